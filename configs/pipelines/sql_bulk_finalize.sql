@@ -0,0 +1,13 @@
+DELETE FROM descriptor_index a USING descriptor_index b
+  WHERE a.uid = b.uid AND a.ctid < b.ctid;
+
+ALTER TABLE descriptor_index ADD PRIMARY KEY (uid);
+
+CREATE INDEX OBJECT_TRACK_ID_FRAME_VIDEO ON OBJECT_TRACK(
+  TRACK_ID,
+  FRAME_NUMBER,
+  VIDEO_NAME
+);
+
+ANALYZE descriptor_index;
+ANALYZE OBJECT_TRACK;
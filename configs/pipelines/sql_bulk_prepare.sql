@@ -0,0 +1,3 @@
+DROP INDEX IF EXISTS OBJECT_TRACK_ID_FRAME_VIDEO;
+
+ALTER TABLE descriptor_index DROP CONSTRAINT IF EXISTS descriptor_index_pkey;
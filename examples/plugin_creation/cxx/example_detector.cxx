@@ -86,4 +86,22 @@ example_detector
 }
 
 
+// -------------------------------------------------------------------------------------------------
+std::vector< kwiver::vital::detected_object_set_sptr >
+example_detector
+::detect_batch( std::vector< kwiver::vital::image_container_sptr > const& images ) const
+{
+  std::vector< kwiver::vital::detected_object_set_sptr > detected_sets;
+
+  std::cout << "Text: " << d->m_text << " (batch of " << images.size() << ")" << std::endl;
+
+  for( size_t i = 0; i < images.size(); ++i )
+  {
+    detected_sets.push_back( std::make_shared< kwiver::vital::detected_object_set >() );
+  }
+
+  return detected_sets;
+}
+
+
 } // end namespace
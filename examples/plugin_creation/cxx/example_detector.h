@@ -6,12 +6,14 @@
 #define VIAME_EXAMPLE_DETECTOR_H
 
 #include <vital/algo/image_object_detector.h>
+#include <viame/batch_image_object_detector.h>
 
 namespace viame {
 
 class example_detector :
   public kwiver::vital::algorithm_impl<
-    example_detector, kwiver::vital::algo::image_object_detector >
+    example_detector, kwiver::vital::algo::image_object_detector >,
+  public viame::batch_image_object_detector
 {
 public:
   example_detector();
@@ -28,6 +30,10 @@ public:
   virtual kwiver::vital::detected_object_set_sptr detect(
     kwiver::vital::image_container_sptr image_data ) const;
 
+  // Batched detection method, called by the batch_detector process
+  virtual std::vector< kwiver::vital::detected_object_set_sptr > detect_batch(
+    std::vector< kwiver::vital::image_container_sptr > const& images ) const;
+
 private:
   class priv;
   const std::unique_ptr< priv > d;
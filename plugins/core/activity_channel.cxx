@@ -0,0 +1,106 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Named channels carrying activity feedback back up a pipeline
+ */
+
+#include "activity_channel.h"
+
+#include <algorithm>
+#include <map>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+std::shared_ptr< activity_channel >
+activity_channel
+::get( std::string const& name )
+{
+  static std::mutex channels_mutex;
+  static std::map< std::string, std::shared_ptr< activity_channel > > channels;
+
+  std::lock_guard< std::mutex > lock( channels_mutex );
+
+  auto& channel = channels[ name ];
+
+  if( !channel )
+  {
+    channel = std::make_shared< activity_channel >();
+  }
+  return channel;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+activity_channel
+::report( kwiver::vital::timestamp const& ts )
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  if( !m_reported ||
+      ( ts.has_valid_time() && m_last_active.has_valid_time() &&
+        ts.get_time_usec() > m_last_active.get_time_usec() ) ||
+      ( ts.has_valid_frame() && m_last_active.has_valid_frame() &&
+        ts.get_frame() > m_last_active.get_frame() ) )
+  {
+    m_last_active = ts;
+    m_reported = true;
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+double
+activity_channel
+::seconds_since_active( kwiver::vital::timestamp const& ts,
+                        double frame_rate ) const
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  if( !m_reported )
+  {
+    return -1.0;
+  }
+  if( ts.has_valid_time() && m_last_active.has_valid_time() )
+  {
+    return std::max( 0.0, ( ts.get_time_usec() - m_last_active.get_time_usec() ) * 1e-6 );
+  }
+  if( frame_rate > 0.0 && ts.has_valid_frame() && m_last_active.has_valid_frame() )
+  {
+    return std::max( 0.0, ( ts.get_frame() - m_last_active.get_frame() ) / frame_rate );
+  }
+  return -1.0;
+}
+
+} // end namespace viame
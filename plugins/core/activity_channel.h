@@ -0,0 +1,83 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Named channels carrying activity feedback back up a pipeline
+ */
+
+#ifndef VIAME_CORE_ACTIVITY_CHANNEL_H
+#define VIAME_CORE_ACTIVITY_CHANNEL_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/types/timestamp.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Latest frame on which a downstream stage saw activity
+ *
+ * Sprokit edges only carry data downstream, so stages late in a pipeline,
+ * such as detectors or motion gates, report the frames they found active on
+ * a channel which an earlier stage, such as adaptive_downsample_process,
+ * reads without ever blocking. Channels are shared by name across a process.
+ */
+class VIAME_CORE_EXPORT activity_channel
+{
+public:
+  activity_channel() : m_reported( false ) {}
+
+  static std::shared_ptr< activity_channel > get( std::string const& name );
+
+  /// Record activity on a frame, ignoring frames older than the last one
+  void report( kwiver::vital::timestamp const& ts );
+
+  /// Seconds between the last active frame and the given one, negative if
+  /// nothing was reported or the timestamps can not be compared. Frame
+  /// numbers are used with frame_rate when either timestamp has no time.
+  double seconds_since_active( kwiver::vital::timestamp const& ts,
+                               double frame_rate ) const;
+
+private:
+  mutable std::mutex m_mutex;
+  bool m_reported;
+  kwiver::vital::timestamp m_last_active;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_ACTIVITY_CHANNEL_H
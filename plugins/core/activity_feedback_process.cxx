@@ -0,0 +1,191 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Report frames with detections or passed images as active
+ */
+
+#include "activity_feedback_process.h"
+#include "activity_channel.h"
+#include "process_trace.h"
+
+#include <sprokit/processes/kwiver_type_traits.h>
+
+#include <vital/vital_types.h>
+
+#include <vital/types/timestamp.h>
+#include <vital/types/image_container.h>
+#include <vital/types/detected_object_set.h>
+
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( channel, std::string, "activity",
+  "Name of the activity channel read by adaptive_downsample_process." );
+create_config_trait( min_confidence, double, "0.0",
+  "Minimum confidence of a detection for its frame to count as active." );
+
+//------------------------------------------------------------------------------
+// Private implementation class
+class activity_feedback_process::priv
+{
+public:
+  priv();
+  ~priv();
+
+  // Configuration values
+  double m_min_confidence;
+
+  std::shared_ptr< activity_channel > m_channel;
+};
+
+// =============================================================================
+
+activity_feedback_process
+::activity_feedback_process( kwiver::vital::config_block_sptr const& config )
+  : process( config ),
+    d( new activity_feedback_process::priv() )
+{
+  make_ports();
+  make_config();
+}
+
+
+activity_feedback_process
+::~activity_feedback_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+activity_feedback_process
+::_configure()
+{
+  d->m_min_confidence = config_value_using_trait( min_confidence );
+  d->m_channel = activity_channel::get( config_value_using_trait( channel ) );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+activity_feedback_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  kwiver::vital::timestamp timestamp = grab_from_port_using_trait( timestamp );
+  kwiver::vital::detected_object_set_sptr detections;
+  kwiver::vital::image_container_sptr image;
+
+  if( has_input_port_edge_using_trait( detected_object_set ) )
+  {
+    detections = grab_from_port_using_trait( detected_object_set );
+  }
+  if( has_input_port_edge_using_trait( image ) )
+  {
+    image = grab_from_port_using_trait( image );
+  }
+
+  trace.inputs_ready();
+
+  bool active = ( image && image->width() > 0 && image->height() > 0 );
+
+  if( !active && detections )
+  {
+    for( auto const& det : *detections )
+    {
+      if( det->confidence() >= d->m_min_confidence )
+      {
+        active = true;
+        break;
+      }
+    }
+  }
+
+  trace.count( "active", active ? 1 : 0 );
+
+  if( active )
+  {
+    d->m_channel->report( timestamp );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+activity_feedback_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t required;
+  sprokit::process::port_flags_t optional;
+
+  required.insert( flag_required );
+
+  // -- input --
+  declare_input_port_using_trait( timestamp, required );
+  declare_input_port_using_trait( detected_object_set, optional );
+  declare_input_port_using_trait( image, optional );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+activity_feedback_process
+::make_config()
+{
+  declare_config_using_trait( channel );
+  declare_config_using_trait( min_confidence );
+}
+
+
+// =============================================================================
+activity_feedback_process::priv
+::priv()
+  : m_min_confidence( 0.0 )
+{
+}
+
+
+activity_feedback_process::priv
+::~priv()
+{
+}
+
+
+} // end namespace core
+
+} // end namespace viame
@@ -0,0 +1,271 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Downsample frames at a rate raised while activity is reported
+ */
+
+#include "adaptive_downsample_process.h"
+#include "activity_channel.h"
+#include "process_trace.h"
+
+#include <vital/vital_types.h>
+
+#include <vital/types/timestamp.h>
+#include <vital/types/image_container.h>
+
+#include <sprokit/pipeline/process_exception.h>
+
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( active_frame_rate, double, "5.0",
+  "Frame rate passed while activity is present, 0 to pass every frame." );
+create_config_trait( idle_frame_rate, double, "0.5",
+  "Frame rate passed while no activity is present. Must be above 0, as "
+  "activity can only be found on passed frames." );
+create_config_trait( hold_time, double, "2.0",
+  "Seconds the active rate is kept after the last frame reported active. "
+  "Should cover the delay between this process and the feedback stage." );
+create_config_trait( input_frame_rate, double, "0",
+  "Source frame rate used when no frame_rate input is connected, needed "
+  "when timestamps only hold frame numbers, else every frame is passed." );
+create_config_trait( channel, std::string, "activity",
+  "Name of the activity channel written by activity_feedback_process." );
+
+//------------------------------------------------------------------------------
+// Private implementation class
+class adaptive_downsample_process::priv
+{
+public:
+  priv();
+  ~priv();
+
+  // Seconds of a timestamp, from its time or its frame number
+  bool seconds( kwiver::vital::timestamp const& ts, double& value ) const;
+
+  // Configuration values
+  double m_active_frame_rate;
+  double m_idle_frame_rate;
+  double m_hold_time;
+  double m_source_rate;
+
+  std::shared_ptr< activity_channel > m_channel;
+
+  // Time of the last passed frame
+  bool m_has_passed;
+  double m_last_pass;
+};
+
+// =============================================================================
+
+adaptive_downsample_process
+::adaptive_downsample_process( kwiver::vital::config_block_sptr const& config )
+  : process( config ),
+    d( new adaptive_downsample_process::priv() )
+{
+  make_ports();
+  make_config();
+}
+
+
+adaptive_downsample_process
+::~adaptive_downsample_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+adaptive_downsample_process
+::_configure()
+{
+  d->m_active_frame_rate = config_value_using_trait( active_frame_rate );
+  d->m_idle_frame_rate = config_value_using_trait( idle_frame_rate );
+  d->m_hold_time = config_value_using_trait( hold_time );
+  d->m_source_rate = config_value_using_trait( input_frame_rate );
+  d->m_channel = activity_channel::get( config_value_using_trait( channel ) );
+
+  if( d->m_idle_frame_rate <= 0.0 || d->m_active_frame_rate < 0.0 ||
+      ( d->m_active_frame_rate > 0.0 &&
+        d->m_active_frame_rate < d->m_idle_frame_rate ) )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+      "idle_frame_rate must be above 0 and no higher than active_frame_rate" );
+  }
+
+  d->m_has_passed = false;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+adaptive_downsample_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  kwiver::vital::timestamp timestamp = grab_from_port_using_trait( timestamp );
+  kwiver::vital::image_container_sptr image = grab_from_port_using_trait( input_1 );
+  std::string file_name;
+
+  if( has_input_port_edge_using_trait( input_2 ) )
+  {
+    file_name = grab_from_port_using_trait( input_2 );
+  }
+  if( has_input_port_edge_using_trait( frame_rate ) )
+  {
+    d->m_source_rate = grab_from_port_using_trait( frame_rate );
+  }
+
+  trace.inputs_ready();
+
+  const double since = d->m_channel->seconds_since_active( timestamp, d->m_source_rate );
+  const bool active = ( since >= 0.0 && since <= d->m_hold_time );
+  const double rate = ( active ? d->m_active_frame_rate : d->m_idle_frame_rate );
+
+  double now = 0.0;
+  bool passed = true;
+
+  if( d->m_has_passed && rate > 0.0 && d->seconds( timestamp, now ) )
+  {
+    // Half a source frame of tolerance, so that a rate dividing the source
+    // rate passes every Nth frame exactly
+    const double tolerance = ( d->m_source_rate > 0.0 ? 0.5 / d->m_source_rate : 0.0 );
+
+    passed = ( now - d->m_last_pass >= 1.0 / rate - tolerance );
+  }
+
+  trace.count( "active", active ? 1 : 0 );
+  trace.count( "passed", passed ? 1 : 0 );
+
+  if( !passed )
+  {
+    return;
+  }
+
+  if( d->seconds( timestamp, now ) )
+  {
+    d->m_last_pass = now;
+    d->m_has_passed = true;
+  }
+
+  push_to_port_using_trait( timestamp, timestamp );
+  push_to_port_using_trait( output_1, image );
+  push_to_port_using_trait( output_2, file_name );
+  push_to_port_using_trait( frame_rate,
+    d->m_active_frame_rate > 0.0 ? d->m_active_frame_rate : d->m_source_rate );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+adaptive_downsample_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t required;
+  sprokit::process::port_flags_t optional;
+
+  required.insert( flag_required );
+
+  // -- input --
+  declare_input_port_using_trait( timestamp, required );
+  declare_input_port_using_trait( input_1, required );
+  declare_input_port_using_trait( input_2, optional );
+  declare_input_port_using_trait( frame_rate, optional );
+
+  // -- output --
+  declare_output_port_using_trait( timestamp, optional );
+  declare_output_port_using_trait( output_1, optional );
+  declare_output_port_using_trait( output_2, optional );
+  declare_output_port_using_trait( frame_rate, optional );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+adaptive_downsample_process
+::make_config()
+{
+  declare_config_using_trait( active_frame_rate );
+  declare_config_using_trait( idle_frame_rate );
+  declare_config_using_trait( hold_time );
+  declare_config_using_trait( input_frame_rate );
+  declare_config_using_trait( channel );
+}
+
+
+// =============================================================================
+adaptive_downsample_process::priv
+::priv()
+  : m_active_frame_rate( 5.0 )
+  , m_idle_frame_rate( 0.5 )
+  , m_hold_time( 2.0 )
+  , m_source_rate( 0.0 )
+  , m_has_passed( false )
+  , m_last_pass( 0.0 )
+{
+}
+
+
+adaptive_downsample_process::priv
+::~priv()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+adaptive_downsample_process::priv
+::seconds( kwiver::vital::timestamp const& ts, double& value ) const
+{
+  if( ts.has_valid_time() )
+  {
+    value = ts.get_time_usec() * 1e-6;
+    return true;
+  }
+  if( ts.has_valid_frame() && m_source_rate > 0.0 )
+  {
+    value = ts.get_frame() / m_source_rate;
+    return true;
+  }
+  return false;
+}
+
+
+} // end namespace core
+
+} // end namespace viame
@@ -0,0 +1,93 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Downsample frames at a rate raised while activity is reported
+ */
+
+#ifndef VIAME_ADAPTIVE_DOWNSAMPLE_PROCESS_H
+#define VIAME_ADAPTIVE_DOWNSAMPLE_PROCESS_H
+
+#include <sprokit/pipeline/process.h>
+#include <sprokit/processes/kwiver_type_traits.h>
+
+#include <plugins/core/viame_processes_core_export.h>
+
+#include <memory>
+
+namespace viame
+{
+
+namespace core
+{
+
+// Port names match the downsample process, so either can be used in a pipe
+create_port_trait( input_1, image, "Image to downsample" );
+create_port_trait( input_2, file_name, "File name of the image" );
+create_port_trait( output_1, image, "Passed image" );
+create_port_trait( output_2, file_name, "File name of the passed image" );
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Downsampler switching between an active and an idle frame rate
+ *
+ * Frames are passed at active_frame_rate while activity was reported on the
+ * named activity_channel within the last hold_time seconds, and at
+ * idle_frame_rate otherwise. Activity is reported by activity_feedback_process
+ * placed after a detector, filter_frame_process or filter_frame_motion_process
+ * later in the same pipeline. Rejected frames produce no output, as in the
+ * downsample process.
+ */
+class VIAME_PROCESSES_CORE_NO_EXPORT adaptive_downsample_process
+  : public sprokit::process
+{
+public:
+  // -- CONSTRUCTORS --
+  adaptive_downsample_process( kwiver::vital::config_block_sptr const& config );
+  virtual ~adaptive_downsample_process();
+
+protected:
+  virtual void _configure();
+  virtual void _step();
+
+private:
+  void make_ports();
+  void make_config();
+
+  class priv;
+  const std::unique_ptr<priv> d;
+
+}; // end class adaptive_downsample_process
+
+} // end namespace core
+} // end namespace viame
+
+#endif // VIAME_ADAPTIVE_DOWNSAMPLE_PROCESS_H
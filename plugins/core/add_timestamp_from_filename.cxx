@@ -50,6 +50,7 @@ namespace viame
 
 // ----------------------------------------------------------------------------
 add_timestamp_from_filename::add_timestamp_from_filename()
+  : cache_filename_format( true )
 {
   this->set_capability( kwiver::vital::algo::image_io::HAS_TIME, true );
 }
@@ -60,6 +61,10 @@ kwiver::vital::config_block_sptr
 {
   auto config = kwiver::vital::algo::image_io::get_configuration();
 
+  config->set_value( "cache_filename_format", this->cache_filename_format,
+    "Detect the filename timestamp format once and decode later filenames "
+    "with the same layout directly from its character offsets." );
+
   kwiver::vital::algo::image_io::get_nested_algo_configuration(
     "image_reader", config, this->image_reader);
 
@@ -73,6 +78,10 @@ void add_timestamp_from_filename::set_configuration(
   auto new_config = this->get_configuration();
   new_config->merge_config( config );
 
+  this->cache_filename_format =
+    new_config->get_value< bool >( "cache_filename_format" );
+  this->timestamp_parser.reset();
+
   kwiver::vital::algo::image_io::set_nested_algo_configuration(
     "image_reader", new_config, this->image_reader );
 }
@@ -132,7 +141,9 @@ kwiver::vital::metadata_sptr add_timestamp_from_filename::fixup_metadata(
     md = std::make_shared<kwiver::vital::metadata>();
   }
 
-  kwiver::vital::time_usec_t utc_time_usec = convert_to_timestamp( filename );
+  kwiver::vital::time_usec_t utc_time_usec =
+    ( this->cache_filename_format ? this->timestamp_parser.parse( filename )
+                                  : convert_to_timestamp( filename ) );
 
   kwiver::vital::timestamp ts;
   ts.set_time_usec( utc_time_usec );
@@ -32,6 +32,7 @@
 #define VIAME_CORE_ADD_TIMESTAMP_FROM_FILENAME_H
 
 #include <plugins/core/viame_core_export.h>
+#include <plugins/core/filename_to_timestamp.h>
 
 #include <vital/algo/image_io.h>
 
@@ -58,6 +59,10 @@ public:
 private:
   kwiver::vital::algo::image_io_sptr image_reader;
 
+  // Reuse the format detected on previous filenames of the stream
+  bool cache_filename_format;
+  mutable filename_timestamp_parser timestamp_parser;
+
   kwiver::vital::image_container_sptr load_(
     std::string const& filename ) const override;
 
@@ -0,0 +1,364 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Aggregate batched descriptors of object tracks
+ */
+
+#include "aggregate_track_descriptors_process.h"
+#include "process_trace.h"
+
+#include <vital/vital_types.h>
+#include <vital/algo/compute_track_descriptors.h>
+#include <vital/types/descriptor.h>
+#include <vital/types/image_container.h>
+#include <vital/types/timestamp.h>
+#include <vital/types/object_track_set.h>
+#include <vital/types/track_descriptor_set.h>
+
+#include <sprokit/processes/kwiver_type_traits.h>
+#include <sprokit/pipeline/process_exception.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace kv = kwiver::vital;
+namespace algo = kwiver::vital::algo;
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( descriptor_extractor, std::string, "",
+  "Algorithm configuration subblock for the compute_track_descriptors "
+  "algorithm describing the tracks" );
+create_config_trait( batch_frames, unsigned, "1",
+  "Compute descriptors every this many frames, in a single call for all "
+  "the tracks with a state on the current frame" );
+create_config_trait( max_batch_size, unsigned, "0",
+  "If set, maximum number of tracks passed to each descriptor computation, "
+  "larger batches are split in multiple calls" );
+create_config_trait( assign_to_detections, bool, "true",
+  "Set the running mean descriptor of each track as the descriptor of the "
+  "detection in its last state" );
+
+// =============================================================================
+// Private implementation class
+class aggregate_track_descriptors_process::priv
+{
+public:
+  explicit priv( aggregate_track_descriptors_process* parent );
+  ~priv();
+
+  // Running mean descriptor of a track
+  struct running_mean
+  {
+    std::vector< double > values;
+    unsigned count = 0;
+    kv::track_descriptor_sptr descriptor;
+  };
+
+  void add_descriptors( const kv::track_descriptor_set_sptr& descriptors );
+
+  // Configuration settings
+  unsigned m_batch_frames;
+  unsigned m_max_batch_size;
+  bool m_assign_to_detections;
+
+  // Internal variables
+  algo::compute_track_descriptors_sptr m_extractor;
+  unsigned m_frame_counter;
+  std::unordered_map< kv::track_id_t, running_mean > m_means;
+  std::unordered_set< kv::track_id_t > m_input_ids;
+
+  // Other variables
+  aggregate_track_descriptors_process* parent;
+};
+
+
+// -----------------------------------------------------------------------------
+aggregate_track_descriptors_process::priv
+::priv( aggregate_track_descriptors_process* ptr )
+  : m_batch_frames( 1 )
+  , m_max_batch_size( 0 )
+  , m_assign_to_detections( true )
+  , m_frame_counter( 0 )
+  , parent( ptr )
+{
+}
+
+
+aggregate_track_descriptors_process::priv
+::~priv()
+{
+}
+
+
+void
+aggregate_track_descriptors_process::priv
+::add_descriptors( const kv::track_descriptor_set_sptr& descriptors )
+{
+  if( !descriptors )
+  {
+    return;
+  }
+
+  for( const auto& td : *descriptors )
+  {
+    if( !td || !td->get_descriptor() )
+    {
+      continue;
+    }
+
+    const std::vector< double > values = td->get_descriptor()->as_double();
+
+    for( auto id : td->get_track_ids() )
+    {
+      running_mean& mean = m_means[ id ];
+
+      // Restart the mean if the descriptor layout changed
+      if( mean.values.size() != values.size() )
+      {
+        mean.values.assign( values.size(), 0.0 );
+        mean.count = 0;
+      }
+
+      mean.count++;
+
+      for( size_t i = 0; i < values.size(); ++i )
+      {
+        mean.values[ i ] += ( values[ i ] - mean.values[ i ] ) / mean.count;
+      }
+
+      // Downstream processes may still hold the previous descriptor
+      auto desc = std::make_shared< kv::descriptor_dynamic< double > >(
+        mean.values.size() );
+      std::copy( mean.values.begin(), mean.values.end(), desc->raw_data() );
+
+      mean.descriptor = kv::track_descriptor::create( td->get_type() );
+      mean.descriptor->set_descriptor( desc );
+      mean.descriptor->add_track_id( id );
+    }
+  }
+}
+
+
+// =============================================================================
+aggregate_track_descriptors_process
+::aggregate_track_descriptors_process( kv::config_block_sptr const& config )
+  : process( config ),
+    d( new aggregate_track_descriptors_process::priv( this ) )
+{
+  make_ports();
+  make_config();
+}
+
+
+aggregate_track_descriptors_process
+::~aggregate_track_descriptors_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+aggregate_track_descriptors_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t required;
+  sprokit::process::port_flags_t optional;
+
+  required.insert( flag_required );
+
+  // -- inputs --
+  declare_input_port_using_trait( timestamp, required );
+  declare_input_port_using_trait( image, required );
+  declare_input_port_using_trait( object_track_set, required );
+
+  // -- outputs --
+  declare_output_port_using_trait( object_track_set, optional );
+  declare_output_port_using_trait( track_descriptor_set, optional );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+aggregate_track_descriptors_process
+::make_config()
+{
+  declare_config_using_trait( descriptor_extractor );
+  declare_config_using_trait( batch_frames );
+  declare_config_using_trait( max_batch_size );
+  declare_config_using_trait( assign_to_detections );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+aggregate_track_descriptors_process
+::_configure()
+{
+  d->m_batch_frames = std::max( 1u, config_value_using_trait( batch_frames ) );
+  d->m_max_batch_size = config_value_using_trait( max_batch_size );
+  d->m_assign_to_detections = config_value_using_trait( assign_to_detections );
+
+  kv::config_block_sptr algo_config = get_config();
+
+  algo::compute_track_descriptors::set_nested_algo_configuration(
+    "descriptor_extractor", algo_config, d->m_extractor );
+
+  if( !d->m_extractor )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Unable to create descriptor_extractor" );
+  }
+
+  algo::compute_track_descriptors::get_nested_algo_configuration(
+    "descriptor_extractor", algo_config, d->m_extractor );
+
+  if( !algo::compute_track_descriptors::check_nested_algo_configuration(
+        "descriptor_extractor", algo_config ) )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Configuration check failed for descriptor_extractor" );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+aggregate_track_descriptors_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  kv::timestamp timestamp = grab_from_port_using_trait( timestamp );
+  kv::image_container_sptr image = grab_from_port_using_trait( image );
+  kv::object_track_set_sptr tracks = grab_from_port_using_trait( object_track_set );
+
+  trace.inputs_ready();
+  trace.count( "tracks", tracks ? tracks->size() : 0 );
+
+  std::vector< kv::track_sptr > input_tracks;
+
+  if( tracks )
+  {
+    input_tracks = tracks->tracks();
+  }
+
+  // Describe all the tracks visible on this frame at once
+  if( d->m_frame_counter++ % d->m_batch_frames == 0 )
+  {
+    std::vector< kv::track_sptr > active_tracks;
+
+    for( const auto& trk : input_tracks )
+    {
+      if( trk && !trk->empty() && trk->last_frame() == timestamp.get_frame() )
+      {
+        active_tracks.push_back( trk );
+      }
+    }
+
+    const size_t batch_size = d->m_max_batch_size > 0 ?
+      d->m_max_batch_size : std::max< size_t >( active_tracks.size(), 1 );
+
+    for( size_t begin = 0; begin < active_tracks.size(); begin += batch_size )
+    {
+      const size_t end = std::min( begin + batch_size, active_tracks.size() );
+
+      kv::object_track_set_sptr batch = std::make_shared< kv::object_track_set >(
+        std::vector< kv::track_sptr >( active_tracks.begin() + begin,
+                                       active_tracks.begin() + end ) );
+
+      d->add_descriptors( d->m_extractor->compute( timestamp, image, batch ) );
+    }
+  }
+
+  // Output the cached means and drop the tracks which are no longer input
+  kv::track_descriptor_set_sptr output( new kv::track_descriptor_set() );
+
+  d->m_input_ids.clear();
+
+  for( const auto& trk : input_tracks )
+  {
+    if( !trk )
+    {
+      continue;
+    }
+
+    d->m_input_ids.insert( trk->id() );
+
+    auto it = d->m_means.find( trk->id() );
+
+    if( it == d->m_means.end() || !it->second.descriptor )
+    {
+      continue;
+    }
+
+    output->push_back( it->second.descriptor );
+
+    if( d->m_assign_to_detections && !trk->empty() )
+    {
+      auto state = std::dynamic_pointer_cast< kv::object_track_state >( trk->back() );
+
+      if( state && state->detection() )
+      {
+        state->detection()->set_descriptor(
+          it->second.descriptor->get_descriptor() );
+      }
+    }
+  }
+
+  for( auto it = d->m_means.begin(); it != d->m_means.end(); )
+  {
+    if( d->m_input_ids.count( it->first ) == 0 )
+    {
+      it = d->m_means.erase( it );
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  push_to_port_using_trait( object_track_set, tracks );
+  push_to_port_using_trait( track_descriptor_set, output );
+}
+
+} // end namespace core
+
+} // end namespace viame
@@ -0,0 +1,84 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Aggregate batched descriptors of object tracks
+ */
+
+#ifndef VIAME_AGGREGATE_TRACK_DESCRIPTORS_PROCESS_H
+#define VIAME_AGGREGATE_TRACK_DESCRIPTORS_PROCESS_H
+
+#include <sprokit/pipeline/process.h>
+
+#include <plugins/core/viame_processes_core_export.h>
+
+#include <memory>
+
+namespace viame
+{
+
+namespace core
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Aggregate batched descriptors of object tracks
+ *
+ * Descriptors of all the tracks active on a frame are computed with a single
+ * call of a compute_track_descriptors algorithm, every batch_frames frames,
+ * and the running mean descriptor of each track is cached until the track
+ * leaves the input track set.
+ */
+class VIAME_PROCESSES_CORE_NO_EXPORT aggregate_track_descriptors_process
+  : public sprokit::process
+{
+public:
+  // -- CONSTRUCTORS --
+  aggregate_track_descriptors_process( kwiver::vital::config_block_sptr const& config );
+  virtual ~aggregate_track_descriptors_process();
+
+protected:
+  virtual void _configure();
+  virtual void _step();
+
+private:
+  void make_ports();
+  void make_config();
+
+  class priv;
+  const std::unique_ptr<priv> d;
+
+}; // end class aggregate_track_descriptors_process
+
+} // end namespace core
+} // end namespace viame
+
+#endif // VIAME_AGGREGATE_TRACK_DESCRIPTORS_PROCESS_H
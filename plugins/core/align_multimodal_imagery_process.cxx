@@ -34,6 +34,11 @@
  */
 
 #include "align_multimodal_imagery_process.h"
+#include "process_trace.h"
+#include "auto_detect_transform.h"
+#include "image_memory_budget.h"
+#include "lazy_image_container.h"
+#include "thread_pool.h"
 
 #include <vital/vital_types.h>
 
@@ -41,10 +46,21 @@
 #include <vital/types/image_container.h>
 #include <vital/types/homography.h>
 
+#include <sprokit/pipeline/process_exception.h>
+
+#include <arrows/ocv/image_container.h>
+
+#include <Eigen/LU>
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/core/eigen.hpp>
+
 #include <sstream>
 #include <iostream>
-#include <list>
-#include <limits>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <vector>
 #include <cmath>
 
 
@@ -58,6 +74,76 @@ create_config_trait( output_frames_without_match, bool, "true",
   "Output frames without any valid matches" );
 create_config_trait( max_time_offset, double, "0.5",
   "The maximum time difference (s) under whitch two frames can be tested" );
+create_config_trait( max_buffer_size, unsigned, "64",
+  "Maximum number of frames buffered for each modality. When a buffer is "
+  "full its oldest frame is dropped, and output without a match if it "
+  "belongs to the dominant stream." );
+create_config_trait( registration_threads, unsigned, "0",
+  "Number of threads registering matched pairs concurrently, 0 registers "
+  "them inline. Results are still output in the order of the frames." );
+create_config_trait( homography_file, std::string, "",
+  "Optional file containing a fixed optical to thermal transform of the rig, "
+  "in any format read by the auto transform reader. When set, frames are not "
+  "registered, the homographies and warped images of every matched pair are "
+  "computed from this transform." );
+
+namespace
+{
+
+// Homography equivalent to a transform, exact for projective transforms, fit
+// from the mapping of four points otherwise
+kwiver::vital::homography_sptr
+transform_to_homography( const kwiver::vital::transform_2d& transform )
+{
+  if( auto homog = dynamic_cast< const kwiver::vital::homography* >( &transform ) )
+  {
+    return homog->normalize();
+  }
+
+  const kwiver::vital::vector_2d src[ 4 ] =
+    { { 0.0, 0.0 }, { 1000.0, 0.0 }, { 1000.0, 1000.0 }, { 0.0, 1000.0 } };
+
+  Eigen::Matrix< double, 8, 8 > a;
+  Eigen::Matrix< double, 8, 1 > b;
+
+  for( unsigned i = 0; i < 4; ++i )
+  {
+    const kwiver::vital::vector_2d dst = transform.map( src[ i ] );
+    const double x = src[ i ].x(), y = src[ i ].y();
+
+    a.row( 2 * i ) << x, y, 1, 0, 0, 0, -x * dst.x(), -y * dst.x();
+    a.row( 2 * i + 1 ) << 0, 0, 0, x, y, 1, -x * dst.y(), -y * dst.y();
+    b( 2 * i ) = dst.x();
+    b( 2 * i + 1 ) = dst.y();
+  }
+
+  const Eigen::Matrix< double, 8, 1 > h = a.fullPivLu().solve( b );
+
+  kwiver::vital::matrix_3x3d matrix;
+  matrix << h( 0 ), h( 1 ), h( 2 ), h( 3 ), h( 4 ), h( 5 ), h( 6 ), h( 7 ), 1.0;
+
+  return std::make_shared< kwiver::vital::homography_< double > >( matrix );
+}
+
+// Warp an image with a homography from the output to the input image
+kwiver::vital::image_container_sptr
+warp_image( const kwiver::vital::image_container_sptr& image,
+            const kwiver::vital::matrix_3x3d& output_to_input,
+            const size_t width, const size_t height )
+{
+  using ic = kwiver::arrows::ocv::image_container;
+
+  cv::Mat matrix, warped;
+  cv::eigen2cv( output_to_input, matrix );
+
+  cv::warpPerspective( ic::vital_to_ocv( image->get_image(), ic::RGB_COLOR ),
+    warped, matrix, cv::Size( static_cast< int >( width ), static_cast< int >( height ) ),
+    cv::INTER_LINEAR | cv::WARP_INVERSE_MAP );
+
+  return std::make_shared< ic >( warped, ic::RGB_COLOR );
+}
+
+} // end anonymous namespace
 
 //------------------------------------------------------------------------------
 // Private implementation class
@@ -67,13 +153,105 @@ public:
   priv();
   ~priv();
 
+  // Fixed capacity ring of frames, sorted by time since frames are received
+  // in chronological order. The images held are reported to the shared image
+  // memory budget.
+  class frame_ring
+  {
+  public:
+    frame_ring() : m_first( 0 ), m_count( 0 ) {}
+
+    void reset( size_t capacity )
+    {
+      m_frames.assign( capacity, buffered_frame() );
+      m_bytes.assign( capacity, 0 );
+      m_memory.clear();
+      m_first = 0;
+      m_count = 0;
+    }
+
+    bool empty() const { return m_count == 0; }
+    bool full() const { return m_count == m_frames.size(); }
+    size_t size() const { return m_count; }
+
+    buffered_frame& operator[]( size_t i )
+    {
+      return m_frames[ ( m_first + i ) % m_frames.size() ];
+    }
+
+    buffered_frame& front() { return m_frames[ m_first ]; }
+
+    void push_back( buffered_frame&& frame )
+    {
+      const size_t slot = ( m_first + m_count ) % m_frames.size();
+
+      m_bytes[ slot ] = image_memory_size( frame.image );
+      m_memory.add( m_bytes[ slot ] );
+      m_frames[ slot ] = std::move( frame );
+      ++m_count;
+    }
+
+    // Remove the n oldest frames, releasing their images
+    void pop_front( size_t n = 1 )
+    {
+      for( ; n > 0 && m_count > 0; --n, --m_count )
+      {
+        m_frames[ m_first ] = buffered_frame();
+        m_memory.remove( m_bytes[ m_first ] );
+        m_bytes[ m_first ] = 0;
+        m_first = ( m_first + 1 ) % m_frames.size();
+      }
+    }
+
+    void clear() { pop_front( m_count ); }
+
+    // Index of the first frame not older than the given time
+    size_t lower_bound( double time )
+    {
+      size_t lower = 0, upper = m_count;
+
+      while( lower < upper )
+      {
+        const size_t middle = lower + ( upper - lower ) / 2;
+
+        if( ( *this )[ middle ].time() < time )
+        {
+          lower = middle + 1;
+        }
+        else
+        {
+          upper = middle;
+        }
+      }
+      return lower;
+    }
+
+  private:
+    std::vector< buffered_frame > m_frames;
+    std::vector< size_t > m_bytes;
+    image_memory_holder m_memory;
+    size_t m_first;
+    size_t m_count;
+  };
+
   // Configuration values
   bool m_output_frames_without_match;
   double m_max_time_offset;
+  unsigned m_max_buffer_size;
+
+  unsigned m_registration_threads;
+
+  // Fixed rig transforms, registration is skipped if set
+  kwiver::vital::homography_sptr m_optical_to_thermal;
+  kwiver::vital::homography_sptr m_thermal_to_optical;
+
+  // Registration workers, and results not output yet in output order
+  std::unique_ptr< viame::thread_pool > m_pool;
+  std::deque< std::future< registration_result > > m_pending;
 
   // Internal buffer
-  std::list< buffered_frame > m_optical_frames;
-  std::list< buffered_frame > m_thermal_frames;
+  frame_ring m_optical_frames;
+  frame_ring m_thermal_frames;
 
   kwiver::vital::timestamp m_last_optical_ts;
   kwiver::vital::timestamp m_last_thermal_ts;
@@ -102,6 +280,7 @@ align_multimodal_imagery_process
 align_multimodal_imagery_process
 ::~align_multimodal_imagery_process()
 {
+  finish_registrations();
 }
 
 
@@ -114,6 +293,50 @@ align_multimodal_imagery_process
     config_value_using_trait( output_frames_without_match );
   d->m_max_time_offset =
     config_value_using_trait( max_time_offset ) * 1e6;
+  d->m_max_buffer_size =
+    config_value_using_trait( max_buffer_size );
+
+  if( d->m_max_buffer_size == 0 )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "max_buffer_size must be at least 1" );
+  }
+
+  d->m_optical_frames.reset( d->m_max_buffer_size );
+  d->m_thermal_frames.reset( d->m_max_buffer_size );
+
+  d->m_registration_threads =
+    config_value_using_trait( registration_threads );
+
+  const std::string homography_file =
+    config_value_using_trait( homography_file );
+
+  d->m_optical_to_thermal.reset();
+  d->m_thermal_to_optical.reset();
+
+  if( !homography_file.empty() )
+  {
+    try
+    {
+      viame::auto_detect_transform_io reader;
+
+      d->m_optical_to_thermal =
+        transform_to_homography( *reader.load( homography_file ) );
+      d->m_thermal_to_optical =
+        std::static_pointer_cast< kwiver::vital::homography >(
+          d->m_optical_to_thermal->inverse() );
+    }
+    catch( const std::exception& e )
+    {
+      VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                   "Unable to load homography_file " + homography_file +
+                   ": " + e.what() );
+    }
+  }
+
+  finish_registrations();
+  d->m_pool.reset( d->m_registration_threads > 0 ?
+    new viame::thread_pool( d->m_registration_threads ) : nullptr );
 }
 
 
@@ -122,6 +345,8 @@ void
 align_multimodal_imagery_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
   kwiver::vital::timestamp optical_time;
   kwiver::vital::image_container_sptr optical_image;
   std::string optical_file_name;
@@ -220,6 +445,8 @@ align_multimodal_imagery_process
     }
   }
 
+  trace.inputs_ready();
+
   // Determine dominant type
   bool optical_dominant = true;
 
@@ -256,130 +483,124 @@ align_multimodal_imagery_process
     d->m_last_thermal_ts = thermal_time;
   }
 
-  // Add images to buffer
+  // Add images to buffer, dropping the oldest frame of a full buffer
+  auto add_frame = [&]( priv::frame_ring& frames, buffered_frame&& frame,
+                        const bool is_dominant, const unsigned stream_id )
+  {
+    if( frames.full() )
+    {
+      LOG_DEBUG( logger(), "Frame buffer full, dropping frame "
+                 << frames.front().ts );
+
+      if( is_dominant )
+      {
+        output_no_match( frames.front(), stream_id );
+      }
+      frames.pop_front();
+    }
+    frames.push_back( std::move( frame ) );
+  };
+
   if( optical_image )
   {
-    d->m_optical_frames.push_back(
-      buffered_frame( optical_image, optical_time, optical_file_name ) );
+    add_frame( d->m_optical_frames,
+      buffered_frame( optical_image, optical_time, optical_file_name ),
+      optical_dominant, 0 );
   }
 
   if( thermal_image )
   {
-    d->m_thermal_frames.push_back(
-      buffered_frame( thermal_image, thermal_time, thermal_file_name ) );
+    add_frame( d->m_thermal_frames,
+      buffered_frame( thermal_image, thermal_time, thermal_file_name ),
+      !optical_dominant, 1 );
   }
 
   // Determine if any images need to be tested
-  std::list< buffered_frame >* dom =
-    ( optical_dominant ? &d->m_optical_frames : &d->m_thermal_frames );
-  std::list< buffered_frame >* sub =
-    ( optical_dominant ? &d->m_thermal_frames : &d->m_optical_frames );
+  priv::frame_ring& dom =
+    ( optical_dominant ? d->m_optical_frames : d->m_thermal_frames );
+  priv::frame_ring& sub =
+    ( optical_dominant ? d->m_thermal_frames : d->m_optical_frames );
 
   const bool this_is_the_end = ( d->m_optical_finished && d->m_thermal_finished );
+  const bool sub_finished =
+    ( optical_dominant ? d->m_thermal_finished : d->m_optical_finished );
 
   d->m_check_optical = true;
   d->m_check_thermal = true;
 
-  if( !dom->empty() )
+  while( !dom.empty() )
   {
-    for( auto dom_entry = dom->begin(); dom_entry != dom->end(); )
+    buffered_frame& dom_entry = dom.front();
+
+    const double dom_time = dom_entry.time();
+    const double lower_time = dom_time - d->m_max_time_offset;
+    const double upper_time = dom_time + d->m_max_time_offset;
+
+    // Special case to prevent over-buffering
+    if( sub.size() == 1 && sub.front().time() < lower_time )
     {
-      bool found_in_range = false; // Crit1: A sub-frame in search interval found
-      bool minimum_found = false;  // Crit2: Found guaranteed local minimum diff between times
-      bool bound_exceeded = false; // Crit3: Upper search bound exceeded
-      bool is_exact = false;       // Crit4: Times match exactly
+      sub.pop_front();
+      d->m_check_optical = !optical_dominant;
+      d->m_check_thermal = optical_dominant;
+      break;
+    }
 
-      const double lower_time = dom_entry->time() - d->m_max_time_offset;
-      const double upper_time = dom_entry->time() + d->m_max_time_offset;
+    // Sub frames too old for this frame are too old for all later ones
+    sub.pop_front( sub.lower_bound( lower_time ) );
 
-      double min_dist = std::numeric_limits< double >::max();
-      buffered_frame* closest_frame = NULL;
+    // The closest frame is either side of the first one not older than this
+    const size_t next = sub.lower_bound( dom_time );
+    buffered_frame* closest_frame = NULL;
 
-      // Special case to prevent over-buffering
-      if( dom_entry == dom->begin() &&
-          sub->size() == 1 && sub->begin()->time() < lower_time )
-      {
-        sub->erase( sub->begin() );
-        d->m_check_optical = !optical_dominant;
-        d->m_check_thermal = optical_dominant;
-        break;
-      }
+    if( next < sub.size() && sub[ next ].time() <= upper_time )
+    {
+      closest_frame = &sub[ next ];
+    }
+    if( next > 0 && ( !closest_frame ||
+          dom_time - sub[ next - 1 ].time() <= closest_frame->time() - dom_time ) )
+    {
+      closest_frame = &sub[ next - 1 ];
+    }
 
-      // Iterate over sub
-      for( auto sub_entry = sub->begin(); sub_entry != sub->end(); )
+    // Sub frames received later can only be further away in time
+    const bool is_final = ( next < sub.size() || sub_finished || this_is_the_end );
+
+    // Definite match
+    if( closest_frame && is_final )
+    {
+      if( optical_dominant )
       {
-        if( sub_entry->time() < lower_time )
-        {
-          sub_entry = sub->erase( sub_entry );
-        }
-        else if( sub_entry->time() > upper_time )
-        {
-          minimum_found = found_in_range;
-          bound_exceeded = true;
-          break;
-        }
-        else
-        {
-          // This frame is in the desired time range
-          found_in_range = true;
-
-          double abs_diff = std::fabs( dom_entry->time() - sub_entry->time() );
-
-          if( abs_diff < min_dist )
-          {
-            min_dist = abs_diff;
-            closest_frame = &(*sub_entry);
-
-            if( abs_diff == 0 )
-            {
-              is_exact = true;
-              break;
-            }
-          }
-          else
-          {
-            minimum_found = true;
-            break;
-          }
-
-          sub_entry++;
-        }
+        attempt_registration( dom_entry, *closest_frame, true );
       }
-
-      // Definite match 
-      if( found_in_range && ( minimum_found || this_is_the_end || is_exact ) )
+      else
       {
-        if( optical_dominant )
-        {
-          attempt_registration( *dom_entry, *closest_frame, true );
-        }
-        else
-        {
-          attempt_registration( *closest_frame, *dom_entry, false );
-        }
-        dom_entry = dom->erase( dom_entry );
+        attempt_registration( *closest_frame, dom_entry, false );
       }
-      // No match for this frame ever
-      else if( ( bound_exceeded && !found_in_range ) || this_is_the_end )
+      dom.pop_front();
+    }
+    // No match for this frame ever
+    else if( is_final )
+    {
+      if( optical_dominant )
       {
-        if( optical_dominant )
-        {
-          output_no_match( *dom_entry, 0 );
-        }
-        else
-        {
-          output_no_match( *dom_entry, 1 );
-        }
-        dom_entry = dom->erase( dom_entry );
+        output_no_match( dom_entry, 0 );
       }
-      // No match found yet...  wait until we receive more frames or EOV
       else
       {
-        break;
+        output_no_match( dom_entry, 1 );
       }
+      dom.pop_front();
+    }
+    // No match found yet...  wait until we receive more frames or EOV
+    else
+    {
+      break;
     }
   }
 
+  // Output finished registrations, all of them at the end of the streams
+  push_ready_results( this_is_the_end );
+
   if( this_is_the_end )
   {
     // Send complete messages, shut down
@@ -396,6 +617,7 @@ align_multimodal_imagery_process
     push_datum_to_port_using_trait( warped_thermal_image, dat );
     push_datum_to_port_using_trait( optical_to_thermal_homog, dat );
     push_datum_to_port_using_trait( thermal_to_optical_homog, dat );
+    push_datum_to_port_using_trait( registration_stats, dat );
     push_datum_to_port_using_trait( success_flag, dat );
   }
 }
@@ -430,6 +652,7 @@ align_multimodal_imagery_process
   declare_output_port_using_trait( warped_thermal_image, optional );
   declare_output_port_using_trait( optical_to_thermal_homog, optional );
   declare_output_port_using_trait( thermal_to_optical_homog, optional );
+  declare_output_port_using_trait( registration_stats, optional );
   declare_output_port_using_trait( success_flag, optional );
 }
 
@@ -441,13 +664,18 @@ align_multimodal_imagery_process
 {
   declare_config_using_trait( output_frames_without_match );
   declare_config_using_trait( max_time_offset );
+  declare_config_using_trait( max_buffer_size );
+  declare_config_using_trait( registration_threads );
+  declare_config_using_trait( homography_file );
 }
 
 
 // =============================================================================
 align_multimodal_imagery_process::priv
 ::priv()
-  : m_optical_finished( false )
+  : m_max_buffer_size( 64 )
+  , m_registration_threads( 0 )
+  , m_optical_finished( false )
   , m_thermal_finished( false )
   , m_check_optical( true )
   , m_check_thermal( true )
@@ -461,84 +689,226 @@ align_multimodal_imagery_process::priv
 }
 
 
+// -----------------------------------------------------------------------------
+align_multimodal_imagery_process::registration_result
+align_multimodal_imagery_process
+::register_frames( const buffered_frame& frame1,
+                   const buffered_frame& frame2,
+                   const bool output_frame1_time )
+{
+  registration_result result;
+
+  result.optical = frame1;
+  result.thermal = frame2;
+  result.ts = ( output_frame1_time ? frame1.ts : frame2.ts );
+  result.success = true;
+
+  return result;
+}
+
+
+// -----------------------------------------------------------------------------
+align_multimodal_imagery_process::registration_result
+align_multimodal_imagery_process
+::apply_fixed_homography( const buffered_frame& optical,
+                          const buffered_frame& thermal,
+                          const bool output_optical_time )
+{
+  registration_result result;
+
+  result.optical = optical;
+  result.thermal = thermal;
+  result.ts = ( output_optical_time ? optical.ts : thermal.ts );
+  result.optical_to_thermal = d->m_optical_to_thermal;
+  result.thermal_to_optical = d->m_thermal_to_optical;
+  result.success = true;
+
+  if( !optical.image || !thermal.image )
+  {
+    return result;
+  }
+
+  // Warps are only computed if a downstream process reads their pixels
+  const size_t optical_width = optical.image->width();
+  const size_t optical_height = optical.image->height();
+  const size_t thermal_width = thermal.image->width();
+  const size_t thermal_height = thermal.image->height();
+
+  if( count_output_port_edges_using_trait( warped_thermal_image ) > 0 )
+  {
+    const kwiver::vital::image_container_sptr image = thermal.image;
+    const kwiver::vital::matrix_3x3d matrix = d->m_optical_to_thermal->matrix();
+
+    result.warped_thermal = std::make_shared< viame::lazy_image_container >(
+      [image, matrix, optical_width, optical_height]()
+      {
+        return warp_image( image, matrix, optical_width, optical_height );
+      },
+      optical_width, optical_height, image->depth() );
+  }
+
+  if( count_output_port_edges_using_trait( warped_optical_image ) > 0 )
+  {
+    const kwiver::vital::image_container_sptr image = optical.image;
+    const kwiver::vital::matrix_3x3d matrix = d->m_thermal_to_optical->matrix();
+
+    result.warped_optical = std::make_shared< viame::lazy_image_container >(
+      [image, matrix, thermal_width, thermal_height]()
+      {
+        return warp_image( image, matrix, thermal_width, thermal_height );
+      },
+      thermal_width, thermal_height, image->depth() );
+  }
+
+  return result;
+}
+
+
+// -----------------------------------------------------------------------------
+align_multimodal_imagery_process::registration_result
+align_multimodal_imagery_process
+::no_match( const buffered_frame& frame, const unsigned stream_id ) const
+{
+  registration_result result;
+
+  if( stream_id == 0 )
+  {
+    result.optical = frame;
+  }
+  else if( stream_id == 1 )
+  {
+    result.thermal = frame;
+  }
+  else
+  {
+    throw std::runtime_error( "Invalid index" );
+  }
+
+  result.ts = frame.ts;
+  return result;
+}
+
+
+// -----------------------------------------------------------------------------
 void
 align_multimodal_imagery_process
 ::attempt_registration( const buffered_frame& frame1,
                         const buffered_frame& frame2,
                         const bool output_frame1_time )
 {
-  // Output required elements depending on connections
-  this->push_to_port_using_trait( optical_image,
-    frame1.image );
-  this->push_to_port_using_trait( optical_file_name,
-    frame1.name );
-  this->push_to_port_using_trait( thermal_image,
-    frame2.image );
-  this->push_to_port_using_trait( thermal_file_name,
-    frame2.name );
-  this->push_to_port_using_trait( timestamp,
-     output_frame1_time ? frame1.ts : frame2.ts );
-  this->push_to_port_using_trait( warped_optical_image,
-    kwiver::vital::image_container_sptr() );
-  this->push_to_port_using_trait( warped_thermal_image,
-    kwiver::vital::image_container_sptr() );
-  this->push_to_port_using_trait( optical_to_thermal_homog,
-    kwiver::vital::homography_sptr() );
-  this->push_to_port_using_trait( thermal_to_optical_homog,
-    kwiver::vital::homography_sptr() );
-  this->push_to_port_using_trait( success_flag,
-    true );
+  // A fixed rig transform replaces the registration of the frames
+  const bool fixed = static_cast< bool >( d->m_optical_to_thermal );
+
+  if( !d->m_pool )
+  {
+    push_result( fixed ?
+      apply_fixed_homography( frame1, frame2, output_frame1_time ) :
+      register_frames( frame1, frame2, output_frame1_time ) );
+    return;
+  }
+
+  d->m_pending.push_back( d->m_pool->enqueue(
+    [this, frame1, frame2, output_frame1_time, fixed]()
+    {
+      return fixed ?
+        apply_fixed_homography( frame1, frame2, output_frame1_time ) :
+        register_frames( frame1, frame2, output_frame1_time );
+    } ) );
+
+  // Bound the frames held by queued registrations
+  while( d->m_pending.size() > 2 * d->m_pool->size() )
+  {
+    push_result( d->m_pending.front().get() );
+    d->m_pending.pop_front();
+  }
 }
 
 
+// -----------------------------------------------------------------------------
 void
 align_multimodal_imagery_process
-::output_no_match( const buffered_frame& frame, unsigned stream_id )
+::output_no_match( const buffered_frame& frame, const unsigned stream_id )
 {
   if( !d->m_output_frames_without_match )
   {
     return;
   }
 
-  if( stream_id == 0 )
+  if( !d->m_pool )
   {
-    this->push_to_port_using_trait( optical_image,
-      frame.image );
-    this->push_to_port_using_trait( thermal_image,
-      kwiver::vital::image_container_sptr() );
-    this->push_to_port_using_trait( optical_file_name,
-      frame.name );
-    this->push_to_port_using_trait( thermal_file_name,
-      std::string() );
+    push_result( no_match( frame, stream_id ) );
+    return;
   }
-  else if( stream_id == 1 )
+
+  // Queued behind the pending registrations to keep the output order
+  std::promise< registration_result > result;
+  result.set_value( no_match( frame, stream_id ) );
+  d->m_pending.push_back( result.get_future() );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+align_multimodal_imagery_process
+::push_ready_results( const bool wait_all )
+{
+  while( !d->m_pending.empty() &&
+         ( wait_all || d->m_pending.front().wait_for( std::chrono::seconds( 0 ) ) ==
+                         std::future_status::ready ) )
   {
-    this->push_to_port_using_trait( optical_image,
-      kwiver::vital::image_container_sptr() );
-    this->push_to_port_using_trait( thermal_image,
-      frame.image );
-    this->push_to_port_using_trait( optical_file_name,
-      std::string() );
-    this->push_to_port_using_trait( thermal_file_name,
-      frame.name );
+    push_result( d->m_pending.front().get() );
+    d->m_pending.pop_front();
   }
-  else
+}
+
+
+// -----------------------------------------------------------------------------
+void
+align_multimodal_imagery_process
+::finish_registrations()
+{
+  for( auto& pending : d->m_pending )
   {
-    throw std::runtime_error( "Invalid index" );
+    pending.wait();
+  }
+
+  d->m_pending.clear();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+align_multimodal_imagery_process
+::push_result( const registration_result& result )
+{
+  if( !result.success && !d->m_output_frames_without_match )
+  {
+    return;
   }
 
+  // Output required elements depending on connections
+  this->push_to_port_using_trait( optical_image,
+    result.optical.image );
+  this->push_to_port_using_trait( optical_file_name,
+    result.optical.name );
+  this->push_to_port_using_trait( thermal_image,
+    result.thermal.image );
+  this->push_to_port_using_trait( thermal_file_name,
+    result.thermal.name );
   this->push_to_port_using_trait( timestamp,
-    frame.ts );
+    result.ts );
   this->push_to_port_using_trait( warped_optical_image,
-    kwiver::vital::image_container_sptr() );
+    result.warped_optical );
   this->push_to_port_using_trait( warped_thermal_image,
-    kwiver::vital::image_container_sptr() );
+    result.warped_thermal );
   this->push_to_port_using_trait( optical_to_thermal_homog,
-    kwiver::vital::homography_sptr() );
+    result.optical_to_thermal );
   this->push_to_port_using_trait( thermal_to_optical_homog,
-    kwiver::vital::homography_sptr() );
+    result.thermal_to_optical );
+  this->push_to_port_using_trait( registration_stats,
+    result.statistics );
   this->push_to_port_using_trait( success_flag,
-    false );
+    result.success );
 }
 
 
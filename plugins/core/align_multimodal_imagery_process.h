@@ -43,6 +43,7 @@
 #include <sprokit/processes/kwiver_type_traits.h>
 
 #include <vital/types/image_container.h>
+#include <vital/types/homography.h>
 #include <vital/types/timestamp.h>
 
 #include <memory>
@@ -70,6 +71,8 @@ create_port_trait( warped_optical_image, image, "Warped optical image" );
 create_port_trait( warped_thermal_image, image, "Warped thermal image" );
 create_port_trait( optical_to_thermal_homog, homography, "Homography" );
 create_port_trait( thermal_to_optical_homog, homography, "Homography" );
+create_port_trait( registration_stats, string,
+  "Telemetry of the registration of each output frame, if computed" );
 
 
 // -----------------------------------------------------------------------------
@@ -93,6 +96,8 @@ protected:
 
   struct buffered_frame
   {
+    buffered_frame() {}
+
     buffered_frame( kwiver::vital::image_container_sptr _image,
                     kwiver::vital::timestamp _ts,
                     std::string _name )
@@ -105,23 +110,65 @@ protected:
     kwiver::vital::timestamp ts;
     std::string name;
 
-    double time()
+    double time() const
     {
       return static_cast< double >( ts.get_time_usec() );
     }
   };
 
-  virtual void attempt_registration( const buffered_frame& frame1,
-                                     const buffered_frame& frame2,
-                                     const bool output_frame1_time );
+  // Values output for one frame or matched pair of frames
+  struct registration_result
+  {
+    registration_result() : success( false ) {}
+
+    buffered_frame optical;
+    buffered_frame thermal;
+    kwiver::vital::timestamp ts;
+
+    kwiver::vital::image_container_sptr warped_optical;
+    kwiver::vital::image_container_sptr warped_thermal;
+    kwiver::vital::homography_sptr optical_to_thermal;
+    kwiver::vital::homography_sptr thermal_to_optical;
+
+    // Registration telemetry, empty if not computed
+    std::string statistics;
+
+    bool success;
+  };
+
+  // Register a matched pair of frames. This is called from the registration
+  // workers when registration_threads is set, so it must be thread safe.
+  virtual registration_result register_frames( const buffered_frame& frame1,
+                                               const buffered_frame& frame2,
+                                               const bool output_frame1_time );
+
+  // Result of a frame output without a match
+  registration_result no_match( const buffered_frame& frame,
+                                const unsigned stream_id ) const;
+
+  // Wait for the queued registrations, discarding their results, before
+  // the state they use is destroyed
+  void finish_registrations();
 
-  virtual void output_no_match( const buffered_frame& frame,
-                                const unsigned stream_id );
+  void attempt_registration( const buffered_frame& frame1,
+                             const buffered_frame& frame2,
+                             const bool output_frame1_time );
+
+  void output_no_match( const buffered_frame& frame,
+                        const unsigned stream_id );
 
 private:
   void make_ports();
   void make_config();
 
+  // Result of a matched pair of frames using the configured rig transform
+  registration_result apply_fixed_homography( const buffered_frame& optical,
+                                              const buffered_frame& thermal,
+                                              const bool output_optical_time );
+
+  void push_result( const registration_result& result );
+  void push_ready_results( const bool wait_all );
+
   class priv;
   const std::unique_ptr<priv> d;
 
@@ -4,6 +4,8 @@
  */
 
 #include "append_detections_to_tracks_process.h"
+#include "image_memory_budget.h"
+#include "process_trace.h"
 
 #include <vital/vital_types.h>
 #include <vital/types/image_container.h>
@@ -31,6 +33,11 @@ create_config_trait( max_frame_count, unsigned, "0",
   "If set, generate an appended detected object to an object track set for frames before max_frame_count" );
 create_config_trait( do_wait_process_end_before_sending_output, bool, "0",
   "If set, waits until the in port detection set is at the end before sending the results" );
+create_config_trait( output_horizon, unsigned, "0",
+  "If set with do_wait_process_end_before_sending_output, sends the track segments "
+  "accumulated over this many frames and releases their states, instead of "
+  "holding every state until the end of the input. Results are also sent as soon "
+  "as max_frame_count is reached, since no later state can be appended." );
 
 // =============================================================================
 // Private implementation class
@@ -44,14 +51,23 @@ public:
   unsigned m_min_frame_count;
   unsigned m_max_frame_count;
   bool m_do_wait_process_end_before_sending_output;
+  unsigned m_output_horizon;
   unsigned m_max_detection{};
 
   // Internal variables
   unsigned m_track_counter;
   unsigned m_frame_counter;
+  unsigned m_horizon_counter;
+  bool m_is_finalized;
   kv::object_track_set_sptr m_output{};
   std::vector<std::vector< kv::track_state_sptr >> m_states;
 
+  // Detection masks held by m_states, reported to the image memory budget
+  image_memory_holder m_states_memory;
+
+  // Returns the current output and drops the states it holds
+  kv::object_track_set_sptr release_output();
+
   // Other variables
   append_detections_to_tracks_process* parent;
 
@@ -65,8 +81,11 @@ append_detections_to_tracks_process::priv
   : m_min_frame_count( 0 )
   , m_max_frame_count( 0 )
   , m_do_wait_process_end_before_sending_output( false )
+  , m_output_horizon( 0 )
   , m_track_counter( 0 )
   , m_frame_counter( 0 )
+  , m_horizon_counter( 0 )
+  , m_is_finalized( false )
   , parent( ptr )
   , m_logger( kv::get_logger( "append_detections_to_tracks_process" ) )
 {
@@ -79,6 +98,30 @@ append_detections_to_tracks_process::priv
 }
 
 
+kv::object_track_set_sptr
+append_detections_to_tracks_process::priv
+::release_output()
+{
+  kv::object_track_set_sptr output = m_output;
+
+  if( !output )
+  {
+    output = std::make_shared< kv::object_track_set >();
+  }
+
+  // Keep the track slots so that IDs stay stable across segments
+  for( auto& states : m_states )
+  {
+    states.clear();
+  }
+  m_states_memory.clear();
+
+  m_output.reset();
+  m_horizon_counter = 0;
+  return output;
+}
+
+
 // =============================================================================
 append_detections_to_tracks_process
 ::append_detections_to_tracks_process( kv::config_block_sptr const& config )
@@ -125,6 +168,7 @@ append_detections_to_tracks_process
   declare_config_using_trait( min_frame_count );
   declare_config_using_trait( max_frame_count );
   declare_config_using_trait( do_wait_process_end_before_sending_output );
+  declare_config_using_trait( output_horizon );
 }
 
 
@@ -136,6 +180,7 @@ append_detections_to_tracks_process
   d->m_min_frame_count = config_value_using_trait( min_frame_count );
   d->m_max_frame_count = config_value_using_trait( max_frame_count );
   d->m_do_wait_process_end_before_sending_output = config_value_using_trait( do_wait_process_end_before_sending_output );
+  d->m_output_horizon = config_value_using_trait( output_horizon );
 
   if ( d->m_min_frame_count > d->m_max_frame_count )
   {
@@ -150,6 +195,8 @@ void
 append_detections_to_tracks_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
   kv::image_container_sptr image;
   kv::timestamp timestamp;
   kv::detected_object_set_sptr detections;
@@ -157,6 +204,9 @@ append_detections_to_tracks_process
   timestamp = grab_from_port_using_trait( timestamp );
   detections = grab_from_port_using_trait( detected_object_set );
 
+  trace.inputs_ready();
+  trace.count( "detections", detections ? detections->size() : 0 );
+
   d->m_max_detection = std::max((int) d->m_max_detection,(int) detections->size());
 
   if( !d->m_max_frame_count ||
@@ -176,6 +226,7 @@ append_detections_to_tracks_process
         d->m_states[detectId].push_back(
               std::make_shared< kv::object_track_state >(
                 timestamp, detections->at( detectId ) ) );
+        d->m_states_memory.add( image_memory_size( detections->at( detectId ) ) );
 
         kv::track_sptr ot = kv::track::create();
         ot->set_id( detectId );
@@ -191,6 +242,8 @@ append_detections_to_tracks_process
       d->m_output = std::make_shared<kv::object_track_set>(all_tracks);
       d->m_track_counter++;
     }
+
+    d->m_horizon_counter++;
   }
   d->m_frame_counter++;
   LOG_DEBUG(d->m_logger, "Accumulated non empty tracks (" << d->m_track_counter << "/" << d->m_frame_counter << ")");
@@ -200,7 +253,29 @@ append_detections_to_tracks_process
   // Otherwise, send an empty datum in the output ports
   auto port_info = peek_at_port_using_trait(detected_object_set);
   auto is_input_complete = port_info.datum->type() == sprokit::datum::complete;
-  if (!d->m_do_wait_process_end_before_sending_output || is_input_complete) {
+
+  // In streaming mode, send the segments accumulated so far once the horizon or max_frame_count is reached
+  const bool is_streaming = d->m_do_wait_process_end_before_sending_output && d->m_output_horizon;
+  const bool is_last_frame = d->m_max_frame_count && timestamp.get_frame() >= d->m_max_frame_count;
+
+  if (is_streaming) {
+    if (d->m_is_finalized) {
+      LOG_DEBUG(d->m_logger, "Sending empty.");
+      const auto dat = sprokit::datum::empty_datum();
+      push_datum_to_port_using_trait(timestamp, dat);
+      push_datum_to_port_using_trait(object_track_set, dat);
+    } else if (is_input_complete || is_last_frame || d->m_horizon_counter >= d->m_output_horizon) {
+      LOG_DEBUG(d->m_logger, "Sending appended object track segments.");
+      d->m_is_finalized = is_last_frame;
+      push_to_port_using_trait(timestamp, timestamp);
+      push_to_port_using_trait(object_track_set, d->release_output());
+    } else {
+      LOG_DEBUG(d->m_logger, "Sending empty.");
+      const auto dat = sprokit::datum::empty_datum();
+      push_datum_to_port_using_trait(timestamp, dat);
+      push_datum_to_port_using_trait(object_track_set, dat);
+    }
+  } else if (!d->m_do_wait_process_end_before_sending_output || is_input_complete) {
     LOG_DEBUG(d->m_logger, "Sending appended object tracks.");
     push_to_port_using_trait(timestamp, timestamp);
     push_to_port_using_trait(object_track_set, d->m_output);
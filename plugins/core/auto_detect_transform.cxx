@@ -3,47 +3,31 @@
 
 #include <vital/types/homography.h>
 
+#include <kwiversys/SystemTools.hxx>
+
 #include <fstream>
+#include <map>
+#include <mutex>
 
 namespace viame
 {
 
-
-auto_detect_transform_io
-::auto_detect_transform_io()
+namespace
 {
-}
 
-auto_detect_transform_io
-::~auto_detect_transform_io()
+// Transforms loaded by any instance, shared as they are never modified
+struct cached_transform
 {
-}
+  long modified_time;
+  unsigned long file_length;
+  kwiver::vital::transform_2d_sptr transform;
+};
 
-
-kwiver::vital::config_block_sptr
-auto_detect_transform_io
-::get_configuration() const
-{
-  return kwiver::vital::algo::transform_2d_io::get_configuration();
-}
-
-void
-auto_detect_transform_io
-::set_configuration( kwiver::vital::config_block_sptr /*config*/ )
-{
-  return;
-}
-
-bool
-auto_detect_transform_io
-::check_configuration( kwiver::vital::config_block_sptr /*config*/ ) const
-{
-  return true;
-}
+std::mutex g_cache_mutex;
+std::map< std::string, cached_transform > g_cache;
 
 kwiver::vital::transform_2d_sptr
-auto_detect_transform_io
-::load_( std::string const& filename ) const
+load_transform( std::string const& filename )
 {
   kwiver::vital::transform_2d_sptr output;
 
@@ -105,6 +89,71 @@ auto_detect_transform_io
   return output;
 }
 
+} // end anonymous namespace
+
+
+auto_detect_transform_io
+::auto_detect_transform_io()
+{
+}
+
+auto_detect_transform_io
+::~auto_detect_transform_io()
+{
+}
+
+
+kwiver::vital::config_block_sptr
+auto_detect_transform_io
+::get_configuration() const
+{
+  return kwiver::vital::algo::transform_2d_io::get_configuration();
+}
+
+void
+auto_detect_transform_io
+::set_configuration( kwiver::vital::config_block_sptr /*config*/ )
+{
+  return;
+}
+
+bool
+auto_detect_transform_io
+::check_configuration( kwiver::vital::config_block_sptr /*config*/ ) const
+{
+  return true;
+}
+
+kwiver::vital::transform_2d_sptr
+auto_detect_transform_io
+::load_( std::string const& filename ) const
+{
+  const std::string path = kwiversys::SystemTools::CollapseFullPath( filename );
+  const long modified_time = kwiversys::SystemTools::ModifiedTime( path );
+  const unsigned long file_length = kwiversys::SystemTools::FileLength( path );
+
+  {
+    std::lock_guard< std::mutex > lock( g_cache_mutex );
+
+    auto itr = g_cache.find( path );
+
+    if( itr != g_cache.end() &&
+        itr->second.modified_time == modified_time &&
+        itr->second.file_length == file_length )
+    {
+      return itr->second.transform;
+    }
+  }
+
+  // Parsed outside of the lock, concurrent first loads may both parse
+  kwiver::vital::transform_2d_sptr output = load_transform( filename );
+
+  std::lock_guard< std::mutex > lock( g_cache_mutex );
+  g_cache[ path ] = cached_transform{ modified_time, file_length, output };
+
+  return output;
+}
+
 void
 auto_detect_transform_io
 ::save_( std::string const& /*filename*/, kwiver::vital::transform_2d_sptr /*data*/ ) const
@@ -0,0 +1,259 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Run a detector on batches of consecutive frames
+ */
+
+#include "batch_detector_process.h"
+#include "batch_image_object_detector.h"
+#include "process_trace.h"
+
+#include <vital/algo/image_object_detector.h>
+#include <vital/types/detected_object_set.h>
+#include <vital/types/image_container.h>
+#include <vital/types/timestamp.h>
+
+#include <sprokit/processes/kwiver_type_traits.h>
+#include <sprokit/pipeline/process_exception.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+namespace kv = kwiver::vital;
+namespace algo = kwiver::vital::algo;
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( detector, std::string, "",
+  "Algorithm configuration subblock for the image_object_detector run on "
+  "each batch" );
+create_config_trait( batch_size, unsigned, "4",
+  "Number of frames collected before running the detector, the last batch "
+  "may be smaller" );
+
+// =============================================================================
+// Private implementation class
+class batch_detector_process::priv
+{
+public:
+  priv();
+  ~priv();
+
+  // Configuration settings
+  unsigned m_batch_size;
+
+  // Internal variables
+  algo::image_object_detector_sptr m_detector;
+
+  // Frames waiting for the next detector call
+  std::vector< kv::image_container_sptr > m_images;
+  std::vector< kv::timestamp > m_timestamps;
+  std::vector< std::string > m_file_names;
+};
+
+
+// -----------------------------------------------------------------------------
+batch_detector_process::priv
+::priv()
+  : m_batch_size( 4 )
+{
+}
+
+
+batch_detector_process::priv
+::~priv()
+{
+}
+
+
+// =============================================================================
+batch_detector_process
+::batch_detector_process( kv::config_block_sptr const& config )
+  : process( config ),
+    d( new batch_detector_process::priv() )
+{
+  make_ports();
+  make_config();
+}
+
+
+batch_detector_process
+::~batch_detector_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+batch_detector_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t required;
+  sprokit::process::port_flags_t optional;
+
+  required.insert( flag_required );
+
+  // -- inputs --
+  declare_input_port_using_trait( image, required );
+  declare_input_port_using_trait( timestamp, optional );
+  declare_input_port_using_trait( image_file_name, optional );
+
+  // -- outputs --
+  declare_output_port_using_trait( detected_object_set, optional );
+  declare_output_port_using_trait( timestamp, optional );
+  declare_output_port_using_trait( image_file_name, optional );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+batch_detector_process
+::make_config()
+{
+  declare_config_using_trait( detector );
+  declare_config_using_trait( batch_size );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+batch_detector_process
+::_configure()
+{
+  d->m_batch_size = std::max( 1u, config_value_using_trait( batch_size ) );
+
+  kv::config_block_sptr algo_config = get_config();
+
+  algo::image_object_detector::set_nested_algo_configuration(
+    "detector", algo_config, d->m_detector );
+
+  if( !d->m_detector )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Unable to create detector" );
+  }
+
+  algo::image_object_detector::get_nested_algo_configuration(
+    "detector", algo_config, d->m_detector );
+
+  if( !algo::image_object_detector::check_nested_algo_configuration(
+        "detector", algo_config ) )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Configuration check failed for detector" );
+  }
+
+  d->m_images.reserve( d->m_batch_size );
+  d->m_timestamps.reserve( d->m_batch_size );
+  d->m_file_names.reserve( d->m_batch_size );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+batch_detector_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  auto port_info = peek_at_port_using_trait( image );
+  const bool complete = ( port_info.datum->type() == sprokit::datum::complete );
+
+  if( complete )
+  {
+    grab_edge_datum_using_trait( image );
+
+    if( has_input_port_edge_using_trait( timestamp ) )
+    {
+      grab_edge_datum_using_trait( timestamp );
+    }
+    if( has_input_port_edge_using_trait( image_file_name ) )
+    {
+      grab_edge_datum_using_trait( image_file_name );
+    }
+  }
+  else
+  {
+    d->m_images.push_back( grab_from_port_using_trait( image ) );
+
+    d->m_timestamps.push_back(
+      has_input_port_edge_using_trait( timestamp ) ?
+      grab_from_port_using_trait( timestamp ) : kv::timestamp() );
+
+    d->m_file_names.push_back(
+      has_input_port_edge_using_trait( image_file_name ) ?
+      grab_from_port_using_trait( image_file_name ) : std::string() );
+  }
+
+  trace.inputs_ready();
+
+  // Detect over the full batch, or the remaining frames at the end of input
+  if( d->m_images.size() >= d->m_batch_size || ( complete && !d->m_images.empty() ) )
+  {
+    trace.count( "frames", d->m_images.size() );
+
+    auto detections = detect_in_batches( *d->m_detector, d->m_images );
+
+    for( size_t i = 0; i < detections.size(); ++i )
+    {
+      push_to_port_using_trait( detected_object_set, detections[i] );
+      push_to_port_using_trait( timestamp, d->m_timestamps[i] );
+      push_to_port_using_trait( image_file_name, d->m_file_names[i] );
+    }
+
+    d->m_images.clear();
+    d->m_timestamps.clear();
+    d->m_file_names.clear();
+  }
+
+  if( complete )
+  {
+    mark_process_as_complete();
+
+    const sprokit::datum_t dat = sprokit::datum::complete_datum();
+
+    push_datum_to_port_using_trait( detected_object_set, dat );
+    push_datum_to_port_using_trait( timestamp, dat );
+    push_datum_to_port_using_trait( image_file_name, dat );
+  }
+}
+
+} // end namespace core
+
+} // end namespace viame
@@ -0,0 +1,83 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Run a detector on batches of consecutive frames
+ */
+
+#ifndef VIAME_BATCH_DETECTOR_PROCESS_H
+#define VIAME_BATCH_DETECTOR_PROCESS_H
+
+#include <sprokit/pipeline/process.h>
+
+#include <plugins/core/viame_processes_core_export.h>
+
+#include <memory>
+
+namespace viame
+{
+
+namespace core
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Collect frames and detect objects over all of them in one call
+ *
+ * Detectors implementing batch_image_object_detector receive whole batches,
+ * others are run once per frame. Outputs are produced in input order once
+ * each batch is full, or when the input completes.
+ */
+class VIAME_PROCESSES_CORE_NO_EXPORT batch_detector_process
+  : public sprokit::process
+{
+public:
+  // -- CONSTRUCTORS --
+  batch_detector_process( kwiver::vital::config_block_sptr const& config );
+  virtual ~batch_detector_process();
+
+protected:
+  virtual void _configure();
+  virtual void _step();
+
+private:
+  void make_ports();
+  void make_config();
+
+  class priv;
+  const std::unique_ptr< priv > d;
+
+}; // end class batch_detector_process
+
+} // end namespace core
+} // end namespace viame
+
+#endif // VIAME_BATCH_DETECTOR_PROCESS_H
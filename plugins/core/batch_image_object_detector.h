@@ -0,0 +1,125 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Optional extension for detectors processing several images per call
+ */
+
+#ifndef VIAME_CORE_BATCH_IMAGE_OBJECT_DETECTOR_H
+#define VIAME_CORE_BATCH_IMAGE_OBJECT_DETECTOR_H
+
+#include <vital/algo/image_object_detector.h>
+#include <vital/exceptions.h>
+#include <vital/types/detected_object_set.h>
+#include <vital/types/image_container.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Interface for detectors able to process a batch of images at once
+ *
+ * Implemented alongside kwiver::vital::algo::image_object_detector by detectors
+ * whose per-call costs, such as GPU transfers and kernel launches, can be
+ * shared between images. Callers find it with a dynamic_cast on the detector.
+ */
+class batch_image_object_detector
+{
+public:
+  virtual ~batch_image_object_detector() = default;
+
+  /// Detect objects in each image, returning one set per image in order
+  virtual std::vector< kwiver::vital::detected_object_set_sptr >
+  detect_batch(
+    std::vector< kwiver::vital::image_container_sptr > const& images ) const = 0;
+
+  /// Largest batch passed to detect_batch, or 0 for no limit
+  virtual size_t max_batch_size() const { return 0; }
+};
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Detect objects in several images with any detector
+ *
+ * Batch detectors are called once per max_batch_size images, others once per
+ * image.
+ */
+inline std::vector< kwiver::vital::detected_object_set_sptr >
+detect_in_batches(
+  kwiver::vital::algo::image_object_detector const& detector,
+  std::vector< kwiver::vital::image_container_sptr > const& images )
+{
+  std::vector< kwiver::vital::detected_object_set_sptr > output;
+  output.reserve( images.size() );
+
+  auto batch_detector = dynamic_cast< batch_image_object_detector const* >( &detector );
+
+  if( !batch_detector )
+  {
+    for( auto const& image : images )
+    {
+      output.push_back( detector.detect( image ) );
+    }
+    return output;
+  }
+
+  const size_t batch_size = batch_detector->max_batch_size() > 0 ?
+    batch_detector->max_batch_size() : std::max< size_t >( images.size(), 1 );
+
+  for( size_t begin = 0; begin < images.size(); begin += batch_size )
+  {
+    const size_t end = std::min( begin + batch_size, images.size() );
+
+    auto sets = batch_detector->detect_batch(
+      std::vector< kwiver::vital::image_container_sptr >(
+        images.begin() + begin, images.begin() + end ) );
+
+    if( sets.size() != end - begin )
+    {
+      VITAL_THROW( kwiver::vital::invalid_data,
+                   "Batch detector returned " + std::to_string( sets.size() ) +
+                   " detection sets for " + std::to_string( end - begin ) + " images" );
+    }
+
+    output.insert( output.end(), sets.begin(), sets.end() );
+  }
+
+  return output;
+}
+
+} // end namespace viame
+
+#endif // VIAME_CORE_BATCH_IMAGE_OBJECT_DETECTOR_H
@@ -0,0 +1,371 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "cached_detector.h"
+
+#include "read_detected_object_set_viame_csv.h"
+#include "write_detected_object_set_viame_csv.h"
+
+#include <vital/exceptions.h>
+#include <vital/logger/logger.h>
+#include <vital/types/image_container.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+namespace
+{
+
+// 64-bit FNV-1a, matching the other on-disk caches
+class fnv_hash
+{
+public:
+  fnv_hash() : value( 14695981039346656037ULL ) {}
+
+  void add( const void* data, size_t size )
+  {
+    auto bytes = static_cast< const unsigned char* >( data );
+
+    for( size_t i = 0; i < size; ++i )
+    {
+      value ^= bytes[i];
+      value *= 1099511628211ULL;
+    }
+  }
+
+  void add( std::string const& str )
+  {
+    add( str.data(), str.size() );
+    add( "", 1 );
+  }
+
+  uint64_t value;
+};
+
+// Hash of the pixel values and layout of an image, independent of strides
+uint64_t
+image_hash( kv::image const& img )
+{
+  fnv_hash hash;
+
+  const uint64_t shape[4] = { img.width(), img.height(), img.depth(),
+    static_cast< uint64_t >( img.pixel_traits().num_bytes ) };
+  hash.add( shape, sizeof( shape ) );
+
+  const size_t bytes = img.pixel_traits().num_bytes;
+  auto first = static_cast< const unsigned char* >( img.first_pixel() );
+
+  if( img.is_contiguous() )
+  {
+    hash.add( first, img.width() * img.height() * img.depth() * bytes );
+    return hash.value;
+  }
+
+  for( size_t k = 0; k < img.depth(); ++k )
+  {
+    for( size_t j = 0; j < img.height(); ++j )
+    {
+      for( size_t i = 0; i < img.width(); ++i )
+      {
+        hash.add( first + ( i * img.w_step() + j * img.h_step() +
+                            k * img.d_step() ) * bytes, bytes );
+      }
+    }
+  }
+
+  return hash.value;
+}
+
+} // end anonymous namespace
+
+// =============================================================================
+class cached_detector::priv
+{
+public:
+  priv()
+    : read_only( false )
+    , config_key( 0 )
+    , m_logger( kv::get_logger( "viame.core.cached_detector" ) )
+  {}
+
+  std::string entry_path( uint64_t image_key ) const;
+
+  kv::detected_object_set_sptr load( std::string const& path,
+                                     std::string const& entry ) const;
+  void store( std::string const& path, std::string const& entry,
+              kv::detected_object_set_sptr const& detections ) const;
+
+  std::string cache_directory;
+  std::string model_identifier;
+  std::string version_identifier;
+  bool read_only;
+
+  uint64_t config_key;
+
+  // The nested detector is only created on the first cache miss, so that
+  // fully cached reruns never load the model
+  kv::config_block_sptr detector_config;
+  kv::algo::image_object_detector_sptr detector;
+  std::mutex detector_mutex;
+
+  kv::logger_handle_t m_logger;
+};
+
+// -----------------------------------------------------------------------------
+std::string
+cached_detector::priv
+::entry_path( uint64_t image_key ) const
+{
+  std::ostringstream path;
+  path << cache_directory << "/" << std::hex << config_key
+       << "/" << image_key << ".csv";
+  return path.str();
+}
+
+// -----------------------------------------------------------------------------
+kv::detected_object_set_sptr
+cached_detector::priv
+::load( std::string const& path, std::string const& entry ) const
+{
+  read_detected_object_set_viame_csv reader;
+  reader.set_configuration( reader.get_configuration() );
+  reader.open( path );
+
+  kv::detected_object_set_sptr output;
+  std::string image_name = entry;
+
+  // Entries without detections only hold the header, so yield no set
+  if( !reader.read_set( output, image_name ) || !output )
+  {
+    output = std::make_shared< kv::detected_object_set >();
+  }
+
+  reader.close();
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+void
+cached_detector::priv
+::store( std::string const& path, std::string const& entry,
+         kv::detected_object_set_sptr const& detections ) const
+{
+  const std::string directory =
+    kwiversys::SystemTools::GetFilenamePath( path );
+
+  if( !kwiversys::SystemTools::MakeDirectory( directory ) )
+  {
+    LOG_WARN( m_logger, "Unable to create detection cache directory " << directory );
+    return;
+  }
+
+  // Written to a temporary first so that concurrent readers never see a
+  // partial entry
+  const std::string temporary = path + ".tmp";
+  {
+    write_detected_object_set_viame_csv writer;
+    auto config = writer.get_configuration();
+    config->set_value( "model_identifier", model_identifier );
+    config->set_value( "version_identifier", version_identifier );
+    writer.set_configuration( config );
+    writer.open( temporary );
+    writer.write_set( detections, entry );
+    writer.close();
+  }
+  kwiversys::SystemTools::RenameFile( temporary, path );
+}
+
+// =============================================================================
+cached_detector
+::cached_detector()
+  : d( new priv() )
+{
+}
+
+
+cached_detector
+::~cached_detector()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+kv::config_block_sptr
+cached_detector
+::get_configuration() const
+{
+  auto config = kv::algo::image_object_detector::get_configuration();
+
+  config->set_value( "cache_directory", d->cache_directory,
+    "Directory holding stored detections. Entries are grouped in one "
+    "sub-directory per detector configuration, which can be removed to clear "
+    "the cache of a single model." );
+  config->set_value( "model_identifier", d->model_identifier,
+    "Identifier of the detection model, part of the cache key and written "
+    "to the stored viame_csv files. Change it whenever the model weights "
+    "change without a change to the detector configuration." );
+  config->set_value( "version_identifier", d->version_identifier,
+    "Version of the detection model, part of the cache key." );
+  config->set_value( "read_only", d->read_only,
+    "Only read existing entries, without storing results of cache misses." );
+
+  kv::algo::image_object_detector::get_nested_algo_configuration(
+    "detector", config, d->detector );
+
+  if( d->detector_config && !d->detector )
+  {
+    config->merge_config( d->detector_config );
+  }
+
+  return config;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+cached_detector
+::set_configuration( kv::config_block_sptr config )
+{
+  auto new_config = this->get_configuration();
+  new_config->merge_config( config );
+
+  d->cache_directory = new_config->get_value< std::string >( "cache_directory" );
+  d->model_identifier = new_config->get_value< std::string >( "model_identifier" );
+  d->version_identifier = new_config->get_value< std::string >( "version_identifier" );
+  d->read_only = new_config->get_value< bool >( "read_only" );
+
+  // Keep only the nested block, to be handed to the detector when created
+  d->detector_config = kv::config_block::empty_config();
+  fnv_hash hash;
+
+  hash.add( d->model_identifier );
+  hash.add( d->version_identifier );
+
+  for( auto const& key : new_config->available_values() )
+  {
+    if( key.compare( 0, 9, "detector:" ) == 0 )
+    {
+      const auto value = new_config->get_value< std::string >( key );
+
+      d->detector_config->set_value( key, value );
+      hash.add( key );
+      hash.add( value );
+    }
+  }
+
+  d->config_key = hash.value;
+
+  std::lock_guard< std::mutex > lock( d->detector_mutex );
+  d->detector.reset();
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+cached_detector
+::check_configuration( kv::config_block_sptr config ) const
+{
+  auto new_config = this->get_configuration();
+  new_config->merge_config( config );
+
+  if( new_config->get_value< std::string >( "cache_directory" ).empty() )
+  {
+    return false;
+  }
+
+  return kv::algo::image_object_detector::check_nested_algo_configuration(
+    "detector", new_config );
+}
+
+
+// -----------------------------------------------------------------------------
+kv::detected_object_set_sptr
+cached_detector
+::detect( kv::image_container_sptr image_data ) const
+{
+  if( !image_data )
+  {
+    return std::make_shared< kv::detected_object_set >();
+  }
+
+  const uint64_t image_key = image_hash( image_data->get_image() );
+  const std::string path = d->entry_path( image_key );
+
+  std::ostringstream entry;
+  entry << std::hex << image_key;
+
+  if( kwiversys::SystemTools::FileExists( path, true ) )
+  {
+    return d->load( path, entry.str() );
+  }
+
+  kv::algo::image_object_detector_sptr detector;
+  {
+    std::lock_guard< std::mutex > lock( d->detector_mutex );
+
+    if( !d->detector )
+    {
+      kv::algo::image_object_detector::set_nested_algo_configuration(
+        "detector", d->detector_config, d->detector );
+    }
+
+    detector = d->detector;
+  }
+
+  if( !detector )
+  {
+    VITAL_THROW( kv::algorithm_configuration_exception,
+      type_name(), impl_name(), "No nested detector configured" );
+  }
+
+  auto output = detector->detect( image_data );
+
+  if( !output )
+  {
+    output = std::make_shared< kv::detected_object_set >();
+  }
+
+  if( !d->read_only )
+  {
+    d->store( path, entry.str(), output );
+  }
+
+  return output;
+}
+
+} // end namespace viame
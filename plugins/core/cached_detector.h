@@ -0,0 +1,83 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Detector which stores nested detector results on disk for reuse
+ */
+
+#ifndef VIAME_CORE_CACHED_DETECTOR_H
+#define VIAME_CORE_CACHED_DETECTOR_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/algo/image_object_detector.h>
+
+#include <memory>
+
+namespace viame
+{
+
+/**
+ * @brief Cache nested detector output keyed by image content and model
+ *
+ * Each result is stored as a viame_csv file named by a hash of the image
+ * pixels, in a directory named by a hash of the nested detector configuration
+ * and the model and version identifiers. Reruns of a pipeline which only
+ * change downstream stages then read the stored detections instead of running
+ * the detector again, and the nested detector is only loaded on a cache miss.
+ */
+class VIAME_CORE_EXPORT cached_detector
+  : public kwiver::vital::algo::image_object_detector
+{
+public:
+  static constexpr char const* name = "cached";
+  static constexpr char const* description =
+    "Reuse stored nested detector output for images seen before";
+
+  cached_detector();
+  ~cached_detector() override;
+
+  kwiver::vital::config_block_sptr get_configuration() const override;
+
+  void set_configuration( kwiver::vital::config_block_sptr config ) override;
+
+  bool check_configuration( kwiver::vital::config_block_sptr config ) const override;
+
+  kwiver::vital::detected_object_set_sptr detect(
+    kwiver::vital::image_container_sptr image_data ) const override;
+
+private:
+  class priv;
+  const std::unique_ptr< priv > d;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_CACHED_DETECTOR_H
@@ -4,6 +4,7 @@
  */
 
 #include "calibrate_cameras_from_tracks_process.h"
+#include "process_trace.h"
 
 #include <vital/vital_types.h>
 #include <vital/types/timestamp.h>
@@ -22,7 +23,14 @@
 
 #include <sprokit/processes/kwiver_type_traits.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <memory>
+#include <set>
+#include <unordered_map>
 #include <arrows/ocv/camera_intrinsics.h>
 
 
@@ -41,6 +49,18 @@ create_config_trait(image_width, unsigned, "", "Camera image width in pixels.");
 create_config_trait(image_height, unsigned, "", "Camera image height in pixels.");
 create_config_trait(frame_count_threshold, unsigned, "",
                     "Maximum number of frames to use during calibration. 0 to use every frame available.");
+create_config_trait(frame_selection_method, std::string, "variance",
+                    "Frame selection method when more than frame_count_threshold frames are available. One of "
+                    "variance (K-Medians clustering) or coverage (incremental image coverage).");
+create_config_trait(parallel_distortion_search, bool, "false",
+                    "If true, evaluate the distortion parameter candidates of the intrinsic calibration in parallel.");
+
+create_config_trait(correspondence_table_input, std::string, "",
+                    "Optional binary correspondence table file. When set, the image / world correspondences are read "
+                    "from this file and the tracks received on the input ports are ignored.");
+create_config_trait(correspondence_table_output, std::string, "",
+                    "Optional binary correspondence table file written from the input tracks. It can be used as "
+                    "correspondence_table_input to skip the detection notes parsing on later calibrations.");
 
 create_port_trait(tracks_left, object_track_set, "Object track set of camera1.");
 create_port_trait(tracks_right, object_track_set, "Object track set of camera2.");
@@ -63,13 +83,36 @@ public:
   unsigned m_image_width;
   unsigned m_image_height;
   unsigned m_frame_count_threshold;
+  std::string m_frame_selection_method;
+  bool m_parallel_distortion_search;
+  std::string m_correspondence_table_input;
+  std::string m_correspondence_table_output;
 
   // Other variables
   calibrate_cameras_from_tracks_process *parent;
 
   kv::logger_handle_t m_logger;
 
-  static std::pair<std::string, float> get_attribute_value(const std::string &note);
+  /// Image / world point correspondence of one track state, as parsed from the detection notes
+  struct Correspondence {
+    std::int64_t track_id;
+    std::int64_t frame;
+    double image_x, image_y;
+    double world_x, world_y, world_z;
+    bool has_world;
+  };
+
+  using CorrespondenceTable = std::vector<Correspondence>;
+
+  static bool parse_world_point(const std::vector<std::string> &notes, kv::vector_3d &pt);
+
+  static CorrespondenceTable build_correspondence_table(const kv::object_track_set_sptr &object_track);
+
+  static void write_correspondence_tables(const std::string &path, const CorrespondenceTable &table1,
+                                          const CorrespondenceTable &table2);
+
+  static void read_correspondence_tables(const std::string &path, CorrespondenceTable &table1,
+                                         CorrespondenceTable &table2);
 
   static kv::feature_track_set_sptr merge_features_track(const kv::feature_track_set_sptr &feature_track1,
                                                          const kv::feature_track_set_sptr &feature_track2);
@@ -78,26 +121,150 @@ public:
   merge_landmarks_map(const kv::landmark_map_sptr &landmarks_map1, const kv::landmark_map_sptr &landmarks_map2);
 
   std::pair<kv::feature_track_set_sptr, kv::landmark_map_sptr>
-  split_object_track(const kv::object_track_set_sptr &object_track);
+  split_correspondence_table(const CorrespondenceTable &table);
 };
 
 
-std::pair<std::string, float>
-calibrate_cameras_from_tracks_process::priv::get_attribute_value(const std::string &note) {
-  // read a formatted notes in detection "(trk) :name=value"
-  std::size_t pos = note.find_first_of(':');
-  std::size_t pos2 = note.find_first_of('=');
+bool calibrate_cameras_from_tracks_process::priv::parse_world_point(const std::vector<std::string> &notes,
+                                                                    kv::vector_3d &pt) {
+  // read formatted notes in detection "(trk) :stereo3d_x=value", keeping the first value of each axis
+  static const char prefix[] = "stereo3d_";
+  static const size_t prefix_size = sizeof(prefix) - 1;
+
+  bool found[3] = {false, false, false};
+  for (const auto &note: notes) {
+    std::size_t pos = note.find_first_of(':');
+    if (pos == std::string::npos || note.size() < pos + prefix_size + 3 ||
+        note.compare(pos + 1, prefix_size, prefix) != 0 || note[pos + prefix_size + 2] != '=')
+      continue;
+
+    int axis = note[pos + prefix_size + 1] - 'x';
+    if (axis < 0 || axis > 2 || found[axis])
+      continue;
+
+    const char *value_begin = note.c_str() + pos + prefix_size + 3;
+    char *value_end = nullptr;
+    float value = std::strtof(value_begin, &value_end);
+    if (value_end == value_begin)
+      continue;
+
+    pt[axis] = value;
+    found[axis] = true;
+  }
+
+  return found[0] && found[1] && found[2];
+}
+
 
-  std::string attr_name = "";
-  float value = 0.;
-  if (pos == std::string::npos || pos2 == std::string::npos || pos2 == pos + 1) {
-    return std::make_pair(attr_name, value);
+calibrate_cameras_from_tracks_process::priv::CorrespondenceTable
+calibrate_cameras_from_tracks_process::priv::build_correspondence_table(
+    const kv::object_track_set_sptr &object_track) {
+  CorrespondenceTable table;
+  for (const auto &track: object_track->tracks()) {
+    for (auto state: *track | kv::as_object_track) {
+      Correspondence c{};
+      c.track_id = track->id();
+      c.frame = state->frame();
+
+      const auto center = state->detection()->bounding_box().center();
+      c.image_x = center[0];
+      c.image_y = center[1];
+
+      kv::vector_3d pt;
+      c.has_world = parse_world_point(state->detection()->notes(), pt);
+      if (c.has_world) {
+        c.world_x = pt[0];
+        c.world_y = pt[1];
+        c.world_z = pt[2];
+      }
+      table.push_back(c);
+    }
   }
+  return table;
+}
+
+
+namespace {
+
+const char correspondence_table_magic[] = "VIAMECT1";
+const size_t correspondence_table_magic_size = sizeof(correspondence_table_magic) - 1;
 
-  attr_name = note.substr(pos + 1, pos2 - 1);
-  value = std::stof(note.substr(pos2 + 1));
+template<typename T>
+void write_binary(std::ofstream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
 
-  return std::make_pair(attr_name, value);
+template<typename T>
+void read_binary(std::ifstream &in, T &value) {
+  in.read(reinterpret_cast<char *>(&value), sizeof(T));
+}
+
+} // namespace
+
+
+void calibrate_cameras_from_tracks_process::priv::write_correspondence_tables(const std::string &path,
+                                                                              const CorrespondenceTable &table1,
+                                                                              const CorrespondenceTable &table2) {
+  // Layout : magic, then for each camera the entry count followed by the fixed size entries
+  std::ofstream out(path, std::ios::binary);
+  if (!out) {
+    VITAL_THROW(kv::invalid_data, "Unable to open correspondence table for writing : " + path);
+  }
+
+  out.write(correspondence_table_magic, correspondence_table_magic_size);
+  for (const auto *table: {&table1, &table2}) {
+    write_binary(out, static_cast<std::uint64_t>(table->size()));
+    for (const auto &c: *table) {
+      write_binary(out, c.track_id);
+      write_binary(out, c.frame);
+      write_binary(out, c.image_x);
+      write_binary(out, c.image_y);
+      write_binary(out, c.world_x);
+      write_binary(out, c.world_y);
+      write_binary(out, c.world_z);
+      write_binary(out, static_cast<std::uint8_t>(c.has_world));
+    }
+  }
+
+  if (!out) {
+    VITAL_THROW(kv::invalid_data, "Failed to write correspondence table : " + path);
+  }
+}
+
+
+void calibrate_cameras_from_tracks_process::priv::read_correspondence_tables(const std::string &path,
+                                                                             CorrespondenceTable &table1,
+                                                                             CorrespondenceTable &table2) {
+  std::ifstream in(path, std::ios::binary);
+  char magic[correspondence_table_magic_size];
+  if (!in || !in.read(magic, correspondence_table_magic_size) ||
+      std::memcmp(magic, correspondence_table_magic, correspondence_table_magic_size) != 0) {
+    VITAL_THROW(kv::invalid_data, "Invalid correspondence table file : " + path);
+  }
+
+  for (auto *table: {&table1, &table2}) {
+    std::uint64_t size{};
+    read_binary(in, size);
+    table->clear();
+    for (std::uint64_t i = 0; in && i < size; i++) {
+      Correspondence c{};
+      std::uint8_t has_world{};
+      read_binary(in, c.track_id);
+      read_binary(in, c.frame);
+      read_binary(in, c.image_x);
+      read_binary(in, c.image_y);
+      read_binary(in, c.world_x);
+      read_binary(in, c.world_y);
+      read_binary(in, c.world_z);
+      read_binary(in, has_world);
+      c.has_world = has_world != 0;
+      table->push_back(c);
+    }
+
+    if (!in) {
+      VITAL_THROW(kv::invalid_data, "Truncated correspondence table file : " + path);
+    }
+  }
 }
 
 
@@ -141,63 +308,48 @@ calibrate_cameras_from_tracks_process::priv::merge_landmarks_map(const kv::landm
 
 
 std::pair<kv::feature_track_set_sptr, kv::landmark_map_sptr>
-calibrate_cameras_from_tracks_process::priv::split_object_track(const kv::object_track_set_sptr &object_track) {
+calibrate_cameras_from_tracks_process::priv::split_correspondence_table(const CorrespondenceTable &table) {
   std::set<kv::track_id_t> erase_id_set;
   kv::landmark_map::map_landmark_t landmarks;
   kv::feature_track_set_sptr features;
   std::vector<kv::track_sptr> tracks;
-  std::vector<kv::track_sptr> all_tracks = object_track->tracks();
-
-  // get landmarks coordinate from detection notes and init landmark_map
-  for (const auto &track: object_track->tracks()) {
-    for (auto state: *track | kv::as_object_track) {
-      if (state->detection()->notes().empty())
-        continue;
-
-      std::map<std::string, double> attrs;
-      for (const auto &note: state->detection()->notes()) {
-        attrs.insert(get_attribute_value(note));
+  std::unordered_map<kv::track_id_t, kv::track_sptr> tracks_by_id;
+
+  // init landmark_map from the world points and group image points by track, in table order
+  for (const auto &c: table) {
+    if (c.has_world) {
+      kv::vector_3d pt = kv::vector_3d(c.world_x, c.world_y, c.world_z);
+      auto landmark = landmarks.find(c.track_id);
+      if (landmark == std::end(landmarks)) {
+        landmarks[c.track_id] = kv::landmark_sptr(new kv::landmark_d(pt));
       }
-
-      // Only keep image and world points for which xyz values has been found in notes
-      if (attrs.count("stereo3d_x") && attrs.count("stereo3d_y") && attrs.count("stereo3d_z")) {
-        kv::vector_3d pt = kv::vector_3d(attrs["stereo3d_x"], attrs["stereo3d_y"], attrs["stereo3d_z"]);
-        if (!landmarks.count(track->id())) {
-          landmarks[track->id()] = kv::landmark_sptr(new kv::landmark_d(pt));
-        }
-          // we will erase the landmark if we have different pt coordinate for the same track_id
-        else if (landmarks[track->id()]->loc() != pt) {
-          erase_id_set.insert(track->id());
-        }
+        // we will erase the landmark if we have different pt coordinate for the same track_id
+      else if (landmark->second->loc() != pt) {
+        erase_id_set.insert(c.track_id);
       }
     }
+
+    auto &t = tracks_by_id[c.track_id];
+    if (!t) {
+      t = kv::track::create();
+      t->set_id(c.track_id);
+      tracks.push_back(t);
+    }
+
+    auto fts = std::make_shared<kv::feature_track_state>(c.frame);
+    fts->feature = std::make_shared<kv::feature_d>(kv::vector_2d(c.image_x, c.image_y));
+    fts->inlier = true;
+    t->append(fts);
   }
 
-  // erase invalid landmarks
+  // erase invalid landmarks and their features
   for (const auto &track_id: erase_id_set) {
     landmarks.erase(track_id);
   }
 
-  // get detected target corner pt
-  // only push features with valid landmarks into features set
-  auto is_erased = [&erase_id_set](size_t track_id) { return erase_id_set.find(track_id) != std::end(erase_id_set); };
-  for (const auto &track: all_tracks) {
-    if (is_erased(track->id()))
-      continue;
-
-    kv::track_sptr t = kv::track::create();
-    t->set_id(track->id());
-    tracks.push_back(t);
+  auto is_erased = [&erase_id_set](const kv::track_sptr &t) { return erase_id_set.count(t->id()) > 0; };
+  tracks.erase(std::remove_if(tracks.begin(), tracks.end(), is_erased), tracks.end());
 
-    for (auto state1: *track | kv::as_object_track) {
-      auto center = state1->detection()->bounding_box().center();
-
-      auto fts = std::make_shared<kv::feature_track_state>(state1->frame());
-      fts->feature = std::make_shared<kv::feature_d>(center);
-      fts->inlier = true;
-      t->append(fts);
-    }
-  }
   features = std::make_shared<kv::feature_track_set>(tracks);
 
   if (features->empty()) {
@@ -217,8 +369,9 @@ calibrate_cameras_from_tracks_process::priv::split_object_track(const kv::object
 
 // -----------------------------------------------------------------------------
 calibrate_cameras_from_tracks_process::priv::priv(calibrate_cameras_from_tracks_process *ptr)
-    : m_output_cameras_directory(""), m_track_set_left(""), m_track_set_right(""), m_frame_count_threshold(0), parent(
-    ptr) {
+    : m_output_cameras_directory(""), m_track_set_left(""), m_track_set_right(""), m_frame_count_threshold(0),
+      m_frame_selection_method("variance"), m_parallel_distortion_search(false), m_correspondence_table_input(""),
+      m_correspondence_table_output(""), parent(ptr) {
 }
 
 
@@ -263,6 +416,10 @@ void calibrate_cameras_from_tracks_process::make_config() {
   declare_config_using_trait(image_width);
   declare_config_using_trait(image_height);
   declare_config_using_trait(frame_count_threshold);
+  declare_config_using_trait(frame_selection_method);
+  declare_config_using_trait(parallel_distortion_search);
+  declare_config_using_trait(correspondence_table_input);
+  declare_config_using_trait(correspondence_table_output);
 }
 
 
@@ -272,23 +429,45 @@ void calibrate_cameras_from_tracks_process::_configure() {
   d->m_image_width = config_value_using_trait(image_width);
   d->m_image_height = config_value_using_trait(image_height);
   d->m_frame_count_threshold = config_value_using_trait(frame_count_threshold);
+  d->m_frame_selection_method = config_value_using_trait(frame_selection_method);
+  d->m_parallel_distortion_search = config_value_using_trait(parallel_distortion_search);
+  d->m_correspondence_table_input = config_value_using_trait(correspondence_table_input);
+  d->m_correspondence_table_output = config_value_using_trait(correspondence_table_output);
 }
 
 // -----------------------------------------------------------------------------
 void calibrate_cameras_from_tracks_process::_step() {
+  process_step_trace trace(name());
+
   kv::object_track_set_sptr object_track_set1, object_track_set2;
 
   object_track_set1 = grab_from_port_using_trait(tracks_left);
   object_track_set2 = grab_from_port_using_trait(tracks_right);
 
-  if (!object_track_set1 || !object_track_set2)
-    return;
+  trace.inputs_ready();
+
+  priv::CorrespondenceTable table1, table2;
+  if (!d->m_correspondence_table_input.empty()) {
+    d->read_correspondence_tables(d->m_correspondence_table_input, table1, table2);
+  } else {
+    if (!object_track_set1 || !object_track_set2)
+      return;
+
+    table1 = d->build_correspondence_table(object_track_set1);
+    table2 = d->build_correspondence_table(object_track_set2);
+  }
+
+  if (!d->m_correspondence_table_output.empty()) {
+    d->write_correspondence_tables(d->m_correspondence_table_output, table1, table2);
+  }
 
   auto config_optimizer = kv::config_block::empty_config();
   config_optimizer->set_value("image_width", d->m_image_width);
   config_optimizer->set_value("image_height", d->m_image_height);
   config_optimizer->set_value("frame_count_threshold", d->m_frame_count_threshold);
   config_optimizer->set_value("output_calibration_directory", d->m_output_cameras_directory);
+  config_optimizer->set_value("frame_selection_method", d->m_frame_selection_method);
+  config_optimizer->set_value("parallel_distortion_search", d->m_parallel_distortion_search);
 
   kv::camera_map::map_camera_t cameras;
   cameras[0] = std::make_shared<kv::simple_camera_perspective>();
@@ -297,8 +476,8 @@ void calibrate_cameras_from_tracks_process::_step() {
 
   // split object track set then merge features and landmarks
   std::pair<kv::feature_track_set_sptr, kv::landmark_map_sptr> split1, split2;
-  split1 = d->split_object_track(object_track_set1);
-  split2 = d->split_object_track(object_track_set2);
+  split1 = d->split_correspondence_table(table1);
+  split2 = d->split_correspondence_table(table2);
 
   // Sanity check on left and right tracks number after feature / landmark split
   auto t1_size = split1.first->tracks().size();
@@ -30,8 +30,12 @@
 
 #include "convert_head_tail_points.h"
 
+#include <vital/types/point.h>
+
 #include <cmath>
+#include <limits>
 #include <string>
+#include <vector>
 
 namespace viame
 {
@@ -55,8 +59,37 @@ public:
   std::string m_head_postfix;
   std::string m_tail_postfix;
   double m_box_expansion;
+
+  // Head or tail point given as its own detection
+  struct point_detection
+  {
+    kwiver::vital::point_2d location;
+    std::string category;
+    bool is_head;
+  };
+
+  // Category without the postfix, if the type name ends with it
+  static bool strip_postfix( const std::string& name, const std::string& postfix,
+                             std::string& category );
 };
 
+
+// -----------------------------------------------------------------------------
+bool
+convert_head_tail_points::priv
+::strip_postfix( const std::string& name, const std::string& postfix,
+                 std::string& category )
+{
+  if( postfix.empty() || name.size() <= postfix.size() ||
+      name.compare( name.size() - postfix.size(), postfix.size(), postfix ) != 0 )
+  {
+    return false;
+  }
+
+  category = name.substr( 0, name.size() - postfix.size() );
+  return true;
+}
+
 // =============================================================================
 
 convert_head_tail_points
@@ -83,6 +116,9 @@ convert_head_tail_points
     "Detection type postfix indicating head position." );
   config->set_value( "tail_postfix", d->m_tail_postfix,
     "Detection type postfix indicating tail position." );
+  config->set_value( "box_expansion", d->m_box_expansion,
+    "Fraction by which detection boxes are expanded when matching them "
+    "to head and tail points." );
 
   return config;
 }
@@ -95,6 +131,7 @@ convert_head_tail_points
 {
   d->m_head_postfix = config->get_value< std::string >( "head_postfix" );
   d->m_tail_postfix = config->get_value< std::string >( "tail_postfix" );
+  d->m_box_expansion = config->get_value< double >( "box_expansion" );
 }
 
 
@@ -115,6 +152,94 @@ convert_head_tail_points
 {
   auto output = std::make_shared< kwiver::vital::detected_object_set >();
 
+  if( !input_dets )
+  {
+    return output;
+  }
+
+  // Separate head and tail point detections from the object detections
+  std::vector< priv::point_detection > points;
+  std::vector< kwiver::vital::detected_object_sptr > objects;
+  std::vector< std::string > categories;
+  std::vector< kwiver::vital::bounding_box_d > search_boxes;
+
+  for( auto det : *input_dets )
+  {
+    std::string name, category;
+
+    if( det->type() )
+    {
+      double score;
+      det->type()->get_most_likely( name, score );
+    }
+
+    const auto& box = det->bounding_box();
+
+    if( priv::strip_postfix( name, d->m_head_postfix, category ) )
+    {
+      points.push_back( { kwiver::vital::point_2d( box.center() ), category, true } );
+    }
+    else if( priv::strip_postfix( name, d->m_tail_postfix, category ) )
+    {
+      points.push_back( { kwiver::vital::point_2d( box.center() ), category, false } );
+    }
+    else
+    {
+      const double dx = box.width() * d->m_box_expansion / 2;
+      const double dy = box.height() * d->m_box_expansion / 2;
+
+      objects.push_back( det );
+      categories.push_back( name );
+      search_boxes.push_back( kwiver::vital::bounding_box_d(
+        box.min_x() - dx, box.min_y() - dy, box.max_x() + dx, box.max_y() + dy ) );
+    }
+  }
+
+  // Attach each point to the object containing it, preferring objects of the
+  // same category and then the closest center
+  for( const auto& point : points )
+  {
+    const double x = point.location.value()[0], y = point.location.value()[1];
+    const std::string keypoint = ( point.is_head ? "head" : "tail" );
+
+    int best = -1;
+    bool best_same_category = false;
+    double best_distance = std::numeric_limits< double >::max();
+
+    for( unsigned i = 0; i < objects.size(); ++i )
+    {
+      const auto& box = search_boxes[i];
+
+      if( x < box.min_x() || x > box.max_x() || y < box.min_y() || y > box.max_y() ||
+          objects[i]->keypoints().count( keypoint ) )
+      {
+        continue;
+      }
+
+      const bool same_category = ( categories[i] == point.category );
+      const auto center = box.center();
+      const double distance = std::hypot( center[0] - x, center[1] - y );
+
+      if( best < 0 || ( same_category && !best_same_category ) ||
+          ( same_category == best_same_category && distance < best_distance ) )
+      {
+        best = i;
+        best_same_category = same_category;
+        best_distance = distance;
+      }
+    }
+
+    if( best >= 0 )
+    {
+      objects[ best ]->add_keypoint( keypoint, point.location );
+    }
+  }
+
+  for( auto det : objects )
+  {
+    output->add( det );
+  }
+
   return output;
 }
 
@@ -0,0 +1,144 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "csv_checkpoint.h"
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <fstream>
+#include <sstream>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+std::string
+csv_checkpoint_path( std::string const& output_file )
+{
+  return output_file + ".checkpoint";
+}
+
+// -----------------------------------------------------------------------------
+bool
+read_csv_checkpoint( std::string const& filename, csv_checkpoint& checkpoint )
+{
+  std::ifstream fin( filename );
+
+  if( !fin )
+  {
+    return false;
+  }
+
+  csv_checkpoint parsed;
+  bool has_frame = false, has_offset = false;
+  std::string line;
+
+  while( std::getline( fin, line ) )
+  {
+    if( line.empty() || line[0] == '#' )
+    {
+      continue;
+    }
+
+    std::istringstream fields( line );
+    std::string key;
+    fields >> key;
+
+    if( key == "frame" )
+    {
+      has_frame = static_cast< bool >( fields >> parsed.frame );
+    }
+    else if( key == "offset" )
+    {
+      has_offset = static_cast< bool >( fields >> parsed.offset );
+    }
+    else if( key == "next_id" )
+    {
+      fields >> parsed.next_id;
+    }
+  }
+
+  if( !has_frame || !has_offset )
+  {
+    return false;
+  }
+
+  checkpoint = parsed;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+bool
+write_csv_checkpoint( std::string const& filename,
+                      csv_checkpoint const& checkpoint )
+{
+  // Written to a temporary first so that a crash while writing never leaves
+  // a partial checkpoint behind
+  const std::string temporary = filename + ".tmp";
+  {
+    std::ofstream fout( temporary );
+    fout << "# viame csv checkpoint" << '\n'
+         << "frame " << checkpoint.frame << '\n'
+         << "offset " << checkpoint.offset << '\n'
+         << "next_id " << checkpoint.next_id << '\n';
+
+    if( !fout.flush() )
+    {
+      return false;
+    }
+  }
+
+  return kwiversys::SystemTools::RenameFile( temporary, filename );
+}
+
+// -----------------------------------------------------------------------------
+bool
+truncate_to_csv_checkpoint( std::string const& output_file,
+                            csv_checkpoint const& checkpoint )
+{
+  boost::system::error_code ec;
+
+  const auto size = boost::filesystem::file_size( output_file, ec );
+
+  if( ec || size < checkpoint.offset )
+  {
+    return false;
+  }
+
+  if( size > checkpoint.offset )
+  {
+    boost::filesystem::resize_file( output_file, checkpoint.offset, ec );
+  }
+
+  return !ec;
+}
+
+} // end namespace viame
@@ -0,0 +1,87 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Checkpoints of partially written csv outputs, used to resume runs
+ */
+
+#ifndef VIAME_CORE_CSV_CHECKPOINT_H
+#define VIAME_CORE_CSV_CHECKPOINT_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/vital_types.h>
+
+#include <cstdint>
+#include <string>
+
+namespace viame
+{
+
+/// Progress of a csv writer at a point where all its rows were flushed
+struct csv_checkpoint
+{
+  /// Last frame whose output is complete, frames are numbered from 1
+  kwiver::vital::frame_id_t frame = 0;
+
+  /// Size of the output file covering exactly the frames up to frame
+  std::uint64_t offset = 0;
+
+  /// Next detection or track id to write, so resumed ids stay unique
+  std::uint64_t next_id = 0;
+};
+
+/// Checkpoint file kept alongside the given csv output file
+VIAME_CORE_EXPORT std::string
+csv_checkpoint_path( std::string const& output_file );
+
+/// Read a checkpoint file, returns false if there is none or it is invalid
+VIAME_CORE_EXPORT bool
+read_csv_checkpoint( std::string const& filename, csv_checkpoint& checkpoint );
+
+/// Atomically replace a checkpoint file, returns false on failure
+VIAME_CORE_EXPORT bool
+write_csv_checkpoint( std::string const& filename,
+                      csv_checkpoint const& checkpoint );
+
+/**
+ * @brief Prepare an output file to be appended to after a checkpoint
+ *
+ * Rows after the checkpointed offset, from frames which were in flight when
+ * the previous run stopped, are removed. Returns false if the file does not
+ * hold the checkpointed data, in which case it should be written anew.
+ */
+VIAME_CORE_EXPORT bool
+truncate_to_csv_checkpoint( std::string const& output_file,
+                            csv_checkpoint const& checkpoint );
+
+} // end namespace viame
+
+#endif // VIAME_CORE_CSV_CHECKPOINT_H
@@ -0,0 +1,300 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of the viame_csv file parsing helpers
+ */
+
+#include "csv_file_parser.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+namespace viame
+{
+
+namespace bip = boost::interprocess;
+
+// =============================================================================
+class csv_file_view::priv
+{
+public:
+  std::unique_ptr< bip::mapped_region > m_region;
+  std::string m_buffer;
+};
+
+
+// -----------------------------------------------------------------------------
+csv_file_view
+::csv_file_view( std::string const& filename, std::istream& fallback_stream )
+  : d( new priv() )
+{
+  if( !filename.empty() )
+  {
+    try
+    {
+      bip::file_mapping file( filename.c_str(), bip::read_only );
+      d->m_region.reset( new bip::mapped_region( file, bip::read_only ) );
+      d->m_region->advise( bip::mapped_region::advice_sequential );
+      return;
+    }
+    catch( bip::interprocess_exception const& )
+    {
+      // Empty files or non mappable sources, read through the stream below
+      d->m_region.reset();
+    }
+  }
+
+  d->m_buffer.assign( std::istreambuf_iterator< char >( fallback_stream ),
+                      std::istreambuf_iterator< char >() );
+}
+
+
+csv_file_view
+::~csv_file_view()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+std::string_view
+csv_file_view
+::data() const
+{
+  if( d->m_region )
+  {
+    return std::string_view( static_cast< const char* >( d->m_region->get_address() ),
+                             d->m_region->get_size() );
+  }
+  return d->m_buffer;
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+csv_file_view
+::is_mapped() const
+{
+  return static_cast< bool >( d->m_region );
+}
+
+
+// =============================================================================
+csv_line_parser
+::csv_line_parser( std::string_view data, std::string const& delimiters )
+  : m_data( data )
+  , m_delimiters( delimiters )
+  , m_position( 0 )
+  , m_line_offset( 0 )
+{
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+csv_line_parser
+::next()
+{
+  static const char* const whitespace = " \t\r\n\f\v";
+
+  while( m_position < m_data.size() )
+  {
+    const std::size_t end = std::min( m_data.find( '\n', m_position ), m_data.size() );
+    std::string_view line = m_data.substr( m_position, end - m_position );
+    std::size_t line_start = m_position;
+    m_position = end + 1;
+
+    // Trim surrounding whitespace, including the '\r' of windows line endings
+    const std::size_t first = line.find_first_not_of( whitespace );
+    if( first == std::string_view::npos )
+    {
+      continue;
+    }
+    line = line.substr( first, line.find_last_not_of( whitespace ) - first + 1 );
+    line_start += first;
+
+    if( line[ 0 ] == '#' )
+    {
+      continue;
+    }
+
+    m_line = line;
+    m_line_offset = line_start;
+    csv_split_fields( line, m_delimiters, m_fields );
+    return true;
+  }
+
+  m_line = std::string_view();
+  m_fields.clear();
+  return false;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+csv_split_fields( std::string_view line, std::string_view delimiters,
+                  std::vector< std::string_view >& fields, bool skip_empty )
+{
+  fields.clear();
+
+  std::size_t field_start = 0;
+  while( true )
+  {
+    const std::size_t field_end = line.find_first_of( delimiters, field_start );
+    const std::string_view field = line.substr( field_start,
+      field_end == std::string_view::npos ? field_end : field_end - field_start );
+
+    if( !skip_empty || !field.empty() )
+    {
+      fields.push_back( field );
+    }
+    if( field_end == std::string_view::npos )
+    {
+      break;
+    }
+    field_start = field_end + 1;
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector< std::string_view >
+csv_split_lines( std::string_view data, std::size_t max_chunks,
+                 std::size_t min_chunk_size )
+{
+  std::vector< std::string_view > chunks;
+
+  const std::size_t chunk_count = std::max< std::size_t >( max_chunks, 1 );
+  const std::size_t target_size = std::max(
+    { ( data.size() + chunk_count - 1 ) / chunk_count, min_chunk_size,
+      std::size_t( 1 ) } );
+
+  std::size_t start = 0;
+  while( start < data.size() )
+  {
+    std::size_t end = start + target_size;
+
+    if( end >= data.size() )
+    {
+      end = data.size();
+    }
+    else
+    {
+      end = std::min( data.find( '\n', end - 1 ), data.size() - 1 ) + 1;
+    }
+
+    chunks.push_back( data.substr( start, end - start ) );
+    start = end;
+  }
+  return chunks;
+}
+
+
+// =============================================================================
+namespace {
+
+// Skip the leading whitespace and '+' sign that from_chars does not accept
+std::string_view
+number_start( std::string_view field )
+{
+  std::size_t pos = 0;
+  while( pos < field.size() &&
+         ( field[ pos ] == ' ' || ( field[ pos ] >= '\t' && field[ pos ] <= '\r' ) ) )
+  {
+    ++pos;
+  }
+  if( pos < field.size() && field[ pos ] == '+' )
+  {
+    ++pos;
+  }
+  return field.substr( pos );
+}
+
+} // end anonymous namespace
+
+
+// -----------------------------------------------------------------------------
+int
+csv_to_int( std::string_view field )
+{
+  field = number_start( field );
+
+  int value = 0;
+  std::from_chars( field.data(), field.data() + field.size(), value );
+  return value;
+}
+
+
+// -----------------------------------------------------------------------------
+double
+csv_to_double( std::string_view field )
+{
+  field = number_start( field );
+
+#if defined( __cpp_lib_to_chars ) && __cpp_lib_to_chars >= 201611L
+  double value = 0.0;
+  if( std::from_chars( field.data(), field.data() + field.size(), value ).ec == std::errc() )
+  {
+    return value;
+  }
+  return 0.0;
+#else
+  // Floating point from_chars is not available, parse a null terminated copy
+  char buffer[ 64 ];
+  const std::size_t size = std::min( field.size(), sizeof( buffer ) - 1 );
+  std::memcpy( buffer, field.data(), size );
+  buffer[ size ] = '\0';
+  return std::strtod( buffer, nullptr );
+#endif
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector< std::string >
+csv_fields_to_strings( std::vector< std::string_view > const& fields )
+{
+  std::vector< std::string > output;
+  output.reserve( fields.size() );
+
+  for( auto const& field : fields )
+  {
+    output.emplace_back( field );
+  }
+  return output;
+}
+
+} // end namespace
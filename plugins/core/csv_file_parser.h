@@ -0,0 +1,158 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Zero-copy reading and field splitting of viame_csv style files
+ */
+
+#ifndef VIAME_CORE_CSV_FILE_PARSER_H
+#define VIAME_CORE_CSV_FILE_PARSER_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Read-only contents of a CSV file
+ *
+ * Named files are memory-mapped, so that parsing runs directly on the page
+ * cache. When no file name is available, or the file cannot be mapped, the
+ * stream is read into an owned buffer instead.
+ */
+class VIAME_CORE_EXPORT csv_file_view
+{
+public:
+  csv_file_view( std::string const& filename, std::istream& fallback_stream );
+  ~csv_file_view();
+
+  csv_file_view( csv_file_view const& ) = delete;
+  csv_file_view& operator=( csv_file_view const& ) = delete;
+
+  /// Whole file contents, valid for the lifetime of this object
+  std::string_view data() const;
+
+  /// True if the contents are memory-mapped rather than copied
+  bool is_mapped() const;
+
+private:
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Sequential line and field splitter over CSV data
+ *
+ * Lines are trimmed of surrounding whitespace, and blank lines or lines
+ * starting with '#' are skipped. Fields are views into the input data and
+ * remain valid as long as the data does, until the next call to next().
+ */
+class VIAME_CORE_EXPORT csv_line_parser
+{
+public:
+  /// @param data CSV contents, such as csv_file_view::data() or a part of it
+  /// @param delimiters Any of these characters separates two fields
+  explicit csv_line_parser( std::string_view data,
+                            std::string const& delimiters = "," );
+
+  /// Advance to the next data line, returns false at the end of the data
+  bool next();
+
+  /// Current trimmed line
+  std::string_view line() const { return m_line; }
+
+  /// Fields of the current line, never empty after a successful next()
+  std::vector< std::string_view > const& fields() const { return m_fields; }
+
+  /// Byte offset of the current line start in the input data
+  std::size_t offset() const { return m_line_offset; }
+
+private:
+  std::string_view m_data;
+  std::string m_delimiters;
+  std::size_t m_position;
+  std::size_t m_line_offset;
+  std::string_view m_line;
+  std::vector< std::string_view > m_fields;
+};
+
+// -----------------------------------------------------------------------------
+/// Split a single line into views of its fields, separated by any of the
+/// delimiter characters. The fields vector is cleared first so that callers
+/// can reuse it across lines. Empty fields are dropped if skip_empty is set.
+VIAME_CORE_EXPORT void
+csv_split_fields( std::string_view line, std::string_view delimiters,
+                  std::vector< std::string_view >& fields,
+                  bool skip_empty = false );
+
+// -----------------------------------------------------------------------------
+/// Split CSV data into at most max_chunks parts of similar size, ending on line
+/// boundaries so that each part can be handed to its own csv_line_parser. No
+/// part is made smaller than min_chunk_size bytes, except the last one.
+VIAME_CORE_EXPORT std::vector< std::string_view >
+csv_split_lines( std::string_view data, std::size_t max_chunks,
+                 std::size_t min_chunk_size );
+
+// -----------------------------------------------------------------------------
+/// Integer value of a field, with the semantics of atoi: leading whitespace
+/// and sign are accepted, parsing stops at the first invalid character, and 0
+/// is returned if the field does not start with a number.
+VIAME_CORE_EXPORT int
+csv_to_int( std::string_view field );
+
+/// Floating point value of a field, with the semantics of atof
+VIAME_CORE_EXPORT double
+csv_to_double( std::string_view field );
+
+/// True if the field starts with the given prefix
+inline bool
+csv_starts_with( std::string_view field, std::string_view prefix )
+{
+  return field.size() >= prefix.size() &&
+         field.compare( 0, prefix.size(), prefix ) == 0;
+}
+
+/// Copies of the fields, for helpers working on string columns
+VIAME_CORE_EXPORT std::vector< std::string >
+csv_fields_to_strings( std::vector< std::string_view > const& fields );
+
+} // end namespace
+
+#endif // VIAME_CORE_CSV_FILE_PARSER_H
@@ -0,0 +1,352 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of the viame_csv row buffer
+ */
+
+#include "csv_row_buffer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace viame
+{
+
+// =============================================================================
+class csv_row_buffer::async_writer
+{
+public:
+  explicit async_writer( std::size_t max_blocks )
+    : m_max_blocks( max_blocks )
+    , m_stopping( false )
+    , m_writing( false )
+  {
+    m_thread = std::thread( [this]{ this->run(); } );
+  }
+
+  ~async_writer()
+  {
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_stopping = true;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+  }
+
+  // Queue a block, swapping in a recycled buffer for the caller
+  void submit( std::ostream& stream, std::string& block, bool flush )
+  {
+    std::unique_lock< std::mutex > lock( m_mutex );
+    m_condition.wait( lock, [this]{ return m_queue.size() < m_max_blocks; } );
+
+    m_queue.push_back( { &stream, std::move( block ), flush } );
+
+    block.clear();
+    if( !m_free_blocks.empty() )
+    {
+      block.swap( m_free_blocks.back() );
+      m_free_blocks.pop_back();
+    }
+
+    lock.unlock();
+    m_condition.notify_all();
+  }
+
+  void wait()
+  {
+    std::unique_lock< std::mutex > lock( m_mutex );
+    m_condition.wait( lock, [this]{ return m_queue.empty() && !m_writing; } );
+  }
+
+private:
+  struct pending_block
+  {
+    std::ostream* stream;
+    std::string data;
+    bool flush;
+  };
+
+  void run()
+  {
+    std::unique_lock< std::mutex > lock( m_mutex );
+
+    while( true )
+    {
+      m_condition.wait( lock, [this]{ return m_stopping || !m_queue.empty(); } );
+
+      if( m_queue.empty() )
+      {
+        return;
+      }
+
+      pending_block block = std::move( m_queue.front() );
+      m_queue.pop_front();
+      m_writing = true;
+      lock.unlock();
+
+      block.stream->write( block.data.data(), block.data.size() );
+      if( block.flush )
+      {
+        block.stream->flush();
+      }
+
+      lock.lock();
+      m_writing = false;
+      block.data.clear();
+      m_free_blocks.push_back( std::move( block.data ) );
+      m_condition.notify_all();
+    }
+  }
+
+  const std::size_t m_max_blocks;
+  bool m_stopping;
+  bool m_writing;
+  std::deque< pending_block > m_queue;
+  std::vector< std::string > m_free_blocks;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::thread m_thread;
+};
+
+
+// -----------------------------------------------------------------------------
+csv_row_buffer
+::csv_row_buffer( std::size_t block_size )
+  : m_block_size( block_size )
+  , m_precision( 6 )
+{
+  m_buffer.reserve( block_size > 0 ? block_size + 4096 : 4096 );
+}
+
+
+csv_row_buffer
+::~csv_row_buffer()
+{
+  // Joins the writer thread once the queued blocks are written
+  m_async.reset();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+csv_row_buffer
+::set_async( std::size_t max_blocks )
+{
+  m_async.reset();
+
+  if( max_blocks > 0 )
+  {
+    m_async.reset( new async_writer( max_blocks ) );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+csv_row_buffer
+::wait()
+{
+  if( m_async )
+  {
+    m_async->wait();
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+csv_row_buffer
+::write_out( std::ostream& stream, bool flush )
+{
+  if( m_async )
+  {
+    m_async->submit( stream, m_buffer, flush );
+    return;
+  }
+
+  stream.write( m_buffer.data(), m_buffer.size() );
+  m_buffer.clear();
+
+  if( flush )
+  {
+    stream.flush();
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+template< typename T >
+void
+csv_row_buffer
+::append_integer( T value )
+{
+  char digits[ 24 ];
+  const auto result = std::to_chars( digits, digits + sizeof( digits ), value );
+  m_buffer.append( digits, result.ptr );
+}
+
+
+// -----------------------------------------------------------------------------
+csv_row_buffer&
+csv_row_buffer
+::operator<<( char value )
+{
+  m_buffer.push_back( value );
+  return *this;
+}
+
+
+csv_row_buffer&
+csv_row_buffer
+::operator<<( const char* value )
+{
+  m_buffer.append( value );
+  return *this;
+}
+
+
+csv_row_buffer&
+csv_row_buffer
+::operator<<( std::string_view value )
+{
+  m_buffer.append( value.data(), value.size() );
+  return *this;
+}
+
+
+csv_row_buffer&
+csv_row_buffer
+::operator<<( int value )
+{
+  append_integer( value );
+  return *this;
+}
+
+
+csv_row_buffer&
+csv_row_buffer
+::operator<<( unsigned value )
+{
+  append_integer( value );
+  return *this;
+}
+
+
+csv_row_buffer&
+csv_row_buffer
+::operator<<( long value )
+{
+  append_integer( value );
+  return *this;
+}
+
+
+csv_row_buffer&
+csv_row_buffer
+::operator<<( unsigned long value )
+{
+  append_integer( value );
+  return *this;
+}
+
+
+csv_row_buffer&
+csv_row_buffer
+::operator<<( long long value )
+{
+  append_integer( value );
+  return *this;
+}
+
+
+csv_row_buffer&
+csv_row_buffer
+::operator<<( unsigned long long value )
+{
+  append_integer( value );
+  return *this;
+}
+
+
+// -----------------------------------------------------------------------------
+csv_row_buffer&
+csv_row_buffer
+::operator<<( double value )
+{
+  // Same as the %g conversion used by std::ostream without a floatfield
+  char digits[ 64 ];
+#if defined( __cpp_lib_to_chars ) && __cpp_lib_to_chars >= 201611L
+  const auto result = std::to_chars( digits, digits + sizeof( digits ), value,
+                                     std::chars_format::general, m_precision );
+  if( result.ec == std::errc() )
+  {
+    m_buffer.append( digits, result.ptr );
+    return *this;
+  }
+#endif
+  const int size = std::snprintf( digits, sizeof( digits ), "%.*g", m_precision, value );
+  m_buffer.append( digits, std::min< std::size_t >( size, sizeof( digits ) - 1 ) );
+  return *this;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+csv_row_buffer
+::end_row( std::ostream& stream )
+{
+  m_buffer.push_back( '\n' );
+
+  if( m_block_size > 0 && m_buffer.size() >= m_block_size )
+  {
+    write_out( stream, false );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+csv_row_buffer
+::flush( std::ostream& stream )
+{
+  write_out( stream, true );
+}
+
+} // end namespace
@@ -0,0 +1,119 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Reusable text buffer for formatting viame_csv style rows
+ */
+
+#ifndef VIAME_CORE_CSV_ROW_BUFFER_H
+#define VIAME_CORE_CSV_ROW_BUFFER_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Formats CSV rows into memory, writing them to a stream in blocks
+ *
+ * Values are formatted with to_chars into a buffer reused across rows, with
+ * the same output as the default formatting of std::ostream. Rows are written
+ * to the stream once the buffered size reaches the block size, or on flush().
+ *
+ * In asynchronous mode, written blocks are handed to a bounded queue drained
+ * by a dedicated thread, so that callers only wait when the queue is full.
+ */
+class VIAME_CORE_EXPORT csv_row_buffer
+{
+public:
+  /// @param block_size Buffered bytes that trigger a write in end_row(), 0 to
+  ///                   only write on flush()
+  explicit csv_row_buffer( std::size_t block_size = 0 );
+  ~csv_row_buffer();
+
+  csv_row_buffer( csv_row_buffer const& ) = delete;
+  csv_row_buffer& operator=( csv_row_buffer const& ) = delete;
+
+  void set_block_size( std::size_t block_size ) { m_block_size = block_size; }
+  std::size_t block_size() const { return m_block_size; }
+
+  /// Write blocks from a background thread, queuing at most max_blocks of
+  /// them, or write synchronously if max_blocks is 0
+  void set_async( std::size_t max_blocks );
+
+  /// Significant digits of floating point values, as std::ostream::precision
+  void set_precision( int precision ) { m_precision = precision; }
+
+  csv_row_buffer& operator<<( char value );
+  csv_row_buffer& operator<<( const char* value );
+  csv_row_buffer& operator<<( std::string_view value );
+  csv_row_buffer& operator<<( int value );
+  csv_row_buffer& operator<<( unsigned value );
+  csv_row_buffer& operator<<( long value );
+  csv_row_buffer& operator<<( unsigned long value );
+  csv_row_buffer& operator<<( long long value );
+  csv_row_buffer& operator<<( unsigned long long value );
+  csv_row_buffer& operator<<( double value );
+
+  /// Terminate the current row, writing the buffer out once a block is full
+  void end_row( std::ostream& stream );
+
+  /// Write out all buffered rows and flush the stream
+  void flush( std::ostream& stream );
+
+  /// Wait until the background thread has written all queued blocks
+  void wait();
+
+  /// True if no formatted data is waiting to be written
+  bool empty() const { return m_buffer.empty(); }
+
+private:
+  template< typename T > void append_integer( T value );
+  void write_out( std::ostream& stream, bool flush );
+
+  class async_writer;
+
+  std::unique_ptr< async_writer > m_async;
+  std::string m_buffer;
+  std::size_t m_block_size;
+  int m_precision;
+};
+
+} // end namespace
+
+#endif // VIAME_CORE_CSV_ROW_BUFFER_H
@@ -0,0 +1,628 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "descriptor_index.h"
+#include "thread_pool.h"
+
+#include <vital/exceptions.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace viame
+{
+
+namespace kv = kwiver::vital;
+
+namespace
+{
+
+char const index_magic[ 4 ] = { 'V', 'I', 'V', 'F' };
+std::uint32_t const index_version = 1;
+
+struct index_header
+{
+  char magic[ 4 ];
+  std::uint32_t version;
+  std::uint32_t dimension;
+  std::uint32_t num_lists;
+};
+
+// Descriptors are scanned in blocks of this many per task
+size_t const scan_block_size = 16384;
+
+inline float
+squared_distance( float const* a, float const* b, unsigned dimension )
+{
+  float sum = 0.0f;
+
+  for( unsigned i = 0; i < dimension; ++i )
+  {
+    const float diff = a[ i ] - b[ i ];
+    sum += diff * diff;
+  }
+
+  return sum;
+}
+
+// Max-heap of the closest descriptors seen so far
+typedef std::priority_queue< std::pair< float, size_t > > match_heap;
+
+inline void
+push_match( match_heap& heap, size_t count, float distance, size_t index )
+{
+  if( heap.size() < count )
+  {
+    heap.emplace( distance, index );
+  }
+  else if( distance < heap.top().first )
+  {
+    heap.pop();
+    heap.emplace( distance, index );
+  }
+}
+
+} // end anonymous namespace
+
+// -----------------------------------------------------------------------------
+class descriptor_index::priv
+{
+public:
+  priv( std::string const& path, bool writable, unsigned num_threads,
+        descriptor_store::encoding_t encoding )
+    : ivf_path( path + ".ivf" )
+    , lists_path( path + ".lists" )
+    , writable( writable )
+    , store( path, writable, encoding )
+    , workers( num_threads )
+  {}
+
+  std::string ivf_path;
+  std::string lists_path;
+  bool writable;
+
+  descriptor_store store;
+  mutable thread_pool workers;
+
+  unsigned num_lists = 0;
+  std::vector< float > centroids;
+  std::vector< std::vector< std::uint32_t > > lists;
+
+  // Assignments not written to the lists file yet
+  std::vector< std::uint32_t > pending_assignments;
+
+  void load();
+  void write_index() const;
+  std::uint32_t nearest_centroid( float const* values ) const;
+  void assign_stored( size_t first );
+
+  // Run fn( begin, end ) over [0, count) in blocks on the workers
+  template< typename F >
+  void for_blocks( size_t count, F fn ) const;
+};
+
+// -----------------------------------------------------------------------------
+template< typename F >
+void
+descriptor_index::priv
+::for_blocks( size_t count, F fn ) const
+{
+  std::vector< std::future< void > > tasks;
+
+  for( size_t begin = 0; begin < count; begin += scan_block_size )
+  {
+    const size_t end = std::min( count, begin + scan_block_size );
+    tasks.push_back( workers.enqueue( [&fn, begin, end]{ fn( begin, end ); } ) );
+  }
+
+  for( auto& task : tasks )
+  {
+    task.get();
+  }
+}
+
+// -----------------------------------------------------------------------------
+void
+descriptor_index::priv
+::load()
+{
+  if( !kwiversys::SystemTools::FileExists( ivf_path ) )
+  {
+    return;
+  }
+
+  std::ifstream input( ivf_path, std::ios::binary );
+  index_header header;
+
+  if( !input.read( reinterpret_cast< char* >( &header ), sizeof( header ) ) ||
+      std::memcmp( header.magic, index_magic, 4 ) != 0 ||
+      header.version != index_version || header.num_lists == 0 ||
+      header.dimension != store.dimension() )
+  {
+    VITAL_THROW( kv::invalid_data, "Invalid descriptor index " + ivf_path );
+  }
+
+  centroids.resize( static_cast< size_t >( header.num_lists ) * header.dimension );
+
+  if( !input.read( reinterpret_cast< char* >( centroids.data() ),
+                   centroids.size() * sizeof( float ) ) )
+  {
+    VITAL_THROW( kv::invalid_data, "Truncated descriptor index " + ivf_path );
+  }
+
+  num_lists = header.num_lists;
+  lists.assign( num_lists, std::vector< std::uint32_t >() );
+
+  // Assignments are written after their descriptors, so there may be fewer
+  // of them than stored descriptors but never more
+  std::ifstream assignments( lists_path, std::ios::binary );
+  std::uint32_t list;
+  size_t index = 0;
+
+  while( index < store.size() &&
+         assignments.read( reinterpret_cast< char* >( &list ), sizeof( list ) ) &&
+         list < num_lists )
+  {
+    lists[ list ].push_back( static_cast< std::uint32_t >( index++ ) );
+  }
+
+  assign_stored( index );
+}
+
+// -----------------------------------------------------------------------------
+void
+descriptor_index::priv
+::write_index() const
+{
+  const std::string temp_path = ivf_path + ".tmp";
+
+  {
+    std::ofstream output( temp_path, std::ios::binary | std::ios::trunc );
+
+    index_header header;
+    std::memcpy( header.magic, index_magic, 4 );
+    header.version = index_version;
+    header.dimension = store.dimension();
+    header.num_lists = num_lists;
+
+    output.write( reinterpret_cast< char const* >( &header ), sizeof( header ) );
+    output.write( reinterpret_cast< char const* >( centroids.data() ),
+                  centroids.size() * sizeof( float ) );
+
+    if( !output )
+    {
+      VITAL_THROW( kv::file_write_exception, temp_path, "Unable to write index" );
+    }
+  }
+
+  // Assignments are rewritten in store order
+  std::vector< std::uint32_t > assignments( store.size() - pending_assignments.size() );
+
+  for( std::uint32_t list = 0; list < num_lists; ++list )
+  {
+    for( auto index : lists[ list ] )
+    {
+      if( index < assignments.size() )
+      {
+        assignments[ index ] = list;
+      }
+    }
+  }
+
+  {
+    std::ofstream output( lists_path, std::ios::binary | std::ios::trunc );
+    output.write( reinterpret_cast< char const* >( assignments.data() ),
+                  assignments.size() * sizeof( std::uint32_t ) );
+
+    if( !output )
+    {
+      VITAL_THROW( kv::file_write_exception, lists_path, "Unable to write index" );
+    }
+  }
+
+  if( !kwiversys::SystemTools::RenameFile( temp_path, ivf_path ) )
+  {
+    VITAL_THROW( kv::file_write_exception, ivf_path, "Unable to replace index" );
+  }
+}
+
+// -----------------------------------------------------------------------------
+std::uint32_t
+descriptor_index::priv
+::nearest_centroid( float const* values ) const
+{
+  const unsigned dimension = store.dimension();
+
+  std::uint32_t best = 0;
+  float best_distance = std::numeric_limits< float >::max();
+
+  for( std::uint32_t list = 0; list < num_lists; ++list )
+  {
+    const float distance =
+      squared_distance( values, &centroids[ list * dimension ], dimension );
+
+    if( distance < best_distance )
+    {
+      best = list;
+      best_distance = distance;
+    }
+  }
+
+  return best;
+}
+
+// -----------------------------------------------------------------------------
+void
+descriptor_index::priv
+::assign_stored( size_t first )
+{
+  const size_t count = store.size() - first;
+
+  if( count == 0 )
+  {
+    return;
+  }
+
+  std::vector< std::uint32_t > assignments( count );
+
+  for_blocks( count, [&]( size_t begin, size_t end )
+  {
+    std::vector< float > buffer( store.dimension() );
+
+    for( size_t i = begin; i < end; ++i )
+    {
+      assignments[ i ] = nearest_centroid(
+        store.vector( first + i, buffer.data() ) );
+    }
+  } );
+
+  for( size_t i = 0; i < count; ++i )
+  {
+    lists[ assignments[ i ] ].push_back( static_cast< std::uint32_t >( first + i ) );
+  }
+
+  if( writable )
+  {
+    pending_assignments.insert( pending_assignments.end(),
+                                assignments.begin(), assignments.end() );
+  }
+}
+
+// =============================================================================
+descriptor_index
+::descriptor_index( std::string const& path, bool writable, unsigned num_threads,
+                    descriptor_store::encoding_t encoding )
+  : d( new priv( path, writable, num_threads, encoding ) )
+{
+  d->load();
+}
+
+descriptor_index
+::~descriptor_index()
+{
+  if( d->writable )
+  {
+    flush();
+  }
+}
+
+// -----------------------------------------------------------------------------
+descriptor_store const&
+descriptor_index
+::store() const
+{
+  return d->store;
+}
+
+// -----------------------------------------------------------------------------
+bool
+descriptor_index
+::trained() const
+{
+  return d->num_lists > 0;
+}
+
+// -----------------------------------------------------------------------------
+unsigned
+descriptor_index
+::num_lists() const
+{
+  return d->num_lists;
+}
+
+// -----------------------------------------------------------------------------
+void
+descriptor_index
+::train( unsigned num_lists, size_t sample_size, unsigned iterations )
+{
+  if( !d->writable )
+  {
+    VITAL_THROW( kv::invalid_value, "Descriptor index opened read only" );
+  }
+
+  d->store.flush();
+
+  const size_t count = d->store.size();
+  const unsigned dimension = d->store.dimension();
+
+  if( num_lists == 0 || count < num_lists )
+  {
+    VITAL_THROW( kv::invalid_value, "Training " + std::to_string( num_lists ) +
+      " lists requires at least as many descriptors" );
+  }
+
+  // Sample evenly over the store, which follows the ingest order
+  if( sample_size == 0 || sample_size > count )
+  {
+    sample_size = count;
+  }
+  sample_size = std::max< size_t >( sample_size, num_lists );
+
+  std::vector< size_t > sample( sample_size );
+
+  for( size_t i = 0; i < sample_size; ++i )
+  {
+    sample[ i ] = i * count / sample_size;
+  }
+
+  d->num_lists = num_lists;
+  d->centroids.resize( static_cast< size_t >( num_lists ) * dimension );
+
+  for( unsigned list = 0; list < num_lists; ++list )
+  {
+    d->store.read( sample[ list * sample_size / num_lists ],
+                   &d->centroids[ list * dimension ] );
+  }
+
+  std::vector< float > buffer( dimension );
+
+  // Lloyd iterations, clusters left empty keep their previous centroid
+  std::vector< std::uint32_t > assignments( sample_size );
+
+  for( unsigned iteration = 0; iteration < iterations; ++iteration )
+  {
+    d->for_blocks( sample_size, [&]( size_t begin, size_t end )
+    {
+      std::vector< float > block_buffer( dimension );
+
+      for( size_t i = begin; i < end; ++i )
+      {
+        assignments[ i ] = d->nearest_centroid(
+          d->store.vector( sample[ i ], block_buffer.data() ) );
+      }
+    } );
+
+    std::vector< double > sums( d->centroids.size(), 0.0 );
+    std::vector< size_t > sizes( num_lists, 0 );
+
+    for( size_t i = 0; i < sample_size; ++i )
+    {
+      float const* values = d->store.vector( sample[ i ], buffer.data() );
+      double* sum = &sums[ assignments[ i ] * dimension ];
+
+      for( unsigned j = 0; j < dimension; ++j )
+      {
+        sum[ j ] += values[ j ];
+      }
+
+      ++sizes[ assignments[ i ] ];
+    }
+
+    for( unsigned list = 0; list < num_lists; ++list )
+    {
+      if( sizes[ list ] == 0 )
+      {
+        continue;
+      }
+
+      for( unsigned j = 0; j < dimension; ++j )
+      {
+        d->centroids[ list * dimension + j ] =
+          static_cast< float >( sums[ list * dimension + j ] / sizes[ list ] );
+      }
+    }
+  }
+
+  d->lists.assign( num_lists, std::vector< std::uint32_t >() );
+  d->pending_assignments.clear();
+  d->assign_stored( 0 );
+  d->pending_assignments.clear();
+
+  d->write_index();
+}
+
+// -----------------------------------------------------------------------------
+void
+descriptor_index
+::add( std::string const& uid, double const* values, unsigned dimension )
+{
+  const size_t index = d->store.size();
+
+  if( index >= std::numeric_limits< std::uint32_t >::max() )
+  {
+    VITAL_THROW( kv::invalid_value, "Descriptor index is full" );
+  }
+
+  d->store.add( uid, values, dimension );
+
+  if( trained() )
+  {
+    // Pending descriptors are always served in place
+    const std::uint32_t list = d->nearest_centroid(
+      d->store.vector( index, nullptr ) );
+
+    d->lists[ list ].push_back( static_cast< std::uint32_t >( index ) );
+    d->pending_assignments.push_back( list );
+  }
+}
+
+// -----------------------------------------------------------------------------
+void
+descriptor_index
+::flush()
+{
+  d->store.flush();
+
+  if( d->pending_assignments.empty() )
+  {
+    return;
+  }
+
+  std::ofstream output( d->lists_path, std::ios::binary | std::ios::app );
+  output.write( reinterpret_cast< char const* >( d->pending_assignments.data() ),
+                d->pending_assignments.size() * sizeof( std::uint32_t ) );
+
+  if( !output )
+  {
+    VITAL_THROW( kv::file_write_exception, d->lists_path, "Unable to write index" );
+  }
+
+  d->pending_assignments.clear();
+}
+
+// -----------------------------------------------------------------------------
+std::vector< descriptor_match >
+descriptor_index
+::search( double const* query, unsigned dimension, size_t count,
+          unsigned num_probes ) const
+{
+  std::vector< descriptor_match > output;
+
+  if( count == 0 || d->store.size() == 0 )
+  {
+    return output;
+  }
+  if( dimension != d->store.dimension() )
+  {
+    VITAL_THROW( kv::invalid_value, "Query dimension " +
+      std::to_string( dimension ) + " does not match the index" );
+  }
+
+  const std::vector< float > values( query, query + dimension );
+
+  // Descriptors to compare against, whole lists when trained
+  std::vector< std::pair< std::uint32_t const*, size_t > > ranges;
+  std::vector< std::uint32_t > all;
+
+  if( trained() )
+  {
+    std::vector< std::pair< float, std::uint32_t > > probes( d->num_lists );
+
+    for( std::uint32_t list = 0; list < d->num_lists; ++list )
+    {
+      probes[ list ] = { squared_distance( values.data(),
+        &d->centroids[ list * dimension ], dimension ), list };
+    }
+
+    const size_t num_probed = std::min< size_t >( std::max( 1u, num_probes ), d->num_lists );
+    std::partial_sort( probes.begin(), probes.begin() + num_probed, probes.end() );
+
+    for( size_t i = 0; i < num_probed; ++i )
+    {
+      auto const& list = d->lists[ probes[ i ].second ];
+
+      for( size_t begin = 0; begin < list.size(); begin += scan_block_size )
+      {
+        ranges.emplace_back( list.data() + begin,
+                             std::min( scan_block_size, list.size() - begin ) );
+      }
+    }
+  }
+  else
+  {
+    all.resize( d->store.size() );
+
+    for( size_t i = 0; i < all.size(); ++i )
+    {
+      all[ i ] = static_cast< std::uint32_t >( i );
+    }
+
+    for( size_t begin = 0; begin < all.size(); begin += scan_block_size )
+    {
+      ranges.emplace_back( all.data() + begin,
+                           std::min( scan_block_size, all.size() - begin ) );
+    }
+  }
+
+  // Scan ranges in parallel and merge the closest matches of each
+  std::vector< std::future< match_heap > > tasks;
+
+  for( auto const& range : ranges )
+  {
+    tasks.push_back( d->workers.enqueue( [&, range]
+    {
+      match_heap heap;
+      std::vector< float > buffer( dimension );
+
+      for( size_t i = 0; i < range.second; ++i )
+      {
+        const size_t index = range.first[ i ];
+        push_match( heap, count, squared_distance( values.data(),
+          d->store.vector( index, buffer.data() ), dimension ), index );
+      }
+
+      return heap;
+    } ) );
+  }
+
+  match_heap heap;
+
+  for( auto& task : tasks )
+  {
+    match_heap partial = task.get();
+
+    while( !partial.empty() )
+    {
+      push_match( heap, count, partial.top().first, partial.top().second );
+      partial.pop();
+    }
+  }
+
+  output.resize( heap.size() );
+
+  for( size_t i = heap.size(); i > 0; --i )
+  {
+    output[ i - 1 ] = { heap.top().second, std::sqrt( heap.top().first ) };
+    heap.pop();
+  }
+
+  return output;
+}
+
+} // end namespace viame
@@ -0,0 +1,110 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Approximate nearest neighbour index over a descriptor store
+ */
+
+#ifndef VIAME_CORE_DESCRIPTOR_INDEX_H
+#define VIAME_CORE_DESCRIPTOR_INDEX_H
+
+#include <plugins/core/viame_core_export.h>
+#include <plugins/core/descriptor_store.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace viame
+{
+
+/// Stored descriptor returned by a search
+struct descriptor_match
+{
+  size_t index;
+  float distance;
+};
+
+/**
+ * @brief Inverted file index of the descriptors of a descriptor_store
+ *
+ * Descriptors are clustered into lists around k-means centroids, kept in
+ * <path>.ivf, and every stored descriptor is assigned to the list of its
+ * closest centroid in <path>.lists. Searches only compare the query to the
+ * descriptors of the lists with the closest centroids, using the Euclidean
+ * distance. Until the index is trained searches are exhaustive.
+ *
+ * Descriptors added after training are assigned to their list directly, so
+ * the index grows incrementally; retraining is only needed when the data
+ * drifts away from the initial sample.
+ */
+class VIAME_CORE_EXPORT descriptor_index
+{
+public:
+  /// Open the index and store at path, creating them if writable
+  descriptor_index( std::string const& path, bool writable,
+                    unsigned num_threads = 0,
+                    descriptor_store::encoding_t encoding = descriptor_store::FLOAT32 );
+  ~descriptor_index();
+
+  descriptor_store const& store() const;
+
+  bool trained() const;
+  unsigned num_lists() const;
+
+  /**
+   * @brief Cluster the stored descriptors and assign them to lists
+   *
+   * Centroids are fit on at most sample_size descriptors spread over the
+   * store, all of them when 0, before every descriptor is assigned.
+   */
+  void train( unsigned num_lists, size_t sample_size = 0,
+              unsigned iterations = 10 );
+
+  /// Append a descriptor to the store and to its list when trained
+  void add( std::string const& uid, double const* values, unsigned dimension );
+
+  /// Write out added descriptors and their list assignments
+  void flush();
+
+  /// The count closest stored descriptors, searching num_probes lists
+  std::vector< descriptor_match > search( double const* query,
+    unsigned dimension, size_t count, unsigned num_probes ) const;
+
+private:
+  class priv;
+  const std::unique_ptr< priv > d;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_DESCRIPTOR_INDEX_H
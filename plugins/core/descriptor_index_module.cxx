@@ -0,0 +1,223 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Python module searching a descriptor index
+ *
+ * Gives query code such as the SMQTK IQR service access to indices written
+ * by the index_descriptors process without loading the descriptors, and
+ * scores them against banks of per-class SVM models in a single pass.
+ */
+
+#include <plugins/core/descriptor_index.h>
+#include <plugins/core/svm_model_bank.h>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace viame
+{
+
+namespace
+{
+
+using query_array = py::array_t< double, py::array::c_style | py::array::forcecast >;
+
+// -----------------------------------------------------------------------------
+std::pair< std::vector< std::string >, std::vector< float > >
+search( descriptor_index const& index, query_array const& query,
+        size_t count, unsigned num_probes )
+{
+  if( query.ndim() != 1 )
+  {
+    throw py::value_error( "Queries must be 1 dimensional" );
+  }
+
+  std::vector< descriptor_match > matches;
+  {
+    py::gil_scoped_release release;
+    matches = index.search( query.data(),
+      static_cast< unsigned >( query.shape( 0 ) ), count, num_probes );
+  }
+
+  std::pair< std::vector< std::string >, std::vector< float > > output;
+
+  for( auto const& match : matches )
+  {
+    output.first.push_back( index.store().uid( match.index ) );
+    output.second.push_back( match.distance );
+  }
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+py::array_t< float >
+vector( descriptor_index const& index, size_t i )
+{
+  if( i >= index.store().size() )
+  {
+    throw py::index_error( "Descriptor index out of range" );
+  }
+
+  const unsigned dimension = index.store().dimension();
+  py::array_t< float > output( dimension );
+
+  index.store().read( i, output.mutable_data() );
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+py::array_t< float >
+vectors( descriptor_index const& index, std::vector< std::string > const& uids )
+{
+  descriptor_store const& store = index.store();
+  const unsigned dimension = store.dimension();
+
+  std::vector< size_t > indices( uids.size() );
+
+  for( size_t i = 0; i < uids.size(); ++i )
+  {
+    if( !store.find( uids[ i ], indices[ i ] ) )
+    {
+      throw py::key_error( "No stored descriptor with uid " + uids[ i ] );
+    }
+  }
+
+  py::array_t< float > output( { uids.size(), static_cast< size_t >( dimension ) } );
+  float* values = output.mutable_data();
+
+  for( size_t i = 0; i < indices.size(); ++i )
+  {
+    store.read( indices[ i ], values + i * dimension );
+  }
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+py::array_t< float >
+score_array( svm_model_bank const& bank, query_array const& descriptors )
+{
+  if( descriptors.ndim() != 2 )
+  {
+    throw py::value_error( "Descriptors must be given as a 2 dimensional array" );
+  }
+
+  const size_t count = descriptors.shape( 0 );
+  py::array_t< float > output( { count, bank.num_classes() } );
+  float* scores = output.mutable_data();
+
+  {
+    py::gil_scoped_release release;
+    bank.score( descriptors.data(), count, descriptors.shape( 1 ),
+      static_cast< unsigned >( descriptors.shape( 1 ) ), scores );
+  }
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+py::array_t< float >
+score_index( svm_model_bank const& bank, descriptor_index const& index )
+{
+  const size_t classes = bank.num_classes();
+  py::array_t< float > output( { index.store().size(), classes } );
+  float* scores = output.mutable_data();
+
+  {
+    py::gil_scoped_release release;
+    bank.score( index.store(),
+      [&]( size_t first, size_t count, float const* block )
+      {
+        std::copy( block, block + count * classes, scores + first * classes );
+      } );
+  }
+  return output;
+}
+
+} // end anonymous namespace
+
+} // end namespace viame
+
+// -----------------------------------------------------------------------------
+PYBIND11_MODULE( descriptor_index, m )
+{
+  m.doc() = "Read only access to descriptor indices and batched SVM scoring";
+
+  py::class_< viame::descriptor_index,
+              std::unique_ptr< viame::descriptor_index > >( m, "DescriptorIndex" )
+    .def( py::init( []( std::string const& path, unsigned num_threads )
+      {
+        return std::unique_ptr< viame::descriptor_index >(
+          new viame::descriptor_index( path, false, num_threads ) );
+      } ),
+      py::arg( "path" ), py::arg( "num_threads" ) = 0,
+      "Open the index written at path, without extension" )
+    .def( "__len__", []( viame::descriptor_index const& index )
+      { return index.store().size(); } )
+    .def_property_readonly( "dimension", []( viame::descriptor_index const& index )
+      { return index.store().dimension(); } )
+    .def_property_readonly( "trained", &viame::descriptor_index::trained )
+    .def( "uid", []( viame::descriptor_index const& index, size_t i )
+      { return index.store().uid( i ); }, py::arg( "index" ) )
+    .def( "vector", &viame::vector, py::arg( "index" ),
+      "Copy of the stored descriptor at index" )
+    .def( "vectors", &viame::vectors, py::arg( "uids" ),
+      "Decoded descriptors of shape (len(uids), dimension) for a list of uids" )
+    .def( "search", &viame::search,
+      py::arg( "query" ), py::arg( "count" ), py::arg( "num_probes" ) = 8,
+      "Uids and Euclidean distances of the count closest descriptors, "
+      "comparing the query to the num_probes closest lists" );
+
+  py::class_< viame::svm_model_bank >( m, "SvmModelBank" )
+    .def( py::init( []( std::string const& model_dir, unsigned num_threads )
+      {
+        std::unique_ptr< viame::svm_model_bank > bank(
+          new viame::svm_model_bank( num_threads ) );
+        bank->load_directory( model_dir );
+        return bank;
+      } ),
+      py::arg( "model_dir" ), py::arg( "num_threads" ) = 0,
+      "Load every <class>.svm model within model_dir" )
+    .def_property_readonly( "classes", &viame::svm_model_bank::class_names )
+    .def( "score", &viame::score_array, py::arg( "descriptors" ),
+      "Scores of shape (count, classes) for an array of descriptor rows" )
+    .def( "score_index", &viame::score_index, py::arg( "index" ),
+      "Scores of shape (size, classes) for every descriptor of an index, "
+      "in storage order" );
+}
@@ -0,0 +1,544 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "descriptor_store.h"
+
+#include <vital/exceptions.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace viame
+{
+
+namespace kv = kwiver::vital;
+namespace bip = boost::interprocess;
+
+namespace
+{
+
+char const store_magic[ 4 ] = { 'V', 'D', 'S', 'C' };
+std::uint32_t const store_version = 1;
+
+struct store_header
+{
+  char magic[ 4 ];
+  std::uint32_t version;
+  std::uint32_t dimension;
+  std::uint32_t encoding;
+};
+
+inline size_t
+element_size( descriptor_store::encoding_t encoding )
+{
+  return ( encoding == descriptor_store::FLOAT16 ? 2 : 4 );
+}
+
+// IEEE half precision conversions, rounding to nearest even
+std::uint16_t
+float_to_half( float value )
+{
+  std::uint32_t bits;
+  std::memcpy( &bits, &value, sizeof( bits ) );
+
+  const std::uint16_t sign = static_cast< std::uint16_t >( ( bits >> 16 ) & 0x8000 );
+  const std::uint32_t exponent = ( bits >> 23 ) & 0xff;
+  std::uint32_t mantissa = bits & 0x7fffff;
+
+  if( exponent == 0xff )
+  {
+    // Infinity, or a quiet NaN
+    return sign | 0x7c00 | ( mantissa ? 0x200 : 0 );
+  }
+
+  const int half_exponent = static_cast< int >( exponent ) - 127 + 15;
+
+  if( half_exponent >= 0x1f )
+  {
+    return sign | 0x7c00;
+  }
+
+  if( half_exponent <= 0 )
+  {
+    // Subnormal halves, or zero when too small
+    if( half_exponent < -10 )
+    {
+      return sign;
+    }
+
+    mantissa |= 0x800000;
+    const unsigned shift = static_cast< unsigned >( 14 - half_exponent );
+    std::uint32_t half = mantissa >> shift;
+    const std::uint32_t rest = mantissa & ( ( 1u << shift ) - 1 );
+    const std::uint32_t halfway = 1u << ( shift - 1 );
+
+    if( rest > halfway || ( rest == halfway && ( half & 1 ) ) )
+    {
+      ++half;
+    }
+    return sign | static_cast< std::uint16_t >( half );
+  }
+
+  std::uint32_t half = ( static_cast< std::uint32_t >( half_exponent ) << 10 ) |
+                       ( mantissa >> 13 );
+  const std::uint32_t rest = mantissa & 0x1fff;
+
+  // Carries into the exponent round up to the next power of two, or infinity
+  if( rest > 0x1000 || ( rest == 0x1000 && ( half & 1 ) ) )
+  {
+    ++half;
+  }
+  return sign | static_cast< std::uint16_t >( half );
+}
+
+float
+half_to_float( std::uint16_t half )
+{
+  const std::uint32_t sign = static_cast< std::uint32_t >( half & 0x8000 ) << 16;
+  std::uint32_t exponent = ( half >> 10 ) & 0x1f;
+  std::uint32_t mantissa = half & 0x3ff;
+  std::uint32_t bits;
+
+  if( exponent == 0x1f )
+  {
+    bits = sign | 0x7f800000 | ( mantissa << 13 );
+  }
+  else if( exponent == 0 )
+  {
+    if( mantissa == 0 )
+    {
+      bits = sign;
+    }
+    else
+    {
+      // Normalize the subnormal half
+      exponent = 127 - 15 + 1;
+      while( !( mantissa & 0x400 ) )
+      {
+        mantissa <<= 1;
+        --exponent;
+      }
+      bits = sign | ( exponent << 23 ) | ( ( mantissa & 0x3ff ) << 13 );
+    }
+  }
+  else
+  {
+    bits = sign | ( ( exponent + 127 - 15 ) << 23 ) | ( mantissa << 13 );
+  }
+
+  float value;
+  std::memcpy( &value, &bits, sizeof( value ) );
+  return value;
+}
+
+// Map a whole file read only, null when it is empty
+std::unique_ptr< bip::mapped_region >
+map_file( std::string const& path )
+{
+  if( !kwiversys::SystemTools::FileExists( path ) ||
+      kwiversys::SystemTools::FileLength( path ) == 0 )
+  {
+    return nullptr;
+  }
+
+  bip::file_mapping file( path.c_str(), bip::read_only );
+  return std::unique_ptr< bip::mapped_region >(
+    new bip::mapped_region( file, bip::read_only ) );
+}
+
+} // end anonymous namespace
+
+// -----------------------------------------------------------------------------
+class descriptor_store::priv
+{
+public:
+  std::string vectors_path;
+  std::string uids_path;
+  bool writable = false;
+  unsigned dimension = 0;
+  encoding_t encoding = FLOAT32;
+
+  // Stored descriptors, mapped from their files
+  std::unique_ptr< bip::mapped_region > vectors_region;
+  std::unique_ptr< bip::mapped_region > uids_region;
+  size_t mapped_count = 0;
+  std::vector< std::uint64_t > uid_offsets;
+
+  // Descriptors added since the last flush
+  std::vector< float > pending_values;
+  std::vector< std::string > pending_uids;
+
+  // Uid lookups, extended to new descriptors on demand
+  mutable std::mutex uid_mutex;
+  mutable std::unordered_map< std::string, size_t > uid_indices;
+  mutable size_t indexed_count = 0;
+
+  void map_stored();
+
+  char const* stored_row( size_t index ) const
+  {
+    return static_cast< char const* >( vectors_region->get_address() ) +
+      sizeof( store_header ) + index * dimension * element_size( encoding );
+  }
+};
+
+// -----------------------------------------------------------------------------
+void
+descriptor_store::priv
+::map_stored()
+{
+  vectors_region.reset();
+  uids_region.reset();
+  mapped_count = 0;
+  uid_offsets.clear();
+
+  try
+  {
+    vectors_region = map_file( vectors_path );
+    uids_region = map_file( uids_path );
+  }
+  catch( bip::interprocess_exception const& e )
+  {
+    VITAL_THROW( kv::file_not_read_exception, vectors_path, e.what() );
+  }
+
+  if( !vectors_region )
+  {
+    return;
+  }
+
+  store_header header;
+
+  if( vectors_region->get_size() < sizeof( header ) )
+  {
+    VITAL_THROW( kv::invalid_data, "Truncated descriptor store " + vectors_path );
+  }
+
+  std::memcpy( &header, vectors_region->get_address(), sizeof( header ) );
+
+  if( std::memcmp( header.magic, store_magic, 4 ) != 0 ||
+      header.version != store_version || header.dimension == 0 ||
+      header.encoding > FLOAT16 )
+  {
+    VITAL_THROW( kv::invalid_data, "Invalid descriptor store " + vectors_path );
+  }
+
+  dimension = header.dimension;
+  encoding = static_cast< encoding_t >( header.encoding );
+
+  // Index every complete uid line, a partially written store only exposes the
+  // descriptors present in both files
+  char const* uids = ( uids_region ?
+    static_cast< char const* >( uids_region->get_address() ) : nullptr );
+  const size_t uids_size = ( uids_region ? uids_region->get_size() : 0 );
+
+  const size_t vector_count =
+    ( vectors_region->get_size() - sizeof( header ) ) /
+    ( dimension * element_size( encoding ) );
+
+  uid_offsets.reserve( vector_count + 1 );
+  uid_offsets.push_back( 0 );
+
+  for( size_t i = 0; i < uids_size && uid_offsets.size() <= vector_count; ++i )
+  {
+    if( uids[ i ] == '\n' )
+    {
+      uid_offsets.push_back( i + 1 );
+    }
+  }
+
+  mapped_count = uid_offsets.size() - 1;
+}
+
+// =============================================================================
+descriptor_store
+::descriptor_store( std::string const& path, bool writable,
+                    encoding_t encoding )
+  : d( new priv )
+{
+  d->vectors_path = path + ".vectors";
+  d->uids_path = path + ".uids";
+  d->writable = writable;
+  d->encoding = encoding;
+
+  d->map_stored();
+}
+
+descriptor_store
+::~descriptor_store()
+{
+  if( d->writable && !d->pending_uids.empty() )
+  {
+    flush();
+  }
+}
+
+// -----------------------------------------------------------------------------
+size_t
+descriptor_store
+::size() const
+{
+  return d->mapped_count + d->pending_uids.size();
+}
+
+// -----------------------------------------------------------------------------
+unsigned
+descriptor_store
+::dimension() const
+{
+  return d->dimension;
+}
+
+// -----------------------------------------------------------------------------
+descriptor_store::encoding_t
+descriptor_store
+::encoding() const
+{
+  return d->encoding;
+}
+
+// -----------------------------------------------------------------------------
+void
+descriptor_store
+::add( std::string const& uid, double const* values, unsigned dimension )
+{
+  if( !d->writable )
+  {
+    VITAL_THROW( kv::invalid_value, "Descriptor store opened read only" );
+  }
+  if( dimension == 0 || ( d->dimension && dimension != d->dimension ) )
+  {
+    VITAL_THROW( kv::invalid_value, "Descriptor dimension " +
+      std::to_string( dimension ) + " does not match the store" );
+  }
+  if( uid.find( '\n' ) != std::string::npos )
+  {
+    VITAL_THROW( kv::invalid_value, "Descriptor uids can not contain new lines" );
+  }
+
+  d->dimension = dimension;
+  d->pending_values.insert( d->pending_values.end(), values, values + dimension );
+  d->pending_uids.push_back( uid );
+
+  // Pending values read the same before and after they are written
+  if( d->encoding == FLOAT16 )
+  {
+    for( auto it = d->pending_values.end() - dimension;
+         it != d->pending_values.end(); ++it )
+    {
+      *it = half_to_float( float_to_half( *it ) );
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+void
+descriptor_store
+::flush()
+{
+  if( d->pending_uids.empty() )
+  {
+    return;
+  }
+
+  // Both files are cut back to the mapped descriptors, dropping the tail of
+  // an interrupted write, before appending
+  const size_t vectors_size = ( d->vectors_region ?
+    sizeof( store_header ) +
+    d->mapped_count * d->dimension * element_size( d->encoding ) : 0 );
+  const size_t uids_size = d->uid_offsets.empty() ? 0 : d->uid_offsets.back();
+
+  d->vectors_region.reset();
+  d->uids_region.reset();
+
+  try
+  {
+    if( vectors_size )
+    {
+      boost::filesystem::resize_file( d->vectors_path, vectors_size );
+    }
+    if( uids_size )
+    {
+      boost::filesystem::resize_file( d->uids_path, uids_size );
+    }
+  }
+  catch( boost::filesystem::filesystem_error const& e )
+  {
+    VITAL_THROW( kv::file_write_exception, d->vectors_path, e.what() );
+  }
+
+  {
+    std::ofstream vectors( d->vectors_path, std::ios::binary |
+      ( vectors_size ? std::ios::app : std::ios::trunc | std::ios::out ) );
+    std::ofstream uids( d->uids_path, std::ios::binary |
+      ( uids_size ? std::ios::app : std::ios::trunc | std::ios::out ) );
+
+    if( !vectors || !uids )
+    {
+      VITAL_THROW( kv::file_write_exception, d->vectors_path,
+        "Unable to open descriptor store for writing" );
+    }
+
+    if( !vectors_size )
+    {
+      store_header header;
+      std::memcpy( header.magic, store_magic, 4 );
+      header.version = store_version;
+      header.dimension = d->dimension;
+      header.encoding = d->encoding;
+      vectors.write( reinterpret_cast< char const* >( &header ), sizeof( header ) );
+    }
+
+    if( d->encoding == FLOAT16 )
+    {
+      std::vector< std::uint16_t > halves( d->pending_values.size() );
+
+      for( size_t i = 0; i < halves.size(); ++i )
+      {
+        halves[ i ] = float_to_half( d->pending_values[ i ] );
+      }
+
+      vectors.write( reinterpret_cast< char const* >( halves.data() ),
+                     halves.size() * sizeof( std::uint16_t ) );
+    }
+    else
+    {
+      vectors.write( reinterpret_cast< char const* >( d->pending_values.data() ),
+                     d->pending_values.size() * sizeof( float ) );
+    }
+
+    for( auto const& uid : d->pending_uids )
+    {
+      uids << uid << '\n';
+    }
+
+    if( !vectors || !uids )
+    {
+      VITAL_THROW( kv::file_write_exception, d->vectors_path,
+        "Unable to write descriptor store" );
+    }
+  }
+
+  d->pending_values.clear();
+  d->pending_uids.clear();
+
+  d->map_stored();
+}
+
+// -----------------------------------------------------------------------------
+float const*
+descriptor_store
+::vector( size_t index, float* buffer ) const
+{
+  if( index >= d->mapped_count )
+  {
+    return d->pending_values.data() + ( index - d->mapped_count ) * d->dimension;
+  }
+
+  if( d->encoding == FLOAT32 )
+  {
+    return reinterpret_cast< float const* >( d->stored_row( index ) );
+  }
+
+  std::uint16_t const* halves =
+    reinterpret_cast< std::uint16_t const* >( d->stored_row( index ) );
+
+  for( unsigned i = 0; i < d->dimension; ++i )
+  {
+    buffer[ i ] = half_to_float( halves[ i ] );
+  }
+
+  return buffer;
+}
+
+// -----------------------------------------------------------------------------
+void
+descriptor_store
+::read( size_t index, float* output ) const
+{
+  float const* values = vector( index, output );
+
+  if( values != output )
+  {
+    std::copy( values, values + d->dimension, output );
+  }
+}
+
+// -----------------------------------------------------------------------------
+bool
+descriptor_store
+::find( std::string const& uid, size_t& index ) const
+{
+  std::lock_guard< std::mutex > lock( d->uid_mutex );
+
+  // Repeated uids resolve to their first descriptor
+  for( ; d->indexed_count < size(); ++d->indexed_count )
+  {
+    d->uid_indices.emplace( this->uid( d->indexed_count ), d->indexed_count );
+  }
+
+  auto it = d->uid_indices.find( uid );
+
+  if( it == d->uid_indices.end() )
+  {
+    return false;
+  }
+
+  index = it->second;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+std::string
+descriptor_store
+::uid( size_t index ) const
+{
+  if( index < d->mapped_count )
+  {
+    char const* uids = static_cast< char const* >( d->uids_region->get_address() );
+    return std::string( uids + d->uid_offsets[ index ],
+      d->uid_offsets[ index + 1 ] - d->uid_offsets[ index ] - 1 );
+  }
+
+  return d->pending_uids[ index - d->mapped_count ];
+}
+
+} // end namespace viame
@@ -0,0 +1,117 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Append-only, memory-mapped store of fixed dimension descriptors
+ */
+
+#ifndef VIAME_CORE_DESCRIPTOR_STORE_H
+#define VIAME_CORE_DESCRIPTOR_STORE_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace viame
+{
+
+/**
+ * @brief Descriptors and their uids, appended to files and read in place
+ *
+ * Vectors are kept as 32 or 16-bit floats after a small header in
+ * <path>.vectors, and their uids one per line in <path>.uids, both in
+ * insertion order. Stored files are memory-mapped so archives larger than
+ * memory can be read, while descriptors added since the last flush() are
+ * served from memory. Half precision stores are decoded as they are read.
+ *
+ * Reads may be made from several threads, additions from a single one.
+ */
+class VIAME_CORE_EXPORT descriptor_store
+{
+public:
+  /// Element type of stored vectors, recorded in the file header
+  enum encoding_t
+  {
+    FLOAT32 = 0,
+    FLOAT16 = 1,
+  };
+
+  /**
+   * @brief Open the store at path, creating it on the first addition if writable
+   *
+   * The encoding is only used when creating the store, existing stores keep
+   * the encoding they were written with.
+   */
+  descriptor_store( std::string const& path, bool writable,
+                    encoding_t encoding = FLOAT32 );
+  ~descriptor_store();
+
+  encoding_t encoding() const;
+
+  /// Number of stored descriptors, including those not flushed yet
+  size_t size() const;
+
+  /// Descriptor dimension, 0 while the store is empty
+  unsigned dimension() const;
+
+  /// Append a descriptor, all descriptors must have the same dimension
+  void add( std::string const& uid, double const* values, unsigned dimension );
+
+  /// Write out added descriptors and map them in place of their copies
+  void flush();
+
+  /**
+   * @brief Values of the descriptor at index, valid until the next flush()
+   *
+   * Float stores return their values in place; others decode them into
+   * buffer, which must hold dimension() values, and return it.
+   */
+  float const* vector( size_t index, float* buffer ) const;
+
+  /// Copy the decoded values of the descriptor at index to output
+  void read( size_t index, float* output ) const;
+
+  /// Find the index of a uid, indexing all uids on the first call
+  bool find( std::string const& uid, size_t& index ) const;
+
+  /// Uid of the descriptor at index
+  std::string uid( size_t index ) const;
+
+private:
+  class priv;
+  const std::unique_ptr< priv > d;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_DESCRIPTOR_STORE_H
@@ -0,0 +1,277 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Structure of arrays form of a detection set
+ */
+
+#include "detection_arrays.h"
+
+#include <vital/types/detected_object_type.h>
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+detection_arrays
+::detection_arrays( kv::detected_object_set const& detections )
+{
+  assign( detections );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+detection_arrays
+::assign( kv::detected_object_set const& detections )
+{
+  clear();
+  append( detections );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+detection_arrays
+::append( kv::detected_object_set const& detections )
+{
+  reserve( size() + detections.size() );
+
+  for( auto const& detection : detections )
+  {
+    push_back( detection );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+detection_arrays
+::push_back( kv::detected_object_sptr const& detection )
+{
+  if( !detection )
+  {
+    push_back( kv::bounding_box_d(), 0.0 );
+    return;
+  }
+
+  const kv::bounding_box_d box = detection->bounding_box();
+
+  min_x.push_back( box.min_x() );
+  min_y.push_back( box.min_y() );
+  max_x.push_back( box.max_x() );
+  max_y.push_back( box.max_y() );
+  confidence.push_back( detection->confidence() );
+
+  // Empty types are skipped, get_most_likely would throw on them
+  const auto type = detection->type();
+
+  if( type && type->size() > 0 )
+  {
+    std::string name;
+    double score;
+
+    type->get_most_likely( name, score );
+
+    class_id.push_back( add_class( name ) );
+    class_score.push_back( score );
+  }
+  else
+  {
+    class_id.push_back( -1 );
+    class_score.push_back( 0.0 );
+  }
+
+  sources.push_back( detection );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+detection_arrays
+::push_back( kv::bounding_box_d const& box,
+             double confidence_value,
+             std::string const& name,
+             double score )
+{
+  min_x.push_back( box.min_x() );
+  min_y.push_back( box.min_y() );
+  max_x.push_back( box.max_x() );
+  max_y.push_back( box.max_y() );
+  confidence.push_back( confidence_value );
+  class_id.push_back( name.empty() ? -1 : add_class( name ) );
+  class_score.push_back( name.empty() ? 0.0 : score );
+  sources.emplace_back();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+detection_arrays
+::pop_back()
+{
+  min_x.pop_back();
+  min_y.pop_back();
+  max_x.pop_back();
+  max_y.pop_back();
+  confidence.pop_back();
+  class_id.pop_back();
+  class_score.pop_back();
+  sources.pop_back();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+detection_arrays
+::reserve( size_t new_size )
+{
+  min_x.reserve( new_size );
+  min_y.reserve( new_size );
+  max_x.reserve( new_size );
+  max_y.reserve( new_size );
+  confidence.reserve( new_size );
+  class_id.reserve( new_size );
+  class_score.reserve( new_size );
+  sources.reserve( new_size );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+detection_arrays
+::clear()
+{
+  min_x.clear();
+  min_y.clear();
+  max_x.clear();
+  max_y.clear();
+  confidence.clear();
+  class_id.clear();
+  class_score.clear();
+  sources.clear();
+}
+
+
+// -----------------------------------------------------------------------------
+std::string const&
+detection_arrays
+::class_name( size_t row ) const
+{
+  static const std::string none;
+
+  return class_id[ row ] < 0 ? none : class_names[ class_id[ row ] ];
+}
+
+
+// -----------------------------------------------------------------------------
+int
+detection_arrays
+::find_class( std::string const& name ) const
+{
+  auto itr = m_class_ids.find( name );
+  return itr == m_class_ids.end() ? -1 : itr->second;
+}
+
+
+// -----------------------------------------------------------------------------
+int
+detection_arrays
+::add_class( std::string const& name )
+{
+  auto inserted = m_class_ids.emplace(
+    name, static_cast< int >( class_names.size() ) );
+
+  if( inserted.second )
+  {
+    class_names.push_back( name );
+  }
+  return inserted.first->second;
+}
+
+
+// -----------------------------------------------------------------------------
+kv::detected_object_sptr
+detection_arrays
+::detection( size_t row ) const
+{
+  if( sources[ row ] )
+  {
+    return sources[ row ];
+  }
+
+  kv::detected_object_type_sptr type;
+
+  if( class_id[ row ] >= 0 )
+  {
+    type = std::make_shared< kv::detected_object_type >(
+      class_names[ class_id[ row ] ], class_score[ row ] );
+  }
+
+  return std::make_shared< kv::detected_object >(
+    box( row ), confidence[ row ], type );
+}
+
+
+// -----------------------------------------------------------------------------
+kv::detected_object_set_sptr
+detection_arrays
+::to_detected_object_set() const
+{
+  std::vector< kv::detected_object_sptr > detections;
+  detections.reserve( size() );
+
+  for( size_t row = 0; row < size(); ++row )
+  {
+    detections.push_back( detection( row ) );
+  }
+
+  return std::make_shared< kv::detected_object_set >( detections );
+}
+
+
+kv::detected_object_set_sptr
+detection_arrays
+::to_detected_object_set( std::vector< size_t > const& rows ) const
+{
+  std::vector< kv::detected_object_sptr > detections;
+  detections.reserve( rows.size() );
+
+  for( size_t row : rows )
+  {
+    detections.push_back( detection( row ) );
+  }
+
+  return std::make_shared< kv::detected_object_set >( detections );
+}
+
+} // end namespace viame
@@ -0,0 +1,138 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Structure of arrays form of a detection set
+ */
+
+#ifndef VIAME_CORE_DETECTION_ARRAYS_H
+#define VIAME_CORE_DETECTION_ARRAYS_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/types/bounding_box.h>
+#include <vital/types/detected_object_set.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Detection boxes, confidences and top classes held column by column
+ *
+ * Dense proposal sets hold thousands of detections per frame, each behind its
+ * own shared pointer with a class score map. Loops over all of them, such as
+ * threshold tests, overlap searches and stereo matching, read the columns
+ * here instead, with every class name resolved once to an index into
+ * class_names. Class indices are kept by clear(), so rows added before and
+ * after it, or from the left and right sets of a stereo pair added one after
+ * the other, compare by index.
+ *
+ * Rows added from a detection keep it, and to_detected_object_set() returns
+ * those detections unchanged, masks and notes included.
+ */
+class VIAME_CORE_EXPORT detection_arrays
+{
+public:
+  detection_arrays() = default;
+  explicit detection_arrays( kwiver::vital::detected_object_set const& detections );
+
+  /// Replace the rows with the given detections, keeping allocated memory
+  void assign( kwiver::vital::detected_object_set const& detections );
+
+  /// Append the given detections after the current rows
+  void append( kwiver::vital::detected_object_set const& detections );
+
+  /// Append one detection, null detections become empty rows
+  void push_back( kwiver::vital::detected_object_sptr const& detection );
+
+  /// Append a row without a source detection, an empty class_name for none
+  void push_back( kwiver::vital::bounding_box_d const& box,
+                  double confidence,
+                  std::string const& class_name = std::string(),
+                  double class_score = 0.0 );
+
+  /// Remove the last row
+  void pop_back();
+
+  void reserve( size_t size );
+  void clear();
+
+  size_t size() const { return min_x.size(); }
+  bool empty() const { return min_x.empty(); }
+
+  kwiver::vital::bounding_box_d box( size_t row ) const
+  {
+    return kwiver::vital::bounding_box_d(
+      min_x[ row ], min_y[ row ], max_x[ row ], max_y[ row ] );
+  }
+
+  /// Name of the top class of a row, empty without class
+  std::string const& class_name( size_t row ) const;
+
+  /// Index of a class name, -1 if no row used it
+  int find_class( std::string const& name ) const;
+
+  /// Index of a class name, added if new
+  int add_class( std::string const& name );
+
+  /// Detection of a row, built from the columns for rows without a source
+  kwiver::vital::detected_object_sptr detection( size_t row ) const;
+
+  /// Detections of all rows, or of the given rows in the given order
+  kwiver::vital::detected_object_set_sptr to_detected_object_set() const;
+  kwiver::vital::detected_object_set_sptr to_detected_object_set(
+    std::vector< size_t > const& rows ) const;
+
+  // Columns, one entry per row
+  std::vector< double > min_x, min_y, max_x, max_y;
+  std::vector< double > confidence;
+
+  /// Most likely class of each row, -1 for detections without class scores
+  std::vector< int > class_id;
+  std::vector< double > class_score;
+
+  /// Detection each row came from, null for rows added from columns
+  std::vector< kwiver::vital::detected_object_sptr > sources;
+
+  /// Names indexed by class_id
+  std::vector< std::string > class_names;
+
+private:
+  std::unordered_map< std::string, int > m_class_ids;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_DETECTION_ARRAYS_H
@@ -0,0 +1,329 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "detection_scoring.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace viame
+{
+
+namespace
+{
+
+// Outcome of one computed detection
+struct detection_match
+{
+  double score;
+  int label;
+  bool is_true_positive;
+};
+
+struct frame_results
+{
+  std::vector< detection_match > matches;
+  std::vector< size_t > truth_counts;
+  std::vector< size_t > confusion;
+};
+
+// -----------------------------------------------------------------------------
+// Greedy matching of computed to truth boxes in decreasing score order, each
+// truth box is used at most once. Returns the matched truth index or -1 for
+// each computed box, restricted to equal labels if same_label is set.
+void
+match_boxes( std::vector< scoring_box > const& truth,
+             std::vector< scoring_box > const& computed,
+             std::vector< size_t > const& order,
+             double iou_threshold, bool same_label,
+             std::vector< int >& assignment )
+{
+  std::vector< bool > used( truth.size(), false );
+
+  assignment.assign( computed.size(), -1 );
+
+  for( size_t c : order )
+  {
+    double best_iou = iou_threshold;
+    int best = -1;
+
+    for( size_t t = 0; t < truth.size(); ++t )
+    {
+      if( used[t] || ( same_label && truth[t].label != computed[c].label ) )
+      {
+        continue;
+      }
+
+      const double iou = scoring_iou( truth[t], computed[c] );
+
+      if( iou >= best_iou )
+      {
+        best_iou = iou;
+        best = static_cast< int >( t );
+      }
+    }
+
+    if( best >= 0 )
+    {
+      used[ best ] = true;
+      assignment[c] = best;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+void
+score_frame( scoring_frame const& frame, size_t label_count,
+             detection_scoring_options const& options,
+             frame_results& results )
+{
+  const size_t stride = label_count + 1;
+  const size_t background = label_count;
+
+  std::vector< size_t > order( frame.computed.size() );
+  std::iota( order.begin(), order.end(), 0 );
+  std::stable_sort( order.begin(), order.end(),
+    [&]( size_t a, size_t b )
+    {
+      return frame.computed[a].score > frame.computed[b].score;
+    } );
+
+  for( auto const& t : frame.truth )
+  {
+    results.truth_counts[ t.label ]++;
+  }
+
+  std::vector< int > assignment;
+
+  // Per label matching for the precision-recall curves
+  match_boxes( frame.truth, frame.computed, order,
+               options.iou_threshold, true, assignment );
+
+  for( size_t c = 0; c < frame.computed.size(); ++c )
+  {
+    results.matches.push_back( { frame.computed[c].score,
+      frame.computed[c].label, assignment[c] >= 0 } );
+  }
+
+  // Label agnostic matching above threshold for the confusion matrix
+  order.erase( std::remove_if( order.begin(), order.end(),
+    [&]( size_t c ){ return frame.computed[c].score < options.threshold; } ),
+    order.end() );
+
+  match_boxes( frame.truth, frame.computed, order,
+               options.iou_threshold, false, assignment );
+
+  std::vector< bool > truth_matched( frame.truth.size(), false );
+
+  for( size_t c : order )
+  {
+    const size_t computed_label = frame.computed[c].label;
+
+    if( assignment[c] >= 0 )
+    {
+      truth_matched[ assignment[c] ] = true;
+      results.confusion[ frame.truth[ assignment[c] ].label * stride +
+                         computed_label ]++;
+    }
+    else
+    {
+      results.confusion[ background * stride + computed_label ]++;
+    }
+  }
+
+  for( size_t t = 0; t < frame.truth.size(); ++t )
+  {
+    if( !truth_matched[t] )
+    {
+      results.confusion[ frame.truth[t].label * stride + background ]++;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Sweep matches sorted by decreasing score, emitting a point per distinct score
+void
+sweep_curve( std::vector< detection_match > const& matches,
+             detection_class_metrics& metrics )
+{
+  size_t tp = 0, fp = 0;
+
+  metrics.curve.clear();
+  metrics.max_f1 = 0.0;
+  metrics.max_f1_threshold = 0.0;
+
+  for( size_t i = 0; i < matches.size(); ++i )
+  {
+    matches[i].is_true_positive ? ++tp : ++fp;
+
+    if( i + 1 < matches.size() && matches[i+1].score == matches[i].score )
+    {
+      continue;
+    }
+
+    detection_pr_point point;
+    point.threshold = matches[i].score;
+    point.true_positives = tp;
+    point.false_positives = fp;
+    point.precision = static_cast< double >( tp ) / ( tp + fp );
+    point.recall = metrics.truth_count ?
+      static_cast< double >( tp ) / metrics.truth_count : 0.0;
+
+    const double denom = point.precision + point.recall;
+    const double f1 = denom > 0.0 ?
+      2.0 * point.precision * point.recall / denom : 0.0;
+
+    if( f1 > metrics.max_f1 )
+    {
+      metrics.max_f1 = f1;
+      metrics.max_f1_threshold = point.threshold;
+    }
+
+    metrics.curve.push_back( point );
+  }
+
+  // Area under the monotonically decreasing precision envelope
+  double ap = 0.0;
+  double envelope = 0.0;
+
+  for( size_t i = metrics.curve.size(); i-- > 0; )
+  {
+    envelope = std::max( envelope, metrics.curve[i].precision );
+
+    const double prev_recall = i > 0 ? metrics.curve[i-1].recall : 0.0;
+    ap += ( metrics.curve[i].recall - prev_recall ) * envelope;
+  }
+
+  metrics.average_precision = ap;
+}
+
+} // end anonymous namespace
+
+
+// -----------------------------------------------------------------------------
+detection_metrics
+score_detections( std::vector< scoring_sequence > const& sequences,
+                  scoring_labels const& labels,
+                  detection_scoring_options const& options )
+{
+  const size_t label_count = labels.size();
+  const size_t stride = label_count + 1;
+
+  std::vector< scoring_frame const* > frames;
+
+  for( auto const& sequence : sequences )
+  {
+    for( auto const& frame : sequence.frames )
+    {
+      frames.push_back( &frame );
+    }
+  }
+
+  // Each worker takes every n-th frame, frames vary a lot in density
+  thread_pool workers( options.num_threads );
+  const size_t worker_count = std::max< size_t >( workers.size(), 1 );
+
+  std::vector< frame_results > partial( worker_count );
+  std::vector< std::future< void > > futures;
+
+  for( size_t w = 0; w < worker_count; ++w )
+  {
+    futures.push_back( workers.enqueue( [&, w]
+    {
+      frame_results& results = partial[w];
+      results.truth_counts.assign( label_count, 0 );
+      results.confusion.assign( stride * stride, 0 );
+
+      for( size_t f = w; f < frames.size(); f += worker_count )
+      {
+        score_frame( *frames[f], label_count, options, results );
+      }
+    } ) );
+  }
+  for( auto& future : futures )
+  {
+    future.wait();
+  }
+  for( auto& future : futures )
+  {
+    future.get();
+  }
+
+  detection_metrics output;
+  output.confusion.labels = labels.names();
+  output.confusion.counts.assign( stride * stride, 0 );
+  output.classes.resize( label_count );
+
+  std::vector< detection_match > all_matches;
+
+  for( auto& results : partial )
+  {
+    for( size_t l = 0; l < label_count; ++l )
+    {
+      output.classes[l].truth_count += results.truth_counts[l];
+    }
+    for( size_t i = 0; i < results.confusion.size(); ++i )
+    {
+      output.confusion.counts[i] += results.confusion[i];
+    }
+    all_matches.insert( all_matches.end(),
+      results.matches.begin(), results.matches.end() );
+    results.matches = std::vector< detection_match >();
+  }
+
+  std::sort( all_matches.begin(), all_matches.end(),
+    []( detection_match const& a, detection_match const& b )
+    {
+      return a.score > b.score;
+    } );
+
+  // Split the sorted matches by label, which keeps each one sorted
+  std::vector< std::vector< detection_match > > by_label( label_count );
+
+  for( auto const& match : all_matches )
+  {
+    by_label[ match.label ].push_back( match );
+  }
+
+  for( size_t l = 0; l < label_count; ++l )
+  {
+    output.classes[l].label = labels.names()[l];
+    output.overall.truth_count += output.classes[l].truth_count;
+    sweep_curve( by_label[l], output.classes[l] );
+  }
+
+  output.overall.label = "overall";
+  sweep_curve( all_matches, output.overall );
+
+  return output;
+}
+
+} // end namespace
@@ -0,0 +1,124 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Precision-recall curves and confusion matrices for detections
+ */
+
+#ifndef VIAME_CORE_DETECTION_SCORING_H
+#define VIAME_CORE_DETECTION_SCORING_H
+
+#include <plugins/core/viame_core_export.h>
+#include <plugins/core/scoring_data.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+struct detection_scoring_options
+{
+  /// Minimum overlap for a computed detection to match a truth detection
+  double iou_threshold = 0.5;
+
+  /// Minimum score of computed detections counted in the confusion matrix
+  double threshold = 0.0;
+
+  /// Threads matching frames, 0 for one per core
+  unsigned num_threads = 0;
+};
+
+/// Counts when every computed detection scoring at least threshold is kept
+struct detection_pr_point
+{
+  double threshold;
+  double precision;
+  double recall;
+  size_t true_positives;
+  size_t false_positives;
+};
+
+struct detection_class_metrics
+{
+  std::string label;
+  size_t truth_count = 0;
+  double average_precision = 0.0;
+  double max_f1 = 0.0;
+  double max_f1_threshold = 0.0;
+
+  /// One point per distinct score, by decreasing threshold
+  std::vector< detection_pr_point > curve;
+};
+
+/// Row is the truth label and column the computed label, with one extra
+/// background row and column for unmatched detections
+struct detection_confusion_matrix
+{
+  std::vector< std::string > labels;
+  std::vector< size_t > counts;
+
+  size_t at( size_t truth, size_t computed ) const
+  {
+    return counts[ truth * ( labels.size() + 1 ) + computed ];
+  }
+};
+
+struct detection_metrics
+{
+  /// Per label, in scoring_labels order
+  std::vector< detection_class_metrics > classes;
+
+  /// All labels pooled together
+  detection_class_metrics overall;
+
+  detection_confusion_matrix confusion;
+};
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Score computed detections against truth over every threshold
+ *
+ * Computed detections are matched per frame and label to the best
+ * overlapping unmatched truth, in decreasing score order. Since the order
+ * does not depend on the threshold, one sweep over the sorted matches gives
+ * precision and recall at every threshold at once.
+ */
+VIAME_CORE_EXPORT detection_metrics
+score_detections( std::vector< scoring_sequence > const& sequences,
+                  scoring_labels const& labels,
+                  detection_scoring_options const& options );
+
+} // end namespace
+
+#endif // VIAME_CORE_DETECTION_SCORING_H
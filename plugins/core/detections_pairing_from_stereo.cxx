@@ -6,6 +6,17 @@
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/calib3d/calib3d.hpp>
 
+#include <plugins/core/linear_assignment.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 void viame::core::detections_pairing_from_stereo::load_camera_calibration() {
   try {
     auto intrinsics_path = m_cameras_directory + "/intrinsics.yml";
@@ -38,6 +49,12 @@ void viame::core::detections_pairing_from_stereo::load_camera_calibration() {
     // Compute RVec from matrix for later use
     cv::Rodrigues(m_R, m_Rvec);
 
+    // Lookup table depends on the calibration
+    {
+      std::lock_guard<std::mutex> lock(m_workspaces.mutex);
+      m_workspaces.left_undistortion_lut.reset();
+    }
+
     fs.release();
   } catch (const kwiver::vital::file_not_found_exception &e) {
     VITAL_THROW(kwiver::vital::invalid_data, "Calibration file not found : " + std::string(e.what()));
@@ -140,6 +157,51 @@ viame::core::detections_pairing_from_stereo::get_rectified_bbox(const kwiver::vi
   return {tl.x, tl.y, br.x, br.y};
 }
 
+viame::core::DetectionSpan
+viame::core::DetectionSpan::of(const kwiver::vital::detected_object_set &detections,
+                               std::vector<element_ptr> &buffer) {
+  buffer.clear();
+  for (const auto &detection: detections)
+    buffer.emplace_back(&detection);
+  return {buffer.data(), buffer.size()};
+}
+
+viame::core::DetectionSpan
+viame::core::DetectionSpan::of(const std::vector<kwiver::vital::detected_object_sptr> &detections,
+                               std::vector<element_ptr> &buffer) {
+  buffer.clear();
+  for (const auto &detection: detections)
+    buffer.emplace_back(&detection);
+  return {buffer.data(), buffer.size()};
+}
+
+std::vector<std::pair<int, int>>
+viame::core::detections_pairing_from_stereo::rectified_row_strips(
+    const std::vector<kwiver::vital::detected_object_sptr> &detections, int image_height, int padding) const {
+  std::vector<DetectionSpan::element_ptr> buffer;
+  return rectified_row_strips(DetectionSpan::of(detections, buffer), image_height, padding);
+}
+
+std::vector<std::pair<int, int>>
+viame::core::detections_pairing_from_stereo::rectified_row_strips(
+    DetectionSpan detections, int image_height, int padding) const {
+  std::vector<std::pair<int, int>> strips;
+  for (const auto &detection: detections) {
+    if (!detection || !detection->bounding_box().is_valid())
+      continue;
+
+    const auto rectified_bbox = get_rectified_bbox(detection->bounding_box(), true);
+    if (!rectified_bbox.is_valid())
+      continue;
+
+    auto first = std::max(0, (int) std::floor(rectified_bbox.min_y()) - padding);
+    auto second = std::min(image_height, (int) std::ceil(rectified_bbox.max_y()) + padding + 1);
+    if (first < second)
+      strips.emplace_back(first, second);
+  }
+  return strips;
+}
+
 bool viame::core::detections_pairing_from_stereo::point_is_valid(float x, float y, float z) {
   return ((z > 0) && std::isfinite(x) && std::isfinite(y) && std::isfinite(z));
 }
@@ -172,30 +234,31 @@ viame::core::detections_pairing_from_stereo::estimate_3d_position_from_bbox(cons
   }
 
   // Compute medians in cropped patch
-  cv::Mat channels[3];
   auto crop = pos_3d_map(crop_rect);
-  cv::split(crop, channels);
-
-  // Select for valid points (with z > 0 and z != inf ) and compute xs, ys, zs
-  // median from those
-  cv::Mat xs = channels[0].reshape(1, 1);
-  cv::Mat ys = channels[1].reshape(1, 1);
-  cv::Mat zs = channels[2].reshape(1, 1);
-  int nb_val = zs.size().width;
-  if (zs.depth() != CV_32F) {
+  if (crop.type() != CV_32FC3) {
     throw std::runtime_error("depth values are not of type cv::CV_32F.");
   }
 
-  std::vector<float> valid_xs, valid_ys, valid_zs;
-  for (int i = 0; i < nb_val; i++) {
-    auto x = xs.at<float>(i);
-    auto y = ys.at<float>(i);
-    auto z = zs.at<float>(i);
-
-    if (point_is_valid(x, y, z)) {
-      valid_xs.push_back(x);
-      valid_ys.push_back(y);
-      valid_zs.push_back(z);
+  // Select for valid points (with z > 0 and z != inf ) and compute xs, ys, zs
+  // median from those
+  auto &ws = workspace();
+  auto &valid_xs = ws.xs;
+  auto &valid_ys = ws.ys;
+  auto &valid_zs = ws.zs;
+  valid_xs.clear();
+  valid_ys.clear();
+  valid_zs.clear();
+
+  for (int i_row = 0; i_row < crop.rows; i_row++) {
+    const auto *row = crop.ptr<cv::Vec3f>(i_row);
+    for (int i_col = 0; i_col < crop.cols; i_col++) {
+      const auto &pt = row[i_col];
+
+      if (point_is_valid(pt)) {
+        valid_xs.push_back(pt[0]);
+        valid_ys.push_back(pt[1]);
+        valid_zs.push_back(pt[2]);
+      }
     }
   }
 
@@ -212,27 +275,16 @@ viame::core::detections_pairing_from_stereo::estimate_3d_position_from_unrectifi
   if (bbox.width() == 0 || bbox.height() == 0)
     return {};
 
-  // Find all distorted positions where mask is not empty
-  std::vector<cv::Point2d> mask_distorted_coords;
-  const auto mask_tl = bbox.upper_left();
-  for (int i_x = 0; i_x < mask.size().width; i_x++) {
-    for (int i_y = 0; i_y < mask.size().height; i_y++) {
-      if (mask.at<uchar>(i_y, i_x) > 0) {
-        mask_distorted_coords.emplace_back(cv::Point2d(mask_tl.x() + i_x, mask_tl.y() + i_y));
-      }
-    }
-  }
+  // Find all positions where mask is not empty, undistorted if requested
+  auto &mask_coords = workspace().undistorted_coords;
+  mask_to_rectified_coordinates(bbox, mask, do_undistort_points, pos_3d_map.size(), mask_coords);
 
   // If no segmentation, early return
-  if (mask_distorted_coords.empty())
+  if (mask_coords.empty())
     return {};
 
-  // Undistort mask points
-  auto undistorted_mask_coords = do_undistort_points ? undistort_point(mask_distorted_coords, true)
-                                                     : mask_distorted_coords;
-
   const auto rectified_bbox = do_undistort_points ? get_rectified_bbox(bbox, true) : bbox;
-  return estimate_3d_position_from_point_coordinates(rectified_bbox, undistorted_mask_coords, pos_3d_map);
+  return estimate_3d_position_from_point_coordinates(rectified_bbox, mask_coords, pos_3d_map);
 }
 
 viame::core::Detections3DPositions
@@ -249,7 +301,13 @@ viame::core::detections_pairing_from_stereo::estimate_3d_position_from_point_coo
   };
 
   int n_total{};
-  std::vector<float> xs, ys, zs;
+  auto &ws = workspace();
+  auto &xs = ws.xs;
+  auto &ys = ws.ys;
+  auto &zs = ws.zs;
+  xs.clear();
+  ys.clear();
+  zs.clear();
   for (const auto &point: undistorted_mask_coords) {
     if (is_out_of_bounds(point))
       continue;
@@ -276,9 +334,17 @@ viame::core::detections_pairing_from_stereo::create_3d_position(const std::vecto
                                                                 const std::vector<float> &zs,
                                                                 const kwiver::vital::bounding_box_d &bbox,
                                                                 const cv::Mat &pos_3d_map, float score) const {
-  const auto saturate_corner = [&pos_3d_map](const Eigen::Matrix<double, 2, 1> &corner) {
-    return Eigen::Matrix<double, 2, 1>{std::max(0., std::min(pos_3d_map.size().width - 1., corner.x())),
-                                       std::max(0., std::min(pos_3d_map.size().height - 1., corner.y()))};
+  return create_3d_position(xs, ys, zs, bbox, pos_3d_map.size(), score,
+                            [&] { return project_to_right_image(bbox, pos_3d_map); });
+}
+
+viame::core::Detections3DPositions viame::core::detections_pairing_from_stereo::create_3d_position(
+    const std::vector<float> &xs, const std::vector<float> &ys, const std::vector<float> &zs,
+    const kwiver::vital::bounding_box_d &bbox, const cv::Size &map_size, float score,
+    const std::function<kwiver::vital::bounding_box_d()> &fallback_projection) const {
+  const auto saturate_corner = [&map_size](const Eigen::Matrix<double, 2, 1> &corner) {
+    return Eigen::Matrix<double, 2, 1>{std::max(0., std::min(map_size.width - 1., corner.x())),
+                                       std::max(0., std::min(map_size.height - 1., corner.y()))};
   };
 
   const auto saturate_bbox = [&saturate_corner](const kwiver::vital::bounding_box_d &bbox) {
@@ -309,10 +375,10 @@ viame::core::detections_pairing_from_stereo::create_3d_position(const std::vecto
 
   Detections3DPositions position;
   position.score = score;
-  position.center3d = cv::Point3f{compute_median(xs), compute_median(ys), compute_median(zs)};
+  position.center3d = cv::Point3f{workspace_median(xs), workspace_median(ys), workspace_median(zs)};
   position.rectified_left_bbox = saturate_bbox(bbox);
   position.left_bbox_proj_to_right_image = saturate_bbox(xs.empty() ?//
-                                                         project_to_right_image(bbox, pos_3d_map) ://
+                                                         fallback_projection() ://
                                                          project_to_right_image(extract_3d_bbox_from_point_list()));
 
   // If position score is valid, project center3D to right image
@@ -381,12 +447,27 @@ cv::Point2f viame::core::detections_pairing_from_stereo::project_to_right_image(
 std::vector<viame::core::Detections3DPositions>
 viame::core::detections_pairing_from_stereo::update_left_detections_3d_positions(
     const std::vector<kwiver::vital::detected_object_sptr> &detections, const cv::Mat &cv_disparity_map) const {
-  const auto cv_pos_3d_map = reproject_3d_depth_map(cv_disparity_map);
+  std::vector<DetectionSpan::element_ptr> buffer;
   std::vector<Detections3DPositions> positions;
+  update_left_detections_3d_positions(DetectionSpan::of(detections, buffer), cv_disparity_map, positions);
+  return positions;
+}
+
+
+void viame::core::detections_pairing_from_stereo::update_left_detections_3d_positions(
+    DetectionSpan detections, const cv::Mat &cv_disparity_map, std::vector<Detections3DPositions> &positions) const {
+  positions.clear();
+  if (m_sparse_reprojection) {
+    for (const auto &detection: detections) {
+      positions.emplace_back(update_left_detection_3d_position_from_disparity(detection, cv_disparity_map));
+    }
+    return;
+  }
+
+  const auto &cv_pos_3d_map = reproject_3d_depth_map_in_workspace(cv_disparity_map);
   for (const auto &detection: detections) {
     positions.emplace_back(update_left_detection_3d_position(detection, cv_pos_3d_map));
   }
-  return positions;
 }
 
 
@@ -395,7 +476,22 @@ viame::core::Detections3DPositions viame::core::detections_pairing_from_stereo::
 
   // Process 3D coordinates for frame matching the current depth image
   auto position = estimate_3d_position_from_detection(detection, cv_pos_3d_map, true, 1. / 3.);
+  add_3d_position_notes(detection, position);
+  return position;
+}
+
 
+viame::core::Detections3DPositions
+viame::core::detections_pairing_from_stereo::update_left_detection_3d_position_from_disparity(
+    const kwiver::vital::detected_object_sptr &detection, const cv::Mat &cv_disparity_map) const {
+  auto position = estimate_3d_position_from_detection_disparity(detection, cv_disparity_map, true, 1. / 3.);
+  add_3d_position_notes(detection, position);
+  return position;
+}
+
+
+void viame::core::detections_pairing_from_stereo::add_3d_position_notes(
+    const kwiver::vital::detected_object_sptr &detection, const Detections3DPositions &position) {
   // Add 3d estimations to state if score is valid
   if (position.score > 0) {
     detection->add_note(":stereo3d_x=" + std::to_string(position.center3d.x));
@@ -403,8 +499,178 @@ viame::core::Detections3DPositions viame::core::detections_pairing_from_stereo::
     detection->add_note(":stereo3d_z=" + std::to_string(position.center3d.z));
     detection->add_note(":score=" + std::to_string(position.score));
   }
+}
 
-  return position;
+
+viame::core::Detections3DPositions
+viame::core::detections_pairing_from_stereo::estimate_3d_position_from_detection_disparity(
+    const kwiver::vital::detected_object_sptr &detection, const cv::Mat &cv_disparity_map, bool do_undistort_points,
+    float bbox_crop_ratio) const {
+  auto mask = get_standard_mask(detection);
+
+  if (mask.empty())
+    return estimate_3d_position_from_bbox_disparity(detection->bounding_box(), cv_disparity_map, bbox_crop_ratio,
+                                                    do_undistort_points);
+
+  return estimate_3d_position_from_unrectified_mask_disparity(detection->bounding_box(), cv_disparity_map, mask,
+                                                              do_undistort_points);
+}
+
+
+void viame::core::detections_pairing_from_stereo::reproject_3d_region(const cv::Mat &cv_disparity_map,
+                                                                      const cv::Rect &rect,
+                                                                      cv::Mat &region_3d_map) const {
+  // Offset Q so that the region local pixel coordinates map to the full frame coordinates
+  cv::Matx44d Q;
+  reprojection_matrix(cv_disparity_map).convertTo(Q, CV_64F);
+  const cv::Matx44d offset{1, 0, 0, (double) rect.x,
+                           0, 1, 0, (double) rect.y,
+                           0, 0, 1, 0,
+                           0, 0, 0, 1};
+  cv::reprojectImageTo3D(cv_disparity_map(rect), region_3d_map, cv::Mat(Q * offset), false);
+}
+
+
+viame::core::Detections3DPositions
+viame::core::detections_pairing_from_stereo::estimate_3d_position_from_bbox_disparity(
+    const kwiver::vital::bounding_box_d &bbox, const cv::Mat &cv_disparity_map, float crop_ratio,
+    bool do_undistort_points) const {
+  const auto rectified_bbox = do_undistort_points ? get_rectified_bbox(bbox, true) : bbox;
+
+  // Same crop as estimate_3d_position_from_bbox
+  float crop_width = crop_ratio * (float) rectified_bbox.width();
+  float crop_height = crop_ratio * (float) rectified_bbox.height();
+  cv::Rect crop_rect{(int) (rectified_bbox.center().x() - crop_width / 2),
+                     (int) (rectified_bbox.center().y() - crop_height / 2), (int) crop_width, (int) crop_height};
+  crop_rect = crop_rect & cv::Rect(0, 0, cv_disparity_map.size().width, cv_disparity_map.size().height);
+
+  if (m_verbose)
+    print(crop_rect, "CROP RECT");
+
+  if (crop_rect.width == 0 || crop_rect.height == 0) {
+    return {};
+  }
+
+  // Only the cropped pixels are reprojected
+  auto &ws = workspace();
+  auto &crop = ws.region_3d_map;
+  reproject_3d_region(cv_disparity_map, crop_rect, crop);
+
+  auto &valid_xs = ws.xs;
+  auto &valid_ys = ws.ys;
+  auto &valid_zs = ws.zs;
+  valid_xs.clear();
+  valid_ys.clear();
+  valid_zs.clear();
+
+  for (int i_row = 0; i_row < crop.rows; i_row++) {
+    const auto *row = crop.ptr<cv::Vec3f>(i_row);
+    for (int i_col = 0; i_col < crop.cols; i_col++) {
+      const auto &pt = row[i_col];
+
+      if (point_is_valid(pt)) {
+        valid_xs.push_back(pt[0]);
+        valid_ys.push_back(pt[1]);
+        valid_zs.push_back(pt[2]);
+      }
+    }
+  }
+
+  auto score = (float) valid_xs.size() / (crop_width * crop_height);
+  return create_3d_position(valid_xs, valid_ys, valid_zs, rectified_bbox, cv_disparity_map.size(), score,
+                            [&] { return project_to_right_image_from_disparity(rectified_bbox, cv_disparity_map); });
+}
+
+
+viame::core::Detections3DPositions
+viame::core::detections_pairing_from_stereo::estimate_3d_position_from_unrectified_mask_disparity(
+    const kwiver::vital::bounding_box_d &bbox, const cv::Mat &cv_disparity_map, const cv::Mat &mask,
+    bool do_undistort_points) const {
+  if (bbox.width() == 0 || bbox.height() == 0)
+    return {};
+
+  auto &undistorted_mask_coords = workspace().undistorted_coords;
+  mask_to_rectified_coordinates(bbox, mask, do_undistort_points, cv_disparity_map.size(), undistorted_mask_coords);
+
+  if (undistorted_mask_coords.empty())
+    return {};
+
+  const auto rectified_bbox = do_undistort_points ? get_rectified_bbox(bbox, true) : bbox;
+
+  // Bounds of the in image mask points, which are the only reprojected pixels
+  const auto map_size = cv_disparity_map.size();
+  const auto is_out_of_bounds = [&map_size](const cv::Point2d &pt) {
+    return (pt.x < 0.) || (pt.y < 0.) || (pt.x >= map_size.width) || (pt.y >= map_size.height);
+  };
+
+  int min_x{map_size.width}, min_y{map_size.height}, max_x{-1}, max_y{-1};
+  for (const auto &point: undistorted_mask_coords) {
+    if (is_out_of_bounds(point))
+      continue;
+    min_x = std::min(min_x, (int) point.x);
+    min_y = std::min(min_y, (int) point.y);
+    max_x = std::max(max_x, (int) point.x);
+    max_y = std::max(max_y, (int) point.y);
+  }
+
+  int n_total{};
+  auto &ws = workspace();
+  auto &xs = ws.xs;
+  auto &ys = ws.ys;
+  auto &zs = ws.zs;
+  xs.clear();
+  ys.clear();
+  zs.clear();
+
+  if (max_x >= 0) {
+    const cv::Rect region{min_x, min_y, max_x - min_x + 1, max_y - min_y + 1};
+    auto &region_3d_map = ws.region_3d_map;
+    reproject_3d_region(cv_disparity_map, region, region_3d_map);
+
+    for (const auto &point: undistorted_mask_coords) {
+      if (is_out_of_bounds(point))
+        continue;
+
+      n_total += 1;
+      auto point_3d = region_3d_map.at<cv::Vec3f>((int) point.y - region.y, (int) point.x - region.x);
+
+      if (point_is_valid(point_3d)) {
+        xs.push_back(point_3d[0]);
+        ys.push_back(point_3d[1]);
+        zs.push_back(point_3d[2]);
+      }
+    }
+  }
+
+  auto score = n_total > 0 ? ((float) xs.size() / (float) n_total) : 0.f;
+  return create_3d_position(xs, ys, zs, rectified_bbox, map_size, score,
+                            [&] { return project_to_right_image_from_disparity(rectified_bbox, cv_disparity_map); });
+}
+
+
+kwiver::vital::bounding_box_d viame::core::detections_pairing_from_stereo::project_to_right_image_from_disparity(
+    const kwiver::vital::bounding_box_d &bbox, const cv::Mat &cv_disparity_map) const {
+  auto saturate_pos = [&cv_disparity_map](const Eigen::Matrix<double, 2, 1> &corner) {
+    auto x = std::min(std::max(corner.x(), 0.), cv_disparity_map.size().width - 1.);
+    auto y = std::min(std::max(corner.y(), 0.), cv_disparity_map.size().height - 1.);
+
+    return Eigen::Matrix<double, 2, 1>{x, y};
+  };
+
+  auto bbox_ul = saturate_pos(bbox.upper_left());
+  auto bbox_lr = saturate_pos(bbox.lower_right());
+
+  // Reproject only the two corner pixels
+  auto &point_3d_map = workspace().point_3d_map;
+  reproject_3d_region(cv_disparity_map, {(int) bbox_ul.x(), (int) bbox_ul.y(), 1, 1}, point_3d_map);
+  auto tl_3d = point_3d_map.at<cv::Vec3f>(0, 0);
+  reproject_3d_region(cv_disparity_map, {(int) bbox_lr.x(), (int) bbox_lr.y(), 1, 1}, point_3d_map);
+  auto br_3d = point_3d_map.at<cv::Vec3f>(0, 0);
+
+  if (!point_is_valid(tl_3d) || !point_is_valid(br_3d))
+    return {};
+
+  return project_to_right_image(std::vector<cv::Vec3f>{tl_3d, br_3d});
 }
 
 
@@ -423,13 +689,130 @@ double viame::core::detections_pairing_from_stereo::iou_distance(const kwiver::v
 }
 
 
+viame::core::BoundingBoxes::BoundingBoxes(const std::vector<kwiver::vital::bounding_box_d> &bboxes) {
+  reserve(bboxes.size());
+  for (const auto &bbox: bboxes)
+    push_back(bbox);
+}
+
+
+void viame::core::BoundingBoxes::reserve(size_t size) {
+  min_x.reserve(size);
+  min_y.reserve(size);
+  max_x.reserve(size);
+  max_y.reserve(size);
+}
+
+
+void viame::core::BoundingBoxes::push_back(const kwiver::vital::bounding_box_d &bbox) {
+  // Empty boxes at origin never have a positive intersection area with another box
+  const bool is_valid = bbox.is_valid();
+  min_x.push_back(is_valid ? bbox.min_x() : 0.);
+  min_y.push_back(is_valid ? bbox.min_y() : 0.);
+  max_x.push_back(is_valid ? bbox.max_x() : 0.);
+  max_y.push_back(is_valid ? bbox.max_y() : 0.);
+}
+
+
+void viame::core::detections_pairing_from_stereo::iou_matrix(const BoundingBoxes &bboxes1,
+                                                             const BoundingBoxes &bboxes2, std::vector<double> &iou) {
+  const size_t n_cols = bboxes2.size();
+  iou.resize(bboxes1.size() * n_cols);
+
+  // Minimal union area, avoids dividing by zero for pairs of empty boxes whose intersection is null
+  const double min_union = std::numeric_limits<double>::min();
+  std::vector<double> areas2(n_cols);
+  for (size_t j = 0; j < n_cols; j++)
+    areas2[j] = (bboxes2.max_x[j] - bboxes2.min_x[j]) * (bboxes2.max_y[j] - bboxes2.min_y[j]);
+
+  for (size_t i = 0; i < bboxes1.size(); i++) {
+    const double x0 = bboxes1.min_x[i], y0 = bboxes1.min_y[i], x1 = bboxes1.max_x[i], y1 = bboxes1.max_y[i];
+    const double area1 = (x1 - x0) * (y1 - y0);
+    double *row = iou.data() + i * n_cols;
+    size_t j = 0;
+
+#if defined(__AVX__)
+    const __m256d zero4 = _mm256_setzero_pd(), min_union4 = _mm256_set1_pd(min_union);
+    const __m256d x0_4 = _mm256_set1_pd(x0), y0_4 = _mm256_set1_pd(y0), x1_4 = _mm256_set1_pd(x1),
+        y1_4 = _mm256_set1_pd(y1), area1_4 = _mm256_set1_pd(area1);
+    for (; j + 4 <= n_cols; j += 4) {
+      const __m256d w = _mm256_max_pd(zero4, _mm256_sub_pd(_mm256_min_pd(x1_4, _mm256_loadu_pd(&bboxes2.max_x[j])),
+                                                           _mm256_max_pd(x0_4, _mm256_loadu_pd(&bboxes2.min_x[j]))));
+      const __m256d h = _mm256_max_pd(zero4, _mm256_sub_pd(_mm256_min_pd(y1_4, _mm256_loadu_pd(&bboxes2.max_y[j])),
+                                                           _mm256_max_pd(y0_4, _mm256_loadu_pd(&bboxes2.min_y[j]))));
+      const __m256d inter = _mm256_mul_pd(w, h);
+      const __m256d uni = _mm256_sub_pd(_mm256_add_pd(area1_4, _mm256_loadu_pd(&areas2[j])), inter);
+      _mm256_storeu_pd(row + j, _mm256_div_pd(inter, _mm256_max_pd(uni, min_union4)));
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128d zero2 = _mm_setzero_pd(), min_union2 = _mm_set1_pd(min_union);
+    const __m128d x0_2 = _mm_set1_pd(x0), y0_2 = _mm_set1_pd(y0), x1_2 = _mm_set1_pd(x1), y1_2 = _mm_set1_pd(y1),
+        area1_2 = _mm_set1_pd(area1);
+    for (; j + 2 <= n_cols; j += 2) {
+      const __m128d w = _mm_max_pd(zero2, _mm_sub_pd(_mm_min_pd(x1_2, _mm_loadu_pd(&bboxes2.max_x[j])),
+                                                     _mm_max_pd(x0_2, _mm_loadu_pd(&bboxes2.min_x[j]))));
+      const __m128d h = _mm_max_pd(zero2, _mm_sub_pd(_mm_min_pd(y1_2, _mm_loadu_pd(&bboxes2.max_y[j])),
+                                                     _mm_max_pd(y0_2, _mm_loadu_pd(&bboxes2.min_y[j]))));
+      const __m128d inter = _mm_mul_pd(w, h);
+      const __m128d uni = _mm_sub_pd(_mm_add_pd(area1_2, _mm_loadu_pd(&areas2[j])), inter);
+      _mm_storeu_pd(row + j, _mm_div_pd(inter, _mm_max_pd(uni, min_union2)));
+    }
+#endif
+    for (; j < n_cols; j++) {
+      const double w = std::max(0., std::min(x1, bboxes2.max_x[j]) - std::max(x0, bboxes2.min_x[j]));
+      const double h = std::max(0., std::min(y1, bboxes2.max_y[j]) - std::max(y0, bboxes2.min_y[j]));
+      const double inter = w * h;
+      row[j] = inter / std::max(area1 + areas2[j] - inter, min_union);
+    }
+  }
+}
+
+
+cv::Mat viame::core::detections_pairing_from_stereo::reprojection_matrix(const cv::Mat &cv_disparity) const {
+  if (cv_disparity.depth() != CV_16S || m_fixed_point_disparity_scale == 1.f)
+    return m_Q;
+
+  cv::Mat Q;
+  m_Q.convertTo(Q, CV_64F);
+  Q.col(2) /= m_fixed_point_disparity_scale;
+  return Q;
+}
+
+
 cv::Mat viame::core::detections_pairing_from_stereo::reproject_3d_depth_map(const cv::Mat &cv_disparity_left) const {
   cv::Mat cv_pos_3d_left_map;
-  cv::reprojectImageTo3D(cv_disparity_left, cv_pos_3d_left_map, m_Q, false);
+  reproject_3d_depth_map(cv_disparity_left, cv_pos_3d_left_map);
   return cv_pos_3d_left_map;
 }
 
 
+void viame::core::detections_pairing_from_stereo::reproject_3d_depth_map(const cv::Mat &cv_disparity_left,
+                                                                         cv::Mat &pos_3d_map) const {
+  cv::reprojectImageTo3D(cv_disparity_left, pos_3d_map, reprojection_matrix(cv_disparity_left), false);
+}
+
+
+const cv::Mat &
+viame::core::detections_pairing_from_stereo::reproject_3d_depth_map_in_workspace(const cv::Mat &cv_disparity_left) const {
+  auto &pos_3d_map = workspace().pos_3d_map;
+  reproject_3d_depth_map(cv_disparity_left, pos_3d_map);
+  return pos_3d_map;
+}
+
+
+void viame::core::detections_pairing_from_stereo::reproject_3d_depth_map_rows(const cv::Mat &cv_disparity_left,
+                                                                              int first_row, int row_count,
+                                                                              cv::Mat &pos_3d_block) const {
+  // Block pixel rows start at 0, shift them back to their rows in the full map
+  cv::Mat Q;
+  reprojection_matrix(cv_disparity_left).convertTo(Q, CV_64F);
+  Q.col(3) += first_row * Q.col(1);
+
+  cv::reprojectImageTo3D(cv_disparity_left.rowRange(first_row, first_row + row_count), pos_3d_block, Q, false);
+}
+
+
 cv::Point2d
 viame::core::detections_pairing_from_stereo::undistort_point(const cv::Point2d &point, bool is_left_image) const {
   return undistort_point(std::vector<cv::Point2d>{point}, is_left_image)[0];
@@ -440,12 +823,150 @@ std::vector<cv::Point2d>
 viame::core::detections_pairing_from_stereo::undistort_point(const std::vector<cv::Point2d> &point,
                                                              bool is_left_image) const {
   std::vector<cv::Point2d> points_undist;
+  undistort_point(point, points_undist, is_left_image);
+  return points_undist;
+}
+
 
+void viame::core::detections_pairing_from_stereo::undistort_point(const std::vector<cv::Point2d> &point,
+                                                                  std::vector<cv::Point2d> &points_undist,
+                                                                  bool is_left_image) const {
   if (is_left_image)
-    cv::undistortPoints(std::vector<cv::Point2d>{point}, points_undist, m_K1, m_D1, m_R1, m_P1);
+    cv::undistortPoints(point, points_undist, m_K1, m_D1, m_R1, m_P1);
   else
-    cv::undistortPoints(std::vector<cv::Point2d>{point}, points_undist, m_K2, m_D2, m_R2, m_P2);
-  return points_undist;
+    cv::undistortPoints(point, points_undist, m_K2, m_D2, m_R2, m_P2);
+}
+
+
+std::shared_ptr<const cv::Mat>
+viame::core::detections_pairing_from_stereo::left_undistortion_lut(const cv::Size &image_size) const {
+  {
+    std::lock_guard<std::mutex> lock(m_workspaces.mutex);
+    const auto &lut = m_workspaces.left_undistortion_lut;
+    if (lut && lut->size() == image_size)
+      return lut;
+  }
+
+  // Undistort every pixel center outside of the lock, one row at a time to bound the temporary buffers
+  auto lut = std::make_shared<cv::Mat>(image_size, CV_32FC2);
+  std::vector<cv::Point2d> row_coords(image_size.width), row_undistorted;
+  for (int i_y = 0; i_y < image_size.height; i_y++) {
+    for (int i_x = 0; i_x < image_size.width; i_x++)
+      row_coords[i_x] = cv::Point2d(i_x, i_y);
+
+    undistort_point(row_coords, row_undistorted, true);
+    auto *lut_row = lut->ptr<cv::Vec2f>(i_y);
+    for (int i_x = 0; i_x < image_size.width; i_x++)
+      lut_row[i_x] = cv::Vec2f((float) row_undistorted[i_x].x, (float) row_undistorted[i_x].y);
+  }
+
+  std::lock_guard<std::mutex> lock(m_workspaces.mutex);
+  m_workspaces.left_undistortion_lut = lut;
+  return lut;
+}
+
+
+void viame::core::detections_pairing_from_stereo::mask_to_rectified_coordinates(
+    const kwiver::vital::bounding_box_d &bbox, const cv::Mat &mask, bool do_undistort_points,
+    const cv::Size &image_size, std::vector<cv::Point2d> &coords) const {
+  coords.clear();
+  const auto mask_tl = bbox.upper_left();
+
+  // Row-major scan of the mask, following its memory layout
+  const auto gather = [&](std::vector<cv::Point2d> &out) {
+    for (int i_y = 0; i_y < mask.rows; i_y++) {
+      const auto *mask_row = mask.ptr<uchar>(i_y);
+      for (int i_x = 0; i_x < mask.cols; i_x++) {
+        if (mask_row[i_x] > 0)
+          out.emplace_back(mask_tl.x() + i_x, mask_tl.y() + i_y);
+      }
+    }
+  };
+
+  if (!do_undistort_points) {
+    gather(coords);
+    return;
+  }
+
+  auto &distorted_coords = workspace().mask_coords;
+  distorted_coords.clear();
+
+  if (!m_use_undistortion_lut || image_size.area() == 0) {
+    gather(distorted_coords);
+    if (!distorted_coords.empty())
+      undistort_point(distorted_coords, coords, true);
+    return;
+  }
+
+  // Bilinear lookup of the undistorted coordinates for the in image pixels. The mask may be placed at sub pixel
+  // positions, other pixels are undistorted directly.
+  const auto lut = left_undistortion_lut(image_size);
+  const double x_offset = mask_tl.x() - std::floor(mask_tl.x());
+  const double y_offset = mask_tl.y() - std::floor(mask_tl.y());
+  const int x_origin = (int) std::floor(mask_tl.x());
+  const int y_origin = (int) std::floor(mask_tl.y());
+  const int x_pad = x_offset > 0 ? 1 : 0;
+  const int y_pad = y_offset > 0 ? 1 : 0;
+
+  for (int i_y = 0; i_y < mask.rows; i_y++) {
+    const auto *mask_row = mask.ptr<uchar>(i_y);
+    const int y0 = y_origin + i_y;
+    const bool row_in_image = y0 >= 0 && y0 + y_pad < image_size.height;
+    const auto *lut_row0 = row_in_image ? lut->ptr<cv::Vec2f>(y0) : nullptr;
+    const auto *lut_row1 = row_in_image ? lut->ptr<cv::Vec2f>(y0 + y_pad) : nullptr;
+
+    for (int i_x = 0; i_x < mask.cols; i_x++) {
+      if (mask_row[i_x] == 0)
+        continue;
+
+      const int x0 = x_origin + i_x;
+      if (!row_in_image || x0 < 0 || x0 + x_pad >= image_size.width) {
+        distorted_coords.emplace_back(mask_tl.x() + i_x, mask_tl.y() + i_y);
+        continue;
+      }
+
+      const cv::Vec2f top = lut_row0[x0] * (1. - x_offset) + lut_row0[x0 + x_pad] * x_offset;
+      const cv::Vec2f bottom = lut_row1[x0] * (1. - x_offset) + lut_row1[x0 + x_pad] * x_offset;
+      const cv::Vec2f undistorted = top * (1. - y_offset) + bottom * y_offset;
+      coords.emplace_back(undistorted[0], undistorted[1]);
+    }
+  }
+
+  if (!distorted_coords.empty()) {
+    auto &outside_coords = workspace().outside_image_coords;
+    undistort_point(distorted_coords, outside_coords, true);
+    coords.insert(coords.end(), outside_coords.begin(), outside_coords.end());
+  }
+}
+
+
+viame::core::detections_pairing_from_stereo::Workspace &
+viame::core::detections_pairing_from_stereo::workspace() const {
+  std::lock_guard<std::mutex> lock(m_workspaces.mutex);
+  auto &thread_workspace = m_workspaces.workspaces[std::this_thread::get_id()];
+  if (!thread_workspace)
+    thread_workspace = std::make_unique<Workspace>();
+  return *thread_workspace;
+}
+
+
+float viame::core::detections_pairing_from_stereo::workspace_median(const std::vector<float> &values) const {
+  if (values.empty())
+    return 0;
+
+  // Partial sort a copy held in the workspace to keep the input order and avoid allocations
+  auto &scratch = workspace().median_values;
+  scratch.assign(values.begin(), values.end());
+
+  const auto size = scratch.size();
+  const auto middle = scratch.begin() + (long) (size / 2);
+  std::nth_element(scratch.begin(), middle, scratch.end());
+  if (size % 2 != 0)
+    return *middle;
+
+  // Even size, lower middle value is the largest of the lower half
+  const auto lower = *std::max_element(scratch.begin(), middle);
+  return (lower + *middle) / 2;
 }
 
 
@@ -469,128 +990,289 @@ private:
   std::set<T> m_processed;
 };
 
-std::vector<std::vector<size_t>>
+/// @class RowBinIndex
+/// @brief Spatial index of bounding boxes along the image rows.
+///     Bounding boxes are registered in every fixed height bin their vertical extent covers, so that the candidates for
+///     a point are read from a single bin instead of scanning every box.
+class RowBinIndex {
+public:
+  explicit RowBinIndex(const std::vector<kwiver::vital::bounding_box_d> &bboxes, double bin_height = 32.)
+      : m_bin_height{bin_height} {
+    double y_min = std::numeric_limits<double>::max(), y_max = std::numeric_limits<double>::lowest();
+    for (const auto &bbox: bboxes) {
+      if (!bbox.is_valid())
+        continue;
+      y_min = std::min(y_min, bbox.min_y());
+      y_max = std::max(y_max, bbox.max_y());
+    }
+
+    if (y_min > y_max)
+      return;
+
+    // Bound the number of bins for large coordinate ranges
+    m_y_min = y_min;
+    m_bin_height = std::max(m_bin_height, (y_max - y_min) / 1024.);
+    m_bins.resize(bin_index(y_max) + 1);
+    for (size_t i_bbox = 0; i_bbox < bboxes.size(); i_bbox++) {
+      const auto &bbox = bboxes[i_bbox];
+      if (!bbox.is_valid())
+        continue;
+
+      for (auto i_bin = bin_index(bbox.min_y()); i_bin <= bin_index(bbox.max_y()); i_bin++)
+        m_bins[i_bin].emplace_back(i_bbox);
+    }
+  }
+
+  /// @brief Returns the indices of the boxes whose vertical extent may contain y, in increasing order
+  const std::vector<size_t> &candidates(double y) const {
+    static const std::vector<size_t> empty;
+    if (m_bins.empty() || !(y >= m_y_min))
+      return empty;
+
+    const auto i_bin = bin_index(y);
+    return i_bin < m_bins.size() ? m_bins[i_bin] : empty;
+  }
+
+private:
+  size_t bin_index(double y) const { return static_cast<size_t>((y - m_y_min) / m_bin_height); }
+
+  double m_bin_height;
+  double m_y_min{};
+  std::vector<std::vector<size_t>> m_bins;
+};
+
+
+std::vector<std::pair<size_t, size_t>>
 viame::core::detections_pairing_from_stereo::pair_left_right_detections_using_3d_center(
     const std::vector<kwiver::vital::detected_object_sptr> &left_detections,
     const std::vector<viame::core::Detections3DPositions> &left_3d_pos,
-    const std::vector<kwiver::vital::detected_object_sptr> &right_detections) {
+    const std::vector<kwiver::vital::detected_object_sptr> &right_detections, bool do_optimal_assignment) {
+  std::vector<DetectionSpan::element_ptr> left_buffer, right_buffer;
+  return pair_left_right_detections_using_3d_center(DetectionSpan::of(left_detections, left_buffer), left_3d_pos,
+                                                    DetectionSpan::of(right_detections, right_buffer),
+                                                    do_optimal_assignment);
+}
 
-  std::vector<std::vector<size_t>> paired_detections;
-  ProcessTracker<size_t> tracker;
 
-  const auto most_probable_right_detection = [&right_detections, &tracker](
-      const Eigen::Matrix<double, 2, 1> &left_point, const std::string &left_class) {
-    int i_best = -1;
-    auto dist_best = std::numeric_limits<double>::max();
+std::vector<std::pair<size_t, size_t>>
+viame::core::detections_pairing_from_stereo::pair_left_right_detections_using_3d_center(
+    DetectionSpan left_detections, const std::vector<viame::core::Detections3DPositions> &left_3d_pos,
+    DetectionSpan right_detections, bool do_optimal_assignment) {
+
+  std::vector<std::pair<size_t, size_t>> paired_detections;
+
+  // Both views share the class indices of a single set, left rows first
+  const auto columns = to_detection_arrays(left_detections, right_detections);
+  const size_t right_offset = left_detections.size();
+
+  // Index right boxes by rows to only test the boxes close to the projected left centers
+  std::vector<kwiver::vital::bounding_box_d> right_bboxes;
+  right_bboxes.reserve(right_detections.size());
+  for (size_t i_right = 0; i_right < right_detections.size(); i_right++)
+    right_bboxes.emplace_back(columns.box(right_offset + i_right));
+  const RowBinIndex right_index{right_bboxes};
+
+  // Candidate left / right pairs and their distance to the right box center
+  struct Candidate {
+    size_t i_left, i_right;
+    double dist;
+  };
+  std::vector<Candidate> candidates;
 
-    for (size_t i_right = 0; i_right < right_detections.size(); i_right++) {
-      // Skip right tracks not in current frame or with different detection class
-      const auto &right_detection = right_detections[i_right];
-      if (most_likely_detection_class(right_detection) != left_class || tracker.is_processed(i_right))
-        continue;
+  for (size_t i_left = 0; i_left < left_detections.size(); i_left++) {
+    // Skip left tracks not in current frame or invalid
+    if (!left_3d_pos[i_left].is_valid())
+      continue;
+
+    const auto left_class = columns.class_id[i_left];
+    const auto proj_left_point = left_3d_pos[i_left].center3d_proj_to_right_image;
+    const Eigen::Matrix<double, 2, 1> left_point{proj_left_point.x, proj_left_point.y};
 
-      auto right_bbox = right_detection->bounding_box();
-      if (!right_bbox.is_valid() || !right_bbox.contains(left_point))
+    for (const auto i_right: right_index.candidates(left_point.y())) {
+      // Skip right tracks with different detection class or not containing the projected center point
+      const auto &right_bbox = right_bboxes[i_right];
+      if (columns.class_id[right_offset + i_right] != left_class || !right_bbox.contains(left_point))
         continue;
 
-      const auto dist = (right_bbox.center() - left_point).norm();
-      if (dist < dist_best) {
-        i_best = (int) i_right;
-        dist_best = dist;
+      candidates.push_back({i_left, i_right, (right_bbox.center() - left_point).norm()});
+    }
+  }
+
+  if (!do_optimal_assignment) {
+    // Greedy pairing in the left detection order, keeping the closest right detection not already paired
+    ProcessTracker<size_t> tracker;
+    for (size_t i_candidate = 0; i_candidate < candidates.size();) {
+      const auto i_left = candidates[i_candidate].i_left;
+      int i_best = -1;
+      auto dist_best = std::numeric_limits<double>::max();
+      for (; i_candidate < candidates.size() && candidates[i_candidate].i_left == i_left; i_candidate++) {
+        const auto &candidate = candidates[i_candidate];
+        if (!tracker.is_processed(candidate.i_right) && candidate.dist < dist_best) {
+          i_best = (int) candidate.i_right;
+          dist_best = candidate.dist;
+        }
       }
+
+      if (i_best < 0)
+        continue;
+
+      paired_detections.emplace_back(i_left, static_cast<size_t>(i_best));
+      tracker.emplace(static_cast<size_t>(i_best));
     }
-    return i_best;
+    return paired_detections;
+  }
+
+  // Split the candidate graph in connected components so that each assignment problem stays small
+  std::vector<size_t> parents(left_detections.size() + right_detections.size());
+  std::iota(parents.begin(), parents.end(), 0);
+  const auto find_root = [&parents](size_t i) {
+    while (parents[i] != i)
+      i = parents[i] = parents[parents[i]];
+    return i;
   };
 
-  for (size_t i_left = 0; i_left < left_detections.size(); i_left++) {
-    const auto &left_detection = left_detections[i_left];
-    const auto left_class = most_likely_detection_class(left_detection);
+  for (const auto &candidate: candidates)
+    parents[find_root(candidate.i_left)] = find_root(left_detections.size() + candidate.i_right);
 
-    // Skip left tracks not in current frame or invalid
-    if (!left_3d_pos[i_left].is_valid())
-      continue;
+  std::map<size_t, std::vector<const Candidate *>> components;
+  for (const auto &candidate: candidates)
+    components[find_root(candidate.i_left)].emplace_back(&candidate);
 
-    // Find most probable right track match given projected center point
-    const auto proj_left_point = left_3d_pos[i_left].center3d_proj_to_right_image;
-    const auto i_right = most_probable_right_detection({proj_left_point.x, proj_left_point.y}, left_class);
-    if (i_right < 0)
-      continue;
+  for (const auto &component: components) {
+    // Map component detections to local cost matrix rows and columns
+    std::map<size_t, size_t> rows, cols;
+    for (const auto candidate: component.second) {
+      rows.emplace(candidate->i_left, rows.size());
+      cols.emplace(candidate->i_right, cols.size());
+    }
 
-    paired_detections.emplace_back(std::vector<size_t>{i_left, static_cast<size_t>(i_right)});
-    tracker.emplace(i_right);
+    // Forbidden pairs are given a cost larger than any valid assignment and dropped afterwards
+    double forbidden_cost = 1.;
+    for (const auto candidate: component.second)
+      forbidden_cost += candidate->dist;
+
+    std::vector<double> costs(rows.size() * cols.size(), forbidden_cost);
+    for (const auto candidate: component.second)
+      costs[rows[candidate->i_left] * cols.size() + cols[candidate->i_right]] = candidate->dist;
+
+    std::vector<size_t> col_to_right(cols.size());
+    for (const auto &col: cols)
+      col_to_right[col.second] = col.first;
+
+    const auto assignment = solve_linear_assignment(costs, rows.size(), cols.size());
+    for (const auto &row: rows) {
+      const auto i_col = assignment[row.second];
+      if (i_col < 0 || costs[row.second * cols.size() + i_col] >= forbidden_cost)
+        continue;
+
+      paired_detections.emplace_back(row.first, col_to_right[i_col]);
+    }
   }
+
+  std::sort(paired_detections.begin(), paired_detections.end());
   return paired_detections;
 }
 
 
-std::vector<std::vector<size_t>> viame::core::detections_pairing_from_stereo::pair_left_right_tracks_using_bbox_iou(
+std::vector<std::pair<size_t, size_t>>
+viame::core::detections_pairing_from_stereo::pair_left_right_tracks_using_bbox_iou(
     const std::vector<kwiver::vital::detected_object_sptr> &left_detections,
     const std::vector<kwiver::vital::detected_object_sptr> &right_detections, bool do_rectify_bbox) {
+  std::vector<DetectionSpan::element_ptr> left_buffer, right_buffer;
+  return pair_left_right_tracks_using_bbox_iou(DetectionSpan::of(left_detections, left_buffer),
+                                               DetectionSpan::of(right_detections, right_buffer), do_rectify_bbox);
+}
+
+
+std::vector<std::pair<size_t, size_t>>
+viame::core::detections_pairing_from_stereo::pair_left_right_tracks_using_bbox_iou(
+    DetectionSpan left_detections, DetectionSpan right_detections, bool do_rectify_bbox) {
 
-  std::vector<std::vector<size_t>> paired_detections;
+  std::vector<std::pair<size_t, size_t>> paired_detections;
   ProcessTracker<size_t> tracker;
 
-  const auto most_probable_right_track = [&right_detections, do_rectify_bbox, &tracker, this](
-      const kwiver::vital::detected_object_sptr &left_detection, const std::string &left_class) {
-    int i_best = -1;
-    auto best_iou = std::numeric_limits<double>::lowest();
-    auto left_bbox = left_detection->bounding_box();
-    if (do_rectify_bbox)
-      left_bbox = get_rectified_bbox(left_bbox, true);
+  // Both views share the class indices of a single set, left rows first
+  const auto columns = to_detection_arrays(left_detections, right_detections);
+  const size_t right_offset = left_detections.size();
+
+  // Compute the IOU of every left / right pair at once
+  const auto to_bboxes = [&columns, do_rectify_bbox, this](size_t first, size_t count) {
+    BoundingBoxes bboxes;
+    bboxes.reserve(count);
+    for (size_t i = first; i < first + count; i++) {
+      auto bbox = columns.box(i);
+      if (do_rectify_bbox && bbox.is_valid())
+        bbox = get_rectified_bbox(bbox, true);
+      bboxes.push_back(bbox);
+    }
+    return bboxes;
+  };
 
-    if (!left_bbox.is_valid())
-      return i_best;
+  std::vector<double> ious;
+  iou_matrix(to_bboxes(0, left_detections.size()), to_bboxes(right_offset, right_detections.size()), ious);
 
-    for (size_t i_right = 0; i_right < right_detections.size(); i_right++) {
-      // Skip right tracks not in current frame or with different detection class
-      const auto &right_track = right_detections[i_right];
-      if (most_likely_detection_class(right_track) != left_class || tracker.is_processed(i_right))
-        continue;
+  for (size_t i_left = 0; i_left < left_detections.size(); i_left++) {
+    const auto left_track_class = columns.class_id[i_left];
+    const double *left_ious = ious.data() + i_left * right_detections.size();
 
-      auto right_bbox = right_track->bounding_box();
-      if (!right_bbox.is_valid())
+    // Find most probable right track match given the IOU with the left bounding box
+    int i_right = -1;
+    auto best_iou = std::numeric_limits<double>::lowest();
+    for (size_t i_candidate = 0; i_candidate < right_detections.size(); i_candidate++) {
+      // Skip right tracks already paired or with different detection class
+      const auto iou = left_ious[i_candidate];
+      if (iou <= m_iou_pair_threshold || iou <= best_iou || tracker.is_processed(i_candidate) ||
+          columns.class_id[right_offset + i_candidate] != left_track_class)
         continue;
 
-      if (do_rectify_bbox)
-        right_bbox = get_rectified_bbox(right_bbox, true);
-
-      const auto iou = iou_distance(left_bbox, right_bbox);
-      if ((iou > m_iou_pair_threshold) && (iou > best_iou)) {
-        i_best = (int) i_right;
-        best_iou = iou;
-      }
+      i_right = (int) i_candidate;
+      best_iou = iou;
     }
-    return i_best;
-  };
 
-  for (size_t i_left = 0; i_left < left_detections.size(); i_left++) {
-    const auto &left_detection = left_detections[i_left];
-    const auto left_track_class = most_likely_detection_class(left_detection);
-
-    // Find most probable right track match given projected center point
-    const auto i_right = most_probable_right_track(left_detection, left_track_class);
     if (i_right < 0)
       continue;
 
-    paired_detections.emplace_back(std::vector<size_t>{i_left, static_cast<size_t>(i_right)});
+    paired_detections.emplace_back(i_left, static_cast<size_t>(i_right));
     tracker.emplace(i_right);
   }
   return paired_detections;
 }
 
 
-std::vector<std::vector<size_t>> viame::core::detections_pairing_from_stereo::pair_left_right_detections(
+std::vector<std::pair<size_t, size_t>> viame::core::detections_pairing_from_stereo::pair_left_right_detections(
     const std::vector<kwiver::vital::detected_object_sptr> &left_detections,
     const std::vector<viame::core::Detections3DPositions> &left_3d_pos,
     const std::vector<kwiver::vital::detected_object_sptr> &right_detections) {
+  std::vector<DetectionSpan::element_ptr> left_buffer, right_buffer;
+  return pair_left_right_detections(DetectionSpan::of(left_detections, left_buffer), left_3d_pos,
+                                    DetectionSpan::of(right_detections, right_buffer));
+}
+
+
+std::vector<std::pair<size_t, size_t>> viame::core::detections_pairing_from_stereo::pair_left_right_detections(
+    DetectionSpan left_detections, const std::vector<viame::core::Detections3DPositions> &left_3d_pos,
+    DetectionSpan right_detections) {
   bool do_rectify_bbox = m_pairing_method == "PAIRING_RECTIFIED_IOU";
-  if (m_pairing_method == "PAIRING_3D")
-    return pair_left_right_detections_using_3d_center(left_detections, left_3d_pos, right_detections);
+  if (m_pairing_method == "PAIRING_3D" || m_pairing_method == "PAIRING_3D_ASSIGNMENT")
+    return pair_left_right_detections_using_3d_center(left_detections, left_3d_pos, right_detections,
+                                                      m_pairing_method == "PAIRING_3D_ASSIGNMENT");
   else
     return pair_left_right_tracks_using_bbox_iou(left_detections, right_detections, do_rectify_bbox);
 }
 
 
+viame::detection_arrays viame::core::detections_pairing_from_stereo::to_detection_arrays(
+    DetectionSpan left_detections, DetectionSpan right_detections) {
+  detection_arrays columns;
+  columns.reserve(left_detections.size() + right_detections.size());
+  for (const auto &detection: left_detections)
+    columns.push_back(detection);
+  for (const auto &detection: right_detections)
+    columns.push_back(detection);
+  return columns;
+}
+
+
 std::string viame::core::detections_pairing_from_stereo::most_likely_detection_class(
     const kwiver::vital::detected_object_sptr &detection) {
   if (!detection)
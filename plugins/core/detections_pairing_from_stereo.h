@@ -3,13 +3,21 @@
 
 #include <vital/types/bounding_box.h>
 #include <vital/types/detected_object.h>
+#include <vital/types/detected_object_set.h>
 #include <vital/vital_types.h>
 
 #include <opencv2/core/core.hpp>
 
+#include <plugins/core/detection_arrays.h>
 #include <plugins/core/viame_core_export.h>
 
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace viame {
 namespace core {
@@ -29,6 +37,58 @@ struct VIAME_CORE_EXPORT Detections3DPositions {
 };
 
 
+/// @brief Structure of arrays bounding box coordinates used for batched IOU computation
+/// Invalid bounding boxes are stored as empty boxes and have a null IOU with any other box.
+struct VIAME_CORE_EXPORT BoundingBoxes {
+  std::vector<double> min_x, min_y, max_x, max_y;
+
+  BoundingBoxes() = default;
+  explicit BoundingBoxes(const std::vector<kwiver::vital::bounding_box_d> &bboxes);
+
+  void reserve(size_t size);
+  void push_back(const kwiver::vital::bounding_box_d &bbox);
+  size_t size() const { return min_x.size(); }
+};
+
+
+/// @brief Non-owning view of a sequence of detections, through pointers to the shared pointers held by a detection set
+/// or vector. Viewing detections leaves their reference counts unchanged, and the viewed set or vector must outlive the
+/// view and not be modified while it is used.
+class VIAME_CORE_EXPORT DetectionSpan {
+public:
+  using element_ptr = const kwiver::vital::detected_object_sptr *;
+
+  struct iterator {
+    const element_ptr *it;
+    const kwiver::vital::detected_object_sptr &operator*() const { return **it; }
+    iterator &operator++() {
+      ++it;
+      return *this;
+    }
+    bool operator!=(const iterator &other) const { return it != other.it; }
+  };
+
+  DetectionSpan() = default;
+  DetectionSpan(const element_ptr *data, size_t size) : m_data(data), m_size(size) {}
+
+  /// @brief View of the input detections. Pointers are gathered in buffer, which keeps its capacity from one call to
+  ///     the next.
+  static DetectionSpan of(const kwiver::vital::detected_object_set &detections, std::vector<element_ptr> &buffer);
+  static DetectionSpan of(const std::vector<kwiver::vital::detected_object_sptr> &detections,
+                          std::vector<element_ptr> &buffer);
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  const kwiver::vital::detected_object_sptr &operator[](size_t i) const { return *m_data[i]; }
+  iterator begin() const { return {m_data}; }
+  iterator end() const { return {m_data + m_size}; }
+
+private:
+  const element_ptr *m_data{};
+  size_t m_size{};
+};
+
+
 /// @brief Class responsible for the detection stereo pairing logic
 /// Uses camera calibration information, left and right tracks and disparity map to find corresponding detection from
 /// left to right.
@@ -41,13 +101,46 @@ public:
   float m_iou_pair_threshold{.1};
   std::string m_pairing_method{"PAIRING_3D"};
   bool m_verbose{}; // Set to true to activate debug print
+  bool m_sparse_reprojection{}; // Set to true to only reproject the disparity pixels used by each detection
+  float m_fixed_point_disparity_scale{16.f}; // CV_16S disparity values are disparity pixels times this scale
+  bool m_use_undistortion_lut{}; // Set to true to undistort mask pixels with a per pixel lookup table
 
   // Camera depth information
   cv::Mat m_Q, m_K1, m_D1, m_R1, m_P1, m_K2, m_D2, m_R2, m_P2, m_R, m_Rvec, m_T;
 
+  /// @brief Buffers reused from one frame / detection to the next so that steady state processing does not allocate
+  struct Workspace {
+    cv::Mat pos_3d_map;
+    std::vector<float> xs, ys, zs;
+    std::vector<float> median_values;
+    std::vector<cv::Point2d> mask_coords;
+    std::vector<cv::Point2d> undistorted_coords;
+    std::vector<cv::Point2d> outside_image_coords;
+    cv::Mat region_3d_map;
+    cv::Mat point_3d_map;
+  };
+
+  /// @brief Reprojection matrix for the input disparity type. CV_16S fixed-point disparities are reprojected as is,
+  ///     by dividing the disparity column of Q by m_fixed_point_disparity_scale.
+  cv::Mat reprojection_matrix(const cv::Mat &cv_disparity) const;
+
   /// @brief Project depth map as 3 channel 3D image
   cv::Mat reproject_3d_depth_map(const cv::Mat &cv_disparity_left) const;
 
+  /// @brief Project depth map as 3 channel 3D image into the input buffer, reusing its memory if already allocated
+  ///     with the disparity size
+  void reproject_3d_depth_map(const cv::Mat &cv_disparity_left, cv::Mat &pos_3d_map) const;
+
+  /// @brief Project depth map as 3 channel 3D image in the instance workspace.
+  ///     Returned map is overwritten by the next call.
+  const cv::Mat &reproject_3d_depth_map_in_workspace(const cv::Mat &cv_disparity_left) const;
+
+  /// @brief Project rows [first_row, first_row + row_count) of the depth map as 3 channel 3D image into the input
+  ///     buffer. Each block row holds the same values as the matching row of @ref reproject_3d_depth_map, so a map can
+  ///     be processed in blocks of rows without its full 3D image.
+  void reproject_3d_depth_map_rows(const cv::Mat &cv_disparity_left, int first_row, int row_count,
+                                   cv::Mat &pos_3d_block) const;
+
   /// @brief Load matrix calibration from settings camera directory
   void load_camera_calibration();
 
@@ -73,12 +166,38 @@ public:
   /// @brief Rectify bounding box positions given loaded camera properties
   kwiver::vital::bounding_box_d get_rectified_bbox(const kwiver::vital::bounding_box_d &bbox, bool is_left_image) const;
 
+  /// @brief Rectified left image row ranges [first, second) covering the input detections
+  /// @param detections: Left image detections
+  /// @param image_height: Rectified image height used to saturate the ranges
+  /// @param padding: Number of rows added above and below each rectified bounding box
+  std::vector<std::pair<int, int>>
+  rectified_row_strips(DetectionSpan detections, int image_height, int padding) const;
+  std::vector<std::pair<int, int>>
+  rectified_row_strips(const std::vector<kwiver::vital::detected_object_sptr> &detections, int image_height,
+                       int padding) const;
+
   /// @brief Undistort input point coordinate
   cv::Point2d undistort_point(const cv::Point2d &point, bool is_left_image) const;
 
   /// @brief Unistort input point coordinates
   std::vector<cv::Point2d> undistort_point(const std::vector<cv::Point2d> &point, bool is_left_image) const;
 
+  /// @brief Unistort input point coordinates in output vector, reusing its capacity
+  void undistort_point(const std::vector<cv::Point2d> &point, std::vector<cv::Point2d> &points_undist,
+                       bool is_left_image) const;
+
+  /// @brief Undistorted and rectified coordinates of each left image pixel, as a CV_32FC2 map of the image size.
+  ///     Computed on first use for a given image size and shared by all threads.
+  std::shared_ptr<const cv::Mat> left_undistortion_lut(const cv::Size &image_size) const;
+
+  /// @brief Left mask pixel coordinates in row-major order, undistorted if do_undistort_points.
+  ///     Uses the left undistortion lookup table for in image pixels when m_use_undistortion_lut is set.
+  /// @param bbox: Unrectified detection bounding box, placing the mask in the image
+  /// @param image_size: Left image size
+  void mask_to_rectified_coordinates(const kwiver::vital::bounding_box_d &bbox, const cv::Mat &mask,
+                                     bool do_undistort_points, const cv::Size &image_size,
+                                     std::vector<cv::Point2d> &coords) const;
+
   /// @return True if 3D point is valid (not infinite and Z positive)
   static bool point_is_valid(float x, float y, float z);
 
@@ -136,34 +255,77 @@ public:
   update_left_detections_3d_positions(const std::vector<kwiver::vital::detected_object_sptr> &detections,
                                       const cv::Mat &cv_disparity_map) const;
 
+  /// @brief Same as above, writing the positions in the input vector so that its capacity is reused
+  void update_left_detections_3d_positions(DetectionSpan detections, const cv::Mat &cv_disparity_map,
+                                           std::vector<viame::core::Detections3DPositions> &positions) const;
+
   viame::core::Detections3DPositions
   update_left_detection_3d_position(const kwiver::vital::detected_object_sptr &detection,
                                     const cv::Mat &cv_pos_3d_map) const;
 
+  /// @brief Same as @ref update_left_detection_3d_position, reprojecting to 3D only the disparity pixels used by the
+  ///     estimate instead of using a full frame 3D map.
+  viame::core::Detections3DPositions
+  update_left_detection_3d_position_from_disparity(const kwiver::vital::detected_object_sptr &detection,
+                                                   const cv::Mat &cv_disparity_map) const;
+
+  /// @brief Sparse equivalent of @ref estimate_3d_position_from_detection using the disparity map directly.
+  viame::core::Detections3DPositions
+  estimate_3d_position_from_detection_disparity(const kwiver::vital::detected_object_sptr &detection,
+                                                const cv::Mat &cv_disparity_map, bool do_undistort_points,
+                                                float bbox_crop_ratio) const;
+
+  /// @brief Reproject the disparity pixels of the input rectangle to 3D. Output has the rectangle size, with each
+  ///     value matching the full frame @ref reproject_3d_depth_map value at the same pixel.
+  void reproject_3d_region(const cv::Mat &cv_disparity_map, const cv::Rect &rect, cv::Mat &region_3d_map) const;
+
 
   /// @brief Calculates intersection over union for two bounding boxes
   static double iou_distance(const kwiver::vital::bounding_box_d &bbox1, const kwiver::vital::bounding_box_d &bbox2);
 
+  /// @brief Calculates intersection over union for every pair of bounding boxes
+  /// @param iou: Row major output matrix of size bboxes1.size() x bboxes2.size(), iou[i * bboxes2.size() + j] being
+  ///     equal to @ref iou_distance of bboxes1[i] and bboxes2[j]. Uses SSE2 / AVX instructions when available.
+  static void iou_matrix(const BoundingBoxes &bboxes1, const BoundingBoxes &bboxes2, std::vector<double> &iou);
+
 
   /// @brief Update left and right tracks pairs using left 3D coordinates and right bounding boxes
   ///     - Project left 3D center coordinate to right image
   ///     - For each right bounding box containing projected left center, find closest
-  static std::vector<std::vector<size_t>>
+  ///     Right bounding boxes are indexed by rows to only test the boxes close to each projected center.
+  ///     If do_optimal_assignment is set, the pairs minimizing the total center distance are kept (Hungarian
+  ///     algorithm on each group of conflicting candidates) instead of greedily pairing in the left detection order.
+  /// @return (left index, right index) pairs
+  static std::vector<std::pair<size_t, size_t>>
+  pair_left_right_detections_using_3d_center(DetectionSpan left_detections,
+                                             const std::vector<viame::core::Detections3DPositions> &left_3d_pos,
+                                             DetectionSpan right_detections, bool do_optimal_assignment = false);
+  static std::vector<std::pair<size_t, size_t>>
   pair_left_right_detections_using_3d_center(const std::vector<kwiver::vital::detected_object_sptr> &left_detections,
                                              const std::vector<viame::core::Detections3DPositions> &left_3d_pos,
-                                             const std::vector<kwiver::vital::detected_object_sptr> &right_detections);
+                                             const std::vector<kwiver::vital::detected_object_sptr> &right_detections,
+                                             bool do_optimal_assignment = false);
 
   /// @brief Update left and right tracks pairs using left and right bounding boxes
   ///     - For each left / right tracks, finds the pair having the highest IOU
-  std::vector<std::vector<size_t>>
+  /// @return (left index, right index) pairs
+  std::vector<std::pair<size_t, size_t>>
+  pair_left_right_tracks_using_bbox_iou(DetectionSpan left_detections, DetectionSpan right_detections,
+                                        bool do_rectify_bbox);
+  std::vector<std::pair<size_t, size_t>>
   pair_left_right_tracks_using_bbox_iou(const std::vector<kwiver::vital::detected_object_sptr> &left_detections,
                                         const std::vector<kwiver::vital::detected_object_sptr> &right_detections,
                                         bool do_rectify_bbox);
 
   /// @brief Update left and right tracks pairs using the currently set pairing method.
-  ///     If pairing is set to 3D, uses @ref pair_left_right_detections_using_3d_center.
+  ///     If pairing is set to 3D or 3D assignment, uses @ref pair_left_right_detections_using_3d_center.
   ///     Otherwise, uses @ref pair_left_right_tracks_using_bbox_iou.
-  std::vector<std::vector<size_t>>
+  /// @return (left index, right index) pairs
+  std::vector<std::pair<size_t, size_t>>
+  pair_left_right_detections(DetectionSpan left_detections,
+                             const std::vector<viame::core::Detections3DPositions> &left_3d_pos,
+                             DetectionSpan right_detections);
+  std::vector<std::pair<size_t, size_t>>
   pair_left_right_detections(const std::vector<kwiver::vital::detected_object_sptr> &left_detections,
                              const std::vector<viame::core::Detections3DPositions> &left_3d_pos,
                              const std::vector<kwiver::vital::detected_object_sptr> &right_detections);
@@ -172,6 +334,53 @@ public:
   /// Assumes the most likely detection class doesn't change in the lifetime of the input track
   static std::string most_likely_detection_class(const kwiver::vital::detected_object_sptr &detection);
 
+  /// @brief Columns of the left then the right detections, with the class indices shared by both views
+  static detection_arrays to_detection_arrays(DetectionSpan left_detections, DetectionSpan right_detections);
+
+private:
+  /// @brief Sparse variants of the bbox, mask and right projection estimates
+  Detections3DPositions
+  estimate_3d_position_from_bbox_disparity(const kwiver::vital::bounding_box_d &bbox, const cv::Mat &cv_disparity_map,
+                                           float crop_ratio, bool do_undistort_points) const;
+
+  Detections3DPositions
+  estimate_3d_position_from_unrectified_mask_disparity(const kwiver::vital::bounding_box_d &bbox,
+                                                       const cv::Mat &cv_disparity_map, const cv::Mat &mask,
+                                                       bool do_undistort_points) const;
+
+  kwiver::vital::bounding_box_d
+  project_to_right_image_from_disparity(const kwiver::vital::bounding_box_d &bbox,
+                                        const cv::Mat &cv_disparity_map) const;
+
+  /// @brief Creates 3D position given the 3D map size and the right projection to use when no 3D point is valid
+  Detections3DPositions
+  create_3d_position(const std::vector<float> &xs, const std::vector<float> &ys, const std::vector<float> &zs,
+                     const kwiver::vital::bounding_box_d &bbox, const cv::Size &map_size, float score,
+                     const std::function<kwiver::vital::bounding_box_d()> &fallback_projection) const;
+
+  /// @brief Add the 3D position notes to the input detection if the position score is valid
+  static void add_3d_position_notes(const kwiver::vital::detected_object_sptr &detection,
+                                    const Detections3DPositions &position);
+
+  /// @brief Median of the input values using the workspace scratch buffer
+  float workspace_median(const std::vector<float> &values) const;
+
+  /// @brief Returns the workspace of the calling thread.
+  ///     Each thread has its own buffers, so that the 3D estimation methods can be called concurrently for different
+  ///     detections. Buffers returned by @ref reproject_3d_depth_map_in_workspace belong to the calling thread.
+  Workspace &workspace() const;
+
+  /// @brief Per thread workspaces. Copies start with empty workspaces as the buffers are scratch memory only.
+  struct ThreadWorkspaces {
+    ThreadWorkspaces() = default;
+    ThreadWorkspaces(const ThreadWorkspaces &) {}
+    ThreadWorkspaces &operator=(const ThreadWorkspaces &) { return *this; }
+
+    std::mutex mutex;
+    std::map<std::thread::id, std::unique_ptr<Workspace>> workspaces;
+    std::shared_ptr<const cv::Mat> left_undistortion_lut;
+  };
+  mutable ThreadWorkspaces m_workspaces;
 };
 
 } // core
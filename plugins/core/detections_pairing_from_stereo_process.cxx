@@ -4,10 +4,13 @@
  */
 
 #include "detections_pairing_from_stereo_process.h"
-#include "detections_pairing_from_stereo.h"
+#include "process_trace.h"
+#include "roi_stereo_depth_map.h"
+#include "thread_pool.h"
 
 #include <vital/vital_types.h>
 #include <vital/types/detected_object_set.h>
+#include <vital/exceptions.h>
 
 #include <memory>
 
@@ -20,10 +23,31 @@ namespace viame {
 namespace core {
 
 create_config_trait(cameras_directory, std::string, "", "The calibrated cameras files directory")
-create_config_trait(pairing_method, std::string, "PAIRING_3D", "One of PAIRING_3D, PAIRING_IOU, PAIRING_RECTIFIED_IOU")
+create_config_trait(pairing_method, std::string, "PAIRING_3D", "One of PAIRING_3D, PAIRING_3D_ASSIGNMENT, PAIRING_IOU, PAIRING_RECTIFIED_IOU")
 create_config_trait(iou_pair_threshold, double, "0.1",
                     "Used with IOU pairing_method. Minimum IOU threshold below which left and right detections will not be paired.")
 create_config_trait(verbose, bool, "false", "If true, will print debug information to the pipeline console.")
+create_config_trait(sparse_reprojection, bool, "false",
+                    "If true, only reproject to 3D the disparity pixels used by each detection instead of the full "
+                    "disparity map. Produces the same 3D positions with less memory traffic.")
+create_config_trait(undistortion_lut, bool, "false",
+                    "If true, undistort the mask pixels with a per pixel lookup table of the left camera, computed "
+                    "once per image size, instead of undistorting each mask point.")
+create_config_trait(fixed_point_disparity_scale, float, "16",
+                    "Scale of CV_16S fixed-point disparity maps, which are used without conversion. Disparity in "
+                    "pixels is the map value divided by this scale. The OpenCV matchers use 16 (4 fractional bits).")
+create_config_trait(disparity_computer, std::string, "",
+                    "Optional compute_stereo_depth_map algorithm. If set, disparity is computed from the left_image "
+                    "and right_image ports instead of being read from the depth_map port.")
+create_config_trait(roi_disparity, bool, "false",
+                    "If true and the disparity_computer supports it, only compute disparity within horizontal strips "
+                    "covering the rectified left detections.")
+create_config_trait(roi_padding, int, "16",
+                    "Number of rows added above and below each rectified detection when roi_disparity is set.")
+create_config_trait(disparity_queue_depth, unsigned, "0",
+                    "Number of frames whose disparity the disparity_computer computes ahead, on its own thread, "
+                    "while earlier frames are paired. Outputs are delayed by as many frames. 0 computes disparity "
+                    "synchronously.")
 create_port_trait(detected_object_set1, detected_object_set, "Set of object detections1.")
 create_port_trait(detected_object_set2, detected_object_set, "Set of object detections2.")
 create_port_trait(detected_object_set_out1, detected_object_set, "The stereo filtered object detections1.")
@@ -49,13 +73,16 @@ void detections_pairing_from_stereo_process::make_ports() {
   required.insert(flag_required);
 
   // -- inputs --
-  declare_input_port_using_trait(depth_map, required);
+  declare_input_port_using_trait(depth_map, optional);
+  declare_input_port_using_trait(left_image, optional);
+  declare_input_port_using_trait(right_image, optional);
   declare_input_port_using_trait(detected_object_set1, required);
   declare_input_port_using_trait(detected_object_set2, required);
 
   // -- outputs --
   declare_output_port_using_trait(detected_object_set_out1, optional);
   declare_output_port_using_trait(detected_object_set_out2, optional);
+  declare_output_port_using_trait(depth_map, optional);
 }
 
 // -----------------------------------------------------------------------------
@@ -64,6 +91,13 @@ void detections_pairing_from_stereo_process::make_config() {
   declare_config_using_trait(pairing_method);
   declare_config_using_trait(iou_pair_threshold);
   declare_config_using_trait(verbose);
+  declare_config_using_trait(sparse_reprojection);
+  declare_config_using_trait(undistortion_lut);
+  declare_config_using_trait(fixed_point_disparity_scale);
+  declare_config_using_trait(disparity_computer);
+  declare_config_using_trait(roi_disparity);
+  declare_config_using_trait(roi_padding);
+  declare_config_using_trait(disparity_queue_depth);
 }
 
 // -----------------------------------------------------------------------------
@@ -72,37 +106,147 @@ void detections_pairing_from_stereo_process::_configure() {
   d->m_pairing_method = config_value_using_trait(pairing_method);
   d->m_iou_pair_threshold = config_value_using_trait(iou_pair_threshold);
   d->m_verbose = config_value_using_trait(verbose);
+  d->m_sparse_reprojection = config_value_using_trait(sparse_reprojection);
+  d->m_use_undistortion_lut = config_value_using_trait(undistortion_lut);
+  d->m_fixed_point_disparity_scale = config_value_using_trait(fixed_point_disparity_scale);
   d->load_camera_calibration();
+
+  m_roi_disparity = config_value_using_trait(roi_disparity);
+  m_roi_padding = config_value_using_trait(roi_padding);
+  m_disparity_queue_depth = config_value_using_trait(disparity_queue_depth);
+
+  kv::config_block_sptr algo_config = get_config();
+  if (algo_config->has_value("disparity_computer:type") &&
+      !algo_config->get_value<std::string>("disparity_computer:type").empty()) {
+    kv::algo::compute_stereo_depth_map::set_nested_algo_configuration("disparity_computer", algo_config,
+                                                                     m_disparity_computer);
+    if (!m_disparity_computer)
+      VITAL_THROW(kv::invalid_configuration, "Unable to create disparity_computer");
+  } else {
+    m_disparity_computer.reset();
+  }
+
+  m_pending.clear();
+  m_disparity_worker.reset();
+  if (m_disparity_computer && m_disparity_queue_depth > 0)
+    m_disparity_worker.reset(new viame::thread_pool(1));
 }
 
 // -----------------------------------------------------------------------------
 void detections_pairing_from_stereo_process::_step() {
+  process_step_trace trace(name());
+
+  // Pipelined disparity, flushing the frames still queued at the end of input
+  if (m_disparity_worker) {
+    auto port_info = peek_at_port_using_trait(detected_object_set1);
+
+    if (port_info.datum->type() == sprokit::datum::complete) {
+      grab_edge_datum_using_trait(detected_object_set1);
+      grab_edge_datum_using_trait(detected_object_set2);
+      if (has_input_port_edge_using_trait(left_image))
+        grab_edge_datum_using_trait(left_image);
+      if (has_input_port_edge_using_trait(right_image))
+        grab_edge_datum_using_trait(right_image);
+      trace.inputs_ready();
+
+      while (!m_pending.empty()) {
+        auto frame = std::move(m_pending.front());
+        m_pending.pop_front();
+        auto depth_map = frame.depth_map.get();
+        push_to_port_using_trait(depth_map, depth_map);
+        pair_and_push(frame.left_detections, frame.right_detections, depth_map);
+      }
+
+      mark_process_as_complete();
+
+      const sprokit::datum_t dat = sprokit::datum::complete_datum();
+
+      push_datum_to_port_using_trait(detected_object_set_out1, dat);
+      push_datum_to_port_using_trait(detected_object_set_out2, dat);
+      push_datum_to_port_using_trait(depth_map, dat);
+      return;
+    }
+  }
+
   // Grab inputs from previous process
   auto left_detected_object_set = grab_from_port_using_trait(detected_object_set1);
   auto right_detected_object_set = grab_from_port_using_trait(detected_object_set2);
-  auto depth_map = grab_from_port_using_trait(depth_map);
+
+  trace.inputs_ready();
+  trace.count("left_detections", left_detected_object_set->size());
+  trace.count("right_detections", right_detected_object_set->size());
+
+  if (!m_disparity_computer) {
+    pair_and_push(left_detected_object_set, right_detected_object_set, grab_from_port_using_trait(depth_map));
+    return;
+  }
+
+  auto left_image = grab_from_port_using_trait(left_image);
+  auto right_image = grab_from_port_using_trait(right_image);
+
+  // Restrict disparity to the rows of the left detections when supported
+  const auto roi_computer =
+      m_roi_disparity ? dynamic_cast<const roi_stereo_depth_map *>(m_disparity_computer.get()) : nullptr;
+
+  std::vector<std::pair<int, int>> strips;
+  if (roi_computer) {
+    strips = d->rectified_row_strips(DetectionSpan::of(*left_detected_object_set, m_left_buffer),
+                                     (int) left_image->height(), m_roi_padding);
+  }
+
+  auto computer = m_disparity_computer;
+  auto compute = [computer, roi_computer, left_image, right_image, strips]() {
+    return roi_computer ? roi_computer->compute_in_rows(left_image, right_image, strips)
+                        : computer->compute(left_image, right_image);
+  };
+
+  if (!m_disparity_worker) {
+    auto depth_map = compute();
+    push_to_port_using_trait(depth_map, depth_map);
+    pair_and_push(left_detected_object_set, right_detected_object_set, depth_map);
+    return;
+  }
+
+  // Queue this frame's disparity and pair the oldest frame once the queue is full
+  m_pending.push_back({left_detected_object_set, right_detected_object_set, m_disparity_worker->enqueue(compute)});
+  trace.count("pending_frames", m_pending.size());
+
+  if (m_pending.size() > m_disparity_queue_depth) {
+    auto frame = std::move(m_pending.front());
+    m_pending.pop_front();
+    auto depth_map = frame.depth_map.get();
+    push_to_port_using_trait(depth_map, depth_map);
+    pair_and_push(frame.left_detections, frame.right_detections, depth_map);
+  }
+}
+
+// -----------------------------------------------------------------------------
+void detections_pairing_from_stereo_process::pair_and_push(kv::detected_object_set_sptr left_detected_object_set,
+                                                           kv::detected_object_set_sptr right_detected_object_set,
+                                                           kv::image_container_sptr depth_map) {
+  if (!depth_map) {
+    push_to_port_using_trait(detected_object_set_out1, left_detected_object_set);
+    push_to_port_using_trait(detected_object_set_out2, right_detected_object_set);
+    return;
+  }
+
+  // View the detection sets in place
+  const auto left_detections = DetectionSpan::of(*left_detected_object_set, m_left_buffer);
+  const auto right_detections = DetectionSpan::of(*right_detected_object_set, m_right_buffer);
 
   // Split input disparity into left / right disparity maps
   auto cv_disparity_left = kwiver::arrows::ocv::image_container::vital_to_ocv(depth_map->get_image(),
                                                                               kwiver::arrows::ocv::image_container::BGR_COLOR);
 
-  // Format detection sets as detection object vectors
-  std::vector<kwiver::vital::detected_object_sptr> left_detections, right_detections;
-  for (const auto &left_detection: *left_detected_object_set)
-    left_detections.emplace_back(left_detection);
-
-  for (const auto &right_detection: *right_detected_object_set)
-    right_detections.emplace_back(right_detection);
-
   // Estimate 3D positions in left image with disparity
-  auto left_3d_pos = d->update_left_detections_3d_positions(left_detections, cv_disparity_left);
+  d->update_left_detections_3d_positions(left_detections, cv_disparity_left, m_left_3d_pos);
 
   // Pair right and left tracks
-  auto pairings = d->pair_left_right_detections(left_detections, left_3d_pos, right_detections);
+  auto pairings = d->pair_left_right_detections(left_detections, m_left_3d_pos, right_detections);
 
   // Modify right_detection pairing id
   for (const auto &pairing: pairings) {
-    right_detections[pairing[1]]->set_index(left_detections[pairing[0]]->index());
+    right_detections[pairing.second]->set_index(left_detections[pairing.first]->index());
   }
 
   // Return modified detections
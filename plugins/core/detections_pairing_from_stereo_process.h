@@ -9,17 +9,23 @@
 #include <sprokit/pipeline/process.h>
 
 #include <plugins/core/viame_processes_core_export.h>
+#include <plugins/core/detections_pairing_from_stereo.h>
 
+#include <vital/algo/compute_stereo_depth_map.h>
+#include <vital/types/detected_object_set.h>
+
+#include <deque>
+#include <future>
 #include <memory>
 
 namespace viame
 {
 
+class thread_pool;
+
 namespace core
 {
 
-class detections_pairing_from_stereo;
-
 // -----------------------------------------------------------------------------
 /**
  * @brief Compute object detection pairs from stereo depth map information
@@ -40,8 +46,33 @@ private:
   void make_ports();
   void make_config();
 
+  // Pair one frame of detections using its disparity and push the results
+  void pair_and_push( kwiver::vital::detected_object_set_sptr left_detected_object_set,
+                      kwiver::vital::detected_object_set_sptr right_detected_object_set,
+                      kwiver::vital::image_container_sptr depth_map );
+
   const std::unique_ptr<detections_pairing_from_stereo> d;
 
+  // Optional in-process disparity computation from left / right images
+  kwiver::vital::algo::compute_stereo_depth_map_sptr m_disparity_computer;
+  bool m_roi_disparity{};
+  int m_roi_padding{};
+
+  // Frames whose disparity is computed ahead of their pairing, oldest first
+  struct pending_frame {
+    kwiver::vital::detected_object_set_sptr left_detections;
+    kwiver::vital::detected_object_set_sptr right_detections;
+    std::future<kwiver::vital::image_container_sptr> depth_map;
+  };
+
+  unsigned m_disparity_queue_depth{};
+  std::unique_ptr<viame::thread_pool> m_disparity_worker;
+  std::deque<pending_frame> m_pending;
+
+  // Buffers reused from one frame to the next, the detections are viewed in place
+  std::vector<DetectionSpan::element_ptr> m_left_buffer, m_right_buffer;
+  std::vector<Detections3DPositions> m_left_3d_pos;
+
 };
 } // core
 } // viame
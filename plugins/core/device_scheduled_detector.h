@@ -0,0 +1,91 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Detector placing its nested detector with the device scheduler
+ */
+
+#ifndef VIAME_CORE_DEVICE_SCHEDULED_DETECTOR_H
+#define VIAME_CORE_DEVICE_SCHEDULED_DETECTOR_H
+
+#include <plugins/core/viame_core_export.h>
+#include <plugins/core/batch_image_object_detector.h>
+
+#include <vital/algo/image_object_detector.h>
+
+#include <memory>
+
+namespace viame
+{
+
+/**
+ * @brief Run a nested detector on the GPU chosen by the device scheduler
+ *
+ * The index of the assigned GPU is written into the nested detector
+ * configuration under device_key before the detector is created, so the
+ * detectors of several streams or ensemble members are spread over the GPUs
+ * of the node instead of all using the device their pipeline file names.
+ * Batches are forwarded to nested batch detectors.
+ */
+class VIAME_CORE_EXPORT device_scheduled_detector
+  : public kwiver::vital::algo::image_object_detector
+  , public batch_image_object_detector
+{
+public:
+  static constexpr char const* name = "device_scheduled";
+  static constexpr char const* description =
+    "Run a nested detector on a GPU chosen from measured device load";
+
+  device_scheduled_detector();
+  ~device_scheduled_detector() override;
+
+  kwiver::vital::config_block_sptr get_configuration() const override;
+
+  void set_configuration( kwiver::vital::config_block_sptr config ) override;
+
+  bool check_configuration( kwiver::vital::config_block_sptr config ) const override;
+
+  kwiver::vital::detected_object_set_sptr detect(
+    kwiver::vital::image_container_sptr image_data ) const override;
+
+  std::vector< kwiver::vital::detected_object_set_sptr > detect_batch(
+    std::vector< kwiver::vital::image_container_sptr > const& images ) const override;
+
+  size_t max_batch_size() const override;
+
+private:
+  class priv;
+  const std::unique_ptr< priv > d;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_DEVICE_SCHEDULED_DETECTOR_H
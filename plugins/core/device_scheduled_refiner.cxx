@@ -0,0 +1,132 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "device_scheduled_refiner.h"
+#include "device_scheduler.h"
+
+#include <vital/exceptions.h>
+#include <vital/logger/logger.h>
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+// =============================================================================
+class device_scheduled_refiner::priv
+{
+public:
+  priv()
+    : m_logger( kv::get_logger( "viame.core.device_scheduled_refiner" ) )
+  {}
+
+  device_schedule schedule;
+  kv::algo::refine_detections_sptr refiner;
+
+  kv::logger_handle_t m_logger;
+};
+
+// =============================================================================
+device_scheduled_refiner
+::device_scheduled_refiner()
+  : d( new priv() )
+{
+}
+
+
+device_scheduled_refiner
+::~device_scheduled_refiner()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+kv::config_block_sptr
+device_scheduled_refiner
+::get_configuration() const
+{
+  auto config = kv::algo::refine_detections::get_configuration();
+
+  d->schedule.get_configuration( config );
+
+  kv::algo::refine_detections::get_nested_algo_configuration(
+    "refiner", config, d->refiner );
+
+  return config;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+device_scheduled_refiner
+::set_configuration( kv::config_block_sptr config )
+{
+  auto new_config = this->get_configuration();
+  new_config->merge_config( config );
+
+  d->schedule.set_configuration( new_config, "refiner" );
+
+  LOG_INFO( d->m_logger, "Placing refiner on "
+            << ( d->schedule.device() < 0 ? std::string( "CPU" ) :
+                 "GPU " + std::to_string( d->schedule.device() ) ) );
+
+  kv::algo::refine_detections::set_nested_algo_configuration(
+    "refiner", new_config, d->refiner );
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+device_scheduled_refiner
+::check_configuration( kv::config_block_sptr config ) const
+{
+  return kv::algo::refine_detections::check_nested_algo_configuration(
+    "refiner", config );
+}
+
+
+// -----------------------------------------------------------------------------
+kv::detected_object_set_sptr
+device_scheduled_refiner
+::refine( kv::image_container_sptr image_data,
+          kv::detected_object_set_sptr detections ) const
+{
+  if( !d->refiner )
+  {
+    VITAL_THROW( kv::algorithm_configuration_exception,
+      type_name(), impl_name(), "No nested refiner configured" );
+  }
+
+  d->schedule.pin_current_thread();
+
+  return d->refiner->refine( image_data, detections );
+}
+
+} // end namespace viame
@@ -0,0 +1,82 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Refiner placing its nested refiner with the device scheduler
+ */
+
+#ifndef VIAME_CORE_DEVICE_SCHEDULED_REFINER_H
+#define VIAME_CORE_DEVICE_SCHEDULED_REFINER_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/algo/refine_detections.h>
+
+#include <memory>
+
+namespace viame
+{
+
+/**
+ * @brief Run a nested refiner on the GPU chosen by the device scheduler
+ *
+ * Counterpart of device_scheduled_detector for refine_detections, giving a
+ * refiner the same schedule_key as its detector keeps both on one GPU.
+ */
+class VIAME_CORE_EXPORT device_scheduled_refiner
+  : public kwiver::vital::algo::refine_detections
+{
+public:
+  static constexpr char const* name = "device_scheduled";
+  static constexpr char const* description =
+    "Run a nested refiner on a GPU chosen from measured device load";
+
+  device_scheduled_refiner();
+  ~device_scheduled_refiner() override;
+
+  kwiver::vital::config_block_sptr get_configuration() const override;
+
+  void set_configuration( kwiver::vital::config_block_sptr config ) override;
+
+  bool check_configuration( kwiver::vital::config_block_sptr config ) const override;
+
+  kwiver::vital::detected_object_set_sptr refine(
+    kwiver::vital::image_container_sptr image_data,
+    kwiver::vital::detected_object_set_sptr detections ) const override;
+
+private:
+  class priv;
+  const std::unique_ptr< priv > d;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_DEVICE_SCHEDULED_REFINER_H
@@ -0,0 +1,507 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "device_scheduler.h"
+
+#include <vital/logger/logger.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+namespace
+{
+
+std::string
+trim( std::string const& value )
+{
+  const auto first = value.find_first_not_of( " \t\r\n" );
+
+  if( first == std::string::npos )
+  {
+    return std::string();
+  }
+
+  const auto last = value.find_last_not_of( " \t\r\n" );
+  return value.substr( first, last - first + 1 );
+}
+
+std::vector< std::string >
+split( std::string const& value, const char delimiter )
+{
+  std::vector< std::string > fields;
+  std::stringstream stream( value );
+  std::string field;
+
+  while( std::getline( stream, field, delimiter ) )
+  {
+    fields.push_back( trim( field ) );
+  }
+  return fields;
+}
+
+// Value of a numeric nvidia-smi field, 0 for fields such as "[N/A]"
+double
+to_number( std::string const& field )
+{
+  return std::strtod( field.c_str(), nullptr );
+}
+
+// Cores listed in a sysfs cpulist such as "0-13,28-41"
+std::vector< unsigned >
+read_cpu_list( std::string const& filename )
+{
+  std::vector< unsigned > cpus;
+  std::ifstream fin( filename );
+  std::string line;
+
+  if( !std::getline( fin, line ) )
+  {
+    return cpus;
+  }
+
+  for( auto const& range : split( line, ',' ) )
+  {
+    if( range.empty() )
+    {
+      continue;
+    }
+
+    const auto dash = range.find( '-' );
+    const unsigned first = std::stoul( range.substr( 0, dash ) );
+    const unsigned last = dash == std::string::npos ?
+      first : std::stoul( range.substr( dash + 1 ) );
+
+    for( unsigned cpu = first; cpu <= last; ++cpu )
+    {
+      cpus.push_back( cpu );
+    }
+  }
+  return cpus;
+}
+
+// Every device reported by nvidia-smi, in its own index order
+std::vector< gpu_device >
+query_devices()
+{
+  std::vector< gpu_device > devices;
+
+  const std::string command =
+    "nvidia-smi --query-gpu=index,uuid,pci.bus_id,memory.total,memory.used,"
+    "utilization.gpu --format=csv,noheader,nounits";
+
+#ifdef WIN32
+  FILE* output = _popen( command.c_str(), "r" );
+#else
+  FILE* output = popen( ( command + " 2>/dev/null" ).c_str(), "r" );
+#endif
+
+  if( !output )
+  {
+    return devices;
+  }
+
+  char buffer[512];
+
+  while( std::fgets( buffer, sizeof( buffer ), output ) )
+  {
+    const auto fields = split( buffer, ',' );
+
+    if( fields.size() < 6 || fields[0].empty() ||
+        !std::isdigit( static_cast< unsigned char >( fields[0][0] ) ) )
+    {
+      continue;
+    }
+
+    gpu_device device;
+    device.index = static_cast< unsigned >( std::stoul( fields[0] ) );
+    device.uuid = fields[1];
+    device.bus_id = fields[2];
+    device.total_memory = to_number( fields[3] );
+    device.used_memory = to_number( fields[4] );
+    device.utilization = to_number( fields[5] );
+
+#ifdef __linux__
+    // nvidia-smi reports an 8 digit PCI domain where sysfs uses 4
+    std::string sysfs_id = device.bus_id.size() > 12 ?
+      device.bus_id.substr( device.bus_id.size() - 12 ) : device.bus_id;
+    std::transform( sysfs_id.begin(), sysfs_id.end(), sysfs_id.begin(),
+      []( unsigned char c ){ return static_cast< char >( std::tolower( c ) ); } );
+
+    try
+    {
+      device.local_cpus =
+        read_cpu_list( "/sys/bus/pci/devices/" + sysfs_id + "/local_cpulist" );
+    }
+    catch( ... )
+    {
+      device.local_cpus.clear();
+    }
+#endif
+
+    devices.push_back( device );
+  }
+
+#ifdef WIN32
+  _pclose( output );
+#else
+  pclose( output );
+#endif
+
+  return devices;
+}
+
+// Devices visible to CUDA, renumbered in the order CUDA_VISIBLE_DEVICES lists
+std::vector< gpu_device >
+visible_devices( std::vector< gpu_device > const& all )
+{
+  const char* visible = std::getenv( "CUDA_VISIBLE_DEVICES" );
+
+  if( !visible )
+  {
+    return all;
+  }
+
+  std::vector< gpu_device > output;
+
+  for( auto const& entry : split( visible, ',' ) )
+  {
+    auto match = std::find_if( all.begin(), all.end(),
+      [&entry]( gpu_device const& device )
+      {
+        return entry == std::to_string( device.index ) ||
+               ( !entry.empty() && device.uuid.compare( 0, entry.size(), entry ) == 0 );
+      } );
+
+    // CUDA ignores the devices listed after an invalid entry
+    if( entry.empty() || match == all.end() )
+    {
+      break;
+    }
+
+    output.push_back( *match );
+    output.back().index = static_cast< unsigned >( output.size() - 1 );
+  }
+  return output;
+}
+
+} // end anonymous namespace
+
+// =============================================================================
+device_scheduler&
+device_scheduler
+::instance()
+{
+  static device_scheduler scheduler;
+  return scheduler;
+}
+
+
+device_scheduler
+::device_scheduler()
+  : m_devices( visible_devices( query_devices() ) )
+{
+  auto logger = kv::get_logger( "viame.core.device_scheduler" );
+
+  for( auto const& device : m_devices )
+  {
+    LOG_DEBUG( logger, "GPU " << device.index << " (" << device.bus_id << "): "
+               << device.used_memory << " of " << device.total_memory
+               << " MB used, " << device.utilization << "% utilization, "
+               << device.local_cpus.size() << " local cores" );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector< gpu_device >
+device_scheduler
+::devices() const
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+  return m_devices;
+}
+
+
+// -----------------------------------------------------------------------------
+int
+device_scheduler
+::assign( std::string const& key, double memory_estimate )
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  auto existing = m_assignments.find( key );
+
+  if( existing != m_assignments.end() )
+  {
+    existing->second.references++;
+    return existing->second.device;
+  }
+
+  if( m_devices.empty() )
+  {
+    m_assignments[ key ] = assignment{ -1, 0.0, 1 };
+    return -1;
+  }
+
+  // Memory and keys already placed on each device by this process
+  std::vector< double > reserved( m_devices.size(), 0.0 );
+  std::vector< unsigned > keys( m_devices.size(), 0 );
+
+  for( auto const& entry : m_assignments )
+  {
+    if( entry.second.device >= 0 )
+    {
+      reserved[ entry.second.device ] += entry.second.memory;
+      keys[ entry.second.device ]++;
+    }
+  }
+
+  int best = -1;
+  bool best_fits = false;
+  double best_free = 0.0;
+
+  for( size_t i = 0; i < m_devices.size(); ++i )
+  {
+    gpu_device const& device = m_devices[i];
+
+    const double free_memory =
+      device.total_memory - device.used_memory - reserved[i];
+    const bool fits = free_memory >= memory_estimate;
+
+    bool better = best < 0 || ( fits && !best_fits );
+
+    if( !better && fits == best_fits )
+    {
+      better = fits ?
+        ( keys[i] < keys[ best ] ||
+          ( keys[i] == keys[ best ] &&
+            device.utilization < m_devices[ best ].utilization ) ) :
+        free_memory > best_free;
+    }
+
+    if( better )
+    {
+      best = static_cast< int >( i );
+      best_fits = fits;
+      best_free = free_memory;
+    }
+  }
+
+  if( !best_fits )
+  {
+    LOG_WARN( kv::get_logger( "viame.core.device_scheduler" ),
+              "No GPU has " << memory_estimate << " MB free for " << key
+              << ", using the device with the most free memory" );
+  }
+
+  m_assignments[ key ] = assignment{ best, memory_estimate, 1 };
+  return best;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+device_scheduler
+::release( std::string const& key )
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  auto existing = m_assignments.find( key );
+
+  if( existing != m_assignments.end() && --existing->second.references == 0 )
+  {
+    m_assignments.erase( existing );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+device_scheduler
+::pin_current_thread( int device ) const
+{
+#ifdef __linux__
+  std::vector< unsigned > cpus;
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    if( device < 0 || device >= static_cast< int >( m_devices.size() ) )
+    {
+      return false;
+    }
+    cpus = m_devices[ device ].local_cpus;
+  }
+
+  // Only keep the cores the process may already run on, such as within a
+  // container or taskset limit
+  cpu_set_t allowed, pinned;
+  CPU_ZERO( &pinned );
+
+  if( pthread_getaffinity_np( pthread_self(), sizeof( allowed ), &allowed ) != 0 )
+  {
+    return false;
+  }
+
+  bool any = false;
+
+  for( unsigned cpu : cpus )
+  {
+    if( cpu < CPU_SETSIZE && CPU_ISSET( cpu, &allowed ) )
+    {
+      CPU_SET( cpu, &pinned );
+      any = true;
+    }
+  }
+
+  return any &&
+    pthread_setaffinity_np( pthread_self(), sizeof( pinned ), &pinned ) == 0;
+#else
+  (void) device;
+  return false;
+#endif
+}
+
+
+// =============================================================================
+device_schedule
+::device_schedule()
+  : m_memory_estimate( 2048.0 )
+  , m_device_key( "gpu_index" )
+  , m_pin_threads( true )
+  , m_device( -1 )
+{
+}
+
+
+device_schedule
+::~device_schedule()
+{
+  if( !m_assigned_key.empty() )
+  {
+    device_scheduler::instance().release( m_assigned_key );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+device_schedule
+::get_configuration( kv::config_block_sptr config ) const
+{
+  config->set_value( "schedule_key", m_schedule_key,
+    "Name of the stream this model belongs to. Models sharing a key, such as "
+    "the detector and refiner of one camera, are placed on the same GPU, "
+    "while different keys are spread over the GPUs. When empty, each model "
+    "is placed on its own." );
+  config->set_value( "memory_estimate", m_memory_estimate,
+    "GPU memory (MB) expected to be used by the model, reserved on the "
+    "chosen device when placing later models." );
+  config->set_value( "device_key", m_device_key,
+    "Name of the setting of the nested algorithm which receives the index "
+    "of the assigned GPU." );
+  config->set_value( "pin_threads", m_pin_threads,
+    "Restrict the threads calling the model to the CPU cores attached to "
+    "the same node as the assigned GPU, where known." );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+device_schedule
+::set_configuration( kv::config_block_sptr config,
+                     std::string const& nested_name )
+{
+  m_schedule_key = config->get_value< std::string >( "schedule_key" );
+  m_memory_estimate = config->get_value< double >( "memory_estimate" );
+  m_device_key = config->get_value< std::string >( "device_key" );
+  m_pin_threads = config->get_value< bool >( "pin_threads" );
+
+  device_scheduler& scheduler = device_scheduler::instance();
+
+  if( !m_assigned_key.empty() )
+  {
+    scheduler.release( m_assigned_key );
+  }
+
+  if( m_schedule_key.empty() )
+  {
+    std::ostringstream key;
+    key << "model@" << static_cast< const void* >( this );
+    m_assigned_key = key.str();
+  }
+  else
+  {
+    m_assigned_key = "stream:" + m_schedule_key;
+  }
+
+  m_device = scheduler.assign( m_assigned_key, m_memory_estimate );
+
+  const std::string type =
+    config->get_value< std::string >( nested_name + ":type", "" );
+
+  if( m_device >= 0 && !type.empty() && !m_device_key.empty() )
+  {
+    config->set_value( nested_name + ":" + type + ":" + m_device_key,
+                       std::to_string( m_device ) );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+device_schedule
+::pin_current_thread() const
+{
+  thread_local int pinned_device = -1;
+
+  if( !m_pin_threads || m_device < 0 || pinned_device == m_device )
+  {
+    return;
+  }
+
+  device_scheduler::instance().pin_current_thread( m_device );
+  pinned_device = m_device;
+}
+
+} // end namespace viame
@@ -0,0 +1,158 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Process-wide placement of nested models on the available GPUs
+ */
+
+#ifndef VIAME_CORE_DEVICE_SCHEDULER_H
+#define VIAME_CORE_DEVICE_SCHEDULER_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/config/config_block.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/// Measured state of one GPU
+struct gpu_device
+{
+  /// CUDA ordinal of the device within the visible devices
+  unsigned index;
+
+  std::string uuid;
+  std::string bus_id;
+
+  /// Memory in MB and utilization in percent when first queried
+  double total_memory;
+  double used_memory;
+  double utilization;
+
+  /// CPU cores attached to the same node as the device, empty if unknown
+  std::vector< unsigned > local_cpus;
+};
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Assign GPUs to the models of every pipeline in this process
+ *
+ * Devices are queried once with nvidia-smi, restricted to and ordered by
+ * CUDA_VISIBLE_DEVICES when it is set. The reported indices assume CUDA
+ * enumerates devices in PCI bus order, as on nodes of identical GPUs or when
+ * CUDA_DEVICE_ORDER=PCI_BUS_ID is set. Each key, naming a stream or a model,
+ * is placed on the device with the fewest keys among those with enough free
+ * memory, ties going to the least utilized, and keeps that device until
+ * released.
+ */
+class VIAME_CORE_EXPORT device_scheduler
+{
+public:
+  static device_scheduler& instance();
+
+  /// Visible devices, empty if none could be queried
+  std::vector< gpu_device > devices() const;
+
+  /// Device assigned to a key, choosing one if it has none, or -1 for CPU
+  int assign( std::string const& key, double memory_estimate );
+
+  /// Drop one reference to a key, freeing its device once unreferenced
+  void release( std::string const& key );
+
+  /// Restrict the calling thread to the cores local to a device, returns
+  /// false if the cores are unknown or the platform does not support it
+  bool pin_current_thread( int device ) const;
+
+private:
+  device_scheduler();
+
+  struct assignment
+  {
+    int device;
+    double memory;
+    unsigned references;
+  };
+
+  mutable std::mutex m_mutex;
+  std::vector< gpu_device > m_devices;
+  std::map< std::string, assignment > m_assignments;
+};
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Device placement settings of one wrapped model
+ *
+ * Shared by the device_scheduled detector and refiner, which write the
+ * assigned device into the configuration of their nested algorithm before
+ * creating it, and pin the threads calling it to the cores of that device.
+ */
+class VIAME_CORE_EXPORT device_schedule
+{
+public:
+  device_schedule();
+  ~device_schedule();
+
+  device_schedule( const device_schedule& ) = delete;
+  device_schedule& operator=( const device_schedule& ) = delete;
+
+  /// Add the placement settings to an algorithm configuration
+  void get_configuration( kwiver::vital::config_block_sptr config ) const;
+
+  /// Read the placement settings, assign a device and write its index into
+  /// the block of the nested algorithm named nested_name
+  void set_configuration( kwiver::vital::config_block_sptr config,
+                          std::string const& nested_name );
+
+  /// Pin the calling thread to the assigned device if enabled, once per thread
+  void pin_current_thread() const;
+
+  /// Assigned device, or -1 for CPU
+  int device() const { return m_device; }
+
+private:
+  std::string m_schedule_key;
+  double m_memory_estimate;
+  std::string m_device_key;
+  bool m_pin_threads;
+
+  std::string m_assigned_key;
+  int m_device;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_DEVICE_SCHEDULER_H
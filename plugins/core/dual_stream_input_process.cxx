@@ -0,0 +1,529 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Read two synchronized image streams with a single process
+ */
+
+#include "dual_stream_input_process.h"
+#include "filename_to_timestamp.h"
+#include "image_memory_budget.h"
+#include "process_trace.h"
+#include "spsc_ring_buffer.h"
+#include "thread_pool.h"
+
+#include <vital/algo/video_input.h>
+#include <vital/types/image_container.h>
+#include <vital/types/metadata.h>
+#include <vital/types/metadata_traits.h>
+#include <vital/types/timestamp.h>
+
+#include <sprokit/pipeline/process_exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <string>
+#include <thread>
+
+
+namespace kv = kwiver::vital;
+namespace algo = kwiver::vital::algo;
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( video_filename1, std::string, "",
+  "Video file or image list read for the first stream" );
+create_config_trait( video_filename2, std::string, "",
+  "Video file or image list read for the second stream" );
+create_config_trait( video_reader1, std::string, "",
+  "Algorithm configuration subblock for the video_input reading the first "
+  "stream" );
+create_config_trait( video_reader2, std::string, "",
+  "Algorithm configuration subblock for the video_input reading the second "
+  "stream" );
+create_config_trait( max_time_offset, double, "0.5",
+  "The maximum time difference (s) between the two frames of a pair. Frames "
+  "without a timestamp are paired by frame number instead." );
+create_config_trait( prefetch_count, unsigned, "4",
+  "Number of matched pairs read and decoded ahead of the pipeline. Bounds the "
+  "memory used by decoded images waiting to be processed." );
+create_config_trait( time_from_file_name, bool, "false",
+  "Take the time of each frame from the date and time in its file name, for "
+  "image lists read without a timestamp, instead of from the reader" );
+create_config_trait( memory_budget, double, "0",
+  "Image memory (MB) buffered across the pipeline above which reading "
+  "pauses until downstream stages release frames. The smallest budget "
+  "of all readers applies, 0 uses the VIAME_IMAGE_MEMORY_BUDGET environment "
+  "variable or no budget." );
+create_config_trait( max_throttle_wait, double, "1",
+  "Longest time (s) reading pauses for each pair while over the memory "
+  "budget, after which the pair is read anyway." );
+
+// =============================================================================
+// Private implementation class
+class dual_stream_input_process::priv
+{
+public:
+  priv();
+  ~priv();
+
+  // One frame of either stream
+  struct stream_frame
+  {
+    kv::timestamp ts;
+    std::string name;
+    kv::image_container_sptr image;
+  };
+
+  // Matched frames, or the end of the streams if last is set
+  struct frame_pair
+  {
+    frame_pair() : last( false ) {}
+
+    stream_frame first;
+    stream_frame second;
+    bool last;
+  };
+
+  // Advance one reader, returning false at the end of its stream
+  bool read_frame( const unsigned stream, stream_frame& frame );
+
+  // Run both functions at once, the second one on the decoder thread
+  void run_both( const std::function< void() >& first,
+                 const std::function< void() >& second );
+
+  // Match frames of both readers until either one ends, run by the loader
+  void load_pairs();
+
+  // Next pair output by the loader, waiting for it if needed
+  frame_pair next_pair();
+
+  // Stop the loader and close the readers
+  void stop();
+
+  // Configuration settings
+  std::string m_filenames[ 2 ];
+  double m_max_time_offset;
+  unsigned m_prefetch_count;
+  bool m_time_from_file_name;
+  std::chrono::milliseconds m_max_throttle_wait;
+
+  // Internal variables
+  algo::video_input_sptr m_readers[ 2 ];
+  filename_timestamp_parser m_parsers[ 2 ];
+
+  // Frames skipped in each stream for lack of a partner
+  size_t m_skipped[ 2 ];
+
+  // Loader matching frames, and the thread decoding the second stream
+  std::thread m_loader;
+  std::unique_ptr< viame::thread_pool > m_decoder;
+  spsc_ring_buffer< frame_pair > m_pairs;
+
+  std::atomic< bool > m_cancel;
+  std::exception_ptr m_load_error;
+  bool m_loaded;
+};
+
+
+// -----------------------------------------------------------------------------
+dual_stream_input_process::priv
+::priv()
+  : m_max_time_offset( 0.5e6 )
+  , m_prefetch_count( 4 )
+  , m_time_from_file_name( false )
+  , m_max_throttle_wait( 1000 )
+  , m_skipped{ 0, 0 }
+  , m_cancel( false )
+  , m_loaded( true )
+{
+}
+
+
+dual_stream_input_process::priv
+::~priv()
+{
+  stop();
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+dual_stream_input_process::priv
+::read_frame( const unsigned stream, stream_frame& frame )
+{
+  kv::timestamp ts;
+
+  if( !m_readers[ stream ]->next_frame( ts ) )
+  {
+    return false;
+  }
+
+  frame.ts = ts;
+  frame.name.clear();
+  frame.image.reset();
+
+  for( const auto& md : m_readers[ stream ]->frame_metadata() )
+  {
+    if( !md )
+    {
+      continue;
+    }
+
+    auto const& uri = md->find( kv::VITAL_META_IMAGE_URI );
+
+    if( uri.is_valid() )
+    {
+      frame.name = uri.as_string();
+      break;
+    }
+  }
+
+  if( m_time_from_file_name && !frame.name.empty() )
+  {
+    frame.ts.set_time_usec( m_parsers[ stream ].parse( frame.name ) );
+  }
+
+  return true;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+dual_stream_input_process::priv
+::run_both( const std::function< void() >& first,
+            const std::function< void() >& second )
+{
+  auto result = m_decoder->enqueue( second );
+
+  try
+  {
+    first();
+  }
+  catch( ... )
+  {
+    result.wait();
+    throw;
+  }
+
+  result.get();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+dual_stream_input_process::priv
+::load_pairs()
+{
+  try
+  {
+    stream_frame frame1, frame2;
+    bool has1 = false, has2 = false;
+
+    run_both( [&]{ has1 = read_frame( 0, frame1 ); },
+              [&]{ has2 = read_frame( 1, frame2 ); } );
+
+    while( has1 && has2 && !m_cancel )
+    {
+      const bool timed =
+        frame1.ts.has_valid_time() && frame2.ts.has_valid_time();
+
+      const double offset = timed ?
+        static_cast< double >( frame1.ts.get_time_usec() - frame2.ts.get_time_usec() ) :
+        static_cast< double >( frame1.ts.get_frame() - frame2.ts.get_frame() );
+      const double tolerance = timed ? m_max_time_offset : 0.0;
+
+      // Skip the older frame until both are close enough, without decoding it
+      if( offset < -tolerance )
+      {
+        ++m_skipped[ 0 ];
+        has1 = read_frame( 0, frame1 );
+        continue;
+      }
+      if( offset > tolerance )
+      {
+        ++m_skipped[ 1 ];
+        has2 = read_frame( 1, frame2 );
+        continue;
+      }
+
+      image_memory_budget::instance().wait_below_limit( m_max_throttle_wait );
+
+      // Each reader only holds its current frame, so both are decoded before
+      // either one advances
+      run_both( [&]{ frame1.image = m_readers[ 0 ]->frame_image(); },
+                [&]{ frame2.image = m_readers[ 1 ]->frame_image(); } );
+
+      frame_pair pair;
+      pair.first = std::move( frame1 );
+      pair.second = std::move( frame2 );
+      m_pairs.wait_push( std::move( pair ) );
+
+      run_both( [&]{ has1 = read_frame( 0, frame1 ); },
+                [&]{ has2 = read_frame( 1, frame2 ); } );
+    }
+  }
+  catch( ... )
+  {
+    m_load_error = std::current_exception();
+  }
+
+  frame_pair end;
+  end.last = true;
+  m_pairs.wait_push( std::move( end ) );
+}
+
+
+// -----------------------------------------------------------------------------
+dual_stream_input_process::priv::frame_pair
+dual_stream_input_process::priv
+::next_pair()
+{
+  while( m_pairs.empty() )
+  {
+    std::this_thread::yield();
+  }
+
+  frame_pair pair = std::move( m_pairs.front() );
+  m_pairs.pop();
+
+  if( pair.last )
+  {
+    m_loader.join();
+    m_loaded = true;
+  }
+  return pair;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+dual_stream_input_process::priv
+::stop()
+{
+  // Drain the queue so a loader waiting on it can reach its end marker
+  m_cancel = true;
+
+  while( !m_loaded )
+  {
+    next_pair();
+  }
+
+  m_decoder.reset();
+  m_cancel = false;
+
+  for( auto& reader : m_readers )
+  {
+    if( reader )
+    {
+      reader->close();
+    }
+  }
+}
+
+
+// =============================================================================
+dual_stream_input_process
+::dual_stream_input_process( kv::config_block_sptr const& config )
+  : process( config ),
+    d( new dual_stream_input_process::priv() )
+{
+  make_ports();
+  make_config();
+}
+
+
+dual_stream_input_process
+::~dual_stream_input_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+dual_stream_input_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t optional;
+
+  // -- outputs --
+  declare_output_port_using_trait( image1, optional );
+  declare_output_port_using_trait( image2, optional );
+  declare_output_port_using_trait( timestamp, optional );
+  declare_output_port_using_trait( file_name1, optional );
+  declare_output_port_using_trait( file_name2, optional );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+dual_stream_input_process
+::make_config()
+{
+  declare_config_using_trait( video_filename1 );
+  declare_config_using_trait( video_filename2 );
+  declare_config_using_trait( video_reader1 );
+  declare_config_using_trait( video_reader2 );
+  declare_config_using_trait( max_time_offset );
+  declare_config_using_trait( prefetch_count );
+  declare_config_using_trait( time_from_file_name );
+  declare_config_using_trait( memory_budget );
+  declare_config_using_trait( max_throttle_wait );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+dual_stream_input_process
+::_configure()
+{
+  d->stop();
+
+  d->m_filenames[ 0 ] = config_value_using_trait( video_filename1 );
+  d->m_filenames[ 1 ] = config_value_using_trait( video_filename2 );
+  d->m_max_time_offset = config_value_using_trait( max_time_offset ) * 1e6;
+  d->m_prefetch_count = std::max( 1u, config_value_using_trait( prefetch_count ) );
+  d->m_time_from_file_name = config_value_using_trait( time_from_file_name );
+  d->m_max_throttle_wait = std::chrono::milliseconds( static_cast< long long >(
+    config_value_using_trait( max_throttle_wait ) * 1000.0 ) );
+
+  image_memory_budget::instance().set_limit( static_cast< size_t >(
+    std::max( 0.0, config_value_using_trait( memory_budget ) ) * 1024.0 * 1024.0 ) );
+
+  if( d->m_filenames[ 0 ].empty() || d->m_filenames[ 1 ].empty() )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Both video_filename1 and video_filename2 must be set" );
+  }
+
+  kv::config_block_sptr algo_config = get_config();
+
+  const std::string reader_names[ 2 ] = { "video_reader1", "video_reader2" };
+
+  for( unsigned i = 0; i < 2; ++i )
+  {
+    algo::video_input::set_nested_algo_configuration(
+      reader_names[ i ], algo_config, d->m_readers[ i ] );
+
+    if( !d->m_readers[ i ] )
+    {
+      VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                   "Unable to create " + reader_names[ i ] );
+    }
+
+    algo::video_input::get_nested_algo_configuration(
+      reader_names[ i ], algo_config, d->m_readers[ i ] );
+
+    if( !algo::video_input::check_nested_algo_configuration(
+          reader_names[ i ], algo_config ) )
+    {
+      VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                   "Configuration check failed for " + reader_names[ i ] );
+    }
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+dual_stream_input_process
+::_init()
+{
+  d->stop();
+
+  for( unsigned i = 0; i < 2; ++i )
+  {
+    d->m_readers[ i ]->open( d->m_filenames[ i ] );
+    d->m_parsers[ i ].reset();
+    d->m_skipped[ i ] = 0;
+  }
+
+  d->m_pairs.reset( d->m_prefetch_count );
+  d->m_decoder.reset( new viame::thread_pool( 1 ) );
+  d->m_load_error = nullptr;
+  d->m_loaded = false;
+
+  priv* const loader = d.get();
+  d->m_loader = std::thread( [loader]{ loader->load_pairs(); } );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+dual_stream_input_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  priv::frame_pair pair = d->next_pair();
+
+  trace.inputs_ready();
+
+  if( pair.last )
+  {
+    LOG_INFO( logger(), "Skipped " << d->m_skipped[ 0 ] << " and "
+              << d->m_skipped[ 1 ] << " frames without a match" );
+
+    if( d->m_load_error )
+    {
+      std::rethrow_exception( d->m_load_error );
+    }
+
+    mark_process_as_complete();
+
+    const sprokit::datum_t dat = sprokit::datum::complete_datum();
+
+    push_datum_to_port_using_trait( image1, dat );
+    push_datum_to_port_using_trait( image2, dat );
+    push_datum_to_port_using_trait( timestamp, dat );
+    push_datum_to_port_using_trait( file_name1, dat );
+    push_datum_to_port_using_trait( file_name2, dat );
+    return;
+  }
+
+  push_to_port_using_trait( image1, pair.first.image );
+  push_to_port_using_trait( image2, pair.second.image );
+  push_to_port_using_trait( timestamp, pair.first.ts );
+  push_to_port_using_trait( file_name1, pair.first.name );
+  push_to_port_using_trait( file_name2, pair.second.name );
+}
+
+} // end namespace core
+
+} // end namespace viame
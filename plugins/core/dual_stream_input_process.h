@@ -0,0 +1,95 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Read two synchronized image streams with a single process
+ */
+
+#ifndef VIAME_DUAL_STREAM_INPUT_PROCESS_H
+#define VIAME_DUAL_STREAM_INPUT_PROCESS_H
+
+#include <sprokit/pipeline/process.h>
+
+#include <plugins/core/viame_processes_core_export.h>
+
+#include <sprokit/processes/kwiver_type_traits.h>
+
+#include <memory>
+
+namespace viame
+{
+
+namespace core
+{
+
+// -----------------------------------------------------------------------------
+create_port_trait( image1, image, "Image of the first stream" );
+create_port_trait( image2, image, "Image of the second stream" );
+create_port_trait( file_name1, file_name, "File name of the first stream" );
+create_port_trait( file_name2, file_name, "File name of the second stream" );
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Read two video or image list streams, outputting matched pairs
+ *
+ * Both nested video readers are advanced from a background thread, which
+ * pairs their frames by time as they are read. Frames without a partner
+ * within max_time_offset are skipped before their image is requested, so
+ * readers decoding on access, such as image lists, never decode them. The
+ * images of each pair are decoded concurrently and queued ahead of the
+ * pipeline, up to prefetch_count pairs.
+ */
+class VIAME_PROCESSES_CORE_NO_EXPORT dual_stream_input_process
+  : public sprokit::process
+{
+public:
+  // -- CONSTRUCTORS --
+  dual_stream_input_process( kwiver::vital::config_block_sptr const& config );
+  virtual ~dual_stream_input_process();
+
+protected:
+  virtual void _configure();
+  virtual void _init();
+  virtual void _step();
+
+private:
+  void make_ports();
+  void make_config();
+
+  class priv;
+  const std::unique_ptr< priv > d;
+
+}; // end class dual_stream_input_process
+
+} // end namespace core
+} // end namespace viame
+
+#endif // VIAME_DUAL_STREAM_INPUT_PROCESS_H
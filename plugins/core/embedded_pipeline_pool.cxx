@@ -0,0 +1,229 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "embedded_pipeline_pool.h"
+
+#include <sprokit/processes/adapters/embedded_pipeline.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+// Embedded pipeline with settings applied over its file
+class embedded_pipeline_pool::instance : public kwiver::embedded_pipeline
+{
+public:
+  explicit instance( kwiver::vital::config_block_sptr settings )
+    : m_settings( settings )
+  {
+  }
+
+protected:
+  virtual void update_config( kwiver::vital::config_block_sptr config )
+  {
+    if( m_settings )
+    {
+      config->merge_config( m_settings );
+    }
+  }
+
+private:
+  kwiver::vital::config_block_sptr m_settings;
+};
+
+// -----------------------------------------------------------------------------
+embedded_pipeline_pool
+::embedded_pipeline_pool( std::string const& pipeline_filename,
+                          unsigned count,
+                          kwiver::vital::config_block_sptr settings )
+{
+  if( count == 0 )
+  {
+    count = std::max( std::thread::hardware_concurrency(), 1u );
+  }
+
+  const std::string directory =
+    kwiversys::SystemTools::GetFilenamePath( pipeline_filename );
+
+  for( unsigned i = 0; i < count; ++i )
+  {
+    std::ifstream pipe_stream( pipeline_filename );
+
+    if( !pipe_stream )
+    {
+      throw std::runtime_error( "Unable to open pipeline file: " + pipeline_filename );
+    }
+
+    std::unique_ptr< instance > pipe( new instance( settings ) );
+    pipe->build_pipeline( pipe_stream, directory );
+    pipe->start();
+
+    m_inputs = pipe->input_port_names();
+    m_instances.push_back( std::move( pipe ) );
+  }
+
+  m_running = m_instances.size();
+
+  for( auto& pipe : m_instances )
+  {
+    m_workers.emplace_back( &embedded_pipeline_pool::run, this, std::ref( *pipe ) );
+  }
+}
+
+// -----------------------------------------------------------------------------
+embedded_pipeline_pool
+::~embedded_pipeline_pool()
+{
+  finish();
+}
+
+// -----------------------------------------------------------------------------
+bool
+embedded_pipeline_pool
+::has_input( std::string const& port ) const
+{
+  return std::find( m_inputs.begin(), m_inputs.end(), port ) != m_inputs.end();
+}
+
+// -----------------------------------------------------------------------------
+std::future< kwiver::adapter::adapter_data_set_t >
+embedded_pipeline_pool
+::submit( kwiver::adapter::adapter_data_set_t inputs )
+{
+  request job;
+  job.inputs = inputs;
+  auto result = job.outputs.get_future();
+
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    if( m_stopping || m_running == 0 )
+    {
+      throw std::runtime_error( "Pipeline pool is finished" );
+    }
+    m_requests.push( std::move( job ) );
+  }
+  m_available.notify_one();
+
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+void
+embedded_pipeline_pool
+::finish()
+{
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_stopping = true;
+  }
+  m_available.notify_all();
+
+  for( auto& worker : m_workers )
+  {
+    worker.join();
+  }
+  m_workers.clear();
+
+  for( auto& pipe : m_instances )
+  {
+    pipe->send_end_of_input();
+    pipe->wait();
+  }
+  m_instances.clear();
+}
+
+// -----------------------------------------------------------------------------
+void
+embedded_pipeline_pool
+::run( instance& pipe )
+{
+  while( true )
+  {
+    request job;
+    {
+      std::unique_lock< std::mutex > lock( m_mutex );
+      m_available.wait( lock, [this]{ return m_stopping || !m_requests.empty(); } );
+
+      if( m_requests.empty() )
+      {
+        return;
+      }
+
+      job = std::move( m_requests.front() );
+      m_requests.pop();
+    }
+
+    bool terminated = false;
+
+    try
+    {
+      pipe.send( job.inputs );
+      auto outputs = pipe.receive();
+
+      if( outputs->is_end_of_data() )
+      {
+        terminated = true;
+        throw std::runtime_error( "Pipeline terminated unexpectedly" );
+      }
+      job.outputs.set_value( outputs );
+    }
+    catch( ... )
+    {
+      job.outputs.set_exception( std::current_exception() );
+    }
+
+    // A terminated instance takes no more requests. Once none is left, queued
+    // requests fail rather than wait forever.
+    if( terminated )
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+
+      if( --m_running == 0 )
+      {
+        while( !m_requests.empty() )
+        {
+          m_requests.front().outputs.set_exception( std::make_exception_ptr(
+            std::runtime_error( "All pipeline instances terminated" ) ) );
+          m_requests.pop();
+        }
+      }
+      return;
+    }
+  }
+}
+
+} // end namespace viame
@@ -0,0 +1,123 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Pool of embedded pipelines running requests concurrently
+ */
+
+#ifndef VIAME_CORE_EMBEDDED_PIPELINE_POOL_H
+#define VIAME_CORE_EMBEDDED_PIPELINE_POOL_H
+
+#include <plugins/core/viame_embedded_export.h>
+
+#include <vital/config/config_block.h>
+
+#include <sprokit/processes/adapters/adapter_data_set.h>
+
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Started instances of one pipeline file, each driven by its own thread
+ *
+ * The pipeline must take its inputs from an input_adapter and return its
+ * results through an output_adapter. Each request is sent to the first idle
+ * instance, and its outputs are returned through a future, so the pipeline
+ * must produce exactly one output set per input set. Outputs of requests on
+ * different instances may complete in any order.
+ */
+class VIAME_EMBEDDED_EXPORT embedded_pipeline_pool
+{
+public:
+  /**
+   * @brief Build and start the instances
+   *
+   * A count of 0 starts one instance per hardware thread. Optional settings
+   * are merged over the configuration of the pipeline file.
+   */
+  embedded_pipeline_pool( std::string const& pipeline_filename,
+                          unsigned count = 1,
+                          kwiver::vital::config_block_sptr settings = nullptr );
+
+  /// Finish queued requests and stop all instances
+  ~embedded_pipeline_pool();
+
+  embedded_pipeline_pool( embedded_pipeline_pool const& ) = delete;
+  embedded_pipeline_pool& operator=( embedded_pipeline_pool const& ) = delete;
+
+  /// Number of instances
+  unsigned size() const { return static_cast< unsigned >( m_workers.size() ); }
+
+  /// True if the input adapter of the pipeline has the given port
+  bool has_input( std::string const& port ) const;
+
+  /// Queue one set of inputs, whose output set is returned by the future
+  std::future< kwiver::adapter::adapter_data_set_t >
+  submit( kwiver::adapter::adapter_data_set_t inputs );
+
+  /// Finish queued requests and stop all instances, also done on destruction
+  void finish();
+
+private:
+  class instance;
+
+  struct request
+  {
+    kwiver::adapter::adapter_data_set_t inputs;
+    std::promise< kwiver::adapter::adapter_data_set_t > outputs;
+  };
+
+  void run( instance& pipe );
+
+  std::vector< std::string > m_inputs;
+  std::vector< std::unique_ptr< instance > > m_instances;
+  std::vector< std::thread > m_workers;
+
+  std::mutex m_mutex;
+  std::condition_variable m_available;
+  std::queue< request > m_requests;
+  bool m_stopping = false;
+  size_t m_running = 0;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_EMBEDDED_PIPELINE_POOL_H
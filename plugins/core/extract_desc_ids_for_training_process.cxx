@@ -34,12 +34,16 @@
  */
 
 #include "extract_desc_ids_for_training_process.h"
+#include "detection_arrays.h"
+#include "process_trace.h"
 
 #include <vital/vital_types.h>
 
 #include <vital/types/category_hierarchy.h>
 #include <vital/types/timestamp_config.h>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 
@@ -85,6 +89,13 @@ public:
 
   ~priv() {}
 
+  // Index the in-category groundtruth boxes of the current frame
+  void index_groundtruth( const kwiver::vital::detected_object_set_sptr& detections );
+
+  // Indices of the groundtruth boxes which may overlap a box, in input order
+  void find_candidates( const kwiver::vital::bounding_box_d& box,
+                        std::vector< unsigned >& candidates ) const;
+
   std::string m_category_file;
   std::string m_output_directory;
 
@@ -96,8 +107,165 @@ public:
 
   kwiver::vital::category_hierarchy_sptr m_classes;
   std::vector< std::unique_ptr< std::ofstream > > m_writers;
+
+  // In-category groundtruth of the current frame as columns, with the
+  // category of each row resolved once
+  detection_arrays m_groundtruth;
+  std::vector< unsigned > m_groundtruth_ids;
+
+  // Category of each class index of m_groundtruth, -1 outside the categories
+  std::vector< int > m_class_categories;
+
+  // Uniform grid over the groundtruth, each cell listing the boxes touching it
+  double m_grid_x = 0, m_grid_y = 0, m_cell_size = 1;
+  int m_grid_cols = 0, m_grid_rows = 0;
+  std::vector< std::vector< unsigned > > m_cells;
+  std::vector< unsigned > m_candidates;
 };
 
+
+// -------------------------------------------------------------------------------
+void
+extract_desc_ids_for_training_process::priv
+::index_groundtruth( const kwiver::vital::detected_object_set_sptr& detections )
+{
+  m_groundtruth.clear();
+  m_groundtruth_ids.clear();
+
+  for( const auto& det : *detections )
+  {
+    // Check type on detection, is it in our training set
+    if( !det->type() || det->type()->size() == 0 )
+    {
+      continue;
+    }
+
+    const kwiver::vital::bounding_box_d& det_box = det->bounding_box();
+
+    if( det_box.width() <= 0 || det_box.height() <= 0 )
+    {
+      continue;
+    }
+
+    m_groundtruth.push_back( det );
+
+    // Categories are looked up once per class name over the whole input
+    const int class_index = m_groundtruth.class_id.back();
+
+    while( m_class_categories.size() <= static_cast< size_t >( class_index ) )
+    {
+      const std::string& name = m_groundtruth.class_names[ m_class_categories.size() ];
+
+      m_class_categories.push_back( m_classes->has_class_name( name ) ?
+        static_cast< int >( m_classes->get_class_id( name ) ) : -1 );
+    }
+
+    if( m_class_categories[ class_index ] < 0 )
+    {
+      m_groundtruth.pop_back();
+      continue;
+    }
+
+    m_groundtruth_ids.push_back( m_class_categories[ class_index ] );
+  }
+
+  m_grid_cols = m_grid_rows = 0;
+
+  if( m_groundtruth.empty() )
+  {
+    return;
+  }
+
+  // Cells about the size of an average box, bounded to a few cells per box
+  const detection_arrays& gt = m_groundtruth;
+
+  double min_x = *std::min_element( gt.min_x.begin(), gt.min_x.end() );
+  double max_x = *std::max_element( gt.max_x.begin(), gt.max_x.end() );
+  double min_y = *std::min_element( gt.min_y.begin(), gt.min_y.end() );
+  double max_y = *std::max_element( gt.max_y.begin(), gt.max_y.end() );
+  double total_size = 0;
+
+  for( size_t i = 0; i < gt.size(); ++i )
+  {
+    total_size += std::max( gt.max_x[i] - gt.min_x[i], gt.max_y[i] - gt.min_y[i] );
+  }
+
+  const double max_cells = 4.0 * m_groundtruth.size();
+
+  m_cell_size = total_size / m_groundtruth.size();
+  m_cell_size = std::max( m_cell_size,
+    std::sqrt( ( max_x - min_x ) * ( max_y - min_y ) / max_cells ) );
+
+  m_grid_x = min_x;
+  m_grid_y = min_y;
+  m_grid_cols = static_cast< int >( ( max_x - min_x ) / m_cell_size ) + 1;
+  m_grid_rows = static_cast< int >( ( max_y - min_y ) / m_cell_size ) + 1;
+
+  m_cells.resize( static_cast< size_t >( m_grid_cols ) * m_grid_rows );
+
+  for( auto& cell : m_cells )
+  {
+    cell.clear();
+  }
+
+  for( unsigned i = 0; i < gt.size(); ++i )
+  {
+    const int c0 = static_cast< int >( ( gt.min_x[i] - m_grid_x ) / m_cell_size );
+    const int c1 = std::min( m_grid_cols - 1, static_cast< int >( ( gt.max_x[i] - m_grid_x ) / m_cell_size ) );
+    const int r0 = static_cast< int >( ( gt.min_y[i] - m_grid_y ) / m_cell_size );
+    const int r1 = std::min( m_grid_rows - 1, static_cast< int >( ( gt.max_y[i] - m_grid_y ) / m_cell_size ) );
+
+    for( int r = r0; r <= r1; ++r )
+    {
+      for( int c = c0; c <= c1; ++c )
+      {
+        m_cells[ static_cast< size_t >( r ) * m_grid_cols + c ].push_back( i );
+      }
+    }
+  }
+}
+
+
+// -------------------------------------------------------------------------------
+void
+extract_desc_ids_for_training_process::priv
+::find_candidates( const kwiver::vital::bounding_box_d& box,
+                   std::vector< unsigned >& candidates ) const
+{
+  candidates.clear();
+
+  if( m_grid_cols == 0 )
+  {
+    return;
+  }
+
+  const double c0 = std::floor( ( box.min_x() - m_grid_x ) / m_cell_size );
+  const double c1 = std::floor( ( box.max_x() - m_grid_x ) / m_cell_size );
+  const double r0 = std::floor( ( box.min_y() - m_grid_y ) / m_cell_size );
+  const double r1 = std::floor( ( box.max_y() - m_grid_y ) / m_cell_size );
+
+  if( c1 < 0 || r1 < 0 || c0 >= m_grid_cols || r0 >= m_grid_rows )
+  {
+    return;
+  }
+
+  const int col_end = std::min( m_grid_cols - 1, static_cast< int >( c1 ) );
+  const int row_end = std::min( m_grid_rows - 1, static_cast< int >( r1 ) );
+
+  for( int r = std::max( 0, static_cast< int >( r0 ) ); r <= row_end; ++r )
+  {
+    for( int c = std::max( 0, static_cast< int >( c0 ) ); c <= col_end; ++c )
+    {
+      const auto& cell = m_cells[ static_cast< size_t >( r ) * m_grid_cols + c ];
+      candidates.insert( candidates.end(), cell.begin(), cell.end() );
+    }
+  }
+
+  // Boxes spanning several cells are listed once, in groundtruth order
+  std::sort( candidates.begin(), candidates.end() );
+  candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+}
+
 // ===============================================================================
 
 extract_desc_ids_for_training_process
@@ -175,6 +343,8 @@ void
 extract_desc_ids_for_training_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
   bool timestamp_set = false;
   kwiver::vital::timestamp timestamp;
 
@@ -190,22 +360,28 @@ extract_desc_ids_for_training_process
   descriptors = grab_from_port_using_trait( track_descriptor_set );
   detections = grab_from_port_using_trait( detected_object_set );
 
+  trace.inputs_ready();
+
+  d->index_groundtruth( detections );
+
   for( kwiver::vital::track_descriptor_sptr desc : *descriptors )
   {
     // Find bounding box for current frame
     kwiver::vital::bounding_box_d desc_box( 0, 0, 0, 0 );
+    const auto& history = desc->get_history();
 
-    if( !timestamp_set && desc->get_history().size() == 1 )
+    if( !timestamp_set && history.size() == 1 )
     {
-      desc_box = desc->get_history()[0].get_image_location();
+      desc_box = history[0].get_image_location();
     }
     else
     {
-      for( const auto& hist_entry : desc->get_history() )
+      // Histories grow with time, so the current frame is usually last
+      for( auto hist_entry = history.rbegin(); hist_entry != history.rend(); ++hist_entry )
       {
-        if( hist_entry.get_timestamp() == timestamp )
+        if( hist_entry->get_timestamp() == timestamp )
         {
-          desc_box = hist_entry.get_image_location();
+          desc_box = hist_entry->get_image_location();
           break;
         }
       }
@@ -218,24 +394,12 @@ extract_desc_ids_for_training_process
 
     bool is_background = true;
 
-    for( kwiver::vital::detected_object_sptr det : *detections )
-    {
-      // Check type on detection, is it in our training set
-      kwiver::vital::detected_object_type_sptr type_sptr = det->type();
-
-      std::string top_category;
-      double top_score;
-
-      type_sptr->get_most_likely( top_category, top_score );
-
-      if( !d->m_classes->has_class_name( top_category ) )
-      {
-        continue;
-      }
+    d->find_candidates( desc_box, d->m_candidates );
 
+    for( unsigned index : d->m_candidates )
+    {
       // Check bounding box overlap with detection
-      const kwiver::vital::bounding_box_d& det_box =
-        det->bounding_box();
+      const kwiver::vital::bounding_box_d det_box = d->m_groundtruth.box( index );
 
       kwiver::vital::bounding_box_d intersect =
         kwiver::vital::intersection( desc_box, det_box );
@@ -253,7 +417,7 @@ extract_desc_ids_for_training_process
 
         if( min_overlap >= d->m_positive_min_overlap )
         {
-          *d->m_writers[ d->m_classes->get_class_id( top_category ) ]
+          *d->m_writers[ d->m_groundtruth_ids[ index ] ]
             << desc->get_uid().value() << std::endl;
 
           is_background = false;
@@ -33,6 +33,7 @@
 #include <kwiversys/SystemTools.hxx>
 
 #include <cctype>
+#include <cstring>
 #include <locale>
 #include <exception>
 #include <sstream>
@@ -358,4 +359,271 @@ convert_to_timestamp( const std::string& filename, const bool auto_discover )
   return utc_time_usec;
 }
 
+// ----------------------------------------------------------------------------
+// Offset and size of each part of a name, split as with split( s, delim )
+static std::vector< std::pair< std::size_t, std::size_t > >
+split_offsets( const std::string& s, char delim )
+{
+  std::vector< std::pair< std::size_t, std::size_t > > parts;
+  std::size_t start = 0;
+
+  while( start < s.size() )
+  {
+    std::size_t end = s.find( delim, start );
+    if( end == std::string::npos )
+    {
+      end = s.size();
+    }
+    parts.emplace_back( start, end - start );
+    start = end + 1;
+  }
+  return parts;
+}
+
+static inline bool
+is_digit( char c )
+{
+  return c >= '0' && c <= '9';
+}
+
+// ----------------------------------------------------------------------------
+filename_timestamp_parser
+::filename_timestamp_parser( const bool auto_discover )
+  : m_auto_discover( auto_discover )
+  , m_compiled( false )
+  , m_year_adjustment( 0 )
+  , m_fraction_scale( 1 )
+{
+}
+
+// ----------------------------------------------------------------------------
+void
+filename_timestamp_parser
+::reset()
+{
+  m_compiled = false;
+  m_mask.clear();
+}
+
+// ----------------------------------------------------------------------------
+kwiver::vital::time_usec_t
+filename_timestamp_parser
+::parse( const std::string& filename )
+{
+#ifdef _WIN32
+  const std::size_t slash = filename.find_last_of( "/\\" );
+#else
+  const std::size_t slash = filename.find_last_of( '/' );
+#endif
+  const std::size_t name_start = ( slash == std::string::npos ? 0 : slash + 1 );
+  const char* name = filename.c_str() + name_start;
+  const std::size_t name_size = filename.size() - name_start;
+
+  if( m_compiled && filename.size() > 10 && matches( name, name_size ) )
+  {
+    const kwiver::vital::time_usec_t utc_time_usec = extract( name );
+
+    if( utc_time_usec )
+    {
+      return utc_time_usec;
+    }
+  }
+
+  // New layout, decode it the slow way and compile it for the next files
+  const kwiver::vital::time_usec_t utc_time_usec =
+    convert_to_timestamp( filename, m_auto_discover );
+
+  if( !compile( std::string( name, name_size ) ) ||
+      extract( name ) != utc_time_usec )
+  {
+    reset();
+  }
+
+  return utc_time_usec;
+}
+
+// ----------------------------------------------------------------------------
+bool
+filename_timestamp_parser
+::matches( const char* name, std::size_t size ) const
+{
+  if( size != m_mask.size() )
+  {
+    return false;
+  }
+
+  for( std::size_t i = 0; i < size; ++i )
+  {
+    if( m_mask[i] == '0' ? !is_digit( name[i] ) : name[i] != m_mask[i] )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+kwiver::vital::time_usec_t
+filename_timestamp_parser
+::extract( const char* name ) const
+{
+  auto value = [name]( const field& f )
+  {
+    int output = 0;
+    for( std::size_t i = 0; i < f.digits; ++i )
+    {
+      output = output * 10 + ( name[ f.offset + i ] - '0' );
+    }
+    return output;
+  };
+
+  tm t = tm();
+
+  t.tm_year = value( m_year ) + m_year_adjustment;
+  t.tm_mon = value( m_month ) - 1;
+  t.tm_mday = value( m_day );
+
+  t.tm_hour = value( m_hour );
+  t.tm_min = value( m_minute );
+  t.tm_sec = value( m_second );
+
+  return static_cast< kwiver::vital::time_usec_t >( timegm( &t ) ) * 1000000 +
+         value( m_fraction ) * m_fraction_scale;
+}
+
+// ----------------------------------------------------------------------------
+bool
+filename_timestamp_parser
+::compile( const std::string& name )
+{
+  m_compiled = false;
+
+  // Mirrors the fixed formats of convert_to_timestamp, recording the offsets
+  // each field would be read from. Formats are only compiled if every field
+  // starts with a digit, as std::stoi would throw otherwise.
+  bool valid = true;
+
+  auto make_field = [&]( std::size_t offset, std::size_t length )
+  {
+    field f{ offset, 0 };
+    while( f.digits < length && offset + f.digits < name.size() &&
+           is_digit( name[ offset + f.digits ] ) )
+    {
+      ++f.digits;
+    }
+    valid = valid && f.digits > 0;
+    return f;
+  };
+
+  auto set_fields = [&]( std::size_t date, std::size_t time,
+                         std::size_t fraction, std::size_t fraction_length,
+                         kwiver::vital::time_usec_t fraction_scale )
+  {
+    m_year = make_field( date, 4 );
+    m_year_adjustment = -1900;
+    m_month = make_field( date + 4, 2 );
+    m_day = make_field( date + 6, 2 );
+    m_hour = make_field( time, 2 );
+    m_minute = make_field( time + 2, 2 );
+    m_second = make_field( time + 4, 2 );
+    m_fraction = make_field( fraction, fraction_length );
+    m_fraction_scale = fraction_scale;
+    m_compiled = true;
+  };
+
+  m_mask = name;
+  for( auto& c : m_mask )
+  {
+    if( is_digit( c ) )
+    {
+      c = '0';
+    }
+  }
+
+  auto parts = split_offsets( name, '_' );
+  auto part_is = [&]( std::size_t i, const char* str )
+  {
+    return name.compare( parts[i].first, parts[i].second, str ) == 0;
+  };
+
+  // Example: CHESS_FL1_C_160407_234502.428_COLOR-8-BIT.JPG
+  if( parts.size() > 4 && part_is( 0, "CHESS" ) &&
+      parts[3].second > 5 && parts[4].second > 9 )
+  {
+    set_fields( parts[3].first, parts[4].first, parts[4].first + 7, 3, 1000 );
+
+    // Two digit years, starting at 2000
+    m_year = make_field( parts[3].first, 2 );
+    m_year_adjustment = 100;
+    m_month = make_field( parts[3].first + 2, 2 );
+    m_day = make_field( parts[3].first + 4, 2 );
+  }
+  // Example: CHESS2016_N94S_FL23_P__20160518012412.111GMT_THERM-16BIT.PNG
+  else if( parts.size() > 5 && parts[0].second > 5 &&
+           name.compare( 0, 5, "CHESS" ) == 0 )
+  {
+    auto const& date = ( parts[4].second == 0 ? parts[5] : parts[4] );
+
+    if( date.second >= 21 && name.compare( date.first + 18, 3, "GMT" ) == 0 )
+    {
+      set_fields( date.first, date.first + 8, date.first + 15, 3, 1000 );
+    }
+  }
+  // Example: *_20190507_004346.455104* or *_20190401_220727.714*
+  else if( parts.size() > 2 )
+  {
+    for( unsigned i = 0; i < parts.size()-1; i++ )
+    {
+      if( parts[i].second == 8 && parts[i+1].second >= 10 &&
+          name[ parts[i+1].first + 6 ] == '.' )
+      {
+        if( name[ parts[i].first ] != '2' )
+        {
+          // This part would be used by another file with a leading '2'
+          return false;
+        }
+
+        // Other files need the same leading '2' to select this part
+        m_mask[ parts[i].first ] = '2';
+
+        if( parts[i+1].second < 12 )
+        {
+          set_fields( parts[i].first, parts[i+1].first,
+                      parts[i+1].first + 7, 3, 1000 );
+        }
+        else
+        {
+          set_fields( parts[i].first, parts[i+1].first,
+                      parts[i+1].first + 7, 6, 1 );
+        }
+        break;
+      }
+    }
+  }
+
+  if( !m_compiled )
+  {
+    parts = split_offsets( name, '.' );
+
+    // Example: 20151023.200145.662.017459.png
+    if( parts.size() > 3 && parts[0].second == 8 && parts[1].second == 6 )
+    {
+      set_fields( parts[0].first, parts[1].first, parts[2].first, 3, 1000 );
+    }
+    // Example: 00231.00232.20171025.182621.170.004021.tif
+    else if( parts.size() > 6 && parts[2].second == 8 && parts[3].second == 6 )
+    {
+      set_fields( parts[2].first, parts[3].first, parts[4].first, 3, 1000 );
+    }
+    // Example 201503.20150517.105551974.76450.png
+    else if( parts.size() > 3 && parts[0].second == 6 && parts[1].second == 8 )
+    {
+      set_fields( parts[1].first, parts[2].first, parts[2].first + 6, 3, 1000 );
+    }
+  }
+
+  m_compiled = m_compiled && valid;
+  return m_compiled;
+}
+
 }
@@ -35,6 +35,9 @@
 
 #include <vital/types/timestamp.h>
 
+#include <cstddef>
+#include <string>
+
 namespace viame
 {
 
@@ -50,6 +53,51 @@ kwiver::vital::time_usec_t
 convert_to_timestamp( const std::string& filename,
                       const bool auto_discover = false );
 
+/// Filename timestamp decoder for streams of similarly named files
+///
+/// The format of a filename is detected with the same rules as
+/// convert_to_timestamp, and compiled into the fixed character offsets of its
+/// date and time fields. Later filenames with the same layout, differing only
+/// in their digits, are decoded directly from those offsets without any string
+/// allocation. Other filenames fall back to convert_to_timestamp and replace
+/// the compiled layout.
+///
+class VIAME_CORE_EXPORT filename_timestamp_parser
+{
+public:
+  /// @param auto_discover passed to convert_to_timestamp for fallback parses
+  explicit filename_timestamp_parser( const bool auto_discover = false );
+
+  /// Decode the timestamp of a filename
+  ///
+  /// @throws runtime_error on invalid or unable to parse filename format
+  kwiver::vital::time_usec_t parse( const std::string& filename );
+
+  /// Forget the compiled layout, as when starting a new stream
+  void reset();
+
+private:
+  // Run of digits at a fixed offset of the filename
+  struct field
+  {
+    std::size_t offset;
+    std::size_t digits;
+  };
+
+  bool compile( const std::string& name );
+  bool matches( const char* name, std::size_t size ) const;
+  kwiver::vital::time_usec_t extract( const char* name ) const;
+
+  bool m_auto_discover;
+  bool m_compiled;
+
+  // Filename without directory, with every digit replaced by '0'
+  std::string m_mask;
+  field m_year, m_month, m_day, m_hour, m_minute, m_second, m_fraction;
+  int m_year_adjustment;
+  kwiver::vital::time_usec_t m_fraction_scale;
+};
+
 } // end namespace viame
 
 #endif // VIAME_CORE_FILENAME_TO_TIMESTAMP_H
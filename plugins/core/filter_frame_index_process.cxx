@@ -4,6 +4,8 @@
  */
 
 #include "filter_frame_index_process.h"
+#include "process_trace.h"
+#include "frame_schedule.h"
 
 #include <vital/vital_types.h>
 #include <vital/types/timestamp.h>
@@ -28,6 +30,10 @@ create_config_trait( max_frame_count, unsigned, "0",
   "If set, Require frame index lower than to pass frame" );
 create_config_trait( frame_step, unsigned, "0",
   "If set, Pass frame at each frame step" );
+create_config_trait( schedule_name, std::string, "",
+  "If set, publish the frame limits and step under this name so that a "
+  "scheduled video reader with the same schedule_name can seek past frames "
+  "this process would drop instead of decoding them" );
 
 //------------------------------------------------------------------------------
 // Private implementation class
@@ -42,9 +48,7 @@ public:
   bool m_first_frame;
   
   // Configuration settings
-  kv::frame_id_t m_min_frame_count;
-  kv::frame_id_t m_max_frame_count;
-  kv::frame_id_t m_frame_step;
+  frame_schedule m_schedule;
 };
 
 // =============================================================================
@@ -52,9 +56,6 @@ filter_frame_index_process::priv
 ::priv()
   : m_last_frame_id(0)
   , m_first_frame(true)
-  , m_min_frame_count( 0 )
-  , m_max_frame_count( 0 )
-  , m_frame_step( 0 )
 {
 }
 
@@ -113,6 +114,7 @@ filter_frame_index_process
   declare_config_using_trait( min_frame_count );
   declare_config_using_trait( max_frame_count );
   declare_config_using_trait( frame_step );
+  declare_config_using_trait( schedule_name );
 }
 
 
@@ -123,14 +125,21 @@ filter_frame_index_process
 {
   d->m_last_frame_id = 0;
   d->m_first_frame = true;
-  d->m_min_frame_count = config_value_using_trait( min_frame_count );
-  d->m_max_frame_count = config_value_using_trait( max_frame_count );
-  d->m_frame_step = config_value_using_trait( frame_step );
+  d->m_schedule.min_frame = config_value_using_trait( min_frame_count );
+  d->m_schedule.max_frame = config_value_using_trait( max_frame_count );
+  d->m_schedule.frame_step = config_value_using_trait( frame_step );
   
-  if ( d->m_min_frame_count > d->m_max_frame_count )
+  if ( d->m_schedule.min_frame > d->m_schedule.max_frame )
   {
     VITAL_THROW( sprokit::invalid_configuration_exception, name(), "Invalid min/max frame index limits" );
   }
+
+  const std::string schedule_name = config_value_using_trait( schedule_name );
+
+  if( !schedule_name.empty() )
+  {
+    publish_frame_schedule( schedule_name, d->m_schedule );
+  }
 }
 
 
@@ -139,18 +148,23 @@ void
 filter_frame_index_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
   kv::timestamp timestamp;
   std::string image_name;
   kv::image_container_sptr image;
 
   timestamp = grab_from_port_using_trait( timestamp );
   
-  if(!d->m_max_frame_count && !d->m_frame_step ||
-     timestamp.get_frame() >= d->m_min_frame_count && 
-     timestamp.get_frame() <= d->m_max_frame_count)
+  trace.inputs_ready();
+
+  const kv::frame_id_t frame = timestamp.get_frame();
+  const frame_schedule& sched = d->m_schedule;
+
+  if(!sched.max_frame && !sched.frame_step ||
+     frame >= sched.min_frame && frame <= sched.max_frame)
   {
-    if(d->m_first_frame ||
-       (timestamp.get_frame() - d->m_last_frame_id) >= d->m_frame_step)
+    if(sched.passes(frame, !d->m_first_frame, d->m_last_frame_id))
     {
       push_to_port_using_trait( timestamp, timestamp );
       image_name = grab_from_port_using_trait( image_file_name );
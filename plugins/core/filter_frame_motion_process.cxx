@@ -0,0 +1,393 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Pass frames only on motion or at a minimum keyframe rate
+ */
+
+#include "filter_frame_motion_process.h"
+#include "process_trace.h"
+
+#include <sprokit/processes/kwiver_type_traits.h>
+
+#include <vital/vital_types.h>
+
+#include <vital/types/timestamp.h>
+#include <vital/types/image_container.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( grid_width, unsigned, "64",
+  "Width of the grid of mean intensities frames are compared on. The grid "
+  "height follows the frame aspect ratio." );
+create_config_trait( samples_per_cell, unsigned, "4",
+  "Pixels sampled along each side of a grid cell to estimate its mean, so "
+  "that the cost does not depend on the frame resolution." );
+create_config_trait( pixel_threshold, double, "10.0",
+  "Difference in mean intensity, on a 0-255 scale, above which a grid cell "
+  "is considered changed." );
+create_config_trait( motion_threshold, double, "0.01",
+  "Fraction of changed grid cells required to pass a frame." );
+create_config_trait( keyframe_interval, unsigned, "30",
+  "Pass a frame at least this often even without motion, 0 to disable." );
+create_config_trait( passing_frames_only, bool, "false",
+  "Only produce outputs for frames which pass, instead of an empty image for "
+  "rejected frames." );
+
+//------------------------------------------------------------------------------
+// Private implementation class
+class filter_frame_motion_process::priv
+{
+public:
+  priv();
+  ~priv();
+
+  // Configuration values
+  unsigned m_grid_width;
+  unsigned m_samples_per_cell;
+  double m_pixel_threshold;
+  double m_motion_threshold;
+  unsigned m_keyframe_interval;
+  bool m_passing_frames_only;
+
+  // Grid of the last passed frame, and frames rejected since
+  std::vector< float > m_reference;
+  unsigned m_reference_width;
+  unsigned m_reference_height;
+  unsigned m_frames_since_pass;
+
+  // Reduce an image to a grid of mean intensities on a 0-255 scale, returns
+  // false for pixel types which are not supported
+  bool compute_grid( const kwiver::vital::image& image,
+                     std::vector< float >& grid,
+                     unsigned& grid_w, unsigned& grid_h ) const;
+
+  // Fraction of grid cells changed compared to the reference
+  double changed_fraction( const std::vector< float >& grid ) const;
+};
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+template< typename T >
+void
+sample_grid( const kwiver::vital::image& image, double scale,
+             unsigned samples, unsigned grid_w, unsigned grid_h,
+             std::vector< float >& grid )
+{
+  const T* first = reinterpret_cast< const T* >( image.first_pixel() );
+
+  const size_t width = image.width();
+  const size_t height = image.height();
+  const size_t depth = image.depth();
+
+  grid.assign( static_cast< size_t >( grid_w ) * grid_h, 0.0f );
+
+  const double norm = scale / ( samples * samples * depth );
+
+  for( unsigned gj = 0; gj < grid_h; ++gj )
+  {
+    for( unsigned gi = 0; gi < grid_w; ++gi )
+    {
+      double sum = 0.0;
+
+      for( unsigned sj = 0; sj < samples; ++sj )
+      {
+        const size_t j = ( ( gj * samples + sj ) * 2 + 1 ) * height /
+                         ( 2 * grid_h * samples );
+
+        for( unsigned si = 0; si < samples; ++si )
+        {
+          const size_t i = ( ( gi * samples + si ) * 2 + 1 ) * width /
+                           ( 2 * grid_w * samples );
+
+          const T* pixel = first + i * image.w_step() + j * image.h_step();
+
+          for( size_t k = 0; k < depth; ++k )
+          {
+            sum += static_cast< double >( pixel[ k * image.d_step() ] );
+          }
+        }
+      }
+
+      grid[ gj * grid_w + gi ] = static_cast< float >( sum * norm );
+    }
+  }
+}
+
+} // end anonymous namespace
+
+// =============================================================================
+
+filter_frame_motion_process
+::filter_frame_motion_process( kwiver::vital::config_block_sptr const& config )
+  : process( config ),
+    d( new filter_frame_motion_process::priv() )
+{
+  make_ports();
+  make_config();
+}
+
+
+filter_frame_motion_process
+::~filter_frame_motion_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+filter_frame_motion_process
+::_configure()
+{
+  d->m_grid_width = std::max( 1u, config_value_using_trait( grid_width ) );
+  d->m_samples_per_cell = std::max( 1u, config_value_using_trait( samples_per_cell ) );
+  d->m_pixel_threshold = config_value_using_trait( pixel_threshold );
+  d->m_motion_threshold = config_value_using_trait( motion_threshold );
+  d->m_keyframe_interval = config_value_using_trait( keyframe_interval );
+  d->m_passing_frames_only = config_value_using_trait( passing_frames_only );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+filter_frame_motion_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  kwiver::vital::image_container_sptr image;
+  kwiver::vital::timestamp timestamp;
+
+  image = grab_from_port_using_trait( image );
+
+  if( has_input_port_edge_using_trait( timestamp ) )
+  {
+    timestamp = grab_from_port_using_trait( timestamp );
+  }
+
+  trace.inputs_ready();
+
+  bool passed = false;
+
+  std::vector< float > grid;
+  unsigned grid_w = 0, grid_h = 0;
+
+  if( !image )
+  {
+    passed = false;
+  }
+  else if( !d->compute_grid( image->get_image(), grid, grid_w, grid_h ) )
+  {
+    // Unsupported pixel types are never gated
+    passed = true;
+  }
+  else if( d->m_reference.empty() ||
+           grid_w != d->m_reference_width ||
+           grid_h != d->m_reference_height )
+  {
+    passed = true;
+  }
+  else if( d->m_keyframe_interval > 0 &&
+           d->m_frames_since_pass + 1 >= d->m_keyframe_interval )
+  {
+    passed = true;
+  }
+  else
+  {
+    passed = ( d->changed_fraction( grid ) >= d->m_motion_threshold );
+  }
+
+  if( passed )
+  {
+    d->m_reference.swap( grid );
+    d->m_reference_width = grid_w;
+    d->m_reference_height = grid_h;
+    d->m_frames_since_pass = 0;
+  }
+  else
+  {
+    d->m_frames_since_pass++;
+  }
+
+  trace.count( "passed", passed ? 1 : 0 );
+
+  if( !passed && d->m_passing_frames_only )
+  {
+    return;
+  }
+
+  push_to_port_using_trait( timestamp, timestamp );
+
+  if( passed )
+  {
+    push_to_port_using_trait( image, image );
+  }
+  else
+  {
+    push_to_port_using_trait( image, kwiver::vital::image_container_sptr() );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+filter_frame_motion_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t required;
+  sprokit::process::port_flags_t optional;
+
+  required.insert( flag_required );
+
+  // -- input --
+  declare_input_port_using_trait( image, required );
+  declare_input_port_using_trait( timestamp, optional );
+
+  // -- output --
+  declare_output_port_using_trait( image, optional );
+  declare_output_port_using_trait( timestamp, optional );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+filter_frame_motion_process
+::make_config()
+{
+  declare_config_using_trait( grid_width );
+  declare_config_using_trait( samples_per_cell );
+  declare_config_using_trait( pixel_threshold );
+  declare_config_using_trait( motion_threshold );
+  declare_config_using_trait( keyframe_interval );
+  declare_config_using_trait( passing_frames_only );
+}
+
+
+// =============================================================================
+filter_frame_motion_process::priv
+::priv()
+  : m_grid_width( 64 )
+  , m_samples_per_cell( 4 )
+  , m_pixel_threshold( 10.0 )
+  , m_motion_threshold( 0.01 )
+  , m_keyframe_interval( 30 )
+  , m_passing_frames_only( false )
+  , m_reference_width( 0 )
+  , m_reference_height( 0 )
+  , m_frames_since_pass( 0 )
+{
+}
+
+
+filter_frame_motion_process::priv
+::~priv()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+filter_frame_motion_process::priv
+::compute_grid( const kwiver::vital::image& image,
+                std::vector< float >& grid,
+                unsigned& grid_w, unsigned& grid_h ) const
+{
+  typedef kwiver::vital::image_pixel_traits traits_t;
+
+  if( image.width() == 0 || image.height() == 0 || image.depth() == 0 )
+  {
+    return false;
+  }
+
+  grid_w = std::min< unsigned >( m_grid_width,
+                                 static_cast< unsigned >( image.width() ) );
+  grid_h = std::max( 1u, static_cast< unsigned >(
+    std::lround( static_cast< double >( grid_w ) * image.height() / image.width() ) ) );
+  grid_h = std::min< unsigned >( grid_h, static_cast< unsigned >( image.height() ) );
+
+  const unsigned samples = m_samples_per_cell;
+  const traits_t& pt = image.pixel_traits();
+
+  if( pt.type == traits_t::UNSIGNED && pt.num_bytes == 1 )
+  {
+    sample_grid< uint8_t >( image, 1.0, samples, grid_w, grid_h, grid );
+  }
+  else if( pt.type == traits_t::UNSIGNED && pt.num_bytes == 2 )
+  {
+    sample_grid< uint16_t >( image, 255.0 / 65535.0, samples, grid_w, grid_h, grid );
+  }
+  else if( pt.type == traits_t::FLOAT && pt.num_bytes == 4 )
+  {
+    sample_grid< float >( image, 255.0, samples, grid_w, grid_h, grid );
+  }
+  else
+  {
+    return false;
+  }
+
+  return true;
+}
+
+
+// -----------------------------------------------------------------------------
+double
+filter_frame_motion_process::priv
+::changed_fraction( const std::vector< float >& grid ) const
+{
+  size_t changed = 0;
+
+  for( size_t i = 0; i < grid.size(); ++i )
+  {
+    if( std::fabs( grid[i] - m_reference[i] ) > m_pixel_threshold )
+    {
+      changed++;
+    }
+  }
+
+  return grid.empty() ? 0.0 : static_cast< double >( changed ) / grid.size();
+}
+
+
+} // end namespace core
+
+} // end namespace viame
@@ -34,6 +34,7 @@
  */
 
 #include "filter_frame_process.h"
+#include "process_trace.h"
 
 #include <sprokit/processes/kwiver_type_traits.h>
 
@@ -59,6 +60,10 @@ namespace core
 
 create_config_trait( detection_threshold, double, "0.0",
   "Require having a detection with at least this confidence to pass frame" );
+create_config_trait( passing_frames_only, bool, "false",
+  "Only produce outputs for frames which pass, instead of an empty image for "
+  "rejected frames. Connecting the timestamp ports without the image ports "
+  "then emits the frame indices of passing frames alone." );
 
 //------------------------------------------------------------------------------
 // Private implementation class
@@ -70,6 +75,10 @@ public:
 
   // Configuration values
   double m_detection_threshold;
+  bool m_passing_frames_only;
+
+  // Whether any detection meets the threshold
+  bool criteria_met( const kwiver::vital::detected_object_set_sptr& detections ) const;
 };
 
 // =============================================================================
@@ -96,6 +105,7 @@ filter_frame_process
 ::_configure()
 {
   d->m_detection_threshold = config_value_using_trait( detection_threshold );
+  d->m_passing_frames_only = config_value_using_trait( passing_frames_only );
 }
 
 
@@ -104,51 +114,41 @@ void
 filter_frame_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
   kwiver::vital::image_container_sptr image;
   kwiver::vital::detected_object_set_sptr detections;
+  kwiver::vital::timestamp timestamp;
+
+  // The image is only passed along, so lazily loaded images are never read
+  if( has_input_port_edge_using_trait( image ) )
+  {
+    image = grab_from_port_using_trait( image );
+  }
 
-  image = grab_from_port_using_trait( image );
+  if( has_input_port_edge_using_trait( timestamp ) )
+  {
+    timestamp = grab_from_port_using_trait( timestamp );
+  }
 
   if( has_input_port_edge_using_trait( detected_object_set ) )
   {
     detections = grab_from_port_using_trait( detected_object_set );
   }
 
-  bool criteria_met = false;
+  trace.inputs_ready();
+  trace.count( "detections", detections ? detections->size() : 0 );
+
+  const bool passed = d->criteria_met( detections );
 
-  if( detections )
+  if( !passed && d->m_passing_frames_only )
   {
-    for( auto detection : *detections )
-    {
-      if( detection->confidence() >= d->m_detection_threshold )
-      {
-        criteria_met = true;
-        break;
-      }
-      else if( detection->type() )
-      {
-        try
-        {
-          double score;
-          std::string unused;
-
-          detection->type()->get_most_likely( unused, score );
-
-          if( score >= d->m_detection_threshold )
-          {
-            criteria_met = true;
-            break;
-          }
-        }
-        catch( ... )
-        {
-          continue;
-        }
-      }
-    }
+    return;
   }
 
-  if( criteria_met )
+  push_to_port_using_trait( timestamp, timestamp );
+
+  if( passed )
   {
     push_to_port_using_trait( image, image );
   }
@@ -171,11 +171,13 @@ filter_frame_process
   required.insert( flag_required );
 
   // -- input --
-  declare_input_port_using_trait( image, required );
+  declare_input_port_using_trait( image, optional );
+  declare_input_port_using_trait( timestamp, optional );
   declare_input_port_using_trait( detected_object_set, optional );
 
   // -- output --
   declare_output_port_using_trait( image, optional );
+  declare_output_port_using_trait( timestamp, optional );
 }
 
 
@@ -185,6 +187,7 @@ filter_frame_process
 ::make_config()
 {
   declare_config_using_trait( detection_threshold );
+  declare_config_using_trait( passing_frames_only );
 }
 
 
@@ -192,6 +195,7 @@ filter_frame_process
 filter_frame_process::priv
 ::priv()
   : m_detection_threshold( 0.0 )
+  , m_passing_frames_only( false )
 {
 }
 
@@ -202,6 +206,44 @@ filter_frame_process::priv
 }
 
 
+// -----------------------------------------------------------------------------
+bool
+filter_frame_process::priv
+::criteria_met( const kwiver::vital::detected_object_set_sptr& detections ) const
+{
+  if( !detections )
+  {
+    return false;
+  }
+
+  for( auto detection : *detections )
+  {
+    if( detection->confidence() >= m_detection_threshold )
+    {
+      return true;
+    }
+
+    // Empty types are skipped, get_most_likely would throw on them
+    const auto& type = detection->type();
+
+    if( type && type->size() > 0 )
+    {
+      double score;
+      std::string unused;
+
+      type->get_most_likely( unused, score );
+
+      if( score >= m_detection_threshold )
+      {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+
 } // end namespace core
 
 } // end namespace viame
@@ -34,6 +34,7 @@
  */
 
 #include "filter_object_tracks_process.h"
+#include "process_trace.h"
 
 #include <vital/vital_types.h>
 #include <vital/types/image_container.h>
@@ -43,6 +44,10 @@
 
 #include <sprokit/processes/kwiver_type_traits.h>
 
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
 
 namespace kv = kwiver::vital;
 
@@ -55,7 +60,10 @@ namespace core
 create_config_trait( required_states, unsigned, "0",
   "If set, number of track states required for a track"  );
 create_config_trait( buffer_frames, unsigned, "0",
-  "Number of frames to buffer offer"  );
+  "Number of frames to buffer before output. If set, the output for each frame is "
+  "delayed by this many frames, so that tracks reaching required_states "
+  "within the window are also output on their earlier frames. Only the "
+  "track IDs of buffered frames and the tracks they reference are kept."  );
 
 // =============================================================================
 // Private implementation class
@@ -69,6 +77,27 @@ public:
   unsigned m_required_states;
   unsigned m_buffer_frames;
 
+  // Frame awaiting output in buffered mode
+  struct pending_frame
+  {
+    kv::timestamp timestamp;
+    std::vector< kv::track_id_t > ids;
+  };
+
+  // Latest version of a track referenced by pending frames
+  struct window_track
+  {
+    kv::track_sptr track;
+    unsigned references;
+  };
+
+  std::deque< pending_frame > m_pending;
+  std::unordered_map< kv::track_id_t, window_track > m_window;
+
+  void add_frame( const kv::timestamp& timestamp,
+                  const kv::object_track_set_sptr& tracks );
+  kv::object_track_set_sptr release_frame( kv::timestamp& timestamp );
+
   // Other variables
   filter_object_tracks_process* parent;
 };
@@ -90,6 +119,65 @@ filter_object_tracks_process::priv
 }
 
 
+void
+filter_object_tracks_process::priv
+::add_frame( const kv::timestamp& timestamp,
+             const kv::object_track_set_sptr& tracks )
+{
+  m_pending.push_back( pending_frame{ timestamp, {} } );
+
+  if( !tracks )
+  {
+    return;
+  }
+
+  auto& ids = m_pending.back().ids;
+
+  for( auto trk : tracks->tracks() )
+  {
+    if( !trk )
+    {
+      continue;
+    }
+
+    auto& entry = m_window[ trk->id() ];
+    entry.track = trk;
+    entry.references++;
+    ids.push_back( trk->id() );
+  }
+}
+
+
+kv::object_track_set_sptr
+filter_object_tracks_process::priv
+::release_frame( kv::timestamp& timestamp )
+{
+  pending_frame frame = std::move( m_pending.front() );
+  m_pending.pop_front();
+
+  std::vector< kv::track_sptr > filtered_tracks;
+
+  for( auto id : frame.ids )
+  {
+    auto it = m_window.find( id );
+
+    if( it->second.track->size() >= m_required_states )
+    {
+      filtered_tracks.push_back( it->second.track );
+    }
+
+    // Drop tracks no longer referenced by any buffered frame
+    if( --it->second.references == 0 )
+    {
+      m_window.erase( it );
+    }
+  }
+
+  timestamp = frame.timestamp;
+  return std::make_shared< kv::object_track_set >( filtered_tracks );
+}
+
+
 // =============================================================================
 filter_object_tracks_process
 ::filter_object_tracks_process( kv::config_block_sptr const& config )
@@ -144,6 +232,12 @@ filter_object_tracks_process
 {
   d->m_required_states = config_value_using_trait( required_states );
   d->m_buffer_frames = config_value_using_trait( buffer_frames );
+
+  if( d->m_buffer_frames > 0 )
+  {
+    // Completion is handled in the step to flush the buffered frames
+    set_data_checking_level( check_none );
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -151,11 +245,19 @@ void
 filter_object_tracks_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
   kv::object_track_set_sptr input_tracks;
 
   kv::image_container_sptr image;
   kv::timestamp timestamp;
 
+  if( d->m_buffer_frames > 0 )
+  {
+    buffered_step();
+    return;
+  }
+
   input_tracks = grab_from_port_using_trait( object_track_set );
 
   if( has_input_port_edge_using_trait( timestamp ) )
@@ -167,6 +269,9 @@ filter_object_tracks_process
     image = grab_from_port_using_trait( image );
   }
 
+  trace.inputs_ready();
+  trace.count( "tracks", input_tracks ? input_tracks->size() : 0 );
+
   std::vector< kv::track_sptr > filtered_tracks;
 
   for( auto trk : input_tracks->tracks() )
@@ -185,6 +290,78 @@ filter_object_tracks_process
   push_to_port_using_trait( object_track_set, output );
 }
 
+// -----------------------------------------------------------------------------
+void
+filter_object_tracks_process
+::buffered_step()
+{
+  auto port_info = peek_at_port_using_trait( object_track_set );
+
+  if( port_info.datum->type() == sprokit::datum::complete )
+  {
+    grab_edge_datum_using_trait( object_track_set );
+
+    if( has_input_port_edge_using_trait( timestamp ) )
+    {
+      grab_edge_datum_using_trait( timestamp );
+    }
+    if( has_input_port_edge_using_trait( image ) )
+    {
+      grab_edge_datum_using_trait( image );
+    }
+
+    // Flush all buffered frames before completing
+    while( !d->m_pending.empty() )
+    {
+      kv::timestamp timestamp;
+      kv::object_track_set_sptr output = d->release_frame( timestamp );
+
+      push_to_port_using_trait( timestamp, timestamp );
+      push_to_port_using_trait( object_track_set, output );
+    }
+
+    mark_process_as_complete();
+
+    const sprokit::datum_t dat = sprokit::datum::complete_datum();
+
+    push_datum_to_port_using_trait( timestamp, dat );
+    push_datum_to_port_using_trait( object_track_set, dat );
+    return;
+  }
+
+  kv::object_track_set_sptr input_tracks;
+  kv::timestamp timestamp;
+
+  input_tracks = grab_from_port_using_trait( object_track_set );
+
+  if( has_input_port_edge_using_trait( timestamp ) )
+  {
+    timestamp = grab_from_port_using_trait( timestamp );
+  }
+  if( has_input_port_edge_using_trait( image ) )
+  {
+    grab_edge_datum_using_trait( image );
+  }
+
+  d->add_frame( timestamp, input_tracks );
+
+  if( d->m_pending.size() > d->m_buffer_frames )
+  {
+    kv::object_track_set_sptr output = d->release_frame( timestamp );
+
+    push_to_port_using_trait( timestamp, timestamp );
+    push_to_port_using_trait( object_track_set, output );
+  }
+  else
+  {
+    // Keep the outputs in step with the inputs while filling the buffer
+    const sprokit::datum_t dat = sprokit::datum::empty_datum();
+
+    push_datum_to_port_using_trait( timestamp, dat );
+    push_datum_to_port_using_trait( object_track_set, dat );
+  }
+}
+
 } // end namespace core
 
 } // end namespace viame
@@ -67,6 +67,7 @@ protected:
 private:
   void make_ports();
   void make_config();
+  void buffered_step();
 
   class priv;
   const std::unique_ptr<priv> d;
@@ -0,0 +1,616 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Smooth per-frame classifications into class segments
+ */
+
+#include "frame_class_segmenter_process.h"
+#include "process_trace.h"
+
+#include <vital/types/detected_object_set.h>
+#include <vital/types/object_track_set.h>
+#include <vital/types/timestamp.h>
+
+#include <sprokit/processes/kwiver_type_traits.h>
+#include <sprokit/pipeline/process_exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( smoothing, std::string, "median",
+  "Temporal smoothing applied to the class scores of each frame, either "
+  "median, for the per-class median score over a window centered on the "
+  "frame, or hmm, for a fixed-lag Viterbi decode where changing class costs "
+  "switch_penalty" );
+create_config_trait( window_size, unsigned, "5",
+  "Number of frames in the smoothing window. Outputs lag the inputs by half "
+  "of the window for median smoothing and by the window less one for hmm." );
+create_config_trait( switch_penalty, double, "2.0",
+  "Log-score cost of changing class between consecutive frames, used by hmm "
+  "smoothing. Larger values produce fewer, longer segments." );
+
+// Label of frames without any class
+const size_t no_class = static_cast< size_t >( -1 );
+
+// =============================================================================
+// Private implementation class
+class frame_class_segmenter_process::priv
+{
+public:
+  priv();
+  ~priv();
+
+  struct frame_entry
+  {
+    kv::timestamp ts;
+    std::string file_name;
+
+    // Highest score for each class index on the frame, 0 when absent
+    std::vector< double > scores;
+
+    kv::bounding_box_d box;
+    bool has_box = false;
+
+    // Viterbi backpointers to the previous frame, empty before any class
+    std::vector< size_t > back;
+  };
+
+  size_t class_index( std::string const& name );
+  void add_frame( kv::timestamp const& ts,
+                  std::string const& file_name,
+                  kv::detected_object_set_sptr const& detections );
+
+  // Decide the smoothed class and score of each undecided frame which can
+  // be decided, or of all of them when flushing, in frame order
+  void decide( bool flush, std::vector< size_t >& labels,
+               std::vector< double >& scores );
+  void decide_median( bool flush, std::vector< size_t >& labels,
+                      std::vector< double >& scores );
+  void decide_hmm( bool flush, std::vector< size_t >& labels,
+                   std::vector< double >& scores );
+
+  // Extend or start the current segment with a decided frame
+  kv::object_track_set_sptr emit( frame_entry const& frame,
+                                  size_t label, double score );
+
+  double score_of( frame_entry const& frame, size_t label ) const;
+
+  // Configuration settings
+  bool m_use_hmm;
+  unsigned m_window_size;
+  double m_switch_penalty;
+
+  // Frames from index m_first onwards, decided up to m_next
+  std::deque< frame_entry > m_frames;
+  size_t m_first;
+  size_t m_next;
+
+  std::map< std::string, size_t > m_class_ids;
+  std::vector< std::string > m_class_names;
+
+  // Viterbi scores of the newest frame, per class index
+  std::vector< double > m_delta;
+
+  // Current segment
+  kv::track_sptr m_track;
+  size_t m_track_class;
+  kv::track_id_t m_track_counter;
+  kv::bounding_box_d m_last_box;
+  bool m_has_last_box;
+};
+
+
+// -----------------------------------------------------------------------------
+frame_class_segmenter_process::priv
+::priv()
+  : m_use_hmm( false )
+  , m_window_size( 5 )
+  , m_switch_penalty( 2.0 )
+  , m_first( 0 )
+  , m_next( 0 )
+  , m_track_class( no_class )
+  , m_track_counter( 1 )
+  , m_last_box( 0, 0, 0, 0 )
+  , m_has_last_box( false )
+{
+}
+
+
+frame_class_segmenter_process::priv
+::~priv()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+size_t
+frame_class_segmenter_process::priv
+::class_index( std::string const& name )
+{
+  auto itr = m_class_ids.find( name );
+
+  if( itr != m_class_ids.end() )
+  {
+    return itr->second;
+  }
+
+  m_class_ids[ name ] = m_class_names.size();
+  m_class_names.push_back( name );
+  return m_class_names.size() - 1;
+}
+
+
+// -----------------------------------------------------------------------------
+double
+frame_class_segmenter_process::priv
+::score_of( frame_entry const& frame, size_t label ) const
+{
+  return label < frame.scores.size() ? frame.scores[ label ] : 0.0;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+frame_class_segmenter_process::priv
+::add_frame( kv::timestamp const& ts,
+             std::string const& file_name,
+             kv::detected_object_set_sptr const& detections )
+{
+  m_frames.emplace_back();
+
+  frame_entry& frame = m_frames.back();
+  frame.ts = ts;
+  frame.file_name = file_name;
+
+  bool has_scores = false;
+
+  if( detections )
+  {
+    for( auto det : *detections )
+    {
+      if( !frame.has_box )
+      {
+        frame.box = det->bounding_box();
+        frame.has_box = true;
+      }
+
+      if( !det->type() )
+      {
+        continue;
+      }
+
+      for( auto const& name : det->type()->class_names() )
+      {
+        const size_t id = class_index( name );
+
+        if( frame.scores.size() <= id )
+        {
+          frame.scores.resize( id + 1, 0.0 );
+        }
+
+        frame.scores[ id ] = std::max( frame.scores[ id ],
+                                       det->type()->score( name ) );
+        has_scores = true;
+      }
+    }
+  }
+
+  if( !m_use_hmm || m_class_names.empty() )
+  {
+    return;
+  }
+
+  // One Viterbi step, classes first seen on this frame start from a switch
+  const size_t class_count = m_class_names.size();
+  const double floor_score = 1e-6;
+
+  std::vector< double > delta( class_count );
+  frame.back.resize( class_count );
+
+  size_t best_prev = 0;
+
+  for( size_t c = 1; c < m_delta.size(); ++c )
+  {
+    if( m_delta[ c ] > m_delta[ best_prev ] )
+    {
+      best_prev = c;
+    }
+  }
+
+  for( size_t c = 0; c < class_count; ++c )
+  {
+    const double emission = ( has_scores ?
+      std::log( std::max( score_of( frame, c ), floor_score ) ) : 0.0 );
+
+    if( m_delta.empty() )
+    {
+      delta[ c ] = emission;
+      frame.back[ c ] = c;
+      continue;
+    }
+
+    const double switched = m_delta[ best_prev ] - m_switch_penalty;
+
+    if( c < m_delta.size() && m_delta[ c ] >= switched )
+    {
+      delta[ c ] = m_delta[ c ] + emission;
+      frame.back[ c ] = c;
+    }
+    else
+    {
+      delta[ c ] = switched + emission;
+      frame.back[ c ] = best_prev;
+    }
+  }
+
+  // Keep scores near zero over long inputs
+  const double top = *std::max_element( delta.begin(), delta.end() );
+
+  for( double& value : delta )
+  {
+    value -= top;
+  }
+
+  m_delta.swap( delta );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+frame_class_segmenter_process::priv
+::decide( bool flush, std::vector< size_t >& labels,
+          std::vector< double >& scores )
+{
+  labels.clear();
+  scores.clear();
+
+  if( m_use_hmm )
+  {
+    decide_hmm( flush, labels, scores );
+  }
+  else
+  {
+    decide_median( flush, labels, scores );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+frame_class_segmenter_process::priv
+::decide_median( bool flush, std::vector< size_t >& labels,
+                 std::vector< double >& scores )
+{
+  const size_t half = ( m_window_size - 1 ) / 2;
+  const size_t end = m_first + m_frames.size();
+
+  std::vector< double > values;
+
+  for( size_t next = m_next; next < end && ( flush || end > next + half ); ++next )
+  {
+    const size_t lo = std::max( m_first, next > half ? next - half : 0 );
+    const size_t hi = std::min( end - 1, next + half );
+
+    // Ties keep the class of the previous frame
+    const size_t previous = ( labels.empty() ? m_track_class : labels.back() );
+
+    size_t label = no_class;
+    double label_score = 0.0;
+
+    for( size_t c = 0; c < m_class_names.size(); ++c )
+    {
+      values.clear();
+
+      for( size_t i = lo; i <= hi; ++i )
+      {
+        values.push_back( score_of( m_frames[ i - m_first ], c ) );
+      }
+
+      auto mid = values.begin() + values.size() / 2;
+      std::nth_element( values.begin(), mid, values.end() );
+
+      if( *mid > label_score ||
+          ( *mid == label_score && *mid > 0.0 && c == previous ) )
+      {
+        label = c;
+        label_score = *mid;
+      }
+    }
+
+    labels.push_back( label );
+    scores.push_back( label_score );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+frame_class_segmenter_process::priv
+::decide_hmm( bool flush, std::vector< size_t >& labels,
+              std::vector< double >& scores )
+{
+  const size_t end = m_first + m_frames.size();
+  const size_t lag = m_window_size - 1;
+
+  if( m_next >= end || ( !flush && end - m_next <= lag ) )
+  {
+    return;
+  }
+
+  // Trace the best path back from the newest frame, frames before the first
+  // classification have no class
+  std::vector< size_t > states( end - m_next, no_class );
+
+  size_t state = no_class;
+
+  if( !m_delta.empty() )
+  {
+    state = std::max_element( m_delta.begin(), m_delta.end() ) - m_delta.begin();
+  }
+
+  for( size_t i = end; i-- > m_next; )
+  {
+    frame_entry const& frame = m_frames[ i - m_first ];
+
+    if( frame.back.empty() )
+    {
+      break;
+    }
+
+    states[ i - m_next ] = state;
+    state = frame.back[ state ];
+  }
+
+  // Without flushing only frames at least the lag behind the newest are final
+  const size_t count = ( flush ? states.size() : states.size() - lag );
+
+  for( size_t i = 0; i < count; ++i )
+  {
+    labels.push_back( states[i] );
+    scores.push_back( states[i] == no_class ? 0.0 :
+      score_of( m_frames[ m_next + i - m_first ], states[i] ) );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+kv::object_track_set_sptr
+frame_class_segmenter_process::priv
+::emit( frame_entry const& frame, size_t label, double score )
+{
+  if( frame.has_box )
+  {
+    m_last_box = frame.box;
+    m_has_last_box = true;
+  }
+
+  if( label == no_class )
+  {
+    m_track.reset();
+  }
+  else if( !m_track || label != m_track_class )
+  {
+    m_track = kv::track::create();
+    m_track->set_id( m_track_counter++ );
+  }
+
+  m_track_class = label;
+
+  if( m_track && m_has_last_box )
+  {
+    auto det = std::make_shared< kv::detected_object >( m_last_box, score,
+      std::make_shared< kv::detected_object_type >(
+        m_class_names[ label ], score ) );
+
+    m_track->append(
+      std::make_shared< kv::object_track_state >( frame.ts, det ) );
+  }
+
+  std::vector< kv::track_sptr > tracks;
+
+  if( m_track && !m_track->empty() )
+  {
+    tracks.push_back( m_track );
+  }
+
+  return std::make_shared< kv::object_track_set >( tracks );
+}
+
+
+// =============================================================================
+frame_class_segmenter_process
+::frame_class_segmenter_process( kv::config_block_sptr const& config )
+  : process( config ),
+    d( new frame_class_segmenter_process::priv() )
+{
+  make_ports();
+  make_config();
+}
+
+
+frame_class_segmenter_process
+::~frame_class_segmenter_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+frame_class_segmenter_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t required;
+  sprokit::process::port_flags_t optional;
+
+  required.insert( flag_required );
+
+  // -- inputs --
+  declare_input_port_using_trait( detected_object_set, required );
+  declare_input_port_using_trait( timestamp, required );
+  declare_input_port_using_trait( image_file_name, optional );
+
+  // -- outputs --
+  declare_output_port_using_trait( object_track_set, optional );
+  declare_output_port_using_trait( timestamp, optional );
+  declare_output_port_using_trait( image_file_name, optional );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+frame_class_segmenter_process
+::make_config()
+{
+  declare_config_using_trait( smoothing );
+  declare_config_using_trait( window_size );
+  declare_config_using_trait( switch_penalty );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+frame_class_segmenter_process
+::_configure()
+{
+  const std::string smoothing = config_value_using_trait( smoothing );
+
+  if( smoothing != "median" && smoothing != "hmm" )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Invalid smoothing type: " + smoothing );
+  }
+
+  d->m_use_hmm = ( smoothing == "hmm" );
+  d->m_window_size = std::max( 1u, config_value_using_trait( window_size ) );
+  d->m_switch_penalty = config_value_using_trait( switch_penalty );
+
+  if( d->m_switch_penalty < 0.0 )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "switch_penalty must not be negative" );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+frame_class_segmenter_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  auto port_info = peek_at_port_using_trait( detected_object_set );
+  const bool complete = ( port_info.datum->type() == sprokit::datum::complete );
+
+  if( complete )
+  {
+    grab_edge_datum_using_trait( detected_object_set );
+    grab_edge_datum_using_trait( timestamp );
+
+    if( has_input_port_edge_using_trait( image_file_name ) )
+    {
+      grab_edge_datum_using_trait( image_file_name );
+    }
+  }
+  else
+  {
+    kv::detected_object_set_sptr detections =
+      grab_from_port_using_trait( detected_object_set );
+    kv::timestamp timestamp = grab_from_port_using_trait( timestamp );
+
+    std::string file_name;
+
+    if( has_input_port_edge_using_trait( image_file_name ) )
+    {
+      file_name = grab_from_port_using_trait( image_file_name );
+    }
+
+    d->add_frame( timestamp, file_name, detections );
+  }
+
+  trace.inputs_ready();
+
+  std::vector< size_t > labels;
+  std::vector< double > scores;
+
+  d->decide( complete, labels, scores );
+
+  trace.count( "frames", labels.size() );
+
+  for( size_t i = 0; i < labels.size(); ++i, ++d->m_next )
+  {
+    auto const& frame = d->m_frames[ d->m_next - d->m_first ];
+
+    push_to_port_using_trait( object_track_set,
+                              d->emit( frame, labels[i], scores[i] ) );
+    push_to_port_using_trait( timestamp, frame.ts );
+    push_to_port_using_trait( image_file_name, frame.file_name );
+  }
+
+  // Drop frames no longer inside any smoothing window
+  const size_t keep = ( d->m_use_hmm ? 0 : ( d->m_window_size - 1 ) / 2 );
+
+  while( !d->m_frames.empty() && d->m_first + keep < d->m_next )
+  {
+    d->m_frames.pop_front();
+    d->m_first++;
+  }
+
+  if( complete )
+  {
+    mark_process_as_complete();
+
+    const sprokit::datum_t dat = sprokit::datum::complete_datum();
+
+    push_datum_to_port_using_trait( object_track_set, dat );
+    push_datum_to_port_using_trait( timestamp, dat );
+    push_datum_to_port_using_trait( image_file_name, dat );
+  }
+}
+
+} // end namespace core
+
+} // end namespace viame
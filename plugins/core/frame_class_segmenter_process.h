@@ -0,0 +1,85 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Smooth per-frame classifications into class segments
+ */
+
+#ifndef VIAME_FRAME_CLASS_SEGMENTER_PROCESS_H
+#define VIAME_FRAME_CLASS_SEGMENTER_PROCESS_H
+
+#include <sprokit/pipeline/process.h>
+
+#include <plugins/core/viame_processes_core_export.h>
+
+#include <memory>
+
+namespace viame
+{
+
+namespace core
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Temporally smooth full frame classifications into class segments
+ *
+ * Class scores are smoothed over a sliding window of frames, either with a
+ * per-class median or a fixed-lag Viterbi decode penalizing class switches.
+ * Each run of frames with the same smoothed class becomes a single track, a
+ * new track ID starting whenever the class changes. Outputs lag the inputs by
+ * the smoothing window and are flushed when the input completes, one output
+ * per input frame.
+ */
+class VIAME_PROCESSES_CORE_NO_EXPORT frame_class_segmenter_process
+  : public sprokit::process
+{
+public:
+  // -- CONSTRUCTORS --
+  frame_class_segmenter_process( kwiver::vital::config_block_sptr const& config );
+  virtual ~frame_class_segmenter_process();
+
+protected:
+  virtual void _configure();
+  virtual void _step();
+
+private:
+  void make_ports();
+  void make_config();
+
+  class priv;
+  const std::unique_ptr< priv > d;
+
+}; // end class frame_class_segmenter_process
+
+} // end namespace core
+} // end namespace viame
+
+#endif // VIAME_FRAME_CLASS_SEGMENTER_PROCESS_H
@@ -0,0 +1,130 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "frame_schedule.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+namespace viame
+{
+
+namespace
+{
+
+std::mutex&
+schedule_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map< std::string, frame_schedule >&
+schedule_registry()
+{
+  static std::map< std::string, frame_schedule > registry;
+  return registry;
+}
+
+} // end anonymous namespace
+
+
+// -----------------------------------------------------------------------------
+bool
+frame_schedule
+::passes( kwiver::vital::frame_id_t frame,
+          bool has_last, kwiver::vital::frame_id_t last ) const
+{
+  if( ( max_frame || frame_step ) &&
+      ( frame < min_frame || frame > max_frame ) )
+  {
+    return false;
+  }
+
+  return !has_last || frame - last >= frame_step;
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+frame_schedule
+::next( kwiver::vital::frame_id_t frame,
+        bool has_last, kwiver::vital::frame_id_t last,
+        kwiver::vital::frame_id_t& next_frame ) const
+{
+  next_frame = frame;
+
+  if( has_last )
+  {
+    next_frame = std::max( next_frame, last + frame_step );
+  }
+
+  if( max_frame || frame_step )
+  {
+    next_frame = std::max( next_frame, min_frame );
+
+    if( next_frame > max_frame )
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+publish_frame_schedule( const std::string& name, const frame_schedule& schedule )
+{
+  std::lock_guard< std::mutex > lock( schedule_mutex() );
+  schedule_registry()[ name ] = schedule;
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+find_frame_schedule( const std::string& name, frame_schedule& schedule )
+{
+  std::lock_guard< std::mutex > lock( schedule_mutex() );
+
+  auto it = schedule_registry().find( name );
+
+  if( it == schedule_registry().end() )
+  {
+    return false;
+  }
+
+  schedule = it->second;
+  return true;
+}
+
+} // end namespace
@@ -0,0 +1,82 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Frame index schedule shared between filters and readers
+ */
+
+#ifndef VIAME_CORE_FRAME_SCHEDULE_H
+#define VIAME_CORE_FRAME_SCHEDULE_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/vital_types.h>
+
+#include <string>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Frames passed by filter_frame_index_process
+ *
+ * Frames pass when inside [min_frame, max_frame], or always when neither
+ * max_frame nor frame_step is set, and at least frame_step frames after the
+ * previously passed frame.
+ */
+struct VIAME_CORE_EXPORT frame_schedule
+{
+  kwiver::vital::frame_id_t min_frame = 0;
+  kwiver::vital::frame_id_t max_frame = 0;
+  kwiver::vital::frame_id_t frame_step = 0;
+
+  /// Whether frame passes, given the last passed frame if any
+  bool passes( kwiver::vital::frame_id_t frame,
+               bool has_last, kwiver::vital::frame_id_t last ) const;
+
+  /// First frame from frame onwards which passes, false if there is none
+  bool next( kwiver::vital::frame_id_t frame,
+             bool has_last, kwiver::vital::frame_id_t last,
+             kwiver::vital::frame_id_t& next_frame ) const;
+};
+
+/// Make a schedule available to readers under name, replacing any previous
+VIAME_CORE_EXPORT void
+publish_frame_schedule( const std::string& name, const frame_schedule& schedule );
+
+/// Look up the schedule published under name, false if there is none
+VIAME_CORE_EXPORT bool
+find_frame_schedule( const std::string& name, frame_schedule& schedule );
+
+} // end namespace
+
+#endif // VIAME_CORE_FRAME_SCHEDULE_H
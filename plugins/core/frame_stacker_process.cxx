@@ -34,17 +34,20 @@
  */
 
 #include "frame_stacker_process.h"
+#include "process_trace.h"
 
 #include <vital/vital_types.h>
 
 #include <vital/types/timestamp_config.h>
 #include <vital/types/image_container.h>
 
+#include <sprokit/pipeline/process_exception.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <sstream>
-#include <iostream>
-#include <list>
-#include <limits>
-#include <cmath>
+#include <vector>
 
 
 namespace viame
@@ -53,10 +56,16 @@ namespace viame
 namespace core
 {
 
-create_config_trait( target_frame_gap, double, "1.0",
-  "Target time gap between frames if timestamp is valid" );
-create_config_trait( target_time_gap, unsigned, "10",
+create_config_trait( stack_count, unsigned, "3",
+  "Number of frames stacked in each output image, including the current frame. "
+  "Output channels are ordered from the oldest frame to the current one." );
+create_config_trait( target_frame_gap, unsigned, "10",
   "Target frame count gap between frames if timestamp not valid" );
+create_config_trait( target_time_gap, double, "1.0",
+  "Target time gap in seconds between frames if timestamp is valid. "
+  "Set to 0 to always use the frame count gap." );
+create_config_trait( max_buffer_size, unsigned, "100",
+  "Maximum number of frames referenced when selecting frames by time gap" );
 
 //------------------------------------------------------------------------------
 // Private implementation class
@@ -66,12 +75,34 @@ public:
   priv();
   ~priv();
 
+  // Reset the ring buffer to the given capacity
+  void reset( size_t capacity );
+
+  // Add a frame to the ring buffer, overwriting the oldest one once full
+  void add( buffered_frame const& frame );
+
+  // Frame at the given distance from the newest one, clamped to the oldest
+  buffered_frame& at( size_t age );
+
+  // Frame stacked for the given slot, 0 being the current frame
+  buffered_frame& select( unsigned slot );
+
+  // Copy the selected frames into the output buffer
+  kwiver::vital::image_container_sptr stack();
+
   // Configuration values
+  unsigned m_stack_count;
   unsigned m_target_frame_gap;
   double m_target_time_gap;
+  unsigned m_max_buffer_size;
 
-  // Internal buffer
-  std::list< buffered_frame > m_frames;
+  // Fixed capacity ring buffer of frame references
+  std::vector< buffered_frame > m_frames;
+  size_t m_capacity;
+  size_t m_next;
+
+  // Output buffer, reused once downstream releases it
+  kwiver::vital::image m_output;
 };
 
 // =============================================================================
@@ -97,10 +128,35 @@ void
 frame_stacker_process
 ::_configure()
 {
+  d->m_stack_count =
+    config_value_using_trait( stack_count );
   d->m_target_frame_gap =
     config_value_using_trait( target_frame_gap );
   d->m_target_time_gap =
     config_value_using_trait( target_time_gap );
+  d->m_max_buffer_size =
+    config_value_using_trait( max_buffer_size );
+
+  if( d->m_stack_count == 0 )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception,
+                 name(), "stack_count must be at least 1" );
+  }
+
+  if( d->m_target_frame_gap == 0 )
+  {
+    d->m_target_frame_gap = 1;
+  }
+
+  // Enough history for the oldest slot at the frame gap, or the time gap
+  size_t capacity = ( d->m_stack_count - 1 ) * d->m_target_frame_gap + 1;
+
+  if( d->m_target_time_gap > 0.0 )
+  {
+    capacity = std::max< size_t >( capacity, d->m_max_buffer_size );
+  }
+
+  d->reset( capacity );
 }
 
 
@@ -109,6 +165,44 @@ void
 frame_stacker_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
+  kwiver::vital::image_container_sptr image;
+  kwiver::vital::timestamp ts;
+
+  image = grab_from_port_using_trait( image );
+
+  if( has_input_port_edge_using_trait( timestamp ) )
+  {
+    ts = grab_from_port_using_trait( timestamp );
+  }
+
+  trace.inputs_ready();
+
+  if( !image )
+  {
+    push_to_port_using_trait( image, kwiver::vital::image_container_sptr() );
+    return;
+  }
+
+  // Drop the history when the frame format changes, it can't be stacked
+  if( !d->m_frames.empty() )
+  {
+    kwiver::vital::image_container_sptr last = d->at( 0 ).image;
+
+    if( last->width() != image->width() ||
+        last->height() != image->height() ||
+        last->depth() != image->depth() ||
+        last->get_image().pixel_traits() != image->get_image().pixel_traits() )
+    {
+      LOG_WARN( logger(), "Frame format changed, resetting the frame history" );
+      d->reset( d->m_capacity );
+    }
+  }
+
+  d->add( buffered_frame( image, ts ) );
+
+  push_to_port_using_trait( image, d->stack() );
 }
 
 
@@ -137,14 +231,22 @@ void
 frame_stacker_process
 ::make_config()
 {
+  declare_config_using_trait( stack_count );
   declare_config_using_trait( target_time_gap );
   declare_config_using_trait( target_frame_gap );
+  declare_config_using_trait( max_buffer_size );
 }
 
 
 // =============================================================================
 frame_stacker_process::priv
 ::priv()
+  : m_stack_count( 3 )
+  , m_target_frame_gap( 10 )
+  , m_target_time_gap( 1.0 )
+  , m_max_buffer_size( 100 )
+  , m_capacity( 1 )
+  , m_next( 0 )
 {
 }
 
@@ -155,6 +257,156 @@ frame_stacker_process::priv
 }
 
 
+// -----------------------------------------------------------------------------
+void
+frame_stacker_process::priv
+::reset( size_t capacity )
+{
+  m_frames.clear();
+  m_frames.reserve( capacity );
+  m_capacity = capacity;
+  m_next = 0;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+frame_stacker_process::priv
+::add( buffered_frame const& frame )
+{
+  if( m_frames.size() < m_capacity )
+  {
+    m_frames.push_back( frame );
+  }
+  else
+  {
+    m_frames[ m_next ] = frame;
+  }
+
+  m_next = ( m_next + 1 ) % m_capacity;
+}
+
+
+// -----------------------------------------------------------------------------
+frame_stacker_process::buffered_frame&
+frame_stacker_process::priv
+::at( size_t age )
+{
+  const size_t count = m_frames.size();
+  age = std::min( age, count - 1 );
+
+  return m_frames[ ( m_next + m_capacity - 1 - age ) % m_capacity ];
+}
+
+
+// -----------------------------------------------------------------------------
+frame_stacker_process::buffered_frame&
+frame_stacker_process::priv
+::select( unsigned slot )
+{
+  buffered_frame& current = at( 0 );
+
+  if( slot == 0 )
+  {
+    return current;
+  }
+
+  if( m_target_time_gap <= 0.0 || !current.ts.has_valid_time() )
+  {
+    return at( static_cast< size_t >( slot ) * m_target_frame_gap );
+  }
+
+  // Newest frame at least slot time gaps older than the current one
+  const double target = current.time() - slot * m_target_time_gap * 1e6;
+
+  for( size_t age = 1; age < m_frames.size(); ++age )
+  {
+    buffered_frame& frame = at( age );
+
+    if( !frame.ts.has_valid_time() || frame.time() <= target )
+    {
+      return frame;
+    }
+  }
+
+  return at( m_frames.size() - 1 );
+}
+
+
+// -----------------------------------------------------------------------------
+kwiver::vital::image_container_sptr
+frame_stacker_process::priv
+::stack()
+{
+  kwiver::vital::image const& current = at( 0 ).image->get_image();
+
+  const size_t width = current.width();
+  const size_t height = current.height();
+  const size_t depth = current.depth();
+  const size_t bytes = current.pixel_traits().num_bytes;
+
+  // Only allocate when the previous output is still referenced downstream
+  if( m_output.width() != width ||
+      m_output.height() != height ||
+      m_output.depth() != depth * m_stack_count ||
+      m_output.pixel_traits() != current.pixel_traits() ||
+      !m_output.memory() ||
+      m_output.memory().use_count() > 1 )
+  {
+    m_output = kwiver::vital::image( width, height, depth * m_stack_count,
+                                     true, current.pixel_traits() );
+  }
+
+  auto* dst_base = static_cast< uint8_t* >( m_output.first_pixel() );
+
+  const ptrdiff_t dst_w_step = m_output.w_step() * bytes;
+  const ptrdiff_t dst_h_step = m_output.h_step() * bytes;
+  const ptrdiff_t dst_d_step = m_output.d_step() * bytes;
+
+  // Slot 0 of the output is the oldest frame
+  for( unsigned slot = 0; slot < m_stack_count; ++slot )
+  {
+    kwiver::vital::image const& src =
+      select( m_stack_count - 1 - slot ).image->get_image();
+
+    const auto* src_base = static_cast< const uint8_t* >( src.first_pixel() );
+
+    const ptrdiff_t src_w_step = src.w_step() * bytes;
+    const ptrdiff_t src_h_step = src.h_step() * bytes;
+    const ptrdiff_t src_d_step = src.d_step() * bytes;
+
+    const bool contiguous_pixels =
+      ( src.d_step() == 1 && m_output.d_step() == 1 );
+
+    for( size_t j = 0; j < height; ++j )
+    {
+      const uint8_t* src_row = src_base + j * src_h_step;
+      uint8_t* dst_row = dst_base + j * dst_h_step + slot * depth * dst_d_step;
+
+      for( size_t i = 0; i < width; ++i )
+      {
+        const uint8_t* src_pixel = src_row + i * src_w_step;
+        uint8_t* dst_pixel = dst_row + i * dst_w_step;
+
+        if( contiguous_pixels )
+        {
+          std::memcpy( dst_pixel, src_pixel, depth * bytes );
+          continue;
+        }
+
+        for( size_t k = 0; k < depth; ++k )
+        {
+          std::memcpy( dst_pixel + k * dst_d_step,
+                       src_pixel + k * src_d_step, bytes );
+        }
+      }
+    }
+  }
+
+  return std::make_shared< kwiver::vital::simple_image_container >( m_output );
+}
+
+
 } // end namespace core
 
 } // end namespace viame
@@ -34,6 +34,7 @@
  */
 
 #include "full_frame_tracker_process.h"
+#include "process_trace.h"
 
 #include <vital/vital_types.h>
 #include <vital/types/image_container.h>
@@ -54,6 +55,13 @@ namespace core
 
 create_config_trait( fixed_frame_count, unsigned, "0",
   "If set, generate a full frame track for this many frames" );
+create_config_trait( incremental, bool, "false",
+  "Keep a single track object for each full frame track and append new "
+  "states to it, instead of rebuilding the whole track on every frame. The "
+  "same track object is then output on every frame until it is complete." );
+create_config_trait( output_delta, bool, "false",
+  "Only output the state added on the current frame, as a track with the "
+  "same ID holding that single state, rather than the full track so far." );
 
 // =============================================================================
 // Private implementation class
@@ -65,11 +73,15 @@ public:
 
   // Configuration settings
   unsigned m_fixed_frame_count;
+  bool m_incremental;
+  bool m_output_delta;
 
   // Internal variables
   unsigned m_frame_counter;
   unsigned m_track_counter;
+  unsigned m_state_count;
   std::vector< kv::track_state_sptr > m_states;
+  kv::track_sptr m_track;
 
   // Other variables
   full_frame_tracker_process* parent;
@@ -80,8 +92,11 @@ public:
 full_frame_tracker_process::priv
 ::priv( full_frame_tracker_process* ptr )
   : m_fixed_frame_count( 0 )
+  , m_incremental( false )
+  , m_output_delta( false )
   , m_frame_counter( 0 )
   , m_track_counter( 1 )
+  , m_state_count( 0 )
   , parent( ptr )
 {
 }
@@ -137,6 +152,8 @@ full_frame_tracker_process
 ::make_config()
 {
   declare_config_using_trait( fixed_frame_count );
+  declare_config_using_trait( incremental );
+  declare_config_using_trait( output_delta );
 }
 
 // -----------------------------------------------------------------------------
@@ -145,6 +162,8 @@ full_frame_tracker_process
 ::_configure()
 {
   d->m_fixed_frame_count = config_value_using_trait( fixed_frame_count );
+  d->m_incremental = config_value_using_trait( incremental );
+  d->m_output_delta = config_value_using_trait( output_delta );
 }
 
 // -----------------------------------------------------------------------------
@@ -152,6 +171,8 @@ void
 full_frame_tracker_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
   kv::image_container_sptr image;
   kv::timestamp timestamp;
   kv::detected_object_set_sptr detections;
@@ -169,25 +190,68 @@ full_frame_tracker_process
     detections = grab_from_port_using_trait( detected_object_set );
   }
 
-  if( d->m_states.size() == d->m_fixed_frame_count )
+  trace.inputs_ready();
+  trace.count( "detections", detections ? detections->size() : 0 );
+
+  if( d->m_state_count == d->m_fixed_frame_count )
   {
     d->m_track_counter++;
+    d->m_state_count = 0;
     d->m_states.clear();
+    d->m_track.reset();
   }
 
-  if( detections->size() == 1 )
+  kv::track_state_sptr new_state;
+
+  if( detections && detections->size() == 1 )
   {
-    d->m_states.push_back(
-      std::make_shared< kwiver::vital::object_track_state >(
-        timestamp, detections->at( 0 ) ) );
+    new_state = std::make_shared< kwiver::vital::object_track_state >(
+      timestamp, detections->at( 0 ) );
+
+    d->m_state_count++;
   }
 
-  kv::track_sptr ot = kv::track::create();
-  ot->set_id( d->m_track_counter );
+  kv::track_sptr ot;
 
-  for( auto state : d->m_states )
+  if( d->m_output_delta )
+  {
+    ot = kv::track::create();
+    ot->set_id( d->m_track_counter );
+
+    if( new_state )
+    {
+      ot->append( new_state );
+    }
+  }
+  else if( d->m_incremental )
+  {
+    if( !d->m_track )
+    {
+      d->m_track = kv::track::create();
+      d->m_track->set_id( d->m_track_counter );
+    }
+
+    if( new_state )
+    {
+      d->m_track->append( new_state );
+    }
+
+    ot = d->m_track;
+  }
+  else
   {
-    ot->append( state );
+    if( new_state )
+    {
+      d->m_states.push_back( new_state );
+    }
+
+    ot = kv::track::create();
+    ot->set_id( d->m_track_counter );
+
+    for( auto state : d->m_states )
+    {
+      ot->append( state );
+    }
   }
 
   kv::object_track_set_sptr output(
@@ -0,0 +1,703 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of HabCam metadata parsing and indexing
+ */
+
+#include "habcam_metadata_index.h"
+
+#include "csv_file_parser.h"
+
+#include <vital/exceptions.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+#if defined( MSDOS ) || defined( WIN32 )
+  #include <fcntl.h>
+  #include <io.h>
+#else
+  #include <fcntl.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace viame
+{
+
+namespace {
+
+const char index_magic[] = "VIAMEHMI";
+const std::size_t index_magic_size = sizeof( index_magic ) - 1;
+const std::uint32_t index_version = 1;
+
+const std::uint32_t record_size =
+  sizeof( std::uint64_t ) + 2 * sizeof( std::uint32_t ) + 5 * sizeof( double );
+const std::uint64_t header_size =
+  index_magic_size + 2 * sizeof( std::uint32_t ) + 2 * sizeof( std::uint64_t );
+
+template< typename T >
+void write_binary( std::ofstream& out, const T& value )
+{
+  out.write( reinterpret_cast< const char* >( &value ), sizeof( T ) );
+}
+
+// Unaligned read from the mapped file
+template< typename T >
+T read_binary( const char* data )
+{
+  T value;
+  std::memcpy( &value, data, sizeof( T ) );
+  return value;
+}
+
+// File name without its directories, which keys the index
+std::string_view index_key( std::string_view path )
+{
+  const std::size_t pos = path.find_last_of( "/\\" );
+  return pos == std::string_view::npos ? path : path.substr( pos + 1 );
+}
+
+// 64-bit FNV-1a, stable across platforms unlike std::hash
+std::uint64_t hash_key( std::string_view key )
+{
+  std::uint64_t hash = 14695981039346656037ull;
+
+  for( const char c : key )
+  {
+    hash ^= static_cast< unsigned char >( c );
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+
+// Read JPG comments from file
+int get_jpeg_comments( FILE *f, std::string& s )
+{
+  int c, m;
+  unsigned ss;
+  s = "";
+#if defined( MSDOS ) || defined( WIN32 )
+  setmode( fileno(f), O_BINARY );
+#endif
+  if( ferror( f ) ) return -1;
+  /* A typical JPEG file has markers in these order:
+   *   d8 e0_JFIF e1 e1 e2 db db fe fe c0 c4 c4 c4 c4 da d9.
+   *   The first fe marker (COM, comment) was near offset 30000.
+   * A typical JPEG file after filtering through jpegtran:
+   *   d8 e0_JFIF fe fe db db c0 c4 c4 c4 c4 da d9.
+   *   The first fe marker (COM, comment) was at offset 20.
+   */
+  if( (c = getc(f) ) < 0 ) return -2;  /* Truncated (empty). */
+  if( c != 0xff) return -3;
+  if( ( c = getc(f) ) < 0 ) return -2;  /* Truncated. */
+  if( c != 0xd8) return -3;  /* Not a JPEG file, SOI expected. */
+
+  for( ;; )
+  {
+    /* printf("@%ld\n", ftell(f)); */
+    if( (c = getc(f) ) < 0 ) return -2;  /* Truncated. */
+    if( c != 0xff ) return -3;  /* Not a JPEG file, marker expected. */
+    if( (m = getc(f) ) < 0 ) return -2;  /* Truncated. */
+    while( m == 0xff ) {  /* Padding. */
+      if( (m = getc(f) ) < 0 ) return -2;  /* Truncated. */
+    }
+    if( m == 0xd8 ) return -4;  /* SOI unexpected. */
+    if( m == 0xd9 ) break;  /* EOI. */
+    if( m == 0xda ) break;  /* SOS. Would need special escaping to process. */
+    /* printf("MARKER 0x%02x\n", m); */
+    if( (c = getc(f)) < 0 ) return -2;  /* Truncated. */
+    ss = (c + 0U) << 8;
+    if( (c = getc(f)) < 0 ) return -2;  /* Truncated. */
+    ss += c;
+    if( ss < 2 ) return -5;  /* Segment too short. */
+    ss -= 2;
+    if( m == 0xfe ) {  /* Emit comment in one read. */
+      std::size_t start = s.size();
+      s.resize( start + ss );
+      if( fread( &s[start], 1, ss, f ) != ss ) return -2;  /* Truncated. */
+      s+='\n';  /* End of comment. */
+    }
+    else if( ss > 0 && fseek( f, ss, SEEK_CUR ) ) {  /* Skip other segments. */
+      return -2;  /* Truncated. */
+    }
+  }
+  return 0;
+}
+
+
+// Read at most the last length bytes of a file, without reading the rest of it
+bool read_file_tail( std::string const& file_name, std::size_t length, std::string& tail )
+{
+  tail.clear();
+#if defined( MSDOS ) || defined( WIN32 )
+  std::ifstream fin( file_name.c_str(), std::ios::binary | std::ios::ate );
+
+  if( !fin )
+  {
+    return false;
+  }
+
+  std::streamoff size = fin.tellg();
+  std::streamoff count = std::min< std::streamoff >( size, length );
+  tail.resize( static_cast< std::size_t >( count ) );
+  fin.seekg( size - count );
+  fin.read( &tail[0], count );
+  return static_cast< bool >( fin ) || count == 0;
+#else
+  int fd = open( file_name.c_str(), O_RDONLY );
+
+  if( fd < 0 )
+  {
+    return false;
+  }
+
+  struct stat st;
+  bool success = ( fstat( fd, &st ) == 0 );
+
+  if( success )
+  {
+    std::size_t size = static_cast< std::size_t >( st.st_size );
+    std::size_t count = std::min( size, length );
+    tail.resize( count );
+
+    // A single positioned read of the window, which matters on network drives
+    std::size_t done = 0;
+    while( success && done < count )
+    {
+      ssize_t result = pread( fd, &tail[done], count - done, size - count + done );
+      success = ( result > 0 );
+      done += success ? static_cast< std::size_t >( result ) : 0;
+    }
+  }
+
+  close( fd );
+  return success;
+#endif
+}
+
+
+// Value of a "field=value" token, where token spans [begin, end)
+bool parse_field( const char* begin, const char* end, const char* field, double& value )
+{
+  const std::size_t field_length = std::strlen( field );
+
+  if( static_cast< std::size_t >( end - begin ) <= field_length ||
+      std::strncmp( begin, field, field_length ) != 0 || begin[ field_length ] != '=' )
+  {
+    return false;
+  }
+
+  const char* str_val = begin + field_length + 1;
+  const std::size_t val_length = end - str_val;
+
+  if( val_length == 6 && std::strncmp( str_val, "-99.99", 6 ) == 0 )
+  {
+    return false;
+  }
+
+  // The value is delimited by the end of the token, copy it to terminate it
+  char buffer[64];
+  const std::size_t copied = std::min( val_length, sizeof( buffer ) - 1 );
+  std::memcpy( buffer, str_val, copied );
+  buffer[ copied ] = '\0';
+
+  char* parsed = nullptr;
+  value = std::strtod( buffer, &parsed );
+  return parsed != buffer;
+}
+
+
+bool ends_with( std::string const &input, std::string const &ending )
+{
+  if( input.length() >= ending.length() )
+  {
+    return ( 0 == input.compare(input.length() - ending.length(), ending.length(), ending) );
+  }
+  else
+  {
+    return false;
+  }
+}
+
+
+bool is_tiff( std::string const &file_name )
+{
+  return ends_with( file_name, ".tif" ) || ends_with( file_name, ".tiff" ) ||
+         ends_with( file_name, ".TIF" ) || ends_with( file_name, ".TIFF" );
+}
+
+
+void tokenize( const std::string ascii_snippet, std::vector< std::string >& tokens )
+{
+  std::stringstream ss( ascii_snippet );
+  std::string line;
+  const std::string delims = "\n\t\v ,";
+  tokens.clear();
+
+  while( std::getline( ss, line ) )
+  {
+    std::size_t prev = 0, pos;
+    while( ( pos = line.find_first_of( delims, prev ) ) != std::string::npos )
+    {
+      if( pos > prev )
+      {
+        std::string token = line.substr( prev, pos-prev );
+        if( !token.empty() )
+        {
+          tokens.push_back( token );
+        }
+      }
+      prev = pos + 1;
+    }
+    if( prev < line.length() )
+    {
+      std::string token = line.substr( prev, std::string::npos );
+      if( !token.empty() )
+      {
+        tokens.push_back( token );
+      }
+    }
+  }
+}
+
+} // end anonymous namespace
+
+
+// =============================================================================
+bool
+read_habcam_image_metadata( std::string const& file_name,
+                            std::size_t scan_length,
+                            habcam_metadata& metadata )
+{
+  metadata = habcam_metadata();
+
+  if( is_tiff( file_name ) )
+  {
+    std::string ascii_snippet;
+
+    if( !read_file_tail( file_name, scan_length, ascii_snippet ) )
+    {
+      throw std::runtime_error( "Unable to load: " + file_name );
+    }
+
+    auto meta_start = ascii_snippet.find( "pixelformat=" );
+
+    if( meta_start == std::string::npos )
+    {
+      return false;
+    }
+
+    // Walk the tokens in place rather than copying them out of the snippet
+    static const char* delims = "\n\t\v ,";
+    const char* pos = ascii_snippet.c_str() + meta_start;
+    const char* end = ascii_snippet.c_str() + ascii_snippet.size();
+
+    while( pos < end )
+    {
+      const char* token_end = pos;
+      while( token_end < end && *token_end != '\0' && !std::strchr( delims, *token_end ) )
+      {
+        ++token_end;
+      }
+
+      double value;
+
+      if( parse_field( pos, token_end, "hdg", value ) )
+      {
+        metadata.yaw = value;
+        metadata.fields |= habcam_metadata::has_yaw;
+      }
+      if( parse_field( pos, token_end, "pitch", value ) )
+      {
+        metadata.pitch = value;
+        metadata.fields |= habcam_metadata::has_pitch;
+      }
+      if( parse_field( pos, token_end, "roll", value ) )
+      {
+        metadata.roll = value;
+        metadata.fields |= habcam_metadata::has_roll;
+      }
+      if( parse_field( pos, token_end, "alt0", value ) ||
+          parse_field( pos, token_end, "alt1", value ) )
+      {
+        metadata.altitude = value;
+        metadata.fields |= habcam_metadata::has_altitude;
+      }
+
+      pos = token_end + 1;
+    }
+  }
+  else
+  {
+    std::string ascii_snippet;
+    FILE *fin = fopen( file_name.c_str(), "rb" );
+
+    if( !fin )
+    {
+      throw std::runtime_error( "Unable to load: " + file_name );
+    }
+
+    const int comment_status = get_jpeg_comments( fin, ascii_snippet );
+    fclose( fin );
+
+    if( comment_status ) // Note: returns 0 on success
+    {
+      throw std::runtime_error( "Unable to read metadata from: " + file_name );
+    }
+
+    std::vector< std::string > tokens;
+    tokenize( ascii_snippet, tokens );
+
+    int image_id_ind = -1;
+
+    for( int i = 0; i < static_cast<int>( tokens.size() ); ++i )
+    {
+      if( is_tiff( tokens[i] ) )
+      {
+        image_id_ind = i;
+        break;
+      }
+    }
+
+    if( image_id_ind < 0 )
+    {
+      throw std::runtime_error( "TIF image file string not found in: " + file_name );
+    }
+
+    if( image_id_ind + 6 <= static_cast<int>( tokens.size() ) )
+    {
+      metadata.altitude = std::stod( tokens[ image_id_ind + 2 ] );
+      metadata.yaw = std::stod( tokens[ image_id_ind + 3 ] );
+      metadata.pitch = std::stod( tokens[ image_id_ind + 4 ] );
+      metadata.roll = std::stod( tokens[ image_id_ind + 5 ] );
+      metadata.fields |= habcam_metadata::has_altitude | habcam_metadata::has_yaw |
+                         habcam_metadata::has_pitch | habcam_metadata::has_roll;
+    }
+    else
+    {
+      throw std::runtime_error( "Insufficient metadata fields in " + file_name );
+    }
+  }
+
+  return true;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+compute_habcam_gsd( habcam_metadata& metadata, double focal_length )
+{
+  if( focal_length <= 0.0 || !metadata.has( habcam_metadata::has_altitude ) ||
+      metadata.altitude <= 0.0 )
+  {
+    return;
+  }
+
+  const double deg_to_rad = std::acos( -1.0 ) / 180.0;
+  double range = metadata.altitude;
+
+  if( metadata.has( habcam_metadata::has_pitch ) &&
+      metadata.has( habcam_metadata::has_roll ) )
+  {
+    const double tilt = std::cos( metadata.pitch * deg_to_rad ) *
+                        std::cos( metadata.roll * deg_to_rad );
+
+    if( tilt > 0.0 )
+    {
+      range /= tilt;
+    }
+  }
+
+  metadata.gsd = range / focal_length;
+  metadata.fields |= habcam_metadata::has_gsd;
+}
+
+
+// -----------------------------------------------------------------------------
+std::size_t
+write_habcam_metadata_index(
+  std::string const& filename,
+  std::vector< std::pair< std::string, habcam_metadata > > const& entries )
+{
+  // Keep the first entry of every name, in input order
+  std::vector< std::size_t > kept;
+  std::unordered_set< std::string_view > seen;
+
+  kept.reserve( entries.size() );
+
+  for( std::size_t i = 0; i < entries.size(); ++i )
+  {
+    if( seen.insert( index_key( entries[i].first ) ).second )
+    {
+      kept.push_back( i );
+    }
+  }
+
+  if( kept.size() >= std::numeric_limits< std::uint32_t >::max() )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Too many images for a metadata index: " + filename );
+  }
+
+  // At most half of the buckets are used, which keeps probe sequences short
+  std::uint64_t bucket_count = 2;
+
+  while( bucket_count < 2 * kept.size() )
+  {
+    bucket_count *= 2;
+  }
+
+  std::vector< std::uint32_t > buckets( bucket_count, 0 );
+
+  for( std::size_t r = 0; r < kept.size(); ++r )
+  {
+    std::uint64_t b = hash_key( index_key( entries[ kept[r] ].first ) ) & ( bucket_count - 1 );
+
+    while( buckets[b] != 0 )
+    {
+      b = ( b + 1 ) & ( bucket_count - 1 );
+    }
+    buckets[b] = static_cast< std::uint32_t >( r + 1 );
+  }
+
+  std::ofstream out( filename, std::ios::binary );
+
+  if( !out )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Unable to open metadata index for writing: " + filename );
+  }
+
+  const std::uint64_t count = kept.size();
+
+  out.write( index_magic, index_magic_size );
+  write_binary( out, index_version );
+  write_binary( out, record_size );
+  write_binary( out, count );
+  write_binary( out, bucket_count );
+  out.write( reinterpret_cast< const char* >( buckets.data() ),
+             buckets.size() * sizeof( std::uint32_t ) );
+
+  std::uint64_t name_offset = 0;
+
+  for( const std::size_t i : kept )
+  {
+    const std::string_view name = index_key( entries[i].first );
+    const habcam_metadata& md = entries[i].second;
+
+    write_binary( out, name_offset );
+    write_binary( out, static_cast< std::uint32_t >( name.size() ) );
+    write_binary( out, md.fields );
+    write_binary( out, md.altitude );
+    write_binary( out, md.yaw );
+    write_binary( out, md.pitch );
+    write_binary( out, md.roll );
+    write_binary( out, md.gsd );
+
+    name_offset += name.size();
+  }
+
+  for( const std::size_t i : kept )
+  {
+    const std::string_view name = index_key( entries[i].first );
+    out.write( name.data(), name.size() );
+  }
+
+  if( !out.flush() )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Unable to write metadata index: " + filename );
+  }
+
+  return entries.size() - kept.size();
+}
+
+
+// =============================================================================
+class habcam_metadata_index::priv
+{
+public:
+  std::unique_ptr< csv_file_view > m_file;
+
+  std::uint64_t m_count = 0;
+  std::uint64_t m_bucket_count = 0;
+
+  const char* m_buckets = nullptr;
+  const char* m_records = nullptr;
+  const char* m_names = nullptr;
+  std::uint64_t m_names_size = 0;
+};
+
+
+// -----------------------------------------------------------------------------
+habcam_metadata_index
+::habcam_metadata_index()
+  : d( new priv() )
+{
+}
+
+
+habcam_metadata_index
+::~habcam_metadata_index()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+habcam_metadata_index
+::open( std::string const& filename )
+{
+  d.reset( new priv() );
+
+  std::ifstream fin( filename, std::ios::binary );
+
+  if( !fin )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Unable to open metadata index: " + filename );
+  }
+
+  std::unique_ptr< csv_file_view > file( new csv_file_view( filename, fin ) );
+  const std::string_view data = file->data();
+
+  if( data.size() < header_size ||
+      std::memcmp( data.data(), index_magic, index_magic_size ) != 0 )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Not a HabCam metadata index: " + filename );
+  }
+
+  const char* pos = data.data() + index_magic_size;
+
+  const auto version = read_binary< std::uint32_t >( pos );
+  const auto size = read_binary< std::uint32_t >( pos + sizeof( std::uint32_t ) );
+
+  if( version != index_version || size != record_size )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Unsupported metadata index version in: " + filename );
+  }
+
+  pos += 2 * sizeof( std::uint32_t );
+  const auto count = read_binary< std::uint64_t >( pos );
+  const auto bucket_count = read_binary< std::uint64_t >( pos + sizeof( std::uint64_t ) );
+
+  const std::uint64_t available = data.size() - header_size;
+
+  if( bucket_count == 0 || ( bucket_count & ( bucket_count - 1 ) ) != 0 ||
+      bucket_count <= count || bucket_count > available / sizeof( std::uint32_t ) ||
+      count > ( available - bucket_count * sizeof( std::uint32_t ) ) / record_size )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Invalid metadata index header in: " + filename );
+  }
+
+  d->m_count = count;
+  d->m_bucket_count = bucket_count;
+  d->m_buckets = data.data() + header_size;
+  d->m_records = d->m_buckets + bucket_count * sizeof( std::uint32_t );
+  d->m_names = d->m_records + count * record_size;
+  d->m_names_size = data.data() + data.size() - d->m_names;
+  d->m_file = std::move( file );
+}
+
+
+// -----------------------------------------------------------------------------
+std::size_t
+habcam_metadata_index
+::size() const
+{
+  return d->m_count;
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+habcam_metadata_index
+::find( std::string_view image_name, habcam_metadata& metadata ) const
+{
+  if( d->m_count == 0 )
+  {
+    return false;
+  }
+
+  const std::string_view key = index_key( image_name );
+  const std::uint64_t mask = d->m_bucket_count - 1;
+
+  std::uint64_t b = hash_key( key ) & mask;
+
+  // The table is never full, so probe sequences end on an empty bucket
+  for( std::uint64_t probe = 0; probe < d->m_bucket_count; ++probe, b = ( b + 1 ) & mask )
+  {
+    const auto entry = read_binary< std::uint32_t >(
+      d->m_buckets + b * sizeof( std::uint32_t ) );
+
+    if( entry == 0 || entry > d->m_count )
+    {
+      return false;
+    }
+
+    const char* record = d->m_records + std::uint64_t( entry - 1 ) * record_size;
+    const auto name_offset = read_binary< std::uint64_t >( record );
+    const auto name_length = read_binary< std::uint32_t >( record + 8 );
+
+    if( name_length != key.size() || name_offset > d->m_names_size ||
+        name_length > d->m_names_size - name_offset ||
+        std::memcmp( d->m_names + name_offset, key.data(), key.size() ) != 0 )
+    {
+      continue;
+    }
+
+    metadata.fields = read_binary< std::uint32_t >( record + 12 );
+    metadata.altitude = read_binary< double >( record + 16 );
+    metadata.yaw = read_binary< double >( record + 24 );
+    metadata.pitch = read_binary< double >( record + 32 );
+    metadata.roll = read_binary< double >( record + 40 );
+    metadata.gsd = read_binary< double >( record + 48 );
+    return true;
+  }
+
+  return false;
+}
+
+} // end namespace viame
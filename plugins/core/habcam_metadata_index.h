@@ -0,0 +1,161 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Parsing of HabCam image metadata and its archive-level index
+ *
+ * The index is a sidecar file written once for a whole archive, so that
+ * pipelines can look up the metadata of an image without opening it. All
+ * values are in native (little endian) byte order:
+ *
+ *   char[8]   magic "VIAMEHMI"
+ *   uint32    format version, currently 1
+ *   uint32    record size in bytes, currently 56
+ *   uint64    number of records
+ *   uint64    number of hash buckets, a power of two
+ *   buckets   uint32 record index + 1 of every bucket, 0 when empty
+ *   records   one per image:
+ *     uint64    offset of the image name in the name characters
+ *     uint32    image name length
+ *     uint32    habcam_metadata field flags
+ *     double[5] altitude, yaw, pitch, roll and gsd
+ *   chars     image name characters
+ *
+ * Images are keyed by file name without directories, and the buckets form
+ * an open addressing table over the FNV-1a hash of that name. A lookup thus
+ * probes a few buckets of the memory-mapped file, and opening an index does
+ * not depend on the size of the archive.
+ */
+
+#ifndef VIAME_CORE_HABCAM_METADATA_INDEX_H
+#define VIAME_CORE_HABCAM_METADATA_INDEX_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Navigation metadata of a single HabCam image
+ */
+struct VIAME_CORE_EXPORT habcam_metadata
+{
+  enum field : std::uint32_t
+  {
+    has_altitude = 0x1,
+    has_yaw      = 0x2,
+    has_pitch    = 0x4,
+    has_roll     = 0x8,
+    has_gsd      = 0x10
+  };
+
+  /// Bitwise or of the field flags present
+  std::uint32_t fields = 0;
+
+  double altitude = 0.0;
+  double yaw = 0.0;
+  double pitch = 0.0;
+  double roll = 0.0;
+
+  /// Ground sample distance, in altitude units per pixel
+  double gsd = -1.0;
+
+  bool has( field f ) const { return ( fields & f ) != 0; }
+};
+
+
+// -----------------------------------------------------------------------------
+/// Parse the metadata embedded in a HabCam image. TIFF images are searched for
+/// a "pixelformat=" block in their last scan_length bytes, and JPEG images for
+/// the fields following the source TIFF name in their comments. Returns false
+/// for TIFF images without any metadata block, and throws std::runtime_error
+/// if the file cannot be read or its metadata is malformed.
+VIAME_CORE_EXPORT bool
+read_habcam_image_metadata( std::string const& file_name,
+                            std::size_t scan_length,
+                            habcam_metadata& metadata );
+
+// -----------------------------------------------------------------------------
+/// Set the ground sample distance of a nadir camera from the altitude, given
+/// the focal length in pixels. When known, pitch and roll in degrees are used
+/// to correct the altitude to the range along the optical axis. Nothing is
+/// set without an altitude or a positive focal length.
+VIAME_CORE_EXPORT void
+compute_habcam_gsd( habcam_metadata& metadata, double focal_length );
+
+// -----------------------------------------------------------------------------
+/// Write an index of image metadata, keyed by the file name of each image
+/// without its directories. Images sharing a file name keep the first entry.
+/// Returns the number of such duplicates, throws if the file can't be written.
+VIAME_CORE_EXPORT std::size_t
+write_habcam_metadata_index(
+  std::string const& filename,
+  std::vector< std::pair< std::string, habcam_metadata > > const& entries );
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Constant time lookups of image metadata in an index file
+ */
+class VIAME_CORE_EXPORT habcam_metadata_index
+{
+public:
+  habcam_metadata_index();
+  ~habcam_metadata_index();
+
+  habcam_metadata_index( habcam_metadata_index const& ) = delete;
+  habcam_metadata_index& operator=( habcam_metadata_index const& ) = delete;
+
+  /// Map an index file and validate its header, throws on invalid files
+  void open( std::string const& filename );
+
+  /// Number of images in the index
+  std::size_t size() const;
+
+  /// Metadata of an image, given its file name with or without directories
+  bool find( std::string_view image_name, habcam_metadata& metadata ) const;
+
+private:
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+} // end namespace
+
+#endif // VIAME_CORE_HABCAM_METADATA_INDEX_H
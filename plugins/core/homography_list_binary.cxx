@@ -0,0 +1,369 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * \file
+ * \brief Implementation of the binary homography lists
+ */
+
+#include "homography_list_binary.h"
+
+#include <vital/exceptions.h>
+
+#include <cstring>
+
+namespace viame
+{
+
+namespace {
+
+const char homography_magic[] = "VIAMEHOM";
+const std::size_t homography_magic_size = sizeof( homography_magic ) - 1;
+const std::uint32_t homography_version = 1;
+
+const std::uint32_t record_has_homography = 0x1;
+const std::uint32_t record_size = 4 * sizeof( std::uint32_t ) + 9 * sizeof( double );
+
+const std::uint64_t header_size = homography_magic_size + 2 * sizeof( std::uint32_t );
+const std::uint64_t trailer_size = homography_magic_size + 2 * sizeof( std::uint64_t );
+
+template< typename T >
+void write_binary( std::ofstream& out, const T& value )
+{
+  out.write( reinterpret_cast< const char* >( &value ), sizeof( T ) );
+}
+
+template< typename T >
+void read_binary( std::ifstream& in, T& value )
+{
+  in.read( reinterpret_cast< char* >( &value ), sizeof( T ) );
+}
+
+} // end anonymous namespace
+
+
+// =============================================================================
+homography_list_writer
+::homography_list_writer()
+  : m_count( 0 )
+{
+}
+
+
+homography_list_writer
+::~homography_list_writer()
+{
+  try
+  {
+    close();
+  }
+  catch( ... )
+  {
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+homography_list_writer
+::open( std::string const& filename )
+{
+  close();
+
+  m_filename = filename;
+  m_count = 0;
+  m_strings.clear();
+  m_string_ids.clear();
+  m_sources.clear();
+
+  m_out.open( filename, std::ios::binary );
+
+  if( !m_out )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Unable to open homography list for writing: " + filename );
+  }
+
+  m_out.write( homography_magic, homography_magic_size );
+  write_binary( m_out, homography_version );
+  write_binary( m_out, record_size );
+}
+
+
+// -----------------------------------------------------------------------------
+std::uint32_t
+homography_list_writer
+::intern( std::string const& str )
+{
+  auto itr = m_string_ids.find( str );
+
+  if( itr != m_string_ids.end() )
+  {
+    return itr->second;
+  }
+
+  const std::uint32_t id = static_cast< std::uint32_t >( m_strings.size() );
+  m_strings.push_back( str );
+  m_string_ids[ str ] = id;
+  return id;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+homography_list_writer
+::add( std::string const& source, std::string const& dest,
+       kwiver::vital::matrix_3x3d const* homography )
+{
+  const std::uint32_t source_id = intern( source );
+  const std::uint32_t dest_id = intern( dest );
+  const std::uint32_t flags = ( homography ? record_has_homography : 0 );
+  const std::uint32_t padding = 0;
+
+  write_binary( m_out, source_id );
+  write_binary( m_out, dest_id );
+  write_binary( m_out, flags );
+  write_binary( m_out, padding );
+
+  for( unsigned r = 0; r < 3; ++r )
+  {
+    for( unsigned c = 0; c < 3; ++c )
+    {
+      const double value = ( homography ? ( *homography )( r, c ) : ( r == c ? 1.0 : 0.0 ) );
+      write_binary( m_out, value );
+    }
+  }
+
+  m_sources.push_back( source_id );
+  ++m_count;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+homography_list_writer
+::close()
+{
+  if( !m_out.is_open() )
+  {
+    return;
+  }
+
+  const std::uint64_t strings_offset = header_size + m_count * record_size;
+
+  std::vector< std::uint64_t > string_offsets( 1, 0 );
+  std::string string_data;
+
+  for( auto const& str : m_strings )
+  {
+    string_data += str;
+    string_offsets.push_back( string_data.size() );
+  }
+
+  write_binary( m_out, static_cast< std::uint64_t >( m_strings.size() ) );
+  m_out.write( reinterpret_cast< const char* >( string_offsets.data() ),
+               string_offsets.size() * sizeof( std::uint64_t ) );
+  m_out.write( string_data.data(), string_data.size() );
+  m_out.write( reinterpret_cast< const char* >( m_sources.data() ),
+               m_sources.size() * sizeof( std::uint32_t ) );
+
+  m_out.write( homography_magic, homography_magic_size );
+  write_binary( m_out, m_count );
+  write_binary( m_out, strings_offset );
+
+  const bool failed = !m_out;
+  m_out.close();
+
+  if( failed )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Failed to write homography list: " + m_filename );
+  }
+}
+
+
+// =============================================================================
+homography_list_reader
+::homography_list_reader()
+  : m_count( 0 )
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+homography_list_reader
+::open( std::string const& filename )
+{
+  m_filename = filename;
+  m_count = 0;
+  m_strings.clear();
+  m_source_index.clear();
+
+  if( m_in.is_open() )
+  {
+    m_in.close();
+  }
+
+  m_in.open( filename, std::ios::binary );
+
+  char magic[ homography_magic_size ];
+  std::uint32_t version = 0, size = 0;
+
+  if( !m_in || !m_in.read( magic, homography_magic_size ) ||
+      std::memcmp( magic, homography_magic, homography_magic_size ) != 0 )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Not a binary homography list: " + filename );
+  }
+
+  read_binary( m_in, version );
+  read_binary( m_in, size );
+
+  if( !m_in || version != homography_version || size != record_size )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Unsupported homography list version in: " + filename );
+  }
+
+  // The trailer locates the string table and index
+  std::uint64_t strings_offset = 0;
+
+  m_in.seekg( -static_cast< std::streamoff >( trailer_size ), std::ios::end );
+
+  if( !m_in.read( magic, homography_magic_size ) ||
+      std::memcmp( magic, homography_magic, homography_magic_size ) != 0 )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Incomplete homography list: " + filename );
+  }
+
+  read_binary( m_in, m_count );
+  read_binary( m_in, strings_offset );
+
+  if( !m_in || strings_offset != header_size + m_count * record_size )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Invalid homography list trailer in: " + filename );
+  }
+
+  m_in.seekg( strings_offset );
+
+  std::uint64_t string_count = 0;
+  read_binary( m_in, string_count );
+
+  std::vector< std::uint64_t > string_offsets( m_in ? string_count + 1 : 0 );
+  m_in.read( reinterpret_cast< char* >( string_offsets.data() ),
+             string_offsets.size() * sizeof( std::uint64_t ) );
+
+  std::string string_data( m_in ? string_offsets.back() : 0, '\0' );
+  m_in.read( &string_data[0], string_data.size() );
+
+  std::vector< std::uint32_t > sources( m_in ? m_count : 0 );
+  m_in.read( reinterpret_cast< char* >( sources.data() ),
+             sources.size() * sizeof( std::uint32_t ) );
+
+  if( !m_in )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Invalid homography list string table in: " + filename );
+  }
+
+  for( std::uint64_t i = 0; i < string_count; ++i )
+  {
+    m_strings.push_back( string_data.substr(
+      string_offsets[ i ], string_offsets[ i + 1 ] - string_offsets[ i ] ) );
+  }
+
+  for( size_t i = 0; i < sources.size(); ++i )
+  {
+    if( sources[ i ] >= m_strings.size() )
+    {
+      VITAL_THROW( kwiver::vital::invalid_data,
+                   "Invalid homography list index in: " + filename );
+    }
+
+    m_source_index.emplace( m_strings[ sources[ i ] ], i );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+homography_list_record
+homography_list_reader
+::record( size_t index )
+{
+  if( index >= m_count )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Homography list record out of range" );
+  }
+
+  m_in.clear();
+  m_in.seekg( header_size + index * record_size );
+
+  std::uint32_t source_id = 0, dest_id = 0, flags = 0, padding = 0;
+  read_binary( m_in, source_id );
+  read_binary( m_in, dest_id );
+  read_binary( m_in, flags );
+  read_binary( m_in, padding );
+
+  homography_list_record output;
+
+  for( unsigned r = 0; r < 3; ++r )
+  {
+    for( unsigned c = 0; c < 3; ++c )
+    {
+      read_binary( m_in, output.homography( r, c ) );
+    }
+  }
+
+  if( !m_in || source_id >= m_strings.size() || dest_id >= m_strings.size() )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Invalid homography list record in: " + m_filename );
+  }
+
+  output.source = m_strings[ source_id ];
+  output.dest = m_strings[ dest_id ];
+  output.valid = ( ( flags & record_has_homography ) != 0 );
+  return output;
+}
+
+
+// -----------------------------------------------------------------------------
+size_t
+homography_list_reader
+::find_source( std::string const& source ) const
+{
+  auto itr = m_source_index.find( source );
+  return ( itr == m_source_index.end() ? size() : itr->second );
+}
+
+} // end namespace
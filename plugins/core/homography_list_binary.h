@@ -0,0 +1,159 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Indexed binary storage of homography lists
+ *
+ * Binary counterpart of the text lists of write_homography_list_process,
+ * with all values in native (little endian) byte order:
+ *
+ *   char[8]   magic "VIAMEHOM"
+ *   uint32    format version, currently 1
+ *   uint32    record size in bytes, currently 88
+ *   records   one per written frame, in output order:
+ *     uint32    source string index
+ *     uint32    destination string index
+ *     uint32    flags, 1 when the record holds a homography
+ *     uint32    padding
+ *     double[9] homography, row major, identity without a match
+ *   strings   string table, written on close:
+ *     uint64    number of strings
+ *     uint64    count + 1 offsets into the string characters
+ *     chars     string characters
+ *   index     uint32 source string index of every record
+ *   char[8]   trailer magic "VIAMEHOM"
+ *   uint64    number of records
+ *   uint64    byte offset of the string table from the file start
+ *
+ * Records have a fixed size, so the homography of any frame can be read
+ * without parsing the preceding ones, and the index locates the frame of an
+ * image without reading the records.
+ */
+
+#ifndef VIAME_CORE_HOMOGRAPHY_LIST_BINARY_H
+#define VIAME_CORE_HOMOGRAPHY_LIST_BINARY_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/types/matrix.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief One frame of a homography list
+ */
+struct VIAME_CORE_EXPORT homography_list_record
+{
+  std::string source;
+  std::string dest;
+
+  /// False for frames output without a match
+  bool valid;
+  kwiver::vital::matrix_3x3d homography;
+};
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Streaming writer of binary homography lists
+ */
+class VIAME_CORE_EXPORT homography_list_writer
+{
+public:
+  homography_list_writer();
+  ~homography_list_writer();
+
+  /// Start a new file, throws if it cannot be opened
+  void open( std::string const& filename );
+
+  /// Append the record of a frame, a null homography marking no match
+  void add( std::string const& source, std::string const& dest,
+            kwiver::vital::matrix_3x3d const* homography );
+
+  /// Write the string table and trailer, also done on destruction
+  void close();
+
+  bool is_open() const { return m_out.is_open(); }
+
+private:
+  std::uint32_t intern( std::string const& str );
+
+  std::string m_filename;
+  std::ofstream m_out;
+  std::uint64_t m_count;
+
+  std::vector< std::string > m_strings;
+  std::unordered_map< std::string, std::uint32_t > m_string_ids;
+  std::vector< std::uint32_t > m_sources;
+};
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Random access reader of binary homography lists
+ */
+class VIAME_CORE_EXPORT homography_list_reader
+{
+public:
+  homography_list_reader();
+
+  /// Open a file and load its string table, throws on invalid files
+  void open( std::string const& filename );
+
+  /// Number of records
+  size_t size() const { return m_count; }
+
+  /// Record of the given frame, read directly from its file position
+  homography_list_record record( size_t index );
+
+  /// Index of the first record with the given source, or size() if none
+  size_t find_source( std::string const& source ) const;
+
+private:
+  std::string m_filename;
+  std::ifstream m_in;
+  std::uint64_t m_count;
+
+  std::vector< std::string > m_strings;
+  std::unordered_map< std::string, size_t > m_source_index;
+};
+
+} // end namespace
+
+#endif // VIAME_CORE_HOMOGRAPHY_LIST_BINARY_H
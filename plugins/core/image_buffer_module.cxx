@@ -0,0 +1,240 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Python module sharing image memory with numpy without copies
+ *
+ * Arrays returned by as_array view the pixels of an image container and keep
+ * its memory alive, while from_array wraps an array in an image container
+ * referencing it. Torch tensors and other DLPack consumers can in turn wrap
+ * the numpy arrays without copying.
+ */
+
+#include <vital/types/image_container.h>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include <vector>
+
+namespace py = pybind11;
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+namespace
+{
+
+// -----------------------------------------------------------------------------
+py::dtype
+pixel_dtype( kv::image_pixel_traits const& traits )
+{
+  switch( traits.type )
+  {
+    case kv::image_pixel_traits::UNSIGNED:
+      switch( traits.num_bytes )
+      {
+        case 1: return py::dtype::of< uint8_t >();
+        case 2: return py::dtype::of< uint16_t >();
+        case 4: return py::dtype::of< uint32_t >();
+        case 8: return py::dtype::of< uint64_t >();
+      }
+      break;
+    case kv::image_pixel_traits::SIGNED:
+      switch( traits.num_bytes )
+      {
+        case 1: return py::dtype::of< int8_t >();
+        case 2: return py::dtype::of< int16_t >();
+        case 4: return py::dtype::of< int32_t >();
+        case 8: return py::dtype::of< int64_t >();
+      }
+      break;
+    case kv::image_pixel_traits::FLOAT:
+      switch( traits.num_bytes )
+      {
+        case 4: return py::dtype::of< float >();
+        case 8: return py::dtype::of< double >();
+      }
+      break;
+    case kv::image_pixel_traits::BOOL:
+      return py::dtype::of< bool >();
+    default:
+      break;
+  }
+
+  throw py::type_error( "Unsupported image pixel type" );
+}
+
+// -----------------------------------------------------------------------------
+kv::image_pixel_traits
+array_pixel_traits( py::dtype const& dtype )
+{
+  const size_t bytes = static_cast< size_t >( dtype.itemsize() );
+
+  switch( dtype.kind() )
+  {
+    case 'u':
+      return kv::image_pixel_traits( kv::image_pixel_traits::UNSIGNED, bytes );
+    case 'i':
+      return kv::image_pixel_traits( kv::image_pixel_traits::SIGNED, bytes );
+    case 'f':
+      return kv::image_pixel_traits( kv::image_pixel_traits::FLOAT, bytes );
+    case 'b':
+      return kv::image_pixel_traits( kv::image_pixel_traits::BOOL, bytes );
+  }
+
+  throw py::type_error( "Unsupported array dtype for an image" );
+}
+
+// -----------------------------------------------------------------------------
+// Image memory owned by a numpy array, released with the GIL held since the
+// last reference may be dropped from any pipeline thread
+class array_image_memory : public kv::image_memory
+{
+public:
+  explicit array_image_memory( py::array const& array )
+    : m_array( array.ptr() )
+  {
+    Py_INCREF( m_array );
+
+    this->data_ = const_cast< void* >( array.data() );
+    this->size_ = static_cast< size_t >( array.nbytes() );
+  }
+
+  ~array_image_memory() override
+  {
+    // The data belongs to the array, not to the base class
+    this->data_ = nullptr;
+    this->size_ = 0;
+
+    py::gil_scoped_acquire gil;
+    Py_DECREF( m_array );
+  }
+
+private:
+  PyObject* m_array;
+};
+
+// -----------------------------------------------------------------------------
+py::array
+as_array( kv::image_container_sptr const& container, bool squeeze )
+{
+  if( !container )
+  {
+    throw py::value_error( "No image container given" );
+  }
+
+  kv::image const image = container->get_image();
+  const auto bytes = static_cast< py::ssize_t >( image.pixel_traits().num_bytes );
+
+  std::vector< py::ssize_t > shape = {
+    static_cast< py::ssize_t >( image.height() ),
+    static_cast< py::ssize_t >( image.width() ),
+    static_cast< py::ssize_t >( image.depth() ) };
+  std::vector< py::ssize_t > strides = {
+    image.h_step() * bytes, image.w_step() * bytes, image.d_step() * bytes };
+
+  if( squeeze && image.depth() == 1 )
+  {
+    shape.pop_back();
+    strides.pop_back();
+  }
+
+  // The capsule holds a reference to the image memory for the array lifetime
+  auto holder = new kv::image( image );
+  py::capsule base( holder,
+    []( void* ptr ) { delete static_cast< kv::image* >( ptr ); } );
+
+  py::array output( pixel_dtype( image.pixel_traits() ), shape, strides,
+                    image.first_pixel(), base );
+
+  // Frames are shared by every downstream process, so must not be changed
+  output.attr( "setflags" )( py::arg( "write" ) = false );
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+kv::image_container_sptr
+from_array( py::array array )
+{
+  if( array.ndim() != 2 && array.ndim() != 3 )
+  {
+    throw py::value_error( "Image arrays must have 2 or 3 dimensions" );
+  }
+
+  const auto itemsize = array.itemsize();
+
+  for( py::ssize_t i = 0; i < array.ndim(); ++i )
+  {
+    if( array.strides( i ) % itemsize != 0 )
+    {
+      array = py::array::ensure( array,
+        py::array::c_style | py::array::forcecast );
+      break;
+    }
+  }
+
+  const kv::image_pixel_traits traits = array_pixel_traits( array.dtype() );
+  auto memory = std::make_shared< array_image_memory >( array );
+
+  const size_t depth = ( array.ndim() == 3 ? array.shape( 2 ) : 1 );
+  const ptrdiff_t d_step = ( array.ndim() == 3 ? array.strides( 2 ) / itemsize : 0 );
+
+  kv::image image( memory, array.data(),
+                   array.shape( 1 ), array.shape( 0 ), depth,
+                   array.strides( 1 ) / itemsize,
+                   array.strides( 0 ) / itemsize,
+                   d_step, traits );
+
+  return std::make_shared< kv::simple_image_container >( image );
+}
+
+} // end anonymous namespace
+
+} // end namespace viame
+
+// -----------------------------------------------------------------------------
+PYBIND11_MODULE( image_buffer, m )
+{
+  // Registers the ImageContainer type the functions below convert from and to
+  py::module::import( "kwiver.vital.types" );
+
+  m.doc() = "Zero copy conversion between image containers and numpy arrays";
+
+  m.def( "as_array", &viame::as_array,
+    py::arg( "image_container" ), py::arg( "squeeze" ) = true,
+    "Read-only array of shape (height, width[, depth]) viewing the pixels of "
+    "an image container, which stays valid as long as the array exists" );
+
+  m.def( "from_array", &viame::from_array, py::arg( "array" ),
+    "Image container referencing the memory of a 2 or 3 dimensional array, "
+    "which is copied only if its strides are not whole pixels" );
+}
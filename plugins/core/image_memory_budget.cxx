@@ -0,0 +1,255 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "image_memory_budget.h"
+#include "lazy_image_container.h"
+
+#include <vital/types/object_track_set.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+// =============================================================================
+image_memory_budget&
+image_memory_budget
+::instance()
+{
+  static image_memory_budget budget;
+  return budget;
+}
+
+
+image_memory_budget
+::image_memory_budget()
+  : m_limit( 0 )
+  , m_held( 0 )
+{
+  if( const char* budget = std::getenv( "VIAME_IMAGE_MEMORY_BUDGET" ) )
+  {
+    m_limit = static_cast< size_t >( std::max( 0.0,
+      std::strtod( budget, nullptr ) ) * 1024.0 * 1024.0 );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+image_memory_budget
+::set_limit( size_t bytes )
+{
+  if( bytes == 0 )
+  {
+    return;
+  }
+
+  size_t current = m_limit;
+
+  while( ( current == 0 || bytes < current ) &&
+         !m_limit.compare_exchange_weak( current, bytes ) )
+  {
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+image_memory_budget
+::exceeded() const
+{
+  const size_t limit = m_limit;
+  return limit > 0 && m_held > limit;
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+image_memory_budget
+::wait_below_limit( std::chrono::milliseconds max_wait )
+{
+  if( !exceeded() )
+  {
+    return true;
+  }
+
+  std::unique_lock< std::mutex > lock( m_mutex );
+  return m_released.wait_for( lock, max_wait, [this]{ return !exceeded(); } );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+image_memory_budget
+::add( size_t bytes )
+{
+  m_held += bytes;
+}
+
+
+void
+image_memory_budget
+::remove( size_t bytes )
+{
+  m_held -= bytes;
+
+  if( m_limit > 0 )
+  {
+    // Taking the lock orders this with a reader between its check and wait
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_released.notify_all();
+  }
+}
+
+
+// =============================================================================
+void
+image_memory_holder
+::add( size_t bytes )
+{
+  if( bytes > 0 )
+  {
+    m_held += bytes;
+    image_memory_budget::instance().add( bytes );
+  }
+}
+
+
+void
+image_memory_holder
+::remove( size_t bytes )
+{
+  // Never return more than was added, should a size change in between
+  size_t current = m_held;
+  size_t returned;
+
+  do
+  {
+    returned = std::min( bytes, current );
+  }
+  while( !m_held.compare_exchange_weak( current, current - returned ) );
+
+  if( returned > 0 )
+  {
+    image_memory_budget::instance().remove( returned );
+  }
+}
+
+
+void
+image_memory_holder
+::clear()
+{
+  const size_t bytes = m_held.exchange( 0 );
+
+  if( bytes > 0 )
+  {
+    image_memory_budget::instance().remove( bytes );
+  }
+}
+
+
+// =============================================================================
+size_t
+image_memory_size( kv::image_container_sptr const& image )
+{
+  if( !image )
+  {
+    return 0;
+  }
+
+  auto lazy = dynamic_cast< lazy_image_container const* >( image.get() );
+
+  if( lazy && !lazy->is_computed() )
+  {
+    return 0;
+  }
+
+  return image->size();
+}
+
+
+size_t
+image_memory_size( kv::detected_object_sptr const& detection )
+{
+  return detection ? image_memory_size( detection->mask() ) : 0;
+}
+
+
+size_t
+image_memory_size( kv::track const& track, size_t first )
+{
+  size_t bytes = 0;
+
+  for( size_t i = first; i < track.size(); ++i )
+  {
+    auto state = dynamic_cast< kv::object_track_state const* >(
+      ( track.begin() + i )->get() );
+
+    if( state )
+    {
+      bytes += image_memory_size( state->detection() );
+    }
+  }
+  return bytes;
+}
+
+
+// =============================================================================
+void
+get_image_memory_configuration( kv::config_block_sptr config,
+                                double memory_budget, double max_throttle_wait )
+{
+  config->set_value( "memory_budget", memory_budget,
+    "Image memory (MB) buffered across the pipeline above which reading "
+    "pauses until downstream stages release frames. The smallest budget "
+    "of all readers applies, 0 uses the VIAME_IMAGE_MEMORY_BUDGET environment "
+    "variable or no budget." );
+  config->set_value( "max_throttle_wait", max_throttle_wait,
+    "Longest time (s) reading pauses for each frame while over the memory "
+    "budget, after which the frame is read anyway." );
+}
+
+
+void
+set_image_memory_configuration( kv::config_block_sptr config,
+                                double& memory_budget, double& max_throttle_wait )
+{
+  memory_budget = config->get_value< double >( "memory_budget" );
+  max_throttle_wait = config->get_value< double >( "max_throttle_wait" );
+
+  image_memory_budget::instance().set_limit(
+    static_cast< size_t >( std::max( 0.0, memory_budget ) * 1024.0 * 1024.0 ) );
+}
+
+} // end namespace viame
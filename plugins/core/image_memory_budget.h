@@ -0,0 +1,159 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Process-wide accounting of image memory held by buffering stages
+ */
+
+#ifndef VIAME_CORE_IMAGE_MEMORY_BUDGET_H
+#define VIAME_CORE_IMAGE_MEMORY_BUDGET_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/config/config_block.h>
+#include <vital/types/detected_object.h>
+#include <vital/types/image_container.h>
+#include <vital/types/track.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Shared budget for the image memory buffered across pipelines
+ *
+ * Stages holding images or masks for more than one step, such as frame
+ * aligners, track conductors and end-of-stream writers, report what they hold
+ * through image_memory_holder. Readers call wait_below_limit() before loading
+ * more frames, so a pipeline exceeding its budget slows down to the pace at
+ * which the held memory is released instead of growing until the process is
+ * killed. The wait is bounded, so stages which only release memory once they
+ * receive more frames keep making progress.
+ *
+ * The limit is the smallest one configured by any reader, or the value in MB
+ * of the VIAME_IMAGE_MEMORY_BUDGET environment variable, no limit without
+ * either.
+ */
+class VIAME_CORE_EXPORT image_memory_budget
+{
+public:
+  static image_memory_budget& instance();
+
+  /// Lower the limit in bytes, 0 leaves it unchanged
+  void set_limit( size_t bytes );
+
+  /// Limit in bytes, or 0 for none
+  size_t limit() const { return m_limit; }
+
+  /// Bytes currently held by all holders
+  size_t held() const { return m_held; }
+
+  /// True while the held memory exceeds the limit
+  bool exceeded() const;
+
+  /// Wait until the held memory is under the limit or max_wait has passed,
+  /// returning false if the wait timed out
+  bool wait_below_limit( std::chrono::milliseconds max_wait );
+
+  void add( size_t bytes );
+  void remove( size_t bytes );
+
+private:
+  image_memory_budget();
+
+  std::atomic< size_t > m_limit;
+  std::atomic< size_t > m_held;
+
+  std::mutex m_mutex;
+  std::condition_variable m_released;
+};
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Bytes reported by one buffering stage, returned when destroyed
+ *
+ * add() and remove() may be called from different threads, as when one
+ * thread fills a buffer which another empties.
+ */
+class VIAME_CORE_EXPORT image_memory_holder
+{
+public:
+  image_memory_holder() : m_held( 0 ) {}
+  ~image_memory_holder() { clear(); }
+
+  image_memory_holder( const image_memory_holder& ) = delete;
+  image_memory_holder& operator=( const image_memory_holder& ) = delete;
+
+  void add( size_t bytes );
+  void remove( size_t bytes );
+
+  /// Return everything held by this stage
+  void clear();
+
+  size_t held() const { return m_held; }
+
+private:
+  std::atomic< size_t > m_held;
+};
+
+// -----------------------------------------------------------------------------
+/// Bytes used by the pixels of an image, 0 for lazy images not computed yet
+VIAME_CORE_EXPORT size_t
+image_memory_size( kwiver::vital::image_container_sptr const& image );
+
+/// Bytes used by the mask of a detection
+VIAME_CORE_EXPORT size_t
+image_memory_size( kwiver::vital::detected_object_sptr const& detection );
+
+/// Bytes used by the detection masks of the states of a track from index first
+VIAME_CORE_EXPORT size_t
+image_memory_size( kwiver::vital::track const& track, size_t first = 0 );
+
+// -----------------------------------------------------------------------------
+/// Add the reader throttling settings to an algorithm configuration
+VIAME_CORE_EXPORT void
+get_image_memory_configuration( kwiver::vital::config_block_sptr config,
+                                double memory_budget, double max_throttle_wait );
+
+/// Read the reader throttling settings, lowering the shared limit if set
+VIAME_CORE_EXPORT void
+set_image_memory_configuration( kwiver::vital::config_block_sptr config,
+                                double& memory_budget, double& max_throttle_wait );
+
+} // end namespace viame
+
+#endif // VIAME_CORE_IMAGE_MEMORY_BUDGET_H
@@ -0,0 +1,189 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "image_tiling.h"
+
+#include <map>
+#include <string>
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+std::vector< unsigned >
+tile_origins( unsigned size, unsigned tile_size, unsigned overlap )
+{
+  std::vector< unsigned > origins;
+
+  if( tile_size == 0 || tile_size >= size )
+  {
+    origins.push_back( 0 );
+    return origins;
+  }
+
+  const unsigned step = ( tile_size > overlap ? tile_size - overlap : 1 );
+
+  for( unsigned origin = 0; ; origin += step )
+  {
+    if( origin + tile_size >= size )
+    {
+      origins.push_back( size - tile_size );
+      break;
+    }
+
+    origins.push_back( origin );
+  }
+
+  return origins;
+}
+
+// -----------------------------------------------------------------------------
+kv::detected_object_set_sptr
+crop_detections( kv::detected_object_set_sptr const& detections,
+                 kv::bounding_box_d const& region,
+                 double min_overlap )
+{
+  auto output = std::make_shared< kv::detected_object_set >();
+
+  if( !detections )
+  {
+    return output;
+  }
+
+  for( auto det : *detections )
+  {
+    const auto& bbox = det->bounding_box();
+    const auto inside = kv::intersection( bbox, region );
+
+    if( !inside.is_valid() || inside.area() <= 0.0 ||
+        inside.area() < min_overlap * bbox.area() )
+    {
+      continue;
+    }
+
+    auto cropped = det->clone();
+
+    cropped->set_bounding_box( kv::bounding_box_d(
+      inside.min_x() - region.min_x(), inside.min_y() - region.min_y(),
+      inside.max_x() - region.min_x(), inside.max_y() - region.min_y() ) );
+
+    // Masks are relative to their box, so only remain valid if it is not clipped
+    if( inside.width() != bbox.width() || inside.height() != bbox.height() )
+    {
+      cropped->set_mask( nullptr );
+    }
+
+    output->add( cropped );
+  }
+
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+void
+translate_detections( kv::detected_object_set_sptr const& detections,
+                      double dx, double dy )
+{
+  if( !detections )
+  {
+    return;
+  }
+
+  for( auto det : *detections )
+  {
+    const auto& bbox = det->bounding_box();
+
+    det->set_bounding_box( kv::bounding_box_d(
+      bbox.min_x() + dx, bbox.min_y() + dy,
+      bbox.max_x() + dx, bbox.max_y() + dy ) );
+  }
+}
+
+// -----------------------------------------------------------------------------
+kv::detected_object_set_sptr
+adjust_to_full_frame( kv::detected_object_set_sptr const& detections,
+                      unsigned width, unsigned height )
+{
+  if( !detections )
+  {
+    return detections;
+  }
+
+  bool adj_required = false;
+
+  for( auto det : *detections )
+  {
+    if( det &&
+        ( det->bounding_box().min_x() != 0 ||
+          det->bounding_box().min_y() != 0 ||
+          det->bounding_box().width() != width ||
+          det->bounding_box().height() != height ) )
+    {
+      adj_required = true;
+    }
+  }
+
+  if( !adj_required )
+  {
+    return detections;
+  }
+
+  auto output = std::make_shared< kv::detected_object_set >();
+
+  const kv::bounding_box_d ff_box( 0, 0, width, height );
+
+  std::map< std::string, int > obs_labels;
+
+  for( auto det : *detections )
+  {
+    std::string label;
+    double score;
+
+    if( det->type() )
+    {
+      det->type()->get_most_likely( label, score );
+    }
+
+    if( ++obs_labels[ label ] > 1 )
+    {
+      continue;
+    }
+
+    det->set_bounding_box( ff_box );
+
+    output->add( det );
+  }
+
+  return output;
+}
+
+} // end namespace viame
@@ -0,0 +1,89 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Tile layout and detection coordinate helpers for tiled images
+ */
+
+#ifndef VIAME_CORE_IMAGE_TILING_H
+#define VIAME_CORE_IMAGE_TILING_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/types/bounding_box.h>
+#include <vital/types/detected_object_set.h>
+
+#include <vector>
+
+namespace viame
+{
+
+/**
+ * @brief Tile origins along one dimension of an image
+ *
+ * Tiles start every tile_size - overlap pixels, and the last one is aligned
+ * to the image border so that all tiles have the same size, matching the chip
+ * mode of vxl_srm_image_formatter_process. A single origin at 0 is returned
+ * when the tile covers the whole dimension.
+ */
+VIAME_CORE_EXPORT std::vector< unsigned >
+tile_origins( unsigned size, unsigned tile_size, unsigned overlap );
+
+/**
+ * @brief Copies of the detections inside a region, relative to its origin
+ *
+ * Detections with less than min_overlap of their area inside the region are
+ * dropped, others are clipped to it. Masks of clipped detections are removed,
+ * as they are relative to the original box.
+ */
+VIAME_CORE_EXPORT kwiver::vital::detected_object_set_sptr
+crop_detections( kwiver::vital::detected_object_set_sptr const& detections,
+                 kwiver::vital::bounding_box_d const& region,
+                 double min_overlap = 0.0 );
+
+/// Move all detection boxes by the given offset, such as a tile origin
+VIAME_CORE_EXPORT void
+translate_detections( kwiver::vital::detected_object_set_sptr const& detections,
+                      double dx, double dy );
+
+/**
+ * @brief Convert detections to full frame labels of an image or tile
+ *
+ * Each label is kept once, with its box set to the full frame. Sets already
+ * only holding full frame boxes are returned unchanged.
+ */
+VIAME_CORE_EXPORT kwiver::vital::detected_object_set_sptr
+adjust_to_full_frame( kwiver::vital::detected_object_set_sptr const& detections,
+                      unsigned width, unsigned height );
+
+} // end namespace viame
+
+#endif // VIAME_CORE_IMAGE_TILING_H
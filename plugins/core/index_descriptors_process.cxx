@@ -0,0 +1,239 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Add descriptors to an approximate nearest neighbour index
+ */
+
+#include "index_descriptors_process.h"
+#include "descriptor_index.h"
+#include "process_trace.h"
+
+#include <vital/types/descriptor_set.h>
+
+#include <sprokit/processes/kwiver_type_traits.h>
+#include <sprokit/pipeline/process_exception.h>
+
+#include <vector>
+
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( index_path, std::string, "",
+  "Path of the descriptor index, without extension. The files are created "
+  "if missing and appended to otherwise" );
+create_config_trait( num_lists, unsigned, "1024",
+  "Number of inverted lists the descriptors are clustered into when the "
+  "index is trained" );
+create_config_trait( train_count, unsigned, "100000",
+  "Train the index once it holds this many descriptors, 0 never trains it "
+  "and leaves searches exhaustive" );
+create_config_trait( flush_count, unsigned, "10000",
+  "Write out descriptors once this many are buffered" );
+create_config_trait( descriptor_encoding, std::string, "float32",
+  "Precision of stored descriptor values when creating the index, float32 "
+  "or float16. Half precision halves the store size and is decoded as "
+  "descriptors are read" );
+create_config_trait( num_threads, unsigned, "0",
+  "Threads used to train the index, 0 uses all cores" );
+
+// =============================================================================
+// Private implementation class
+class index_descriptors_process::priv
+{
+public:
+  priv()
+    : m_num_lists( 1024 )
+    , m_train_count( 100000 )
+    , m_flush_count( 10000 )
+    , m_buffered( 0 )
+  {}
+
+  // Configuration settings
+  unsigned m_num_lists;
+  unsigned m_train_count;
+  unsigned m_flush_count;
+
+  // Internal variables
+  std::unique_ptr< descriptor_index > m_index;
+  unsigned m_buffered;
+};
+
+
+// =============================================================================
+index_descriptors_process
+::index_descriptors_process( kv::config_block_sptr const& config )
+  : process( config ),
+    d( new index_descriptors_process::priv() )
+{
+  make_ports();
+  make_config();
+}
+
+
+index_descriptors_process
+::~index_descriptors_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+index_descriptors_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t required;
+  sprokit::process::port_flags_t optional;
+
+  required.insert( flag_required );
+
+  // -- inputs --
+  declare_input_port_using_trait( descriptor_set, required );
+  declare_input_port_using_trait( string_vector, required );
+
+  // -- outputs --
+  declare_output_port_using_trait( descriptor_set, optional );
+  declare_output_port_using_trait( string_vector, optional );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+index_descriptors_process
+::make_config()
+{
+  declare_config_using_trait( index_path );
+  declare_config_using_trait( num_lists );
+  declare_config_using_trait( train_count );
+  declare_config_using_trait( flush_count );
+  declare_config_using_trait( descriptor_encoding );
+  declare_config_using_trait( num_threads );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+index_descriptors_process
+::_configure()
+{
+  const std::string path = config_value_using_trait( index_path );
+
+  if( path.empty() )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "An index_path must be given" );
+  }
+
+  d->m_num_lists = config_value_using_trait( num_lists );
+  d->m_train_count = config_value_using_trait( train_count );
+  d->m_flush_count = config_value_using_trait( flush_count );
+
+  if( d->m_train_count && d->m_train_count < d->m_num_lists )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "train_count must be at least num_lists" );
+  }
+
+  const std::string encoding = config_value_using_trait( descriptor_encoding );
+
+  if( encoding != "float32" && encoding != "float16" )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Unknown descriptor_encoding " + encoding );
+  }
+
+  d->m_index.reset( new descriptor_index( path, true,
+    config_value_using_trait( num_threads ),
+    encoding == "float16" ? descriptor_store::FLOAT16 : descriptor_store::FLOAT32 ) );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+index_descriptors_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  kv::descriptor_set_sptr descriptors = grab_from_port_using_trait( descriptor_set );
+  kv::string_vector_sptr uids = grab_from_port_using_trait( string_vector );
+
+  trace.inputs_ready();
+
+  const size_t count = ( descriptors ? descriptors->size() : 0 );
+
+  if( count != ( uids ? uids->size() : 0 ) )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Received " + std::to_string( count ) + " descriptors with " +
+                 std::to_string( uids ? uids->size() : 0 ) + " uids" );
+  }
+
+  trace.count( "descriptors", count );
+
+  size_t i = 0;
+
+  for( auto const& desc : *descriptors )
+  {
+    const std::vector< double > values = desc->as_double();
+
+    d->m_index->add( ( *uids )[ i++ ], values.data(),
+                     static_cast< unsigned >( values.size() ) );
+  }
+
+  d->m_buffered += count;
+
+  if( d->m_buffered >= d->m_flush_count )
+  {
+    d->m_index->flush();
+    d->m_buffered = 0;
+  }
+
+  if( d->m_train_count && !d->m_index->trained() &&
+      d->m_index->store().size() >= d->m_train_count )
+  {
+    d->m_index->train( d->m_num_lists, d->m_train_count );
+    d->m_buffered = 0;
+  }
+
+  push_to_port_using_trait( descriptor_set, descriptors );
+  push_to_port_using_trait( string_vector, uids );
+}
+
+} // end namespace core
+} // end namespace viame
@@ -0,0 +1,711 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Frame to frame association of boxes by overlap
+ */
+
+#include "iou_tracker.h"
+#include "linear_assignment.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+
+namespace viame
+{
+
+namespace kv = kwiver::vital;
+
+namespace
+{
+
+// Position and velocity of one box coordinate
+struct axis_filter
+{
+  double pos = 0.0;
+  double vel = 0.0;
+  double p00 = 0.0;
+  double p01 = 0.0;
+  double p11 = 0.0;
+
+  void init( double z, double r )
+  {
+    pos = z;
+    vel = 0.0;
+    p00 = r;
+    p01 = 0.0;
+    p11 = 10.0 * r;
+  }
+
+  void predict( double q )
+  {
+    pos += vel;
+    p00 += 2.0 * p01 + p11 + 0.25 * q;
+    p01 += p11 + 0.5 * q;
+    p11 += q;
+  }
+
+  void update( double z, double r )
+  {
+    const double s = p00 + r;
+    const double k0 = p00 / s;
+    const double k1 = p01 / s;
+    const double y = z - pos;
+
+    pos += k0 * y;
+    vel += k1 * y;
+    p11 -= k1 * p01;
+    p01 *= ( 1.0 - k0 );
+    p00 *= ( 1.0 - k0 );
+  }
+};
+
+
+struct active_track
+{
+  kv::track_id_t id = 0;
+
+  // Center x, center y, width and height
+  axis_filter filter[ 4 ];
+  kv::bounding_box_d predicted;
+
+  unsigned missed = 0;
+  unsigned hits = 0;
+};
+
+
+struct candidate_pair
+{
+  double iou;
+  unsigned track;
+  unsigned box;
+};
+
+
+// -----------------------------------------------------------------------------
+// Uniform grid of box indices, each box listed in every cell it covers
+class box_grid
+{
+public:
+  void reset( double cell_size )
+  {
+    m_scale = 1.0 / std::max( cell_size, 1.0 );
+
+    // Keep the storage of cells used on the last frame, drop the others
+    for( auto itr = m_cells.begin(); itr != m_cells.end(); )
+    {
+      if( itr->second.empty() )
+      {
+        itr = m_cells.erase( itr );
+      }
+      else
+      {
+        itr->second.clear();
+        ++itr;
+      }
+    }
+  }
+
+  void insert( unsigned index, kv::bounding_box_d const& box )
+  {
+    for_cells( box, [&]( std::uint64_t key )
+    {
+      m_cells[ key ].push_back( index );
+    } );
+  }
+
+  template< typename F >
+  void query( kv::bounding_box_d const& box, F visit ) const
+  {
+    for_cells( box, [&]( std::uint64_t key )
+    {
+      auto itr = m_cells.find( key );
+
+      if( itr != m_cells.end() )
+      {
+        for( unsigned index : itr->second )
+        {
+          visit( index );
+        }
+      }
+    } );
+  }
+
+private:
+  template< typename F >
+  void for_cells( kv::bounding_box_d const& box, F f ) const
+  {
+    const std::int64_t x0 = static_cast< std::int64_t >( std::floor( box.min_x() * m_scale ) );
+    const std::int64_t y0 = static_cast< std::int64_t >( std::floor( box.min_y() * m_scale ) );
+    const std::int64_t x1 = static_cast< std::int64_t >( std::floor( box.max_x() * m_scale ) );
+    const std::int64_t y1 = static_cast< std::int64_t >( std::floor( box.max_y() * m_scale ) );
+
+    for( std::int64_t y = y0; y <= y1; ++y )
+    {
+      for( std::int64_t x = x0; x <= x1; ++x )
+      {
+        f( ( static_cast< std::uint64_t >( x ) << 32 ) ^
+           static_cast< std::uint32_t >( y ) );
+      }
+    }
+  }
+
+  double m_scale = 1.0;
+  std::unordered_map< std::uint64_t, std::vector< unsigned > > m_cells;
+};
+
+} // end anonymous namespace
+
+
+// -----------------------------------------------------------------------------
+double
+box_iou( kv::bounding_box_d const& a, kv::bounding_box_d const& b )
+{
+  const double iw = std::min( a.max_x(), b.max_x() ) - std::max( a.min_x(), b.min_x() );
+  const double ih = std::min( a.max_y(), b.max_y() ) - std::max( a.min_y(), b.min_y() );
+
+  if( iw <= 0.0 || ih <= 0.0 )
+  {
+    return 0.0;
+  }
+
+  const double inter = iw * ih;
+  return inter / ( a.area() + b.area() - inter );
+}
+
+
+// -----------------------------------------------------------------------------
+kv::bounding_box_d
+map_box( kv::matrix_3x3d const& h, kv::bounding_box_d const& box )
+{
+  const double xs[ 2 ] = { box.min_x(), box.max_x() };
+  const double ys[ 2 ] = { box.min_y(), box.max_y() };
+
+  double min_x = 0.0, min_y = 0.0, max_x = 0.0, max_y = 0.0;
+
+  for( unsigned i = 0; i < 4; ++i )
+  {
+    const double x = xs[ i & 1 ];
+    const double y = ys[ i >> 1 ];
+    const double w = h( 2, 0 ) * x + h( 2, 1 ) * y + h( 2, 2 );
+
+    if( std::abs( w ) < 1e-12 )
+    {
+      return box;
+    }
+
+    const double mx = ( h( 0, 0 ) * x + h( 0, 1 ) * y + h( 0, 2 ) ) / w;
+    const double my = ( h( 1, 0 ) * x + h( 1, 1 ) * y + h( 1, 2 ) ) / w;
+
+    if( i == 0 )
+    {
+      min_x = max_x = mx;
+      min_y = max_y = my;
+    }
+    else
+    {
+      min_x = std::min( min_x, mx );
+      max_x = std::max( max_x, mx );
+      min_y = std::min( min_y, my );
+      max_y = std::max( max_y, my );
+    }
+  }
+
+  return kv::bounding_box_d( min_x, min_y, max_x, max_y );
+}
+
+
+// =============================================================================
+class iou_tracker::priv
+{
+public:
+  explicit priv( iou_tracker_settings const& settings )
+    : m_settings( settings )
+    , m_next_track_id( 1 )
+    , m_stamp( 0 )
+  { }
+
+  iou_tracker_settings m_settings;
+
+  std::vector< active_track > m_tracks;
+  kv::track_id_t m_next_track_id;
+  std::vector< kv::track_id_t > m_terminated;
+
+  // Buffers kept across frames
+  box_grid m_grid;
+  std::vector< unsigned > m_visit_stamp;
+  unsigned m_stamp;
+  std::vector< candidate_pair > m_candidates;
+
+  void init_track( active_track& trk, kv::bounding_box_d const& box );
+  void predict_track( active_track& trk );
+  void update_track( active_track& trk, kv::bounding_box_d const& box );
+
+  // Fills m_candidates with overlapping track, box pairs
+  void find_candidates( std::vector< kv::bounding_box_d > const& boxes );
+
+  // Returns the track assigned to each box, or -1
+  std::vector< int > assign( size_t box_count );
+  void assign_greedy( std::vector< candidate_pair >& pairs,
+                      std::vector< int >& track_of,
+                      std::vector< bool >& track_used );
+};
+
+
+// -----------------------------------------------------------------------------
+void
+iou_tracker::priv
+::init_track( active_track& trk, kv::bounding_box_d const& box )
+{
+  const kv::vector_2d center = box.center();
+  const double r = m_settings.measurement_noise;
+
+  trk.filter[ 0 ].init( center[ 0 ], r );
+  trk.filter[ 1 ].init( center[ 1 ], r );
+  trk.filter[ 2 ].init( box.width(), r );
+  trk.filter[ 3 ].init( box.height(), r );
+  trk.predicted = box;
+}
+
+
+void
+iou_tracker::priv
+::predict_track( active_track& trk )
+{
+  if( !m_settings.use_kalman )
+  {
+    return;
+  }
+
+  for( auto& f : trk.filter )
+  {
+    f.predict( m_settings.process_noise );
+  }
+
+  const double w = std::max( trk.filter[ 2 ].pos, 1.0 );
+  const double h = std::max( trk.filter[ 3 ].pos, 1.0 );
+
+  trk.predicted = kv::bounding_box_d(
+    kv::vector_2d( trk.filter[ 0 ].pos, trk.filter[ 1 ].pos ), w, h );
+}
+
+
+void
+iou_tracker::priv
+::update_track( active_track& trk, kv::bounding_box_d const& box )
+{
+  if( !m_settings.use_kalman )
+  {
+    trk.predicted = box;
+    return;
+  }
+
+  const kv::vector_2d center = box.center();
+  const double r = m_settings.measurement_noise;
+
+  trk.filter[ 0 ].update( center[ 0 ], r );
+  trk.filter[ 1 ].update( center[ 1 ], r );
+  trk.filter[ 2 ].update( box.width(), r );
+  trk.filter[ 3 ].update( box.height(), r );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+iou_tracker::priv
+::find_candidates( std::vector< kv::bounding_box_d > const& boxes )
+{
+  m_candidates.clear();
+
+  if( m_tracks.empty() || boxes.empty() )
+  {
+    return;
+  }
+
+  double cell_size = m_settings.grid_cell_size;
+
+  if( cell_size <= 0.0 )
+  {
+    double size_sum = 0.0;
+
+    for( auto const& trk : m_tracks )
+    {
+      size_sum += std::max( trk.predicted.width(), trk.predicted.height() );
+    }
+
+    cell_size = size_sum / m_tracks.size();
+  }
+
+  m_grid.reset( cell_size );
+
+  for( unsigned i = 0; i < m_tracks.size(); ++i )
+  {
+    m_grid.insert( i, m_tracks[ i ].predicted );
+  }
+
+  m_visit_stamp.resize( m_tracks.size(), 0 );
+
+  for( unsigned j = 0; j < boxes.size(); ++j )
+  {
+    // Boxes covering several cells are listed once per cell
+    if( ++m_stamp == 0 )
+    {
+      std::fill( m_visit_stamp.begin(), m_visit_stamp.end(), 0 );
+      m_stamp = 1;
+    }
+
+    m_grid.query( boxes[ j ], [&]( unsigned i )
+    {
+      if( m_visit_stamp[ i ] == m_stamp )
+      {
+        return;
+      }
+
+      m_visit_stamp[ i ] = m_stamp;
+
+      const double iou = box_iou( m_tracks[ i ].predicted, boxes[ j ] );
+
+      if( iou >= m_settings.min_iou && iou > 0.0 )
+      {
+        m_candidates.push_back( candidate_pair{ iou, i, j } );
+      }
+    } );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+iou_tracker::priv
+::assign_greedy( std::vector< candidate_pair >& pairs,
+                 std::vector< int >& track_of,
+                 std::vector< bool >& track_used )
+{
+  std::sort( pairs.begin(), pairs.end(),
+    []( candidate_pair const& a, candidate_pair const& b )
+    {
+      if( a.iou != b.iou )
+      {
+        return a.iou > b.iou;
+      }
+      return a.track != b.track ? a.track < b.track : a.box < b.box;
+    } );
+
+  for( auto const& pair : pairs )
+  {
+    if( !track_used[ pair.track ] && track_of[ pair.box ] < 0 )
+    {
+      track_used[ pair.track ] = true;
+      track_of[ pair.box ] = static_cast< int >( pair.track );
+    }
+  }
+}
+
+
+std::vector< int >
+iou_tracker::priv
+::assign( size_t box_count )
+{
+  std::vector< int > track_of( box_count, -1 );
+  std::vector< bool > track_used( m_tracks.size(), false );
+
+  if( !m_settings.hungarian )
+  {
+    assign_greedy( m_candidates, track_of, track_used );
+    return track_of;
+  }
+
+  // Group pairs into connected sets of boxes, tracks first then boxes
+  const size_t track_count = m_tracks.size();
+  std::vector< unsigned > root( track_count + box_count );
+  std::iota( root.begin(), root.end(), 0 );
+
+  auto find = [&]( unsigned n )
+  {
+    while( root[ n ] != n )
+    {
+      root[ n ] = root[ root[ n ] ];
+      n = root[ n ];
+    }
+    return n;
+  };
+
+  for( auto const& pair : m_candidates )
+  {
+    root[ find( pair.track ) ] = find( track_count + pair.box );
+  }
+
+  std::stable_sort( m_candidates.begin(), m_candidates.end(),
+    [&]( candidate_pair const& a, candidate_pair const& b )
+    {
+      return find( a.track ) < find( b.track );
+    } );
+
+  std::vector< unsigned > rows, cols;
+  std::vector< int > row_of( track_count, -1 ), col_of( box_count, -1 );
+  std::vector< double > costs;
+
+  for( size_t begin = 0; begin < m_candidates.size(); )
+  {
+    const unsigned group = find( m_candidates[ begin ].track );
+    size_t end = begin;
+
+    rows.clear();
+    cols.clear();
+
+    while( end < m_candidates.size() && find( m_candidates[ end ].track ) == group )
+    {
+      candidate_pair const& pair = m_candidates[ end++ ];
+
+      if( row_of[ pair.track ] < 0 )
+      {
+        row_of[ pair.track ] = static_cast< int >( rows.size() );
+        rows.push_back( pair.track );
+      }
+      if( col_of[ pair.box ] < 0 )
+      {
+        col_of[ pair.box ] = static_cast< int >( cols.size() );
+        cols.push_back( pair.box );
+      }
+    }
+
+    if( rows.size() == 1 || cols.size() == 1 || rows.size() * cols.size() > 250000 )
+    {
+      // Trivial or too large to solve exactly
+      std::vector< candidate_pair > pairs( m_candidates.begin() + begin,
+                                           m_candidates.begin() + end );
+      assign_greedy( pairs, track_of, track_used );
+    }
+    else
+    {
+      // Pairs which do not overlap enough cost more than any valid pair
+      costs.assign( rows.size() * cols.size(), 2.0 );
+
+      for( size_t k = begin; k < end; ++k )
+      {
+        candidate_pair const& pair = m_candidates[ k ];
+        costs[ row_of[ pair.track ] * cols.size() + col_of[ pair.box ] ] =
+          1.0 - pair.iou;
+      }
+
+      const std::vector< int > result =
+        core::solve_linear_assignment( costs, rows.size(), cols.size() );
+
+      for( size_t r = 0; r < rows.size(); ++r )
+      {
+        if( result[ r ] >= 0 && costs[ r * cols.size() + result[ r ] ] <= 1.0 )
+        {
+          track_used[ rows[ r ] ] = true;
+          track_of[ cols[ result[ r ] ] ] = static_cast< int >( rows[ r ] );
+        }
+      }
+    }
+
+    for( unsigned t : rows )
+    {
+      row_of[ t ] = -1;
+    }
+    for( unsigned c : cols )
+    {
+      col_of[ c ] = -1;
+    }
+
+    begin = end;
+  }
+
+  return track_of;
+}
+
+
+// =============================================================================
+iou_tracker
+::iou_tracker( iou_tracker_settings const& settings )
+  : d( new iou_tracker::priv( settings ) )
+{
+}
+
+
+iou_tracker
+::~iou_tracker()
+{
+}
+
+
+iou_tracker_settings const&
+iou_tracker
+::settings() const
+{
+  return d->m_settings;
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector< kv::track_id_t >
+iou_tracker
+::update( std::vector< kv::bounding_box_d > const& boxes,
+          std::vector< double > const& confidences )
+{
+  for( auto& trk : d->m_tracks )
+  {
+    d->predict_track( trk );
+  }
+
+  d->find_candidates( boxes );
+  const std::vector< int > track_of = d->assign( boxes.size() );
+
+  std::vector< kv::track_id_t > ids( boxes.size(), -1 );
+  std::vector< bool > matched( d->m_tracks.size(), false );
+
+  for( size_t j = 0; j < boxes.size(); ++j )
+  {
+    if( track_of[ j ] >= 0 )
+    {
+      active_track& trk = d->m_tracks[ track_of[ j ] ];
+
+      d->update_track( trk, boxes[ j ] );
+      trk.missed = 0;
+      trk.hits++;
+
+      matched[ track_of[ j ] ] = true;
+      ids[ j ] = trk.id;
+    }
+  }
+
+  // Drop tracks missing boxes for too long, keeping the others in order
+  size_t kept = 0;
+  d->m_terminated.clear();
+
+  for( size_t i = 0; i < d->m_tracks.size(); ++i )
+  {
+    if( !matched[ i ] &&
+        ++d->m_tracks[ i ].missed > d->m_settings.max_missed_frames )
+    {
+      d->m_terminated.push_back( d->m_tracks[ i ].id );
+      continue;
+    }
+
+    if( kept != i )
+    {
+      d->m_tracks[ kept ] = std::move( d->m_tracks[ i ] );
+    }
+    kept++;
+  }
+
+  d->m_tracks.resize( kept );
+
+  for( size_t j = 0; j < boxes.size(); ++j )
+  {
+    if( track_of[ j ] >= 0 ||
+        ( j < confidences.size() &&
+          confidences[ j ] < d->m_settings.new_track_threshold ) )
+    {
+      continue;
+    }
+
+    active_track trk;
+
+    trk.id = d->m_next_track_id++;
+    trk.hits = 1;
+
+    d->init_track( trk, boxes[ j ] );
+    d->m_tracks.push_back( std::move( trk ) );
+
+    ids[ j ] = d->m_tracks.back().id;
+  }
+
+  return ids;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+iou_tracker
+::reseed( std::function< bool( kv::track_id_t, kv::bounding_box_d& ) > const& box_of )
+{
+  for( auto& trk : d->m_tracks )
+  {
+    kv::bounding_box_d box;
+
+    if( !box_of( trk.id, box ) )
+    {
+      continue;
+    }
+
+    const double vx = trk.filter[ 0 ].vel;
+    const double vy = trk.filter[ 1 ].vel;
+
+    d->init_track( trk, box );
+
+    trk.filter[ 0 ].vel = vx;
+    trk.filter[ 1 ].vel = vy;
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector< kv::track_id_t >
+iou_tracker
+::confirmed() const
+{
+  std::vector< kv::track_id_t > ids;
+  ids.reserve( d->m_tracks.size() );
+
+  for( auto const& trk : d->m_tracks )
+  {
+    if( trk.hits >= d->m_settings.min_track_hits )
+    {
+      ids.push_back( trk.id );
+    }
+  }
+
+  return ids;
+}
+
+
+std::vector< kv::track_id_t > const&
+iou_tracker
+::terminated() const
+{
+  return d->m_terminated;
+}
+
+
+size_t
+iou_tracker
+::candidate_count() const
+{
+  return d->m_candidates.size();
+}
+
+} // end namespace viame
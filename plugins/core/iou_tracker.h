@@ -0,0 +1,139 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Frame to frame association of boxes by overlap
+ */
+
+#ifndef VIAME_CORE_IOU_TRACKER_H
+#define VIAME_CORE_IOU_TRACKER_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/types/bounding_box.h>
+#include <vital/types/matrix.h>
+#include <vital/vital_types.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace viame
+{
+
+/// Intersection over union of two boxes
+VIAME_CORE_EXPORT double
+box_iou( kwiver::vital::bounding_box_d const& a,
+         kwiver::vital::bounding_box_d const& b );
+
+/// Bounds of the corners of a box mapped through a homography
+VIAME_CORE_EXPORT kwiver::vital::bounding_box_d
+map_box( kwiver::vital::matrix_3x3d const& homography,
+         kwiver::vital::bounding_box_d const& box );
+
+/// Settings of an iou_tracker
+struct iou_tracker_settings
+{
+  /// Minimum overlap between a predicted box and a box to associate them
+  double min_iou = 0.1;
+
+  /// Minimum confidence of an unassociated box to start a track
+  double new_track_threshold = 0.0;
+
+  /// Frames a track is predicted through without boxes before it ends
+  unsigned max_missed_frames = 5;
+
+  /// Boxes a track needs before it is reported as confirmed
+  unsigned min_track_hits = 1;
+
+  /// Predict with a constant velocity Kalman filter, else the last box
+  bool use_kalman = true;
+  double process_noise = 1.0;
+  double measurement_noise = 4.0;
+
+  /// Spatial grid cell size, the mean predicted box size when 0
+  double grid_cell_size = 0.0;
+
+  /// Solve each group of overlapping boxes exactly instead of greedily
+  bool hungarian = false;
+};
+
+/**
+ * @brief Associate boxes with tracks by overlap with their predicted boxes
+ *
+ * Candidate pairs are found through a uniform grid over the predicted boxes,
+ * so only nearby boxes are compared, and are then assigned in order of
+ * overlap. All boxes given to a tracker must share one coordinate frame.
+ */
+class VIAME_CORE_EXPORT iou_tracker
+{
+public:
+  explicit iou_tracker( iou_tracker_settings const& settings = iou_tracker_settings() );
+  ~iou_tracker();
+
+  iou_tracker_settings const& settings() const;
+
+  /**
+   * @brief Associate the boxes of the next frame
+   *
+   * Returns the id of the track each box extends or starts, or -1 for boxes
+   * below new_track_threshold that match no track.
+   */
+  std::vector< kwiver::vital::track_id_t >
+  update( std::vector< kwiver::vital::bounding_box_d > const& boxes,
+          std::vector< double > const& confidences );
+
+  /**
+   * @brief Restart tracks after a change of coordinate frame
+   *
+   * box_of returns false for tracks which keep their current prediction.
+   * Velocities are kept.
+   */
+  void reseed( std::function< bool( kwiver::vital::track_id_t,
+                                    kwiver::vital::bounding_box_d& ) > const& box_of );
+
+  /// Tracks with at least min_track_hits boxes, in creation order
+  std::vector< kwiver::vital::track_id_t > confirmed() const;
+
+  /// Tracks ended by the last update
+  std::vector< kwiver::vital::track_id_t > const& terminated() const;
+
+  /// Track and box pairs compared by the last update
+  size_t candidate_count() const;
+
+private:
+  class priv;
+  const std::unique_ptr< priv > d;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_IOU_TRACKER_H
@@ -0,0 +1,366 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Link detections into tracks by box overlap
+ */
+
+#include "iou_tracker_process.h"
+#include "iou_tracker.h"
+#include "process_trace.h"
+
+#include <vital/types/bounding_box.h>
+#include <vital/types/detected_object_set.h>
+#include <vital/types/homography_f2f.h>
+#include <vital/types/object_track_set.h>
+#include <vital/types/timestamp.h>
+
+#include <sprokit/processes/kwiver_type_traits.h>
+#include <sprokit/pipeline/process_exception.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( min_iou, double, "0.1",
+  "Minimum overlap between a track's predicted box and a detection for "
+  "the two to be associated" );
+create_config_trait( detection_threshold, double, "0.0",
+  "Detections below this confidence are ignored" );
+create_config_trait( new_track_threshold, double, "0.0",
+  "Minimum confidence of an unmatched detection to start a new track" );
+create_config_trait( max_missed_frames, unsigned, "5",
+  "Frames a track may go without a matching detection before it is "
+  "terminated. Missed frames are bridged with the predicted box." );
+create_config_trait( min_track_hits, unsigned, "1",
+  "Tracks are only output once they have matched this many detections" );
+create_config_trait( use_kalman, bool, "true",
+  "Predict track boxes with a constant velocity Kalman filter, otherwise "
+  "the last matched box is used as the prediction" );
+create_config_trait( process_noise, double, "1.0",
+  "Kalman filter process noise, in squared pixels per frame" );
+create_config_trait( measurement_noise, double, "4.0",
+  "Kalman filter measurement noise, in squared pixels" );
+create_config_trait( grid_cell_size, double, "0",
+  "Cell size of the spatial grid used to find candidate pairs, in pixels. "
+  "If 0, the mean size of the predicted track boxes is used." );
+create_config_trait( assignment, std::string, "greedy",
+  "How candidate pairs are assigned, either greedy (highest overlap first) "
+  "or hungarian (optimal within each group of overlapping boxes)" );
+
+// =============================================================================
+// Private implementation class
+class iou_tracker_process::priv
+{
+public:
+  explicit priv( iou_tracker_process* parent );
+  ~priv();
+
+  // Configuration settings
+  iou_tracker_settings m_settings;
+  double m_detection_threshold;
+
+  // Internal variables
+  std::unique_ptr< iou_tracker > m_tracker;
+  std::map< kv::track_id_t, kv::track_sptr > m_tracks;
+  kv::frame_id_t m_frame_counter;
+  kv::frame_id_t m_reference_id;
+  bool m_has_reference;
+
+  // Other variables
+  iou_tracker_process* parent;
+};
+
+
+// -----------------------------------------------------------------------------
+iou_tracker_process::priv
+::priv( iou_tracker_process* ptr )
+  : m_detection_threshold( 0.0 )
+  , m_frame_counter( 0 )
+  , m_reference_id( 0 )
+  , m_has_reference( false )
+  , parent( ptr )
+{
+}
+
+
+iou_tracker_process::priv
+::~priv()
+{
+}
+
+
+// =============================================================================
+iou_tracker_process
+::iou_tracker_process( kv::config_block_sptr const& config )
+  : process( config ),
+    d( new iou_tracker_process::priv( this ) )
+{
+  make_ports();
+  make_config();
+}
+
+
+iou_tracker_process
+::~iou_tracker_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+iou_tracker_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t required;
+  sprokit::process::port_flags_t optional;
+
+  required.insert( flag_required );
+
+  // -- inputs --
+  declare_input_port_using_trait( image, optional );
+  declare_input_port_using_trait( timestamp, optional );
+  declare_input_port_using_trait( homography_src_to_ref, optional );
+  declare_input_port_using_trait( detected_object_set, required );
+
+  // -- outputs --
+  declare_output_port_using_trait( timestamp, optional );
+  declare_output_port_using_trait( object_track_set, optional );
+}
+
+// -----------------------------------------------------------------------------
+void
+iou_tracker_process
+::make_config()
+{
+  declare_config_using_trait( min_iou );
+  declare_config_using_trait( detection_threshold );
+  declare_config_using_trait( new_track_threshold );
+  declare_config_using_trait( max_missed_frames );
+  declare_config_using_trait( min_track_hits );
+  declare_config_using_trait( use_kalman );
+  declare_config_using_trait( process_noise );
+  declare_config_using_trait( measurement_noise );
+  declare_config_using_trait( grid_cell_size );
+  declare_config_using_trait( assignment );
+}
+
+// -----------------------------------------------------------------------------
+void
+iou_tracker_process
+::_configure()
+{
+  d->m_settings.min_iou = config_value_using_trait( min_iou );
+  d->m_settings.new_track_threshold = config_value_using_trait( new_track_threshold );
+  d->m_settings.max_missed_frames = config_value_using_trait( max_missed_frames );
+  d->m_settings.min_track_hits = config_value_using_trait( min_track_hits );
+  d->m_settings.use_kalman = config_value_using_trait( use_kalman );
+  d->m_settings.process_noise = config_value_using_trait( process_noise );
+  d->m_settings.measurement_noise = config_value_using_trait( measurement_noise );
+  d->m_settings.grid_cell_size = config_value_using_trait( grid_cell_size );
+  d->m_detection_threshold = config_value_using_trait( detection_threshold );
+
+  const std::string assignment = config_value_using_trait( assignment );
+
+  if( assignment == "hungarian" )
+  {
+    d->m_settings.hungarian = true;
+  }
+  else if( assignment == "greedy" )
+  {
+    d->m_settings.hungarian = false;
+  }
+  else
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+      "Invalid assignment: " + assignment );
+  }
+
+  d->m_tracker.reset( new iou_tracker( d->m_settings ) );
+  d->m_tracks.clear();
+  d->m_has_reference = false;
+}
+
+// -----------------------------------------------------------------------------
+void
+iou_tracker_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  kv::image_container_sptr image;
+  kv::timestamp timestamp;
+  kv::f2f_homography homography( 0 );
+  kv::detected_object_set_sptr detections;
+
+  bool has_homography = false;
+
+  if( has_input_port_edge_using_trait( timestamp ) )
+  {
+    timestamp = grab_from_port_using_trait( timestamp );
+  }
+  if( has_input_port_edge_using_trait( image ) )
+  {
+    image = grab_from_port_using_trait( image );
+  }
+  if( has_input_port_edge_using_trait( homography_src_to_ref ) )
+  {
+    homography = grab_from_port_using_trait( homography_src_to_ref );
+    has_homography = ( homography.homography() != nullptr );
+  }
+  detections = grab_from_port_using_trait( detected_object_set );
+
+  trace.inputs_ready();
+  trace.count( "detections", detections ? detections->size() : 0 );
+
+  if( !timestamp.has_valid_frame() )
+  {
+    timestamp.set_frame( d->m_frame_counter );
+  }
+  d->m_frame_counter = timestamp.get_frame() + 1;
+
+  kv::matrix_3x3d src_to_ref = kv::matrix_3x3d::Identity();
+
+  if( has_homography )
+  {
+    src_to_ref = homography.homography()->matrix();
+
+    // A new reference frame shares no coordinates with the previous one,
+    // so restart each track from its last box in image coordinates
+    if( d->m_has_reference && homography.to_id() != d->m_reference_id )
+    {
+      d->m_tracker->reseed(
+        [&]( kv::track_id_t id, kv::bounding_box_d& box )
+        {
+          auto itr = d->m_tracks.find( id );
+
+          if( itr == d->m_tracks.end() || itr->second->empty() )
+          {
+            return false;
+          }
+
+          auto state = std::static_pointer_cast< kv::object_track_state >(
+            itr->second->back() );
+
+          box = map_box( src_to_ref, state->detection()->bounding_box() );
+          return true;
+        } );
+    }
+
+    d->m_reference_id = homography.to_id();
+    d->m_has_reference = true;
+  }
+
+  // Detections to match and their boxes in the matching frame
+  std::vector< kv::detected_object_sptr > dets;
+  std::vector< kv::bounding_box_d > boxes;
+  std::vector< double > confidences;
+
+  if( detections )
+  {
+    dets.reserve( detections->size() );
+    boxes.reserve( detections->size() );
+    confidences.reserve( detections->size() );
+
+    for( auto det : *detections )
+    {
+      if( !det || det->confidence() < d->m_detection_threshold )
+      {
+        continue;
+      }
+
+      dets.push_back( det );
+      boxes.push_back( has_homography ?
+        map_box( src_to_ref, det->bounding_box() ) : det->bounding_box() );
+      confidences.push_back( det->confidence() );
+    }
+  }
+
+  const std::vector< kv::track_id_t > ids =
+    d->m_tracker->update( boxes, confidences );
+
+  trace.count( "candidates", d->m_tracker->candidate_count() );
+
+  for( size_t j = 0; j < dets.size(); ++j )
+  {
+    if( ids[ j ] < 0 )
+    {
+      continue;
+    }
+
+    kv::track_sptr& trk = d->m_tracks[ ids[ j ] ];
+
+    if( !trk )
+    {
+      trk = kv::track::create();
+      trk->set_id( ids[ j ] );
+    }
+
+    trk->append(
+      std::make_shared< kv::object_track_state >( timestamp, dets[ j ] ) );
+  }
+
+  for( kv::track_id_t id : d->m_tracker->terminated() )
+  {
+    d->m_tracks.erase( id );
+  }
+
+  const std::vector< kv::track_id_t > confirmed = d->m_tracker->confirmed();
+
+  std::vector< kv::track_sptr > output;
+  output.reserve( confirmed.size() );
+
+  for( kv::track_id_t id : confirmed )
+  {
+    output.push_back( d->m_tracks[ id ] );
+  }
+
+  trace.count( "tracks", output.size() );
+
+  push_to_port_using_trait( timestamp, timestamp );
+  push_to_port_using_trait( object_track_set,
+    std::make_shared< kv::object_track_set >( output ) );
+}
+
+} // end namespace core
+
+} // end namespace viame
@@ -0,0 +1,525 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Event based JSON parsing and JSON string output for large files
+ */
+
+#include "json_stream.h"
+
+#include <vital/exceptions.h>
+
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+namespace viame
+{
+
+namespace
+{
+
+// Size of the blocks read from the input stream
+const std::size_t json_read_block_size = 1 << 20;
+
+// -----------------------------------------------------------------------------
+class json_reader
+{
+public:
+  json_reader( std::istream& in, json_sax_handler& handler )
+    : m_in( in )
+    , m_handler( handler )
+    , m_buffer( json_read_block_size )
+    , m_pos( 0 )
+    , m_end( 0 )
+    , m_offset( 0 )
+  {}
+
+  void parse();
+
+private:
+  // Next character, or -1 at the end of the input
+  int get()
+  {
+    if( m_pos == m_end && !fill() )
+    {
+      return -1;
+    }
+    return static_cast< unsigned char >( m_buffer[ m_pos++ ] );
+  }
+
+  int get_non_space()
+  {
+    int c = get();
+
+    while( c == ' ' || c == '\n' || c == '\r' || c == '\t' )
+    {
+      c = get();
+    }
+    return c;
+  }
+
+  bool fill();
+
+  void read_string();
+  void read_number( int first );
+  void read_literal( char const* rest );
+  void append_utf8( unsigned code );
+  unsigned read_hex4();
+
+  [[noreturn]] void fail( std::string const& message ) const;
+
+  std::istream& m_in;
+  json_sax_handler& m_handler;
+
+  std::vector< char > m_buffer;
+  std::size_t m_pos;
+  std::size_t m_end;
+  std::size_t m_offset;
+
+  // Value of the last string read, reused across strings
+  std::string m_string;
+};
+
+
+// -----------------------------------------------------------------------------
+bool
+json_reader
+::fill()
+{
+  m_offset += m_end;
+  m_pos = m_end = 0;
+
+  if( !m_in )
+  {
+    return false;
+  }
+
+  m_in.read( m_buffer.data(), m_buffer.size() );
+  m_end = static_cast< std::size_t >( m_in.gcount() );
+  return m_end > 0;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+json_reader
+::fail( std::string const& message ) const
+{
+  std::stringstream str;
+  str << "Invalid JSON at byte " << ( m_offset + m_pos ) << ": " << message;
+  VITAL_THROW( kwiver::vital::invalid_data, str.str() );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+json_reader
+::parse()
+{
+  enum class expect { VALUE, VALUE_OR_END, KEY, KEY_OR_END, AFTER_VALUE };
+
+  // Open objects and arrays, as '{' and '['
+  std::vector< char > containers;
+  expect state = expect::VALUE;
+
+  while( true )
+  {
+    const int c = get_non_space();
+
+    switch( state )
+    {
+      case expect::VALUE_OR_END:
+        if( c == ']' )
+        {
+          containers.pop_back();
+          m_handler.end_array();
+          state = expect::AFTER_VALUE;
+          break;
+        }
+        // fall through
+
+      case expect::VALUE:
+        state = expect::AFTER_VALUE;
+
+        if( c == '{' )
+        {
+          containers.push_back( '{' );
+          m_handler.start_object();
+          state = expect::KEY_OR_END;
+        }
+        else if( c == '[' )
+        {
+          containers.push_back( '[' );
+          m_handler.start_array();
+          state = expect::VALUE_OR_END;
+        }
+        else if( c == '"' )
+        {
+          read_string();
+          m_handler.string_value( m_string );
+        }
+        else if( c == '-' || ( c >= '0' && c <= '9' ) )
+        {
+          read_number( c );
+        }
+        else if( c == 't' )
+        {
+          read_literal( "rue" );
+          m_handler.bool_value( true );
+        }
+        else if( c == 'f' )
+        {
+          read_literal( "alse" );
+          m_handler.bool_value( false );
+        }
+        else if( c == 'n' )
+        {
+          read_literal( "ull" );
+          m_handler.null_value();
+        }
+        else
+        {
+          fail( c < 0 ? "unexpected end of input" : "expected a value" );
+        }
+        break;
+
+      case expect::KEY_OR_END:
+        if( c == '}' )
+        {
+          containers.pop_back();
+          m_handler.end_object();
+          state = expect::AFTER_VALUE;
+          break;
+        }
+        // fall through
+
+      case expect::KEY:
+        if( c != '"' )
+        {
+          fail( "expected an object key" );
+        }
+
+        read_string();
+        m_handler.key( m_string );
+
+        if( get_non_space() != ':' )
+        {
+          fail( "expected ':' after an object key" );
+        }
+
+        state = expect::VALUE;
+        break;
+
+      case expect::AFTER_VALUE:
+        if( containers.empty() )
+        {
+          if( c >= 0 )
+          {
+            fail( "unexpected data after the document" );
+          }
+          return;
+        }
+        else if( c == ',' )
+        {
+          state = ( containers.back() == '{' ? expect::KEY : expect::VALUE );
+        }
+        else if( c == '}' && containers.back() == '{' )
+        {
+          containers.pop_back();
+          m_handler.end_object();
+        }
+        else if( c == ']' && containers.back() == '[' )
+        {
+          containers.pop_back();
+          m_handler.end_array();
+        }
+        else
+        {
+          fail( c < 0 ? "unexpected end of input" : "expected ',' or a closing bracket" );
+        }
+        break;
+    }
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+json_reader
+::read_string()
+{
+  m_string.clear();
+
+  while( true )
+  {
+    // Copy unescaped runs of the buffer at once
+    const std::size_t start = m_pos;
+
+    while( m_pos < m_end && m_buffer[ m_pos ] != '"' && m_buffer[ m_pos ] != '\\' )
+    {
+      ++m_pos;
+    }
+
+    m_string.append( m_buffer.data() + start, m_pos - start );
+
+    const int c = get();
+
+    if( c == '"' )
+    {
+      return;
+    }
+    else if( c < 0 )
+    {
+      fail( "unterminated string" );
+    }
+    else if( c != '\\' )
+    {
+      // Buffer ran out in the middle of the string
+      m_string.push_back( static_cast< char >( c ) );
+      continue;
+    }
+
+    switch( get() )
+    {
+      case '"':  m_string.push_back( '"' ); break;
+      case '\\': m_string.push_back( '\\' ); break;
+      case '/':  m_string.push_back( '/' ); break;
+      case 'b':  m_string.push_back( '\b' ); break;
+      case 'f':  m_string.push_back( '\f' ); break;
+      case 'n':  m_string.push_back( '\n' ); break;
+      case 'r':  m_string.push_back( '\r' ); break;
+      case 't':  m_string.push_back( '\t' ); break;
+      case 'u':
+      {
+        unsigned code = read_hex4();
+
+        // Characters outside the basic plane come as surrogate pairs
+        if( code >= 0xD800 && code < 0xDC00 )
+        {
+          if( get() != '\\' || get() != 'u' )
+          {
+            fail( "unpaired surrogate in string" );
+          }
+
+          const unsigned low = read_hex4();
+
+          if( low < 0xDC00 || low >= 0xE000 )
+          {
+            fail( "unpaired surrogate in string" );
+          }
+
+          code = 0x10000 + ( ( code - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+        }
+
+        append_utf8( code );
+        break;
+      }
+      default:
+        fail( "invalid escape in string" );
+    }
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+unsigned
+json_reader
+::read_hex4()
+{
+  unsigned code = 0;
+
+  for( int i = 0; i < 4; ++i )
+  {
+    const int c = get();
+
+    code <<= 4;
+
+    if( c >= '0' && c <= '9' )
+    {
+      code |= c - '0';
+    }
+    else if( c >= 'a' && c <= 'f' )
+    {
+      code |= c - 'a' + 10;
+    }
+    else if( c >= 'A' && c <= 'F' )
+    {
+      code |= c - 'A' + 10;
+    }
+    else
+    {
+      fail( "invalid unicode escape in string" );
+    }
+  }
+  return code;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+json_reader
+::append_utf8( unsigned code )
+{
+  if( code < 0x80 )
+  {
+    m_string.push_back( static_cast< char >( code ) );
+  }
+  else if( code < 0x800 )
+  {
+    m_string.push_back( static_cast< char >( 0xC0 | ( code >> 6 ) ) );
+    m_string.push_back( static_cast< char >( 0x80 | ( code & 0x3F ) ) );
+  }
+  else if( code < 0x10000 )
+  {
+    m_string.push_back( static_cast< char >( 0xE0 | ( code >> 12 ) ) );
+    m_string.push_back( static_cast< char >( 0x80 | ( ( code >> 6 ) & 0x3F ) ) );
+    m_string.push_back( static_cast< char >( 0x80 | ( code & 0x3F ) ) );
+  }
+  else
+  {
+    m_string.push_back( static_cast< char >( 0xF0 | ( code >> 18 ) ) );
+    m_string.push_back( static_cast< char >( 0x80 | ( ( code >> 12 ) & 0x3F ) ) );
+    m_string.push_back( static_cast< char >( 0x80 | ( ( code >> 6 ) & 0x3F ) ) );
+    m_string.push_back( static_cast< char >( 0x80 | ( code & 0x3F ) ) );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+json_reader
+::read_number( int first )
+{
+  char text[ 64 ];
+  std::size_t length = 0;
+
+  text[ length++ ] = static_cast< char >( first );
+
+  while( true )
+  {
+    if( m_pos == m_end && !fill() )
+    {
+      break;
+    }
+
+    const char c = m_buffer[ m_pos ];
+
+    if( !( ( c >= '0' && c <= '9' ) || c == '.' || c == 'e' || c == 'E' ||
+           c == '-' || c == '+' ) )
+    {
+      break;
+    }
+
+    if( length + 1 >= sizeof( text ) )
+    {
+      fail( "number too long" );
+    }
+
+    text[ length++ ] = c;
+    ++m_pos;
+  }
+
+  text[ length ] = '\0';
+
+  char* parsed_end = nullptr;
+  const double value = std::strtod( text, &parsed_end );
+
+  if( parsed_end != text + length )
+  {
+    fail( std::string( "invalid number " ) + text );
+  }
+
+  m_handler.number_value( value );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+json_reader
+::read_literal( char const* rest )
+{
+  for( ; *rest; ++rest )
+  {
+    if( get() != *rest )
+    {
+      fail( "invalid literal" );
+    }
+  }
+}
+
+} // end anonymous namespace
+
+
+// -----------------------------------------------------------------------------
+void
+parse_json( std::istream& in, json_sax_handler& handler )
+{
+  json_reader( in, handler ).parse();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+write_json_string( std::ostream& out, std::string const& value )
+{
+  static const char hex[] = "0123456789abcdef";
+
+  out.put( '"' );
+
+  for( const char ch : value )
+  {
+    const unsigned char c = static_cast< unsigned char >( ch );
+
+    switch( c )
+    {
+      case '"':  out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\b': out << "\\b"; break;
+      case '\f': out << "\\f"; break;
+      case '\n': out << "\\n"; break;
+      case '\r': out << "\\r"; break;
+      case '\t': out << "\\t"; break;
+      default:
+        if( c < 0x20 )
+        {
+          out << "\\u00" << hex[ c >> 4 ] << hex[ c & 0xF ];
+        }
+        else
+        {
+          out.put( ch );
+        }
+    }
+  }
+
+  out.put( '"' );
+}
+
+} // end namespace viame
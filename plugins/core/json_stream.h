@@ -0,0 +1,82 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Event based JSON parsing and JSON string output for large files
+ */
+
+#ifndef VIAME_CORE_JSON_STREAM_H
+#define VIAME_CORE_JSON_STREAM_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Receiver of the events of parse_json, in document order
+ *
+ * Object members produce a key() event before their value. The strings
+ * passed are only valid for the duration of the call.
+ */
+class VIAME_CORE_EXPORT json_sax_handler
+{
+public:
+  virtual ~json_sax_handler() = default;
+
+  virtual void start_object() {}
+  virtual void end_object() {}
+  virtual void start_array() {}
+  virtual void end_array() {}
+  virtual void key( std::string const& name ) {}
+
+  virtual void string_value( std::string const& value ) {}
+  virtual void number_value( double value ) {}
+  virtual void bool_value( bool value ) {}
+  virtual void null_value() {}
+};
+
+/// Parse one JSON document in a single pass over a stream, without building
+/// it in memory. Throws kwiver::vital::invalid_data on syntax errors.
+VIAME_CORE_EXPORT void
+parse_json( std::istream& in, json_sax_handler& handler );
+
+/// Write a string as a quoted and escaped JSON string
+VIAME_CORE_EXPORT void
+write_json_string( std::ostream& out, std::string const& value );
+
+} // end namespace viame
+
+#endif // VIAME_CORE_JSON_STREAM_H
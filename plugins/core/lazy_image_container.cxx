@@ -0,0 +1,91 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "lazy_image_container.h"
+
+namespace viame
+{
+
+lazy_image_container
+::lazy_image_container( generator_t generator,
+                        size_t width, size_t height, size_t depth )
+  : m_width( width ),
+    m_height( height ),
+    m_depth( depth ),
+    m_generator( std::move( generator ) )
+{
+}
+
+
+size_t
+lazy_image_container
+::size() const
+{
+  kwiver::vital::image_container_sptr image = computed();
+  return image ? image->size() : 0;
+}
+
+
+kwiver::vital::image
+lazy_image_container
+::get_image() const
+{
+  kwiver::vital::image_container_sptr image = computed();
+  return image ? image->get_image() : kwiver::vital::image();
+}
+
+
+bool
+lazy_image_container
+::is_computed() const
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+  return !m_generator;
+}
+
+
+kwiver::vital::image_container_sptr
+lazy_image_container
+::computed() const
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  if( m_generator )
+  {
+    m_image = m_generator();
+
+    // Release what the generator holds, such as its input images
+    m_generator = nullptr;
+  }
+
+  return m_image;
+}
+
+} // end namespace
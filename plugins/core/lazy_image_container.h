@@ -0,0 +1,93 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * \file
+ * \brief Image container computing its image on first access
+ */
+
+#ifndef VIAME_CORE_LAZY_IMAGE_CONTAINER_H
+#define VIAME_CORE_LAZY_IMAGE_CONTAINER_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/types/image_container.h>
+
+#include <functional>
+#include <mutex>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Image container deferring the computation of its image
+ *
+ * The dimensions are known up front, the generator is only run the first time
+ * the pixels are accessed, for instance by get_image(), and its result is kept
+ * for later accesses. Containers dropped without any access never run it. The
+ * generator may run on any thread accessing the pixels, and should return null
+ * on failure, in which case the image is empty.
+ */
+class VIAME_CORE_EXPORT lazy_image_container
+  : public kwiver::vital::image_container
+{
+public:
+  using generator_t = std::function< kwiver::vital::image_container_sptr() >;
+
+  lazy_image_container( generator_t generator,
+                        size_t width, size_t height, size_t depth );
+
+  /// Size in bytes of the image, which computes it
+  virtual size_t size() const;
+
+  virtual size_t width() const { return m_width; }
+  virtual size_t height() const { return m_height; }
+  virtual size_t depth() const { return m_depth; }
+
+  virtual kwiver::vital::image get_image() const;
+
+  /// True once the image has been computed
+  bool is_computed() const;
+
+private:
+  kwiver::vital::image_container_sptr computed() const;
+
+  const size_t m_width;
+  const size_t m_height;
+  const size_t m_depth;
+
+  mutable std::mutex m_mutex;
+  mutable generator_t m_generator;
+  mutable kwiver::vital::image_container_sptr m_image;
+};
+
+} // end namespace
+
+#endif // VIAME_CORE_LAZY_IMAGE_CONTAINER_H
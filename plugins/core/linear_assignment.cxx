@@ -0,0 +1,83 @@
+#include "linear_assignment.h"
+
+#include <algorithm>
+#include <limits>
+
+std::vector<int>
+viame::core::solve_linear_assignment(const std::vector<double> &costs, size_t n_rows, size_t n_cols) {
+  std::vector<int> assignment(n_rows, -1);
+  if (n_rows == 0 || n_cols == 0)
+    return assignment;
+
+  // Algorithm requires rows <= cols, solve the transposed problem otherwise
+  const bool transposed = n_rows > n_cols;
+  const size_t n = transposed ? n_cols : n_rows;
+  const size_t m = transposed ? n_rows : n_cols;
+  const auto cost = [&](size_t i, size_t j) {
+    return transposed ? costs[j * n_cols + i] : costs[i * n_cols + j];
+  };
+
+  // Potentials and matching with 1 based indices, column 0 being a virtual column
+  const double inf = std::numeric_limits<double>::infinity();
+  std::vector<double> u(n + 1), v(m + 1), min_v(m + 1);
+  std::vector<size_t> p(m + 1), way(m + 1);
+  std::vector<char> used(m + 1);
+
+  for (size_t i = 1; i <= n; i++) {
+    p[0] = i;
+    size_t j0 = 0;
+    std::fill(min_v.begin(), min_v.end(), inf);
+    std::fill(used.begin(), used.end(), 0);
+
+    // Find augmenting path from row i
+    do {
+      used[j0] = 1;
+      const size_t i0 = p[j0];
+      double delta = inf;
+      size_t j1 = 0;
+
+      for (size_t j = 1; j <= m; j++) {
+        if (used[j])
+          continue;
+
+        const double cur = cost(i0 - 1, j - 1) - u[i0] - v[j];
+        if (cur < min_v[j]) {
+          min_v[j] = cur;
+          way[j] = j0;
+        }
+        if (min_v[j] < delta) {
+          delta = min_v[j];
+          j1 = j;
+        }
+      }
+
+      for (size_t j = 0; j <= m; j++) {
+        if (used[j]) {
+          u[p[j]] += delta;
+          v[j] -= delta;
+        } else {
+          min_v[j] -= delta;
+        }
+      }
+      j0 = j1;
+    } while (p[j0] != 0);
+
+    // Invert the augmenting path
+    do {
+      const size_t j1 = way[j0];
+      p[j0] = p[j1];
+      j0 = j1;
+    } while (j0 != 0);
+  }
+
+  for (size_t j = 1; j <= m; j++) {
+    if (p[j] == 0)
+      continue;
+
+    if (transposed)
+      assignment[j - 1] = (int) (p[j] - 1);
+    else
+      assignment[p[j] - 1] = (int) (j - 1);
+  }
+  return assignment;
+}
@@ -0,0 +1,24 @@
+#ifndef VIAME_CORE_LINEAR_ASSIGNMENT_H
+#define VIAME_CORE_LINEAR_ASSIGNMENT_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace viame {
+namespace core {
+
+/// @brief Solve the rectangular linear assignment problem for the input cost matrix (Hungarian algorithm, O(n^3)).
+/// @param costs: Row major cost matrix of size n_rows x n_cols
+/// @param n_rows: Number of rows of the cost matrix
+/// @param n_cols: Number of columns of the cost matrix
+/// @return For each row, the index of the assigned column or -1 if the row is unassigned. min(n_rows, n_cols) rows
+///     are assigned, minimizing the sum of assigned costs.
+VIAME_CORE_EXPORT std::vector<int>
+solve_linear_assignment(const std::vector<double> &costs, size_t n_rows, size_t n_cols);
+
+} // core
+} // viame
+
+#endif // VIAME_CORE_LINEAR_ASSIGNMENT_H
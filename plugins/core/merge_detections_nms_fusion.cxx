@@ -0,0 +1,883 @@
+ /*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "merge_detections_nms_fusion.h"
+
+#include <vital/exceptions.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Storage class for private member variables
+ */
+class merge_detections_nms_fusion::priv
+{
+public:
+
+  priv()
+   : m_fusion_type( "nmw" )
+   , m_match_iou( 0.5 )
+   , m_iou_thr( 0.75 )
+   , m_skip_box_thr( 0.0001 )
+   , m_sigma( 0.1 )
+   , m_fusion_weights_str( "[1, 1.5, 1]" )
+   , m_height( 1.0 )
+   , m_width( 1.0 )
+   , m_label_dic_str( "{}" )
+   , m_pseudo_dic_str( "{}" )
+   , m_pseudo_ind_str( "{}" )
+  {}
+
+  ~priv() {}
+
+  // Parameters, the dictionaries and lists use python literal syntax
+  std::string m_fusion_type;
+  double m_match_iou;
+  double m_iou_thr;
+  double m_skip_box_thr;
+  double m_sigma;
+  std::string m_fusion_weights_str;
+  double m_height;
+  double m_width;
+  std::string m_label_dic_str;
+  std::string m_pseudo_dic_str;
+  std::string m_pseudo_ind_str;
+
+  // Parsed forms of the above
+  std::vector< double > m_fusion_weights;
+  std::vector< std::pair< std::string, int > > m_label_list;
+  std::map< std::string, int > m_label_dic;
+  std::map< int, std::string > m_id_dic;
+  std::map< int, std::vector< int > > m_pseudo_dic;
+  std::map< int, std::vector< int > > m_pseudo_ind;
+
+  // Normalized box of one input detection
+  struct fusion_box
+  {
+    int label;
+    double score;
+    double weight;
+    double x1, y1, x2, y2;
+  };
+
+  // Boxes clusters are matched against, stored by column so the IoU of a
+  // candidate against all of them is one tight loop
+  struct box_columns
+  {
+    std::vector< double > x1, y1, x2, y2, area;
+
+    void push_back( const fusion_box& b );
+    void set( unsigned i, double bx1, double by1, double bx2, double by2 );
+    int best_match( const fusion_box& b, double threshold ) const;
+  };
+
+  // Sum of a WBF cluster, the fused box being sum / conf
+  struct wbf_cluster
+  {
+    int label;
+    double conf, weight;
+    double x1, y1, x2, y2;
+    unsigned count;
+  };
+
+  static double iou( const fusion_box& a, const fusion_box& b );
+
+  static std::vector< std::string > split_literal( const std::string& str,
+                                                   char open, char close );
+  static std::string unquote( const std::string& str );
+  static int parse_int( const std::string& str );
+  static double parse_double( const std::string& str );
+  static std::vector< double > parse_list( const std::string& str );
+  static std::vector< std::pair< std::string, int > > parse_label_dic(
+    const std::string& str );
+  static std::map< int, std::vector< int > > parse_list_dic( const std::string& str );
+
+  void non_maximum_weighted( std::vector< std::vector< fusion_box > >& sets,
+                             std::vector< fusion_box >& output ) const;
+  void weighted_boxes_fusion( std::vector< std::vector< fusion_box > >& sets,
+                              const std::vector< double >& weights,
+                              std::vector< fusion_box >& output ) const;
+};
+
+
+// -----------------------------------------------------------------------------
+void
+merge_detections_nms_fusion::priv::box_columns
+::push_back( const fusion_box& b )
+{
+  x1.push_back( b.x1 );
+  y1.push_back( b.y1 );
+  x2.push_back( b.x2 );
+  y2.push_back( b.y2 );
+  area.push_back( ( b.x2 - b.x1 ) * ( b.y2 - b.y1 ) );
+}
+
+
+void
+merge_detections_nms_fusion::priv::box_columns
+::set( unsigned i, double bx1, double by1, double bx2, double by2 )
+{
+  x1[i] = bx1;
+  y1[i] = by1;
+  x2[i] = bx2;
+  y2[i] = by2;
+  area[i] = ( bx2 - bx1 ) * ( by2 - by1 );
+}
+
+
+int
+merge_detections_nms_fusion::priv::box_columns
+::best_match( const fusion_box& b, double threshold ) const
+{
+  const double b_area = ( b.x2 - b.x1 ) * ( b.y2 - b.y1 );
+  const unsigned n = x1.size();
+
+  int best_index = -1;
+  double best_iou = threshold;
+
+  for( unsigned i = 0; i < n; ++i )
+  {
+    const double iw = std::max( 0.0, std::min( x2[i], b.x2 ) - std::max( x1[i], b.x1 ) );
+    const double ih = std::max( 0.0, std::min( y2[i], b.y2 ) - std::max( y1[i], b.y1 ) );
+    const double inter = iw * ih;
+    const double iou = ( inter > 0.0 ? inter / ( area[i] + b_area - inter ) : 0.0 );
+
+    if( iou > best_iou )
+    {
+      best_index = i;
+      best_iou = iou;
+    }
+  }
+
+  return best_index;
+}
+
+
+// -----------------------------------------------------------------------------
+double
+merge_detections_nms_fusion::priv
+::iou( const fusion_box& a, const fusion_box& b )
+{
+  const double iw = std::max( 0.0, std::min( a.x2, b.x2 ) - std::max( a.x1, b.x1 ) );
+  const double ih = std::max( 0.0, std::min( a.y2, b.y2 ) - std::max( a.y1, b.y1 ) );
+  const double inter = iw * ih;
+
+  if( inter <= 0.0 )
+  {
+    return 0.0;
+  }
+
+  return inter / ( ( a.x2 - a.x1 ) * ( a.y2 - a.y1 ) +
+                   ( b.x2 - b.x1 ) * ( b.y2 - b.y1 ) - inter );
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector< std::string >
+merge_detections_nms_fusion::priv
+::split_literal( const std::string& str, char open, char close )
+{
+  const auto first = str.find_first_not_of( " \t" );
+  const auto last = str.find_last_not_of( " \t" );
+
+  if( first == std::string::npos || str[first] != open || str[last] != close )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+      "Unable to parse nms_fusion setting: " + str );
+  }
+
+  // Split on commas outside of nested brackets
+  std::vector< std::string > entries;
+  std::string current;
+  int depth = 0;
+
+  for( auto i = first + 1; i < last; ++i )
+  {
+    const char c = str[i];
+
+    if( c == '[' || c == '{' )
+    {
+      depth++;
+    }
+    else if( c == ']' || c == '}' )
+    {
+      depth--;
+    }
+
+    if( c == ',' && depth == 0 )
+    {
+      entries.push_back( current );
+      current.clear();
+    }
+    else
+    {
+      current += c;
+    }
+  }
+
+  if( current.find_first_not_of( " \t" ) != std::string::npos )
+  {
+    entries.push_back( current );
+  }
+
+  return entries;
+}
+
+
+std::string
+merge_detections_nms_fusion::priv
+::unquote( const std::string& str )
+{
+  const auto first = str.find_first_not_of( " \t" );
+  const auto last = str.find_last_not_of( " \t" );
+
+  if( first == std::string::npos )
+  {
+    return std::string();
+  }
+
+  if( last > first && ( str[first] == '\'' || str[first] == '"' ) &&
+      str[last] == str[first] )
+  {
+    return str.substr( first + 1, last - first - 1 );
+  }
+
+  return str.substr( first, last - first + 1 );
+}
+
+
+int
+merge_detections_nms_fusion::priv
+::parse_int( const std::string& str )
+{
+  const std::string value = unquote( str );
+  char* end = nullptr;
+  const long result = std::strtol( value.c_str(), &end, 10 );
+
+  if( value.empty() || *end != '\0' )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+      "Expected integer in nms_fusion setting: " + str );
+  }
+
+  return static_cast< int >( result );
+}
+
+
+double
+merge_detections_nms_fusion::priv
+::parse_double( const std::string& str )
+{
+  const std::string value = unquote( str );
+  char* end = nullptr;
+  const double result = std::strtod( value.c_str(), &end );
+
+  if( value.empty() || *end != '\0' )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+      "Expected number in nms_fusion setting: " + str );
+  }
+
+  return result;
+}
+
+
+std::vector< double >
+merge_detections_nms_fusion::priv
+::parse_list( const std::string& str )
+{
+  std::vector< double > output;
+
+  for( const auto& entry : split_literal( str, '[', ']' ) )
+  {
+    output.push_back( parse_double( entry ) );
+  }
+
+  return output;
+}
+
+
+std::vector< std::pair< std::string, int > >
+merge_detections_nms_fusion::priv
+::parse_label_dic( const std::string& str )
+{
+  // Kept in the order listed, a repeated key updating its first entry
+  std::vector< std::pair< std::string, int > > output;
+
+  for( const auto& entry : split_literal( str, '{', '}' ) )
+  {
+    const auto sep = entry.rfind( ':' );
+
+    if( sep == std::string::npos )
+    {
+      VITAL_THROW( kwiver::vital::invalid_data,
+        "Expected key:value in nms_fusion setting: " + str );
+    }
+
+    const std::string key = unquote( entry.substr( 0, sep ) );
+    const int value = parse_int( entry.substr( sep + 1 ) );
+
+    auto existing = std::find_if( output.begin(), output.end(),
+      [&]( const std::pair< std::string, int >& p ){ return p.first == key; } );
+
+    if( existing != output.end() )
+    {
+      existing->second = value;
+    }
+    else
+    {
+      output.push_back( std::make_pair( key, value ) );
+    }
+  }
+
+  return output;
+}
+
+
+std::map< int, std::vector< int > >
+merge_detections_nms_fusion::priv
+::parse_list_dic( const std::string& str )
+{
+  std::map< int, std::vector< int > > output;
+
+  for( const auto& entry : split_literal( str, '{', '}' ) )
+  {
+    const auto sep = entry.find( ':' );
+
+    if( sep == std::string::npos )
+    {
+      VITAL_THROW( kwiver::vital::invalid_data,
+        "Expected key:value in nms_fusion setting: " + str );
+    }
+
+    std::vector< int >& values = output[ parse_int( entry.substr( 0, sep ) ) ];
+
+    for( const auto& value : split_literal( entry.substr( sep + 1 ), '[', ']' ) )
+    {
+      values.push_back( parse_int( value ) );
+    }
+  }
+
+  return output;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+merge_detections_nms_fusion::priv
+::non_maximum_weighted( std::vector< std::vector< fusion_box > >& sets,
+                        std::vector< fusion_box >& output ) const
+{
+  // Scores are scaled by the normalized detector weights before filtering
+  std::vector< fusion_box > boxes;
+
+  for( const auto& set : sets )
+  {
+    for( auto b : set )
+    {
+      b.score = b.score * b.weight;
+
+      if( b.score >= m_skip_box_thr )
+      {
+        boxes.push_back( b );
+      }
+    }
+  }
+
+  // One sweep per label in decreasing score order
+  std::stable_sort( boxes.begin(), boxes.end(),
+    []( const fusion_box& a, const fusion_box& b )
+    {
+      return a.label < b.label || ( a.label == b.label && a.score > b.score );
+    } );
+
+  for( unsigned start = 0; start < boxes.size(); )
+  {
+    unsigned end = start;
+    while( end < boxes.size() && boxes[end].label == boxes[start].label )
+    {
+      end++;
+    }
+
+    // Clusters are matched against their first, highest scoring, box
+    box_columns main_boxes;
+    std::vector< std::vector< unsigned > > clusters;
+
+    for( unsigned i = start; i < end; ++i )
+    {
+      const int index = main_boxes.best_match( boxes[i], m_iou_thr );
+
+      if( index >= 0 )
+      {
+        clusters[ index ].push_back( i );
+      }
+      else
+      {
+        main_boxes.push_back( boxes[i] );
+        clusters.push_back( std::vector< unsigned >( 1, i ) );
+      }
+    }
+
+    for( const auto& cluster : clusters )
+    {
+      const fusion_box& best = boxes[ cluster[0] ];
+      fusion_box fused = best;
+      fused.x1 = fused.y1 = fused.x2 = fused.y2 = 0.0;
+      double conf = 0.0;
+
+      for( unsigned i : cluster )
+      {
+        const fusion_box& b = boxes[i];
+        const double weight = b.score * iou( b, best );
+
+        fused.x1 += weight * b.x1;
+        fused.y1 += weight * b.y1;
+        fused.x2 += weight * b.x2;
+        fused.y2 += weight * b.y2;
+        conf += weight;
+      }
+
+      if( conf > 0.0 )
+      {
+        fused.x1 /= conf;
+        fused.y1 /= conf;
+        fused.x2 /= conf;
+        fused.y2 /= conf;
+      }
+
+      output.push_back( fused );
+    }
+
+    start = end;
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+merge_detections_nms_fusion::priv
+::weighted_boxes_fusion( std::vector< std::vector< fusion_box > >& sets,
+                         const std::vector< double >& weights,
+                         std::vector< fusion_box >& output ) const
+{
+  double weight_sum = 0.0;
+  std::vector< fusion_box > boxes;
+
+  for( double w : weights )
+  {
+    weight_sum += w;
+  }
+
+  for( const auto& set : sets )
+  {
+    for( auto b : set )
+    {
+      if( b.score >= m_skip_box_thr )
+      {
+        b.score = b.score * b.weight;
+        boxes.push_back( b );
+      }
+    }
+  }
+
+  std::stable_sort( boxes.begin(), boxes.end(),
+    []( const fusion_box& a, const fusion_box& b )
+    {
+      return a.label < b.label || ( a.label == b.label && a.score > b.score );
+    } );
+
+  for( unsigned start = 0; start < boxes.size(); )
+  {
+    unsigned end = start;
+    while( end < boxes.size() && boxes[end].label == boxes[start].label )
+    {
+      end++;
+    }
+
+    // Clusters are matched against their running fused box, kept as sums so
+    // adding a member is constant time
+    box_columns fused_boxes;
+    std::vector< wbf_cluster > clusters;
+
+    for( unsigned i = start; i < end; ++i )
+    {
+      const fusion_box& b = boxes[i];
+      const int index = fused_boxes.best_match( b, m_iou_thr );
+
+      if( index < 0 )
+      {
+        fused_boxes.push_back( b );
+        clusters.push_back( { b.label, b.score, b.weight,
+          b.score * b.x1, b.score * b.y1, b.score * b.x2, b.score * b.y2, 1 } );
+        continue;
+      }
+
+      wbf_cluster& c = clusters[ index ];
+
+      c.conf += b.score;
+      c.weight += b.weight;
+      c.x1 += b.score * b.x1;
+      c.y1 += b.score * b.y1;
+      c.x2 += b.score * b.x2;
+      c.y2 += b.score * b.y2;
+      c.count++;
+
+      fused_boxes.set( index, c.x1 / c.conf, c.y1 / c.conf,
+                       c.x2 / c.conf, c.y2 / c.conf );
+    }
+
+    for( unsigned i = 0; i < clusters.size(); ++i )
+    {
+      const wbf_cluster& c = clusters[i];
+      const double model_count = std::min< double >( weights.size(), c.count );
+
+      fusion_box fused;
+      fused.label = c.label;
+      fused.score = ( c.conf / c.count ) * model_count /
+                    ( weight_sum > 0.0 ? weight_sum : 1.0 );
+      fused.weight = c.weight;
+      fused.x1 = fused_boxes.x1[i];
+      fused.y1 = fused_boxes.y1[i];
+      fused.x2 = fused_boxes.x2[i];
+      fused.y2 = fused_boxes.y2[i];
+
+      output.push_back( fused );
+    }
+
+    start = end;
+  }
+}
+
+// =============================================================================
+
+merge_detections_nms_fusion
+::merge_detections_nms_fusion()
+  : d( new priv )
+{}
+
+
+merge_detections_nms_fusion
+::  ~merge_detections_nms_fusion()
+{}
+
+
+// -----------------------------------------------------------------------------
+kwiver::vital::config_block_sptr
+merge_detections_nms_fusion
+::get_configuration() const
+{
+  // Get base config from base class
+  kwiver::vital::config_block_sptr config =
+    kwiver::vital::algorithm::get_configuration();
+
+  config->set_value( "fusion_type", d->m_fusion_type,
+    "Fusion method, either nmw (non-maximum weighted) or wbf (weighted "
+    "boxes fusion)." );
+  config->set_value( "match_iou", d->m_match_iou,
+    "IoU above which detections from different detectors are matched when "
+    "applying pseudonyms." );
+  config->set_value( "iou_thr", d->m_iou_thr,
+    "IoU above which boxes are fused into the same cluster." );
+  config->set_value( "skip_box_thr", d->m_skip_box_thr,
+    "Detections scoring below this value are ignored." );
+  config->set_value( "sigma", d->m_sigma,
+    "Soft-NMS sigma, unused by the nmw and wbf methods." );
+  config->set_value( "fusion_weights", d->m_fusion_weights_str,
+    "List of weights, one per input detection set." );
+  config->set_value( "height", d->m_height,
+    "Height boxes are normalized by, 1 to use the largest box extent." );
+  config->set_value( "width", d->m_width,
+    "Width boxes are normalized by, 1 to use the largest box extent." );
+  config->set_value( "label_dic", d->m_label_dic_str,
+    "Dictionary from class name to fused label id, classes not listed "
+    "are dropped." );
+  config->set_value( "pseudo_dic", d->m_pseudo_dic_str,
+    "Dictionary from label id to the label ids it may be replaced by." );
+  config->set_value( "pseudo_ind", d->m_pseudo_ind_str,
+    "Dictionary from input set index to the set indices used to look up "
+    "pseudonyms for its detections." );
+
+  return config;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+merge_detections_nms_fusion
+::set_configuration( kwiver::vital::config_block_sptr config_in )
+{
+  kwiver::vital::config_block_sptr config = this->get_configuration();
+  config->merge_config( config_in );
+
+  d->m_fusion_type = config->get_value< std::string >( "fusion_type" );
+  d->m_match_iou = config->get_value< double >( "match_iou" );
+  d->m_iou_thr = config->get_value< double >( "iou_thr" );
+  d->m_skip_box_thr = config->get_value< double >( "skip_box_thr" );
+  d->m_sigma = config->get_value< double >( "sigma" );
+  d->m_fusion_weights_str = config->get_value< std::string >( "fusion_weights" );
+  d->m_height = config->get_value< double >( "height" );
+  d->m_width = config->get_value< double >( "width" );
+  d->m_label_dic_str = config->get_value< std::string >( "label_dic" );
+  d->m_pseudo_dic_str = config->get_value< std::string >( "pseudo_dic" );
+  d->m_pseudo_ind_str = config->get_value< std::string >( "pseudo_ind" );
+
+  d->m_fusion_weights = priv::parse_list( d->m_fusion_weights_str );
+  d->m_label_list = priv::parse_label_dic( d->m_label_dic_str );
+  d->m_label_dic = std::map< std::string, int >(
+    d->m_label_list.begin(), d->m_label_list.end() );
+  d->m_pseudo_dic = priv::parse_list_dic( d->m_pseudo_dic_str );
+  d->m_pseudo_ind = priv::parse_list_dic( d->m_pseudo_ind_str );
+
+  // Output names are the first class listed for each label id
+  d->m_id_dic.clear();
+
+  for( const auto& label : d->m_label_list )
+  {
+    d->m_id_dic.insert( std::make_pair( label.second, label.first ) );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+merge_detections_nms_fusion
+::check_configuration( kwiver::vital::config_block_sptr config ) const
+{
+  const std::string type = config->get_value< std::string >( "fusion_type", "nmw" );
+
+  return type == "nmw" || type == "wbf";
+}
+
+
+// -----------------------------------------------------------------------------
+kwiver::vital::detected_object_set_sptr
+merge_detections_nms_fusion
+::merge( std::vector< kwiver::vital::detected_object_set_sptr > const& sets ) const
+{
+  auto output = std::make_shared< kwiver::vital::detected_object_set >();
+
+  // Weights default to one per set when they do not match the inputs
+  std::vector< double > weights = d->m_fusion_weights;
+
+  if( weights.size() != sets.size() )
+  {
+    weights.assign( sets.size(), 1.0 );
+  }
+
+  double weight_sum = 0.0;
+
+  for( double w : weights )
+  {
+    weight_sum += w;
+  }
+
+  // Gather boxes of known classes in image coordinates
+  std::vector< std::vector< priv::fusion_box > > boxes( sets.size() );
+  double max_x = 0.0, max_y = 0.0;
+
+  for( unsigned s = 0; s < sets.size(); ++s )
+  {
+    if( !sets[s] )
+    {
+      continue;
+    }
+
+    for( auto det : *sets[s] )
+    {
+      if( !det->type() )
+      {
+        continue;
+      }
+
+      std::string class_name;
+      double class_score;
+      det->type()->get_most_likely( class_name, class_score );
+
+      auto label = d->m_label_dic.find( class_name );
+
+      if( label == d->m_label_dic.end() )
+      {
+        continue;
+      }
+
+      const auto& bbox = det->bounding_box();
+
+      priv::fusion_box b;
+      b.label = label->second;
+      b.score = class_score;
+      b.weight = ( d->m_fusion_type == "nmw" && weight_sum > 0.0 ?
+                   weights[s] / weight_sum : weights[s] );
+      b.x1 = bbox.min_x();
+      b.y1 = bbox.min_y();
+      b.x2 = bbox.max_x();
+      b.y2 = bbox.max_y();
+
+      max_x = std::max( max_x, b.x2 );
+      max_y = std::max( max_y, b.y2 );
+
+      boxes[s].push_back( b );
+    }
+  }
+
+  // Normalize, clip to the unit square and drop empty boxes
+  const double norm_width = ( d->m_width == 1.0 ? max_x + 1.0 : d->m_width );
+  const double norm_height = ( d->m_height == 1.0 ? max_y + 1.0 : d->m_height );
+
+  for( auto& set : boxes )
+  {
+    std::vector< priv::fusion_box > kept;
+
+    for( auto b : set )
+    {
+      b.x1 = std::min( 1.0, std::max( 0.0, b.x1 / norm_width ) );
+      b.x2 = std::min( 1.0, std::max( 0.0, b.x2 / norm_width ) );
+      b.y1 = std::min( 1.0, std::max( 0.0, b.y1 / norm_height ) );
+      b.y2 = std::min( 1.0, std::max( 0.0, b.y2 / norm_height ) );
+
+      if( b.x2 < b.x1 )
+      {
+        std::swap( b.x1, b.x2 );
+      }
+      if( b.y2 < b.y1 )
+      {
+        std::swap( b.y1, b.y2 );
+      }
+      if( ( b.x2 - b.x1 ) * ( b.y2 - b.y1 ) == 0.0 )
+      {
+        continue;
+      }
+
+      kept.push_back( b );
+    }
+
+    set.swap( kept );
+  }
+
+  // Utilize pseudonym lists when upsampling categories
+  std::vector< priv::box_columns > columns( boxes.size() );
+
+  for( unsigned s = 0; s < boxes.size() && !d->m_pseudo_ind.empty(); ++s )
+  {
+    for( const auto& b : boxes[s] )
+    {
+      columns[s].push_back( b );
+    }
+  }
+
+  for( const auto& chk : d->m_pseudo_ind )
+  {
+    if( chk.first < 0 || chk.first >= static_cast< int >( boxes.size() ) )
+    {
+      continue;
+    }
+
+    for( auto& b : boxes[ chk.first ] )
+    {
+      auto pseudonyms = d->m_pseudo_dic.find( b.label );
+
+      if( pseudonyms == d->m_pseudo_dic.end() )
+      {
+        continue;
+      }
+
+      for( int other : chk.second )
+      {
+        if( other < 0 || other >= static_cast< int >( boxes.size() ) )
+        {
+          continue;
+        }
+
+        const int best = columns[ other ].best_match( b, d->m_match_iou );
+
+        if( best >= 0 &&
+            std::count( pseudonyms->second.begin(), pseudonyms->second.end(),
+                        boxes[ other ][ best ].label ) )
+        {
+          b.label = boxes[ other ][ best ].label;
+          break;
+        }
+      }
+    }
+  }
+
+  // Run merging algorithm
+  std::vector< priv::fusion_box > fused;
+
+  if( d->m_fusion_type == "wbf" )
+  {
+    d->weighted_boxes_fusion( boxes, weights, fused );
+  }
+  else
+  {
+    d->non_maximum_weighted( boxes, fused );
+  }
+
+  std::stable_sort( fused.begin(), fused.end(),
+    []( const priv::fusion_box& a, const priv::fusion_box& b )
+    {
+      return a.score > b.score;
+    } );
+
+  // Compile output detections
+  for( const auto& b : fused )
+  {
+    auto name = d->m_id_dic.find( b.label );
+
+    if( name == d->m_id_dic.end() )
+    {
+      continue;
+    }
+
+    kwiver::vital::bounding_box_d bbox(
+      b.x1 * norm_width, b.y1 * norm_height,
+      b.x2 * norm_width, b.y2 * norm_height );
+
+    auto dot = std::make_shared< kwiver::vital::detected_object_type >(
+      name->second, b.score );
+
+    output->add( std::make_shared< kwiver::vital::detected_object >(
+      bbox, b.score, dot ) );
+  }
+
+  return output;
+}
+
+} // end namespace
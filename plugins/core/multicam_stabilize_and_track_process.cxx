@@ -0,0 +1,771 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Stabilize several cameras and track across them in one process
+ */
+
+#include "multicam_stabilize_and_track_process.h"
+#include "iou_tracker.h"
+#include "process_trace.h"
+#include "thread_pool.h"
+
+#include <vital/algo/detect_features.h>
+#include <vital/algo/estimate_homography.h>
+#include <vital/algo/extract_descriptors.h>
+#include <vital/algo/match_features.h>
+#include <vital/types/detected_object_set.h>
+#include <vital/types/homography.h>
+#include <vital/types/homography_f2f.h>
+#include <vital/types/image_container.h>
+#include <vital/types/object_track_set.h>
+#include <vital/types/timestamp.h>
+
+#include <sprokit/processes/kwiver_type_traits.h>
+#include <sprokit/pipeline/process_exception.h>
+
+#include <algorithm>
+#include <future>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+
+
+namespace kv = kwiver::vital;
+namespace algo = kwiver::vital::algo;
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( n_input, unsigned, "1",
+  "Number of cameras, at most 3, with image<i> and det_objs_<i> inputs" );
+create_config_trait( num_threads, unsigned, "0",
+  "Threads stabilizing cameras, one per connected camera if 0" );
+create_config_trait( min_matches, unsigned, "50",
+  "Minimum homography inliers for a frame to be registered to the previous "
+  "frame of its camera, or a camera to the first camera" );
+create_config_trait( inlier_scale, double, "10.0",
+  "Inlier distance scale passed to the homography estimator" );
+create_config_trait( reanchor_interval, unsigned, "0",
+  "If set, register cameras after the first to the first camera again "
+  "every this many frames, limiting drift between them. Otherwise they are "
+  "only registered when their frame to frame chain breaks." );
+create_config_trait( cross_camera_iou, double, "0.3",
+  "Minimum overlap in the reference frame for detections of two cameras "
+  "to be considered the same object" );
+create_config_trait( detection_threshold, double, "0.0",
+  "Detections below this confidence are ignored" );
+create_config_trait( min_iou, double, "0.1",
+  "Minimum overlap between a track's predicted box and a detection for "
+  "the two to be associated" );
+create_config_trait( new_track_threshold, double, "0.0",
+  "Minimum confidence of an unmatched detection to start a new track" );
+create_config_trait( max_missed_frames, unsigned, "5",
+  "Frames a track may go without a matching detection in any camera "
+  "before it is terminated" );
+create_config_trait( min_track_hits, unsigned, "1",
+  "Tracks are only output once they have matched this many detections" );
+create_config_trait( assignment, std::string, "greedy",
+  "How candidate pairs are assigned, either greedy (highest overlap first) "
+  "or hungarian (optimal within each group of overlapping boxes)" );
+
+create_port_trait( image1, image, "Image of camera 1" );
+create_port_trait( image2, image, "Image of camera 2" );
+create_port_trait( image3, image, "Image of camera 3" );
+create_port_trait( det_objs_1, detected_object_set, "Detections of camera 1" );
+create_port_trait( det_objs_2, detected_object_set, "Detections of camera 2" );
+create_port_trait( det_objs_3, detected_object_set, "Detections of camera 3" );
+create_port_trait( homog1, homography_src_to_ref,
+  "Homography from camera 1 to the reference frame" );
+create_port_trait( homog2, homography_src_to_ref,
+  "Homography from camera 2 to the reference frame" );
+create_port_trait( homog3, homography_src_to_ref,
+  "Homography from camera 3 to the reference frame" );
+create_port_trait( obj_tracks_1, object_track_set, "Tracks of camera 1" );
+create_port_trait( obj_tracks_2, object_track_set, "Tracks of camera 2" );
+create_port_trait( obj_tracks_3, object_track_set, "Tracks of camera 3" );
+
+static const unsigned max_cameras = 3;
+
+// =============================================================================
+// Registration state of one camera
+struct camera_state
+{
+  algo::detect_features_sptr detector;
+  algo::extract_descriptors_sptr extractor;
+  algo::match_features_sptr matcher;
+  algo::estimate_homography_sptr estimator;
+
+  // Features of the current and previous frames
+  kv::feature_set_sptr features;
+  kv::descriptor_set_sptr descriptors;
+  kv::feature_set_sptr prev_features;
+  kv::descriptor_set_sptr prev_descriptors;
+
+  // Current frame to the shared reference frame
+  kv::matrix_3x3d to_ref = kv::matrix_3x3d::Identity();
+  bool anchored = false;
+  kv::frame_id_t anchor_frame = 0;
+
+  // Track of each track id seen by this camera
+  std::map< kv::track_id_t, kv::track_sptr > tracks;
+};
+
+
+// -----------------------------------------------------------------------------
+// Homography mapping the features of a onto those of b, if well supported
+static bool
+register_features( camera_state const& cam,
+                   kv::feature_set_sptr const& feat_a,
+                   kv::descriptor_set_sptr const& desc_a,
+                   kv::feature_set_sptr const& feat_b,
+                   kv::descriptor_set_sptr const& desc_b,
+                   unsigned min_matches, double inlier_scale,
+                   kv::matrix_3x3d& a_to_b )
+{
+  if( !feat_a || !feat_b || !desc_a || !desc_b ||
+      feat_a->size() < min_matches || feat_b->size() < min_matches )
+  {
+    return false;
+  }
+
+  kv::match_set_sptr matches = cam.matcher->match( feat_a, desc_a, feat_b, desc_b );
+
+  if( !matches || matches->size() < min_matches )
+  {
+    return false;
+  }
+
+  std::vector< bool > inliers;
+  kv::homography_sptr h =
+    cam.estimator->estimate( feat_a, feat_b, matches, inliers, inlier_scale );
+
+  if( !h || static_cast< unsigned >(
+        std::count( inliers.begin(), inliers.end(), true ) ) < min_matches )
+  {
+    return false;
+  }
+
+  a_to_b = h->matrix();
+  return true;
+}
+
+
+// =============================================================================
+// Private implementation class
+class multicam_stabilize_and_track_process::priv
+{
+public:
+  explicit priv( multicam_stabilize_and_track_process* parent );
+  ~priv();
+
+  // Configuration settings
+  unsigned m_min_matches;
+  double m_inlier_scale;
+  unsigned m_reanchor_interval;
+  double m_cross_camera_iou;
+  double m_detection_threshold;
+
+  // Internal variables
+  std::vector< camera_state > m_cameras;
+  std::unique_ptr< thread_pool > m_workers;
+  std::unique_ptr< iou_tracker > m_tracker;
+  kv::frame_id_t m_reference_id;
+  kv::frame_id_t m_frame_counter;
+  bool m_warned_unanchored;
+
+  // Other variables
+  multicam_stabilize_and_track_process* parent;
+
+  // Registers a camera's frame to its previous frame, false on a break
+  bool stabilize( camera_state& cam, kv::image_container_sptr const& image );
+
+  // Registers a camera to the first camera on the current frame
+  bool anchor( camera_state& cam );
+};
+
+
+// -----------------------------------------------------------------------------
+multicam_stabilize_and_track_process::priv
+::priv( multicam_stabilize_and_track_process* ptr )
+  : m_min_matches( 50 )
+  , m_inlier_scale( 10.0 )
+  , m_reanchor_interval( 0 )
+  , m_cross_camera_iou( 0.3 )
+  , m_detection_threshold( 0.0 )
+  , m_reference_id( 0 )
+  , m_frame_counter( 0 )
+  , m_warned_unanchored( false )
+  , parent( ptr )
+{
+}
+
+
+multicam_stabilize_and_track_process::priv
+::~priv()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+multicam_stabilize_and_track_process::priv
+::stabilize( camera_state& cam, kv::image_container_sptr const& image )
+{
+  cam.prev_features = cam.features;
+  cam.prev_descriptors = cam.descriptors;
+  cam.features.reset();
+  cam.descriptors.reset();
+
+  if( !image )
+  {
+    return false;
+  }
+
+  cam.features = cam.detector->detect( image );
+  cam.descriptors = cam.extractor->extract( image, cam.features );
+
+  kv::matrix_3x3d to_prev;
+
+  if( !register_features( cam, cam.features, cam.descriptors,
+                          cam.prev_features, cam.prev_descriptors,
+                          m_min_matches, m_inlier_scale, to_prev ) )
+  {
+    return false;
+  }
+
+  cam.to_ref = cam.to_ref * to_prev;
+  return true;
+}
+
+
+bool
+multicam_stabilize_and_track_process::priv
+::anchor( camera_state& cam )
+{
+  camera_state const& first = m_cameras[ 0 ];
+  kv::matrix_3x3d to_first;
+
+  if( !register_features( cam, cam.features, cam.descriptors,
+                          first.features, first.descriptors,
+                          m_min_matches, m_inlier_scale, to_first ) )
+  {
+    return false;
+  }
+
+  cam.to_ref = first.to_ref * to_first;
+  return true;
+}
+
+
+// =============================================================================
+multicam_stabilize_and_track_process
+::multicam_stabilize_and_track_process( kv::config_block_sptr const& config )
+  : process( config ),
+    d( new multicam_stabilize_and_track_process::priv( this ) )
+{
+  make_ports();
+  make_config();
+}
+
+
+multicam_stabilize_and_track_process
+::~multicam_stabilize_and_track_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+multicam_stabilize_and_track_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t required;
+  sprokit::process::port_flags_t optional;
+
+  required.insert( flag_required );
+
+  // -- inputs --
+  declare_input_port_using_trait( timestamp, optional );
+  declare_input_port_using_trait( image1, required );
+  declare_input_port_using_trait( image2, optional );
+  declare_input_port_using_trait( image3, optional );
+  declare_input_port_using_trait( det_objs_1, required );
+  declare_input_port_using_trait( det_objs_2, optional );
+  declare_input_port_using_trait( det_objs_3, optional );
+
+  // -- outputs --
+  declare_output_port_using_trait( timestamp, optional );
+  declare_output_port_using_trait( homog1, optional );
+  declare_output_port_using_trait( homog2, optional );
+  declare_output_port_using_trait( homog3, optional );
+  declare_output_port_using_trait( obj_tracks_1, optional );
+  declare_output_port_using_trait( obj_tracks_2, optional );
+  declare_output_port_using_trait( obj_tracks_3, optional );
+}
+
+// -----------------------------------------------------------------------------
+void
+multicam_stabilize_and_track_process
+::make_config()
+{
+  declare_config_using_trait( n_input );
+  declare_config_using_trait( num_threads );
+  declare_config_using_trait( min_matches );
+  declare_config_using_trait( inlier_scale );
+  declare_config_using_trait( reanchor_interval );
+  declare_config_using_trait( cross_camera_iou );
+  declare_config_using_trait( detection_threshold );
+  declare_config_using_trait( min_iou );
+  declare_config_using_trait( new_track_threshold );
+  declare_config_using_trait( max_missed_frames );
+  declare_config_using_trait( min_track_hits );
+  declare_config_using_trait( assignment );
+}
+
+// -----------------------------------------------------------------------------
+void
+multicam_stabilize_and_track_process
+::_configure()
+{
+  d->m_min_matches = config_value_using_trait( min_matches );
+  d->m_inlier_scale = config_value_using_trait( inlier_scale );
+  d->m_reanchor_interval = config_value_using_trait( reanchor_interval );
+  d->m_cross_camera_iou = config_value_using_trait( cross_camera_iou );
+  d->m_detection_threshold = config_value_using_trait( detection_threshold );
+
+  iou_tracker_settings settings;
+
+  settings.min_iou = config_value_using_trait( min_iou );
+  settings.new_track_threshold = config_value_using_trait( new_track_threshold );
+  settings.max_missed_frames = config_value_using_trait( max_missed_frames );
+  settings.min_track_hits = config_value_using_trait( min_track_hits );
+
+  const std::string assignment = config_value_using_trait( assignment );
+
+  if( assignment != "greedy" && assignment != "hungarian" )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+      "Invalid assignment: " + assignment );
+  }
+
+  settings.hungarian = ( assignment == "hungarian" );
+  d->m_tracker.reset( new iou_tracker( settings ) );
+
+  const unsigned camera_count = config_value_using_trait( n_input );
+
+  if( camera_count < 1 || camera_count > max_cameras )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+      "n_input must be between 1 and " + std::to_string( max_cameras ) );
+  }
+
+  kv::config_block_sptr algo_config = get_config();
+
+  d->m_cameras.clear();
+  d->m_cameras.resize( camera_count );
+
+  // Each camera runs its own algorithm instances on its own thread
+  for( auto& cam : d->m_cameras )
+  {
+    algo::detect_features::set_nested_algo_configuration(
+      "feature_detector", algo_config, cam.detector );
+    algo::extract_descriptors::set_nested_algo_configuration(
+      "descriptor_extractor", algo_config, cam.extractor );
+    algo::match_features::set_nested_algo_configuration(
+      "feature_matcher", algo_config, cam.matcher );
+    algo::estimate_homography::set_nested_algo_configuration(
+      "homography_estimator", algo_config, cam.estimator );
+
+    if( !cam.detector || !cam.extractor || !cam.matcher || !cam.estimator )
+    {
+      VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+        "Unable to create feature_detector, descriptor_extractor, "
+        "feature_matcher or homography_estimator" );
+    }
+  }
+
+  algo::detect_features::get_nested_algo_configuration(
+    "feature_detector", algo_config, d->m_cameras[ 0 ].detector );
+  algo::extract_descriptors::get_nested_algo_configuration(
+    "descriptor_extractor", algo_config, d->m_cameras[ 0 ].extractor );
+  algo::match_features::get_nested_algo_configuration(
+    "feature_matcher", algo_config, d->m_cameras[ 0 ].matcher );
+  algo::estimate_homography::get_nested_algo_configuration(
+    "homography_estimator", algo_config, d->m_cameras[ 0 ].estimator );
+
+  const unsigned num_threads = config_value_using_trait( num_threads );
+
+  d->m_workers.reset( new thread_pool( num_threads > 0 ? num_threads : camera_count ) );
+  d->m_frame_counter = 0;
+  d->m_warned_unanchored = false;
+}
+
+// -----------------------------------------------------------------------------
+void
+multicam_stabilize_and_track_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  const size_t camera_count = d->m_cameras.size();
+
+  kv::timestamp timestamp;
+  std::vector< kv::image_container_sptr > images( camera_count );
+  std::vector< kv::detected_object_set_sptr > detections( camera_count );
+
+  if( has_input_port_edge_using_trait( timestamp ) )
+  {
+    timestamp = grab_from_port_using_trait( timestamp );
+  }
+
+  for( size_t c = 0; c < camera_count; ++c )
+  {
+    const std::string index = std::to_string( c + 1 );
+
+    images[ c ] = grab_from_port_as< kv::image_container_sptr >( "image" + index );
+
+    if( has_input_port_edge( "det_objs_" + index ) )
+    {
+      detections[ c ] =
+        grab_from_port_as< kv::detected_object_set_sptr >( "det_objs_" + index );
+    }
+  }
+
+  trace.inputs_ready();
+
+  if( !timestamp.has_valid_frame() )
+  {
+    timestamp.set_frame( d->m_frame_counter );
+  }
+  d->m_frame_counter = timestamp.get_frame() + 1;
+
+  const kv::frame_id_t frame = timestamp.get_frame();
+
+  // Register every camera to its previous frame concurrently
+  std::vector< std::future< bool > > linked_futures;
+
+  for( size_t c = 0; c < camera_count; ++c )
+  {
+    linked_futures.push_back( d->m_workers->enqueue(
+      [this, c, &images]
+      {
+        return d->stabilize( d->m_cameras[ c ], images[ c ] );
+      } ) );
+  }
+
+  std::vector< bool > linked( camera_count );
+
+  for( size_t c = 0; c < camera_count; ++c )
+  {
+    linked[ c ] = linked_futures[ c ].get();
+  }
+
+  // The first camera defines the reference frame, restarted on a break
+  camera_state& first = d->m_cameras[ 0 ];
+  bool reference_changed = false;
+
+  if( !linked[ 0 ] || !first.anchored )
+  {
+    first.to_ref = kv::matrix_3x3d::Identity();
+    first.anchored = true;
+    d->m_reference_id = frame;
+    reference_changed = true;
+  }
+
+  // Then register the other cameras to it where needed
+  std::vector< std::future< bool > > anchor_futures( camera_count );
+
+  for( size_t c = 1; c < camera_count; ++c )
+  {
+    camera_state& cam = d->m_cameras[ c ];
+
+    const bool reanchor = d->m_reanchor_interval > 0 &&
+      frame >= cam.anchor_frame + d->m_reanchor_interval;
+
+    if( !linked[ c ] || !cam.anchored || reference_changed || reanchor )
+    {
+      anchor_futures[ c ] = d->m_workers->enqueue(
+        [this, c]{ return d->anchor( d->m_cameras[ c ] ); } );
+    }
+  }
+
+  for( size_t c = 1; c < camera_count; ++c )
+  {
+    camera_state& cam = d->m_cameras[ c ];
+
+    if( !anchor_futures[ c ].valid() )
+    {
+      continue;
+    }
+
+    if( anchor_futures[ c ].get() )
+    {
+      cam.anchored = true;
+      cam.anchor_frame = frame;
+    }
+    else if( !linked[ c ] || reference_changed )
+    {
+      // A failed periodic registration keeps the existing chain
+      cam.anchored = false;
+    }
+  }
+
+  trace.count( "cameras", camera_count );
+
+  // Tracks follow the reference frame when it changes
+  if( reference_changed )
+  {
+    d->m_tracker->reseed(
+      [&]( kv::track_id_t id, kv::bounding_box_d& box )
+      {
+        for( auto const& cam : d->m_cameras )
+        {
+          auto itr = cam.tracks.find( id );
+
+          if( !cam.anchored || itr == cam.tracks.end() || itr->second->empty() )
+          {
+            continue;
+          }
+
+          auto state = std::static_pointer_cast< kv::object_track_state >(
+            itr->second->back() );
+
+          box = map_box( cam.to_ref, state->detection()->bounding_box() );
+          return true;
+        }
+        return false;
+      } );
+  }
+
+  // Detections of all anchored cameras in the reference frame
+  struct camera_detection
+  {
+    unsigned camera;
+    kv::detected_object_sptr det;
+    kv::bounding_box_d box;
+  };
+
+  std::vector< camera_detection > dets;
+
+  for( size_t c = 0; c < camera_count; ++c )
+  {
+    camera_state const& cam = d->m_cameras[ c ];
+
+    if( !detections[ c ] )
+    {
+      continue;
+    }
+
+    if( !cam.anchored )
+    {
+      if( !d->m_warned_unanchored && !detections[ c ]->empty() )
+      {
+        LOG_WARN( logger(), "Camera " << c + 1 << " could not be registered "
+                            "to camera 1, skipping its detections" );
+        d->m_warned_unanchored = true;
+      }
+      continue;
+    }
+
+    for( auto det : *detections[ c ] )
+    {
+      if( det && det->confidence() >= d->m_detection_threshold )
+      {
+        dets.push_back( camera_detection{ static_cast< unsigned >( c ), det,
+          map_box( cam.to_ref, det->bounding_box() ) } );
+      }
+    }
+  }
+
+  trace.count( "detections", dets.size() );
+
+  // Merge detections of different cameras overlapping in the reference
+  // frame, sweeping over boxes sorted by their left edge
+  std::vector< unsigned > order( dets.size() ), group( dets.size() );
+  std::iota( order.begin(), order.end(), 0 );
+  std::iota( group.begin(), group.end(), 0 );
+
+  std::sort( order.begin(), order.end(), [&]( unsigned a, unsigned b )
+    {
+      return dets[ a ].box.min_x() < dets[ b ].box.min_x();
+    } );
+
+  auto find = [&]( unsigned n )
+  {
+    while( group[ n ] != n )
+    {
+      group[ n ] = group[ group[ n ] ];
+      n = group[ n ];
+    }
+    return n;
+  };
+
+  if( camera_count > 1 )
+  {
+    for( size_t i = 0; i < order.size(); ++i )
+    {
+      camera_detection const& a = dets[ order[ i ] ];
+
+      for( size_t j = i + 1; j < order.size(); ++j )
+      {
+        camera_detection const& b = dets[ order[ j ] ];
+
+        if( b.box.min_x() >= a.box.max_x() )
+        {
+          break;
+        }
+
+        if( a.camera != b.camera &&
+            box_iou( a.box, b.box ) >= d->m_cross_camera_iou )
+        {
+          group[ find( order[ i ] ) ] = find( order[ j ] );
+        }
+      }
+    }
+  }
+
+  // One box per object, the most confident of its detections
+  std::vector< kv::bounding_box_d > boxes;
+  std::vector< double > confidences;
+  std::vector< unsigned > object_of( dets.size() );
+  std::map< unsigned, unsigned > object_of_group;
+
+  for( size_t i = 0; i < dets.size(); ++i )
+  {
+    const unsigned g = find( static_cast< unsigned >( i ) );
+    auto itr = object_of_group.find( g );
+    const double confidence = dets[ i ].det->confidence();
+
+    if( itr == object_of_group.end() )
+    {
+      object_of_group[ g ] = static_cast< unsigned >( boxes.size() );
+      object_of[ i ] = static_cast< unsigned >( boxes.size() );
+      boxes.push_back( dets[ i ].box );
+      confidences.push_back( confidence );
+    }
+    else
+    {
+      object_of[ i ] = itr->second;
+
+      if( confidence > confidences[ itr->second ] )
+      {
+        boxes[ itr->second ] = dets[ i ].box;
+        confidences[ itr->second ] = confidence;
+      }
+    }
+  }
+
+  const std::vector< kv::track_id_t > ids = d->m_tracker->update( boxes, confidences );
+
+  trace.count( "objects", boxes.size() );
+
+  // Most confident detections first, so each camera keeps its best one
+  // when several of its detections join the same object
+  std::stable_sort( order.begin(), order.end(), [&]( unsigned a, unsigned b )
+    {
+      return dets[ a ].det->confidence() > dets[ b ].det->confidence();
+    } );
+
+  for( unsigned i : order )
+  {
+    const kv::track_id_t id = ids[ object_of[ i ] ];
+
+    if( id < 0 )
+    {
+      continue;
+    }
+
+    kv::track_sptr& trk = d->m_cameras[ dets[ i ].camera ].tracks[ id ];
+
+    if( !trk )
+    {
+      trk = kv::track::create();
+      trk->set_id( id );
+    }
+    else if( !trk->empty() && trk->back()->frame() == frame )
+    {
+      continue;
+    }
+
+    trk->append(
+      std::make_shared< kv::object_track_state >( timestamp, dets[ i ].det ) );
+  }
+
+  for( kv::track_id_t id : d->m_tracker->terminated() )
+  {
+    for( auto& cam : d->m_cameras )
+    {
+      cam.tracks.erase( id );
+    }
+  }
+
+  const std::vector< kv::track_id_t > confirmed = d->m_tracker->confirmed();
+
+  push_to_port_using_trait( timestamp, timestamp );
+
+  for( size_t c = 0; c < camera_count; ++c )
+  {
+    camera_state const& cam = d->m_cameras[ c ];
+    const std::string index = std::to_string( c + 1 );
+
+    std::vector< kv::track_sptr > output;
+
+    for( kv::track_id_t id : confirmed )
+    {
+      auto itr = cam.tracks.find( id );
+
+      if( itr != cam.tracks.end() )
+      {
+        output.push_back( itr->second );
+      }
+    }
+
+    // Cameras without a reference are reported as starting their own
+    const kv::matrix_3x3d to_ref =
+      ( cam.anchored ? cam.to_ref : kv::matrix_3x3d::Identity() );
+
+    push_to_port_as< kv::f2f_homography >( "homog" + index,
+      kv::f2f_homography( std::make_shared< kv::homography_< double > >( to_ref ),
+                          frame, cam.anchored ? d->m_reference_id : frame ) );
+    push_to_port_as< kv::object_track_set_sptr >( "obj_tracks_" + index,
+      std::make_shared< kv::object_track_set >( output ) );
+  }
+}
+
+} // end namespace core
+
+} // end namespace viame
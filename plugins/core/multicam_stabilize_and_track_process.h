@@ -0,0 +1,87 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Stabilize several cameras and track across them in one process
+ */
+
+#ifndef VIAME_MULTICAM_STABILIZE_AND_TRACK_PROCESS_H
+#define VIAME_MULTICAM_STABILIZE_AND_TRACK_PROCESS_H
+
+#include <sprokit/pipeline/process.h>
+
+#include <plugins/core/viame_processes_core_export.h>
+
+#include <memory>
+
+namespace viame
+{
+
+namespace core
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Stabilize several cameras and track across them in one process
+ *
+ * Each connected camera, up to three, is registered frame to frame on its
+ * own worker thread, and cameras after the first are then anchored to the
+ * first camera so all of them share its reference frame. Detections of all
+ * cameras are mapped into that frame, where those seen by several cameras
+ * are merged, and linked into tracks by an iou_tracker. Each camera gets
+ * its own track set, with the same track ids for the same objects, and its
+ * homography to the shared reference frame.
+ */
+class VIAME_PROCESSES_CORE_NO_EXPORT multicam_stabilize_and_track_process
+  : public sprokit::process
+{
+public:
+  // -- CONSTRUCTORS --
+  multicam_stabilize_and_track_process( kwiver::vital::config_block_sptr const& config );
+  virtual ~multicam_stabilize_and_track_process();
+
+protected:
+  virtual void _configure();
+  virtual void _step();
+
+private:
+  void make_ports();
+  void make_config();
+
+  class priv;
+  const std::unique_ptr<priv> d;
+
+}; // end class multicam_stabilize_and_track_process
+
+} // end namespace core
+} // end namespace viame
+
+#endif // VIAME_MULTICAM_STABILIZE_AND_TRACK_PROCESS_H
@@ -30,48 +30,107 @@
 
 #include "notes_to_attributes.h"
 
-#include <vital/util/tokenize.h>
+#include <algorithm>
 
 namespace viame
 {
 
-std::string
-format_note( const std::string& str, const std::string delim )
+// -----------------------------------------------------------------------------
+static void
+format_note( std::string_view str, std::string_view delim, std::string& output )
 {
   if( str.empty() )
   {
-    return "";
+    return;
   }
-  else if( str[0] == '(' )
+
+  output += delim;
+
+  if( str[0] == '(' )
   {
-    return delim + str;
+    output += str;
   }
-  else if( str.find_first_of( ',' ) != std::string::npos )
+  else if( str.find_first_of( ',' ) != std::string_view::npos )
   {
-    return delim + "(note) \"" + str + "\"";
+    output += "(note) \"";
+    output += str;
+    output += "\"";
   }
   else
   {
-    return delim + "(note) " + str;
+    output += "(note) ";
+    output += str;
   }
 }
 
-std::string
-notes_to_attributes( const std::vector< std::string >& notes,
-                     const std::string delim )
+// -----------------------------------------------------------------------------
+csv_attribute
+parse_attribute( std::string_view field )
 {
-  std::string output;
+  csv_attribute output;
+
+  if( field.empty() || field[0] != '(' )
+  {
+    return output;
+  }
+
+  const std::size_t type_end = field.find( ' ' );
+  const std::string_view type = field.substr( 0, type_end );
 
-  for( std::string note : notes )
+  if( type == "(note)" )
+  {
+    output.type = csv_attribute_type::note;
+    output.value = ( field.size() > 7 ? field.substr( 7 ) : std::string_view() );
+    output.has_value = true;
+    return output;
+  }
+  else if( type == "(kp)" )
+  {
+    output.type = csv_attribute_type::keypoint;
+  }
+  else if( type == "(atr)" )
+  {
+    output.type = csv_attribute_type::attribute;
+  }
+  else
+  {
+    return output;
+  }
+
+  if( type_end == std::string_view::npos )
+  {
+    // No key, not a valid attribute
+    output.type = csv_attribute_type::unknown;
+    return output;
+  }
+
+  const std::size_t key_end = field.find( ' ', type_end + 1 );
+  output.key = field.substr( type_end + 1, key_end - ( type_end + 1 ) );
+
+  if( key_end != std::string_view::npos )
+  {
+    output.value = field.substr( key_end + 1 );
+    output.has_value = true;
+  }
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+void
+notes_to_attributes( const std::vector< std::string >& notes,
+                     std::string_view delim,
+                     std::string& output )
+{
+  for( std::string_view note : notes )
   {
     while( !note.empty() )
     {
       std::size_t pos = note.find_first_of( ':' );
       std::size_t pos2 = note.find_first_of( '=' );
 
-      if( pos == std::string::npos || pos2 == std::string::npos || pos2 == pos + 1 )
+      if( pos == std::string_view::npos || pos2 == std::string_view::npos || pos2 == pos + 1 )
       {
-        output += format_note( note, delim );
+        format_note( note, delim, output );
         break;
       }
       else if( note[0] == ' ' )
@@ -80,7 +139,7 @@ notes_to_attributes( const std::vector< std::string >& notes,
       }
       else if( pos != 0 )
       {
-        output += format_note( note.substr( 0, pos ), delim );
+        format_note( note.substr( 0, pos ), delim, output );
         note = note.substr( pos );
       }
       else if( note[0] == ':' )
@@ -90,21 +149,22 @@ notes_to_attributes( const std::vector< std::string >& notes,
 
         pos = note.find_first_of( ':' );
 
-        while( pos != std::string::npos && pos > 0 && note[pos-1] == ' ' )
+        while( pos != std::string_view::npos && pos > 0 && note[pos-1] == ' ' )
         {
           pos--;
         }
 
-        std::size_t value_len = ( pos == std::string::npos ?
+        std::size_t value_len = ( pos == std::string_view::npos ?
                                   note.size() - pos2 - 1 :
                                   pos - pos2 - 1 );
 
-        std::string category = note.substr( 0, pos2 );
-        std::string value = note.substr( pos2 + 1, value_len );
+        output += delim;
+        output += "(atr) ";
+        output += note.substr( 0, pos2 );
+        output += " ";
+        output += note.substr( pos2 + 1, value_len );
 
-        output += delim + "(atr) " + category + " " + value;
-
-        if( pos == std::string::npos )
+        if( pos == std::string_view::npos )
         {
           break;
         }
@@ -115,55 +175,59 @@ notes_to_attributes( const std::vector< std::string >& notes,
       }
     }
   }
+}
 
+// -----------------------------------------------------------------------------
+std::string
+notes_to_attributes( const std::vector< std::string >& notes,
+                     const std::string delim )
+{
+  std::string output;
+  notes_to_attributes( notes, delim, output );
   return output;
 }
 
-void
-add_attributes_to_detection( kwiver::vital::detected_object& detection,
-                             const std::vector< std::string >& attrs )
+// -----------------------------------------------------------------------------
+template < typename String >
+static void
+add_attributes( kwiver::vital::detected_object& detection,
+                const std::vector< String >& attrs )
 {
   for( unsigned i = 0; i < attrs.size(); ++i )
   {
-    const std::string& attr = attrs[i];
-
-    if( attr.empty() || attr[0] != '(' )
-    {
-      continue;
-    }
-
-    // tokensize attribute
-    std::vector< std::string > col;
-    kwiver::vital::tokenize( attr, col, " ", false );
+    const std::string_view attr = attrs[i];
+    const csv_attribute parsed = parse_attribute( attr );
 
-    if( col.empty() )
+    if( parsed.type == csv_attribute_type::keypoint )
     {
-      continue;
-    }
-
-    if( col[0] == "(kp)" )
-    {
-      if( col.size() != 4 )
+      // Name and exactly two coordinates
+      if( std::count( attr.begin(), attr.end(), ' ' ) != 3 )
       {
         continue; // throw error
       }
 
-      detection.add_keypoint( col[1], { std::stod( col[2] ),
-                                        std::stod( col[3] ) } );
+      const std::size_t split = parsed.value.find( ' ' );
+
+      detection.add_keypoint( std::string( parsed.key ),
+        { std::stod( std::string( parsed.value.substr( 0, split ) ) ),
+          std::stod( std::string( parsed.value.substr( split + 1 ) ) ) } );
     }
-    else if( col[0] == "(note)" )
+    else if( parsed.type == csv_attribute_type::note )
     {
-      std::string full_note = attr.substr( 7 );
+      std::string full_note( parsed.value );
 
       if( attr.size() > 7 && attr[7] == '\"' && attr.back() != '\"' )
       {
         for( unsigned j = i + 1; j < attrs.size(); j++ )
         {
-          full_note += "," + attrs[j];
+          const std::string_view next = attrs[j];
+
+          full_note += ",";
+          full_note += next;
 
           i++;
 
-          if( attrs[j].back() == '\"' )
+          if( !next.empty() && next.back() == '\"' )
           {
             break;
           }
@@ -172,27 +236,21 @@ add_attributes_to_detection( kwiver::vital::detected_object& detection,
 
       detection.add_note( full_note );
     }
-    else if( col[0] == "(atr)" )
+    else if( parsed.type == csv_attribute_type::attribute )
     {
-      if( col.size() < 2 )
-      {
-        continue; // throw error
-      }
-
-      std::string formatted_note = ":" + col[1];
+      std::string formatted_note;
+      formatted_note.reserve( parsed.key.size() + parsed.value.size() + 6 );
+      formatted_note += ":";
+      formatted_note += parsed.key;
 
-      if( col.size() == 2 )
+      if( !parsed.has_value )
       {
         formatted_note += "=true";
       }
-      else if( col.size() > 2 )
+      else
       {
-        formatted_note += "=" + col[2];
-
-        for( unsigned i = 3; i < col.size(); ++i )
-        {
-          formatted_note += " " + col[i];
-        }
+        formatted_note += "=";
+        formatted_note += parsed.value;
       }
 
       detection.add_note( formatted_note );
@@ -200,4 +258,20 @@ add_attributes_to_detection( kwiver::vital::detected_object& detection,
   }
 }
 
+// -----------------------------------------------------------------------------
+void
+add_attributes_to_detection( kwiver::vital::detected_object& detection,
+                             const std::vector< std::string >& attrs )
+{
+  add_attributes( detection, attrs );
+}
+
+// -----------------------------------------------------------------------------
+void
+add_attributes_to_detection( kwiver::vital::detected_object& detection,
+                             const std::vector< std::string_view >& attrs )
+{
+  add_attributes( detection, attrs );
+}
+
 } // end namespace
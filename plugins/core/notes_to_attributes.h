@@ -41,6 +41,7 @@
 #include <vital/types/detected_object.h>
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
 
@@ -48,16 +49,60 @@ namespace viame
 {
 
 
+/// Kind of an attribute field in a viame csv row
+enum class csv_attribute_type
+{
+  unknown,
+  keypoint,
+  note,
+  attribute
+};
+
+/// Attribute field of a viame csv row, as views into the field
+struct csv_attribute
+{
+  csv_attribute_type type = csv_attribute_type::unknown;
+
+  /// Keypoint name or attribute name, empty for notes
+  std::string_view key;
+
+  /// Remainder of the field after the key, or the note text
+  std::string_view value;
+
+  /// False for attributes given by name only, which are flags set to true
+  bool has_value = false;
+};
+
+
+/// Split an attribute field such as "(kp) head 10 20" or "(atr) length 5"
+VIAME_CORE_EXPORT csv_attribute
+parse_attribute( std::string_view field );
+
+
 VIAME_CORE_EXPORT std::string
 notes_to_attributes( const std::vector< std::string >& notes,
                      const std::string delim = "," );
 
 
+/// Append the attribute fields of notes to output, which callers can reuse
+/// across rows to avoid reallocating it
+VIAME_CORE_EXPORT void
+notes_to_attributes( const std::vector< std::string >& notes,
+                     std::string_view delim,
+                     std::string& output );
+
+
 VIAME_CORE_EXPORT void
 add_attributes_to_detection( kwiver::vital::detected_object& detection,
                              const std::vector< std::string >& attrs );
 
 
+/// Overload on views of the row fields, as given by csv_line_parser
+VIAME_CORE_EXPORT void
+add_attributes_to_detection( kwiver::vital::detected_object& detection,
+                             const std::vector< std::string_view >& attrs );
+
+
 } // end namespace
 
 #endif // VIAME_CORE_NOTES_TO_ATTRIBUTES_H
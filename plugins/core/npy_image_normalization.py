@@ -31,8 +31,7 @@ from __future__ import print_function
 
 from kwiver.vital.algo import ImageFilter
 
-from kwiver.vital.types import Image
-from kwiver.vital.types import ImageContainer
+from viame.arrows.core.image_arrays import as_array, from_array
 
 import numpy as np
 
@@ -54,7 +53,7 @@ class PercentileNorm16BitTo8Bit( ImageFilter ):
     return True
 
   def filter( self, in_img ):
-    img = in_img.image().asarray().astype( "uint16" )
+    img = np.asarray( as_array( in_img ), dtype=np.uint16 )
 
     mi = np.percentile( img, 1 )
     ma = np.percentile( img, 100 )
@@ -63,7 +62,7 @@ class PercentileNorm16BitTo8Bit( ImageFilter ):
     normalized = normalized * 255
     normalized[ normalized < 0 ] = 0
 
-    output = ImageContainer( Image( normalized.astype( "uint8" ) ) )
+    output = from_array( normalized.astype( "uint8" ) )
     return output
 
 def __vital_algorithm_register__():
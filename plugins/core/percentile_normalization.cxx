@@ -0,0 +1,290 @@
+ /*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "percentile_normalization.h"
+
+#include <vital/exceptions.h>
+#include <vital/types/image_container.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Storage class for private member variables
+ */
+class percentile_normalization::priv
+{
+public:
+
+  priv()
+   : m_lower_percentile( 1.0 )
+   , m_upper_percentile( 100.0 )
+   , m_max_samples( 1000000 )
+  {}
+
+  ~priv() {}
+
+  double m_lower_percentile;
+  double m_upper_percentile;
+  unsigned m_max_samples;
+
+  // Reused between frames
+  std::vector< uint64_t > m_histogram;
+  std::vector< uint8_t > m_lut;
+
+  // Percentile of the histogram with numpy's linear interpolation
+  static double percentile( const std::vector< uint64_t >& histogram,
+                            uint64_t count, double pct );
+
+  template< typename T >
+  kwiver::vital::image normalize( const kwiver::vital::image& input );
+};
+
+
+// -----------------------------------------------------------------------------
+double
+percentile_normalization::priv
+::percentile( const std::vector< uint64_t >& histogram, uint64_t count, double pct )
+{
+  const double rank = std::min( 100.0, std::max( 0.0, pct ) ) / 100.0 * ( count - 1 );
+  const uint64_t lower = static_cast< uint64_t >( std::floor( rank ) );
+  const double fraction = rank - lower;
+
+  // Values holding sorted positions lower and lower + 1
+  double lower_value = 0.0, upper_value = 0.0;
+  uint64_t seen = 0;
+  bool found_lower = false;
+
+  for( size_t v = 0; v < histogram.size(); ++v )
+  {
+    seen += histogram[v];
+
+    if( !found_lower && seen > lower )
+    {
+      lower_value = static_cast< double >( v );
+      found_lower = true;
+    }
+    if( found_lower && ( seen > lower + 1 || seen == count ) )
+    {
+      upper_value = static_cast< double >( v );
+      break;
+    }
+  }
+
+  return lower_value + ( upper_value - lower_value ) * fraction;
+}
+
+
+// -----------------------------------------------------------------------------
+template< typename T >
+kwiver::vital::image
+percentile_normalization::priv
+::normalize( const kwiver::vital::image& input )
+{
+  const size_t width = input.width();
+  const size_t height = input.height();
+  const size_t depth = input.depth();
+  const size_t total = width * height * depth;
+
+  const ptrdiff_t w_step = input.w_step();
+  const ptrdiff_t h_step = input.h_step();
+  const ptrdiff_t d_step = input.d_step();
+
+  const T* src = static_cast< const T* >( input.first_pixel() );
+
+  // Histogram of a strided sample of all values, about max_samples of them
+  const size_t stride = ( m_max_samples > 0 && total > m_max_samples ?
+    ( total + m_max_samples - 1 ) / m_max_samples : 1 );
+
+  m_histogram.assign( size_t( 1 ) << ( 8 * sizeof( T ) ), 0 );
+  uint64_t count = 0;
+
+  for( size_t index = 0; index < total; index += stride )
+  {
+    const size_t k = index % depth;
+    const size_t i = ( index / depth ) % width;
+    const size_t j = index / ( depth * width );
+
+    m_histogram[ src[ j * h_step + i * w_step + k * d_step ] ]++;
+    count++;
+  }
+
+  const double lower = percentile( m_histogram, count, m_lower_percentile );
+  const double upper = percentile( m_histogram, count, m_upper_percentile );
+
+  // Every input value maps through a table, so conversion is one lookup
+  m_lut.resize( m_histogram.size() );
+
+  const double scale = ( upper > lower ? 255.0 / ( upper - lower ) : 0.0 );
+
+  for( size_t v = 0; v < m_lut.size(); ++v )
+  {
+    const double value = ( static_cast< double >( v ) - lower ) * scale;
+    m_lut[v] = static_cast< uint8_t >( std::min( 255.0, std::max( 0.0, value ) ) );
+  }
+
+  kwiver::vital::image_of< uint8_t > output( width, height, depth, true );
+
+  uint8_t* dst = output.first_pixel();
+  const uint8_t* lut = m_lut.data();
+
+  for( size_t j = 0; j < height; ++j )
+  {
+    const T* src_row = src + j * h_step;
+    uint8_t* dst_row = dst + j * output.h_step();
+
+    if( d_step == 1 && w_step == static_cast< ptrdiff_t >( depth ) )
+    {
+      for( size_t i = 0; i < width * depth; ++i )
+      {
+        dst_row[i] = lut[ src_row[i] ];
+      }
+      continue;
+    }
+
+    for( size_t i = 0; i < width; ++i )
+    {
+      for( size_t k = 0; k < depth; ++k )
+      {
+        dst_row[ i * depth + k ] = lut[ src_row[ i * w_step + k * d_step ] ];
+      }
+    }
+  }
+
+  return output;
+}
+
+// =============================================================================
+
+percentile_normalization
+::percentile_normalization()
+  : d( new priv )
+{}
+
+
+percentile_normalization
+::  ~percentile_normalization()
+{}
+
+
+// -----------------------------------------------------------------------------
+kwiver::vital::config_block_sptr
+percentile_normalization
+::get_configuration() const
+{
+  // Get base config from base class
+  kwiver::vital::config_block_sptr config =
+    kwiver::vital::algorithm::get_configuration();
+
+  config->set_value( "lower_percentile", d->m_lower_percentile,
+    "Percentile of the input values mapped to 0." );
+  config->set_value( "upper_percentile", d->m_upper_percentile,
+    "Percentile of the input values mapped to 255." );
+  config->set_value( "max_samples", d->m_max_samples,
+    "Approximate number of values sampled when computing percentiles, "
+    "0 to use every value." );
+
+  return config;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+percentile_normalization
+::set_configuration( kwiver::vital::config_block_sptr config_in )
+{
+  kwiver::vital::config_block_sptr config = this->get_configuration();
+  config->merge_config( config_in );
+
+  d->m_lower_percentile = config->get_value< double >( "lower_percentile" );
+  d->m_upper_percentile = config->get_value< double >( "upper_percentile" );
+  d->m_max_samples = config->get_value< unsigned >( "max_samples" );
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+percentile_normalization
+::check_configuration( kwiver::vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+
+// -----------------------------------------------------------------------------
+kwiver::vital::image_container_sptr
+percentile_normalization
+::filter( kwiver::vital::image_container_sptr image_data )
+{
+  if( !image_data )
+  {
+    return image_data;
+  }
+
+  const kwiver::vital::image& input = image_data->get_image();
+  const auto& traits = input.pixel_traits();
+
+  if( input.size() == 0 )
+  {
+    return image_data;
+  }
+
+  if( traits.type != kwiver::vital::image_pixel_traits::UNSIGNED )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+      "percentile_norm requires unsigned integer imagery" );
+  }
+
+  kwiver::vital::image output;
+
+  if( traits.num_bytes == 1 )
+  {
+    output = d->normalize< uint8_t >( input );
+  }
+  else if( traits.num_bytes == 2 )
+  {
+    output = d->normalize< uint16_t >( input );
+  }
+  else
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+      "percentile_norm supports 8 and 16-bit imagery" );
+  }
+
+  return std::make_shared< kwiver::vital::simple_image_container >( output );
+}
+
+} // end namespace
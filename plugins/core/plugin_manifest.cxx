@@ -0,0 +1,336 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "plugin_manifest.h"
+
+#include <vital/plugin_loader/plugin_factory.h>
+#include <vital/plugin_loader/plugin_manager_internal.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+namespace
+{
+
+// The manager only exposes loading whole directories, while modules are loaded
+// one file at a time by its loader
+class manifest_plugin_manager : public kv::plugin_manager_internal
+{
+public:
+  using kv::plugin_manager::get_loader;
+
+  static manifest_plugin_manager& instance()
+  {
+    return static_cast< manifest_plugin_manager& >(
+      kv::plugin_manager_internal::instance() );
+  }
+};
+
+// Schedulers used by embedded pipelines and kwiver runner when none is set
+const char* const default_schedulers[] = { "thread_per_process", "pythread_per_process" };
+
+// -----------------------------------------------------------------------------
+std::map< std::string, std::string >
+read_plugin_manifest( std::string const& filename )
+{
+  std::map< std::string, std::string > modules;
+  std::ifstream fin( filename );
+  std::string line;
+
+  while( std::getline( fin, line ) )
+  {
+    const size_t tab = line.find( '\t' );
+
+    if( tab != std::string::npos )
+    {
+      modules[ line.substr( 0, tab ) ] = line.substr( tab + 1 );
+    }
+  }
+  return modules;
+}
+
+// -----------------------------------------------------------------------------
+std::string
+trim( std::string const& str )
+{
+  const size_t first = str.find_first_not_of( " \t\r" );
+
+  if( first == std::string::npos )
+  {
+    return std::string();
+  }
+  return str.substr( first, str.find_last_not_of( " \t\r" ) - first + 1 );
+}
+
+// -----------------------------------------------------------------------------
+std::string
+find_include( std::string const& name, std::string const& directory )
+{
+  std::vector< std::string > candidates = { directory + "/" + name };
+
+  if( const char* paths = std::getenv( "SPROKIT_PIPE_INCLUDE_PATH" ) )
+  {
+    std::vector< std::string > entries;
+    kwiversys::SystemTools::Split( paths, entries,
+#ifdef _WIN32
+      ';'
+#else
+      ':'
+#endif
+      );
+
+    for( auto const& entry : entries )
+    {
+      candidates.push_back( entry + "/" + name );
+    }
+  }
+
+  for( auto const& candidate : candidates )
+  {
+    if( kwiversys::SystemTools::FileExists( candidate, true ) )
+    {
+      return candidate;
+    }
+  }
+  return std::string();
+}
+
+// -----------------------------------------------------------------------------
+void
+collect_pipeline_names( std::string const& filename,
+                        std::set< std::string >& visited,
+                        std::set< std::string >& names )
+{
+  if( !visited.insert( filename ).second )
+  {
+    return;
+  }
+
+  std::ifstream fin( filename );
+  const std::string directory = kwiversys::SystemTools::GetFilenamePath( filename );
+  std::string line;
+
+  while( std::getline( fin, line ) )
+  {
+    line = trim( line.substr( 0, line.find( '#' ) ) );
+
+    if( line.empty() )
+    {
+      continue;
+    }
+
+    if( line.compare( 0, 8, "include " ) == 0 )
+    {
+      const std::string path = find_include( trim( line.substr( 8 ) ), directory );
+
+      if( !path.empty() )
+      {
+        collect_pipeline_names( path, visited, names );
+      }
+      continue;
+    }
+
+    // Process types, either on their own line or after the process name
+    const size_t decl = line.find( "::" );
+
+    if( decl != std::string::npos &&
+        ( decl == 0 || line.compare( 0, 8, "process " ) == 0 ) )
+    {
+      std::istringstream type( line.substr( decl + 2 ) );
+      std::string name;
+
+      if( type >> name )
+      {
+        names.insert( name );
+      }
+      continue;
+    }
+
+    // Settings, as ":key value" in pipelines or "key = value" in config files
+    std::string key, value;
+    const size_t equals = line.find( '=' );
+
+    if( equals != std::string::npos )
+    {
+      key = trim( line.substr( 0, equals ) );
+      value = trim( line.substr( equals + 1 ) );
+    }
+    else if( line[0] == ':' )
+    {
+      const size_t space = line.find_first_of( " \t" );
+
+      if( space != std::string::npos )
+      {
+        key = line.substr( 0, space );
+        value = trim( line.substr( space ) );
+      }
+    }
+
+    const size_t sep = key.find_last_of( ": " );
+    const std::string leaf = ( sep == std::string::npos ? key : key.substr( sep + 1 ) );
+
+    if( leaf == "type" && !value.empty() )
+    {
+      names.insert( value );
+    }
+  }
+}
+
+} // end anonymous namespace
+
+// -----------------------------------------------------------------------------
+std::string
+default_plugin_manifest()
+{
+  const char* path = std::getenv( "VIAME_PLUGIN_MANIFEST" );
+  return path ? std::string( path ) : std::string();
+}
+
+// -----------------------------------------------------------------------------
+void
+write_plugin_manifest( std::string const& filename,
+                       std::vector< std::string > const& referenced )
+{
+  auto& vpm = manifest_plugin_manager::instance();
+  vpm.load_all_plugins();
+
+  std::ostringstream contents;
+  std::set< std::string > provided;
+
+  for( auto const& interface : vpm.plugin_map() )
+  {
+    for( auto const& factory : interface.second )
+    {
+      std::string name, file;
+
+      if( factory->get_attribute( kv::plugin_factory::PLUGIN_NAME, name ) &&
+          factory->get_attribute( kv::plugin_factory::PLUGIN_FILE_NAME, file ) )
+      {
+        contents << name << '\t' << file << '\n';
+        provided.insert( name );
+      }
+    }
+  }
+
+  // Referenced names no module provides, such as settings which happen to be
+  // called type, are kept with no file so that they do not force a full load
+  // on every run
+  for( auto const& name : referenced )
+  {
+    if( provided.insert( name ).second )
+    {
+      contents << name << '\t' << '\n';
+    }
+  }
+
+  // Written to a temporary first so that concurrent readers never see a
+  // partial manifest
+  const std::string temporary = filename + ".tmp";
+  {
+    std::ofstream fout( temporary );
+    fout << contents.str();
+
+    if( !fout )
+    {
+      return;
+    }
+  }
+  kwiversys::SystemTools::RenameFile( temporary, filename );
+}
+
+// -----------------------------------------------------------------------------
+void
+load_plugins_for( std::vector< std::string > const& names,
+                  std::string const& manifest )
+{
+  auto& vpm = manifest_plugin_manager::instance();
+
+  if( manifest.empty() )
+  {
+    vpm.load_all_plugins();
+    return;
+  }
+
+  const auto modules = read_plugin_manifest( manifest );
+  std::set< std::string > files;
+
+  for( auto const& name : names )
+  {
+    auto it = modules.find( name );
+
+    if( it == modules.end() )
+    {
+      write_plugin_manifest( manifest, names );
+      return;
+    }
+    if( !it->second.empty() )
+    {
+      files.insert( it->second );
+    }
+  }
+
+  // The default schedulers are loaded when a module provides them, as the
+  // pipeline may rely on them without naming one
+  for( auto scheduler : default_schedulers )
+  {
+    auto it = modules.find( scheduler );
+
+    if( it != modules.end() && !it->second.empty() )
+    {
+      files.insert( it->second );
+    }
+  }
+
+  for( auto const& file : files )
+  {
+    vpm.get_loader()->load_plugin( file );
+  }
+}
+
+// -----------------------------------------------------------------------------
+std::vector< std::string >
+pipeline_plugin_names( std::string const& pipeline_filename )
+{
+  std::set< std::string > visited, names;
+  collect_pipeline_names( pipeline_filename, visited, names );
+  return std::vector< std::string >( names.begin(), names.end() );
+}
+
+} // end namespace viame
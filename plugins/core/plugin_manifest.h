@@ -0,0 +1,88 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Loading of only the plugin modules that provide requested types
+ */
+
+#ifndef VIAME_CORE_PLUGIN_MANIFEST_H
+#define VIAME_CORE_PLUGIN_MANIFEST_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <string>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Default manifest location, from the VIAME_PLUGIN_MANIFEST variable
+ *
+ * Returns an empty string when the variable is not set.
+ */
+VIAME_CORE_EXPORT std::string default_plugin_manifest();
+
+/**
+ * @brief Load all plugins and record the module providing every plugin name
+ *
+ * Each line of the manifest holds a plugin name, such as an algorithm or
+ * process type, and the file of the module registering it, separated by a tab.
+ * Referenced names that no module provides are recorded with an empty file.
+ */
+VIAME_CORE_EXPORT void write_plugin_manifest(
+  std::string const& filename,
+  std::vector< std::string > const& referenced = std::vector< std::string >() );
+
+/**
+ * @brief Load the modules providing the given plugin names
+ *
+ * Falls back to loading all plugins when no manifest is given or readable, or
+ * when it lacks any of the names. In the latter case the manifest is rewritten,
+ * so that newly added modules are found on the next run.
+ */
+VIAME_CORE_EXPORT void load_plugins_for(
+  std::vector< std::string > const& names,
+  std::string const& manifest = default_plugin_manifest() );
+
+/**
+ * @brief Plugin names referenced by a pipeline file and the files it includes
+ *
+ * These are the process types, following "::", and the values of all type
+ * settings. Default schedulers are added by load_plugins_for.
+ */
+VIAME_CORE_EXPORT std::vector< std::string >
+pipeline_plugin_names( std::string const& pipeline_filename );
+
+} // end namespace viame
+
+#endif // VIAME_CORE_PLUGIN_MANIFEST_H
@@ -0,0 +1,269 @@
+#include "point_cloud_writer.h"
+
+#include <vital/exceptions.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+namespace {
+
+// Points buffered before each stream write
+constexpr size_t buffer_points = 65536;
+
+// Width of the zero padded PLY vertex count, rewritten on close
+constexpr int ply_count_width = 12;
+
+constexpr size_t las_header_size = 227;
+
+template <typename T> void put(std::vector<char> &buffer, T value) {
+  const char *bytes = reinterpret_cast<const char *>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T> void put_at(std::vector<char> &buffer, size_t offset, T value) {
+  std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+void put_text(std::vector<char> &buffer, const char *text, size_t size) {
+  const size_t length = std::min(std::strlen(text), size);
+  buffer.insert(buffer.end(), text, text + length);
+  buffer.insert(buffer.end(), size - length, '\0');
+}
+
+} // namespace
+
+
+viame::core::point_cloud_writer::format viame::core::point_cloud_writer::format_from_path(const std::string &path) {
+  if (path.size() >= 4) {
+    std::string extension = path.substr(path.size() - 4);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == ".las")
+      return format::LAS;
+  }
+  return format::PLY;
+}
+
+
+size_t viame::core::point_cloud_writer::voxel_hash::operator()(const std::array<std::int64_t, 3> &key) const {
+  std::uint64_t h = static_cast<std::uint64_t>(key[0]) * 73856093u;
+  h ^= static_cast<std::uint64_t>(key[1]) * 19349663u;
+  h ^= static_cast<std::uint64_t>(key[2]) * 83492791u;
+  return static_cast<size_t>(h);
+}
+
+
+viame::core::point_cloud_writer::point_cloud_writer(const std::string &path, format fmt, bool with_color,
+                                                    double voxel_size, double las_scale)
+    : m_path(path), m_format(fmt), m_with_color(with_color), m_voxel_size(voxel_size), m_las_scale(las_scale) {
+  if (m_format == format::LAS && !(m_las_scale > 0.))
+    VITAL_THROW(kwiver::vital::invalid_value, "LAS scale must be positive");
+
+  m_stream.open(m_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_stream)
+    VITAL_THROW(kwiver::vital::file_write_exception, m_path, "Unable to open point cloud file");
+
+  for (int i = 0; i < 3; ++i) {
+    m_min[i] = std::numeric_limits<double>::max();
+    m_max[i] = std::numeric_limits<double>::lowest();
+  }
+
+  if (m_format == format::PLY)
+    m_point_size = 3 * sizeof(float) + (m_with_color ? 3 : 0);
+  else
+    m_point_size = m_with_color ? 26 : 20; // point data formats 2 and 0
+
+  write_header();
+  m_buffer.reserve(buffer_points * m_point_size);
+}
+
+
+viame::core::point_cloud_writer::~point_cloud_writer() {
+  try {
+    close();
+  } catch (...) {
+  }
+}
+
+
+void viame::core::point_cloud_writer::write_header() {
+  std::vector<char> header;
+
+  if (m_format == format::PLY) {
+    char count[32];
+    std::snprintf(count, sizeof(count), "%0*d", ply_count_width, 0);
+
+    std::string text = "ply\nformat binary_little_endian 1.0\ncomment written by viame point_cloud_writer\n";
+    text += "element vertex " + std::string(count) + "\n";
+    text += "property float x\nproperty float y\nproperty float z\n";
+    if (m_with_color)
+      text += "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+    text += "end_header\n";
+
+    m_stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return;
+  }
+
+  // LAS 1.2 public header block, counts and bounds are filled in on close
+  const std::time_t now = std::time(nullptr);
+  const std::tm *date = std::gmtime(&now);
+
+  put_text(header, "LASF", 4);
+  put<std::uint16_t>(header, 0);    // file source id
+  put<std::uint16_t>(header, 0);    // global encoding
+  put_text(header, "", 16);         // project id
+  put<std::uint8_t>(header, 1);     // version major
+  put<std::uint8_t>(header, 2);     // version minor
+  put_text(header, "VIAME", 32);    // system identifier
+  put_text(header, "viame point_cloud_writer", 32);
+  put<std::uint16_t>(header, static_cast<std::uint16_t>(date ? date->tm_yday + 1 : 0));
+  put<std::uint16_t>(header, static_cast<std::uint16_t>(date ? date->tm_year + 1900 : 0));
+  put<std::uint16_t>(header, static_cast<std::uint16_t>(las_header_size));
+  put<std::uint32_t>(header, static_cast<std::uint32_t>(las_header_size)); // offset to point data
+  put<std::uint32_t>(header, 0);    // variable length records
+  put<std::uint8_t>(header, m_with_color ? 2 : 0);
+  put<std::uint16_t>(header, static_cast<std::uint16_t>(m_point_size));
+  put<std::uint32_t>(header, 0);    // point count
+  for (int i = 0; i < 5; ++i)
+    put<std::uint32_t>(header, 0);  // points by return
+  for (int i = 0; i < 3; ++i)
+    put<double>(header, m_las_scale);
+  for (int i = 0; i < 3; ++i)
+    put<double>(header, 0.);        // offsets
+  for (int i = 0; i < 6; ++i)
+    put<double>(header, 0.);        // max x, min x, max y, min y, max z, min z
+
+  m_stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+
+void viame::core::point_cloud_writer::add_point(float x, float y, float z, const std::uint8_t *rgb) {
+  if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z))
+    return;
+
+  if (m_voxel_size <= 0.) {
+    write_point(x, y, z, rgb);
+    return;
+  }
+
+  const std::array<std::int64_t, 3> key{static_cast<std::int64_t>(std::floor(x / m_voxel_size)),
+                                        static_cast<std::int64_t>(std::floor(y / m_voxel_size)),
+                                        static_cast<std::int64_t>(std::floor(z / m_voxel_size))};
+  auto &cell = m_voxels[key];
+  cell.x += x;
+  cell.y += y;
+  cell.z += z;
+  if (rgb) {
+    cell.r += rgb[0];
+    cell.g += rgb[1];
+    cell.b += rgb[2];
+  }
+  ++cell.count;
+}
+
+
+void viame::core::point_cloud_writer::end_frame() {
+  for (const auto &entry : m_voxels) {
+    const voxel &cell = entry.second;
+    const std::uint8_t rgb[3] = {static_cast<std::uint8_t>(cell.r / cell.count),
+                                 static_cast<std::uint8_t>(cell.g / cell.count),
+                                 static_cast<std::uint8_t>(cell.b / cell.count)};
+    write_point(static_cast<float>(cell.x / cell.count), static_cast<float>(cell.y / cell.count),
+                static_cast<float>(cell.z / cell.count), rgb);
+  }
+  m_voxels.clear();
+}
+
+
+void viame::core::point_cloud_writer::write_point(float x, float y, float z, const std::uint8_t *rgb) {
+  const double p[3] = {x, y, z};
+  for (int i = 0; i < 3; ++i) {
+    m_min[i] = std::min(m_min[i], p[i]);
+    m_max[i] = std::max(m_max[i], p[i]);
+  }
+
+  static const std::uint8_t black[3] = {0, 0, 0};
+  if (!rgb)
+    rgb = black;
+
+  if (m_format == format::PLY) {
+    put(m_buffer, x);
+    put(m_buffer, y);
+    put(m_buffer, z);
+    if (m_with_color)
+      m_buffer.insert(m_buffer.end(), rgb, rgb + 3);
+  } else {
+    for (int i = 0; i < 3; ++i) {
+      const double scaled = std::round(p[i] / m_las_scale);
+      if (std::abs(scaled) > std::numeric_limits<std::int32_t>::max())
+        VITAL_THROW(kwiver::vital::invalid_value, "Point coordinate out of range for the LAS scale");
+      put(m_buffer, static_cast<std::int32_t>(scaled));
+    }
+    put<std::uint16_t>(m_buffer, 0);    // intensity
+    put<std::uint8_t>(m_buffer, 0x09);  // return 1 of 1
+    put<std::uint8_t>(m_buffer, 0);     // classification
+    put<std::int8_t>(m_buffer, 0);      // scan angle
+    put<std::uint8_t>(m_buffer, 0);     // user data
+    put<std::uint16_t>(m_buffer, 0);    // point source id
+    if (m_with_color) {
+      for (int i = 0; i < 3; ++i)
+        put<std::uint16_t>(m_buffer, static_cast<std::uint16_t>(rgb[i] * 257));
+    }
+  }
+
+  ++m_point_count;
+  if (m_buffer.size() >= buffer_points * m_point_size)
+    flush_buffer();
+}
+
+
+void viame::core::point_cloud_writer::flush_buffer() {
+  m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+  m_buffer.clear();
+  if (!m_stream)
+    VITAL_THROW(kwiver::vital::file_write_exception, m_path, "Unable to write point cloud file");
+}
+
+
+void viame::core::point_cloud_writer::close() {
+  if (!m_stream.is_open())
+    return;
+
+  end_frame();
+  flush_buffer();
+
+  if (m_format == format::PLY) {
+    char count[32];
+    std::snprintf(count, sizeof(count), "%0*zu", ply_count_width, m_point_count);
+
+    const std::string prefix = "ply\nformat binary_little_endian 1.0\ncomment written by viame point_cloud_writer\n"
+                               "element vertex ";
+    m_stream.seekp(static_cast<std::streamoff>(prefix.size()));
+    m_stream.write(count, ply_count_width);
+  } else {
+    if (m_point_count > std::numeric_limits<std::uint32_t>::max())
+      VITAL_THROW(kwiver::vital::file_write_exception, m_path, "Too many points for a LAS 1.2 file");
+
+    std::vector<char> counts;
+    put<std::uint32_t>(counts, static_cast<std::uint32_t>(m_point_count));
+    put<std::uint32_t>(counts, static_cast<std::uint32_t>(m_point_count)); // all first returns
+    m_stream.seekp(107);
+    m_stream.write(counts.data(), static_cast<std::streamsize>(counts.size()));
+
+    std::vector<char> bounds;
+    const bool empty = m_point_count == 0;
+    for (int i = 0; i < 3; ++i) {
+      put<double>(bounds, empty ? 0. : m_max[i]);
+      put<double>(bounds, empty ? 0. : m_min[i]);
+    }
+    m_stream.seekp(179);
+    m_stream.write(bounds.data(), static_cast<std::streamsize>(bounds.size()));
+  }
+
+  m_stream.close();
+  if (m_stream.fail())
+    VITAL_THROW(kwiver::vital::file_write_exception, m_path, "Unable to complete point cloud file");
+}
@@ -0,0 +1,86 @@
+/**
+ * \file
+ * \brief Streaming binary PLY and LAS point cloud writer
+ */
+
+#ifndef VIAME_POINT_CLOUD_WRITER_H
+#define VIAME_POINT_CLOUD_WRITER_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace viame {
+namespace core {
+
+/// @brief Writes points to a binary little endian PLY or LAS 1.2 file as they are added, keeping only a small output
+///     buffer in memory. The point count and bounds are written into the header when the file is closed.
+///
+/// With a positive voxel size, the points of each frame are averaged per voxel of a regular grid and only the voxel
+/// averages are written, when the frame ends. Memory then grows with the voxels of one frame only.
+class VIAME_CORE_EXPORT point_cloud_writer {
+public:
+  enum class format { PLY, LAS };
+
+  /// @brief LAS for a .las path, PLY otherwise
+  static format format_from_path(const std::string &path);
+
+  /// @param las_scale: LAS coordinate resolution, in the units of the points
+  point_cloud_writer(const std::string &path, format fmt, bool with_color, double voxel_size = 0.,
+                     double las_scale = 0.001);
+  ~point_cloud_writer();
+
+  point_cloud_writer(const point_cloud_writer &) = delete;
+  point_cloud_writer &operator=(const point_cloud_writer &) = delete;
+
+  /// @brief Add a point, rgb may be null when the writer has no color
+  void add_point(float x, float y, float z, const std::uint8_t *rgb = nullptr);
+
+  /// @brief Write the voxel averages of the current frame
+  void end_frame();
+
+  /// @brief End the current frame, complete the header and close the file
+  void close();
+
+  size_t point_count() const { return m_point_count; }
+
+private:
+  struct voxel {
+    double x{}, y{}, z{};
+    std::uint32_t r{}, g{}, b{};
+    std::uint32_t count{};
+  };
+
+  struct voxel_hash {
+    size_t operator()(const std::array<std::int64_t, 3> &key) const;
+  };
+
+  void write_header();
+  void write_point(float x, float y, float z, const std::uint8_t *rgb);
+  void flush_buffer();
+
+  std::string m_path;
+  format m_format;
+  bool m_with_color;
+  double m_voxel_size;
+  double m_las_scale;
+
+  std::ofstream m_stream;
+  std::vector<char> m_buffer;
+  size_t m_point_size{};
+  size_t m_point_count{};
+  double m_min[3], m_max[3];
+
+  std::unordered_map<std::array<std::int64_t, 3>, voxel, voxel_hash> m_voxels;
+};
+
+} // core
+} // viame
+
+#endif // VIAME_POINT_CLOUD_WRITER_H
@@ -0,0 +1,557 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "prefetch_image_list_input.h"
+
+#include <plugins/core/image_memory_budget.h>
+#include <plugins/core/thread_pool.h>
+
+#include <vital/algo/image_io.h>
+#include <vital/exceptions.h>
+#include <vital/logger/logger.h>
+#include <vital/types/metadata.h>
+#include <vital/types/metadata_map.h>
+#include <vital/types/metadata_traits.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+// =============================================================================
+class prefetch_image_list_input::priv
+{
+public:
+  priv()
+    : num_threads( 4 )
+    , prefetch_count( 8 )
+    , skip_bad_images( false )
+    , memory_budget( 0.0 )
+    , max_throttle_wait( 1.0 )
+    , next_index( 0 )
+    , has_frame( false )
+  {}
+
+  // Read a list of image files, relative paths are first looked up from the
+  // current directory then from the directory of the list
+  void read_list( std::string const& list_name );
+
+  // Queue loads up to prefetch_count images after the next one to return,
+  // only the next one while the image memory budget is exceeded
+  void fill_queue();
+
+  // Load one image with whichever nested reader is idle
+  kv::image_container_sptr load( std::string const& filename );
+
+  // Drop queued images, waiting for those being decoded
+  void clear_queue();
+
+  unsigned num_threads;
+  unsigned prefetch_count;
+  bool skip_bad_images;
+  double memory_budget;
+  double max_throttle_wait;
+
+  kv::config_block_sptr reader_config;
+  std::vector< kv::algo::image_io_sptr > readers;
+  std::vector< kv::algo::image_io* > free_readers;
+  std::mutex reader_mutex;
+
+  std::vector< std::string > files;
+
+  // Loads in flight, in list order, with the index of their file
+  std::deque< std::pair< size_t, std::future< kv::image_container_sptr > > > queue;
+  size_t next_index;
+
+  // Currently returned frame
+  bool has_frame;
+  size_t frame_index;
+  kv::timestamp frame_ts;
+  kv::image_container_sptr frame;
+
+  std::unique_ptr< thread_pool > workers;
+};
+
+// -----------------------------------------------------------------------------
+void
+prefetch_image_list_input::priv
+::read_list( std::string const& list_name )
+{
+  std::ifstream fin( list_name );
+
+  if( !fin )
+  {
+    VITAL_THROW( kv::file_not_found_exception, list_name,
+                 "Could not open image list" );
+  }
+
+  const std::string list_dir =
+    kwiversys::SystemTools::GetFilenamePath(
+      kwiversys::SystemTools::CollapseFullPath( list_name ) );
+
+  files.clear();
+  std::string line;
+
+  while( std::getline( fin, line ) )
+  {
+    const auto first = line.find_first_not_of( " \t\r\n" );
+
+    if( first == std::string::npos )
+    {
+      continue;
+    }
+
+    const auto last = line.find_last_not_of( " \t\r\n" );
+    std::string filename = line.substr( first, last - first + 1 );
+
+    if( !kwiversys::SystemTools::FileIsFullPath( filename ) &&
+        !kwiversys::SystemTools::FileExists( filename ) )
+    {
+      const std::string candidate = list_dir + "/" + filename;
+
+      if( kwiversys::SystemTools::FileExists( candidate ) )
+      {
+        filename = candidate;
+      }
+    }
+
+    files.push_back( filename );
+  }
+}
+
+// -----------------------------------------------------------------------------
+kv::image_container_sptr
+prefetch_image_list_input::priv
+::load( std::string const& filename )
+{
+  kv::algo::image_io* reader;
+  {
+    std::lock_guard< std::mutex > lock( reader_mutex );
+    reader = free_readers.back();
+    free_readers.pop_back();
+  }
+
+  kv::image_container_sptr image;
+
+  try
+  {
+    image = reader->load( filename );
+  }
+  catch( ... )
+  {
+    std::lock_guard< std::mutex > lock( reader_mutex );
+    free_readers.push_back( reader );
+    throw;
+  }
+
+  std::lock_guard< std::mutex > lock( reader_mutex );
+  free_readers.push_back( reader );
+  return image;
+}
+
+// -----------------------------------------------------------------------------
+void
+prefetch_image_list_input::priv
+::fill_queue()
+{
+  size_t queued = queue.empty() ? next_index : queue.back().first + 1;
+
+  const size_t ahead =
+    image_memory_budget::instance().exceeded() ? 0 : prefetch_count;
+
+  while( queued < files.size() && queued < next_index + ahead + 1 )
+  {
+    const std::string filename = files[ queued ];
+
+    queue.emplace_back( queued, workers->enqueue(
+      [this, filename]{ return load( filename ); } ) );
+
+    ++queued;
+  }
+}
+
+// -----------------------------------------------------------------------------
+void
+prefetch_image_list_input::priv
+::clear_queue()
+{
+  for( auto& entry : queue )
+  {
+    entry.second.wait();
+  }
+
+  queue.clear();
+}
+
+// =============================================================================
+prefetch_image_list_input
+::prefetch_image_list_input()
+  : d( new priv() )
+{
+  attach_logger( "viame.core.prefetch_image_list_input" );
+
+  set_capability( kv::algo::video_input::HAS_EOV, true );
+  set_capability( kv::algo::video_input::HAS_FRAME_NUMBERS, true );
+  set_capability( kv::algo::video_input::HAS_FRAME_DATA, true );
+  set_capability( kv::algo::video_input::HAS_METADATA, true );
+  set_capability( kv::algo::video_input::HAS_FRAME_TIME, false );
+  set_capability( kv::algo::video_input::HAS_ABSOLUTE_FRAME_TIME, false );
+  set_capability( kv::algo::video_input::HAS_TIMEOUT, false );
+  set_capability( kv::algo::video_input::IS_SEEKABLE, true );
+}
+
+
+prefetch_image_list_input
+::~prefetch_image_list_input()
+{
+  close();
+}
+
+
+// -----------------------------------------------------------------------------
+kv::config_block_sptr
+prefetch_image_list_input
+::get_configuration() const
+{
+  auto config = kv::algo::video_input::get_configuration();
+
+  config->set_value( "num_threads", d->num_threads,
+    "Number of images decoded in parallel, each by its own copy of the "
+    "image reader. 0 uses one per hardware thread." );
+  config->set_value( "prefetch_count", d->prefetch_count,
+    "Number of images after the current one read ahead of time. Bounds the "
+    "memory used by decoded images waiting to be processed." );
+  config->set_value( "skip_bad_images", d->skip_bad_images,
+    "Skip images which fail to load instead of stopping with an error." );
+
+  get_image_memory_configuration( config,
+    d->memory_budget, d->max_throttle_wait );
+
+  kv::algo::image_io::get_nested_algo_configuration(
+    "image_reader", config,
+    d->readers.empty() ? nullptr : d->readers[0] );
+
+  return config;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+prefetch_image_list_input
+::set_configuration( kv::config_block_sptr config )
+{
+  auto new_config = this->get_configuration();
+  new_config->merge_config( config );
+
+  d->num_threads = new_config->get_value< unsigned >( "num_threads" );
+  d->prefetch_count = new_config->get_value< unsigned >( "prefetch_count" );
+  d->skip_bad_images = new_config->get_value< bool >( "skip_bad_images" );
+
+  set_image_memory_configuration( new_config,
+    d->memory_budget, d->max_throttle_wait );
+
+  if( d->num_threads == 0 )
+  {
+    d->num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+  }
+
+  close();
+
+  d->readers.clear();
+  d->readers.resize( d->num_threads );
+  d->free_readers.clear();
+
+  for( auto& reader : d->readers )
+  {
+    kv::algo::image_io::set_nested_algo_configuration(
+      "image_reader", new_config, reader );
+
+    if( reader )
+    {
+      d->free_readers.push_back( reader.get() );
+    }
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+prefetch_image_list_input
+::check_configuration( kv::config_block_sptr config ) const
+{
+  return kv::algo::image_io::check_nested_algo_configuration(
+    "image_reader", config );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+prefetch_image_list_input
+::open( std::string list_name )
+{
+  if( d->readers.empty() || !d->readers[0] )
+  {
+    VITAL_THROW( kv::algorithm_configuration_exception,
+      type_name(), impl_name(), "No image_reader configured" );
+  }
+
+  close();
+
+  d->read_list( list_name );
+  d->workers.reset( new thread_pool( d->num_threads ) );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+prefetch_image_list_input
+::close()
+{
+  d->clear_queue();
+  d->workers.reset();
+
+  d->files.clear();
+  d->next_index = 0;
+  d->has_frame = false;
+  d->frame.reset();
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+prefetch_image_list_input
+::end_of_video() const
+{
+  return d->next_index >= d->files.size();
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+prefetch_image_list_input
+::good() const
+{
+  return d->has_frame;
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+prefetch_image_list_input
+::seekable() const
+{
+  return true;
+}
+
+
+// -----------------------------------------------------------------------------
+size_t
+prefetch_image_list_input
+::num_frames() const
+{
+  return d->files.size();
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+prefetch_image_list_input
+::next_frame( kv::timestamp& ts, uint32_t /*timeout*/ )
+{
+  d->has_frame = false;
+
+  if( !d->workers )
+  {
+    return false;
+  }
+
+  image_memory_budget::instance().wait_below_limit(
+    std::chrono::milliseconds(
+      static_cast< long long >( d->max_throttle_wait * 1000.0 ) ) );
+
+  while( d->next_index < d->files.size() )
+  {
+    d->fill_queue();
+
+    const size_t index = d->queue.front().first;
+    std::future< kv::image_container_sptr > result =
+      std::move( d->queue.front().second );
+    d->queue.pop_front();
+    d->next_index = index + 1;
+
+    kv::image_container_sptr image;
+
+    try
+    {
+      image = result.get();
+    }
+    catch( std::exception const& e )
+    {
+      if( !d->skip_bad_images )
+      {
+        throw;
+      }
+
+      LOG_WARN( logger(), "Skipping " << d->files[ index ] << ": " << e.what() );
+      continue;
+    }
+
+    if( !image )
+    {
+      if( !d->skip_bad_images )
+      {
+        VITAL_THROW( kv::invalid_data,
+          "Unable to load image " + d->files[ index ] );
+      }
+
+      LOG_WARN( logger(), "Skipping unreadable image " << d->files[ index ] );
+      continue;
+    }
+
+    // Frames are numbered by their position in the list, starting at 1
+    d->frame = image;
+    d->frame_index = index;
+    d->frame_ts = kv::timestamp();
+    d->frame_ts.set_frame( static_cast< kv::frame_id_t >( index + 1 ) );
+
+    auto md = image->get_metadata();
+
+    if( md && md->timestamp().has_valid_time() )
+    {
+      d->frame_ts.set_time_usec( md->timestamp().get_time_usec() );
+    }
+
+    d->has_frame = true;
+    ts = d->frame_ts;
+    return true;
+  }
+
+  return false;
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+prefetch_image_list_input
+::seek_frame( kv::timestamp& ts, kv::frame_id_t frame_number,
+              uint32_t timeout )
+{
+  if( frame_number < 1 ||
+      static_cast< size_t >( frame_number ) > d->files.size() )
+  {
+    return false;
+  }
+
+  const size_t index = static_cast< size_t >( frame_number - 1 );
+
+  // Loads already queued for the target and after it remain useful
+  while( !d->queue.empty() && d->queue.front().first < index )
+  {
+    d->queue.front().second.wait();
+    d->queue.pop_front();
+  }
+
+  if( !d->queue.empty() && d->queue.front().first != index )
+  {
+    d->clear_queue();
+  }
+
+  d->next_index = index;
+  return next_frame( ts, timeout );
+}
+
+
+// -----------------------------------------------------------------------------
+kv::timestamp
+prefetch_image_list_input
+::frame_timestamp() const
+{
+  return d->has_frame ? d->frame_ts : kv::timestamp();
+}
+
+
+// -----------------------------------------------------------------------------
+kv::image_container_sptr
+prefetch_image_list_input
+::frame_image()
+{
+  return d->has_frame ? d->frame : nullptr;
+}
+
+
+// -----------------------------------------------------------------------------
+kv::metadata_vector
+prefetch_image_list_input
+::frame_metadata()
+{
+  kv::metadata_vector output;
+
+  if( !d->has_frame )
+  {
+    return output;
+  }
+
+  auto md = d->frame->get_metadata();
+
+  if( !md )
+  {
+    md = std::make_shared< kv::metadata >();
+  }
+
+  md->add< kv::VITAL_META_IMAGE_URI >( d->files[ d->frame_index ] );
+  md->set_timestamp( d->frame_ts );
+
+  output.push_back( md );
+  return output;
+}
+
+
+// -----------------------------------------------------------------------------
+kv::metadata_map_sptr
+prefetch_image_list_input
+::metadata_map()
+{
+  // Metadata is only known for decoded images, so none is provided up front
+  return std::make_shared< kv::simple_metadata_map >();
+}
+
+} // end namespace viame
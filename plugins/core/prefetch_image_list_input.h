@@ -0,0 +1,99 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Image list reader decoding upcoming images on a thread pool
+ */
+
+#ifndef VIAME_CORE_PREFETCH_IMAGE_LIST_INPUT_H
+#define VIAME_CORE_PREFETCH_IMAGE_LIST_INPUT_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/algo/video_input.h>
+
+#include <memory>
+
+namespace viame
+{
+
+/**
+ * @brief Read a list of images, loading the next ones ahead of time
+ *
+ * Behaves as the image_list reader, but while a frame is processed the
+ * following prefetch_count images are already read and decoded by
+ * num_threads workers, each using its own copy of the nested image reader.
+ * This hides file access latency and spreads decoding over several cores.
+ */
+class VIAME_CORE_EXPORT prefetch_image_list_input
+  : public kwiver::vital::algo::video_input
+{
+public:
+  static constexpr char const* name = "prefetch_image_list";
+  static constexpr char const* description =
+    "Read a list of images, decoding upcoming ones in parallel";
+
+  prefetch_image_list_input();
+  ~prefetch_image_list_input() override;
+
+  kwiver::vital::config_block_sptr get_configuration() const override;
+
+  void set_configuration( kwiver::vital::config_block_sptr config ) override;
+
+  bool check_configuration( kwiver::vital::config_block_sptr config ) const override;
+
+  void open( std::string list_name ) override;
+  void close() override;
+
+  bool end_of_video() const override;
+  bool good() const override;
+  bool seekable() const override;
+  size_t num_frames() const override;
+
+  bool next_frame( kwiver::vital::timestamp& ts,
+                   uint32_t timeout = 0 ) override;
+
+  bool seek_frame( kwiver::vital::timestamp& ts,
+                   kwiver::vital::frame_id_t frame_number,
+                   uint32_t timeout = 0 ) override;
+
+  kwiver::vital::timestamp frame_timestamp() const override;
+  kwiver::vital::image_container_sptr frame_image() override;
+  kwiver::vital::metadata_vector frame_metadata() override;
+  kwiver::vital::metadata_map_sptr metadata_map() override;
+
+private:
+  class priv;
+  const std::unique_ptr< priv > d;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_PREFETCH_IMAGE_LIST_INPUT_H
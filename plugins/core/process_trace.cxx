@@ -0,0 +1,319 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "process_trace.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+namespace viame
+{
+
+namespace
+{
+
+typedef std::chrono::steady_clock trace_clock_t;
+
+// Steps kept for the timeline, later ones only update the process totals
+const size_t max_trace_events = 1000000;
+
+struct step_event
+{
+  unsigned process;
+  size_t step;
+  double start_us;
+  double wait_us;
+  double duration_us;
+  std::vector< std::pair< std::string, size_t > > counts;
+};
+
+struct process_totals
+{
+  std::string name;
+  size_t steps = 0;
+  double step_us = 0.0;
+  double wait_us = 0.0;
+  double max_step_us = 0.0;
+  std::map< std::string, size_t > counts;
+};
+
+std::string
+json_escape( std::string const& value )
+{
+  std::string output;
+
+  for( char c : value )
+  {
+    if( c == '"' || c == '\\' )
+    {
+      output += '\\';
+    }
+    if( static_cast< unsigned char >( c ) >= 0x20 )
+    {
+      output += c;
+    }
+  }
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+// Steps of all processes, written when the library is unloaded at shutdown
+class trace_collector
+{
+public:
+  static trace_collector& instance()
+  {
+    static trace_collector collector;
+    return collector;
+  }
+
+  ~trace_collector()
+  {
+    if( enabled() )
+    {
+      write();
+    }
+  }
+
+  bool enabled() const { return !m_filename.empty(); }
+
+  void record( std::string const& process,
+               trace_clock_t::time_point start,
+               trace_clock_t::time_point ready,
+               trace_clock_t::time_point end,
+               std::vector< std::pair< const char*, size_t > > const& counts )
+  {
+    typedef std::chrono::duration< double, std::micro > usec_t;
+
+    const double wait_us = usec_t( ready - start ).count();
+    const double duration_us = usec_t( end - start ).count();
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    auto id = m_ids.emplace( process, static_cast< unsigned >( m_totals.size() ) );
+    if( id.second )
+    {
+      m_totals.emplace_back();
+      m_totals.back().name = process;
+    }
+
+    process_totals& totals = m_totals[ id.first->second ];
+    totals.steps++;
+    totals.step_us += duration_us;
+    totals.wait_us += wait_us;
+    totals.max_step_us = std::max( totals.max_step_us, duration_us );
+
+    for( auto const& c : counts )
+    {
+      totals.counts[ c.first ] += c.second;
+    }
+
+    if( m_events.size() >= max_trace_events )
+    {
+      m_dropped++;
+      return;
+    }
+
+    step_event event;
+    event.process = id.first->second;
+    event.step = totals.steps;
+    event.start_us = usec_t( start - m_origin ).count();
+    event.wait_us = wait_us;
+    event.duration_us = duration_us;
+
+    for( auto const& c : counts )
+    {
+      event.counts.emplace_back( c.first, c.second );
+    }
+
+    m_events.push_back( std::move( event ) );
+  }
+
+private:
+  trace_collector()
+    : m_origin( trace_clock_t::now() )
+  {
+    if( const char* filename = std::getenv( "VIAME_PIPELINE_TRACE" ) )
+    {
+      m_filename = filename;
+    }
+  }
+
+  void write()
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    std::ofstream fout( m_filename );
+
+    if( !fout )
+    {
+      return;
+    }
+
+    // One timeline row per process, with its waits nested in its steps
+    fout << "{\"traceEvents\":[";
+
+    bool first = true;
+    auto separator = [&]() -> std::ostream&
+    {
+      fout << ( first ? "\n" : ",\n" );
+      first = false;
+      return fout;
+    };
+
+    for( unsigned i = 0; i < m_totals.size(); ++i )
+    {
+      separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i
+                  << ",\"args\":{\"name\":\"" << json_escape( m_totals[i].name ) << "\"}}";
+    }
+
+    for( auto const& e : m_events )
+    {
+      separator() << "{\"name\":\"step\",\"cat\":\"process\",\"ph\":\"X\",\"pid\":1"
+                  << ",\"tid\":" << e.process << ",\"ts\":" << e.start_us
+                  << ",\"dur\":" << e.duration_us << ",\"args\":{\"step\":" << e.step
+                  << ",\"wait_us\":" << e.wait_us;
+
+      for( auto const& c : e.counts )
+      {
+        fout << ",\"" << json_escape( c.first ) << "\":" << c.second;
+      }
+      fout << "}}";
+
+      if( e.wait_us > 0.0 )
+      {
+        separator() << "{\"name\":\"port wait\",\"cat\":\"wait\",\"ph\":\"X\",\"pid\":1"
+                    << ",\"tid\":" << e.process << ",\"ts\":" << e.start_us
+                    << ",\"dur\":" << e.wait_us << "}";
+      }
+    }
+
+    fout << "\n],\n\"displayTimeUnit\":\"ms\",\n\"viame_dropped_steps\":" << m_dropped
+         << ",\n\"viame_process_summary\":[";
+
+    for( unsigned i = 0; i < m_totals.size(); ++i )
+    {
+      auto const& t = m_totals[i];
+      const double steps = static_cast< double >( std::max< size_t >( t.steps, 1 ) );
+
+      fout << ( i ? ",\n" : "\n" )
+           << "{\"process\":\"" << json_escape( t.name ) << "\",\"steps\":" << t.steps
+           << ",\"total_step_us\":" << t.step_us
+           << ",\"mean_step_us\":" << t.step_us / steps
+           << ",\"max_step_us\":" << t.max_step_us
+           << ",\"total_wait_us\":" << t.wait_us
+           << ",\"mean_wait_us\":" << t.wait_us / steps
+           << ",\"counts\":{";
+
+      bool first_count = true;
+      for( auto const& c : t.counts )
+      {
+        fout << ( first_count ? "" : "," ) << "\"" << json_escape( c.first ) << "\":" << c.second;
+        first_count = false;
+      }
+      fout << "}}";
+    }
+
+    fout << "\n]}" << std::endl;
+  }
+
+  std::string m_filename;
+  trace_clock_t::time_point m_origin;
+
+  std::mutex m_mutex;
+  std::map< std::string, unsigned > m_ids;
+  std::vector< process_totals > m_totals;
+  std::vector< step_event > m_events;
+  size_t m_dropped = 0;
+};
+
+} // end anonymous namespace
+
+// -----------------------------------------------------------------------------
+bool
+process_trace_enabled()
+{
+  static const bool enabled = trace_collector::instance().enabled();
+  return enabled;
+}
+
+// -----------------------------------------------------------------------------
+process_step_trace
+::process_step_trace( std::string const& process_name )
+  : m_enabled( process_trace_enabled() )
+{
+  if( m_enabled )
+  {
+    m_process = process_name;
+    m_start = clock_t::now();
+  }
+}
+
+// -----------------------------------------------------------------------------
+process_step_trace
+::~process_step_trace()
+{
+  if( !m_enabled )
+  {
+    return;
+  }
+
+  const clock_t::time_point end = clock_t::now();
+
+  trace_collector::instance().record(
+    m_process, m_start, ( m_inputs_ready ? m_ready : m_start ), end, m_counts );
+}
+
+// -----------------------------------------------------------------------------
+void
+process_step_trace
+::inputs_ready()
+{
+  if( m_enabled && !m_inputs_ready )
+  {
+    m_ready = clock_t::now();
+    m_inputs_ready = true;
+  }
+}
+
+// -----------------------------------------------------------------------------
+void
+process_step_trace
+::count( const char* name, size_t value )
+{
+  if( m_enabled )
+  {
+    m_counts.emplace_back( name, value );
+  }
+}
+
+} // end namespace viame
@@ -0,0 +1,92 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Opt-in step timing of pipeline processes, exported as a Chrome trace
+ */
+
+#ifndef VIAME_CORE_PROCESS_TRACE_H
+#define VIAME_CORE_PROCESS_TRACE_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace viame
+{
+
+/// True when the VIAME_PIPELINE_TRACE variable names an output trace file
+VIAME_CORE_EXPORT bool process_trace_enabled();
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Records one process step, from construction to destruction
+ *
+ * Created at the start of a _step, the time until inputs_ready() is counted as
+ * port wait time, and the rest as compute time. When VIAME_PIPELINE_TRACE is
+ * set, all steps of a run are written to that file at shutdown in the Chrome
+ * trace event format, readable by Perfetto or chrome://tracing, along with
+ * per-process totals. Otherwise construction only checks a cached flag.
+ */
+class VIAME_CORE_EXPORT process_step_trace
+{
+public:
+  explicit process_step_trace( std::string const& process_name );
+
+  ~process_step_trace();
+
+  process_step_trace( process_step_trace const& ) = delete;
+  process_step_trace& operator=( process_step_trace const& ) = delete;
+
+  /// Mark the end of the input port grabs of this step
+  void inputs_ready();
+
+  /// Record a count of items carried by this step, such as detections
+  void count( const char* name, size_t value );
+
+private:
+  typedef std::chrono::steady_clock clock_t;
+
+  bool m_enabled;
+  bool m_inputs_ready = false;
+  std::string m_process;
+  clock_t::time_point m_start;
+  clock_t::time_point m_ready;
+  std::vector< std::pair< const char*, size_t > > m_counts;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_PROCESS_TRACE_H
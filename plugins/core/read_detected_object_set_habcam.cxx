@@ -29,13 +29,14 @@
  */
 
 #include "read_detected_object_set_habcam.h"
+#include "csv_file_parser.h"
 
-#include <vital/util/tokenize.h>
 #include <vital/util/data_stream_reader.h>
 #include <vital/logger/logger.h>
 #include <vital/exceptions.h>
 
 #include <map>
+#include <unordered_map>
 #include <sstream>
 #include <memory>
 #include <cmath>
@@ -91,9 +92,9 @@ public:
   void read_all();
   void init_species_map();
   std::string decode_species( int code );
-  void parse_detection( const std::vector< std::string >& parsed_line );
+  void parse_detection( const std::vector< std::string_view >& parsed_line );
 
-  bool parse_box( const std::vector< std::string >& parsed_line,
+  bool parse_box( const std::vector< std::string_view >& parsed_line,
                   unsigned index,
                   kwiver::vital::bounding_box_d& bbox );
 
@@ -112,8 +113,12 @@ public:
   int m_detected_version;
 
   std::map< int, std::string > m_species_map;
-  std::map< std::string, kwiver::vital::detected_object_set_sptr > m_gt_sets;
+  std::unordered_map< std::string, kwiver::vital::detected_object_set_sptr > m_gt_sets;
   std::vector< std::string > m_filenames;
+
+  // Set of the previous line, as annotations are usually grouped by image
+  std::string m_last_image;
+  kwiver::vital::detected_object_set* m_last_set = nullptr;
 };
 
 
@@ -173,7 +178,8 @@ read_detected_object_set_habcam
   if( !image_name.empty() )
   {
     // return detection set at current index if there is one
-    if( d->m_gt_sets.find( image_name ) == d->m_gt_sets.end() )
+    auto itr = d->m_gt_sets.find( image_name );
+    if( itr == d->m_gt_sets.end() )
     {
       // return empty set
       set = std::make_shared< kwiver::vital::detected_object_set>();
@@ -181,7 +187,7 @@ read_detected_object_set_habcam
     else
     {
       // Return detections for this frame.
-      set = d->m_gt_sets[ image_name ];
+      set = itr->second;
     }
     return true;
   }
@@ -211,13 +217,15 @@ read_detected_object_set_habcam
   d->m_first = true;
   d->m_filenames.clear();
   d->m_gt_sets.clear();
+  d->m_last_image.clear();
+  d->m_last_set = nullptr;
 }
 
 
 // -----------------------------------------------------------------------------
 void
 read_detected_object_set_habcam::priv
-::parse_detection( const std::vector< std::string >& parsed_line )
+::parse_detection( const std::vector< std::string_view >& parsed_line )
 {
   if ( parsed_line.size() < 4 )
   {
@@ -226,13 +234,18 @@ read_detected_object_set_habcam::priv
     return;
   }
 
-  if( m_gt_sets.find( parsed_line[0] ) == m_gt_sets.end() )
+  if( !m_last_set || parsed_line[0] != m_last_image )
   {
-    // create a new detection set entry
-    m_gt_sets[ parsed_line[0] ] =
-      std::make_shared<kwiver::vital::detected_object_set>();
+    m_last_image.assign( parsed_line[0].data(), parsed_line[0].size() );
 
-    m_filenames.push_back( parsed_line[0] );
+    auto& image_set = m_gt_sets[ m_last_image ];
+    if( !image_set )
+    {
+      // create a new detection set entry
+      image_set = std::make_shared<kwiver::vital::detected_object_set>();
+      m_filenames.push_back( m_last_image );
+    }
+    m_last_set = image_set.get();
   }
 
   kwiver::vital::detected_object_type_sptr dot
@@ -255,7 +268,7 @@ read_detected_object_set_habcam::priv
   }
   else if( m_use_internal_table )
   {
-    class_name = decode_species( atoi( parsed_line[1].c_str() ) );
+    class_name = decode_species( csv_to_int( parsed_line[1] ) );
   }
   else
   {
@@ -274,7 +287,7 @@ read_detected_object_set_habcam::priv
     return;
   }
 
-  m_gt_sets[ parsed_line[0] ]->add(
+  m_last_set->add(
     std::make_shared< kwiver::vital::detected_object >( bbox, 1.0, dot ) );
 } // read_detected_object_set_habcam::priv::add_detection
 
@@ -282,7 +295,7 @@ read_detected_object_set_habcam::priv
 // -----------------------------------------------------------------------------
 bool
 read_detected_object_set_habcam::priv
-::parse_box( const std::vector< std::string >& parsed_line,
+::parse_box( const std::vector< std::string_view >& parsed_line,
              unsigned index,
              kwiver::vital::bounding_box_d& bbox )
 {
@@ -292,10 +305,10 @@ read_detected_object_set_habcam::priv
     if ( parsed_line.size() > index + 4 )
     {
       bbox = kwiver::vital::bounding_box_d(
-        atof( parsed_line[ index + 1 ].c_str() ),
-        atof( parsed_line[ index + 2 ].c_str() ),
-        atof( parsed_line[ index + 3 ].c_str() ),
-        atof( parsed_line[ index + 4 ].c_str() ) );
+        csv_to_double( parsed_line[ index + 1 ] ),
+        csv_to_double( parsed_line[ index + 2 ] ),
+        csv_to_double( parsed_line[ index + 3 ] ),
+        csv_to_double( parsed_line[ index + 4 ] ) );
     }
     else
     {
@@ -307,10 +320,10 @@ read_detected_object_set_habcam::priv
   {
     if ( parsed_line.size() > index + 4 )
     {
-      const double x1 = atof( parsed_line[ index + 1 ].c_str() );
-      const double y1 = atof( parsed_line[ index + 2 ].c_str() );
-      const double x2 = atof( parsed_line[ index + 3 ].c_str() );
-      const double y2 = atof( parsed_line[ index + 4 ].c_str() );
+      const double x1 = csv_to_double( parsed_line[ index + 1 ] );
+      const double y1 = csv_to_double( parsed_line[ index + 2 ] );
+      const double x2 = csv_to_double( parsed_line[ index + 3 ] );
+      const double y2 = csv_to_double( parsed_line[ index + 4 ] );
 
       const double cx = ( x1 + x2 ) / 2;
       const double cy = ( y1 + y2 ) / 2;
@@ -333,8 +346,8 @@ read_detected_object_set_habcam::priv
   {
     if ( parsed_line.size() > index + 2 )
     {
-      const double cx = atof( parsed_line[ index + 1 ].c_str() );
-      const double cy = atof( parsed_line[ index + 2 ].c_str() );
+      const double cx = csv_to_double( parsed_line[ index + 1 ] );
+      const double cy = csv_to_double( parsed_line[ index + 2 ] );
 
       bbox = kwiver::vital::bounding_box_d(
         cx - m_point_dilation, cy - m_point_dilation,
@@ -350,10 +363,10 @@ read_detected_object_set_habcam::priv
   {
     if ( parsed_line.size() > index + 4 )
     {
-      const double x1 = atof( parsed_line[ index + 1 ].c_str() );
-      const double y1 = atof( parsed_line[ index + 2 ].c_str() );
-      const double x2 = atof( parsed_line[ index + 3 ].c_str() );
-      const double y2 = atof( parsed_line[ index + 4 ].c_str() );
+      const double x1 = csv_to_double( parsed_line[ index + 1 ] );
+      const double y1 = csv_to_double( parsed_line[ index + 2 ] );
+      const double x2 = csv_to_double( parsed_line[ index + 3 ] );
+      const double y2 = csv_to_double( parsed_line[ index + 4 ] );
 
       const double cx = ( x1 + x2 ) / 2;
       const double cy = ( y1 + y2 ) / 2;
@@ -407,7 +420,12 @@ read_detected_object_set_habcam::priv
   std::string line;
   kwiver::vital::data_stream_reader stream_reader( m_parent->stream() );
 
+  // Field views into the current line, reused across lines
+  std::vector< std::string_view > parsed_line;
+  std::vector< std::string_view > parsed_loc;
+
   m_gt_sets.clear();
+  m_last_set = nullptr;
 
   while( stream_reader.getline( line ) )
   {
@@ -443,8 +461,7 @@ read_detected_object_set_habcam::priv
       line.erase( std::remove( line.begin(), line.end(), '"' ), line.end() );
     }
 
-    std::vector< std::string > parsed_line;
-    kwiver::vital::tokenize( line, parsed_line, m_delim, true );
+    csv_split_fields( line, m_delim, parsed_line, true );
 
     // Test the minimum number of fields.
     if ( parsed_line.size() < 4 )
@@ -456,16 +473,15 @@ read_detected_object_set_habcam::priv
     // Make 'v2' formats look like 'v1' so they can share parsing code
     if( m_detected_version == 2 )
     {
-      std::vector< std::string > parsed_loc;
-      kwiver::vital::tokenize( parsed_line[3], parsed_loc, " ", true );
-      parsed_line.erase( parsed_line.begin() + 3 );
+      csv_split_fields( parsed_line[3], " ", parsed_loc, true );
 
       if( parsed_loc.size() != 2 )
       {
         throw kwiver::vital::invalid_data( "Invalid line: " + line );
       }
 
-      parsed_line.insert( parsed_line.begin() + 3, parsed_loc.begin(), parsed_loc.end() );
+      parsed_line[3] = parsed_loc[1];
+      parsed_line.insert( parsed_line.begin() + 3, parsed_loc[0] );
     }
 
     parse_detection( parsed_line );
@@ -34,22 +34,25 @@
  */
 
 #include "read_detected_object_set_oceaneyes.h"
+#include "csv_file_parser.h"
 
-#include <vital/util/tokenize.h>
 #include <vital/util/data_stream_reader.h>
 #include <vital/exceptions.h>
 
 #include <kwiversys/SystemTools.hxx>
 
-#include <map>
+#include <algorithm>
+#include <unordered_map>
 #include <sstream>
 #include <cstdlib>
 
 namespace viame
 {
 
-double filter_number( std::string str )
+double filter_number( std::string_view field )
 {
+  std::string str( field );
+
   str.erase( std::remove( str.begin(), str.end(), '('), str.end() );
   str.erase( std::remove( str.begin(), str.end(), ')'), str.end() );
   str.erase( std::remove( str.begin(), str.end(), '"'), str.end() );
@@ -92,13 +95,16 @@ public:
   double c_box_expansion;
   double c_max_aspect_ratio;
 
-  typedef std::map< std::string, kwiver::vital::detected_object_set_sptr > map_type;
+  typedef std::unordered_map< std::string, kwiver::vital::detected_object_set_sptr > map_type;
 
   // Map of detected objects indexed by file name. Each set contains all detections
   // for a single frame (unsorted).
   map_type m_detection_by_str;
 
-  map_type::iterator m_current_idx;
+  // File names in alphabetical order, for iterating through all sets
+  std::vector< std::string > m_ordered_ids;
+
+  size_t m_current_idx = 0;
 };
 
 
@@ -150,7 +156,7 @@ read_detected_object_set_oceaneyes
     d->m_first = false;
 
     // set up iterators for returning sets.
-    d->m_current_idx = d->m_detection_by_str.begin();
+    d->m_current_idx = 0;
   }
 
   // External image name provided, use that
@@ -159,7 +165,8 @@ read_detected_object_set_oceaneyes
     // return detection set at current index if there is one
     std::string name_no_ext = image_name.substr( 0, image_name.find_last_of( "." ) );
 
-    if( d->m_detection_by_str.find( name_no_ext ) == d->m_detection_by_str.end() )
+    auto itr = d->m_detection_by_str.find( name_no_ext );
+    if( itr == d->m_detection_by_str.end() )
     {
       // return empty set
       set = std::make_shared< kwiver::vital::detected_object_set>();
@@ -167,19 +174,19 @@ read_detected_object_set_oceaneyes
     else
     {
       // Return detections for this frame.
-      set = d->m_detection_by_str[ name_no_ext ];
+      set = itr->second;
     }
     return true;
   }
 
   // Test for end of all loaded detections
-  if( d->m_current_idx == d->m_detection_by_str.end() )
+  if( d->m_current_idx >= d->m_ordered_ids.size() )
   {
     return false;
   }
 
   // Return detection set at current index if there is one
-  set = d->m_current_idx->second;
+  set = d->m_detection_by_str[ d->m_ordered_ids[ d->m_current_idx ] ];
   d->m_current_idx++;
 
   return true;
@@ -203,16 +210,23 @@ read_detected_object_set_oceaneyes::priv
   std::string line;
   kwiver::vital::data_stream_reader stream_reader( m_parent->stream() );
 
+  // Field views into the current line, reused across lines
+  std::vector< std::string_view > col;
+  std::string str_id;
+
+  // Set of the previous line, as detections are usually grouped by image
+  kwiver::vital::detected_object_set* frame_set = nullptr;
+
   // Read detections
   m_detection_by_str.clear();
+  m_ordered_ids.clear();
 
   // Determine version based on header type
   unsigned version = 1;
 
   while( stream_reader.getline( line ) )
   {
-    std::vector< std::string > col;
-    kwiver::vital::tokenize( line, col, ",", false );
+    csv_split_fields( line, ",", col );
 
     if( col.empty() || ( !col[0].empty() && col[0][0] == '#' ) )
     {
@@ -255,15 +269,26 @@ read_detected_object_set_oceaneyes::priv
     }
 
     // Get frame ID and remove extension to make filetype agnostic
-    std::string str_id = col[ COL_FRAME_ID ];
-    str_id = str_id.substr( 0, str_id.find_last_of( "." ) );
+    std::string_view frame_id = col[ COL_FRAME_ID ];
+    frame_id = frame_id.substr( 0, frame_id.find_last_of( "." ) );
 
-    if( !str_id.empty() &&
-        m_detection_by_str.count( str_id ) == 0 )
+    if( frame_id.empty() )
+    {
+      frame_set = nullptr;
+      str_id.clear();
+    }
+    else if( !frame_set || frame_id != str_id )
     {
-      // create a new detection set entry
-      m_detection_by_str[ str_id ] =
-        std::make_shared<kwiver::vital::detected_object_set>();
+      str_id.assign( frame_id.data(), frame_id.size() );
+
+      auto& id_set = m_detection_by_str[ str_id ];
+      if( !id_set )
+      {
+        // create a new detection set entry
+        id_set = std::make_shared<kwiver::vital::detected_object_set>();
+        m_ordered_ids.push_back( str_id );
+      }
+      frame_set = id_set.get();
     }
 
     if( COL_SPECIES_ID > 0 && col[ COL_SPECIES_ID ] == c_no_fish_string )
@@ -314,18 +339,18 @@ read_detected_object_set_oceaneyes::priv
     kwiver::vital::detected_object_type_sptr dot =
       std::make_shared< kwiver::vital::detected_object_type >();
 
-    std::string species_label = col[ COL_SPECIES_ID ];
+    std::string species_label( col[ COL_SPECIES_ID ] );
 
     double species_conf = 1.0;
 
     if( COL_SPEC_CONF > 0 && COL_FISH_CONF > 0 )
     {
-      species_conf = std::max( std::stod( col[ COL_SPEC_CONF ] ),
-                               std::stod( col[ COL_FISH_CONF ] ) );
+      species_conf = std::max( std::stod( std::string( col[ COL_SPEC_CONF ] ) ),
+                               std::stod( std::string( col[ COL_FISH_CONF ] ) ) );
     }
     else if( COL_SPEC_CONF > 0 )
     {
-      species_conf = std::stod( col[ COL_SPEC_CONF ] );
+      species_conf = std::stod( std::string( col[ COL_SPEC_CONF ] ) );
     }
 
     species_label = ( species_label.empty() ? "other" : species_label );
@@ -345,10 +370,16 @@ read_detected_object_set_oceaneyes::priv
         kwiver::vital::point_2d( x2, y2 ) );
     }
 
-    // Add detection to set for the frame
-    m_detection_by_str[ str_id ]->add( dob );
+    // Add detection to set for the frame, detections without a frame
+    // name cannot be looked up so they are dropped
+    if( frame_set )
+    {
+      frame_set->add( dob );
+    }
 
   } // ...while !eof
+
+  std::sort( m_ordered_ids.begin(), m_ordered_ids.end() );
 } // read_all
 
 } // end namespace
@@ -0,0 +1,533 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Implementation for read_detected_object_set_viame_coco
+ */
+
+#include "read_detected_object_set_viame_coco.h"
+#include "json_stream.h"
+
+#include <vital/types/detected_object_type.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace viame {
+
+namespace {
+
+// -----------------------------------------------------------------------------------
+struct coco_image
+{
+  std::int64_t id;
+  std::string file_name;
+};
+
+// Annotation fields kept after parsing, polygons live in a shared pool
+struct coco_annotation
+{
+  std::int64_t image_id;
+  std::int64_t category_id;
+  double bbox[4];
+  double score;
+  std::size_t poly_begin;
+  std::size_t poly_size;
+};
+
+// -----------------------------------------------------------------------------------
+// Collects images, categories and annotations as the document is parsed. The
+// top level object is at depth 1, its arrays at depth 2 and their elements at
+// depth 3, with bbox and flat segmentation values at depth 4 and polygon
+// segmentation values at depth 5.
+class coco_index_handler : public json_sax_handler
+{
+public:
+  enum section_type { NONE, IMAGES, ANNOTATIONS, CATEGORIES };
+
+  coco_index_handler( std::vector< coco_image >& images,
+                      std::vector< coco_annotation >& annotations,
+                      std::vector< double >& polygons,
+                      std::unordered_map< std::int64_t, std::string >& categories )
+    : m_images( images )
+    , m_annotations( annotations )
+    , m_polygons( polygons )
+    , m_categories( categories )
+  {}
+
+  void start_object() override
+  {
+    if( ++m_depth == 3 && m_section != NONE )
+    {
+      m_image = coco_image{ -1, std::string() };
+      m_annotation = coco_annotation{ -1, -1, { 0, 0, 0, 0 }, -1.0,
+                                      m_polygons.size(), 0 };
+      m_category_id = -1;
+      m_category_name.clear();
+      m_bbox_size = 0;
+      m_polygon_count = 0;
+      m_rle = false;
+      m_field.clear();
+    }
+    else if( m_depth == 4 && in_segmentation() )
+    {
+      // Run length encoded masks are not read
+      m_rle = true;
+    }
+  }
+
+  void end_object() override
+  {
+    if( m_depth == 3 )
+    {
+      commit();
+    }
+    --m_depth;
+  }
+
+  void start_array() override
+  {
+    ++m_depth;
+
+    if( m_depth == 2 )
+    {
+      m_section = ( m_section_key == "images" ? IMAGES :
+                    m_section_key == "annotations" ? ANNOTATIONS :
+                    m_section_key == "categories" ? CATEGORIES : NONE );
+    }
+    else if( m_depth == 5 && in_segmentation() )
+    {
+      ++m_polygon_count;
+    }
+  }
+
+  void end_array() override
+  {
+    if( m_depth == 2 )
+    {
+      m_section = NONE;
+    }
+    --m_depth;
+  }
+
+  void key( std::string const& name ) override
+  {
+    if( m_depth == 1 )
+    {
+      m_section_key = name;
+    }
+    else if( m_depth == 3 )
+    {
+      m_field = name;
+    }
+  }
+
+  void string_value( std::string const& value ) override
+  {
+    if( m_depth != 3 )
+    {
+      return;
+    }
+
+    if( m_section == IMAGES && m_field == "file_name" )
+    {
+      m_image.file_name = value;
+    }
+    else if( m_section == CATEGORIES && m_field == "name" )
+    {
+      m_category_name = value;
+    }
+  }
+
+  void number_value( double value ) override
+  {
+    if( m_depth == 3 )
+    {
+      const std::int64_t id = static_cast< std::int64_t >( value );
+
+      if( m_field == "id" )
+      {
+        m_image.id = id;
+        m_category_id = id;
+      }
+      else if( m_field == "image_id" )
+      {
+        m_annotation.image_id = id;
+      }
+      else if( m_field == "category_id" )
+      {
+        m_annotation.category_id = id;
+      }
+      else if( m_field == "score" )
+      {
+        m_annotation.score = value;
+      }
+    }
+    else if( m_section == ANNOTATIONS && m_depth == 4 )
+    {
+      if( m_field == "bbox" && m_bbox_size < 4 )
+      {
+        m_annotation.bbox[ m_bbox_size++ ] = value;
+      }
+      else if( in_segmentation() )
+      {
+        m_polygons.push_back( value );
+      }
+    }
+    else if( m_depth == 5 && in_segmentation() && m_polygon_count == 1 )
+    {
+      // Only the first polygon of an annotation is kept
+      m_polygons.push_back( value );
+    }
+  }
+
+private:
+  bool in_segmentation() const
+  {
+    return m_section == ANNOTATIONS && m_field == "segmentation" && !m_rle;
+  }
+
+  void commit()
+  {
+    if( m_section == IMAGES && m_image.id >= 0 )
+    {
+      m_images.push_back( std::move( m_image ) );
+    }
+    else if( m_section == CATEGORIES && m_category_id >= 0 )
+    {
+      m_categories[ m_category_id ] = m_category_name;
+    }
+    else if( m_section == ANNOTATIONS )
+    {
+      m_annotation.poly_size = m_polygons.size() - m_annotation.poly_begin;
+      m_annotation.poly_size -= m_annotation.poly_size % 2;
+      m_polygons.resize( m_annotation.poly_begin + m_annotation.poly_size );
+
+      // Boxes default to the bounds of the polygon
+      if( m_bbox_size < 4 && m_annotation.poly_size > 0 )
+      {
+        double min_x = m_polygons[ m_annotation.poly_begin ], max_x = min_x;
+        double min_y = m_polygons[ m_annotation.poly_begin + 1 ], max_y = min_y;
+
+        for( std::size_t i = 2; i < m_annotation.poly_size; i += 2 )
+        {
+          min_x = std::min( min_x, m_polygons[ m_annotation.poly_begin + i ] );
+          max_x = std::max( max_x, m_polygons[ m_annotation.poly_begin + i ] );
+          min_y = std::min( min_y, m_polygons[ m_annotation.poly_begin + i + 1 ] );
+          max_y = std::max( max_y, m_polygons[ m_annotation.poly_begin + i + 1 ] );
+        }
+
+        m_annotation.bbox[0] = min_x;
+        m_annotation.bbox[1] = min_y;
+        m_annotation.bbox[2] = max_x - min_x;
+        m_annotation.bbox[3] = max_y - min_y;
+        m_bbox_size = 4;
+      }
+
+      if( m_bbox_size == 4 && m_annotation.image_id >= 0 )
+      {
+        m_annotations.push_back( m_annotation );
+      }
+      else
+      {
+        m_polygons.resize( m_annotation.poly_begin );
+      }
+    }
+  }
+
+  std::vector< coco_image >& m_images;
+  std::vector< coco_annotation >& m_annotations;
+  std::vector< double >& m_polygons;
+  std::unordered_map< std::int64_t, std::string >& m_categories;
+
+  int m_depth = 0;
+  section_type m_section = NONE;
+  std::string m_section_key;
+  std::string m_field;
+
+  // Element being parsed
+  coco_image m_image;
+  coco_annotation m_annotation;
+  std::int64_t m_category_id = -1;
+  std::string m_category_name;
+  unsigned m_bbox_size = 0;
+  unsigned m_polygon_count = 0;
+  bool m_rle = false;
+};
+
+} // end anonymous namespace
+
+
+// -----------------------------------------------------------------------------------
+class read_detected_object_set_viame_coco::priv
+{
+public:
+  priv( read_detected_object_set_viame_coco* parent )
+    : m_parent( parent )
+    , m_first( true )
+    , m_current_image( 0 )
+  {}
+
+  ~priv() {}
+
+  // Parse the file and group annotations by image
+  void read_all();
+
+  // Detections of the image at the given position in the images array
+  kwiver::vital::detected_object_set_sptr image_set( size_t position ) const;
+
+  read_detected_object_set_viame_coco* m_parent;
+  std::string m_filename;
+  bool m_first;
+  size_t m_current_image;
+
+  std::vector< coco_image > m_images;
+  std::vector< coco_annotation > m_annotations;
+  std::vector< double > m_polygons;
+  std::unordered_map< std::int64_t, std::string > m_categories;
+
+  // Annotations of image i are m_order[ m_image_offsets[i] ... m_image_offsets[i+1] )
+  std::vector< size_t > m_image_offsets;
+  std::vector< size_t > m_order;
+
+  // Image position of every image file name, and of their base names
+  std::unordered_map< std::string, size_t > m_image_by_name;
+};
+
+
+// -----------------------------------------------------------------------------------
+void
+read_detected_object_set_viame_coco::priv
+::read_all()
+{
+  m_images.clear();
+  m_annotations.clear();
+  m_polygons.clear();
+  m_categories.clear();
+  m_image_by_name.clear();
+
+  coco_index_handler handler( m_images, m_annotations, m_polygons, m_categories );
+  parse_json( m_parent->stream(), handler );
+
+  std::unordered_map< std::int64_t, size_t > position_by_id;
+  position_by_id.reserve( m_images.size() );
+
+  for( size_t i = 0; i < m_images.size(); ++i )
+  {
+    position_by_id.emplace( m_images[i].id, i );
+
+    const std::string& name = m_images[i].file_name;
+
+    if( !name.empty() )
+    {
+      m_image_by_name.emplace( name, i );
+
+      const size_t last_slash_idx = name.find_last_of( "\\/" );
+      if( last_slash_idx != std::string::npos )
+      {
+        m_image_by_name.emplace( name.substr( last_slash_idx + 1 ), i );
+      }
+    }
+  }
+
+  // Counting sort of the annotations by image position, keeping file order
+  std::vector< size_t > positions( m_annotations.size() );
+  m_image_offsets.assign( m_images.size() + 1, 0 );
+  size_t unmatched = 0;
+
+  for( size_t i = 0; i < m_annotations.size(); ++i )
+  {
+    auto itr = position_by_id.find( m_annotations[i].image_id );
+
+    positions[i] = ( itr == position_by_id.end() ? m_images.size() : itr->second );
+
+    if( positions[i] < m_images.size() )
+    {
+      m_image_offsets[ positions[i] + 1 ]++;
+    }
+    else
+    {
+      unmatched++;
+    }
+  }
+
+  for( size_t i = 0; i < m_images.size(); ++i )
+  {
+    m_image_offsets[ i + 1 ] += m_image_offsets[i];
+  }
+
+  std::vector< size_t > next( m_image_offsets.begin(), m_image_offsets.end() - 1 );
+  m_order.resize( m_annotations.size() - unmatched );
+
+  for( size_t i = 0; i < m_annotations.size(); ++i )
+  {
+    if( positions[i] < m_images.size() )
+    {
+      m_order[ next[ positions[i] ]++ ] = i;
+    }
+  }
+
+  if( unmatched > 0 )
+  {
+    LOG_WARN( m_parent->logger(), "Skipped " << unmatched << " annotations "
+              "referencing unknown images in " << m_filename );
+  }
+}
+
+
+// -----------------------------------------------------------------------------------
+kwiver::vital::detected_object_set_sptr
+read_detected_object_set_viame_coco::priv
+::image_set( size_t position ) const
+{
+  auto set = std::make_shared< kwiver::vital::detected_object_set >();
+
+  for( size_t i = m_image_offsets[ position ]; i < m_image_offsets[ position + 1 ]; ++i )
+  {
+    const coco_annotation& ann = m_annotations[ m_order[i] ];
+
+    const kwiver::vital::bounding_box_d bbox(
+      ann.bbox[0], ann.bbox[1], ann.bbox[0] + ann.bbox[2], ann.bbox[1] + ann.bbox[3] );
+
+    const double confidence = ( ann.score >= 0.0 ? ann.score : 1.0 );
+
+    auto cat_itr = m_categories.find( ann.category_id );
+    const std::string category = ( cat_itr != m_categories.end() ?
+      cat_itr->second : std::to_string( ann.category_id ) );
+
+    auto dot = std::make_shared< kwiver::vital::detected_object_type >(
+      category, confidence );
+
+    auto det = std::make_shared< kwiver::vital::detected_object >(
+      bbox, confidence, dot );
+
+    if( ann.poly_size > 0 )
+    {
+      det->set_flattened_polygon( std::vector< double >(
+        m_polygons.begin() + ann.poly_begin,
+        m_polygons.begin() + ann.poly_begin + ann.poly_size ) );
+    }
+
+    set->add( det );
+  }
+  return set;
+}
+
+
+// ===================================================================================
+read_detected_object_set_viame_coco
+::read_detected_object_set_viame_coco()
+  : d( new read_detected_object_set_viame_coco::priv( this ) )
+{
+  attach_logger( "viame.core.read_detected_object_set_viame_coco" );
+}
+
+
+read_detected_object_set_viame_coco
+::~read_detected_object_set_viame_coco()
+{
+}
+
+
+// -----------------------------------------------------------------------------------
+void
+read_detected_object_set_viame_coco
+::open( std::string const& filename )
+{
+  kwiver::vital::algo::detected_object_set_input::open( filename );
+
+  d->m_filename = filename;
+  d->m_first = true;
+}
+
+
+// -----------------------------------------------------------------------------------
+void
+read_detected_object_set_viame_coco
+::set_configuration( kwiver::vital::config_block_sptr config )
+{
+}
+
+
+// -----------------------------------------------------------------------------------
+bool
+read_detected_object_set_viame_coco
+::check_configuration( kwiver::vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+
+// -----------------------------------------------------------------------------------
+bool
+read_detected_object_set_viame_coco
+::read_set( kwiver::vital::detected_object_set_sptr& set, std::string& image_name )
+{
+  if( d->m_first )
+  {
+    d->read_all();
+    d->m_first = false;
+    d->m_current_image = 0;
+  }
+
+  // External image name provided, use that
+  if( !image_name.empty() && !d->m_image_by_name.empty() )
+  {
+    auto itr = d->m_image_by_name.find( image_name );
+
+    if( itr == d->m_image_by_name.end() )
+    {
+      const size_t last_slash_idx = image_name.find_last_of( "\\/" );
+      if( last_slash_idx != std::string::npos )
+      {
+        itr = d->m_image_by_name.find( image_name.substr( last_slash_idx + 1 ) );
+      }
+    }
+
+    set = ( itr != d->m_image_by_name.end() ? d->image_set( itr->second ) :
+            std::make_shared< kwiver::vital::detected_object_set >() );
+    return true;
+  }
+
+  if( d->m_current_image >= d->m_images.size() )
+  {
+    return false;
+  }
+
+  set = d->image_set( d->m_current_image );
+  image_name = d->m_images[ d->m_current_image ].file_name;
+
+  ++d->m_current_image;
+  return true;
+}
+
+} // end namespace
@@ -0,0 +1,211 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation for read_detected_object_set_viame_columnar
+ */
+
+#include "read_detected_object_set_viame_columnar.h"
+#include "viame_columnar_table.h"
+
+#include <unordered_map>
+
+namespace viame {
+
+// -----------------------------------------------------------------------------------
+class read_detected_object_set_viame_columnar::priv
+{
+public:
+  priv()
+    : m_groups( viame_columnar_table::ALL_GROUPS )
+    , m_first( true )
+    , m_current_frame( 0 )
+  {}
+
+  ~priv() {}
+
+  // Detections of the frame at the given frame index position
+  kwiver::vital::detected_object_set_sptr frame_set( size_t position ) const;
+
+  unsigned m_groups;
+  std::string m_filename;
+  bool m_first;
+  size_t m_current_frame;
+
+  viame_columnar_table m_table;
+
+  // Frame index position of every image name, and of their file names
+  std::unordered_map< std::string, size_t > m_frame_by_name;
+};
+
+
+// -----------------------------------------------------------------------------------
+kwiver::vital::detected_object_set_sptr
+read_detected_object_set_viame_columnar::priv
+::frame_set( size_t position ) const
+{
+  auto const& index = m_table.frame_index();
+  const size_t end = ( position + 1 < index.size() ?
+                       index[ position + 1 ].second : m_table.size() );
+
+  auto set = std::make_shared< kwiver::vital::detected_object_set >();
+
+  for( size_t row = index[ position ].second; row < end; ++row )
+  {
+    set->add( m_table.detection( row ) );
+  }
+  return set;
+}
+
+
+// ===================================================================================
+read_detected_object_set_viame_columnar
+::read_detected_object_set_viame_columnar()
+  : d( new read_detected_object_set_viame_columnar::priv() )
+{
+  attach_logger( "viame.core.read_detected_object_set_viame_columnar" );
+}
+
+
+read_detected_object_set_viame_columnar
+::~read_detected_object_set_viame_columnar()
+{
+}
+
+
+// -----------------------------------------------------------------------------------
+void
+read_detected_object_set_viame_columnar
+::open( std::string const& filename )
+{
+  kwiver::vital::algo::detected_object_set_input::open( filename );
+
+  d->m_filename = filename;
+  d->m_first = true;
+}
+
+
+// -----------------------------------------------------------------------------------
+void
+read_detected_object_set_viame_columnar
+::set_configuration( kwiver::vital::config_block_sptr config )
+{
+  // Column groups to load, the others are left empty
+  const std::pair< const char*, unsigned > group_options[] =
+  {
+    { "load_classes", viame_columnar_table::CLASSES },
+    { "load_polygons", viame_columnar_table::POLYGONS },
+    { "load_keypoints", viame_columnar_table::KEYPOINTS },
+    { "load_notes", viame_columnar_table::NOTES },
+  };
+
+  for( auto const& option : group_options )
+  {
+    const bool load = config->get_value< bool >(
+      option.first, ( d->m_groups & option.second ) != 0 );
+
+    d->m_groups = load ? ( d->m_groups | option.second ) : ( d->m_groups & ~option.second );
+  }
+}
+
+
+// -----------------------------------------------------------------------------------
+bool
+read_detected_object_set_viame_columnar
+::check_configuration( kwiver::vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+
+// -----------------------------------------------------------------------------------
+bool
+read_detected_object_set_viame_columnar
+::read_set( kwiver::vital::detected_object_set_sptr& set, std::string& image_name )
+{
+  auto const& index = d->m_table.frame_index();
+
+  if( d->m_first )
+  {
+    d->m_table.read( d->m_filename, d->m_groups );
+    d->m_first = false;
+    d->m_current_frame = 0;
+    d->m_frame_by_name.clear();
+
+    for( size_t i = 0; i < index.size(); ++i )
+    {
+      const std::string& name = d->m_table.source( index[ i ].second );
+
+      if( !name.empty() )
+      {
+        d->m_frame_by_name.emplace( name, i );
+
+        const size_t last_slash_idx = name.find_last_of( "\\/" );
+        if( last_slash_idx != std::string::npos )
+        {
+          d->m_frame_by_name.emplace( name.substr( last_slash_idx + 1 ), i );
+        }
+      }
+    }
+  }
+
+  // External image name provided, use that
+  if( !image_name.empty() && !d->m_frame_by_name.empty() )
+  {
+    auto itr = d->m_frame_by_name.find( image_name );
+
+    if( itr == d->m_frame_by_name.end() )
+    {
+      const size_t last_slash_idx = image_name.find_last_of( "\\/" );
+      if( last_slash_idx != std::string::npos )
+      {
+        itr = d->m_frame_by_name.find( image_name.substr( last_slash_idx + 1 ) );
+      }
+    }
+
+    set = ( itr != d->m_frame_by_name.end() ? d->frame_set( itr->second ) :
+            std::make_shared< kwiver::vital::detected_object_set >() );
+    return true;
+  }
+
+  if( d->m_current_frame >= index.size() )
+  {
+    return false;
+  }
+
+  set = d->frame_set( d->m_current_frame );
+  image_name = d->m_table.source( index[ d->m_current_frame ].second );
+
+  ++d->m_current_frame;
+  return true;
+}
+
+} // end namespace
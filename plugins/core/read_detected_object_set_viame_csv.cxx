@@ -35,22 +35,25 @@
 
 #include "read_detected_object_set_viame_csv.h"
 #include "notes_to_attributes.h"
+#include "csv_file_parser.h"
+#include "thread_pool.h"
 
 #include <vital/util/transform_image.h>
 #include <vital/util/tokenize.h>
-#include <vital/util/data_stream_reader.h>
 #include <vital/types/image.h>
 #include <vital/types/image_container.h>
 #include <vital/exceptions.h>
 
 #include <kwiversys/SystemTools.hxx>
 
+#include <future>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <cstdlib>
 #include <iostream>
 #include <algorithm>
+#include <thread>
 
 #ifdef VIAME_ENABLE_VXL
 #include <vgl/vgl_polygon.h>
@@ -74,6 +77,9 @@ enum
   COL_TOT        // 9
 };
 
+// Smallest part of a file parsed on its own thread when load_threads != 1
+const std::size_t min_load_chunk_size = 4 << 20;
+
 // -----------------------------------------------------------------------------------
 class read_detected_object_set_viame_csv::priv
 {
@@ -84,6 +90,7 @@ public:
     , m_confidence_override( -1.0 )
     , m_poly_to_mask( false )
     , m_warning_file( "" )
+    , m_load_threads( 1 )
     , m_current_idx( 0 )
     , m_last_idx( 0 )
     , m_error_writer()
@@ -91,13 +98,24 @@ public:
 
   ~priv() { }
 
+  // Detection parsed from one line, before insertion into the frame maps
+  struct parsed_detection
+  {
+    int frame_id;
+    std::string str_id;
+    kwiver::vital::detected_object_sptr dob;
+  };
+
   void read_all();
+  std::vector< parsed_detection > parse_lines( std::string_view data ) const;
 
   read_detected_object_set_viame_csv* m_parent;
   bool m_first;
   double m_confidence_override;
   bool m_poly_to_mask;
   std::string m_warning_file;
+  unsigned m_load_threads;
+  std::string m_filename;
 
   int m_current_idx;
   int m_last_idx;
@@ -150,6 +168,17 @@ read_detected_object_set_viame_csv
 }
 
 
+// -----------------------------------------------------------------------------------
+void
+read_detected_object_set_viame_csv
+::open( std::string const& filename )
+{
+  kwiver::vital::algo::detected_object_set_input::open( filename );
+
+  d->m_filename = filename;
+}
+
+
 // -----------------------------------------------------------------------------------
 void
 read_detected_object_set_viame_csv
@@ -161,6 +190,8 @@ read_detected_object_set_viame_csv
     config->get_value< bool >( "poly_to_mask", d->m_poly_to_mask );
   d->m_warning_file =
     config->get_value< std::string >( "warning_file", d->m_warning_file );
+  d->m_load_threads =
+    config->get_value< unsigned >( "load_threads", d->m_load_threads );
 
   if( !d->m_warning_file.empty() )
   {
@@ -287,77 +318,146 @@ void
 read_detected_object_set_viame_csv::priv
 ::read_all()
 {
-  std::string line;
-  kwiver::vital::data_stream_reader stream_reader( m_parent->stream() );
+  // Parse fields in place from the mapped file, falling back on the stream
+  csv_file_view file( m_filename, m_parent->stream() );
 
   // Read detections
   m_detection_by_id.clear();
   m_detection_by_str.clear();
 
-  while( stream_reader.getline( line ) )
+  std::vector< std::vector< parsed_detection > > chunk_detections;
+
+  const auto chunks = csv_split_lines( file.data(),
+    m_load_threads == 0 ? std::thread::hardware_concurrency() : m_load_threads,
+    min_load_chunk_size );
+
+  if( chunks.size() > 1 )
   {
-    std::vector< std::string > col;
-    kwiver::vital::tokenize( line, col, ",", false );
+    // Parse chunks concurrently, the futures keep them in file order
+    thread_pool workers( chunks.size() );
+    std::vector< std::future< std::vector< parsed_detection > > > results;
 
-    if( col.empty() || ( !col[0].empty() && col[0][0] == '#' ) )
+    for( auto const& chunk : chunks )
     {
-      continue;
+      results.push_back( workers.enqueue(
+        [this, chunk]{ return parse_lines( chunk ); } ) );
     }
-
-    if( col.size() < 9 )
+    for( auto& result : results )
     {
-      std::stringstream str;
-      str << "This is not a viame_csv file; found " << col.size()
-          << " columns in\n\"" << line << "\"";
-      throw kwiver::vital::invalid_data( str.str() );
+      chunk_detections.push_back( result.get() );
     }
+  }
+  else
+  {
+    chunk_detections.push_back( parse_lines( file.data() ) );
+  }
 
-    /*
-     * Check to see if we have seen this frame before. If we have,
-     * then retrieve the frame's index into our output map. If not
-     * seen before, add frame -> detection set index to our map and
-     * press on.
-     *
-     * This allows for track states to be written in a non-contiguous
-     * manner as may be done by streaming writers.
-     */
-    int frame_id = atoi( col[COL_FRAME_ID].c_str() );
-    std::string str_id = col[COL_SOURCE_ID];
-
-    if( m_detection_by_id.count( frame_id ) == 0 )
+  for( auto const& detections : chunk_detections )
+  {
+    for( auto const& det : detections )
     {
-      // create a new detection set entry
-      m_detection_by_id[ frame_id ] =
-        std::make_shared<kwiver::vital::detected_object_set>();
-    }
+      /*
+       * Check to see if we have seen this frame before. If we have,
+       * then retrieve the frame's index into our output map. If not
+       * seen before, add frame -> detection set index to our map and
+       * press on.
+       *
+       * This allows for track states to be written in a non-contiguous
+       * manner as may be done by streaming writers.
+       */
+      auto& frame_set = m_detection_by_id[ det.frame_id ];
+
+      if( !frame_set )
+      {
+        // create a new detection set entry
+        frame_set = std::make_shared<kwiver::vital::detected_object_set>();
+      }
 
-    if( !str_id.empty() &&
-        m_detection_by_str.count( str_id ) == 0 )
-    {
-      // create a new detection set entry
-      m_detection_by_str[ str_id ] =
-        std::make_shared<kwiver::vital::detected_object_set>();
-
-      // if this name contains a path, populate synonyms
-      std::string tmp = str_id;
-      while( tmp.find( '/' ) != std::string::npos ||
-             tmp.find( '\\' ) != std::string::npos )
+      if( !det.str_id.empty() &&
+          m_detection_by_str.count( det.str_id ) == 0 )
       {
-        tmp = tmp.substr( tmp.find_first_of( "/\\" ) + 1 );
-        if( !tmp.empty() )
+        // create a new detection set entry
+        m_detection_by_str[ det.str_id ] =
+          std::make_shared<kwiver::vital::detected_object_set>();
+
+        // if this name contains a path, populate synonyms
+        std::string tmp = det.str_id;
+        while( tmp.find( '/' ) != std::string::npos ||
+               tmp.find( '\\' ) != std::string::npos )
         {
-          m_alt_filenames[ tmp ] = str_id;
+          tmp = tmp.substr( tmp.find_first_of( "/\\" ) + 1 );
+          if( !tmp.empty() )
+          {
+            m_alt_filenames[ tmp ] = det.str_id;
+          }
         }
       }
+
+      // Add detection to set for the frame
+      frame_set->add( det.dob );
+
+      if( !det.str_id.empty() )
+      {
+        m_detection_by_str[ det.str_id ]->add( det.dob );
+      }
+    }
+  }
+
+  // Check if all frame names are timestamps, if so don't use them in favor of frame ids
+  unsigned timestamp_count = 0;
+  unsigned frame_count = 0;
+
+  for( auto itr : m_detection_by_str )
+  {
+    const std::string& entry = itr.first;
+
+    if( ( ( std::count( entry.begin(), entry.end(), ':' ) == 2 ||
+            std::count( entry.begin(), entry.end(), ':' ) == 1 ) &&
+          std::count( entry.begin(), entry.end(), '.' ) == 1 ) ||
+         entry.find( ".data@" ) != std::string::npos )
+    {
+      timestamp_count++;
+    }
+    else
+    {
+      frame_count++;
+    }
+  }
+
+  if( timestamp_count > 0 && frame_count <= 1 && timestamp_count > frame_count )
+  {
+    m_detection_by_str.clear();
+  }
+} // read_all
+
+
+// -----------------------------------------------------------------------------------
+std::vector< read_detected_object_set_viame_csv::priv::parsed_detection >
+read_detected_object_set_viame_csv::priv
+::parse_lines( std::string_view data ) const
+{
+  std::vector< parsed_detection > output;
+  csv_line_parser parser( data, "," );
+
+  while( parser.next() )
+  {
+    const std::vector< std::string_view >& col = parser.fields();
+
+    if( col.size() < 9 )
+    {
+      std::stringstream str;
+      str << "This is not a viame_csv file; found " << col.size()
+          << " columns in\n\"" << parser.line() << "\"";
+      throw kwiver::vital::invalid_data( str.str() );
     }
 
     kwiver::vital::bounding_box_d bbox(
-      atof( col[COL_MIN_X].c_str() ),
-      atof( col[COL_MIN_Y].c_str() ),
-      atof( col[COL_MAX_X].c_str() ),
-      atof( col[COL_MAX_Y].c_str() ) );
+      csv_to_double( col[COL_MIN_X] ),
+      csv_to_double( col[COL_MIN_Y] ),
+      csv_to_double( col[COL_MAX_X] ),
+      csv_to_double( col[COL_MAX_Y] ) );
 
-    double conf = atof( col[COL_CONFIDENCE].c_str() );
+    double conf = csv_to_double( col[COL_CONFIDENCE] );
 
     if( conf == -1.0 )
     {
@@ -389,13 +489,13 @@ read_detected_object_set_viame_csv::priv
       {
         std::stringstream str;
         str << "Every species pair must contain a confidence; error "
-            << "at\n\"" << line << "\"";
+            << "at\n\"" << parser.line() << "\"";
         throw kwiver::vital::invalid_data( str.str() );
       }
 
-      std::string spec_id = col[i];
+      std::string spec_id( col[i] );
 
-      double spec_conf = atof( col[i+1].c_str() );
+      double spec_conf = csv_to_double( col[i+1] );
 
       if( m_confidence_override > 0.0 )
       {
@@ -420,10 +520,10 @@ read_detected_object_set_viame_csv::priv
     {
       for( unsigned i = COL_TOT; i < col.size(); i++ )
       {
-        if( ( col[i].size() >= 6 && col[i].substr( 0, 6 ) == "(poly)" ) ||
-            ( col[i].size() >= 7 && col[i].substr( 0, 7 ) == "(+poly)" ) )
+        if( csv_starts_with( col[i], "(poly)" ) ||
+            csv_starts_with( col[i], "(+poly)" ) )
         {
-          poly_strings.push_back( col[i] );
+          poly_strings.emplace_back( col[i] );
         }
       }
     }
@@ -521,40 +621,11 @@ read_detected_object_set_viame_csv::priv
       add_attributes_to_detection( *dob, col );
     }
 
-    // Add detection to set for the frame
-    m_detection_by_id[ frame_id ]->add( dob );
-
-    if( !str_id.empty() )
-    {
-      m_detection_by_str[ str_id ]->add( dob );
-    }
+    output.push_back( { csv_to_int( col[COL_FRAME_ID] ),
+                        std::string( col[COL_SOURCE_ID] ), dob } );
   } // ...while !eof
 
-  // Check if all frame names are timestamps, if so don't use them in favor of frame ids
-  unsigned timestamp_count = 0;
-  unsigned frame_count = 0;
-
-  for( auto itr : m_detection_by_str )
-  {
-    const std::string& entry = itr.first;
-
-    if( ( ( std::count( entry.begin(), entry.end(), ':' ) == 2 ||
-            std::count( entry.begin(), entry.end(), ':' ) == 1 ) &&
-          std::count( entry.begin(), entry.end(), '.' ) == 1 ) ||
-         entry.find( ".data@" ) != std::string::npos )
-    {
-      timestamp_count++;
-    }
-    else
-    {
-      frame_count++;
-    }
-  }
-
-  if( timestamp_count > 0 && frame_count <= 1 && timestamp_count > frame_count )
-  {
-    m_detection_by_str.clear();
-  }
-} // read_all
+  return output;
+} // parse_lines
 
 } // end namespace
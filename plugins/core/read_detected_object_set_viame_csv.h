@@ -64,6 +64,8 @@ public:
   read_detected_object_set_viame_csv();
   virtual ~read_detected_object_set_viame_csv();
 
+  virtual void open( std::string const& filename );
+
   virtual void set_configuration(kwiver::vital::config_block_sptr config);
   virtual bool check_configuration(kwiver::vital::config_block_sptr config) const;
 
@@ -0,0 +1,212 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation for read_object_track_set_viame_columnar
+ */
+
+#include "read_object_track_set_viame_columnar.h"
+#include "viame_columnar_table.h"
+
+#include <vital/types/object_track_set.h>
+
+#include <map>
+
+namespace viame {
+
+// -------------------------------------------------------------------------------
+class read_object_track_set_viame_columnar::priv
+{
+public:
+  priv()
+    : m_groups( viame_columnar_table::ALL_GROUPS )
+    , m_batch_load( false )
+    , m_first( true )
+    , m_current_idx( 0 )
+  {}
+
+  ~priv() {}
+
+  typedef std::vector< kwiver::vital::track_sptr > track_vector;
+
+  // Helper function - read all states into tracks
+  void read_all();
+
+  unsigned m_groups;
+  bool m_batch_load;
+  std::string m_filename;
+  bool m_first;
+  kwiver::vital::frame_id_t m_current_idx;
+
+  // Tracks active on each frame, and all tracks by id
+  std::map< kwiver::vital::frame_id_t, track_vector > m_tracks_by_frame_id;
+  std::map< kwiver::vital::track_id_t, kwiver::vital::track_sptr > m_all_tracks;
+};
+
+
+// -------------------------------------------------------------------------------
+void
+read_object_track_set_viame_columnar::priv
+::read_all()
+{
+  viame_columnar_table table;
+  table.read( m_filename, m_groups );
+
+  m_tracks_by_frame_id.clear();
+  m_all_tracks.clear();
+
+  // Rows are sorted by frame, so states are appended in order
+  for( size_t row = 0; row < table.size(); ++row )
+  {
+    kwiver::vital::track_sptr& trk = m_all_tracks[ table.track_id( row ) ];
+
+    if( !trk )
+    {
+      trk = kwiver::vital::track::create();
+      trk->set_id( table.track_id( row ) );
+    }
+
+    trk->append( std::make_shared< kwiver::vital::object_track_state >(
+      table.frame_id( row ), table.time_usec( row ), table.detection( row ) ) );
+
+    if( !m_batch_load )
+    {
+      m_tracks_by_frame_id[ table.frame_id( row ) ].push_back( trk );
+    }
+  }
+}
+
+
+// ===============================================================================
+read_object_track_set_viame_columnar
+::read_object_track_set_viame_columnar()
+  : d( new read_object_track_set_viame_columnar::priv() )
+{
+}
+
+
+read_object_track_set_viame_columnar
+::~read_object_track_set_viame_columnar()
+{
+}
+
+
+// -------------------------------------------------------------------------------
+void
+read_object_track_set_viame_columnar
+::open( std::string const& filename )
+{
+  kwiver::vital::algo::read_object_track_set::open( filename );
+
+  d->m_filename = filename;
+  d->m_first = true;
+  d->m_current_idx = 0;
+}
+
+
+// -------------------------------------------------------------------------------
+void
+read_object_track_set_viame_columnar
+::set_configuration( kwiver::vital::config_block_sptr config )
+{
+  d->m_batch_load =
+    config->get_value< bool >( "batch_load", d->m_batch_load );
+
+  // Column groups to load, the others are left empty
+  const std::pair< const char*, unsigned > group_options[] =
+  {
+    { "load_classes", viame_columnar_table::CLASSES },
+    { "load_polygons", viame_columnar_table::POLYGONS },
+    { "load_keypoints", viame_columnar_table::KEYPOINTS },
+    { "load_notes", viame_columnar_table::NOTES },
+  };
+
+  for( auto const& option : group_options )
+  {
+    const bool load = config->get_value< bool >(
+      option.first, ( d->m_groups & option.second ) != 0 );
+
+    d->m_groups = load ? ( d->m_groups | option.second ) : ( d->m_groups & ~option.second );
+  }
+}
+
+
+// -------------------------------------------------------------------------------
+bool
+read_object_track_set_viame_columnar
+::check_configuration( kwiver::vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+
+// -------------------------------------------------------------------------------
+bool
+read_object_track_set_viame_columnar
+::read_set( kwiver::vital::object_track_set_sptr& set )
+{
+  const bool was_first = d->m_first;
+
+  if( was_first )
+  {
+    d->read_all();
+    d->m_first = false;
+  }
+
+  if( d->m_batch_load )
+  {
+    if( !was_first )
+    {
+      return false;
+    }
+
+    priv::track_vector trks;
+    for( auto const& trk : d->m_all_tracks )
+    {
+      trks.push_back( trk.second );
+    }
+
+    set = std::make_shared< kwiver::vital::object_track_set >( trks );
+    return true;
+  }
+
+  // Return tracks active at the current frame, or an empty set
+  auto itr = d->m_tracks_by_frame_id.find( d->m_current_idx );
+
+  set = ( itr == d->m_tracks_by_frame_id.end() ?
+          std::make_shared< kwiver::vital::object_track_set >() :
+          std::make_shared< kwiver::vital::object_track_set >( itr->second ) );
+
+  ++d->m_current_idx;
+  return true;
+}
+
+} // end namespace
@@ -36,13 +36,19 @@
 #include "read_object_track_set_viame_csv.h"
 #include "filename_to_timestamp.h"
 #include "notes_to_attributes.h"
-
-#include <vital/util/tokenize.h>
-#include <vital/util/data_stream_reader.h>
+#include "csv_file_parser.h"
+#include "thread_pool.h"
 
 #include <kwiversys/SystemTools.hxx>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <future>
 #include <set>
+#include <sstream>
+#include <thread>
 
 namespace viame {
 
@@ -60,6 +66,42 @@ enum
   COL_TOT        // 9
 };
 
+// Smallest part of a file parsed on its own thread when load_threads != 1
+const std::size_t min_load_chunk_size = 4 << 20;
+
+namespace {
+
+// Leading bytes of frame index sidecar files
+const char frame_index_magic[] = "VIAMEFI1";
+const std::size_t frame_index_magic_size = sizeof( frame_index_magic ) - 1;
+
+template< typename T >
+void write_binary( std::ofstream& out, const T& value )
+{
+  out.write( reinterpret_cast< const char* >( &value ), sizeof( T ) );
+}
+
+template< typename T >
+void read_binary( std::ifstream& in, T& value )
+{
+  in.read( reinterpret_cast< char* >( &value ), sizeof( T ) );
+}
+
+void
+check_column_count( const std::vector< std::string_view >& col,
+                    std::string_view line )
+{
+  if( col.size() < 9 )
+  {
+    std::stringstream str;
+    str << "This is not a viame_csv file; found " << col.size()
+        << " columns in\n\"" << line << "\"";
+    throw kwiver::vital::invalid_data( str.str() );
+  }
+}
+
+} // end anonymous namespace
+
 // -------------------------------------------------------------------------------
 class read_object_track_set_viame_csv::priv
 {
@@ -73,6 +115,9 @@ public:
     , m_frame_id_adjustment( 0 )
     , m_single_state_only( false )
     , m_multi_state_only( false )
+    , m_load_threads( 1 )
+    , m_lazy_load( false )
+    , m_frame_index_file( "" )
     , m_first( true )
     , m_current_idx( 0 )
     , m_last_idx( 1 )
@@ -93,18 +138,72 @@ public:
   frame_id_t m_frame_id_adjustment;
   bool m_single_state_only;
   bool m_multi_state_only;
+  unsigned m_load_threads;
+  bool m_lazy_load;
+  std::string m_frame_index_file;
+
+  // Name of the opened file, mapped for parsing when set
+  std::string m_filename;
 
   // Internal counters
   bool m_first;
   frame_id_t m_current_idx;
   frame_id_t m_last_idx;
 
+  // Track state parsed from one line, before insertion into its track
+  struct parsed_state
+  {
+    int trk_id;
+    kwiver::vital::track_state_sptr ots;
+  };
+
   // Helper function - read all states
   void read_all();
 
+  // Helper function - parse the states of a part of the file
+  std::vector< parsed_state > parse_lines( std::string_view data ) const;
+
+  // Helper function - parse the state of a single split line
+  parsed_state parse_line( const std::vector< std::string_view >& col,
+                           std::string_view line ) const;
+
   // Helper function - format tracks for current frame
   track_vector format_tracks( const track_vector& tracks, const frame_id_t frame_id );
 
+  // Lazy mode - index the line offsets of every frame, or load the sidecar
+  void build_frame_index();
+  bool read_frame_index_file( std::uint64_t file_size, std::int64_t modified_time );
+  void write_frame_index_file( std::uint64_t file_size, std::int64_t modified_time ) const;
+
+  // Lazy mode - parse the lines of one frame, appending them to their tracks
+  track_vector read_frame( const frame_id_t frame_id );
+
+  // Number of states of a track in the whole file
+  size_t track_length( const kwiver::vital::track_sptr& trk ) const;
+
+  // Lazy mode - line start of a state, frame ids are the ones in the file
+  struct frame_index_entry
+  {
+    frame_id_t frame_id;
+    std::uint64_t offset;
+  };
+
+  // Lazy mode - summary of a track over the whole file
+  struct track_index_entry
+  {
+    std::uint32_t state_count;
+    frame_id_t last_frame;
+  };
+
+  // Lazy mode - contents kept open for parsing frames on request
+  std::unique_ptr< csv_file_view > m_file;
+
+  // Lazy mode - states sorted by frame, then by position in the file
+  std::vector< frame_index_entry > m_frame_index;
+
+  // Lazy mode - track id -> summary of the track
+  std::map< frame_id_t, track_index_entry > m_track_index;
+
   // Map of object tracks indexed by frame number. Each set contains all tracks
   // referenced (active) on that individual frame.
   std::map< frame_id_t, track_vector > m_tracks_by_frame_id;
@@ -139,10 +238,15 @@ read_object_track_set_viame_csv
   kwiver::vital::algo::read_object_track_set::open( filename );
 
   d->m_first = true;
+  d->m_filename = filename;
 
   d->m_tracks_by_frame_id.clear();
   d->m_all_tracks.clear();
   d->m_track_ids.clear();
+
+  d->m_file.reset();
+  d->m_frame_index.clear();
+  d->m_track_index.clear();
 }
 
 
@@ -163,6 +267,12 @@ read_object_track_set_viame_csv
     config->get_value< bool >( "single_state_only", d->m_single_state_only );
   d->m_multi_state_only =
     config->get_value< bool >( "multi_state_only", d->m_multi_state_only );
+  d->m_load_threads =
+    config->get_value< unsigned >( "load_threads", d->m_load_threads );
+  d->m_lazy_load =
+    config->get_value< bool >( "lazy_load", d->m_lazy_load );
+  d->m_frame_index_file =
+    config->get_value< std::string >( "frame_index_file", d->m_frame_index_file );
 
   d->m_current_idx = d->m_frame_id_adjustment;
 }
@@ -190,8 +300,16 @@ read_object_track_set_viame_csv
 
   if( was_first )
   {
-    // Read in all detections
-    d->read_all();
+    if( d->m_lazy_load && !d->m_batch_load )
+    {
+      // Only index frame positions, states are parsed as frames are requested
+      d->build_frame_index();
+    }
+    else
+    {
+      // Read in all detections
+      d->read_all();
+    }
     d->m_first = false;
   }
 
@@ -222,6 +340,16 @@ read_object_track_set_viame_csv
     return true;
   }
 
+  if( d->m_file )
+  {
+    set = std::make_shared< kwiver::vital::object_track_set >(
+      d->format_tracks(
+        d->read_frame( d->m_current_idx ), d->m_current_idx ) );
+
+    ++d->m_current_idx;
+    return true;
+  }
+
   // Return detection set at current index if there is one
   if( d->m_tracks_by_frame_id.count( d->m_current_idx ) == 0 )
   {
@@ -250,8 +378,8 @@ void
 read_object_track_set_viame_csv::priv
 ::read_all()
 {
-  std::string line;
-  kwiver::vital::data_stream_reader stream_reader( m_parent->stream() );
+  // Parse fields in place from the mapped file, falling back on the stream
+  csv_file_view file( m_filename, m_parent->stream() );
 
   m_tracks_by_frame_id.clear();
   m_all_tracks.clear();
@@ -264,141 +392,189 @@ read_object_track_set_viame_csv::priv
     m_track_ids.clear();
   }
 
-  // Read track file
-  while( stream_reader.getline( line ) )
-  {
-    if( !line.empty() && line[0] == '#' )
-    {
-      continue;
-    }
+  std::vector< std::vector< parsed_state > > chunk_states;
 
-    std::vector< std::string > col;
-    kwiver::vital::tokenize( line, col, m_delim, false );
+  const auto chunks = csv_split_lines( file.data(),
+    m_load_threads == 0 ? std::thread::hardware_concurrency() : m_load_threads,
+    min_load_chunk_size );
 
-    if( col.size() < 9 )
+  if( chunks.size() > 1 )
+  {
+    // Parse chunks concurrently, the futures keep them in file order
+    thread_pool workers( chunks.size() );
+    std::vector< std::future< std::vector< parsed_state > > > results;
+
+    for( auto const& chunk : chunks )
     {
-      std::stringstream str;
-      str << "This is not a viame_csv file; found " << col.size()
-          << " columns in\n\"" << line << "\"";
-      throw kwiver::vital::invalid_data( str.str() );
+      results.push_back( workers.enqueue(
+        [this, chunk]{ return parse_lines( chunk ); } ) );
     }
-
-    /*
-     * Check to see if we have seen this frame before. If we have,
-     * then retrieve the frame's index into our output map. If not
-     * seen before, add frame -> detection set index to our map and
-     * press on.
-     *
-     * This allows for track states to be written in a non-contiguous
-     * manner as may be done by streaming writers.
-     */
-    int trk_id = atoi( col[COL_DET_ID].c_str() );
-    frame_id_t frame_id = atoi( col[COL_FRAME_ID].c_str() );
-    frame_id = frame_id + m_frame_id_adjustment;
-    kwiver::vital::time_usec_t frame_time;
-    std::string str_id = col[COL_SOURCE_ID];
-
-    kwiver::vital::bounding_box_d bbox(
-      atof( col[COL_MIN_X].c_str() ),
-      atof( col[COL_MIN_Y].c_str() ),
-      atof( col[COL_MAX_X].c_str() ),
-      atof( col[COL_MAX_Y].c_str() ) );
-
-    double conf = atof( col[COL_CONFIDENCE].c_str() );
-
-    if( m_confidence_override > 0.0 )
+    for( auto& result : results )
     {
-      conf = m_confidence_override;
+      chunk_states.push_back( result.get() );
     }
+  }
+  else
+  {
+    chunk_states.push_back( parse_lines( file.data() ) );
+  }
 
-    // Create detection object
-    kwiver::vital::detected_object_sptr dob;
-
-    kwiver::vital::detected_object_type_sptr dot =
-      std::make_shared<kwiver::vital::detected_object_type>();
-
-    bool found_attribute = false;
-
-    for( unsigned i = COL_TOT; i < col.size(); i+=2 )
+  // Append states to their tracks in file order
+  for( auto const& states : chunk_states )
+  {
+    for( auto const& state : states )
     {
-      if( col[i].empty() || col[i][0] == '(' )
+      /*
+       * Check to see if we have seen this frame before. If we have,
+       * then retrieve the frame's index into our output map. If not
+       * seen before, add frame -> detection set index to our map and
+       * press on.
+       *
+       * This allows for track states to be written in a non-contiguous
+       * manner as may be done by streaming writers.
+       */
+      const int trk_id = state.trk_id;
+      const frame_id_t frame_id = state.ots->frame();
+
+      // Assign object track state to track
+      kwiver::vital::track_sptr trk;
+
+      if( m_all_tracks.count( trk_id ) == 0 )
       {
-        found_attribute = true;
-        break;
+        trk = kwiver::vital::track::create();
+        trk->set_id( trk_id );
+        m_all_tracks[ trk_id ] = trk;
       }
-
-      if( col.size() < i + 2 )
+      else
       {
-        std::stringstream str;
-        str << "Every species pair must contain a confidence; error "
-            << "at\n\"" << line << "\"";
-        throw kwiver::vital::invalid_data( str.str() );
+        trk = m_all_tracks[ trk_id ];
       }
 
-      std::string spec_id = col[i];
-      double spec_conf = atof( col[i+1].c_str() );
+      trk->append( state.ots );
 
-      if( m_confidence_override > 0.0 )
+      // Add track to indexes
+      if( !m_batch_load )
       {
-        spec_conf = m_confidence_override;
+        m_tracks_by_frame_id[ frame_id ].push_back( trk );
+        m_last_idx = std::max( m_last_idx, frame_id );
       }
-
-      dot->set_score( spec_id, spec_conf );
     }
+  }
+}
 
-    if( COL_TOT < col.size() )
-    {
-      dob = std::make_shared< kwiver::vital::detected_object>( bbox, conf, dot );
-    }
-    else
-    {
-      dob = std::make_shared< kwiver::vital::detected_object>( bbox, conf );
-    }
 
-    try
-    {
-      frame_time = convert_to_timestamp( str_id );
-    }
-    catch( ... )
-    {
-      frame_time = frame_id;
-    }
+// -------------------------------------------------------------------------------
+std::vector< read_object_track_set_viame_csv::priv::parsed_state >
+read_object_track_set_viame_csv::priv
+::parse_lines( std::string_view data ) const
+{
+  std::vector< parsed_state > output;
+  csv_line_parser parser( data, m_delim );
 
-    if( found_attribute )
-    {
-      add_attributes_to_detection( *dob, col );
-    }
+  while( parser.next() )
+  {
+    output.push_back( parse_line( parser.fields(), parser.line() ) );
+  }
+
+  return output;
+}
+
+
+// -------------------------------------------------------------------------------
+read_object_track_set_viame_csv::priv::parsed_state
+read_object_track_set_viame_csv::priv
+::parse_line( const std::vector< std::string_view >& col,
+              std::string_view line ) const
+{
+  check_column_count( col, line );
+
+  int trk_id = csv_to_int( col[COL_DET_ID] );
+  frame_id_t frame_id = csv_to_int( col[COL_FRAME_ID] );
+  frame_id = frame_id + m_frame_id_adjustment;
+  kwiver::vital::time_usec_t frame_time;
+  std::string str_id( col[COL_SOURCE_ID] );
+
+  kwiver::vital::bounding_box_d bbox(
+    csv_to_double( col[COL_MIN_X] ),
+    csv_to_double( col[COL_MIN_Y] ),
+    csv_to_double( col[COL_MAX_X] ),
+    csv_to_double( col[COL_MAX_Y] ) );
+
+  double conf = csv_to_double( col[COL_CONFIDENCE] );
+
+  if( m_confidence_override > 0.0 )
+  {
+    conf = m_confidence_override;
+  }
 
-    // Create new object track state
-    kwiver::vital::track_state_sptr ots =
-      std::make_shared< kwiver::vital::object_track_state >(
-        frame_id, frame_time, dob );
+  // Create detection object
+  kwiver::vital::detected_object_sptr dob;
 
-    // Assign object track state to track
-    kwiver::vital::track_sptr trk;
+  kwiver::vital::detected_object_type_sptr dot =
+    std::make_shared<kwiver::vital::detected_object_type>();
 
-    if( m_all_tracks.count( trk_id ) == 0 )
+  bool found_attribute = false;
+
+  for( unsigned i = COL_TOT; i < col.size(); i+=2 )
+  {
+    if( col[i].empty() || col[i][0] == '(' )
     {
-      trk = kwiver::vital::track::create();
-      trk->set_id( trk_id );
-      m_all_tracks[ trk_id ] = trk;
+      found_attribute = true;
+      break;
     }
-    else
+
+    if( col.size() < i + 2 )
     {
-      trk = m_all_tracks[ trk_id ];
+      std::stringstream str;
+      str << "Every species pair must contain a confidence; error "
+          << "at\n\"" << line << "\"";
+      throw kwiver::vital::invalid_data( str.str() );
     }
 
-    trk->append( ots );
+    std::string spec_id( col[i] );
+    double spec_conf = csv_to_double( col[i+1] );
 
-    // Add track to indexes
-    if( !m_batch_load )
+    if( m_confidence_override > 0.0 )
     {
-      m_tracks_by_frame_id[ frame_id ].push_back( trk );
-      m_last_idx = std::max( m_last_idx, frame_id );
+      spec_conf = m_confidence_override;
     }
+
+    dot->set_score( spec_id, spec_conf );
+  }
+
+  if( COL_TOT < col.size() )
+  {
+    dob = std::make_shared< kwiver::vital::detected_object>( bbox, conf, dot );
   }
+  else
+  {
+    dob = std::make_shared< kwiver::vital::detected_object>( bbox, conf );
+  }
+
+  try
+  {
+    frame_time = convert_to_timestamp( str_id );
+  }
+  catch( ... )
+  {
+    frame_time = frame_id;
+  }
+
+  if( found_attribute )
+  {
+    add_attributes_to_detection( *dob, col );
+  }
+
+  // Create new object track state
+  kwiver::vital::track_state_sptr ots =
+    std::make_shared< kwiver::vital::object_track_state >(
+      frame_id, frame_time, dob );
+
+  return { trk_id, ots };
 }
 
+
+// -------------------------------------------------------------------------------
 read_object_track_set_viame_csv::priv::track_vector
 read_object_track_set_viame_csv::priv
 ::format_tracks( const track_vector& tracks, const frame_id_t frame_id )
@@ -409,11 +585,11 @@ read_object_track_set_viame_csv::priv
 
     for( auto trk : tracks )
     {
-      if( m_single_state_only && trk->size() > 1 )
+      if( m_single_state_only && track_length( trk ) > 1 )
       {
         continue;
       }
-      if( m_multi_state_only && trk->size() == 1 )
+      if( m_multi_state_only && track_length( trk ) == 1 )
       {
         continue;
       }
@@ -427,4 +603,224 @@ read_object_track_set_viame_csv::priv
   return tracks;
 }
 
+
+// -------------------------------------------------------------------------------
+size_t
+read_object_track_set_viame_csv::priv
+::track_length( const kwiver::vital::track_sptr& trk ) const
+{
+  if( m_file )
+  {
+    auto itr = m_track_index.find( static_cast< frame_id_t >( trk->id() ) );
+    return itr != m_track_index.end() ? itr->second.state_count : trk->size();
+  }
+  return trk->size();
+}
+
+
+// -------------------------------------------------------------------------------
+void
+read_object_track_set_viame_csv::priv
+::build_frame_index()
+{
+  m_file.reset( new csv_file_view( m_filename, m_parent->stream() ) );
+  m_frame_index.clear();
+  m_track_index.clear();
+  m_all_tracks.clear();
+
+  const std::uint64_t file_size = m_file->data().size();
+  const std::int64_t modified_time = m_filename.empty() ? 0 :
+    static_cast< std::int64_t >( kwiversys::SystemTools::ModifiedTime( m_filename ) );
+
+  if( m_frame_index_file.empty() ||
+      !read_frame_index_file( file_size, modified_time ) )
+  {
+    csv_line_parser parser( m_file->data(), m_delim );
+
+    while( parser.next() )
+    {
+      const std::vector< std::string_view >& col = parser.fields();
+      check_column_count( col, parser.line() );
+
+      const frame_id_t frame_id = csv_to_int( col[COL_FRAME_ID] );
+      m_frame_index.push_back( { frame_id, parser.offset() } );
+
+      track_index_entry& trk = m_track_index[ csv_to_int( col[COL_DET_ID] ) ];
+      trk.last_frame = trk.state_count == 0 ? frame_id : std::max( trk.last_frame, frame_id );
+      ++trk.state_count;
+    }
+
+    // Streaming writers may output frames non-contiguously, keep file order per frame
+    std::stable_sort( m_frame_index.begin(), m_frame_index.end(),
+      []( const frame_index_entry& lhs, const frame_index_entry& rhs )
+      {
+        return lhs.frame_id < rhs.frame_id;
+      } );
+
+    if( !m_frame_index_file.empty() )
+    {
+      write_frame_index_file( file_size, modified_time );
+    }
+  }
+
+  if( !m_frame_index.empty() )
+  {
+    m_last_idx = std::max( m_last_idx,
+      m_frame_index.back().frame_id + m_frame_id_adjustment );
+  }
+}
+
+
+// -------------------------------------------------------------------------------
+bool
+read_object_track_set_viame_csv::priv
+::read_frame_index_file( std::uint64_t file_size, std::int64_t modified_time )
+{
+  // Layout : magic, source file size and modification time, delimiters, then
+  // the frame index and track index entries, each preceded by their count
+  std::ifstream in( m_frame_index_file, std::ios::binary );
+
+  char magic[ frame_index_magic_size ];
+  if( !in || !in.read( magic, frame_index_magic_size ) ||
+      std::memcmp( magic, frame_index_magic, frame_index_magic_size ) != 0 )
+  {
+    return false;
+  }
+
+  std::uint64_t indexed_size = 0;
+  std::int64_t indexed_time = 0;
+  std::uint32_t delim_size = 0;
+  read_binary( in, indexed_size );
+  read_binary( in, indexed_time );
+  read_binary( in, delim_size );
+
+  std::string delim( in && delim_size < 256 ? delim_size : 0, '\0' );
+  in.read( &delim[0], delim.size() );
+
+  if( !in || indexed_size != file_size ||
+      indexed_time != modified_time || delim != m_delim )
+  {
+    LOG_INFO( m_logger, "Frame index " << m_frame_index_file
+              << " does not match " << m_filename << ", rebuilding it" );
+    return false;
+  }
+
+  std::uint64_t count = 0;
+  read_binary( in, count );
+  for( std::uint64_t i = 0; in && i < count; ++i )
+  {
+    frame_index_entry entry;
+    read_binary( in, entry.frame_id );
+    read_binary( in, entry.offset );
+    m_frame_index.push_back( entry );
+  }
+
+  read_binary( in, count );
+  for( std::uint64_t i = 0; in && i < count; ++i )
+  {
+    frame_id_t trk_id = 0;
+    track_index_entry entry;
+    read_binary( in, trk_id );
+    read_binary( in, entry.state_count );
+    read_binary( in, entry.last_frame );
+    m_track_index[ trk_id ] = entry;
+  }
+
+  if( !in )
+  {
+    LOG_WARN( m_logger, "Truncated frame index " << m_frame_index_file
+              << ", rebuilding it" );
+    m_frame_index.clear();
+    m_track_index.clear();
+    return false;
+  }
+  return true;
+}
+
+
+// -------------------------------------------------------------------------------
+void
+read_object_track_set_viame_csv::priv
+::write_frame_index_file( std::uint64_t file_size, std::int64_t modified_time ) const
+{
+  std::ofstream out( m_frame_index_file, std::ios::binary );
+
+  out.write( frame_index_magic, frame_index_magic_size );
+  write_binary( out, file_size );
+  write_binary( out, modified_time );
+  write_binary( out, static_cast< std::uint32_t >( m_delim.size() ) );
+  out.write( m_delim.data(), m_delim.size() );
+
+  write_binary( out, static_cast< std::uint64_t >( m_frame_index.size() ) );
+  for( const auto& entry : m_frame_index )
+  {
+    write_binary( out, entry.frame_id );
+    write_binary( out, entry.offset );
+  }
+
+  write_binary( out, static_cast< std::uint64_t >( m_track_index.size() ) );
+  for( const auto& entry : m_track_index )
+  {
+    write_binary( out, entry.first );
+    write_binary( out, entry.second.state_count );
+    write_binary( out, entry.second.last_frame );
+  }
+
+  if( !out )
+  {
+    // The index is only a cache, loading still works without it
+    LOG_WARN( m_logger, "Unable to write frame index " << m_frame_index_file );
+  }
+}
+
+
+// -------------------------------------------------------------------------------
+read_object_track_set_viame_csv::priv::track_vector
+read_object_track_set_viame_csv::priv
+::read_frame( const frame_id_t frame_id )
+{
+  const frame_id_t file_frame_id = frame_id - m_frame_id_adjustment;
+
+  auto range = std::equal_range( m_frame_index.begin(), m_frame_index.end(),
+    frame_index_entry{ file_frame_id, 0 },
+    []( const frame_index_entry& lhs, const frame_index_entry& rhs )
+    {
+      return lhs.frame_id < rhs.frame_id;
+    } );
+
+  track_vector output;
+  const std::string_view data = m_file->data();
+
+  for( auto itr = range.first; itr != range.second; ++itr )
+  {
+    csv_line_parser parser( data.substr( itr->offset ), m_delim );
+    parser.next();
+
+    parsed_state state = parse_line( parser.fields(), parser.line() );
+    kwiver::vital::track_sptr& trk = m_all_tracks[ state.trk_id ];
+
+    if( !trk )
+    {
+      trk = kwiver::vital::track::create();
+      trk->set_id( state.trk_id );
+    }
+
+    trk->append( state.ots );
+    output.push_back( trk );
+  }
+
+  // Tracks without later states are no longer needed by the reader
+  for( const auto& trk : output )
+  {
+    auto itr = m_track_index.find( static_cast< frame_id_t >( trk->id() ) );
+
+    if( itr == m_track_index.end() || itr->second.last_frame <= file_frame_id )
+    {
+      m_all_tracks.erase( static_cast< frame_id_t >( trk->id() ) );
+    }
+  }
+
+  return output;
+}
+
 } // end namespace
@@ -34,6 +34,7 @@
  */
 
 #include "refine_measurements_process.h"
+#include "process_trace.h"
 
 #include <vital/vital_types.h>
 #include <vital/types/image_container.h>
@@ -46,8 +47,12 @@
 #include <sprokit/processes/kwiver_type_traits.h>
 
 #include <Eigen/Core>
+#include <Eigen/LU>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <deque>
 
 
 namespace kv = kwiver::vital;
@@ -80,8 +85,6 @@ create_config_trait( percentile, double, "0.45",
 create_config_trait( intrinsics, std::string, "1 0 0 0 1 0 0 0 1",
   "Camera calibration for use with metadata" );
 
-typedef std::pair< double, double > point_t;
-
 // =============================================================================
 // Private implementation class
 class refine_measurements_process::priv
@@ -104,13 +107,18 @@ public:
 
   // Internal variables
   double m_last_gsd;
+
+  // GSD estimates of the last history_length frames, each frame's values in
+  // m_history_frames and all of them kept sorted in m_history
   std::vector< double > m_history;
+  std::deque< std::vector< double > > m_history_frames;
 
   // Other variables
   refine_measurements_process* parent;
 
   // Helper functions
   double percentile( std::vector< double >& vec  );
+  double history_percentile( const std::vector< double >& frame_ests );
   bool is_border( const kv::bounding_box_d& box, unsigned w, unsigned h );
 };
 
@@ -150,11 +158,42 @@ refine_measurements_process::priv
     return -1.0;
   }
 
-  std::sort( vec.begin(), vec.end() );
+  // Only the selected rank needs to be in place
   unsigned ind = static_cast< unsigned >( m_percentile * vec.size() );
+  std::nth_element( vec.begin(), vec.begin() + ind, vec.end() );
   return vec[ ind ];
 }
 
+double
+refine_measurements_process::priv
+::history_percentile( const std::vector< double >& frame_ests )
+{
+  // Frames slide in and out of the sorted window, instead of sorting all of it
+  for( double est : frame_ests )
+  {
+    m_history.insert( std::upper_bound( m_history.begin(), m_history.end(), est ), est );
+  }
+
+  m_history_frames.push_back( frame_ests );
+
+  while( m_history_frames.size() > m_history_length )
+  {
+    for( double est : m_history_frames.front() )
+    {
+      m_history.erase( std::lower_bound( m_history.begin(), m_history.end(), est ) );
+    }
+
+    m_history_frames.pop_front();
+  }
+
+  if( m_history.empty() || m_percentile >= 1.0 )
+  {
+    return -1.0;
+  }
+
+  return m_history[ static_cast< unsigned >( m_percentile * m_history.size() ) ];
+}
+
 bool
 refine_measurements_process::priv
 ::is_border( const kv::bounding_box_d& box, unsigned w, unsigned h )
@@ -165,31 +204,40 @@ refine_measurements_process::priv
            box.max_y() >= h - m_border_factor );
 }
 
-point_t
-compute_ground_position( const point_t& pos, const Eigen::MatrixXd& inv )
+// Ground positions of homogeneous image points, one per column, in one product
+Eigen::Matrix2Xd
+compute_ground_positions( const Eigen::Matrix3Xd& pos, const Eigen::Matrix3d& inv )
 {
-  Eigen::Vector3d unadj = inv * Eigen::Vector3d( pos.first, pos.second, 1.0 );  
+  Eigen::Matrix3Xd unadj = inv * pos;
+  Eigen::Matrix2Xd result = Eigen::Matrix2Xd::Zero( 2, pos.cols() );
 
-  if( unadj( 2 ) > 0 )
+  for( int i = 0; i < pos.cols(); ++i )
   {
-    return point_t( unadj( 0 ) / unadj( 2 ), unadj( 1 ) / unadj( 2 ) );
+    if( unadj( 2, i ) > 0 )
+    {
+      result.col( i ) = unadj.col( i ).head< 2 >() / unadj( 2, i );
+    }
   }
 
-  return point_t( 0.0, 0.0 );
+  return result;
 }
 
-void
-remove_column( Eigen::MatrixXd& matrix, unsigned int col )
+// Parse the value of a length note, as written by detected_object::set_length
+bool
+parse_length_note( const std::string& note, double& length )
 {
-  unsigned int rows = matrix.rows();
-  unsigned int cols = matrix.cols()-1;
+  static const char prefix[] = ":length=";
+  const std::size_t prefix_size = sizeof( prefix ) - 1;
 
-  if( col < cols )
+  if( note.size() <= prefix_size || note.compare( 0, prefix_size, prefix ) != 0 )
   {
-    matrix.block( 0, col, rows, cols-col ) = matrix.block( 0, col+1, rows, cols-col );
+    return false;
   }
 
-  matrix.conservativeResize( rows, cols );
+  const char* start = note.c_str() + prefix_size;
+  char* end = nullptr;
+  length = std::strtod( start, &end );
+  return end != start;
 }
 
 
@@ -282,6 +330,8 @@ void
 refine_measurements_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
   kv::object_track_set_sptr input_tracks;
   kv::detected_object_set_sptr input_dets;
   kv::image_container_sptr image;
@@ -329,6 +379,9 @@ refine_measurements_process
 
   const unsigned detection_count = ( input_dets ? input_dets->size() : 0 );
 
+  trace.inputs_ready();
+  trace.count( "detections", detection_count );
+
   const unsigned img_height = ( image ? image->height() : 0 );
   const unsigned img_width = ( image ? image->width() : 0 );
 
@@ -347,11 +400,12 @@ refine_measurements_process
     {
       if( !det->notes().empty() && det->bounding_box().width() > 0 )
       {
-        for( auto note : det->notes() )
+        for( const auto& note : det->notes() )
         {
-          if( note.size() > 8 && note.substr( 0, 8 ) == ":length=" )
+          double lth;
+
+          if( parse_length_note( note, lth ) )
           {
-            double lth = std::stod( note.substr( 8 ) );
             double est = lth / det->bounding_box().width();
 
             lengths[ ind ] = lth;
@@ -391,6 +445,11 @@ refine_measurements_process
     initial_gsd_est = external_gsd;
     d->m_last_gsd = initial_gsd_est;
   }
+  else if( highest_conf > 1 && d->m_history_length > 0 )
+  {
+    initial_gsd_est = d->history_percentile( conf_ests[ highest_conf ] );
+    d->m_last_gsd = initial_gsd_est;
+  }
   else if( highest_conf > 1 )
   {
     initial_gsd_est = d->percentile( conf_ests[ highest_conf ] );
@@ -499,13 +558,14 @@ refine_measurements_process
     Eigen::Matrix3d rotation_matrix = q.matrix();
     Eigen::Vector3d translation_matrix( 0, 0, alt * 1000 );
 
-    Eigen::MatrixXd perspective( 3, 4 );
-    perspective << rotation_matrix, translation_matrix;
+    // Ground plane homography, the camera matrix without its third column
+    Eigen::Matrix3d camera_rt;
+    camera_rt << rotation_matrix.col( 0 ), rotation_matrix.col( 1 ), translation_matrix;
 
-    Eigen::MatrixXd camera = d->m_intrinsics * perspective;
-    remove_column( camera, 2 );
+    Eigen::Matrix3d inverse = ( d->m_intrinsics * camera_rt ).inverse();
 
-    Eigen::MatrixXd inverse = camera.inverse();
+    // Project the width endpoints of all detections to measure together
+    std::vector< kv::detected_object_sptr > measured;
 
     for( auto det : *input_dets )
     {
@@ -513,27 +573,36 @@ refine_measurements_process
             det->notes().empty() ) &&
           det->bounding_box().width() > 0 )
       {
-        if( !d->m_output_multiple )
-        {
-          det->clear_notes();
-        }
+        measured.push_back( det );
+      }
+    }
 
-        double img_y1 = ( det->bounding_box().min_y() + det->bounding_box().max_y() ) / 2;
+    Eigen::Matrix3Xd img_pts( 3, 2 * measured.size() );
 
-        double img_x1 = det->bounding_box().min_x();
-        double img_x2 = det->bounding_box().max_x();
- 
-        point_t world_xy1 = compute_ground_position( point_t( img_x1, img_y1 ), inverse );
-        point_t world_xy2 = compute_ground_position( point_t( img_x2, img_y1 ), inverse );
+    for( std::size_t i = 0; i < measured.size(); ++i )
+    {
+      const kv::bounding_box_d& box = measured[i]->bounding_box();
+      double img_y1 = ( box.min_y() + box.max_y() ) / 2;
 
-        double lth = std::sqrt( std::pow( world_xy1.first - world_xy2.first, 2 ) +
-                                std::pow( world_xy1.second - world_xy2.second, 2 ) );
+      img_pts.col( 2 * i ) << box.min_x(), img_y1, 1.0;
+      img_pts.col( 2 * i + 1 ) << box.max_x(), img_y1, 1.0;
+    }
 
-        if( ( d->m_min_valid <= 0.0 || lth >= d->m_min_valid ) &&
-            ( d->m_max_valid <= 0.0 || lth <= d->m_max_valid ) )
-        {
-          det->set_length( lth );
-        }
+    Eigen::Matrix2Xd world_pts = compute_ground_positions( img_pts, inverse );
+
+    for( std::size_t i = 0; i < measured.size(); ++i )
+    {
+      if( !d->m_output_multiple )
+      {
+        measured[i]->clear_notes();
+      }
+
+      double lth = ( world_pts.col( 2 * i ) - world_pts.col( 2 * i + 1 ) ).norm();
+
+      if( ( d->m_min_valid <= 0.0 || lth >= d->m_min_valid ) &&
+          ( d->m_max_valid <= 0.0 || lth <= d->m_max_valid ) )
+      {
+        measured[i]->set_length( lth );
       }
     }
   }
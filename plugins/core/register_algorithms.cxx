@@ -40,6 +40,16 @@
 #include "auto_detect_transform.h"
 #include "convert_head_tail_points.h"
 #include "empty_detector.h"
+#include "merge_detections_nms_fusion.h"
+#include "percentile_normalization.h"
+#include "cached_detector.h"
+#include "device_scheduled_detector.h"
+#include "device_scheduled_refiner.h"
+#include "prefetch_image_list_input.h"
+#include "scale_detections.h"
+#include "svm_bank_refine.h"
+#include "scheduled_video_input.h"
+#include "tiled_detector.h"
 #include "read_detected_object_set_fishnet.h"
 #include "read_detected_object_set_habcam.h"
 #include "read_detected_object_set_oceaneyes.h"
@@ -47,6 +57,13 @@
 #include "write_detected_object_set_viame_csv.h"
 #include "read_object_track_set_viame_csv.h"
 #include "write_object_track_set_viame_csv.h"
+#include "read_detected_object_set_viame_columnar.h"
+#include "write_detected_object_set_viame_columnar.h"
+#include "read_object_track_set_viame_columnar.h"
+#include "write_object_track_set_viame_columnar.h"
+#include "write_object_track_set_pg_copy.h"
+#include "read_detected_object_set_viame_coco.h"
+#include "write_detected_object_set_viame_coco.h"
 
 namespace viame {
 
@@ -86,6 +103,16 @@ register_factories( kwiver::vital::plugin_loader& vpm )
   register_algorithm< auto_detect_transform_io >( vpm );
   register_algorithm< convert_head_tail_points >( vpm );
   register_algorithm< empty_detector >( vpm );
+  register_algorithm< merge_detections_nms_fusion >( vpm );
+  register_algorithm< percentile_normalization >( vpm );
+  register_algorithm< cached_detector >( vpm );
+  register_algorithm< device_scheduled_detector >( vpm );
+  register_algorithm< device_scheduled_refiner >( vpm );
+  register_algorithm< prefetch_image_list_input >( vpm );
+  register_algorithm< scale_detections >( vpm );
+  register_algorithm< svm_bank_refine >( vpm );
+  register_algorithm< scheduled_video_input >( vpm );
+  register_algorithm< tiled_detector >( vpm );
   register_algorithm< read_detected_object_set_fishnet >( vpm );
   register_algorithm< read_detected_object_set_habcam >( vpm );
   register_algorithm< read_detected_object_set_oceaneyes >( vpm );
@@ -93,6 +120,13 @@ register_factories( kwiver::vital::plugin_loader& vpm )
   register_algorithm< write_detected_object_set_viame_csv >( vpm );
   register_algorithm< read_object_track_set_viame_csv >( vpm );
   register_algorithm< write_object_track_set_viame_csv >( vpm );
+  register_algorithm< read_detected_object_set_viame_columnar >( vpm );
+  register_algorithm< write_detected_object_set_viame_columnar >( vpm );
+  register_algorithm< read_object_track_set_viame_columnar >( vpm );
+  register_algorithm< write_object_track_set_viame_columnar >( vpm );
+  register_algorithm< write_object_track_set_pg_copy >( vpm );
+  register_algorithm< read_detected_object_set_viame_coco >( vpm );
+  register_algorithm< write_detected_object_set_viame_coco >( vpm );
 
   vpm.mark_module_as_loaded( module_name );
 }
@@ -0,0 +1,72 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Optional extension for row-restricted stereo depth map computation
+ */
+
+#ifndef VIAME_CORE_ROI_STEREO_DEPTH_MAP_H
+#define VIAME_CORE_ROI_STEREO_DEPTH_MAP_H
+
+#include <vital/types/image_container.h>
+
+#include <utility>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Interface for stereo depth map algorithms able to skip unused rows
+ *
+ * Implemented alongside kwiver::vital::algo::compute_stereo_depth_map by
+ * algorithms which can restrict matching to horizontal strips of the
+ * rectified left image, so that callers only needing depth inside a few
+ * regions (e.g. detections) do not pay for a full frame computation.
+ */
+class roi_stereo_depth_map
+{
+public:
+  virtual ~roi_stereo_depth_map() = default;
+
+  /// Compute a disparity map for the given [first, second) rectified row
+  /// ranges. Ranges may overlap and be unordered, pixels outside of them
+  /// are set to zero.
+  virtual kwiver::vital::image_container_sptr
+  compute_in_rows( kwiver::vital::image_container_sptr left_image,
+                   kwiver::vital::image_container_sptr right_image,
+                   const std::vector< std::pair< int, int > >& rows ) const = 0;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_ROI_STEREO_DEPTH_MAP_H
@@ -0,0 +1,365 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Read only a sampled set of frames from a video or image list
+ */
+
+#include "sample_frames_process.h"
+#include "process_trace.h"
+
+#include <vital/algo/video_input.h>
+#include <vital/types/image_container.h>
+#include <vital/types/metadata.h>
+#include <vital/types/metadata_traits.h>
+#include <vital/types/timestamp.h>
+
+#include <sprokit/processes/kwiver_type_traits.h>
+#include <sprokit/pipeline/process_exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+
+namespace kv = kwiver::vital;
+namespace algo = kwiver::vital::algo;
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( video_filename, std::string, "",
+  "Name of the video file or image list to sample." );
+create_config_trait( video_reader, std::string, "",
+  "Algorithm configuration subblock of the nested video reader." );
+create_config_trait( frame_step, unsigned, "10",
+  "Output every this many frames." );
+create_config_trait( max_frame_count, unsigned, "0",
+  "If set, output at most this many frames. When the input length is known "
+  "and frame_step would give more, they are spread evenly over the input." );
+create_config_trait( first_frame, unsigned, "1",
+  "Frame number of the first frame to output." );
+
+//------------------------------------------------------------------------------
+// Private implementation class
+class sample_frames_process::priv
+{
+public:
+  priv();
+  ~priv();
+
+  // Compute the sampled frame numbers once the input is open
+  void plan( size_t frame_count );
+
+  // Move the reader to frame, false at the end of the input
+  bool move_to( kv::frame_id_t frame, kv::timestamp& ts );
+
+  // Configuration values
+  std::string m_filename;
+  unsigned m_frame_step;
+  unsigned m_max_frame_count;
+  kv::frame_id_t m_first_frame;
+
+  algo::video_input_sptr m_reader;
+
+  // Sampled frames, or a fixed step when the input length is unknown
+  std::vector< kv::frame_id_t > m_frames;
+  bool m_unbounded;
+  size_t m_next;
+  bool m_has_frame;
+  kv::frame_id_t m_current;
+};
+
+
+// =============================================================================
+sample_frames_process::priv
+::priv()
+  : m_frame_step( 10 )
+  , m_max_frame_count( 0 )
+  , m_first_frame( 1 )
+  , m_unbounded( false )
+  , m_next( 0 )
+  , m_has_frame( false )
+  , m_current( 0 )
+{
+}
+
+
+sample_frames_process::priv
+::~priv()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+sample_frames_process::priv
+::plan( size_t frame_count )
+{
+  m_frames.clear();
+  m_next = 0;
+  m_has_frame = false;
+  m_unbounded = ( frame_count == 0 );
+
+  if( m_unbounded )
+  {
+    return;
+  }
+
+  // Frame numbers of the input run from 1 to frame_count
+  const kv::frame_id_t last = static_cast< kv::frame_id_t >( frame_count );
+
+  if( m_first_frame > last )
+  {
+    return;
+  }
+
+  const double span = static_cast< double >( last - m_first_frame + 1 );
+  double step = m_frame_step;
+
+  if( m_max_frame_count > 0 && span / step > m_max_frame_count )
+  {
+    step = span / m_max_frame_count;
+  }
+
+  for( double f = 0.0; f < span; f += step )
+  {
+    const kv::frame_id_t frame = m_first_frame + static_cast< kv::frame_id_t >( f );
+
+    if( m_frames.empty() || frame > m_frames.back() )
+    {
+      m_frames.push_back( frame );
+    }
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+sample_frames_process::priv
+::move_to( kv::frame_id_t frame, kv::timestamp& ts )
+{
+  if( m_reader->seekable() )
+  {
+    if( !m_reader->seek_frame( ts, frame ) )
+    {
+      return false;
+    }
+    m_has_frame = true;
+    m_current = ts.get_frame();
+    return true;
+  }
+
+  // Images are only requested for the frame landed on
+  while( !m_has_frame || m_current < frame )
+  {
+    if( !m_reader->next_frame( ts ) )
+    {
+      return false;
+    }
+    m_has_frame = true;
+    m_current = ts.get_frame();
+  }
+
+  ts = m_reader->frame_timestamp();
+  return true;
+}
+
+
+// =============================================================================
+sample_frames_process
+::sample_frames_process( kv::config_block_sptr const& config )
+  : process( config ),
+    d( new sample_frames_process::priv() )
+{
+  make_ports();
+  make_config();
+}
+
+
+sample_frames_process
+::~sample_frames_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+sample_frames_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t optional;
+
+  // -- outputs --
+  declare_output_port_using_trait( image, optional );
+  declare_output_port_using_trait( timestamp, optional );
+  declare_output_port_using_trait( file_name, optional );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+sample_frames_process
+::make_config()
+{
+  declare_config_using_trait( video_filename );
+  declare_config_using_trait( video_reader );
+  declare_config_using_trait( frame_step );
+  declare_config_using_trait( max_frame_count );
+  declare_config_using_trait( first_frame );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+sample_frames_process
+::_configure()
+{
+  d->m_filename = config_value_using_trait( video_filename );
+  d->m_frame_step = std::max( 1u, config_value_using_trait( frame_step ) );
+  d->m_max_frame_count = config_value_using_trait( max_frame_count );
+  d->m_first_frame = std::max( 1u, config_value_using_trait( first_frame ) );
+
+  if( d->m_filename.empty() )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "video_filename must be set" );
+  }
+
+  kv::config_block_sptr algo_config = get_config();
+
+  algo::video_input::set_nested_algo_configuration(
+    "video_reader", algo_config, d->m_reader );
+
+  if( !d->m_reader )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Unable to create video_reader" );
+  }
+
+  algo::video_input::get_nested_algo_configuration(
+    "video_reader", algo_config, d->m_reader );
+
+  if( !algo::video_input::check_nested_algo_configuration(
+        "video_reader", algo_config ) )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Configuration check failed for video_reader" );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+sample_frames_process
+::_init()
+{
+  d->m_reader->open( d->m_filename );
+  d->plan( d->m_reader->num_frames() );
+
+  LOG_INFO( logger(), "Sampling " << ( d->m_unbounded ?
+    "every " + std::to_string( d->m_frame_step ) + " frames" :
+    std::to_string( d->m_frames.size() ) + " frames" ) << " of " << d->m_filename );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+sample_frames_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  kv::frame_id_t target = 0;
+  bool found = false;
+
+  if( d->m_unbounded )
+  {
+    target = d->m_first_frame + static_cast< kv::frame_id_t >( d->m_next ) * d->m_frame_step;
+    found = ( d->m_max_frame_count == 0 || d->m_next < d->m_max_frame_count );
+  }
+  else if( d->m_next < d->m_frames.size() )
+  {
+    target = d->m_frames[ d->m_next ];
+    found = true;
+  }
+
+  kv::timestamp ts;
+  found = found && d->move_to( target, ts );
+
+  trace.inputs_ready();
+
+  if( !found )
+  {
+    d->m_reader->close();
+    mark_process_as_complete();
+
+    const sprokit::datum_t dat = sprokit::datum::complete_datum();
+
+    push_datum_to_port_using_trait( image, dat );
+    push_datum_to_port_using_trait( timestamp, dat );
+    push_datum_to_port_using_trait( file_name, dat );
+    return;
+  }
+
+  d->m_next++;
+
+  std::string file_name;
+
+  for( const auto& md : d->m_reader->frame_metadata() )
+  {
+    if( !md )
+    {
+      continue;
+    }
+
+    auto const& uri = md->find( kv::VITAL_META_IMAGE_URI );
+
+    if( uri.is_valid() )
+    {
+      file_name = uri.as_string();
+      break;
+    }
+  }
+
+  push_to_port_using_trait( image, d->m_reader->frame_image() );
+  push_to_port_using_trait( timestamp, ts );
+  push_to_port_using_trait( file_name, file_name );
+}
+
+} // end namespace core
+
+} // end namespace viame
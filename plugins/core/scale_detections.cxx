@@ -0,0 +1,104 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "scale_detections.h"
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+scale_detections
+::scale_detections()
+  : m_scale_factor( 2.0 )
+{}
+
+
+scale_detections
+::~scale_detections()
+{}
+
+
+// -----------------------------------------------------------------------------
+kwiver::vital::config_block_sptr
+scale_detections
+::get_configuration() const
+{
+  kwiver::vital::config_block_sptr config =
+    kwiver::vital::algorithm::get_configuration();
+
+  config->set_value( "scale_factor", m_scale_factor,
+    "Factor applied to all detection coordinates, e.g. the reduction used "
+    "by an ocv_reduced image reader." );
+
+  return config;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+scale_detections
+::set_configuration( kwiver::vital::config_block_sptr config )
+{
+  m_scale_factor = config->get_value< double >( "scale_factor" );
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+scale_detections
+::check_configuration( kwiver::vital::config_block_sptr config ) const
+{
+  return config->get_value< double >( "scale_factor", m_scale_factor ) > 0.0;
+}
+
+
+// -----------------------------------------------------------------------------
+kwiver::vital::detected_object_set_sptr
+scale_detections
+::refine( kwiver::vital::image_container_sptr image_data,
+  kwiver::vital::detected_object_set_sptr input_dets ) const
+{
+  if( !input_dets )
+  {
+    return std::make_shared< kwiver::vital::detected_object_set >();
+  }
+
+  // Detections may be shared with other consumers, so never scale in place
+  auto output = input_dets->clone();
+
+  if( m_scale_factor != 1.0 )
+  {
+    output->scale( m_scale_factor );
+  }
+
+  return output;
+}
+
+} // end namespace
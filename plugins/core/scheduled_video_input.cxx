@@ -0,0 +1,361 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "scheduled_video_input.h"
+#include "csv_checkpoint.h"
+#include "image_memory_budget.h"
+
+#include <vital/exceptions.h>
+#include <vital/logger/logger.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace viame
+{
+
+// ----------------------------------------------------------------------------
+scheduled_video_input::scheduled_video_input()
+  : target_frame_rate( 0.0 )
+  , min_seek_distance( 8 )
+  , has_last( false )
+  , last_frame( 0 )
+  , schedule_done( false )
+  , resume_frame( 0 )
+  , resume_pending( false )
+  , memory_budget( 0.0 )
+  , max_throttle_wait( 1.0 )
+{
+  attach_logger( "viame.core.scheduled_video_input" );
+}
+
+// ----------------------------------------------------------------------------
+kwiver::vital::config_block_sptr
+  scheduled_video_input::get_configuration() const
+{
+  auto config = kwiver::vital::algo::video_input::get_configuration();
+
+  config->set_value( "schedule_name", this->schedule_name,
+    "Name of the frame schedule published by a filter_frame_index process. "
+    "When empty or not yet published every frame is read." );
+
+  config->set_value( "target_frame_rate", this->target_frame_rate,
+    "When positive and no schedule_name is given, only read frames at about "
+    "this rate, stepping over the rest of the video. Should match the "
+    "target_frame_rate of a downstream downsampler." );
+
+  config->set_value( "min_seek_distance", this->min_seek_distance,
+    "Smallest gap to the next scheduled frame which is seeked over, shorter "
+    "gaps are read through since a seek decodes from the previous key frame." );
+
+  config->set_value( "resume_checkpoint", this->resume_checkpoint,
+    "Checkpoint file of a viame_csv writer run with resume enabled, usually "
+    "the output file name followed by .checkpoint. Frames up to the one it "
+    "records are skipped. Ignored when the file does not exist." );
+
+  get_image_memory_configuration( config,
+    this->memory_budget, this->max_throttle_wait );
+
+  kwiver::vital::algo::video_input::get_nested_algo_configuration(
+    "video_reader", config, this->video_reader );
+
+  return config;
+}
+
+// ----------------------------------------------------------------------------
+void scheduled_video_input::set_configuration(
+  kwiver::vital::config_block_sptr config )
+{
+  auto new_config = this->get_configuration();
+  new_config->merge_config( config );
+
+  this->schedule_name =
+    new_config->get_value< std::string >( "schedule_name" );
+  this->target_frame_rate =
+    new_config->get_value< double >( "target_frame_rate" );
+  this->min_seek_distance =
+    new_config->get_value< kwiver::vital::frame_id_t >( "min_seek_distance" );
+  this->resume_checkpoint =
+    new_config->get_value< std::string >( "resume_checkpoint" );
+
+  set_image_memory_configuration( new_config,
+    this->memory_budget, this->max_throttle_wait );
+
+  kwiver::vital::algo::video_input::set_nested_algo_configuration(
+    "video_reader", new_config, this->video_reader );
+}
+
+// ----------------------------------------------------------------------------
+bool scheduled_video_input::check_configuration(
+  kwiver::vital::config_block_sptr config ) const
+{
+  return kwiver::vital::algo::video_input::check_nested_algo_configuration(
+    "video_reader", config );
+}
+
+// ----------------------------------------------------------------------------
+void scheduled_video_input::open( std::string video_name )
+{
+  if( !this->video_reader )
+  {
+    VITAL_THROW( kwiver::vital::algorithm_configuration_exception,
+      type_name(), impl_name(), "No video_reader configured" );
+  }
+
+  this->video_reader->open( video_name );
+
+  this->has_last = false;
+  this->last_frame = 0;
+  this->schedule_done = false;
+
+  csv_checkpoint checkpoint;
+
+  this->resume_pending = !this->resume_checkpoint.empty() &&
+    read_csv_checkpoint( this->resume_checkpoint, checkpoint ) &&
+    checkpoint.frame > 0;
+  this->resume_frame = checkpoint.frame;
+
+  if( this->resume_pending )
+  {
+    LOG_INFO( logger(), "Skipping frames up to " << this->resume_frame
+                        << " completed by a previous run" );
+  }
+
+  auto const& caps = this->video_reader->get_implementation_capabilities();
+
+  for( auto const& cap : caps.capability_list() )
+  {
+    this->set_capability( cap, caps.capability( cap ) );
+  }
+}
+
+// ----------------------------------------------------------------------------
+void scheduled_video_input::close()
+{
+  if( this->video_reader )
+  {
+    this->video_reader->close();
+  }
+}
+
+// ----------------------------------------------------------------------------
+bool scheduled_video_input::end_of_video() const
+{
+  return this->schedule_done ||
+    !this->video_reader || this->video_reader->end_of_video();
+}
+
+// ----------------------------------------------------------------------------
+bool scheduled_video_input::good() const
+{
+  return !this->schedule_done &&
+    this->video_reader && this->video_reader->good();
+}
+
+// ----------------------------------------------------------------------------
+bool scheduled_video_input::seekable() const
+{
+  return this->video_reader && this->video_reader->seekable();
+}
+
+// ----------------------------------------------------------------------------
+size_t scheduled_video_input::num_frames() const
+{
+  return this->video_reader ? this->video_reader->num_frames() : 0;
+}
+
+// ----------------------------------------------------------------------------
+bool scheduled_video_input::next_frame(
+  kwiver::vital::timestamp& ts, uint32_t timeout )
+{
+  if( !this->video_reader || this->schedule_done )
+  {
+    return false;
+  }
+
+  image_memory_budget::instance().wait_below_limit(
+    std::chrono::milliseconds(
+      static_cast< long long >( this->max_throttle_wait * 1000.0 ) ) );
+
+  // The first frame after a checkpoint is always read, the schedule applies
+  // from there on
+  if( this->resume_pending )
+  {
+    this->resume_pending = false;
+
+    const kwiver::vital::frame_id_t target = this->resume_frame + 1;
+    bool success;
+
+    if( this->video_reader->seekable() )
+    {
+      success = this->video_reader->seek_frame( ts, target, timeout );
+    }
+    else
+    {
+      do
+      {
+        success = this->video_reader->next_frame( ts, timeout );
+      }
+      while( success && ts.get_frame() < target );
+    }
+
+    if( success )
+    {
+      this->has_last = true;
+      this->last_frame = ts.get_frame();
+    }
+
+    return success;
+  }
+
+  frame_schedule schedule;
+
+  if( !this->video_reader->seekable() || !this->current_schedule( schedule ) )
+  {
+    return this->video_reader->next_frame( ts, timeout );
+  }
+
+  // Frame numbers start at 1, the first read has no current frame yet
+  const kwiver::vital::timestamp current_ts =
+    this->video_reader->frame_timestamp();
+  const kwiver::vital::frame_id_t current =
+    current_ts.has_valid_frame() ? current_ts.get_frame() + 1 : 1;
+
+  kwiver::vital::frame_id_t target;
+
+  if( !schedule.next( current, this->has_last, this->last_frame, target ) )
+  {
+    this->schedule_done = true;
+    return false;
+  }
+
+  bool success;
+
+  if( target - current >= this->min_seek_distance )
+  {
+    success = this->video_reader->seek_frame( ts, target, timeout );
+  }
+  else
+  {
+    do
+    {
+      success = this->video_reader->next_frame( ts, timeout );
+    }
+    while( success && ts.get_frame() < target );
+  }
+
+  if( success )
+  {
+    this->has_last = true;
+    this->last_frame = ts.get_frame();
+  }
+
+  return success;
+}
+
+// ----------------------------------------------------------------------------
+bool scheduled_video_input::current_schedule( frame_schedule& schedule )
+{
+  if( !this->schedule_name.empty() )
+  {
+    return find_frame_schedule( this->schedule_name, schedule );
+  }
+
+  const double rate = this->video_reader->frame_rate();
+
+  if( this->target_frame_rate <= 0.0 || rate <= this->target_frame_rate )
+  {
+    return false;
+  }
+
+  schedule.min_frame = 1;
+  schedule.max_frame = std::numeric_limits< kwiver::vital::frame_id_t >::max();
+  // Rounded down so a downstream downsampler still receives every frame it
+  // would have passed
+  schedule.frame_step = std::max< kwiver::vital::frame_id_t >( 1,
+    static_cast< kwiver::vital::frame_id_t >(
+      std::floor( rate / this->target_frame_rate ) ) );
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+bool scheduled_video_input::seek_frame(
+  kwiver::vital::timestamp& ts,
+  kwiver::vital::frame_id_t frame_number,
+  uint32_t timeout )
+{
+  if( !this->video_reader )
+  {
+    return false;
+  }
+
+  // An explicit seek restarts the schedule from the requested frame
+  this->has_last = false;
+  this->schedule_done = false;
+  this->resume_pending = false;
+
+  return this->video_reader->seek_frame( ts, frame_number, timeout );
+}
+
+// ----------------------------------------------------------------------------
+kwiver::vital::timestamp scheduled_video_input::frame_timestamp() const
+{
+  return this->video_reader ?
+    this->video_reader->frame_timestamp() : kwiver::vital::timestamp();
+}
+
+// ----------------------------------------------------------------------------
+kwiver::vital::image_container_sptr scheduled_video_input::frame_image()
+{
+  return this->video_reader ? this->video_reader->frame_image() : nullptr;
+}
+
+// ----------------------------------------------------------------------------
+kwiver::vital::metadata_vector scheduled_video_input::frame_metadata()
+{
+  return this->video_reader ?
+    this->video_reader->frame_metadata() : kwiver::vital::metadata_vector();
+}
+
+// ----------------------------------------------------------------------------
+kwiver::vital::metadata_map_sptr scheduled_video_input::metadata_map()
+{
+  return this->video_reader ? this->video_reader->metadata_map() : nullptr;
+}
+
+// ----------------------------------------------------------------------------
+double scheduled_video_input::frame_rate()
+{
+  return this->video_reader ? this->video_reader->frame_rate() : -1.0;
+}
+
+} // end namespace viame
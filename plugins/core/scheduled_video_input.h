@@ -0,0 +1,119 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIAME_CORE_SCHEDULED_VIDEO_INPUT_H
+#define VIAME_CORE_SCHEDULED_VIDEO_INPUT_H
+
+#include <plugins/core/viame_core_export.h>
+#include <plugins/core/frame_schedule.h>
+
+#include <vital/algo/video_input.h>
+
+namespace viame
+{
+
+/**
+ * @brief Video reader which only decodes frames a downstream filter passes
+ *
+ * Wraps another video_input and, when it is seekable, seeks directly to the
+ * next frame of the schedule published by a filter_frame_index_process with
+ * the same schedule_name instead of decoding every frame in between. Without
+ * a schedule_name, target_frame_rate gives a fixed frame step instead, for
+ * reads which are downsampled afterwards.
+ *
+ * When resume_checkpoint names the checkpoint of a csv writer resuming its
+ * output, the frames it already completed are skipped.
+ */
+class VIAME_CORE_EXPORT scheduled_video_input
+  : public kwiver::vital::algo::video_input
+{
+public:
+  static constexpr char const* name = "scheduled";
+  static constexpr char const* description =
+    "Seek a nested video reader to the frames a frame index filter passes";
+
+  scheduled_video_input();
+  ~scheduled_video_input() override = default;
+
+  kwiver::vital::config_block_sptr get_configuration() const override;
+
+  void set_configuration( kwiver::vital::config_block_sptr config ) override;
+
+  bool check_configuration( kwiver::vital::config_block_sptr config ) const override;
+
+  void open( std::string video_name ) override;
+  void close() override;
+
+  bool end_of_video() const override;
+  bool good() const override;
+  bool seekable() const override;
+  size_t num_frames() const override;
+
+  bool next_frame( kwiver::vital::timestamp& ts,
+                   uint32_t timeout = 0 ) override;
+
+  bool seek_frame( kwiver::vital::timestamp& ts,
+                   kwiver::vital::frame_id_t frame_number,
+                   uint32_t timeout = 0 ) override;
+
+  kwiver::vital::timestamp frame_timestamp() const override;
+  kwiver::vital::image_container_sptr frame_image() override;
+  kwiver::vital::metadata_vector frame_metadata() override;
+  kwiver::vital::metadata_map_sptr metadata_map() override;
+  double frame_rate() override;
+
+private:
+  kwiver::vital::algo::video_input_sptr video_reader;
+
+  std::string schedule_name;
+  double target_frame_rate;
+  kwiver::vital::frame_id_t min_seek_distance;
+  std::string resume_checkpoint;
+
+  // Schedule to follow for the next read, false if every frame is read
+  bool current_schedule( frame_schedule& schedule );
+
+  // Frames passed so far, mirroring the filter's own state
+  bool has_last;
+  kwiver::vital::frame_id_t last_frame;
+  bool schedule_done;
+
+  // Last frame completed by a previous run, skipped on the first read
+  kwiver::vital::frame_id_t resume_frame;
+  bool resume_pending;
+
+  // Reading pauses while the shared image memory budget is exceeded
+  double memory_budget;
+  double max_throttle_wait;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_SCHEDULED_VIDEO_INPUT_H
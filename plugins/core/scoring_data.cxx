@@ -0,0 +1,257 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "scoring_data.h"
+#include "csv_file_parser.h"
+#include "thread_pool.h"
+
+#include <vital/exceptions.h>
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace viame
+{
+
+namespace
+{
+
+const std::size_t min_load_chunk_size = 4 << 20;
+
+enum
+{
+  COL_DET_ID=0,  // 0: Object ID
+  COL_SOURCE_ID, // 1
+  COL_FRAME_ID,  // 2
+  COL_MIN_X,     // 3
+  COL_MIN_Y,     // 4
+  COL_MAX_X,     // 5
+  COL_MAX_Y,     // 6
+  COL_CONFIDENCE,// 7
+  COL_LENGTH,    // 8
+  COL_TOT        // 9
+};
+
+// Row with its label still unresolved, labels are indexed serially
+struct parsed_row
+{
+  long long frame_id;
+  scoring_box box;
+  std::string label;
+};
+
+// -----------------------------------------------------------------------------
+std::vector< parsed_row >
+parse_rows( std::string_view data, scoring_load_options const& options )
+{
+  std::vector< parsed_row > output;
+  csv_line_parser parser( data, "," );
+
+  while( parser.next() )
+  {
+    const std::vector< std::string_view >& col = parser.fields();
+
+    if( col.size() < COL_TOT )
+    {
+      std::stringstream str;
+      str << "This is not a viame_csv file; found " << col.size()
+          << " columns in\n\"" << parser.line() << "\"";
+      throw kwiver::vital::invalid_data( str.str() );
+    }
+
+    double conf = csv_to_double( col[COL_CONFIDENCE] );
+
+    if( conf == -1.0 )
+    {
+      conf = 1.0;
+    }
+
+    bool has_class = false;
+    std::string top_label;
+    double top_score = 0.0;
+
+    for( unsigned i = COL_TOT; i + 1 < col.size(); i += 2 )
+    {
+      if( col[i].empty() || col[i][0] == '(' )
+      {
+        break;
+      }
+
+      std::string label( col[i] );
+
+      if( options.hierarchy )
+      {
+        if( !options.hierarchy->has_class_name( label ) )
+        {
+          continue;
+        }
+        label = options.hierarchy->get_class_name( label );
+      }
+
+      const double score = csv_to_double( col[i+1] );
+
+      if( !has_class || score > top_score )
+      {
+        has_class = true;
+        top_label = std::move( label );
+        top_score = score;
+      }
+    }
+
+    if( !has_class && !options.ignore_classes )
+    {
+      continue;
+    }
+
+    parsed_row row;
+
+    row.frame_id = csv_to_int( col[COL_FRAME_ID] );
+    row.box.track_id = csv_to_int( col[COL_DET_ID] );
+    row.box.min_x = csv_to_double( col[COL_MIN_X] );
+    row.box.min_y = csv_to_double( col[COL_MIN_Y] );
+    row.box.max_x = csv_to_double( col[COL_MAX_X] );
+    row.box.max_y = csv_to_double( col[COL_MAX_Y] );
+    row.box.label = -1;
+    row.box.score = ( options.aux_confidence || !has_class ) ? conf : top_score;
+    row.label = options.ignore_classes ? options.default_label : top_label;
+
+    output.push_back( std::move( row ) );
+  }
+
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+std::vector< parsed_row >
+read_rows( std::string const& filename, scoring_load_options const& options )
+{
+  std::ifstream stream( filename );
+
+  if( !stream )
+  {
+    VITAL_THROW( kwiver::vital::file_not_found_exception, filename,
+                 "Unable to open scoring input" );
+  }
+
+  csv_file_view file( filename, stream );
+
+  const auto chunks = csv_split_lines( file.data(),
+    options.num_threads == 0 ?
+      std::thread::hardware_concurrency() : options.num_threads,
+    min_load_chunk_size );
+
+  if( chunks.size() <= 1 )
+  {
+    return parse_rows( file.data(), options );
+  }
+
+  thread_pool workers( chunks.size() );
+  std::vector< std::future< std::vector< parsed_row > > > results;
+
+  for( auto const& chunk : chunks )
+  {
+    results.push_back( workers.enqueue(
+      [chunk, &options]{ return parse_rows( chunk, options ); } ) );
+  }
+
+  std::vector< parsed_row > output;
+
+  for( auto& result : results )
+  {
+    auto rows = result.get();
+    output.insert( output.end(),
+      std::make_move_iterator( rows.begin() ),
+      std::make_move_iterator( rows.end() ) );
+  }
+
+  return output;
+}
+
+} // end anonymous namespace
+
+
+// -----------------------------------------------------------------------------
+int
+scoring_labels
+::index( std::string const& name )
+{
+  auto it = m_indices.find( name );
+
+  if( it != m_indices.end() )
+  {
+    return it->second;
+  }
+
+  const int id = static_cast< int >( m_names.size() );
+  m_names.push_back( name );
+  m_indices.emplace( name, id );
+  return id;
+}
+
+
+// -----------------------------------------------------------------------------
+scoring_sequence
+load_scoring_sequence( std::string const& truth_file,
+                       std::string const& computed_file,
+                       scoring_load_options const& options,
+                       scoring_labels& labels )
+{
+  std::vector< parsed_row > truth = read_rows( truth_file, options );
+  std::vector< parsed_row > computed = read_rows( computed_file, options );
+
+  std::map< long long, scoring_frame > frames;
+
+  for( auto& row : truth )
+  {
+    row.box.label = labels.index( row.label );
+    frames[ row.frame_id ].truth.push_back( row.box );
+  }
+  for( auto& row : computed )
+  {
+    row.box.label = labels.index( row.label );
+    frames[ row.frame_id ].computed.push_back( row.box );
+  }
+
+  scoring_sequence output;
+  output.name = computed_file;
+  output.frames.reserve( frames.size() );
+
+  for( auto& frame : frames )
+  {
+    frame.second.frame_id = frame.first;
+    output.frames.push_back( std::move( frame.second ) );
+  }
+
+  return output;
+}
+
+} // end namespace
@@ -0,0 +1,142 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Truth and computed viame_csv contents aligned by frame for scoring
+ */
+
+#ifndef VIAME_CORE_SCORING_DATA_H
+#define VIAME_CORE_SCORING_DATA_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/types/category_hierarchy.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/// One detection reduced to what scoring needs: its box, track and top label
+struct scoring_box
+{
+  long long track_id;
+  double min_x, min_y, max_x, max_y;
+  int label;
+  double score;
+};
+
+/// Truth and computed detections sharing a frame identifier
+struct scoring_frame
+{
+  long long frame_id;
+  std::vector< scoring_box > truth;
+  std::vector< scoring_box > computed;
+};
+
+/// Aligned frames of a truth and computed file pair, sorted by frame
+struct scoring_sequence
+{
+  std::string name;
+  std::vector< scoring_frame > frames;
+};
+
+// -----------------------------------------------------------------------------
+/// Label names shared by every sequence of a scoring run
+class VIAME_CORE_EXPORT scoring_labels
+{
+public:
+  /// Index of name, added if not seen before
+  int index( std::string const& name );
+
+  std::vector< std::string > const& names() const { return m_names; }
+  size_t size() const { return m_names.size(); }
+
+private:
+  std::vector< std::string > m_names;
+  std::unordered_map< std::string, int > m_indices;
+};
+
+// -----------------------------------------------------------------------------
+/// How class columns of viame_csv rows are reduced to one label and score
+struct scoring_load_options
+{
+  /// Score every detection as default_label, regardless of its classes
+  bool ignore_classes = false;
+
+  /// Use the detection confidence column instead of the class score
+  bool aux_confidence = false;
+
+  /// Label used for ignore_classes
+  std::string default_label = "fish";
+
+  /// If set, classes not in the hierarchy are dropped and synonyms merged
+  kwiver::vital::category_hierarchy_sptr hierarchy;
+
+  /// Threads parsing each file, 0 for one per core
+  unsigned num_threads = 0;
+};
+
+// -----------------------------------------------------------------------------
+/// Read a truth and a computed viame_csv file and align them by frame id.
+/// Detections without any usable class are dropped unless ignore_classes.
+VIAME_CORE_EXPORT scoring_sequence
+load_scoring_sequence( std::string const& truth_file,
+                       std::string const& computed_file,
+                       scoring_load_options const& options,
+                       scoring_labels& labels );
+
+/// Intersection over union of two boxes
+inline double
+scoring_iou( scoring_box const& a, scoring_box const& b )
+{
+  const double iw = std::min( a.max_x, b.max_x ) - std::max( a.min_x, b.min_x );
+  const double ih = std::min( a.max_y, b.max_y ) - std::max( a.min_y, b.min_y );
+
+  if( iw <= 0.0 || ih <= 0.0 )
+  {
+    return 0.0;
+  }
+
+  const double inter = iw * ih;
+  const double uni = ( a.max_x - a.min_x ) * ( a.max_y - a.min_y ) +
+                     ( b.max_x - b.min_x ) * ( b.max_y - b.min_y ) - inter;
+
+  return uni > 0.0 ? inter / uni : 0.0;
+}
+
+} // end namespace
+
+#endif // VIAME_CORE_SCORING_DATA_H
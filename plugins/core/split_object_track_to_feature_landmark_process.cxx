@@ -4,6 +4,7 @@
  */
 
 #include "split_object_track_to_feature_landmark_process.h"
+#include "process_trace.h"
 
 #include <vital/vital_types.h>
 #include <vital/types/detected_object_set.h>
@@ -14,6 +15,9 @@
 #include <sprokit/processes/kwiver_type_traits.h>
 
 #include "notes_to_attributes.h"
+#include "csv_file_parser.h"
+
+#include <string_view>
 
 
 namespace kv = kwiver::vital;
@@ -39,24 +43,21 @@ public:
   // Other variables
   split_object_track_to_feature_landmark_process* parent;
   
-  std::pair<std::string, float>
-  get_attribut_value(const std::string& note)
+  // Name view and value of a formatted note, the name refers to the note
+  std::pair<std::string_view, float>
+  get_attribut_value(std::string_view note)
   {
     // read formated notes in detection "(trk) :name=value"
     std::size_t pos = note.find_first_of( ':' );
     std::size_t pos2 = note.find_first_of( '=' );
     
-    std::string attr_name = "";
-    float value = 0.;
-    if( pos == std::string::npos || pos2 == std::string::npos || pos2 == pos + 1 )
+    if( pos == std::string_view::npos || pos2 == std::string_view::npos || pos2 <= pos + 1 )
     {
-      return std::make_pair(attr_name, value);
+      return std::make_pair(std::string_view(), 0.f);
     }
     
-    attr_name = note.substr( pos+1, pos2-1 );
-    value = std::stof(note.substr( pos2 + 1 ));
-    
-    return std::make_pair(attr_name, value);
+    return std::make_pair(note.substr( pos + 1, pos2 - pos - 1 ),
+                          static_cast<float>(csv_to_double(note.substr( pos2 + 1 ))));
   }
 };
 
@@ -129,36 +130,61 @@ void
 split_object_track_to_feature_landmark_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
   kv::object_track_set_sptr object_track;
   kv::feature_track_set_sptr features;
   kv::landmark_map::map_landmark_t landmarks;
 
   object_track = grab_from_port_using_trait( object_track_set );
-  std::vector<kv::track_sptr> all_tracks = object_track->tracks();
+
+  trace.inputs_ready();
+
+  // The feature track set references the input tracks and their states
+  const std::vector<kv::track_sptr> all_tracks = object_track->tracks();
   features = std::make_shared<kv::feature_track_set>(all_tracks);
   
-  for (auto track : all_tracks )
+  for (const auto& track : all_tracks )
   {
-    for ( auto state : *track | kv::as_object_track )
+    // Only the last state with xyz values is kept for a track
+    bool has_point = false;
+    kv::vector_3d pt;
+
+    for ( const auto& state : *track | kv::as_object_track )
     {
-      if(!state->detection()->notes().size())
+      const auto& notes = state->detection()->notes();
+      if(notes.empty())
         break;
       
-      // get xyz attributes from detection notes
-      std::map<std::string, double> attrs;
-      for(auto note : state->detection()->notes())
+      // get xyz attributes from detection notes, the first note of a name wins
+      double xyz[3];
+      bool found[3] = { false, false, false };
+      for(const auto& note : notes)
       {
-        attrs.insert(d->get_attribut_value(note));
+        const auto attr = d->get_attribut_value(note);
+        if(attr.first.size() != 1)
+          continue;
+
+        const int axis = attr.first[0] - 'x';
+        if(axis >= 0 && axis < 3 && !found[axis])
+        {
+          xyz[axis] = attr.second;
+          found[axis] = true;
+        }
       }
       
       // Only keep image and world points for which xyz values has been found in notes
-      if(attrs.count("x") && attrs.count("y") && attrs.count("z"))
+      if(found[0] && found[1] && found[2])
       {
-        kv::vector_3d pt = kv::vector_3d(attrs["x"], attrs["y"], attrs["z"]);
-        kv::landmark_sptr landmark = kv::landmark_sptr(new kv::landmark_d( pt ));
-        landmarks[track->id()] = landmark;
+        pt = kv::vector_3d(xyz[0], xyz[1], xyz[2]);
+        has_point = true;
       }
     }
+
+    if(has_point)
+    {
+      landmarks[track->id()] = kv::landmark_sptr(new kv::landmark_d( pt ));
+    }
   }
   
   push_to_port_using_trait( feature_track_set, features );
@@ -0,0 +1,167 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Bounded lock-free queue between one producer and one consumer thread
+ */
+
+#ifndef VIAME_CORE_SPSC_RING_BUFFER_H
+#define VIAME_CORE_SPSC_RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Fixed-capacity ring buffer for a single producer and single consumer
+ *
+ * Elements are stored in a preallocated array, so pushing and popping never
+ * allocate, and the two threads only synchronize on the head and tail indices.
+ * push() and wait_push() may only be called by the producer; front(), back(),
+ * pop() and size() only by the consumer. Both roles may be the same thread.
+ * The capacity must be set with reset() before either thread starts.
+ */
+template< typename T >
+class spsc_ring_buffer
+{
+public:
+  explicit spsc_ring_buffer( size_t capacity = 64 )
+  {
+    reset( capacity );
+  }
+
+  spsc_ring_buffer( const spsc_ring_buffer& ) = delete;
+  spsc_ring_buffer& operator=( const spsc_ring_buffer& ) = delete;
+
+  /// Discard all elements and change the capacity, not thread safe
+  void reset( size_t capacity )
+  {
+    // One slot is kept free to tell a full buffer from an empty one
+    m_slots.clear();
+    m_slots.resize( std::max< size_t >( capacity, 1 ) + 1 );
+    m_head.store( 0, std::memory_order_relaxed );
+    m_tail.store( 0, std::memory_order_relaxed );
+  }
+
+  /// Maximum number of elements held at once
+  size_t capacity() const
+  {
+    return m_slots.size() - 1;
+  }
+
+  /// Add an element, returns false without moving it if the buffer is full
+  bool push( T&& value )
+  {
+    const size_t head = m_head.load( std::memory_order_relaxed );
+    const size_t next = increment( head );
+
+    if( next == m_tail.load( std::memory_order_acquire ) )
+    {
+      return false;
+    }
+
+    m_slots[ head ] = std::move( value );
+    m_head.store( next, std::memory_order_release );
+    return true;
+  }
+
+  /// Add an element, yielding while the consumer makes room for it
+  void wait_push( T&& value )
+  {
+    while( !push( std::move( value ) ) )
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  /// True if no element is available to the consumer
+  bool empty() const
+  {
+    return m_tail.load( std::memory_order_relaxed ) ==
+           m_head.load( std::memory_order_acquire );
+  }
+
+  /// Number of elements available to the consumer
+  size_t size() const
+  {
+    const size_t tail = m_tail.load( std::memory_order_relaxed );
+    const size_t head = m_head.load( std::memory_order_acquire );
+    return head >= tail ? head - tail : head + m_slots.size() - tail;
+  }
+
+  /// Oldest element, the buffer must not be empty
+  T& front()
+  {
+    return m_slots[ m_tail.load( std::memory_order_relaxed ) ];
+  }
+
+  /// Newest element, the buffer must not be empty
+  T& back()
+  {
+    const size_t head = m_head.load( std::memory_order_acquire );
+    return m_slots[ head == 0 ? m_slots.size() - 1 : head - 1 ];
+  }
+
+  /// Release the oldest element, the buffer must not be empty
+  void pop()
+  {
+    const size_t tail = m_tail.load( std::memory_order_relaxed );
+
+    // Drop the element now rather than when its slot is reused
+    m_slots[ tail ] = T();
+    m_tail.store( increment( tail ), std::memory_order_release );
+  }
+
+private:
+  size_t increment( size_t index ) const
+  {
+    return index + 1 == m_slots.size() ? 0 : index + 1;
+  }
+
+  std::vector< T > m_slots;
+
+  // Next slot to write, only modified by the producer
+  alignas( 64 ) std::atomic< size_t > m_head{ 0 };
+
+  // Next slot to read, only modified by the consumer
+  alignas( 64 ) std::atomic< size_t > m_tail{ 0 };
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_SPSC_RING_BUFFER_H
@@ -0,0 +1,173 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "svm_bank_refine.h"
+#include "svm_model_bank.h"
+
+#include <vital/types/detected_object_type.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace viame
+{
+
+namespace kv = kwiver::vital;
+
+// -----------------------------------------------------------------------------
+svm_bank_refine
+::svm_bank_refine()
+  : m_model_dir( "category_models" )
+  , m_score_threshold( 0.0 )
+  , m_num_threads( 0 )
+{}
+
+
+svm_bank_refine
+::~svm_bank_refine()
+{}
+
+
+// -----------------------------------------------------------------------------
+kv::config_block_sptr
+svm_bank_refine
+::get_configuration() const
+{
+  kv::config_block_sptr config = kv::algorithm::get_configuration();
+
+  config->set_value( "model_dir", m_model_dir,
+    "Directory of <class>.svm libsvm models, each scoring one class." );
+  config->set_value( "score_threshold", m_score_threshold,
+    "Class scores below this value are left out of detection types." );
+  config->set_value( "num_threads", m_num_threads,
+    "Threads scoring descriptor blocks, 0 uses all cores." );
+
+  return config;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+svm_bank_refine
+::set_configuration( kv::config_block_sptr config )
+{
+  m_model_dir = config->get_value< std::string >( "model_dir" );
+  m_score_threshold = config->get_value< double >( "score_threshold" );
+  m_num_threads = config->get_value< unsigned >( "num_threads" );
+
+  m_models.reset( new svm_model_bank( m_num_threads ) );
+  m_models->load_directory( m_model_dir );
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+svm_bank_refine
+::check_configuration( kv::config_block_sptr config ) const
+{
+  return !config->get_value< std::string >( "model_dir", m_model_dir ).empty();
+}
+
+
+// -----------------------------------------------------------------------------
+kv::detected_object_set_sptr
+svm_bank_refine
+::refine( kv::image_container_sptr image_data,
+  kv::detected_object_set_sptr input_dets ) const
+{
+  if( !input_dets )
+  {
+    return std::make_shared< kv::detected_object_set >();
+  }
+
+  auto output = input_dets->clone();
+
+  if( !m_models || m_models->num_classes() == 0 )
+  {
+    return output;
+  }
+
+  // Gather the descriptors of the frame into one block
+  const unsigned dimension = m_models->dimension();
+
+  std::vector< kv::detected_object_sptr > described;
+  std::vector< double > values;
+
+  for( auto det : *output )
+  {
+    auto descriptor = det->descriptor();
+
+    if( !descriptor )
+    {
+      continue;
+    }
+
+    const std::vector< double > desc_values = descriptor->as_double();
+    const size_t used = std::min< size_t >( desc_values.size(), dimension );
+
+    values.resize( ( described.size() + 1 ) * dimension, 0.0 );
+    std::copy( desc_values.begin(), desc_values.begin() + used,
+               values.end() - dimension );
+
+    described.push_back( det );
+  }
+
+  if( described.empty() )
+  {
+    return output;
+  }
+
+  const size_t classes = m_models->num_classes();
+  std::vector< float > scores( described.size() * classes );
+
+  m_models->score( values.data(), described.size(), dimension, dimension,
+                   scores.data() );
+
+  for( size_t i = 0; i < described.size(); ++i )
+  {
+    auto type = std::make_shared< kv::detected_object_type >();
+
+    for( size_t c = 0; c < classes; ++c )
+    {
+      const double score = scores[ i * classes + c ];
+
+      if( score >= m_score_threshold )
+      {
+        type->set_score( m_models->class_names()[ c ], score );
+      }
+    }
+
+    described[ i ]->set_type( type );
+  }
+
+  return output;
+}
+
+} // end namespace
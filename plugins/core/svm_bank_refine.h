@@ -0,0 +1,81 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIAME_SVM_BANK_REFINE_H
+#define VIAME_SVM_BANK_REFINE_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/algo/refine_detections.h>
+
+#include <memory>
+#include <string>
+
+namespace viame {
+
+class svm_model_bank;
+
+class VIAME_CORE_EXPORT svm_bank_refine :
+  public kwiver::vital::algo::refine_detections
+{
+public:
+  svm_bank_refine();
+  virtual ~svm_bank_refine();
+
+  static constexpr char const* name = "svm_bank";
+
+  static constexpr char const* description =
+    "Classify detection descriptors with a directory of per-class linear or "
+    "histogram intersection SVM models, scoring all classes of a frame's "
+    "detections in one batch.";
+
+  // Get the current configuration (parameters) for this refiner
+  virtual kwiver::vital::config_block_sptr get_configuration() const;
+
+  // Set configurations automatically parsed from input pipeline and config files
+  virtual void set_configuration( kwiver::vital::config_block_sptr config );
+  virtual bool check_configuration( kwiver::vital::config_block_sptr config ) const;
+
+  // Main refinement method
+  virtual kwiver::vital::detected_object_set_sptr refine(
+    kwiver::vital::image_container_sptr image_data,
+    kwiver::vital::detected_object_set_sptr input_dets ) const;
+
+private:
+  std::string m_model_dir;
+  double m_score_threshold;
+  unsigned m_num_threads;
+
+  std::unique_ptr< svm_model_bank > m_models;
+};
+
+} // end namespace
+
+#endif /* VIAME_SVM_BANK_REFINE_H */
@@ -0,0 +1,630 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Batched scoring of per-class binary SVM models
+ */
+
+#include "svm_model_bank.h"
+#include "descriptor_store.h"
+#include "thread_pool.h"
+
+#include <vital/exceptions.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <future>
+#include <sstream>
+
+namespace viame
+{
+
+namespace kv = kwiver::vital;
+
+namespace
+{
+
+// Descriptors are scored in tasks of this many rows
+size_t const score_block_size = 256;
+
+// Weight rows are padded to a multiple of the accumulator lane count
+unsigned const lane_count = 8;
+
+inline unsigned
+padded_size( unsigned dimension )
+{
+  return ( dimension + lane_count - 1 ) / lane_count * lane_count;
+}
+
+// Dot product written with independent lanes, so that it vectorizes without
+// relaxed floating point flags. Both rows are padded with zeros.
+inline float
+dot_padded( float const* a, float const* b, unsigned padded )
+{
+  float lanes[ lane_count ] = { 0.0f };
+
+  for( unsigned i = 0; i < padded; i += lane_count )
+  {
+    for( unsigned l = 0; l < lane_count; ++l )
+    {
+      lanes[ l ] += a[ i + l ] * b[ i + l ];
+    }
+  }
+
+  float sum = 0.0f;
+
+  for( unsigned l = 0; l < lane_count; ++l )
+  {
+    sum += lanes[ l ];
+  }
+
+  return sum;
+}
+
+// Probability of the first label, as computed by libsvm's sigmoid_predict
+inline float
+sigmoid_predict( float decision, float a, float b )
+{
+  const double fApB = static_cast< double >( decision ) * a + b;
+
+  if( fApB >= 0.0 )
+  {
+    return static_cast< float >( std::exp( -fApB ) / ( 1.0 + std::exp( -fApB ) ) );
+  }
+
+  return static_cast< float >( 1.0 / ( 1.0 + std::exp( fApB ) ) );
+}
+
+bool
+is_intersection_kernel( std::string kernel )
+{
+  std::transform( kernel.begin(), kernel.end(), kernel.begin(), ::tolower );
+
+  return kernel == "intersection" || kernel == "histogram_intersection" ||
+         kernel == "hik" || kernel == "hi";
+}
+
+} // end anonymous namespace
+
+// -----------------------------------------------------------------------------
+class svm_model_bank::priv
+{
+public:
+  explicit priv( unsigned num_threads )
+    : workers( num_threads )
+  {}
+
+  // Support vectors of one model, summed per dimension
+  struct intersection_table
+  {
+    // Entries of dimension d are [ offsets[ d ], offsets[ d + 1 ] )
+    std::vector< size_t > offsets;
+    std::vector< float > values;
+
+    // Per entry k of a dimension, the sum of coef * value of the entries
+    // before k and the sum of coefs from k onwards, one extra per dimension
+    std::vector< float > below;
+    std::vector< float > above;
+
+    // Sum of the coefs of support vectors with no value in a dimension
+    std::vector< float > missing;
+  };
+
+  struct model
+  {
+    bool linear = true;
+    float rho = 0.0f;
+    bool probability = false;
+    float prob_a = 0.0f;
+    float prob_b = 0.0f;
+
+    // The decision value is relative to the first label, negated when it is
+    // the negative one
+    bool negate = false;
+
+    std::vector< float > weights;
+    intersection_table table;
+  };
+
+  mutable thread_pool workers;
+
+  std::vector< std::string > names;
+  std::vector< model > models;
+  unsigned dimension = 0;
+
+  // Linear models, one padded row per model, zero for other kernels
+  std::vector< float > weight_matrix;
+  unsigned padded = 0;
+
+  model parse( std::string const& path ) const;
+  void build_matrix();
+
+  float intersection( model const& m, float const* row ) const;
+
+  // Score count padded rows into count rows of scores
+  void score_rows( float const* rows, size_t count, float* output ) const;
+
+  // Copy, pad and score descriptors on the workers
+  template< typename T >
+  void score( T const* descriptors, size_t count, size_t stride,
+              unsigned dimension, float* output ) const;
+};
+
+// -----------------------------------------------------------------------------
+svm_model_bank::priv::model
+svm_model_bank::priv
+::parse( std::string const& path ) const
+{
+  std::ifstream input( path );
+
+  if( !input )
+  {
+    VITAL_THROW( kv::file_not_read_exception, path, "Unable to open SVM model" );
+  }
+
+  model output;
+  std::string kernel;
+  std::vector< int > labels;
+  std::string line;
+
+  // Header lines up to the support vectors
+  while( std::getline( input, line ) && line != "SV" )
+  {
+    std::istringstream tokens( line );
+    std::string key;
+    tokens >> key;
+
+    if( key == "kernel_type" )
+    {
+      tokens >> kernel;
+    }
+    else if( key == "nr_class" )
+    {
+      int classes = 0;
+      tokens >> classes;
+
+      if( classes != 2 )
+      {
+        VITAL_THROW( kv::invalid_data, path + " is not a binary SVM model" );
+      }
+    }
+    else if( key == "rho" )
+    {
+      tokens >> output.rho;
+    }
+    else if( key == "label" )
+    {
+      int label;
+      while( tokens >> label )
+      {
+        labels.push_back( label );
+      }
+    }
+    else if( key == "probA" )
+    {
+      tokens >> output.prob_a;
+      output.probability = true;
+    }
+    else if( key == "probB" )
+    {
+      tokens >> output.prob_b;
+    }
+  }
+
+  if( kernel == "linear" )
+  {
+    output.linear = true;
+  }
+  else if( is_intersection_kernel( kernel ) )
+  {
+    output.linear = false;
+  }
+  else
+  {
+    VITAL_THROW( kv::invalid_data, path + " uses the " + kernel + " kernel, "
+      "only linear and histogram intersection models can be batched" );
+  }
+
+  // Scores are for label 1 when present, the first label otherwise
+  output.negate = ( labels.size() == 2 && labels[ 1 ] == 1 );
+
+  // Support vectors as coef index:value ..., indices starting at 1
+  std::vector< std::vector< std::pair< float, float > > > entries;
+  float coef_sum = 0.0f;
+
+  while( std::getline( input, line ) )
+  {
+    std::istringstream tokens( line );
+    float coef;
+
+    if( !( tokens >> coef ) )
+    {
+      continue;
+    }
+
+    coef_sum += coef;
+
+    std::string pair;
+
+    while( tokens >> pair )
+    {
+      const size_t colon = pair.find( ':' );
+      const long index = std::stol( pair.substr( 0, colon ) );
+      const float value = std::stof( pair.substr( colon + 1 ) );
+
+      if( index < 1 )
+      {
+        continue;
+      }
+
+      if( static_cast< size_t >( index ) > entries.size() )
+      {
+        entries.resize( index );
+      }
+
+      entries[ index - 1 ].emplace_back( value, coef );
+    }
+  }
+
+  const size_t dimension = entries.size();
+
+  if( output.linear )
+  {
+    output.weights.assign( dimension, 0.0f );
+
+    for( size_t i = 0; i < dimension; ++i )
+    {
+      for( auto const& entry : entries[ i ] )
+      {
+        output.weights[ i ] += entry.first * entry.second;
+      }
+    }
+    return output;
+  }
+
+  intersection_table& table = output.table;
+  table.offsets.push_back( 0 );
+
+  for( auto& dim_entries : entries )
+  {
+    std::sort( dim_entries.begin(), dim_entries.end() );
+
+    float below = 0.0f;
+    float present = 0.0f;
+
+    for( auto const& entry : dim_entries )
+    {
+      present += entry.second;
+    }
+
+    float above = present;
+
+    for( auto const& entry : dim_entries )
+    {
+      table.values.push_back( entry.first );
+      table.below.push_back( below );
+      table.above.push_back( above );
+
+      below += entry.first * entry.second;
+      above -= entry.second;
+    }
+
+    table.below.push_back( below );
+    table.above.push_back( 0.0f );
+    table.offsets.push_back( table.values.size() );
+    table.missing.push_back( coef_sum - present );
+  }
+
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+void
+svm_model_bank::priv
+::build_matrix()
+{
+  padded = padded_size( dimension );
+  weight_matrix.assign( models.size() * padded, 0.0f );
+
+  for( size_t c = 0; c < models.size(); ++c )
+  {
+    std::copy( models[ c ].weights.begin(), models[ c ].weights.end(),
+               weight_matrix.begin() + c * padded );
+  }
+}
+
+// -----------------------------------------------------------------------------
+float
+svm_model_bank::priv
+::intersection( model const& m, float const* row ) const
+{
+  intersection_table const& table = m.table;
+  const size_t dims = table.missing.size();
+  float sum = 0.0f;
+
+  for( size_t d = 0; d < dims; ++d )
+  {
+    const float x = row[ d ];
+    const size_t first = table.offsets[ d ];
+    const size_t last = table.offsets[ d + 1 ];
+
+    // Entries up to k are at most x and contribute their value, later ones x
+    const size_t k = std::upper_bound( table.values.begin() + first,
+      table.values.begin() + last, x ) - table.values.begin();
+
+    // Lookups are offset by one extra entry per preceding dimension
+    sum += table.below[ k + d ] + x * table.above[ k + d ];
+
+    if( x < 0.0f )
+    {
+      sum += x * table.missing[ d ];
+    }
+  }
+
+  return sum;
+}
+
+// -----------------------------------------------------------------------------
+void
+svm_model_bank::priv
+::score_rows( float const* rows, size_t count, float* output ) const
+{
+  const size_t classes = models.size();
+
+  for( size_t i = 0; i < count; ++i )
+  {
+    float const* row = rows + i * padded;
+    float* scores = output + i * classes;
+
+    for( size_t c = 0; c < classes; ++c )
+    {
+      model const& m = models[ c ];
+
+      float decision = ( m.linear ?
+        dot_padded( weight_matrix.data() + c * padded, row, padded ) :
+        intersection( m, row ) ) - m.rho;
+
+      if( m.probability )
+      {
+        const float first = sigmoid_predict( decision, m.prob_a, m.prob_b );
+        scores[ c ] = ( m.negate ? 1.0f - first : first );
+      }
+      else
+      {
+        decision = ( m.negate ? -decision : decision );
+        scores[ c ] = 1.0f / ( 1.0f + std::exp( -decision ) );
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+template< typename T >
+void
+svm_model_bank::priv
+::score( T const* descriptors, size_t count, size_t stride,
+         unsigned input_dimension, float* output ) const
+{
+  if( models.empty() )
+  {
+    return;
+  }
+
+  const unsigned used = std::min( input_dimension, dimension );
+  std::vector< std::future< void > > tasks;
+
+  for( size_t begin = 0; begin < count; begin += score_block_size )
+  {
+    const size_t end = std::min( count, begin + score_block_size );
+
+    tasks.push_back( workers.enqueue( [=]
+    {
+      std::vector< float > rows( ( end - begin ) * padded, 0.0f );
+
+      for( size_t i = begin; i < end; ++i )
+      {
+        std::copy( descriptors + i * stride, descriptors + i * stride + used,
+                   rows.begin() + ( i - begin ) * padded );
+      }
+
+      score_rows( rows.data(), end - begin, output + begin * models.size() );
+    } ) );
+  }
+
+  for( auto& task : tasks )
+  {
+    task.get();
+  }
+}
+
+// =============================================================================
+svm_model_bank
+::svm_model_bank( unsigned num_threads )
+  : d( new priv( num_threads ) )
+{
+}
+
+
+svm_model_bank
+::~svm_model_bank()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+svm_model_bank
+::load_directory( std::string const& directory )
+{
+  namespace bfs = boost::filesystem;
+
+  if( !bfs::is_directory( directory ) )
+  {
+    VITAL_THROW( kv::file_not_found_exception, directory,
+                 "SVM model directory not found" );
+  }
+
+  std::vector< bfs::path > files;
+
+  for( bfs::directory_iterator it( directory ), end; it != end; ++it )
+  {
+    if( it->path().extension() == ".svm" )
+    {
+      files.push_back( it->path() );
+    }
+  }
+
+  std::sort( files.begin(), files.end() );
+
+  for( auto const& file : files )
+  {
+    add_model( file.stem().string(), file.string() );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+svm_model_bank
+::add_model( std::string const& class_name, std::string const& path )
+{
+  priv::model m = d->parse( path );
+
+  const size_t model_dimension = ( m.linear ?
+    m.weights.size() : m.table.missing.size() );
+
+  d->dimension = std::max( d->dimension,
+    static_cast< unsigned >( model_dimension ) );
+
+  d->names.push_back( class_name );
+  d->models.push_back( std::move( m ) );
+  d->build_matrix();
+}
+
+
+// -----------------------------------------------------------------------------
+size_t
+svm_model_bank
+::num_classes() const
+{
+  return d->models.size();
+}
+
+
+std::vector< std::string > const&
+svm_model_bank
+::class_names() const
+{
+  return d->names;
+}
+
+
+unsigned
+svm_model_bank
+::dimension() const
+{
+  return d->dimension;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+svm_model_bank
+::score( float const* descriptors, size_t count, size_t stride,
+         unsigned dimension, float* output ) const
+{
+  d->score( descriptors, count, stride, dimension, output );
+}
+
+
+void
+svm_model_bank
+::score( double const* descriptors, size_t count, size_t stride,
+         unsigned dimension, float* output ) const
+{
+  d->score( descriptors, count, stride, dimension, output );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+svm_model_bank
+::score( descriptor_store const& store, block_callback const& fn,
+         size_t block_size ) const
+{
+  const size_t count = store.size();
+  const unsigned dimension = store.dimension();
+
+  block_size = std::max< size_t >( block_size, 1 );
+
+  std::vector< float > scores;
+  std::vector< float > rows;
+
+  for( size_t first = 0; first < count; first += block_size )
+  {
+    const size_t block_count = std::min( block_size, count - first );
+    scores.resize( block_count * d->models.size() );
+
+    // Float vectors are read in place as contiguous rows, apart from
+    // unflushed additions, while other encodings are decoded first
+    bool contiguous = ( store.encoding() == descriptor_store::FLOAT32 );
+
+    for( size_t i = 1; i < block_count && contiguous; ++i )
+    {
+      contiguous = ( store.vector( first + i, nullptr ) ==
+                     store.vector( first, nullptr ) + i * dimension );
+    }
+
+    if( contiguous )
+    {
+      d->score( store.vector( first, nullptr ), block_count, dimension,
+                dimension, scores.data() );
+    }
+    else
+    {
+      rows.resize( block_count * dimension );
+
+      for( size_t i = 0; i < block_count; ++i )
+      {
+        store.read( first + i, rows.data() + i * dimension );
+      }
+
+      d->score( rows.data(), block_count, dimension, dimension, scores.data() );
+    }
+
+    fn( first, block_count, scores.data() );
+  }
+}
+
+} // end namespace viame
@@ -0,0 +1,110 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Batched scoring of per-class binary SVM models
+ */
+
+#ifndef VIAME_CORE_SVM_MODEL_BANK_H
+#define VIAME_CORE_SVM_MODEL_BANK_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace viame
+{
+
+class descriptor_store;
+
+/**
+ * @brief One-vs-rest libsvm models scored together over descriptor blocks
+ *
+ * Linear models are collapsed into the rows of a single contiguous weight
+ * matrix, so scoring a block of descriptors is one matrix product instead of
+ * a kernel evaluation per support vector. Histogram intersection models are
+ * additive over dimensions and are reduced to sorted per-dimension tables,
+ * evaluated with one binary search per dimension. Other kernels can not be
+ * reduced and are rejected.
+ *
+ * Scores are probabilities of the positive label when the models were
+ * trained with probability estimates, or a logistic of the decision value.
+ */
+class VIAME_CORE_EXPORT svm_model_bank
+{
+public:
+  explicit svm_model_bank( unsigned num_threads = 0 );
+  ~svm_model_bank();
+
+  /// Add every <class>.svm file within directory, in name order
+  void load_directory( std::string const& directory );
+
+  /// Add the libsvm model file at path, scored as class_name
+  void add_model( std::string const& class_name, std::string const& path );
+
+  size_t num_classes() const;
+  std::vector< std::string > const& class_names() const;
+
+  /// Highest feature index used by any model
+  unsigned dimension() const;
+
+  /**
+   * @brief Score count descriptors, stride values apart
+   *
+   * Writes count rows of num_classes() scores to output. Values past the
+   * model dimension are ignored and missing ones taken as 0.
+   */
+  void score( float const* descriptors, size_t count, size_t stride,
+              unsigned dimension, float* output ) const;
+
+  /// Scores of count double precision descriptors
+  void score( double const* descriptors, size_t count, size_t stride,
+              unsigned dimension, float* output ) const;
+
+  typedef std::function< void( size_t first, size_t count,
+                               float const* scores ) > block_callback;
+
+  /// Score a whole store in one pass, handing each block of scores to fn
+  void score( descriptor_store const& store, block_callback const& fn,
+              size_t block_size = 65536 ) const;
+
+private:
+  class priv;
+  const std::unique_ptr< priv > d;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_SVM_MODEL_BANK_H
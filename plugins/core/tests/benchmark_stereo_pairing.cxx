@@ -0,0 +1,290 @@
+/// @file
+/// @brief Micro-benchmarks of the stereo pairing stages over synthetic scenes.
+///
+/// Usage : benchmark_stereo_pairing [--detections N] [--frames N] [--iterations N] [--masks] [--sparse]
+///
+/// For each stage, reports the mean and minimum latency per call and the mean number of heap allocations per call.
+
+#include <plugins/core/tracks_pairing_from_stereo.h>
+#include <plugins/core/detections_pairing_from_stereo.h>
+#include <vital/types/track.h>
+#include <vital/types/timestamp.h>
+#include <arrows/ocv/image_container.h>
+
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace kv = kwiver::vital;
+using namespace viame::core;
+
+// -----------------------------------------------------------------------------
+// Global allocation counter, incremented by every operator new of the benchmark process
+namespace {
+std::atomic<size_t> g_allocation_count{0};
+}
+
+void *operator new(std::size_t size) {
+  g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace {
+
+struct BenchmarkOptions {
+  int detections{50};
+  int frames{20};
+  int iterations{20};
+  bool masks{false};
+  bool sparse{false};
+};
+
+/// @brief Synthetic scene : one left / right track per object, visible in every frame
+struct Scene {
+  cv::Mat disparity;
+  std::vector<std::vector<kv::bounding_box_d>> left_bboxes; // [frame][object]
+  std::vector<std::vector<kv::bounding_box_d>> right_bboxes;
+};
+
+const cv::Size image_size{1280, 720};
+
+tracks_pairing_from_stereo create_pairing(const BenchmarkOptions &options) {
+  tracks_pairing_from_stereo pairing;
+  pairing.m_cameras_directory = std::string(TEST_DATA_DIR);
+  pairing.load_camera_calibration();
+  pairing.m_iou_pair_threshold = 0.05;
+  pairing.m_detection_split_threshold = 3;
+  pairing.m_do_split_detections = true;
+  pairing.m_sparse_reprojection = options.sparse;
+  return pairing;
+}
+
+detections_pairing_from_stereo create_detection_pairing(const BenchmarkOptions &options) {
+  detections_pairing_from_stereo pairing;
+  pairing.m_cameras_directory = std::string(TEST_DATA_DIR);
+  pairing.load_camera_calibration();
+  pairing.m_iou_pair_threshold = 0.05;
+  pairing.m_sparse_reprojection = options.sparse;
+  return pairing;
+}
+
+kv::detected_object_sptr create_detection(const kv::bounding_box_d &bbox, bool with_mask) {
+  auto detection = std::make_shared<kv::detected_object>(bbox, 1.0);
+  if (with_mask) {
+    // Elliptic mask covering the bounding box
+    cv::Mat mask = cv::Mat::zeros((int) bbox.height(), (int) bbox.width(), CV_8UC1);
+    cv::ellipse(mask, cv::Point(mask.cols / 2, mask.rows / 2), cv::Size(mask.cols / 2, mask.rows / 2), 0, 0, 360,
+                cv::Scalar(255), -1);
+    using ic = kwiver::arrows::ocv::image_container;
+    detection->set_mask(std::make_shared<kv::simple_image_container>(
+        ic::ocv_to_vital(mask, ic::ColorMode::OTHER_COLOR)));
+  }
+  return detection;
+}
+
+Scene create_scene(const BenchmarkOptions &options) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> size_dist(40, 120);
+  std::uniform_real_distribution<double> x_dist(300, image_size.width - 150);
+  std::uniform_real_distribution<double> y_dist(10, image_size.height - 150);
+  std::uniform_real_distribution<double> motion_dist(-3, 3);
+  std::normal_distribution<float> noise_dist(0.f, 1.f);
+
+  Scene scene;
+
+  // Uniform disparity with noise, roughly matching the test data depth
+  scene.disparity = cv::Mat(image_size, CV_32F);
+  for (int i_y = 0; i_y < image_size.height; i_y++) {
+    auto *row = scene.disparity.ptr<float>(i_y);
+    for (int i_x = 0; i_x < image_size.width; i_x++)
+      row[i_x] = 160.f + noise_dist(rng);
+  }
+
+  std::vector<kv::bounding_box_d> bboxes;
+  for (int i_det = 0; i_det < options.detections; i_det++) {
+    auto x = x_dist(rng), y = y_dist(rng), size = size_dist(rng);
+    bboxes.emplace_back(x, y, x + size, y + size);
+  }
+
+  // Right boxes are the left boxes projected with the disparity
+  auto pairing = create_detection_pairing(options);
+  for (int i_frame = 0; i_frame < options.frames; i_frame++) {
+    std::vector<kv::detected_object_sptr> detections;
+    for (auto &bbox: bboxes) {
+      const double dx = motion_dist(rng), dy = motion_dist(rng);
+      bbox = kv::bounding_box_d(bbox.min_x() + dx, bbox.min_y() + dy, bbox.max_x() + dx, bbox.max_y() + dy);
+      detections.push_back(create_detection(bbox, false));
+    }
+
+    std::vector<kv::bounding_box_d> right_bboxes;
+    for (const auto &position: pairing.update_left_detections_3d_positions(detections, scene.disparity))
+      right_bboxes.push_back(position.left_bbox_proj_to_right_image);
+
+    scene.left_bboxes.push_back(bboxes);
+    scene.right_bboxes.push_back(right_bboxes);
+  }
+
+  return scene;
+}
+
+std::vector<kv::track_sptr>
+create_tracks(const std::vector<std::vector<kv::bounding_box_d>> &bboxes, kv::track_id_t first_id, bool with_mask) {
+  std::vector<kv::track_sptr> tracks;
+  for (size_t i_obj = 0; i_obj < bboxes.front().size(); i_obj++) {
+    auto track = kv::track::create();
+    track->set_id(first_id + (kv::track_id_t) i_obj);
+    for (size_t i_frame = 0; i_frame < bboxes.size(); i_frame++) {
+      kv::timestamp ts{(kv::time_usec_t) i_frame, (kv::frame_id_t) i_frame};
+      auto state = std::make_shared<kv::object_track_state>(ts, create_detection(bboxes[i_frame][i_obj], with_mask));
+      state->set_frame((kv::frame_id_t) i_frame);
+      track->append(state);
+    }
+    tracks.push_back(track);
+  }
+  return tracks;
+}
+
+std::vector<kv::detected_object_sptr> create_detections(const std::vector<kv::bounding_box_d> &bboxes, bool with_mask) {
+  std::vector<kv::detected_object_sptr> detections;
+  for (const auto &bbox: bboxes)
+    detections.push_back(create_detection(bbox, with_mask));
+  return detections;
+}
+
+/// @brief Runs setup then the timed call for the given number of iterations, and prints the call statistics
+void run_benchmark(const std::string &name, int iterations, const std::function<void()> &setup,
+                   const std::function<void()> &call) {
+  double total_us{}, min_us{std::numeric_limits<double>::max()};
+  size_t total_allocations{};
+
+  for (int i_iter = 0; i_iter < iterations; i_iter++) {
+    setup();
+
+    const auto allocations_before = g_allocation_count.load();
+    const auto start = std::chrono::steady_clock::now();
+    call();
+    const auto end = std::chrono::steady_clock::now();
+    total_allocations += g_allocation_count.load() - allocations_before;
+
+    const double elapsed_us = std::chrono::duration<double, std::micro>(end - start).count();
+    total_us += elapsed_us;
+    min_us = std::min(min_us, elapsed_us);
+  }
+
+  std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << total_us / iterations << std::setw(14) << min_us << std::setw(16)
+            << (double) total_allocations / iterations << std::endl;
+}
+
+BenchmarkOptions parse_options(int argc, char **argv) {
+  BenchmarkOptions options;
+  for (int i_arg = 1; i_arg < argc; i_arg++) {
+    const std::string arg = argv[i_arg];
+    const auto next_int = [&] {
+      if (i_arg + 1 >= argc)
+        throw std::invalid_argument("Missing value for " + arg);
+      return std::max(1, std::atoi(argv[++i_arg]));
+    };
+
+    if (arg == "--detections")
+      options.detections = next_int();
+    else if (arg == "--frames")
+      options.frames = next_int();
+    else if (arg == "--iterations")
+      options.iterations = next_int();
+    else if (arg == "--masks")
+      options.masks = true;
+    else if (arg == "--sparse")
+      options.sparse = true;
+    else
+      throw std::invalid_argument("Unknown option " + arg);
+  }
+  return options;
+}
+
+} // namespace
+
+
+int main(int argc, char **argv) {
+  BenchmarkOptions options;
+  try {
+    options = parse_options(argc, argv);
+  } catch (const std::invalid_argument &e) {
+    std::cerr << e.what() << "\nUsage : " << argv[0]
+              << " [--detections N] [--frames N] [--iterations N] [--masks] [--sparse]" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Scene : " << options.detections << " detections, " << options.frames << " frames, masks "
+            << (options.masks ? "on" : "off") << ", sparse reprojection " << (options.sparse ? "on" : "off")
+            << ", " << options.iterations << " iterations\n\n";
+  std::cout << std::left << std::setw(40) << "Stage" << std::right << std::setw(14) << "mean (us)" << std::setw(14)
+            << "min (us)" << std::setw(16) << "allocs / call" << std::endl;
+
+  const auto scene = create_scene(options);
+  auto detection_pairing = create_detection_pairing(options);
+  const auto left_detections = create_detections(scene.left_bboxes.back(), options.masks);
+  const auto right_detections = create_detections(scene.right_bboxes.back(), options.masks);
+  const auto no_setup = [] {};
+
+  cv::Mat pos_3d_map;
+  run_benchmark("reproject_3d_depth_map", options.iterations, no_setup,
+                [&] { detection_pairing.reproject_3d_depth_map(scene.disparity, pos_3d_map); });
+
+  std::vector<Detections3DPositions> left_3d_pos;
+  run_benchmark("update_left_detections_3d_positions", options.iterations, no_setup, [&] {
+    left_3d_pos = detection_pairing.update_left_detections_3d_positions(left_detections, scene.disparity);
+  });
+
+  for (const auto &method: {"PAIRING_3D", "PAIRING_3D_ASSIGNMENT", "PAIRING_IOU"}) {
+    detection_pairing.m_pairing_method = method;
+    run_benchmark(std::string("pair_left_right_detections ") + method, options.iterations, no_setup, [&] {
+      detection_pairing.pair_left_right_detections(left_detections, left_3d_pos, right_detections);
+    });
+  }
+
+  // Accumulate the track pairings of every frame before splitting them
+  std::unique_ptr<tracks_pairing_from_stereo> tracks_pairing;
+  const auto setup_split = [&] {
+    tracks_pairing.reset(new tracks_pairing_from_stereo(create_pairing(options)));
+    const auto left_tracks = create_tracks(scene.left_bboxes, 0, options.masks);
+    const auto right_tracks = create_tracks(scene.right_bboxes, options.detections, options.masks);
+
+    for (int i_frame = 0; i_frame < options.frames; i_frame++) {
+      kv::timestamp ts{(kv::time_usec_t) i_frame, (kv::frame_id_t) i_frame};
+      auto [tracks, positions] = tracks_pairing->update_left_tracks_3d_position(left_tracks, scene.disparity, ts);
+      auto current_right_tracks = tracks_pairing->keep_right_tracks_in_current_frame(right_tracks, ts);
+      tracks_pairing->pair_left_right_tracks(tracks, positions, current_right_tracks, ts);
+    }
+  };
+
+  run_benchmark("split_paired_tracks_to_new_tracks", options.iterations, setup_split, [&] {
+    std::vector<kv::track_sptr> left_tracks, right_tracks;
+    tracks_pairing->split_paired_tracks_to_new_tracks(left_tracks, right_tracks);
+  });
+
+  return 0;
+}
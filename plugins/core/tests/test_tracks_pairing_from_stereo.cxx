@@ -482,3 +482,236 @@ TEST(TracksPairingFromStereoTest, undistorted_coordinates_are_consistent) {
     EXPECT_NEAR(undistorted[i_pt].y, exp_points[i_pt].y, tol_pix);
   }
 }
+
+
+TEST(TracksPairingFromStereoTest, sparse_reprojection_matches_full_frame_reprojection) {
+  auto pairing = create_detection_pairing();
+  auto cv_disparity_left = load_disparity_map();
+  auto cv_3d_pos_map = pairing.reproject_3d_depth_map(cv_disparity_left);
+
+  std::vector<kv::detected_object_sptr> detections;
+  for (const auto &info: left_tracks_detections())
+    detections.push_back(std::make_shared<kv::detected_object>(info.bbox, 1.0));
+
+  // Add a masked detection to exercise the mask path
+  kv::bounding_box_d mask_bbox{600, 300, 700, 400};
+  auto masked = std::make_shared<kv::detected_object>(mask_bbox, 1.0);
+  using ic = kwiver::arrows::ocv::image_container;
+  masked->set_mask(std::make_shared<kwiver::vital::simple_image_container>(
+      ic::ocv_to_vital(create_uniform_image(255, cv::Size(100, 100)), ic::ColorMode::OTHER_COLOR)));
+  detections.push_back(masked);
+
+  for (const auto &detection: detections) {
+    auto full = pairing.estimate_3d_position_from_detection(detection, cv_3d_pos_map, true, 1. / 3.);
+    auto sparse = pairing.estimate_3d_position_from_detection_disparity(detection, cv_disparity_left, true, 1. / 3.);
+
+    EXPECT_FLOAT_EQ(full.score, sparse.score);
+    EXPECT_NEAR(full.center3d.x, sparse.center3d.x, 1e-4);
+    EXPECT_NEAR(full.center3d.y, sparse.center3d.y, 1e-4);
+    EXPECT_NEAR(full.center3d.z, sparse.center3d.z, 1e-4);
+    ASSERT_BBOX_NEAR(full.rectified_left_bbox, sparse.rectified_left_bbox, 1e-6);
+    ASSERT_BBOX_NEAR(full.left_bbox_proj_to_right_image, sparse.left_bbox_proj_to_right_image, 1e-2);
+  }
+}
+
+TEST(TracksPairingFromStereoTest, assignment_pairing_resolves_right_detection_conflicts) {
+  // Both projected left centers fall in the first right box, only the first one falls in the second right box
+  const auto create_3d_pos = [](float x, float y) {
+    Detections3DPositions pos;
+    pos.center3d_proj_to_right_image = {x, y};
+    pos.score = 1.f;
+    return pos;
+  };
+
+  std::vector<kv::detected_object_sptr> left_detections{
+      std::make_shared<kv::detected_object>(kv::bounding_box_d{0, 0, 10, 10}),
+      std::make_shared<kv::detected_object>(kv::bounding_box_d{0, 0, 10, 10})};
+  std::vector<Detections3DPositions> left_3d_pos{create_3d_pos(60, 50), create_3d_pos(30, 50)};
+  std::vector<kv::detected_object_sptr> right_detections{
+      std::make_shared<kv::detected_object>(kv::bounding_box_d{0, 0, 100, 100}),
+      std::make_shared<kv::detected_object>(kv::bounding_box_d{40, 0, 200, 100})};
+
+  // Greedy pairing gives the first right box to the first left detection and leaves the second one unpaired
+  auto greedy = detections_pairing_from_stereo::pair_left_right_detections_using_3d_center(
+      left_detections, left_3d_pos, right_detections, false);
+  ASSERT_EQ(greedy, (std::vector<std::pair<size_t, size_t>>{{0, 0}}));
+
+  // Optimal assignment pairs every left detection
+  auto optimal = detections_pairing_from_stereo::pair_left_right_detections_using_3d_center(
+      left_detections, left_3d_pos, right_detections, true);
+  ASSERT_EQ(optimal, (std::vector<std::pair<size_t, size_t>>{{0, 1}, {1, 0}}));
+}
+
+TEST(TracksPairingFromStereoTest, detection_span_views_set_in_place) {
+  auto create_3d_pos = [](float x, float y) {
+    Detections3DPositions pos;
+    pos.center3d_proj_to_right_image = {x, y};
+    pos.score = 1.f;
+    return pos;
+  };
+
+  kv::detected_object_set left_set, right_set;
+  left_set.add(std::make_shared<kv::detected_object>(kv::bounding_box_d{0, 0, 10, 10}));
+  left_set.add(std::make_shared<kv::detected_object>(kv::bounding_box_d{0, 0, 10, 10}));
+  right_set.add(std::make_shared<kv::detected_object>(kv::bounding_box_d{0, 0, 100, 100}));
+  right_set.add(std::make_shared<kv::detected_object>(kv::bounding_box_d{40, 0, 200, 100}));
+  std::vector<Detections3DPositions> left_3d_pos{create_3d_pos(60, 50), create_3d_pos(30, 50)};
+
+  std::vector<DetectionSpan::element_ptr> left_buffer, right_buffer;
+  const auto left_span = DetectionSpan::of(left_set, left_buffer);
+  const auto right_span = DetectionSpan::of(right_set, right_buffer);
+  ASSERT_EQ(left_span.size(), 2u);
+  ASSERT_EQ(left_span[0].use_count(), 1);
+
+  auto pairings = detections_pairing_from_stereo::pair_left_right_detections_using_3d_center(
+      left_span, left_3d_pos, right_span, true);
+  ASSERT_EQ(pairings, (std::vector<std::pair<size_t, size_t>>{{0, 1}, {1, 0}}));
+}
+
+TEST(TracksPairingFromStereoTest, iou_matrix_matches_iou_distance) {
+  std::vector<kv::bounding_box_d> bboxes1{{0, 0, 100, 100}, {50, 50, 150, 120}, {200, 10, 260, 40}, {}};
+  std::vector<kv::bounding_box_d> bboxes2{{10, 10, 90, 90}, {100, 0, 200, 100}, {0, 0, 100, 100},
+                                          {210, 0, 250, 50}, {500, 500, 600, 600}, {}};
+
+  std::vector<double> ious;
+  detections_pairing_from_stereo::iou_matrix(BoundingBoxes{bboxes1}, BoundingBoxes{bboxes2}, ious);
+  ASSERT_EQ(ious.size(), bboxes1.size() * bboxes2.size());
+
+  for (size_t i = 0; i < bboxes1.size(); i++) {
+    for (size_t j = 0; j < bboxes2.size(); j++) {
+      ASSERT_NEAR(ious[i * bboxes2.size() + j], detections_pairing_from_stereo::iou_distance(bboxes1[i], bboxes2[j]),
+                  1e-9) << "at (" << i << ", " << j << ")";
+    }
+  }
+}
+
+TEST(TracksPairingFromStereoTest, frame_intervals_merge_consecutive_frames) {
+  FrameIntervals frames{1, 2, 3, 8, 5, 4};
+  ASSERT_EQ(frames.size(), 6);
+  ASSERT_EQ(frames.intervals(), (std::vector<FrameIntervals::Interval>{{1, 5}, {8, 8}}));
+  ASSERT_TRUE(frames.contains(4));
+  ASSERT_FALSE(frames.contains(6));
+  ASSERT_EQ(frames.first(), 1);
+  ASSERT_EQ(frames.last(), 8);
+
+  frames.emplace(7);
+  frames.emplace(6);
+  ASSERT_EQ(frames.size(), 8);
+  ASSERT_EQ(frames.intervals(), (std::vector<FrameIntervals::Interval>{{1, 8}}));
+}
+
+TEST(TracksPairingFromStereoTest, inactive_tracks_are_finalized_with_their_pairs) {
+  auto pairing = create_pairing();
+  pairing.m_inactivity_frames_threshold = 3;
+
+  kv::bounding_box_d a_bbox{0, 0, 1, 1};
+  std::vector<DetectionInfo> left_infos, right_infos;
+  for (int i_frame = 1; i_frame <= 10; i_frame++) {
+    if (i_frame <= 2) {
+      left_infos.push_back({1, i_frame, a_bbox});
+      right_infos.push_back({3, i_frame, a_bbox});
+    }
+    left_infos.push_back({2, i_frame, a_bbox});
+    right_infos.push_back({4, i_frame, a_bbox});
+  }
+
+  for (const auto &track: create_test_tracks(left_infos))
+    pairing.m_tracks_with_3d_left[track->id()] = track;
+  for (const auto &track: create_test_tracks(right_infos))
+    pairing.m_right_tracks_memo[track->id()] = track;
+
+  pairing.m_left_to_right_pairing[tracks_pairing_from_stereo::cantor_pairing(1, 3)] = Pairing{{1, 2}, {1, 3}};
+  pairing.m_left_to_right_pairing[tracks_pairing_from_stereo::cantor_pairing(2, 4)] = Pairing{{1, 2, 3, 4, 5, 6},
+                                                                                              {2, 4}};
+
+  // Only the first pair is inactive at frame 6
+  auto [left_tracks, right_tracks] = pairing.finalize_inactive_tracks(create_timestamp(6));
+  ASSERT_EQ(left_tracks.size(), 1);
+  ASSERT_EQ(right_tracks.size(), 1);
+  ASSERT_EQ(left_tracks[0]->id(), right_tracks[0]->id());
+  ASSERT_GT(left_tracks[0]->id(), 4);
+  ASSERT_EQ(pairing.m_tracks_with_3d_left.size(), 1);
+  ASSERT_EQ(pairing.m_right_tracks_memo.size(), 1);
+  ASSERT_EQ(pairing.m_left_to_right_pairing.size(), 1);
+
+  // Remaining pair is returned at the end of the stream with a new unique id
+  auto [last_left_tracks, last_right_tracks] = pairing.get_left_right_tracks_with_pairing();
+  ASSERT_EQ(last_left_tracks.size(), 1);
+  ASSERT_EQ(last_right_tracks.size(), 1);
+  ASSERT_GT(last_left_tracks[0]->id(), left_tracks[0]->id());
+}
+
+TEST(TracksPairingFromStereoTest, parallel_3d_position_update_matches_serial_update) {
+  auto cv_disparity_left = load_disparity_map();
+
+  const auto update_positions = [&](size_t worker_count) {
+    auto [tracks_left, tracks_right, timestamp] = create_test_tracks();
+    auto pairing = create_pairing();
+    pairing.m_worker_count = worker_count;
+    return std::get<1>(pairing.update_left_tracks_3d_position(tracks_left, cv_disparity_left, timestamp));
+  };
+
+  auto serial = update_positions(1);
+  auto parallel = update_positions(4);
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (size_t i = 0; i < serial.size(); i++) {
+    ASSERT_EQ(serial[i].score, parallel[i].score);
+    ASSERT_EQ(serial[i].center3d, parallel[i].center3d);
+    ASSERT_EQ(serial[i].rectified_left_bbox, parallel[i].rectified_left_bbox);
+  }
+}
+
+TEST(TracksPairingFromStereoTest, fixed_point_disparity_reprojection_matches_float_disparity) {
+  auto pairing = create_detection_pairing();
+  cv::Mat disparity_float, disparity_fixed;
+  load_disparity_map().convertTo(disparity_float, CV_32F, 1. / 4.);
+  disparity_float.convertTo(disparity_fixed, CV_16S, pairing.m_fixed_point_disparity_scale);
+
+  auto float_3d_map = pairing.reproject_3d_depth_map(disparity_float);
+  auto fixed_3d_map = pairing.reproject_3d_depth_map(disparity_fixed);
+  ASSERT_EQ(fixed_3d_map.type(), CV_32FC3);
+
+  for (const auto &pt: {cv::Point{100, 100}, cv::Point{640, 360}, cv::Point{1200, 700}}) {
+    const auto expected = float_3d_map.at<cv::Vec3f>(pt);
+    const auto actual = fixed_3d_map.at<cv::Vec3f>(pt);
+    for (int i = 0; i < 3; i++)
+      EXPECT_NEAR(expected[i], actual[i], 1e-3 * std::max(1.f, std::abs(expected[i])));
+  }
+
+  std::vector<kv::detected_object_sptr> detections;
+  for (const auto &info: left_tracks_detections())
+    detections.push_back(std::make_shared<kv::detected_object>(info.bbox, 1.0));
+
+  for (const auto &detection: detections) {
+    auto expected = pairing.estimate_3d_position_from_detection_disparity(detection, disparity_float, true, 1. / 3.);
+    auto actual = pairing.estimate_3d_position_from_detection_disparity(detection, disparity_fixed, true, 1. / 3.);
+    EXPECT_NEAR(expected.center3d.z, actual.center3d.z, 1e-3 * std::max(1.f, std::abs(expected.center3d.z)));
+  }
+}
+
+TEST(TracksPairingFromStereoTest, undistortion_lut_matches_point_undistortion) {
+  auto pairing = create_detection_pairing();
+  const cv::Size image_size{1280, 720};
+  auto mask = create_uniform_image(255, cv::Size(40, 30));
+
+  // Integer, sub pixel and partially out of image mask placements
+  for (const auto &bbox: {kv::bounding_box_d{600, 300, 640, 330}, kv::bounding_box_d{100.25, 200.5, 140.25, 230.5},
+                          kv::bounding_box_d{1260.5, 700, 1300.5, 730}}) {
+    std::vector<cv::Point2d> expected, actual;
+    pairing.m_use_undistortion_lut = false;
+    pairing.mask_to_rectified_coordinates(bbox, mask, true, image_size, expected);
+    pairing.m_use_undistortion_lut = true;
+    pairing.mask_to_rectified_coordinates(bbox, mask, true, image_size, actual);
+
+    ASSERT_EQ(expected.size(), actual.size());
+    auto by_coordinates = [](const cv::Point2d &a, const cv::Point2d &b) {
+      return a.y < b.y - 1e-3 || (std::abs(a.y - b.y) <= 1e-3 && a.x < b.x);
+    };
+    std::sort(expected.begin(), expected.end(), by_coordinates);
+    std::sort(actual.begin(), actual.end(), by_coordinates);
+    for (size_t i = 0; i < expected.size(); i++) {
+      EXPECT_NEAR(expected[i].x, actual[i].x, 1e-2);
+      EXPECT_NEAR(expected[i].y, actual[i].y, 1e-2);
+    }
+  }
+}
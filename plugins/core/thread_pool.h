@@ -0,0 +1,159 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Small fixed-size worker pool owned by individual algorithms
+ */
+
+#ifndef VIAME_CORE_THREAD_POOL_H
+#define VIAME_CORE_THREAD_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Fixed-size pool of worker threads
+ *
+ * Unlike the global vital thread pool, each instance is owned by the algorithm
+ * or process using it, which bounds the number of threads that component can
+ * occupy. Tasks are run in submission order, and destruction waits for all
+ * queued tasks to finish.
+ */
+class thread_pool
+{
+public:
+  /// Create a pool, using the hardware concurrency if num_threads is zero
+  explicit thread_pool( size_t num_threads = 0 )
+  {
+    if( num_threads == 0 )
+    {
+      num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+
+    for( size_t i = 0; i < num_threads; ++i )
+    {
+      m_workers.emplace_back( [this]{ this->worker_loop(); } );
+    }
+  }
+
+  ~thread_pool()
+  {
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_stopping = true;
+    }
+
+    m_condition.notify_all();
+
+    for( auto& worker : m_workers )
+    {
+      worker.join();
+    }
+  }
+
+  thread_pool( const thread_pool& ) = delete;
+  thread_pool& operator=( const thread_pool& ) = delete;
+
+  /// Number of worker threads in the pool
+  size_t size() const
+  {
+    return m_workers.size();
+  }
+
+  /// Queue a task, returning a future holding its result or exception
+  template< typename F >
+  std::future< typename std::result_of< F() >::type >
+  enqueue( F&& task )
+  {
+    typedef typename std::result_of< F() >::type result_t;
+
+    auto packaged = std::make_shared< std::packaged_task< result_t() > >(
+      std::forward< F >( task ) );
+
+    std::future< result_t > result = packaged->get_future();
+
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      m_tasks.emplace( [packaged]{ ( *packaged )(); } );
+    }
+
+    m_condition.notify_one();
+    return result;
+  }
+
+private:
+  void worker_loop()
+  {
+    while( true )
+    {
+      std::function< void() > task;
+
+      {
+        std::unique_lock< std::mutex > lock( m_mutex );
+
+        m_condition.wait( lock,
+          [this]{ return m_stopping || !m_tasks.empty(); } );
+
+        if( m_tasks.empty() )
+        {
+          return;
+        }
+
+        task = std::move( m_tasks.front() );
+        m_tasks.pop();
+      }
+
+      task();
+    }
+  }
+
+  std::vector< std::thread > m_workers;
+  std::queue< std::function< void() > > m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stopping = false;
+};
+
+} // end namespace viame
+
+#endif // VIAME_CORE_THREAD_POOL_H
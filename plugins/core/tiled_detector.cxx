@@ -0,0 +1,397 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "tiled_detector.h"
+
+#include <plugins/core/batch_image_object_detector.h>
+#include <plugins/core/image_tiling.h>
+#include <plugins/core/thread_pool.h>
+
+#include <vital/exceptions.h>
+#include <vital/types/image_container.h>
+
+#include <algorithm>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+// =============================================================================
+class tiled_detector::priv
+{
+public:
+  priv()
+    : tile_width( 1024 )
+    , tile_height( 1024 )
+    , tile_overlap( 128 )
+    , num_threads( 1 )
+    , batch_tiles( true )
+    , nms_threshold( 0.5 )
+  {}
+
+  // Run one detector over a run of tiles
+  std::vector< kv::detected_object_set_sptr >
+  detect_tiles( kv::algo::image_object_detector const& detector,
+                std::vector< kv::image_container_sptr > const& tiles ) const;
+
+  // Merge tile detections already in image coordinates
+  kv::detected_object_set_sptr
+  merge( std::vector< kv::detected_object_set_sptr > const& tile_dets ) const;
+
+  unsigned tile_width;
+  unsigned tile_height;
+  unsigned tile_overlap;
+  unsigned num_threads;
+  bool batch_tiles;
+  double nms_threshold;
+
+  // One detector instance per worker, since detect() is not thread safe
+  std::vector< kv::algo::image_object_detector_sptr > detectors;
+  std::unique_ptr< thread_pool > workers;
+};
+
+// -----------------------------------------------------------------------------
+std::vector< kv::detected_object_set_sptr >
+tiled_detector::priv
+::detect_tiles( kv::algo::image_object_detector const& detector,
+                std::vector< kv::image_container_sptr > const& tiles ) const
+{
+  if( batch_tiles )
+  {
+    return detect_in_batches( detector, tiles );
+  }
+
+  std::vector< kv::detected_object_set_sptr > output;
+
+  for( auto const& tile : tiles )
+  {
+    output.push_back( detector.detect( tile ) );
+  }
+
+  return output;
+}
+
+// -----------------------------------------------------------------------------
+kv::detected_object_set_sptr
+tiled_detector::priv
+::merge( std::vector< kv::detected_object_set_sptr > const& tile_dets ) const
+{
+  struct candidate
+  {
+    kv::detected_object_sptr det;
+    std::string label;
+    size_t tile;
+  };
+
+  std::vector< candidate > candidates;
+
+  for( size_t t = 0; t < tile_dets.size(); ++t )
+  {
+    if( !tile_dets[t] )
+    {
+      continue;
+    }
+
+    for( auto det : *tile_dets[t] )
+    {
+      std::string label;
+      double score;
+
+      if( det->type() )
+      {
+        det->type()->get_most_likely( label, score );
+      }
+
+      candidates.push_back( { det, label, t } );
+    }
+  }
+
+  std::stable_sort( candidates.begin(), candidates.end(),
+    []( candidate const& a, candidate const& b )
+    {
+      return a.det->confidence() > b.det->confidence();
+    } );
+
+  auto output = std::make_shared< kv::detected_object_set >();
+  std::vector< candidate const* > kept;
+
+  for( auto const& cand : candidates )
+  {
+    const auto& box = cand.det->bounding_box();
+    bool suppressed = false;
+
+    // Only detections from different tiles are duplicates, the nested
+    // detector is trusted to have already resolved overlaps within a tile
+    for( auto other : kept )
+    {
+      if( other->tile == cand.tile || other->label != cand.label )
+      {
+        continue;
+      }
+
+      const auto& other_box = other->det->bounding_box();
+      const auto inter = kv::intersection( box, other_box );
+
+      if( !inter.is_valid() )
+      {
+        continue;
+      }
+
+      // Over the smaller box, as a tile often only holds part of an object
+      const double smaller = std::min( box.area(), other_box.area() );
+
+      if( smaller > 0.0 && inter.area() / smaller > nms_threshold )
+      {
+        suppressed = true;
+        break;
+      }
+    }
+
+    if( !suppressed )
+    {
+      kept.push_back( &cand );
+      output->add( cand.det );
+    }
+  }
+
+  return output;
+}
+
+// =============================================================================
+tiled_detector
+::tiled_detector()
+  : d( new priv() )
+{
+}
+
+
+tiled_detector
+::~tiled_detector()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+kv::config_block_sptr
+tiled_detector
+::get_configuration() const
+{
+  auto config = kv::algo::image_object_detector::get_configuration();
+
+  config->set_value( "tile_width", d->tile_width,
+    "Width of each tile in pixels, images no larger than one tile are passed "
+    "to the nested detector as is." );
+  config->set_value( "tile_height", d->tile_height,
+    "Height of each tile in pixels." );
+  config->set_value( "tile_overlap", d->tile_overlap,
+    "Overlap between adjacent tiles in pixels, which should be at least the "
+    "size of the largest expected object." );
+  config->set_value( "num_threads", d->num_threads,
+    "Number of nested detector instances run on tiles in parallel, 0 uses "
+    "one per hardware thread. Each instance holds its own model." );
+  config->set_value( "batch_tiles", d->batch_tiles,
+    "Pass tiles to nested detectors supporting batched detection several "
+    "at a time instead of one by one." );
+  config->set_value( "nms_threshold", d->nms_threshold,
+    "Detections of the same class from different tiles are merged, keeping "
+    "the most confident, when their intersection covers more than this "
+    "fraction of the smaller box. Values of 1 or above disable merging." );
+
+  kv::algo::image_object_detector::get_nested_algo_configuration(
+    "detector", config, d->detectors.empty() ? nullptr : d->detectors[0] );
+
+  return config;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+tiled_detector
+::set_configuration( kv::config_block_sptr config )
+{
+  auto new_config = this->get_configuration();
+  new_config->merge_config( config );
+
+  d->tile_width = new_config->get_value< unsigned >( "tile_width" );
+  d->tile_height = new_config->get_value< unsigned >( "tile_height" );
+  d->tile_overlap = new_config->get_value< unsigned >( "tile_overlap" );
+  d->num_threads = new_config->get_value< unsigned >( "num_threads" );
+  d->batch_tiles = new_config->get_value< bool >( "batch_tiles" );
+  d->nms_threshold = new_config->get_value< double >( "nms_threshold" );
+
+  if( d->num_threads == 0 )
+  {
+    d->num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+  }
+
+  d->detectors.resize( d->num_threads );
+
+  for( auto& detector : d->detectors )
+  {
+    kv::algo::image_object_detector::set_nested_algo_configuration(
+      "detector", new_config, detector );
+  }
+
+  d->workers.reset();
+
+  if( d->num_threads > 1 )
+  {
+    d->workers.reset( new thread_pool( d->num_threads ) );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+tiled_detector
+::check_configuration( kv::config_block_sptr config ) const
+{
+  auto new_config = this->get_configuration();
+  new_config->merge_config( config );
+
+  if( new_config->get_value< unsigned >( "tile_overlap" ) >=
+        new_config->get_value< unsigned >( "tile_width" ) ||
+      new_config->get_value< unsigned >( "tile_overlap" ) >=
+        new_config->get_value< unsigned >( "tile_height" ) )
+  {
+    return false;
+  }
+
+  return kv::algo::image_object_detector::check_nested_algo_configuration(
+    "detector", new_config );
+}
+
+
+// -----------------------------------------------------------------------------
+kv::detected_object_set_sptr
+tiled_detector
+::detect( kv::image_container_sptr image_data ) const
+{
+  if( d->detectors.empty() || !d->detectors[0] )
+  {
+    VITAL_THROW( kv::algorithm_configuration_exception,
+      type_name(), impl_name(), "No nested detector configured" );
+  }
+
+  if( !image_data )
+  {
+    return std::make_shared< kv::detected_object_set >();
+  }
+
+  const unsigned width = image_data->width();
+  const unsigned height = image_data->height();
+
+  const auto x_origins = tile_origins( width, d->tile_width, d->tile_overlap );
+  const auto y_origins = tile_origins( height, d->tile_height, d->tile_overlap );
+
+  if( x_origins.size() == 1 && y_origins.size() == 1 )
+  {
+    return d->detectors[0]->detect( image_data );
+  }
+
+  const unsigned tw = std::min( d->tile_width, width );
+  const unsigned th = std::min( d->tile_height, height );
+
+  const kv::image full = image_data->get_image();
+
+  std::vector< kv::image_container_sptr > tiles;
+  std::vector< std::pair< unsigned, unsigned > > origins;
+
+  for( auto y : y_origins )
+  {
+    for( auto x : x_origins )
+    {
+      tiles.push_back( std::make_shared< kv::simple_image_container >(
+        full.crop( x, y, tw, th ) ) );
+      origins.emplace_back( x, y );
+    }
+  }
+
+  // Contiguous runs of tiles per detector instance keep batches full
+  const size_t runs = std::min( d->detectors.size(), tiles.size() );
+  std::vector< kv::detected_object_set_sptr > tile_dets;
+
+  if( runs <= 1 || !d->workers )
+  {
+    tile_dets = d->detect_tiles( *d->detectors[0], tiles );
+  }
+  else
+  {
+    std::vector< std::future< std::vector< kv::detected_object_set_sptr > > > results;
+
+    for( size_t r = 0; r < runs; ++r )
+    {
+      const size_t begin = r * tiles.size() / runs;
+      const size_t end = ( r + 1 ) * tiles.size() / runs;
+
+      std::vector< kv::image_container_sptr > run(
+        tiles.begin() + begin, tiles.begin() + end );
+
+      auto detector = d->detectors[r];
+
+      results.push_back( d->workers->enqueue(
+        [this, detector, run]{ return d->detect_tiles( *detector, run ); } ) );
+    }
+
+    for( auto& result : results )
+    {
+      auto run_dets = result.get();
+      tile_dets.insert( tile_dets.end(), run_dets.begin(), run_dets.end() );
+    }
+  }
+
+  for( size_t t = 0; t < tile_dets.size(); ++t )
+  {
+    translate_detections( tile_dets[t], origins[t].first, origins[t].second );
+  }
+
+  if( d->nms_threshold >= 1.0 )
+  {
+    auto output = std::make_shared< kv::detected_object_set >();
+
+    for( auto const& dets : tile_dets )
+    {
+      if( dets )
+      {
+        output->add( dets );
+      }
+    }
+
+    return output;
+  }
+
+  return d->merge( tile_dets );
+}
+
+} // end namespace viame
@@ -0,0 +1,312 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of the tiled BigTIFF writer
+ */
+
+#include "tiled_tiff_writer.h"
+
+#include <vital/exceptions.h>
+
+#include <algorithm>
+
+namespace viame
+{
+
+namespace {
+
+// BigTIFF field types
+const std::uint16_t TIFF_SHORT = 3;
+const std::uint16_t TIFF_LONG = 4;
+const std::uint16_t TIFF_LONG8 = 16;
+
+const std::uint64_t header_size = 16;
+const std::uint64_t entry_count = 12;
+const std::uint64_t directory_size = 8 + entry_count * 20 + 8;
+
+struct tiff_entry
+{
+  std::uint16_t tag;
+  std::uint16_t type;
+  std::uint64_t count;
+  std::uint64_t value;
+};
+
+template< typename T >
+void write_binary( std::fstream& out, const T& value )
+{
+  out.write( reinterpret_cast< const char* >( &value ), sizeof( T ) );
+}
+
+// Array of 16 bit values stored inline in an entry value
+std::uint64_t
+pack_shorts( unsigned count, std::uint16_t value )
+{
+  std::uint64_t output = 0;
+
+  for( unsigned i = 0; i < count; ++i )
+  {
+    output |= static_cast< std::uint64_t >( value ) << ( 16 * i );
+  }
+  return output;
+}
+
+} // end anonymous namespace
+
+
+// =============================================================================
+tiled_tiff_writer
+::tiled_tiff_writer( std::string const& filename,
+                     size_t width, size_t height, unsigned channels,
+                     size_t tile_size, unsigned levels )
+  : m_filename( filename )
+  , m_channels( channels )
+  , m_tile_size( tile_size )
+{
+  if( channels != 1 && channels != 3 )
+  {
+    VITAL_THROW( kwiver::vital::invalid_value,
+                 "Tiled TIFF output supports 1 or 3 channels" );
+  }
+  if( width == 0 || height == 0 || tile_size == 0 || tile_size % 16 != 0 )
+  {
+    VITAL_THROW( kwiver::vital::invalid_value,
+                 "Tiled TIFF output needs a non-empty image and tiles of a "
+                 "multiple of 16 pixels" );
+  }
+
+  // Halve until a single tile holds a level, unless a level count is given
+  while( m_levels.empty() ||
+         ( levels == 0 ? std::max( width, height ) > tile_size
+                       : m_levels.size() < levels ) )
+  {
+    if( !m_levels.empty() )
+    {
+      width = ( width + 1 ) / 2;
+      height = ( height + 1 ) / 2;
+    }
+
+    level_layout level;
+    level.width = width;
+    level.height = height;
+    level.tiles_x = ( width + tile_size - 1 ) / tile_size;
+    level.tiles_y = ( height + tile_size - 1 ) / tile_size;
+    level.data_offset = 0;
+    m_levels.push_back( level );
+
+    if( width == 1 && height == 1 )
+    {
+      break;
+    }
+  }
+
+  m_file.open( filename, std::ios::in | std::ios::out |
+                         std::ios::binary | std::ios::trunc );
+
+  if( !m_file )
+  {
+    VITAL_THROW( kwiver::vital::file_write_exception, filename,
+                 "Unable to open tiled TIFF output" );
+  }
+
+  write_directories();
+}
+
+
+tiled_tiff_writer
+::~tiled_tiff_writer()
+{
+  close();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+tiled_tiff_writer
+::write_directories()
+{
+  // Directories and tile arrays of every level first, then all tile data
+  std::uint64_t position = header_size;
+  std::vector< std::uint64_t > directory_offsets;
+
+  for( auto const& level : m_levels )
+  {
+    const std::uint64_t count = level.tiles_x * level.tiles_y;
+
+    directory_offsets.push_back( position );
+    position += directory_size + ( count > 1 ? 2 * 8 * count : 0 );
+  }
+
+  for( auto& level : m_levels )
+  {
+    level.data_offset = position;
+    position += level.tiles_x * level.tiles_y * tile_bytes();
+  }
+
+  // Header: little endian BigTIFF with 8 byte offsets
+  m_file.write( "II", 2 );
+  write_binary( m_file, std::uint16_t( 43 ) );
+  write_binary( m_file, std::uint16_t( 8 ) );
+  write_binary( m_file, std::uint16_t( 0 ) );
+  write_binary( m_file, directory_offsets[0] );
+
+  for( unsigned l = 0; l < m_levels.size(); ++l )
+  {
+    level_layout const& level = m_levels[l];
+    const std::uint64_t count = level.tiles_x * level.tiles_y;
+    const std::uint64_t arrays = directory_offsets[l] + directory_size;
+
+    const tiff_entry entries[ entry_count ] =
+    {
+      { 254, TIFF_LONG, 1, l > 0 ? 1u : 0u },           // NewSubfileType
+      { 256, TIFF_LONG8, 1, level.width },               // ImageWidth
+      { 257, TIFF_LONG8, 1, level.height },              // ImageLength
+      { 258, TIFF_SHORT, m_channels, pack_shorts( m_channels, 8 ) },
+      { 259, TIFF_SHORT, 1, 1 },                         // No compression
+      { 262, TIFF_SHORT, 1, m_channels == 3 ? 2u : 1u }, // RGB or gray
+      { 277, TIFF_SHORT, 1, m_channels },                // SamplesPerPixel
+      { 284, TIFF_SHORT, 1, 1 },                         // Interleaved
+      { 322, TIFF_LONG, 1, m_tile_size },                // TileWidth
+      { 323, TIFF_LONG, 1, m_tile_size },                // TileLength
+      { 324, TIFF_LONG8, count, count > 1 ? arrays : level.data_offset },
+      { 325, TIFF_LONG8, count, count > 1 ? arrays + 8 * count : tile_bytes() },
+    };
+
+    m_file.seekp( directory_offsets[l] );
+    write_binary( m_file, entry_count );
+
+    for( auto const& entry : entries )
+    {
+      write_binary( m_file, entry.tag );
+      write_binary( m_file, entry.type );
+      write_binary( m_file, entry.count );
+      write_binary( m_file, entry.value );
+    }
+
+    write_binary( m_file, std::uint64_t(
+      l + 1 < m_levels.size() ? directory_offsets[ l + 1 ] : 0 ) );
+
+    if( count > 1 )
+    {
+      for( std::uint64_t t = 0; t < count; ++t )
+      {
+        write_binary( m_file, std::uint64_t( level.data_offset + t * tile_bytes() ) );
+      }
+      for( std::uint64_t t = 0; t < count; ++t )
+      {
+        write_binary( m_file, std::uint64_t( tile_bytes() ) );
+      }
+    }
+  }
+
+  // Extend to the full size so tiles land inside the file in any order
+  m_file.seekp( position - 1 );
+  m_file.put( 0 );
+
+  if( !m_file )
+  {
+    VITAL_THROW( kwiver::vital::file_write_exception, m_filename,
+                 "Unable to write tiled TIFF directories" );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+std::uint64_t
+tiled_tiff_writer
+::tile_offset( unsigned level, size_t tx, size_t ty ) const
+{
+  level_layout const& layout = m_levels.at( level );
+
+  if( tx >= layout.tiles_x || ty >= layout.tiles_y )
+  {
+    VITAL_THROW( kwiver::vital::invalid_value, "Tile index out of range" );
+  }
+
+  return layout.data_offset + ( ty * layout.tiles_x + tx ) * tile_bytes();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+tiled_tiff_writer
+::write_tile( unsigned level, size_t tx, size_t ty, std::uint8_t const* data )
+{
+  const std::uint64_t offset = tile_offset( level, tx, ty );
+
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  m_file.seekp( offset );
+  m_file.write( reinterpret_cast< const char* >( data ), tile_bytes() );
+
+  if( !m_file )
+  {
+    VITAL_THROW( kwiver::vital::file_write_exception, m_filename,
+                 "Unable to write tile" );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+tiled_tiff_writer
+::read_tile( unsigned level, size_t tx, size_t ty, std::uint8_t* data )
+{
+  const std::uint64_t offset = tile_offset( level, tx, ty );
+
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  m_file.seekg( offset );
+  m_file.read( reinterpret_cast< char* >( data ), tile_bytes() );
+
+  if( !m_file )
+  {
+    VITAL_THROW( kwiver::vital::file_not_read_exception, m_filename,
+                 "Unable to read back tile" );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+tiled_tiff_writer
+::close()
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  if( m_file.is_open() )
+  {
+    m_file.close();
+  }
+}
+
+} // end namespace
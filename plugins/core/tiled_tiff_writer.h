@@ -0,0 +1,115 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Streaming writer of tiled, pyramidal BigTIFF images
+ *
+ * Tiles are stored uncompressed, so the position of every tile of every
+ * level is known when the file is created. Tiles can then be written once
+ * each, in any order and from any thread, without holding the image in
+ * memory. The image file directories of all levels come first, followed by
+ * the tile data, in the cloud optimized GeoTIFF layout.
+ */
+
+#ifndef VIAME_CORE_TILED_TIFF_WRITER_H
+#define VIAME_CORE_TILED_TIFF_WRITER_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+class VIAME_CORE_EXPORT tiled_tiff_writer
+{
+public:
+  /// Create the file and write its directories, throws if it cannot be opened
+  /// @param channels 1 for grayscale or 3 for RGB, 8 bits each
+  /// @param levels Number of resolution levels, each half the size of the
+  ///               previous one, or 0 to halve until one tile covers a level
+  tiled_tiff_writer( std::string const& filename,
+                     size_t width, size_t height, unsigned channels,
+                     size_t tile_size = 512, unsigned levels = 0 );
+  ~tiled_tiff_writer();
+
+  tiled_tiff_writer( tiled_tiff_writer const& ) = delete;
+  tiled_tiff_writer& operator=( tiled_tiff_writer const& ) = delete;
+
+  unsigned levels() const { return static_cast< unsigned >( m_levels.size() ); }
+  size_t tile_size() const { return m_tile_size; }
+  unsigned channels() const { return m_channels; }
+
+  size_t width( unsigned level ) const { return m_levels[ level ].width; }
+  size_t height( unsigned level ) const { return m_levels[ level ].height; }
+  size_t tiles_x( unsigned level ) const { return m_levels[ level ].tiles_x; }
+  size_t tiles_y( unsigned level ) const { return m_levels[ level ].tiles_y; }
+
+  /// Bytes of one tile, tile_size squared pixels of interleaved channels
+  size_t tile_bytes() const { return m_tile_size * m_tile_size * m_channels; }
+
+  /// Store a tile, thread safe; parts beyond the image edge are ignored
+  void write_tile( unsigned level, size_t tx, size_t ty, std::uint8_t const* data );
+
+  /// Read back a written tile, thread safe, e.g. to build the next level
+  void read_tile( unsigned level, size_t tx, size_t ty, std::uint8_t* data );
+
+  /// Flush and close the file, also done on destruction
+  void close();
+
+private:
+  struct level_layout
+  {
+    size_t width, height;
+    size_t tiles_x, tiles_y;
+    std::uint64_t data_offset;
+  };
+
+  std::uint64_t tile_offset( unsigned level, size_t tx, size_t ty ) const;
+  void write_directories();
+
+  std::string m_filename;
+  std::fstream m_file;
+  std::mutex m_mutex;
+
+  unsigned m_channels;
+  size_t m_tile_size;
+  std::vector< level_layout > m_levels;
+};
+
+} // end namespace
+
+#endif // VIAME_CORE_TILED_TIFF_WRITER_H
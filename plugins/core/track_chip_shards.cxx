@@ -0,0 +1,443 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of the track chip shards
+ */
+
+#include "track_chip_shards.h"
+
+#include <vital/exceptions.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
+#include <fstream>
+
+namespace viame
+{
+
+namespace bip = boost::interprocess;
+
+namespace {
+
+const char shard_magic[] = "VIAMETCS";
+const std::size_t shard_magic_size = sizeof( shard_magic ) - 1;
+const std::uint32_t shard_version = 1;
+
+const std::uint32_t record_size =
+  sizeof( std::int64_t ) + 2 * sizeof( std::uint32_t ) + 8 * sizeof( double );
+const std::uint64_t track_size = 3 * sizeof( std::uint64_t );
+const std::uint64_t header_size =
+  shard_magic_size + 6 * sizeof( std::uint32_t ) + 3 * sizeof( std::uint64_t );
+const std::uint64_t pixel_alignment = 4096;
+
+template< typename T >
+void write_value( char*& pos, const T& value )
+{
+  std::memcpy( pos, &value, sizeof( T ) );
+  pos += sizeof( T );
+}
+
+template< typename T >
+T read_value( const char*& pos )
+{
+  T value;
+  std::memcpy( &value, pos, sizeof( T ) );
+  pos += sizeof( T );
+  return value;
+}
+
+std::uint64_t pixel_offset( std::uint64_t track_count, std::uint64_t chip_count )
+{
+  const std::uint64_t tables = header_size + track_count * track_size +
+                               chip_count * record_size;
+  return ( tables + pixel_alignment - 1 ) / pixel_alignment * pixel_alignment;
+}
+
+} // end anonymous namespace
+
+
+// =============================================================================
+class track_chip_shard_writer::priv
+{
+public:
+  std::string m_filename;
+  std::unique_ptr< bip::mapped_region > m_region;
+
+  std::size_t m_chip_count = 0;
+  std::size_t m_chip_size = 0;
+  char* m_records = nullptr;
+  unsigned char* m_pixels = nullptr;
+};
+
+
+// -----------------------------------------------------------------------------
+track_chip_shard_writer
+::track_chip_shard_writer( std::string const& filename,
+                           unsigned width, unsigned height, unsigned channels,
+                           std::vector< track_chip_range > const& tracks )
+  : d( new priv() )
+{
+  d->m_filename = filename;
+  d->m_chip_size = static_cast< std::size_t >( width ) * height * channels;
+
+  for( std::size_t i = 0; i < tracks.size(); ++i )
+  {
+    if( tracks[i].first_chip != d->m_chip_count ||
+        ( i > 0 && tracks[i].track_id <= tracks[i-1].track_id ) )
+    {
+      VITAL_THROW( kwiver::vital::invalid_data,
+                   "Track chip ranges must be contiguous with increasing ids" );
+    }
+    d->m_chip_count += tracks[i].chip_count;
+  }
+
+  const std::uint64_t data_offset = pixel_offset( tracks.size(), d->m_chip_count );
+  const std::uint64_t file_size = data_offset +
+    static_cast< std::uint64_t >( d->m_chip_count ) * d->m_chip_size;
+
+  // Size the file up front, its unwritten contents read back as zeros
+  {
+    std::ofstream out( filename, std::ios::binary | std::ios::trunc );
+
+    if( !out || !out.seekp( file_size - 1 ) || !out.put( '\0' ) || !out.flush() )
+    {
+      VITAL_THROW( kwiver::vital::file_write_exception, filename,
+                   "Unable to create track chip shard" );
+    }
+  }
+
+  try
+  {
+    bip::file_mapping file( filename.c_str(), bip::read_write );
+    d->m_region.reset( new bip::mapped_region( file, bip::read_write ) );
+  }
+  catch( bip::interprocess_exception const& e )
+  {
+    VITAL_THROW( kwiver::vital::file_write_exception, filename,
+                 std::string( "Unable to map track chip shard: " ) + e.what() );
+  }
+
+  char* pos = static_cast< char* >( d->m_region->get_address() );
+
+  std::memcpy( pos, shard_magic, shard_magic_size );
+  pos += shard_magic_size;
+  write_value( pos, shard_version );
+  write_value( pos, record_size );
+  write_value( pos, static_cast< std::uint32_t >( width ) );
+  write_value( pos, static_cast< std::uint32_t >( height ) );
+  write_value( pos, static_cast< std::uint32_t >( channels ) );
+  write_value( pos, std::uint32_t( 0 ) );
+  write_value( pos, static_cast< std::uint64_t >( tracks.size() ) );
+  write_value( pos, static_cast< std::uint64_t >( d->m_chip_count ) );
+  write_value( pos, data_offset );
+
+  for( auto const& track : tracks )
+  {
+    write_value( pos, track.track_id );
+    write_value( pos, static_cast< std::uint64_t >( track.first_chip ) );
+    write_value( pos, static_cast< std::uint64_t >( track.chip_count ) );
+  }
+
+  d->m_records = pos;
+  d->m_pixels = static_cast< unsigned char* >( d->m_region->get_address() ) + data_offset;
+}
+
+
+track_chip_shard_writer
+::~track_chip_shard_writer()
+{
+  try
+  {
+    close();
+  }
+  catch( ... )
+  {
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+std::size_t
+track_chip_shard_writer
+::chip_count() const
+{
+  return d->m_chip_count;
+}
+
+
+// -----------------------------------------------------------------------------
+unsigned char*
+track_chip_shard_writer
+::pixels( std::size_t chip )
+{
+  return d->m_pixels + chip * d->m_chip_size;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+track_chip_shard_writer
+::set_record( std::size_t chip, track_chip_record const& record )
+{
+  char* pos = d->m_records + chip * record_size;
+
+  write_value( pos, record.frame_id );
+  write_value( pos, record.flags );
+  write_value( pos, std::uint32_t( 0 ) );
+
+  for( const double value : record.box )
+  {
+    write_value( pos, value );
+  }
+  for( const double value : record.region )
+  {
+    write_value( pos, value );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+track_chip_shard_writer
+::close()
+{
+  if( d->m_region )
+  {
+    const bool flushed = d->m_region->flush();
+    d->m_region.reset();
+
+    if( !flushed )
+    {
+      VITAL_THROW( kwiver::vital::file_write_exception, d->m_filename,
+                   "Unable to flush track chip shard" );
+    }
+  }
+}
+
+
+// =============================================================================
+class track_chip_shard_reader::priv
+{
+public:
+  std::unique_ptr< bip::mapped_region > m_region;
+
+  unsigned m_width = 0;
+  unsigned m_height = 0;
+  unsigned m_channels = 0;
+
+  std::vector< track_chip_range > m_tracks;
+  std::size_t m_chip_count = 0;
+  const char* m_records = nullptr;
+  const unsigned char* m_pixels = nullptr;
+};
+
+
+// -----------------------------------------------------------------------------
+track_chip_shard_reader
+::track_chip_shard_reader()
+  : d( new priv() )
+{
+}
+
+
+track_chip_shard_reader
+::~track_chip_shard_reader()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+track_chip_shard_reader
+::open( std::string const& filename )
+{
+  d.reset( new priv() );
+
+  try
+  {
+    bip::file_mapping file( filename.c_str(), bip::read_only );
+    d->m_region.reset( new bip::mapped_region( file, bip::read_only ) );
+  }
+  catch( bip::interprocess_exception const& )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Unable to map track chip shard: " + filename );
+  }
+
+  const char* data = static_cast< const char* >( d->m_region->get_address() );
+  const std::uint64_t size = d->m_region->get_size();
+
+  if( size < header_size || std::memcmp( data, shard_magic, shard_magic_size ) != 0 )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Not a track chip shard: " + filename );
+  }
+
+  const char* pos = data + shard_magic_size;
+
+  const auto version = read_value< std::uint32_t >( pos );
+  const auto rsize = read_value< std::uint32_t >( pos );
+
+  if( version != shard_version || rsize != record_size )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Unsupported track chip shard version in: " + filename );
+  }
+
+  d->m_width = read_value< std::uint32_t >( pos );
+  d->m_height = read_value< std::uint32_t >( pos );
+  d->m_channels = read_value< std::uint32_t >( pos );
+  read_value< std::uint32_t >( pos );
+
+  const auto track_count = read_value< std::uint64_t >( pos );
+  const auto chip_count = read_value< std::uint64_t >( pos );
+  const auto data_offset = read_value< std::uint64_t >( pos );
+
+  const std::uint64_t chip_size =
+    static_cast< std::uint64_t >( d->m_width ) * d->m_height * d->m_channels;
+
+  if( track_count > size / track_size || chip_count > size / record_size ||
+      data_offset != pixel_offset( track_count, chip_count ) ||
+      data_offset > size || ( chip_size && chip_count > ( size - data_offset ) / chip_size ) )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Invalid track chip shard header in: " + filename );
+  }
+
+  std::uint64_t next_chip = 0;
+
+  for( std::uint64_t i = 0; i < track_count; ++i )
+  {
+    track_chip_range track;
+    track.track_id = read_value< std::int64_t >( pos );
+    track.first_chip = read_value< std::uint64_t >( pos );
+    track.chip_count = read_value< std::uint64_t >( pos );
+
+    if( track.first_chip != next_chip || track.chip_count > chip_count - next_chip )
+    {
+      VITAL_THROW( kwiver::vital::invalid_data,
+                   "Invalid track chip ranges in: " + filename );
+    }
+
+    next_chip += track.chip_count;
+    d->m_tracks.push_back( track );
+  }
+
+  d->m_chip_count = chip_count;
+  d->m_records = pos;
+  d->m_pixels = reinterpret_cast< const unsigned char* >( data ) + data_offset;
+}
+
+
+// -----------------------------------------------------------------------------
+unsigned
+track_chip_shard_reader
+::width() const
+{
+  return d->m_width;
+}
+
+
+unsigned
+track_chip_shard_reader
+::height() const
+{
+  return d->m_height;
+}
+
+
+unsigned
+track_chip_shard_reader
+::channels() const
+{
+  return d->m_channels;
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector< track_chip_range > const&
+track_chip_shard_reader
+::tracks() const
+{
+  return d->m_tracks;
+}
+
+
+std::size_t
+track_chip_shard_reader
+::chip_count() const
+{
+  return d->m_chip_count;
+}
+
+
+// -----------------------------------------------------------------------------
+track_chip_record
+track_chip_shard_reader
+::record( std::size_t chip ) const
+{
+  if( chip >= d->m_chip_count )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data, "Track chip index out of range" );
+  }
+
+  track_chip_record record;
+  const char* pos = d->m_records + chip * record_size;
+
+  record.frame_id = read_value< std::int64_t >( pos );
+  record.flags = read_value< std::uint32_t >( pos );
+  read_value< std::uint32_t >( pos );
+
+  for( double& value : record.box )
+  {
+    value = read_value< double >( pos );
+  }
+  for( double& value : record.region )
+  {
+    value = read_value< double >( pos );
+  }
+  return record;
+}
+
+
+// -----------------------------------------------------------------------------
+const unsigned char*
+track_chip_shard_reader
+::pixels( std::size_t chip ) const
+{
+  return d->m_pixels + chip *
+    static_cast< std::size_t >( d->m_width ) * d->m_height * d->m_channels;
+}
+
+} // end namespace viame
@@ -0,0 +1,180 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Memory-mapped shards of fixed-size track chips
+ *
+ * Chips of every state of a track are stored contiguously, so that trainers
+ * can map a shard and read the chips of a track as one block. All values are
+ * in native (little endian) byte order:
+ *
+ *   char[8]   magic "VIAMETCS"
+ *   uint32    format version, currently 1
+ *   uint32    chip record size in bytes, currently 80
+ *   uint32    chip width, height and channels, then padding
+ *   uint64    number of tracks
+ *   uint64    number of chips
+ *   uint64    byte offset of the pixel data, a multiple of 4096
+ *   tracks    one per track, in increasing track id order:
+ *     int64     track id
+ *     uint64    index of the first chip of the track
+ *     uint64    number of chips of the track
+ *   records   one per chip, in track then frame order:
+ *     int64     frame id
+ *     uint32    flags, 1 when the chip holds image data
+ *     uint32    padding
+ *     double[4] track box in chip pixels, min x, min y, max x, max y
+ *     double[4] region of the frame scaled into the chip, same order
+ *   pixels    uint8 values of every chip in record order, rows top down
+ *             with channels interleaved
+ *
+ * The layout of a shard is fixed before any chip is written, so that chips
+ * can be written in any order and from several threads at once.
+ */
+
+#ifndef VIAME_CORE_TRACK_CHIP_SHARDS_H
+#define VIAME_CORE_TRACK_CHIP_SHARDS_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Location of one track state within its chip
+ */
+struct VIAME_CORE_EXPORT track_chip_record
+{
+  static const std::uint32_t has_pixels = 0x1;
+
+  std::int64_t frame_id = 0;
+  std::uint32_t flags = 0;
+
+  /// Track box in chip pixels
+  double box[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+  /// Region of the frame scaled into the chip, which may exceed the frame
+  double region[4] = { 0.0, 0.0, 0.0, 0.0 };
+};
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Chips of one track within a shard
+ */
+struct VIAME_CORE_EXPORT track_chip_range
+{
+  std::int64_t track_id = 0;
+  std::size_t first_chip = 0;
+  std::size_t chip_count = 0;
+};
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Writer of a shard with a layout fixed on creation
+ *
+ * Distinct chips may be written concurrently. Chips which are never written
+ * keep zero pixels and records without the has_pixels flag.
+ */
+class VIAME_CORE_EXPORT track_chip_shard_writer
+{
+public:
+  /// Create the shard file for the given tracks, whose ids must increase.
+  /// Throws if the file cannot be created or mapped.
+  track_chip_shard_writer( std::string const& filename,
+                           unsigned width, unsigned height, unsigned channels,
+                           std::vector< track_chip_range > const& tracks );
+  ~track_chip_shard_writer();
+
+  track_chip_shard_writer( track_chip_shard_writer const& ) = delete;
+  track_chip_shard_writer& operator=( track_chip_shard_writer const& ) = delete;
+
+  /// Number of chips in the shard
+  std::size_t chip_count() const;
+
+  /// Mapped pixels of a chip, height rows of width times channels values
+  unsigned char* pixels( std::size_t chip );
+
+  /// Write the record of a chip
+  void set_record( std::size_t chip, track_chip_record const& record );
+
+  /// Flush all chips to the file and unmap it, also done on destruction
+  void close();
+
+private:
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Read-only access to a memory-mapped shard
+ */
+class VIAME_CORE_EXPORT track_chip_shard_reader
+{
+public:
+  track_chip_shard_reader();
+  ~track_chip_shard_reader();
+
+  track_chip_shard_reader( track_chip_shard_reader const& ) = delete;
+  track_chip_shard_reader& operator=( track_chip_shard_reader const& ) = delete;
+
+  /// Map a shard and validate its header, throws on invalid files
+  void open( std::string const& filename );
+
+  unsigned width() const;
+  unsigned height() const;
+  unsigned channels() const;
+
+  /// Tracks of the shard, in increasing track id order
+  std::vector< track_chip_range > const& tracks() const;
+
+  std::size_t chip_count() const;
+  track_chip_record record( std::size_t chip ) const;
+  const unsigned char* pixels( std::size_t chip ) const;
+
+private:
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+} // end namespace
+
+#endif // VIAME_CORE_TRACK_CHIP_SHARDS_H
@@ -34,9 +34,18 @@
  */
 
 #include "track_conductor_process.h"
-
-#include <list>
+#include "process_trace.h"
+#include "image_memory_budget.h"
+#include "spsc_ring_buffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
 #include <limits>
+#include <map>
+#include <memory>
+#include <unordered_map>
 #include <cmath>
 #include <utility>
 #include <thread>
@@ -51,6 +60,7 @@
 #include <vital/types/object_track_set.h>
 
 #include <sprokit/processes/kwiver_type_traits.h>
+#include <sprokit/pipeline/process_exception.h>
 
 
 namespace kv = kwiver::vital;
@@ -76,14 +86,16 @@ create_port_trait( short_term_initializations, object_track_set, "Init signals"
 create_port_trait( mid_term_initializations, object_track_set, "Init signals" );
 create_port_trait( long_term_initializations, object_track_set, "Init signals" );
 
+// Frame inputs, with the image bytes reported to the image memory budget
 typedef std::tuple< kv::timestamp,
                     kv::image_container_sptr,
-                    kv::object_track_set_sptr > image_and_track_tuple_t;
-typedef std::list< image_and_track_tuple_t > image_and_track_buffer_t;
+                    kv::object_track_set_sptr,
+                    size_t > image_and_track_tuple_t;
+typedef spsc_ring_buffer< image_and_track_tuple_t > image_and_track_buffer_t;
 
 typedef std::pair< kv::timestamp,
                    kv::object_track_set_sptr > timestamp_track_pair_t;
-typedef std::list< timestamp_track_pair_t > track_buffer_t;
+typedef spsc_ring_buffer< timestamp_track_pair_t > track_buffer_t;
 
 typedef kv::track_id_t track_id_t;
 
@@ -96,13 +108,159 @@ struct track_info_t
   unsigned frames_since_last[3];
 };
 
+// Tracks with the same ID from each of the input trackers
+struct tri_track_t
+{
+  kv::track_sptr st;
+  kv::track_sptr mt;
+  kv::track_sptr lt;
+};
+
+typedef std::map< track_id_t, tri_track_t > tri_track_map_t;
+
+// -----------------------------------------------------------------------------
+// Merges the initialization signals sent to one tracker. The merged index is
+// kept across frames, so a merge with the same result as the previous frame
+// returns the previous output set instead of building a new one.
+class init_signal_merger
+{
+public:
+  kv::object_track_set_sptr
+  merge( const kv::object_track_set_sptr& priority,
+         const kv::object_track_set_sptr& secondary )
+  {
+    if( !priority && !secondary )
+    {
+      return kv::object_track_set_sptr();
+    }
+    else if( !priority || priority->empty() )
+    {
+      return secondary;
+    }
+    else if( !secondary || secondary->empty() )
+    {
+      return priority;
+    }
+
+    m_merged.clear();
+
+    for( const auto& track : priority->tracks() )
+    {
+      add( track, true );
+    }
+    for( const auto& track : secondary->tracks() )
+    {
+      add( track, false );
+    }
+
+    if( !m_output || m_merged != m_index )
+    {
+      m_index.swap( m_merged );
+
+      std::vector< kv::track_sptr > track_vec;
+      track_vec.reserve( m_index.size() );
+
+      for( const auto& elem : m_index )
+      {
+        track_vec.push_back( elem.second );
+      }
+
+      std::sort( track_vec.begin(), track_vec.end(),
+        []( const kv::track_sptr& lhs, const kv::track_sptr& rhs )
+        {
+          return lhs->id() < rhs->id();
+        } );
+
+      m_output = std::make_shared< kv::object_track_set >( track_vec );
+    }
+
+    return m_output;
+  }
+
+private:
+  // Keep the most recent track for each ID, priority tracks winning ties
+  void add( const kv::track_sptr& track, bool is_priority )
+  {
+    if( !track )
+    {
+      return;
+    }
+
+    auto it = m_merged.find( track->id() );
+
+    if( it == m_merged.end() )
+    {
+      m_merged.emplace( track->id(), track );
+    }
+    else if( is_priority ? track->last_frame() >= it->second->last_frame()
+                         : track->last_frame() > it->second->last_frame() )
+    {
+      it->second = track;
+    }
+  }
+
+  std::unordered_map< track_id_t, kv::track_sptr > m_index;
+  std::unordered_map< track_id_t, kv::track_sptr > m_merged;
+  kv::object_track_set_sptr m_output;
+};
+
+
+// -----------------------------------------------------------------------------
+// Latency counters of one input port, updated by its input thread in
+// asynchronous mode while the process step reads them for reports
+struct port_stats_t
+{
+  std::atomic< uint64_t > count{ 0 };
+  std::atomic< uint64_t > wait_usec{ 0 };
+  std::atomic< uint64_t > max_wait_usec{ 0 };
+  std::atomic< uint64_t > depth_sum{ 0 };
+  std::atomic< uint64_t > max_depth{ 0 };
+
+  void add( uint64_t wait, uint64_t depth )
+  {
+    count++;
+    wait_usec += wait;
+    depth_sum += depth;
+    update_max( max_wait_usec, wait );
+    update_max( max_depth, depth );
+  }
+
+  static void update_max( std::atomic< uint64_t >& max, uint64_t value )
+  {
+    uint64_t current = max;
+
+    while( current < value && !max.compare_exchange_weak( current, value ) )
+    {
+    }
+  }
+};
+
+typedef std::chrono::steady_clock stats_clock_t;
+
+inline uint64_t
+elapsed_usec( const stats_clock_t::time_point& start )
+{
+  return std::chrono::duration_cast< std::chrono::microseconds >(
+    stats_clock_t::now() - start ).count();
+}
+
+
 create_config_trait( synchronize, bool, "true",
   "Expect no frame droppages and wait for outputs from all trackers at each "
   "step. If disabled, downsampling of input trackers is allowed." );
+create_config_trait( buffer_size, unsigned, "64",
+  "Maximum number of frames buffered for each tracker in asynchronous mode. "
+  "A tracker waits for the conductor to catch up when its buffer is full." );
 create_config_trait( auto_track_id_start, track_id_t, "10000",
   "If a combination of user and automatically generated tracking is enabled, "
   "this field allows a clear differentiation between the two by starting "
   "automatic track IDs at this value." );
+create_config_trait( stats_interval, unsigned, "0",
+  "If set, log the queue depth and wait time of each input port and the "
+  "step latency every this many output frames, and once at completion." );
+create_config_trait( stats_file, std::string, "",
+  "If set, also write these latency statistics to this CSV file, with one "
+  "row of cumulative counters per port and report." );
 
 
 // =============================================================================
@@ -113,29 +271,71 @@ public:
   explicit priv( track_conductor_process* parent );
   ~priv();
 
+  // Fuse the tracker outputs into the active tracks and corrections. Each
+  // tracker output is considered current for the given frame, which is the
+  // output frame in synchronous mode but lags behind it for slower trackers
+  // in asynchronous mode.
+  // Log the latency counters and write them to the stats file
+  void report_stats( kv::frame_id_t frame );
+
+  kv::object_track_set_sptr update_tracks( const kv::timestamp& timestamp,
+                                           const tri_track_map_t& computed,
+                                           const kv::frame_id_t frames[3] );
+
+  // Move the outputs of a tracker up to the given frame out of its buffer,
+  // keeping the most recent one, returns false if there were none
+  bool take_outputs( track_buffer_t& buffer,
+                     timestamp_track_pair_t& latest, kv::frame_id_t frame );
+
+  void join_threads();
+
   // Configuration settings
   bool m_synchronize;
+  unsigned m_buffer_size;
   track_id_t m_auto_track_id_start;
   unsigned m_mid_term_reinit_thresh;
   unsigned m_long_term_reinit_thresh;
-
-  // Internal thread system
+  unsigned m_stats_interval;
+  std::string m_stats_file;
+
+  // Latency instrumentation, the standard inputs cover the timestamp, image
+  // and initializations ports
+  port_stats_t m_standard_stats;
+  port_stats_t m_short_term_stats;
+  port_stats_t m_mid_term_stats;
+  port_stats_t m_long_term_stats;
+  uint64_t m_step_count;
+  uint64_t m_step_usec;
+  uint64_t m_max_step_usec;
+  unsigned m_frames_since_report;
+  std::ofstream m_stats_writer;
+
+  // Internal thread system, the mutex is only used to sleep on the trigger
   std::vector< std::thread > threads;
   std::condition_variable update_trigger;
+  std::mutex update_mutex;
 
-  // Internal buffers
+  // Internal buffers, each filled by a single tracker input thread in
+  // asynchronous mode and emptied by the process step
   image_and_track_buffer_t m_standard_inputs;
-  std::mutex m_standard_input_mutex;
+  image_memory_holder m_standard_memory;
   track_buffer_t m_short_term_tracks;
-  std::mutex m_short_term_mutex;
   bool m_has_short_term_tracker;
   track_buffer_t m_mid_term_tracks;
-  std::mutex m_mid_term_mutex;
   bool m_has_mid_term_tracker;
   track_buffer_t m_long_term_tracks;
-  std::mutex m_long_term_mutex;
   bool m_has_long_term_tracker;
 
+  // Set by the tracker input threads in asynchronous mode
+  std::atomic< bool > m_short_term_complete;
+  std::atomic< bool > m_mid_term_complete;
+  std::atomic< bool > m_long_term_complete;
+
+  // Most recent output received from each tracker in asynchronous mode
+  timestamp_track_pair_t m_short_term_latest;
+  timestamp_track_pair_t m_mid_term_latest;
+  timestamp_track_pair_t m_long_term_latest;
+
   // Track management
   std::map< track_id_t, track_info_t > m_active_tracks;
 
@@ -144,6 +344,11 @@ public:
   kv::object_track_set_sptr m_mt_corrections;
   kv::object_track_set_sptr m_lt_corrections;
 
+  // Initialization signals sent to each tracker
+  init_signal_merger m_st_inits;
+  init_signal_merger m_mt_inits;
+  init_signal_merger m_lt_inits;
+
   // General frame-level properties
   bool m_is_first;
   bool m_received_complete;
@@ -155,12 +360,21 @@ public:
 track_conductor_process::priv
 ::priv( track_conductor_process* ptr )
   : m_synchronize( true )
+  , m_buffer_size( 64 )
   , m_auto_track_id_start( 10000 )
   , m_mid_term_reinit_thresh( 5 )
   , m_long_term_reinit_thresh( 10 )
+  , m_stats_interval( 0 )
+  , m_step_count( 0 )
+  , m_step_usec( 0 )
+  , m_max_step_usec( 0 )
+  , m_frames_since_report( 0 )
   , m_has_short_term_tracker( false )
   , m_has_mid_term_tracker( false )
   , m_has_long_term_tracker( false )
+  , m_short_term_complete( false )
+  , m_mid_term_complete( false )
+  , m_long_term_complete( false )
   , m_is_first( true )
   , m_received_complete( false )
   , parent( ptr )
@@ -171,6 +385,97 @@ track_conductor_process::priv
 track_conductor_process::priv
 ::~priv()
 {
+  join_threads();
+}
+
+
+void
+track_conductor_process::priv
+::join_threads()
+{
+  for( auto& thread : threads )
+  {
+    if( thread.joinable() )
+    {
+      thread.join();
+    }
+  }
+  threads.clear();
+}
+
+
+void
+track_conductor_process::priv
+::report_stats( kv::frame_id_t frame )
+{
+  auto report = [&]( const char* name, const port_stats_t& stats )
+  {
+    const uint64_t count = stats.count;
+    const double mean_wait_ms = ( count ? stats.wait_usec.load() / 1000.0 / count : 0.0 );
+    const double max_wait_ms = stats.max_wait_usec.load() / 1000.0;
+    const double mean_depth = ( count ? double( stats.depth_sum.load() ) / count : 0.0 );
+
+    LOG_INFO( parent->logger(), name << ": " << count << " frames, wait "
+              << mean_wait_ms << " ms mean, " << max_wait_ms << " ms max, "
+              << "queue depth " << mean_depth << " mean, "
+              << stats.max_depth.load() << " max" );
+
+    if( m_stats_writer.is_open() )
+    {
+      m_stats_writer << frame << "," << name << "," << count << ","
+                     << mean_wait_ms << "," << max_wait_ms << ","
+                     << mean_depth << "," << stats.max_depth.load() << "\n";
+    }
+  };
+
+  report( "inputs", m_standard_stats );
+
+  if( m_has_short_term_tracker )
+  {
+    report( "short_term", m_short_term_stats );
+  }
+  if( m_has_mid_term_tracker )
+  {
+    report( "mid_term", m_mid_term_stats );
+  }
+  if( m_has_long_term_tracker )
+  {
+    report( "long_term", m_long_term_stats );
+  }
+
+  const double mean_step_ms =
+    ( m_step_count ? m_step_usec / 1000.0 / m_step_count : 0.0 );
+
+  LOG_INFO( parent->logger(), "step: " << m_step_count << " frames, latency "
+            << mean_step_ms << " ms mean, " << m_max_step_usec / 1000.0
+            << " ms max" );
+
+  if( m_stats_writer.is_open() )
+  {
+    m_stats_writer << frame << ",step," << m_step_count << ","
+                   << mean_step_ms << "," << m_max_step_usec / 1000.0
+                   << ",0,0" << std::endl;
+  }
+
+  m_frames_since_report = 0;
+}
+
+
+bool
+track_conductor_process::priv
+::take_outputs( track_buffer_t& buffer,
+                timestamp_track_pair_t& latest, kv::frame_id_t frame )
+{
+  bool any = false;
+
+  while( !buffer.empty() && buffer.front().first.get_frame() <= frame )
+  {
+    latest = std::move( buffer.front() );
+    buffer.pop();
+    any = true;
+  }
+
+  return any;
 }
 
 
@@ -233,7 +538,10 @@ track_conductor_process
 ::make_config()
 {
   declare_config_using_trait( synchronize );
+  declare_config_using_trait( buffer_size );
   declare_config_using_trait( auto_track_id_start );
+  declare_config_using_trait( stats_interval );
+  declare_config_using_trait( stats_file );
 }
 
 
@@ -243,7 +551,34 @@ track_conductor_process
 ::_configure()
 {
   d->m_synchronize = config_value_using_trait( synchronize );
+  d->m_buffer_size = config_value_using_trait( buffer_size );
+
+  // Synchronous steps consume every input before the next one is grabbed
+  const size_t buffer_size = ( d->m_synchronize ? 1 : d->m_buffer_size );
+
+  d->m_standard_inputs.reset( buffer_size );
+  d->m_standard_memory.clear();
+  d->m_short_term_tracks.reset( buffer_size );
+  d->m_mid_term_tracks.reset( buffer_size );
+  d->m_long_term_tracks.reset( buffer_size );
   d->m_auto_track_id_start = config_value_using_trait( auto_track_id_start );
+
+  d->m_stats_interval = config_value_using_trait( stats_interval );
+  d->m_stats_file = config_value_using_trait( stats_file );
+
+  if( d->m_stats_interval > 0 && !d->m_stats_file.empty() )
+  {
+    d->m_stats_writer.open( d->m_stats_file, std::ofstream::out );
+
+    if( !d->m_stats_writer )
+    {
+      VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                   "Unable to open stats file: " + d->m_stats_file );
+    }
+
+    d->m_stats_writer << "frame,port,count,mean_wait_ms,max_wait_ms,"
+                      << "mean_queue_depth,max_queue_depth" << std::endl;
+  }
 }
 
 
@@ -252,7 +587,50 @@ void
 track_conductor_process
 ::make_threads()
 {
-  throw std::runtime_error( "Asynchronous processing not implemented" );
+  // One input thread per tracker, each grabbing tracker outputs as soon as
+  // they are produced so that slower trackers never block the output
+  auto add_thread = [this]( void ( track_conductor_process::*wait_for_inputs )(),
+                            std::atomic< bool >& complete )
+  {
+    d->threads.emplace_back( [this, wait_for_inputs, &complete]()
+    {
+      while( !complete )
+      {
+        try
+        {
+          ( this->*wait_for_inputs )();
+        }
+        catch( ... )
+        {
+          // Pipeline shutdown, no more outputs will come from this tracker
+          complete = true;
+        }
+
+        // Taking the mutex orders the new output before a waiting step
+        // rechecks its condition, so the notification cannot be missed
+        {
+          std::lock_guard< std::mutex > lock( d->update_mutex );
+        }
+        d->update_trigger.notify_all();
+      }
+    } );
+  };
+
+  if( d->m_has_short_term_tracker )
+  {
+    add_thread( &track_conductor_process::wait_for_short_term_inputs,
+                d->m_short_term_complete );
+  }
+  if( d->m_has_mid_term_tracker )
+  {
+    add_thread( &track_conductor_process::wait_for_mid_term_inputs,
+                d->m_mid_term_complete );
+  }
+  if( d->m_has_long_term_tracker )
+  {
+    add_thread( &track_conductor_process::wait_for_long_term_inputs,
+                d->m_long_term_complete );
+  }
 }
 
 
@@ -265,6 +643,8 @@ track_conductor_process
   kv::timestamp timestamp;
   kv::object_track_set_sptr tracks;
 
+  const stats_clock_t::time_point start = stats_clock_t::now();
+
   auto port_info = peek_at_port_using_trait( timestamp );
 
   if( port_info.datum->type() == sprokit::datum::complete )
@@ -295,18 +675,14 @@ track_conductor_process
       tracks = grab_from_port_using_trait( initializations );
     }
 
-    if( d->m_synchronize )
-    {
-      d->m_standard_inputs.push_back(
-        std::make_tuple( timestamp, image, tracks ) );
-    }
-    else
-    {
-      std::lock_guard< std::mutex >( d->m_standard_input_mutex );
+    const size_t bytes = image_memory_size( image );
+    d->m_standard_memory.add( bytes );
 
-      d->m_standard_inputs.push_back(
-        std::make_tuple( timestamp, image, tracks ) );
-    }
+    d->m_standard_inputs.wait_push(
+      std::make_tuple( timestamp, image, tracks, bytes ) );
+
+    d->m_standard_stats.add( elapsed_usec( start ),
+                             d->m_standard_inputs.size() );
   }  
 }
 
@@ -319,32 +695,34 @@ track_conductor_process                                                      \
 {                                                                            \
   kv::timestamp timestamp;                                                   \
   kv::object_track_set_sptr tracks;                                          \
+  const stats_clock_t::time_point start = stats_clock_t::now();              \
   auto port_info = peek_at_port_using_trait( TRACKER ## _timestamp );        \
                                                                              \
   if( port_info.datum->type() == sprokit::datum::complete )                  \
   {                                                                          \
-    d->m_received_complete = true;                                           \
-                                                                             \
     grab_edge_datum_using_trait( TRACKER ## _timestamp );                    \
     grab_edge_datum_using_trait( TRACKER ## _tracks );                       \
-  }                                                                          \
-  else                                                                       \
-  {                                                                          \
-    timestamp = grab_from_port_using_trait( TRACKER ## _timestamp );         \
-    tracks = grab_from_port_using_trait( TRACKER ## _tracks );               \
                                                                              \
     if( d->m_synchronize )                                                   \
     {                                                                        \
-      d->m_ ## TRACKER ## _tracks.push_back(                                 \
-        std::make_pair( timestamp, tracks ) );                               \
+      d->m_received_complete = true;                                         \
     }                                                                        \
     else                                                                     \
     {                                                                        \
-      std::lock_guard< std::mutex >( d->m_standard_input_mutex );            \
-      d->m_ ## TRACKER ## _tracks.push_back(                                 \
-        std::make_pair( timestamp, tracks ) );                               \
+      d->m_ ## TRACKER ## _complete = true;                                  \
     }                                                                        \
   }                                                                          \
+  else                                                                       \
+  {                                                                          \
+    timestamp = grab_from_port_using_trait( TRACKER ## _timestamp );         \
+    tracks = grab_from_port_using_trait( TRACKER ## _tracks );               \
+                                                                             \
+    d->m_ ## TRACKER ## _tracks.wait_push(                                   \
+      std::make_pair( timestamp, tracks ) );                                 \
+                                                                             \
+    d->m_ ## TRACKER ## _stats.add( elapsed_usec( start ),                   \
+                                    d->m_ ## TRACKER ## _tracks.size() );    \
+  }                                                                          \
 }
 
 DECLARE_INPUT_FUNCTION( short_term )
@@ -356,6 +734,8 @@ void
 track_conductor_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
   if( d->m_is_first )
   {
     d->m_has_short_term_tracker =
@@ -373,6 +753,8 @@ track_conductor_process
     d->m_is_first = false;
   }
 
+  const stats_clock_t::time_point start = stats_clock_t::now();
+
   if( d->m_synchronize )
   {
     sync_step();
@@ -381,161 +763,37 @@ track_conductor_process
   {
     async_step();
   }
-}
 
-
-// -----------------------------------------------------------------------------
-kv::object_track_set_sptr
-merge_init_signals( const kv::object_track_set_sptr priority,
-                    const kv::object_track_set_sptr secondary )
-{
-  if( !priority && !secondary )
-  {
-    return kv::object_track_set_sptr();
-  }
-  else if( !priority )
-  {
-    return secondary;
-  }
-  else if( !secondary )
+  if( d->m_stats_interval > 0 )
   {
-    return priority;
-  }
-
-  std::map< track_id_t, kv::track_sptr > to_output;
-
-  for( auto track : priority->tracks() )
-  {
-    if( !track )
-    {
-      continue;
-    }
-
-    auto it = to_output.find( track->id() );
-
-    if( it == to_output.end() ||
-        track->last_frame() >= it->second->last_frame() )
+    if( d->m_received_complete )
     {
-      to_output[ track->id() ] = track;
+      d->report_stats( d->m_last_output.get_frame() );
+      return;
     }
-  }
 
-  for( auto track : secondary->tracks() )
-  {
-    if( !track )
-    {
-      continue;
-    }
+    const uint64_t step_usec = elapsed_usec( start );
 
-    auto it = to_output.find( track->id() );
+    d->m_step_count++;
+    d->m_step_usec += step_usec;
+    d->m_max_step_usec = std::max( d->m_max_step_usec, step_usec );
 
-    if( it == to_output.end() ||
-        track->last_frame() > it->second->last_frame() )
+    if( ++d->m_frames_since_report >= d->m_stats_interval )
     {
-      to_output[ track->id() ] = track;
+      d->report_stats( d->m_last_output.get_frame() );
     }
   }
-
-  std::vector< kv::track_sptr > track_vec;
-
-  for( auto elem : to_output )
-  {
-    track_vec.push_back( elem.second );
-  }
-
-  return kv::object_track_set_sptr( new kv::object_track_set( track_vec ) );
 }
 
 
 // -----------------------------------------------------------------------------
-void
-track_conductor_process
-::sync_step()
+kv::object_track_set_sptr
+track_conductor_process::priv
+::update_tracks( const kv::timestamp& timestamp,
+                 const tri_track_map_t& computed_tracks,
+                 const kv::frame_id_t frames[3] )
 {
-  wait_for_standard_inputs();
-
-  if( d->m_received_complete )
-  {
-    mark_process_as_complete();
-
-    const sprokit::datum_t dat = sprokit::datum::complete_datum();
-
-    push_datum_to_port_using_trait( image, dat );
-    push_datum_to_port_using_trait( timestamp, dat );
-    push_datum_to_port_using_trait( object_track_set, dat );
-
-    push_datum_to_port_using_trait( short_term_initializations, dat );
-    push_datum_to_port_using_trait( mid_term_initializations, dat );
-    push_datum_to_port_using_trait( long_term_initializations, dat );
-    return;
-  }
-
-  // Drive all connected tracks
-  const image_and_track_tuple_t& inputs = d->m_standard_inputs.back();
-
-  const kv::timestamp timestamp = std::get<0>( inputs );
-  const kv::image_container_sptr image = std::get<1>( inputs );
-
-  if( d->m_has_short_term_tracker )
-  {
-    auto sti = merge_init_signals( std::get<2>( inputs ), d->m_st_corrections );
-    push_to_port_using_trait( short_term_initializations, sti );
-  }
-  if( d->m_has_mid_term_tracker )
-  {
-    auto mti = merge_init_signals( std::get<2>( inputs ), d->m_mt_corrections );
-    push_to_port_using_trait( mid_term_initializations, mti );
-  }
-  if( d->m_has_long_term_tracker )
-  {
-    auto lti = merge_init_signals( std::get<2>( inputs ), d->m_lt_corrections );
-    push_to_port_using_trait( long_term_initializations, lti );
-  }
-
-  if( d->m_has_short_term_tracker )
-  {
-    wait_for_short_term_inputs();
-  }
-  if( d->m_has_mid_term_tracker )
-  {
-    wait_for_mid_term_inputs();
-  }
-  if( d->m_has_long_term_tracker )
-  {
-    wait_for_long_term_inputs();
-  }
-
-  // Generate aggregate tracks for current frame
-  struct tri_track_t
-  {
-    kv::track_sptr st;
-    kv::track_sptr mt;
-    kv::track_sptr lt;
-  };
-
-  std::map< track_id_t, tri_track_t > computed_tracks;
-
-  if( d->m_has_short_term_tracker )
-  {
-    for( auto track : d->m_short_term_tracks.back().second->tracks() )
-    {
-      computed_tracks[ track->id() ].st = track;
-    }
-  }
-  if( d->m_has_mid_term_tracker )
-  {
-    for( auto track : d->m_mid_term_tracks.back().second->tracks() )
-    {
-      computed_tracks[ track->id() ].mt = track;
-    }
-  }
-  if( d->m_has_long_term_tracker )
-  {
-    for( auto track : d->m_long_term_tracks.back().second->tracks() )
-    {
-      computed_tracks[ track->id() ].lt = track;
-    }
-  }
+  const kv::frame_id_t frame = timestamp.get_frame();
 
   // Perform filtering actions (corrections, restarts)
   std::vector< kv::track_sptr > st_corrections;
@@ -543,12 +801,12 @@ track_conductor_process
   std::vector< kv::track_sptr > lt_corrections;
 
   // - update existing tracks
-  for( auto track_it : d->m_active_tracks )
+  for( auto& track_it : m_active_tracks )
   {
     const track_id_t id = track_it.first;
 
     auto computed_itr = computed_tracks.find( id );
-    track_info_t& track_info = d->m_active_tracks[id];
+    track_info_t& track_info = track_it.second;
 
     const bool received_any = ( computed_itr != computed_tracks.end() );
 
@@ -556,11 +814,25 @@ track_conductor_process
       computed_itr->second : tri_track_t() );
 
     const bool has_st = ( received_any && computed.st &&
-      computed.st->last_frame() == timestamp.get_frame() );
+      computed.st->last_frame() == frames[0] );
     const bool has_mt = ( received_any && computed.mt &&
-      computed.mt->last_frame() == timestamp.get_frame() );
+      computed.mt->last_frame() == frames[1] );
     const bool has_lt = ( received_any && computed.lt &&
-      computed.lt->last_frame() == timestamp.get_frame() );
+      computed.lt->last_frame() == frames[2] );
+
+    // Only states of the output frame are added, so lagging trackers fall
+    // back on the short term state and otherwise only provide corrections
+    auto add_state = [&]( const kv::track_sptr& source )
+    {
+      if( source->last_frame() == frame )
+      {
+        track_info.states.push_back( source->back() );
+      }
+      else if( has_st && computed.st->last_frame() == frame )
+      {
+        track_info.states.push_back( computed.st->back() );
+      }
+    };
 
     // Update counter states to help with transitions
     track_info.frames_since_last[0] = ( has_st ?
@@ -586,50 +858,50 @@ track_conductor_process
     // Update track states for current frame
     if( has_st && has_mt && has_lt )
     {
-      track_info.states.push_back( computed.st->back() );
+      add_state( computed.st );
     }
     else if( has_mt && has_lt )
     {
-      track_info.states.push_back( computed.lt->back() );
+      add_state( computed.lt );
 
       st_corrections.push_back( computed.lt );
     }
     else if( has_mt && has_st )
     {
-      track_info.states.push_back( computed.st->back() );
+      add_state( computed.st );
     }
     else if( has_lt && has_st )
     {
-      track_info.states.push_back( computed.st->back() );
+      add_state( computed.st );
 
       st_corrections.push_back( computed.mt );
     }
     else if( has_lt )
     {
-      track_info.states.push_back( computed.mt->back() );
+      add_state( computed.lt );
 
       st_corrections.push_back( computed.lt );
     }
     else if( has_mt )
     {
-      track_info.states.push_back( computed.mt->back() );
+      add_state( computed.mt );
 
       st_corrections.push_back( computed.mt );
 
-      if( track_info.frames_since_last[2] > d->m_long_term_reinit_thresh )
+      if( track_info.frames_since_last[2] > m_long_term_reinit_thresh )
       {
         lt_corrections.push_back( computed.st );
       }
     }
     else if( has_st )
     {
-      track_info.states.push_back( computed.st->back() );
+      add_state( computed.st );
 
-      if( track_info.frames_since_last[1] > d->m_mid_term_reinit_thresh )
+      if( track_info.frames_since_last[1] > m_mid_term_reinit_thresh )
       {
         mt_corrections.push_back( computed.st );
       }
-      if( track_info.frames_since_last[2] > d->m_long_term_reinit_thresh )
+      if( track_info.frames_since_last[2] > m_long_term_reinit_thresh )
       {
         lt_corrections.push_back( computed.st );
       }
@@ -637,34 +909,35 @@ track_conductor_process
   }
 
   // - handle new tracks
-  for( auto tri_itr : computed_tracks )
+  for( const auto& tri_itr : computed_tracks )
   {
-    if( d->m_active_tracks.find( tri_itr.first ) == d->m_active_tracks.end() )
+    if( m_active_tracks.find( tri_itr.first ) == m_active_tracks.end() )
     {
+      const tri_track_t& computed = tri_itr.second;
       track_info_t new_track_info;
 
-      new_track_info.states.push_back ( tri_itr.second.st->back() ?
-        tri_itr.second.st->back() : tri_itr.second.mt->back() );
- 
+      new_track_info.states.push_back( computed.st ? computed.st->back() :
+        ( computed.mt ? computed.mt->back() : computed.lt->back() ) );
+
       new_track_info.status = ALL_TRACKING;
       std::fill( std::begin(new_track_info.frames_since_last),
                  std::end(new_track_info.frames_since_last), 0 );
 
-      d->m_active_tracks[ tri_itr.first ] = new_track_info;
+      m_active_tracks[ tri_itr.first ] = new_track_info;
     }
   }
 
-  d->m_st_corrections =
+  m_st_corrections =
     kv::object_track_set_sptr( new kv::object_track_set( st_corrections ) );
-  d->m_mt_corrections =
+  m_mt_corrections =
     kv::object_track_set_sptr( new kv::object_track_set( mt_corrections ) );
-  d->m_lt_corrections =
+  m_lt_corrections =
     kv::object_track_set_sptr( new kv::object_track_set( lt_corrections ) );
 
   // Send outputs to all downstream nodes
   std::vector< kv::track_sptr > ot;
 
-  for( auto it : d->m_active_tracks )
+  for( const auto& it : m_active_tracks )
   {
     ot.push_back( kv::track_sptr( kv::track::create() ) );
     ot.back()->set_id( it.first );
@@ -675,25 +948,120 @@ track_conductor_process
     }
   }
 
-  kv::object_track_set_sptr output( new kv::object_track_set( ot ) );
+  return kv::object_track_set_sptr( new kv::object_track_set( ot ) );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+track_conductor_process
+::sync_step()
+{
+  wait_for_standard_inputs();
+
+  if( d->m_received_complete )
+  {
+    mark_process_as_complete();
+
+    const sprokit::datum_t dat = sprokit::datum::complete_datum();
+
+    push_datum_to_port_using_trait( image, dat );
+    push_datum_to_port_using_trait( timestamp, dat );
+    push_datum_to_port_using_trait( object_track_set, dat );
+
+    push_datum_to_port_using_trait( short_term_initializations, dat );
+    push_datum_to_port_using_trait( mid_term_initializations, dat );
+    push_datum_to_port_using_trait( long_term_initializations, dat );
+    return;
+  }
+
+  // Drive all connected tracks
+  const image_and_track_tuple_t& inputs = d->m_standard_inputs.front();
+
+  const kv::timestamp timestamp = std::get<0>( inputs );
+  const kv::image_container_sptr image = std::get<1>( inputs );
+
+  if( d->m_has_short_term_tracker )
+  {
+    auto sti = d->m_st_inits.merge( std::get<2>( inputs ), d->m_st_corrections );
+    push_to_port_using_trait( short_term_initializations, sti );
+  }
+  if( d->m_has_mid_term_tracker )
+  {
+    auto mti = d->m_mt_inits.merge( std::get<2>( inputs ), d->m_mt_corrections );
+    push_to_port_using_trait( mid_term_initializations, mti );
+  }
+  if( d->m_has_long_term_tracker )
+  {
+    auto lti = d->m_lt_inits.merge( std::get<2>( inputs ), d->m_lt_corrections );
+    push_to_port_using_trait( long_term_initializations, lti );
+  }
+
+  if( d->m_has_short_term_tracker )
+  {
+    wait_for_short_term_inputs();
+  }
+  if( d->m_has_mid_term_tracker )
+  {
+    wait_for_mid_term_inputs();
+  }
+  if( d->m_has_long_term_tracker )
+  {
+    wait_for_long_term_inputs();
+  }
+
+  // Generate aggregate tracks for current frame
+  tri_track_map_t computed_tracks;
+
+  if( d->m_has_short_term_tracker )
+  {
+    for( auto track : d->m_short_term_tracks.front().second->tracks() )
+    {
+      computed_tracks[ track->id() ].st = track;
+    }
+  }
+  if( d->m_has_mid_term_tracker )
+  {
+    for( auto track : d->m_mid_term_tracks.front().second->tracks() )
+    {
+      computed_tracks[ track->id() ].mt = track;
+    }
+  }
+  if( d->m_has_long_term_tracker )
+  {
+    for( auto track : d->m_long_term_tracks.front().second->tracks() )
+    {
+      computed_tracks[ track->id() ].lt = track;
+    }
+  }
+
+  const kv::frame_id_t frames[3] = { timestamp.get_frame(),
+                                     timestamp.get_frame(),
+                                     timestamp.get_frame() };
+
+  kv::object_track_set_sptr output =
+    d->update_tracks( timestamp, computed_tracks, frames );
 
   push_to_port_using_trait( timestamp, timestamp );
   push_to_port_using_trait( image, image );
   push_to_port_using_trait( object_track_set, output );
 
-  d->m_standard_inputs.pop_back();
+  d->m_last_output = timestamp;
+
+  d->m_standard_memory.remove( std::get<3>( inputs ) );
+  d->m_standard_inputs.pop();
 
   if( d->m_has_short_term_tracker )
   {
-    d->m_short_term_tracks.pop_back();
+    d->m_short_term_tracks.pop();
   }
   if( d->m_has_mid_term_tracker )
   {
-    d->m_mid_term_tracks.pop_back();
+    d->m_mid_term_tracks.pop();
   }
   if( d->m_has_long_term_tracker )
   {
-    d->m_long_term_tracks.pop_back();
+    d->m_long_term_tracks.pop();
   }
 }
 
@@ -703,7 +1071,139 @@ void
 track_conductor_process
 ::async_step()
 {
-  throw std::runtime_error( "Asynchronous processing not implemented" );
+  wait_for_standard_inputs();
+
+  if( d->m_received_complete )
+  {
+    mark_process_as_complete();
+
+    const sprokit::datum_t dat = sprokit::datum::complete_datum();
+
+    push_datum_to_port_using_trait( image, dat );
+    push_datum_to_port_using_trait( timestamp, dat );
+    push_datum_to_port_using_trait( object_track_set, dat );
+
+    push_datum_to_port_using_trait( short_term_initializations, dat );
+    push_datum_to_port_using_trait( mid_term_initializations, dat );
+    push_datum_to_port_using_trait( long_term_initializations, dat );
+
+    // Trackers finish once they receive the completion of their inputs
+    d->join_threads();
+    return;
+  }
+
+  // Drive all connected tracks
+  const image_and_track_tuple_t inputs = std::move( d->m_standard_inputs.front() );
+  d->m_standard_inputs.pop();
+  d->m_standard_memory.remove( std::get<3>( inputs ) );
+
+  const kv::timestamp timestamp = std::get<0>( inputs );
+  const kv::image_container_sptr image = std::get<1>( inputs );
+  const kv::frame_id_t frame = timestamp.get_frame();
+
+  if( d->m_has_short_term_tracker )
+  {
+    auto sti = d->m_st_inits.merge( std::get<2>( inputs ), d->m_st_corrections );
+    push_to_port_using_trait( short_term_initializations, sti );
+  }
+  if( d->m_has_mid_term_tracker )
+  {
+    auto mti = d->m_mt_inits.merge( std::get<2>( inputs ), d->m_mt_corrections );
+    push_to_port_using_trait( mid_term_initializations, mti );
+  }
+  if( d->m_has_long_term_tracker )
+  {
+    auto lti = d->m_lt_inits.merge( std::get<2>( inputs ), d->m_lt_corrections );
+    push_to_port_using_trait( long_term_initializations, lti );
+  }
+
+  // Only wait on the fastest connected tracker, which is assumed to be the
+  // short term one, the others are folded in whenever their outputs arrive
+  track_buffer_t* primary_buffer = nullptr;
+  std::atomic< bool >* primary_complete = nullptr;
+
+  if( d->m_has_short_term_tracker )
+  {
+    primary_buffer = &d->m_short_term_tracks;
+    primary_complete = &d->m_short_term_complete;
+  }
+  else if( d->m_has_mid_term_tracker )
+  {
+    primary_buffer = &d->m_mid_term_tracks;
+    primary_complete = &d->m_mid_term_complete;
+  }
+  else if( d->m_has_long_term_tracker )
+  {
+    primary_buffer = &d->m_long_term_tracks;
+    primary_complete = &d->m_long_term_complete;
+  }
+
+  if( primary_buffer )
+  {
+    std::unique_lock< std::mutex > lock( d->update_mutex );
+
+    d->update_trigger.wait( lock, [&]()
+    {
+      return *primary_complete || ( !primary_buffer->empty() &&
+        primary_buffer->back().first.get_frame() >= frame );
+    } );
+  }
+
+  // Generate aggregate tracks from the latest output of each tracker
+  tri_track_map_t computed_tracks;
+  kv::frame_id_t frames[3] = { frame, frame, frame };
+
+  if( d->m_has_short_term_tracker )
+  {
+    d->take_outputs( d->m_short_term_tracks, d->m_short_term_latest, frame );
+
+    if( d->m_short_term_latest.second )
+    {
+      frames[0] = d->m_short_term_latest.first.get_frame();
+
+      for( auto track : d->m_short_term_latest.second->tracks() )
+      {
+        computed_tracks[ track->id() ].st = track;
+      }
+    }
+  }
+  if( d->m_has_mid_term_tracker )
+  {
+    d->take_outputs( d->m_mid_term_tracks, d->m_mid_term_latest, frame );
+
+    if( d->m_mid_term_latest.second )
+    {
+      frames[1] = d->m_mid_term_latest.first.get_frame();
+
+      for( auto track : d->m_mid_term_latest.second->tracks() )
+      {
+        computed_tracks[ track->id() ].mt = track;
+      }
+    }
+  }
+  if( d->m_has_long_term_tracker )
+  {
+    d->take_outputs( d->m_long_term_tracks, d->m_long_term_latest, frame );
+
+    if( d->m_long_term_latest.second )
+    {
+      frames[2] = d->m_long_term_latest.first.get_frame();
+
+      for( auto track : d->m_long_term_latest.second->tracks() )
+      {
+        computed_tracks[ track->id() ].lt = track;
+      }
+    }
+  }
+
+  kv::object_track_set_sptr output =
+    d->update_tracks( timestamp, computed_tracks, frames );
+
+  push_to_port_using_trait( timestamp, timestamp );
+  push_to_port_using_trait( image, image );
+  push_to_port_using_trait( object_track_set, output );
+
+  d->m_last_output = timestamp;
 }
 
 
@@ -0,0 +1,413 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "track_scoring.h"
+#include "linear_assignment.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace viame
+{
+
+namespace
+{
+
+const double invalid_cost = 1.0e6;
+
+// Dense indices of the track ids seen in a sequence
+class track_index
+{
+public:
+  size_t operator()( long long id )
+  {
+    auto it = m_indices.emplace( id, m_indices.size() );
+    return it.first->second;
+  }
+
+  size_t size() const { return m_indices.size(); }
+
+private:
+  std::unordered_map< long long, size_t > m_indices;
+};
+
+struct truth_track_state
+{
+  size_t present = 0;
+  size_t matched = 0;
+  bool ever_matched = false;
+  bool last_matched = false;
+  long long last_computed = -1;
+};
+
+// -----------------------------------------------------------------------------
+size_t
+find_root( std::vector< size_t >& parent, size_t i )
+{
+  while( parent[i] != i )
+  {
+    parent[i] = parent[ parent[i] ];
+    i = parent[i];
+  }
+  return i;
+}
+
+// -----------------------------------------------------------------------------
+// Maximum total co-occurrence under a one to one truth to computed mapping,
+// solved separately for each connected group of tracks
+size_t
+identity_true_positives(
+  std::unordered_map< unsigned long long, size_t > const& pair_counts,
+  size_t truth_count, size_t computed_count )
+{
+  std::vector< size_t > parent( truth_count + computed_count );
+  std::iota( parent.begin(), parent.end(), 0 );
+
+  for( auto const& pair : pair_counts )
+  {
+    const size_t t = pair.first >> 32;
+    const size_t c = truth_count + ( pair.first & 0xffffffffULL );
+    parent[ find_root( parent, t ) ] = find_root( parent, c );
+  }
+
+  struct group
+  {
+    std::vector< size_t > truth, computed;
+  };
+
+  std::unordered_map< size_t, group > groups;
+
+  for( size_t i = 0; i < parent.size(); ++i )
+  {
+    group& g = groups[ find_root( parent, i ) ];
+    ( i < truth_count ? g.truth : g.computed ).push_back( i );
+  }
+
+  size_t output = 0;
+
+  for( auto const& entry : groups )
+  {
+    group const& g = entry.second;
+
+    if( g.truth.empty() || g.computed.empty() )
+    {
+      continue;
+    }
+
+    const size_t rows = g.truth.size(), cols = g.computed.size();
+    std::vector< double > costs( rows * cols, 0.0 );
+
+    for( size_t r = 0; r < rows; ++r )
+    {
+      for( size_t c = 0; c < cols; ++c )
+      {
+        const unsigned long long key =
+          ( static_cast< unsigned long long >( g.truth[r] ) << 32 ) |
+          ( g.computed[c] - truth_count );
+        auto it = pair_counts.find( key );
+
+        if( it != pair_counts.end() )
+        {
+          costs[ r * cols + c ] = -static_cast< double >( it->second );
+        }
+      }
+    }
+
+    const std::vector< int > assignment =
+      core::solve_linear_assignment( costs, rows, cols );
+
+    for( size_t r = 0; r < rows; ++r )
+    {
+      if( assignment[r] >= 0 )
+      {
+        output += static_cast< size_t >( -costs[ r * cols + assignment[r] ] );
+      }
+    }
+  }
+
+  return output;
+}
+
+} // end anonymous namespace
+
+
+// -----------------------------------------------------------------------------
+void
+track_metrics
+::accumulate( track_metrics const& other )
+{
+  num_frames += other.num_frames;
+  num_objects += other.num_objects;
+  num_predictions += other.num_predictions;
+  num_matches += other.num_matches;
+  num_false_positives += other.num_false_positives;
+  num_misses += other.num_misses;
+  num_switches += other.num_switches;
+  num_fragmentations += other.num_fragmentations;
+  num_unique_objects += other.num_unique_objects;
+  mostly_tracked += other.mostly_tracked;
+  partially_tracked += other.partially_tracked;
+  mostly_lost += other.mostly_lost;
+  id_true_positives += other.id_true_positives;
+  total_distance += other.total_distance;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+track_metrics
+::finalize()
+{
+  auto ratio = []( double num, double den ){ return den > 0.0 ? num / den : 0.0; };
+
+  mota = 1.0 - ratio( num_misses + num_false_positives + num_switches,
+                      num_objects );
+  motp = ratio( total_distance, num_matches );
+  idp = ratio( id_true_positives, num_predictions );
+  idr = ratio( id_true_positives, num_objects );
+  idf1 = ratio( 2.0 * id_true_positives, num_predictions + num_objects );
+  recall = ratio( num_matches, num_objects );
+  precision = ratio( num_matches, num_matches + num_false_positives );
+}
+
+
+// -----------------------------------------------------------------------------
+track_metrics
+score_tracks( scoring_sequence const& sequence, double threshold,
+              track_scoring_options const& options )
+{
+  track_metrics output;
+
+  track_index truth_ids, computed_ids;
+  std::vector< truth_track_state > states;
+  std::unordered_map< unsigned long long, size_t > pair_counts;
+
+  std::vector< scoring_box const* > truth, computed;
+  std::vector< size_t > truth_idx, computed_idx;
+  std::vector< int > truth_match, computed_match;
+  std::vector< double > costs;
+
+  for( auto const& frame : sequence.frames )
+  {
+    truth.clear();
+    computed.clear();
+    truth_idx.clear();
+    computed_idx.clear();
+
+    for( auto const& box : frame.truth )
+    {
+      if( options.target_label < 0 || box.label == options.target_label )
+      {
+        truth.push_back( &box );
+        truth_idx.push_back( truth_ids( box.track_id ) );
+      }
+    }
+    for( auto const& box : frame.computed )
+    {
+      if( box.score >= threshold &&
+          ( options.target_label < 0 || box.label == options.target_label ) )
+      {
+        computed.push_back( &box );
+        computed_idx.push_back( computed_ids( box.track_id ) );
+      }
+    }
+
+    if( truth.empty() && computed.empty() )
+    {
+      continue;
+    }
+
+    output.num_frames++;
+    output.num_objects += truth.size();
+    output.num_predictions += computed.size();
+    states.resize( truth_ids.size() );
+
+    const size_t rows = truth.size(), cols = computed.size();
+    costs.assign( rows * cols, invalid_cost );
+
+    for( size_t r = 0; r < rows; ++r )
+    {
+      for( size_t c = 0; c < cols; ++c )
+      {
+        const double iou = scoring_iou( *truth[r], *computed[c] );
+
+        if( iou >= options.iou_threshold )
+        {
+          costs[ r * cols + c ] = 1.0 - iou;
+          pair_counts[ ( static_cast< unsigned long long >( truth_idx[r] ) << 32 ) |
+                       computed_idx[c] ]++;
+        }
+      }
+    }
+
+    truth_match.assign( rows, -1 );
+    computed_match.assign( cols, -1 );
+
+    // Keep correspondences of earlier frames which still overlap
+    for( size_t r = 0; r < rows; ++r )
+    {
+      const long long previous = states[ truth_idx[r] ].last_computed;
+
+      for( size_t c = 0; previous >= 0 && c < cols; ++c )
+      {
+        if( computed_match[c] < 0 &&
+            static_cast< long long >( computed_idx[c] ) == previous &&
+            costs[ r * cols + c ] < invalid_cost )
+        {
+          truth_match[r] = static_cast< int >( c );
+          computed_match[c] = static_cast< int >( r );
+          break;
+        }
+      }
+    }
+
+    // Assign the rest with minimum total distance
+    std::vector< size_t > free_rows, free_cols;
+
+    for( size_t r = 0; r < rows; ++r )
+    {
+      if( truth_match[r] < 0 )
+      {
+        free_rows.push_back( r );
+      }
+    }
+    for( size_t c = 0; c < cols; ++c )
+    {
+      if( computed_match[c] < 0 )
+      {
+        free_cols.push_back( c );
+      }
+    }
+
+    if( !free_rows.empty() && !free_cols.empty() )
+    {
+      std::vector< double > sub( free_rows.size() * free_cols.size() );
+
+      for( size_t i = 0; i < free_rows.size(); ++i )
+      {
+        for( size_t j = 0; j < free_cols.size(); ++j )
+        {
+          sub[ i * free_cols.size() + j ] =
+            costs[ free_rows[i] * cols + free_cols[j] ];
+        }
+      }
+
+      const std::vector< int > assignment = core::solve_linear_assignment(
+        sub, free_rows.size(), free_cols.size() );
+
+      for( size_t i = 0; i < free_rows.size(); ++i )
+      {
+        if( assignment[i] < 0 ||
+            sub[ i * free_cols.size() + assignment[i] ] >= invalid_cost )
+        {
+          continue;
+        }
+
+        const size_t r = free_rows[i], c = free_cols[ assignment[i] ];
+        const long long previous = states[ truth_idx[r] ].last_computed;
+
+        if( previous >= 0 &&
+            previous != static_cast< long long >( computed_idx[c] ) )
+        {
+          output.num_switches++;
+        }
+
+        truth_match[r] = static_cast< int >( c );
+        computed_match[c] = static_cast< int >( r );
+      }
+    }
+
+    for( size_t r = 0; r < rows; ++r )
+    {
+      truth_track_state& state = states[ truth_idx[r] ];
+      state.present++;
+
+      if( truth_match[r] < 0 )
+      {
+        output.num_misses++;
+        state.last_matched = false;
+        continue;
+      }
+
+      const size_t c = truth_match[r];
+
+      output.num_matches++;
+      output.total_distance += costs[ r * cols + c ];
+
+      if( state.ever_matched && !state.last_matched )
+      {
+        output.num_fragmentations++;
+      }
+
+      state.matched++;
+      state.ever_matched = true;
+      state.last_matched = true;
+      state.last_computed = computed_idx[c];
+    }
+
+    for( size_t c = 0; c < cols; ++c )
+    {
+      if( computed_match[c] < 0 )
+      {
+        output.num_false_positives++;
+      }
+    }
+  }
+
+  output.num_unique_objects = states.size();
+
+  for( auto const& state : states )
+  {
+    const double ratio = state.present ?
+      static_cast< double >( state.matched ) / state.present : 0.0;
+
+    if( ratio >= 0.8 )
+    {
+      output.mostly_tracked++;
+    }
+    else if( ratio < 0.2 )
+    {
+      output.mostly_lost++;
+    }
+    else
+    {
+      output.partially_tracked++;
+    }
+  }
+
+  output.id_true_positives = identity_true_positives(
+    pair_counts, truth_ids.size(), computed_ids.size() );
+
+  output.finalize();
+  return output;
+}
+
+} // end namespace
@@ -0,0 +1,106 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief CLEAR MOT and identity metrics for object tracks
+ */
+
+#ifndef VIAME_CORE_TRACK_SCORING_H
+#define VIAME_CORE_TRACK_SCORING_H
+
+#include <plugins/core/viame_core_export.h>
+#include <plugins/core/scoring_data.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+struct track_scoring_options
+{
+  /// Minimum overlap for a computed detection to match a truth detection
+  double iou_threshold = 0.5;
+
+  /// If not negative, only boxes with this label are scored
+  int target_label = -1;
+};
+
+/// Raw counts, which add up over sequences, and the metrics derived from them
+struct track_metrics
+{
+  size_t num_frames = 0;
+  size_t num_objects = 0;
+  size_t num_predictions = 0;
+  size_t num_matches = 0;
+  size_t num_false_positives = 0;
+  size_t num_misses = 0;
+  size_t num_switches = 0;
+  size_t num_fragmentations = 0;
+  size_t num_unique_objects = 0;
+  size_t mostly_tracked = 0;
+  size_t partially_tracked = 0;
+  size_t mostly_lost = 0;
+  size_t id_true_positives = 0;
+  double total_distance = 0.0;
+
+  double mota = 0.0;
+  double motp = 0.0;
+  double idf1 = 0.0;
+  double idp = 0.0;
+  double idr = 0.0;
+  double recall = 0.0;
+  double precision = 0.0;
+
+  /// Add the counts of other, call finalize() afterwards
+  void accumulate( track_metrics const& other );
+
+  /// Compute the ratios from the counts
+  void finalize();
+};
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Score computed tracks scoring at least threshold against truth
+ *
+ * Frames are matched as in py-motmetrics: correspondences from the previous
+ * frame are kept while they still overlap, and the remaining boxes are
+ * assigned with minimum total 1 - IoU. Identity metrics use the single
+ * truth to computed track mapping maximizing the matched frame count.
+ */
+VIAME_CORE_EXPORT track_metrics
+score_tracks( scoring_sequence const& sequence, double threshold,
+              track_scoring_options const& options );
+
+} // end namespace
+
+#endif // VIAME_CORE_TRACK_SCORING_H
@@ -2,9 +2,68 @@
 #include "tracks_pairing_from_stereo.h"
 #include "detections_pairing_from_stereo.h"
 
+#include <plugins/core/thread_pool.h>
+
+#include <algorithm>
+
+viame::core::FrameIntervals::FrameIntervals(std::initializer_list<kwiver::vital::frame_id_t> frame_ids) {
+  for (const auto frame_id: frame_ids)
+    emplace(frame_id);
+}
+
+void viame::core::FrameIntervals::emplace(kwiver::vital::frame_id_t frame_id) {
+  // Fast path for frames appended in increasing order
+  if (m_intervals.empty() || frame_id > m_intervals.back().second + 1) {
+    m_intervals.emplace_back(frame_id, frame_id);
+    m_size++;
+    return;
+  }
+
+  if (frame_id == m_intervals.back().second + 1) {
+    m_intervals.back().second = frame_id;
+    m_size++;
+    return;
+  }
+
+  // Find first interval ending after the frame preceding frame_id
+  auto it = std::lower_bound(m_intervals.begin(), m_intervals.end(), frame_id - 1,
+                             [](const Interval &interval, kwiver::vital::frame_id_t value) {
+                               return interval.second < value;
+                             });
+
+  if (it != m_intervals.end() && it->first <= frame_id && frame_id <= it->second)
+    return;
+
+  m_size++;
+  if (it != m_intervals.end() && it->second == frame_id - 1) {
+    // Extend interval and merge with next one if they become adjacent
+    it->second = frame_id;
+    auto next = std::next(it);
+    if (next != m_intervals.end() && next->first == frame_id + 1) {
+      it->second = next->second;
+      m_intervals.erase(next);
+    }
+  } else if (it != m_intervals.end() && it->first == frame_id + 1) {
+    it->first = frame_id;
+  } else {
+    m_intervals.insert(it, Interval{frame_id, frame_id});
+  }
+}
+
+bool viame::core::FrameIntervals::contains(kwiver::vital::frame_id_t frame_id) const {
+  auto it = std::lower_bound(m_intervals.begin(), m_intervals.end(), frame_id,
+                             [](const Interval &interval, kwiver::vital::frame_id_t value) {
+                               return interval.second < value;
+                             });
+  return it != m_intervals.end() && it->first <= frame_id;
+}
+
+
 viame::core::tracks_pairing_from_stereo::tracks_pairing_from_stereo()
     : m_detection_pairing(new detections_pairing_from_stereo()) {}
 
+viame::core::tracks_pairing_from_stereo::~tracks_pairing_from_stereo() = default;
+
 void viame::core::tracks_pairing_from_stereo::load_camera_calibration() {
   m_detection_pairing->m_cameras_directory = m_cameras_directory;
   m_detection_pairing->load_camera_calibration();
@@ -15,10 +74,13 @@ viame::core::tracks_pairing_from_stereo::update_left_tracks_3d_position(
     const std::vector<kwiver::vital::track_sptr> &tracks, const cv::Mat &cv_disparity_map,
     const kwiver::vital::timestamp &timestamp) {
   m_detection_pairing->m_verbose = m_verbose;
-  const auto cv_pos_3d_map = m_detection_pairing->reproject_3d_depth_map(cv_disparity_map);
+  m_detection_pairing->m_use_undistortion_lut = m_use_undistortion_lut;
+  const auto &cv_pos_3d_map = m_sparse_reprojection ? cv_disparity_map :
+                              m_detection_pairing->reproject_3d_depth_map_in_workspace(cv_disparity_map);
 
   std::vector<kwiver::vital::track_sptr> filtered_tracks;
-  std::vector<Detections3DPositions> tracks_positions;
+  std::vector<Detections3DPositions> tracks_positions(tracks.size());
+  std::vector<std::shared_ptr<kwiver::vital::object_track_state>> states(tracks.size());
 
   for (const auto &track: tracks) {
     // Check if a 3d track already exists with this id in order to update it
@@ -35,19 +97,53 @@ viame::core::tracks_pairing_from_stereo::update_left_tracks_3d_position(
     // Add 3D track to output
     filtered_tracks.push_back(tracks_3d);
 
-    // Skip 3d processing for tracks without current frame and associate empty position to avoid further pairing
+    // Skip 3d processing for tracks without current frame and keep empty position to avoid further pairing
     auto state = std::dynamic_pointer_cast<kwiver::vital::object_track_state>(track->back());
-    if ((track->last_frame() < timestamp.get_frame()) || !state) {
-      tracks_positions.emplace_back(Detections3DPositions{});
+    if ((track->last_frame() < timestamp.get_frame()) || !state)
       continue;
+
+    states[filtered_tracks.size() - 1] = state;
+  }
+
+  // Process 3D coordinates for frame matching the current depth image
+  const auto estimate_positions = [&](size_t i_begin, size_t i_end) {
+    for (size_t i_track = i_begin; i_track < i_end; i_track++) {
+      if (!states[i_track])
+        continue;
+
+      const auto &detection = states[i_track]->detection();
+      tracks_positions[i_track] = m_sparse_reprojection ?
+                                  m_detection_pairing->update_left_detection_3d_position_from_disparity(
+                                      detection, cv_disparity_map) :
+                                  m_detection_pairing->update_left_detection_3d_position(detection, cv_pos_3d_map);
     }
+  };
 
-    // Process 3D coordinates for frame matching the current depth image
-    auto position = m_detection_pairing->update_left_detection_3d_position(state->detection(), cv_pos_3d_map);
+  const auto worker_count = m_worker_count == 0 ? std::max(1u, std::thread::hardware_concurrency()) : m_worker_count;
+  if (worker_count > 1 && tracks.size() > 1) {
+    if (!m_workers || m_workers->size() != worker_count)
+      m_workers = std::make_shared<viame::thread_pool>(worker_count);
+
+    // Split tracks in contiguous chunks, each chunk writing to its own output positions
+    const auto chunk_size = (tracks.size() + worker_count - 1) / worker_count;
+    std::vector<std::future<void>> results;
+    for (size_t i_begin = 0; i_begin < tracks.size(); i_begin += chunk_size)
+      results.emplace_back(m_workers->enqueue(
+          [&, i_begin] { estimate_positions(i_begin, std::min(i_begin + chunk_size, tracks.size())); }));
+
+    // Wait for all the chunks before propagating errors as the tasks reference local buffers
+    for (auto &result: results)
+      result.wait();
+    for (auto &result: results)
+      result.get();
+  } else {
+    estimate_positions(0, tracks.size());
+  }
 
-    // Update state information to tracks 3D and push tracks to output
-    tracks_3d->append(state);
-    tracks_positions.emplace_back(position);
+  // Update state information to tracks 3D
+  for (size_t i_track = 0; i_track < filtered_tracks.size(); i_track++) {
+    if (states[i_track])
+      filtered_tracks[i_track]->append(states[i_track]);
   }
 
   // Sanity check on the filtered_tracks and track_position size
@@ -98,9 +194,10 @@ kwiver::vital::track_id_t viame::core::tracks_pairing_from_stereo::last_left_rig
   auto ids_left = get_map_ids(m_tracks_with_3d_left);
   auto ids_right = get_map_ids(m_right_tracks_memo);
   if (ids_left.empty() || ids_right.empty())
-    return ids_left.empty() ? ids_right.empty() ? 1 : *ids_right.rbegin() + 1 : *ids_left.rbegin() + 1;
+    return std::max(m_last_finalized_track_id, ids_left.empty() ? ids_right.empty() ? 1 : *ids_right.rbegin() + 1
+                                                                : *ids_left.rbegin() + 1);
 
-  return std::max(*ids_left.rbegin(), *ids_right.rbegin());
+  return std::max({m_last_finalized_track_id, *ids_left.rbegin(), *ids_right.rbegin()});
 }
 
 /// @brief Helper structure to store the most likely pair to a left track
@@ -110,6 +207,19 @@ struct MostLikelyPair {
 };
 
 
+/// @brief Creates a copy of the track referencing the original states instead of deep copying them
+///
+/// Output tracks only relabel their ids, the states and detections are not modified after pairing and can be shared
+/// with the memo tracks. This avoids duplicating every state, detection and mask of the video at the end of stream.
+static kwiver::vital::track_sptr share_track_states(const kwiver::vital::track_sptr &track) {
+  auto shared_track = kwiver::vital::track::create(track->data());
+  shared_track->set_id(track->id());
+  for (const auto &state: *track)
+    shared_track->append(state);
+  return shared_track;
+}
+
+
 std::tuple<std::vector<kwiver::vital::track_sptr>, std::vector<kwiver::vital::track_sptr>>
 viame::core::tracks_pairing_from_stereo::get_left_right_tracks_with_pairing() {
   std::vector<kwiver::vital::track_sptr> left_tracks, right_tracks;
@@ -126,7 +236,7 @@ viame::core::tracks_pairing_from_stereo::get_left_right_tracks_with_pairing() {
         continue;
 
       processed.emplace(pair.first);
-      vect.emplace_back(pair.second->clone());
+      vect.emplace_back(share_track_states(pair.second));
     }
   };
 
@@ -136,6 +246,89 @@ viame::core::tracks_pairing_from_stereo::get_left_right_tracks_with_pairing() {
   return {filter_tracks_with_threshold(left_tracks), filter_tracks_with_threshold(right_tracks)};
 }
 
+
+std::tuple<std::vector<kwiver::vital::track_sptr>, std::vector<kwiver::vital::track_sptr>>
+viame::core::tracks_pairing_from_stereo::finalize_inactive_tracks(const kwiver::vital::timestamp &timestamp) {
+  using track_map_t = std::map<kwiver::vital::track_id_t, kwiver::vital::track_sptr>;
+
+  const auto is_active = [&](const kwiver::vital::track_sptr &track) {
+    return !track->empty() && track->last_frame() + m_inactivity_frames_threshold > timestamp.get_frame();
+  };
+
+  const auto get_active_ids = [&](const track_map_t &tracks_map) {
+    std::set<kwiver::vital::track_id_t> active;
+    for (const auto &pair: tracks_map)
+      if (is_active(pair.second))
+        active.emplace(pair.first);
+    return active;
+  };
+
+  // Tracks paired with an active track are kept active until all their pairs are inactive
+  auto active_left = get_active_ids(m_tracks_with_3d_left);
+  auto active_right = get_active_ids(m_right_tracks_memo);
+  for (bool is_updated = true; is_updated;) {
+    is_updated = false;
+    for (const auto &pairing: m_left_to_right_pairing) {
+      const auto &id_pair = pairing.second.left_right_id_pair;
+      const bool is_left_active = active_left.find(id_pair.left_id) != std::end(active_left);
+      const bool is_right_active = active_right.find(id_pair.right_id) != std::end(active_right);
+      if (is_left_active == is_right_active)
+        continue;
+
+      active_left.emplace(id_pair.left_id);
+      active_right.emplace(id_pair.right_id);
+      is_updated = true;
+    }
+  }
+
+  // Move inactive tracks and pairings out of the memo
+  const auto extract_inactive = [](track_map_t &tracks_map, const std::set<kwiver::vital::track_id_t> &active) {
+    track_map_t inactive;
+    for (auto it = tracks_map.begin(); it != tracks_map.end();) {
+      if (active.find(it->first) == std::end(active)) {
+        inactive.emplace(*it);
+        it = tracks_map.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return inactive;
+  };
+
+  // New track ids need to stay unique with the tracks still in the memo
+  m_last_finalized_track_id = last_left_right_track_id();
+
+  auto inactive_left = extract_inactive(m_tracks_with_3d_left, active_left);
+  auto inactive_right = extract_inactive(m_right_tracks_memo, active_right);
+  std::map<size_t, Pairing> inactive_pairing;
+  for (auto it = m_left_to_right_pairing.begin(); it != m_left_to_right_pairing.end();) {
+    if (active_left.find(it->second.left_right_id_pair.left_id) == std::end(active_left)) {
+      inactive_pairing.emplace(it->first, std::move(it->second));
+      it = m_left_to_right_pairing.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  if (inactive_left.empty() && inactive_right.empty())
+    return {};
+
+  // Pair the inactive tracks using the same logic as the end of stream pairing
+  std::swap(inactive_left, m_tracks_with_3d_left);
+  std::swap(inactive_right, m_right_tracks_memo);
+  std::swap(inactive_pairing, m_left_to_right_pairing);
+  auto left_right_tracks = get_left_right_tracks_with_pairing();
+  std::swap(inactive_left, m_tracks_with_3d_left);
+  std::swap(inactive_right, m_right_tracks_memo);
+  std::swap(inactive_pairing, m_left_to_right_pairing);
+
+  for (const auto &tracks: {std::get<0>(left_right_tracks), std::get<1>(left_right_tracks)})
+    for (const auto &track: tracks)
+      m_last_finalized_track_id = std::max(m_last_finalized_track_id, track->id());
+
+  return left_right_tracks;
+}
+
 std::tuple<std::set<kwiver::vital::track_id_t>, std::set<kwiver::vital::track_id_t>>
 viame::core::tracks_pairing_from_stereo::select_most_likely_pairing(std::vector<kwiver::vital::track_sptr> &left_tracks,
                                                                     std::vector<kwiver::vital::track_sptr> &right_tracks) {
@@ -167,8 +360,8 @@ viame::core::tracks_pairing_from_stereo::select_most_likely_pairing(std::vector<
     proc_left.emplace(left_id);
     proc_right.emplace(right_id);
 
-    auto left_track = m_tracks_with_3d_left[left_id]->clone();
-    auto right_track = m_right_tracks_memo[right_id]->clone();
+    auto left_track = share_track_states(m_tracks_with_3d_left[left_id]);
+    auto right_track = share_track_states(m_right_tracks_memo[right_id]);
 
     // Update left right pairing in case the pairing id is different.
     // Otherwise, keep the track id
@@ -221,9 +414,14 @@ void viame::core::tracks_pairing_from_stereo::pair_left_right_tracks(
   m_detection_pairing->m_pairing_method = m_pairing_method;
   m_detection_pairing->m_iou_pair_threshold = m_iou_pair_threshold;
 
-  std::vector<kwiver::vital::track_sptr> filtered_left, filtered_right;
-  std::vector<kwiver::vital::detected_object_sptr> filtered_left_detections, filtered_right_detections;
-  std::vector<viame::core::Detections3DPositions> filtered_3d_pos;
+  auto &filtered_left = m_filtered_left, &filtered_right = m_filtered_right;
+  auto &filtered_left_detections = m_filtered_left_detections, &filtered_right_detections = m_filtered_right_detections;
+  auto &filtered_3d_pos = m_filtered_3d_pos;
+  filtered_left.clear();
+  filtered_right.clear();
+  filtered_left_detections.clear();
+  filtered_right_detections.clear();
+  filtered_3d_pos.clear();
 
   auto get_current_track_detection = [&timestamp](
       const kwiver::vital::track_sptr &track) -> kwiver::vital::detected_object_sptr {
@@ -261,7 +459,7 @@ void viame::core::tracks_pairing_from_stereo::pair_left_right_tracks(
 
   // Append detected frames to memo
   for (const auto &pairing: pairings) {
-    append_paired_frame(filtered_left[pairing[0]], filtered_right[pairing[1]], timestamp);
+    append_paired_frame(filtered_left[pairing.first], filtered_right[pairing.second], timestamp);
   }
 }
 
@@ -309,8 +507,8 @@ inline std::string to_string(const std::map<size_t, viame::core::Pairing> &left_
   ss << "PAIRINGS TO SPLIT : " << std::endl;
   for (const auto &pair: left_to_right_pairing) {
     std::string print_frames{"{"};
-    for (const auto &frame_id: pair.second.frame_set)
-      print_frames += "," + std::to_string(frame_id);
+    for (const auto &interval: pair.second.frame_set.intervals())
+      print_frames += ",[" + std::to_string(interval.first) + "," + std::to_string(interval.second) + "]";
     print_frames += "}";
 
     ss << "ID: " << pair.first << ", left: " << pair.second.left_right_id_pair.left_id << ", right: "
@@ -326,16 +524,16 @@ viame::core::tracks_pairing_from_stereo::create_split_ranges_from_track_pairs(
   if (m_verbose)
     std::cout << to_string(left_to_right_pairing) << std::endl;
 
-  // Find last pairing frame id from all saved pairings
+  // Find first and last pairing frame ids from all saved pairings
+  kwiver::vital::frame_id_t first_pairings_frame_id{std::numeric_limits<kwiver::vital::frame_id_t>::max()};
   kwiver::vital::frame_id_t last_pairings_frame_id{};
 
   for (const auto &pairing: left_to_right_pairing) {
     if (pairing.second.frame_set.empty())
       continue;
 
-    const auto pairing_frame_id = *(pairing.second.frame_set.rbegin());
-    if (pairing_frame_id > last_pairings_frame_id)
-      last_pairings_frame_id = pairing_frame_id;
+    first_pairings_frame_id = std::min(first_pairings_frame_id, pairing.second.frame_set.first());
+    last_pairings_frame_id = std::max(last_pairings_frame_id, pairing.second.frame_set.last());
   }
 
   // Init output ID as last unused track ID
@@ -426,11 +624,12 @@ viame::core::tracks_pairing_from_stereo::create_split_ranges_from_track_pairs(
 
 
   // For each frame
-  for (kwiver::vital::frame_id_t i_frame = 0; i_frame <= last_pairings_frame_id; i_frame++) {
+  for (auto i_frame = std::max<kwiver::vital::frame_id_t>(first_pairings_frame_id, 0);
+       i_frame <= last_pairings_frame_id; i_frame++) {
     // For each pairing
     for (const auto &pairing: left_to_right_pairing) {
       // If pairing not in current frame -> continue
-      if (pairing.second.frame_set.find(i_frame) == std::end(pairing.second.frame_set))
+      if (!pairing.second.frame_set.contains(i_frame))
         continue;
 
       if (open_ranges.find(pairing.first) != std::end(open_ranges)) {
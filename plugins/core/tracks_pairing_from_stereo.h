@@ -5,11 +5,19 @@
 #include <vital/types/object_track_set.h>
 #include <plugins/core/viame_core_export.h>
 
+#include <initializer_list>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
 namespace cv {
 class Mat;
 }
 
 namespace viame {
+class thread_pool;
+
 namespace core {
 
 class detections_pairing_from_stereo;
@@ -22,8 +30,41 @@ struct IdPair {
   kwiver::vital::track_id_t right_id;
 };
 
+/// @brief Sorted set of frame ids stored as run-length intervals
+/// Consecutive frames are merged in [first, last] intervals so that memory is proportional to the number of pairing
+/// interruptions instead of the number of paired frames.
+class VIAME_CORE_EXPORT FrameIntervals {
+public:
+  using Interval = std::pair<kwiver::vital::frame_id_t, kwiver::vital::frame_id_t>;
+
+  FrameIntervals() = default;
+  FrameIntervals(std::initializer_list<kwiver::vital::frame_id_t> frame_ids);
+
+  /// @brief Add frame to the set. Constant time when frames are added in increasing order.
+  void emplace(kwiver::vital::frame_id_t frame_id);
+
+  /// @brief Returns true if the input frame is in the set
+  bool contains(kwiver::vital::frame_id_t frame_id) const;
+
+  /// @brief Number of frames in the set
+  size_t size() const { return m_size; }
+
+  bool empty() const { return m_intervals.empty(); }
+
+  /// @brief First and last frames of the set. Set is expected to be non empty.
+  kwiver::vital::frame_id_t first() const { return m_intervals.front().first; }
+  kwiver::vital::frame_id_t last() const { return m_intervals.back().second; }
+
+  /// @brief Sorted disjoint and non adjacent inclusive intervals
+  const std::vector<Interval> &intervals() const { return m_intervals; }
+
+private:
+  std::vector<Interval> m_intervals;
+  size_t m_size{};
+};
+
 struct VIAME_CORE_EXPORT Pairing {
-  std::set<kwiver::vital::frame_id_t> frame_set;
+  FrameIntervals frame_set;
   IdPair left_right_id_pair;
 };
 
@@ -40,6 +81,7 @@ class VIAME_CORE_EXPORT tracks_pairing_from_stereo {
 public:
 
   tracks_pairing_from_stereo();
+  ~tracks_pairing_from_stereo();
 
   // Configuration settings
   std::string m_cameras_directory;
@@ -53,6 +95,10 @@ public:
   bool m_do_split_detections{false};
   std::string m_pairing_method{"PAIRING_3D"};
   bool m_verbose{}; // Set true to activate debug print
+  bool m_sparse_reprojection{}; // Set true to only reproject the disparity pixels used by each detection
+  bool m_use_undistortion_lut{}; // Set true to undistort mask pixels with a per pixel lookup table
+  kwiver::vital::frame_id_t m_inactivity_frames_threshold{0}; // Used by finalize_inactive_tracks
+  size_t m_worker_count{1}; // Number of threads used for the 3D position estimation. 0 uses all the cores.
 
   // Tracks status memo
   std::map<kwiver::vital::track_id_t, kwiver::vital::track_sptr> m_tracks_with_3d_left, m_right_tracks_memo;
@@ -60,11 +106,26 @@ public:
   // Track ID pairing
   std::map<size_t, Pairing> m_left_to_right_pairing;
 
+  // Largest track ID already used by finalized tracks. New track ids are created above this value.
+  kwiver::vital::track_id_t m_last_finalized_track_id{0};
+
+private:
+  // Workers used for the 3D position estimation, created on first use
+  std::shared_ptr<viame::thread_pool> m_workers;
+
+  // Buffers reused from one frame to the next by pair_left_right_tracks
+  std::vector<kwiver::vital::track_sptr> m_filtered_left, m_filtered_right;
+  std::vector<kwiver::vital::detected_object_sptr> m_filtered_left_detections, m_filtered_right_detections;
+  std::vector<viame::core::Detections3DPositions> m_filtered_3d_pos;
+
+public:
+
 
   /// @brief Load matrix calibration from settings camera directory
   void load_camera_calibration();
 
   /// @brief Update 3D tracks positions given a list of tracks and tracks disparity map
+  ///     The 3D positions are estimated on m_worker_count threads. Output order matches the input tracks order.
   std::tuple<std::vector<kwiver::vital::track_sptr>, std::vector<viame::core::Detections3DPositions>>
   update_left_tracks_3d_position(const std::vector<kwiver::vital::track_sptr> &tracks, const cv::Mat &cv_disparity_map,
                                  const kwiver::vital::timestamp &timestamp);
@@ -74,7 +135,7 @@ public:
   keep_right_tracks_in_current_frame(const std::vector<kwiver::vital::track_sptr> &tracks,
                                      const kwiver::vital::timestamp &timestamp);
 
-  /// @brief returns last track id available in both left and right track map
+  /// @brief returns last track id available in both left and right track map and in the finalized tracks
   kwiver::vital::track_id_t last_left_right_track_id() const;
 
   /// @brief Update left and right tracks pairs using the currently set pairing method.
@@ -89,6 +150,14 @@ public:
   std::tuple<std::vector<kwiver::vital::track_sptr>, std::vector<kwiver::vital::track_sptr>>
   get_left_right_tracks_with_pairing();
 
+  /// @brief Apply pairing to the tracks which have not been updated since m_inactivity_frames_threshold frames and
+  ///     remove them from the memo.
+  ///     Tracks are finalized together with all the tracks they have been paired with, only when all of them are
+  ///     inactive. Allows streaming the pairing results and keeping memory bounded on long sequences. Remaining tracks
+  ///     are returned by @ref get_left_right_tracks_with_pairing.
+  std::tuple<std::vector<kwiver::vital::track_sptr>, std::vector<kwiver::vital::track_sptr>>
+  finalize_inactive_tracks(const kwiver::vital::timestamp &timestamp);
+
   /// @brief Remove tracks in input list that don't match the min / max detection and min / max surface thresholds
   std::vector<kwiver::vital::track_sptr>
   filter_tracks_with_threshold(std::vector<kwiver::vital::track_sptr> tracks) const;
@@ -4,6 +4,7 @@
  */
 
 #include "tracks_pairing_from_stereo_process.h"
+#include "process_trace.h"
 #include "tracks_pairing_from_stereo.h"
 #include "detections_pairing_from_stereo.h"
 
@@ -26,7 +27,7 @@ namespace viame {
 namespace core {
 
 create_config_trait(cameras_directory, std::string, "", "The calibrated cameras files directory")
-create_config_trait(pairing_method, std::string, "PAIRING_3D", "One of PAIRING_3D, PAIRING_IOU, PAIRING_RECTIFIED_IOU")
+create_config_trait(pairing_method, std::string, "PAIRING_3D", "One of PAIRING_3D, PAIRING_3D_ASSIGNMENT, PAIRING_IOU, PAIRING_RECTIFIED_IOU")
 create_config_trait(min_detection_number_threshold, int, "0",
                     "Filters out tracks with less detections than this threshold.")
 create_config_trait(max_detection_number_threshold, int, "std::numeric_limits<int>::max()",
@@ -42,6 +43,19 @@ create_config_trait(do_split_detections, bool, "true",
 create_config_trait(detection_split_threshold, int, "3",
                     "Number of detections pairings required before split. Used when do_split_detections is set to true.")
 create_config_trait(verbose, bool, "false", "If true, will print debug information to the pipeline console.")
+create_config_trait(sparse_reprojection, bool, "false",
+                    "If true, only reproject to 3D the disparity pixels used by each detection instead of the full "
+                    "disparity map. Produces the same 3D positions with less memory traffic.")
+create_config_trait(undistortion_lut, bool, "false",
+                    "If true, undistort the mask pixels with a per pixel lookup table of the left camera, computed "
+                    "once per image size, instead of undistorting each mask point.")
+create_config_trait(worker_count, unsigned, "1",
+                    "Number of threads used to estimate the left tracks 3D positions. 0 uses all available cores.")
+create_config_trait(inactivity_frames_threshold, int, "0",
+                    "If positive, tracks which have not been updated for this number of frames are paired and pushed "
+                    "to the output as soon as all the tracks they have been paired with are inactive, instead of "
+                    "waiting for the end of the stream. Keeps memory bounded on long sequences. Should be larger than "
+                    "the upstream trackers termination delay.")
 
 create_port_trait(object_track_set1, object_track_set, "Set of object tracks1.")
 create_port_trait(object_track_set2, object_track_set, "Set of object tracks2.")
@@ -94,6 +108,10 @@ void tracks_pairing_from_stereo_process::make_config() {
   declare_config_using_trait(do_split_detections);
   declare_config_using_trait(detection_split_threshold);
   declare_config_using_trait(verbose);
+  declare_config_using_trait(sparse_reprojection);
+  declare_config_using_trait(undistortion_lut);
+  declare_config_using_trait(inactivity_frames_threshold);
+  declare_config_using_trait(worker_count);
 }
 
 // -----------------------------------------------------------------------------
@@ -108,17 +126,27 @@ void tracks_pairing_from_stereo_process::_configure() {
   d->m_do_split_detections = config_value_using_trait(do_split_detections);
   d->m_detection_split_threshold = config_value_using_trait(detection_split_threshold);
   d->m_verbose = config_value_using_trait(verbose);
+  d->m_sparse_reprojection = config_value_using_trait(sparse_reprojection);
+  d->m_use_undistortion_lut = config_value_using_trait(undistortion_lut);
+  d->m_inactivity_frames_threshold = config_value_using_trait(inactivity_frames_threshold);
+  d->m_worker_count = config_value_using_trait(worker_count);
   d->load_camera_calibration();
 }
 
 // -----------------------------------------------------------------------------
 void tracks_pairing_from_stereo_process::_step() {
+  process_step_trace trace(name());
+
   // Grab inputs from previous process
   kv::object_track_set_sptr input_tracks1 = grab_from_port_using_trait(object_track_set1);
   kv::object_track_set_sptr input_tracks2 = grab_from_port_using_trait(object_track_set2);
   kv::timestamp timestamp = grab_from_port_using_trait(timestamp);
   kv::image_container_sptr depth_map = grab_from_port_using_trait(depth_map);
 
+  trace.inputs_ready();
+  trace.count("left_tracks", input_tracks1->size());
+  trace.count("right_tracks", input_tracks2->size());
+
   // Split input disparity into left / right disparity maps
   cv::Mat cv_disparity_left = kwiver::arrows::ocv::image_container::vital_to_ocv(depth_map->get_image(),
                                                                                  kwiver::arrows::ocv::image_container::BGR_COLOR);
@@ -150,6 +178,14 @@ void tracks_pairing_from_stereo_process::_step() {
     push_datum_to_port_using_trait(timestamp, complete_dat);
     push_datum_to_port_using_trait(filtered_object_track_set1, complete_dat);
     push_datum_to_port_using_trait(filtered_object_track_set2, complete_dat);
+  } else if (d->m_inactivity_frames_threshold > 0) {
+    auto left_right_tracks = d->finalize_inactive_tracks(timestamp);
+    auto output1 = std::make_shared<kv::object_track_set>(std::get<0>(left_right_tracks));
+    auto output2 = std::make_shared<kv::object_track_set>(std::get<1>(left_right_tracks));
+
+    push_to_port_using_trait(timestamp, timestamp);
+    push_to_port_using_trait(filtered_object_track_set1, output1);
+    push_to_port_using_trait(filtered_object_track_set2, output2);
   } else {
     auto no_tracks = std::make_shared<kv::object_track_set>(std::vector<kv::track_sptr>{});
     push_to_port_using_trait(timestamp, timestamp);
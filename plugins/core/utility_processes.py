@@ -27,19 +27,19 @@
 # OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-from PIL import Image as pil_image
 from random import randint
 
 from kwiver.sprokit.processes.kwiver_process import KwiverProcess
 from kwiver.sprokit.pipeline import process
 
-from kwiver.vital.types import Image
 from kwiver.vital.types import ImageContainer
 from kwiver.vital.types import DetectedObject, DetectedObjectSet
 from kwiver.vital.types import ObjectTrackState, Track, ObjectTrackSet
 
 from kwiver.vital.util.VitalPIL import get_pil_image, from_pil
 
+from viame.arrows.core.image_arrays import as_array, from_array
+
 import numpy as np
 
 class blank_out_frames( KwiverProcess ):
@@ -71,16 +71,23 @@ class blank_out_frames( KwiverProcess ):
         in_img_c = self.grab_input_using_trait( 'image' )
         tracks = self.grab_input_using_trait( 'object_track_set' )
 
-        # Get python image from conatiner (just for show)
-        in_img = get_pil_image( in_img_c.image() ).convert( 'RGB' )
+        in_img = as_array( in_img_c, squeeze=False )
+        is_rgb = ( in_img.ndim == 3 and in_img.shape[2] == 3 and
+                   in_img.dtype == np.uint8 )
 
         if len( tracks.tracks() ) == 0:
           # Fill image
-          in_img = pil_image.new( mode='RGB', size=in_img.size,
-            color = ( randint( 0, 255 ), randint( 0, 255 ), randint( 0, 255 ) ) )
-
-        # push dummy image object (same as input) to output port
-        self.push_to_port_using_trait( 'image', ImageContainer( from_pil( in_img ) ) )
+          color = ( randint( 0, 255 ), randint( 0, 255 ), randint( 0, 255 ) )
+          out_img_c = from_array( np.full( ( in_img.shape[0], in_img.shape[1], 3 ),
+            color, dtype=np.uint8 ) )
+        elif is_rgb:
+          # Frames which are already RGB are passed on as is
+          out_img_c = in_img_c
+        else:
+          out_img_c = ImageContainer( from_pil(
+            get_pil_image( in_img_c.image() ).convert( 'RGB' ) ) )
+
+        self.push_to_port_using_trait( 'image', out_img_c )
 
         self._base_step()
 
@@ -110,7 +117,7 @@ class percentile_norm_npy_16_to_8bit( KwiverProcess ):
         # grab image container from port using traits
         img_c = self.grab_input_using_trait( 'image' )
 
-        img = img_c.image().asarray().astype( "uint16" )
+        img = np.asarray( as_array( img_c ), dtype=np.uint16 )
 
         mi = np.percentile( img, 1 )
         ma = np.percentile( img, 100 )
@@ -120,7 +127,7 @@ class percentile_norm_npy_16_to_8bit( KwiverProcess ):
         normalized = normalized * 255
         normalized[ normalized < 0 ] = 0
 
-        output = ImageContainer( Image( normalized.astype( "uint8" ) ) )
+        output = from_array( normalized.astype( "uint8" ) )
 
          # push dummy image object (same as input) to output port
         self.push_to_port_using_trait( 'image', output )
@@ -0,0 +1,555 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation of the viame_columnar binary table
+ */
+
+#include "viame_columnar_table.h"
+
+#include <vital/exceptions.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+namespace viame
+{
+
+namespace {
+
+const char columnar_magic[] = "VIAMECOL";
+const std::size_t columnar_magic_size = sizeof( columnar_magic ) - 1;
+const std::uint32_t columnar_version = 1;
+const std::size_t column_name_size = 16;
+
+// Column data to be written, as a name and raw bytes
+struct column_data
+{
+  const char* name;
+  const void* data;
+  std::uint64_t size;
+};
+
+template< typename T >
+column_data
+make_column( const char* name, std::vector< T > const& values )
+{
+  return { name, values.data(), values.size() * sizeof( T ) };
+}
+
+template< typename T >
+void write_binary( std::ofstream& out, const T& value )
+{
+  out.write( reinterpret_cast< const char* >( &value ), sizeof( T ) );
+}
+
+template< typename T >
+void read_binary( std::ifstream& in, T& value )
+{
+  in.read( reinterpret_cast< char* >( &value ), sizeof( T ) );
+}
+
+std::uint64_t
+align_offset( std::uint64_t offset )
+{
+  return ( offset + 7 ) & ~std::uint64_t( 7 );
+}
+
+// Range of the values of a row in a variable length column
+std::pair< std::uint64_t, std::uint64_t >
+row_range( std::vector< std::uint64_t > const& offsets, size_t row )
+{
+  return { offsets[ row ], offsets[ row + 1 ] };
+}
+
+} // end anonymous namespace
+
+
+// =============================================================================
+viame_columnar_table
+::viame_columnar_table()
+{
+  clear();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+viame_columnar_table
+::clear()
+{
+  m_track_id.clear();
+  m_frame_id.clear();
+  m_time_usec.clear();
+  m_source.clear();
+  m_bbox.clear();
+  m_confidence.clear();
+
+  m_class_offsets.assign( 1, 0 );
+  m_class_name.clear();
+  m_class_score.clear();
+  m_poly_offsets.assign( 1, 0 );
+  m_poly_coords.clear();
+  m_kp_offsets.assign( 1, 0 );
+  m_kp_name.clear();
+  m_kp_coords.clear();
+  m_note_offsets.assign( 1, 0 );
+  m_note_text.clear();
+
+  m_strings.clear();
+  m_string_ids.clear();
+  m_frame_index.clear();
+}
+
+
+// -----------------------------------------------------------------------------
+std::uint32_t
+viame_columnar_table
+::intern( std::string const& str )
+{
+  auto itr = m_string_ids.find( str );
+
+  if( itr != m_string_ids.end() )
+  {
+    return itr->second;
+  }
+
+  const std::uint32_t id = static_cast< std::uint32_t >( m_strings.size() );
+  m_strings.push_back( str );
+  m_string_ids.emplace( str, id );
+  return id;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+viame_columnar_table
+::add( std::int64_t track_id, std::int64_t frame_id, std::int64_t time_usec,
+       std::string const& source, kwiver::vital::detected_object const& det )
+{
+  const kwiver::vital::bounding_box_d bbox = det.bounding_box();
+
+  m_track_id.push_back( track_id );
+  m_frame_id.push_back( frame_id );
+  m_time_usec.push_back( time_usec );
+  m_source.push_back( intern( source ) );
+  m_bbox.insert( m_bbox.end(),
+    { bbox.min_x(), bbox.min_y(), bbox.max_x(), bbox.max_y() } );
+  m_confidence.push_back( det.confidence() );
+
+  if( det.type() )
+  {
+    for( auto const& name : det.type()->class_names() )
+    {
+      m_class_name.push_back( intern( name ) );
+      m_class_score.push_back( det.type()->score( name ) );
+    }
+  }
+  m_class_offsets.push_back( m_class_name.size() );
+
+  for( auto const& p : det.polygon() )
+  {
+    m_poly_coords.push_back( p[0] );
+    m_poly_coords.push_back( p[1] );
+  }
+  m_poly_offsets.push_back( m_poly_coords.size() / 2 );
+
+  for( auto const& kp : det.keypoints() )
+  {
+    m_kp_name.push_back( intern( kp.first ) );
+    m_kp_coords.push_back( kp.second.value()[0] );
+    m_kp_coords.push_back( kp.second.value()[1] );
+  }
+  m_kp_offsets.push_back( m_kp_name.size() );
+
+  for( auto const& note : det.notes() )
+  {
+    m_note_text.push_back( intern( note ) );
+  }
+  m_note_offsets.push_back( m_note_text.size() );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+viame_columnar_table
+::copy_row( viame_columnar_table const& other, size_t row )
+{
+  // String indices are kept, the strings table is shared with the source
+  m_track_id.push_back( other.m_track_id[ row ] );
+  m_frame_id.push_back( other.m_frame_id[ row ] );
+  m_time_usec.push_back( other.m_time_usec[ row ] );
+  m_source.push_back( other.m_source[ row ] );
+  m_bbox.insert( m_bbox.end(), other.m_bbox.begin() + 4 * row,
+                 other.m_bbox.begin() + 4 * row + 4 );
+  m_confidence.push_back( other.m_confidence[ row ] );
+
+  auto range = row_range( other.m_class_offsets, row );
+  m_class_name.insert( m_class_name.end(), other.m_class_name.begin() + range.first,
+                       other.m_class_name.begin() + range.second );
+  m_class_score.insert( m_class_score.end(), other.m_class_score.begin() + range.first,
+                        other.m_class_score.begin() + range.second );
+  m_class_offsets.push_back( m_class_name.size() );
+
+  range = row_range( other.m_poly_offsets, row );
+  m_poly_coords.insert( m_poly_coords.end(), other.m_poly_coords.begin() + 2 * range.first,
+                        other.m_poly_coords.begin() + 2 * range.second );
+  m_poly_offsets.push_back( m_poly_coords.size() / 2 );
+
+  range = row_range( other.m_kp_offsets, row );
+  m_kp_name.insert( m_kp_name.end(), other.m_kp_name.begin() + range.first,
+                    other.m_kp_name.begin() + range.second );
+  m_kp_coords.insert( m_kp_coords.end(), other.m_kp_coords.begin() + 2 * range.first,
+                      other.m_kp_coords.begin() + 2 * range.second );
+  m_kp_offsets.push_back( m_kp_name.size() );
+
+  range = row_range( other.m_note_offsets, row );
+  m_note_text.insert( m_note_text.end(), other.m_note_text.begin() + range.first,
+                      other.m_note_text.begin() + range.second );
+  m_note_offsets.push_back( m_note_text.size() );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+viame_columnar_table
+::write( std::string const& filename ) const
+{
+  // Sort rows by frame, keeping the insertion order within each frame
+  std::vector< size_t > order( size() );
+  std::iota( order.begin(), order.end(), size_t( 0 ) );
+  std::stable_sort( order.begin(), order.end(),
+    [this]( size_t lhs, size_t rhs )
+    {
+      return m_frame_id[ lhs ] < m_frame_id[ rhs ];
+    } );
+
+  viame_columnar_table sorted;
+  for( size_t row : order )
+  {
+    sorted.copy_row( *this, row );
+  }
+
+  std::vector< std::pair< std::int64_t, std::uint64_t > > frame_index;
+  for( size_t row = 0; row < sorted.size(); ++row )
+  {
+    if( row == 0 || sorted.m_frame_id[ row ] != sorted.m_frame_id[ row - 1 ] )
+    {
+      frame_index.emplace_back( sorted.m_frame_id[ row ], row );
+    }
+  }
+
+  std::vector< std::uint64_t > string_offsets( 1, 0 );
+  std::string string_data;
+  for( auto const& str : m_strings )
+  {
+    string_data += str;
+    string_offsets.push_back( string_data.size() );
+  }
+
+  const std::vector< column_data > columns =
+  {
+    make_column( "track_id", sorted.m_track_id ),
+    make_column( "frame_id", sorted.m_frame_id ),
+    make_column( "time_usec", sorted.m_time_usec ),
+    make_column( "source", sorted.m_source ),
+    make_column( "bbox", sorted.m_bbox ),
+    make_column( "confidence", sorted.m_confidence ),
+    make_column( "class_offsets", sorted.m_class_offsets ),
+    make_column( "class_name", sorted.m_class_name ),
+    make_column( "class_score", sorted.m_class_score ),
+    make_column( "poly_offsets", sorted.m_poly_offsets ),
+    make_column( "poly_coords", sorted.m_poly_coords ),
+    make_column( "kp_offsets", sorted.m_kp_offsets ),
+    make_column( "kp_name", sorted.m_kp_name ),
+    make_column( "kp_coords", sorted.m_kp_coords ),
+    make_column( "note_offsets", sorted.m_note_offsets ),
+    make_column( "note_text", sorted.m_note_text ),
+    make_column( "string_offsets", string_offsets ),
+    { "string_data", string_data.data(), string_data.size() },
+    make_column( "frame_index", frame_index ),
+  };
+
+  std::ofstream out( filename, std::ios::binary );
+  if( !out )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Unable to open columnar file for writing: " + filename );
+  }
+
+  out.write( columnar_magic, columnar_magic_size );
+  write_binary( out, columnar_version );
+  write_binary( out, static_cast< std::uint32_t >( columns.size() ) );
+  write_binary( out, static_cast< std::uint64_t >( sorted.size() ) );
+
+  // Column data starts after the fixed header and the column directory
+  const std::uint64_t data_start = columnar_magic_size +
+    2 * sizeof( std::uint32_t ) + sizeof( std::uint64_t ) +
+    columns.size() * ( column_name_size + 2 * sizeof( std::uint64_t ) );
+
+  std::uint64_t offset = data_start;
+
+  for( auto const& column : columns )
+  {
+    char name[ column_name_size ] = {};
+    std::strncpy( name, column.name, column_name_size );
+    out.write( name, column_name_size );
+
+    offset = align_offset( offset );
+    write_binary( out, offset );
+    write_binary( out, column.size );
+    offset += column.size;
+  }
+
+  static const char padding[ 8 ] = {};
+  std::uint64_t position = data_start;
+
+  for( auto const& column : columns )
+  {
+    out.write( padding, align_offset( position ) - position );
+    out.write( static_cast< const char* >( column.data ), column.size );
+    position = align_offset( position ) + column.size;
+  }
+
+  if( !out )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Failed to write columnar file: " + filename );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+viame_columnar_table
+::read( std::string const& filename, unsigned groups )
+{
+  clear();
+
+  std::ifstream in( filename, std::ios::binary );
+  char magic[ columnar_magic_size ];
+
+  if( !in || !in.read( magic, columnar_magic_size ) ||
+      std::memcmp( magic, columnar_magic, columnar_magic_size ) != 0 )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Not a viame_columnar file: " + filename );
+  }
+
+  std::uint32_t version = 0, column_count = 0;
+  std::uint64_t rows = 0;
+  read_binary( in, version );
+  read_binary( in, column_count );
+  read_binary( in, rows );
+
+  if( !in || version != columnar_version )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Unsupported viame_columnar version in: " + filename );
+  }
+
+  std::unordered_map< std::string, std::pair< std::uint64_t, std::uint64_t > > directory;
+  for( std::uint32_t i = 0; in && i < column_count; ++i )
+  {
+    char name[ column_name_size + 1 ] = {};
+    std::uint64_t offset = 0, size = 0;
+    in.read( name, column_name_size );
+    read_binary( in, offset );
+    read_binary( in, size );
+    directory[ name ] = { offset, size };
+  }
+
+  // Seek to and read a single column, checking its length when known
+  auto load = [&]( const char* name, auto& values, std::uint64_t expected_count )
+  {
+    typedef typename std::decay< decltype( values[0] ) >::type value_t;
+
+    auto itr = directory.find( name );
+    if( itr == directory.end() || itr->second.second % sizeof( value_t ) != 0 ||
+        ( expected_count > 0 && itr->second.second != expected_count * sizeof( value_t ) ) )
+    {
+      VITAL_THROW( kwiver::vital::invalid_data,
+                   std::string( "Missing or invalid column " ) + name + " in: " + filename );
+    }
+
+    values.resize( itr->second.second / sizeof( value_t ) );
+    in.seekg( itr->second.first );
+    in.read( reinterpret_cast< char* >( values.data() ), itr->second.second );
+
+    if( !in )
+    {
+      VITAL_THROW( kwiver::vital::invalid_data,
+                   std::string( "Truncated column " ) + name + " in: " + filename );
+    }
+  };
+
+  // Skipped groups keep empty ranges for every row
+  auto load_offsets = [&]( const char* name, std::vector< std::uint64_t >& offsets,
+                           unsigned group )
+  {
+    if( groups & group )
+    {
+      load( name, offsets, rows + 1 );
+    }
+    else
+    {
+      offsets.assign( rows + 1, 0 );
+    }
+  };
+
+  load( "track_id", m_track_id, rows );
+  load( "frame_id", m_frame_id, rows );
+  load( "time_usec", m_time_usec, rows );
+  load( "source", m_source, rows );
+  load( "bbox", m_bbox, 4 * rows );
+  load( "confidence", m_confidence, rows );
+
+  load_offsets( "class_offsets", m_class_offsets, CLASSES );
+  load_offsets( "poly_offsets", m_poly_offsets, POLYGONS );
+  load_offsets( "kp_offsets", m_kp_offsets, KEYPOINTS );
+  load_offsets( "note_offsets", m_note_offsets, NOTES );
+
+  if( groups & CLASSES )
+  {
+    load( "class_name", m_class_name, m_class_offsets.back() );
+    load( "class_score", m_class_score, m_class_offsets.back() );
+  }
+  if( groups & POLYGONS )
+  {
+    load( "poly_coords", m_poly_coords, 2 * m_poly_offsets.back() );
+  }
+  if( groups & KEYPOINTS )
+  {
+    load( "kp_name", m_kp_name, m_kp_offsets.back() );
+    load( "kp_coords", m_kp_coords, 2 * m_kp_offsets.back() );
+  }
+  if( groups & NOTES )
+  {
+    load( "note_text", m_note_text, m_note_offsets.back() );
+  }
+
+  std::vector< std::uint64_t > string_offsets;
+  std::vector< char > string_data;
+  load( "string_offsets", string_offsets, 0 );
+  load( "string_data", string_data, 0 );
+
+  if( string_offsets.empty() || string_offsets.back() > string_data.size() )
+  {
+    VITAL_THROW( kwiver::vital::invalid_data,
+                 "Invalid string table in: " + filename );
+  }
+
+  for( size_t i = 0; i + 1 < string_offsets.size(); ++i )
+  {
+    m_strings.emplace_back( string_data.data() + string_offsets[ i ],
+                            string_offsets[ i + 1 ] - string_offsets[ i ] );
+  }
+
+  load( "frame_index", m_frame_index, 0 );
+
+  // Every string index must refer to the string table
+  auto check_strings = [&]( std::vector< std::uint32_t > const& ids )
+  {
+    for( auto id : ids )
+    {
+      if( id >= m_strings.size() )
+      {
+        VITAL_THROW( kwiver::vital::invalid_data,
+                     "Invalid string index in: " + filename );
+      }
+    }
+  };
+
+  check_strings( m_source );
+  check_strings( m_class_name );
+  check_strings( m_kp_name );
+  check_strings( m_note_text );
+}
+
+
+// -----------------------------------------------------------------------------
+kwiver::vital::detected_object_sptr
+viame_columnar_table
+::detection( size_t row ) const
+{
+  const kwiver::vital::bounding_box_d bbox(
+    m_bbox[ 4 * row ], m_bbox[ 4 * row + 1 ],
+    m_bbox[ 4 * row + 2 ], m_bbox[ 4 * row + 3 ] );
+
+  kwiver::vital::detected_object_sptr det;
+  auto range = row_range( m_class_offsets, row );
+
+  if( range.first < range.second )
+  {
+    std::vector< std::string > names;
+    std::vector< double > scores;
+
+    for( auto i = range.first; i < range.second; ++i )
+    {
+      names.push_back( m_strings[ m_class_name[ i ] ] );
+      scores.push_back( m_class_score[ i ] );
+    }
+
+    det = std::make_shared< kwiver::vital::detected_object >( bbox, m_confidence[ row ],
+      std::make_shared< kwiver::vital::detected_object_type >( names, scores ) );
+  }
+  else
+  {
+    det = std::make_shared< kwiver::vital::detected_object >( bbox, m_confidence[ row ] );
+  }
+
+  range = row_range( m_poly_offsets, row );
+  if( range.first < range.second )
+  {
+    det->set_flattened_polygon( std::vector< double >(
+      m_poly_coords.begin() + 2 * range.first,
+      m_poly_coords.begin() + 2 * range.second ) );
+  }
+
+  range = row_range( m_kp_offsets, row );
+  for( auto i = range.first; i < range.second; ++i )
+  {
+    det->add_keypoint( m_strings[ m_kp_name[ i ] ],
+      kwiver::vital::point_2d( m_kp_coords[ 2 * i ], m_kp_coords[ 2 * i + 1 ] ) );
+  }
+
+  range = row_range( m_note_offsets, row );
+  for( auto i = range.first; i < range.second; ++i )
+  {
+    det->add_note( m_strings[ m_note_text[ i ] ] );
+  }
+
+  return det;
+}
+
+} // end namespace
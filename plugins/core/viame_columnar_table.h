@@ -0,0 +1,161 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Columnar binary storage of detections and track states
+ *
+ * File layout, with all values in native (little endian) byte order:
+ *
+ *   char[8]   magic "VIAMECOL"
+ *   uint32    format version, currently 1
+ *   uint32    number of columns
+ *   uint64    number of rows, one per detection or track state
+ *   columns   directory, for each column:
+ *     char[16]  column name, zero padded
+ *     uint64    byte offset of the column data from the file start
+ *     uint64    byte size of the column data
+ *   data      column contents, each starting on an 8 byte boundary
+ *
+ * Per row columns are "track_id", "frame_id", "time_usec" (int64), "source"
+ * (uint32 string index), "bbox" (4 doubles : min x, min y, max x, max y) and
+ * "confidence" (double). Variable length fields use an "*_offsets" column of
+ * row count + 1 uint64 values, delimiting the entries of each row in their
+ * value columns :
+ *
+ *   class_offsets   class_name (uint32 string index), class_score (double)
+ *   poly_offsets    poly_coords (2 doubles per vertex)
+ *   kp_offsets      kp_name (uint32 string index), kp_coords (2 doubles)
+ *   note_offsets    note_text (uint32 string index)
+ *
+ * Strings are stored once, as "string_offsets" (uint64, count + 1) into the
+ * characters of "string_data". Rows are sorted by frame, and "frame_index"
+ * holds an (int64 frame id, uint64 first row) pair for every frame.
+ */
+
+#ifndef VIAME_CORE_VIAME_COLUMNAR_TABLE_H
+#define VIAME_CORE_VIAME_COLUMNAR_TABLE_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/types/detected_object.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace viame
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief In-memory columns of a viame_columnar file
+ */
+class VIAME_CORE_EXPORT viame_columnar_table
+{
+public:
+  /// Optional groups of columns, so readers only load what they need
+  enum column_group
+  {
+    CLASSES   = 0x1,
+    POLYGONS  = 0x2,
+    KEYPOINTS = 0x4,
+    NOTES     = 0x8,
+    ALL_GROUPS = CLASSES | POLYGONS | KEYPOINTS | NOTES
+  };
+
+  viame_columnar_table();
+
+  /// Remove all rows
+  void clear();
+
+  /// Number of rows
+  size_t size() const { return m_track_id.size(); }
+
+  /// Append a detection or track state
+  void add( std::int64_t track_id, std::int64_t frame_id, std::int64_t time_usec,
+            std::string const& source, kwiver::vital::detected_object const& det );
+
+  /// Write all rows sorted by frame, throws on I/O errors
+  void write( std::string const& filename ) const;
+
+  /// Replace the contents with a file, only loading the given column groups
+  void read( std::string const& filename, unsigned groups = ALL_GROUPS );
+
+  std::int64_t track_id( size_t row ) const { return m_track_id[ row ]; }
+  std::int64_t frame_id( size_t row ) const { return m_frame_id[ row ]; }
+  std::int64_t time_usec( size_t row ) const { return m_time_usec[ row ]; }
+  std::string const& source( size_t row ) const { return m_strings[ m_source[ row ] ]; }
+
+  /// Detection of a row, built from the loaded columns
+  kwiver::vital::detected_object_sptr detection( size_t row ) const;
+
+  /// First row of every frame, valid after read() where rows are frame sorted
+  std::vector< std::pair< std::int64_t, std::uint64_t > > const& frame_index() const
+  {
+    return m_frame_index;
+  }
+
+private:
+  std::uint32_t intern( std::string const& str );
+  void copy_row( viame_columnar_table const& other, size_t row );
+
+  std::vector< std::int64_t > m_track_id;
+  std::vector< std::int64_t > m_frame_id;
+  std::vector< std::int64_t > m_time_usec;
+  std::vector< std::uint32_t > m_source;
+  std::vector< double > m_bbox;
+  std::vector< double > m_confidence;
+
+  std::vector< std::uint64_t > m_class_offsets;
+  std::vector< std::uint32_t > m_class_name;
+  std::vector< double > m_class_score;
+
+  std::vector< std::uint64_t > m_poly_offsets;
+  std::vector< double > m_poly_coords;
+
+  std::vector< std::uint64_t > m_kp_offsets;
+  std::vector< std::uint32_t > m_kp_name;
+  std::vector< double > m_kp_coords;
+
+  std::vector< std::uint64_t > m_note_offsets;
+  std::vector< std::uint32_t > m_note_text;
+
+  std::vector< std::string > m_strings;
+  std::unordered_map< std::string, std::uint32_t > m_string_ids;
+
+  std::vector< std::pair< std::int64_t, std::uint64_t > > m_frame_index;
+};
+
+} // end namespace
+
+#endif // VIAME_CORE_VIAME_COLUMNAR_TABLE_H
@@ -0,0 +1,276 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Implementation for write_detected_object_set_viame_coco
+ */
+
+#include "write_detected_object_set_viame_coco.h"
+#include "json_stream.h"
+
+#include <vital/exceptions.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <vector>
+
+namespace viame {
+
+// --------------------------------------------------------------------------------
+class write_detected_object_set_viame_coco::priv
+{
+public:
+  priv()
+    : m_image_count( 0 )
+    , m_annotation_count( 0 )
+    , m_pending( false )
+  {}
+
+  ~priv() {}
+
+  // Close the images array, append the spooled annotations and categories
+  void finish( std::ostream& out );
+
+  std::string m_filename;
+  std::string m_spool_filename;
+  std::ofstream m_spool;
+
+  std::int64_t m_image_count;
+  std::int64_t m_annotation_count;
+  bool m_pending;
+
+  // Category IDs in order of first use
+  std::map< std::string, std::int64_t > m_category_ids;
+  std::vector< std::string > m_category_names;
+};
+
+
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_coco::priv
+::finish( std::ostream& out )
+{
+  m_pending = false;
+  m_spool.close();
+
+  out << "\n],\n\"annotations\": [";
+
+  std::ifstream spool( m_spool_filename, std::ios::binary );
+
+  if( spool && spool.peek() != std::ifstream::traits_type::eof() )
+  {
+    out << spool.rdbuf();
+  }
+
+  spool.close();
+  std::remove( m_spool_filename.c_str() );
+
+  out << "\n],\n\"categories\": [";
+
+  for( size_t i = 0; i < m_category_names.size(); ++i )
+  {
+    out << ( i == 0 ? "\n" : ",\n" ) << "{\"id\": " << ( i + 1 ) << ", \"name\": ";
+    write_json_string( out, m_category_names[i] );
+    out << "}";
+  }
+
+  out << "\n]\n}\n";
+  out.flush();
+
+  if( !out )
+  {
+    VITAL_THROW( kwiver::vital::file_write_exception, m_filename,
+                 "Unable to write COCO output" );
+  }
+}
+
+
+// ================================================================================
+write_detected_object_set_viame_coco
+::write_detected_object_set_viame_coco()
+  : d( new write_detected_object_set_viame_coco::priv() )
+{
+  attach_logger( "viame.core.write_detected_object_set_viame_coco" );
+}
+
+
+write_detected_object_set_viame_coco
+::~write_detected_object_set_viame_coco()
+{
+  // Output was not closed, complete the document without throwing
+  if( d->m_pending )
+  {
+    try
+    {
+      d->finish( stream() );
+    }
+    catch( std::exception const& e )
+    {
+      LOG_ERROR( logger(), e.what() );
+    }
+  }
+}
+
+
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_coco
+::open( std::string const& filename )
+{
+  kwiver::vital::algo::detected_object_set_output::open( filename );
+
+  d->m_filename = filename;
+  d->m_spool_filename = filename + ".annotations.tmp";
+  d->m_spool.open( d->m_spool_filename, std::ios::binary | std::ios::trunc );
+
+  if( !d->m_spool )
+  {
+    VITAL_THROW( kwiver::vital::file_write_exception, d->m_spool_filename,
+                 "Unable to open annotation spool file" );
+  }
+
+  d->m_spool.precision( 10 );
+  stream().precision( 10 );
+
+  d->m_image_count = 0;
+  d->m_annotation_count = 0;
+  d->m_category_ids.clear();
+  d->m_category_names.clear();
+  d->m_pending = true;
+
+  stream() << "{\n\"images\": [";
+}
+
+
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_coco
+::close()
+{
+  if( d->m_pending )
+  {
+    d->finish( stream() );
+  }
+
+  kwiver::vital::algo::detected_object_set_output::close();
+}
+
+
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_coco
+::set_configuration( kwiver::vital::config_block_sptr config )
+{
+}
+
+
+// --------------------------------------------------------------------------------
+bool
+write_detected_object_set_viame_coco
+::check_configuration( kwiver::vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_coco
+::write_set( const kwiver::vital::detected_object_set_sptr set,
+             std::string const& image_name )
+{
+  const std::int64_t image_id = ++d->m_image_count;
+
+  std::ostream& out = stream();
+
+  out << ( image_id == 1 ? "\n" : ",\n" ) << "{\"id\": " << image_id
+      << ", \"file_name\": ";
+  write_json_string( out, image_name );
+  out << "}";
+
+  if( !set )
+  {
+    return;
+  }
+
+  std::ostream& ann = d->m_spool;
+
+  for( auto det = set->cbegin(); det != set->cend(); ++det )
+  {
+    const kwiver::vital::bounding_box_d bbox = (*det)->bounding_box();
+
+    // Detections without class scores are written as unknown
+    std::string category = "unknown";
+    const auto dot = (*det)->type();
+
+    if( dot && dot->size() > 0 )
+    {
+      dot->get_most_likely( category );
+    }
+
+    auto cat_itr = d->m_category_ids.find( category );
+
+    if( cat_itr == d->m_category_ids.end() )
+    {
+      d->m_category_names.push_back( category );
+      cat_itr = d->m_category_ids.emplace(
+        category, static_cast< std::int64_t >( d->m_category_names.size() ) ).first;
+    }
+
+    ann << ( d->m_annotation_count == 0 ? "\n" : ",\n" )
+        << "{\"id\": " << ++d->m_annotation_count
+        << ", \"image_id\": " << image_id
+        << ", \"category_id\": " << cat_itr->second
+        << ", \"bbox\": [" << bbox.min_x() << ", " << bbox.min_y() << ", "
+        << bbox.width() << ", " << bbox.height() << "]"
+        << ", \"area\": " << bbox.area()
+        << ", \"iscrowd\": 0"
+        << ", \"score\": " << (*det)->confidence();
+
+    const auto& poly = (*det)->polygon();
+
+    if( !poly.empty() )
+    {
+      ann << ", \"segmentation\": [[";
+
+      for( size_t i = 0; i < poly.size(); ++i )
+      {
+        ann << ( i == 0 ? "" : ", " ) << poly[i][0] << ", " << poly[i][1];
+      }
+
+      ann << "]]";
+    }
+
+    ann << "}";
+  }
+}
+
+} // end namespace
@@ -0,0 +1,156 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation for write_detected_object_set_viame_columnar
+ */
+
+#include "write_detected_object_set_viame_columnar.h"
+#include "viame_columnar_table.h"
+
+namespace viame {
+
+// --------------------------------------------------------------------------------
+class write_detected_object_set_viame_columnar::priv
+{
+public:
+  priv()
+    : m_frame_number( 0 )
+    , m_detection_id( 0 )
+    , m_pending( false )
+  {}
+
+  ~priv() {}
+
+  std::string m_filename;
+  int m_frame_number;
+  std::int64_t m_detection_id;
+  bool m_pending;
+
+  viame_columnar_table m_table;
+};
+
+
+// ================================================================================
+write_detected_object_set_viame_columnar
+::write_detected_object_set_viame_columnar()
+  : d( new write_detected_object_set_viame_columnar::priv() )
+{
+  attach_logger( "viame.core.write_detected_object_set_viame_columnar" );
+}
+
+
+write_detected_object_set_viame_columnar
+::~write_detected_object_set_viame_columnar()
+{
+  // Output was not closed, write what was received without throwing
+  if( d->m_pending )
+  {
+    try
+    {
+      d->m_table.write( d->m_filename );
+    }
+    catch( std::exception const& e )
+    {
+      LOG_ERROR( logger(), e.what() );
+    }
+  }
+}
+
+
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_columnar
+::open( std::string const& filename )
+{
+  kwiver::vital::algo::detected_object_set_output::open( filename );
+
+  d->m_filename = filename;
+  d->m_frame_number = 0;
+  d->m_table.clear();
+  d->m_pending = true;
+}
+
+
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_columnar
+::close()
+{
+  // Columns can only be written once all rows are known
+  kwiver::vital::algo::detected_object_set_output::close();
+
+  if( d->m_pending )
+  {
+    d->m_table.write( d->m_filename );
+    d->m_pending = false;
+  }
+}
+
+
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_columnar
+::set_configuration( kwiver::vital::config_block_sptr config )
+{
+}
+
+
+// --------------------------------------------------------------------------------
+bool
+write_detected_object_set_viame_columnar
+::check_configuration( kwiver::vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_columnar
+::write_set( const kwiver::vital::detected_object_set_sptr set,
+             std::string const& image_name )
+{
+  if( set )
+  {
+    for( auto det = set->cbegin(); det != set->cend(); ++det )
+    {
+      // Detections have no timestamp, the frame number is used instead
+      d->m_table.add( d->m_detection_id++, d->m_frame_number,
+                      d->m_frame_number, image_name, **det );
+    }
+  }
+
+  // Put each set on a new frame
+  ++d->m_frame_number;
+}
+
+} // end namespace
@@ -0,0 +1,79 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Interface for write_detected_object_set_viame_columnar
+ */
+
+#ifndef VIAME_CORE_WRITE_DETECTED_OBJECT_SET_VIAME_COLUMNAR_H
+#define VIAME_CORE_WRITE_DETECTED_OBJECT_SET_VIAME_COLUMNAR_H
+
+#include <plugins/core/viame_core_export.h>
+
+#include <vital/algo/detected_object_set_output.h>
+
+#include <memory>
+
+namespace viame {
+
+class VIAME_CORE_EXPORT write_detected_object_set_viame_columnar
+  : public kwiver::vital::algo::detected_object_set_output
+{
+public:
+
+  static constexpr char const* name = "viame_columnar";
+
+  static constexpr char const* description =
+    "Detected object set writer using the viame_columnar binary format.\n\n"
+    "  Boxes, confidences, class-score pairs, polygons, keypoints and notes\n"
+    "  are stored as binary columns, with rows sorted by frame and a frame\n"
+    "  index. See viame_columnar_table.h for the file layout.\n";
+
+  write_detected_object_set_viame_columnar();
+  virtual ~write_detected_object_set_viame_columnar();
+
+  virtual void open( std::string const& filename );
+  virtual void close();
+
+  virtual void set_configuration( kwiver::vital::config_block_sptr config );
+  virtual bool check_configuration( kwiver::vital::config_block_sptr config ) const;
+
+  virtual void write_set( const kwiver::vital::detected_object_set_sptr set,
+                          std::string const& image_name );
+
+private:
+  class priv;
+  std::unique_ptr< priv > d;
+};
+
+} // end namespace
+
+#endif // VIAME_CORE_WRITE_DETECTED_OBJECT_SET_VIAME_COLUMNAR_H
@@ -31,6 +31,8 @@
 #include "write_detected_object_set_viame_csv.h"
 
 #include "notes_to_attributes.h"
+#include "csv_checkpoint.h"
+#include "csv_row_buffer.h"
 
 #include <vital/util/tokenize.h>
 
@@ -59,6 +61,9 @@
 
 namespace viame {
 
+// Detection ids are unique across all writers of the process
+static std::atomic< unsigned > s_detection_id_counter( 0 );
+
 
 // --------------------------------------------------------------------------------
 class write_detected_object_set_viame_csv::priv
@@ -74,10 +79,18 @@ public:
     , m_version_identifier( "" )
     , m_mask_to_poly_tol( -1 )
     , m_mask_to_poly_points( 20 )
+    , m_write_block_size( 0 )
+    , m_async_write_queue( 0 )
+    , m_checkpoint_interval( 0 )
+    , m_resume( false )
+    , m_frames_since_checkpoint( 0 )
   {}
 
   ~priv() {}
 
+  // Flush all rows and record the progress made so far
+  void write_checkpoint( std::ostream& stream );
+
   write_detected_object_set_viame_csv* m_parent;
   bool m_first;
   int m_frame_number;
@@ -87,9 +100,59 @@ public:
   std::string m_version_identifier;
   double m_mask_to_poly_tol;
   int m_mask_to_poly_points;
+  unsigned m_write_block_size;
+  unsigned m_async_write_queue;
+  unsigned m_checkpoint_interval;
+  bool m_resume;
+
+  // Output file checkpoints are kept for, and its stream when appending
+  std::string m_filename;
+  std::unique_ptr< std::ofstream > m_resume_stream;
+  unsigned m_frames_since_checkpoint;
+
+  // Formatted rows not yet written to the stream
+  csv_row_buffer m_buffer;
+
+  // Attribute fields of the current detection, reused across rows
+  std::string m_attributes;
 };
 
 
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_csv::priv
+::write_checkpoint( std::ostream& stream )
+{
+  m_frames_since_checkpoint = 0;
+
+  if( m_filename.empty() )
+  {
+    return;
+  }
+
+  m_buffer.flush( stream );
+  m_buffer.wait();
+  stream.flush();
+
+  const std::streamoff offset = stream.tellp();
+
+  if( offset < 0 )
+  {
+    return;
+  }
+
+  csv_checkpoint checkpoint;
+  checkpoint.frame = m_frame_number;
+  checkpoint.offset = static_cast< std::uint64_t >( offset );
+  checkpoint.next_id = s_detection_id_counter;
+
+  if( !write_csv_checkpoint( csv_checkpoint_path( m_filename ), checkpoint ) )
+  {
+    LOG_WARN( m_parent->logger(), "Unable to write checkpoint for " << m_filename );
+  }
+}
+
+
 // ================================================================================
 write_detected_object_set_viame_csv
 ::write_detected_object_set_viame_csv()
@@ -102,6 +165,77 @@ write_detected_object_set_viame_csv
 write_detected_object_set_viame_csv
 ::~write_detected_object_set_viame_csv()
 {
+  // Rows are only left in the buffer while the stream is still open
+  if( !d->m_buffer.empty() )
+  {
+    d->m_buffer.flush( stream() );
+  }
+}
+
+
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_csv
+::open( std::string const& filename )
+{
+  d->m_filename = filename;
+  d->m_frames_since_checkpoint = 0;
+  d->m_resume_stream.reset();
+
+  csv_checkpoint checkpoint;
+
+  if( d->m_resume &&
+      read_csv_checkpoint( csv_checkpoint_path( filename ), checkpoint ) &&
+      truncate_to_csv_checkpoint( filename, checkpoint ) )
+  {
+    d->m_resume_stream.reset( new std::ofstream( filename,
+      std::ios::in | std::ios::out | std::ios::ate ) );
+
+    if( *d->m_resume_stream )
+    {
+      use_stream( d->m_resume_stream.get() );
+
+      // The header was already written by the previous run
+      d->m_first = false;
+      d->m_frame_number = static_cast< int >( checkpoint.frame );
+
+      if( s_detection_id_counter < checkpoint.next_id )
+      {
+        s_detection_id_counter = static_cast< unsigned >( checkpoint.next_id );
+      }
+
+      LOG_INFO( logger(), "Resuming " << filename << " after frame "
+                          << checkpoint.frame );
+      return;
+    }
+
+    d->m_resume_stream.reset();
+  }
+
+  kwiver::vital::algo::detected_object_set_output::open( filename );
+}
+
+
+// --------------------------------------------------------------------------------
+void
+write_detected_object_set_viame_csv
+::close()
+{
+  if( d->m_checkpoint_interval > 0 && !d->m_first )
+  {
+    d->write_checkpoint( stream() );
+  }
+
+  if( !d->m_buffer.empty() )
+  {
+    d->m_buffer.flush( stream() );
+  }
+  d->m_buffer.wait();
+
+  kwiver::vital::algo::detected_object_set_output::close();
+
+  d->m_resume_stream.reset();
+  d->m_filename.clear();
 }
 
 
@@ -126,6 +260,17 @@ write_detected_object_set_viame_csv
     config->get_value< double >( "mask_to_poly_tol" );
   d->m_mask_to_poly_points =
     config->get_value< int >( "mask_to_poly_points" );
+  d->m_write_block_size =
+    config->get_value< unsigned >( "write_block_size" );
+  d->m_async_write_queue =
+    config->get_value< unsigned >( "async_write_queue" );
+  d->m_checkpoint_interval =
+    config->get_value< unsigned >( "checkpoint_interval" );
+  d->m_resume =
+    config->get_value< bool >( "resume" );
+
+  d->m_buffer.set_block_size( d->m_write_block_size );
+  d->m_buffer.set_async( d->m_async_write_queue );
 
   if( d->m_mask_to_poly_tol >= 0 && d->m_mask_to_poly_points >= 0 )
   {
@@ -167,6 +312,21 @@ write_detected_object_set_viame_csv
   config->set_value( "mask_to_poly_points", d->m_mask_to_poly_points,
     "Write segmentation masks when available as polygons with the specified "
     "maximum number of points.  Set to a negative value to disable." );
+  config->set_value( "write_block_size", d->m_write_block_size,
+    "Number of bytes of formatted rows to accumulate before writing them to "
+    "the file.  Set to 0 to write and flush the rows of every frame." );
+  config->set_value( "async_write_queue", d->m_async_write_queue,
+    "If positive, write blocks of rows from a background thread, with at most "
+    "this many blocks waiting to be written.  Set to 0 to write from write_set." );
+  config->set_value( "checkpoint_interval", d->m_checkpoint_interval,
+    "If positive, flush the output and record the number of frames written "
+    "and the file size every this many frames, in a .checkpoint file next to "
+    "the output.  Set to 0 to disable checkpoints." );
+  config->set_value( "resume", d->m_resume,
+    "If a checkpoint of the output file exists, discard any rows written "
+    "after it and append to the file instead of overwriting it.  The input "
+    "must skip the same frames, see the resume_checkpoint option of the "
+    "scheduled video reader." );
 
   return config;
 }
@@ -236,48 +396,48 @@ write_detected_object_set_viame_csv
     return;
   }
 
+  // The video identifier is shared by all the detections of the frame
+  std::string video_id;
+  if( !d->m_stream_identifier.empty() )
+  {
+    video_id = d->m_stream_identifier;
+  }
+  else
+  {
+    video_id = image_name;
+    const size_t last_slash_idx = video_id.find_last_of("\\/");
+    if ( std::string::npos != last_slash_idx )
+    {
+      video_id.erase( 0, last_slash_idx + 1 );
+    }
+  }
+
   auto ie = set->cend();
 
   for( auto det = set->cbegin(); det != ie; ++det )
   {
     const kwiver::vital::bounding_box_d bbox( (*det)->bounding_box() );
 
-    static std::atomic<unsigned> id_counter( 0 );
-    const unsigned det_id = id_counter++;
-
-    std::string video_id;
-    if( !d->m_stream_identifier.empty() )
-    {
-      video_id = d->m_stream_identifier;
-    }
-    else
-    {
-      video_id = image_name;
-      const size_t last_slash_idx = video_id.find_last_of("\\/");
-      if ( std::string::npos != last_slash_idx )
-      {
-        video_id.erase( 0, last_slash_idx + 1 );
-      }
-    }
+    const unsigned det_id = s_detection_id_counter++;
 
-    stream() << det_id << ","               // 1: track id
-             << video_id << ",";            // 2: video or image id
+    d->m_buffer << det_id << ","               // 1: track id
+                << video_id << ",";            // 2: video or image id
 
     if( d->m_write_frame_number )
     {
-      stream() << d->m_frame_number << ","; // 3: frame number
+      d->m_buffer << d->m_frame_number << ","; // 3: frame number
     }
     else
     {
-      stream() << image_name << ",";        // 3: frame identfier
+      d->m_buffer << image_name << ",";        // 3: frame identfier
     }
 
-    stream() << bbox.min_x() << ","         // 4: TL-x
-             << bbox.min_y() << ","         // 5: TL-y
-             << bbox.max_x() << ","         // 6: BR-x
-             << bbox.max_y() << ","         // 7: BR-y
-             << (*det)->confidence() << "," // 8: confidence
-             << "0";                        // 9: length
+    d->m_buffer << bbox.min_x() << ","         // 4: TL-x
+                << bbox.min_y() << ","         // 5: TL-y
+                << bbox.max_x() << ","         // 6: BR-x
+                << bbox.max_y() << ","         // 7: BR-y
+                << (*det)->confidence() << "," // 8: confidence
+                << "0";                        // 9: length
 
     const auto dot = (*det)->type();
 
@@ -285,10 +445,10 @@ write_detected_object_set_viame_csv
     {
       const auto name_list( dot->class_names() );
 
-      for( auto name : name_list )
+      for( const auto& name : name_list )
       {
         // Write out the <name> <score> pair
-        stream() << "," << name << "," << dot->score( name );
+        d->m_buffer << "," << name << "," << dot->score( name );
       }
     }
 
@@ -298,11 +458,11 @@ write_detected_object_set_viame_csv
             d->m_mask_to_poly_points < 0 ) ||
            !(*det)->mask() ) )
     {
-      stream() << ",(poly)";
+      d->m_buffer << ",(poly)";
       auto poly = (*det)->polygon();
       for( auto&& p : poly )
       {
-        stream() << " " << p[0] << " " << p[1];
+        d->m_buffer << " " << p[0] << " " << p[1];
       }
     }
 #ifdef VIAME_ENABLE_OPENCV
@@ -343,10 +503,10 @@ write_detected_object_set_viame_csv
         {
           simp_contour = simplify_polygon( contour, d->m_mask_to_poly_points );
         }
-        stream() << ( hierarchy[i][3] < 0 ? ",(poly)" : ",(hole)" );
+        d->m_buffer << ( hierarchy[i][3] < 0 ? ",(poly)" : ",(hole)" );
         for( auto&& p : simp_contour )
         {
-          stream() << " " << p.x + ref_x << " " << p.y + ref_y;
+          d->m_buffer << " " << p.x + ref_x << " " << p.y + ref_y;
         }
       }
     }
@@ -356,24 +516,35 @@ write_detected_object_set_viame_csv
     {
       for( const auto& kp : (*det)->keypoints() )
       {
-        stream() << "," << "(kp) " << kp.first;
-        stream() << " " << kp.second.value()[0] << " " << kp.second.value()[1];
+        d->m_buffer << "," << "(kp) " << kp.first;
+        d->m_buffer << " " << kp.second.value()[0] << " " << kp.second.value()[1];
       }
     }
 
     if( !(*det)->notes().empty() )
     {
-      stream() << notes_to_attributes( (*det)->notes(), "," );
+      d->m_attributes.clear();
+      notes_to_attributes( (*det)->notes(), ",", d->m_attributes );
+      d->m_buffer << d->m_attributes;
     }
 
-    stream() << std::endl;
+    d->m_buffer.end_row( stream() );
   }
 
-  // Flush stream to prevent buffer issues
-  stream().flush();
+  // Flush stream to prevent buffer issues, unless writing in blocks
+  if( d->m_write_block_size == 0 )
+  {
+    d->m_buffer.flush( stream() );
+  }
 
   // Put each set on a new frame
   ++d->m_frame_number;
+
+  if( d->m_checkpoint_interval > 0 &&
+      ++d->m_frames_since_checkpoint >= d->m_checkpoint_interval )
+  {
+    d->write_checkpoint( stream() );
+  }
 }
 
 } // end namespace
@@ -69,6 +69,9 @@ public:
   virtual void set_configuration( kwiver::vital::config_block_sptr config );
   virtual bool check_configuration( kwiver::vital::config_block_sptr config ) const;
 
+  virtual void open( std::string const& filename );
+  virtual void close();
+
   virtual void write_set( const kwiver::vital::detected_object_set_sptr set,
                           std::string const& image_name );
 
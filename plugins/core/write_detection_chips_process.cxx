@@ -0,0 +1,607 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Write image chips around detections, encoding them in parallel
+ */
+
+#include "write_detection_chips_process.h"
+#include "process_trace.h"
+#include "thread_pool.h"
+
+#include <vital/types/detected_object_set.h>
+#include <vital/types/image_container.h>
+#include <vital/types/timestamp.h>
+#include <vital/exceptions.h>
+
+#include <sprokit/processes/kwiver_type_traits.h>
+#include <sprokit/pipeline/process_exception.h>
+#include <sprokit/pipeline/datum.h>
+
+#include <arrows/ocv/image_container.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace kv = kwiver::vital;
+
+namespace viame
+{
+
+namespace core
+{
+
+create_config_trait( output_directory, std::string, "chips",
+  "Directory chips or chip archives are written to" );
+create_config_trait( archive_size, unsigned, "0",
+  "Number of chips appended to each chips_NNNNNN.tar archive, or 0 to write "
+  "each chip to its own file" );
+create_config_trait( chip_width, unsigned, "0",
+  "Width chips are resized to, 0 scales with chip_height or keeps the "
+  "detection width when both are 0" );
+create_config_trait( chip_height, unsigned, "0",
+  "Height chips are resized to, 0 scales with chip_width or keeps the "
+  "detection height when both are 0" );
+create_config_trait( padding, double, "0.0",
+  "Fraction of the detection size added to each side of the chip" );
+create_config_trait( file_extension, std::string, "png",
+  "Image format of chips, given as a file extension such as png or jpg" );
+create_config_trait( jpeg_quality, unsigned, "95",
+  "Quality of chips encoded as jpg" );
+create_config_trait( max_pending_chips, unsigned, "1024",
+  "Number of chips which may wait to be encoded before a step blocks" );
+create_config_trait( num_threads, unsigned, "0",
+  "Threads resizing and encoding chips, 0 uses all cores" );
+
+namespace
+{
+
+// Chips are encoded in tasks of at most this many
+size_t const chips_per_task = 32;
+
+struct encoded_chip
+{
+  std::string name;
+  std::vector< uchar > data;
+};
+
+// -----------------------------------------------------------------------------
+// Appends files to a ustar archive
+class tar_writer
+{
+public:
+  void open( std::string const& path )
+  {
+    m_path = path;
+    m_stream.open( path, std::ios::binary | std::ios::trunc );
+
+    if( !m_stream )
+    {
+      VITAL_THROW( kv::file_write_exception, path, "Unable to open chip archive" );
+    }
+  }
+
+  bool is_open() const
+  {
+    return m_stream.is_open();
+  }
+
+  void add( std::string const& name, std::vector< uchar > const& data )
+  {
+    char header[ 512 ];
+    std::memset( header, 0, sizeof( header ) );
+
+    std::strncpy( header, name.c_str(), 99 );
+    std::snprintf( header + 100, 8, "%07o", 0644 );
+    std::snprintf( header + 108, 8, "%07o", 0 );
+    std::snprintf( header + 116, 8, "%07o", 0 );
+    std::snprintf( header + 124, 12, "%011lo",
+                   static_cast< unsigned long >( data.size() ) );
+    std::snprintf( header + 136, 12, "%011lo",
+                   static_cast< unsigned long >( std::time( nullptr ) ) );
+    header[ 156 ] = '0';
+    std::memcpy( header + 257, "ustar", 6 );
+    std::memcpy( header + 263, "00", 2 );
+
+    // The checksum is computed with its own field set to spaces
+    std::memset( header + 148, ' ', 8 );
+    unsigned checksum = 0;
+
+    for( unsigned char c : header )
+    {
+      checksum += c;
+    }
+    std::snprintf( header + 148, 8, "%06o", checksum );
+
+    static char const zeros[ 512 ] = { 0 };
+
+    m_stream.write( header, sizeof( header ) );
+    m_stream.write( reinterpret_cast< char const* >( data.data() ), data.size() );
+    m_stream.write( zeros, ( 512 - data.size() % 512 ) % 512 );
+
+    if( !m_stream )
+    {
+      VITAL_THROW( kv::file_write_exception, m_path, "Unable to write chip archive" );
+    }
+  }
+
+  void close()
+  {
+    if( m_stream.is_open() )
+    {
+      static char const zeros[ 1024 ] = { 0 };
+      m_stream.write( zeros, sizeof( zeros ) );
+      m_stream.close();
+    }
+  }
+
+private:
+  std::string m_path;
+  std::ofstream m_stream;
+};
+
+// -----------------------------------------------------------------------------
+std::string
+safe_name( std::string name, size_t max_length )
+{
+  for( char& c : name )
+  {
+    if( !std::isalnum( static_cast< unsigned char >( c ) ) &&
+        c != '-' && c != '.' )
+    {
+      c = '_';
+    }
+  }
+
+  return name.substr( 0, max_length );
+}
+
+} // end anonymous namespace
+
+// =============================================================================
+// Private implementation class
+class write_detection_chips_process::priv
+{
+public:
+  priv()
+    : m_archive_size( 0 )
+    , m_chip_width( 0 )
+    , m_chip_height( 0 )
+    , m_padding( 0.0 )
+    , m_max_pending_chips( 1024 )
+    , m_frame_counter( 0 )
+    , m_pending_chips( 0 )
+    , m_archive_index( 0 )
+    , m_archive_chips( 0 )
+  {}
+
+  ~priv()
+  {
+    // Only reached with chips left when the pipeline stops before completing
+    try
+    {
+      finish();
+    }
+    catch( ... )
+    {
+    }
+  }
+
+  // Configuration settings
+  std::string m_output_directory;
+  unsigned m_archive_size;
+  unsigned m_chip_width;
+  unsigned m_chip_height;
+  double m_padding;
+  std::string m_extension;
+  std::vector< int > m_encode_params;
+  unsigned m_max_pending_chips;
+
+  // Internal variables
+  std::unique_ptr< thread_pool > m_workers;
+  size_t m_frame_counter;
+
+  // Encoding tasks in frame order with their chip counts
+  std::deque< std::pair< size_t, std::future< std::vector< encoded_chip > > > > m_pending;
+  size_t m_pending_chips;
+
+  tar_writer m_archive;
+  unsigned m_archive_index;
+  unsigned m_archive_chips;
+
+  cv::Size chip_size( cv::Size const& crop ) const;
+  std::vector< encoded_chip > encode(
+    std::vector< std::pair< std::string, cv::Mat > > const& crops ) const;
+
+  // Write finished tasks, waiting on the oldest while over max_pending chips
+  void write_ready( size_t max_pending );
+  void write( std::vector< encoded_chip > const& chips );
+  void finish();
+};
+
+
+// -----------------------------------------------------------------------------
+cv::Size
+write_detection_chips_process::priv
+::chip_size( cv::Size const& crop ) const
+{
+  if( m_chip_width && m_chip_height )
+  {
+    return cv::Size( m_chip_width, m_chip_height );
+  }
+  if( m_chip_width )
+  {
+    return cv::Size( m_chip_width, std::max( 1,
+      static_cast< int >( std::lround( crop.height * m_chip_width / double( crop.width ) ) ) ) );
+  }
+  if( m_chip_height )
+  {
+    return cv::Size( std::max( 1,
+      static_cast< int >( std::lround( crop.width * m_chip_height / double( crop.height ) ) ) ),
+      m_chip_height );
+  }
+  return crop;
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector< encoded_chip >
+write_detection_chips_process::priv
+::encode( std::vector< std::pair< std::string, cv::Mat > > const& crops ) const
+{
+  std::vector< encoded_chip > output( crops.size() );
+  cv::Mat resized;
+
+  for( size_t i = 0; i < crops.size(); ++i )
+  {
+    cv::Mat const& crop = crops[ i ].second;
+    const cv::Size size = chip_size( crop.size() );
+
+    if( size != crop.size() )
+    {
+      cv::resize( crop, resized, size, 0, 0,
+        size.area() < crop.size().area() ? cv::INTER_AREA : cv::INTER_LINEAR );
+    }
+    else
+    {
+      resized = crop;
+    }
+
+    output[ i ].name = crops[ i ].first;
+    if( !cv::imencode( "." + m_extension, resized, output[ i ].data, m_encode_params ) )
+    {
+      VITAL_THROW( kv::file_write_exception, output[ i ].name, "Unable to encode chip" );
+    }
+  }
+
+  return output;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+write_detection_chips_process::priv
+::write_ready( size_t max_pending )
+{
+  while( !m_pending.empty() &&
+         ( m_pending_chips > max_pending ||
+           m_pending.front().second.wait_for( std::chrono::seconds( 0 ) ) ==
+             std::future_status::ready ) )
+  {
+    auto task = std::move( m_pending.front() );
+    m_pending.pop_front();
+    m_pending_chips -= task.first;
+
+    write( task.second.get() );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+write_detection_chips_process::priv
+::write( std::vector< encoded_chip > const& chips )
+{
+  for( auto const& chip : chips )
+  {
+    if( !m_archive_size )
+    {
+      const std::string path = m_output_directory + "/" + chip.name;
+      std::ofstream output( path, std::ios::binary );
+
+      output.write( reinterpret_cast< char const* >( chip.data.data() ),
+                    chip.data.size() );
+
+      if( !output )
+      {
+        VITAL_THROW( kv::file_write_exception, path, "Unable to write chip" );
+      }
+      continue;
+    }
+
+    if( m_archive_chips == m_archive_size )
+    {
+      m_archive.close();
+      m_archive_chips = 0;
+    }
+
+    if( !m_archive.is_open() )
+    {
+      char archive_name[ 32 ];
+      std::snprintf( archive_name, sizeof( archive_name ),
+                     "/chips_%06u.tar", m_archive_index++ );
+      m_archive.open( m_output_directory + archive_name );
+    }
+
+    m_archive.add( chip.name, chip.data );
+    ++m_archive_chips;
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+write_detection_chips_process::priv
+::finish()
+{
+  write_ready( 0 );
+  m_archive.close();
+}
+
+
+// =============================================================================
+write_detection_chips_process
+::write_detection_chips_process( kv::config_block_sptr const& config )
+  : process( config ),
+    d( new write_detection_chips_process::priv() )
+{
+  make_ports();
+  make_config();
+}
+
+
+write_detection_chips_process
+::~write_detection_chips_process()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+write_detection_chips_process
+::make_ports()
+{
+  // Set up for required ports
+  sprokit::process::port_flags_t required;
+  sprokit::process::port_flags_t optional;
+
+  required.insert( flag_required );
+
+  // -- inputs --
+  declare_input_port_using_trait( image, required );
+  declare_input_port_using_trait( detected_object_set, required );
+  declare_input_port_using_trait( timestamp, optional );
+  declare_input_port_using_trait( image_file_name, optional );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+write_detection_chips_process
+::make_config()
+{
+  declare_config_using_trait( output_directory );
+  declare_config_using_trait( archive_size );
+  declare_config_using_trait( chip_width );
+  declare_config_using_trait( chip_height );
+  declare_config_using_trait( padding );
+  declare_config_using_trait( file_extension );
+  declare_config_using_trait( jpeg_quality );
+  declare_config_using_trait( max_pending_chips );
+  declare_config_using_trait( num_threads );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+write_detection_chips_process
+::_configure()
+{
+  d->m_output_directory = config_value_using_trait( output_directory );
+  d->m_archive_size = config_value_using_trait( archive_size );
+  d->m_chip_width = config_value_using_trait( chip_width );
+  d->m_chip_height = config_value_using_trait( chip_height );
+  d->m_padding = config_value_using_trait( padding );
+  d->m_extension = config_value_using_trait( file_extension );
+  d->m_max_pending_chips = config_value_using_trait( max_pending_chips );
+
+  if( d->m_extension.empty() || d->m_padding < 0.0 )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "A file_extension and non-negative padding must be given" );
+  }
+
+  if( d->m_extension == "jpg" || d->m_extension == "jpeg" )
+  {
+    d->m_encode_params = { cv::IMWRITE_JPEG_QUALITY,
+      static_cast< int >( config_value_using_trait( jpeg_quality ) ) };
+  }
+
+  if( !kwiversys::SystemTools::MakeDirectory( d->m_output_directory ) )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Unable to create " + d->m_output_directory );
+  }
+
+  d->m_workers.reset( new thread_pool( config_value_using_trait( num_threads ) ) );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+write_detection_chips_process
+::_step()
+{
+  process_step_trace trace( name() );
+
+  auto port_info = peek_at_port_using_trait( image );
+
+  if( port_info.datum->type() == sprokit::datum::complete )
+  {
+    grab_edge_datum_using_trait( image );
+    grab_edge_datum_using_trait( detected_object_set );
+
+    if( has_input_port_edge_using_trait( timestamp ) )
+    {
+      grab_edge_datum_using_trait( timestamp );
+    }
+    if( has_input_port_edge_using_trait( image_file_name ) )
+    {
+      grab_edge_datum_using_trait( image_file_name );
+    }
+
+    trace.inputs_ready();
+
+    d->finish();
+    mark_process_as_complete();
+    return;
+  }
+
+  kv::image_container_sptr image = grab_from_port_using_trait( image );
+  kv::detected_object_set_sptr detections =
+    grab_from_port_using_trait( detected_object_set );
+
+  kv::timestamp timestamp;
+  std::string file_name;
+
+  if( has_input_port_edge_using_trait( timestamp ) )
+  {
+    timestamp = grab_from_port_using_trait( timestamp );
+  }
+  if( has_input_port_edge_using_trait( image_file_name ) )
+  {
+    file_name = grab_from_port_using_trait( image_file_name );
+  }
+
+  trace.inputs_ready();
+
+  const size_t frame = ( timestamp.has_valid_frame() ?
+    static_cast< size_t >( timestamp.get_frame() ) : d->m_frame_counter );
+  ++d->m_frame_counter;
+
+  if( !image || !detections || detections->empty() )
+  {
+    d->write_ready( d->m_max_pending_chips );
+    return;
+  }
+
+  const std::string prefix = file_name.empty() ? std::string( "frame" ) :
+    safe_name( kwiversys::SystemTools::GetFilenameWithoutLastExtension( file_name ), 40 );
+
+  // Crops are views of the frame, which they keep alive until encoded
+  using ic = kwiver::arrows::ocv::image_container;
+  const cv::Mat frame_image = ic::vital_to_ocv( image->get_image(), ic::BGR_COLOR );
+  const cv::Rect bounds( 0, 0, frame_image.cols, frame_image.rows );
+
+  std::vector< std::pair< std::string, cv::Mat > > crops;
+  size_t index = 0;
+
+  for( auto det : *detections )
+  {
+    const kv::bounding_box_d box = det->bounding_box();
+    const double pad_x = box.width() * d->m_padding;
+    const double pad_y = box.height() * d->m_padding;
+
+    const cv::Rect rect = bounds & cv::Rect(
+      cv::Point( static_cast< int >( std::floor( box.min_x() - pad_x ) ),
+                 static_cast< int >( std::floor( box.min_y() - pad_y ) ) ),
+      cv::Point( static_cast< int >( std::ceil( box.max_x() + pad_x ) ),
+                 static_cast< int >( std::ceil( box.max_y() + pad_y ) ) ) );
+
+    const size_t det_index = index++;
+
+    if( rect.area() == 0 )
+    {
+      continue;
+    }
+
+    std::string label = "unknown";
+    double score;
+
+    if( det->type() )
+    {
+      det->type()->get_most_likely( label, score );
+    }
+
+    char suffix[ 32 ];
+    std::snprintf( suffix, sizeof( suffix ), "_%06zu_%04zu_", frame, det_index );
+
+    crops.emplace_back( prefix + suffix + safe_name( label, 32 ) + "." +
+                        d->m_extension, frame_image( rect ) );
+  }
+
+  trace.count( "chips", crops.size() );
+
+  for( size_t begin = 0; begin < crops.size(); begin += chips_per_task )
+  {
+    const size_t end = std::min( crops.size(), begin + chips_per_task );
+
+    std::vector< std::pair< std::string, cv::Mat > > task_crops(
+      crops.begin() + begin, crops.begin() + end );
+
+    priv* p = d.get();
+    d->m_pending.emplace_back( end - begin, d->m_workers->enqueue(
+      [p, task_crops]{ return p->encode( task_crops ); } ) );
+    d->m_pending_chips += end - begin;
+  }
+
+  d->write_ready( d->m_max_pending_chips );
+}
+
+} // end namespace core
+} // end namespace viame
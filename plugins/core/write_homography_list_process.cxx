@@ -34,11 +34,14 @@
  */
 
 #include "write_homography_list_process.h"
+#include "process_trace.h"
+#include "homography_list_binary.h"
 
 #include <vital/vital_types.h>
 #include <vital/types/homography.h>
 
 #include <sprokit/processes/kwiver_type_traits.h>
+#include <sprokit/pipeline/process_exception.h>
 
 #include <fstream>
 #include <iostream>
@@ -55,6 +58,9 @@ create_config_trait( file_name, std::string, "homographies.txt",
   "Filename for writing homographies into" );
 create_config_trait( no_homography_string, std::string, "[no-match]",
   "String to print out to the output file if there is no match" );
+create_config_trait( file_format, std::string, "text",
+  "Format of the output file, either text or binary. Binary lists have fixed "
+  "size records and a file name index, see homography_list_binary.h." );
 
 create_port_trait( source_file_name, file_name, "Source file name" );
 create_port_trait( dest_file_name, file_name, "Destination file name" );
@@ -71,9 +77,11 @@ public:
   // Configuration values
   std::string m_file_name;
   std::string m_no_homography_string;
+  bool m_binary;
 
   // Internal variables
   std::ofstream m_writer;
+  homography_list_writer m_binary_writer;
 };
 
 // =============================================================================
@@ -106,11 +114,28 @@ write_homography_list_process
   d->m_file_name = config_value_using_trait( file_name );
   d->m_no_homography_string = config_value_using_trait( no_homography_string );
 
+  const std::string file_format = config_value_using_trait( file_format );
+
+  if( file_format != "text" && file_format != "binary" )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Invalid file_format: " + file_format );
+  }
+
+  d->m_binary = ( file_format == "binary" );
+
   if( d->m_writer.is_open() )
   {
     d->m_writer.close();
   }
 
+  if( d->m_binary )
+  {
+    d->m_binary_writer.open( d->m_file_name );
+    return;
+  }
+
+  d->m_binary_writer.close();
   d->m_writer.open( d->m_file_name, std::ofstream::out );
 
   if( !d->m_writer.is_open() )
@@ -125,6 +150,8 @@ void
 write_homography_list_process
 ::_step()
 {
+  process_step_trace trace( name() );
+
   std::string source_file_name;
   std::string dest_file_name;
 
@@ -134,25 +161,42 @@ write_homography_list_process
   dest_file_name = grab_from_port_using_trait( dest_file_name );
   homog = grab_from_port_using_trait( homography );
 
+  trace.inputs_ready();
+
+  if( d->m_binary )
+  {
+    if( homog )
+    {
+      const kwiver::vital::matrix_3x3d matrix = homog->matrix();
+      d->m_binary_writer.add( source_file_name, dest_file_name, &matrix );
+    }
+    else
+    {
+      d->m_binary_writer.add( source_file_name, dest_file_name, nullptr );
+    }
+    return;
+  }
+
+  // Lines are flushed by the stream as its buffer fills, or on close
   if( !source_file_name.empty() )
   {
-    d->m_writer << source_file_name << std::endl;
+    d->m_writer << source_file_name << '\n';
   }
   if( !dest_file_name.empty() )
   {
-    d->m_writer << dest_file_name << std::endl;
+    d->m_writer << dest_file_name << '\n';
   }
 
   if( homog )
   {
-    d->m_writer << *homog << std::endl;
+    d->m_writer << *homog << '\n';
   }
   else
   {
-    d->m_writer << d->m_no_homography_string << std::endl;
+    d->m_writer << d->m_no_homography_string << '\n';
   }
 
-  d->m_writer << std::endl;
+  d->m_writer << '\n';
 }
 
 
@@ -180,12 +224,14 @@ write_homography_list_process
 {
   declare_config_using_trait( file_name );
   declare_config_using_trait( no_homography_string );
+  declare_config_using_trait( file_format );
 }
 
 
 // =============================================================================
 write_homography_list_process::priv
 ::priv()
+  : m_binary( false )
 {
 }
 
@@ -0,0 +1,250 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation for write_object_track_set_pg_copy
+ */
+
+#include "write_object_track_set_pg_copy.h"
+
+#include <vital/exceptions/io.h>
+#include <vital/types/object_track_set.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+namespace viame {
+
+// -------------------------------------------------------------------------------
+class write_object_track_set_pg_copy::priv
+{
+public:
+  priv()
+    : m_logger( kwiver::vital::get_logger( "write_object_track_set_pg_copy" ) )
+  {}
+
+  ~priv() {}
+
+  // Helper functions - append fields in network byte order
+  void put( uint64_t value, unsigned bytes );
+  void put_field( uint64_t value, unsigned bytes );
+  void put_field( double value );
+  void put_field( std::string const& value );
+
+  kwiver::vital::logger_handle_t m_logger;
+  std::string m_video_name;
+  std::ofstream m_stream;
+
+  // Last written frame of each track, states are only appended once
+  std::map< kwiver::vital::track_id_t, kwiver::vital::frame_id_t > m_last_frames;
+};
+
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_pg_copy::priv
+::put( uint64_t value, unsigned bytes )
+{
+  char buffer[8];
+
+  for( unsigned i = 0; i < bytes; ++i )
+  {
+    buffer[i] = static_cast< char >( value >> ( 8 * ( bytes - i - 1 ) ) );
+  }
+  m_stream.write( buffer, bytes );
+}
+
+
+void
+write_object_track_set_pg_copy::priv
+::put_field( uint64_t value, unsigned bytes )
+{
+  put( bytes, 4 );
+  put( value, bytes );
+}
+
+
+void
+write_object_track_set_pg_copy::priv
+::put_field( double value )
+{
+  uint64_t bits;
+  std::memcpy( &bits, &value, sizeof( bits ) );
+  put_field( bits, 8 );
+}
+
+
+void
+write_object_track_set_pg_copy::priv
+::put_field( std::string const& value )
+{
+  put( value.size(), 4 );
+  m_stream.write( value.data(), value.size() );
+}
+
+
+// ===============================================================================
+write_object_track_set_pg_copy
+::write_object_track_set_pg_copy()
+  : d( new write_object_track_set_pg_copy::priv() )
+{
+}
+
+
+write_object_track_set_pg_copy
+::~write_object_track_set_pg_copy()
+{
+  close();
+}
+
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_pg_copy
+::open( std::string const& filename )
+{
+  // The base stream is text mode, so the binary file is owned here instead
+  close();
+
+  d->m_stream.open( filename, std::ios::out | std::ios::binary | std::ios::trunc );
+
+  if( !d->m_stream )
+  {
+    VITAL_THROW( kwiver::vital::file_write_exception, filename,
+                 "Unable to open spool file" );
+  }
+
+  // Signature, flags and header extension length of the COPY binary format
+  d->m_stream.write( "PGCOPY\n\377\r\n\0", 11 );
+  d->put( 0, 4 );
+  d->put( 0, 4 );
+  d->m_last_frames.clear();
+}
+
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_pg_copy
+::close()
+{
+  if( d->m_stream.is_open() )
+  {
+    d->put( 0xFFFF, 2 );
+    d->m_stream.close();
+  }
+}
+
+
+// -------------------------------------------------------------------------------
+kwiver::vital::config_block_sptr
+write_object_track_set_pg_copy
+::get_configuration() const
+{
+  auto config = kwiver::vital::algo::write_object_track_set::get_configuration();
+
+  config->set_value( "video_name", d->m_video_name,
+    "Video name written in the VIDEO_NAME column of every row" );
+
+  return config;
+}
+
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_pg_copy
+::set_configuration( kwiver::vital::config_block_sptr config )
+{
+  d->m_video_name = config->get_value< std::string >( "video_name", d->m_video_name );
+}
+
+
+// -------------------------------------------------------------------------------
+bool
+write_object_track_set_pg_copy
+::check_configuration( kwiver::vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_pg_copy
+::write_set( const kwiver::vital::object_track_set_sptr& set,
+             const kwiver::vital::timestamp& ts,
+             const std::string& file_id )
+{
+  if( !set || !d->m_stream.is_open() )
+  {
+    return;
+  }
+
+  for( auto const& trk : set->tracks() )
+  {
+    auto last = d->m_last_frames.find( trk->id() );
+    bool const has_last = ( last != d->m_last_frames.end() );
+
+    for( auto const& ts_ptr : *trk )
+    {
+      auto state = dynamic_cast< kwiver::vital::object_track_state* >( ts_ptr.get() );
+
+      if( !state || !state->detection() ||
+          ( has_last && state->frame() <= last->second ) )
+      {
+        continue;
+      }
+
+      const auto& det = state->detection();
+      const auto& bbox = det->bounding_box();
+
+      // Columns of OBJECT_TRACK in sql_init_table.sql
+      d->put( 9, 2 );
+      d->put_field( static_cast< uint32_t >( trk->id() ), 4 );
+      d->put_field( static_cast< uint32_t >( state->frame() ), 4 );
+      d->put_field( d->m_video_name );
+      d->put_field( static_cast< uint64_t >( state->time() ), 8 );
+      d->put_field( bbox.min_x() );
+      d->put_field( bbox.min_y() );
+      d->put_field( bbox.max_x() );
+      d->put_field( bbox.max_y() );
+      d->put_field( det->confidence() );
+    }
+
+    if( !trk->empty() )
+    {
+      d->m_last_frames[ trk->id() ] = trk->last_frame();
+    }
+  }
+}
+
+} // end namespace
@@ -0,0 +1,198 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Implementation for write_object_track_set_viame_columnar
+ */
+
+#include "write_object_track_set_viame_columnar.h"
+#include "viame_columnar_table.h"
+
+#include <vital/types/object_track_set.h>
+
+#include <map>
+
+namespace viame {
+
+// -------------------------------------------------------------------------------
+class write_object_track_set_viame_columnar::priv
+{
+public:
+  priv()
+    : m_logger( kwiver::vital::get_logger( "write_object_track_set_viame_columnar" ) )
+    , m_pending( false )
+  {}
+
+  ~priv() {}
+
+  // Helper function - convert all tracks to rows and write the file
+  void write_all();
+
+  kwiver::vital::logger_handle_t m_logger;
+  std::string m_filename;
+  bool m_pending;
+
+  // Latest version of every track, and the file name of each frame
+  std::map< kwiver::vital::track_id_t, kwiver::vital::track_sptr > m_tracks;
+  std::map< kwiver::vital::frame_id_t, std::string > m_frame_uids;
+};
+
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_viame_columnar::priv
+::write_all()
+{
+  viame_columnar_table table;
+  const std::string no_uid;
+
+  for( auto const& trk_pair : m_tracks )
+  {
+    for( auto const& ts_ptr : *trk_pair.second )
+    {
+      auto ts = dynamic_cast< kwiver::vital::object_track_state* >( ts_ptr.get() );
+
+      if( !ts || !ts->detection() )
+      {
+        LOG_ERROR( m_logger, "Skipping state without detection in track "
+                             << trk_pair.first );
+        continue;
+      }
+
+      auto uid = m_frame_uids.find( ts->frame() );
+
+      table.add( trk_pair.first, ts->frame(), ts->time(),
+                 uid != m_frame_uids.end() ? uid->second : no_uid,
+                 *ts->detection() );
+    }
+  }
+
+  table.write( m_filename );
+}
+
+
+// ===============================================================================
+write_object_track_set_viame_columnar
+::write_object_track_set_viame_columnar()
+  : d( new write_object_track_set_viame_columnar::priv() )
+{
+}
+
+
+write_object_track_set_viame_columnar
+::~write_object_track_set_viame_columnar()
+{
+  // Output was not closed, write what was received without throwing
+  if( d->m_pending )
+  {
+    try
+    {
+      d->write_all();
+    }
+    catch( std::exception const& e )
+    {
+      LOG_ERROR( d->m_logger, e.what() );
+    }
+  }
+}
+
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_viame_columnar
+::open( std::string const& filename )
+{
+  kwiver::vital::algo::write_object_track_set::open( filename );
+
+  d->m_filename = filename;
+  d->m_tracks.clear();
+  d->m_frame_uids.clear();
+  d->m_pending = true;
+}
+
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_viame_columnar
+::close()
+{
+  // Columns can only be written once all track states are known
+  kwiver::vital::algo::write_object_track_set::close();
+
+  if( d->m_pending )
+  {
+    d->write_all();
+    d->m_pending = false;
+  }
+}
+
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_viame_columnar
+::set_configuration( kwiver::vital::config_block_sptr config )
+{
+}
+
+
+// -------------------------------------------------------------------------------
+bool
+write_object_track_set_viame_columnar
+::check_configuration( kwiver::vital::config_block_sptr config ) const
+{
+  return true;
+}
+
+
+// -------------------------------------------------------------------------------
+void
+write_object_track_set_viame_columnar
+::write_set( const kwiver::vital::object_track_set_sptr& set,
+             const kwiver::vital::timestamp& ts,
+             const std::string& file_id )
+{
+  if( !file_id.empty() && ts.has_valid_frame() )
+  {
+    d->m_frame_uids[ ts.get_frame() ] = file_id;
+  }
+
+  if( !set )
+  {
+    return;
+  }
+
+  for( auto const& trk : set->tracks() )
+  {
+    d->m_tracks[ trk->id() ] = trk;
+  }
+}
+
+} // end namespace
@@ -36,10 +36,18 @@
 #include "write_object_track_set_viame_csv.h"
 
 #include "notes_to_attributes.h"
+#include "csv_checkpoint.h"
+#include "csv_row_buffer.h"
+#include "image_memory_budget.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <ctime>
+#include <fstream>
+#include <map>
 #include <sstream>
 #include <iomanip>
+#include <unordered_set>
 
 #ifdef VIAME_ENABLE_OPENCV
 #include <arrows/ocv/image_container.h>
@@ -47,7 +55,10 @@
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
+#include <cstdint>
 #include <queue>
+#include <unordered_map>
+#include <utility>
 
 static std::vector< cv::Point >
 simplify_polygon( std::vector< cv::Point > const& curve, size_t max_points );
@@ -56,6 +67,140 @@ simplify_polygon( std::vector< cv::Point > const& curve, size_t max_points );
 namespace viame {
 
 
+// -------------------------------------------------------------------------------
+// Running class mass sums of a track, updated one state at a time
+class tot_accumulator
+{
+public:
+  tot_accumulator()
+    : m_weighted_mass( 0.0 )
+    , m_weighted_non_ignore_mass( 0.0 )
+    , m_weighted_ignore_mass( 0.0 )
+    , m_ignore_sum( 0.0 )
+    , m_conf_sum( 0.0 )
+    , m_conf_count( 0 )
+  { }
+
+  void add( kwiver::vital::object_track_state const* ts,
+            bool weighted, bool scale_by_conf,
+            std::string const& ignore_class );
+
+  kwiver::vital::detected_object_type_sptr
+  average( bool scale_by_conf, std::string const& ignore_class ) const;
+
+private:
+  double m_weighted_mass;
+  double m_weighted_non_ignore_mass;
+  double m_weighted_ignore_mass;
+
+  std::map< std::string, double > m_class_sum;
+  double m_ignore_sum;
+  double m_conf_sum;
+  unsigned m_conf_count;
+};
+
+
+void
+tot_accumulator
+::add( kwiver::vital::object_track_state const* ts,
+       bool weighted, bool scale_by_conf,
+       std::string const& ignore_class )
+{
+  if( !ts || !ts->detection() )
+  {
+    return;
+  }
+
+  kwiver::vital::detected_object_type_sptr dot = ts->detection()->type();
+
+  if( !dot )
+  {
+    return;
+  }
+
+  double weight = ( weighted ? ts->detection()->confidence() : 1.0 );
+
+  if( scale_by_conf )
+  {
+    m_conf_sum += ts->detection()->confidence();
+    m_conf_count += 1;
+  }
+
+  bool ignore = ( dot->class_names().size() == 1 &&
+                  dot->class_names()[0] == ignore_class );
+
+  if( ignore )
+  {
+    m_ignore_sum += ( dot->score( ignore_class ) * weight );
+    m_weighted_ignore_mass += weight;
+  }
+  else
+  {
+    for( const auto name : dot->class_names() )
+    {
+      m_class_sum[ name ] += ( dot->score( name ) * weight );
+    }
+    m_weighted_non_ignore_mass += weight;
+  }
+
+  m_weighted_mass += weight;
+}
+
+
+kwiver::vital::detected_object_type_sptr
+tot_accumulator
+::average( bool scale_by_conf, std::string const& ignore_class ) const
+{
+  std::vector< std::string > output_names;
+  std::vector< double > output_scores;
+
+  double prob_scale_factor = 1.0;
+  bool only_ignore = false;
+
+  if( scale_by_conf && m_conf_count > 0 )
+  {
+    prob_scale_factor = 0.1 + 0.9 * ( m_conf_sum / m_conf_count );
+  }
+
+  if( m_weighted_mass > 0.0 && m_weighted_ignore_mass == 0.0 )
+  {
+    prob_scale_factor /= m_weighted_mass;
+  }
+  else if( m_weighted_ignore_mass > 0.0 && m_weighted_non_ignore_mass > 0.0 )
+  {
+    prob_scale_factor /= m_weighted_non_ignore_mass;
+  }
+  else if( m_weighted_ignore_mass > 0.0 )
+  {
+    only_ignore = true;
+    prob_scale_factor /= m_weighted_ignore_mass;
+  }
+
+  // Tracks holding only the ignore class report it alone
+  std::map< std::string, double > ignore_only;
+
+  if( only_ignore )
+  {
+    ignore_only = m_class_sum;
+    ignore_only[ ignore_class ] = m_ignore_sum;
+  }
+
+  for( auto itr : ( only_ignore ? ignore_only : m_class_sum ) )
+  {
+    output_names.push_back( itr.first );
+    output_scores.push_back( prob_scale_factor * itr.second );
+  }
+
+  if( output_names.empty() )
+  {
+    return kwiver::vital::detected_object_type_sptr();
+  }
+
+  return std::make_shared< kwiver::vital::detected_object_type >(
+    output_names, output_scores );
+}
+
+
 // -------------------------------------------------------------------------------
 class write_object_track_set_viame_csv::priv
 {
@@ -75,6 +220,20 @@ public:
     , m_frame_id_adjustment( 0 )
     , m_mask_to_poly_tol( -1 )
     , m_mask_to_poly_points( 20 )
+    , m_write_block_size( 0 )
+    , m_async_write_queue( 0 )
+    , m_mask_cache_size( 256 )
+    , m_checkpoint_interval( 0 )
+    , m_resume( false )
+    , m_frames_since_checkpoint( 0 )
+    , m_last_frame( 0 )
+    , m_track_id_offset( 0 )
+    , m_next_track_id( 0 )
+    , m_finalize_tracks( false )
+    , m_track_timeout( 0 )
+    , m_tot_weighted( true )
+    , m_tot_scaled( false )
+    , m_set_count( 0 )
   { }
 
   ~priv() { }
@@ -87,6 +246,22 @@ public:
   std::string m_model_identifier;
   std::string m_version_identifier;
   std::map< unsigned, kwiver::vital::track_sptr > m_tracks;
+
+  // States of m_tracks whose detection masks are reported to the image
+  // memory budget, with their bytes, by track id
+  struct held_track
+  {
+    held_track() : states( 0 ), bytes( 0 ) { }
+
+    size_t states;
+    size_t bytes;
+  };
+
+  std::map< unsigned, held_track > m_held_tracks;
+  image_memory_holder m_tracks_memory;
+
+  // Report the masks of the states added to a track kept until close
+  void hold_track( kwiver::vital::track_sptr const& trk );
   bool m_active_writing;
   bool m_write_time_as_uid;
 
@@ -96,9 +271,91 @@ public:
   std::map< unsigned, std::string > m_frame_uids;
   double m_mask_to_poly_tol;
   int m_mask_to_poly_points;
+  unsigned m_write_block_size;
+  unsigned m_async_write_queue;
+  unsigned m_mask_cache_size;
+  unsigned m_checkpoint_interval;
+  bool m_resume;
+
+  // Output file checkpoints are kept for, and its stream when appending
+  std::string m_filename;
+  std::unique_ptr< std::ofstream > m_resume_stream;
+  unsigned m_frames_since_checkpoint;
+  kwiver::vital::frame_id_t m_last_frame;
+
+  // Track ids of a resumed run follow those of the previous run
+  std::uint64_t m_track_id_offset;
+  std::uint64_t m_next_track_id;
+
+  // Tracks written as soon as they terminate instead of on close
+  bool m_finalize_tracks;
+  unsigned m_track_timeout;
+
+  // Derived from m_tot_option
+  bool m_tot_weighted;
+  bool m_tot_scaled;
+
+  // A track seen so far, with the states already folded into its average
+  struct track_entry
+  {
+    track_entry() : accumulated( 0 ), last_seen( 0 ) { }
+
+    kwiver::vital::track_sptr track;
+    tot_accumulator tot;
+    size_t accumulated;
+    std::uint64_t last_seen;
+  };
+
+  std::map< unsigned, track_entry > m_track_entries;
+  std::unordered_set< unsigned > m_finalized_ids;
+  std::uint64_t m_set_count;
+
+  // Formatted rows not yet written to the stream
+  csv_row_buffer m_buffer;
+
+  // Attribute fields of the current detection, reused across rows
+  std::string m_attributes;
+
+#ifdef VIAME_ENABLE_OPENCV
+  // Simplified contour of a mask, in mask coordinates
+  struct mask_polygon
+  {
+    bool is_hole;
+    std::vector< cv::Point > points;
+  };
+
+  // Polygons of a previously seen mask, keyed on a hash of its pixels
+  struct mask_cache_entry
+  {
+    cv::Mat mask;
+    std::vector< mask_polygon > polygons;
+  };
+
+  std::unordered_multimap< std::uint64_t, mask_cache_entry > m_mask_cache;
+  std::vector< std::vector< cv::Point > > m_contours;
+  std::vector< cv::Vec4i > m_hierarchy;
+
+  std::vector< mask_polygon > const& mask_to_polygons( cv::Mat const& mask );
+  void simplify_contours( std::vector< mask_polygon >& polygons );
+#endif
 
   std::string format_image_id( const kwiver::vital::object_track_state* ts );
-  void write_detection_info(std::ostream& stream, const kwiver::vital::detected_object_sptr& det);
+  void write_detection_info(csv_row_buffer& stream, const kwiver::vital::detected_object_sptr& det);
+  void flush_rows();
+
+  // Fold the states added to a track since the last call into its average
+  track_entry& update_track( kwiver::vital::track_sptr const& trk );
+  kwiver::vital::detected_object_type_sptr average_tot( tot_accumulator const& tot ) const;
+
+  // Write every state of a track, using the given type for all of them
+  void write_track( kwiver::vital::track_sptr const& trk,
+                    kwiver::vital::detected_object_type_sptr const& trk_tot );
+
+  // Write and forget tracks missing from the last set or timed out
+  void finalize_tracks( kwiver::vital::frame_id_t frame );
+
+  // Flush all rows and record the progress made so far
+  void write_checkpoint();
 };
 
 std::string
@@ -137,7 +394,156 @@ write_object_track_set_viame_csv::priv
   }
 }
 
-void write_object_track_set_viame_csv::priv::write_detection_info(std::ostream &stream,
+void write_object_track_set_viame_csv::priv::flush_rows()
+{
+  // Flush stream to prevent buffer issues, unless writing in blocks
+  if( m_write_block_size == 0 )
+  {
+    m_buffer.flush( m_parent->stream() );
+  }
+}
+
+void write_object_track_set_viame_csv::priv::write_checkpoint()
+{
+  m_frames_since_checkpoint = 0;
+
+  if( m_filename.empty() )
+  {
+    return;
+  }
+
+  std::ostream& stream = m_parent->stream();
+
+  m_buffer.flush( stream );
+  m_buffer.wait();
+  stream.flush();
+
+  const std::streamoff offset = stream.tellp();
+
+  if( offset < 0 )
+  {
+    return;
+  }
+
+  csv_checkpoint checkpoint;
+  checkpoint.frame = m_last_frame;
+  checkpoint.offset = static_cast< std::uint64_t >( offset );
+  checkpoint.next_id = m_next_track_id;
+
+  if( !write_csv_checkpoint( csv_checkpoint_path( m_filename ), checkpoint ) )
+  {
+    LOG_WARN( m_logger, "Unable to write checkpoint for " << m_filename );
+  }
+}
+
+#ifdef VIAME_ENABLE_OPENCV
+// -------------------------------------------------------------------------------
+static std::uint64_t
+hash_mask( cv::Mat const& mask )
+{
+  // FNV-1a over the mask size and pixel rows
+  std::uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash]( unsigned char const* data, size_t size )
+  {
+    for( size_t i = 0; i < size; ++i )
+    {
+      hash = ( hash ^ data[i] ) * 1099511628211ull;
+    }
+  };
+
+  int const header[] = { mask.rows, mask.cols, mask.type() };
+  mix( reinterpret_cast< unsigned char const* >( header ), sizeof( header ) );
+
+  size_t const row_size = mask.cols * mask.elemSize();
+  for( int r = 0; r < mask.rows; ++r )
+  {
+    mix( mask.ptr< unsigned char >( r ), row_size );
+  }
+  return hash;
+}
+
+std::vector< write_object_track_set_viame_csv::priv::mask_polygon > const&
+write_object_track_set_viame_csv::priv
+::mask_to_polygons( cv::Mat const& mask )
+{
+  // Track states of a slowly changing object often carry identical masks,
+  // so reuse the polygons of a previous mask with the same pixels
+  std::uint64_t const key = hash_mask( mask );
+  auto range = m_mask_cache.equal_range( key );
+  for( auto itr = range.first; itr != range.second; ++itr )
+  {
+    cv::Mat const& cached = itr->second.mask;
+    if( cached.size() == mask.size() && cached.type() == mask.type() &&
+        cv::norm( cached, mask, cv::NORM_INF ) == 0 )
+    {
+      return itr->second.polygons;
+    }
+  }
+
+  if( m_mask_cache.size() >= m_mask_cache_size )
+  {
+    m_mask_cache.clear();
+  }
+
+  mask_cache_entry entry;
+
+#if CV_VERSION_MAJOR > 3 || ( CV_VERSION_MAJOR == 3 && CV_VERSION_MINOR >= 2 )
+  cv::findContours( mask, m_contours, m_hierarchy,
+                    cv::RETR_CCOMP, cv::CHAIN_APPROX_SIMPLE );
+#else
+  // Pre-3.2 OpenCV may modify the passed image, so we clone it.
+  cv::findContours( mask.clone(), m_contours, m_hierarchy,
+                    cv::RETR_CCOMP, cv::CHAIN_APPROX_SIMPLE );
+#endif
+  simplify_contours( entry.polygons );
+
+  if( m_mask_cache_size == 0 )
+  {
+    m_mask_cache.clear();
+  }
+  else
+  {
+    entry.mask = mask.clone();
+  }
+
+  // References to multimap elements remain valid across rehashing
+  return m_mask_cache.emplace( key, std::move( entry ) )->second.polygons;
+}
+
+void
+write_object_track_set_viame_csv::priv
+::simplify_contours( std::vector< mask_polygon >& polygons )
+{
+  polygons.resize( m_contours.size() );
+  for( size_t i = 0; i < m_contours.size(); ++i )
+  {
+    auto& contour = m_contours[i];
+    int x_min, x_max, y_min, y_max;
+    x_min = x_max = contour[0].x;
+    y_min = y_max = contour[0].y;
+    for( size_t j = 1; j < contour.size(); ++j )
+    {
+      x_min = std::min( x_min, contour[j].x );
+      x_max = std::max( x_max, contour[j].x );
+      y_min = std::min( y_min, contour[j].y );
+      y_max = std::max( y_max, contour[j].y );
+    }
+    if( m_mask_to_poly_tol >= 0 )
+    {
+      double tol = m_mask_to_poly_tol * std::min( x_max - x_min + 1,
+                                                  y_max - y_min + 1 );
+      cv::approxPolyDP( contour, polygons[i].points, tol, /*closed:*/ true );
+    }
+    else
+    {
+      polygons[i].points = simplify_polygon( contour, m_mask_to_poly_points );
+    }
+    polygons[i].is_hole = ( m_hierarchy[i][3] >= 0 );
+  }
+}
+#endif
+
+void write_object_track_set_viame_csv::priv::write_detection_info(csv_row_buffer &stream,
                                                                   const kwiver::vital::detected_object_sptr &det) {
   // Sanity return in case method was called with empty detection
   if(!det)
@@ -167,37 +573,10 @@ void write_object_track_set_viame_csv::priv::write_detection_info(std::ostream &
     auto ref_y = static_cast< int >( bbox.min_y() );
     cv::Mat mask = ic::vital_to_ocv( det->mask()->get_image(),
                                      ic::OTHER_COLOR );
-    std::vector< std::vector< cv::Point > > contours;
-    std::vector< cv::Vec4i > hierarchy;
-    // Pre-3.2 OpenCV may modify the passed image, so we clone it.
-    cv::findContours( mask.clone(), contours, hierarchy,
-                      cv::RETR_CCOMP, cv::CHAIN_APPROX_SIMPLE );
-    for( size_t i = 0; i < contours.size(); ++i )
+    for( auto const& polygon : mask_to_polygons( mask ) )
     {
-      auto& contour = contours[i];
-      int x_min, x_max, y_min, y_max;
-      x_min = x_max = contour[0].x;
-      y_min = y_max = contour[0].y;
-      for( size_t j = 1; j < contour.size(); ++j )
-      {
-        x_min = std::min( x_min, contour[j].x );
-        x_max = std::max( x_max, contour[j].x );
-        y_min = std::min( y_min, contour[j].y );
-        y_max = std::max( y_max, contour[j].y );
-      }
-      std::vector< cv::Point > simp_contour;
-      if( m_mask_to_poly_tol >= 0 )
-      {
-        double tol = m_mask_to_poly_tol * std::min( x_max - x_min + 1,
-                                                    y_max - y_min + 1 );
-        cv::approxPolyDP( contour, simp_contour, tol, /*closed:*/ true );
-      }
-      else
-      {
-        simp_contour = simplify_polygon( contour, m_mask_to_poly_points );
-      }
-      stream << ( hierarchy[i][3] < 0 ? m_delim  + "(poly)" : m_delim  + "(hole)" );
-      for( auto&& p : simp_contour )
+      stream << m_delim << ( polygon.is_hole ? "(hole)" : "(poly)" );
+      for( auto&& p : polygon.points )
       {
         stream << " " << p.x + ref_x << " " << p.y + ref_y;
       }
@@ -216,110 +595,162 @@ void write_object_track_set_viame_csv::priv::write_detection_info(std::ostream &
 
   if( !det->notes().empty() )
   {
-    stream << notes_to_attributes( det->notes(), m_delim );
+    m_attributes.clear();
+    notes_to_attributes( det->notes(), m_delim, m_attributes );
+    stream << m_attributes;
+  }
+}
+
+void
+write_object_track_set_viame_csv::priv
+::hold_track( kwiver::vital::track_sptr const& trk )
+{
+  held_track& held = m_held_tracks[ trk->id() ];
+
+  // A rebuilt track replaces the states counted so far
+  if( trk->size() < held.states )
+  {
+    m_tracks_memory.remove( held.bytes );
+    held = held_track();
+  }
+
+  const size_t bytes = image_memory_size( *trk, held.states );
+
+  m_tracks_memory.add( bytes );
+  held.bytes += bytes;
+  held.states = trk->size();
+}
+
+write_object_track_set_viame_csv::priv::track_entry&
+write_object_track_set_viame_csv::priv
+::update_track( kwiver::vital::track_sptr const& trk )
+{
+  track_entry& entry = m_track_entries[ trk->id() ];
+
+  // A tracker may hand back a rebuilt track, fold it in from the start
+  if( entry.track != trk && trk->size() < entry.accumulated )
+  {
+    entry.tot = tot_accumulator();
+    entry.accumulated = 0;
   }
+
+  entry.track = trk;
+  entry.last_seen = m_set_count;
+
+  if( m_tot_option == "detection" )
+  {
+    entry.accumulated = trk->size();
+    return entry;
+  }
+
+  for( auto itr = trk->begin() + entry.accumulated; itr != trk->end(); ++itr )
+  {
+    entry.tot.add(
+      dynamic_cast< kwiver::vital::object_track_state const* >( itr->get() ),
+      m_tot_weighted, m_tot_scaled, m_tot_ignore_class );
+  }
+
+  entry.accumulated = trk->size();
+  return entry;
 }
 
+
 kwiver::vital::detected_object_type_sptr
-compute_average_tot( kwiver::vital::track_sptr trk_ptr,
-                     bool weighted = false,
-                     bool scale_by_conf = false,
-                     std::string ignore_class = "" )
+write_object_track_set_viame_csv::priv
+::average_tot( tot_accumulator const& tot ) const
 {
-  if( !trk_ptr )
+  if( m_tot_option == "detection" )
   {
     return kwiver::vital::detected_object_type_sptr();
   }
 
-  std::vector< std::string > output_names;
-  std::vector< double > output_scores;
-
-  double weighted_mass = 0.0;
-  double weighted_non_ignore_mass = 0.0;
-  double weighted_ignore_mass = 0.0;
+  return tot.average( m_tot_scaled, m_tot_ignore_class );
+}
 
-  std::map< std::string, double > class_sum;
-  double ignore_sum = 0.0;
-  double conf_sum = 0.0;
-  unsigned conf_count = 0;
 
+void
+write_object_track_set_viame_csv::priv
+::write_track( kwiver::vital::track_sptr const& trk_ptr,
+               kwiver::vital::detected_object_type_sptr const& trk_average_tot )
+{
   for( auto ts_ptr : *trk_ptr )
   {
     kwiver::vital::object_track_state* ts =
-      static_cast< kwiver::vital::object_track_state* >( ts_ptr.get() );
+      dynamic_cast< kwiver::vital::object_track_state* >( ts_ptr.get() );
 
-    if( !ts->detection() )
+    if( !ts )
     {
+      LOG_ERROR( m_logger, "Invalid timestamp " << trk_ptr->id()
+                                                << " " << trk_ptr->size() );
       continue;
     }
 
-    kwiver::vital::detected_object_type_sptr dot = ts->detection()->type();
-
-    if( dot )
+    kwiver::vital::detected_object_sptr det = ts->detection();
+    const kwiver::vital::bounding_box_d empty_box =
+      kwiver::vital::bounding_box_d( -1, -1, -1, -1 );
+    kwiver::vital::bounding_box_d bbox = ( det ? det->bounding_box() : empty_box );
+    auto confidence = ( det ? det->confidence() : 0 );
+    int frame_id = ts->frame() + m_frame_id_adjustment;
+
+    m_buffer << trk_ptr->id() << m_delim            // 1: track id
+             << format_image_id( ts ) << m_delim    // 2: video or image id
+             << frame_id << m_delim                 // 3: frame number
+             << bbox.min_x() << m_delim             // 4: TL-x
+             << bbox.min_y() << m_delim             // 5: TL-y
+             << bbox.max_x() << m_delim             // 6: BR-x
+             << bbox.max_y() << m_delim             // 7: BR-y
+             << confidence << m_delim               // 8: confidence
+             << "0";                                // 9: length
+
+    if( det )
     {
-      double weight = ( weighted ? ts->detection()->confidence() : 1.0 );
+      const kwiver::vital::detected_object_type_sptr dot =
+        ( m_tot_option == "detection" ? det->type() : trk_average_tot );
 
-      if( scale_by_conf )
+      if( dot )
       {
-        conf_sum += ts->detection()->confidence();
-        conf_count += 1;
-      }
-
-      bool ignore = ( dot->class_names().size() == 1 &&
-                      dot->class_names()[0] == ignore_class );
-
-      if( ignore )
-      {
-        ignore_sum += ( dot->score( ignore_class ) * weight );
-        weighted_ignore_mass += weight;
-      }
-      else
-      {
-        for( const auto name : dot->class_names() )
+        const auto name_list( dot->class_names() );
+        for( const auto& name : name_list )
         {
-          class_sum[ name ] += ( dot->score( name ) * weight );
+          m_buffer << m_delim << name << m_delim << dot->score( name );
         }
-        weighted_non_ignore_mass += weight;
       }
 
-      weighted_mass += weight;
+      write_detection_info( m_buffer, det );
+
+      m_buffer.end_row( m_parent->stream() );
     }
   }
 
-  double prob_scale_factor = 1.0;
+  flush_rows();
+}
 
-  if( scale_by_conf && conf_count > 0 )
-  {
-    prob_scale_factor = 0.1 + 0.9 * ( conf_sum / conf_count );
-  }
 
-  if( weighted_mass > 0.0 && weighted_ignore_mass == 0.0 )
-  {
-    prob_scale_factor /= weighted_mass;
-  }
-  else if( weighted_ignore_mass > 0.0 && weighted_non_ignore_mass > 0.0 )
-  {
-    prob_scale_factor /= weighted_non_ignore_mass;
-  }
-  else if( weighted_ignore_mass > 0.0 )
+void
+write_object_track_set_viame_csv::priv
+::finalize_tracks( kwiver::vital::frame_id_t frame )
+{
+  for( auto itr = m_track_entries.begin(); itr != m_track_entries.end(); )
   {
-    class_sum[ ignore_class ] = ignore_sum;
-    prob_scale_factor /= weighted_ignore_mass;
-  }
+    track_entry& entry = itr->second;
 
-  for( auto itr : class_sum )
-  {
-    output_names.push_back( itr.first );
-    output_scores.push_back( prob_scale_factor * itr.second );
-  }
+    bool terminated = ( entry.last_seen != m_set_count );
 
-  if( output_names.empty() )
-  {
-    return kwiver::vital::detected_object_type_sptr();
-  }
+    if( !terminated && m_track_timeout > 0 && !entry.track->empty() )
+    {
+      terminated = ( entry.track->last_frame() + m_track_timeout < frame );
+    }
 
-  return std::make_shared< kwiver::vital::detected_object_type >(
-    output_names, output_scores );
+    if( !terminated )
+    {
+      ++itr;
+      continue;
+    }
+
+    write_track( entry.track, average_tot( entry.tot ) );
+    m_finalized_ids.insert( itr->first );
+    itr = m_track_entries.erase( itr );
+  }
 }
 
 
@@ -334,6 +765,55 @@ write_object_track_set_viame_csv
 write_object_track_set_viame_csv
 ::~write_object_track_set_viame_csv()
 {
+  // Rows are only left in the buffer while the stream is still open
+  if( !d->m_buffer.empty() )
+  {
+    d->m_buffer.flush( stream() );
+  }
+}
+
+
+void write_object_track_set_viame_csv
+::open( std::string const& filename )
+{
+  d->m_filename = filename;
+  d->m_frames_since_checkpoint = 0;
+  d->m_resume_stream.reset();
+
+  csv_checkpoint checkpoint;
+
+  // Without active writing all rows are only written on close
+  if( d->m_resume && !d->m_active_writing )
+  {
+    LOG_WARN( d->m_logger, "Resuming track output requires active_writing, "
+                           "overwriting " << filename );
+  }
+  else if( d->m_resume &&
+           read_csv_checkpoint( csv_checkpoint_path( filename ), checkpoint ) &&
+           truncate_to_csv_checkpoint( filename, checkpoint ) )
+  {
+    d->m_resume_stream.reset( new std::ofstream( filename,
+      std::ios::in | std::ios::out | std::ios::ate ) );
+
+    if( *d->m_resume_stream )
+    {
+      use_stream( d->m_resume_stream.get() );
+
+      // The header was already written by the previous run
+      d->m_first = false;
+      d->m_last_frame = checkpoint.frame;
+      d->m_track_id_offset = checkpoint.next_id;
+      d->m_next_track_id = checkpoint.next_id;
+
+      LOG_INFO( d->m_logger, "Resuming " << filename << " after frame "
+                             << checkpoint.frame );
+      return;
+    }
+
+    d->m_resume_stream.reset();
+  }
+
+  write_object_track_set::open( filename );
 }
 
 
@@ -342,74 +822,61 @@ void write_object_track_set_viame_csv
 {
   if( d->m_active_writing )
   {
-    // No flushing required
+    if( d->m_checkpoint_interval > 0 && !d->m_first )
+    {
+      d->write_checkpoint();
+    }
+
+    // Only rows kept for block writing remain
+    if( !d->m_buffer.empty() )
+    {
+      d->m_buffer.flush( stream() );
+    }
+    d->m_buffer.wait();
     write_object_track_set::close();
+
+    d->m_track_entries.clear();
+    d->m_resume_stream.reset();
+    d->m_filename.clear();
     return;
   }
 
-  for( auto trk_pair : d->m_tracks )
+  // Tracks still active at the end of the stream
+  for( auto& entry_pair : d->m_track_entries )
   {
-    auto trk_ptr = trk_pair.second;
+    d->write_track( entry_pair.second.track,
+                    d->average_tot( entry_pair.second.tot ) );
+  }
 
-    const kwiver::vital::detected_object_type_sptr trk_average_tot =
-          ( d->m_tot_option == "detection" ? kwiver::vital::detected_object_type_sptr()
-            : compute_average_tot( trk_ptr,
-                d->m_tot_option.find( "weighted" ) != std::string::npos,
-                d->m_tot_option.find( "scaled_by_conf" ) != std::string::npos,
-                d->m_tot_ignore_class ) );
+  d->m_track_entries.clear();
+  d->m_finalized_ids.clear();
 
-    for( auto ts_ptr : *trk_ptr )
-    {
-      kwiver::vital::object_track_state* ts =
-        dynamic_cast< kwiver::vital::object_track_state* >( ts_ptr.get() );
+  for( auto trk_pair : d->m_tracks )
+  {
+    tot_accumulator tot;
 
-      if( !ts )
+    if( d->m_tot_option != "detection" )
+    {
+      for( auto ts_ptr : *trk_pair.second )
       {
-        LOG_ERROR( d->m_logger, "Invalid timestamp " << trk_ptr->id()
-                                                     << " " << trk_ptr->size() );
-        continue;
+        tot.add(
+          dynamic_cast< kwiver::vital::object_track_state const* >( ts_ptr.get() ),
+          d->m_tot_weighted, d->m_tot_scaled, d->m_tot_ignore_class );
       }
+    }
 
-      kwiver::vital::detected_object_sptr det = ts->detection();
-      const kwiver::vital::bounding_box_d empty_box =
-        kwiver::vital::bounding_box_d( -1, -1, -1, -1 );
-      kwiver::vital::bounding_box_d bbox = ( det ? det->bounding_box() : empty_box );
-      auto confidence = ( det ? det->confidence() : 0 );
-      int frame_id = ts->frame() + d->m_frame_id_adjustment;
-
-      stream() << trk_ptr->id() << d->m_delim            // 1: track id
-               << d->format_image_id( ts ) << d->m_delim // 2: video or image id
-               << frame_id << d->m_delim                 // 3: frame number
-               << bbox.min_x() << d->m_delim             // 4: TL-x
-               << bbox.min_y() << d->m_delim             // 5: TL-y
-               << bbox.max_x() << d->m_delim             // 6: BR-x
-               << bbox.max_y() << d->m_delim             // 7: BR-y
-               << confidence << d->m_delim               // 8: confidence
-               << "0";                                   // 9: length
-
-      if( det )
-      {
-        const kwiver::vital::detected_object_type_sptr dot =
-          ( d->m_tot_option == "detection" ? det->type() : trk_average_tot );
-
-        if( dot )
-        {
-          const auto name_list( dot->class_names() );
-          for( auto name : name_list )
-          {
-            stream() << d->m_delim << name << d->m_delim << dot->score( name );
-          }
-        }
+    d->write_track( trk_pair.second, d->average_tot( tot ) );
+  }
 
-        d->write_detection_info(stream(), det);
+  d->m_tracks.clear();
+  d->m_held_tracks.clear();
+  d->m_tracks_memory.clear();
 
-        stream() << std::endl;
-      }
-    }
-
-    // Flush stream to prevent buffer issues
-    stream().flush();
+  if( !d->m_buffer.empty() )
+  {
+    d->m_buffer.flush( stream() );
   }
+  d->m_buffer.wait();
 
   write_object_track_set::close();
 }
@@ -442,6 +909,29 @@ write_object_track_set_viame_csv
       config->get_value< double >( "mask_to_poly_tol", d->m_mask_to_poly_tol );
   d->m_mask_to_poly_points =
       config->get_value< int >( "mask_to_poly_points", d->m_mask_to_poly_points );
+  d->m_write_block_size =
+    config->get_value< unsigned >( "write_block_size", d->m_write_block_size );
+  d->m_async_write_queue =
+    config->get_value< unsigned >( "async_write_queue", d->m_async_write_queue );
+  d->m_mask_cache_size =
+    config->get_value< unsigned >( "mask_cache_size", d->m_mask_cache_size );
+  d->m_checkpoint_interval =
+    config->get_value< unsigned >( "checkpoint_interval", d->m_checkpoint_interval );
+  d->m_resume =
+    config->get_value< bool >( "resume", d->m_resume );
+  d->m_finalize_tracks =
+    config->get_value< bool >( "finalize_terminated_tracks", d->m_finalize_tracks );
+  d->m_track_timeout =
+    config->get_value< unsigned >( "track_timeout_frames", d->m_track_timeout );
+
+  d->m_tot_weighted = ( d->m_tot_option.find( "weighted" ) != std::string::npos );
+  d->m_tot_scaled = ( d->m_tot_option.find( "scaled_by_conf" ) != std::string::npos );
+
+  d->m_buffer.set_block_size( d->m_write_block_size );
+  d->m_buffer.set_async( d->m_async_write_queue );
+#ifdef VIAME_ENABLE_OPENCV
+  d->m_mask_cache.clear();
+#endif
 
   if( d->m_mask_to_poly_tol >= 0 && d->m_mask_to_poly_points >= 0 )
   {
@@ -522,18 +1012,38 @@ write_object_track_set_viame_csv
     d->m_frame_uids[ ts.get_frame() ] = file_id;
   }
 
+  if( ts.has_valid_frame() )
+  {
+    d->m_last_frame = ts.get_frame();
+  }
+
   if( !set )
   {
     return;
   }
 
-  if( !d->m_active_writing )
+  d->m_set_count++;
+
+  if( !d->m_active_writing && !d->m_finalize_tracks )
   {
     for( auto trk : set->tracks() )
     {
       d->m_tracks[ trk->id() ] = trk;
+      d->hold_track( trk );
     }
   }
+  else if( !d->m_active_writing )
+  {
+    for( auto trk : set->tracks() )
+    {
+      if( trk && !trk->empty() && !d->m_finalized_ids.count( trk->id() ) )
+      {
+        d->update_track( trk );
+      }
+    }
+
+    d->finalize_tracks( ts.has_valid_frame() ? ts.get_frame() : d->m_last_frame );
+  }
   else
   {
     for( auto trk_ptr : set->tracks() )
@@ -544,6 +1054,8 @@ write_object_track_set_viame_csv
         continue;
       }
 
+      priv::track_entry& entry = d->update_track( trk_ptr );
+
       kwiver::vital::object_track_state* state =
         dynamic_cast< kwiver::vital::object_track_state* >( trk_ptr->back().get() );
 
@@ -571,43 +1083,61 @@ write_object_track_set_viame_csv
 
       auto confidence = ( det ? det->confidence() : 0 );
       int frame_id = state->frame() + d->m_frame_id_adjustment;
+      const std::uint64_t track_id = trk_ptr->id() + d->m_track_id_offset;
 
-      stream() << trk_ptr->id() << d->m_delim               // 1: track id
-               << d->format_image_id( state ) << d->m_delim // 2: video or image id
-               << frame_id << d->m_delim                    // 3: frame number
-               << bbox.min_x() << d->m_delim                // 4: TL-x
-               << bbox.min_y() << d->m_delim                // 5: TL-y
-               << bbox.max_x() << d->m_delim                // 6: BR-x
-               << bbox.max_y() << d->m_delim                // 7: BR-y
-               << confidence << d->m_delim                  // 8: confidence
-               << "0";                                      // 9: length
+      d->m_next_track_id = std::max( d->m_next_track_id, track_id + 1 );
+
+      d->m_buffer << track_id << d->m_delim                    // 1: track id
+                  << d->format_image_id( state ) << d->m_delim // 2: video or image id
+                  << frame_id << d->m_delim                    // 3: frame number
+                  << bbox.min_x() << d->m_delim                // 4: TL-x
+                  << bbox.min_y() << d->m_delim                // 5: TL-y
+                  << bbox.max_x() << d->m_delim                // 6: BR-x
+                  << bbox.max_y() << d->m_delim                // 7: BR-y
+                  << confidence << d->m_delim                  // 8: confidence
+                  << "0";                                      // 9: length
 
       if( det )
       {
         const kwiver::vital::detected_object_type_sptr dot =
           ( d->m_tot_option == "detection" ? det->type() :
-            compute_average_tot( trk_ptr,
-              d->m_tot_option.find( "weighted" ) != std::string::npos,
-              d->m_tot_option.find( "scaled_by_conf" ) != std::string::npos,
-              d->m_tot_ignore_class ) );
+            d->average_tot( entry.tot ) );
 
         if( dot )
         {
           const auto name_list( dot->class_names() );
-          for( auto name : name_list )
+          for( const auto& name : name_list )
           {
-            stream() << d->m_delim << name << d->m_delim << dot->score( name );
+            d->m_buffer << d->m_delim << name << d->m_delim << dot->score( name );
           }
         }
 
-        d->write_detection_info(stream(), det);
+        d->write_detection_info( d->m_buffer, det );
+
+        d->m_buffer.end_row( stream() );
+      }
+    }
 
-        stream() << std::endl;
+    // Tracks left out of the set are never written again
+    for( auto itr = d->m_track_entries.begin(); itr != d->m_track_entries.end(); )
+    {
+      if( itr->second.last_seen != d->m_set_count )
+      {
+        itr = d->m_track_entries.erase( itr );
+      }
+      else
+      {
+        ++itr;
       }
     }
 
-    // Flush stream to prevent buffer issues
-    stream().flush();
+    d->flush_rows();
+  }
+
+  if( d->m_active_writing && d->m_checkpoint_interval > 0 &&
+      ++d->m_frames_since_checkpoint >= d->m_checkpoint_interval )
+  {
+    d->write_checkpoint();
   }
 }
 
@@ -71,6 +71,7 @@ public:
                           const kwiver::vital::timestamp& ts,
                           const std::string& file_id );
 
+  virtual void open( std::string const& filename );
   virtual void close();
 
 private:
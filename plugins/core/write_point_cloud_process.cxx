@@ -0,0 +1,225 @@
+/**
+ * \file
+ * \brief Write the 3D points of stereo depth maps to a binary point cloud file
+ */
+
+#include "write_point_cloud_process.h"
+#include "process_trace.h"
+
+#include <vital/vital_types.h>
+#include <vital/types/timestamp.h>
+#include <vital/exceptions.h>
+
+#include <arrows/ocv/image_container.h>
+#include <sprokit/pipeline/process_exception.h>
+#include <sprokit/processes/kwiver_type_traits.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace kv = kwiver::vital;
+
+namespace viame {
+namespace core {
+
+create_config_trait(cameras_directory, std::string, "", "The calibrated cameras files directory")
+create_config_trait(file_name, std::string, "point_cloud.ply",
+                    "Output point cloud file. Points of every frame are written to the same file unless the name "
+                    "contains a printf integer pattern such as cloud_%06d.ply, which writes one file per frame.")
+create_config_trait(format, std::string, "",
+                    "Output format, ply or las. Deduced from the file_name extension when empty.")
+create_config_trait(row_block_size, int, "64",
+                    "Number of depth map rows reprojected to 3D at a time. Bounds the memory used per frame.")
+create_config_trait(voxel_size, double, "0",
+                    "If positive, average each frame's points over a voxel grid of this size, in calibration units, "
+                    "and only write the voxel averages.")
+create_config_trait(fixed_point_disparity_scale, float, "16",
+                    "Scale of CV_16S fixed-point disparity maps. Disparity in pixels is the map value divided by this "
+                    "scale.")
+create_config_trait(las_scale, double, "0.001", "Coordinate resolution of LAS files, in calibration units.")
+
+// =============================================================================
+write_point_cloud_process::write_point_cloud_process(kv::config_block_sptr const &config)
+    : process(config), d(new detections_pairing_from_stereo()) {
+  make_ports();
+  make_config();
+}
+
+
+write_point_cloud_process::~write_point_cloud_process() = default;
+
+
+// -----------------------------------------------------------------------------
+void write_point_cloud_process::make_ports() {
+  sprokit::process::port_flags_t required;
+  sprokit::process::port_flags_t optional;
+
+  required.insert(flag_required);
+
+  // -- inputs --
+  declare_input_port_using_trait(depth_map, required);
+  declare_input_port_using_trait(image, optional);
+  declare_input_port_using_trait(timestamp, optional);
+}
+
+// -----------------------------------------------------------------------------
+void write_point_cloud_process::make_config() {
+  declare_config_using_trait(cameras_directory);
+  declare_config_using_trait(file_name);
+  declare_config_using_trait(format);
+  declare_config_using_trait(row_block_size);
+  declare_config_using_trait(voxel_size);
+  declare_config_using_trait(fixed_point_disparity_scale);
+  declare_config_using_trait(las_scale);
+}
+
+// -----------------------------------------------------------------------------
+void write_point_cloud_process::_configure() {
+  d->m_cameras_directory = config_value_using_trait(cameras_directory);
+  d->m_fixed_point_disparity_scale = config_value_using_trait(fixed_point_disparity_scale);
+  d->load_camera_calibration();
+
+  m_file_name = config_value_using_trait(file_name);
+  m_format = config_value_using_trait(format);
+  m_row_block_size = config_value_using_trait(row_block_size);
+  m_voxel_size = config_value_using_trait(voxel_size);
+  m_las_scale = config_value_using_trait(las_scale);
+
+  std::transform(m_format.begin(), m_format.end(), m_format.begin(), ::tolower);
+
+  if (m_file_name.empty())
+    VITAL_THROW(sprokit::invalid_configuration_exception, name(), "file_name must be set");
+  if (!m_format.empty() && m_format != "ply" && m_format != "las")
+    VITAL_THROW(sprokit::invalid_configuration_exception, name(), "format must be one of ply, las");
+  if (m_row_block_size <= 0)
+    VITAL_THROW(sprokit::invalid_configuration_exception, name(), "row_block_size must be positive");
+  if (!(m_las_scale > 0.))
+    VITAL_THROW(sprokit::invalid_configuration_exception, name(), "las_scale must be positive");
+
+  m_per_frame_files = m_file_name.find('%') != std::string::npos;
+  m_frame_counter = 0;
+  m_writer.reset();
+}
+
+// -----------------------------------------------------------------------------
+point_cloud_writer &write_point_cloud_process::writer_for_frame(kv::frame_id_t frame) {
+  if (m_writer && !m_per_frame_files)
+    return *m_writer;
+
+  if (m_writer)
+    m_writer->close();
+
+  std::string path = m_file_name;
+  if (m_per_frame_files) {
+    char buffer[4096];
+    std::snprintf(buffer, sizeof(buffer), m_file_name.c_str(), static_cast<int>(frame));
+    path = buffer;
+  }
+
+  const auto fmt = m_format.empty() ? point_cloud_writer::format_from_path(path)
+                                    : (m_format == "las" ? point_cloud_writer::format::LAS
+                                                         : point_cloud_writer::format::PLY);
+
+  // Color is written when an image is connected, so that every frame has the same point layout
+  m_writer.reset(new point_cloud_writer(path, fmt, has_input_port_edge_using_trait(image), m_voxel_size, m_las_scale));
+  return *m_writer;
+}
+
+// -----------------------------------------------------------------------------
+void write_point_cloud_process::_step() {
+  process_step_trace trace(name());
+
+  auto port_info = peek_at_port_using_trait(depth_map);
+
+  if (port_info.datum->type() == sprokit::datum::complete) {
+    grab_edge_datum_using_trait(depth_map);
+    if (has_input_port_edge_using_trait(image))
+      grab_edge_datum_using_trait(image);
+    if (has_input_port_edge_using_trait(timestamp))
+      grab_edge_datum_using_trait(timestamp);
+    trace.inputs_ready();
+
+    if (m_writer)
+      m_writer->close();
+    m_writer.reset();
+
+    mark_process_as_complete();
+    return;
+  }
+
+  auto depth_map = grab_from_port_using_trait(depth_map);
+
+  kv::image_container_sptr image;
+  if (has_input_port_edge_using_trait(image))
+    image = grab_from_port_using_trait(image);
+
+  kv::frame_id_t frame = m_frame_counter++;
+  if (has_input_port_edge_using_trait(timestamp)) {
+    auto ts = grab_from_port_using_trait(timestamp);
+    if (ts.has_valid_frame())
+      frame = ts.get_frame();
+  }
+
+  trace.inputs_ready();
+
+  auto &writer = writer_for_frame(frame);
+
+  if (!depth_map) {
+    writer.end_frame();
+    return;
+  }
+
+  auto cv_disparity_left = kwiver::arrows::ocv::image_container::vital_to_ocv(depth_map->get_image(),
+                                                                              kwiver::arrows::ocv::image_container::BGR_COLOR);
+
+  cv::Mat cv_color;
+  if (image) {
+    cv_color = kwiver::arrows::ocv::image_container::vital_to_ocv(image->get_image(),
+                                                               kwiver::arrows::ocv::image_container::RGB_COLOR);
+    if (cv_color.size() != cv_disparity_left.size() || cv_color.depth() != CV_8U)
+      VITAL_THROW(kv::invalid_data, "Point cloud color image must be an 8 bit image of the depth map size");
+  }
+
+  // Reproject a block of rows at a time, reusing the block buffers from one block to the next
+  const size_t points_before = writer.point_count();
+  cv::Mat pos_3d_block, disparity_block;
+  std::uint8_t rgb[3];
+
+  for (int first_row = 0; first_row < cv_disparity_left.rows; first_row += m_row_block_size) {
+    const int row_count = std::min(m_row_block_size, cv_disparity_left.rows - first_row);
+
+    d->reproject_3d_depth_map_rows(cv_disparity_left, first_row, row_count, pos_3d_block);
+    cv_disparity_left.rowRange(first_row, first_row + row_count).convertTo(disparity_block, CV_32F);
+
+    for (int r = 0; r < row_count; ++r) {
+      const auto *points = pos_3d_block.ptr<cv::Vec3f>(r);
+      const auto *disparities = disparity_block.ptr<float>(r);
+      const std::uint8_t *colors = cv_color.empty() ? nullptr : cv_color.ptr<std::uint8_t>(first_row + r);
+      const int channels = cv_color.empty() ? 0 : cv_color.channels();
+
+      for (int c = 0; c < cv_disparity_left.cols; ++c) {
+        if (!(disparities[c] > 0.f))
+          continue;
+
+        const cv::Vec3f &p = points[c];
+        if (!std::isfinite(p[0]) || !std::isfinite(p[1]) || !std::isfinite(p[2]))
+          continue;
+
+        if (colors) {
+          const std::uint8_t *pixel = colors + c * channels;
+          rgb[0] = pixel[0];
+          rgb[1] = pixel[channels >= 3 ? 1 : 0];
+          rgb[2] = pixel[channels >= 3 ? 2 : 0];
+        }
+        writer.add_point(p[0], p[1], p[2], colors ? rgb : nullptr);
+      }
+    }
+  }
+
+  writer.end_frame();
+  trace.count("points", writer.point_count() - points_before);
+}
+
+} // end namespace core
+} // end namespace viame
@@ -0,0 +1,65 @@
+/**
+ * \file
+ * \brief Write the 3D points of stereo depth maps to a binary point cloud file
+ */
+
+#ifndef VIAME_WRITE_POINT_CLOUD_PROCESS_H
+#define VIAME_WRITE_POINT_CLOUD_PROCESS_H
+
+#include <sprokit/pipeline/process.h>
+
+#include <plugins/core/viame_processes_core_export.h>
+#include <plugins/core/detections_pairing_from_stereo.h>
+#include <plugins/core/point_cloud_writer.h>
+
+#include <memory>
+#include <string>
+
+namespace viame
+{
+
+namespace core
+{
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Stream the 3D points of left disparity maps to a binary PLY or LAS file
+ *
+ * Each depth map is reprojected with the stereo calibration in blocks of rows, so the full-frame 3D image is never
+ * held in memory, and points are written as they are produced.
+ */
+class VIAME_PROCESSES_CORE_NO_EXPORT write_point_cloud_process
+  : public sprokit::process
+{
+public:
+  // -- CONSTRUCTORS --
+  write_point_cloud_process( kwiver::vital::config_block_sptr const& config );
+  virtual ~write_point_cloud_process();
+
+protected:
+  void _configure() override;
+  void _step() override;
+
+private:
+  void make_ports();
+  void make_config();
+
+  // Writer for the given frame, opening a new file per frame when the file name is a pattern
+  point_cloud_writer &writer_for_frame( kwiver::vital::frame_id_t frame );
+
+  const std::unique_ptr<detections_pairing_from_stereo> d;
+  std::unique_ptr<point_cloud_writer> m_writer;
+
+  std::string m_file_name;
+  std::string m_format;
+  int m_row_block_size{};
+  double m_voxel_size{};
+  double m_las_scale{};
+  bool m_per_frame_files{};
+  kwiver::vital::frame_id_t m_frame_counter{};
+
+};
+} // core
+} // viame
+
+#endif // VIAME_WRITE_POINT_CLOUD_PROCESS_H
@@ -104,11 +104,10 @@ kwiver::vital::image_container_sptr
 hello_world_filter::
 filter( kwiver::vital::image_container_sptr image_data )
 {
-  kwiver::vital::image_container_sptr image_output;
-
   std::cout << "Text: " << d->m_text << std::endl;
 
-  return image_output;
+  // Pass the image along unchanged, as the python filter does
+  return image_data;
 }
 
 
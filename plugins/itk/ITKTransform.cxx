@@ -1,8 +1,11 @@
 
 #include "ITKTransform.h"
 
+#include <itkMatrixOffsetTransformBase.h>
 #include <itkTransformFileReader.h>
 
+#include <vector>
+
 
 namespace viame
 {
@@ -14,6 +17,7 @@ ITKTransform
 ::ITKTransform( viame::itk::BaseTransformType::Pointer transform )
 {
   m_transform = transform;
+  compute_matrix();
 }
 
 ITKTransform
@@ -39,10 +43,75 @@ ITKTransform
         m_transform->GetInverseTransform() ) ) );
 }
 
+void
+ITKTransform
+::compute_matrix()
+{
+  using LinearTransformType =
+    ::itk::MatrixOffsetTransformBase< TransformFloatType, Dimension, Dimension >;
+
+  m_is_linear = false;
+  m_matrix = kwiver::vital::matrix_3x3d::Identity();
+
+  std::vector< const BaseTransformType* > parts;
+
+  const NetTransformType* composite =
+    dynamic_cast< const NetTransformType* >( m_transform.GetPointer() );
+
+  if( composite )
+  {
+    for( unsigned n = 0; n < composite->GetNumberOfTransforms(); ++n )
+    {
+      parts.push_back( composite->GetNthTransform( n ).GetPointer() );
+    }
+  }
+  else
+  {
+    parts.push_back( m_transform.GetPointer() );
+  }
+
+  // The last transform of a composite is applied first, as in net * next
+  kwiver::vital::matrix_3x3d net = kwiver::vital::matrix_3x3d::Identity();
+
+  for( const BaseTransformType* part : parts )
+  {
+    const LinearTransformType* linear =
+      dynamic_cast< const LinearTransformType* >( part );
+
+    if( !linear )
+    {
+      return;
+    }
+
+    kwiver::vital::matrix_3x3d next = kwiver::vital::matrix_3x3d::Identity();
+
+    for( unsigned r = 0; r < Dimension; ++r )
+    {
+      for( unsigned c = 0; c < Dimension; ++c )
+      {
+        next( r, c ) = linear->GetMatrix()( r, c );
+      }
+      next( r, 2 ) = linear->GetOffset()[r];
+    }
+
+    net = net * next;
+  }
+
+  m_matrix = net;
+  m_is_linear = true;
+}
+
 kwiver::vital::vector_2d
 ITKTransform
 ::map( kwiver::vital::vector_2d const& p ) const
 {
+  if( m_is_linear )
+  {
+    return kwiver::vital::vector_2d(
+      m_matrix( 0, 0 ) * p[0] + m_matrix( 0, 1 ) * p[1] + m_matrix( 0, 2 ),
+      m_matrix( 1, 0 ) * p[0] + m_matrix( 1, 1 ) * p[1] + m_matrix( 1, 2 ) );
+  }
+
   TransformFloatType input[2] = { p[0], p[1] };
 
   BaseTransformType::OutputPointType output =
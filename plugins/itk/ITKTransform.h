@@ -35,6 +35,7 @@
 
 #include <vital/algo/transform_2d_io.h>
 #include <vital/types/transform_2d.h>
+#include <vital/types/matrix.h>
 
 #include "RegisterOpticalAndThermal.h"
 
@@ -67,6 +68,9 @@ public:
 
   /// Map a 2D double-type point using this transform
   /**
+   * Affine transforms, or composites of them, are mapped through their
+   * equivalent matrix computed at construction.
+   *
    * \param p Point to map against this transform
    * \return New point in the projected coordinate system.
    */
@@ -74,7 +78,13 @@ public:
 
 private:
 
+  /// Collapse the transform to a single matrix when it is linear
+  void compute_matrix();
+
   BaseTransformType::Pointer m_transform;
+
+  bool m_is_linear;
+  kwiver::vital::matrix_3x3d m_matrix;
 };
 
 
@@ -0,0 +1,279 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "JHCTMetricCuda.h"
+
+#include <cuda_runtime.h>
+
+#include <cmath>
+
+namespace viame
+{
+
+namespace itk
+{
+
+namespace
+{
+
+constexpr int BlockSize = 256;
+constexpr int TermCount = 7;
+
+// One thread per fixed point, the moving points are read by shared memory tiles.
+// Each thread writes its value term followed by its six derivative terms.
+__global__ void
+jhct_terms_kernel( const float2* fixedPoints, int numberOfFixedPoints,
+                   const float2* movingPoints, int numberOfMovingPoints,
+                   double a00, double a01, double a10, double a11,
+                   double tx, double ty, double cx, double cy,
+                   float sigma, double alpha, double* terms )
+{
+  __shared__ float2 tile[ BlockSize ];
+
+  const int index = blockIdx.x * blockDim.x + threadIdx.x;
+  const bool active = ( index < numberOfFixedPoints );
+
+  double rx = 0.0, ry = 0.0;
+  float px = 0.0f, py = 0.0f;
+
+  if( active )
+  {
+    rx = fixedPoints[ index ].x - cx;
+    ry = fixedPoints[ index ].y - cy;
+    px = static_cast< float >( a00 * rx + a01 * ry + cx + tx );
+    py = static_cast< float >( a10 * rx + a11 * ry + cy + ty );
+  }
+
+  const float inverseVariance = 1.0f / ( sigma * sigma );
+
+  float sumGaussian = 0.0f, sumGx = 0.0f, sumGy = 0.0f;
+
+  for( int start = 0; start < numberOfMovingPoints; start += BlockSize )
+  {
+    const int load = start + threadIdx.x;
+
+    if( load < numberOfMovingPoints )
+    {
+      tile[ threadIdx.x ] = movingPoints[ load ];
+    }
+    __syncthreads();
+
+    const int count = min( BlockSize, numberOfMovingPoints - start );
+
+    for( int j = 0; j < count; ++j )
+    {
+      const float dx = tile[ j ].x - px;
+      const float dy = tile[ j ].y - py;
+      const float g = __expf( -0.5f * ( dx * dx + dy * dy ) * inverseVariance );
+
+      sumGaussian += g;
+      sumGx += g * dx;
+      sumGy += g * dy;
+    }
+    __syncthreads();
+  }
+
+  if( !active )
+  {
+    return;
+  }
+
+  double* out = terms + static_cast< size_t >( index ) * TermCount;
+
+  const double norm = 1.0 /
+    ( numberOfMovingPoints * 2.0 * 3.14159265358979323846 * sigma * sigma );
+  const double density = sumGaussian * norm;
+
+  if( !( density > 1e-300 ) )
+  {
+    for( int t = 0; t < TermCount; ++t )
+    {
+      out[ t ] = 0.0;
+    }
+    return;
+  }
+
+  out[ 0 ] = ( alpha == 1.0 ? log( density ) :
+               pow( density, alpha - 1.0 ) / ( alpha - 1.0 ) );
+
+  // Density gradient at the mapped point, scaled by the derivative of the term
+  const double factor = pow( density, alpha - 2.0 ) * norm * inverseVariance;
+  const double gx = factor * sumGx;
+  const double gy = factor * sumGy;
+
+  out[ 1 ] = gx * rx;
+  out[ 2 ] = gx * ry;
+  out[ 3 ] = gy * rx;
+  out[ 4 ] = gy * ry;
+  out[ 5 ] = gx;
+  out[ 6 ] = gy;
+}
+
+} // end anonymous namespace
+
+struct JHCTMetricCuda::DeviceBuffers
+{
+  float2* fixedPoints = nullptr;
+  float2* movingPoints = nullptr;
+  double* terms = nullptr;
+  int numberOfFixedPoints = 0;
+  int numberOfMovingPoints = 0;
+
+  mutable std::vector< double > hostTerms;
+
+  void clear()
+  {
+    cudaFree( fixedPoints );
+    cudaFree( movingPoints );
+    cudaFree( terms );
+
+    fixedPoints = nullptr;
+    movingPoints = nullptr;
+    terms = nullptr;
+    numberOfFixedPoints = 0;
+    numberOfMovingPoints = 0;
+  }
+
+  ~DeviceBuffers()
+  {
+    clear();
+  }
+};
+
+JHCTMetricCuda
+::JHCTMetricCuda()
+  : m_Buffers( new DeviceBuffers )
+{
+}
+
+JHCTMetricCuda
+::~JHCTMetricCuda()
+{
+}
+
+bool
+JHCTMetricCuda
+::IsAvailable()
+{
+  int count = 0;
+  return cudaGetDeviceCount( &count ) == cudaSuccess && count > 0;
+}
+
+bool
+JHCTMetricCuda
+::SetPointSets( const std::vector< float >& fixedPoints,
+                const std::vector< float >& movingPoints )
+{
+  m_Buffers->clear();
+
+  const int fixedCount = static_cast< int >( fixedPoints.size() / 2 );
+  const int movingCount = static_cast< int >( movingPoints.size() / 2 );
+
+  if( fixedCount == 0 || movingCount == 0 )
+  {
+    return false;
+  }
+
+  if( cudaMalloc( &m_Buffers->fixedPoints, fixedCount * sizeof( float2 ) ) != cudaSuccess ||
+      cudaMalloc( &m_Buffers->movingPoints, movingCount * sizeof( float2 ) ) != cudaSuccess ||
+      cudaMalloc( &m_Buffers->terms, fixedCount * TermCount * sizeof( double ) ) != cudaSuccess ||
+      cudaMemcpy( m_Buffers->fixedPoints, fixedPoints.data(),
+                  fixedCount * sizeof( float2 ), cudaMemcpyHostToDevice ) != cudaSuccess ||
+      cudaMemcpy( m_Buffers->movingPoints, movingPoints.data(),
+                  movingCount * sizeof( float2 ), cudaMemcpyHostToDevice ) != cudaSuccess )
+  {
+    m_Buffers->clear();
+    return false;
+  }
+
+  m_Buffers->numberOfFixedPoints = fixedCount;
+  m_Buffers->numberOfMovingPoints = movingCount;
+  m_Buffers->hostTerms.resize( static_cast< size_t >( fixedCount ) * TermCount );
+  return true;
+}
+
+bool
+JHCTMetricCuda
+::Evaluate( const double parameters[ 6 ], const double center[ 2 ],
+            double sigma, double alpha,
+            double& value, double* derivative ) const
+{
+  const int fixedCount = m_Buffers->numberOfFixedPoints;
+
+  if( fixedCount == 0 )
+  {
+    return false;
+  }
+
+  const int blocks = ( fixedCount + BlockSize - 1 ) / BlockSize;
+
+  jhct_terms_kernel<<< blocks, BlockSize >>>(
+    m_Buffers->fixedPoints, fixedCount,
+    m_Buffers->movingPoints, m_Buffers->numberOfMovingPoints,
+    parameters[ 0 ], parameters[ 1 ], parameters[ 2 ], parameters[ 3 ],
+    parameters[ 4 ], parameters[ 5 ], center[ 0 ], center[ 1 ],
+    static_cast< float >( sigma ), alpha, m_Buffers->terms );
+
+  auto& hostTerms = m_Buffers->hostTerms;
+
+  if( cudaGetLastError() != cudaSuccess ||
+      cudaMemcpy( hostTerms.data(), m_Buffers->terms,
+                  hostTerms.size() * sizeof( double ),
+                  cudaMemcpyDeviceToHost ) != cudaSuccess )
+  {
+    return false;
+  }
+
+  double sums[ TermCount ] = { 0.0 };
+
+  for( size_t n = 0; n < hostTerms.size(); n += TermCount )
+  {
+    for( int t = 0; t < TermCount; ++t )
+    {
+      sums[ t ] += hostTerms[ n + t ];
+    }
+  }
+
+  value = -sums[ 0 ] / fixedCount;
+
+  if( derivative )
+  {
+    for( int t = 1; t < TermCount; ++t )
+    {
+      derivative[ t - 1 ] = sums[ t ] / fixedCount;
+    }
+  }
+
+  return true;
+}
+
+} // end namespace itk
+
+} // end namespace viame
@@ -0,0 +1,85 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIAME_ITK_JHCT_METRIC_CUDA_H
+#define VIAME_ITK_JHCT_METRIC_CUDA_H
+
+#include <memory>
+#include <vector>
+
+namespace viame
+{
+
+namespace itk
+{
+
+// Evaluates the Jensen-Havrda-Charvat-Tsallis point set metric of a 2D affine
+// transform on the GPU. Each fixed point x is mapped by the transform and the
+// isotropic Parzen window density p of the moving points, with a Gaussian of
+// standard deviation sigma, is evaluated at its position. The metric value is
+//
+//   -1 / ( N ( alpha - 1 ) ) sum_x p( T( x ) )^( alpha - 1 )
+//
+// or -1 / N sum_x log p( T( x ) ) with alpha equal to 1, and the derivative is
+// the negated gradient with respect to the affine parameters, following the
+// ITK v4 metric convention.
+class JHCTMetricCuda
+{
+public:
+  JHCTMetricCuda();
+  ~JHCTMetricCuda();
+
+  JHCTMetricCuda( const JHCTMetricCuda& ) = delete;
+  JHCTMetricCuda& operator=( const JHCTMetricCuda& ) = delete;
+
+  // True if a CUDA device can be used
+  static bool IsAvailable();
+
+  // Upload the interleaved x, y coordinates of both point sets, false on error
+  bool SetPointSets( const std::vector< float >& fixedPoints,
+                     const std::vector< float >& movingPoints );
+
+  // Parameters are in the ITK affine order, the row major matrix followed by
+  // the translation, and center is the fixed parameters of the transform. The
+  // derivative is not computed if null. Returns false on error.
+  bool Evaluate( const double parameters[ 6 ], const double center[ 2 ],
+                 double sigma, double alpha,
+                 double& value, double* derivative ) const;
+
+private:
+  struct DeviceBuffers;
+  std::unique_ptr< DeviceBuffers > m_Buffers;
+};
+
+} // end namespace itk
+
+} // end namespace viame
+
+#endif // VIAME_ITK_JHCT_METRIC_CUDA_H
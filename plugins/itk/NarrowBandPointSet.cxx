@@ -7,6 +7,58 @@
 #include "itkMeshFileWriter.h"
 #include "itkChangeInformationImageFilter.h"
 
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Keep at most budget points of a mesh, taking one point of each cell of a
+// coarse grid of the region in turn, so that the kept points stay spread out
+template< typename TMesh, typename TRegion >
+typename TMesh::Pointer BudgetPointSet( const TMesh & input, const TRegion & region, unsigned int budget )
+{
+  constexpr unsigned int Dimension = TMesh::PointDimension;
+  constexpr unsigned int cellsPerAxis = 8;
+
+  using PointType = typename TMesh::PointType;
+  std::vector< std::vector< PointType > > cells( static_cast< size_t >(
+    std::pow( cellsPerAxis, Dimension ) ) );
+
+  const auto size = region.GetSize();
+  for( auto it = input.GetPoints()->Begin(); it != input.GetPoints()->End(); ++it )
+    {
+    size_t cell = 0;
+    for( unsigned int d = Dimension; d-- > 0; )
+      {
+      const double position = std::max( 0.0, static_cast< double >( it.Value()[d] ) );
+      cell = cell * cellsPerAxis + std::min< size_t >( cellsPerAxis - 1,
+        static_cast< size_t >( position * cellsPerAxis / size[d] ) );
+      }
+    cells[cell].push_back( it.Value() );
+    }
+
+  typename TMesh::Pointer output = TMesh::New();
+  typename TMesh::PointsContainer::Pointer points = TMesh::PointsContainer::New();
+  for( size_t rank = 0; points->Size() < budget; ++rank )
+    {
+    bool remaining = false;
+    for( const auto & cell : cells )
+      {
+      if( rank < cell.size() && points->Size() < budget )
+        {
+        points->InsertElement( points->Size(), cell[rank] );
+        remaining = true;
+        }
+      }
+    if( !remaining )
+      {
+      break;
+      }
+    }
+  output->SetPoints( points );
+  return output;
+}
+
 template< unsigned int VDimension >
 int NarrowBandPointSet( int argc, char * argv[] )
 {
@@ -14,7 +66,7 @@ int NarrowBandPointSet( int argc, char * argv[] )
 
   if( argc < 3 )
     {
-    std::cerr << "Usage: " << argv[0] << " <InputBinaryMask> <OutputMeshPrefix> [BandWidth]" << std::endl;
+    std::cerr << "Usage: " << argv[0] << " <InputBinaryMask> <OutputMeshPrefix> [BandWidth] [PointBudget]" << std::endl;
     std::cerr << "Example: " << argv[0] << " ./0/thermal_phase_symmetry.png ./0/thermal_phase_symmetry" << std::endl;
     return EXIT_FAILURE;
     }
@@ -35,6 +87,11 @@ int NarrowBandPointSet( int argc, char * argv[] )
     {
     bandwidth = atof( argv[3] );
     }
+  unsigned int pointBudget = 0;
+  if( argc > 4 )
+    {
+    pointBudget = std::stoi( argv[4] );
+    }
 
   using BinaryMaskPixelType = unsigned char;
 
@@ -97,11 +154,17 @@ int NarrowBandPointSet( int argc, char * argv[] )
 
   using MeshWriterType = itk::MeshFileWriter< MeshType >;
   typename MeshWriterType::Pointer meshWriter = MeshWriterType::New();
-  meshWriter->SetInput( maskToPointSetFilter->GetOutput() );
   meshWriter->SetFileName( outputMeshFile );
 
   try
     {
+    maskToPointSetFilter->Update();
+    typename MeshType::Pointer mesh = maskToPointSetFilter->GetOutput();
+    if( pointBudget > 0 && mesh->GetNumberOfPoints() > pointBudget )
+      {
+      mesh = BudgetPointSet( *mesh, inputRegion, pointBudget );
+      }
+    meshWriter->SetInput( mesh );
     meshWriter->Update();
     }
   catch( itk::ExceptionObject & error )
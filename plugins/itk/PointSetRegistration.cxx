@@ -8,6 +8,12 @@
 #include "itkAffineTransform.h"
 #include "itkCommand.h"
 #include "itkTransformFileWriter.h"
+#include "itkMultiThreaderBase.h"
+
+#include <future>
+#include <limits>
+#include <string>
+#include <vector>
 
 template< typename TFilter >
 class RegistrationIterationUpdateCommand: public itk::Command
@@ -53,7 +59,8 @@ template< typename TTransform, typename TMetric, typename TPointSet >
 int EuclideanDistancePointSetMetricRegistration(
   unsigned int numberOfIterations, double maximumPhysicalStepSize,
   typename TTransform::Pointer & transform, typename TMetric::Pointer & metric,
-  typename TPointSet::Pointer & fixedPoints, typename TPointSet::Pointer & movingPoints )
+  typename TPointSet::Pointer & fixedPoints, typename TPointSet::Pointer & movingPoints,
+  bool verbose )
 {
   // Finish setting up the metric
   metric->SetFixedPointSet( fixedPoints );
@@ -78,39 +85,46 @@ int EuclideanDistancePointSetMetricRegistration(
   optimizer->SetScalesEstimator( shiftScaleEstimator );
   optimizer->SetMaximumStepSizeInPhysicalUnits( maximumPhysicalStepSize );
 
-  using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
-  typename CommandType::Pointer observer = CommandType::New();
-  optimizer->AddObserver( itk::IterationEvent(), observer );
+  if( verbose )
+    {
+    using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
+    typename CommandType::Pointer observer = CommandType::New();
+    optimizer->AddObserver( itk::IterationEvent(), observer );
+
+    std::cout << "Transform" << *transform << std::endl;
+    }
 
-  std::cout << "Transform" << *transform << std::endl;
   // start
   optimizer->StartOptimization();
 
-  std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
-  std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
-  std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
-  std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
-  std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
-  if( transform->GetTransformCategory() == TTransform::DisplacementField )
+  if( verbose )
     {
-    std::cout << "local-support transform non-zero parameters: " << std::endl;
-    typename TTransform::ParametersType params = transform->GetParameters();
-    for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters();
-         n += transform->GetNumberOfLocalParameters() )
+    std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
+    std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
+    std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
+    std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
+    std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
+    if( transform->GetTransformCategory() == TTransform::DisplacementField )
       {
-      typename TTransform::ParametersValueType zero =
-        itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
-      if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+      std::cout << "local-support transform non-zero parameters: " << std::endl;
+      typename TTransform::ParametersType params = transform->GetParameters();
+      for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters();
+           n += transform->GetNumberOfLocalParameters() )
         {
-        std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+        typename TTransform::ParametersValueType zero =
+          itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
+        if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+          {
+          std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+          }
         }
       }
+    else
+      {
+      std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
+      }
+    std::cout << "Transform" << *transform << std::endl;
     }
-  else
-    {
-    std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
-    }
-  std::cout << "Transform" << *transform << std::endl;
 
   return EXIT_SUCCESS;
 }
@@ -120,7 +134,7 @@ int ExpectationBasedPointSetMetricRegistration(
   unsigned int numberOfIterations, double maximumPhysicalStepSize,
   typename TTransform::Pointer & transform, typename TMetric::Pointer & metric,
   typename TPointSet::Pointer & fixedPoints, typename TPointSet::Pointer & movingPoints,
-  double pointSetSigma )
+  double pointSetSigma, bool verbose )
 {
   // Finish setting up the metric
   metric->SetFixedPointSet( fixedPoints );
@@ -147,39 +161,46 @@ int ExpectationBasedPointSetMetricRegistration(
   optimizer->SetScalesEstimator( shiftScaleEstimator );
   optimizer->SetMaximumStepSizeInPhysicalUnits( maximumPhysicalStepSize );
 
-  using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
-  typename CommandType::Pointer observer = CommandType::New();
-  optimizer->AddObserver( itk::IterationEvent(), observer );
+  if( verbose )
+    {
+    using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
+    typename CommandType::Pointer observer = CommandType::New();
+    optimizer->AddObserver( itk::IterationEvent(), observer );
+
+    std::cout << "Transform" << *transform << std::endl;
+    }
 
-  std::cout << "Transform" << *transform << std::endl;
   // start
   optimizer->StartOptimization();
 
-  std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
-  std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
-  std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
-  std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
-  std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
-  if( transform->GetTransformCategory() == TTransform::DisplacementField )
+  if( verbose )
     {
-    std::cout << "local-support transform non-zero parameters: " << std::endl;
-    typename TTransform::ParametersType params = transform->GetParameters();
-    for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters();
-         n += transform->GetNumberOfLocalParameters() )
+    std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
+    std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
+    std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
+    std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
+    std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
+    if( transform->GetTransformCategory() == TTransform::DisplacementField )
       {
-      typename TTransform::ParametersValueType zero =
-        itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
-      if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+      std::cout << "local-support transform non-zero parameters: " << std::endl;
+      typename TTransform::ParametersType params = transform->GetParameters();
+      for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters();
+           n += transform->GetNumberOfLocalParameters() )
         {
-        std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+        typename TTransform::ParametersValueType zero =
+          itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
+        if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+          {
+          std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+          }
         }
       }
+    else
+      {
+      std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
+      }
+    std::cout << "Transform" << *transform << std::endl;
     }
-  else
-    {
-    std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
-    }
-  std::cout << "Transform" << *transform << std::endl;
 
   return EXIT_SUCCESS;
 }
@@ -189,7 +210,7 @@ int JHCTPointSetMetricRegistration(
   unsigned int numberOfIterations, double maximumPhysicalStepSize,
   typename TTransform::Pointer & transform, typename TMetric::Pointer & metric,
   typename TPointSet::Pointer & fixedPoints, typename TPointSet::Pointer & movingPoints,
-  double pointSetSigma )
+  double pointSetSigma, bool verbose )
 {
   // Finish setting up the metric
   metric->SetFixedPointSet( fixedPoints );
@@ -218,47 +239,106 @@ int JHCTPointSetMetricRegistration(
   optimizer->SetScalesEstimator( shiftScaleEstimator );
   optimizer->SetMaximumStepSizeInPhysicalUnits( maximumPhysicalStepSize );
 
-  using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
-  typename CommandType::Pointer observer = CommandType::New();
-  optimizer->AddObserver( itk::IterationEvent(), observer );
+  if( verbose )
+    {
+    using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
+    typename CommandType::Pointer observer = CommandType::New();
+    optimizer->AddObserver( itk::IterationEvent(), observer );
+
+    std::cout << "Transform" << *transform << std::endl;
+    }
 
-  std::cout << "Transform" << *transform << std::endl;
   // start
   optimizer->StartOptimization();
 
-  std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
-  std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
-  std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
-  std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
-  std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
-  if( transform->GetTransformCategory() == TTransform::DisplacementField )
+  if( verbose )
     {
-    std::cout << "local-support transform non-zero parameters: " << std::endl;
-    typename TTransform::ParametersType params = transform->GetParameters();
-    for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters(); n += transform->GetNumberOfLocalParameters() )
+    std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
+    std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
+    std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
+    std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
+    std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
+    if( transform->GetTransformCategory() == TTransform::DisplacementField )
       {
-      typename TTransform::ParametersValueType zero = itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
-      if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+      std::cout << "local-support transform non-zero parameters: " << std::endl;
+      typename TTransform::ParametersType params = transform->GetParameters();
+      for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters(); n += transform->GetNumberOfLocalParameters() )
         {
-        std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+        typename TTransform::ParametersValueType zero = itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
+        if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+          {
+          std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+          }
         }
       }
+    else
+      {
+      std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
+      }
+    std::cout << "Transform" << *transform << std::endl;
     }
-  else
+
+  return EXIT_SUCCESS;
+}
+
+// Copy of a point set, so that concurrent registrations share no ITK objects
+template< typename TPointSet >
+typename TPointSet::Pointer ClonePointSet( const typename TPointSet::Pointer & input )
+{
+  typename TPointSet::Pointer output = TPointSet::New();
+  for( auto it = input->GetPoints()->Begin(); it != input->GetPoints()->End(); ++it )
     {
-    std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
+    output->SetPoint( it.Index(), it.Value() );
     }
-  std::cout << "Transform" << *transform << std::endl;
+  return output;
+}
 
-  return EXIT_SUCCESS;
+// Mean distance of the transformed points to their closest counterpart, which
+// compares the results of different metrics on the same scale
+template< typename TTransform, typename TPointSet >
+double AlignmentError( typename TTransform::Pointer & transform,
+  typename TPointSet::Pointer & fixedPoints, typename TPointSet::Pointer & movingPoints )
+{
+  using MetricType = itk::EuclideanDistancePointSetToPointSetMetricv4< TPointSet >;
+  typename MetricType::Pointer metric = MetricType::New();
+  metric->SetFixedPointSet( fixedPoints );
+  metric->SetMovingPointSet( movingPoints );
+  metric->SetMovingTransform( transform );
+  metric->Initialize();
+  return metric->GetValue();
 }
+
 int main(int argc, char * argv[])
 {
+  // Options, removed from the positional arguments
+  bool verbose = true;
+  int numberOfThreads = 0;
+  std::vector< char * > positional;
+  for( int i = 0; i < argc; ++i )
+    {
+    const std::string arg = argv[i];
+    if( arg == "--quiet" )
+      {
+      verbose = false;
+      }
+    else if( arg == "--threads" && i + 1 < argc )
+      {
+      numberOfThreads = std::stoi( argv[++i] );
+      }
+    else
+      {
+      positional.push_back( argv[i] );
+      }
+    }
+  argc = static_cast< int >( positional.size() );
+  argv = positional.data();
+
   if( argc < 4 )
     {
     std::cerr << "Usage: " << argv[0] << " <InputFixedMesh> <InputMovingMesh> <OutputTransform> "
               << "<OutputTransformedFixedMesh> [MetricId] [NumberOfIterations] "
-              << "[MaximumPhysicalStepSize] [PointSetSigma]" << std::endl;
+              << "[MaximumPhysicalStepSize] [PointSetSigma] [--threads N] [--quiet]" << std::endl;
+    std::cerr << "MetricId 3 runs every metric concurrently and keeps the best result" << std::endl;
 
     return EXIT_FAILURE;
     }
@@ -289,6 +369,11 @@ int main(int argc, char * argv[])
     pointSetSigma = std::stod( argv[7] );
     }
 
+  if( numberOfThreads > 0 )
+    {
+    itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads( numberOfThreads );
+    }
+
   constexpr unsigned int Dimension = 2;
   using PointSetType = itk::PointSet<unsigned char, Dimension>;
   using MeshType = itk::Mesh<unsigned char, Dimension>;
@@ -327,51 +412,114 @@ int main(int argc, char * argv[])
   movingPointSet->SetPointData( movingMesh->GetPointData() );
 
   using ICPPointSetMetricType = itk::EuclideanDistancePointSetToPointSetMetricv4< PointSetType >;
-  ICPPointSetMetricType::Pointer icpMetric = ICPPointSetMetricType::New();
 
   using ExpectationPointSetMetricType = itk::ExpectationBasedPointSetToPointSetMetricv4< PointSetType >;
-  ExpectationPointSetMetricType::Pointer expectationMetric = ExpectationPointSetMetricType::New();
 
   using JHCTPointSetMetricType = itk::JensenHavrdaCharvatTsallisPointSetToPointSetMetricv4< PointSetType >;
-  JHCTPointSetMetricType::Pointer jhctMetric = JHCTPointSetMetricType::New();
 
   using AffineTransformType = itk::AffineTransform<double, Dimension>;
   AffineTransformType::Pointer affineTransform = AffineTransformType::New();
   affineTransform->SetIdentity();
-  try
+  // Register with one metric, returning false on errors
+  const auto registerWithMetric = [&]( unsigned int id, AffineTransformType::Pointer & transform,
+    PointSetType::Pointer fixedPoints, PointSetType::Pointer movingPoints ) -> bool
     {
-    switch( metricId )
+    try
       {
-    case 0:
-      // ICP
-      EuclideanDistancePointSetMetricRegistration<AffineTransformType, ICPPointSetMetricType, PointSetType>
-      ( numberOfIterations, maximumPhysicalStepSize,
-        affineTransform, icpMetric,
-        fixedPointSet, movingPointSet );
-      break;
-    case 1:
-      // GMM
-      ExpectationBasedPointSetMetricRegistration<AffineTransformType, ExpectationPointSetMetricType, PointSetType>
-      ( numberOfIterations, maximumPhysicalStepSize,
-        affineTransform, expectationMetric,
-        fixedPointSet, movingPointSet,
-        pointSetSigma );
-      break;
-    case 2:
-      // JHCT divergence
-      JHCTPointSetMetricRegistration<AffineTransformType, JHCTPointSetMetricType, PointSetType >
-      ( numberOfIterations, maximumPhysicalStepSize,
-        affineTransform, jhctMetric,
-        fixedPointSet, movingPointSet, pointSetSigma );
-      break;
-    default:
-      std::cerr << "Unexpected metric id: " << metricId << std::endl;
-      return EXIT_FAILURE;
+      switch( id )
+        {
+      case 0:
+        {
+        // ICP
+        ICPPointSetMetricType::Pointer icpMetric = ICPPointSetMetricType::New();
+        EuclideanDistancePointSetMetricRegistration<AffineTransformType, ICPPointSetMetricType, PointSetType>
+        ( numberOfIterations, maximumPhysicalStepSize,
+          transform, icpMetric,
+          fixedPoints, movingPoints, verbose );
+        break;
+        }
+      case 1:
+        {
+        // GMM
+        ExpectationPointSetMetricType::Pointer expectationMetric = ExpectationPointSetMetricType::New();
+        ExpectationBasedPointSetMetricRegistration<AffineTransformType, ExpectationPointSetMetricType, PointSetType>
+        ( numberOfIterations, maximumPhysicalStepSize,
+          transform, expectationMetric,
+          fixedPoints, movingPoints,
+          pointSetSigma, verbose );
+        break;
+        }
+      default:
+        {
+        // JHCT divergence
+        JHCTPointSetMetricType::Pointer jhctMetric = JHCTPointSetMetricType::New();
+        JHCTPointSetMetricRegistration<AffineTransformType, JHCTPointSetMetricType, PointSetType >
+        ( numberOfIterations, maximumPhysicalStepSize,
+          transform, jhctMetric,
+          fixedPoints, movingPoints, pointSetSigma, verbose );
+        break;
+        }
+        }
       }
+    catch( itk::ExceptionObject & error )
+      {
+      std::cerr << "Error during registration: " << error << std::endl;
+      return false;
+      }
+    return true;
+    };
+
+  if( metricId < 3 )
+    {
+    registerWithMetric( metricId, affineTransform, fixedPointSet, movingPointSet );
     }
-  catch( itk::ExceptionObject & error )
+  else if( metricId == 3 )
+    {
+    // All metrics concurrently from the same initial transform, keeping the
+    // result with the lowest alignment error
+    std::vector< AffineTransformType::Pointer > candidates;
+    std::vector< std::future< bool > > results;
+    for( unsigned int id = 0; id < 3; ++id )
+      {
+      AffineTransformType::Pointer candidate = AffineTransformType::New();
+      candidate->SetFixedParameters( affineTransform->GetFixedParameters() );
+      candidate->SetParameters( affineTransform->GetParameters() );
+      candidates.push_back( candidate );
+      }
+    for( unsigned int id = 0; id < 3; ++id )
+      {
+      results.push_back( std::async( std::launch::async, [&, id]()
+        {
+        return registerWithMetric( id, candidates[id],
+          ClonePointSet< PointSetType >( fixedPointSet ),
+          ClonePointSet< PointSetType >( movingPointSet ) );
+        } ) );
+      }
+
+    double bestError = std::numeric_limits< double >::max();
+    for( unsigned int id = 0; id < 3; ++id )
+      {
+      if( !results[id].get() )
+        {
+        continue;
+        }
+      const double error = AlignmentError< AffineTransformType, PointSetType >(
+        candidates[id], fixedPointSet, movingPointSet );
+      if( verbose )
+        {
+        std::cout << "Metric " << id << " alignment error: " << error << std::endl;
+        }
+      if( error < bestError )
+        {
+        bestError = error;
+        affineTransform = candidates[id];
+        }
+      }
+    }
+  else
     {
-    std::cerr << "Error during registration: " << error << std::endl;
+    std::cerr << "Unexpected metric id: " << metricId << std::endl;
+    return EXIT_FAILURE;
     }
 
   using TransformWriterType = itk::TransformFileWriterTemplate< double >;
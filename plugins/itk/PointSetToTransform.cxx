@@ -8,8 +8,14 @@
 #include "itkAffineTransform.h"
 #include "itkCommand.h"
 #include "itkTransformFileWriter.h"
+#include "itkMultiThreaderBase.h"
 #include "itkLandmarkBasedTransformInitializer.h"
 
+#include <future>
+#include <limits>
+#include <string>
+#include <vector>
+
 template< typename TFilter >
 class RegistrationIterationUpdateCommand: public itk::Command
 {
@@ -51,7 +57,8 @@ template< typename TTransform, typename TMetric, typename TPointSet >
 int EuclideanDistancePointSetMetricRegistration(
   unsigned int numberOfIterations, double maximumPhysicalStepSize,
   typename TTransform::Pointer & transform, typename TMetric::Pointer & metric,
-  typename TPointSet::Pointer & fixedPoints, typename TPointSet::Pointer & movingPoints )
+  typename TPointSet::Pointer & fixedPoints, typename TPointSet::Pointer & movingPoints,
+  bool verbose )
 {
   using PointSetType = TPointSet;
   using PointType = typename PointSetType::PointType;
@@ -78,37 +85,44 @@ int EuclideanDistancePointSetMetricRegistration(
   optimizer->SetScalesEstimator( shiftScaleEstimator );
   optimizer->SetMaximumStepSizeInPhysicalUnits( maximumPhysicalStepSize );
 
-  using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
-  typename CommandType::Pointer observer = CommandType::New();
-  optimizer->AddObserver( itk::IterationEvent(), observer );
+  if( verbose )
+    {
+    using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
+    typename CommandType::Pointer observer = CommandType::New();
+    optimizer->AddObserver( itk::IterationEvent(), observer );
+
+    std::cout << "Transform" << *transform << std::endl;
+    }
 
-  std::cout << "Transform" << *transform << std::endl;
   // start
   optimizer->StartOptimization();
 
-  std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
-  std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
-  std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
-  std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
-  std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
-  if( transform->GetTransformCategory() == TTransform::DisplacementField )
+  if( verbose )
     {
-    std::cout << "local-support transform non-zero parameters: " << std::endl;
-    typename TTransform::ParametersType params = transform->GetParameters();
-    for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters(); n += transform->GetNumberOfLocalParameters() )
+    std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
+    std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
+    std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
+    std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
+    std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
+    if( transform->GetTransformCategory() == TTransform::DisplacementField )
       {
-      typename TTransform::ParametersValueType zero = itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
-      if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+      std::cout << "local-support transform non-zero parameters: " << std::endl;
+      typename TTransform::ParametersType params = transform->GetParameters();
+      for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters(); n += transform->GetNumberOfLocalParameters() )
         {
-        std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+        typename TTransform::ParametersValueType zero = itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
+        if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+          {
+          std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+          }
         }
       }
+    else
+      {
+      std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
+      }
+    std::cout << "Transform" << *transform << std::endl;
     }
-  else
-    {
-    std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
-    }
-  std::cout << "Transform" << *transform << std::endl;
 
   return EXIT_SUCCESS;
 }
@@ -118,7 +132,7 @@ int ExpectationBasedPointSetMetricRegistration(
   unsigned int numberOfIterations, double maximumPhysicalStepSize,
   typename TTransform::Pointer & transform, typename TMetric::Pointer & metric,
   typename TPointSet::Pointer & fixedPoints, typename TPointSet::Pointer & movingPoints,
-  double pointSetSigma )
+  double pointSetSigma, bool verbose )
 {
   using PointSetType = TPointSet;
   using PointType = typename PointSetType::PointType;
@@ -147,37 +161,44 @@ int ExpectationBasedPointSetMetricRegistration(
   optimizer->SetScalesEstimator( shiftScaleEstimator );
   optimizer->SetMaximumStepSizeInPhysicalUnits( maximumPhysicalStepSize );
 
-  using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
-  typename CommandType::Pointer observer = CommandType::New();
-  optimizer->AddObserver( itk::IterationEvent(), observer );
+  if( verbose )
+    {
+    using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
+    typename CommandType::Pointer observer = CommandType::New();
+    optimizer->AddObserver( itk::IterationEvent(), observer );
+
+    std::cout << "Transform" << *transform << std::endl;
+    }
 
-  std::cout << "Transform" << *transform << std::endl;
   // start
   optimizer->StartOptimization();
 
-  std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
-  std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
-  std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
-  std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
-  std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
-  if( transform->GetTransformCategory() == TTransform::DisplacementField )
+  if( verbose )
     {
-    std::cout << "local-support transform non-zero parameters: " << std::endl;
-    typename TTransform::ParametersType params = transform->GetParameters();
-    for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters(); n += transform->GetNumberOfLocalParameters() )
+    std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
+    std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
+    std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
+    std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
+    std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
+    if( transform->GetTransformCategory() == TTransform::DisplacementField )
       {
-      typename TTransform::ParametersValueType zero = itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
-      if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+      std::cout << "local-support transform non-zero parameters: " << std::endl;
+      typename TTransform::ParametersType params = transform->GetParameters();
+      for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters(); n += transform->GetNumberOfLocalParameters() )
         {
-        std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+        typename TTransform::ParametersValueType zero = itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
+        if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+          {
+          std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+          }
         }
       }
+    else
+      {
+      std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
+      }
+    std::cout << "Transform" << *transform << std::endl;
     }
-  else
-    {
-    std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
-    }
-  std::cout << "Transform" << *transform << std::endl;
 
   return EXIT_SUCCESS;
 }
@@ -187,7 +208,7 @@ int JHCTPointSetMetricRegistration(
   unsigned int numberOfIterations, double maximumPhysicalStepSize,
   typename TTransform::Pointer & transform, typename TMetric::Pointer & metric,
   typename TPointSet::Pointer & fixedPoints, typename TPointSet::Pointer & movingPoints,
-  double pointSetSigma )
+  double pointSetSigma, bool verbose )
 {
   using PointSetType = TPointSet;
   using PointType = typename PointSetType::PointType;
@@ -218,45 +239,104 @@ int JHCTPointSetMetricRegistration(
   optimizer->SetScalesEstimator( shiftScaleEstimator );
   optimizer->SetMaximumStepSizeInPhysicalUnits( maximumPhysicalStepSize );
 
-  using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
-  typename CommandType::Pointer observer = CommandType::New();
-  optimizer->AddObserver( itk::IterationEvent(), observer );
+  if( verbose )
+    {
+    using CommandType = RegistrationIterationUpdateCommand<OptimizerType>;
+    typename CommandType::Pointer observer = CommandType::New();
+    optimizer->AddObserver( itk::IterationEvent(), observer );
+
+    std::cout << "Transform" << *transform << std::endl;
+    }
 
-  std::cout << "Transform" << *transform << std::endl;
   // start
   optimizer->StartOptimization();
 
-  std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
-  std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
-  std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
-  std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
-  std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
-  if( transform->GetTransformCategory() == TTransform::DisplacementField )
+  if( verbose )
     {
-    std::cout << "local-support transform non-zero parameters: " << std::endl;
-    typename TTransform::ParametersType params = transform->GetParameters();
-    for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters(); n += transform->GetNumberOfLocalParameters() )
+    std::cout << "numberOfIterations: " << numberOfIterations << std::endl;
+    std::cout << "maximumPhysicalStepSize: " << maximumPhysicalStepSize << std::endl;
+    std::cout << "Optimizer scales: " << optimizer->GetScales() << std::endl;
+    std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
+    std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
+    if( transform->GetTransformCategory() == TTransform::DisplacementField )
       {
-      typename TTransform::ParametersValueType zero = itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
-      if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+      std::cout << "local-support transform non-zero parameters: " << std::endl;
+      typename TTransform::ParametersType params = transform->GetParameters();
+      for( itk::SizeValueType n = 0; n < transform->GetNumberOfParameters(); n += transform->GetNumberOfLocalParameters() )
         {
-        std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+        typename TTransform::ParametersValueType zero = itk::NumericTraits<typename TTransform::ParametersValueType>::ZeroValue();
+        if( itk::Math::NotExactlyEquals(params[n], zero) && itk::Math::NotExactlyEquals(params[n+1], zero) )
+          {
+          std::cout << n << ", " << n+1 << " : " << params[n] << ", " << params[n+1] << std::endl;
+          }
         }
       }
+    else
+      {
+      std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
+      }
+    std::cout << "Transform" << *transform << std::endl;
     }
-  else
+
+  return EXIT_SUCCESS;
+}
+
+// Copy of a point set, so that concurrent registrations share no ITK objects
+template< typename TPointSet >
+typename TPointSet::Pointer ClonePointSet( const typename TPointSet::Pointer & input )
+{
+  typename TPointSet::Pointer output = TPointSet::New();
+  for( auto it = input->GetPoints()->Begin(); it != input->GetPoints()->End(); ++it )
     {
-    std::cout << "Moving-source final position: " << optimizer->GetCurrentPosition() << std::endl;
+    output->SetPoint( it.Index(), it.Value() );
     }
-  std::cout << "Transform" << *transform << std::endl;
+  return output;
+}
 
-  return EXIT_SUCCESS;
+// Mean distance of the transformed points to their closest counterpart, which
+// compares the results of different metrics on the same scale
+template< typename TTransform, typename TPointSet >
+double AlignmentError( typename TTransform::Pointer & transform,
+  typename TPointSet::Pointer & fixedPoints, typename TPointSet::Pointer & movingPoints )
+{
+  using MetricType = itk::EuclideanDistancePointSetToPointSetMetricv4< TPointSet >;
+  typename MetricType::Pointer metric = MetricType::New();
+  metric->SetFixedPointSet( fixedPoints );
+  metric->SetMovingPointSet( movingPoints );
+  metric->SetMovingTransform( transform );
+  metric->Initialize();
+  return metric->GetValue();
 }
+
 int main(int argc, char * argv[])
 {
+  // Options, removed from the positional arguments
+  bool verbose = true;
+  int numberOfThreads = 0;
+  std::vector< char * > positional;
+  for( int i = 0; i < argc; ++i )
+    {
+    const std::string arg = argv[i];
+    if( arg == "--quiet" )
+      {
+      verbose = false;
+      }
+    else if( arg == "--threads" && i + 1 < argc )
+      {
+      numberOfThreads = std::stoi( argv[++i] );
+      }
+    else
+      {
+      positional.push_back( argv[i] );
+      }
+    }
+  argc = static_cast< int >( positional.size() );
+  argv = positional.data();
+
   if( argc < 3 )
     {
-    std::cerr << "Usage: " << argv[0] << " <InputPoints> <OutputTransform> [MetricId] [NumberOfIterations] [MaximumPhysicalStepSize] [PointSetSigma]" << std::endl;
+    std::cerr << "Usage: " << argv[0] << " <InputPoints> <OutputTransform> [MetricId] [NumberOfIterations] [MaximumPhysicalStepSize] [PointSetSigma] [--threads N] [--quiet]" << std::endl;
+    std::cerr << "MetricId 3 runs every metric concurrently and keeps the best result" << std::endl;
     return EXIT_FAILURE;
     }
   const char * inputPointsFile = argv[1];
@@ -283,6 +363,11 @@ int main(int argc, char * argv[])
     pointSetSigma = std::stod( argv[6] );
     }
 
+  if( numberOfThreads > 0 )
+    {
+    itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads( numberOfThreads );
+    }
+
   constexpr unsigned int Dimension = 2;
   using PointSetType = itk::PointSet<unsigned char, Dimension>;
   //using PointSetType = itk::PointSet<unsigned char, Dimension, itk::DefaultStaticMeshTraits<unsigned char, Dimension, Dimension, double>>;
@@ -311,13 +396,10 @@ int main(int argc, char * argv[])
   }
 
   using ICPPointSetMetricType = itk::EuclideanDistancePointSetToPointSetMetricv4< PointSetType >;
-  ICPPointSetMetricType::Pointer icpMetric = ICPPointSetMetricType::New();
 
   using ExpectationPointSetMetricType = itk::ExpectationBasedPointSetToPointSetMetricv4< PointSetType >;
-  ExpectationPointSetMetricType::Pointer expectationMetric = ExpectationPointSetMetricType::New();
 
   using JHCTPointSetMetricType = itk::JensenHavrdaCharvatTsallisPointSetToPointSetMetricv4< PointSetType >;
-  JHCTPointSetMetricType::Pointer jhctMetric = JHCTPointSetMetricType::New();
 
   using AffineTransformType = itk::AffineTransform<double, Dimension>;
   AffineTransformType::Pointer affineTransform = AffineTransformType::New();
@@ -330,40 +412,106 @@ int main(int argc, char * argv[])
   initializer->SetTransform(affineTransform);
   initializer->InitializeTransform();
 
-  try
+  // Register with one metric, returning false on errors
+  const auto registerWithMetric = [&]( unsigned int id, AffineTransformType::Pointer & transform,
+    PointSetType::Pointer fixedPoints, PointSetType::Pointer movingPoints ) -> bool
     {
-    switch( metricId )
+    try
       {
-    case 0:
-      // ICP
-      EuclideanDistancePointSetMetricRegistration<AffineTransformType, ICPPointSetMetricType, PointSetType>
-      ( numberOfIterations, maximumPhysicalStepSize,
-        affineTransform, icpMetric,
-        fixedPointSet, movingPointSet );
-      break;
-    case 1:
-      // GMM
-      ExpectationBasedPointSetMetricRegistration<AffineTransformType, ExpectationPointSetMetricType, PointSetType>
-      ( numberOfIterations, maximumPhysicalStepSize,
-        affineTransform, expectationMetric,
-        fixedPointSet, movingPointSet,
-        pointSetSigma );
-      break;
-    case 2:
-      // JHCT divergence
-      JHCTPointSetMetricRegistration<AffineTransformType, JHCTPointSetMetricType, PointSetType >
-      ( numberOfIterations, maximumPhysicalStepSize,
-        affineTransform, jhctMetric,
-        fixedPointSet, movingPointSet, pointSetSigma );
-      break;
-    default:
-      std::cerr << "Unexpected metric id: " << metricId << std::endl;
-      return EXIT_FAILURE;
+      switch( id )
+        {
+      case 0:
+        {
+        // ICP
+        ICPPointSetMetricType::Pointer icpMetric = ICPPointSetMetricType::New();
+        EuclideanDistancePointSetMetricRegistration<AffineTransformType, ICPPointSetMetricType, PointSetType>
+        ( numberOfIterations, maximumPhysicalStepSize,
+          transform, icpMetric,
+          fixedPoints, movingPoints, verbose );
+        break;
+        }
+      case 1:
+        {
+        // GMM
+        ExpectationPointSetMetricType::Pointer expectationMetric = ExpectationPointSetMetricType::New();
+        ExpectationBasedPointSetMetricRegistration<AffineTransformType, ExpectationPointSetMetricType, PointSetType>
+        ( numberOfIterations, maximumPhysicalStepSize,
+          transform, expectationMetric,
+          fixedPoints, movingPoints,
+          pointSetSigma, verbose );
+        break;
+        }
+      default:
+        {
+        // JHCT divergence
+        JHCTPointSetMetricType::Pointer jhctMetric = JHCTPointSetMetricType::New();
+        JHCTPointSetMetricRegistration<AffineTransformType, JHCTPointSetMetricType, PointSetType >
+        ( numberOfIterations, maximumPhysicalStepSize,
+          transform, jhctMetric,
+          fixedPoints, movingPoints, pointSetSigma, verbose );
+        break;
+        }
+        }
       }
+    catch( itk::ExceptionObject & error )
+      {
+      std::cerr << "Error during registration: " << error << std::endl;
+      return false;
+      }
+    return true;
+    };
+
+  if( metricId < 3 )
+    {
+    registerWithMetric( metricId, affineTransform, fixedPointSet, movingPointSet );
     }
-  catch( itk::ExceptionObject & error )
+  else if( metricId == 3 )
+    {
+    // All metrics concurrently from the same initial transform, keeping the
+    // result with the lowest alignment error
+    std::vector< AffineTransformType::Pointer > candidates;
+    std::vector< std::future< bool > > results;
+    for( unsigned int id = 0; id < 3; ++id )
+      {
+      AffineTransformType::Pointer candidate = AffineTransformType::New();
+      candidate->SetFixedParameters( affineTransform->GetFixedParameters() );
+      candidate->SetParameters( affineTransform->GetParameters() );
+      candidates.push_back( candidate );
+      }
+    for( unsigned int id = 0; id < 3; ++id )
+      {
+      results.push_back( std::async( std::launch::async, [&, id]()
+        {
+        return registerWithMetric( id, candidates[id],
+          ClonePointSet< PointSetType >( fixedPointSet ),
+          ClonePointSet< PointSetType >( movingPointSet ) );
+        } ) );
+      }
+
+    double bestError = std::numeric_limits< double >::max();
+    for( unsigned int id = 0; id < 3; ++id )
+      {
+      if( !results[id].get() )
+        {
+        continue;
+        }
+      const double error = AlignmentError< AffineTransformType, PointSetType >(
+        candidates[id], fixedPointSet, movingPointSet );
+      if( verbose )
+        {
+        std::cout << "Metric " << id << " alignment error: " << error << std::endl;
+        }
+      if( error < bestError )
+        {
+        bestError = error;
+        affineTransform = candidates[id];
+        }
+      }
+    }
+  else
     {
-    std::cerr << "Error during registration: " << error << std::endl;
+    std::cerr << "Unexpected metric id: " << metricId << std::endl;
+    return EXIT_FAILURE;
     }
 
   using TransformWriterType = itk::TransformFileWriterTemplate< double >;
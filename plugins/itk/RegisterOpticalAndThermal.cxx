@@ -1,5 +1,9 @@
 #include "RegisterOpticalAndThermal.h"
 
+#ifdef VIAME_ITK_CUDA
+#include "JHCTMetricCuda.h"
+#endif
+
 #include "itkImageFileReader.h"
 #include "itkCoherenceEnhancingDiffusionImageFilter.h"
 #include "itkPhaseSymmetryImageFilter.h"
@@ -22,6 +26,24 @@
 #include "itkRescaleIntensityImageFilter.h"
 #include "itkResampleImageFilter.h"
 #include "itkImageFileWriter.h"
+#include "itkVersion.h"
+
+#if ITK_VERSION_MAJOR >= 5
+#include "itkMultiThreaderBase.h"
+#else
+#include "itkMultiThreader.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
 
 namespace
 {
@@ -74,7 +96,7 @@ int JHCTPointSetMetricRegistration(
   unsigned int numberOfIterations, double maximumPhysicalStepSize,
   typename TTransform::Pointer & transform, typename TMetric::Pointer & metric,
   typename TPointSet::Pointer & fixedPoints, typename TPointSet::Pointer & movingPoints,
-  double pointSetSigma )
+  double pointSetSigma, double & finalMetricValue, unsigned & iterationsRun )
 {
   // Finish setting up the metric
   metric->SetFixedPointSet( fixedPoints );
@@ -118,6 +140,9 @@ int JHCTPointSetMetricRegistration(
   std::cout << "Optimizer learning rate: " << optimizer->GetLearningRate() << std::endl;
   std::cout << "Moving-source final value: " << optimizer->GetCurrentMetricValue() << std::endl;
 
+  finalMetricValue = optimizer->GetCurrentMetricValue();
+  iterationsRun = optimizer->GetCurrentIteration();
+
   if( transform->GetTransformCategory() == TTransform::DisplacementField )
     {
     std::cout << "local-support transform non-zero parameters: " << std::endl;
@@ -143,10 +168,282 @@ int JHCTPointSetMetricRegistration(
   return EXIT_SUCCESS;
 }
 
+#ifdef VIAME_ITK_CUDA
+
+// Registrations use the GPU metric if enabled and a device is available
+std::atomic< bool > g_useCudaMetric( false );
+
+// JHCT metric whose value and derivative are evaluated on the GPU for 2D affine
+// moving transforms, falling back to the CPU metric otherwise. The GPU metric
+// uses the isotropic Parzen window density of every moving point instead of the
+// anisotropic density of the closest neighbors, which is what makes it suited
+// to a brute force evaluation.
+template< typename TPointSet >
+class JHCTPointSetMetricCudav4 :
+  public itk::JensenHavrdaCharvatTsallisPointSetToPointSetMetricv4< TPointSet >
+{
+public:
+  using Self = JHCTPointSetMetricCudav4;
+  using Superclass = itk::JensenHavrdaCharvatTsallisPointSetToPointSetMetricv4< TPointSet >;
+  using Pointer = itk::SmartPointer< Self >;
+  itkNewMacro( Self );
+
+  using MeasureType = typename Superclass::MeasureType;
+  using DerivativeType = typename Superclass::DerivativeType;
+
+  void Initialize() override
+    {
+    Superclass::Initialize();
+
+    m_UseDevice = false;
+
+    if( TPointSet::PointDimension != 2 ||
+        !dynamic_cast< const AffineTransformType * >( this->GetMovingTransform() ) )
+      {
+      return;
+      }
+
+    std::vector< float > fixedPoints;
+    std::vector< float > movingPoints;
+    CopyPoints( *this->GetFixedPointSet(), fixedPoints );
+    CopyPoints( *this->GetMovingPointSet(), movingPoints );
+
+    m_UseDevice = m_Device.SetPointSets( fixedPoints, movingPoints );
+    }
+
+  MeasureType GetValue() const override
+    {
+    MeasureType value;
+
+    if( !m_UseDevice || !Evaluate( value, nullptr ) )
+      {
+      return Superclass::GetValue();
+      }
+
+    return value;
+    }
+
+  void GetDerivative( DerivativeType & derivative ) const override
+    {
+    MeasureType value;
+    GetValueAndDerivative( value, derivative );
+    }
+
+  void GetValueAndDerivative( MeasureType & value, DerivativeType & derivative ) const override
+    {
+    if( derivative.GetSize() != this->GetNumberOfParameters() )
+      {
+      derivative.SetSize( this->GetNumberOfParameters() );
+      }
+
+    if( !m_UseDevice || !Evaluate( value, derivative.data_block() ) )
+      {
+      Superclass::GetValueAndDerivative( value, derivative );
+      }
+    }
+
+protected:
+  JHCTPointSetMetricCudav4() = default;
+
+private:
+  static void CopyPoints( const TPointSet & pointSet, std::vector< float > & output )
+    {
+    const auto * points = pointSet.GetPoints();
+    output.reserve( 2 * points->Size() );
+
+    for( auto it = points->Begin(); it != points->End(); ++it )
+      {
+      output.push_back( static_cast< float >( it.Value()[0] ) );
+      output.push_back( static_cast< float >( it.Value()[1] ) );
+      }
+    }
+
+  bool Evaluate( MeasureType & value, double * derivative ) const
+    {
+    const auto & transform = *this->GetMovingTransform();
+    const auto & parameters = transform.GetParameters();
+    const auto & center = transform.GetFixedParameters();
+
+    const double affineParameters[ 6 ] = { parameters[0], parameters[1],
+      parameters[2], parameters[3], parameters[4], parameters[5] };
+    const double affineCenter[ 2 ] = { center[0], center[1] };
+
+    double deviceValue = 0.0;
+
+    if( !m_Device.Evaluate( affineParameters, affineCenter,
+                            this->GetPointSetSigma(), this->GetAlpha(),
+                            deviceValue, derivative ) )
+      {
+      return false;
+      }
+
+    value = deviceValue;
+    return true;
+    }
+
+  viame::itk::JHCTMetricCuda m_Device;
+  bool m_UseDevice = false;
+};
+
+#endif
+
+using PhaseSymmetryImageType = itk::Image< float, Dimension >;
+using PhaseSymmetryFilterType =
+  itk::PhaseSymmetryImageFilter< PhaseSymmetryImageType, PhaseSymmetryImageType >;
+
+// Initialized phase symmetry filters, whose log-Gabor filter bank and FFT
+// filters only depend on the padded image size and the modality settings.
+// Each filter is used by one extraction at a time, and returned afterwards.
+class PhaseSymmetryFilterCache
+{
+public:
+  using KeyType = std::tuple< itk::SizeValueType, itk::SizeValueType, double, bool >;
+
+  static PhaseSymmetryFilterCache& instance()
+  {
+    static PhaseSymmetryFilterCache cache;
+    return cache;
+  }
+
+  // Filter for the given key, or null if a new one must be initialized
+  PhaseSymmetryFilterType::Pointer acquire( const KeyType& key )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    auto& filters = m_filters[ key ];
+
+    if( filters.empty() )
+      {
+      return nullptr;
+      }
+
+    PhaseSymmetryFilterType::Pointer filter = filters.back();
+    filters.pop_back();
+    return filter;
+  }
+
+  void release( const KeyType& key, const PhaseSymmetryFilterType::Pointer& filter )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    // Bound the memory held for sizes which are not used anymore
+    if( m_filters.size() > 8 && m_filters.find( key ) == m_filters.end() )
+      {
+      m_filters.clear();
+      }
+
+    auto& filters = m_filters[ key ];
+
+    if( filters.size() < 4 )
+      {
+      filters.push_back( filter );
+      }
+  }
+
+private:
+  std::mutex m_mutex;
+  std::map< KeyType, std::vector< PhaseSymmetryFilterType::Pointer > > m_filters;
+};
+
+// Keep at most budget points, the strongest of each cell of a coarse grid in
+// turn, so that the kept points stay spread over the image
+template< typename TPointSet, typename TImage >
+typename TPointSet::Pointer
+BudgetPointSet( const TPointSet& input, const TImage& strength, unsigned budget )
+{
+  constexpr unsigned cellsPerAxis = 8;
+
+  using PointType = typename TPointSet::PointType;
+  using CellType = std::vector< std::pair< float, PointType > >;
+
+  const auto region = strength.GetLargestPossibleRegion();
+  const auto size = region.GetSize();
+
+  std::vector< CellType > cells( cellsPerAxis * cellsPerAxis );
+  const typename TPointSet::PointsContainer* inputPoints = input.GetPoints();
+
+  for( auto it = inputPoints->Begin(); it != inputPoints->End(); ++it )
+    {
+    const PointType& point = it.Value();
+    typename TImage::IndexType index;
+    unsigned cell[2];
+
+    for( unsigned d = 0; d < 2; ++d )
+      {
+      index[d] = std::min< itk::IndexValueType >( size[d] - 1,
+        std::max< itk::IndexValueType >( 0, std::lround( point[d] ) ) );
+      cell[d] = std::min( cellsPerAxis - 1,
+        static_cast< unsigned >( index[d] * cellsPerAxis / size[d] ) );
+      }
+
+    cells[ cell[1] * cellsPerAxis + cell[0] ].emplace_back( strength.GetPixel( index ), point );
+    }
+
+  for( auto& cell : cells )
+    {
+    std::stable_sort( cell.begin(), cell.end(),
+      []( const typename CellType::value_type& a, const typename CellType::value_type& b )
+      {
+      return a.first > b.first;
+      } );
+    }
+
+  typename TPointSet::Pointer output = TPointSet::New();
+  typename TPointSet::PointsContainer::Pointer points = TPointSet::PointsContainer::New();
+
+  for( size_t rank = 0; points->Size() < budget; ++rank )
+    {
+    bool remaining = false;
+
+    for( const auto& cell : cells )
+      {
+      if( rank < cell.size() && points->Size() < budget )
+        {
+        points->InsertElement( points->Size(), cell[rank].second );
+        remaining = true;
+        }
+      }
+
+    if( !remaining )
+      {
+      break;
+      }
+    }
+
+  output->SetPoints( points );
+  return output;
+}
+
+using ClockType = std::chrono::steady_clock;
+
+double SecondsSince( const ClockType::time_point& start )
+{
+  return std::chrono::duration< double >( ClockType::now() - start ).count();
+}
+
+void AddStatistics( RegistrationStatistics* total, const RegistrationStatistics& part )
+{
+  if( !total )
+    {
+    return;
+    }
+
+  total->opticalPoints = part.opticalPoints;
+  total->thermalPoints = part.thermalPoints;
+  total->iterations += part.iterations;
+  total->finalMetricValue = part.finalMetricValue;
+  total->castTime += part.castTime;
+  total->shrinkTime += part.shrinkTime;
+  total->diffusionTime += part.diffusionTime;
+  total->extractionTime += part.extractionTime;
+  total->optimizationTime += part.optimizationTime;
+}
+
 template< typename InputImageType, typename TPointSet >
 typename TPointSet::Pointer
 PhaseSymmetryPointSet( const InputImageType& input, bool isThermal,
-  double shrinkFactor, AffineTransformType::Pointer& inputToSet )
+  double shrinkFactor, AffineTransformType::Pointer& inputToSet,
+  unsigned pointBudget = 0, RegistrationStatistics* statistics = nullptr )
 {
   constexpr unsigned int Dimension = 2;
   using PixelType = float;
@@ -156,10 +453,11 @@ PhaseSymmetryPointSet( const InputImageType& input, bool isThermal,
   typename FilterType::Pointer filter = FilterType::New();
   filter->SetInput( &input );
 
-  using ShrinkerType = itk::BinShrinkImageFilter< ImageType, ImageType >;
-  ShrinkerType::Pointer shrinker = ShrinkerType::New();
-  shrinker->SetInput( filter->GetOutput() );
-  using ShrinkFactorsType = ShrinkerType::ShrinkFactorsType;
+  // The shrinker casts while averaging bins, one pass over the input
+  using ShrinkerType = itk::BinShrinkImageFilter< InputImageType, ImageType >;
+  typename ShrinkerType::Pointer shrinker = ShrinkerType::New();
+  shrinker->SetInput( &input );
+  using ShrinkFactorsType = typename ShrinkerType::ShrinkFactorsType;
   ShrinkFactorsType shrinkFactors;
   shrinkFactors.Fill( shrinkFactor );
   shrinker->SetShrinkFactors( shrinkFactors );
@@ -188,11 +486,38 @@ PhaseSymmetryPointSet( const InputImageType& input, bool isThermal,
 
   ImageType::Pointer smoothedImage = smoother->GetOutput();
 
+  // Run the cast or shrink stage on its own, for its timing
+  ClockType::time_point stageStart = ClockType::now();
+
+  if( shrinkFactor == 0 || shrinkFactor == 1 )
+    {
+    filter->Update();
+    }
+  else
+    {
+    shrinker->Update();
+    }
+
+  if( statistics )
+    {
+    ( shrinkFactor == 0 || shrinkFactor == 1 ?
+      statistics->castTime : statistics->shrinkTime ) += SecondsSince( stageStart );
+    }
+
+  stageStart = ClockType::now();
+
   using FFTPadFilterType = itk::FFTPadImageFilter< ImageType >;
   FFTPadFilterType::Pointer fftPadFilter = FFTPadFilterType::New();
   fftPadFilter->SetInput( smoothedImage );
   fftPadFilter->Update();
 
+  if( statistics )
+    {
+    statistics->diffusionTime += SecondsSince( stageStart );
+    }
+
+  stageStart = ClockType::now();
+
   ImageType::Pointer padded = fftPadFilter->GetOutput();
   padded->DisconnectPipeline();
   ImageType::RegionType paddedRegion( padded->GetBufferedRegion() );
@@ -201,8 +526,19 @@ PhaseSymmetryPointSet( const InputImageType& input, bool isThermal,
   paddedRegion.SetIndex( 1, 0 );
   padded->SetRegions( paddedRegion );
 
-  using PhaseSymmetryFilterType = itk::PhaseSymmetryImageFilter< ImageType, ImageType >;
-  PhaseSymmetryFilterType::Pointer phaseSymmetryFilter = PhaseSymmetryFilterType::New();
+  const PhaseSymmetryFilterCache::KeyType cacheKey(
+    paddedSize[0], paddedSize[1], shrinkFactor, isThermal );
+
+  PhaseSymmetryFilterType::Pointer phaseSymmetryFilter =
+    PhaseSymmetryFilterCache::instance().acquire( cacheKey );
+
+  const bool initialized = phaseSymmetryFilter.IsNotNull();
+
+  if( !initialized )
+    {
+    phaseSymmetryFilter = PhaseSymmetryFilterType::New();
+    }
+
   phaseSymmetryFilter->SetInput( padded );
   phaseSymmetryFilter->SetSigma( 0.25 );
   phaseSymmetryFilter->SetPolarity( 0 );
@@ -228,7 +564,11 @@ PhaseSymmetryPointSet( const InputImageType& input, bool isThermal,
   phaseSymmetryFilter->SetWavelengths( wavelengths );
   smoother->Update();
   auto rescaledSize = smoothedImage->GetLargestPossibleRegion().GetSize();
-  phaseSymmetryFilter->Initialize();
+
+  if( !initialized )
+    {
+    phaseSymmetryFilter->Initialize();
+    }
 
   using MaskImageType = itk::Image< unsigned char, Dimension >;
   using ThresholderType = itk::BinaryThresholdImageFilter< ImageType, MaskImageType >;
@@ -290,6 +630,23 @@ PhaseSymmetryPointSet( const InputImageType& input, bool isThermal,
   maskToPointSetFilter->SetBandWidth( bandwidth );
   maskToPointSetFilter->Update();
 
+  // Mask coordinates are the indices of the padded phase symmetry image
+  typename TPointSet::Pointer pointSet = maskToPointSetFilter->GetOutput();
+
+  if( pointBudget > 0 && pointSet->GetNumberOfPoints() > pointBudget )
+    {
+    pointSet = BudgetPointSet< TPointSet, ImageType >(
+      *pointSet, *phaseSymmetryFilter->GetOutput(), pointBudget );
+    }
+
+  // The point set is computed, the filter can serve the next extraction
+  PhaseSymmetryFilterCache::instance().release( cacheKey, phaseSymmetryFilter );
+
+  if( statistics )
+    {
+    statistics->extractionTime += SecondsSince( stageStart );
+    }
+
   // Formulate output homography
   inputToSet = AffineTransformType::New();
   inputToSet->SetIdentity();
@@ -306,7 +663,114 @@ PhaseSymmetryPointSet( const InputImageType& input, bool isThermal,
 
   inputToSet->Translate( translation, false );
 
-  return maskToPointSetFilter->GetOutput();
+  return pointSet;
+}
+
+template< typename TPointSet >
+void ExtractPointSets(
+  const OpticalImageType& inputOpticalImage, const ThermalImageType& inputThermalImage,
+  double opticalShrinkFactor, double thermalShrinkFactor,
+  typename TPointSet::Pointer& opticalPointSet, typename TPointSet::Pointer& thermalPointSet,
+  AffineTransformType::Pointer& opticalToPointSet, AffineTransformType::Pointer& thermalToPointSet,
+  unsigned pointBudget, RegistrationStatistics& statistics )
+{
+  // Each extraction times its own stages, merged once both are done
+  RegistrationStatistics opticalStatistics;
+  RegistrationStatistics thermalStatistics;
+
+  // Both extractions are independent pipelines, run the optical one concurrently
+  std::future< typename TPointSet::Pointer > opticalExtraction = std::async( std::launch::async,
+    [&]()
+    {
+    return PhaseSymmetryPointSet< OpticalImageType, TPointSet >(
+      inputOpticalImage, false, opticalShrinkFactor, opticalToPointSet, pointBudget,
+      &opticalStatistics );
+    } );
+
+  try
+    {
+    thermalPointSet = PhaseSymmetryPointSet< ThermalImageType, TPointSet >(
+      inputThermalImage, true, thermalShrinkFactor, thermalToPointSet, pointBudget,
+      &thermalStatistics );
+    }
+  catch( ... )
+    {
+    opticalExtraction.wait();
+    throw;
+    }
+
+  opticalPointSet = opticalExtraction.get();
+
+  statistics.castTime += opticalStatistics.castTime + thermalStatistics.castTime;
+  statistics.shrinkTime += opticalStatistics.shrinkTime + thermalStatistics.shrinkTime;
+  statistics.diffusionTime += opticalStatistics.diffusionTime + thermalStatistics.diffusionTime;
+  statistics.extractionTime += opticalStatistics.extractionTime + thermalStatistics.extractionTime;
+}
+
+// Keep the first point of each cell of a regular grid
+template< typename TPointSet >
+typename TPointSet::Pointer
+GridSubsamplePointSet( const TPointSet& input, double spacing )
+{
+  typename TPointSet::Pointer output = TPointSet::New();
+  typename TPointSet::PointsContainer::Pointer points = TPointSet::PointsContainer::New();
+
+  std::unordered_set< long long > occupiedCells;
+  const typename TPointSet::PointsContainer* inputPoints = input.GetPoints();
+
+  for( auto it = inputPoints->Begin(); it != inputPoints->End(); ++it )
+    {
+    const auto& point = it.Value();
+    const long long cellX = static_cast< long long >( std::floor( point[0] / spacing ) );
+    const long long cellY = static_cast< long long >( std::floor( point[1] / spacing ) );
+
+    if( occupiedCells.insert( ( cellX << 32 ) ^ ( cellY & 0xffffffffLL ) ).second )
+      {
+      points->InsertElement( points->Size(), point );
+      }
+    }
+
+  output->SetPoints( points );
+  return output;
+}
+
+using HomogeneousMatrixType = itk::Matrix< double, Dimension + 1, Dimension + 1 >;
+
+HomogeneousMatrixType ToHomogeneous( const AffineTransformType& transform )
+{
+  HomogeneousMatrixType output;
+  output.SetIdentity();
+
+  for( unsigned int r = 0; r < Dimension; ++r )
+    {
+    for( unsigned int c = 0; c < Dimension; ++c )
+      {
+      output( r, c ) = transform.GetMatrix()( r, c );
+      }
+    output( r, Dimension ) = transform.GetOffset()[r];
+    }
+
+  return output;
+}
+
+AffineTransformType::Pointer FromHomogeneous( const HomogeneousMatrixType& matrix )
+{
+  AffineTransformType::MatrixType linear;
+  AffineTransformType::OutputVectorType offset;
+
+  for( unsigned int r = 0; r < Dimension; ++r )
+    {
+    for( unsigned int c = 0; c < Dimension; ++c )
+      {
+      linear( r, c ) = matrix( r, c );
+      }
+    offset[r] = matrix( r, Dimension );
+    }
+
+  AffineTransformType::Pointer output = AffineTransformType::New();
+  output->SetMatrix( linear );
+  output->SetOffset( offset );
+  return output;
 }
 
 } // end anynomous namespace
@@ -327,49 +791,188 @@ bool PerformRegistration(
   const double maximumPhysicalStepSize,
   const double pointSetSigma )
 {
+  AffineTransformType::Pointer pointSetTransform;
+  double finalMetricValue;
+
+  return PerformRegistration( inputOpticalImage, inputThermalImage,
+    outputTransformation, pointSetTransform, finalMetricValue,
+    opticalImageShrinkFactor, thermalImageShrinkFactor,
+    numberOfIterations, maximumPhysicalStepSize, pointSetSigma );
+}
+
+bool PerformRegistration(
+  const OpticalImageType& inputOpticalImage,
+  const ThermalImageType& inputThermalImage,
+  NetTransformType::Pointer& outputTransformation,
+  AffineTransformType::Pointer& initialPointSetTransform,
+  double& finalMetricValue,
+  const double opticalImageShrinkFactor,
+  const double thermalImageShrinkFactor,
+  const unsigned numberOfIterations,
+  const double maximumPhysicalStepSize,
+  const double pointSetSigma,
+  const unsigned pyramidLevels,
+  const unsigned refinementIterations,
+  const double gridSpacing,
+  const unsigned pointBudget,
+  RegistrationStatistics* statistics )
+{
+  RegistrationStatistics levelStatistics;
+
   try
     {
     constexpr unsigned int Dimension = 2;
     using PointSetType = ::itk::PointSet< float, Dimension >;
 
-    AffineTransformType::Pointer opticalToPointSet;
-    AffineTransformType::Pointer thermalToPointSet;
-
-    PointSetType::Pointer opticalPhaseSymmetryPointSet =
-      PhaseSymmetryPointSet< OpticalImageType, PointSetType >(
-        inputOpticalImage, false, opticalImageShrinkFactor, opticalToPointSet );
-    PointSetType::Pointer thermalPhaseSymmetryPointSet =
-      PhaseSymmetryPointSet< ThermalImageType, PointSetType >(
-        inputThermalImage, true, thermalImageShrinkFactor, thermalToPointSet );
-
     using JHCTPointSetMetricType =
       ::itk::JensenHavrdaCharvatTsallisPointSetToPointSetMetricv4< PointSetType >;
 
-    JHCTPointSetMetricType::Pointer jhctMetric = JHCTPointSetMetricType::New();
+    AffineTransformType::Pointer opticalToPointSet;
+    AffineTransformType::Pointer thermalToPointSet;
+
     AffineTransformType::Pointer pointSetTransform = AffineTransformType::New();
     pointSetTransform->SetIdentity();
 
-    JHCTPointSetMetricRegistration< AffineTransformType, JHCTPointSetMetricType, PointSetType >
-      ( numberOfIterations, maximumPhysicalStepSize,
-        pointSetTransform, jhctMetric,
-        thermalPhaseSymmetryPointSet,
-        opticalPhaseSymmetryPointSet,
-        pointSetSigma );
+    // Copy the initial transform, the caller keeps it if the registration fails
+    if( initialPointSetTransform )
+      {
+      pointSetTransform->SetFixedParameters( initialPointSetTransform->GetFixedParameters() );
+      pointSetTransform->SetParameters( initialPointSetTransform->GetParameters() );
+      }
+
+    // Initial transforms are already close, they only need the finest level
+    const unsigned levels =
+      ( initialPointSetTransform ? 1 : std::max( 1u, pyramidLevels ) );
+
+    for( unsigned level = levels; level-- > 0; )
+      {
+      // Each coarser level halves the resolution of both point sets
+      const double factor = static_cast< double >( 1u << level );
+      const double opticalShrink = ( level == 0 ? opticalImageShrinkFactor :
+        std::max( 1.0, opticalImageShrinkFactor ) * factor );
+      const double thermalShrink = ( level == 0 ? thermalImageShrinkFactor :
+        std::max( 1.0, thermalImageShrinkFactor ) * factor );
+
+      AffineTransformType::Pointer levelOpticalToPointSet;
+      AffineTransformType::Pointer levelThermalToPointSet;
+
+      PointSetType::Pointer opticalPhaseSymmetryPointSet;
+      PointSetType::Pointer thermalPhaseSymmetryPointSet;
+
+      ExtractPointSets< PointSetType >( inputOpticalImage, inputThermalImage,
+        opticalShrink, thermalShrink,
+        opticalPhaseSymmetryPointSet, thermalPhaseSymmetryPointSet,
+        levelOpticalToPointSet, levelThermalToPointSet, pointBudget, levelStatistics );
+
+      unsigned iterations = numberOfIterations;
+
+      if( level + 1 < levels )
+        {
+        // Express the coarser result between the point sets of this level, keeping the
+        // net optical to thermal transform unchanged
+        pointSetTransform = FromHomogeneous(
+          HomogeneousMatrixType( ToHomogeneous( *levelThermalToPointSet ).GetInverse() ) *
+          ToHomogeneous( *thermalToPointSet ) *
+          ToHomogeneous( *pointSetTransform ) *
+          HomogeneousMatrixType( ToHomogeneous( *opticalToPointSet ).GetInverse() ) *
+          ToHomogeneous( *levelOpticalToPointSet ) );
+
+        if( gridSpacing > 0.0 )
+          {
+          opticalPhaseSymmetryPointSet =
+            GridSubsamplePointSet< PointSetType >( *opticalPhaseSymmetryPointSet, gridSpacing );
+          thermalPhaseSymmetryPointSet =
+            GridSubsamplePointSet< PointSetType >( *thermalPhaseSymmetryPointSet, gridSpacing );
+          }
+
+        iterations = refinementIterations;
+        }
+
+      opticalToPointSet = levelOpticalToPointSet;
+      thermalToPointSet = levelThermalToPointSet;
+
+      levelStatistics.opticalPoints = opticalPhaseSymmetryPointSet->GetNumberOfPoints();
+      levelStatistics.thermalPoints = thermalPhaseSymmetryPointSet->GetNumberOfPoints();
+
+      const ClockType::time_point optimizationStart = ClockType::now();
+      unsigned iterationsRun = 0;
+      bool optimized = false;
+
+#ifdef VIAME_ITK_CUDA
+      if( g_useCudaMetric )
+        {
+        using CudaMetricType = JHCTPointSetMetricCudav4< PointSetType >;
+        CudaMetricType::Pointer cudaMetric = CudaMetricType::New();
+
+        JHCTPointSetMetricRegistration< AffineTransformType, CudaMetricType, PointSetType >
+          ( iterations, maximumPhysicalStepSize,
+            pointSetTransform, cudaMetric,
+            thermalPhaseSymmetryPointSet,
+            opticalPhaseSymmetryPointSet,
+            pointSetSigma, finalMetricValue, iterationsRun );
+        optimized = true;
+        }
+#endif
+
+      if( !optimized )
+        {
+        JHCTPointSetMetricType::Pointer jhctMetric = JHCTPointSetMetricType::New();
+
+        JHCTPointSetMetricRegistration< AffineTransformType, JHCTPointSetMetricType, PointSetType >
+          ( iterations, maximumPhysicalStepSize,
+            pointSetTransform, jhctMetric,
+            thermalPhaseSymmetryPointSet,
+            opticalPhaseSymmetryPointSet,
+            pointSetSigma, finalMetricValue, iterationsRun );
+        }
+
+      levelStatistics.optimizationTime += SecondsSince( optimizationStart );
+      levelStatistics.iterations += iterationsRun;
+      levelStatistics.finalMetricValue = finalMetricValue;
+      }
 
     outputTransformation = NetTransformType::New();
 
     outputTransformation->AddTransform( opticalToPointSet );
     outputTransformation->AddTransform( pointSetTransform->GetInverseTransform() );
     outputTransformation->AddTransform( thermalToPointSet->GetInverseTransform() );
+
+    initialPointSetTransform = pointSetTransform;
     }
   catch( ... )
     {
+      AddStatistics( statistics, levelStatistics );
       return false;
     }
 
+  AddStatistics( statistics, levelStatistics );
   return true;
 }
 
+void SetRegistrationThreadCount( const unsigned numberOfThreads )
+{
+  if( numberOfThreads == 0 )
+    {
+    return;
+    }
+
+#if ITK_VERSION_MAJOR >= 5
+  ::itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads( numberOfThreads );
+#else
+  ::itk::MultiThreader::SetGlobalDefaultNumberOfThreads( numberOfThreads );
+#endif
+}
+
+bool SetRegistrationUseCuda( const bool useCuda )
+{
+#ifdef VIAME_ITK_CUDA
+  g_useCudaMetric = useCuda && JHCTMetricCuda::IsAvailable();
+  return g_useCudaMetric;
+#else
+  return false;
+#endif
+}
+
 bool WarpThermalToOpticalImage(
   const OpticalImageType& inputOpticalImage,
   const ThermalImageType& inputThermalImage,
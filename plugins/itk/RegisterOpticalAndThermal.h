@@ -61,6 +61,27 @@ using BaseTransformType = ::itk::Transform< TransformFloatType, Dimension, Dimen
 using AffineTransformType = ::itk::AffineTransform< TransformFloatType, Dimension >;
 using NetTransformType = ::itk::CompositeTransform< TransformFloatType, Dimension >;
 
+// Telemetry of registrations, accumulated over the calls it is given to. Stage
+// times are wall times in seconds summed over the pyramid levels and over both
+// modalities, whose point sets are extracted concurrently. The cast time is
+// only spent on images which are not shrunk, the shrinker casting them.
+struct RegistrationStatistics
+{
+  // Point set sizes of the last level registered
+  unsigned opticalPoints = 0;
+  unsigned thermalPoints = 0;
+
+  // Optimizer iterations run over all levels, final metric value of the last one
+  unsigned iterations = 0;
+  double finalMetricValue = 0.0;
+
+  double castTime = 0.0;
+  double shrinkTime = 0.0;
+  double diffusionTime = 0.0;
+  double extractionTime = 0.0;
+  double optimizationTime = 0.0;
+};
+
 VIAME_ITK_EXPORT bool PerformRegistration(
   const OpticalImageType& inputOpticalImage,
   const ThermalImageType& inputThermalImage,
@@ -71,6 +92,42 @@ VIAME_ITK_EXPORT bool PerformRegistration(
   const double maximumPhysicalStepSize = 2.0,
   const double pointSetSigma = 3.0 );
 
+// Same as above, starting the point set registration from pointSetTransform if it
+// is set, which is replaced by the final point set transform on success. The final
+// value of the minimized metric is returned in finalMetricValue.
+//
+// With several pyramid levels and no initial transform, the point sets are first
+// registered at coarser shrink factors, each level halving the resolution. Finer levels
+// start from the coarser result and run refinementIterations iterations on point sets
+// keeping one point per gridSpacing sized cell, if gridSpacing is positive.
+//
+// A non-zero pointBudget bounds the size of each extracted point set, keeping the
+// points with the strongest phase symmetry spread over a coarse grid of the image.
+// The telemetry of the registration is added to statistics if it is set.
+VIAME_ITK_EXPORT bool PerformRegistration(
+  const OpticalImageType& inputOpticalImage,
+  const ThermalImageType& inputThermalImage,
+  NetTransformType::Pointer& outputTransformation,
+  AffineTransformType::Pointer& pointSetTransform,
+  double& finalMetricValue,
+  const double opticalImageShrinkFactor = 10.0,
+  const double thermalImageShrinkFactor = 1.0,
+  const unsigned numberOfIterations = 100,
+  const double maximumPhysicalStepSize = 2.0,
+  const double pointSetSigma = 3.0,
+  const unsigned pyramidLevels = 1,
+  const unsigned refinementIterations = 20,
+  const double gridSpacing = 2.0,
+  const unsigned pointBudget = 0,
+  RegistrationStatistics* statistics = nullptr );
+
+// Set the default number of threads used by each ITK filter, 0 keeps the ITK default
+VIAME_ITK_EXPORT void SetRegistrationThreadCount( const unsigned numberOfThreads );
+
+// Evaluate the point set metric of later registrations on the GPU, if built with
+// CUDA support. Returns true if the GPU metric is used.
+VIAME_ITK_EXPORT bool SetRegistrationUseCuda( const bool useCuda );
+
 VIAME_ITK_EXPORT bool WarpThermalToOpticalImage(
   const OpticalImageType& inputOpticalImage,
   const ThermalImageType& inputThermalImage,
@@ -36,6 +36,9 @@
 #include "RegistrationProcess.h"
 #include "RegisterOpticalAndThermal.h"
 
+#include <plugins/core/lazy_image_container.h>
+
+#include <itkImportImageFilter.h>
 #include <itkOpenCVImageBridge.h>
 
 #include <vital/vital_types.h>
@@ -46,6 +49,17 @@
 
 #include <arrows/ocv/image_container.h>
 
+#include <sprokit/pipeline/process_exception.h>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
 using namespace viame::core;
 
 namespace viame
@@ -54,157 +68,838 @@ namespace viame
 namespace itk
 {
 
+create_config_trait( warm_start, bool, "false",
+  "Start the registration of each image pair from the transform found for the "
+  "previous pair, with fewer iterations. Suited to rigidly mounted cameras." );
+create_config_trait( warm_start_iterations, unsigned, "20",
+  "Number of optimizer iterations of warm started registrations" );
+create_config_trait( full_iterations, unsigned, "100",
+  "Number of optimizer iterations of registrations started from scratch" );
+create_config_trait( warm_start_tolerance, double, "0.05",
+  "Relative increase of the final metric value, compared to the last full "
+  "registration, above which a warm started result is rejected and the pair "
+  "is registered again from scratch" );
+create_config_trait( pyramid_levels, unsigned, "1",
+  "Number of resolution levels of registrations started from scratch, each "
+  "coarser level halving the resolution of the point sets" );
+create_config_trait( refinement_iterations, unsigned, "20",
+  "Number of optimizer iterations of the levels refining a coarser result" );
+create_config_trait( grid_spacing, double, "2.0",
+  "Size of the grid cells the point sets of refinement levels are subsampled "
+  "by, keeping one point per cell. 0 keeps every point." );
+create_config_trait( point_budget, unsigned, "0",
+  "Maximum number of points extracted from each image, keeping the "
+  "strongest phase symmetry points spread over the image, for bounded "
+  "registration times. 0 keeps every point." );
+create_config_trait( itk_threads, unsigned, "0",
+  "Default number of threads of the ITK filters, 0 keeps the ITK default. The "
+  "optical and thermal point sets are always extracted concurrently." );
+create_config_trait( use_cuda, bool, "false",
+  "Evaluate the point set metric on the GPU, if the plugin was built with CUDA "
+  "support and a device is available" );
+create_config_trait( cache_file, std::string, "",
+  "File caching accepted transforms across runs, in the format written by "
+  "write_homography_list_process. Transforms are cached in memory only if "
+  "empty and use_cache is set." );
+create_config_trait( use_cache, bool, "false",
+  "Reuse accepted transforms of the same camera pair, calibration epoch and "
+  "time bucket when they pass a quick validation" );
+create_config_trait( camera_pair, std::string, "optical:thermal",
+  "Identifier of the camera pair in the transform cache" );
+create_config_trait( calibration_epoch, std::string, "default",
+  "Identifier of the rig calibration in the transform cache, change it when "
+  "the cameras are remounted" );
+create_config_trait( cache_time_bucket, double, "0.0",
+  "Duration in seconds of the time buckets transforms are cached by, 0 uses "
+  "one transform per calibration epoch" );
+create_config_trait( validation_threshold, double, "0.2",
+  "Minimum correlation between the optical and warped thermal gradient "
+  "magnitudes for a cached transform to be reused" );
+create_config_trait( validation_width, unsigned, "320",
+  "Width the optical image is reduced to when validating cached transforms" );
+create_config_trait( stats_file, std::string, "",
+  "Optional CSV file the telemetry of every registered pair is written to, "
+  "with the columns of the registration_stats port. Rows are written when "
+  "registrations finish, which may be out of order with several "
+  "registration_threads." );
+
+// Columns of the registration telemetry
+const char* const stats_header =
+  "timestamp,optical_file,thermal_file,method,success,optical_points,"
+  "thermal_points,iterations,final_metric,cast_s,shrink_s,diffusion_s,"
+  "extraction_s,optimization_s,total_s";
+
+namespace
+{
+
+// Convert a composite of affine transforms to the equivalent homography
+kwiver::vital::matrix_3x3d
+transform_to_homography( const NetTransformType& transform )
+{
+  kwiver::vital::matrix_3x3d net_output = kwiver::vital::matrix_3x3d::Identity();
+
+  for( unsigned n = 0; n < transform.GetNumberOfTransforms(); n++ )
+  {
+    const AffineTransformType* itk_affine_transform =
+      dynamic_cast< const AffineTransformType* >(
+        transform.GetNthTransform( n ).GetPointer() );
+
+    if( !itk_affine_transform )
+    {
+      throw std::runtime_error( "Unknown transformation type received" );
+    }
+
+    const auto& in_values = itk_affine_transform->GetMatrix();
+    kwiver::vital::matrix_3x3d next_homog = kwiver::vital::matrix_3x3d::Identity();
+
+    for( unsigned r = 0; r < Dimension; ++r )
+    {
+      for( unsigned c = 0; c < Dimension; ++c )
+      {
+        next_homog( r, c ) = in_values( r, c );
+      }
+
+      next_homog( r, 2 ) = itk_affine_transform->GetOffset()[ r ];
+    }
+
+    net_output = net_output * next_homog;
+  }
+
+  return net_output;
+}
+
+// Composite transform made of the affine transform of a homography
+NetTransformType::Pointer
+homography_to_transform( const kwiver::vital::matrix_3x3d& homography )
+{
+  AffineTransformType::Pointer affine = AffineTransformType::New();
+
+  AffineTransformType::MatrixType matrix;
+  AffineTransformType::OutputVectorType offset;
+
+  for( unsigned r = 0; r < Dimension; ++r )
+  {
+    for( unsigned c = 0; c < Dimension; ++c )
+    {
+      matrix( r, c ) = homography( r, c ) / homography( 2, 2 );
+    }
+
+    offset[ r ] = homography( r, 2 ) / homography( 2, 2 );
+  }
+
+  affine->SetMatrix( matrix );
+  affine->SetOffset( offset );
+
+  NetTransformType::Pointer output = NetTransformType::New();
+  output->AddTransform( affine );
+  return output;
+}
+
+// Single channel float version of an image
+cv::Mat
+to_gray( const cv::Mat& image )
+{
+  cv::Mat gray;
+
+  if( image.channels() == 3 )
+  {
+    cv::cvtColor( image, gray, cv::COLOR_BGR2GRAY );
+  }
+  else
+  {
+    gray = image;
+  }
+
+  gray.convertTo( gray, CV_32F );
+  return gray;
+}
+
+// Gradient magnitude of a single channel float image
+cv::Mat
+gradient_magnitude( const cv::Mat& image )
+{
+  cv::Mat dx, dy, magnitude;
+  cv::Sobel( image, dx, CV_32F, 1, 0 );
+  cv::Sobel( image, dy, CV_32F, 0, 1 );
+  cv::magnitude( dx, dy, magnitude );
+  return magnitude;
+}
+
+// Correlation of the optical and warped thermal gradient magnitudes at low
+// resolution, over the optical pixels covered by the thermal image
+double
+validation_score( const cv::Mat& optical, const cv::Mat& thermal,
+                  const kwiver::vital::matrix_3x3d& optical_to_thermal,
+                  unsigned width )
+{
+  if( optical.empty() || thermal.empty() )
+  {
+    return -1.0;
+  }
+
+  const double scale = std::min( 1.0, static_cast< double >( width ) / optical.cols );
+  const cv::Size size( std::max( 1, static_cast< int >( optical.cols * scale ) ),
+                       std::max( 1, static_cast< int >( optical.rows * scale ) ) );
+
+  cv::Mat optical_small;
+  cv::resize( to_gray( optical ), optical_small, size, 0, 0, cv::INTER_AREA );
+
+  // Map from the reduced optical image to the thermal image
+  cv::Matx33d to_thermal;
+
+  for( int r = 0; r < 3; ++r )
+  {
+    for( int c = 0; c < 3; ++c )
+    {
+      to_thermal( r, c ) = optical_to_thermal( r, c );
+    }
+  }
+
+  to_thermal = to_thermal * cv::Matx33d( 1.0 / scale, 0, 0, 0, 1.0 / scale, 0, 0, 0, 1 );
+
+  const cv::Mat thermal_gray = to_gray( thermal );
+  cv::Mat warped, coverage;
+
+  cv::warpPerspective( thermal_gray, warped, to_thermal, size,
+                       cv::INTER_LINEAR | cv::WARP_INVERSE_MAP );
+  cv::warpPerspective( cv::Mat( thermal_gray.size(), CV_8U, cv::Scalar( 255 ) ), coverage,
+                       to_thermal, size, cv::INTER_NEAREST | cv::WARP_INVERSE_MAP );
+
+  // Avoid the borders of the coverage, where the gradients are artificial
+  cv::erode( coverage, coverage, cv::Mat(), cv::Point( -1, -1 ), 2 );
+
+  if( cv::countNonZero( coverage ) < 100 )
+  {
+    return -1.0;
+  }
+
+  const cv::Mat a = gradient_magnitude( optical_small );
+  const cv::Mat b = gradient_magnitude( warped );
+
+  cv::Scalar mean_a, std_a, mean_b, std_b;
+  cv::meanStdDev( a, mean_a, std_a, coverage );
+  cv::meanStdDev( b, mean_b, std_b, coverage );
+
+  if( std_a[0] <= 0.0 || std_b[0] <= 0.0 )
+  {
+    return -1.0;
+  }
+
+  const double mean_ab = cv::mean( a.mul( b ), coverage )[0];
+
+  return ( mean_ab - mean_a[0] * mean_b[0] ) / ( std_a[0] * std_b[0] );
+}
+
+// OpenCV view or conversion of an image
+cv::Mat
+vital_to_ocv( const kwiver::vital::image& image )
+{
+  return kwiver::arrows::ocv::image_container::vital_to_ocv(
+    image, kwiver::arrows::ocv::image_container::BGR_COLOR );
+}
+
+// CSV row of the telemetry of one registration, in the stats_header columns
+std::string
+format_statistics( const kwiver::vital::timestamp& ts,
+                   const std::string& optical_file,
+                   const std::string& thermal_file,
+                   const std::string& method,
+                   const bool success,
+                   const RegistrationStatistics& stats,
+                   const double total_time )
+{
+  std::stringstream row;
+
+  row << ( ts.has_valid_time() ? ts.get_time_usec() : 0 ) << ","
+      << optical_file << "," << thermal_file << ","
+      << method << "," << ( success ? 1 : 0 ) << ","
+      << stats.opticalPoints << "," << stats.thermalPoints << ","
+      << stats.iterations << "," << stats.finalMetricValue << ","
+      << stats.castTime << "," << stats.shrinkTime << ","
+      << stats.diffusionTime << "," << stats.extractionTime << ","
+      << stats.optimizationTime << "," << total_time;
+
+  return row.str();
+}
+
+// ITK image of a vital image, sharing its buffer when it has the ITK pixel type
+// and contiguous rows, which must then outlive the output
+template< typename ImageType >
+typename ImageType::Pointer
+vital_to_itk( const kwiver::vital::image& image )
+{
+  using PixelType = typename ImageType::PixelType;
+
+  if( image.depth() != 1 || image.w_step() != 1 ||
+      image.h_step() != static_cast< ptrdiff_t >( image.width() ) ||
+      image.pixel_traits() != kwiver::vital::image_pixel_traits_of< PixelType >() )
+  {
+    return ::itk::OpenCVImageBridge::CVMatToITKImage< ImageType >( vital_to_ocv( image ) );
+  }
+
+  using ImportFilterType = ::itk::ImportImageFilter< PixelType, Dimension >;
+  typename ImportFilterType::Pointer importer = ImportFilterType::New();
+
+  typename ImportFilterType::SizeType size;
+  size[0] = image.width();
+  size[1] = image.height();
+
+  typename ImportFilterType::IndexType start;
+  start.Fill( 0 );
+
+  importer->SetRegion( typename ImportFilterType::RegionType( start, size ) );
+
+  ::itk::SpacePrecisionType origin[ Dimension ] = { 0.0, 0.0 };
+  ::itk::SpacePrecisionType spacing[ Dimension ] = { 1.0, 1.0 };
+
+  importer->SetOrigin( origin );
+  importer->SetSpacing( spacing );
+
+  // Filters only read their input, the buffer is not modified
+  importer->SetImportPointer(
+    const_cast< PixelType* >( static_cast< const PixelType* >( image.first_pixel() ) ),
+    image.width() * image.height(), false );
+  importer->Update();
+
+  return importer->GetOutput();
+}
+
+} // end anonymous namespace
+
+//------------------------------------------------------------------------------
+// Private implementation class
+class itk_eo_ir_registration_process::priv
+{
+public:
+  priv()
+    : m_warm_start( false )
+    , m_warm_start_iterations( 20 )
+    , m_full_iterations( 100 )
+    , m_warm_start_tolerance( 0.05 )
+    , m_pyramid_levels( 1 )
+    , m_refinement_iterations( 20 )
+    , m_grid_spacing( 2.0 )
+    , m_point_budget( 0 )
+    , m_reference_metric( 0.0 )
+    , m_use_cache( false )
+    , m_cache_time_bucket( 0.0 )
+    , m_validation_threshold( 0.2 )
+    , m_validation_width( 320 )
+  {}
+
+  ~priv() {}
+
+  // Cache key of a frame within the camera pair entries
+  std::string cache_key( const kwiver::vital::timestamp& ts ) const;
+
+  // Record an accepted transform, persisting the cache if a file is set
+  void store( const std::string& key, const kwiver::vital::matrix_3x3d& homography );
+
+  // Update the cache from the given file, if it exists
+  void load_cache();
+  void save_cache() const;
+
+  // Configuration values
+  bool m_warm_start;
+  unsigned m_warm_start_iterations;
+  unsigned m_full_iterations;
+  double m_warm_start_tolerance;
+  unsigned m_pyramid_levels;
+  unsigned m_refinement_iterations;
+  double m_grid_spacing;
+  unsigned m_point_budget;
+
+  // Point set transform of the previous pair, only valid for the same image sizes
+  AffineTransformType::Pointer m_previous_transform;
+  OpticalImageType::SizeType m_optical_size;
+  ThermalImageType::SizeType m_thermal_size;
+
+  // Final metric value of the last full registration
+  double m_reference_metric;
+
+  // Transform cache configuration
+  std::string m_cache_file;
+  bool m_use_cache;
+  std::string m_camera_pair;
+  std::string m_calibration_epoch;
+  double m_cache_time_bucket;
+  double m_validation_threshold;
+  unsigned m_validation_width;
+
+  // Optical to thermal homographies by camera pair and epoch / time bucket
+  std::map< std::pair< std::string, std::string >, kwiver::vital::matrix_3x3d > m_cache;
+
+  // Telemetry log, if a stats file is set
+  std::ofstream m_stats_log;
+
+  // Guards the previous transform, cache and log against concurrent registrations
+  std::mutex m_mutex;
+};
+
+
+// -----------------------------------------------------------------------------
+std::string
+itk_eo_ir_registration_process::priv
+::cache_key( const kwiver::vital::timestamp& ts ) const
+{
+  if( m_cache_time_bucket <= 0.0 || !ts.has_valid_time() )
+  {
+    return m_calibration_epoch;
+  }
+
+  const long long bucket = static_cast< long long >(
+    std::floor( ts.get_time_usec() / ( m_cache_time_bucket * 1e6 ) ) );
+
+  return m_calibration_epoch + "@" + std::to_string( bucket );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+itk_eo_ir_registration_process::priv
+::store( const std::string& key, const kwiver::vital::matrix_3x3d& homography )
+{
+  if( !m_use_cache )
+  {
+    return;
+  }
+
+  m_cache[ std::make_pair( m_camera_pair, key ) ] = homography;
+
+  if( !m_cache_file.empty() )
+  {
+    save_cache();
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+itk_eo_ir_registration_process::priv
+::load_cache()
+{
+  std::ifstream input( m_cache_file );
+
+  if( !input.is_open() )
+  {
+    return;
+  }
+
+  // Entries are a source line, a destination line then either the 3x3 matrix
+  // or a no match string, followed by an empty line
+  std::vector< std::string > lines;
+  std::string line;
+
+  auto parse_entry = [&]()
+  {
+    if( lines.size() >= 3 )
+    {
+      std::stringstream values;
+
+      for( unsigned i = 2; i < lines.size(); ++i )
+      {
+        values << lines[i] << " ";
+      }
+
+      kwiver::vital::matrix_3x3d homography;
+      bool valid = true;
+
+      for( unsigned i = 0; i < 9 && valid; ++i )
+      {
+        valid = static_cast< bool >( values >> homography( i / 3, i % 3 ) );
+      }
+
+      if( valid )
+      {
+        m_cache[ std::make_pair( lines[0], lines[1] ) ] = homography;
+      }
+    }
+
+    lines.clear();
+  };
+
+  while( std::getline( input, line ) )
+  {
+    if( line.empty() )
+    {
+      parse_entry();
+    }
+    else
+    {
+      lines.push_back( line );
+    }
+  }
+
+  parse_entry();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+itk_eo_ir_registration_process::priv
+::save_cache() const
+{
+  std::ofstream output( m_cache_file, std::ofstream::out );
+
+  if( !output.is_open() )
+  {
+    throw std::runtime_error( "Unable to open " + m_cache_file );
+  }
+
+  for( const auto& entry : m_cache )
+  {
+    output << entry.first.first << std::endl;
+    output << entry.first.second << std::endl;
+    output << kwiver::vital::homography_< double >( entry.second ) << std::endl;
+    output << std::endl;
+  }
+}
+
 // =============================================================================
 
 itk_eo_ir_registration_process
 ::itk_eo_ir_registration_process( kwiver::vital::config_block_sptr const& config )
   : align_multimodal_imagery_process( config )
+  , d( new itk_eo_ir_registration_process::priv() )
 {
+  make_config();
 }
 
 
 itk_eo_ir_registration_process
 ::~itk_eo_ir_registration_process()
 {
+  finish_registrations();
 }
 
+
+// -----------------------------------------------------------------------------
 void
 itk_eo_ir_registration_process
-::attempt_registration( const buffered_frame& optical,
-                        const buffered_frame& thermal,
-                        const bool optical_dom )
+::_configure()
 {
-  viame::itk::NetTransformType::Pointer output_transform;
+  align_multimodal_imagery_process::_configure();
+
+  d->m_warm_start =
+    config_value_using_trait( warm_start );
+  d->m_warm_start_iterations =
+    config_value_using_trait( warm_start_iterations );
+  d->m_full_iterations =
+    config_value_using_trait( full_iterations );
+  d->m_warm_start_tolerance =
+    config_value_using_trait( warm_start_tolerance );
+
+  d->m_pyramid_levels =
+    config_value_using_trait( pyramid_levels );
+  d->m_refinement_iterations =
+    config_value_using_trait( refinement_iterations );
+  d->m_grid_spacing =
+    config_value_using_trait( grid_spacing );
+  d->m_point_budget =
+    config_value_using_trait( point_budget );
+
+  d->m_previous_transform = nullptr;
 
-  auto itk_optical_image = 
-    ::itk::OpenCVImageBridge::CVMatToITKImage< viame::itk::OpticalImageType >(
-      kwiver::arrows::ocv::image_container::vital_to_ocv(
-        optical.image->get_image(),
-        kwiver::arrows::ocv::image_container::BGR_COLOR ) );
+  SetRegistrationThreadCount( config_value_using_trait( itk_threads ) );
 
-  auto itk_thermal_image = 
-    ::itk::OpenCVImageBridge::CVMatToITKImage< viame::itk::ThermalImageType >(
-      kwiver::arrows::ocv::image_container::vital_to_ocv(
-        thermal.image->get_image(),
-        kwiver::arrows::ocv::image_container::BGR_COLOR ) );
+  const bool use_gpu = config_value_using_trait( use_cuda );
 
-  if( PerformRegistration( *itk_optical_image, *itk_thermal_image, output_transform ) )
+  if( !SetRegistrationUseCuda( use_gpu ) && use_gpu )
   {
-    // Convert matrix to kwiver
-    kwiver::vital::homography_sptr optical_to_thermal(
-      new kwiver::vital::homography_< double >() );
+    LOG_WARN( logger(), "No CUDA device available, using the CPU point set metric" );
+  }
+
+  d->m_cache_file =
+    config_value_using_trait( cache_file );
+  d->m_use_cache =
+    config_value_using_trait( use_cache ) || !d->m_cache_file.empty();
+  d->m_camera_pair =
+    config_value_using_trait( camera_pair );
+  d->m_calibration_epoch =
+    config_value_using_trait( calibration_epoch );
+  d->m_cache_time_bucket =
+    config_value_using_trait( cache_time_bucket );
+  d->m_validation_threshold =
+    config_value_using_trait( validation_threshold );
+  d->m_validation_width =
+    config_value_using_trait( validation_width );
+
+  d->m_cache.clear();
+
+  if( !d->m_cache_file.empty() )
+  {
+    d->load_cache();
+  }
 
-    kwiver::vital::matrix_3x3d& net_output =
-      dynamic_cast< kwiver::vital::homography_< double >* >(
-        optical_to_thermal.get() )->get_matrix();
+  const std::string stats_file = config_value_using_trait( stats_file );
 
-    net_output = kwiver::vital::matrix_3x3d::Identity();
+  if( d->m_stats_log.is_open() )
+  {
+    d->m_stats_log.close();
+  }
+
+  if( !stats_file.empty() )
+  {
+    d->m_stats_log.open( stats_file, std::ofstream::out );
 
-    for( unsigned n = 0; n < output_transform->GetNumberOfTransforms(); n++ )
+    if( !d->m_stats_log.is_open() )
     {
-      viame::itk::AffineTransformType* itk_affine_transform = 
-        dynamic_cast< viame::itk::AffineTransformType* >(
-          output_transform->GetNthTransform( n ).GetPointer() );
+      VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                   "Unable to open stats_file " + stats_file );
+    }
 
-      if( !itk_affine_transform )
-      {
-        throw std::runtime_error( "Unknown transformation type received" );
-      }
+    d->m_stats_log << stats_header << '\n';
+  }
+}
 
-      const auto& in_values = itk_affine_transform->GetMatrix();
-      kwiver::vital::matrix_3x3d next_homog;
 
-      for( unsigned r = 0; r < viame::itk::Dimension; ++r )
-      {
-        for( unsigned c = 0; c < viame::itk::Dimension; ++c )
-        {
-          next_homog( r, c ) = in_values( r, c );
-        }
-      }
+// -----------------------------------------------------------------------------
+void
+itk_eo_ir_registration_process
+::make_config()
+{
+  declare_config_using_trait( warm_start );
+  declare_config_using_trait( warm_start_iterations );
+  declare_config_using_trait( full_iterations );
+  declare_config_using_trait( warm_start_tolerance );
+  declare_config_using_trait( pyramid_levels );
+  declare_config_using_trait( refinement_iterations );
+  declare_config_using_trait( grid_spacing );
+  declare_config_using_trait( point_budget );
+  declare_config_using_trait( itk_threads );
+  declare_config_using_trait( use_cuda );
+  declare_config_using_trait( cache_file );
+  declare_config_using_trait( use_cache );
+  declare_config_using_trait( camera_pair );
+  declare_config_using_trait( calibration_epoch );
+  declare_config_using_trait( cache_time_bucket );
+  declare_config_using_trait( validation_threshold );
+  declare_config_using_trait( validation_width );
+  declare_config_using_trait( stats_file );
+}
 
-      if( viame::itk::Dimension == 2 )
-      {
-        next_homog( 2, 0 ) = 0;
-        next_homog( 2, 1 ) = 0;
-        next_homog( 2, 2 ) = 1;
 
-        next_homog( 1, 2 ) = itk_affine_transform->GetOffset()[ 1 ];
-        next_homog( 0, 2 ) = itk_affine_transform->GetOffset()[ 0 ];
-      }
+// -----------------------------------------------------------------------------
+itk_eo_ir_registration_process::registration_result
+itk_eo_ir_registration_process
+::register_frames( const buffered_frame& optical,
+                   const buffered_frame& thermal,
+                   const bool optical_dom )
+{
+  const auto start_time = std::chrono::steady_clock::now();
 
-      net_output = net_output * next_homog;
-    }
+  viame::itk::NetTransformType::Pointer output_transform;
+  kwiver::vital::matrix_3x3d net_output;
+  RegistrationStatistics stats;
+  std::string method = "full";
+
+  auto itk_optical_image =
+    vital_to_itk< viame::itk::OpticalImageType >( optical.image->get_image() );
 
-    // Output required elements depending on connections
-    push_to_port_using_trait( optical_image, optical.image );
-    push_to_port_using_trait( optical_file_name, optical.name );
-    push_to_port_using_trait( thermal_image, thermal.image );
-    push_to_port_using_trait( thermal_file_name, thermal.name );
-    push_to_port_using_trait( timestamp, ( optical_dom ? optical.ts : thermal.ts ) );
-    push_to_port_using_trait( success_flag, true );
-    push_to_port_using_trait( optical_to_thermal_homog, optical_to_thermal );
+  auto itk_thermal_image =
+    vital_to_itk< viame::itk::ThermalImageType >( thermal.image->get_image() );
 
-    if( count_output_port_edges_using_trait( thermal_to_optical_homog ) > 0 )
+  const auto optical_size = itk_optical_image->GetLargestPossibleRegion().GetSize();
+  const auto thermal_size = itk_thermal_image->GetLargestPossibleRegion().GetSize();
+
+  bool success = false;
+
+  // Snapshot of the state shared by concurrent registrations
+  const std::string cache_key = d->cache_key( optical_dom ? optical.ts : thermal.ts );
+  bool has_cached = false;
+  kwiver::vital::matrix_3x3d cached;
+  AffineTransformType::Pointer previous_transform;
+  double reference_metric = 0.0;
+
+  {
+    std::lock_guard< std::mutex > lock( d->m_mutex );
+
+    const auto entry = d->m_cache.find( std::make_pair( d->m_camera_pair, cache_key ) );
+
+    if( d->m_use_cache && entry != d->m_cache.end() )
     {
-      push_to_port_using_trait( thermal_to_optical_homog,
-        std::static_pointer_cast< kwiver::vital::homography >(
-          optical_to_thermal->inverse() ) );
+      has_cached = true;
+      cached = entry->second;
     }
 
-    // Warp image if required
-    if( count_output_port_edges_using_trait( warped_thermal_image ) > 0 )
+    if( d->m_warm_start &&
+        optical_size == d->m_optical_size && thermal_size == d->m_thermal_size )
     {
-      WarpedThermalImageType::Pointer warped_image;
-
-      if( WarpThermalToOpticalImage(
-        *itk_optical_image, *itk_thermal_image, *output_transform, warped_image ) )
-      {
-        push_to_port_using_trait( warped_thermal_image,
-          kwiver::vital::image_container_sptr(
-            new kwiver::arrows::ocv::image_container(
-            ::itk::OpenCVImageBridge::ITKImageToCVMat<
-              viame::itk::WarpedThermalImageType >( warped_image ),
-            kwiver::arrows::ocv::image_container::BGR_COLOR ) ) );
-      }
-      else
-      {
-        push_to_port_using_trait( warped_thermal_image,
-          kwiver::vital::image_container_sptr() );
-      }
+      previous_transform = d->m_previous_transform;
+      reference_metric = d->m_reference_metric;
     }
+  }
 
-    if( count_output_port_edges_using_trait( warped_optical_image ) > 0 )
+  // Reuse the cached transform of this rig and time bucket if it still fits
+  if( has_cached &&
+      validation_score( vital_to_ocv( optical.image->get_image() ),
+                        vital_to_ocv( thermal.image->get_image() ),
+                        cached, d->m_validation_width )
+        >= d->m_validation_threshold )
+  {
+    net_output = cached;
+    output_transform = homography_to_transform( net_output );
+    success = true;
+    method = "cached";
+  }
+
+  if( !success && previous_transform )
+  {
+    AffineTransformType::Pointer transform = previous_transform;
+    double metric = 0.0;
+
+    // JHCT values are minimized, accept results no worse than the reference
+    success = PerformRegistration( *itk_optical_image, *itk_thermal_image,
+      output_transform, transform, metric, 10.0, 1.0, d->m_warm_start_iterations,
+      2.0, 3.0, 1, d->m_refinement_iterations, d->m_grid_spacing, d->m_point_budget,
+      &stats ) &&
+      metric <= reference_metric +
+        d->m_warm_start_tolerance * std::abs( reference_metric );
+
+    if( success )
     {
-      WarpedOpticalImageType::Pointer warped_image;
+      method = "warm";
+      net_output = transform_to_homography( *output_transform );
 
-      if( WarpOpticalToThermalImage(
-        *itk_optical_image, *itk_thermal_image, *output_transform, warped_image ) )
-      {
-        push_to_port_using_trait( warped_optical_image,
-          kwiver::vital::image_container_sptr(
-            new kwiver::arrows::ocv::image_container(
-            ::itk::OpenCVImageBridge::ITKImageToCVMat<
-              viame::itk::WarpedOpticalImageType >( warped_image ),
-            kwiver::arrows::ocv::image_container::BGR_COLOR ) ) );
-      }
-      else
-      {
-        push_to_port_using_trait( warped_optical_image,
-          kwiver::vital::image_container_sptr() );
-      }
+      std::lock_guard< std::mutex > lock( d->m_mutex );
+      d->m_previous_transform = transform;
+      d->store( cache_key, net_output );
     }
   }
-  else
+
+  if( !success )
   {
-    if( optical_dom )
+    AffineTransformType::Pointer transform;
+    double metric = 0.0;
+
+    success = PerformRegistration( *itk_optical_image, *itk_thermal_image,
+      output_transform, transform, metric, 10.0, 1.0, d->m_full_iterations, 2.0, 3.0,
+      d->m_pyramid_levels, d->m_refinement_iterations, d->m_grid_spacing,
+      d->m_point_budget, &stats );
+
+    std::lock_guard< std::mutex > lock( d->m_mutex );
+
+    if( success )
     {
-      output_no_match( optical, 0 );
+      d->m_previous_transform = transform;
+      d->m_reference_metric = metric;
+      d->m_optical_size = optical_size;
+      d->m_thermal_size = thermal_size;
+
+      net_output = transform_to_homography( *output_transform );
+      d->store( cache_key, net_output );
     }
     else
     {
-      output_no_match( thermal, 1 );
+      d->m_previous_transform = nullptr;
+    }
+  }
+
+  // Telemetry of the registration, warm start and full attempts accumulated
+  const bool telemetry = d->m_stats_log.is_open() ||
+    count_output_port_edges_using_trait( registration_stats ) > 0;
+
+  std::string statistics;
+
+  if( telemetry )
+  {
+    const double total_time = std::chrono::duration< double >(
+      std::chrono::steady_clock::now() - start_time ).count();
+
+    statistics = format_statistics( optical_dom ? optical.ts : thermal.ts,
+      optical.name, thermal.name, method, success, stats, total_time );
+
+    std::lock_guard< std::mutex > lock( d->m_mutex );
+
+    if( d->m_stats_log.is_open() )
+    {
+      d->m_stats_log << statistics << '\n';
     }
   }
+
+  if( !success )
+  {
+    registration_result result =
+      no_match( optical_dom ? optical : thermal, optical_dom ? 0 : 1 );
+    result.statistics = statistics;
+    return result;
+  }
+
+  registration_result result;
+
+  result.optical = optical;
+  result.thermal = thermal;
+  result.ts = ( optical_dom ? optical.ts : thermal.ts );
+  result.statistics = statistics;
+  result.success = true;
+
+  // Convert matrix to kwiver
+  kwiver::vital::homography_sptr optical_to_thermal(
+    new kwiver::vital::homography_< double >( net_output ) );
+
+  // Output required elements depending on connections
+  result.optical_to_thermal = optical_to_thermal;
+
+  if( count_output_port_edges_using_trait( thermal_to_optical_homog ) > 0 )
+  {
+    result.thermal_to_optical =
+      std::static_pointer_cast< kwiver::vital::homography >(
+        optical_to_thermal->inverse() );
+  }
+
+  // Warp images if required, only once a downstream process reads their pixels.
+  // The input containers are kept alive since the ITK images may share their
+  // buffers.
+  const kwiver::vital::image_container_sptr optical_image = optical.image;
+  const kwiver::vital::image_container_sptr thermal_image = thermal.image;
+
+  if( count_output_port_edges_using_trait( warped_thermal_image ) > 0 )
+  {
+    result.warped_thermal = std::make_shared< viame::lazy_image_container >(
+      [itk_optical_image, itk_thermal_image, output_transform,
+       optical_image, thermal_image]() -> kwiver::vital::image_container_sptr
+      {
+        WarpedThermalImageType::Pointer warped_image;
+
+        if( !WarpThermalToOpticalImage(
+          *itk_optical_image, *itk_thermal_image, *output_transform, warped_image ) )
+        {
+          return nullptr;
+        }
+
+        return kwiver::vital::image_container_sptr(
+          new kwiver::arrows::ocv::image_container(
+          ::itk::OpenCVImageBridge::ITKImageToCVMat<
+            viame::itk::WarpedThermalImageType >( warped_image ),
+          kwiver::arrows::ocv::image_container::BGR_COLOR ) );
+      },
+      optical_size[0], optical_size[1], 1 );
+  }
+
+  if( count_output_port_edges_using_trait( warped_optical_image ) > 0 )
+  {
+    result.warped_optical = std::make_shared< viame::lazy_image_container >(
+      [itk_optical_image, itk_thermal_image, output_transform,
+       optical_image, thermal_image]() -> kwiver::vital::image_container_sptr
+      {
+        WarpedOpticalImageType::Pointer warped_image;
+
+        if( !WarpOpticalToThermalImage(
+          *itk_optical_image, *itk_thermal_image, *output_transform, warped_image ) )
+        {
+          return nullptr;
+        }
+
+        return kwiver::vital::image_container_sptr(
+          new kwiver::arrows::ocv::image_container(
+          ::itk::OpenCVImageBridge::ITKImageToCVMat<
+            viame::itk::WarpedOpticalImageType >( warped_image ),
+          kwiver::arrows::ocv::image_container::BGR_COLOR ) );
+      },
+      thermal_size[0], thermal_size[1], 1 );
+  }
+
+  return result;
 }
 
 } // end namespace itk
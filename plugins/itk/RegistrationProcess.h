@@ -62,9 +62,17 @@ public:
   virtual ~itk_eo_ir_registration_process();
 
 protected:
-  virtual void attempt_registration( const buffered_frame& frame1,
-                                     const buffered_frame& frame2,
-                                     const bool output_frame1_time );
+  virtual void _configure();
+
+  virtual registration_result register_frames( const buffered_frame& frame1,
+                                               const buffered_frame& frame2,
+                                               const bool output_frame1_time );
+
+private:
+  void make_config();
+
+  class priv;
+  const std::unique_ptr<priv> d;
 
 }; // end class itk_eo_ir_registration_process
 
@@ -4,14 +4,257 @@
 #include "itkImageFileWriter.h"
 #include "itkTransformFileWriter.h"
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 using namespace viame::itk;
 
+namespace
+{
+
+// Registration result of one pair in a batch
+struct BatchResult
+{
+  bool success = false;
+  double homography[3][3];
+};
+
+// Optical to thermal homography of a composite of affine transforms
+bool TransformToHomography( const NetTransformType& transform, double homography[3][3] )
+{
+  double net[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+
+  for( unsigned n = 0; n < transform.GetNumberOfTransforms(); ++n )
+    {
+    const AffineTransformType* affine =
+      dynamic_cast< const AffineTransformType* >( transform.GetNthTransform( n ).GetPointer() );
+
+    if( !affine )
+      {
+      return false;
+      }
+
+    double next[3][3] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 1 } };
+
+    for( unsigned r = 0; r < Dimension; ++r )
+      {
+      for( unsigned c = 0; c < Dimension; ++c )
+        {
+        next[r][c] = affine->GetMatrix()( r, c );
+        }
+      next[r][2] = affine->GetOffset()[r];
+      }
+
+    double product[3][3];
+
+    for( unsigned r = 0; r < 3; ++r )
+      {
+      for( unsigned c = 0; c < 3; ++c )
+        {
+        product[r][c] = net[r][0] * next[0][c] + net[r][1] * next[1][c] + net[r][2] * next[2][c];
+        }
+      }
+
+    std::copy( &product[0][0], &product[0][0] + 9, &net[0][0] );
+    }
+
+  std::copy( &net[0][0], &net[0][0] + 9, &homography[0][0] );
+  return true;
+}
+
+// Register a contiguous range of pairs, each pair starting from the point set
+// transform of the previous one and falling back to a full registration when
+// its final metric value is more than 5% worse than the last full one
+void RegisterRange( const std::vector< std::pair< std::string, std::string > >& pairs,
+                    size_t begin, size_t end, std::vector< BatchResult >& results )
+{
+  using OpticalReaderType = itk::ImageFileReader< OpticalImageType >;
+  using ThermalReaderType = itk::ImageFileReader< ThermalImageType >;
+
+  AffineTransformType::Pointer previousTransform;
+  double referenceMetric = 0.0;
+
+  for( size_t i = begin; i < end; ++i )
+    {
+    OpticalReaderType::Pointer opticalReader = OpticalReaderType::New();
+    ThermalReaderType::Pointer thermalReader = ThermalReaderType::New();
+
+    thermalReader->SetFileName( pairs[i].first );
+    opticalReader->SetFileName( pairs[i].second );
+
+    try
+      {
+      thermalReader->Update();
+      opticalReader->Update();
+      }
+    catch( itk::ExceptionObject& error )
+      {
+      std::cerr << "Error when reading: " << error << std::endl;
+      continue;
+      }
+
+    NetTransformType::Pointer transformation;
+    bool success = false;
+
+    if( previousTransform )
+      {
+      AffineTransformType::Pointer transform = previousTransform;
+      double metric = 0.0;
+
+      success = PerformRegistration( *opticalReader->GetOutput(), *thermalReader->GetOutput(),
+        transformation, transform, metric, 10.0, 1.0, 20 ) &&
+        metric <= referenceMetric + 0.05 * std::abs( referenceMetric );
+
+      if( success )
+        {
+        previousTransform = transform;
+        }
+      }
+
+    if( !success )
+      {
+      AffineTransformType::Pointer transform;
+      double metric = 0.0;
+
+      success = PerformRegistration( *opticalReader->GetOutput(), *thermalReader->GetOutput(),
+        transformation, transform, metric );
+
+      previousTransform = ( success ? transform : nullptr );
+      referenceMetric = metric;
+      }
+
+    results[i].success = success &&
+      TransformToHomography( *transformation, results[i].homography );
+    }
+}
+
+// Register every pair of a list, in parallel, into a homography list
+int RegisterBatch( const char* pairListFile, const char* outputListFile,
+                   unsigned numberOfThreads )
+{
+  std::ifstream pairList( pairListFile );
+
+  if( !pairList )
+    {
+    std::cerr << "Unable to open " << pairListFile << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::vector< std::pair< std::string, std::string > > pairs;
+  std::string line;
+
+  while( std::getline( pairList, line ) )
+    {
+    std::istringstream tokens( line );
+    std::string thermal, optical;
+
+    if( line.empty() || line[0] == '#' || !( tokens >> thermal >> optical ) )
+      {
+      continue;
+      }
+
+    pairs.emplace_back( thermal, optical );
+    }
+
+  if( numberOfThreads == 0 )
+    {
+    numberOfThreads = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+
+  numberOfThreads = static_cast< unsigned >(
+    std::max< size_t >( 1, std::min< size_t >( numberOfThreads, pairs.size() ) ) );
+
+  // Share the cores between the workers instead of oversubscribing them
+  SetRegistrationThreadCount(
+    std::max( 1u, std::thread::hardware_concurrency() / numberOfThreads ) );
+
+  // Consecutive pairs go to the same worker, so warm starts see similar frames
+  std::vector< BatchResult > results( pairs.size() );
+  std::vector< std::thread > workers;
+
+  for( unsigned w = 0; w < numberOfThreads; ++w )
+    {
+    workers.emplace_back( RegisterRange, std::cref( pairs ),
+      pairs.size() * w / numberOfThreads, pairs.size() * ( w + 1 ) / numberOfThreads,
+      std::ref( results ) );
+    }
+
+  for( auto& worker : workers )
+    {
+    worker.join();
+    }
+
+  // Same format as write_homography_list_process, optical then thermal names
+  std::ofstream output( outputListFile );
+
+  if( !output )
+    {
+    std::cerr << "Unable to open " << outputListFile << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  output << std::setprecision( 17 );
+  size_t failures = 0;
+
+  for( size_t i = 0; i < pairs.size(); ++i )
+    {
+    output << pairs[i].second << '\n' << pairs[i].first << '\n';
+
+    if( results[i].success )
+      {
+      for( unsigned r = 0; r < 3; ++r )
+        {
+        output << results[i].homography[r][0] << " "
+               << results[i].homography[r][1] << " "
+               << results[i].homography[r][2] << '\n';
+        }
+      }
+    else
+      {
+      output << "[no-match]" << '\n';
+      ++failures;
+      }
+
+    output << '\n';
+    }
+
+  std::cout << "Registered " << pairs.size() - failures << " of "
+            << pairs.size() << " pairs" << std::endl;
+
+  return ( output ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
+} // end anonymous namespace
+
 int main( int argc, char * argv[] )
 {
+  if( argc > 1 && std::string( argv[1] ) == "--batch" )
+    {
+    if( argc < 4 )
+      {
+      std::cerr << "Usage: " << argv[0] << " --batch <PairList> <OutputHomographyList> "
+                << "[NumberOfThreads]" << std::endl;
+      std::cerr << "Each line of the pair list holds a thermal and an optical "
+                << "image path" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    return RegisterBatch( argv[2], argv[3], argc > 4 ? std::stoi( argv[4] ) : 0 );
+    }
+
   if( argc < 4 )
     {
     std::cerr << "Usage: " << argv[0] << " <InputThermalImage> <InputOpticalImage> "
               << "<OutputTransformFile> <OutputTransformedThermalImage>" << std::endl;
+    std::cerr << "       " << argv[0] << " --batch <PairList> <OutputHomographyList> "
+              << "[NumberOfThreads]" << std::endl;
     std::cerr << "Example: ./0/CHESS_FL12_C_160421_215351.941_THERM-16BIT.PNG "
               << "./0/CHESS_FL12_C_160421_215351.941_COLOR-8-BIT.JPG "
               << "./0/thermal_to_optical.h5 ./0/thermal_registered.png" << std::endl;
@@ -42,9 +42,12 @@
 
 #include <vital/types/detected_object_set.h>
 
+#include <itkMatrixOffsetTransformBase.h>
 #include <itkTransformFileReader.h>
 
+#include <algorithm>
 #include <exception>
+#include <vector>
 
 
 namespace viame
@@ -55,6 +58,9 @@ namespace itk
 
 create_config_trait( transformation_file, kwiver::vital::path_t, "",
   "Filename for the file containing an ITK composite transformation" );
+create_config_trait( clone_detections, bool, "false",
+  "Deep copy the input detections. Otherwise only the boxes are replaced and "
+  "the other detection attributes are shared with the input." );
 
 //------------------------------------------------------------------------------
 // Private implementation class
@@ -64,11 +70,115 @@ public:
   priv();
   ~priv();
 
+  // Collapse the transform to a homography if all its parts are linear
+  void compute_homography();
+
+  // Warp points in place, given as separate x and y arrays
+  void warp_corners( std::vector< double >& x, std::vector< double >& y ) const;
+
   // Configuration values
   kwiver::vital::path_t m_transformation_file;
+  bool m_clone_detections;
   NetTransformType::Pointer m_transformation;
+
+  // Homography equivalent to the transformation, if it is linear
+  bool m_is_linear;
+  double m_homography[3][3];
 };
 
+
+// -----------------------------------------------------------------------------
+void
+itk_warp_detections_process::priv
+::compute_homography()
+{
+  using LinearTransformType =
+    ::itk::MatrixOffsetTransformBase< TransformFloatType, Dimension, Dimension >;
+
+  double net[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+
+  m_is_linear = false;
+
+  for( unsigned n = 0; n < m_transformation->GetNumberOfTransforms(); ++n )
+  {
+    const LinearTransformType* linear = dynamic_cast< const LinearTransformType* >(
+      m_transformation->GetNthTransform( n ).GetPointer() );
+
+    if( !linear )
+    {
+      return;
+    }
+
+    double next[3][3] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 1 } };
+
+    for( unsigned r = 0; r < Dimension; ++r )
+    {
+      for( unsigned c = 0; c < Dimension; ++c )
+      {
+        next[r][c] = linear->GetMatrix()( r, c );
+      }
+      next[r][2] = linear->GetOffset()[r];
+    }
+
+    // The last transform added is applied first, as in net * next
+    double product[3][3];
+
+    for( unsigned r = 0; r < 3; ++r )
+    {
+      for( unsigned c = 0; c < 3; ++c )
+      {
+        product[r][c] = net[r][0] * next[0][c] + net[r][1] * next[1][c] + net[r][2] * next[2][c];
+      }
+    }
+
+    std::copy( &product[0][0], &product[0][0] + 9, &net[0][0] );
+  }
+
+  std::copy( &net[0][0], &net[0][0] + 9, &m_homography[0][0] );
+  m_is_linear = true;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+itk_warp_detections_process::priv
+::warp_corners( std::vector< double >& x, std::vector< double >& y ) const
+{
+  const size_t count = x.size();
+
+  double* px = x.data();
+  double* py = y.data();
+
+  if( !m_is_linear )
+  {
+    for( size_t i = 0; i < count; ++i )
+    {
+      TransformFloatType point[2] = { px[i], py[i] };
+
+      NetTransformType::OutputPointType warped =
+        m_transformation->TransformPoint( NetTransformType::InputPointType( point ) );
+
+      px[i] = warped[0];
+      py[i] = warped[1];
+    }
+    return;
+  }
+
+  const double h00 = m_homography[0][0], h01 = m_homography[0][1], h02 = m_homography[0][2];
+  const double h10 = m_homography[1][0], h11 = m_homography[1][1], h12 = m_homography[1][2];
+  const double h20 = m_homography[2][0], h21 = m_homography[2][1], h22 = m_homography[2][2];
+
+  // Independent iterations over contiguous arrays, vectorized by the compiler
+  for( size_t i = 0; i < count; ++i )
+  {
+    const double u = px[i], v = py[i];
+    const double w = 1.0 / ( h20 * u + h21 * v + h22 );
+
+    px[i] = ( h00 * u + h01 * v + h02 ) * w;
+    py[i] = ( h10 * u + h11 * v + h12 ) * w;
+  }
+}
+
 // =============================================================================
 
 itk_warp_detections_process
@@ -107,6 +217,10 @@ itk_warp_detections_process
 
   d->m_transformation = static_cast< NetTransformType* >(
     reader->GetTransformList()->begin()->GetPointer() );
+
+  d->m_clone_detections = config_value_using_trait( clone_detections );
+
+  d->compute_homography();
 }
 
 
@@ -124,42 +238,43 @@ itk_warp_detections_process
   {
     if( input )
     {
-      output = input->clone();
+      std::vector< kwiver::vital::detected_object_sptr > detections;
+      detections.reserve( input->size() );
+
+      for( auto detection : *input )
+      {
+        detections.push_back( d->m_clone_detections ? detection->clone() :
+          std::make_shared< kwiver::vital::detected_object >( *detection ) );
+      }
 
-      for( auto detection : *output )
+      // Corners of all boxes, four consecutive ones per detection
+      std::vector< double > x( 4 * detections.size() );
+      std::vector< double > y( 4 * detections.size() );
+
+      for( size_t i = 0; i < detections.size(); ++i )
+      {
+        const kwiver::vital::bounding_box_d box = detections[i]->bounding_box();
+
+        x[4*i+0] = box.min_x(); y[4*i+0] = box.min_y();
+        x[4*i+1] = box.max_x(); y[4*i+1] = box.min_y();
+        x[4*i+2] = box.max_x(); y[4*i+2] = box.max_y();
+        x[4*i+3] = box.min_x(); y[4*i+3] = box.max_y();
+      }
+
+      d->warp_corners( x, y );
+
+      for( size_t i = 0; i < detections.size(); ++i )
       {
-        // Adjust detection box
-        TransformFloatType lower_left[2] = {
-          detection->bounding_box().min_x(), detection->bounding_box().min_y() };
-        TransformFloatType lower_right[2] = {
-          detection->bounding_box().max_x(), detection->bounding_box().min_y() };
-        TransformFloatType upper_right[2] = {
-          detection->bounding_box().max_x(), detection->bounding_box().max_y() };
-        TransformFloatType upper_left[2] = {
-          detection->bounding_box().min_x(), detection->bounding_box().max_y() };
-
-        NetTransformType::OutputPointType pt1 =
-          d->m_transformation->TransformPoint(
-            NetTransformType::InputPointType( lower_left ) );
-        NetTransformType::OutputPointType pt2 =
-          d->m_transformation->TransformPoint(
-            NetTransformType::InputPointType( lower_right ) );
-        NetTransformType::OutputPointType pt3 =
-          d->m_transformation->TransformPoint(
-            NetTransformType::InputPointType( upper_right ) );
-        NetTransformType::OutputPointType pt4 =
-          d->m_transformation->TransformPoint(
-            NetTransformType::InputPointType( upper_left ) );
-
-        lower_left[0] = std::min( { pt1[0], pt2[0], pt3[0], pt4[0] } );
-        lower_left[1] = std::min( { pt1[1], pt2[1], pt3[1], pt4[1] } );
-        upper_right[0] = std::max( { pt1[0], pt2[0], pt3[0], pt4[0] } );
-        upper_right[1] = std::max( { pt1[1], pt2[1], pt3[1], pt4[1] } );
-
-        detection->set_bounding_box(
+        const double* cx = &x[4*i];
+        const double* cy = &y[4*i];
+
+        detections[i]->set_bounding_box(
           kwiver::vital::bounding_box_d(
-            lower_left[0], lower_left[1], upper_right[0], upper_right[1] ) );
+            *std::min_element( cx, cx + 4 ), *std::min_element( cy, cy + 4 ),
+            *std::max_element( cx, cx + 4 ), *std::max_element( cy, cy + 4 ) ) );
       }
+
+      output = std::make_shared< kwiver::vital::detected_object_set >( detections );
     }
   }
   catch( ... )
@@ -196,6 +311,7 @@ itk_warp_detections_process
 ::make_config()
 {
   declare_config_using_trait( transformation_file );
+  declare_config_using_trait( clone_detections );
 }
 
 
@@ -203,6 +319,8 @@ itk_warp_detections_process
 itk_warp_detections_process::priv
 ::priv()
   : m_transformation_file( "" )
+  , m_clone_detections( false )
+  , m_is_linear( false )
 {
 }
 
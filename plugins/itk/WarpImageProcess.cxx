@@ -47,6 +47,9 @@
 #include <itkOpenCVImageBridge.h>
 #include <itkTransformFileReader.h>
 
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
 #include <exception>
 
 
@@ -59,6 +62,11 @@ namespace itk
 create_config_trait( transformation_file, kwiver::vital::path_t, "",
   "Filename for the file containing an ITK composite transformation" );
 
+create_config_trait( precompute_remap, bool, "false",
+  "Build a remap table of the transformation on the first frame, for the "
+  "output size, and warp every frame with it instead of resampling the "
+  "transformation for every pixel. The table is rebuilt if the sizes change." );
+
 create_port_trait( size_image, image, "Image to get output size from." );
 
 //------------------------------------------------------------------------------
@@ -69,11 +77,55 @@ public:
   priv();
   ~priv();
 
+  // Build the remap table for the given output size
+  void build_remap( const cv::Size& output_size );
+
   // Configuration values
   kwiver::vital::path_t m_transformation_file;
+  bool m_precompute_remap;
   NetTransformType::Pointer m_transformation;
+
+  // Input coordinates of each output pixel, in the fixed point OpenCV format
+  cv::Size m_remap_size;
+  cv::Mat m_remap_xy;
+  cv::Mat m_remap_weights;
 };
 
+
+// -----------------------------------------------------------------------------
+void
+itk_warp_image_process::priv
+::build_remap( const cv::Size& output_size )
+{
+  cv::Mat map_x( output_size, CV_32FC1 );
+  cv::Mat map_y( output_size, CV_32FC1 );
+
+  // The resampler maps each output pixel to its input location
+  cv::parallel_for_( cv::Range( 0, output_size.height ), [&]( const cv::Range& range )
+  {
+    for( int j = range.start; j < range.end; ++j )
+    {
+      float* row_x = map_x.ptr< float >( j );
+      float* row_y = map_y.ptr< float >( j );
+
+      for( int i = 0; i < output_size.width; ++i )
+      {
+        TransformFloatType point[2] = { static_cast< TransformFloatType >( i ),
+                                        static_cast< TransformFloatType >( j ) };
+
+        NetTransformType::OutputPointType input =
+          m_transformation->TransformPoint( NetTransformType::InputPointType( point ) );
+
+        row_x[i] = static_cast< float >( input[0] );
+        row_y[i] = static_cast< float >( input[1] );
+      }
+    }
+  } );
+
+  cv::convertMaps( map_x, map_y, m_remap_xy, m_remap_weights, CV_16SC2 );
+  m_remap_size = output_size;
+}
+
 // =============================================================================
 
 itk_warp_image_process
@@ -112,6 +164,9 @@ itk_warp_image_process
 
   d->m_transformation = static_cast< NetTransformType* >(
     reader->GetTransformList()->begin()->GetPointer() );
+
+  d->m_precompute_remap = config_value_using_trait( precompute_remap );
+  d->m_remap_size = cv::Size();
 }
 
 
@@ -140,6 +195,47 @@ itk_warp_image_process
     output_size[1] = image->height();
   }
 
+  if( d->m_precompute_remap )
+  {
+    const cv::Size size( static_cast< int >( output_size[0] ),
+                         static_cast< int >( output_size[1] ) );
+
+    if( size != d->m_remap_size )
+    {
+      d->build_remap( size );
+    }
+
+    // Same single channel 16-bit output as the ITK resampler
+    cv::Mat input =
+      kwiver::arrows::ocv::image_container::vital_to_ocv(
+        image->get_image(),
+        kwiver::arrows::ocv::image_container::BGR_COLOR );
+
+    if( input.channels() == 3 )
+    {
+      cv::cvtColor( input, input, cv::COLOR_BGR2GRAY );
+    }
+    else if( input.channels() == 4 )
+    {
+      cv::cvtColor( input, input, cv::COLOR_BGRA2GRAY );
+    }
+
+    if( input.depth() != CV_16U )
+    {
+      input.convertTo( input, CV_16U );
+    }
+
+    cv::Mat output;
+    cv::remap( input, output, d->m_remap_xy, d->m_remap_weights,
+               cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar( 0 ) );
+
+    push_to_port_using_trait( image,
+      kwiver::vital::image_container_sptr(
+        new kwiver::arrows::ocv::image_container( output,
+          kwiver::arrows::ocv::image_container::BGR_COLOR ) ) );
+    return;
+  }
+
   auto itk_input_image =
     ::itk::OpenCVImageBridge::CVMatToITKImage< viame::itk::ThermalImageType >(
       kwiver::arrows::ocv::image_container::vital_to_ocv(
@@ -190,6 +286,7 @@ itk_warp_image_process
 ::make_config()
 {
   declare_config_using_trait( transformation_file );
+  declare_config_using_trait( precompute_remap );
 }
 
 
@@ -197,6 +294,7 @@ itk_warp_image_process
 itk_warp_image_process::priv
 ::priv()
   : m_transformation_file( "" )
+  , m_precompute_remap( false )
 {
 }
 
@@ -0,0 +1,614 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Image object detector running MATLAB detectors in persistent engines
+ */
+
+#include "matlab_engine_detector.h"
+
+#include <vital/exceptions.h>
+#include <vital/types/detected_object_set.h>
+#include <vital/types/image.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <engine.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#ifndef VIAME_MATLAB_BRIDGE_DIR
+#define VIAME_MATLAB_BRIDGE_DIR ""
+#endif
+
+namespace kv = kwiver::vital;
+namespace bip = boost::interprocess;
+
+namespace viame {
+
+namespace {
+
+// -----------------------------------------------------------------------------
+// One engine per worker thread, started on first use and closed at exit. The
+// engine C API is not thread safe, so an engine is only used by its thread.
+class engine_registry
+{
+public:
+  static engine_registry& instance()
+  {
+    static engine_registry registry;
+    return registry;
+  }
+
+  Engine* engine_for_this_thread( std::string const& start_command )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    Engine*& engine = m_engines[ std::this_thread::get_id() ];
+
+    if( !engine )
+    {
+      engine = engOpen( start_command.empty() ? nullptr : start_command.c_str() );
+
+      if( !engine )
+      {
+        m_engines.erase( std::this_thread::get_id() );
+        VITAL_THROW( kv::invalid_data, "Unable to start the MATLAB engine" );
+      }
+      engSetVisible( engine, false );
+    }
+    return engine;
+  }
+
+  ~engine_registry()
+  {
+    for( auto& entry : m_engines )
+    {
+      engClose( entry.second );
+    }
+  }
+
+private:
+  std::mutex m_mutex;
+  std::map< std::thread::id, Engine* > m_engines;
+};
+
+// -----------------------------------------------------------------------------
+// Quote a string as a MATLAB char literal
+std::string
+quoted( std::string const& value )
+{
+  std::string output = "'";
+  for( char c : value )
+  {
+    output += c;
+    if( c == '\'' )
+    {
+      output += '\'';
+    }
+  }
+  return output + "'";
+}
+
+// -----------------------------------------------------------------------------
+// Copy an 8 bit image in MATLAB column-major height x width x depth order
+void
+write_column_major( kv::image const& image, uint8_t* output )
+{
+  const uint8_t* first = static_cast< const uint8_t* >( image.first_pixel() );
+
+  for( size_t c = 0; c < image.depth(); ++c )
+  {
+    for( size_t x = 0; x < image.width(); ++x )
+    {
+      const uint8_t* column = first + c * image.d_step() + x * image.w_step();
+
+      for( size_t y = 0; y < image.height(); ++y )
+      {
+        *output++ = column[ y * image.h_step() ];
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// File mapped in this process and by memmapfile in MATLAB, grown as needed
+class shared_frame_file
+{
+public:
+  explicit shared_frame_file( std::string const& path )
+    : m_path( path )
+  {}
+
+  ~shared_frame_file()
+  {
+    m_region.reset();
+    m_mapping.reset();
+    std::remove( m_path.c_str() );
+  }
+
+  uint8_t* reserve( size_t size )
+  {
+    if( size > m_capacity )
+    {
+      m_region.reset();
+      m_mapping.reset();
+
+      // Doubling keeps resizes rare when frame sizes vary
+      const size_t capacity = std::max( size, 2 * m_capacity );
+      {
+        std::filebuf file;
+        if( !file.open( m_path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc ) ||
+            file.pubseekoff( capacity - 1, std::ios::beg ) < 0 || file.sputc( 0 ) == EOF )
+        {
+          VITAL_THROW( kv::file_write_exception, m_path, "Unable to create the shared frame file" );
+        }
+      }
+
+      m_mapping.reset( new bip::file_mapping( m_path.c_str(), bip::read_write ) );
+      m_region.reset( new bip::mapped_region( *m_mapping, bip::read_write, 0, capacity ) );
+      m_capacity = capacity;
+    }
+    return static_cast< uint8_t* >( m_region->get_address() );
+  }
+
+  std::string const& path() const { return m_path; }
+
+private:
+  std::string m_path;
+  size_t m_capacity = 0;
+  std::unique_ptr< bip::file_mapping > m_mapping;
+  std::unique_ptr< bip::mapped_region > m_region;
+};
+
+// -----------------------------------------------------------------------------
+// Memory backed /dev/shm when available, else the temporary directory
+std::string
+temporary_directory()
+{
+  if( kwiversys::SystemTools::FileIsDirectory( "/dev/shm" ) )
+  {
+    return "/dev/shm";
+  }
+  for( const char* variable : { "TMPDIR", "TEMP", "TMP" } )
+  {
+    if( const char* value = kwiversys::SystemTools::GetEnv( variable ) )
+    {
+      return value;
+    }
+  }
+  return ".";
+}
+
+} // end anonymous namespace
+
+// =============================================================================
+class matlab_engine_detector::priv
+{
+public:
+  std::string m_program_file;
+  std::string m_bridge_directory = VIAME_MATLAB_BRIDGE_DIR;
+  std::string m_start_command;
+  std::string m_shared_memory_directory;
+  bool m_use_shared_memory = true;
+  unsigned m_max_batch_size = 8;
+
+  // Program config values, assigned as MATLAB globals
+  std::vector< std::pair< std::string, std::string > > m_program_config;
+
+  // Engines on which the program was initialized
+  std::mutex m_mutex;
+  std::set< Engine* > m_initialized;
+
+  std::unique_ptr< shared_frame_file > m_frames;
+
+  kv::logger_handle_t m_logger;
+
+  Engine* engine();
+
+  // Evaluate in the base workspace, raising MATLAB errors as exceptions
+  void eval( Engine* engine, std::string const& command ) const;
+
+  kv::detected_object_set_sptr read_result( const mxArray* result ) const;
+};
+
+
+// -----------------------------------------------------------------------------
+void
+matlab_engine_detector::priv
+::eval( Engine* engine, std::string const& command ) const
+{
+  const std::string wrapped =
+    "try, " + command + "; viame_error = ''; "
+    "catch viame_exception, viame_error = getReport( viame_exception, 'basic' ); end";
+
+  if( engEvalString( engine, wrapped.c_str() ) != 0 )
+  {
+    VITAL_THROW( kv::invalid_data, "The MATLAB engine is no longer running" );
+  }
+
+  mxArray* error = engGetVariable( engine, "viame_error" );
+  char* message = error ? mxArrayToString( error ) : nullptr;
+  const std::string text = message ? message : "";
+
+  mxFree( message );
+  if( error )
+  {
+    mxDestroyArray( error );
+  }
+
+  if( !text.empty() )
+  {
+    VITAL_THROW( kv::invalid_data, "MATLAB error: " + text );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+Engine*
+matlab_engine_detector::priv
+::engine()
+{
+  Engine* engine = engine_registry::instance().engine_for_this_thread( m_start_command );
+
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  if( m_initialized.count( engine ) )
+  {
+    return engine;
+  }
+
+  // Same sequence as the MATLAB detector template: program, config, initialize
+  std::string program_dir = kwiversys::SystemTools::GetFilenamePath(
+    kwiversys::SystemTools::CollapseFullPath( m_program_file ) );
+
+  if( !m_bridge_directory.empty() )
+  {
+    eval( engine, "addpath( " + quoted( m_bridge_directory ) + " )" );
+  }
+  eval( engine, "addpath( " + quoted( program_dir ) + " ); run( " + quoted( m_program_file ) + " )" );
+
+  for( auto const& value : m_program_config )
+  {
+    eval( engine, "global " + value.first + "; " + value.first + " = " + value.second );
+  }
+  eval( engine, "detector_initialize()" );
+
+  m_initialized.insert( engine );
+  return engine;
+}
+
+
+// -----------------------------------------------------------------------------
+kv::detected_object_set_sptr
+matlab_engine_detector::priv
+::read_result( const mxArray* result ) const
+{
+  auto output = std::make_shared< kv::detected_object_set >();
+
+  const mxArray* boxes = result ? mxGetField( result, 0, "boxes" ) : nullptr;
+
+  if( !boxes || mxIsEmpty( boxes ) )
+  {
+    return output;
+  }
+  if( !mxIsDouble( boxes ) || mxGetN( boxes ) < 4 )
+  {
+    VITAL_THROW( kv::invalid_data, "detected_object_set must be a N x 5 double matrix" );
+  }
+
+  // Rows of [ ul_x ul_y lr_x lr_y confidence ], column-major
+  const size_t count = mxGetM( boxes );
+  const double* values = mxGetPr( boxes );
+  const bool has_confidence = mxGetN( boxes ) >= 5;
+
+  std::vector< kv::detected_object_type_sptr > types( count );
+
+  const mxArray* rows = mxGetField( result, 0, "class_rows" );
+  const mxArray* names = mxGetField( result, 0, "class_names" );
+  const mxArray* scores = mxGetField( result, 0, "class_scores" );
+
+  if( rows && names && scores && !mxIsEmpty( rows ) )
+  {
+    const double* row_values = mxGetPr( rows );
+    const double* score_values = mxGetPr( scores );
+
+    for( size_t i = 0; i < mxGetNumberOfElements( rows ); ++i )
+    {
+      const size_t row = static_cast< size_t >( row_values[ i ] ) - 1;
+      char* name = mxArrayToString( mxGetCell( names, i ) );
+
+      if( row < count && name )
+      {
+        if( !types[ row ] )
+        {
+          types[ row ] = std::make_shared< kv::detected_object_type >();
+        }
+        types[ row ]->set_score( name, score_values[ i ] );
+      }
+      mxFree( name );
+    }
+  }
+
+  for( size_t i = 0; i < count; ++i )
+  {
+    kv::bounding_box_d bbox( values[ i ], values[ i + count ],
+                             values[ i + 2 * count ], values[ i + 3 * count ] );
+    const double confidence = has_confidence ? values[ i + 4 * count ] : 1.0;
+
+    output->add( std::make_shared< kv::detected_object >( bbox, confidence, types[ i ] ) );
+  }
+
+  return output;
+}
+
+
+// =============================================================================
+matlab_engine_detector
+::matlab_engine_detector()
+  : d( new priv() )
+{
+  attach_logger( "viame.matlab.matlab_engine_detector" );
+  d->m_logger = logger();
+}
+
+
+matlab_engine_detector
+::~matlab_engine_detector()
+{}
+
+
+// -----------------------------------------------------------------------------
+kv::config_block_sptr
+matlab_engine_detector
+::get_configuration() const
+{
+  kv::config_block_sptr config = kv::algorithm::get_configuration();
+
+  config->set_value( "program_file", d->m_program_file,
+    "MATLAB detector program, run before detector_initialize is called" );
+  config->set_value( "bridge_directory", d->m_bridge_directory,
+    "Directory of viame_detect_frames.m, added to the MATLAB path" );
+  config->set_value( "start_command", d->m_start_command,
+    "Command starting the MATLAB engines, empty for the default matlab command" );
+  config->set_value( "use_shared_memory", d->m_use_shared_memory,
+    "If true, frames are passed through a memory-mapped file instead of being "
+    "copied to the engine as arrays" );
+  config->set_value( "shared_memory_directory", d->m_shared_memory_directory,
+    "Directory of the memory-mapped frame files. Empty uses /dev/shm when it "
+    "exists, else the temporary directory." );
+  config->set_value( "max_batch_size", d->m_max_batch_size,
+    "Largest number of frames detected per engine call when batching" );
+
+  for( auto const& value : d->m_program_config )
+  {
+    config->set_value( "config:" + value.first, value.second,
+      "Value assigned to this MATLAB global before detector_initialize" );
+  }
+
+  return config;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+matlab_engine_detector
+::set_configuration( kv::config_block_sptr config_in )
+{
+  kv::config_block_sptr config = this->get_configuration();
+  config->merge_config( config_in );
+
+  d->m_program_file = config->get_value< std::string >( "program_file" );
+  d->m_bridge_directory = config->get_value< std::string >( "bridge_directory" );
+  d->m_start_command = config->get_value< std::string >( "start_command" );
+  d->m_use_shared_memory = config->get_value< bool >( "use_shared_memory" );
+  d->m_shared_memory_directory = config->get_value< std::string >( "shared_memory_directory" );
+  d->m_max_batch_size = std::max( config->get_value< unsigned >( "max_batch_size" ), 1u );
+
+  d->m_program_config.clear();
+  kv::config_block_sptr program_config = config->subblock( "config" );
+
+  for( auto const& key : program_config->available_values() )
+  {
+    d->m_program_config.emplace_back( key, program_config->get_value< std::string >( key ) );
+  }
+
+  {
+    std::lock_guard< std::mutex > lock( d->m_mutex );
+    d->m_initialized.clear();
+  }
+
+  d->m_frames.reset();
+
+  if( d->m_use_shared_memory )
+  {
+    std::string directory = d->m_shared_memory_directory;
+
+    if( directory.empty() )
+    {
+      directory = temporary_directory();
+    }
+
+    std::ostringstream path;
+    path << directory << "/viame_matlab_frames_" << std::hex << reinterpret_cast< uintptr_t >( this ) << ".bin";
+    d->m_frames.reset( new shared_frame_file( path.str() ) );
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+matlab_engine_detector
+::check_configuration( kv::config_block_sptr config ) const
+{
+  const std::string program_file = config->get_value< std::string >( "program_file", "" );
+
+  if( program_file.empty() || !kwiversys::SystemTools::FileExists( program_file ) )
+  {
+    LOG_ERROR( logger(), "MATLAB program_file \"" << program_file << "\" not found" );
+    return false;
+  }
+  return true;
+}
+
+
+// -----------------------------------------------------------------------------
+kv::detected_object_set_sptr
+matlab_engine_detector
+::detect( kv::image_container_sptr image_data ) const
+{
+  return detect_batch( { image_data } ).front();
+}
+
+
+// -----------------------------------------------------------------------------
+size_t
+matlab_engine_detector
+::max_batch_size() const
+{
+  return d->m_max_batch_size;
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector< kv::detected_object_set_sptr >
+matlab_engine_detector
+::detect_batch( std::vector< kv::image_container_sptr > const& images ) const
+{
+  std::vector< kv::detected_object_set_sptr > output( images.size() );
+
+  std::vector< size_t > frames;
+  for( size_t i = 0; i < images.size(); ++i )
+  {
+    if( !images[ i ] )
+    {
+      output[ i ] = std::make_shared< kv::detected_object_set >();
+      continue;
+    }
+    if( images[ i ]->get_image().pixel_traits() != kv::image_pixel_traits_of< uint8_t >() )
+    {
+      VITAL_THROW( kv::invalid_data, "The MATLAB detector requires 8 bit images" );
+    }
+    frames.push_back( i );
+  }
+
+  if( frames.empty() )
+  {
+    return output;
+  }
+
+  Engine* engine = d->engine();
+
+  if( d->m_frames )
+  {
+    // Frames one after the other, read back by memmapfile at their offsets
+    std::ostringstream shapes, offsets;
+    size_t total = 0;
+
+    shapes << "[";
+    offsets << "[";
+    for( size_t i : frames )
+    {
+      kv::image const& image = images[ i ]->get_image();
+      shapes << image.height() << " " << image.width() << " " << image.depth() << ";";
+      offsets << total << " ";
+      total += image.width() * image.height() * image.depth();
+    }
+    shapes << "]";
+    offsets << "]";
+
+    uint8_t* data = d->m_frames->reserve( total );
+    for( size_t i : frames )
+    {
+      kv::image const& image = images[ i ]->get_image();
+      write_column_major( image, data );
+      data += image.width() * image.height() * image.depth();
+    }
+
+    d->eval( engine, "viame_results = viame_detect_frames( " + quoted( d->m_frames->path() ) +
+                     ", " + shapes.str() + ", " + offsets.str() + " )" );
+  }
+  else
+  {
+    mxArray* cell = mxCreateCellMatrix( 1, frames.size() );
+
+    for( size_t f = 0; f < frames.size(); ++f )
+    {
+      kv::image const& image = images[ frames[ f ] ]->get_image();
+      const mwSize dims[ 3 ] = { image.height(), image.width(), image.depth() };
+      mxArray* array = mxCreateNumericArray( 3, dims, mxUINT8_CLASS, mxREAL );
+
+      write_column_major( image, static_cast< uint8_t* >( mxGetData( array ) ) );
+      mxSetCell( cell, f, array );
+    }
+
+    const int status = engPutVariable( engine, "viame_frames", cell );
+    mxDestroyArray( cell );
+
+    if( status != 0 )
+    {
+      VITAL_THROW( kv::invalid_data, "Unable to pass the frames to the MATLAB engine" );
+    }
+
+    d->eval( engine, "viame_results = viame_detect_frames( viame_frames ); clear viame_frames" );
+  }
+
+  mxArray* results = engGetVariable( engine, "viame_results" );
+
+  if( !results || !mxIsCell( results ) || mxGetNumberOfElements( results ) != frames.size() )
+  {
+    if( results )
+    {
+      mxDestroyArray( results );
+    }
+    VITAL_THROW( kv::invalid_data, "Unexpected viame_detect_frames results" );
+  }
+
+  for( size_t f = 0; f < frames.size(); ++f )
+  {
+    output[ frames[ f ] ] = d->read_result( mxGetCell( results, f ) );
+  }
+  mxDestroyArray( results );
+
+  return output;
+}
+
+} // end namespace viame
@@ -0,0 +1,99 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Image object detector running MATLAB detectors in persistent engines
+ */
+
+#ifndef VIAME_MATLAB_ENGINE_DETECTOR_H
+#define VIAME_MATLAB_ENGINE_DETECTOR_H
+
+#include <plugins/matlab/viame_matlab_export.h>
+
+#include <plugins/core/batch_image_object_detector.h>
+
+#include <vital/algo/image_object_detector.h>
+
+namespace viame {
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Runs the detect function of a MATLAB detector program
+ *
+ * Follows the protocol of the MATLAB detector template: the program file is
+ * run, the config: values are assigned as globals, detector_initialize is
+ * called, then detect( image ) fills the detected_object_set and
+ * detected_object_classification globals.
+ *
+ * Each worker thread keeps one MATLAB engine for the whole run, shared by the
+ * detectors used on that thread, instead of paying its start per detector.
+ * Frames are written to a memory-mapped file, in /dev/shm when available,
+ * which MATLAB reads with memmapfile instead of receiving serialized arrays,
+ * and a batch of frames is detected per engine call.
+ */
+class VIAME_MATLAB_EXPORT matlab_engine_detector :
+  public kwiver::vital::algorithm_impl<
+    matlab_engine_detector, kwiver::vital::algo::image_object_detector >,
+  public viame::batch_image_object_detector
+{
+public:
+  PLUGIN_INFO( "matlab_engine",
+               "Runs a MATLAB detector in a persistent engine per worker, "
+               "passing frames through shared memory." )
+
+  matlab_engine_detector();
+  virtual ~matlab_engine_detector();
+
+  // Get the current configuration (parameters) for this detector
+  virtual kwiver::vital::config_block_sptr get_configuration() const;
+
+  // Set configurations automatically parsed from input pipeline and config files
+  virtual void set_configuration( kwiver::vital::config_block_sptr config );
+  virtual bool check_configuration( kwiver::vital::config_block_sptr config ) const;
+
+  // Main detection method
+  virtual kwiver::vital::detected_object_set_sptr detect(
+    kwiver::vital::image_container_sptr image_data ) const;
+
+  // Detect in several frames with a single engine call
+  virtual std::vector< kwiver::vital::detected_object_set_sptr > detect_batch(
+    std::vector< kwiver::vital::image_container_sptr > const& images ) const;
+
+  virtual size_t max_batch_size() const;
+
+private:
+  class priv;
+  const std::unique_ptr< priv > d;
+};
+
+} // end namespace viame
+
+#endif // VIAME_MATLAB_ENGINE_DETECTOR_H
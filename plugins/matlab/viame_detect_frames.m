@@ -0,0 +1,88 @@
+% ckwg +29
+% Copyright 2026 by Kitware, Inc.
+% All rights reserved.
+%
+% Redistribution and use in source and binary forms, with or without
+% modification, are permitted provided that the following conditions are met:
+%
+%  * Redistributions of source code must retain the above copyright notice,
+%    this list of conditions and the following disclaimer.
+%
+%  * Redistributions in binary form must reproduce the above copyright notice,
+%    this list of conditions and the following disclaimer in the documentation
+%    and/or other materials provided with the distribution.
+%
+%  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+%    to endorse or promote products derived from this software without specific
+%    prior written permission.
+%
+% THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+% AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+% IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+% ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+% ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+% DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+% SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+% CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+% OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+% OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+function results = viame_detect_frames( frames, shapes, offsets )
+% Run the detect function of the loaded detector on several frames.
+%
+% frames is either a cell array of images, or the path of a file holding the
+% frames one after the other, column-major, at the given byte offsets and with
+% the given [ height width depth ] shapes, one row per frame. The file is read
+% with memmapfile, so frames written to it by the caller are not copied
+% through the engine.
+%
+% Each result holds the detected_object_set boxes and the non empty entries
+% of detected_object_classification, flattened to their row, name and score.
+
+  global detected_object_set;
+  global detected_object_classification;
+
+  if iscell( frames )
+    count = numel( frames );
+  else
+    count = size( shapes, 1 );
+  end
+
+  results = cell( 1, count );
+
+  for i = 1:count
+    if iscell( frames )
+      image = frames{i};
+    else
+      mapping = memmapfile( frames, 'Format', { 'uint8', shapes(i,:), 'frame' }, ...
+                            'Offset', offsets(i), 'Repeat', 1 );
+      image = mapping.Data.frame;
+    end
+
+    detected_object_set = [];
+    detected_object_classification = [];
+
+    detect( image );
+
+    rows = [];
+    names = {};
+    scores = [];
+
+    for r = 1:size( detected_object_classification, 1 )
+      for c = 1:size( detected_object_classification, 2 )
+        entry = detected_object_classification(r,c);
+        if ~isempty( entry.name )
+          rows(end+1) = r;
+          names{end+1} = entry.name;
+          scores(end+1) = entry.score;
+        end
+      end
+    end
+
+    results{i} = struct( 'boxes', double( detected_object_set ), ...
+                         'class_rows', double( rows ), ...
+                         'class_names', { names }, ...
+                         'class_scores', double( scores ) );
+  end
+
+end
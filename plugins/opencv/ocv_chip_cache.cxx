@@ -0,0 +1,251 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ocv_chip_cache.h"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace viame {
+
+// -------------------------------------------------------------------------------------------------
+bool
+ocv_chip_cache::key
+::operator==( const key& other ) const
+{
+  return memory == other.memory && first_pixel == other.first_pixel &&
+         x == other.x && y == other.y && width == other.width && height == other.height &&
+         target_width == other.target_width && target_height == other.target_height &&
+         color_code == other.color_code;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+size_t
+ocv_chip_cache::key_hash
+::operator()( const key& k ) const
+{
+  size_t hash = std::hash< const void* >()( k.memory );
+
+  auto combine = [&hash]( size_t value )
+  {
+    hash ^= value + 0x9e3779b97f4a7c15ull + ( hash << 6 ) + ( hash >> 2 );
+  };
+
+  combine( std::hash< const void* >()( k.first_pixel ) );
+
+  for( int value : { k.x, k.y, k.width, k.height,
+                     k.target_width, k.target_height, k.color_code } )
+  {
+    combine( std::hash< int >()( value ) );
+  }
+
+  return hash;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+ocv_chip_cache&
+ocv_chip_cache
+::instance()
+{
+  static ocv_chip_cache* cache = new ocv_chip_cache();
+  return *cache;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+ocv_chip_cache
+::ocv_chip_cache()
+  : m_cached_bytes( 0 )
+  , m_max_cached_bytes( size_t( 256 ) << 20 )
+  , m_last_memory( nullptr )
+{
+}
+
+
+// -------------------------------------------------------------------------------------------------
+cv::Mat
+ocv_chip_cache
+::get( const kwiver::vital::image& image, const cv::Mat& src,
+       const kwiver::vital::bounding_box_d& box,
+       const cv::Size& size, int color_code )
+{
+  // Same rounding as the refiners cropping chips themselves, within the frame
+  const int x0 = std::max( 0, static_cast< int >( box.min_x() ) );
+  const int y0 = std::max( 0, static_cast< int >( box.min_y() ) );
+  const int x1 = std::min( src.cols, static_cast< int >( box.min_x() + box.width() ) );
+  const int y1 = std::min( src.rows, static_cast< int >( box.min_y() + box.height() ) );
+
+  if( x1 <= x0 || y1 <= y0 )
+  {
+    return cv::Mat();
+  }
+
+  const cv::Rect roi( x0, y0, x1 - x0, y1 - y0 );
+  const bool resize = size.area() > 0 && size != roi.size();
+
+  if( !resize && color_code < 0 )
+  {
+    return src( roi );
+  }
+
+  const kwiver::vital::image_memory_sptr memory = image.memory();
+
+  const key id = { memory.get(), image.first_pixel(), roi.x, roi.y, roi.width, roi.height,
+                   resize ? size.width : 0, resize ? size.height : 0, color_code };
+
+  // Frames not owning their memory can not be told apart once released
+  if( memory )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    auto itr = m_index.find( id );
+
+    if( itr != m_index.end() )
+    {
+      if( !itr->second->memory.expired() )
+      {
+        m_entries.splice( m_entries.begin(), m_entries, itr->second );
+        return itr->second->chip;
+      }
+
+      m_cached_bytes -= itr->second->bytes;
+      m_entries.erase( itr->second );
+      m_index.erase( itr );
+    }
+  }
+
+  // Extracted outside of the lock, concurrent users of the same chip may both end up doing so
+  cv::Mat chip = src( roi );
+
+  if( color_code >= 0 )
+  {
+    cv::Mat converted;
+    cv::cvtColor( chip, converted, color_code );
+    chip = converted;
+  }
+
+  if( resize )
+  {
+    cv::Mat resized;
+    cv::resize( chip, resized, size, 0, 0, cv::INTER_LINEAR );
+    chip = resized;
+  }
+
+  if( !memory )
+  {
+    return chip;
+  }
+
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  if( m_index.find( id ) == m_index.end() )
+  {
+    const size_t bytes = chip.total() * chip.elemSize();
+
+    m_entries.push_front( entry{ id, memory, chip, bytes } );
+    m_index[ id ] = m_entries.begin();
+    m_cached_bytes += bytes;
+
+    const bool new_frame = ( id.memory != m_last_memory );
+    m_last_memory = id.memory;
+
+    evict( new_frame );
+  }
+
+  return chip;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+void
+ocv_chip_cache
+::evict( bool drop_released )
+{
+  for( auto itr = m_entries.begin(); drop_released && itr != m_entries.end(); )
+  {
+    if( itr->memory.expired() )
+    {
+      m_cached_bytes -= itr->bytes;
+      m_index.erase( itr->id );
+      itr = m_entries.erase( itr );
+    }
+    else
+    {
+      ++itr;
+    }
+  }
+
+  while( m_cached_bytes > m_max_cached_bytes && !m_entries.empty() )
+  {
+    m_cached_bytes -= m_entries.back().bytes;
+    m_index.erase( m_entries.back().id );
+    m_entries.pop_back();
+  }
+}
+
+
+// -------------------------------------------------------------------------------------------------
+void
+ocv_chip_cache
+::set_limit( size_t max_cached_bytes )
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+  m_max_cached_bytes = max_cached_bytes;
+  evict( true );
+}
+
+
+// -------------------------------------------------------------------------------------------------
+void
+ocv_chip_cache
+::clear()
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+  m_entries.clear();
+  m_index.clear();
+  m_cached_bytes = 0;
+  m_last_memory = nullptr;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+size_t
+ocv_chip_cache
+::cached_bytes() const
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+  return m_cached_bytes;
+}
+
+} // end namespace
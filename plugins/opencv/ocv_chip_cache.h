@@ -0,0 +1,139 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ * \brief Process wide cache of detection chips shared by chained refiners
+ */
+
+#ifndef VIAME_OCV_CHIP_CACHE_H
+#define VIAME_OCV_CHIP_CACHE_H
+
+#include <plugins/opencv/viame_opencv_export.h>
+
+#include <vital/types/bounding_box.h>
+#include <vital/types/image.h>
+
+#include <opencv2/core/core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace viame {
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * @brief Chips cropped from frames, converted and resized once for all their users
+ *
+ * Refiners and classifiers chained on the same detections each crop the detection boxes out of
+ * the frame and convert them to the colour space and size of their model. Chips are kept here,
+ * keyed by the frame they come from, the box, the target size and the colour conversion, so the
+ * next stage asking for the same chip reuses it. Entries are dropped once their frame is released
+ * or the least recently used ones exceed the size limit.
+ */
+class VIAME_OPENCV_EXPORT ocv_chip_cache
+{
+public:
+  /// Process wide cache, never destroyed so that it outlives every user
+  static ocv_chip_cache& instance();
+
+  /**
+   * @brief Chip of a box of the image, reusing a previous extraction when possible
+   *
+   * @param image        Frame the box is in, identifying it in the cache
+   * @param src          The same frame as returned by vital_to_ocv
+   * @param box          Detection box, clipped to the frame
+   * @param size         Size the chip is resized to, or empty to keep its size
+   * @param color_code   cv::cvtColor conversion code, or negative to keep the colour space
+   *
+   * The returned chip may be shared with other users and must not be modified. Chips without
+   * conversion or resizing are views into the frame and are not cached.
+   */
+  cv::Mat get( const kwiver::vital::image& image, const cv::Mat& src,
+               const kwiver::vital::bounding_box_d& box,
+               const cv::Size& size = cv::Size(), int color_code = -1 );
+
+  /// Bound the total size in bytes of the cached chips
+  void set_limit( size_t max_cached_bytes );
+
+  /// Release every cached chip
+  void clear();
+
+  /// Total size of the cached chips in bytes
+  size_t cached_bytes() const;
+
+private:
+  ocv_chip_cache();
+
+  struct key
+  {
+    const void* memory;
+    const void* first_pixel;
+    int x, y, width, height;
+    int target_width, target_height;
+    int color_code;
+
+    bool operator==( const key& other ) const;
+  };
+
+  struct key_hash
+  {
+    size_t operator()( const key& k ) const;
+  };
+
+  struct entry
+  {
+    key id;
+    std::weak_ptr< kwiver::vital::image_memory > memory;
+    cv::Mat chip;
+    size_t bytes;
+  };
+
+  typedef std::list< entry > entry_list;
+
+  // Drop entries of released frames if requested, then the oldest ones until under the limit
+  void evict( bool drop_released );
+
+  mutable std::mutex m_mutex;
+  entry_list m_entries;
+  std::unordered_map< key, entry_list::iterator, key_hash > m_index;
+  size_t m_cached_bytes;
+  size_t m_max_cached_bytes;
+
+  // Frame of the last inserted chip, released frames are only looked for on a new one
+  const void* m_last_memory;
+};
+
+} // end namespace
+
+#endif /* VIAME_OCV_CHIP_CACHE_H */
@@ -29,17 +29,223 @@
  */
 
 #include "ocv_debayer_filter.h"
+#include "ocv_image_buffer_pool.h"
 
+#include <opencv2/core/ocl.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include <arrows/ocv/image_container.h>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <mutex>
 
 namespace viame {
 
 using namespace kwiver;
 
+// -------------------------------------------------------------------------------------------------
+// Debayer the input and optionally stretch it to 8 bits, for host or OpenCL images
+template < typename MAT >
+void
+debayer( const MAT& input, MAT& output, int code, bool force_8bit )
+{
+  cv::cvtColor( input, output, code );
+
+  if( force_8bit && output.depth() != CV_8U )
+  {
+    cv::normalize( output, output, 255, 0, cv::NORM_MINMAX );
+    output.convertTo( output, CV_8U );
+  }
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// Statistics of the raw samples of each BGR color of a Bayer image
+struct bayer_stats
+{
+  double sum[3] = { 0.0, 0.0, 0.0 };
+  double count[3] = { 0.0, 0.0, 0.0 };
+  double min[3] = { std::numeric_limits< double >::max(),
+                    std::numeric_limits< double >::max(),
+                    std::numeric_limits< double >::max() };
+  double max[3] = { std::numeric_limits< double >::lowest(),
+                    std::numeric_limits< double >::lowest(),
+                    std::numeric_limits< double >::lowest() };
+
+  void add( int color, double value )
+  {
+    sum[ color ] += value;
+    count[ color ]++;
+    min[ color ] = std::min( min[ color ], value );
+    max[ color ] = std::max( max[ color ], value );
+  }
+
+  void merge( const bayer_stats& other )
+  {
+    for( int c = 0; c < 3; ++c )
+    {
+      sum[c] += other.sum[c];
+      count[c] += other.count[c];
+      min[c] = std::min( min[c], other.min[c] );
+      max[c] = std::max( max[c], other.max[c] );
+    }
+  }
+};
+
+
+// Colors of a 16-bit Bayer image, given the BGR index of each site of its top left 2x2 quad
+bayer_stats
+compute_bayer_stats( const cv::Mat& raw, const int quad[4] )
+{
+  bayer_stats stats;
+  std::mutex stats_mutex;
+
+  cv::parallel_for_( cv::Range( 0, raw.rows ), [&]( const cv::Range& range )
+  {
+    bayer_stats local;
+
+    for( int r = range.start; r < range.end; ++r )
+    {
+      const ushort* row = raw.ptr< ushort >( r );
+      const int* colors = quad + 2 * ( r % 2 );
+
+      for( int c = 0; c < raw.cols; ++c )
+      {
+        local.add( colors[ c % 2 ], row[c] );
+      }
+    }
+
+    std::lock_guard< std::mutex > lock( stats_mutex );
+    stats.merge( local );
+  } );
+
+  return stats;
+}
+
+
+// Per channel affine mapping of raw values to 8 bits, stretching the range of the raw samples
+// after an optional gray world white balance
+void
+compute_8bit_mapping( const bayer_stats& stats, bool auto_balance,
+                      double scale[3], double shift[3] )
+{
+  double gain[3] = { 1.0, 1.0, 1.0 };
+
+  if( auto_balance )
+  {
+    double mean[3];
+
+    for( int c = 0; c < 3; ++c )
+    {
+      mean[c] = ( stats.count[c] > 0 ? stats.sum[c] / stats.count[c] : 0.0 );
+    }
+
+    const double illum = ( mean[0] + mean[1] + mean[2] ) / 3;
+
+    for( int c = 0; c < 3; ++c )
+    {
+      gain[c] = ( mean[c] > 0.0 ? illum / mean[c] : 1.0 );
+    }
+  }
+
+  double low = std::numeric_limits< double >::max();
+  double high = std::numeric_limits< double >::lowest();
+
+  for( int c = 0; c < 3; ++c )
+  {
+    if( stats.count[c] > 0 )
+    {
+      low = std::min( low, stats.min[c] * gain[c] );
+      high = std::max( high, stats.max[c] * gain[c] );
+    }
+  }
+
+  const double stretch = ( high - low > std::numeric_limits< double >::epsilon() ?
+    255.0 / ( high - low ) : 0.0 );
+
+  for( int c = 0; c < 3; ++c )
+  {
+    scale[c] = gain[c] * stretch;
+    shift[c] = -low * stretch;
+  }
+}
+
+
+// Collapse each 2x2 Bayer quad to one BGR pixel, averaging its two green samples, and apply a
+// per channel affine mapping to the output type
+template < typename IN, typename OUT >
+void
+debayer_half( const cv::Mat& raw, const int quad[4],
+              const double scale[3], const double shift[3], cv::Mat& output )
+{
+  output.create( raw.rows / 2, raw.cols / 2, CV_MAKETYPE( cv::DataType< OUT >::depth, 3 ) );
+
+  // Fold the average of the samples of each color in the mapping
+  double quad_scale[3] = { scale[0], scale[1], scale[2] };
+  int counts[3] = { 0, 0, 0 };
+
+  for( int i = 0; i < 4; ++i )
+  {
+    counts[ quad[i] ]++;
+  }
+
+  for( int c = 0; c < 3; ++c )
+  {
+    quad_scale[c] /= std::max( counts[c], 1 );
+  }
+
+  cv::parallel_for_( cv::Range( 0, output.rows ), [&]( const cv::Range& range )
+  {
+    for( int r = range.start; r < range.end; ++r )
+    {
+      const IN* top = raw.ptr< IN >( 2 * r );
+      const IN* bottom = raw.ptr< IN >( 2 * r + 1 );
+      OUT* out = output.ptr< OUT >( r );
+
+      for( int c = 0; c < output.cols; ++c, out += 3 )
+      {
+        double sums[3] = { 0.0, 0.0, 0.0 };
+
+        sums[ quad[0] ] += top[ 2 * c ];
+        sums[ quad[1] ] += top[ 2 * c + 1 ];
+        sums[ quad[2] ] += bottom[ 2 * c ];
+        sums[ quad[3] ] += bottom[ 2 * c + 1 ];
+
+        for( int i = 0; i < 3; ++i )
+        {
+          out[i] = cv::saturate_cast< OUT >( sums[i] * quad_scale[i] + shift[i] );
+        }
+      }
+    }
+  } );
+}
+
+
+// Convert a 16-bit BGR image to 8 bits with a per channel affine mapping, in one pass
+void
+convert_to_8bit( const cv::Mat& bgr, cv::Mat& output, const double scale[3], const double shift[3] )
+{
+  output.create( bgr.size(), CV_8UC3 );
+
+  cv::parallel_for_( cv::Range( 0, bgr.rows ), [&]( const cv::Range& range )
+  {
+    for( int r = range.start; r < range.end; ++r )
+    {
+      const ushort* in = bgr.ptr< ushort >( r );
+      uchar* out = output.ptr< uchar >( r );
+
+      for( int c = 0; c < bgr.cols * 3; c += 3 )
+      {
+        out[c] = cv::saturate_cast< uchar >( in[c] * scale[0] + shift[0] );
+        out[c+1] = cv::saturate_cast< uchar >( in[c+1] * scale[1] + shift[1] );
+        out[c+2] = cv::saturate_cast< uchar >( in[c+2] * scale[2] + shift[2] );
+      }
+    }
+  } );
+}
+
 // -----------------------------------------------------------------------------------------------
 /**
  * @brief Storage class for private member variables
@@ -51,6 +257,9 @@ public:
   priv()
     : m_pattern( "BG" )
     , m_force_8bit( false )
+    , m_auto_balance( false )
+    , m_half_resolution( false )
+    , m_use_opencl( false )
     , m_is_first( true )
   {}
 
@@ -58,7 +267,14 @@ public:
 
   std::string m_pattern;
   bool m_force_8bit;
+  bool m_auto_balance;
+  bool m_half_resolution;
+  bool m_use_opencl;
   bool m_is_first;
+
+  // Device buffers reused across frames in OpenCL mode
+  cv::UMat m_input_device;
+  cv::UMat m_output_device;
 };
 
 // =================================================================================================
@@ -90,6 +306,16 @@ ocv_debayer_filter
     "row, second and third columns of the image, respectively." );
 
   config->set_value( "force_8bit", d->m_force_8bit, "Force output to be 8 bit" );
+  config->set_value( "auto_balance", d->m_auto_balance, "When converting 16-bit raw data to 8 "
+    "bits with force_8bit, also white balance the channels from the mean of each Bayer color. "
+    "The balance and contrast stretch are computed on the raw samples and applied in the same "
+    "pass as the 8-bit conversion." );
+  config->set_value( "half_resolution", d->m_half_resolution, "Collapse each 2x2 Bayer quad to "
+    "one BGR pixel instead of demosaicing, producing a half resolution output. The green value "
+    "is the mean of the two green samples. The force_8bit and auto_balance conversions are "
+    "applied in the same pass." );
+  config->set_value( "use_opencl", d->m_use_opencl, "Upload the input once and run the debayering "
+    "and 8-bit conversion with OpenCL kernels. Falls back to the host if OpenCL is not available." );
 
   return config;
 }
@@ -102,6 +328,15 @@ ocv_debayer_filter
 {
   d->m_pattern = config->get_value< std::string >( "pattern" );
   d->m_force_8bit = config->get_value< bool >( "force_8bit" );
+  d->m_auto_balance = config->get_value< bool >( "auto_balance" );
+  d->m_half_resolution = config->get_value< bool >( "half_resolution" );
+  d->m_use_opencl = config->get_value< bool >( "use_opencl" );
+
+  if( d->m_use_opencl && !cv::ocl::haveOpenCL() )
+  {
+    LOG_WARN( logger(), "OpenCL is not available, running on the host" );
+    d->m_use_opencl = false;
+  }
 }
 
 
@@ -144,28 +379,70 @@ ocv_debayer_filter
       kwiver::arrows::ocv::image_container::BGR_COLOR );
 
   cv::Mat output_ocv;
+  ocv_image_buffer_pool::attach( output_ocv );
 
-  if( d->m_pattern == "BG" )
-  {
-    cv::cvtColor( input_ocv, output_ocv, cv::COLOR_BayerBG2BGR );
-  }
-  else if( d->m_pattern == "GB" )
+  // BGR index of each site of the top left quad, the OpenCV BG pattern being RGGB
+  int code = cv::COLOR_BayerBG2BGR;
+  int quad[4] = { 2, 1, 1, 0 };
+
+  if( d->m_pattern == "GB" )
   {
-    cv::cvtColor( input_ocv, output_ocv, cv::COLOR_BayerGB2BGR );
+    code = cv::COLOR_BayerGB2BGR;
+    quad[0] = 1; quad[1] = 2; quad[2] = 0; quad[3] = 1;
   }
   else if( d->m_pattern == "RG" )
   {
-    cv::cvtColor( input_ocv, output_ocv, cv::COLOR_BayerRG2BGR );
+    code = cv::COLOR_BayerRG2BGR;
+    quad[0] = 0; quad[1] = 1; quad[2] = 1; quad[3] = 2;
   }
   else if( d->m_pattern == "GR" )
   {
-    cv::cvtColor( input_ocv, output_ocv, cv::COLOR_BayerGR2BGR );
+    code = cv::COLOR_BayerGR2BGR;
+    quad[0] = 1; quad[1] = 0; quad[2] = 2; quad[3] = 1;
   }
 
-  if( d->m_force_8bit && output_ocv.depth() != CV_8U )
-  { 
-    cv::normalize( output_ocv, output_ocv, 255, 0, cv::NORM_MINMAX );
-    output_ocv.convertTo( output_ocv, CV_8U );
+  if( d->m_half_resolution &&
+      ( input_ocv.depth() == CV_8U || input_ocv.depth() == CV_16U ) )
+  {
+    double scale[3] = { 1.0, 1.0, 1.0 };
+    double shift[3] = { 0.0, 0.0, 0.0 };
+
+    if( input_ocv.depth() == CV_8U )
+    {
+      debayer_half< uchar, uchar >( input_ocv, quad, scale, shift, output_ocv );
+    }
+    else if( d->m_force_8bit )
+    {
+      compute_8bit_mapping( compute_bayer_stats( input_ocv, quad ),
+                            d->m_auto_balance, scale, shift );
+      debayer_half< ushort, uchar >( input_ocv, quad, scale, shift, output_ocv );
+    }
+    else
+    {
+      debayer_half< ushort, ushort >( input_ocv, quad, scale, shift, output_ocv );
+    }
+  }
+  else if( d->m_force_8bit && input_ocv.depth() == CV_16U && !d->m_use_opencl )
+  {
+    // Demosaiced values are interpolated between raw samples of the same color, which also
+    // appear unchanged at their own sites, so the output range is that of the raw samples
+    double scale[3], shift[3];
+    compute_8bit_mapping( compute_bayer_stats( input_ocv, quad ), d->m_auto_balance, scale, shift );
+
+    cv::Mat bgr;
+    ocv_image_buffer_pool::attach( bgr );
+    cv::cvtColor( input_ocv, bgr, code );
+    convert_to_8bit( bgr, output_ocv, scale, shift );
+  }
+  else if( d->m_use_opencl )
+  {
+    input_ocv.copyTo( d->m_input_device );
+    debayer( d->m_input_device, d->m_output_device, code, d->m_force_8bit );
+    d->m_output_device.copyTo( output_ocv );
+  }
+  else
+  {
+    debayer( input_ocv, output_ocv, code, d->m_force_8bit );
   }
 
   kwiver::vital::image_container_sptr output(
@@ -0,0 +1,339 @@
+#include "ocv_gmm_motion_detector.h"
+
+#include <arrows/ocv/image_container.h>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/video/background_segm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace kv = kwiver::vital;
+namespace ocv = kwiver::arrows::ocv;
+
+namespace viame {
+
+// -----------------------------------------------------------------------------------------------
+class ocv_gmm_motion_detector::priv
+{
+public:
+
+  /// Constructor
+  priv()
+    : m_downsample_factor(1.0),
+      m_morphology_size(10),
+      m_num_mixtures(5),
+      m_training_frames(300),
+      m_startup_frames(3),
+      m_learning_rate(-1.0),
+      m_variance_threshold(30.0),
+      m_initial_variance(900.0),
+      m_background_ratio(0.7),
+      m_min_num_pixels(800),
+      m_edge_trim(12),
+      m_min_aspect(3.5),
+      m_max_aspect(7.5),
+      m_object_type("Motion"),
+      m_output_masks(true),
+      m_frame_count(0)
+  {}
+
+  /// Destructor
+  ~priv() {}
+
+  /// Parameters
+  double m_downsample_factor;
+  unsigned m_morphology_size;
+  unsigned m_num_mixtures;
+  unsigned m_training_frames;
+  unsigned m_startup_frames;
+  double m_learning_rate;
+  double m_variance_threshold;
+  double m_initial_variance;
+  double m_background_ratio;
+  unsigned m_min_num_pixels;
+  unsigned m_edge_trim;
+  double m_min_aspect;
+  double m_max_aspect;
+  std::string m_object_type;
+  bool m_output_masks;
+
+  /// Background model and number of frames it was updated with
+  cv::Ptr< cv::BackgroundSubtractorMOG2 > m_model;
+  unsigned m_frame_count;
+
+  /// Buffers reused from one frame to the next
+  cv::Mat m_gray, m_small, m_foreground, m_labels, m_stats, m_centroids;
+
+  kv::logger_handle_t m_logger;
+
+  void reset_model();
+
+  // Update the background model with the frame and return its cleaned foreground mask,
+  // at the downsampled resolution
+  const cv::Mat& foreground( const cv::Mat& image );
+}; // end class ocv_gmm_motion_detector::priv
+
+
+// -------------------------------------------------------------------------------------------------
+void
+ocv_gmm_motion_detector::priv
+::reset_model()
+{
+  m_model = cv::createBackgroundSubtractorMOG2( m_training_frames, m_variance_threshold, false );
+  m_model->setNMixtures( m_num_mixtures );
+  m_model->setVarInit( m_initial_variance );
+  m_model->setBackgroundRatio( m_background_ratio );
+  m_frame_count = 0;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+const cv::Mat&
+ocv_gmm_motion_detector::priv
+::foreground( const cv::Mat& image )
+{
+  // The model works on 8 bit gray frames
+  const cv::Mat* gray = &image;
+
+  if( image.channels() > 1 )
+  {
+    cv::cvtColor( image, m_gray, image.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY );
+    gray = &m_gray;
+  }
+  if( gray->depth() != CV_8U )
+  {
+    gray->convertTo( m_gray, CV_8U, gray->depth() == CV_16U ? 1.0 / 256.0 : 1.0 );
+    gray = &m_gray;
+  }
+
+  // Averaging downsample, as imresize in the MATLAB detector
+  if( m_downsample_factor > 1.0 )
+  {
+    const cv::Size size( std::max( 1, static_cast< int >( std::round( gray->cols / m_downsample_factor ) ) ),
+                         std::max( 1, static_cast< int >( std::round( gray->rows / m_downsample_factor ) ) ) );
+    cv::resize( *gray, m_small, size, 0, 0, cv::INTER_AREA );
+    gray = &m_small;
+  }
+
+  m_model->apply( *gray, m_foreground, m_learning_rate );
+  ++m_frame_count;
+
+  // Opening then dilation with a disk, sized relative to the input image
+  const int ksize = static_cast< int >( std::round( m_morphology_size / m_downsample_factor ) );
+
+  if( ksize > 1 )
+  {
+    const cv::Mat kernel = cv::getStructuringElement( cv::MORPH_ELLIPSE, cv::Size( ksize, ksize ) );
+    cv::morphologyEx( m_foreground, m_foreground, cv::MORPH_OPEN, kernel );
+    cv::dilate( m_foreground, m_foreground, kernel );
+  }
+
+  return m_foreground;
+}
+
+
+// =================================================================================================
+ocv_gmm_motion_detector::
+ocv_gmm_motion_detector()
+  : d( new priv() )
+{
+  attach_logger( "viame.opencv.ocv_gmm_motion_detector" );
+  d->m_logger = logger();
+}
+
+
+ocv_gmm_motion_detector::
+~ocv_gmm_motion_detector()
+{}
+
+
+// -------------------------------------------------------------------------------------------------
+kv::config_block_sptr
+ocv_gmm_motion_detector::
+get_configuration() const
+{
+  // Get base config from base class
+  kv::config_block_sptr config = kv::algorithm::get_configuration();
+
+  config->set_value( "downsample_factor", d->m_downsample_factor,
+    "Frames are downsampled by this factor, averaging pixels, before updating the "
+    "background model. Detections are given at the input resolution." );
+  config->set_value( "morphology_size", d->m_morphology_size,
+    "Diameter of the disk used to open then dilate the foreground mask, in input "
+    "image pixels. 0 disables the cleanup." );
+  config->set_value( "num_mixtures", d->m_num_mixtures, "Number of Gaussians per pixel" );
+  config->set_value( "training_frames", d->m_training_frames,
+    "Number of frames over which the background model is learnt" );
+  config->set_value( "startup_frames", d->m_startup_frames,
+    "Number of first frames which only update the background model, without detections" );
+  config->set_value( "learning_rate", d->m_learning_rate,
+    "Background model learning rate. Negative uses 1 / min( frame count, training_frames )." );
+  config->set_value( "variance_threshold", d->m_variance_threshold,
+    "Squared distance to a background Gaussian, in variances, above which pixels are foreground" );
+  config->set_value( "initial_variance", d->m_initial_variance, "Variance of new Gaussians" );
+  config->set_value( "background_ratio", d->m_background_ratio,
+    "Minimum weight of the Gaussians considered as background" );
+  config->set_value( "min_num_pixels", d->m_min_num_pixels,
+    "Detections with fewer pixels, in input image pixels, are ignored" );
+  config->set_value( "edge_trim", d->m_edge_trim,
+    "Detections closer than this to the image border, in input image pixels, are ignored" );
+  config->set_value( "min_aspect", d->m_min_aspect, "Minimum oriented box aspect ratio of the detections" );
+  config->set_value( "max_aspect", d->m_max_aspect, "Maximum oriented box aspect ratio of the detections" );
+  config->set_value( "object_type", d->m_object_type, "The detected object type" );
+  config->set_value( "output_masks", d->m_output_masks,
+    "If true, each detection carries its foreground mask, cropped to its box" );
+
+  return config;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+void
+ocv_gmm_motion_detector::
+set_configuration( kv::config_block_sptr config_in )
+{
+  kv::config_block_sptr config = this->get_configuration();
+  config->merge_config( config_in );
+
+  d->m_downsample_factor = config->get_value< double >( "downsample_factor" );
+  d->m_morphology_size = config->get_value< unsigned >( "morphology_size" );
+  d->m_num_mixtures = config->get_value< unsigned >( "num_mixtures" );
+  d->m_training_frames = config->get_value< unsigned >( "training_frames" );
+  d->m_startup_frames = config->get_value< unsigned >( "startup_frames" );
+  d->m_learning_rate = config->get_value< double >( "learning_rate" );
+  d->m_variance_threshold = config->get_value< double >( "variance_threshold" );
+  d->m_initial_variance = config->get_value< double >( "initial_variance" );
+  d->m_background_ratio = config->get_value< double >( "background_ratio" );
+  d->m_min_num_pixels = config->get_value< unsigned >( "min_num_pixels" );
+  d->m_edge_trim = config->get_value< unsigned >( "edge_trim" );
+  d->m_min_aspect = config->get_value< double >( "min_aspect" );
+  d->m_max_aspect = config->get_value< double >( "max_aspect" );
+  d->m_object_type = config->get_value< std::string >( "object_type" );
+  d->m_output_masks = config->get_value< bool >( "output_masks" );
+
+  d->m_downsample_factor = std::max( d->m_downsample_factor, 1.0 );
+  d->reset_model();
+}
+
+
+// -------------------------------------------------------------------------------------------------
+bool
+ocv_gmm_motion_detector::
+check_configuration( kv::config_block_sptr config ) const
+{
+  if( config->get_value< unsigned >( "num_mixtures" ) == 0 )
+  {
+    LOG_ERROR( d->m_logger, "num_mixtures must be positive" );
+    return false;
+  }
+  if( config->get_value< double >( "min_aspect" ) > config->get_value< double >( "max_aspect" ) )
+  {
+    LOG_ERROR( d->m_logger, "min_aspect must not exceed max_aspect" );
+    return false;
+  }
+  return true;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+kv::detected_object_set_sptr
+ocv_gmm_motion_detector::
+detect( kv::image_container_sptr image_data ) const
+{
+  auto detected_set = std::make_shared< kv::detected_object_set >();
+
+  if( !image_data )
+  {
+    return detected_set;
+  }
+
+  if( !d->m_model )
+  {
+    d->reset_model();
+  }
+
+  const cv::Mat image = ocv::image_container::vital_to_ocv( image_data->get_image(),
+                                                            ocv::image_container::BGR_COLOR );
+  const cv::Mat& mask = d->foreground( image );
+
+  if( d->m_frame_count <= d->m_startup_frames )
+  {
+    return detected_set;
+  }
+
+  // 8-way connected components, with their areas and boxes in a single pass
+  const int count = cv::connectedComponentsWithStats( mask, d->m_labels, d->m_stats,
+                                                      d->m_centroids, 8, CV_32S );
+
+  const double x_factor = static_cast< double >( image.cols ) / mask.cols;
+  const double y_factor = static_cast< double >( image.rows ) / mask.rows;
+  const double trim = d->m_edge_trim;
+
+  for( int label = 1; label < count; ++label )
+  {
+    const int* stats = d->m_stats.ptr< int >( label );
+
+    if( stats[ cv::CC_STAT_AREA ] * x_factor * y_factor < d->m_min_num_pixels )
+    {
+      continue;
+    }
+
+    const cv::Rect rect( stats[ cv::CC_STAT_LEFT ], stats[ cv::CC_STAT_TOP ],
+                         stats[ cv::CC_STAT_WIDTH ], stats[ cv::CC_STAT_HEIGHT ] );
+    const kv::bounding_box_d bbox( rect.x * x_factor, rect.y * y_factor,
+                                   rect.br().x * x_factor, rect.br().y * y_factor );
+
+    if( bbox.min_x() < trim || bbox.min_y() < trim ||
+        bbox.max_x() > image.cols - trim || bbox.max_y() > image.rows - trim )
+    {
+      continue;
+    }
+
+    // Oriented box of the component outline, which bounds the same points as the
+    // component itself
+    const cv::Mat component = ( d->m_labels( rect ) == label );
+    std::vector< std::vector< cv::Point > > contours;
+    cv::findContours( component, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE );
+
+    std::vector< cv::Point > outline;
+    for( const auto& contour : contours )
+    {
+      outline.insert( outline.end(), contour.begin(), contour.end() );
+    }
+
+    const cv::Size2f extent = cv::minAreaRect( outline ).size;
+    if( extent.width <= 0.f || extent.height <= 0.f )
+    {
+      continue;
+    }
+
+    const double aspect = std::max( extent.width / extent.height, extent.height / extent.width );
+    if( aspect < d->m_min_aspect || aspect > d->m_max_aspect )
+    {
+      continue;
+    }
+
+    auto dot = std::make_shared< kv::detected_object_type >( d->m_object_type, 1.0 );
+    auto detection = std::make_shared< kv::detected_object >( bbox, 1.0, dot );
+
+    if( d->m_output_masks )
+    {
+      const cv::Size mask_size( std::max( 1, static_cast< int >( std::round( bbox.width() ) ) ),
+                                std::max( 1, static_cast< int >( std::round( bbox.height() ) ) ) );
+      cv::Mat object_mask;
+      cv::resize( component / 255, object_mask, mask_size, 0, 0, cv::INTER_NEAREST );
+
+      detection->set_mask( std::make_shared< ocv::image_container >(
+        object_mask, ocv::image_container::OTHER_COLOR ) );
+    }
+
+    detected_set->add( detection );
+  }
+
+  LOG_DEBUG( d->m_logger, "Detected " << detected_set->size() << " moving targets" );
+  return detected_set;
+}
+
+} // end namespace viame
@@ -0,0 +1,50 @@
+#ifndef VIAME_OCV_GMM_MOTION_DETECTOR_H
+#define VIAME_OCV_GMM_MOTION_DETECTOR_H
+
+#include <plugins/opencv/viame_opencv_export.h>
+
+#include <vital/algo/image_object_detector.h>
+
+namespace viame {
+
+/// Detects moving targets with a per pixel Gaussian mixture background model
+///
+/// Native version of the camtrawl GMM detector (gmm_background_remove.m and
+/// extract_targets2.m): the gray, downsampled frame updates the background
+/// model, the foreground mask is cleaned by an opening and a dilation, and
+/// its connected components are filtered by size, distance to the image
+/// border and oriented box aspect ratio. Each detection carries its mask,
+/// cropped to its box in input image coordinates.
+///
+/// The background model is updated by every call to detect, so frames have
+/// to be given in order to a single instance.
+class VIAME_OPENCV_EXPORT ocv_gmm_motion_detector :
+  public kwiver::vital::algorithm_impl<
+    ocv_gmm_motion_detector, kwiver::vital::algo::image_object_detector >
+{
+public:
+  PLUGIN_INFO( "ocv_gmm_motion_detector",
+               "Detects moving targets against a Gaussian mixture background model." )
+
+  ocv_gmm_motion_detector();
+  virtual ~ocv_gmm_motion_detector();
+
+  // Get the current configuration (parameters) for this detector
+  virtual kwiver::vital::config_block_sptr get_configuration() const;
+
+  // Set configurations automatically parsed from input pipeline and config files
+  virtual void set_configuration( kwiver::vital::config_block_sptr config_in );
+  virtual bool check_configuration( kwiver::vital::config_block_sptr config ) const;
+
+  // Main detection method
+  virtual kwiver::vital::detected_object_set_sptr detect(
+    kwiver::vital::image_container_sptr image_data ) const;
+
+private:
+  class priv;
+  const std::unique_ptr< priv > d;
+};
+
+} // end namespace
+
+#endif /* VIAME_OCV_GMM_MOTION_DETECTOR_H */
@@ -0,0 +1,220 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ocv_image_buffer_pool.h"
+
+namespace viame {
+
+// -------------------------------------------------------------------------------------------------
+ocv_image_buffer_pool&
+ocv_image_buffer_pool
+::instance()
+{
+  static ocv_image_buffer_pool* pool = new ocv_image_buffer_pool();
+  return *pool;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+void
+ocv_image_buffer_pool
+::attach( cv::Mat& mat )
+{
+  mat.allocator = &instance();
+}
+
+
+// -------------------------------------------------------------------------------------------------
+ocv_image_buffer_pool
+::ocv_image_buffer_pool()
+  : m_pooled_bytes( 0 )
+  , m_max_buffers_per_size( 4 )
+  , m_max_pooled_bytes( size_t( 1 ) << 30 )
+{
+}
+
+
+// -------------------------------------------------------------------------------------------------
+void
+ocv_image_buffer_pool
+::set_limits( size_t max_buffers_per_size, size_t max_pooled_bytes )
+{
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_max_buffers_per_size = max_buffers_per_size;
+    m_max_pooled_bytes = max_pooled_bytes;
+  }
+
+  clear();
+}
+
+
+// -------------------------------------------------------------------------------------------------
+void
+ocv_image_buffer_pool
+::clear()
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+
+  for( auto& buffers : m_free_buffers )
+  {
+    for( void* buffer : buffers.second )
+    {
+      cv::fastFree( buffer );
+    }
+  }
+
+  m_free_buffers.clear();
+  m_pooled_bytes = 0;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+size_t
+ocv_image_buffer_pool
+::pooled_bytes() const
+{
+  std::lock_guard< std::mutex > lock( m_mutex );
+  return m_pooled_bytes;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+cv::UMatData*
+ocv_image_buffer_pool
+::allocate( int dims, const int* sizes, int type, void* data0, size_t* step,
+            ocv_access_flag_t, cv::UMatUsageFlags ) const
+{
+  // Same layout as the default OpenCV allocator
+  size_t total = CV_ELEM_SIZE( type );
+
+  for( int i = dims - 1; i >= 0; i-- )
+  {
+    if( step )
+    {
+      if( data0 && step[i] != CV_AUTOSTEP )
+      {
+        total = step[i];
+      }
+      else
+      {
+        step[i] = total;
+      }
+    }
+
+    total *= sizes[i];
+  }
+
+  uchar* data = static_cast< uchar* >( data0 );
+
+  if( !data )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    auto buffers = m_free_buffers.find( total );
+
+    if( buffers != m_free_buffers.end() && !buffers->second.empty() )
+    {
+      data = static_cast< uchar* >( buffers->second.back() );
+      buffers->second.pop_back();
+      m_pooled_bytes -= total;
+    }
+  }
+
+  if( !data )
+  {
+    data = static_cast< uchar* >( cv::fastMalloc( total ) );
+  }
+
+  cv::UMatData* u = new cv::UMatData( this );
+  u->data = u->origdata = data;
+  u->size = total;
+
+  if( data0 )
+  {
+    u->flags |= cv::UMatData::USER_ALLOCATED;
+  }
+
+  return u;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+bool
+ocv_image_buffer_pool
+::allocate( cv::UMatData* u, ocv_access_flag_t, cv::UMatUsageFlags ) const
+{
+  return u != nullptr;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+void
+ocv_image_buffer_pool
+::deallocate( cv::UMatData* u ) const
+{
+  if( !u )
+  {
+    return;
+  }
+
+  CV_Assert( u->urefcount == 0 );
+  CV_Assert( u->refcount == 0 );
+
+  if( !( u->flags & cv::UMatData::USER_ALLOCATED ) && u->origdata )
+  {
+    bool pooled = false;
+
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+
+      auto& buffers = m_free_buffers[ u->size ];
+
+      if( buffers.size() < m_max_buffers_per_size &&
+          m_pooled_bytes + u->size <= m_max_pooled_bytes )
+      {
+        buffers.push_back( u->origdata );
+        m_pooled_bytes += u->size;
+        pooled = true;
+      }
+    }
+
+    if( !pooled )
+    {
+      cv::fastFree( u->origdata );
+    }
+
+    u->origdata = 0;
+  }
+
+  delete u;
+}
+
+} // end namespace
@@ -0,0 +1,104 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Size-keyed pool of image buffers shared by the OpenCV filters
+ */
+
+#ifndef VIAME_OCV_IMAGE_BUFFER_POOL_H
+#define VIAME_OCV_IMAGE_BUFFER_POOL_H
+
+#include <plugins/opencv/viame_opencv_export.h>
+
+#include <opencv2/core/core.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace viame {
+
+#if CV_VERSION_MAJOR > 4 || ( CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 2 )
+typedef cv::AccessFlag ocv_access_flag_t;
+#else
+typedef int ocv_access_flag_t;
+#endif
+
+// -------------------------------------------------------------------------------------------------
+/**
+ * @brief Allocator recycling the data of host matrices by byte size
+ *
+ * Matrices attached to the pool draw their data from it on their next (re)allocation. The data
+ * returns to the pool once the last matrix or image container referencing it is released, so
+ * filters producing same sized outputs every frame stop allocating after the first frames.
+ */
+class VIAME_OPENCV_EXPORT ocv_image_buffer_pool : public cv::MatAllocator
+{
+public:
+  /// Process wide pool, never destroyed so that it outlives every matrix using it
+  static ocv_image_buffer_pool& instance();
+
+  /// Make the next allocations of the matrix use the shared pool
+  static void attach( cv::Mat& mat );
+
+  /// Device matrices are left to the OpenCL buffer pool of OpenCV
+  static void attach( cv::UMat& ) {}
+
+  /// Bound the number of free buffers kept for each size and their total size in bytes
+  void set_limits( size_t max_buffers_per_size, size_t max_pooled_bytes );
+
+  /// Release every free buffer
+  void clear();
+
+  /// Total size of the free buffers in bytes
+  size_t pooled_bytes() const;
+
+  cv::UMatData* allocate( int dims, const int* sizes, int type, void* data, size_t* step,
+                          ocv_access_flag_t flags, cv::UMatUsageFlags usage ) const override;
+  bool allocate( cv::UMatData* data, ocv_access_flag_t flags,
+                 cv::UMatUsageFlags usage ) const override;
+  void deallocate( cv::UMatData* data ) const override;
+
+private:
+  ocv_image_buffer_pool();
+
+  mutable std::mutex m_mutex;
+  mutable std::unordered_map< size_t, std::vector< void* > > m_free_buffers;
+  mutable size_t m_pooled_bytes;
+
+  size_t m_max_buffers_per_size;
+  size_t m_max_pooled_bytes;
+};
+
+} // end namespace
+
+#endif /* VIAME_OCV_IMAGE_BUFFER_POOL_H */
@@ -29,18 +29,116 @@
  */
 
 #include "ocv_image_enhancement.h"
+#include "ocv_image_buffer_pool.h"
 
+#include <opencv2/core/ocl.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/photo/photo.hpp>
 
 #include <arrows/ocv/image_container.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace viame {
 
 using namespace kwiver;
 
+// -------------------------------------------------------------------------------------------------
+// Scale the HSV saturation of a BGR image in place, without converting it to HSV. For a pixel of
+// value V = max(B,G,R), every channel is c = V - V * S * t where t only depends on the hue, so
+// scaling S amounts to scaling the distance of each channel to V, the ratio being bounded so that
+// the saturation does not exceed 1.
+template < typename T >
+void
+scale_saturation( cv::Mat& image, float scale )
+{
+  cv::parallel_for_( cv::Range( 0, image.rows ), [&]( const cv::Range& range )
+  {
+    for( int r = range.start; r < range.end; ++r )
+    {
+      T* pixel = image.ptr< T >( r );
+
+      for( int c = 0; c < image.cols; ++c, pixel += 3 )
+      {
+        const float value = std::max( { pixel[0], pixel[1], pixel[2] } );
+        const float spread = value - std::min( { pixel[0], pixel[1], pixel[2] } );
+
+        if( spread <= 0.0f )
+        {
+          continue;
+        }
+
+        const float ratio = std::min( scale, value / spread );
+
+        for( int i = 0; i < 3; ++i )
+        {
+          pixel[i] = cv::saturate_cast< T >( value - ratio * ( value - pixel[i] ) );
+        }
+      }
+    }
+  } );
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// Scratch buffers reused across frames by the fused mode, for host or OpenCL images
+template < typename MAT >
+struct scratch_buffers
+{
+  MAT lab;
+  MAT lightness;
+  MAT lightness_8u;
+  MAT equalized;
+  MAT blurred;
+  MAT hsv;
+};
+
+
+// -------------------------------------------------------------------------------------------------
+// Scale the saturation of a 3-channel image, in BGR space on the host
+void
+apply_saturation( cv::Mat& image, float scale, const cv::Mat&, scratch_buffers< cv::Mat >& )
+{
+  switch( image.depth() )
+  {
+    case CV_8U:  scale_saturation< uchar >( image, scale ); break;
+    case CV_16U: scale_saturation< ushort >( image, scale ); break;
+    case CV_32F: scale_saturation< float >( image, scale ); break;
+    case CV_64F: scale_saturation< double >( image, scale ); break;
+    default:
+      throw std::runtime_error( "Saturation is not supported for this pixel type" );
+  }
+}
+
+
+// Scale the saturation of a 3-channel image, in HSV space with OpenCL kernels
+void
+apply_saturation( cv::UMat& image, float scale, const cv::Mat& lut,
+                  scratch_buffers< cv::UMat >& buffers )
+{
+#if CV_MAJOR_VERSION < 4
+  cv::cvtColor( image, buffers.hsv, CV_BGR2HSV );
+#else
+  cv::cvtColor( image, buffers.hsv, cv::COLOR_BGR2HSV );
+#endif
+
+  if( buffers.hsv.depth() == CV_8U )
+  {
+    cv::LUT( buffers.hsv, lut, buffers.hsv );
+  }
+  else
+  {
+    cv::multiply( buffers.hsv, cv::Scalar( 1.0, scale, 1.0 ), buffers.hsv );
+  }
+
+#if CV_MAJOR_VERSION < 4
+  cv::cvtColor( buffers.hsv, image, CV_HSV2BGR );
+#else
+  cv::cvtColor( buffers.hsv, image, cv::COLOR_HSV2BGR );
+#endif
+}
+
 // -----------------------------------------------------------------------------------------------
 /**
  * @brief Storage class for private member variables
@@ -63,7 +161,19 @@ public:
     , m_apply_sharpening( false )
     , m_sharpening_kernel( 3 )
     , m_sharpening_weight( 0.5 )
-  {}
+    , m_fused( false )
+    , m_use_opencl( false )
+  {
+    configure_lookups();
+  }
+
+  // Create the CLAHE instance and saturation table for the current settings
+  void configure_lookups();
+
+  // Run all enabled stages with at most one color space round trip on the
+  // host, or with OpenCL kernels on device images
+  template < typename MAT >
+  MAT filter_fused( const MAT& input, scratch_buffers< MAT >& buffers );
 
   ~priv() {}
 
@@ -80,8 +190,165 @@ public:
   bool m_apply_sharpening;
   unsigned m_sharpening_kernel;
   double m_sharpening_weight;
+  bool m_fused;
+  bool m_use_opencl;
+
+  // Configured once instead of on every frame, the table scales the saturation
+  // of 8-bit HSV pixels and leaves their hue and value unchanged
+  cv::Ptr< cv::CLAHE > m_clahe;
+  cv::Mat m_saturation_lut;
+
+  scratch_buffers< cv::Mat > m_host_buffers;
+  scratch_buffers< cv::UMat > m_device_buffers;
 };
 
+
+// -------------------------------------------------------------------------------------------------
+void
+ocv_image_enhancement::priv
+::configure_lookups()
+{
+  m_clahe = cv::createCLAHE();
+  m_clahe->setClipLimit( m_clip_limit );
+
+  m_saturation_lut.create( 1, 256, CV_8UC3 );
+
+  for( int i = 0; i < 256; ++i )
+  {
+    m_saturation_lut.at< cv::Vec3b >( i ) =
+      cv::Vec3b( i, cv::saturate_cast< uchar >( i * m_saturation ), i );
+  }
+}
+
+
+// -------------------------------------------------------------------------------------------------
+template < typename MAT >
+MAT
+ocv_image_enhancement::priv
+::filter_fused( const MAT& input, scratch_buffers< MAT >& buffers )
+{
+  MAT output;
+  ocv_image_buffer_pool::attach( output );
+
+  // The first stage reads the input directly instead of a copy of it
+  if( m_apply_smoothing )
+  {
+    cv::medianBlur( input, output, m_smoothing_kernel );
+  }
+  else
+  {
+    input.copyTo( output );
+  }
+
+  if( m_apply_denoising && input.depth() == CV_8U )
+  {
+    cv::fastNlMeansDenoisingColored( output, output,
+      m_denoise_coeff, m_denoise_coeff,
+      m_denoise_kernel, m_denoise_kernel * 3 );
+  }
+
+  if( m_auto_balance && output.channels() == 3 )
+  {
+    const cv::Scalar illum = cv::mean( output );
+    const double scale = ( illum( 0 ) + illum( 1 ) + illum( 2 ) ) / 3;
+
+    cv::multiply( output,
+      cv::Scalar( scale / illum( 0 ), scale / illum( 1 ), scale / illum( 2 ) ), output );
+  }
+
+  if( m_force_8bit && output.depth() != CV_8U )
+  {
+    cv::normalize( output, output, 255, 0, cv::NORM_MINMAX );
+    output.convertTo( output, CV_8U );
+  }
+
+  if( m_apply_denoising && input.depth() != CV_8U )
+  {
+    if( output.depth() != CV_8U )
+    {
+      throw std::runtime_error( "Unable to perform denoising on not 8-bit imagery" );
+    }
+
+    cv::fastNlMeansDenoisingColored( output, output,
+      m_denoise_coeff, m_denoise_coeff,
+      m_denoise_kernel, m_denoise_kernel * 3 );
+  }
+
+  if( m_apply_clahe )
+  {
+    if( output.depth() != CV_8U && output.depth() != CV_32F )
+    {
+      output.convertTo( output, CV_32F );
+    }
+
+    // Only the lightness plane is extracted and written back
+    if( output.channels() == 3 )
+    {
+#if CV_MAJOR_VERSION < 4
+      cv::cvtColor( output, buffers.lab, CV_BGR2Lab );
+#else
+      cv::cvtColor( output, buffers.lab, cv::COLOR_BGR2Lab );
+#endif
+      cv::extractChannel( buffers.lab, buffers.lightness, 0 );
+    }
+    else
+    {
+      buffers.lightness = output;
+    }
+
+    if( output.depth() == CV_32F )
+    {
+      double min, max;
+      cv::minMaxLoc( buffers.lightness, &min, &max );
+      double scale1 = ( max > 0.0 ? 255.0 / ( max - min ) : 1.0 );
+      double shift1 = -( min * scale1 );
+      double scale2 = ( max > 0.0 ?  max / 255.0 : 1.0 );
+      buffers.lightness.convertTo( buffers.lightness_8u, CV_8U, scale1, shift1 );
+      m_clahe->apply( buffers.lightness_8u, buffers.equalized );
+      buffers.equalized.convertTo( buffers.lightness, CV_32F, ( 1.0 / scale2 ) );
+    }
+    else
+    {
+      m_clahe->apply( buffers.lightness, buffers.equalized );
+      buffers.equalized.copyTo( buffers.lightness );
+    }
+
+    if( output.channels() == 3 )
+    {
+      cv::insertChannel( buffers.lightness, buffers.lab, 0 );
+#if CV_MAJOR_VERSION < 4
+      cv::cvtColor( buffers.lab, output, CV_Lab2BGR );
+#else
+      cv::cvtColor( buffers.lab, output, cv::COLOR_Lab2BGR );
+#endif
+    }
+    else
+    {
+      // Do not keep a reference to the returned image in the scratch buffers
+      buffers.lightness.release();
+    }
+  }
+
+  if( m_saturation != 1.0 )
+  {
+    if( output.channels() != 3 )
+    {
+      throw std::runtime_error( "Saturation can only be performed on 3-channel images" );
+    }
+
+    apply_saturation( output, m_saturation, m_saturation_lut, buffers );
+  }
+
+  if( m_apply_sharpening )
+  {
+    cv::GaussianBlur( output, buffers.blurred, cv::Size( 0, 0 ), m_sharpening_kernel );
+    cv::addWeighted( output, 1.0 + m_sharpening_weight, buffers.blurred,
+                     0.0 - m_sharpening_weight, 0, output );
+  }
+
+  return output;
+}
+
 // =================================================================================================
 
 ocv_image_enhancement
@@ -119,6 +386,12 @@ ocv_image_enhancement
   config->set_value( "apply_sharpening", d->m_apply_sharpening, "Apply sharpening to the input" );
   config->set_value( "sharpening_kernel", d->m_sharpening_kernel, "Sharpening kernel size" );
   config->set_value( "sharpening_weight", d->m_sharpening_weight, "Sharpening weight [0.0,1.0]" );
+  config->set_value( "fused", d->m_fused, "Run the enabled stages in a single pass which reuses its "
+    "scratch buffers across frames, only converts to Lab space for CLAHE, and scales saturation "
+    "directly in BGR space. Saturation then matches an HSV scaling without hue quantization." );
+  config->set_value( "use_opencl", d->m_use_opencl, "Upload the input once and run the fused "
+    "stages on OpenCL device images, only downloading the final output. Saturation is then "
+    "scaled in HSV space. Falls back to the host if OpenCL is not available." );
 
   return config;
 }
@@ -145,6 +418,16 @@ ocv_image_enhancement
   d->m_apply_sharpening = config->get_value< bool >( "apply_sharpening" );
   d->m_sharpening_kernel = config->get_value< unsigned >( "sharpening_kernel" );
   d->m_sharpening_weight = config->get_value< double >( "sharpening_weight" );
+  d->m_fused = config->get_value< bool >( "fused" );
+  d->m_use_opencl = config->get_value< bool >( "use_opencl" );
+
+  if( d->m_use_opencl && !cv::ocl::haveOpenCL() )
+  {
+    LOG_WARN( logger(), "OpenCL is not available, running on the host" );
+    d->m_use_opencl = false;
+  }
+
+  d->configure_lookups();
 }
 
 
@@ -166,7 +449,30 @@ ocv_image_enhancement
     arrows::ocv::image_container::vital_to_ocv( image_data->get_image(),
       kwiver::arrows::ocv::image_container::BGR_COLOR );
 
+  if( d->m_use_opencl )
+  {
+    cv::UMat input_device, output_device;
+    cv::Mat output_host;
+    ocv_image_buffer_pool::attach( output_host );
+
+    input_ocv.copyTo( input_device );
+    output_device = d->filter_fused( input_device, d->m_device_buffers );
+    output_device.copyTo( output_host );
+
+    return kwiver::vital::image_container_sptr(
+      new arrows::ocv::image_container( output_host,
+        kwiver::arrows::ocv::image_container::BGR_COLOR ) );
+  }
+
+  if( d->m_fused )
+  {
+    return kwiver::vital::image_container_sptr(
+      new arrows::ocv::image_container( d->filter_fused( input_ocv, d->m_host_buffers ),
+        kwiver::arrows::ocv::image_container::BGR_COLOR ) );
+  }
+
   cv::Mat output_ocv;
+  ocv_image_buffer_pool::attach( output_ocv );
 
   input_ocv.copyTo( output_ocv );
 
@@ -251,9 +557,6 @@ ocv_image_enhancement
     std::vector< cv::Mat > lab_planes( output_ocv.channels() );
     cv::split( lab_image, lab_planes );
 
-    cv::Ptr< cv::CLAHE > clahe = cv::createCLAHE();
-    clahe->setClipLimit( d->m_clip_limit );
-
     if( output_ocv.depth() == CV_32F )
     {
       double min, max;
@@ -263,13 +566,13 @@ ocv_image_enhancement
       double shift1 = -( min * scale1 );
       double scale2 = ( max > 0.0 ?  max / 255.0 : 1.0 );
       lab_planes[0].convertTo( tmp1, CV_8U, scale1, shift1 );
-      clahe->apply( tmp1, tmp2 );
+      d->m_clahe->apply( tmp1, tmp2 );
       tmp2.convertTo( lab_planes[0], CV_32F, ( 1.0 / scale2 ) );
     }
     else
     {
       cv::Mat tmp;
-      clahe->apply( lab_planes[0], tmp );
+      d->m_clahe->apply( lab_planes[0], tmp );
       tmp.copyTo( lab_planes[0] );
     }
 
@@ -302,22 +605,36 @@ ocv_image_enhancement
     cv::cvtColor( output_ocv, hsv_image, cv::COLOR_BGR2HSV );
 #endif
 
-    std::vector< cv::Mat > hsv_channels( 3 );
+    // 8-bit saturation is scaled through the table, without splitting channels
+    if( hsv_image.depth() == CV_8U )
+    {
+      cv::LUT( hsv_image, d->m_saturation_lut, hsv_image );
 
-    cv::split( hsv_image, hsv_channels );
+#if CV_MAJOR_VERSION < 4
+      cv::cvtColor( hsv_image, output_ocv, CV_HSV2BGR );
+#else
+      cv::cvtColor( hsv_image, output_ocv, cv::COLOR_HSV2BGR );
+#endif
+    }
+    else
+    {
+      std::vector< cv::Mat > hsv_channels( 3 );
 
-    cv::Mat hue = hsv_channels[0];
-    cv::Mat sat = hsv_channels[1];
-    cv::Mat val = hsv_channels[2];
+      cv::split( hsv_image, hsv_channels );
 
-    sat *= d->m_saturation;
+      cv::Mat hue = hsv_channels[0];
+      cv::Mat sat = hsv_channels[1];
+      cv::Mat val = hsv_channels[2];
 
-    cv::merge( hsv_channels, output_ocv );
+      sat *= d->m_saturation;
+
+      cv::merge( hsv_channels, output_ocv );
 #if CV_MAJOR_VERSION < 4
-    cv::cvtColor( output_ocv, output_ocv, CV_HSV2BGR );
+      cv::cvtColor( output_ocv, output_ocv, CV_HSV2BGR );
 #else
-    cv::cvtColor( output_ocv, output_ocv, cv::COLOR_HSV2BGR );
+      cv::cvtColor( output_ocv, output_ocv, cv::COLOR_HSV2BGR );
 #endif
+    }
   }
 
   if( d->m_apply_sharpening )
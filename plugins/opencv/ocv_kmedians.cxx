@@ -1,6 +1,11 @@
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <set>
 #include "ocv_kmedians.h"
 
+#include <opencv2/core/utility.hpp>
+
 
 inline bool are_centers_different(const cv::Mat &c1, const cv::Mat &c2, double tol = 1e-9) {
   if (c1.rows != c2.rows || c1.cols != c2.cols)
@@ -16,56 +21,50 @@ inline bool are_centers_different(const cv::Mat &c1, const cv::Mat &c2, double t
 }
 
 inline double manhatan_distance(const cv::Mat &data, const cv::Mat &centers, int i_data, int i_cluster) {
-  double center_dist{};
-  for (int i_feature = 0; i_feature < data.cols; i_feature++)
-    center_dist += std::abs(data.at<float>(i_data, i_feature) - centers.at<float>(i_cluster, i_feature));
-  return center_dist;
-}
-
-inline void update_manhatan_distance(const cv::Mat &data, const cv::Mat &centers, cv::Mat &distance) {
-  for (int i_cluster = 0; i_cluster < distance.cols; i_cluster++) {
-    for (int i_data = 0; i_data < distance.rows; i_data++) {
-      distance.at<float>(i_data, i_cluster) = manhatan_distance(data, centers, i_data, i_cluster);
-    }
-  }
+  return cv::norm(data.row(i_data), centers.row(i_cluster), cv::NORM_L1);
 }
 
-inline void update_labels(const cv::Mat &dist, cv::Mat &_bestLabels) {
-  for (int i_data = 0; i_data < dist.rows; i_data++) {
-    int i_best = 0;
-    double best_dist = std::numeric_limits<float>::max();
-    for (int i_cluster = 0; i_cluster < dist.cols; i_cluster++) {
-      double cluster_dist = dist.at<float>(i_data, i_cluster);
-      if (cluster_dist <= best_dist) {
-        i_best = i_cluster;
-        best_dist = cluster_dist;
+/// @brief Update data to center L1 distances and data labels in parallel over the data rows
+/// @return true if any label changed
+inline bool update_distances_and_labels(const cv::Mat &data, const cv::Mat &centers, cv::Mat &distance,
+                                        cv::Mat &_bestLabels) {
+  std::atomic<bool> is_changed{false};
+  cv::parallel_for_(cv::Range(0, data.rows), [&](const cv::Range &range) {
+    bool is_range_changed{false};
+    for (int i_data = range.start; i_data < range.end; i_data++) {
+      auto *dist_row = distance.ptr<float>(i_data);
+      int i_best = 0;
+      double best_dist = std::numeric_limits<float>::max();
+      for (int i_cluster = 0; i_cluster < centers.rows; i_cluster++) {
+        dist_row[i_cluster] = (float) manhatan_distance(data, centers, i_data, i_cluster);
+        if (dist_row[i_cluster] <= best_dist) {
+          i_best = i_cluster;
+          best_dist = dist_row[i_cluster];
+        }
       }
-    }
-    _bestLabels.at<int>(i_data, 0) = i_best;
-  }
-}
 
+      auto &label = _bestLabels.at<int>(i_data, 0);
+      is_range_changed |= label != i_best;
+      label = i_best;
+    }
 
-// copied from https://www.programmingalgorithms.com/algorithm/median/cpp/
-float median(std::vector<float> data) {
-  sort(data.begin(), data.end());
+    if (is_range_changed)
+      is_changed = true;
+  });
 
-  if (data.size() % 2 == 0)
-    return (data[data.size() / 2 - 1] + data[data.size() / 2]) / 2;
-  else
-    return data[data.size() / 2];
+  return is_changed;
 }
 
-inline float median(const cv::Mat &_data, const std::vector<int> &data_idx, int i_feature) {
-  if (data_idx.empty())
-    return 0;
 
-  std::vector<float> values;
-  for (auto i_data: data_idx) {
-    values.emplace_back(_data.at<float>(i_data, i_feature));
-  }
+// Median using partial selection instead of full sort. Values are reordered.
+inline float median(std::vector<float> &data) {
+  const auto middle = data.begin() + (long) (data.size() / 2);
+  std::nth_element(data.begin(), middle, data.end());
 
-  return median(values);
+  if (data.size() % 2 == 0)
+    return (*std::max_element(data.begin(), middle) + *middle) / 2;
+  else
+    return *middle;
 }
 
 
@@ -77,11 +76,24 @@ inline void update_medians(const cv::Mat &_data, const cv::Mat &_bestLabels, cv:
     center_points[_bestLabels.at<int>(i_data, 0)].push_back(i_data);
   }
 
-  for (int i_cluster = 0; i_cluster < _centers.rows; i_cluster++) {
-    for (int i_feature = 0; i_feature < _centers.cols; i_feature++) {
-      _centers.at<float>(i_cluster, i_feature) = median(_data, center_points[i_cluster], i_feature);
+  // Each cluster / feature median is independent
+  cv::parallel_for_(cv::Range(0, _centers.rows * _centers.cols), [&](const cv::Range &range) {
+    std::vector<float> values;
+    for (int i_median = range.start; i_median < range.end; i_median++) {
+      const int i_cluster = i_median / _centers.cols, i_feature = i_median % _centers.cols;
+      const auto &data_idx = center_points[i_cluster];
+      if (data_idx.empty()) {
+        _centers.at<float>(i_cluster, i_feature) = 0;
+        continue;
+      }
+
+      values.clear();
+      for (auto i_data: data_idx)
+        values.emplace_back(_data.at<float>(i_data, i_feature));
+
+      _centers.at<float>(i_cluster, i_feature) = median(values);
     }
-  }
+  });
 }
 
 inline std::set<int> get_cluster_idx(const cv::Mat &labels) {
@@ -181,15 +193,23 @@ viame::kmedians(const cv::Mat &_data, int K, cv::Mat &_bestLabels, cv::TermCrite
   // Init centers and labels using OCV Kmeans
   cv::kmeans(_data, K, _bestLabels, criteria, attempts, flags, _centers);
 
-  cv::Mat prev_centers(_centers.rows, _centers.cols, CV_32FC1, cv::Scalar(0));
-  cv::Mat dist(_data.rows, _centers.rows, CV_32FC1, cv::Scalar(0));
-  do {
+  // Multi channel points are handled as one feature per channel as in cv::kmeans
+  cv::Mat data = _data.isContinuous() ? _data : _data.clone();
+  data = data.reshape(1, data.rows);
+
+  cv::Mat prev_centers;
+  cv::Mat dist(data.rows, _centers.rows, CV_32FC1, cv::Scalar(0));
+  for (bool is_first_iteration = true;; is_first_iteration = false) {
+    // Centers are the medians of the previous labels. If no label changes, the centers are stable.
+    if (!update_distances_and_labels(data, _centers, dist, _bestLabels) && !is_first_iteration)
+      break;
+
     prev_centers = _centers.clone();
-    update_manhatan_distance(_data, _centers, dist);
-    update_labels(dist, _bestLabels);
-    update_medians(_data, _bestLabels, _centers);
-    make_sure_no_center_is_empty(_data, _bestLabels, _centers);
-  } while (are_centers_different(_centers, prev_centers));
+    update_medians(data, _bestLabels, _centers);
+    make_sure_no_center_is_empty(data, _bestLabels, _centers);
+    if (!are_centers_different(_centers, prev_centers))
+      break;
+  }
 
   return cv::sum(dist)[0];
 }
\ No newline at end of file
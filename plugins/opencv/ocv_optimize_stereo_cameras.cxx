@@ -6,6 +6,8 @@
 #include "ocv_optimize_stereo_cameras.h"
 #include "ocv_stereo_feature_track_filter.h"
 
+#include <plugins/core/thread_pool.h>
+
 #include <vital/types/object_track_set.h>
 #include <vital/types/camera_perspective_map.h>
 #include <vital/types/camera_intrinsics.h>
@@ -39,6 +41,8 @@ public:
   unsigned m_image_height{};
   unsigned m_frame_count_threshold{};
   std::string m_output_calibration_directory{};
+  std::string m_frame_selection_method{"variance"};
+  bool m_parallel_distortion_search{false};
 
   kv::logger_handle_t m_logger;
 
@@ -231,11 +235,54 @@ void ocv_optimize_stereo_cameras::priv::calibrate_camera(const kv::camera_sptr &
                                         "No K1 distortion"};
   std::vector<int> dist_flags{cv::CALIB_ZERO_TANGENT_DIST, cv::CALIB_FIX_K3, cv::CALIB_FIX_K2, cv::CALIB_FIX_K1};
   auto max_error = 1.25 * error;
-  for (size_t i_flag = 0; i_flag < dist_flags.size(); i_flag++) {
-    flags |= dist_flags[i_flag];
-    if (!try_improve_camera_calibration(world_points, image_points, image_size, cv_K1, dist_coeffs, rvec1, tvec1, flags,
-                                        max_error, error, dist_context[i_flag]))
-      break;
+  if (m_parallel_distortion_search) {
+    // Each candidate fixes the distortion parameters up to its index. Candidates don't depend on each other results
+    // as the fixed distortion coefficients are set to 0 without CALIB_USE_INTRINSIC_GUESS.
+    struct Candidate {
+      cv::Mat K, D, R, T;
+      double error{};
+      bool is_improved{};
+    };
+
+    std::vector<Candidate> candidates(dist_flags.size());
+    {
+      viame::thread_pool pool(dist_flags.size());
+      std::vector<std::future<void>> results;
+      auto candidate_flags = flags;
+      for (size_t i_flag = 0; i_flag < dist_flags.size(); i_flag++) {
+        candidate_flags |= dist_flags[i_flag];
+        auto &candidate = candidates[i_flag];
+        candidate.K = cv_K1.clone();
+        candidate.D = dist_coeffs.clone();
+        results.emplace_back(pool.enqueue([&, i_flag, candidate_flags] {
+          candidate.is_improved = try_improve_camera_calibration(
+              world_points, image_points, image_size, candidate.K, candidate.D, candidate.R, candidate.T,
+              candidate_flags, max_error, candidate.error, dist_context[i_flag]);
+        }));
+      }
+
+      for (auto &result: results)
+        result.wait();
+      for (auto &result: results)
+        result.get();
+    }
+
+    // Keep the last candidate of the first improving sequence, as the serial search does
+    for (const auto &candidate: candidates) {
+      if (!candidate.is_improved)
+        break;
+
+      cv_K1 = candidate.K;
+      dist_coeffs = candidate.D;
+      error = candidate.error;
+    }
+  } else {
+    for (size_t i_flag = 0; i_flag < dist_flags.size(); i_flag++) {
+      flags |= dist_flags[i_flag];
+      if (!try_improve_camera_calibration(world_points, image_points, image_size, cv_K1, dist_coeffs, rvec1, tvec1,
+                                          flags, max_error, error, dist_context[i_flag]))
+        break;
+    }
   }
 
   // Push calibration results to perspective camera
@@ -270,7 +317,10 @@ ocv_optimize_stereo_cameras::priv::convert_features_and_landmarks_to_calib_point
     n_frames << feature->all_frame_ids().size() << ",";
 
   LOG_DEBUG(m_logger, "Selecting (" << m_frame_count_threshold << "/" << n_frames.str() << ") frames.");
-  auto points = StereoFeatureTrackFilter::select_frames(features, landmarks, m_frame_count_threshold);
+  auto points = m_frame_selection_method == "coverage" ?
+                StereoFeatureTrackFilter::select_frames_by_coverage(features, landmarks, m_frame_count_threshold,
+                                                                    cv::Size(m_image_width, m_image_height)) :
+                StereoFeatureTrackFilter::select_frames(features, landmarks, m_frame_count_threshold);
   success = !points.image_pts.empty() && !points.image_pts[0].empty() &&
             (points.image_pts[0].size() == points.world_pts.size()) &&
             (points.image_pts[0].size() == points.image_pts[1].size());
@@ -455,6 +505,12 @@ kv::config_block_sptr ocv_optimize_stereo_cameras::get_configuration() const {
                     "max number of frames to use during optimization");
   config->set_value("output_calibration_directory", d_->m_output_calibration_directory,
                     "output path for the generated calibration files");
+  config->set_value("frame_selection_method", d_->m_frame_selection_method,
+                    "method used to select the frames when more than frame_count_threshold frames are available. "
+                    "variance : K-Medians clustering of the frames maximizing the pattern position variance. "
+                    "coverage : incremental selection maximizing the image area covered by the pattern points.");
+  config->set_value("parallel_distortion_search", d_->m_parallel_distortion_search,
+                    "evaluate the distortion parameter candidates of the intrinsic calibration in parallel");
 
   return config;
 }
@@ -468,12 +524,15 @@ void ocv_optimize_stereo_cameras::set_configuration(kv::config_block_sptr config
   d_->m_image_height = config->get_value<double>("image_height");
   d_->m_frame_count_threshold = config->get_value<double>("frame_count_threshold");
   d_->m_output_calibration_directory = config->get_value<std::string>("output_calibration_directory");
+  d_->m_frame_selection_method = config->get_value<std::string>("frame_selection_method");
+  d_->m_parallel_distortion_search = config->get_value<bool>("parallel_distortion_search");
 }
 
 // ----------------------------------------------------------------------------
 // Check that the algorithm's currently configuration is valid
 bool ocv_optimize_stereo_cameras::check_configuration(kv::config_block_sptr config) const {
-  return true;
+  auto method = config->get_value<std::string>("frame_selection_method", "variance");
+  return method == "variance" || method == "coverage";
 }
 
 // ----------------------------------------------------------------------------
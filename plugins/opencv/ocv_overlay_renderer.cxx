@@ -0,0 +1,415 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ocv_overlay_renderer.h"
+#include "ocv_image_buffer_pool.h"
+
+#include <arrows/ocv/image_container.h>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace viame {
+
+using namespace kwiver;
+
+namespace {
+
+// Layers kept for reuse, further layers are allocated and dropped
+const size_t max_cached_layers = 8;
+
+// -----------------------------------------------------------------------------------------------
+// Label text on a band of its class colour, in both output formats
+struct glyph
+{
+  cv::Mat bgr;
+  cv::Mat bgra;
+};
+
+// -----------------------------------------------------------------------------------------------
+// Transparent overlay and the regions drawn on it since it was last cleared
+struct overlay_layer
+{
+  cv::Mat image;
+  std::vector< cv::Rect > dirty;
+};
+
+} // end anonymous namespace
+
+// -----------------------------------------------------------------------------------------------
+class ocv_overlay_renderer::priv
+{
+public:
+  priv()
+    : m_line_thickness( 2 )
+    , m_text_scale( 0.5 )
+    , m_text_thickness( 1 )
+    , m_draw_text( true )
+    , m_draw_scores( true )
+    , m_draw_polygons( true )
+    , m_threshold( 0.0 )
+    , m_output_layer( false )
+    , m_glyph_cache_size( 1024 )
+  {}
+
+  // Configuration settings
+  int m_line_thickness;
+  double m_text_scale;
+  int m_text_thickness;
+  bool m_draw_text;
+  bool m_draw_scores;
+  bool m_draw_polygons;
+  double m_threshold;
+  bool m_output_layer;
+  unsigned m_glyph_cache_size;
+
+  // Internal variables
+  std::unordered_map< std::string, cv::Scalar > m_colors;
+  std::unordered_map< std::string, glyph > m_glyphs;
+  std::vector< overlay_layer > m_layers;
+
+  cv::Scalar const& color( std::string const& label );
+  glyph const& label_glyph( std::string const& text, std::string const& label );
+  overlay_layer& acquire_layer( cv::Size const& size );
+};
+
+
+// -----------------------------------------------------------------------------------------------
+// Stable colour of a class, spread over hues by hashing its name
+cv::Scalar const&
+ocv_overlay_renderer::priv
+::color( std::string const& label )
+{
+  auto it = m_colors.find( label );
+
+  if( it == m_colors.end() )
+  {
+    cv::Mat hsv( 1, 1, CV_8UC3,
+      cv::Scalar( std::hash< std::string >()( label ) % 180, 220, 255 ) ), bgr;
+    cv::cvtColor( hsv, bgr, cv::COLOR_HSV2BGR );
+
+    const cv::Vec3b value = bgr.at< cv::Vec3b >( 0, 0 );
+    it = m_colors.emplace( label, cv::Scalar( value[0], value[1], value[2], 255 ) ).first;
+  }
+
+  return it->second;
+}
+
+
+// -----------------------------------------------------------------------------------------------
+glyph const&
+ocv_overlay_renderer::priv
+::label_glyph( std::string const& text, std::string const& label )
+{
+  const std::string key = label + '\n' + text;
+  auto it = m_glyphs.find( key );
+
+  if( it != m_glyphs.end() )
+  {
+    return it->second;
+  }
+
+  // Scores make labels vary, so the cache is bounded by starting over
+  if( m_glyphs.size() >= m_glyph_cache_size )
+  {
+    m_glyphs.clear();
+  }
+
+  int baseline = 0;
+  const cv::Size text_size = cv::getTextSize( text, cv::FONT_HERSHEY_SIMPLEX,
+    m_text_scale, m_text_thickness, &baseline );
+
+  glyph output;
+  output.bgr = cv::Mat( text_size.height + baseline + 4, text_size.width + 4,
+                        CV_8UC3, color( label ) );
+
+  cv::putText( output.bgr, text, cv::Point( 2, text_size.height + 2 ),
+    cv::FONT_HERSHEY_SIMPLEX, m_text_scale, cv::Scalar( 0, 0, 0 ),
+    m_text_thickness, cv::LINE_AA );
+
+  cv::cvtColor( output.bgr, output.bgra, cv::COLOR_BGR2BGRA );
+
+  return m_glyphs.emplace( key, std::move( output ) ).first->second;
+}
+
+
+// -----------------------------------------------------------------------------------------------
+// A layer no longer referenced downstream is cleared where it was drawn and
+// reused, otherwise a new transparent layer is allocated
+overlay_layer&
+ocv_overlay_renderer::priv
+::acquire_layer( cv::Size const& size )
+{
+  for( auto& layer : m_layers )
+  {
+    if( layer.image.size() == size && layer.image.u && layer.image.u->refcount == 1 )
+    {
+      for( auto const& rect : layer.dirty )
+      {
+        layer.image( rect ).setTo( cv::Scalar::all( 0 ) );
+      }
+      layer.dirty.clear();
+      return layer;
+    }
+  }
+
+  overlay_layer layer;
+  layer.image = cv::Mat::zeros( size, CV_8UC4 );
+
+  if( m_layers.size() >= max_cached_layers )
+  {
+    // Every cached layer is still in use, replace the oldest one
+    m_layers.erase( m_layers.begin() );
+  }
+
+  m_layers.push_back( std::move( layer ) );
+  return m_layers.back();
+}
+
+
+// ===============================================================================================
+ocv_overlay_renderer
+::ocv_overlay_renderer()
+  : d( new priv )
+{
+  attach_logger( "viame.opencv.ocv_overlay_renderer" );
+}
+
+
+ocv_overlay_renderer
+::~ocv_overlay_renderer()
+{
+}
+
+
+// -----------------------------------------------------------------------------------------------
+vital::config_block_sptr
+ocv_overlay_renderer
+::get_configuration() const
+{
+  vital::config_block_sptr config = vital::algorithm::get_configuration();
+
+  config->set_value( "line_thickness", d->m_line_thickness,
+    "Thickness of box and polygon outlines in pixels" );
+  config->set_value( "text_scale", d->m_text_scale,
+    "Scale of label text" );
+  config->set_value( "text_thickness", d->m_text_thickness,
+    "Stroke thickness of label text" );
+  config->set_value( "draw_text", d->m_draw_text,
+    "Draw the most likely class above each detection" );
+  config->set_value( "draw_scores", d->m_draw_scores,
+    "Follow class labels with their score" );
+  config->set_value( "draw_polygons", d->m_draw_polygons,
+    "Outline detection masks in addition to their boxes" );
+  config->set_value( "threshold", d->m_threshold,
+    "Detections with a lower confidence are not drawn" );
+  config->set_value( "output_layer", d->m_output_layer,
+    "Output a transparent BGRA overlay of the frame size instead of the "
+    "annotated frame, for compositing when encoding video" );
+  config->set_value( "glyph_cache_size", d->m_glyph_cache_size,
+    "Number of rendered labels kept for reuse" );
+
+  return config;
+}
+
+
+// -----------------------------------------------------------------------------------------------
+void
+ocv_overlay_renderer
+::set_configuration( vital::config_block_sptr in_config )
+{
+  vital::config_block_sptr config = this->get_configuration();
+  config->merge_config( in_config );
+
+  d->m_line_thickness = config->get_value< int >( "line_thickness" );
+  d->m_text_scale = config->get_value< double >( "text_scale" );
+  d->m_text_thickness = config->get_value< int >( "text_thickness" );
+  d->m_draw_text = config->get_value< bool >( "draw_text" );
+  d->m_draw_scores = config->get_value< bool >( "draw_scores" );
+  d->m_draw_polygons = config->get_value< bool >( "draw_polygons" );
+  d->m_threshold = config->get_value< double >( "threshold" );
+  d->m_output_layer = config->get_value< bool >( "output_layer" );
+  d->m_glyph_cache_size = std::max( 1u, config->get_value< unsigned >( "glyph_cache_size" ) );
+
+  d->m_glyphs.clear();
+  d->m_layers.clear();
+}
+
+
+// -----------------------------------------------------------------------------------------------
+bool
+ocv_overlay_renderer
+::check_configuration( vital::config_block_sptr config ) const
+{
+  return config->get_value< int >( "line_thickness", d->m_line_thickness ) > 0 &&
+         config->get_value< double >( "text_scale", d->m_text_scale ) > 0.0;
+}
+
+
+// -----------------------------------------------------------------------------------------------
+vital::image_container_sptr
+ocv_overlay_renderer
+::draw( vital::detected_object_set_sptr detected_set,
+        vital::image_container_sptr image )
+{
+  using ic = arrows::ocv::image_container;
+
+  if( !image )
+  {
+    return image;
+  }
+
+  const cv::Mat input = ic::vital_to_ocv( image->get_image(), ic::BGR_COLOR );
+
+  cv::Mat output;
+  overlay_layer* layer = nullptr;
+
+  if( d->m_output_layer )
+  {
+    layer = &d->acquire_layer( input.size() );
+    output = layer->image;
+  }
+  else
+  {
+    ocv_image_buffer_pool::attach( output );
+
+    if( input.channels() == 1 )
+    {
+      cv::cvtColor( input, output, cv::COLOR_GRAY2BGR );
+    }
+    else
+    {
+      input.copyTo( output );
+    }
+  }
+
+  const cv::Rect bounds( 0, 0, output.cols, output.rows );
+  const int pad = d->m_line_thickness;
+
+  if( !detected_set )
+  {
+    detected_set = std::make_shared< vital::detected_object_set >();
+  }
+
+  for( auto det : *detected_set )
+  {
+    if( det->confidence() < d->m_threshold )
+    {
+      continue;
+    }
+
+    std::string label = "detection";
+    double score = det->confidence();
+
+    if( det->type() )
+    {
+      det->type()->get_most_likely( label, score );
+    }
+
+    const cv::Scalar& color = d->color( label );
+    const vital::bounding_box_d box = det->bounding_box();
+
+    const cv::Rect rect( cv::Point( static_cast< int >( box.min_x() ),
+                                    static_cast< int >( box.min_y() ) ),
+                         cv::Point( static_cast< int >( box.max_x() ),
+                                    static_cast< int >( box.max_y() ) ) );
+
+    cv::Rect dirty = rect;
+
+    cv::rectangle( output, rect, color, d->m_line_thickness );
+
+    if( d->m_draw_polygons && det->mask() )
+    {
+      cv::Mat mask = ic::vital_to_ocv( det->mask()->get_image(), ic::OTHER_COLOR ).clone();
+      std::vector< std::vector< cv::Point > > contours;
+
+      cv::findContours( mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE,
+                        rect.tl() );
+      cv::polylines( output, contours, true, color, d->m_line_thickness );
+
+      for( auto const& contour : contours )
+      {
+        dirty |= cv::boundingRect( contour );
+      }
+    }
+
+    if( d->m_draw_text )
+    {
+      std::string text = label;
+
+      if( d->m_draw_scores )
+      {
+        char buffer[ 16 ];
+        std::snprintf( buffer, sizeof( buffer ), " %.2f", score );
+        text += buffer;
+      }
+
+      const glyph& g = d->label_glyph( text, label );
+      cv::Mat const& patch = ( d->m_output_layer ? g.bgra : g.bgr );
+
+      if( patch.cols <= output.cols && patch.rows <= output.rows )
+      {
+        // Above the box when there is room, otherwise inside it
+        const int x = std::min( std::max( rect.x, 0 ), output.cols - patch.cols );
+        int y = rect.y - patch.rows;
+
+        if( y < 0 )
+        {
+          y = std::min( std::max( rect.y, 0 ), output.rows - patch.rows );
+        }
+
+        const cv::Rect text_rect( x, y, patch.cols, patch.rows );
+        patch.copyTo( output( text_rect ) );
+        dirty |= text_rect;
+      }
+    }
+
+    if( layer )
+    {
+      dirty = cv::Rect( dirty.x - pad, dirty.y - pad,
+                        dirty.width + 2 * pad + 1, dirty.height + 2 * pad + 1 ) & bounds;
+
+      if( dirty.area() > 0 )
+      {
+        layer->dirty.push_back( dirty );
+      }
+    }
+  }
+
+  return std::make_shared< ic >( output, ic::BGR_COLOR );
+}
+
+} // end namespace
@@ -0,0 +1,80 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIAME_OCV_OVERLAY_RENDERER_H
+#define VIAME_OCV_OVERLAY_RENDERER_H
+
+#include <plugins/opencv/viame_opencv_export.h>
+
+#include <vital/algo/draw_detected_object_set.h>
+
+#include <memory>
+
+namespace viame {
+
+/// Detection overlay drawing for annotated review imagery and videos
+///
+/// Labels are rendered once per distinct text and colour and then copied in
+/// place, the frame copy is drawn into pooled buffers, and only the area
+/// around each detection is touched. With output_layer set a transparent
+/// BGRA overlay is produced instead of an annotated frame, for compositing
+/// at video encoding time; layers are recycled once released downstream,
+/// clearing only the regions drawn on them before.
+class VIAME_OPENCV_EXPORT ocv_overlay_renderer
+  : public kwiver::vital::algo::draw_detected_object_set
+{
+public:
+  PLUGIN_INFO( "ocv_overlay",
+               "Draw detection boxes, polygons and labels with cached glyphs, "
+               "onto frames or into a separate transparent layer" )
+
+  ocv_overlay_renderer();
+  virtual ~ocv_overlay_renderer();
+
+  // Get the current configuration (parameters) for this renderer
+  virtual kwiver::vital::config_block_sptr get_configuration() const;
+
+  // Set configurations automatically parsed from input pipeline and config files
+  virtual void set_configuration( kwiver::vital::config_block_sptr config );
+  virtual bool check_configuration( kwiver::vital::config_block_sptr config ) const;
+
+  // Main drawing method
+  virtual kwiver::vital::image_container_sptr draw(
+    kwiver::vital::detected_object_set_sptr detected_set,
+    kwiver::vital::image_container_sptr image );
+
+private:
+  class priv;
+  const std::unique_ptr< priv > d;
+};
+
+} // end namespace
+
+#endif /* VIAME_OCV_OVERLAY_RENDERER_H */
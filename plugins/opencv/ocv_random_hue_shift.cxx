@@ -29,18 +29,105 @@
  */
 
 #include "ocv_random_hue_shift.h"
+#include "ocv_image_buffer_pool.h"
 
+#include <opencv2/core/ocl.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/photo/photo.hpp>
 
 #include <arrows/ocv/image_container.h>
 
+#include <algorithm>
 #include <cmath>
+#include <random>
 
 namespace viame {
 
 using namespace kwiver;
 
+// -------------------------------------------------------------------------------------------------
+// Apply the HSV and optional BGR lookup tables, for host or OpenCL images
+template < typename MAT >
+void
+shift_colors( const MAT& input, MAT& output, const cv::Mat& hsv_lut, const cv::Mat& rgb_lut )
+{
+  MAT hsv_image;
+
+#if CV_MAJOR_VERSION < 4
+  cv::cvtColor( input, hsv_image, CV_BGR2HSV );
+#else
+  cv::cvtColor( input, hsv_image, cv::COLOR_BGR2HSV );
+#endif
+
+  cv::LUT( hsv_image, hsv_lut, hsv_image );
+
+#if CV_MAJOR_VERSION < 4
+  cv::cvtColor( hsv_image, output, CV_HSV2BGR );
+#else
+  cv::cvtColor( hsv_image, output, cv::COLOR_HSV2BGR );
+#endif
+
+  if( !rgb_lut.empty() )
+  {
+    cv::LUT( output, rgb_lut, output );
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+// Apply an affine color transform in a single pass, for host or OpenCL images
+template < typename MAT >
+void
+transform_colors( const MAT& input, MAT& output, const cv::Matx34f& transform )
+{
+  cv::transform( input, output, transform );
+}
+
+// -------------------------------------------------------------------------------------------------
+// BGR affine transform approximating the HSV shifts, hue in OpenCV units of 2 degrees
+static cv::Matx34f
+hsv_shift_transform( double hue_shift, double sat_shift, double int_shift,
+                     const cv::Vec3d& channel_shift, double max_value )
+{
+  // Rotation around the gray axis in RGB, using the Rec. 709 luma weights
+  const double angle = hue_shift * 2.0 * CV_PI / 180.0;
+  const double c = std::cos( angle );
+  const double s = std::sin( angle );
+
+  const cv::Matx33d rotation(
+    0.213 + c * 0.787 - s * 0.213, 0.715 - c * 0.715 - s * 0.715, 0.072 - c * 0.072 + s * 0.928,
+    0.213 - c * 0.213 + s * 0.143, 0.715 + c * 0.285 + s * 0.140, 0.072 - c * 0.072 - s * 0.283,
+    0.213 - c * 0.213 - s * 0.787, 0.715 - c * 0.715 + s * 0.715, 0.072 + c * 0.928 + s * 0.072 );
+
+  // Additive saturation shifts become a scaling around gray
+  const double f = std::max( 0.0, 1.0 + sat_shift / 255.0 );
+
+  const cv::Matx33d saturation(
+    0.213 + 0.787 * f, 0.715 - 0.715 * f, 0.072 - 0.072 * f,
+    0.213 - 0.213 * f, 0.715 + 0.285 * f, 0.072 - 0.072 * f,
+    0.213 - 0.213 * f, 0.715 - 0.715 * f, 0.072 + 0.928 * f );
+
+  // Reverse the channel order, the images are BGR
+  const cv::Matx33d flip( 0, 0, 1, 0, 1, 0, 1, 0, 0 );
+  const cv::Matx33d rgb = flip * saturation * rotation * flip;
+
+  // Offsets are given for 8-bit data
+  const double offset_scale = max_value / 255.0;
+
+  cv::Matx34f transform;
+
+  for( int r = 0; r < 3; ++r )
+  {
+    for( int col = 0; col < 3; ++col )
+    {
+      transform( r, col ) = static_cast< float >( rgb( r, col ) );
+    }
+
+    transform( r, 3 ) = static_cast< float >( ( int_shift + channel_shift[ r ] ) * offset_scale );
+  }
+
+  return transform;
+}
+
 // -----------------------------------------------------------------------------------------------
 /**
  * @brief Storage class for private member variables
@@ -55,6 +142,10 @@ public:
     , m_sat_range( 0.0 )
     , m_int_range( 0.0 )
     , m_rgb_shift_range( 0.0 )
+    , m_use_opencl( false )
+    , m_rgb_space( false )
+    , m_random_seed( -1 )
+    , m_sample_count( 0 )
   {}
 
   ~priv() {}
@@ -66,6 +157,18 @@ public:
   double m_int_range;
 
   double m_rgb_shift_range;
+
+  bool m_use_opencl;
+  bool m_rgb_space;
+
+  int m_random_seed;
+
+  // Number of filtered samples, used to seed each one when a seed is set
+  unsigned long long m_sample_count;
+
+  // Device buffers reused across frames in OpenCL mode
+  cv::UMat m_input_device;
+  cv::UMat m_output_device;
 };
 
 // =================================================================================================
@@ -100,6 +203,15 @@ ocv_random_hue_shift
 
   config->set_value( "rgb_shift_range", d->m_rgb_shift_range, "Random color shift range" );
 
+  config->set_value( "use_opencl", d->m_use_opencl, "Upload the input once and run the color "
+    "shifts with OpenCL kernels. Falls back to the host if OpenCL is not available." );
+  config->set_value( "rgb_space", d->m_rgb_space, "Apply the shifts directly in RGB space as "
+    "one 3x4 affine color transform approximating the HSV shifts, instead of converting to "
+    "HSV and back. Also supports non 8-bit images." );
+  config->set_value( "random_seed", d->m_random_seed, "If non-negative, each sample draws its "
+    "shifts from a generator seeded with this value and the sample index, making augmentations "
+    "reproducible. Otherwise the global rand() generator is used." );
+
   return config;
 }
 
@@ -119,6 +231,17 @@ ocv_random_hue_shift
   d->m_int_range = config->get_value< double >( "int_range" );
 
   d->m_rgb_shift_range = config->get_value< double >( "rgb_shift_range" );
+
+  d->m_use_opencl = config->get_value< bool >( "use_opencl" );
+  d->m_rgb_space = config->get_value< bool >( "rgb_space" );
+  d->m_random_seed = config->get_value< int >( "random_seed" );
+  d->m_sample_count = 0;
+
+  if( d->m_use_opencl && !cv::ocl::haveOpenCL() )
+  {
+    LOG_WARN( logger(), "OpenCL is not available, running on the host" );
+    d->m_use_opencl = false;
+  }
 }
 
 
@@ -136,7 +259,26 @@ kwiver::vital::image_container_sptr
 ocv_random_hue_shift
 ::filter( kwiver::vital::image_container_sptr image_data )
 {
-  if( rand() / ( RAND_MAX + 1.0 ) >= d->m_trigger_percent )
+  // Uniform draws in [0, 1), from a per-sample generator when seeded
+  std::mt19937 generator;
+  std::uniform_real_distribution< double > distribution( 0.0, 1.0 );
+
+  if( d->m_random_seed >= 0 )
+  {
+    std::seed_seq seed{ static_cast< unsigned >( d->m_random_seed ),
+                        static_cast< unsigned >( d->m_sample_count ),
+                        static_cast< unsigned >( d->m_sample_count >> 32 ) };
+    generator.seed( seed );
+  }
+
+  d->m_sample_count++;
+
+  auto draw = [&]()
+  {
+    return d->m_random_seed >= 0 ? distribution( generator ) : rand() / ( RAND_MAX + 1.0 );
+  };
+
+  if( draw() >= d->m_trigger_percent )
   {
     return image_data;
   }
@@ -145,119 +287,116 @@ ocv_random_hue_shift
     arrows::ocv::image_container::vital_to_ocv( image_data->get_image(),
       kwiver::arrows::ocv::image_container::BGR_COLOR );
 
-  // Shift Hue
-  cv::Mat hsv_image, output_ocv;
+  double hue_shift = d->m_hue_range * draw() - ( d->m_hue_range / 2.0 );
+  double sat_shift = 0.0;
+  double int_shift = 0.0;
+  cv::Vec3d channel_shift( 0.0, 0.0, 0.0 );
 
-#if CV_MAJOR_VERSION < 4
-  cv::cvtColor( input_ocv, hsv_image, CV_BGR2HSV );
-#else
-  cv::cvtColor( input_ocv, hsv_image, cv::COLOR_BGR2HSV );
-#endif
+  if( d->m_sat_range )
+  {
+    sat_shift = d->m_sat_range * draw() - ( d->m_sat_range / 2.0 );
+  }
 
-  double hue_shift = d->m_hue_range * ( rand() / ( RAND_MAX + 1.0 ) ) - ( d->m_hue_range / 2.0 );
+  if( d->m_int_range )
+  {
+    int_shift = d->m_int_range * draw() - ( d->m_int_range / 2.0 );
+  }
 
-  for( auto i = 0; i < input_ocv.cols; ++i )
+  if( d->m_rgb_shift_range )
   {
-    for( auto j = 0; j < input_ocv.rows; ++j )
+    for( int c = 0; c < 3; ++c )
     {
-      double new_value = hue_shift + hsv_image.at<cv::Vec3b>(j,i)[0];
-
-      if( new_value > 180 )
-      {
-        hsv_image.at<cv::Vec3b>(j,i)[0] = new_value - 180;
-      }
-      else if( new_value < 0 )
-      {
-        hsv_image.at<cv::Vec3b>(j,i)[0] = new_value + 180;
-      }
-      else
-      {
-        hsv_image.at<cv::Vec3b>(j,i)[0] = new_value;
-      }
+      channel_shift[ c ] = d->m_rgb_shift_range * draw() - ( d->m_rgb_shift_range / 2.0 );
     }
   }
 
-  if( d->m_sat_range )
+  cv::Mat output_ocv;
+  ocv_image_buffer_pool::attach( output_ocv );
+
+  if( d->m_rgb_space && input_ocv.channels() == 3 )
   {
-    double sat_shift = d->m_sat_range * ( rand() / ( RAND_MAX + 1.0 ) ) - ( d->m_sat_range / 2.0 );
+    double max_value = 255.0;
 
-    for( auto i = 0; i < input_ocv.cols; ++i )
+    switch( input_ocv.depth() )
     {
-      for( auto j = 0; j < input_ocv.rows; ++j )
-      {
-        double new_value = sat_shift + hsv_image.at<cv::Vec3b>(j,i)[1];
-
-        if( new_value > 255.0 )
-        {
-          hsv_image.at<cv::Vec3b>(j,i)[1] = 255;
-        }
-        else if( new_value < 0.0 )
-        {
-          hsv_image.at<cv::Vec3b>(j,i)[1] = 0;
-        }
-        else
-        {
-          hsv_image.at<cv::Vec3b>(j,i)[1] = new_value;
-        }
-      }
+      case CV_16U: max_value = 65535.0; break;
+      case CV_16S: max_value = 32767.0; break;
+      case CV_32F:
+      case CV_64F: max_value = 1.0; break;
+      default: break;
     }
+
+    const cv::Matx34f transform =
+      hsv_shift_transform( hue_shift, sat_shift, int_shift, channel_shift, max_value );
+
+    if( d->m_use_opencl )
+    {
+      input_ocv.copyTo( d->m_input_device );
+      transform_colors( d->m_input_device, d->m_output_device, transform );
+      d->m_output_device.copyTo( output_ocv );
+    }
+    else
+    {
+      transform_colors( input_ocv, output_ocv, transform );
+    }
+
+    return kwiver::vital::image_container_sptr(
+      new arrows::ocv::image_container( output_ocv,
+        kwiver::arrows::ocv::image_container::BGR_COLOR ) );
   }
 
-  if( d->m_int_range )
+  // Every adjustment maps each 8-bit channel value independently, so they are
+  // applied through lookup tables, which also run as OpenCL kernels
+  cv::Mat hsv_lut( 1, 256, CV_8UC3 );
+  cv::Mat rgb_lut;
+
+  // Shifted values are truncated, hue wraps around and the other channels saturate
+  auto shift_value = []( double value )
   {
-    double int_shift = d->m_int_range * ( rand() / ( RAND_MAX + 1.0 ) ) - ( d->m_int_range / 2.0 );
+    return static_cast< uchar >( std::max( std::min( value, 255.0 ), 0.0 ) );
+  };
 
-    for( auto i = 0; i < input_ocv.cols; ++i )
+  for( int i = 0; i < 256; ++i )
+  {
+    double new_hue = hue_shift + i;
+
+    if( new_hue > 180 )
     {
-      for( auto j = 0; j < input_ocv.rows; ++j )
-      {
-        double new_value = int_shift + hsv_image.at<cv::Vec3b>(j,i)[2];
-
-        if( new_value > 255.0 )
-        {
-          hsv_image.at<cv::Vec3b>(j,i)[2] = 255;
-        }
-        else if( new_value < 0.0 )
-        {
-          hsv_image.at<cv::Vec3b>(j,i)[2] = 0;
-        }
-        else
-        {
-          hsv_image.at<cv::Vec3b>(j,i)[2] = new_value;
-        }
-      }
+      new_hue -= 180;
+    }
+    else if( new_hue < 0 )
+    {
+      new_hue += 180;
     }
-  }
 
-#if CV_MAJOR_VERSION < 4
-  cv::cvtColor( hsv_image, output_ocv, CV_HSV2BGR );
-#else
-  cv::cvtColor( hsv_image, output_ocv, cv::COLOR_HSV2BGR );
-#endif
+    hsv_lut.at< cv::Vec3b >( i ) = cv::Vec3b(
+      shift_value( new_hue ), shift_value( sat_shift + i ), shift_value( int_shift + i ) );
+  }
 
   if( d->m_rgb_shift_range )
   {
-    double r_shift = d->m_rgb_shift_range * ( rand() / ( RAND_MAX + 1.0 ) )
-                       - ( d->m_rgb_shift_range / 2.0 );
-    double g_shift = d->m_rgb_shift_range * ( rand() / ( RAND_MAX + 1.0 ) )
-                       - ( d->m_rgb_shift_range / 2.0 );
-    double b_shift = d->m_rgb_shift_range * ( rand() / ( RAND_MAX + 1.0 ) )
-                       - ( d->m_rgb_shift_range / 2.0 );
-
-    for( auto i = 0; i < output_ocv.cols; ++i )
+    rgb_lut.create( 1, 256, CV_8UC3 );
+
+    for( int i = 0; i < 256; ++i )
     {
-      for( auto j = 0; j < output_ocv.rows; ++j )
-      {
-        output_ocv.at<cv::Vec3b>(j,i)[0] =
-          std::max( std::min( r_shift + output_ocv.at<cv::Vec3b>(j,i)[0], 255.0 ), 0.0 );
-        output_ocv.at<cv::Vec3b>(j,i)[1] =
-          std::max( std::min( g_shift + output_ocv.at<cv::Vec3b>(j,i)[1], 255.0 ), 0.0 );
-        output_ocv.at<cv::Vec3b>(j,i)[2] =
-          std::max( std::min( b_shift + output_ocv.at<cv::Vec3b>(j,i)[2], 255.0 ), 0.0 );
-      }
+      rgb_lut.at< cv::Vec3b >( i ) = cv::Vec3b( shift_value( channel_shift[ 0 ] + i ),
+        shift_value( channel_shift[ 1 ] + i ), shift_value( channel_shift[ 2 ] + i ) );
     }
   }
 
+  // Shift Hue
+
+  if( d->m_use_opencl )
+  {
+    input_ocv.copyTo( d->m_input_device );
+    shift_colors( d->m_input_device, d->m_output_device, hsv_lut, rgb_lut );
+    d->m_output_device.copyTo( output_ocv );
+  }
+  else
+  {
+    shift_colors( input_ocv, output_ocv, hsv_lut, rgb_lut );
+  }
+
   kwiver::vital::image_container_sptr output(
     new arrows::ocv::image_container( output_ocv,
       kwiver::arrows::ocv::image_container::BGR_COLOR ) );
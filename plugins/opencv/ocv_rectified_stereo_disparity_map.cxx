@@ -17,14 +17,58 @@
 #include <arrows/ocv/camera_intrinsics.h>
 #include <arrows/ocv/image_container.h>
 
+#ifdef VIAME_OPENCV_CUDA
+#include <opencv2/core/cuda.hpp>
+#include <opencv2/cudaimgproc.hpp>
+#include <opencv2/cudastereo.hpp>
+#include <opencv2/cudawarping.hpp>
+#endif
+
+#include <plugins/core/thread_pool.h>
+
+#include <kwiversys/SystemTools.hxx>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+
 namespace kv = kwiver::vital;
 
 namespace viame {
 
+namespace {
+
+// Header written in front of the raw map data of a rectification cache file
+struct rectification_cache_header
+{
+  char magic[4];
+  uint32_t version;
+  uint64_t key;
+  int32_t width;
+  int32_t height;
+};
+
+const char rectification_cache_magic[4] = { 'V', 'R', 'M', 'C' };
+const uint32_t rectification_cache_version = 1;
+
+// Disparity in pixels times this scale gives the fixed-point output values,
+// which is the 4 fractional bits format of the OpenCV matchers
+const double fixed_point_disparity_scale = 16.0;
+
+} // end anonymous namespace
+
 class ocv_rectified_stereo_disparity_map::priv
 {
 public:
   std::string algorithm;
+  std::string backend;
   int min_disparity;
   int num_disparities;
   int sad_window_size;
@@ -36,7 +80,13 @@ public:
   bool m_use_filtered_disparity{};
   bool m_set_disparity_as_alpha_chanel{};
   bool m_invert_disparity_alpha_chanel{};
+  bool m_parallel_matching{};
+  bool m_output_fixed_point_disparity{};
+  int m_temporal_refresh_interval{};
+  int m_temporal_margin{ 8 };
+  double m_temporal_outlier_ratio{ 0.005 };
   std::string m_cameras_directory;
+  std::string m_rectification_cache_directory;
 
   // intermediate variables
   cv::Mat M1, M2, P1, P2, Q, R1, R2, R, T, D1, D2;
@@ -45,14 +95,46 @@ public:
   cv::Mat m_rectification_map21;
   cv::Mat m_rectification_map22;
 
+  // Read-only mapping of a cache file, owns the data of the maps above when set
+  std::unique_ptr< boost::interprocess::mapped_region > m_rectification_cache_region;
+
   kv::logger_handle_t m_logger;
 
   cv::Ptr< cv::StereoMatcher > left_matcher;
   cv::Ptr< cv::StereoMatcher > right_matcher;
   cv::Ptr< cv::ximgproc::DisparityWLSFilter > disparity_filter;
 
+  // Runs left and right remaps and matchers concurrently when enabled
+  std::unique_ptr< thread_pool > m_matching_pool;
+
+  // Rectified images of the current frame, in buffers reused between frames
+  ocv_stereo_rectification m_rectification;
+
+  // Temporal search range state. The full range is the configured matcher
+  // range, the search range is the one used for the current frame.
+  int m_full_min_disparity{};
+  int m_full_num_disparities{};
+  int m_search_min_disparity{};
+  int m_search_num_disparities{};
+  unsigned m_temporal_frame_index{};
+  std::vector< size_t > m_disparity_histogram;
+
+#ifdef VIAME_OPENCV_CUDA
+  // Device side matcher, filter and rectification maps for the cuda backend
+  cv::Ptr< cv::StereoMatcher > cuda_matcher;
+  cv::Ptr< cv::cuda::DisparityBilateralFilter > cuda_filter;
+  double cuda_disparity_scale{ 1.0 };
+
+  cv::cuda::GpuMat d_map1x, d_map1y, d_map2x, d_map2y;
+  cv::cuda::GpuMat d_left, d_right, d_left_gray, d_right_gray;
+  cv::cuda::GpuMat d_left_rect, d_right_rect;
+  cv::cuda::GpuMat d_disparity, d_filtered, d_disparity_float;
+  cv::cuda::Stream cuda_stream;
+#endif
+
   priv()
     : algorithm( "BM" )
+    , backend( "cpu" )
     , min_disparity( 0 )
     , num_disparities( 16 )
     , sad_window_size( 21 )
@@ -61,6 +143,7 @@ public:
     , speckle_range( 5 )
     , m_computed_rectification(false)
     , m_cameras_directory( "" )
+    , m_rectification_cache_directory( "" )
   {}
 
   ~priv()
@@ -103,6 +186,600 @@ public:
       VITAL_THROW( kv::invalid_data, "Calibration file not found : " + std::string(e.what()) );
     }
   }
+
+  // Drop current maps, including any which reference a mapped cache file
+  void
+  reset_rectification_maps()
+  {
+    m_rectification_map11.release();
+    m_rectification_map12.release();
+    m_rectification_map21.release();
+    m_rectification_map22.release();
+    m_rectification_cache_region.reset();
+    m_computed_rectification = false;
+
+#ifdef VIAME_OPENCV_CUDA
+    d_map1x.release();
+    d_map1y.release();
+    d_map2x.release();
+    d_map2y.release();
+#endif
+  }
+
+  // Rectify, match and optionally WLS filter on the host, restricted to the
+  // given range of rectified rows
+  cv::Mat
+  compute_disparity_cpu( const cv::Mat& left, const cv::Mat& right, const cv::Range& rows )
+  {
+    const bool filtered = m_use_filtered_disparity && right_matcher && disparity_filter;
+
+    // Both remaps are needed by both matchers, so they are done before matching
+    m_rectification.rectify( left, right, rows, m_matching_pool.get() );
+    const cv::Mat& img1r = m_rectification.left();
+    const cv::Mat& img2r = m_rectification.right();
+
+    cv::Mat left_disparity_map, right_disparity_map;
+
+    auto match_left = [&]
+    {
+      left_matcher->compute(img1r, img2r, left_disparity_map);
+      update_temporal_statistics( left_disparity_map );
+    };
+
+    if( m_matching_pool )
+    {
+      std::future< void > right_match;
+
+      if( filtered )
+      {
+        right_match = m_matching_pool->enqueue( [&]{
+          right_matcher->compute(img2r, img1r, right_disparity_map); } );
+      }
+
+      match_left();
+
+      if( right_match.valid() )
+      {
+        right_match.get();
+      }
+    }
+    else
+    {
+      // compute disparity map
+      match_left();
+
+      if( filtered )
+      {
+        right_matcher->compute(img2r, img1r, right_disparity_map);
+      }
+    }
+
+    // Filter disparity map
+    if (filtered) {
+      auto roi = cv::Rect();
+      cv::Mat left_filtered_disparity;
+      disparity_filter->filter(left_disparity_map, img1r, left_filtered_disparity, right_disparity_map, roi, img2r);
+      left_disparity_map = left_filtered_disparity;
+    }
+
+    // Matchers and filter output is already in the fixed-point output format
+    if( m_output_fixed_point_disparity )
+    {
+      return left_disparity_map;
+    }
+
+    cv::Mat left_disparity_float;
+    left_disparity_map.convertTo(left_disparity_float, CV_32F);
+
+    // Convert 16 bits fixed-point disparity map (where each disparity value has 4 fractional bits)
+    // from  StereoBM or StereoSGBM
+    // cf https://docs.opencv.org/3.4/d2/d6e/classcv_1_1StereoMatcher.html
+    left_disparity_float /= 16.0;
+    return left_disparity_float;
+  }
+
+#ifdef VIAME_OPENCV_CUDA
+  // Rectify, match and optionally filter on the device, returning the float
+  // disparity as the only download
+  cv::Mat
+  compute_disparity_cuda( const cv::Mat& left, const cv::Mat& right, const cv::Range& rows )
+  {
+    // cuda::remap requires separate float maps, converted once per calibration
+    if( d_map1x.empty() )
+    {
+      cv::Mat map_x, map_y;
+      cv::convertMaps( m_rectification_map11, m_rectification_map12, map_x, map_y, CV_32FC1 );
+      d_map1x.upload( map_x );
+      d_map1y.upload( map_y );
+      cv::convertMaps( m_rectification_map21, m_rectification_map22, map_x, map_y, CV_32FC1 );
+      d_map2x.upload( map_x );
+      d_map2y.upload( map_y );
+    }
+
+    d_left.upload( left, cuda_stream );
+    d_right.upload( right, cuda_stream );
+
+    if( left.channels() > 1 )
+    {
+      cv::cuda::cvtColor( d_left, d_left_gray, cv::COLOR_BGR2GRAY, 0, cuda_stream );
+      cv::cuda::cvtColor( d_right, d_right_gray, cv::COLOR_BGR2GRAY, 0, cuda_stream );
+    }
+    else
+    {
+      d_left_gray = d_left;
+      d_right_gray = d_right;
+    }
+
+    cv::cuda::remap( d_left_gray, d_left_rect, d_map1x.rowRange( rows ), d_map1y.rowRange( rows ),
+                     cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar(), cuda_stream );
+    cv::cuda::remap( d_right_gray, d_right_rect, d_map2x.rowRange( rows ), d_map2y.rowRange( rows ),
+                     cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar(), cuda_stream );
+
+    // Matchers take the stream implicitly through the default stream, so
+    // synchronize inputs before handing them over
+    cuda_stream.waitForCompletion();
+    cuda_matcher->compute( d_left_rect, d_right_rect, d_disparity );
+
+    cv::cuda::GpuMat* result = &d_disparity;
+
+    if( cuda_filter )
+    {
+      cuda_filter->apply( d_disparity, d_left_rect, d_filtered, cuda_stream );
+      result = &d_filtered;
+    }
+
+    // Output the same pixel units as the cpu path after its division by 16
+    if( m_output_fixed_point_disparity )
+    {
+      result->convertTo( d_disparity_float, CV_16S, cuda_disparity_scale * fixed_point_disparity_scale,
+                         cuda_stream );
+    }
+    else
+    {
+      result->convertTo( d_disparity_float, CV_32F, cuda_disparity_scale, cuda_stream );
+    }
+
+    cv::Mat disparity;
+    d_disparity_float.download( disparity, cuda_stream );
+    cuda_stream.waitForCompletion();
+    return disparity;
+  }
+#endif
+
+  // Store the full matcher search range and restart temporal tracking
+  void
+  reset_search_range()
+  {
+    m_full_min_disparity = left_matcher->getMinDisparity();
+    m_full_num_disparities = left_matcher->getNumDisparities();
+    m_search_min_disparity = m_full_min_disparity;
+    m_search_num_disparities = m_full_num_disparities;
+    m_temporal_frame_index = 0;
+    m_disparity_histogram.clear();
+  }
+
+  void
+  set_search_range( int min_disparity, int num_disparities )
+  {
+    if( min_disparity == m_search_min_disparity && num_disparities == m_search_num_disparities )
+    {
+      return;
+    }
+
+    m_search_min_disparity = min_disparity;
+    m_search_num_disparities = num_disparities;
+    left_matcher->setMinDisparity( min_disparity );
+    left_matcher->setNumDisparities( num_disparities );
+
+    // The right matcher and WLS filter copy the left matcher range on creation
+    if( disparity_filter )
+    {
+      disparity_filter = cv::ximgproc::createDisparityWLSFilter( left_matcher );
+      right_matcher = cv::ximgproc::createRightMatcher( left_matcher );
+    }
+  }
+
+  // Select the search range of the frame about to be computed. Every
+  // m_temporal_refresh_interval frames the full range is searched, otherwise
+  // the range covering the previous frame disparities plus a margin is used.
+  void
+  begin_temporal_frame()
+  {
+    if( m_temporal_refresh_interval <= 0 || backend != "cpu" )
+    {
+      return;
+    }
+
+    const bool refresh = ( m_temporal_frame_index++ % m_temporal_refresh_interval ) == 0;
+    size_t total = 0;
+
+    for( auto count : m_disparity_histogram )
+    {
+      total += count;
+    }
+
+    if( refresh || total == 0 )
+    {
+      set_search_range( m_full_min_disparity, m_full_num_disparities );
+    }
+    else
+    {
+      // Robust extent of the previous disparities, ignoring outliers on both ends
+      const size_t outliers = static_cast< size_t >( total * m_temporal_outlier_ratio );
+      int low = 0;
+      int high = static_cast< int >( m_disparity_histogram.size() ) - 1;
+
+      for( size_t skipped = 0; low < high && skipped + m_disparity_histogram[ low ] <= outliers; ++low )
+      {
+        skipped += m_disparity_histogram[ low ];
+      }
+
+      for( size_t skipped = 0; high > low && skipped + m_disparity_histogram[ high ] <= outliers; --high )
+      {
+        skipped += m_disparity_histogram[ high ];
+      }
+
+      // Matchers require a multiple of 16 disparities
+      const int full_end = m_full_min_disparity + m_full_num_disparities;
+      int min_disparity = std::max( m_full_min_disparity, m_full_min_disparity + low - m_temporal_margin );
+      int max_disparity = std::min( full_end, m_full_min_disparity + high + 1 + m_temporal_margin );
+      int num_disparities = std::min( m_full_num_disparities,
+                                      ( max_disparity - min_disparity + 15 ) / 16 * 16 );
+      min_disparity = std::min( min_disparity, full_end - num_disparities );
+
+      set_search_range( min_disparity, num_disparities );
+    }
+
+    m_disparity_histogram.assign( m_full_num_disparities, 0 );
+  }
+
+  // Accumulate the raw fixed-point disparities used to select the next frame
+  // range, and give pixels invalidated by a narrowed range the full range
+  // invalid value so that the output format does not depend on the range
+  void
+  update_temporal_statistics( cv::Mat& raw_disparity )
+  {
+    if( m_temporal_refresh_interval <= 0 || m_disparity_histogram.empty() ||
+        raw_disparity.type() != CV_16S )
+    {
+      return;
+    }
+
+    const int search_min = m_search_min_disparity * 16;
+    const int16_t invalid = static_cast< int16_t >( ( m_full_min_disparity - 1 ) * 16 );
+    const bool narrowed = m_search_min_disparity != m_full_min_disparity;
+    const int bins = static_cast< int >( m_disparity_histogram.size() );
+
+    for( int r = 0; r < raw_disparity.rows; ++r )
+    {
+      int16_t* row = raw_disparity.ptr< int16_t >( r );
+
+      for( int c = 0; c < raw_disparity.cols; ++c )
+      {
+        if( row[ c ] < search_min )
+        {
+          if( narrowed )
+          {
+            row[ c ] = invalid;
+          }
+          continue;
+        }
+
+        const int bin = row[ c ] / 16 - m_full_min_disparity;
+
+        if( bin >= 0 && bin < bins )
+        {
+          ++m_disparity_histogram[ bin ];
+        }
+      }
+    }
+  }
+
+  // Type of the disparity maps returned by compute
+  int
+  disparity_type() const
+  {
+    return m_output_fixed_point_disparity ? CV_16S : CV_32F;
+  }
+
+  // Full frame disparity for the selected backend
+  cv::Mat
+  compute_disparity( const cv::Mat& left, const cv::Mat& right, const cv::Range& rows )
+  {
+#ifdef VIAME_OPENCV_CUDA
+    if( backend == "cuda" )
+    {
+      return compute_disparity_cuda( left, right, rows );
+    }
+#endif
+    return compute_disparity_cpu( left, right, rows );
+  }
+
+  // Disparity computed only within the given rectified row ranges, other
+  // pixels are left at zero
+  cv::Mat
+  compute_disparity_in_strips( const cv::Mat& left, const cv::Mat& right,
+                               std::vector< cv::Range > strips )
+  {
+    std::sort( strips.begin(), strips.end(),
+      []( const cv::Range& a, const cv::Range& b ){ return a.start < b.start; } );
+
+    const int height = m_rectification_map11.rows;
+    const int width = m_rectification_map11.cols;
+
+    // Matchers need a window radius of context above and below each strip
+    const int margin = std::max( sad_window_size, block_size ) / 2 + 1;
+
+    std::vector< cv::Range > padded;
+
+    for( const auto& strip : strips )
+    {
+      cv::Range range( std::max( 0, strip.start - margin ),
+                       std::min( height, strip.end + margin ) );
+
+      if( range.start >= range.end )
+      {
+        continue;
+      }
+
+      if( !padded.empty() && range.start <= padded.back().end )
+      {
+        padded.back().end = std::max( padded.back().end, range.end );
+      }
+      else
+      {
+        padded.push_back( range );
+      }
+    }
+
+    cv::Mat output = cv::Mat::zeros( height, width, disparity_type() );
+
+    for( const auto& range : padded )
+    {
+      cv::Mat strip_disparity = compute_disparity( left, right, range );
+
+      // Only keep rows away from the strip borders, unless at image borders
+      const int keep_start = ( range.start == 0 ? 0 : margin );
+      const int keep_end = ( range.end == height ? range.size() : range.size() - margin );
+
+      if( keep_start < keep_end )
+      {
+        strip_disparity.rowRange( keep_start, keep_end ).copyTo(
+          output.rowRange( range.start + keep_start, range.start + keep_end ) );
+      }
+    }
+
+    return output;
+  }
+
+  // 64-bit FNV-1a hash of the calibration matrices and target image size
+  uint64_t
+  rectification_cache_key( const cv::Size& img_size ) const
+  {
+    uint64_t hash = 14695981039346656037ULL;
+
+    auto hash_bytes = [&hash]( const void* data, size_t size )
+    {
+      auto bytes = static_cast< const unsigned char* >( data );
+      for( size_t i = 0; i < size; ++i )
+      {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+      }
+    };
+
+    for( const cv::Mat& m : { M1, D1, R1, P1, M2, D2, R2, P2 } )
+    {
+      cv::Mat c = m.isContinuous() ? m : m.clone();
+      int32_t shape[3] = { c.rows, c.cols, c.type() };
+      hash_bytes( shape, sizeof( shape ) );
+      hash_bytes( c.data, c.total() * c.elemSize() );
+    }
+
+    int32_t dims[2] = { img_size.width, img_size.height };
+    hash_bytes( dims, sizeof( dims ) );
+    return hash;
+  }
+
+  std::string
+  rectification_cache_path( uint64_t key ) const
+  {
+    std::ostringstream name;
+    name << m_rectification_cache_directory << "/rectification_maps_"
+         << std::hex << key << ".bin";
+    return name.str();
+  }
+
+  // Number of bytes used by the four CV_16SC2 / CV_16UC1 maps of an image size
+  static size_t
+  rectification_maps_size( const cv::Size& img_size )
+  {
+    size_t pixels = static_cast< size_t >( img_size.area() );
+    return 2 * ( pixels * 2 * sizeof( int16_t ) + pixels * sizeof( uint16_t ) );
+  }
+
+  // Map a previously stored cache file, returns false if none is usable
+  bool
+  load_cached_rectification( const cv::Size& img_size )
+  {
+    if( m_rectification_cache_directory.empty() )
+    {
+      return false;
+    }
+
+    const uint64_t key = rectification_cache_key( img_size );
+    const std::string path = rectification_cache_path( key );
+
+    if( !kwiversys::SystemTools::FileExists( path ) )
+    {
+      return false;
+    }
+
+    namespace bip = boost::interprocess;
+
+    try
+    {
+      bip::file_mapping file( path.c_str(), bip::read_only );
+      std::unique_ptr< bip::mapped_region > region(
+        new bip::mapped_region( file, bip::read_only ) );
+
+      if( region->get_size() <
+          sizeof( rectification_cache_header ) + rectification_maps_size( img_size ) )
+      {
+        LOG_WARN( m_logger, "Ignoring truncated rectification cache " << path );
+        return false;
+      }
+
+      rectification_cache_header header;
+      std::memcpy( &header, region->get_address(), sizeof( header ) );
+
+      if( std::memcmp( header.magic, rectification_cache_magic, 4 ) != 0 ||
+          header.version != rectification_cache_version ||
+          header.key != key ||
+          header.width != img_size.width ||
+          header.height != img_size.height )
+      {
+        LOG_WARN( m_logger, "Ignoring mismatched rectification cache " << path );
+        return false;
+      }
+
+      // The maps are only ever read by cv::remap, so they can point straight
+      // into the shared read-only pages
+      uchar* data = static_cast< uchar* >( region->get_address() ) + sizeof( header );
+
+      m_rectification_map11 = cv::Mat( img_size, CV_16SC2, data );
+      data += m_rectification_map11.total() * m_rectification_map11.elemSize();
+      m_rectification_map12 = cv::Mat( img_size, CV_16UC1, data );
+      data += m_rectification_map12.total() * m_rectification_map12.elemSize();
+      m_rectification_map21 = cv::Mat( img_size, CV_16SC2, data );
+      data += m_rectification_map21.total() * m_rectification_map21.elemSize();
+      m_rectification_map22 = cv::Mat( img_size, CV_16UC1, data );
+
+      m_rectification_cache_region = std::move( region );
+    }
+    catch( const bip::interprocess_exception& e )
+    {
+      LOG_WARN( m_logger, "Unable to map rectification cache " << path << ": " << e.what() );
+      return false;
+    }
+
+    LOG_DEBUG( m_logger, "Loaded rectification maps from " << path );
+    return true;
+  }
+
+  // Load the cached maps of the image size, or compute and cache them, unless
+  // the current maps already match it
+  void
+  update_rectification_maps( const cv::Size& img_size )
+  {
+    if( m_computed_rectification && m_rectification_map11.size() != img_size )
+    {
+      reset_rectification_maps();
+    }
+
+    if( !m_computed_rectification && load_cached_rectification( img_size ) )
+    {
+      m_computed_rectification = true;
+    }
+
+    if( !m_computed_rectification )
+    {
+      LOG_DEBUG(m_logger, "Compute rectification matrix");
+      reset_rectification_maps();
+      cv::initUndistortRectifyMap(M1, D1, R1, P1,
+                                  img_size, CV_16SC2, m_rectification_map11, m_rectification_map12);
+      cv::initUndistortRectifyMap(M2, D2, R2, P2,
+                                  img_size, CV_16SC2, m_rectification_map21, m_rectification_map22);
+
+      if(!m_rectification_map11.empty() ||
+         !m_rectification_map12.empty() ||
+         !m_rectification_map21.empty() ||
+         !m_rectification_map22.empty())
+      {
+        m_computed_rectification = true;
+        store_cached_rectification( img_size );
+      }
+    }
+  }
+
+  // Write the current maps to the cache directory for use by later runs
+  void
+  store_cached_rectification( const cv::Size& img_size ) const
+  {
+    if( m_rectification_cache_directory.empty() )
+    {
+      return;
+    }
+
+    for( const cv::Mat& m : { m_rectification_map11, m_rectification_map12,
+                              m_rectification_map21, m_rectification_map22 } )
+    {
+      if( !m.isContinuous() || m.size() != img_size )
+      {
+        LOG_WARN( m_logger, "Unexpected rectification map layout, not caching" );
+        return;
+      }
+    }
+
+    if( !kwiversys::SystemTools::MakeDirectory( m_rectification_cache_directory ) )
+    {
+      LOG_WARN( m_logger, "Unable to create rectification cache directory "
+                << m_rectification_cache_directory );
+      return;
+    }
+
+    const uint64_t key = rectification_cache_key( img_size );
+    const std::string path = rectification_cache_path( key );
+
+    // Write to a unique temporary then rename, so that concurrent workers
+    // never observe a partially written cache file
+    std::ostringstream tmp_name;
+    tmp_name << path << ".tmp" << std::hex << std::random_device{}();
+    const std::string tmp_path = tmp_name.str();
+
+    rectification_cache_header header;
+    std::memcpy( header.magic, rectification_cache_magic, 4 );
+    header.version = rectification_cache_version;
+    header.key = key;
+    header.width = img_size.width;
+    header.height = img_size.height;
+
+    {
+      std::ofstream out( tmp_path, std::ios::binary );
+
+      if( !out )
+      {
+        LOG_WARN( m_logger, "Unable to write rectification cache " << tmp_path );
+        return;
+      }
+
+      out.write( reinterpret_cast< const char* >( &header ), sizeof( header ) );
+
+      for( const cv::Mat& m : { m_rectification_map11, m_rectification_map12,
+                                m_rectification_map21, m_rectification_map22 } )
+      {
+        out.write( reinterpret_cast< const char* >( m.data ), m.total() * m.elemSize() );
+      }
+
+      if( !out )
+      {
+        LOG_WARN( m_logger, "Unable to write rectification cache " << tmp_path );
+        out.close();
+        std::remove( tmp_path.c_str() );
+        return;
+      }
+    }
+
+    if( std::rename( tmp_path.c_str(), path.c_str() ) != 0 )
+    {
+      // Another worker may have won the race, which is equally fine
+      std::remove( tmp_path.c_str() );
+    }
+    else
+    {
+      LOG_DEBUG( m_logger, "Stored rectification maps in " << path );
+    }
+  }
 };
 
 
@@ -130,6 +807,11 @@ ocv_rectified_stereo_disparity_map
   kv::config_block_sptr config = kv::algorithm::get_configuration();
 
   config->set_value( "algorithm", d->algorithm, "Algorithm: BM or SGBM" );
+  config->set_value( "backend", d->backend,
+                     "Processing backend: cpu or cuda. The cuda backend keeps images on the "
+                     "device for remap, matching and filtering, and uses a bilateral filter "
+                     "in place of WLS when use_filtered_disparity is set. Requires OpenCV "
+                     "built with the cudastereo module." );
   config->set_value( "min_disparity", d->min_disparity, "Min Disparity" );
   config->set_value( "num_disparities", d->num_disparities, "Disparity count" );
   config->set_value( "sad_window_size", d->sad_window_size, "SAD window size" );
@@ -142,8 +824,31 @@ ocv_rectified_stereo_disparity_map
                     "(bool) if true, combines disparity map with left image as alpha chanel.");
   config->set_value("invert_disparity_alpha_chanel", d->m_invert_disparity_alpha_chanel,
                     "(bool) if true, invert disparity map when used as alpha chanel.");
+  config->set_value("parallel_matching", d->m_parallel_matching,
+                    "(bool) if true, run the left and right remaps, and the left and right "
+                    "matchers when filtering, concurrently on a two thread pool. Only used "
+                    "by the cpu backend.");
+  config->set_value("output_fixed_point_disparity", d->m_output_fixed_point_disparity,
+                    "(bool) if true, output the CV_16S fixed-point disparity of the matchers without "
+                    "conversion, where disparity in pixels is the value divided by 16. Float disparity "
+                    "in pixels otherwise.");
+
+  config->set_value("temporal_refresh_interval", d->m_temporal_refresh_interval,
+                    "If greater than 0, the disparity search range of each frame is narrowed to the "
+                    "disparities found in the previous frame, and the full range is searched again "
+                    "every temporal_refresh_interval frames. Only used by the cpu backend.");
+  config->set_value("temporal_margin", d->m_temporal_margin,
+                    "Disparity margin in pixels added on both sides of the previous frame range when "
+                    "temporal_refresh_interval is set.");
+  config->set_value("temporal_outlier_ratio", d->m_temporal_outlier_ratio,
+                    "Ratio of the previous frame disparities ignored at each end of their range when "
+                    "temporal_refresh_interval is set.");
 
   config->set_value("cameras_directory", d->m_cameras_directory, "Path to a directory to read cameras from.");
+  config->set_value("rectification_cache_directory", d->m_rectification_cache_directory,
+                    "Optional directory used to store rectification maps between runs. Maps are keyed "
+                    "by calibration and image size, and memory-mapped read-only so that parallel "
+                    "workers share them. Disabled if empty.");
 
   return config;
 }
@@ -156,6 +861,7 @@ void ocv_rectified_stereo_disparity_map
   config->merge_config( config_in );
 
   d->algorithm = config->get_value< std::string >( "algorithm" );
+  d->backend = config->get_value< std::string >( "backend" );
   d->min_disparity = config->get_value< int >( "min_disparity" );
   d->num_disparities = config->get_value< int >( "num_disparities" );
   d->sad_window_size = config->get_value< int >( "sad_window_size" );
@@ -165,9 +871,25 @@ void ocv_rectified_stereo_disparity_map
   d->m_use_filtered_disparity = config->get_value< bool >("use_filtered_disparity" );
   d->m_set_disparity_as_alpha_chanel = config->get_value< bool >("set_disparity_as_alpha_chanel" );
   d->m_invert_disparity_alpha_chanel = config->get_value< bool >("invert_disparity_alpha_chanel" );
+  d->m_parallel_matching = config->get_value< bool >("parallel_matching" );
+  d->m_output_fixed_point_disparity = config->get_value< bool >("output_fixed_point_disparity" );
+
+  if( d->m_parallel_matching && d->backend == "cpu" )
+  {
+    if( !d->m_matching_pool )
+    {
+      d->m_matching_pool.reset( new thread_pool( 2 ) );
+    }
+  }
+  else
+  {
+    d->m_matching_pool.reset();
+  }
 
-  d->m_computed_rectification = false;
+  d->reset_rectification_maps();
   d->m_cameras_directory = config->get_value< std::string >( "cameras_directory" );
+  d->m_rectification_cache_directory =
+    config->get_value< std::string >( "rectification_cache_directory" );
 
   d->load_camera_calibration();
 
@@ -200,6 +922,52 @@ void ocv_rectified_stereo_disparity_map
     d->disparity_filter.release();
     d->right_matcher.release();
   }
+
+  d->m_temporal_refresh_interval = config->get_value< int >( "temporal_refresh_interval" );
+  d->m_temporal_margin = config->get_value< int >( "temporal_margin" );
+  d->m_temporal_outlier_ratio = config->get_value< double >( "temporal_outlier_ratio" );
+  d->reset_search_range();
+
+  if( d->backend == "cuda" )
+  {
+#ifdef VIAME_OPENCV_CUDA
+    if( cv::cuda::getCudaEnabledDeviceCount() <= 0 )
+    {
+      throw std::runtime_error( "No CUDA device available for cuda backend" );
+    }
+
+    if( d->algorithm == "BM" )
+    {
+      // Device BM outputs integer disparities
+      d->cuda_matcher = cv::cuda::createStereoBM( d->num_disparities, d->sad_window_size );
+      d->cuda_disparity_scale = 1.0;
+    }
+    else
+    {
+      // Device SGM outputs the same 4 fractional bit format as StereoSGBM
+      int block_size_squared = d->block_size * d->block_size;
+      d->cuda_matcher = cv::cuda::createStereoSGM( d->min_disparity, d->num_disparities,
+                                                   8 * block_size_squared, 32 * block_size_squared );
+      d->cuda_disparity_scale = 1.0 / 16.0;
+    }
+
+    if( d->m_use_filtered_disparity )
+    {
+      d->cuda_filter = cv::cuda::createDisparityBilateralFilter( d->num_disparities );
+    }
+    else
+    {
+      d->cuda_filter.release();
+    }
+#else
+    throw std::runtime_error( "cuda backend requested but VIAME was built without "
+                              "OpenCV cuda stereo support" );
+#endif
+  }
+  else if( d->backend != "cpu" )
+  {
+    throw std::runtime_error( "Invalid backend type " + d->backend );
+  }
 }
 
 
@@ -211,10 +979,59 @@ bool ocv_rectified_stereo_disparity_map
 }
 
 
+// ---------------------------------------------------------------------------------------
+const ocv_stereo_rectification&
+ocv_rectified_stereo_disparity_map
+::rectification() const
+{
+  return d->m_rectification;
+}
+
+
+// ---------------------------------------------------------------------------------------
+void ocv_rectified_stereo_disparity_map
+::rectification_maps( const cv::Size& img_size,
+                      cv::Mat& map11, cv::Mat& map12,
+                      cv::Mat& map21, cv::Mat& map22 ) const
+{
+  d->update_rectification_maps( img_size );
+
+  if( !d->m_computed_rectification )
+  {
+    VITAL_THROW( kv::invalid_data, "Unable to compute the rectification maps" );
+  }
+
+  map11 = d->m_rectification_map11;
+  map12 = d->m_rectification_map12;
+  map21 = d->m_rectification_map21;
+  map22 = d->m_rectification_map22;
+}
+
+
 // ---------------------------------------------------------------------------------------
 kv::image_container_sptr ocv_rectified_stereo_disparity_map
 ::compute( kv::image_container_sptr left_image,
            kv::image_container_sptr right_image ) const
+{
+  return compute_impl( left_image, right_image, nullptr );
+}
+
+
+// ---------------------------------------------------------------------------------------
+kv::image_container_sptr ocv_rectified_stereo_disparity_map
+::compute_in_rows( kv::image_container_sptr left_image,
+                   kv::image_container_sptr right_image,
+                   const std::vector< std::pair< int, int > >& rows ) const
+{
+  return compute_impl( left_image, right_image, &rows );
+}
+
+
+// ---------------------------------------------------------------------------------------
+kv::image_container_sptr ocv_rectified_stereo_disparity_map
+::compute_impl( kv::image_container_sptr left_image,
+                kv::image_container_sptr right_image,
+                const std::vector< std::pair< int, int > >* rows ) const
 {
   if(left_image->get_image().size() != right_image->get_image().size())
   {
@@ -223,23 +1040,9 @@ kv::image_container_sptr ocv_rectified_stereo_disparity_map
   }
 
   // Load cameras and compute needed rectification matrix
-  if( !d->m_computed_rectification )
-  {
-    LOG_DEBUG(d->m_logger, "Compute rectification matrix");
-    cv::Size img_size = cv::Size(left_image->get_image().width(),left_image->get_image().height());
-    cv::initUndistortRectifyMap(d->M1, d->D1, d->R1, d->P1,
-                                img_size, CV_16SC2, d->m_rectification_map11, d->m_rectification_map12);
-    cv::initUndistortRectifyMap(d->M2, d->D2, d->R2, d->P2,
-                                img_size, CV_16SC2, d->m_rectification_map21, d->m_rectification_map22);
+  cv::Size img_size = cv::Size(left_image->get_image().width(),left_image->get_image().height());
 
-    if(!d->m_rectification_map11.empty() ||
-       !d->m_rectification_map12.empty() ||
-       !d->m_rectification_map21.empty() ||
-       !d->m_rectification_map22.empty())
-    {
-      d->m_computed_rectification = true;
-    }
-  }
+  d->update_rectification_maps( img_size );
 
   // apply rectification then compute depth map
   cv::Mat ocv1 = kwiver::arrows::ocv::image_container::vital_to_ocv( left_image->get_image(),
@@ -247,51 +1050,46 @@ kv::image_container_sptr ocv_rectified_stereo_disparity_map
   cv::Mat ocv2 = kwiver::arrows::ocv::image_container::vital_to_ocv( right_image->get_image(),
     kwiver::arrows::ocv::image_container::BGR_COLOR  );
 
-  cv::Mat ocv1_gray, ocv2_gray;
+  d->m_rectification.set_maps( d->m_rectification_map11, d->m_rectification_map12,
+                               d->m_rectification_map21, d->m_rectification_map22 );
+  d->m_rectification.begin_frame();
 
-  if( ocv1.channels() > 1 )
+  // The rectified color left image is needed for the alpha output, rectify it
+  // once and let the cpu matchers derive their gray input from it
+  if( d->m_set_disparity_as_alpha_chanel )
   {
-    cvtColor(ocv1, ocv1_gray, cv::COLOR_BGR2GRAY);
-    cvtColor(ocv2, ocv2_gray, cv::COLOR_BGR2GRAY);
+    d->m_rectification.rectify_left_color( ocv1 );
   }
-  else
+
+  d->begin_temporal_frame();
+
+  cv::Mat left_disparity_float;
+
+  if( rows )
   {
-    ocv1_gray = ocv1;
-    ocv2_gray = ocv2;
-  }
+    std::vector< cv::Range > strips;
 
-  cv::Mat img1r, img2r;
-  cv::remap(ocv1_gray, img1r, d->m_rectification_map11, d->m_rectification_map12, cv::INTER_LINEAR);
-  cv::remap(ocv2_gray, img2r, d->m_rectification_map21, d->m_rectification_map22, cv::INTER_LINEAR);
-
-  // compute disparity map
-  cv::Mat left_disparity_map, left_disparity_float;
-  d->left_matcher->compute(img1r, img2r, left_disparity_map);
-  left_disparity_map.convertTo(left_disparity_float, CV_32F);
-
-  // Filter disparity map
-  if (d->m_use_filtered_disparity && d->right_matcher && d->disparity_filter) {
-    auto roi = cv::Rect();
-    cv::Mat right_disparity_map, left_filtered_disparity;
-    d->right_matcher->compute(img2r, img1r, right_disparity_map);
-    d->disparity_filter->filter(left_disparity_map, img1r, left_filtered_disparity, right_disparity_map, roi, img2r);
-    left_filtered_disparity.convertTo(left_disparity_float, CV_32F);
-  }
+    for( const auto& row_range : *rows )
+    {
+      strips.emplace_back( row_range.first, row_range.second );
+    }
 
-  // Convert 16 bits fixed-point disparity map (where each disparity value has 4 fractional bits)
-  // from  StereoBM or StereoSGBM
-  // cf https://docs.opencv.org/3.4/d2/d6e/classcv_1_1StereoMatcher.html
-  left_disparity_float /= 16.0;
+    left_disparity_float = d->compute_disparity_in_strips( ocv1, ocv2, strips );
+  }
+  else
+  {
+    left_disparity_float = d->compute_disparity( ocv1, ocv2, cv::Range::all() );
+  }
 
   if (d->m_set_disparity_as_alpha_chanel){
     // Convert left image to RGBA
     cv::Mat left_rgba, dest_tmp;
 
-    cv::remap(ocv1, left_rgba, d->m_rectification_map11, d->m_rectification_map12, cv::INTER_LINEAR);
-    cv::cvtColor(left_rgba, left_rgba, left_rgba.channels() > 1 ? cv::COLOR_BGR2BGRA :  cv::COLOR_GRAY2BGRA);
+    cv::cvtColor(d->m_rectification.left_color(), left_rgba, left_rgba.channels() > 1 ? cv::COLOR_BGR2BGRA :  cv::COLOR_GRAY2BGRA);
 
     // Convert disparity to 8bit for compatibility with alpha chanel output
-    left_disparity_float.convertTo(dest_tmp, CV_8UC1);
+    left_disparity_float.convertTo(dest_tmp, CV_8UC1,
+                                   d->m_output_fixed_point_disparity ? 1.0 / fixed_point_disparity_scale : 1.0);
 
     // Invert disparity map and keep out of focus pixels as black if needed
     if(d->m_invert_disparity_alpha_chanel) {
@@ -3,6 +3,9 @@
 #define VIAME_OPENCV_RECTIFY_STEREO_DEPTH_H
 
 #include <plugins/opencv/viame_opencv_export.h>
+#include <plugins/opencv/ocv_stereo_rectification.h>
+
+#include <plugins/core/roi_stereo_depth_map.h>
 
 #include <vital/algo/compute_stereo_depth_map.h>
 
@@ -10,7 +13,8 @@ namespace viame {
 
 class VIAME_OPENCV_EXPORT ocv_rectified_stereo_disparity_map :
   public kwiver::vital::algorithm_impl<
-    ocv_rectified_stereo_disparity_map, kwiver::vital::algo::compute_stereo_depth_map >
+    ocv_rectified_stereo_disparity_map, kwiver::vital::algo::compute_stereo_depth_map >,
+  public roi_stereo_depth_map
 {
 public:
   PLUGIN_INFO( "ocv_rectified_stereo_disparity_map",
@@ -28,8 +32,31 @@ public:
   compute( kwiver::vital::image_container_sptr left_image,
            kwiver::vital::image_container_sptr right_image ) const;
 
+  virtual kwiver::vital::image_container_sptr
+  compute_in_rows( kwiver::vital::image_container_sptr left_image,
+                   kwiver::vital::image_container_sptr right_image,
+                   const std::vector< std::pair< int, int > >& rows ) const;
+
+  /// Rectified gray images of the last matched rows, for use by other stereo
+  /// algorithms without rectifying again. Only updated by the cpu backend.
+  const ocv_stereo_rectification& rectification() const;
+
+  /// Left (map11, map12) and right (map21, map22) rectification maps of the
+  /// image size, loaded from the rectification cache or computed and cached
+  /// when needed. The maps may reference the memory-mapped cache file, they
+  /// stay valid while this algorithm is alive and used with the same size,
+  /// and only read by cv::remap they can be shared between threads.
+  void rectification_maps( const cv::Size& img_size,
+                           cv::Mat& map11, cv::Mat& map12,
+                           cv::Mat& map21, cv::Mat& map22 ) const;
+
 private:
 
+  kwiver::vital::image_container_sptr
+  compute_impl( kwiver::vital::image_container_sptr left_image,
+                kwiver::vital::image_container_sptr right_image,
+                const std::vector< std::pair< int, int > >* rows ) const;
+
   class priv;
   const std::unique_ptr< priv > d;
 };
@@ -0,0 +1,205 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ocv_reduced_image_io.h"
+
+#include <vital/exceptions/io.h>
+
+#include <arrows/ocv/image_container.h>
+
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+// Reduced decode flags were added in OpenCV 3.2
+#if CV_MAJOR_VERSION > 3 || ( CV_MAJOR_VERSION == 3 && CV_MINOR_VERSION >= 2 )
+#define VIAME_OCV_REDUCED_DECODE
+#endif
+
+namespace viame {
+
+using namespace kwiver;
+
+// -----------------------------------------------------------------------------------------------
+/**
+ * @brief Storage class for private member variables
+ */
+class ocv_reduced_image_io::priv
+{
+public:
+
+  priv()
+    : m_reduction( 2 )
+    , m_grayscale( false )
+  {}
+
+  ~priv() {}
+
+  int m_reduction;
+  bool m_grayscale;
+
+  // OpenCV imread flags for the configured reduction
+  int read_flags() const;
+};
+
+
+// -----------------------------------------------------------------------------------------------
+int
+ocv_reduced_image_io::priv
+::read_flags() const
+{
+#if CV_MAJOR_VERSION < 3
+  const int full_flags = ( m_grayscale ? CV_LOAD_IMAGE_GRAYSCALE : CV_LOAD_IMAGE_COLOR );
+#else
+  const int full_flags = ( m_grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR );
+#endif
+
+#ifdef VIAME_OCV_REDUCED_DECODE
+  switch( m_reduction )
+  {
+    case 2:
+      return ( m_grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_2 : cv::IMREAD_REDUCED_COLOR_2 );
+    case 4:
+      return ( m_grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_4 : cv::IMREAD_REDUCED_COLOR_4 );
+    case 8:
+      return ( m_grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_8 : cv::IMREAD_REDUCED_COLOR_8 );
+  }
+#endif
+
+  return full_flags;
+}
+
+
+// -----------------------------------------------------------------------------------------------
+ocv_reduced_image_io
+::ocv_reduced_image_io()
+  : d( new priv() )
+{
+  attach_logger( "viame.opencv.ocv_reduced_image_io" );
+}
+
+
+ocv_reduced_image_io
+::~ocv_reduced_image_io()
+{
+}
+
+
+// -----------------------------------------------------------------------------------------------
+vital::config_block_sptr
+ocv_reduced_image_io
+::get_configuration() const
+{
+  vital::config_block_sptr config = vital::algorithm::get_configuration();
+
+  config->set_value( "reduction", d->m_reduction,
+    "Factor by which both image dimensions are reduced when reading, one of "
+    "1, 2, 4 or 8. Should match the scale_factor used when mapping detections "
+    "back to the stored resolution." );
+  config->set_value( "grayscale", d->m_grayscale,
+    "Read images as single channel grayscale instead of RGB." );
+
+  return config;
+}
+
+
+// -----------------------------------------------------------------------------------------------
+void
+ocv_reduced_image_io
+::set_configuration( vital::config_block_sptr in_config )
+{
+  vital::config_block_sptr config = this->get_configuration();
+  config->merge_config( in_config );
+
+  d->m_reduction = config->get_value< int >( "reduction" );
+  d->m_grayscale = config->get_value< bool >( "grayscale" );
+}
+
+
+// -----------------------------------------------------------------------------------------------
+bool
+ocv_reduced_image_io
+::check_configuration( vital::config_block_sptr config ) const
+{
+  const int reduction = config->get_value< int >( "reduction", d->m_reduction );
+
+  if( reduction != 1 && reduction != 2 && reduction != 4 && reduction != 8 )
+  {
+    LOG_ERROR( logger(), "Reduction must be 1, 2, 4 or 8, not " << reduction );
+    return false;
+  }
+
+  return true;
+}
+
+
+// -----------------------------------------------------------------------------------------------
+vital::image_container_sptr
+ocv_reduced_image_io
+::load_( std::string const& filename ) const
+{
+  cv::Mat image = cv::imread( filename, d->read_flags() );
+
+  if( image.empty() )
+  {
+    VITAL_THROW( vital::file_not_read_exception, filename, "Unable to decode image" );
+  }
+
+#ifndef VIAME_OCV_REDUCED_DECODE
+  if( d->m_reduction > 1 )
+  {
+    cv::Mat reduced;
+    cv::resize( image, reduced,
+      cv::Size( ( image.cols + d->m_reduction - 1 ) / d->m_reduction,
+                ( image.rows + d->m_reduction - 1 ) / d->m_reduction ),
+      0, 0, cv::INTER_AREA );
+    image = reduced;
+  }
+#endif
+
+  return std::make_shared< arrows::ocv::image_container >(
+    image, arrows::ocv::image_container::BGR_COLOR );
+}
+
+
+// -----------------------------------------------------------------------------------------------
+void
+ocv_reduced_image_io
+::save_( std::string const& filename, vital::image_container_sptr data ) const
+{
+  cv::Mat image = arrows::ocv::image_container::vital_to_ocv(
+    data->get_image(), arrows::ocv::image_container::BGR_COLOR );
+
+  if( !cv::imwrite( filename, image ) )
+  {
+    VITAL_THROW( vital::file_write_exception, filename, "Unable to encode image" );
+  }
+}
+
+} // end namespace viame
@@ -29,6 +29,7 @@
  */
 
 #include "ocv_stereo_depth_map.h"
+#include "ocv_stereo_rectification.h"
 
 #include <vital/vital_config.h>
 #include <vital/types/image_container.h>
@@ -63,6 +64,9 @@ public:
   cv::Ptr< cv::StereoMatcher > algo;
 #endif
 
+  // Gray conversion buffers reused between frames
+  cv::Mat left_gray, right_gray;
+
   priv()
     : algorithm( "BM" )
     , min_disparity( 0 )
@@ -175,23 +179,12 @@ kwiver::vital::image_container_sptr ocv_stereo_depth_map
   cv::Mat ocv2 = arrows::ocv::image_container::vital_to_ocv( right_image->get_image(),
     kwiver::arrows::ocv::image_container::BGR_COLOR  );
   
-  cv::Mat ocv1_gray, ocv2_gray;
-
-  if( ocv1.channels() > 1 )
-  {
-#if CV_MAJOR_VERSION < 4
-    cvtColor( ocv1, ocv1_gray, CV_BGR2GRAY );
-    cvtColor( ocv2, ocv2_gray, CV_BGR2GRAY );
-#else
-    cv::cvtColor( ocv1, ocv1_gray, cv::COLOR_BGR2GRAY );
-    cv::cvtColor( ocv2, ocv2_gray, cv::COLOR_BGR2GRAY );
-#endif
-  }
-  else
-  {
-    ocv1_gray = ocv1;
-    ocv2_gray = ocv2;
-  }
+  // Already rectified gray inputs, such as the ones of ocv_stereo_rectification,
+  // are used without conversion or copy
+  cv::Mat& ocv1_gray = d->left_gray;
+  cv::Mat& ocv2_gray = d->right_gray;
+  ocv_stereo_rectification::convert_to_gray( ocv1, ocv1_gray );
+  ocv_stereo_rectification::convert_to_gray( ocv2, ocv2_gray );
 
   cv::Mat output;
 
@@ -1,6 +1,9 @@
 #include "ocv_stereo_feature_track_filter.h"
 #include "ocv_kmedians.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <tuple>
 
 viame::StereoPointCoordinates
 viame::StereoPointCoordinates::from_features(const viame::FrameFeatureTrackStates &features,
@@ -88,44 +91,145 @@ viame::StereoPointCoordinates::StereoPointCoordinates() {
   image_pts.resize(2);
 }
 
-viame::FrameFeatureTrackStates
-viame::StereoFeatureTrackFilter::remove_empty_frames(viame::FrameFeatureTrackStates frame_feature_tracks) {
-  frame_feature_tracks.erase(std::remove_if(std::begin(frame_feature_tracks), std::end(frame_feature_tracks),
-                                            [](const CameraFeatureTrackStates &frame) { return frame.empty(); }),
-                             std::end(frame_feature_tracks));
-  return frame_feature_tracks;
+viame::CoverageFrameSelector::CoverageFrameSelector(size_t frame_count_threshold, const cv::Size &image_size,
+                                                   int grid_size)
+    : m_frame_count_threshold{frame_count_threshold}, m_image_size{image_size}, m_grid_size{std::max(grid_size, 1)} {
+  m_cell_counts.resize(2 * m_grid_size * m_grid_size);
+}
+
+std::vector<int>
+viame::CoverageFrameSelector::covered_cells(const StereoPointCoordinates &coordinates, size_t i_frame) const {
+  std::vector<int> cells;
+  const auto n_cells = m_grid_size * m_grid_size;
+  for (size_t i_cam = 0; i_cam < 2; i_cam++) {
+    if (coordinates.image_pts[i_cam].size() <= i_frame)
+      continue;
+
+    for (const auto &pt: coordinates.image_pts[i_cam][i_frame]) {
+      auto x = (int) (pt.x * (float) m_grid_size / (float) std::max(m_image_size.width, 1));
+      auto y = (int) (pt.y * (float) m_grid_size / (float) std::max(m_image_size.height, 1));
+      x = std::min(std::max(x, 0), m_grid_size - 1);
+      y = std::min(std::max(y, 0), m_grid_size - 1);
+      cells.push_back((int) i_cam * n_cells + y * m_grid_size + x);
+    }
+  }
+
+  std::sort(std::begin(cells), std::end(cells));
+  cells.erase(std::unique(std::begin(cells), std::end(cells)), std::end(cells));
+  return cells;
+}
+
+bool viame::CoverageFrameSelector::add_frame(const StereoPointCoordinates &coordinates, size_t i_frame) {
+  auto cells = covered_cells(coordinates, i_frame);
+
+  const bool is_full = m_frame_count_threshold != 0 && m_frames.size() >= m_frame_count_threshold;
+  size_t i_replaced = m_frames.size();
+  if (is_full) {
+    // Number of cells the new frame would cover for the first time
+    long gain{};
+    for (auto cell: cells)
+      gain += m_cell_counts[cell] == 0;
+
+    // Find kept frame covering the least cells no other kept frame covers
+    long min_contribution{std::numeric_limits<long>::max()};
+    for (size_t i_kept = 0; i_kept < m_frames.size(); i_kept++) {
+      long contribution{};
+      for (auto cell: m_frames[i_kept].cells)
+        contribution += m_cell_counts[cell] == 1;
+
+      if (contribution < min_contribution) {
+        min_contribution = contribution;
+        i_replaced = i_kept;
+      }
+    }
+
+    if (gain <= min_contribution) {
+      m_frame_count++;
+      return false;
+    }
+
+    for (auto cell: m_frames[i_replaced].cells)
+      m_cell_counts[cell]--;
+  }
+
+  Frame frame;
+  frame.order = m_frame_count++;
+  frame.cells = std::move(cells);
+  frame.image_pts = {coordinates.image_pts[0][i_frame], coordinates.image_pts[1][i_frame]};
+  frame.world_pts = coordinates.world_pts[i_frame];
+  frame.frame_id = coordinates.frame_ids[i_frame];
+  for (auto cell: frame.cells)
+    m_cell_counts[cell]++;
+
+  if (is_full)
+    m_frames[i_replaced] = std::move(frame);
+  else
+    m_frames.push_back(std::move(frame));
+
+  return true;
+}
+
+viame::StereoPointCoordinates viame::CoverageFrameSelector::selected_frames() const {
+  std::vector<const Frame *> frames;
+  for (const auto &frame: m_frames)
+    frames.push_back(&frame);
+  std::sort(std::begin(frames), std::end(frames), [](const Frame *a, const Frame *b) { return a->order < b->order; });
+
+  StereoPointCoordinates output;
+  for (const auto frame: frames) {
+    output.image_pts[0].push_back(frame->image_pts[0]);
+    output.image_pts[1].push_back(frame->image_pts[1]);
+    output.world_pts.push_back(frame->world_pts);
+    output.frame_ids.push_back(frame->frame_id);
+  }
+  return output;
 }
 
 viame::FrameFeatureTrackStates
 viame::StereoFeatureTrackFilter::group_by_frame_id(const viame::FeatureTracks &feature_tracks) {
-  if (feature_tracks.empty())
-    return {};
+  // Flatten the states to a contiguous array sorted by frame > camera > track id
+  // Memory is proportional to the number of states and independent of the frame and track id ranges
+  struct Observation {
+    kwiver::vital::frame_id_t frame_id;
+    size_t i_camera;
+    kwiver::vital::track_id_t track_id;
+    kwiver::vital::feature_track_state_sptr state;
+  };
+
+  std::vector<Observation> observations;
+  for (size_t i_camera = 0; i_camera < feature_tracks.size(); i_camera++) {
+    for (const auto &track: feature_tracks[i_camera]->tracks()) {
+      for (const auto &state: *track | kwiver::vital::as_feature_track) {
+        if (state->frame() < 0 || track->id() < 0)
+          continue;
 
-  auto max_frame_id = max_feature_tracks_frame_id(feature_tracks);
-  auto max_track_id = max_feature_tracks_track_id(feature_tracks);
-  if (max_frame_id < 0 || max_track_id < 0)
-    return {};
+        observations.push_back({state->frame(), i_camera, track->id(), state});
+      }
+    }
+  }
+
+  const auto key = [](const Observation &observation) {
+    return std::make_tuple(observation.frame_id, observation.i_camera, observation.track_id);
+  };
+  std::stable_sort(std::begin(observations), std::end(observations),
+                   [&](const Observation &a, const Observation &b) { return key(a) < key(b); });
 
+  // Build frames from the sorted array. Only frames with at least one state are created.
   FrameFeatureTrackStates frame_feature_tracks;
-  frame_feature_tracks.resize(max_frame_id + 1);
+  for (size_t i_obs = 0; i_obs < observations.size(); i_obs++) {
+    const auto &observation = observations[i_obs];
 
-  size_t i_feature{0};
-  for (const auto &features: feature_tracks) {
-    for (const auto &track: features->tracks()) {
-      for (const auto &state: *track | kwiver::vital::as_feature_track) {
-        if (frame_feature_tracks[state->frame()].empty())
-          frame_feature_tracks[state->frame()].resize(feature_tracks.size());
+    // Keep the last state if the same track has multiple states in one frame
+    if (i_obs + 1 < observations.size() && key(observations[i_obs + 1]) == key(observation))
+      continue;
 
-        if (frame_feature_tracks[state->frame()][i_feature].empty())
-          frame_feature_tracks[state->frame()][i_feature].resize(max_track_id + 1);
+    if (i_obs == 0 || observations[i_obs - 1].frame_id != observation.frame_id)
+      frame_feature_tracks.emplace_back(feature_tracks.size());
 
-        frame_feature_tracks[state->frame()][i_feature][state->track()->id()] = state;
-      }
-    }
-    i_feature++;
+    frame_feature_tracks.back()[observation.i_camera].push_back(observation.state);
   }
 
-  return remove_empty_frames(frame_feature_tracks);
+  return frame_feature_tracks;
 }
 
 viame::FrameFeatureTrackStates viame::StereoFeatureTrackFilter::remove_frames_without_corresponding_left_right_match(
@@ -203,25 +307,18 @@ viame::StereoFeatureTrackFilter::select_frames(const viame::FeatureTracks &featu
   return select_points_maximizing_variance(stereo_points, frame_count_threshold);
 }
 
-int64_t viame::StereoFeatureTrackFilter::max_feature_id(const viame::FeatureTracks &feature_tracks,
-                                                        const std::function<int64_t(
-                                                            const kwiver::vital::feature_track_set_sptr &)> &max_f) {
-  int64_t max_id{-1};
-  for (const auto &feature: feature_tracks) {
-    max_id = std::max(max_id, max_f(feature));
-  }
-
-  return max_id;
-}
+viame::StereoPointCoordinates
+viame::StereoFeatureTrackFilter::select_frames_by_coverage(const viame::FeatureTracks &features,
+                                                           const viame::Landmarks &landmarks,
+                                                           size_t frame_count_threshold, const cv::Size &image_size) {
+  auto frame_features = remove_frames_without_corresponding_left_right_match(group_by_frame_id(features));
+  auto stereo_points = StereoPointCoordinates::from_features(frame_features, landmarks);
 
-int64_t viame::StereoFeatureTrackFilter::max_feature_tracks_track_id(const viame::FeatureTracks &feature_tracks) {
-  auto max_track_id_f = [](const kwiver::vital::feature_track_set_sptr &f) { return *f->all_track_ids().rbegin(); };
-  return max_feature_id(feature_tracks, max_track_id_f);
-}
+  CoverageFrameSelector selector{frame_count_threshold, image_size};
+  for (size_t i_frame = 0; i_frame < stereo_points.frame_ids.size(); i_frame++)
+    selector.add_frame(stereo_points, i_frame);
 
-int64_t viame::StereoFeatureTrackFilter::max_feature_tracks_frame_id(const viame::FeatureTracks &feature_tracks) {
-  auto max_frame_id_f = [](const kwiver::vital::feature_track_set_sptr &f) { return *f->all_frame_ids().rbegin(); };
-  return max_feature_id(feature_tracks, max_frame_id_f);
+  return selector.selected_frames();
 }
 
 cv::Mat viame::StereoFeatureTrackFilter::create_frames_extents_matrix(const viame::StereoPointCoordinates &coordinates,
@@ -11,7 +11,7 @@ namespace viame {
 using Landmarks = std::vector<kwiver::vital::landmark_map_sptr>;
 using FeatureTracks = std::vector<kwiver::vital::feature_track_set_sptr>;
 
-// Feature track states grouped by camera_index > track_id;
+// Feature track states grouped by camera_index > states sorted by track_id;
 using CameraFeatureTrackStates = std::vector<std::vector<kwiver::vital::feature_track_state_sptr>>;
 
 // Feature track states grouped by frame > camera_index > track_id;
@@ -29,6 +29,41 @@ struct VIAME_OPENCV_EXPORT StereoPointCoordinates {
   static StereoPointCoordinates from_features(const FrameFeatureTrackStates &features, const Landmarks &landmarks);
 };
 
+/// @brief Incremental frame selector keeping at most N frames maximizing the image area covered by their points
+/// Image is split in a grid for each camera. Frames are offered one at a time as they arrive. Once N frames are kept,
+/// a new frame replaces the kept frame with the smallest exclusive coverage if it covers more new cells. Time and
+/// memory per frame are bounded by N and the grid size.
+class VIAME_OPENCV_EXPORT CoverageFrameSelector {
+public:
+  /// @param frame_count_threshold: Maximum number of kept frames. 0 keeps every frame.
+  CoverageFrameSelector(size_t frame_count_threshold, const cv::Size &image_size, int grid_size = 16);
+
+  /// @brief Offer frame i_frame of the input coordinates to the selector.
+  /// @return true if the frame is kept
+  bool add_frame(const StereoPointCoordinates &coordinates, size_t i_frame);
+
+  /// @brief Returns the kept frames in arrival order
+  StereoPointCoordinates selected_frames() const;
+
+private:
+  struct Frame {
+    size_t order;
+    std::vector<int> cells;
+    std::vector<std::vector<cv::Point2f>> image_pts; // Points grouped by cam
+    std::vector<cv::Point3f> world_pts;
+    size_t frame_id;
+  };
+
+  std::vector<int> covered_cells(const StereoPointCoordinates &coordinates, size_t i_frame) const;
+
+  size_t m_frame_count_threshold;
+  cv::Size m_image_size;
+  int m_grid_size;
+  size_t m_frame_count{};
+  std::vector<int> m_cell_counts; // Number of kept frames covering each cam > grid cell
+  std::vector<Frame> m_frames;
+};
+
 /// @brief Class responsible for selecting the best tracks in given feature track vector for the calibration
 class VIAME_OPENCV_EXPORT StereoFeatureTrackFilter {
 public:
@@ -41,12 +76,16 @@ public:
   static StereoPointCoordinates
   select_frames(const FeatureTracks &features, const Landmarks &landmarks, size_t frame_count_threshold);
 
-private:
-  /// @brief Remove empty frames from the input feature tracks vector
-  static FrameFeatureTrackStates remove_empty_frames(FrameFeatureTrackStates frame_feature_tracks);
+  /// @brief Select at most N frames from input frames, offering them in frame order to a @ref CoverageFrameSelector.
+  /// Avoids the K-Medians clustering of all the frames used by @ref select_frames.
+  static StereoPointCoordinates
+  select_frames_by_coverage(const FeatureTracks &features, const Landmarks &landmarks, size_t frame_count_threshold,
+                            const cv::Size &image_size);
 
+private:
   /// @brief Group input feature tracks vector by frame ids > Cameras > Tracks
-  /// Output vector only contains full frames
+  /// Output vector only contains non empty frames sorted by frame id, each camera containing only its present states
+  /// sorted by track id
   static FrameFeatureTrackStates group_by_frame_id(const FeatureTracks &feature_tracks);
 
   /// @brief Remove frames where the number of tracks between left and right cameras is not identical to maximum number
@@ -54,16 +93,6 @@ private:
   /// For single camera case, this method call does nothing
   static FrameFeatureTrackStates remove_frames_without_corresponding_left_right_match(FrameFeatureTrackStates features);
 
-  /// @brief Returns the maximum id in the input feature track vector given a max function
-  static int64_t max_feature_id(const FeatureTracks &feature_tracks,
-                                const std::function<int64_t(const kwiver::vital::feature_track_set_sptr &)> &max_f);
-
-  /// @brief Returns the maximum track id in the input feature track vector
-  static int64_t max_feature_tracks_track_id(const FeatureTracks &feature_tracks);
-
-  /// @brief Returns the maximum frame id in the input feature track vector
-  static int64_t max_feature_tracks_frame_id(const FeatureTracks &feature_tracks);
-
   static cv::Mat
   create_frames_extents_matrix(const viame::StereoPointCoordinates &coordinates, int n_frames);
 
@@ -0,0 +1,190 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ocv_stereo_rectification.h"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <arrows/ocv/image_container.h>
+
+#include <plugins/core/thread_pool.h>
+
+namespace viame {
+
+namespace {
+
+// Drop a pooled buffer if its data is still referenced by a previous result,
+// so that writing the next frame never alters it
+void
+release_if_shared( cv::Mat& buffer )
+{
+  if( buffer.u && buffer.u->refcount > 1 )
+  {
+    buffer.release();
+  }
+}
+
+} // end anonymous namespace
+
+
+ocv_stereo_rectification
+::ocv_stereo_rectification()
+  : m_has_left_color( false )
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void
+ocv_stereo_rectification
+::set_maps( const cv::Mat& map11, const cv::Mat& map12,
+            const cv::Mat& map21, const cv::Mat& map22 )
+{
+  m_map11 = map11;
+  m_map12 = map12;
+  m_map21 = map21;
+  m_map22 = map22;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+ocv_stereo_rectification
+::begin_frame()
+{
+  m_has_left_color = false;
+}
+
+
+// -----------------------------------------------------------------------------
+const cv::Mat&
+ocv_stereo_rectification
+::rectify_left_color( const cv::Mat& left )
+{
+  release_if_shared( m_left_color );
+  cv::remap( left, m_left_color, m_map11, m_map12, cv::INTER_LINEAR );
+  m_has_left_color = true;
+  return m_left_color;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+ocv_stereo_rectification
+::rectify( const cv::Mat& left, const cv::Mat& right, const cv::Range& rows,
+           thread_pool* pool )
+{
+  release_if_shared( m_left_gray );
+  release_if_shared( m_right_gray );
+
+  auto rectify_left = [&]
+  {
+    if( m_has_left_color )
+    {
+      convert_to_gray( m_left_color.rowRange( rows ), m_left_gray );
+    }
+    else
+    {
+      rectify_gray( left, m_map11.rowRange( rows ), m_map12.rowRange( rows ),
+                    m_left_input_gray, m_left_gray );
+    }
+  };
+
+  auto rectify_right = [&]
+  {
+    rectify_gray( right, m_map21.rowRange( rows ), m_map22.rowRange( rows ),
+                  m_right_input_gray, m_right_gray );
+  };
+
+  if( pool )
+  {
+    auto left_done = pool->enqueue( rectify_left );
+    auto right_done = pool->enqueue( rectify_right );
+    left_done.get();
+    right_done.get();
+  }
+  else
+  {
+    rectify_left();
+    rectify_right();
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+kwiver::vital::image_container_sptr
+ocv_stereo_rectification
+::left_image() const
+{
+  return kwiver::vital::image_container_sptr(
+    new kwiver::arrows::ocv::image_container( m_left_gray,
+      kwiver::arrows::ocv::image_container::BGR_COLOR ) );
+}
+
+
+// -----------------------------------------------------------------------------
+kwiver::vital::image_container_sptr
+ocv_stereo_rectification
+::right_image() const
+{
+  return kwiver::vital::image_container_sptr(
+    new kwiver::arrows::ocv::image_container( m_right_gray,
+      kwiver::arrows::ocv::image_container::BGR_COLOR ) );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+ocv_stereo_rectification
+::convert_to_gray( const cv::Mat& image, cv::Mat& gray )
+{
+  if( image.channels() == 1 )
+  {
+    gray = image;
+    return;
+  }
+
+  release_if_shared( gray );
+  cv::cvtColor( image, gray,
+                image.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY );
+}
+
+
+// -----------------------------------------------------------------------------
+void
+ocv_stereo_rectification
+::rectify_gray( const cv::Mat& image, const cv::Mat& map1, const cv::Mat& map2,
+                cv::Mat& gray_buffer, cv::Mat& rectified )
+{
+  convert_to_gray( image, gray_buffer );
+  cv::remap( gray_buffer, rectified, map1, map2, cv::INTER_LINEAR );
+}
+
+} // end namespace viame
@@ -0,0 +1,107 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Rectification stage shared by the OpenCV stereo algorithms
+ */
+
+#ifndef VIAME_OPENCV_STEREO_RECTIFICATION_H
+#define VIAME_OPENCV_STEREO_RECTIFICATION_H
+
+#include <plugins/opencv/viame_opencv_export.h>
+
+#include <vital/types/image_container.h>
+
+#include <opencv2/core/core.hpp>
+
+namespace viame {
+
+class thread_pool;
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Gray conversion and rectification of a stereo image pair
+ *
+ * Rectified images are written to buffers kept between frames, which are only
+ * reallocated when the image size changes or when a previous result is still
+ * referenced elsewhere. When the rectified color left image is also required,
+ * it is remapped once and the gray left image is derived from it.
+ */
+class VIAME_OPENCV_EXPORT ocv_stereo_rectification
+{
+public:
+  ocv_stereo_rectification();
+
+  /// Set the left (map11, map12) and right (map21, map22) rectification maps
+  void set_maps( const cv::Mat& map11, const cv::Mat& map12,
+                 const cv::Mat& map21, const cv::Mat& map22 );
+
+  /// Forget the rectified images of the previous frame
+  void begin_frame();
+
+  /// Rectify the full color left image, reused by the next call to rectify
+  const cv::Mat& rectify_left_color( const cv::Mat& left );
+
+  /// Rectify the gray images within the given rectified rows, optionally
+  /// running the left and right remaps on the given pool
+  void rectify( const cv::Mat& left, const cv::Mat& right, const cv::Range& rows,
+                thread_pool* pool = nullptr );
+
+  const cv::Mat& left() const { return m_left_gray; }
+  const cv::Mat& right() const { return m_right_gray; }
+  const cv::Mat& left_color() const { return m_left_color; }
+
+  /// Wrap the rectified gray images for other stereo algorithms, without copy
+  kwiver::vital::image_container_sptr left_image() const;
+  kwiver::vital::image_container_sptr right_image() const;
+
+  /// Convert to gray into a pooled buffer, or reference the image when it
+  /// already has a single channel
+  static void convert_to_gray( const cv::Mat& image, cv::Mat& gray );
+
+private:
+  void rectify_gray( const cv::Mat& image, const cv::Mat& map1, const cv::Mat& map2,
+                     cv::Mat& gray_buffer, cv::Mat& rectified );
+
+  cv::Mat m_map11, m_map12, m_map21, m_map22;
+
+  cv::Mat m_left_color;
+  cv::Mat m_left_gray, m_right_gray;
+
+  // Unrectified gray buffers
+  cv::Mat m_left_input_gray, m_right_input_gray;
+
+  bool m_has_left_color;
+};
+
+}
+
+#endif // VIAME_OPENCV_STEREO_RECTIFICATION_H
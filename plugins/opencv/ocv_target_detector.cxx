@@ -7,6 +7,7 @@
 #include <opencv2/imgproc.hpp>
 
 
+#include <algorithm>
 #include <cmath>
 
 namespace kv = kwiver::vital;
@@ -26,7 +27,10 @@ public:
     : m_target_width(7),
       m_target_height(5),
       m_square_size(1.0),
-      m_object_type("unknown")
+      m_object_type("unknown"),
+      m_coarse_max_dimension(0),
+      m_track_previous_corners(false),
+      m_search_margin(0.5)
   {}
 
   /// Destructor
@@ -38,11 +42,88 @@ public:
   unsigned m_target_height;
   float m_square_size;
   std::string m_object_type;
+  unsigned m_coarse_max_dimension;
+  bool m_track_previous_corners;
+  double m_search_margin;
+
+  /// Corners found in the previous frame, used to seed the next search
+  std::vector< cv::Point2f > m_previous_corners;
 
   kv::logger_handle_t m_logger;
+
+  // Search corners in the region of interest, downscaling the region if coarse search is enabled.
+  // Found corners are expressed in the full image coordinates along with the search scale.
+  bool find_corners_in_region( const cv::Mat& gray, const cv::Rect& roi,
+                               std::vector< cv::Point2f >& corners, double& scale ) const;
+
+  // Search corners around the previous frame corners first if enabled, then in the full image
+  bool find_corners( const cv::Mat& gray, std::vector< cv::Point2f >& corners, double& scale );
 }; // end class ocv_target_detector::priv
 
 
+// -------------------------------------------------------------------------------------------------
+bool
+ocv_target_detector::priv
+::find_corners_in_region( const cv::Mat& gray, const cv::Rect& roi,
+                          std::vector< cv::Point2f >& corners, double& scale ) const
+{
+  const cv::Size board_size( m_target_width, m_target_height );
+  cv::Mat region = gray( roi );
+
+  scale = 1.0;
+  const int max_dimension = std::max( roi.width, roi.height );
+  if( m_coarse_max_dimension > 0 && max_dimension > static_cast< int >( m_coarse_max_dimension ) )
+  {
+    scale = static_cast< double >( max_dimension ) / m_coarse_max_dimension;
+    cv::Mat coarse;
+    cv::resize( region, coarse, cv::Size(), 1.0 / scale, 1.0 / scale, cv::INTER_AREA );
+    region = coarse;
+  }
+
+  if( !cv::findChessboardCorners( region, board_size, corners, cv::CALIB_CB_ADAPTIVE_THRESH ) )
+  {
+    return false;
+  }
+
+  for( auto& corner : corners )
+  {
+    corner.x = static_cast< float >( corner.x * scale + roi.x );
+    corner.y = static_cast< float >( corner.y * scale + roi.y );
+  }
+  return true;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+bool
+ocv_target_detector::priv
+::find_corners( const cv::Mat& gray, std::vector< cv::Point2f >& corners, double& scale )
+{
+  const cv::Rect image_rect( 0, 0, gray.cols, gray.rows );
+
+  if( m_track_previous_corners && !m_previous_corners.empty() )
+  {
+    // Expand previous target extent by the search margin in each direction
+    const cv::Rect previous = cv::boundingRect( m_previous_corners );
+    const int margin_x = static_cast< int >( previous.width * m_search_margin ) + 1;
+    const int margin_y = static_cast< int >( previous.height * m_search_margin ) + 1;
+    const cv::Rect roi = cv::Rect( previous.x - margin_x, previous.y - margin_y,
+                                   previous.width + 2 * margin_x,
+                                   previous.height + 2 * margin_y ) & image_rect;
+
+    if( roi.area() > 0 && roi != image_rect &&
+        find_corners_in_region( gray, roi, corners, scale ) )
+    {
+      return true;
+    }
+
+    LOG_DEBUG( m_logger, "OCV target not found around previous corners, searching full image." );
+  }
+
+  return find_corners_in_region( gray, image_rect, corners, scale );
+}
+
+
 // =================================================================================================
 
 ocv_target_detector::
@@ -75,6 +156,15 @@ get_configuration() const
   config->set_value( "target_height", d->m_target_height, "Number of height corners of the detected ocv target" );
   config->set_value( "square_size", d->m_square_size, "Square size of the detected ocv target" );
   config->set_value( "object_type", d->m_object_type, "The detected object type" );
+  config->set_value( "coarse_max_dimension", d->m_coarse_max_dimension,
+    "If non zero, corners are first searched in a copy of the image downscaled to this maximum "
+    "dimension, then refined at full resolution around the found corners." );
+  config->set_value( "track_previous_corners", d->m_track_previous_corners,
+    "If true, corners are first searched around the corners found in the previous frame, "
+    "falling back to the full image if the target is not found." );
+  config->set_value( "search_margin", d->m_search_margin,
+    "Margin added on each side of the previous target extent, relative to the target size. "
+    "Used when track_previous_corners is true." );
   
   return config;
 }
@@ -93,6 +183,10 @@ set_configuration( kv::config_block_sptr config_in )
   d->m_target_height = config->get_value< unsigned >( "target_height" );
   d->m_square_size = config->get_value< float >( "square_size" );
   d->m_object_type = config->get_value< std::string >( "object_type" );
+  d->m_coarse_max_dimension = config->get_value< unsigned >( "coarse_max_dimension" );
+  d->m_track_previous_corners = config->get_value< bool >( "track_previous_corners" );
+  d->m_search_margin = config->get_value< double >( "search_margin" );
+  d->m_previous_corners.clear();
 }
 
 
@@ -142,17 +236,21 @@ detect( kv::image_container_sptr image_data ) const
     cv::cvtColor( src, src, cv::COLOR_RGB2GRAY );
   }
 
-  cornersFound = cv::findChessboardCorners(src, boardSize, corners, cv::CALIB_CB_ADAPTIVE_THRESH);
+  double search_scale = 1.0;
+  cornersFound = d->find_corners(src, corners, search_scale);
     
   if( !cornersFound || (corners.size() != world_corners.size()) )
   {
     LOG_WARN( d->m_logger, "Unable to find an OCV target. Found " << corners.size() << " corners" );
+    d->m_previous_corners.clear();
     return detected_set;
   }
   
-  // refine subpixel corner location
+  // refine subpixel corner location, widening the window to cover the coarse search error
+  const int half_window = std::max( 11, static_cast< int >( std::ceil( 2.0 * search_scale ) ) );
   auto term_criteria = cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.001);
-  cv::cornerSubPix(src, corners, cv::Size(11,11), cv::Size(-1,-1), term_criteria);
+  cv::cornerSubPix(src, corners, cv::Size(half_window, half_window), cv::Size(-1,-1), term_criteria);
+  d->m_previous_corners = corners;
 
   for(unsigned i = 0; i < corners.size();i++)
   {
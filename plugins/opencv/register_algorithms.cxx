@@ -42,7 +42,10 @@
 #include "ocv_random_hue_shift.h"
 #include "ocv_image_enhancement.h"
 #include "ocv_target_detector.h"
+#include "ocv_gmm_motion_detector.h"
 #include "ocv_optimize_stereo_cameras.h"
+#include "ocv_reduced_image_io.h"
+#include "ocv_overlay_renderer.h"
 
 #include "split_image_habcam.h"
 
@@ -66,7 +69,10 @@ register_factories( kwiver::vital::plugin_loader& vpm )
   reg.register_algorithm< ocv_random_hue_shift >();
   reg.register_algorithm< ocv_rectified_stereo_disparity_map >();
   reg.register_algorithm< ocv_target_detector >();
+  reg.register_algorithm< ocv_gmm_motion_detector >();
   reg.register_algorithm< ocv_optimize_stereo_cameras >();
+  reg.register_algorithm< ocv_reduced_image_io >();
+  reg.register_algorithm< ocv_overlay_renderer >();
   reg.register_algorithm< split_image_habcam >();
 
   reg.mark_module_as_loaded();
@@ -11,6 +11,8 @@
 
 #include <arrows/ocv/image_container.h>
 
+#include <vital/types/image_container.h>
+
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
@@ -23,15 +25,35 @@ public:
   priv()
     : m_require_stereo( false )
     , m_required_width_factor( 2.0 )
+    , m_vital_views( false )
   {}
 
   ~priv() {}
 
   bool m_require_stereo;
   double m_required_width_factor;
+  bool m_vital_views;
 };
 
 
+namespace {
+
+// Vital image view of the columns [x, x + width) of an image, sharing its memory
+kwiver::vital::image_container_sptr
+column_view( const kwiver::vital::image& image, size_t x, size_t width )
+{
+  const auto* first_pixel = static_cast< const unsigned char* >( image.first_pixel() ) +
+    x * image.w_step() * image.pixel_traits().num_bytes;
+
+  return std::make_shared< kwiver::vital::simple_image_container >(
+    kwiver::vital::image( image.memory(), first_pixel, width, image.height(),
+      image.depth(), image.w_step(), image.h_step(), image.d_step(),
+      image.pixel_traits() ) );
+}
+
+} // end anonymous namespace
+
+
 /// Constructor
 split_image_habcam
 ::split_image_habcam()
@@ -59,6 +81,10 @@ split_image_habcam
   config->set_value( "required_width_factor",
     d->m_required_width_factor,
     "If the width is this time as many heights, it is a stereo pair." );
+  config->set_value( "vital_views",
+    d->m_vital_views,
+    "Output the two halves as vital image views sharing the memory of the input "
+    "image, instead of OpenCV image containers." );
 
   return config;
 }
@@ -75,6 +101,8 @@ split_image_habcam
     config->get_value< bool >( "require_stereo" );
   d->m_required_width_factor =
     config->get_value< double >( "required_width_factor" );
+  d->m_vital_views =
+    config->get_value< bool >( "vital_views" );
 }
 
 
@@ -93,7 +121,16 @@ split_image_habcam
 {
   std::vector< kwiver::vital::image_container_sptr > output;
 
-  if( image->width() >= d->m_required_width_factor * image->height() )
+  if( image->width() >= d->m_required_width_factor * image->height() &&
+      d->m_vital_views && image->get_image().memory() )
+  {
+    const kwiver::vital::image vital_image = image->get_image();
+    const size_t half_width = vital_image.width() / 2;
+
+    output.push_back( column_view( vital_image, 0, half_width ) );
+    output.push_back( column_view( vital_image, half_width, half_width ) );
+  }
+  else if( image->width() >= d->m_required_width_factor * image->height() )
   {
     cv::Mat cv_image =
       kwiver::arrows::ocv::image_container::vital_to_ocv(
@@ -107,13 +144,21 @@ split_image_habcam
       cv_image(
         cv::Rect( cv_image.cols / 2, 0, cv_image.cols / 2, cv_image.rows ) );
 
+    // Crops of a reference counted image keep it alive and are output as is, only images
+    // borrowing memory they do not own are copied
+    if( !cv_image.u )
+    {
+      left_image = left_image.clone();
+      right_image = right_image.clone();
+    }
+
     output.push_back(
       kwiver::vital::image_container_sptr(
-        new kwiver::arrows::ocv::image_container( left_image.clone(),
+        new kwiver::arrows::ocv::image_container( left_image,
         kwiver::arrows::ocv::image_container::RGB_COLOR ) ) );
     output.push_back(
       kwiver::vital::image_container_sptr(
-        new kwiver::arrows::ocv::image_container( right_image.clone(),
+        new kwiver::arrows::ocv::image_container( right_image,
         kwiver::arrows::ocv::image_container::RGB_COLOR ) ) );
   }
   else
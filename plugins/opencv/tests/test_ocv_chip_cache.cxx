@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "ocv_chip_cache.h"
+
+#include <arrows/ocv/image_container.h>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+using namespace viame;
+
+namespace {
+
+kwiver::vital::image make_frame() {
+  kwiver::vital::image_of<uint8_t> frame(64, 48, 3);
+  for (unsigned j = 0; j < 48; ++j) {
+    for (unsigned i = 0; i < 64; ++i) {
+      for (unsigned k = 0; k < 3; ++k) {
+        frame(i, j, k) = static_cast<uint8_t>(i * 3 + j + k * 50);
+      }
+    }
+  }
+  return frame;
+}
+
+} // namespace
+
+TEST(ChipCacheTest, converted_chips_are_shared_between_users) {
+  auto &cache = ocv_chip_cache::instance();
+  cache.clear();
+
+  const kwiver::vital::image frame = make_frame();
+  const cv::Mat src = kwiver::arrows::ocv::image_container::vital_to_ocv(frame);
+  const kwiver::vital::bounding_box_d box(10, 5, 30, 25);
+
+  cv::Mat first = cache.get(frame, src, box, cv::Size(), CV_RGB2GRAY);
+  cv::Mat second = cache.get(frame, src, box, cv::Size(), CV_RGB2GRAY);
+  ASSERT_EQ(first.size(), cv::Size(20, 20));
+  EXPECT_EQ(first.data, second.data);
+
+  cv::Mat expected;
+  cv::cvtColor(src(cv::Rect(10, 5, 20, 20)), expected, CV_RGB2GRAY);
+  EXPECT_EQ(cv::countNonZero(first != expected), 0);
+
+  // Another target size is another chip
+  cv::Mat resized = cache.get(frame, src, box, cv::Size(8, 8), CV_RGB2GRAY);
+  EXPECT_EQ(resized.size(), cv::Size(8, 8));
+  EXPECT_EQ(cache.cached_bytes(), 20u * 20u + 8u * 8u);
+  cache.clear();
+}
+
+TEST(ChipCacheTest, chips_of_released_frames_are_dropped) {
+  auto &cache = ocv_chip_cache::instance();
+  cache.clear();
+
+  const kwiver::vital::bounding_box_d box(0, 0, 16, 16);
+  {
+    const kwiver::vital::image frame = make_frame();
+    const cv::Mat src = kwiver::arrows::ocv::image_container::vital_to_ocv(frame);
+    cache.get(frame, src, box, cv::Size(), CV_RGB2GRAY);
+  }
+  EXPECT_EQ(cache.cached_bytes(), 16u * 16u);
+
+  const kwiver::vital::image frame = make_frame();
+  const cv::Mat src = kwiver::arrows::ocv::image_container::vital_to_ocv(frame);
+  cache.get(frame, src, box, cv::Size(), CV_RGB2GRAY);
+  EXPECT_EQ(cache.cached_bytes(), 16u * 16u);
+
+  // Chips needing no conversion are views of the frame
+  cv::Mat view = cache.get(frame, src, box);
+  EXPECT_EQ(view.data, src.data);
+  cache.clear();
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "ocv_image_buffer_pool.h"
+
+using namespace viame;
+
+TEST(ImageBufferPoolTest, released_buffers_are_reused_for_the_same_size) {
+  auto &pool = ocv_image_buffer_pool::instance();
+  pool.clear();
+
+  const uchar *first_data{};
+  {
+    cv::Mat image;
+    ocv_image_buffer_pool::attach(image);
+    image.create(480, 640, CV_8UC3);
+    first_data = image.data;
+  }
+  EXPECT_EQ(pool.pooled_bytes(), 480u * 640u * 3u);
+
+  // Same byte size, different shape
+  cv::Mat image;
+  ocv_image_buffer_pool::attach(image);
+  image.create(640, 480, CV_8UC3);
+  EXPECT_EQ(image.data, first_data);
+  EXPECT_EQ(pool.pooled_bytes(), 0u);
+}
+
+TEST(ImageBufferPoolTest, buffers_return_to_the_pool_after_the_last_reference) {
+  auto &pool = ocv_image_buffer_pool::instance();
+  pool.clear();
+
+  cv::Mat image;
+  ocv_image_buffer_pool::attach(image);
+  image.create(100, 100, CV_16UC1);
+
+  cv::Mat shared = image;
+  image.release();
+  EXPECT_EQ(pool.pooled_bytes(), 0u);
+
+  shared.release();
+  EXPECT_EQ(pool.pooled_bytes(), 100u * 100u * 2u);
+  pool.clear();
+}
+
+TEST(ImageBufferPoolTest, pool_respects_its_limits) {
+  auto &pool = ocv_image_buffer_pool::instance();
+  pool.set_limits(1, 1024 * 1024);
+
+  {
+    cv::Mat first, second;
+    ocv_image_buffer_pool::attach(first);
+    ocv_image_buffer_pool::attach(second);
+    first.create(10, 10, CV_8UC1);
+    second.create(10, 10, CV_8UC1);
+  }
+  EXPECT_EQ(pool.pooled_bytes(), 100u);
+
+  {
+    cv::Mat large;
+    ocv_image_buffer_pool::attach(large);
+    large.create(2048, 2048, CV_8UC1);
+  }
+  EXPECT_EQ(pool.pooled_bytes(), 100u);
+
+  pool.set_limits(4, size_t(1) << 30);
+}
@@ -231,3 +231,40 @@ TEST(StereoFeatureTrackFilterTest, using_max_frame_count_of_0_returns_all_frames
   auto out_coord = StereoFeatureTrackFilter::select_frames(feature_tracks, landmarks, max_frame_count);
   EXPECT_EQ(out_coord.frame_ids.size(), n_frames);
 }
+
+TEST(StereoFeatureTrackFilterTest, coverage_selection_replaces_redundant_frames) {
+  // Frames 0 and 1 cover the top left corner of the image, frame 2 covers the bottom right corner
+  StereoPointCoordinates coordinates;
+  for (const auto &pt: {cv::Point2f{10, 10}, cv::Point2f{12, 12}, cv::Point2f{1200, 700}}) {
+    coordinates.image_pts[0].push_back({pt});
+    coordinates.image_pts[1].push_back({pt});
+    coordinates.world_pts.push_back({cv::Point3f{}});
+    coordinates.frame_ids.push_back(coordinates.frame_ids.size());
+  }
+
+  CoverageFrameSelector selector{2, cv::Size{1280, 720}};
+  EXPECT_TRUE(selector.add_frame(coordinates, 0));
+  EXPECT_TRUE(selector.add_frame(coordinates, 1));
+  EXPECT_TRUE(selector.add_frame(coordinates, 2));
+
+  // Redundant frame doesn't replace any frame
+  EXPECT_FALSE(selector.add_frame(coordinates, 1));
+
+  auto selected = selector.selected_frames();
+  ASSERT_EQ(selected.frame_ids, (std::vector<size_t>{1, 2}));
+  EXPECT_EQ(selected.image_pts[0].size(), 2);
+  EXPECT_EQ(selected.world_pts.size(), 2);
+}
+
+TEST(StereoFeatureTrackFilterTest, coverage_selection_returns_at_most_threshold_frames) {
+  size_t n_frames{100};
+  auto tracks_and_landmarks = convert_to_feature_tracks_and_landmarks(generate_54_stereo_points_per_frame(n_frames),
+                                                                      2, n_frames);
+
+  size_t max_frame_count{20};
+  auto out_coord = StereoFeatureTrackFilter::select_frames_by_coverage(std::get<0>(tracks_and_landmarks),
+                                                                       std::get<1>(tracks_and_landmarks),
+                                                                       max_frame_count, cv::Size{1280, 720});
+  EXPECT_EQ(out_coord.frame_ids.size(), max_frame_count);
+  EXPECT_EQ(out_coord.image_pts[1].size(), max_frame_count);
+}
@@ -827,40 +827,99 @@ FGExtraction::postProcessing(InputArray src, OutputArray dst)
 	cvReleaseStructuringElement(&removeHorLine);*/
 }
 
+/*******************************************************************************
+* Function:      runningMedian1D
+* Description:   sliding window median of n samples spaced by step, using a
+                 histogram of the window updated by one sample per output
+                 (Huang's algorithm), so each output costs O(1) on average
+* Arguments:
+	in            -   first input sample
+	inStep        -   spacing between input samples
+	out           -   first output sample
+	outStep       -   spacing between output samples
+	n             -   number of samples
+	ksize         -   odd window size, samples closer than ksize/2 to the
+	                  borders are copied as they are
+
+* Returns:       void
+*******************************************************************************/
+static void runningMedian1D(const uchar* in, ptrdiff_t inStep, uchar* out, ptrdiff_t outStep, int n, int ksize)
+{
+	const int half = ksize/2;
+
+	for(int i = 0; i < n; ++i)
+		out[i*outStep] = in[i*inStep];
+
+	if(n < ksize)
+		return;
+
+	int hist[256] = {0};
+	for(int i = 0; i < ksize; ++i)
+		++hist[in[i*inStep]];
+
+	// median of the first window, with the count of samples below it
+	int med = 0, below = 0;
+	while(below + hist[med] <= half){
+		below += hist[med];
+		++med;
+	}
+	out[half*outStep] = (uchar)med;
+
+	for(int i = half+1; i < n-half; ++i){
+		const int removed = in[(i-half-1)*inStep];
+		const int added = in[(i+half)*inStep];
+
+		--hist[removed];
+		if(removed < med)
+			--below;
+		++hist[added];
+		if(added < med)
+			++below;
+
+		// move the median until half the window is below or at it
+		while(below > half){
+			--med;
+			below -= hist[med];
+		}
+		while(below + hist[med] <= half){
+			below += hist[med];
+			++med;
+		}
+		out[i*outStep] = (uchar)med;
+	}
+}
+
 /*******************************************************************************
 * Function:      medianFilter  
-* Description:   performs median filter with kernel size kwidth*kheight
+* Description:   performs median filter with a 1D kernel of ksize pixels
 * Arguments:
-	src           -   input image
-	dst           -   output image
-	kwidth        -   
-	kheight       -   
+	src           -   8-bit single channel input image
+	dst           -   output image, pixels closer to the borders than half the
+	                  kernel are copied from the input
+	ksize         -   odd kernel size
+	isHorizontal  -   whether the kernel is horizontal or vertical
 	
 * Returns:       void
-* Comments:
+* Comments:      each pixel costs O(1) on average, independently of ksize
 * Revision: 
 *******************************************************************************/
-void FGExtraction::medianFilter(Mat src, Mat dst, int ksize, bool isHorizontal)
+void FGExtraction::medianFilter(InputArray src, OutputArray dst, int ksize, bool isHorizontal)
 {
 	assert(ksize % 2 == 1);
-	dst = src;
-	int kwidth = isHorizontal ? ksize : 1;
-	int kheight = isHorizontal ? 1 : ksize;
-
-	for(int y = kheight/2; y < src.rows-kheight/2; ++y){
-		for(int x = kwidth/2; x < src.cols-kwidth/2; ++x){
-			vector<uchar> vec;
-			vec.reserve(kwidth);
-			uchar* p = 0;
-			for(int v = -kheight/2; v <= kheight/2; ++v){
-				p = src.ptr(y+v);
-				for(int u = -kwidth/2; u <= kwidth/2; ++u)
-					vec.push_back(p[x+u]);
-			}
-				
-			sort(vec.begin(), vec.end());
-			p = src.ptr(y);
-			p[x] = vec[ksize/2];
-		}
+	Mat in = src.getMat();
+	CV_Assert(in.type() == CV_8UC1);
+
+	// a separate buffer, so the input is not altered and may also be the output
+	Mat out(in.size(), in.type());
+
+	if(isHorizontal){
+		for(int y = 0; y < in.rows; ++y)
+			runningMedian1D(in.ptr(y), 1, out.ptr(y), 1, in.cols, ksize);
+	}
+	else{
+		for(int x = 0; x < in.cols; ++x)
+			runningMedian1D(in.ptr(0)+x, (ptrdiff_t)in.step, out.ptr(0)+x, (ptrdiff_t)out.step, in.rows, ksize);
 	}
+
+	dst.assign(out);
 }
\ No newline at end of file
@@ -56,7 +56,7 @@ private:
 								 double minAspRatio, double maxAspRation, int varThresh = 30);
 	
 	void postProcessing(InputArray src, OutputArray dst);
-	void medianFilter(Mat src, Mat dst, int ksize, bool isHorizontal);
+	void medianFilter(InputArray src, OutputArray dst, int ksize, bool isHorizontal);
 
 	// data members
 	Mat		_inImg;
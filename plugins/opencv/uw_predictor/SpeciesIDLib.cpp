@@ -11,6 +11,8 @@
 #include "util.h"
 #include "SpeciesIDLib.h"
 
+#include <vital/logger/logger.h>
+
 #include <fstream>
 
 int FishSpeciesID::_dimFeat = 131;
@@ -43,6 +45,11 @@ void FishSpeciesID::saveModel(const char* filename)
 	_classHierarchy.saveModel(filename);
 }
 
+bool FishSpeciesID::saveBinaryModel(const char* filename)
+{
+	return _classHierarchy.saveBinaryModel(filename);
+}
+
 int FishSpeciesID::outputFeature(Mat img, Mat img2, Mat& feature) {
 	Mat fgRect(1,8,CV_64F);
 	Point shift;
@@ -52,7 +59,7 @@ int FishSpeciesID::outputFeature(Mat img, Mat img2, Mat& feature) {
 }
 
 
-void FishSpeciesID::train(Mat data, Mat labels)
+void FishSpeciesID::train(Mat data, Mat labels, unsigned numThreads)
 {
 	// change double to float
 	Mat trainData(data.rows, data.cols, CV_32FC1);
@@ -68,7 +75,7 @@ void FishSpeciesID::train(Mat data, Mat labels)
 			trainLabel.at<float>(i,j) = (float)(labels.at<double>(i,j));
 			//cout<<trainLabel.at<float>(i,j)<<endl;
 		}
-	_classHierarchy.train(trainData, trainLabel);
+	_classHierarchy.train(trainData, trainLabel, numThreads);
 	_classHierarchy.saveModel("Model_SVM.xml");
 	return;
 	/*int N = img_name1.size();
@@ -105,7 +112,7 @@ bool FishSpeciesID::predict(Mat img, Mat img2, vector<int>& predictions, vector<
 	Mat rotateR;
 	int err = extractFeatures(img, img2, sample, false, true, fgRect, shift, rotateR);
 
-	cout<<err<<endl;
+	LOG_DEBUG(kwiver::vital::get_logger("viame.uw_predictor"), "Feature extraction status: " << err);
 	//waitKey(0);
 	//cout<<sample.at<float>(0,100)<<endl;
 	//cout<<sample.at<float>(0,104)<<endl;
@@ -119,14 +126,9 @@ bool FishSpeciesID::predict(Mat img, Mat img2, vector<int>& predictions, vector<
 
 	bool isPartial = false;
 	if (err==0) {
-		isPartial = _classHierarchy.predict(sample, predictions, probabilities);
-		//for (int kk = 0; kk < probabilities.size(); kk++)
-			//cout<<probabilities[kk]<<endl;
-		//cout<<predictions.back()<<endl;
-		//cout<<predictions[0]<<endl;
 		vector<int> class_label;
 		vector<vector<double>> probb;
-		bool temp = _classHierarchy.predict2(sample, class_label, probb);
+		isPartial = _classHierarchy.predictHierarchy(sample, predictions, probabilities, class_label, probb);
 
 		int pred = predictions.back();
 		//cout<<pred<<endl;
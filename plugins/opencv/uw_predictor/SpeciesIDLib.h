@@ -10,6 +10,7 @@
 #ifndef _UWEE_SPECIES_ID_LIB_H_
 #define _UWEE_SPECIES_ID_LIB_H_
 
+#include <atomic>
 #include <vector>
 
 #include <opencv2/core/core.hpp>
@@ -42,13 +43,16 @@ public:
 	// save classifier model to a file
 	void saveModel(const char* filename);
 
+	// save the loaded classifier model as a binary file, which loadModel also reads
+	bool saveBinaryModel(const char* filename);
+
 	// output features
 	int outputFeature(Mat img, Mat img2, Mat& feature);
 
-	// training routine
-	void train(Mat data, Mat labels);
+	// training routine, training the classifier nodes on numThreads threads (0 for all cores)
+	void train(Mat data, Mat labels, unsigned numThreads = 1);
 
-	// testing routine
+	// testing routine, which can be called concurrently once the model is loaded
 	bool predict(Mat img, Mat img2, vector<int>& predictions, vector<double>& probabilities, Mat &fgRect);
 
 	int getDimFeat() {return _dimFeat;};
@@ -59,7 +63,7 @@ private:
 
 	ClassHierarchy _classHierarchy;
 	static int _dimFeat;
-	int _count;
+	std::atomic<int> _count;
 
 public:
 	//////////////////////////////////////////////////////////////////////////
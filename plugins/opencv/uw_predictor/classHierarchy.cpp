@@ -9,15 +9,162 @@
 //
 
 #include <map>
+#include <mutex>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "classHierarchy.h"
 #include "snprintf.h"
 
+#include <plugins/core/thread_pool.h>
+
+//********** binary model format *************************************************
+//
+// A binary model is a header, a table of nodes, then for each node the alpha
+// coefficients (double) and support vectors (float, varCount per vector) of its
+// RBF SVM, at 8-byte aligned offsets from the start of the file.
+
+static const char compactMagic[8] = { 'U', 'W', 'C', 'H', 'B', 'I', 'N', '1' };
+
+struct CompactModelHeader
+{
+	char      magic[8];
+	int32_t   numClasses;
+	int32_t   nodeCount;
+	int32_t   varCount;
+	int32_t   reserved;
+};
+
+struct CompactNode
+{
+	int32_t   id;
+	int32_t   posClass;
+	int32_t   negClass;
+	int32_t   svCount;
+
+	// SVM labels of positive and non-positive decision values
+	int32_t   labelPos;
+	int32_t   labelNeg;
+
+	double    margin;
+	double    decThresh;
+	double    sigA;
+	double    sigB;
+	double    mu1, mu2, sigma1, sigma2, w1, w2;
+
+	// RBF SVM decision function
+	double    gamma;
+	double    rho;
+
+	// offset of the alpha coefficients, followed by the support vectors
+	uint64_t  dataOffset;
+};
+
+// read-only mapping of a binary model file
+class MappedModelFile
+{
+public:
+	~MappedModelFile();
+
+	// maps the file once, loads of the same file share the mapping while it is in use
+	static std::shared_ptr< const MappedModelFile > open(const string& filename);
+
+	const char* data() const { return _data; }
+	size_t size() const { return _size; }
+
+private:
+	MappedModelFile() : _data(0), _size(0) {}
+
+	const char* _data;
+	size_t _size;
+#ifdef _WIN32
+	HANDLE _file;
+	HANDLE _mapping;
+#endif
+};
+
+MappedModelFile::~MappedModelFile()
+{
+#ifdef _WIN32
+	if(_data) UnmapViewOfFile(_data);
+	if(_mapping) CloseHandle(_mapping);
+	if(_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+#else
+	if(_data) munmap(const_cast< char* >(_data), _size);
+#endif
+}
+
+std::shared_ptr< const MappedModelFile > MappedModelFile::open(const string& filename)
+{
+	static std::mutex mutex;
+	static map< string, std::weak_ptr< const MappedModelFile > > opened;
+
+	std::lock_guard< std::mutex > lock(mutex);
+	std::shared_ptr< const MappedModelFile > result = opened[filename].lock();
+	if(result)
+		return result;
+
+	std::shared_ptr< MappedModelFile > file(new MappedModelFile);
+#ifdef _WIN32
+	file->_mapping = NULL;
+	file->_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file->_file == INVALID_HANDLE_VALUE)
+		return result;
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file->_file, &size) || size.QuadPart == 0)
+		return result;
+	file->_mapping = CreateFileMappingA(file->_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(!file->_mapping)
+		return result;
+	file->_data = (const char*)MapViewOfFile(file->_mapping, FILE_MAP_READ, 0, 0, 0);
+	file->_size = (size_t)size.QuadPart;
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if(fd < 0)
+		return result;
+	struct stat st;
+	if(fstat(fd, &st) == 0 && st.st_size > 0){
+		void* data = mmap(0, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if(data != MAP_FAILED){
+			file->_data = (const char*)data;
+			file->_size = (size_t)st.st_size;
+		}
+	}
+	::close(fd);
+#endif
+	if(!file->_data)
+		return result;
+
+	opened[filename] = file;
+	return file;
+}
+
+static bool isBinaryModel(const string& filename)
+{
+	char magic[sizeof(compactMagic)] = {0};
+	ifstream fin(filename.c_str(), ios::binary);
+	fin.read(magic, sizeof(magic));
+	return fin && memcmp(magic, compactMagic, sizeof(magic)) == 0;
+}
+
 //********** class classHierarchyNode ********************************************
 
 ClassHierarchyNode::ClassHierarchyNode(int id) :
 	_ID(id), _posClass(-1), _negClass(-1),
-	_margin(0), _decThresh(0), _sigA(0), _sigB(0), _mu1(0), _mu2(0), _sigma1(1), _sigma2(1), _w1(0.5), _w2(0.5)
+	_margin(0), _decThresh(0), _sigA(0), _sigB(0), _mu1(0), _mu2(0), _sigma1(1), _sigma2(1), _w1(0.5), _w2(0.5),
+	_compact(0), _varCount(0)
 {
   _svm = std::shared_ptr< SVM >( new SVM );
 
@@ -29,7 +176,8 @@ ClassHierarchyNode::ClassHierarchyNode(int id) :
 
 ClassHierarchyNode::ClassHierarchyNode() :
 	_ID(-1), _posClass(-1), _negClass(-1),
-	_margin(0), _decThresh(0), _sigA(0), _sigB(0), _mu1(0), _mu2(0), _sigma1(1), _sigma2(1), _w1(0.5), _w2(0.5)
+	_margin(0), _decThresh(0), _sigA(0), _sigB(0), _mu1(0), _mu2(0), _sigma1(1), _sigma2(1), _w1(0.5), _w2(0.5),
+	_compact(0), _varCount(0)
 {
   _svm = std::shared_ptr< SVM >( new SVM );
 }
@@ -47,6 +195,13 @@ void ClassHierarchyNode::trainSVM(Mat trainData, Mat labels)
 	}
 
 
+	// nodes of the hierarchy are copies of one prototype, give this node its own
+	// SVM so that nodes do not train a shared instance, possibly concurrently
+	_svm = std::shared_ptr< SVM >( new SVM );
+	_svmFile.clear();
+	_mappedFile.reset();
+	_compact = 0;
+
 	int k_fold = 10;
 
 	// count numbers of positive and negative data
@@ -499,8 +654,8 @@ double ClassHierarchyNode::trainPartialNew(Mat decVals, Mat labels)
 
 int ClassHierarchyNode::predictSVM( Mat sample, double& prob )
 {
-	int result = (int)_svm->predict(sample);
-	double decVal = _svm->predict(sample, true);
+	int result;
+	double decVal = decisionValue(sample, result);
 
 	// get probabilistic output
 	prob = 1.0 / (1.0 + exp(_sigA * decVal + _sigB));
@@ -516,8 +671,8 @@ int ClassHierarchyNode::predictSVM( Mat sample, double& prob )
 
 int ClassHierarchyNode::predictSVM2( Mat sample, double& prob_pos, double& prob_neg )
 {
-	int result = (int)_svm->predict(sample);
-	double decVal = _svm->predict(sample, true);
+	int result;
+	double decVal = decisionValue(sample, result);
 
 	prob_pos = 1/(sqrt(2*PI_)*_sigma1)*exp(-(decVal-_mu1)*(decVal-_mu1)/(2*_sigma1*_sigma1))*_w1;
 	prob_neg = 1/(sqrt(2*PI_)*_sigma2)*exp(-(decVal-_mu2)*(decVal-_mu2)/(2*_sigma2*_sigma2))*_w2;
@@ -541,6 +696,91 @@ int ClassHierarchyNode::predictSVM2( Mat sample, double& prob_pos, double& prob_
 	return result;
 }
 
+int ClassHierarchyNode::predictSVMAll( Mat sample, double& prob, double& prob_pos, double& prob_neg )
+{
+	int result;
+	double decVal = decisionValue(sample, result);
+
+	return decisionOutputs(result, decVal, prob, prob_pos, prob_neg);
+}
+
+void ClassHierarchyNode::predictSVMBatch( Mat samples, vector<int>& results, vector<double>& prob,
+	vector<double>& prob_pos, vector<double>& prob_neg )
+{
+	int n = samples.rows;
+	results.resize(n);
+	prob.resize(n);
+	prob_pos.resize(n);
+	prob_neg.resize(n);
+	if(n == 0)
+		return;
+
+	if(_compact){
+		for(int i = 0; i < n; ++i){
+			int label;
+			double decVal = decisionValue(samples.row(i), label);
+			results[i] = decisionOutputs(label, decVal, prob[i], prob_pos[i], prob_neg[i]);
+		}
+		return;
+	}
+
+	// labels of all the rows at once, the decision values are only available per sample
+	Mat labels;
+	_svm->predict(samples, labels);
+
+	for(int i = 0; i < n; ++i){
+		double decVal = _svm->predict(samples.row(i), true);
+		results[i] = decisionOutputs((int)labels.at<float>(i, 0), decVal, prob[i], prob_pos[i], prob_neg[i]);
+	}
+}
+
+double ClassHierarchyNode::decisionValue( Mat sample, int& label )
+{
+	if(!_compact){
+		label = (int)_svm->predict(sample);
+		return _svm->predict(sample, true);
+	}
+
+	CV_Assert(sample.type() == CV_32F && sample.rows == 1 && sample.cols == _varCount);
+
+	// same RBF decision function as the OpenCV SVM, evaluated on the mapped data
+	const double* alpha = (const double*)(_mappedFile->data() + _compact->dataOffset);
+	const float* sv = (const float*)(alpha + _compact->svCount);
+	const float* x = sample.ptr<float>(0);
+
+	double sum = -_compact->rho;
+	for(int i = 0; i < _compact->svCount; ++i, sv += _varCount){
+		double dist = 0;
+		for(int k = 0; k < _varCount; ++k){
+			double t = x[k] - sv[k];
+			dist += t * t;
+		}
+		sum += alpha[i] * exp(-_compact->gamma * dist);
+	}
+
+	label = sum > 0 ? _compact->labelPos : _compact->labelNeg;
+	return (float)sum;
+}
+
+int ClassHierarchyNode::decisionOutputs( int label, double decVal, double& prob, double& prob_pos, double& prob_neg )
+{
+	// sigmoid output of predictSVM
+	prob = 1.0 / (1.0 + exp(_sigA * decVal + _sigB));
+
+	// gaussian mixture output of predictSVM2
+	prob_pos = 1/(sqrt(2*PI_)*_sigma1)*exp(-(decVal-_mu1)*(decVal-_mu1)/(2*_sigma1*_sigma1))*_w1;
+	prob_neg = 1/(sqrt(2*PI_)*_sigma2)*exp(-(decVal-_mu2)*(decVal-_mu2)/(2*_sigma2*_sigma2))*_w2;
+
+	prob_pos = prob_pos/(prob_pos+prob_neg);
+	prob_neg = 1-prob_pos;
+
+	// label 0 if the sample is ambiguous
+	if(abs(decVal) < _decThresh)
+		label = 0;
+
+	return label;
+}
+
 void ClassHierarchyNode::write(FileStorage& fs) const
 {
 	fs << "{";
@@ -579,6 +819,7 @@ void ClassHierarchyNode::read(const FileNode& fn)
 
 	string file = (string)fn["svm_file"];
 	_svm->load(file.c_str());
+	_svmFile = file;
 
 	_margin = (double)fn["margin"];
 	_decThresh = (double)fn["dec_thresh"];
@@ -593,6 +834,100 @@ void ClassHierarchyNode::read(const FileNode& fn)
 	_w2 = (double)fn["w2"];
 }
 
+bool ClassHierarchyNode::writeCompact(CompactNode& node, vector<double>& alpha, vector<float>& sv, int& varCount) const
+{
+	// the decision function is only available from the saved SVM file
+	FileStorage fs(_svmFile, FileStorage::READ);
+	if(!fs.isOpened()){
+		cerr << "Error: cannot read the SVM of node #" << _ID << " from \"" << _svmFile << "\"." << endl;
+		return false;
+	}
+	FileNode svm = fs.getFirstTopLevelNode();
+
+	if((string)svm["kernel"]["type"] != "RBF" || (int)svm["class_count"] != 2){
+		cerr << "Error: only two-class RBF SVMs have a binary form, see node #" << _ID << "." << endl;
+		return false;
+	}
+
+	varCount = (int)svm["var_count"];
+
+	Mat classLabels;
+	svm["class_labels"] >> classLabels;
+	classLabels.convertTo(classLabels, CV_32S);
+
+	vector< vector<float> > supportVectors;
+	for(FileNodeIterator it = svm["support_vectors"].begin(); it != svm["support_vectors"].end(); ++it){
+		supportVectors.push_back(vector<float>());
+		*it >> supportVectors.back();
+	}
+
+	FileNode df = *svm["decision_functions"].begin();
+	int svCount = (int)df["sv_count"];
+	df["alpha"] >> alpha;
+	vector<int> index;
+	df["index"] >> index;
+
+	if((int)alpha.size() != svCount || classLabels.total() != 2){
+		cerr << "Error: invalid decision function for node #" << _ID << "." << endl;
+		return false;
+	}
+
+	// support vectors in the order of their coefficients
+	sv.clear();
+	sv.reserve(svCount * varCount);
+	for(int i = 0; i < svCount; ++i){
+		int j = index.empty() ? i : index[i];
+		if(j < 0 || j >= (int)supportVectors.size() || (int)supportVectors[j].size() != varCount){
+			cerr << "Error: invalid support vector for node #" << _ID << "." << endl;
+			return false;
+		}
+		sv.insert(sv.end(), supportVectors[j].begin(), supportVectors[j].end());
+	}
+
+	memset(&node, 0, sizeof(node));
+	node.id = _ID;
+	node.posClass = _posClass;
+	node.negClass = _negClass;
+	node.svCount = svCount;
+	node.labelPos = classLabels.at<int>(0);
+	node.labelNeg = classLabels.at<int>(1);
+	node.margin = _margin;
+	node.decThresh = _decThresh;
+	node.sigA = _sigA;
+	node.sigB = _sigB;
+	node.mu1 = _mu1;
+	node.mu2 = _mu2;
+	node.sigma1 = _sigma1;
+	node.sigma2 = _sigma2;
+	node.w1 = _w1;
+	node.w2 = _w2;
+	node.gamma = (double)svm["kernel"]["gamma"];
+	node.rho = (double)df["rho"];
+
+	return true;
+}
+
+void ClassHierarchyNode::readCompact(std::shared_ptr< const MappedModelFile > file, const CompactNode* node, int varCount)
+{
+	_mappedFile = file;
+	_compact = node;
+	_varCount = varCount;
+
+	_ID = node->id;
+	_posClass = node->posClass;
+	_negClass = node->negClass;
+	_margin = node->margin;
+	_decThresh = node->decThresh;
+	_sigA = node->sigA;
+	_sigB = node->sigB;
+	_mu1 = node->mu1;
+	_mu2 = node->mu2;
+	_sigma1 = node->sigma1;
+	_sigma2 = node->sigma2;
+	_w1 = node->w1;
+	_w2 = node->w2;
+}
+
 void write(FileStorage& fs, const string& , const ClassHierarchyNode& x)
 {
 	x.write(fs);
@@ -619,7 +954,7 @@ ClassHierarchy::~ClassHierarchy()
 
 }
 
-void ClassHierarchy::train(Mat trainData, Mat trainLabels)
+void ClassHierarchy::train(Mat trainData, Mat trainLabels, unsigned numThreads)
 {
 	if(trainData.rows != trainLabels.rows){
 		cerr << "Error: number of training data and labels are not equal." << endl;
@@ -659,11 +994,133 @@ void ClassHierarchy::train(Mat trainData, Mat trainLabels)
 	}
 
 	// construct the class hierarchy by EM algorithm
-	clusterClassesRecursive(trainData, trainLabels, 1);
+	vector<NodeTraining> trainings;
+	clusterClassesRecursive(trainData, trainLabels, 1, trainings);
+
+	// the tree is complete, so each node SVM can be trained independently
+	if(numThreads == 1){
+		for(size_t i = 0; i < trainings.size(); ++i)
+			_hierarchy[trainings[i].id].trainSVM(trainings[i].data, trainings[i].labels);
+		return;
+	}
+
+	viame::thread_pool workers(numThreads);
+	vector< std::future<void> > results;
+	for(size_t i = 0; i < trainings.size(); ++i){
+		const NodeTraining& training = trainings[i];
+		ClassHierarchyNode& node = _hierarchy[training.id];
+		results.push_back(workers.enqueue([&node, &training]()
+		{
+			node.trainSVM(training.data, training.labels);
+		}));
+	}
 
+	// wait for every node before reporting the first failure
+	std::exception_ptr error;
+	for(size_t i = 0; i < results.size(); ++i){
+		try{
+			results[i].get();
+		}
+		catch(...){
+			if(!error)
+				error = std::current_exception();
+		}
+	}
+	if(error)
+		std::rethrow_exception(error);
+
+}
+
+const ClassHierarchy::NodePrediction& ClassHierarchy::evaluateNode(Mat sample, vector<NodePrediction>& cache, int node)
+{
+	NodePrediction& result = cache[node];
+	if(!result.evaluated){
+		result.pred = _hierarchy[node].predictSVMAll(sample, result.prob, result.probPos, result.probNeg);
+		result.evaluated = true;
+	}
+	return result;
 }
 
 bool ClassHierarchy::predict(Mat sample, vector<int>& predictions, vector<double>& probabilities)
+{
+	vector<NodePrediction> cache(_hierarchy.size());
+	return predictPath(sample, cache, predictions, probabilities);
+}
+
+bool ClassHierarchy::predict2(Mat sample, vector<int>& class_label, vector<vector<double>>& probb)
+{
+	vector<NodePrediction> cache(_hierarchy.size());
+	return predictLeaves(sample, cache, class_label, probb);
+}
+
+bool ClassHierarchy::predictHierarchy(Mat sample, vector<int>& predictions, vector<double>& probabilities,
+	vector<int>& class_label, vector<vector<double>>& probb)
+{
+	// both traversals share the node evaluations, so that each SVM runs at most once
+	vector<NodePrediction> cache(_hierarchy.size());
+	bool isPartial = predictPath(sample, cache, predictions, probabilities);
+	predictLeaves(sample, cache, class_label, probb);
+	return isPartial;
+}
+
+vector<bool> ClassHierarchy::predictHierarchyBatch(Mat samples, vector<vector<int>>& predictions,
+	vector<vector<double>>& probabilities, vector<vector<int>>& class_label,
+	vector<vector<vector<double>>>& probb)
+{
+	int n = samples.rows;
+	vector<vector<NodePrediction>> caches(n, vector<NodePrediction>(_hierarchy.size()));
+
+	// rows reaching each node, children always have a larger index than their parent
+	vector<vector<int>> routed(_hierarchy.size());
+	if(_hierarchy.size() > 1)
+		for(int r = 0; r < n; ++r)
+			routed[1].push_back(r);
+
+	vector<int> results;
+	vector<double> prob, probPos, probNeg;
+	for(size_t node = 1; node < _hierarchy.size(); ++node){
+		const vector<int>& rows = routed[node];
+		if(rows.empty() || _hierarchy[node].getID() == -1)
+			continue;
+
+		Mat nodeSamples(rows.size(), samples.cols, samples.type());
+		for(size_t k = 0; k < rows.size(); ++k)
+			samples.row(rows[k]).copyTo(nodeSamples.row(k));
+
+		_hierarchy[node].predictSVMBatch(nodeSamples, results, prob, probPos, probNeg);
+
+		for(size_t k = 0; k < rows.size(); ++k){
+			NodePrediction& eval = caches[rows[k]][node];
+			eval.pred = results[k];
+			eval.prob = prob[k];
+			eval.probPos = probPos[k];
+			eval.probNeg = probNeg[k];
+			eval.evaluated = true;
+
+			// ambiguous rows stop here, the others continue to both children for predictLeaves
+			if(results[k] == 0)
+				continue;
+			for(size_t child = 2*node; child <= 2*node + 1 && child < _hierarchy.size(); ++child)
+				routed[child].push_back(rows[k]);
+		}
+	}
+
+	// the traversals only read the cached node outputs
+	vector<bool> isPartial(n);
+	predictions.resize(n);
+	probabilities.resize(n);
+	class_label.resize(n);
+	probb.resize(n);
+	for(int r = 0; r < n; ++r){
+		Mat sample = samples.row(r);
+		isPartial[r] = predictPath(sample, caches[r], predictions[r], probabilities[r]);
+		predictLeaves(sample, caches[r], class_label[r], probb[r]);
+	}
+
+	return isPartial;
+}
+
+bool ClassHierarchy::predictPath(Mat sample, vector<NodePrediction>& cache, vector<int>& predictions, vector<double>& probabilities)
 {
 	predictions.clear();
 	probabilities.clear();
@@ -672,8 +1129,9 @@ bool ClassHierarchy::predict(Mat sample, vector<int>& predictions, vector<double
 	int i = 1;
 
 	while(i < _hierarchy.size()){
-		double prob = 0;
-		int pred = _hierarchy[i].predictSVM(sample, prob);
+		const NodePrediction& eval = evaluateNode(sample, cache, i);
+		double prob = eval.prob;
+		int pred = eval.pred;
 		if(pred == 0){
 			isPartial = true;
 			predictions.push_back(-1);
@@ -697,7 +1155,7 @@ bool ClassHierarchy::predict(Mat sample, vector<int>& predictions, vector<double
 	return isPartial;
 }
 
-bool ClassHierarchy::predict2(Mat sample, vector<int>& class_label, vector<vector<double>>& probb)
+bool ClassHierarchy::predictLeaves(Mat sample, vector<NodePrediction>& cache, vector<int>& class_label, vector<vector<double>>& probb)
 {
 	//predictions.push_back(1);
 	//probabilities.push_back(1.0);
@@ -731,8 +1189,9 @@ bool ClassHierarchy::predict2(Mat sample, vector<int>& class_label, vector<vecto
 				continue;
 			}
 			int current_node = nodeID[n].back();
-			double prob = 0, prob_pos = 0.0, prob_neg = 0.0;
-			int pred = _hierarchy[current_node].predictSVM2(sample, prob_pos, prob_neg);
+			const NodePrediction& eval = evaluateNode(sample, cache, current_node);
+			double prob_pos = eval.probPos, prob_neg = eval.probNeg;
+			int pred = eval.pred;
 			if(pred == 0){
 				isPartial = true;
 				break;
@@ -792,7 +1251,7 @@ bool ClassHierarchy::predict2(Mat sample, vector<int>& class_label, vector<vecto
 }
 
 // recursively cluster the classes by using the EM algorithm
-void ClassHierarchy::clusterClassesRecursive(Mat trainData, Mat trainLabels, int id)
+void ClassHierarchy::clusterClassesRecursive(Mat trainData, Mat trainLabels, int id, vector<NodeTraining>& trainings)
 {
 	map<int, int> classCountMap;
 	map<int, int>::iterator it;
@@ -841,7 +1300,8 @@ void ClassHierarchy::clusterClassesRecursive(Mat trainData, Mat trainLabels, int
 		if(_hierarchy.size() <= id)
 			_hierarchy.resize(id + 1, ClassHierarchyNode(-1));
 		_hierarchy[id].setID(id);
-		_hierarchy[id].trainSVM(trainData, svmLabels);
+		NodeTraining training = { id, trainData, svmLabels };
+		trainings.push_back(training);
 
 		//double prob = 0;
 		//Mat sample = trainData.row(0);
@@ -1089,16 +1549,22 @@ void ClassHierarchy::clusterClassesRecursive(Mat trainData, Mat trainLabels, int
 	if(_hierarchy.size() <= id)
 		_hierarchy.resize(id + 1, ClassHierarchyNode(-1));
 	_hierarchy[id].setID(id);
-	_hierarchy[id].trainSVM(trainData, svmLabels);
+	NodeTraining training = { id, trainData, svmLabels };
+	trainings.push_back(training);
 
-	clusterClassesRecursive(posTrainData, posTrainLabels, 2*id);
+	clusterClassesRecursive(posTrainData, posTrainLabels, 2*id, trainings);
 
-	clusterClassesRecursive(negTrainData, negTrainLabels, 2*id + 1);
+	clusterClassesRecursive(negTrainData, negTrainLabels, 2*id + 1, trainings);
 
 }
 
 void ClassHierarchy::loadModel(const string& filename)
 {
+	if(isBinaryModel(filename)){
+		loadBinaryModel(filename);
+		return;
+	}
+
 	FileStorage fs (filename, FileStorage::READ);
 	FileNode fn;
 
@@ -1149,3 +1615,97 @@ void ClassHierarchy::saveModel(const string& filename)
 
 	fs.release();
 }
+
+bool ClassHierarchy::saveBinaryModel(const string& filename)
+{
+	vector<CompactNode> nodes;
+	vector< vector<double> > alphas;
+	vector< vector<float> > svs;
+	int varCount = 0;
+
+	for(size_t i = 0; i < _hierarchy.size(); ++i){
+		if(_hierarchy[i].getID() == -1)
+			continue;
+
+		nodes.push_back(CompactNode());
+		alphas.push_back(vector<double>());
+		svs.push_back(vector<float>());
+		int nodeVarCount = 0;
+		if(!_hierarchy[i].writeCompact(nodes.back(), alphas.back(), svs.back(), nodeVarCount))
+			return false;
+		if(varCount != 0 && nodeVarCount != varCount){
+			cerr << "Error: the SVMs of the hierarchy have different feature sizes." << endl;
+			return false;
+		}
+		varCount = nodeVarCount;
+	}
+
+	// node data follows the node table, each block padded to 8 bytes
+	uint64_t offset = sizeof(CompactModelHeader) + nodes.size() * sizeof(CompactNode);
+	for(size_t i = 0; i < nodes.size(); ++i){
+		nodes[i].dataOffset = offset;
+		offset += alphas[i].size() * sizeof(double) + (svs[i].size() * sizeof(float) + 7) / 8 * 8;
+	}
+
+	CompactModelHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, compactMagic, sizeof(header.magic));
+	header.numClasses = _nClasses;
+	header.nodeCount = (int32_t)nodes.size();
+	header.varCount = varCount;
+
+	ofstream fout(filename.c_str(), ios::binary);
+	fout.write((const char*)&header, sizeof(header));
+	if(!nodes.empty())
+		fout.write((const char*)&nodes[0], nodes.size() * sizeof(CompactNode));
+	for(size_t i = 0; i < nodes.size(); ++i){
+		const char padding[8] = {0};
+		size_t svBytes = svs[i].size() * sizeof(float);
+		fout.write((const char*)alphas[i].data(), alphas[i].size() * sizeof(double));
+		fout.write((const char*)svs[i].data(), svBytes);
+		fout.write(padding, (8 - svBytes % 8) % 8);
+	}
+
+	if(!fout){
+		cerr << "Error: cannot write the binary model \"" << filename << "\"." << endl;
+		return false;
+	}
+	return true;
+}
+
+bool ClassHierarchy::loadBinaryModel(const string& filename)
+{
+	std::shared_ptr< const MappedModelFile > file = MappedModelFile::open(filename);
+	if(!file || file->size() < sizeof(CompactModelHeader)){
+		cerr << "Error: cannot map the binary model \"" << filename << "\"." << endl;
+		return false;
+	}
+
+	const CompactModelHeader* header = (const CompactModelHeader*)file->data();
+	const CompactNode* nodes = (const CompactNode*)(header + 1);
+	if(header->nodeCount < 0 || header->varCount <= 0 ||
+		file->size() < sizeof(CompactModelHeader) + header->nodeCount * sizeof(CompactNode)){
+		cerr << "Error: truncated binary model \"" << filename << "\"." << endl;
+		return false;
+	}
+
+	int maxID = 0;
+	for(int i = 0; i < header->nodeCount; ++i){
+		const CompactNode& node = nodes[i];
+		uint64_t end = node.dataOffset + (uint64_t)node.svCount * (sizeof(double) + header->varCount * sizeof(float));
+		if(node.id < 0 || node.svCount < 0 || node.dataOffset % 8 != 0 || end > file->size()){
+			cerr << "Error: invalid node in binary model \"" << filename << "\"." << endl;
+			return false;
+		}
+		if(node.id > maxID)
+			maxID = node.id;
+	}
+
+	_nClasses = header->numClasses;
+	_hierarchy.clear();
+	_hierarchy.resize(maxID + 1, ClassHierarchyNode());
+	for(int i = 0; i < header->nodeCount; ++i)
+		_hierarchy[nodes[i].id].readCompact(file, &nodes[i], header->varCount);
+
+	return true;
+}
@@ -29,6 +29,8 @@ using namespace cv;
 //********** forward declaration *************************************************
 class ClassHierarchyNode;
 class ClassHierarchy;
+class MappedModelFile;
+struct CompactNode;
 
 //********** class classHierarchyNode ********************************************
 class ClassHierarchyNode
@@ -43,6 +45,13 @@ public:
 
 	int predictSVM2( Mat sample, double& prob_pos, double& prob_neg );
 
+	// outputs of both predictSVM and predictSVM2 from a single SVM evaluation
+	int predictSVMAll( Mat sample, double& prob, double& prob_pos, double& prob_neg );
+
+	// predictSVMAll on each row of samples, with a single batch call for the labels
+	void predictSVMBatch( Mat samples, vector<int>& results, vector<double>& prob,
+		vector<double>& prob_pos, vector<double>& prob_neg );
+
 	int getID() const { return _ID; }
 	int getPosClass() const { return _posClass; }
 	int getNegClass() const { return _negClass; }
@@ -54,7 +63,16 @@ public:
 	void read(const FileNode& fn);
 	void write(FileStorage& fs) const;
 
+	// compact binary form, the node evaluates its SVM directly from the mapped data
+	bool writeCompact(CompactNode& node, vector<double>& alpha, vector<float>& sv, int& varCount) const;
+	void readCompact(std::shared_ptr< const MappedModelFile > file, const CompactNode* node, int varCount);
+
 private:
+	// SVM label and decision value of a sample
+	double decisionValue( Mat sample, int& label );
+
+	int decisionOutputs( int label, double decVal, double& prob, double& prob_pos, double& prob_neg );
+
 	double decFuncMargin();
 	pair<double, double> fitSigmoid_old(Mat decVals, Mat labels, int posCount, int negCount);
 	pair<double, double> fitSigmoid(Mat decVals, Mat labels, int posCount, int negCount);
@@ -88,6 +106,14 @@ private:
 
 	// SVM classifier
 	std::shared_ptr< SVM >       _svm;
+
+	// file the SVM was read from, used to export the compact form
+	string    _svmFile;
+
+	// compact SVM of a binary model, used instead of _svm when set
+	std::shared_ptr< const MappedModelFile > _mappedFile;
+	const CompactNode* _compact;
+	int       _varCount;
 };
 
 void write(FileStorage& fs, const string& , const ClassHierarchyNode& x);
@@ -100,16 +126,59 @@ public:
 	ClassHierarchy();
 	~ClassHierarchy();
 
+	// loads either the saveModel output or a binary model of saveBinaryModel
 	void loadModel(const string& filename);
 	void saveModel(const string& filename);
 
-	void train(Mat trainData, Mat trainLabels);
+	// writes the loaded model as a binary, memory-mappable file, which loads
+	// without parsing and is shared by every hierarchy loading the same file
+	bool saveBinaryModel(const string& filename);
+
+	// trains the node SVMs on numThreads threads once the tree is built, 0 uses all cores
+	void train(Mat trainData, Mat trainLabels, unsigned numThreads = 1);
 
 	bool predict(Mat sample, vector<int>& predictions, vector<double>& probabilities);
 	bool predict2(Mat sample, vector<int>& class_label, vector<vector<double>>& probb);
 
+	// outputs of both predict and predict2, evaluating each node at most once
+	bool predictHierarchy(Mat sample, vector<int>& predictions, vector<double>& probabilities,
+		vector<int>& class_label, vector<vector<double>>& probb);
+
+	// predictHierarchy on each row of samples, evaluating every node once on all
+	// the rows routed to it, returns whether each row was partially classified
+	vector<bool> predictHierarchyBatch(Mat samples, vector<vector<int>>& predictions,
+		vector<vector<double>>& probabilities, vector<vector<int>>& class_label,
+		vector<vector<vector<double>>>& probb);
+
 private:
-	void clusterClassesRecursive(Mat trainData, Mat trainLabels, int id);
+	bool loadBinaryModel(const string& filename);
+
+	// SVM outputs of a node for the current sample
+	struct NodePrediction
+	{
+		NodePrediction() : evaluated(false), pred(0), prob(0.0), probPos(0.0), probNeg(0.0) {}
+
+		bool evaluated;
+		int pred;
+		double prob;
+		double probPos;
+		double probNeg;
+	};
+
+	const NodePrediction& evaluateNode(Mat sample, vector<NodePrediction>& cache, int node);
+
+	bool predictPath(Mat sample, vector<NodePrediction>& cache, vector<int>& predictions, vector<double>& probabilities);
+	bool predictLeaves(Mat sample, vector<NodePrediction>& cache, vector<int>& class_label, vector<vector<double>>& probb);
+
+	// SVM training of a node, which only depends on the data routed to it
+	struct NodeTraining
+	{
+		int id;
+		Mat data;
+		Mat labels;
+	};
+
+	void clusterClassesRecursive(Mat trainData, Mat trainLabels, int id, vector<NodeTraining>& trainings);
 
 	int _nClasses;
 	vector<ClassHierarchyNode> _hierarchy;
@@ -1,39 +1,81 @@
 #include "featureExtraction.h"
 #include "util.h"
 
+// Sampling offsets and bilinear weights of one LBP neighbour, relative to the
+// centre pixel, for a given radius
+struct LBPNeighbour
+{
+	int dx0, dx1, dy0, dy1;
+	float w00, w01, w10, w11;
+};
+
+static void getLBPNeighbours(int radius, LBPNeighbour* neighbours)
+{
+	for(int t = 0; t < 8; ++t){
+		float xx = radius*cos(t*PI_/4.0);
+		float yy = radius*sin(t*PI_/4.0);
+
+		// drop the rounding error of cos/sin on the axes, so these neighbours
+		// are sampled on the pixel grid
+		if(fabs(xx - cvRound(xx)) < 1e-4f) xx = float(cvRound(xx));
+		if(fabs(yy - cvRound(yy)) < 1e-4f) yy = float(cvRound(yy));
+
+		float a = xx - floor(xx);
+		float b = yy - floor(yy);
+
+		LBPNeighbour& n = neighbours[t];
+		n.dx0 = int(floor(xx)); n.dx1 = int(ceil(xx));
+		n.dy0 = int(floor(yy)); n.dy1 = int(ceil(yy));
+		n.w00 = (1-a) * (1-b);
+		n.w01 =     a * (1-b);
+		n.w10 = (1-a) *     b;
+		n.w11 =     a *     b;
+	}
+}
+
 void localBinaryPatterns(InputArray src, OutputArray dst, int radius)
 {
 	if(!src.obj) return;
 	Mat img = src.getMat();
+	CV_Assert(img.type() == CV_8U);
 	dst.create(img.size(), CV_8U);
 	Mat outImg = dst.getMat();
+	outImg.setTo(Scalar(0));
 
+	const int width = img.cols - 2*radius;
+	if(width <= 0 || img.rows <= 2*radius) return;
+
+	// the sampling pattern only depends on the radius, so it is computed once
+	// and every neighbour is then processed on whole rows, which the compiler
+	// can vectorize
+	LBPNeighbour neighbours[8];
+	getLBPNeighbours(radius, neighbours);
+
+	vector<int> threshold(width), code(width);
 	for(int y = radius; y < img.rows - radius; ++y){
-		for(int x = radius; x < img.cols - radius; ++x){
-			Point cen(x, y);
-			uchar cenVal = img.at<uchar>(cen);
-			uchar lbpDecimal = 0;
-
-			for(int t = 0; t < 8; ++t){
-				float xx = cen.x + radius*cos(t*PI_/4.0);
-				float yy = cen.y + radius*sin(t*PI_/4.0);
-
-				float a = xx - floor(xx);
-				float b = yy - floor(yy);
-
-				uchar ptVal = uchar((1-a) * (1-b) * img.at<uchar>(int(floor(yy)), int(floor(xx)))
-								  +     a * (1-b) * img.at<uchar>(int(floor(yy)), int(ceil(xx)))
-								  + (1-a) *     b * img.at<uchar>(int(ceil(yy)), int(floor(xx)))
-								  +     a *     b * img.at<uchar>(int(ceil(yy)), int(ceil(xx))) );
-
-				if (ptVal > cenVal - 3){
-					lbpDecimal += 1 << (7-t);
-				}
-			}
+		const uchar* cen = img.ptr(y) + radius;
+		for(int x = 0; x < width; ++x){
+			threshold[x] = cen[x] - 3;
+			code[x] = 0;
+		}
 
-			outImg.at<uchar>(cen) = lbpDecimal;
-			
+		for(int t = 0; t < 8; ++t){
+			const LBPNeighbour& n = neighbours[t];
+			const uchar* p00 = img.ptr(y + n.dy0) + radius + n.dx0;
+			const uchar* p01 = img.ptr(y + n.dy0) + radius + n.dx1;
+			const uchar* p10 = img.ptr(y + n.dy1) + radius + n.dx0;
+			const uchar* p11 = img.ptr(y + n.dy1) + radius + n.dx1;
+			const int bit = 1 << (7-t);
+
+			for(int x = 0; x < width; ++x){
+				int ptVal = uchar(n.w00 * p00[x] + n.w01 * p01[x] + n.w10 * p10[x] + n.w11 * p11[x]);
+				code[x] |= ptVal > threshold[x] ? bit : 0;
+			}
 		}
+
+		uchar* out = outImg.ptr(y) + radius;
+		for(int x = 0; x < width; ++x)
+			out[x] = uchar(code[x]);
 	}
 }
 
@@ -173,13 +215,12 @@ FeatureExtraction::getCurvature(const vector<Point>& contour)
 vector<pair<double, int>>
 FeatureExtraction::getCSSMaxima(const FGObject& obj, OutputArray cssImg)
 {
-	vector<Point> contour = obj.contour;
 	int nS = 200;
 	int nP = 200;
 	cssImg.create(nS, nP, CV_8U);
 	Mat css = cssImg.getMat();
 	
-	cssImage(contour, css);
+	cssImage(obj.contour, css);
 	
 	Mat cssImg8U = css.clone();
 
@@ -351,103 +392,94 @@ FeatureExtraction::getConcaveIndices(const FGObject& obj)
 
 
 
+// Gaussian derivative kernels at one scale of the CSS image, tap j weights
+// the contour sample at offset - j
+struct CSSKernel
+{
+	int offset;
+	vector<double> gu, guu;
+};
+
+// kernels of all the scales of the CSS image, which do not depend on the contour
+static const vector<CSSKernel>& cssKernels()
+{
+	static const vector<CSSKernel> kernels = []()
+	{
+		int nS = 200;
+		double step = 0.15;
+		int kw = 4;
+
+		vector<CSSKernel> result;
+		result.reserve(nS);
+		for(double s = 1.0; s < 1.14+(nS-1)*step; s+=step){
+			CSSKernel kernel;
+			kernel.offset = int(floor(kw*s));
+			for(int v = 0; v <= 2*kw*s; ++v){
+				double G = exp(-0.5 * pow((v-kw*s)/s, 2)) / sqrt(2*PI_) / s;
+				kernel.gu.push_back(-(v-kw*s)/pow(s, 2) * G);
+				kernel.guu.push_back((-pow(s, 2) + pow(v-kw*s, 2)) / pow(s, 4) * G);
+			}
+			result.push_back(kernel);
+		}
+		return result;
+	}();
+
+	return kernels;
+}
+
 void
-FeatureExtraction::cssImage(vector<Point> contour, OutputArray cssImg)
+FeatureExtraction::cssImage(const vector<Point>& contour, OutputArray cssImg)
 {
 	int nP = 200;
 	int nS = 200;
-	double step = 0.15;
-	int kw = 4;
 
 	cssImg.create(nS, nP, CV_8U);
 	Mat outImg8U = cssImg.getMat();
 	outImg8U.setTo(Scalar(0));
 
-	vector<int> x, y;
-	x.reserve(nP);
-	y.reserve(nP);
+	const vector<CSSKernel>& kernels = cssKernels();
+
+	// resampled contour, padded on both sides with its circular continuation
+	// so that the convolutions never wrap indices
+	int pad = 0;
+	for(size_t n = 0; n < kernels.size(); ++n)
+		pad = max(pad, (int)kernels[n].gu.size());
+
+	vector<double> x(nP + 2*pad), y(nP + 2*pad);
 	size_t size = contour.size();
-	for(int u = 0; u < nP; ++u){
-		x.push_back(contour[u*size/nP].x);
-		y.push_back(contour[u*size/nP].y);
+	for(int u = -pad; u < nP + pad; ++u){
+		int w = ((u % nP) + nP) % nP;
+		x[u + pad] = contour[w*size/nP].x;
+		y[u + pad] = contour[w*size/nP].y;
 	}
 
+	// curvature of one scale, reused across scales
+	vector<double> k(nP);
+
 	int r = nS-1;
-	for(double s = 1.0; s < 1.14+(nS-1)*step; s+=step){
-		// 1D gaussian kernel
-		vector<double> g, gu, guu;
-		for(int v = 0; v <= 2*kw*s; ++v){
-			double G = exp(-0.5 * pow((v-kw*s)/s, 2)) / sqrt(2*PI_) / s;
-			g.push_back(G);
-			gu.push_back(-(v-kw*s)/pow(s, 2) * G);
-			guu.push_back((-pow(s, 2) + pow(v-kw*s, 2)) / pow(s, 4) * G);
-		}
+	for(size_t n = 0; n < kernels.size() && r >= 0; ++n, --r){
+		const CSSKernel& kernel = kernels[n];
+		const int taps = (int)kernel.gu.size();
+		const double* gu = &kernel.gu[0];
+		const double* guu = &kernel.guu[0];
 
 		// convolution and calculate curvature
-		vector<double> X, Xu, Xuu, Y, Yu, Yuu, k;
-		vector<bool> dyLarge;
-		X.reserve(nP);
-		Xu.reserve(nP);
-		Xuu.reserve(nP);
-		Y.reserve(nP);
-		Yu.reserve(nP);
-		Yuu.reserve(nP);
-		k.reserve(nP);
-		dyLarge.reserve(nP);
 		for(int i = 0; i < nP; ++i){
-			X.push_back(0);
-			Xu.push_back(0);
-			Xuu.push_back(0);
-			Y.push_back(0);
-			Yu.push_back(0);
-			Yuu.push_back(0);
-			dyLarge.push_back(true);
-			for(int j = 0; j <= 2*kw*s; ++j){
-				int idx = int(i-j+kw*s);
-				idx = idx < 0 ? idx + nP : (idx >= nP ? idx - nP : idx);
-				X[i]   += x[idx] * g[j];
-				Xu[i]  += x[idx] * gu[j];
-				Xuu[i] += x[idx] * guu[j];
-				Y[i]   += y[idx] * g[j];
-				Yu[i]  += y[idx] * gu[j];
-				Yuu[i] += y[idx] * guu[j];
+			const double* px = &x[pad + i + kernel.offset];
+			const double* py = &y[pad + i + kernel.offset];
+			double Xu = 0, Xuu = 0, Yu = 0, Yuu = 0;
+			for(int j = 0; j < taps; ++j){
+				Xu  += px[-j] * gu[j];
+				Xuu += px[-j] * guu[j];
+				Yu  += py[-j] * gu[j];
+				Yuu += py[-j] * guu[j];
 			}
-			double ki = (Xu[i]*Yuu[i] - Xuu[i]*Yu[i]) / pow((Xu[i]*Xu[i] + Yu[i]*Yu[i]), 1.5);
-			k.push_back(ki);
+			k[i] = (Xu*Yuu - Xuu*Yu) / pow((Xu*Xu + Yu*Yu), 1.5);
 		}
 
-		/*for(int u = 1; u < nP-1; ++u){
-			if(abs(Y[u] - Y[u-1]) < 0.5 && abs(Y[u] - Y[u+1]) < 0.5){
-				for(int v = -1; v <= 1; ++v){
-					int idx = u+v < 0 ? 0 : (u+v >= nP ? nP-1 : u+v);
-					dyLarge[idx] = false;
-				}
-			}
-		}*/
-
-		for(int u = 0; u < nP; ++u){
-			if(k[u]*k[(u+1)%nP] < 0)
-				outImg8U.at<uchar>(r, u) = 255;
-			else
-				outImg8U.at<uchar>(r, u) = 0;
-		}
-		r--;
-
-		/*if(r % 10 == 9){
-			vector<Point> cc;
-			cc.reserve(200);
-			for(int i = 0; i < nP; ++i)
-				cc.push_back(Point(X[i], Y[i]));
-
-			vector<vector<Point>> ccs;
-			ccs.push_back(cc);
-			Mat smoothContour = Mat::zeros(param.getFrameHeight(), param.getFrameWidth(), CV_8U);
-			drawContours(smoothContour, ccs, 0, Scalar(255), -1);
-			showImage("smoothContour", smoothContour, 1, 1);
-			showImage("cssImg", outImg8U, 1);
-			int a = 1;
-		}*/
-		
+		uchar* row = outImg8U.ptr(r);
+		for(int u = 0; u < nP; ++u)
+			row[u] = k[u]*k[(u+1)%nP] < 0 ? 255 : 0;
 	}
 
 	/*Mat se = getStructuringElement(MORPH_RECT, Size(1, 3));
@@ -606,42 +638,35 @@ vector<double> FeatureExtraction::getCorrelation(const vector<Point>& contour, b
 		centDist[u] = centDist[u]/vectNorm;
 	}
 
+	// circular autocorrelation, indexing the shifted series in place
 	vector<double> autoCorr(nP/2, 0.0);
 	for (int n = 1; n <= autoCorr.size(); n++) {
-		vector<double> x2 = centDist;
-		rotate(x2.begin(),x2.begin()+n,x2.end());
-		//for (int m = 0; m < n; m++) {
-		//	x2[m] = 0.0;
-		//}
 		for (int u = 0; u < nP; u++)
-			autoCorr[n-1] += centDist[u]*x2[u];
+			autoCorr[n-1] += centDist[u]*centDist[(u+n)%nP];
 	}
 
 	return autoCorr;
 }
 
 
-// returns the magnitude of the DFT of a real-number series
+// returns the DFT of a real-number series
 vector<complex<double>> FeatureExtraction::discreteFourierTransform( const vector<double>& inputSeries )
 {
 	int M = inputSeries.size();
 	vector<complex<double>> DFT;
-	DFT.reserve(inputSeries.size());
-		
-	for(int k = 0; k < M; ++k){
-		double re = 0;
-		double im = 0;
-		for(int n = 0; n < M; ++n){
-			double theta = -2 * PI_ * k * (double)n / (double)M;
-			double cos_theta = cos(theta);
-			double sin_theta = sin(theta);
-			re += inputSeries[n] * cos_theta;
-			im += inputSeries[n] * sin_theta;
-		}
-		
-		complex<double> z (re, im);
-		DFT.push_back(z);
-	}
+	if(M == 0)
+		return DFT;
+
+	// OpenCV's FFT handles any length, so the series is not resampled and the
+	// descriptor keeps the size the classifier models were trained with
+	Mat series(1, M, CV_64F, const_cast<double*>(&inputSeries[0]));
+	Mat spectrum;
+	dft(series, spectrum, DFT_COMPLEX_OUTPUT);
+
+	DFT.reserve(M);
+	const Vec2d* bins = spectrum.ptr<Vec2d>(0);
+	for(int k = 0; k < M; ++k)
+		DFT.push_back(complex<double>(bins[k][0], bins[k][1]));
 
 	return DFT;
 }
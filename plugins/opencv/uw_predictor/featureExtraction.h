@@ -76,7 +76,7 @@ public:
 
 private:
 	// curvature scale space methods
-	void	cssImage(vector<Point> contour, OutputArray cssImg);
+	void	cssImage(const vector<Point>& contour, OutputArray cssImg);
 	
 	// Fourier descriptor methods
 	vector<complex<double>>	discreteFourierTransform(const vector<double>& series);
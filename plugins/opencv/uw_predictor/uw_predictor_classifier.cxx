@@ -31,6 +31,7 @@
 #include "uw_predictor_classifier.h"
 
 #include <arrows/ocv/image_container.h>
+#include <vital/exceptions.h>
 
 #include <opencv2/core/core.hpp>
 
@@ -38,8 +39,15 @@
 #include "classHierarchy.h"
 #include "SpeciesIDLib.h"
 
+#include <plugins/core/thread_pool.h>
+#include <plugins/opencv/ocv_chip_cache.h>
+
 #include <cmath>
+#include <fstream>
+#include <future>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace viame {
 
@@ -51,13 +59,68 @@ class uw_predictor_classifier::priv
 {
 public:
 
-  priv() {}
+  priv() : m_num_threads( 1 ) {}
   ~priv() {}
 
+  // Classify one detection of the image, which is converted to gray only inside the detection
+  kwiver::vital::detected_object_sptr classify(
+    const kwiver::vital::image& image, const cv::Mat& src,
+    const kwiver::vital::detected_object_sptr& det );
+
   std::string m_model_file;
+  std::string m_binary_model_file;
+  unsigned m_num_threads;
   FishSpeciesID m_fish_model;
+
+  // Workers classifying detections, only used with multiple threads
+  std::unique_ptr< viame::thread_pool > m_workers;
 };
 
+// -------------------------------------------------------------------------------------------------
+kwiver::vital::detected_object_sptr
+uw_predictor_classifier::priv::
+classify( const kwiver::vital::image& image, const cv::Mat& src,
+          const kwiver::vital::detected_object_sptr& det )
+{
+  // Crop out and convert the chip alone, shared with other stages using the same chip
+  auto bbox = det->bounding_box();
+
+  cv::Mat roi_crop = ocv_chip_cache::instance().get( image, src, bbox, cv::Size(),
+    src.channels() == 3 ? CV_RGB2GRAY : -1 );
+
+  if( roi_crop.empty() )
+  {
+    return det;
+  }
+
+  // Run UW predictor code on each chip
+  vector< int > predictions;
+  vector< double > probabilities;
+
+  cv::Mat segment_chip = kwiver::arrows::ocv::image_container::vital_to_ocv( det->mask()->get_image() );
+
+  if( segment_chip.channels() == 3 )
+  {
+    cv::cvtColor( segment_chip, segment_chip, CV_RGB2GRAY );
+  }
+
+  cv::Mat fg_rect;
+  m_fish_model.predict( roi_crop, segment_chip, predictions, probabilities, fg_rect );
+
+  // Convert UW detections to KWIVER format
+  vector< string > names;
+
+  for( int i : predictions )
+  {
+    names.push_back( std::to_string( i ) );
+  }
+
+  auto dot = std::make_shared< kwiver::vital::detected_object_type >( names, probabilities );
+
+  // Create detection
+  return std::make_shared< kwiver::vital::detected_object >( bbox, 1.0, dot );
+}
+
 // =================================================================================================
 
 uw_predictor_classifier::
@@ -81,6 +144,13 @@ get_configuration() const
 
   config->set_value( "model_file", d->m_model_file,
                      "Name of uw_predictor model file." );
+  config->set_value( "binary_model_file", d->m_binary_model_file,
+                     "Optional binary copy of the model file, which loads faster and "
+                     "is shared by all classifiers using it. It is written from "
+                     "model_file when it does not exist, and loaded instead otherwise." );
+  config->set_value( "num_threads", d->m_num_threads,
+                     "Number of threads classifying the detections of a frame in "
+                     "parallel, 0 uses all available cores." );
 
   return config;
 }
@@ -92,8 +162,35 @@ uw_predictor_classifier::
 set_configuration( kwiver::vital::config_block_sptr config )
 {
   d->m_model_file = config->get_value< std::string >( "model_file" );
+  d->m_binary_model_file = config->get_value< std::string >( "binary_model_file" );
+  d->m_num_threads = config->get_value< unsigned >( "num_threads" );
 
-	d->m_fish_model.loadModel( d->m_model_file.c_str() );
+  if( d->m_binary_model_file.empty() )
+  {
+    d->m_fish_model.loadModel( d->m_model_file.c_str() );
+  }
+  else
+  {
+    if( !std::ifstream( d->m_binary_model_file.c_str() ) )
+    {
+      d->m_fish_model.loadModel( d->m_model_file.c_str() );
+
+      if( !d->m_fish_model.saveBinaryModel( d->m_binary_model_file.c_str() ) )
+      {
+        VITAL_THROW( kwiver::vital::invalid_data,
+                     "Unable to write binary model " + d->m_binary_model_file );
+      }
+    }
+
+    d->m_fish_model.loadModel( d->m_binary_model_file.c_str() );
+  }
+
+  d->m_workers.reset();
+
+  if( d->m_num_threads != 1 )
+  {
+    d->m_workers.reset( new viame::thread_pool( d->m_num_threads ) );
+  }
 }
 
 
@@ -114,48 +211,50 @@ refine( kwiver::vital::image_container_sptr image_data,
 {
   auto output_detections = std::make_shared< kwiver::vital::detected_object_set >();
 
-  cv::Mat src = kwiver::arrows::ocv::image_container::vital_to_ocv( image_data->get_image() );
-
-  if( src.channels() == 3 )
-  {
-    cv::cvtColor( src, src, CV_RGB2GRAY );
-  }
+  const kwiver::vital::image image = image_data->get_image();
+  cv::Mat src = kwiver::arrows::ocv::image_container::vital_to_ocv( image );
 
   // process results
-  for( auto det : *input_dets )
+  if( !d->m_workers )
   {
-    // Crop out chip
-    auto bbox = det->bounding_box();
+    for( auto det : *input_dets )
+    {
+      output_detections->add( d->classify( image, src, det ) );
+    }
 
-    cv::Rect roi( bbox.min_x(), bbox.min_y(), bbox.width(), bbox.height() );
-    cv::Mat roi_crop = src( roi );
+    return output_detections;
+  }
 
-    // Run UW predictor code on each chip
-    vector< int > predictions;
-    vector< double > probabilities;
+  // Detections are independent, classify them on the workers and output them in order
+  std::vector< std::future< kwiver::vital::detected_object_sptr > > results;
 
-    cv::Mat segment_chip = kwiver::arrows::ocv::image_container::vital_to_ocv( det->mask()->get_image() );
+  for( auto det : *input_dets )
+  {
+    results.push_back( d->m_workers->enqueue(
+      [this, &image, &src, det]()
+      {
+        return d->classify( image, src, det );
+      } ) );
+  }
 
-    if( segment_chip.channels() == 3 )
+  try
+  {
+    for( auto& result : results )
     {
-      cv::cvtColor( segment_chip, segment_chip, CV_RGB2GRAY );
+      output_detections->add( result.get() );
     }
-
-    cv::Mat fg_rect;
-    bool is_partial = d->m_fish_model.predict( roi_crop, segment_chip, predictions, probabilities, fg_rect );
-
-    // Convert UW detections to KWIVER format
-    vector< string > names;
-
-    for( int i : predictions )
+  }
+  catch( ... )
+  {
+    // The remaining tasks reference the image, let them finish first
+    for( auto& result : results )
     {
-      names.push_back( std::to_string( i ) );
+      if( result.valid() )
+      {
+        result.wait();
+      }
     }
-
-    auto dot = std::make_shared< kwiver::vital::detected_object_type >( names, probabilities );
-
-    // Create detection
-    output_detections->add( std::make_shared< kwiver::vital::detected_object >( bbox, 1.0, dot ) );
+    throw;
   }
 
   return output_detections;
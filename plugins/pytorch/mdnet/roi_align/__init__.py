@@ -1,4 +1,4 @@
-from .functions.roi_align import roi_align, roi_align_ada
+from .functions.roi_align import roi_align, roi_align_ada, roi_align_batched
 from .modules.roi_align import RoIAlign, RoIAlignAda, RoIAlignAvg, RoIAlignMax, RoIAlignAdaMax
 
-__all__ = ['roi_align', 'RoIAlign', 'roi_align_ada', 'RoIAlignAda', 'RoIAlignAvg', 'RoIAlignMax', 'RoIAlignAdaMax']
+__all__ = ['roi_align', 'roi_align_batched', 'RoIAlign', 'roi_align_ada', 'RoIAlignAda', 'RoIAlignAvg', 'RoIAlignMax', 'RoIAlignAdaMax']
@@ -1,6 +1,20 @@
+import torch
 from torch.autograd import Function
 
-from .. import roi_align_cuda
+from .. import roi_align_cpu
+
+try:
+    from .. import roi_align_cuda
+except ImportError:
+    roi_align_cuda = None
+
+
+def _backend(tensor):
+    if not tensor.is_cuda:
+        return roi_align_cpu
+    if roi_align_cuda is None:
+        raise RuntimeError('roi_align was built without CUDA support')
+    return roi_align_cuda
 
 
 class RoIAlignFunction(Function):
@@ -28,11 +42,8 @@ class RoIAlignFunction(Function):
         num_rois = rois.size(0)
 
         output = features.new_zeros(num_rois, num_channels, out_h, out_w)
-        if features.is_cuda:
-            roi_align_cuda.forward(features, rois, out_h, out_w, spatial_scale,
-                                   sample_num, output)
-        else:
-            raise NotImplementedError
+        _backend(features).forward(features, rois, out_h, out_w,
+                                   spatial_scale, sample_num, output)
 
         return output
 
@@ -42,7 +53,7 @@ class RoIAlignFunction(Function):
         spatial_scale = ctx.spatial_scale
         sample_num = ctx.sample_num
         rois = ctx.saved_tensors[0]
-        assert (feature_size is not None and grad_output.is_cuda)
+        assert feature_size is not None
 
         batch_size, num_channels, data_height, data_width = feature_size
         out_w = grad_output.size(3)
@@ -50,11 +61,11 @@ class RoIAlignFunction(Function):
 
         grad_input = grad_rois = None
         if ctx.needs_input_grad[0]:
-            grad_input = rois.new_zeros(batch_size, num_channels, data_height,
-                                        data_width)
-            roi_align_cuda.backward(grad_output.contiguous(), rois, out_h,
-                                    out_w, spatial_scale, sample_num,
-                                    grad_input)
+            grad_input = grad_output.new_zeros(batch_size, num_channels,
+                                               data_height, data_width)
+            _backend(grad_output).backward(grad_output.contiguous(), rois,
+                                           out_h, out_w, spatial_scale,
+                                           sample_num, grad_input)
 
         return grad_input, grad_rois, None, None, None
 class RoIAlignAdaFunction(Function):
@@ -81,11 +92,8 @@ class RoIAlignAdaFunction(Function):
         num_rois = rois.size(0)
 
         output = features.new_zeros(num_rois, num_channels, out_h, out_w)
-        if features.is_cuda:
-            roi_align_cuda.ada_forward(features, rois, out_h, out_w, spatial_scale,
-                                   sample_num, output)
-        else:
-            raise NotImplementedError
+        _backend(features).ada_forward(features, rois, out_h, out_w,
+                                       spatial_scale, sample_num, output)
 
         return output
 
@@ -95,7 +103,7 @@ class RoIAlignAdaFunction(Function):
         spatial_scale = ctx.spatial_scale
         sample_num = ctx.sample_num
         rois = ctx.saved_tensors[0]
-        assert (feature_size is not None and grad_output.is_cuda)
+        assert feature_size is not None
 
         batch_size, num_channels, data_height, data_width = feature_size
         out_w = grad_output.size(3)
@@ -103,13 +111,46 @@ class RoIAlignAdaFunction(Function):
 
         grad_input = grad_rois = None
         if ctx.needs_input_grad[0]:
-            grad_input = rois.new_zeros(batch_size, num_channels, data_height,
-                                        data_width)
-            roi_align_cuda.ada_backward(grad_output.contiguous(), rois, out_h,
-                                    out_w, spatial_scale, sample_num,
-                                    grad_input)
+            grad_input = grad_output.new_zeros(batch_size, num_channels,
+                                               data_height, data_width)
+            _backend(grad_output).ada_backward(grad_output.contiguous(), rois,
+                                               out_h, out_w, spatial_scale,
+                                               sample_num, grad_input)
 
         return grad_input, grad_rois, None, None, None
 
+def roi_align_batched(features, rois, out_size, spatial_scale):
+    """Align the ROIs of several feature maps with a single kernel launch.
+
+    rois[i] indexes into features[i]; one output tensor is returned per map.
+    Inference only, no gradient is propagated to the features.
+    """
+    if isinstance(out_size, int):
+        out_h = out_w = out_size
+    else:
+        out_h, out_w = out_size
+    assert len(features) == len(rois) and len(features) > 0
+
+    num_channels = features[0].size(1)
+    counts = [r.size(0) for r in rois]
+
+    if not features[0].is_cuda:
+        # the CPU kernel has no launch cost to amortize
+        outputs = []
+        for f, r in zip(features, rois):
+            output = f.new_zeros(r.size(0), num_channels, out_h, out_w)
+            roi_align_cpu.forward(f.contiguous(), r.contiguous(), out_h,
+                                  out_w, spatial_scale, 0, output)
+            outputs.append(output)
+        return outputs
+
+    output = features[0].new_zeros(sum(counts), num_channels, out_h, out_w)
+    _backend(features[0]).batched_forward(
+        [f.contiguous() for f in features],
+        [r.contiguous() for r in rois],
+        out_h, out_w, spatial_scale, output)
+
+    return list(torch.split(output, counts, 0))
+
 roi_align = RoIAlignFunction.apply
 roi_align_ada = RoIAlignAdaFunction.apply
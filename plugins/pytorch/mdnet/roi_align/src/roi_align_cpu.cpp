@@ -0,0 +1,219 @@
+#include <torch/extension.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#define CHECK_CPU(x) AT_CHECK(!x.type().is_cuda(), #x, " must be a CPU tensor ")
+#define CHECK_CONTIGUOUS(x) \
+  AT_CHECK(x.is_contiguous(), #x, " must be contiguous ")
+#define CHECK_INPUT(x) \
+  CHECK_CPU(x);        \
+  CHECK_CONTIGUOUS(x)
+
+// Sample location of one output cell, shared by every channel of the ROI.
+// Mirrors ROIAlignForward in roi_align_kernel.cu.
+template <typename scalar_t>
+struct roi_align_cell {
+  bool valid;
+  int upleft;
+  scalar_t w_upleft, w_upright, w_downleft, w_downright;
+};
+
+template <typename scalar_t>
+void roi_align_cells(const scalar_t *roi, const scalar_t spatial_scale,
+                     const int height, const int width,
+                     const int pooled_height, const int pooled_width,
+                     std::vector<roi_align_cell<scalar_t> > &cells) {
+  scalar_t roi_start_w = roi[1] * spatial_scale;
+  scalar_t roi_start_h = roi[2] * spatial_scale;
+  scalar_t roi_end_w = roi[3] * spatial_scale;
+  scalar_t roi_end_h = roi[4] * spatial_scale;
+
+  scalar_t roi_width = std::max<scalar_t>(roi_end_w - roi_start_w + 1., 0.);
+  scalar_t roi_height = std::max<scalar_t>(roi_end_h - roi_start_h + 1., 0.);
+  scalar_t bin_size_h = roi_height / (pooled_height - 1.);
+  scalar_t bin_size_w = roi_width / (pooled_width - 1.);
+
+  cells.resize(pooled_height * pooled_width);
+
+  for (int ph = 0; ph < pooled_height; ++ph) {
+    for (int pw = 0; pw < pooled_width; ++pw) {
+      roi_align_cell<scalar_t> &cell = cells[ph * pooled_width + pw];
+
+      scalar_t h = (scalar_t)ph * bin_size_h + roi_start_h;
+      scalar_t w = (scalar_t)pw * bin_size_w + roi_start_w;
+
+      cell.valid = !(h < 0 || h >= height || w < 0 || w >= width);
+      if (!cell.valid) {
+        continue;
+      }
+
+      int hstart = std::min<int>(std::floor(h), height - 2);
+      int wstart = std::min<int>(std::floor(w), width - 2);
+
+      scalar_t h_ratio = h - (scalar_t)hstart;
+      scalar_t w_ratio = w - (scalar_t)wstart;
+
+      cell.upleft = hstart * width + wstart;
+      cell.w_upleft = (1. - h_ratio) * (1. - w_ratio);
+      cell.w_upright = (1. - h_ratio) * w_ratio;
+      cell.w_downleft = h_ratio * (1. - w_ratio);
+      cell.w_downright = h_ratio * w_ratio;
+    }
+  }
+}
+
+template <typename scalar_t>
+void roi_align_forward_cpu_kernel(const scalar_t *bottom_data,
+                                  const scalar_t *rois,
+                                  const scalar_t spatial_scale,
+                                  const int channels, const int height,
+                                  const int width, const int num_rois,
+                                  const int pooled_height,
+                                  const int pooled_width, scalar_t *top_data) {
+  const int pooled_size = pooled_height * pooled_width;
+
+  at::parallel_for(0, num_rois, 1, [&](int64_t begin, int64_t end) {
+    std::vector<roi_align_cell<scalar_t> > cells;
+
+    for (int64_t n = begin; n < end; ++n) {
+      const scalar_t *roi = rois + n * 5;
+      int roi_batch_ind = roi[0];
+
+      roi_align_cells(roi, spatial_scale, height, width, pooled_height,
+                      pooled_width, cells);
+
+      for (int c = 0; c < channels; ++c) {
+        const scalar_t *plane =
+            bottom_data + (roi_batch_ind * channels + c) * height * width;
+        scalar_t *top = top_data + (n * channels + c) * pooled_size;
+
+        for (int i = 0; i < pooled_size; ++i) {
+          const roi_align_cell<scalar_t> &cell = cells[i];
+          if (!cell.valid) {
+            top[i] = 0.;
+            continue;
+          }
+          const scalar_t *p = plane + cell.upleft;
+          top[i] = p[0] * cell.w_upleft + p[1] * cell.w_upright +
+                   p[width] * cell.w_downleft + p[width + 1] * cell.w_downright;
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void roi_align_backward_cpu_kernel(const scalar_t *top_diff,
+                                   const scalar_t *rois,
+                                   const scalar_t spatial_scale,
+                                   const int channels, const int height,
+                                   const int width, const int num_rois,
+                                   const int pooled_height,
+                                   const int pooled_width,
+                                   scalar_t *bottom_diff) {
+  const int pooled_size = pooled_height * pooled_width;
+
+  // ROIs overlap in the input, channels do not, so threads split channels
+  std::vector<std::vector<roi_align_cell<scalar_t> > > cells(num_rois);
+  for (int n = 0; n < num_rois; ++n) {
+    roi_align_cells(rois + n * 5, spatial_scale, height, width,
+                    pooled_height, pooled_width, cells[n]);
+  }
+
+  at::parallel_for(0, channels, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      for (int n = 0; n < num_rois; ++n) {
+        int roi_batch_ind = rois[n * 5];
+        scalar_t *plane =
+            bottom_diff + (roi_batch_ind * channels + c) * height * width;
+        const scalar_t *top = top_diff + (n * channels + c) * pooled_size;
+
+        for (int i = 0; i < pooled_size; ++i) {
+          const roi_align_cell<scalar_t> &cell = cells[n][i];
+          if (!cell.valid) {
+            continue;
+          }
+          scalar_t *p = plane + cell.upleft;
+          p[0] += top[i] * cell.w_upleft;
+          p[1] += top[i] * cell.w_upright;
+          p[width] += top[i] * cell.w_downleft;
+          p[width + 1] += top[i] * cell.w_downright;
+        }
+      }
+    }
+  });
+}
+
+int roi_align_forward_cpu(at::Tensor features, at::Tensor rois,
+                          int pooled_height, int pooled_width,
+                          float spatial_scale, int sample_num,
+                          at::Tensor output) {
+  CHECK_INPUT(features);
+  CHECK_INPUT(rois);
+  CHECK_INPUT(output);
+
+  // Number of ROIs
+  int num_rois = rois.size(0);
+  int size_rois = rois.size(1);
+
+  if (size_rois != 5) {
+    printf("wrong roi size\n");
+    return 0;
+  }
+
+  int num_channels = features.size(1);
+  int data_height = features.size(2);
+  int data_width = features.size(3);
+
+  AT_DISPATCH_FLOATING_TYPES(features.scalar_type(), "roi_align_forward_cpu", ([&] {
+    const at::Tensor rois_t = rois.to(features.scalar_type()).contiguous();
+    roi_align_forward_cpu_kernel<scalar_t>(
+        features.data_ptr<scalar_t>(), rois_t.data_ptr<scalar_t>(),
+        scalar_t(spatial_scale), num_channels, data_height, data_width,
+        num_rois, pooled_height, pooled_width, output.data_ptr<scalar_t>());
+  }));
+
+  return 1;
+}
+
+int roi_align_backward_cpu(at::Tensor top_grad, at::Tensor rois,
+                           int pooled_height, int pooled_width,
+                           float spatial_scale, int sample_num,
+                           at::Tensor bottom_grad) {
+  CHECK_INPUT(top_grad);
+  CHECK_INPUT(rois);
+  CHECK_INPUT(bottom_grad);
+
+  // Number of ROIs
+  int num_rois = rois.size(0);
+  int size_rois = rois.size(1);
+  if (size_rois != 5) {
+    printf("wrong roi size\n");
+    return 0;
+  }
+
+  int num_channels = bottom_grad.size(1);
+  int data_height = bottom_grad.size(2);
+  int data_width = bottom_grad.size(3);
+
+  AT_DISPATCH_FLOATING_TYPES(top_grad.scalar_type(), "roi_align_backward_cpu", ([&] {
+    const at::Tensor rois_t = rois.to(top_grad.scalar_type()).contiguous();
+    roi_align_backward_cpu_kernel<scalar_t>(
+        top_grad.data_ptr<scalar_t>(), rois_t.data_ptr<scalar_t>(),
+        scalar_t(spatial_scale), num_channels, data_height, data_width,
+        num_rois, pooled_height, pooled_width, bottom_grad.data_ptr<scalar_t>());
+  }));
+
+  return 1;
+}
+
+PYBIND11_MODULE(TORCH_EXTENSION_NAME, m) {
+  // the CUDA ada launchers run the plain kernels, which is matched here
+  m.def("forward", &roi_align_forward_cpu, "Roi_Align forward (CPU)");
+  m.def("backward", &roi_align_backward_cpu, "Roi_Align backward (CPU)");
+  m.def("ada_forward", &roi_align_forward_cpu, "Roi_Align_ada forward (CPU)");
+  m.def("ada_backward", &roi_align_backward_cpu, "Roi_Align_ada backward (CPU)");
+}
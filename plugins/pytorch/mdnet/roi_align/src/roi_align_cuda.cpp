@@ -17,6 +17,14 @@ int ROIAlignBackwardLaucher(const at::Tensor top_grad, const at::Tensor rois,
                             const int pooled_height, const int pooled_width,
                             at::Tensor bottom_grad);
 
+int ROIAlignBatchedForwardLaucher(const std::vector<at::Tensor> &features,
+                                  const at::Tensor rois,
+                                  const std::vector<int> &roi_counts,
+                                  const float spatial_scale,
+                                  const int channels, const int num_rois,
+                                  const int pooled_height,
+                                  const int pooled_width, at::Tensor output);
+
 int ROIAlignAdaForwardLaucher(const at::Tensor features, const at::Tensor rois,
                            const float spatial_scale, const int sample_num,
                            const int channels, const int height,
@@ -93,6 +101,53 @@ int roi_align_backward_cuda(at::Tensor top_grad, at::Tensor rois,
   return 1;
 }
 
+// Aligns the ROIs of several feature maps in one launch. rois[i] indexes
+// into features[i], and output concatenates the results in list order.
+int roi_align_batched_forward_cuda(std::vector<at::Tensor> features,
+                                   std::vector<at::Tensor> rois,
+                                   int pooled_height, int pooled_width,
+                                   float spatial_scale, at::Tensor output) {
+  CHECK_INPUT(output);
+
+  if (features.empty() || features.size() != rois.size()) {
+    printf("features and rois must be non-empty lists of the same length\n");
+    return 0;
+  }
+
+  int num_channels = features[0].size(1);
+  int num_rois = 0;
+  std::vector<int> roi_counts;
+  roi_counts.reserve(rois.size());
+
+  for (size_t i = 0; i < features.size(); ++i) {
+    CHECK_INPUT(features[i]);
+    CHECK_INPUT(rois[i]);
+
+    if (rois[i].size(1) != 5) {
+      printf("wrong roi size\n");
+      return 0;
+    }
+    if (features[i].size(1) != num_channels ||
+        features[i].scalar_type() != output.scalar_type()) {
+      printf("feature maps must share channels and type\n");
+      return 0;
+    }
+
+    roi_counts.push_back(rois[i].size(0));
+    num_rois += rois[i].size(0);
+  }
+
+  if (num_rois == 0) {
+    return 1;
+  }
+
+  ROIAlignBatchedForwardLaucher(features, at::cat(rois, 0), roi_counts,
+                                spatial_scale, num_channels, num_rois,
+                                pooled_height, pooled_width, output);
+
+  return 1;
+}
+
 int roi_align_ada_forward_cuda(at::Tensor features, at::Tensor rois,
                            int pooled_height, int pooled_width,
                            float spatial_scale, int sample_num,
@@ -151,6 +206,7 @@ int roi_align_ada_backward_cuda(at::Tensor top_grad, at::Tensor rois,
 PYBIND11_MODULE(TORCH_EXTENSION_NAME, m) {
   m.def("forward", &roi_align_forward_cuda, "Roi_Align forward (CUDA)");
   m.def("backward", &roi_align_backward_cuda, "Roi_Align backward (CUDA)");
+  m.def("batched_forward", &roi_align_batched_forward_cuda, "Roi_Align forward over several feature maps (CUDA)");
   m.def("ada_forward", &roi_align_ada_forward_cuda, "Roi_Align_ada forward (CUDA)");
   m.def("ada_backward", &roi_align_ada_backward_cuda, "Roi_Align_ada backward (CUDA)");
 }
@@ -1,6 +1,9 @@
 #include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
 #include <THC/THCAtomics.cuh>
 
+#include <vector>
+
 #define CUDA_1D_KERNEL_LOOP(i, n)                            \
   for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < n; \
        i += blockDim.x * gridDim.x)
@@ -60,10 +63,56 @@ __device__ scalar_t bilinear_interpolate(const scalar_t *bottom_data,
   return val;
 }
 
-template <typename scalar_t>
+// Samples one element of the aligned output of roi (5 values, batch index
+// first) from the feature map, accumulating in accscalar_t so half and
+// bfloat16 features keep float precision in the interpolation
+template <typename scalar_t, typename accscalar_t>
+__device__ accscalar_t roi_align_sample(const scalar_t *bottom_data,
+                                        const accscalar_t *roi,
+                                        const accscalar_t spatial_scale,
+                                        const int c, const int ph, const int pw,
+                                        const int channels,
+                                        const int height, const int width,
+                                        const int pooled_height,
+                                        const int pooled_width) {
+  int roi_batch_ind = roi[0];
+  accscalar_t roi_start_w = roi[1] * spatial_scale;
+  accscalar_t roi_start_h = roi[2] * spatial_scale;
+  accscalar_t roi_end_w = roi[3] * spatial_scale;
+  accscalar_t roi_end_h = roi[4] * spatial_scale;
+
+  accscalar_t roi_width = fmaxf(roi_end_w - roi_start_w + 1., 0.);
+  accscalar_t roi_height = fmaxf(roi_end_h - roi_start_h + 1., 0.);
+  accscalar_t bin_size_h = roi_height / (pooled_height - 1.);
+  accscalar_t bin_size_w = roi_width / (pooled_width - 1.);
+
+  accscalar_t h = (accscalar_t)ph * bin_size_h + roi_start_h;
+  accscalar_t w = (accscalar_t)pw * bin_size_w + roi_start_w;
+
+  if (h < 0 || h >= height || w < 0 || w >= width) {
+    return 0.;
+  }
+
+  int hstart = fminf(floor(h), height - 2);
+  int wstart = fminf(floor(w), width - 2);
+
+  accscalar_t h_ratio = h - (accscalar_t)hstart;
+  accscalar_t w_ratio = w - (accscalar_t)wstart;
+  int upleft = ((roi_batch_ind * channels + c) * height + hstart) * width + wstart;
+  int upright = upleft + 1;
+  int downleft = upleft + width;
+  int downright = downleft + 1;
+
+  return static_cast<accscalar_t>(bottom_data[upleft]) * (1. - h_ratio) * (1. - w_ratio)
+       + static_cast<accscalar_t>(bottom_data[upright]) * (1. - h_ratio) * w_ratio
+       + static_cast<accscalar_t>(bottom_data[downleft]) * h_ratio * (1. - w_ratio)
+       + static_cast<accscalar_t>(bottom_data[downright]) * h_ratio * w_ratio;
+}
+
+template <typename scalar_t, typename accscalar_t>
 __global__ void ROIAlignForward(const int nthreads, const scalar_t *bottom_data,
-                                const scalar_t *bottom_rois,
-                                const scalar_t spatial_scale,
+                                const accscalar_t *bottom_rois,
+                                const accscalar_t spatial_scale,
                                 const int sample_num, const int channels,
                                 const int height, const int width,
                                 const int pooled_height, const int pooled_width,
@@ -78,57 +127,50 @@ __global__ void ROIAlignForward(const int nthreads, const scalar_t *bottom_data,
     int c = n % channels;
     n /= channels;
 
-    const scalar_t *offset_bottom_rois = bottom_rois + n * 5;
-    int roi_batch_ind = offset_bottom_rois[0];
-    scalar_t roi_start_w = offset_bottom_rois[1] * spatial_scale;
-    scalar_t roi_start_h = offset_bottom_rois[2] * spatial_scale;
-    scalar_t roi_end_w = offset_bottom_rois[3] * spatial_scale;
-    scalar_t roi_end_h = offset_bottom_rois[4] * spatial_scale;
-
-    // Force malformed ROIs to be 1x1
-    // scalar_t roi_width = fmaxf((scalar_t)roi_end_w - roi_start_w, 0.);
-    // scalar_t roi_height = fmaxf((scalar_t)roi_end_h - roi_start_h, 0.);
-
-    // scalar_t bin_size_h = roi_height / pooled_height;
-    // scalar_t bin_size_w = roi_width / pooled_width;
-    // original
-    scalar_t roi_width = fmaxf((scalar_t)roi_end_w - roi_start_w + 1., 0.);
-    scalar_t roi_height = fmaxf((scalar_t)roi_end_h - roi_start_h + 1., 0.);
-    scalar_t bin_size_h = roi_height / (pooled_height - 1.);
-    scalar_t bin_size_w = roi_width / (pooled_width - 1.);
-
-    // const scalar_t *offset_bottom_data =
-    //     bottom_data + (roi_batch_ind * channels + c) * height * width;
-
-    // int sample_num_h = (sample_num > 0)
-    //                        ? sample_num
-    //                        : ceil(roi_height / pooled_height);  // e.g., = 2
-    // int sample_num_w =
-    //     (sample_num > 0) ? sample_num : ceil(roi_width / pooled_width);
-
-    scalar_t h = (scalar_t)ph * bin_size_h + roi_start_h;
-    scalar_t w = (scalar_t)pw * bin_size_w + roi_start_w;
-
-    int hstart = fminf(floor(h), height - 2);
-    int wstart = fminf(floor(w), width - 2);
+    top_data[index] = static_cast<scalar_t>(roi_align_sample(
+        bottom_data, bottom_rois + n * 5, spatial_scale, c, ph, pw,
+        channels, height, width, pooled_height, pooled_width));
+  }
+}
 
-    int img_start = roi_batch_ind * channels * height * width;
+// Feature map of a batched launch: its data and the end of its ROIs in the
+// concatenated ROI list
+struct ROIAlignBatchMap {
+  const void *data;
+  int height;
+  int width;
+  int roi_end;
+};
+
+template <typename scalar_t, typename accscalar_t>
+__global__ void ROIAlignBatchedForward(const int nthreads,
+                                       const ROIAlignBatchMap *maps,
+                                       const int num_maps,
+                                       const accscalar_t *bottom_rois,
+                                       const accscalar_t spatial_scale,
+                                       const int channels,
+                                       const int pooled_height,
+                                       const int pooled_width,
+                                       scalar_t *top_data) {
+  CUDA_1D_KERNEL_LOOP(index, nthreads) {
+    int n = index;
+    int pw = n % pooled_width;
+    n /= pooled_width;
+    int ph = n % pooled_height;
+    n /= pooled_height;
+    int c = n % channels;
+    n /= channels;
 
-    if (h < 0 || h >= height || w < 0 || w >= width)
-    {
-        top_data[index] = 0.;
-    }else{
-        scalar_t h_ratio = h - (scalar_t)hstart;
-        scalar_t w_ratio = w - (scalar_t)wstart;
-        int upleft = img_start + (c * height + hstart) * width + wstart;
-        int upright = upleft + 1;
-        int downleft = upleft + width;
-        int downright = downleft + 1;
-        top_data[index] = bottom_data[upleft] * (1. - h_ratio) * (1. - w_ratio)
-                    + bottom_data[upright] * (1. - h_ratio) * w_ratio
-                    + bottom_data[downleft] * h_ratio * (1. - w_ratio)
-                    + bottom_data[downright] * h_ratio * w_ratio;
+    // a launch holds a handful of maps, so a scan beats a search
+    int m = 0;
+    while (m < num_maps - 1 && n >= maps[m].roi_end) {
+      ++m;
     }
+
+    top_data[index] = static_cast<scalar_t>(roi_align_sample(
+        static_cast<const scalar_t *>(maps[m].data), bottom_rois + n * 5,
+        spatial_scale, c, ph, pw, channels, maps[m].height, maps[m].width,
+        pooled_height, pooled_width));
   }
 }
 
@@ -139,15 +181,19 @@ int ROIAlignForwardLaucher(const at::Tensor features, const at::Tensor rois,
                            const int pooled_height, const int pooled_width,
                            at::Tensor output) {
   const int output_size = num_rois * pooled_height * pooled_width * channels;
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
-      features.type(), "ROIAlignLaucherForward", ([&] {
-        const scalar_t *bottom_data = features.data<scalar_t>();
-        const scalar_t *rois_data = rois.data<scalar_t>();
-        scalar_t *top_data = output.data<scalar_t>();
-
-        ROIAlignForward<scalar_t>
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::ScalarType::Half, at::ScalarType::BFloat16,
+      features.scalar_type(), "ROIAlignLaucherForward", ([&] {
+        using accscalar_t = at::acc_type<scalar_t, true>;
+        const at::Tensor rois_acc = rois.to(
+            at::CppTypeToScalarType<accscalar_t>::value).contiguous();
+        const scalar_t *bottom_data = features.data_ptr<scalar_t>();
+        const accscalar_t *rois_data = rois_acc.data_ptr<accscalar_t>();
+        scalar_t *top_data = output.data_ptr<scalar_t>();
+
+        ROIAlignForward<scalar_t, accscalar_t>
             <<<GET_BLOCKS(output_size), THREADS_PER_BLOCK>>>(
-                output_size, bottom_data, rois_data, scalar_t(spatial_scale),
+                output_size, bottom_data, rois_data, accscalar_t(spatial_scale),
                 sample_num, channels, height, width, pooled_height,
                 pooled_width, top_data);
       }));
@@ -155,6 +201,55 @@ int ROIAlignForwardLaucher(const at::Tensor features, const at::Tensor rois,
   return 1;
 }
 
+int ROIAlignBatchedForwardLaucher(const std::vector<at::Tensor> &features,
+                                  const at::Tensor rois,
+                                  const std::vector<int> &roi_counts,
+                                  const float spatial_scale,
+                                  const int channels, const int num_rois,
+                                  const int pooled_height,
+                                  const int pooled_width, at::Tensor output) {
+  const int num_maps = features.size();
+  const int output_size = num_rois * pooled_height * pooled_width * channels;
+
+  // the map table goes to the device with the launch, one copy for all maps
+  at::Tensor maps_host = at::empty(
+      {static_cast<int64_t>(num_maps * sizeof(ROIAlignBatchMap))},
+      at::TensorOptions().dtype(at::kByte).pinned_memory(true));
+  ROIAlignBatchMap *maps = reinterpret_cast<ROIAlignBatchMap *>(
+      maps_host.data_ptr<uint8_t>());
+
+  int roi_end = 0;
+  for (int i = 0; i < num_maps; ++i) {
+    roi_end += roi_counts[i];
+    maps[i].data = features[i].data_ptr();
+    maps[i].height = features[i].size(2);
+    maps[i].width = features[i].size(3);
+    maps[i].roi_end = roi_end;
+  }
+
+  const at::Tensor maps_device = maps_host.to(output.device(), at::kByte, /*non_blocking=*/true);
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::ScalarType::Half, at::ScalarType::BFloat16,
+      output.scalar_type(), "ROIAlignBatchedLaucherForward", ([&] {
+        using accscalar_t = at::acc_type<scalar_t, true>;
+        const at::Tensor rois_acc = rois.to(
+            at::CppTypeToScalarType<accscalar_t>::value).contiguous();
+        const accscalar_t *rois_data = rois_acc.data_ptr<accscalar_t>();
+        scalar_t *top_data = output.data_ptr<scalar_t>();
+
+        ROIAlignBatchedForward<scalar_t, accscalar_t>
+            <<<GET_BLOCKS(output_size), THREADS_PER_BLOCK>>>(
+                output_size,
+                reinterpret_cast<const ROIAlignBatchMap *>(
+                    maps_device.data_ptr<uint8_t>()),
+                num_maps, rois_data, accscalar_t(spatial_scale), channels,
+                pooled_height, pooled_width, top_data);
+      }));
+  THCudaCheck(cudaGetLastError());
+  return 1;
+}
+
 template <typename scalar_t>
 __device__ void bilinear_interpolate_gradient(const int height, const int width,
                                               scalar_t y, scalar_t x,
@@ -199,10 +294,10 @@ __device__ void bilinear_interpolate_gradient(const int height, const int width,
   return;
 }
 
-template <typename scalar_t>
+template <typename scalar_t, typename accscalar_t>
 __global__ void ROIAlignBackward(
-    const int nthreads, const scalar_t *top_diff, const scalar_t *bottom_rois,
-    const scalar_t spatial_scale, const int sample_num, const int channels,
+    const int nthreads, const scalar_t *top_diff, const accscalar_t *bottom_rois,
+    const accscalar_t spatial_scale, const int sample_num, const int channels,
     const int height, const int width, const int pooled_height,
     const int pooled_width, scalar_t *bottom_diff) {
   CUDA_1D_KERNEL_LOOP(index, nthreads) {
@@ -215,36 +310,22 @@ __global__ void ROIAlignBackward(
     int c = n % channels;
     n /= channels;
 
-    const scalar_t *offset_bottom_rois = bottom_rois + n * 5;
+    const accscalar_t *offset_bottom_rois = bottom_rois + n * 5;
     int roi_batch_ind = offset_bottom_rois[0];
-    scalar_t roi_start_w = offset_bottom_rois[1] * spatial_scale;
-    scalar_t roi_start_h = offset_bottom_rois[2] * spatial_scale;
-    scalar_t roi_end_w = offset_bottom_rois[3] * spatial_scale;
-    scalar_t roi_end_h = offset_bottom_rois[4] * spatial_scale;
+    accscalar_t roi_start_w = offset_bottom_rois[1] * spatial_scale;
+    accscalar_t roi_start_h = offset_bottom_rois[2] * spatial_scale;
+    accscalar_t roi_end_w = offset_bottom_rois[3] * spatial_scale;
+    accscalar_t roi_end_h = offset_bottom_rois[4] * spatial_scale;
 
     // Force malformed ROIs to be 1x1
-    scalar_t roi_width = fmaxf((scalar_t)roi_end_w - roi_start_w + 1., 0.);
-    scalar_t roi_height = fmaxf((scalar_t)roi_end_h - roi_start_h + 1., 0.);
-
-    scalar_t bin_size_h = roi_height / (pooled_height - 1.);
-    scalar_t bin_size_w = roi_width / (pooled_width - 1.);
-
-    // scalar_t *offset_bottom_diff =
-    //     bottom_diff + (roi_batch_ind * channels + c) * height * width;
-    // int offset_top = (n * channels + c) * pooled_height * pooled_width +
-    //                  ph * pooled_width + pw;
-    // scalar_t offset_top_diff = top_diff[offset_top];
-
-    // int sample_num_h = (sample_num > 0)
-    //                        ? sample_num
-    //                        : ceil(roi_height / pooled_height);  // e.g., = 2
-    // int sample_num_w =
-    //     (sample_num > 0) ? sample_num : ceil(roi_width / pooled_width);
+    accscalar_t roi_width = fmaxf(roi_end_w - roi_start_w + 1., 0.);
+    accscalar_t roi_height = fmaxf(roi_end_h - roi_start_h + 1., 0.);
 
-    // const scalar_t count = (scalar_t)(sample_num_h * sample_num_w);
+    accscalar_t bin_size_h = roi_height / (pooled_height - 1.);
+    accscalar_t bin_size_w = roi_width / (pooled_width - 1.);
 
-    scalar_t h = (scalar_t)ph * bin_size_h + roi_start_h;
-    scalar_t w = (scalar_t)pw * bin_size_w + roi_start_w;
+    accscalar_t h = (accscalar_t)ph * bin_size_h + roi_start_h;
+    accscalar_t w = (accscalar_t)pw * bin_size_w + roi_start_w;
 
     int hstart = fminf(floor(h), height - 2);
     int wstart = fminf(floor(w), width - 2);
@@ -253,17 +334,18 @@ __global__ void ROIAlignBackward(
 
     if (!(h < 0 || h >= height || w < 0 || w >= width))
     {
-        scalar_t h_ratio = h - (scalar_t)(hstart);
-        scalar_t w_ratio = w - (scalar_t)(wstart);
+        accscalar_t h_ratio = h - (accscalar_t)(hstart);
+        accscalar_t w_ratio = w - (accscalar_t)(wstart);
+        accscalar_t grad = static_cast<accscalar_t>(top_diff[index]);
         int upleft = img_start + (c * height + hstart) * width + wstart;
         int upright = upleft + 1;
         int downleft = upleft + width;
         int downright = downleft + 1;
 
-        atomicAdd(bottom_diff + upleft, top_diff[index] * (1. - h_ratio) * (1 - w_ratio));
-        atomicAdd(bottom_diff + upright, top_diff[index] * (1. - h_ratio) * w_ratio);
-        atomicAdd(bottom_diff + downleft, top_diff[index] * h_ratio * (1 - w_ratio));
-        atomicAdd(bottom_diff + downright, top_diff[index] * h_ratio * w_ratio);
+        atomicAdd(bottom_diff + upleft, static_cast<scalar_t>(grad * (1. - h_ratio) * (1 - w_ratio)));
+        atomicAdd(bottom_diff + upright, static_cast<scalar_t>(grad * (1. - h_ratio) * w_ratio));
+        atomicAdd(bottom_diff + downleft, static_cast<scalar_t>(grad * h_ratio * (1 - w_ratio)));
+        atomicAdd(bottom_diff + downright, static_cast<scalar_t>(grad * h_ratio * w_ratio));
     }
   }
 }
@@ -276,19 +358,23 @@ int ROIAlignBackwardLaucher(const at::Tensor top_grad, const at::Tensor rois,
                             at::Tensor bottom_grad) {
   const int output_size = num_rois * pooled_height * pooled_width * channels;
 
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
-      top_grad.type(), "ROIAlignLaucherBackward", ([&] {
-        const scalar_t *top_diff = top_grad.data<scalar_t>();
-        const scalar_t *rois_data = rois.data<scalar_t>();
-        scalar_t *bottom_diff = bottom_grad.data<scalar_t>();
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::ScalarType::Half, at::ScalarType::BFloat16,
+      top_grad.scalar_type(), "ROIAlignLaucherBackward", ([&] {
+        using accscalar_t = at::acc_type<scalar_t, true>;
+        const at::Tensor rois_acc = rois.to(
+            at::CppTypeToScalarType<accscalar_t>::value).contiguous();
+        const scalar_t *top_diff = top_grad.data_ptr<scalar_t>();
+        const accscalar_t *rois_data = rois_acc.data_ptr<accscalar_t>();
+        scalar_t *bottom_diff = bottom_grad.data_ptr<scalar_t>();
         if (sizeof(scalar_t) == sizeof(double)) {
           fprintf(stderr, "double is not supported\n");
           exit(-1);
         }
 
-        ROIAlignBackward<scalar_t>
+        ROIAlignBackward<scalar_t, accscalar_t>
             <<<GET_BLOCKS(output_size), THREADS_PER_BLOCK>>>(
-                output_size, top_diff, rois_data, spatial_scale, sample_num,
+                output_size, top_diff, rois_data, accscalar_t(spatial_scale), sample_num,
                 channels, height, width, pooled_height, pooled_width,
                 bottom_diff);
       }));
@@ -377,15 +463,19 @@ int ROIAlignAdaForwardLaucher(const at::Tensor features, const at::Tensor rois,
                            const int pooled_height, const int pooled_width,
                            at::Tensor output) {
   const int output_size = num_rois * pooled_height * pooled_width * channels;
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
-      features.type(), "ROIAlignAdaLaucherForward", ([&] {
-        const scalar_t *bottom_data = features.data<scalar_t>();
-        const scalar_t *rois_data = rois.data<scalar_t>();
-        scalar_t *top_data = output.data<scalar_t>();
-
-        ROIAlignForward<scalar_t>
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::ScalarType::Half, at::ScalarType::BFloat16,
+      features.scalar_type(), "ROIAlignAdaLaucherForward", ([&] {
+        using accscalar_t = at::acc_type<scalar_t, true>;
+        const at::Tensor rois_acc = rois.to(
+            at::CppTypeToScalarType<accscalar_t>::value).contiguous();
+        const scalar_t *bottom_data = features.data_ptr<scalar_t>();
+        const accscalar_t *rois_data = rois_acc.data_ptr<accscalar_t>();
+        scalar_t *top_data = output.data_ptr<scalar_t>();
+
+        ROIAlignForward<scalar_t, accscalar_t>
             <<<GET_BLOCKS(output_size), THREADS_PER_BLOCK>>>(
-                output_size, bottom_data, rois_data, scalar_t(spatial_scale),
+                output_size, bottom_data, rois_data, accscalar_t(spatial_scale),
                 sample_num, channels, height, width, pooled_height,
                 pooled_width, top_data);
       }));
@@ -471,19 +561,23 @@ int ROIAlignAdaBackwardLaucher(const at::Tensor top_grad, const at::Tensor rois,
                             at::Tensor bottom_grad) {
   const int output_size = num_rois * pooled_height * pooled_width * channels;
 
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
-      top_grad.type(), "ROIAlignAdaLaucherBackward", ([&] {
-        const scalar_t *top_diff = top_grad.data<scalar_t>();
-        const scalar_t *rois_data = rois.data<scalar_t>();
-        scalar_t *bottom_diff = bottom_grad.data<scalar_t>();
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::ScalarType::Half, at::ScalarType::BFloat16,
+      top_grad.scalar_type(), "ROIAlignAdaLaucherBackward", ([&] {
+        using accscalar_t = at::acc_type<scalar_t, true>;
+        const at::Tensor rois_acc = rois.to(
+            at::CppTypeToScalarType<accscalar_t>::value).contiguous();
+        const scalar_t *top_diff = top_grad.data_ptr<scalar_t>();
+        const accscalar_t *rois_data = rois_acc.data_ptr<accscalar_t>();
+        scalar_t *bottom_diff = bottom_grad.data_ptr<scalar_t>();
         if (sizeof(scalar_t) == sizeof(double)) {
           fprintf(stderr, "double is not supported\n");
           exit(-1);
         }
 
-        ROIAlignBackward<scalar_t>
+        ROIAlignBackward<scalar_t, accscalar_t>
             <<<GET_BLOCKS(output_size), THREADS_PER_BLOCK>>>(
-                output_size, top_diff, rois_data, spatial_scale, sample_num,
+                output_size, top_diff, rois_data, accscalar_t(spatial_scale), sample_num,
                 channels, height, width, pooled_height, pooled_width,
                 bottom_diff);
       }));
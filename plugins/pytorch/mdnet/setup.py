@@ -5,7 +5,13 @@ from setuptools import setup, find_packages
 
 from torch.utils.cpp_extension import BuildExtension, CUDAExtension, CppExtension
 
-modules = []
+modules = [
+    CppExtension(
+        'roi_align.roi_align_cpu',
+        ['roi_align/src/roi_align_cpu.cpp'],
+        extra_compile_args={'cxx': ['-O2']}
+    )
+]
 
 if torch.cuda.is_available():
     modules.append(
@@ -9,26 +9,287 @@
 */
 
 #include <vector>
+#include <cmath>
 
 #include <ATen/ATen.h>
-#include <ATen/cuda/CUDAContext.h>
+#include <ATen/Parallel.h>
+
+
+// Corners and weights of a bilinear sample, matching ms_deform_attn_im2col_bilinear
+// of the CUDA kernels, with corners outside the feature map given no offset
+template <typename scalar_t>
+struct ms_deform_attn_bilinear
+{
+  int offset[4];
+  bool valid[4];
+  scalar_t weight[4];
+  scalar_t lh, lw, hh, hw;
+
+  ms_deform_attn_bilinear(const int height, const int width, const int w_stride,
+                          const scalar_t h, const scalar_t w)
+  {
+    const int h_low = std::floor(h);
+    const int w_low = std::floor(w);
+    const int h_high = h_low + 1;
+    const int w_high = w_low + 1;
+
+    lh = h - h_low;
+    lw = w - w_low;
+    hh = 1 - lh;
+    hw = 1 - lw;
+
+    const int h_stride = width * w_stride;
+
+    valid[0] = h_low >= 0 && w_low >= 0;
+    valid[1] = h_low >= 0 && w_high <= width - 1;
+    valid[2] = h_high <= height - 1 && w_low >= 0;
+    valid[3] = h_high <= height - 1 && w_high <= width - 1;
+
+    offset[0] = h_low * h_stride + w_low * w_stride;
+    offset[1] = offset[0] + w_stride;
+    offset[2] = offset[0] + h_stride;
+    offset[3] = offset[2] + w_stride;
+
+    weight[0] = hh * hw;
+    weight[1] = hh * lw;
+    weight[2] = lh * hw;
+    weight[3] = lh * lw;
+  }
+};
+
+
+// Accumulates the attention-weighted samples of one (batch, query, head) over all
+// levels and points into the channels of col
+template <typename scalar_t>
+void ms_deformable_im2col_cpu(const scalar_t *data_value,
+                              const int64_t *data_spatial_shapes,
+                              const int64_t *data_level_start_index,
+                              const scalar_t *data_sampling_loc,
+                              const scalar_t *data_attn_weight,
+                              const int num_heads,
+                              const int channels,
+                              const int num_levels,
+                              const int num_point,
+                              const int m_col,
+                              scalar_t *col)
+{
+  const int w_stride = num_heads * channels;
+
+  for (int l_col = 0; l_col < num_levels; ++l_col)
+  {
+    const int level_start_id = data_level_start_index[l_col];
+    const int spatial_h = data_spatial_shapes[l_col << 1];
+    const int spatial_w = data_spatial_shapes[(l_col << 1) + 1];
+    const scalar_t *data_value_ptr = data_value + level_start_id * w_stride + m_col * channels;
+
+    for (int p_col = 0; p_col < num_point; ++p_col)
+    {
+      const scalar_t loc_w = data_sampling_loc[0];
+      const scalar_t loc_h = data_sampling_loc[1];
+      const scalar_t weight = *data_attn_weight;
+
+      data_sampling_loc += 2;
+      data_attn_weight += 1;
+
+      const scalar_t h_im = loc_h * spatial_h - 0.5;
+      const scalar_t w_im = loc_w * spatial_w - 0.5;
+
+      if (!(h_im > -1 && w_im > -1 && h_im < spatial_h && w_im < spatial_w))
+      {
+        continue;
+      }
+
+      // the corner weights are shared by all channels, which are contiguous
+      const ms_deform_attn_bilinear<scalar_t> bilinear(spatial_h, spatial_w, w_stride, h_im, w_im);
+
+      for (int corner = 0; corner < 4; ++corner)
+      {
+        if (!bilinear.valid[corner])
+        {
+          continue;
+        }
+
+        const scalar_t corner_weight = bilinear.weight[corner] * weight;
+        const scalar_t *corner_ptr = data_value_ptr + bilinear.offset[corner];
+        for (int c = 0; c < channels; ++c)
+        {
+          col[c] += corner_weight * corner_ptr[c];
+        }
+      }
+    }
+  }
+}
+
+
+// Gradients of one (batch, query, head), col2im counterpart of ms_deformable_im2col_cpu
+template <typename scalar_t>
+void ms_deformable_col2im_cpu(const scalar_t *grad_col,
+                              const scalar_t *data_value,
+                              const int64_t *data_spatial_shapes,
+                              const int64_t *data_level_start_index,
+                              const scalar_t *data_sampling_loc,
+                              const scalar_t *data_attn_weight,
+                              const int num_heads,
+                              const int channels,
+                              const int num_levels,
+                              const int num_point,
+                              const int m_col,
+                              scalar_t *grad_value,
+                              scalar_t *grad_sampling_loc,
+                              scalar_t *grad_attn_weight)
+{
+  const int w_stride = num_heads * channels;
+
+  for (int l_col = 0; l_col < num_levels; ++l_col)
+  {
+    const int level_start_id = data_level_start_index[l_col];
+    const int spatial_h = data_spatial_shapes[l_col << 1];
+    const int spatial_w = data_spatial_shapes[(l_col << 1) + 1];
+    const int value_offset = level_start_id * w_stride + m_col * channels;
+
+    for (int p_col = 0; p_col < num_point; ++p_col)
+    {
+      const scalar_t loc_w = data_sampling_loc[0];
+      const scalar_t loc_h = data_sampling_loc[1];
+      const scalar_t weight = *data_attn_weight;
+
+      scalar_t *grad_loc_ptr = grad_sampling_loc;
+      scalar_t *grad_weight_ptr = grad_attn_weight;
+
+      data_sampling_loc += 2;
+      data_attn_weight += 1;
+      grad_sampling_loc += 2;
+      grad_attn_weight += 1;
+
+      const scalar_t h_im = loc_h * spatial_h - 0.5;
+      const scalar_t w_im = loc_w * spatial_w - 0.5;
+
+      if (!(h_im > -1 && w_im > -1 && h_im < spatial_h && w_im < spatial_w))
+      {
+        continue;
+      }
+
+      const ms_deform_attn_bilinear<scalar_t> bilinear(spatial_h, spatial_w, w_stride, h_im, w_im);
+
+      // derivatives of the corner weights along h and w
+      const scalar_t dh[4] = { -bilinear.hw, -bilinear.lw, bilinear.hw, bilinear.lw };
+      const scalar_t dw[4] = { -bilinear.hh, bilinear.hh, -bilinear.lh, bilinear.lh };
+
+      scalar_t grad_h_weight = 0, grad_w_weight = 0, grad_weight = 0;
+
+      for (int corner = 0; corner < 4; ++corner)
+      {
+        if (!bilinear.valid[corner])
+        {
+          continue;
+        }
+
+        const scalar_t *value_ptr = data_value + value_offset + bilinear.offset[corner];
+        scalar_t *grad_value_ptr = grad_value + value_offset + bilinear.offset[corner];
+        const scalar_t corner_weight = bilinear.weight[corner] * weight;
+
+        scalar_t dot = 0;
+        for (int c = 0; c < channels; ++c)
+        {
+          dot += grad_col[c] * value_ptr[c];
+          grad_value_ptr[c] += corner_weight * grad_col[c];
+        }
+
+        grad_h_weight += dh[corner] * dot;
+        grad_w_weight += dw[corner] * dot;
+        grad_weight += bilinear.weight[corner] * dot;
+      }
+
+      *grad_weight_ptr += grad_weight;
+      grad_loc_ptr[0] += spatial_w * grad_w_weight * weight;
+      grad_loc_ptr[1] += spatial_h * grad_h_weight * weight;
+    }
+  }
+}
 
 
 at::Tensor
 ms_deform_attn_cpu_forward(
-    const at::Tensor &value, 
+    const at::Tensor &value,
     const at::Tensor &spatial_shapes,
     const at::Tensor &level_start_index,
     const at::Tensor &sampling_loc,
     const at::Tensor &attn_weight,
     const int im2col_step)
 {
-    AT_ERROR("Not implement on cpu");
+    AT_ASSERTM(value.is_contiguous(), "value tensor has to be contiguous");
+    AT_ASSERTM(spatial_shapes.is_contiguous(), "spatial_shapes tensor has to be contiguous");
+    AT_ASSERTM(level_start_index.is_contiguous(), "level_start_index tensor has to be contiguous");
+    AT_ASSERTM(sampling_loc.is_contiguous(), "sampling_loc tensor has to be contiguous");
+    AT_ASSERTM(attn_weight.is_contiguous(), "attn_weight tensor has to be contiguous");
+
+    AT_ASSERTM(!value.is_cuda(), "value must be a CPU tensor");
+    AT_ASSERTM(!spatial_shapes.is_cuda(), "spatial_shapes must be a CPU tensor");
+    AT_ASSERTM(!level_start_index.is_cuda(), "level_start_index must be a CPU tensor");
+    AT_ASSERTM(!sampling_loc.is_cuda(), "sampling_loc must be a CPU tensor");
+    AT_ASSERTM(!attn_weight.is_cuda(), "attn_weight must be a CPU tensor");
+
+    const int batch = value.size(0);
+    const int spatial_size = value.size(1);
+    const int num_heads = value.size(2);
+    const int channels = value.size(3);
+
+    const int num_levels = spatial_shapes.size(0);
+
+    const int num_query = sampling_loc.size(1);
+    const int num_point = sampling_loc.size(4);
+
+    const int im2col_step_ = std::min(batch, im2col_step);
+
+    AT_ASSERTM(batch % im2col_step_ == 0, "batch(%d) must divide im2col_step(%d)", batch, im2col_step_);
+
+    auto output = at::zeros({batch, num_query, num_heads, channels}, value.options());
+
+    const int64_t per_value_size = spatial_size * num_heads * channels;
+
+    AT_DISPATCH_FLOATING_TYPES(value.scalar_type(), "ms_deform_attn_forward_cpu", ([&] {
+        const scalar_t *value_ptr = value.data_ptr<scalar_t>();
+        const scalar_t *sampling_loc_ptr = sampling_loc.data_ptr<scalar_t>();
+        const scalar_t *attn_weight_ptr = attn_weight.data_ptr<scalar_t>();
+        const int64_t *spatial_shapes_ptr = spatial_shapes.data_ptr<int64_t>();
+        const int64_t *level_start_index_ptr = level_start_index.data_ptr<int64_t>();
+        scalar_t *output_ptr = output.data_ptr<scalar_t>();
+
+        // im2col_step samples of the batch at a time, as on the GPU, each
+        // (sample, query, head) being independent
+        for (int n = 0; n < batch / im2col_step_; ++n)
+        {
+            const int64_t first = int64_t(n) * im2col_step_ * num_query * num_heads;
+            const int64_t count = int64_t(im2col_step_) * num_query * num_heads;
+
+            at::parallel_for(first, first + count, 16, [&](int64_t begin, int64_t end) {
+                for (int64_t index = begin; index < end; ++index)
+                {
+                    const int m_col = index % num_heads;
+                    const int64_t b_col = index / (int64_t(num_query) * num_heads);
+
+                    ms_deformable_im2col_cpu(
+                        value_ptr + b_col * per_value_size,
+                        spatial_shapes_ptr,
+                        level_start_index_ptr,
+                        sampling_loc_ptr + index * num_levels * num_point * 2,
+                        attn_weight_ptr + index * num_levels * num_point,
+                        num_heads, channels, num_levels, num_point, m_col,
+                        output_ptr + index * channels);
+                }
+            });
+        }
+    }));
+
+    output = output.view({batch, num_query, num_heads*channels});
+
+    return output;
 }
 
+
 std::vector<at::Tensor>
 ms_deform_attn_cpu_backward(
-    const at::Tensor &value, 
+    const at::Tensor &value,
     const at::Tensor &spatial_shapes,
     const at::Tensor &level_start_index,
     const at::Tensor &sampling_loc,
@@ -36,6 +297,86 @@ ms_deform_attn_cpu_backward(
     const at::Tensor &grad_output,
     const int im2col_step)
 {
-    AT_ERROR("Not implement on cpu");
-}
+    AT_ASSERTM(value.is_contiguous(), "value tensor has to be contiguous");
+    AT_ASSERTM(spatial_shapes.is_contiguous(), "spatial_shapes tensor has to be contiguous");
+    AT_ASSERTM(level_start_index.is_contiguous(), "level_start_index tensor has to be contiguous");
+    AT_ASSERTM(sampling_loc.is_contiguous(), "sampling_loc tensor has to be contiguous");
+    AT_ASSERTM(attn_weight.is_contiguous(), "attn_weight tensor has to be contiguous");
+    AT_ASSERTM(grad_output.is_contiguous(), "grad_output tensor has to be contiguous");
+
+    AT_ASSERTM(!value.is_cuda(), "value must be a CPU tensor");
+    AT_ASSERTM(!spatial_shapes.is_cuda(), "spatial_shapes must be a CPU tensor");
+    AT_ASSERTM(!level_start_index.is_cuda(), "level_start_index must be a CPU tensor");
+    AT_ASSERTM(!sampling_loc.is_cuda(), "sampling_loc must be a CPU tensor");
+    AT_ASSERTM(!attn_weight.is_cuda(), "attn_weight must be a CPU tensor");
+    AT_ASSERTM(!grad_output.is_cuda(), "grad_output must be a CPU tensor");
+
+    const int batch = value.size(0);
+    const int spatial_size = value.size(1);
+    const int num_heads = value.size(2);
+    const int channels = value.size(3);
+
+    const int num_levels = spatial_shapes.size(0);
+
+    const int num_query = sampling_loc.size(1);
+    const int num_point = sampling_loc.size(4);
+
+    const int im2col_step_ = std::min(batch, im2col_step);
+
+    AT_ASSERTM(batch % im2col_step_ == 0, "batch(%d) must divide im2col_step(%d)", batch, im2col_step_);
 
+    auto grad_value = at::zeros_like(value);
+    auto grad_sampling_loc = at::zeros_like(sampling_loc);
+    auto grad_attn_weight = at::zeros_like(attn_weight);
+
+    const int64_t per_value_size = spatial_size * num_heads * channels;
+
+    AT_DISPATCH_FLOATING_TYPES(value.scalar_type(), "ms_deform_attn_backward_cpu", ([&] {
+        const scalar_t *value_ptr = value.data_ptr<scalar_t>();
+        const scalar_t *sampling_loc_ptr = sampling_loc.data_ptr<scalar_t>();
+        const scalar_t *attn_weight_ptr = attn_weight.data_ptr<scalar_t>();
+        const scalar_t *grad_output_ptr = grad_output.data_ptr<scalar_t>();
+        const int64_t *spatial_shapes_ptr = spatial_shapes.data_ptr<int64_t>();
+        const int64_t *level_start_index_ptr = level_start_index.data_ptr<int64_t>();
+        scalar_t *grad_value_ptr = grad_value.data_ptr<scalar_t>();
+        scalar_t *grad_sampling_loc_ptr = grad_sampling_loc.data_ptr<scalar_t>();
+        scalar_t *grad_attn_weight_ptr = grad_attn_weight.data_ptr<scalar_t>();
+
+        // queries of a (sample, head) all scatter into the same value gradients,
+        // so the work is split by (sample, head) and each task walks its queries
+        for (int n = 0; n < batch / im2col_step_; ++n)
+        {
+            const int64_t first = int64_t(n) * im2col_step_ * num_heads;
+            const int64_t count = int64_t(im2col_step_) * num_heads;
+
+            at::parallel_for(first, first + count, 1, [&](int64_t begin, int64_t end) {
+                for (int64_t task = begin; task < end; ++task)
+                {
+                    const int m_col = task % num_heads;
+                    const int64_t b_col = task / num_heads;
+
+                    for (int q_col = 0; q_col < num_query; ++q_col)
+                    {
+                        const int64_t index = (b_col * num_query + q_col) * num_heads + m_col;
+
+                        ms_deformable_col2im_cpu(
+                            grad_output_ptr + index * channels,
+                            value_ptr + b_col * per_value_size,
+                            spatial_shapes_ptr,
+                            level_start_index_ptr,
+                            sampling_loc_ptr + index * num_levels * num_point * 2,
+                            attn_weight_ptr + index * num_levels * num_point,
+                            num_heads, channels, num_levels, num_point, m_col,
+                            grad_value_ptr + b_col * per_value_size,
+                            grad_sampling_loc_ptr + index * num_levels * num_point * 2,
+                            grad_attn_weight_ptr + index * num_levels * num_point);
+                    }
+                }
+            });
+        }
+    }));
+
+    return {
+        grad_value, grad_sampling_loc, grad_attn_weight
+    };
+}
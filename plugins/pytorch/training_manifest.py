@@ -0,0 +1,139 @@
+# ckwg +29
+# Copyright 2026 by Kitware, Inc.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+#    * Redistributions of source code must retain the above copyright notice,
+#    this list of conditions and the following disclaimer.
+#
+#    * Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+#    * Neither name of Kitware, Inc. nor the names of any contributors may be used
+#    to endorse or promote products derived from this software without specific
+#    prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Reader of the binary training manifest written by viame_train_detector when
+its training_manifest option is set. The manifest holds the prepared training
+and validation images along with their boxes, classes and masks, and is read
+through memory-mapped numpy arrays instead of being parsed. See
+write_training_manifest in viame_train_detector.cxx for the layout.
+"""
+
+import numpy as np
+
+MANIFEST_MAGIC = b'VIAMETM1'
+MANIFEST_VERSION = 1
+
+VALIDATION_FLAG = 1
+
+HEADER_DTYPE = np.dtype( [
+    ( 'magic', 'S8' ), ( 'version', '<u4' ), ( 'reserved', '<u4' ),
+    ( 'image_count', '<u8' ), ( 'box_count', '<u8' ), ( 'class_count', '<u8' ),
+    ( 'string_size', '<u8' ), ( 'mask_size', '<u8' ) ] )
+
+IMAGE_DTYPE = np.dtype( [
+    ( 'path_offset', '<u8' ), ( 'path_length', '<u4' ), ( 'flags', '<u4' ),
+    ( 'first_box', '<u8' ), ( 'box_count', '<u8' ) ] )
+
+BOX_DTYPE = np.dtype( [
+    ( 'bbox', '<f8', ( 4, ) ), ( 'score', '<f8' ), ( 'class_index', '<i4' ),
+    ( 'mask_width', '<u4' ), ( 'mask_height', '<u4' ), ( 'reserved', '<u4' ),
+    ( 'mask_offset', '<u8' ) ] )
+
+CLASS_DTYPE = np.dtype( [
+    ( 'name_offset', '<u8' ), ( 'name_length', '<u4' ), ( 'reserved', '<u4' ) ] )
+
+def _padded( size ):
+    return ( size + 7 ) // 8 * 8
+
+class TrainingManifest( object ):
+    """
+    Memory-mapped view of a training manifest. The images, boxes and classes
+    attributes are numpy record arrays following the file layout.
+    """
+
+    def __init__( self, filename ):
+        self._data = np.memmap( filename, dtype=np.uint8, mode='r' )
+
+        if self._data.size < HEADER_DTYPE.itemsize:
+            raise ValueError( "Truncated training manifest: " + filename )
+
+        header = self._data[ :HEADER_DTYPE.itemsize ].view( HEADER_DTYPE )[0]
+
+        if header[ 'magic' ] != MANIFEST_MAGIC:
+            raise ValueError( "Not a training manifest: " + filename )
+        if header[ 'version' ] != MANIFEST_VERSION:
+            raise ValueError( "Unsupported training manifest version: " +
+                              str( header[ 'version' ] ) )
+
+        offset = HEADER_DTYPE.itemsize
+
+        def section( count, dtype ):
+            nonlocal offset
+            size = int( count ) * dtype.itemsize
+            if offset + size > self._data.size:
+                raise ValueError( "Truncated training manifest: " + filename )
+            output = self._data[ offset:offset + size ].view( dtype )
+            offset += _padded( size )
+            return output
+
+        self.images = section( header[ 'image_count' ], IMAGE_DTYPE )
+        self.boxes = section( header[ 'box_count' ], BOX_DTYPE )
+        self.classes = section( header[ 'class_count' ], CLASS_DTYPE )
+        self._strings = section( header[ 'string_size' ], np.dtype( np.uint8 ) )
+        self._masks = section( header[ 'mask_size' ], np.dtype( np.uint8 ) )
+
+    def __len__( self ):
+        return len( self.images )
+
+    def _string( self, offset, length ):
+        return bytes( self._strings[ offset:offset + length ] ).decode( 'utf-8' )
+
+    def class_names( self ):
+        return [ self._string( c[ 'name_offset' ], c[ 'name_length' ] )
+                 for c in self.classes ]
+
+    def image_path( self, index ):
+        image = self.images[ index ]
+        return self._string( image[ 'path_offset' ], image[ 'path_length' ] )
+
+    def is_validation( self, index ):
+        return bool( self.images[ index ][ 'flags' ] & VALIDATION_FLAG )
+
+    def image_boxes( self, index ):
+        """Records of the boxes of an image, without copying them"""
+        image = self.images[ index ]
+        first = int( image[ 'first_box' ] )
+        return self.boxes[ first:first + int( image[ 'box_count' ] ) ]
+
+    def box_mask( self, box ):
+        """Mask of a box relative to its top-left corner, or None without one"""
+        width, height = int( box[ 'mask_width' ] ), int( box[ 'mask_height' ] )
+        if width == 0 or height == 0:
+            return None
+        offset = int( box[ 'mask_offset' ] )
+        return self._masks[ offset:offset + width * height ].reshape( height, width )
+
+    def split_indices( self ):
+        """Indices of the training and of the validation images"""
+        validation = ( self.images[ 'flags' ] & VALIDATION_FLAG ) != 0
+        return np.nonzero( ~validation )[0], np.nonzero( validation )[0]
+
+def read_training_manifest( filename ):
+    return TrainingManifest( filename )
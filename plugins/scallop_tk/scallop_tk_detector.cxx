@@ -32,9 +32,16 @@
 
 #include <arrows/ocv/image_container.h>
 
+#include <plugins/core/thread_pool.h>
+
 #include <opencv2/core/core.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <future>
+#include <limits>
+#include <string>
+#include <vector>
 
 #include <ScallopTK/Pipelines/CoreDetector.h>
 
@@ -50,13 +57,154 @@ class scallop_tk_detector::priv
 {
 public:
 
-  priv() {}
+  priv()
+    : m_tile_width( 0 )
+    , m_tile_height( 0 )
+    , m_tile_overlap( 128 )
+    , m_num_threads( 0 )
+    , m_seam_iou( 0.3 )
+  {}
   ~priv() {}
 
   std::string m_config_file;
-  std::shared_ptr< CoreDetector > m_detector;
+  unsigned m_tile_width;
+  unsigned m_tile_height;
+  unsigned m_tile_overlap;
+  unsigned m_num_threads;
+  double m_seam_iou;
+
+  // One detector per worker in tiled mode, the first is used otherwise
+  std::vector< std::shared_ptr< CoreDetector > > m_detectors;
+  std::unique_ptr< thread_pool > m_pool;
+
+  // Ellipse detection in frame coordinates, with its box
+  struct ellipse_detection
+  {
+    kwiver::vital::bounding_box_d box;
+    std::vector< std::string > class_ids;
+    std::vector< double > class_probabilities;
+    unsigned tile;
+    double edge_distance;
+  };
+
+  // Run one detector over a region of the frame
+  void detect_region( CoreDetector& detector, const cv::Mat& frame,
+                      const cv::Rect& region, unsigned tile,
+                      std::vector< ellipse_detection >& output ) const;
+
+  // Remove duplicates of the same object found in overlapping tiles
+  void merge_seams( std::vector< ellipse_detection >& detections ) const;
 }; // end class scallop_tk_detector::priv
 
+
+// -------------------------------------------------------------------------------------------------
+void
+scallop_tk_detector::priv::
+detect_region( CoreDetector& detector, const cv::Mat& frame,
+               const cv::Rect& region, unsigned tile,
+               std::vector< ellipse_detection >& output ) const
+{
+  const bool whole_frame = ( region.width == frame.cols && region.height == frame.rows );
+
+  // Tiles are copied so the detector sees a continuous image
+  cv::Mat input = ( whole_frame ? frame : frame( region ).clone() );
+
+  auto det_list = detector.processFrame( input );
+
+  for( auto det : det_list )
+  {
+    // Axis-aligned extent of the rotated ellipse
+    const double angle = det.angle * PI / 180;
+    const double cos_a = cos( angle ), sin_a = sin( angle );
+    const double width = 2 * sqrt( det.major * det.major * cos_a * cos_a +
+                                   det.minor * det.minor * sin_a * sin_a );
+    const double height = 2 * sqrt( det.major * det.major * sin_a * sin_a +
+                                    det.minor * det.minor * cos_a * cos_a );
+
+    const double cx = det.c + region.x;
+    const double cy = det.r + region.y;
+
+    // Distance to the nearest edge shared with another tile
+    double edge_distance = std::numeric_limits< double >::max();
+
+    if( region.x > 0 )
+    {
+      edge_distance = std::min( edge_distance, cx - region.x );
+    }
+    if( region.y > 0 )
+    {
+      edge_distance = std::min( edge_distance, cy - region.y );
+    }
+    if( region.x + region.width < frame.cols )
+    {
+      edge_distance = std::min( edge_distance, region.x + region.width - cx );
+    }
+    if( region.y + region.height < frame.rows )
+    {
+      edge_distance = std::min( edge_distance, region.y + region.height - cy );
+    }
+
+    ellipse_detection output_det =
+    {
+      kwiver::vital::bounding_box_d(
+        kwiver::vital::bounding_box_d::vector_type( cx - width * 0.5, cy - height * 0.5 ),
+        width, height ),
+      det.classIDs,
+      det.classProbabilities,
+      tile,
+      edge_distance
+    };
+
+    output.push_back( output_det );
+  }
+}
+
+
+// -------------------------------------------------------------------------------------------------
+void
+scallop_tk_detector::priv::
+merge_seams( std::vector< ellipse_detection >& detections ) const
+{
+  // Detections further inside their tile are the more complete ones
+  std::stable_sort( detections.begin(), detections.end(),
+    []( const ellipse_detection& a, const ellipse_detection& b )
+    {
+      return a.edge_distance > b.edge_distance;
+    } );
+
+  std::vector< ellipse_detection > kept;
+
+  for( auto& det : detections )
+  {
+    bool duplicate = false;
+
+    for( const auto& other : kept )
+    {
+      if( other.tile == det.tile )
+      {
+        continue;
+      }
+
+      const auto overlap = kwiver::vital::intersection( det.box, other.box );
+      const double inter = ( overlap.is_valid() ? overlap.area() : 0.0 );
+      const double uni = det.box.area() + other.box.area() - inter;
+
+      if( inter > 0.0 && uni > 0.0 && inter / uni > m_seam_iou )
+      {
+        duplicate = true;
+        break;
+      }
+    }
+
+    if( !duplicate )
+    {
+      kept.push_back( std::move( det ) );
+    }
+  }
+
+  detections.swap( kept );
+}
+
 // =================================================================================================
 
 scallop_tk_detector::
@@ -80,6 +228,20 @@ get_configuration() const
 
   config->set_value( "config_file", d->m_config_file,
                      "Name of ScallopTK configuration file." );
+  config->set_value( "tile_width", d->m_tile_width,
+                     "Width of tiles frames are split into, processed in parallel. "
+                     "0 processes whole frames." );
+  config->set_value( "tile_height", d->m_tile_height,
+                     "Height of tiles frames are split into, 0 to use the tile width." );
+  config->set_value( "tile_overlap", d->m_tile_overlap,
+                     "Overlap in pixels between neighbouring tiles, which should "
+                     "exceed the largest expected object." );
+  config->set_value( "num_threads", d->m_num_threads,
+                     "Number of tiles processed in parallel, each with its own "
+                     "detector instance. 0 uses every core." );
+  config->set_value( "seam_iou", d->m_seam_iou,
+                     "Box overlap above which detections from different tiles are "
+                     "considered the same object." );
 
   return config;
 }
@@ -91,9 +253,32 @@ scallop_tk_detector::
 set_configuration( kwiver::vital::config_block_sptr config )
 {
   d->m_config_file = config->get_value< std::string >( "config_file" );
+  d->m_tile_width = config->get_value< unsigned >( "tile_width" );
+  d->m_tile_height = config->get_value< unsigned >( "tile_height" );
+  d->m_tile_overlap = config->get_value< unsigned >( "tile_overlap" );
+  d->m_num_threads = config->get_value< unsigned >( "num_threads" );
+  d->m_seam_iou = config->get_value< double >( "seam_iou" );
 
-  // Create new detector.
-  d->m_detector = std::make_shared< CoreDetector >( d->m_config_file );
+  if( d->m_tile_height == 0 )
+  {
+    d->m_tile_height = d->m_tile_width;
+  }
+
+  // Create new detectors, one per worker when tiling
+  d->m_detectors.clear();
+  d->m_pool.reset();
+
+  if( d->m_tile_width > 0 )
+  {
+    d->m_pool.reset( new thread_pool( d->m_num_threads ) );
+  }
+
+  const size_t detector_count = ( d->m_pool ? d->m_pool->size() : 1 );
+
+  for( size_t i = 0; i < detector_count; ++i )
+  {
+    d->m_detectors.push_back( std::make_shared< CoreDetector >( d->m_config_file ) );
+  }
 }
 
 
@@ -116,32 +301,89 @@ detect( kwiver::vital::image_container_sptr image_data ) const
   cv::Mat src = kwiver::arrows::ocv::image_container::vital_to_ocv( image_data->get_image(),
     kwiver::arrows::ocv::image_container::RGB_COLOR );
 
-  auto det_list = d->m_detector->processFrame( src );
+  std::vector< priv::ellipse_detection > det_list;
+
+  if( !d->m_pool || ( src.cols <= static_cast< int >( d->m_tile_width ) &&
+                      src.rows <= static_cast< int >( d->m_tile_height ) ) )
+  {
+    d->detect_region( *d->m_detectors[0], src, cv::Rect( 0, 0, src.cols, src.rows ), 0, det_list );
+  }
+  else
+  {
+    // Overlapping tiles, the last row and column aligned to the frame edge
+    const int tile_w = std::min< int >( d->m_tile_width, src.cols );
+    const int tile_h = std::min< int >( d->m_tile_height, src.rows );
+    const int step_x = std::max< int >( 1, tile_w - d->m_tile_overlap );
+    const int step_y = std::max< int >( 1, tile_h - d->m_tile_overlap );
+
+    std::vector< cv::Rect > tiles;
+
+    for( int y = 0; ; y += step_y )
+    {
+      const int ty = std::min( y, src.rows - tile_h );
+
+      for( int x = 0; ; x += step_x )
+      {
+        const int tx = std::min( x, src.cols - tile_w );
+        tiles.push_back( cv::Rect( tx, ty, tile_w, tile_h ) );
+
+        if( tx + tile_w >= src.cols )
+        {
+          break;
+        }
+      }
+
+      if( ty + tile_h >= src.rows )
+      {
+        break;
+      }
+    }
+
+    // Each worker owns a detector and takes every n-th tile
+    const size_t workers = std::min( d->m_detectors.size(), tiles.size() );
+
+    std::vector< std::vector< priv::ellipse_detection > > worker_dets( workers );
+    std::vector< std::future< void > > results;
+
+    for( size_t w = 0; w < workers; ++w )
+    {
+      results.push_back( d->m_pool->enqueue( [&, w]()
+      {
+        for( size_t t = w; t < tiles.size(); t += workers )
+        {
+          d->detect_region( *d->m_detectors[w], src, tiles[t], t, worker_dets[w] );
+        }
+      } ) );
+    }
+
+    for( auto& result : results )
+    {
+      result.wait();
+    }
+    for( auto& result : results )
+    {
+      result.get();
+    }
+
+    for( auto& dets : worker_dets )
+    {
+      det_list.insert( det_list.end(), dets.begin(), dets.end() );
+    }
+
+    d->merge_seams( det_list );
+  }
 
   LOG_DEBUG( logger(), "Detected " << det_list.size() << " objects." );
 
   // process results
-  for( auto det : det_list )
+  for( const auto& det : det_list )
   {
-    // Get parameters from ellipse output
-    double angle = det.angle * PI / 180;
-    double a = det.major * cos( angle );
-    double b = det.minor * sin( angle );
-    double c = det.major * sin( angle );
-    double d = det.minor * cos( angle );
-    double width = sqrt( ( a * a ) + ( b * b ) ) * 2;
-    double height = sqrt( ( c * c ) + ( d * d ) ) * 2;
-    double x = det.c - width * 0.5;
-    double y = det.r - height * 0.5;
-
-    // Create kwiver style bounding box
-    kwiver::vital::bounding_box_d bbox( kwiver::vital::bounding_box_d::vector_type( x, y ), width, height );
-
     // Create possible object types.
-    auto dot = std::make_shared< kwiver::vital::detected_object_type >( det.classIDs, det.classProbabilities );
+    auto dot = std::make_shared< kwiver::vital::detected_object_type >(
+      det.class_ids, det.class_probabilities );
 
     // Create detection
-    detected_set->add( std::make_shared< kwiver::vital::detected_object >( bbox, 1.0, dot ) );
+    detected_set->add( std::make_shared< kwiver::vital::detected_object >( det.box, 1.0, dot ) );
   } // end for
 
   return detected_set;
@@ -29,6 +29,8 @@
 from __future__ import print_function
 
 import json
+import pickle
+import struct
 
 from six.moves import zip
 
@@ -50,6 +52,10 @@ class SmqtkIngestDescriptors (KwiverProcess):
       paired UID.
     - overwrites SMQTK descriptor index (set) elements for a given UID.
 
+  When a spool file is given, elements are instead appended to it as
+  (uid, element) rows in the PostgreSQL binary COPY format, to be loaded in
+  bulk afterwards by database_tool.py ingest.
+
   """
 
   def __init__(self, conf):
@@ -71,6 +77,12 @@ class SmqtkIngestDescriptors (KwiverProcess):
         'Maximum number of descriptors to buffer over to make larger batch sizes'
     )
     self.declare_config_using_trait('max_descriptor_buffer')
+    self.add_config_trait(
+        'spool_file', 'spool_file', '',
+        'Optional file to spool descriptor index rows to in the PostgreSQL binary '
+        'COPY format, instead of adding them to the descriptor index directly'
+    )
+    self.declare_config_using_trait('spool_file')
 
     # set up required flags
     optional = process.PortFlags()
@@ -84,7 +96,10 @@ class SmqtkIngestDescriptors (KwiverProcess):
     self.declare_output_port_using_trait('string_vector', optional)
 
   def __del__(self):
-    if len(self.descriptor_buffer) > 0:
+    if self.spool is not None:
+      self.spool.write(struct.pack('!h', -1))
+      self.spool.close()
+    elif len(self.descriptor_buffer) > 0:
       self.smqtk_descriptor_index.add_many_descriptors(
         self.descriptor_buffer
       )
@@ -97,6 +112,7 @@ class SmqtkIngestDescriptors (KwiverProcess):
 
     self.frame_counter = 0
     self.descriptor_buffer = []
+    self.spool = None
 
     # parse json file
     with open(self.config_file) as data_file:
@@ -108,14 +124,32 @@ class SmqtkIngestDescriptors (KwiverProcess):
             self.json_config['descriptor_factory']
         )
 
-    #: :type: smqtk.representation.DescriptorIndex
-    self.smqtk_descriptor_index = smqtk.utils.plugin.from_plugin_config(
-        self.json_config['descriptor_index'],
-        smqtk.representation.get_descriptor_index_impls()
-    )
+    spool_file = self.config_value('spool_file')
+
+    if spool_file:
+      # Elements are pickled as the Postgres descriptor index stores them
+      index_type = self.json_config['descriptor_index']['type']
+      self.pickle_protocol = self.json_config['descriptor_index'] \
+        .get(index_type, {}).get('pickle_protocol', -1)
+
+      # Signature, flags and header extension length of the COPY format
+      self.spool = open(spool_file, 'wb')
+      self.spool.write(b'PGCOPY\n\xff\r\n\x00' + struct.pack('!ii', 0, 0))
+    else:
+      #: :type: smqtk.representation.DescriptorIndex
+      self.smqtk_descriptor_index = smqtk.utils.plugin.from_plugin_config(
+          self.json_config['descriptor_index'],
+          smqtk.representation.get_descriptor_index_impls()
+      )
 
     self._base_configure()
 
+  def _spool_descriptor(self, uid_str, smqtk_descr):
+    uid = uid_str.encode('utf-8')
+    element = pickle.dumps(smqtk_descr, self.pickle_protocol)
+    self.spool.write(struct.pack('!hi', 2, len(uid)) + uid +
+                     struct.pack('!i', len(element)) + element)
+
   def _step(self):
     #
     # Grab input values from ports using traits.
@@ -146,11 +180,15 @@ class SmqtkIngestDescriptors (KwiverProcess):
         # for the given UID. We currently always overwrite.
         smqtk_descr.set_vector(vital_descr.todoublearray())
         # Queue up element for adding to set.
-        self.descriptor_buffer.append(smqtk_descr)
+        if self.spool is not None:
+          self._spool_descriptor(uid_str, smqtk_descr)
+        else:
+          self.descriptor_buffer.append(smqtk_descr)
 
     # Determine if we need to write out a new batch
-    if len(self.descriptor_buffer) >= self.max_descriptor_buffer or \
-         self.frame_counter >= self.max_frame_buffer:
+    if self.spool is None and \
+       ( len(self.descriptor_buffer) >= self.max_descriptor_buffer or
+         self.frame_counter >= self.max_frame_buffer ):
 
       # Ingest descriptors in batch
       self.smqtk_descriptor_index.add_many_descriptors(
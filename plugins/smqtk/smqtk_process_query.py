@@ -185,6 +185,20 @@ class SmqtkProcessQuery (KwiverProcess):
         )
         self.declare_config_using_trait('neighbor_index_config_file')
 
+        self.add_config_trait(
+            'viame_index_path', 'viame_index_path', '',
+            'Optional descriptor index written by the index_descriptors '
+            'process, without extension. When set it is searched in place of '
+            'the neighbor index configured above.'
+        )
+        self.declare_config_using_trait('viame_index_path')
+
+        self.add_config_trait(
+            'viame_index_probes', 'viame_index_probes', '8',
+            'Number of lists of the descriptor index searched per query.'
+        )
+        self.declare_config_using_trait('viame_index_probes')
+
         self.add_config_trait(
             'pos_seed_neighbors', 'pos_seed_neighbors', '500',
             'Number of near neighbors to pull from the neighbor index for each'
@@ -255,10 +269,19 @@ class SmqtkProcessQuery (KwiverProcess):
             self.di_json_config,
             smqtk.representation.get_descriptor_index_impls()
         )
-        self.neighbor_index = smqtk.utils.plugin.from_plugin_config(
-            self.nn_json_config,
-            smqtk.algorithms.get_nn_index_impls()
-        )
+        viame_index_path = self.config_value('viame_index_path')
+
+        if viame_index_path:
+            from viame.arrows.smqtk.viame_neighbor_index import ViameNeighborIndex
+            self.neighbor_index = ViameNeighborIndex(
+                viame_index_path, self.descriptor_set,
+                int(self.config_value('viame_index_probes'))
+            )
+        else:
+            self.neighbor_index = smqtk.utils.plugin.from_plugin_config(
+                self.nn_json_config,
+                smqtk.algorithms.get_nn_index_impls()
+            )
 
         # Using default relevancy index configuration, which as of 2017/08/24
         # is the only one: libSVM-based relevancy ranking.
@@ -64,6 +64,8 @@ def generate_svm_model( positive_uid_files, negative_uid_files,
     smqtk_params['maximum_negative_count'] = 750
   if not 'train_on_neighbors_only' in smqtk_params:
     smqtk_params['train_on_neighbors_only'] = False
+  if not 'viame_index_path' in smqtk_params:
+    smqtk_params['viame_index_path'] = ''
 
   # Load indices
   print( " - Loading descriptor indices" )
@@ -100,17 +102,26 @@ def generate_svm_model( positive_uid_files, negative_uid_files,
     print( "Error: Not enough training samples" )
     return
 
-  # Set of descriptors to pull positive/negative querys from.
-  descriptor_set = smqtk.utils.plugin.from_plugin_config(
-    di_json_config,
-    smqtk.representation.get_descriptor_index_impls()
-  )
-
-  # Nearest Neighbors index to use for IQR working index population.
-  neighbor_index = smqtk.utils.plugin.from_plugin_config(
-    nn_json_config,
-    smqtk.algorithms.get_nn_index_impls()
-  )
+  if smqtk_params['viame_index_path']:
+    # Descriptors written by the index_descriptors process, decoded from
+    # their stored precision as they are read
+    from viame.arrows.smqtk.viame_neighbor_index import ViameDescriptorSet
+    from viame.arrows.smqtk.viame_neighbor_index import ViameNeighborIndex
+
+    descriptor_set = ViameDescriptorSet( smqtk_params['viame_index_path'] )
+    neighbor_index = ViameNeighborIndex( descriptor_set.index, descriptor_set )
+  else:
+    # Set of descriptors to pull positive/negative querys from.
+    descriptor_set = smqtk.utils.plugin.from_plugin_config(
+      di_json_config,
+      smqtk.representation.get_descriptor_index_impls()
+    )
+
+    # Nearest Neighbors index to use for IQR working index population.
+    neighbor_index = smqtk.utils.plugin.from_plugin_config(
+      nn_json_config,
+      smqtk.algorithms.get_nn_index_impls()
+    )
 
   # Max count threshold
   max_pos_samples = int( smqtk_params['maximum_positive_count'] )
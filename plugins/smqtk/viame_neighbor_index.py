@@ -0,0 +1,107 @@
+# ckwg +29
+# Copyright 2026 by Kitware, Inc.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+#    * Redistributions of source code must retain the above copyright notice,
+#    this list of conditions and the following disclaimer.
+#
+#    * Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+#    * Neither name of Kitware, Inc. nor the names of any contributors may be used
+#    to endorse or promote products derived from this software without specific
+#    prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+Descriptor and nearest neighbour lookups backed by an index written by the
+index_descriptors process, in place of SMQTK DescriptorIndex and
+NearestNeighborsIndex implementations. Stored vectors are decoded to floats
+as they are read, whatever precision they are stored at.
+"""
+
+from __future__ import print_function
+
+import numpy
+
+from smqtk.representation.descriptor_element.local_elements \
+  import DescriptorMemoryElement
+
+from viame.arrows.core.descriptor_index import DescriptorIndex
+
+
+class ViameDescriptorSet( object ):
+    """
+    Read only replacement for the SMQTK descriptor sets used by IQR sessions
+    and SVM training, building in-memory elements from stored vectors.
+    """
+
+    def __init__( self, index, type_str="viame" ):
+        if not isinstance( index, DescriptorIndex ):
+            index = DescriptorIndex( index )
+        self.index = index
+        self.type_str = type_str
+
+    def count( self ):
+        return len( self.index )
+
+    def __len__( self ):
+        return len( self.index )
+
+    def get_descriptor( self, uuid ):
+        return self.get_many_descriptors( [ uuid ] )[ 0 ]
+
+    def get_many_descriptors( self, uuids ):
+        uuids = list( uuids )
+        vectors = self.index.vectors( uuids )
+
+        descriptors = []
+        for uuid, vector in zip( uuids, vectors ):
+            element = DescriptorMemoryElement( self.type_str, uuid )
+            element.set_vector( vector.astype( numpy.float64 ) )
+            descriptors.append( element )
+        return descriptors
+
+
+class ViameNeighborIndex( object ):
+    """
+    Minimal NearestNeighborsIndex replacement used to populate IQR working
+    indices, returning elements of the given SMQTK descriptor set, or of the
+    index itself when none is given.
+    """
+
+    def __init__( self, index, descriptor_set=None, num_probes=8 ):
+        if not isinstance( index, DescriptorIndex ):
+            index = DescriptorIndex( index )
+        self.index = index
+        if descriptor_set is None:
+            descriptor_set = ViameDescriptorSet( self.index )
+        self.descriptor_set = descriptor_set
+        self.num_probes = num_probes
+
+    def count( self ):
+        return len( self.index )
+
+    def __len__( self ):
+        return len( self.index )
+
+    def nn( self, d, n=1 ):
+        query = numpy.asarray( d.vector(), dtype=numpy.float64 ).ravel()
+        uids, distances = self.index.search( query, n, self.num_probes )
+
+        descriptors = self.descriptor_set.get_many_descriptors( uids )
+        return tuple( descriptors ), tuple( distances )
@@ -89,4 +89,25 @@ kwiver::vital::detected_object_set_sptr
   return detected_set;
 }
 
+
+// -------------------------------------------------------------------------------------------------
+std::vector< kwiver::vital::detected_object_set_sptr >
+@template@_detector
+::detect_batch( std::vector< kwiver::vital::image_container_sptr > const& images ) const
+{
+  std::vector< kwiver::vital::detected_object_set_sptr > detected_sets;
+
+  //++ insert batched detector code here, running the model once over all
+  //++ images so that transfers and kernel launches are shared by the batch.
+  //++ Exactly one set must be returned per image, in the same order.
+  for( size_t i = 0; i < images.size(); ++i )
+  {
+    detected_sets.push_back( std::make_shared< kwiver::vital::detected_object_set >() );
+  }
+
+  LOG_INFO( logger(), "Text: " << d->m_text << " (batch of " << images.size() << ")" );
+
+  return detected_sets;
+}
+
 } // end namespace
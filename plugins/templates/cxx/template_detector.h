@@ -8,12 +8,14 @@
 #include <plugins/@template_dir@/viame_@template_lib@_export.h>
 
 #include <vital/algo/image_object_detector.h>
+#include <plugins/core/batch_image_object_detector.h>
 
 namespace viame {
 
 class VIAME_@TEMPLATE_LIB@_EXPORT @template@_detector :
   public kwiver::vital::algorithm_impl<
-    @template@_detector, kwiver::vital::algo::image_object_detector >
+    @template@_detector, kwiver::vital::algo::image_object_detector >,
+  public viame::batch_image_object_detector
 {
 public:
   @template@_detector();
@@ -30,6 +32,10 @@ public:
   virtual kwiver::vital::detected_object_set_sptr detect(
     kwiver::vital::image_container_sptr image_data ) const;
 
+  // Batched detection method, called by the batch_detector process
+  virtual std::vector< kwiver::vital::detected_object_set_sptr > detect_batch(
+    std::vector< kwiver::vital::image_container_sptr > const& images ) const;
+
 private:
   class priv;
   const std::unique_ptr< priv > d;
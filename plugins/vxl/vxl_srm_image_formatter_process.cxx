@@ -43,6 +43,13 @@
 
 #include <arrows/vxl/image_container.h>
 
+#include <plugins/core/thread_pool.h>
+
+#include <sprokit/pipeline/process_exception.h>
+
+#include <functional>
+#include <future>
+#include <memory>
 #include <vector>
 
 #include <vil/vil_image_view.h>
@@ -81,6 +88,9 @@ create_config_trait( flux_factor, double, "0.05",
 create_config_trait( max_images_per_index, unsigned, "-1",
   "Maximum number of images that can be stored together in the same "
   "database index." );
+create_config_trait( chip_threads, unsigned, "1",
+  "Number of threads used to format chips in chip mode, 0 uses all available "
+  "cores. Chips are output in order as soon as each one is ready." );
 
 
 //------------------------------------------------------------------------------
@@ -103,6 +113,7 @@ public:
   bool m_pad_sides;
   double m_flux_factor;
   unsigned m_max_images_per_index;
+  unsigned m_chip_threads;
 
   // Computed parameters
   unsigned m_max_input_width;
@@ -111,12 +122,46 @@ public:
   unsigned m_first_output_width;
   unsigned m_first_output_height;
 
+  // Workers formatting chips, only used with multiple chip threads
+  std::unique_ptr< viame::thread_pool > m_workers;
+
   // Functions
   template< typename PixType >
   void filter( const vil_image_view< PixType >& input,
-    std::vector< vil_image_view< PixType > >& output );
+    const std::function< void( const vil_image_view< PixType >& ) >& output );
+
+  template< typename PixType >
+  void chip( const vil_image_view< PixType >& input,
+    const std::function< void( const vil_image_view< PixType >& ) >& output );
+
+  template< typename PixType >
+  vil_image_view< PixType > format_chip( const vil_image_view< PixType >& input,
+    unsigned i0, unsigned j0, unsigned ni, unsigned nj,
+    unsigned output_ni, unsigned output_nj ) const;
 };
 
+// Chip origins along one dimension, the last chip is aligned to the border
+static std::vector< unsigned >
+chip_origins( unsigned size, unsigned chip_size, unsigned overlap )
+{
+  std::vector< unsigned > origins;
+
+  const unsigned step = ( chip_size > overlap ? chip_size - overlap : 1 );
+
+  for( unsigned origin = 0; ; origin += step )
+  {
+    if( origin + chip_size >= size )
+    {
+      origins.push_back( size - chip_size );
+      break;
+    }
+
+    origins.push_back( origin );
+  }
+
+  return origins;
+}
+
 // =============================================================================
 
 vxl_srm_image_formatter_process
@@ -154,6 +199,8 @@ vxl_srm_image_formatter_process
     config_value_using_trait( flux_factor );
   d->m_max_images_per_index =
     config_value_using_trait( max_images_per_index );
+  d->m_chip_threads =
+    config_value_using_trait( chip_threads );
 
   std::string mode = config_value_using_trait( resize_option );
 
@@ -173,6 +220,20 @@ vxl_srm_image_formatter_process
   {
     throw std::runtime_error( "Invalid resize option: " + mode );
   }
+
+  if( d->m_resize_option == priv::CHIP &&
+      ( d->m_max_output_width == 0 || d->m_max_output_height == 0 ) )
+  {
+    VITAL_THROW( sprokit::invalid_configuration_exception, name(),
+                 "Chip mode requires a non-zero maximum output size" );
+  }
+
+  d->m_workers.reset();
+
+  if( d->m_resize_option == priv::CHIP && d->m_chip_threads != 1 )
+  {
+    d->m_workers.reset( new viame::thread_pool( d->m_chip_threads ) );
+  }
 }
 
 
@@ -180,14 +241,14 @@ vxl_srm_image_formatter_process
 template< typename PixType >
 void vxl_srm_image_formatter_process::priv
 ::filter( const vil_image_view< PixType >& raw_input,
-          std::vector< vil_image_view< PixType > >& output )
+          const std::function< void( const vil_image_view< PixType >& ) >& output )
 {
   typedef vil_image_view< PixType > image_t;
 
   // Verification of input
   if( raw_input.ni() == 0 || raw_input.nj() == 0 )
   {
-    output.push_back( image_t() );
+    output( image_t() );
     return;
   }
 
@@ -246,14 +307,14 @@ void vxl_srm_image_formatter_process::priv
 
     if( input.ni() == output_ni && input.nj() == output_nj )
     {
-      output.push_back( input );
+      output( input );
       return;
     }
 
     vil_image_view< PixType > scaled;
     vil_resample_bilin( input, scaled, output_ni, output_nj );
 
-    output.push_back( scaled );
+    output( scaled );
   }
   else if( m_resize_option == CROP )
   {
@@ -279,7 +340,7 @@ void vxl_srm_image_formatter_process::priv
 
     if( input.ni() == output_ni && input.nj() == output_nj )
     {
-      output.push_back( input );
+      output( input );
       return;
     }
 
@@ -295,20 +356,143 @@ void vxl_srm_image_formatter_process::priv
         vil_crop( padded_crop, 0, copy_ni, 0, copy_nj );
 
       vil_copy_reformat( vil_crop( input, 0, copy_ni, 0, copy_nj ), dest );
-      output.push_back( padded_crop );
+      output( padded_crop );
     }
     else
     {
-      output.push_back( vil_crop( input, 0, output_ni, 0, output_nj ) );
+      output( vil_crop( input, 0, output_ni, 0, output_nj ) );
     }
   }
   else // Chip mode
   {
-    // NOT YET IMPLEMENTATED
+    chip( input, output );
   }
 }
 
 
+// -----------------------------------------------------------------------------
+template< typename PixType >
+void vxl_srm_image_formatter_process::priv
+::chip( const vil_image_view< PixType >& input,
+        const std::function< void( const vil_image_view< PixType >& ) >& output )
+{
+  typedef vil_image_view< PixType > image_t;
+
+  const unsigned chip_ni = std::min( m_max_output_width, input.ni() );
+  const unsigned chip_nj = std::min( m_max_output_height, input.nj() );
+
+  unsigned output_ni = ( m_pad_sides ? m_max_output_width : chip_ni );
+  unsigned output_nj = ( m_pad_sides ? m_max_output_height : chip_nj );
+
+  if( m_fix_output_size )
+  {
+    if( m_first_output_width )
+    {
+      output_ni = m_first_output_width;
+      output_nj = m_first_output_height;
+    }
+    else
+    {
+      m_first_output_width = output_ni;
+      m_first_output_height = output_nj;
+    }
+  }
+
+  const std::vector< unsigned > origins_i =
+    chip_origins( input.ni(), chip_ni, m_chip_overlap );
+  const std::vector< unsigned > origins_j =
+    chip_origins( input.nj(), chip_nj, m_chip_overlap );
+
+  if( !m_workers )
+  {
+    for( unsigned j0 : origins_j )
+    {
+      for( unsigned i0 : origins_i )
+      {
+        output( format_chip( input, i0, j0, chip_ni, chip_nj,
+                             output_ni, output_nj ) );
+      }
+    }
+    return;
+  }
+
+  // Chips are views of the input cropped and copied on the workers, each one
+  // is output as soon as it and all the previous ones are done
+  std::vector< std::future< image_t > > chips;
+
+  for( unsigned j0 : origins_j )
+  {
+    for( unsigned i0 : origins_i )
+    {
+      chips.push_back( m_workers->enqueue(
+        [&, i0, j0]()
+        {
+          return format_chip( input, i0, j0, chip_ni, chip_nj,
+                              output_ni, output_nj );
+        } ) );
+    }
+  }
+
+  try
+  {
+    for( auto& result : chips )
+    {
+      output( result.get() );
+    }
+  }
+  catch( ... )
+  {
+    // The remaining tasks reference the input, let them finish first
+    for( auto& result : chips )
+    {
+      if( result.valid() )
+      {
+        result.wait();
+      }
+    }
+    throw;
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+template< typename PixType >
+vil_image_view< PixType > vxl_srm_image_formatter_process::priv
+::format_chip( const vil_image_view< PixType >& input,
+               unsigned i0, unsigned j0, unsigned ni, unsigned nj,
+               unsigned output_ni, unsigned output_nj ) const
+{
+  typedef vil_image_view< PixType > image_t;
+
+  const image_t view = vil_crop( input, i0, ni, j0, nj );
+
+  // Chips are copied so that they do not keep the whole input alive
+  image_t result;
+
+  if( ni == output_ni && nj == output_nj )
+  {
+    result.deep_copy( view );
+  }
+  else if( m_pad_sides )
+  {
+    result = image_t( output_ni, output_nj, input.nplanes() );
+    vil_fill( result, static_cast< PixType >( 0 ) );
+
+    const unsigned copy_ni = std::min( output_ni, ni );
+    const unsigned copy_nj = std::min( output_nj, nj );
+
+    image_t dest = vil_crop( result, 0, copy_ni, 0, copy_nj );
+    vil_copy_reformat( vil_crop( view, 0, copy_ni, 0, copy_nj ), dest );
+  }
+  else
+  {
+    vil_resample_bilin( view, result, output_ni, output_nj );
+  }
+
+  return result;
+}
+
+
 // -----------------------------------------------------------------------------
 void
 vxl_srm_image_formatter_process
@@ -328,23 +512,21 @@ vxl_srm_image_formatter_process
       typedef vil_pixel_format_type_of<T >::component_type pix_t;         \
       vil_image_view< pix_t > input = view;                               \
                                                                           \
-      std::vector< vil_image_view< pix_t > > outputs;                     \
-      d->filter( input, outputs );                                        \
-                                                                          \
-      for( auto output : outputs )                                        \
-      {                                                                   \
-        if( output )                                                      \
-        {                                                                 \
-          push_to_port_using_trait( image,                                \
-            std::make_shared< kwiver::arrows::vxl::image_container >(     \
-              output ) );                                                 \
-        }                                                                 \
-        else                                                              \
+      d->filter< pix_t >( input,                                          \
+        [this]( const vil_image_view< pix_t >& output )                   \
         {                                                                 \
-          push_to_port_using_trait( image,                                \
-            kwiver::vital::image_container_sptr() );                      \
-        }                                                                 \
-      }                                                                   \
+          if( output )                                                    \
+          {                                                               \
+            push_to_port_using_trait( image,                              \
+              std::make_shared< kwiver::arrows::vxl::image_container >(   \
+                output ) );                                               \
+          }                                                               \
+          else                                                            \
+          {                                                               \
+            push_to_port_using_trait( image,                              \
+              kwiver::vital::image_container_sptr() );                    \
+          }                                                               \
+        } );                                                              \
     }                                                                     \
     break;                                                                \
 
@@ -394,13 +576,15 @@ vxl_srm_image_formatter_process
   declare_config_using_trait( pad_sides );
   declare_config_using_trait( flux_factor );
   declare_config_using_trait( max_images_per_index );
+  declare_config_using_trait( chip_threads );
 }
 
 
 // =============================================================================
 vxl_srm_image_formatter_process::priv
 ::priv()
-  : m_max_input_width( 0 )
+  : m_chip_threads( 1 )
+  , m_max_input_width( 0 )
   , m_max_input_height( 0 )
   , m_first_output_width( 0 )
   , m_first_output_height( 0 )
@@ -3,8 +3,10 @@
 import sys
 import os
 import os.path
+import json
 import shutil
 import subprocess
+import tempfile
 import threading
 
 database_dir = "database"
@@ -14,6 +16,10 @@ status_log_file = ""
 sql_dir = os.path.join(database_dir, "SQL")
 sql_init_file = os.path.join(pipelines_dir, "sql_init_table.sql")
 sql_log_file = os.path.join(database_dir, "SQL_Log_File")
+sql_spool_dir = os.path.join(database_dir, "Spool")
+sql_spool_ext = ".pgcopy"
+sql_bulk_prepare_file = os.path.join(pipelines_dir, "sql_bulk_prepare.sql")
+sql_bulk_finalize_file = os.path.join(pipelines_dir, "sql_bulk_finalize.sql")
 
 smqtk_itq_train_config = os.path.join(pipelines_dir, "smqtk_train_itq.json")
 smqtk_hcode_config = os.path.join(pipelines_dir, "smqtk_compute_hashes.json")
@@ -208,6 +214,68 @@ def stop( quiet=False ):
     pass
   status_log_file = original_log_file
 
+def spool_file( basename, table ):
+  """Spool file for rows of the given table, loaded later by bulk_ingest"""
+  if not os.path.exists( sql_spool_dir ):
+    os.makedirs( sql_spool_dir )
+  return os.path.join( sql_spool_dir, basename + "." + table + sql_spool_ext )
+
+def bulk_ingest( streams=4, log_file="" ):
+  """Load all spooled rows with binary COPY, several files at once, with
+  the table indexes dropped during the load and built once afterwards"""
+  global status_log_file
+  status_log_file = log_file
+
+  if not os.path.exists( sql_spool_dir ):
+    return True
+  files = [ os.path.join( sql_spool_dir, f ) for f in sorted( os.listdir( sql_spool_dir ) )
+            if f.endswith( sql_spool_ext ) ]
+  if len( files ) == 0:
+    return True
+
+  # Largest files first, so that the last streams end together
+  files.sort( key=os.path.getsize, reverse=True )
+  failures = []
+
+  def copy_files():
+    while True:
+      try:
+        filename = files.pop( 0 )
+      except IndexError:
+        return
+      table = os.path.splitext( os.path.splitext( filename )[0] )[1][1:]
+      path = os.path.abspath( filename ).replace( "'", "''" )
+      try:
+        execute_cmd( "psql", [ "-v", "ON_ERROR_STOP=1", "-c",
+          "\\copy " + table + " FROM '" + path + "' WITH (FORMAT binary)", "postgres" ] )
+        remove_file( filename )
+      except subprocess.CalledProcessError:
+        failures.append( filename )
+
+  try:
+    log_info( "  (1/3) Dropping indices... " )
+    execute_cmd( "psql", [ "-f", find_config( sql_bulk_prepare_file ), "postgres" ] )
+    log_info( "Success" + lb1 + "  (2/3) Copying " + str( len( files ) ) + " files... " )
+    threads = [ threading.Thread( target=copy_files ) for _ in range( max( streams, 1 ) ) ]
+    for thread in threads:
+      thread.start()
+    for thread in threads:
+      thread.join()
+    if len( failures ) > 0:
+      log_info( "Failure" + lb1 + "  Unable to load: " + ", ".join( failures ) + lb1 )
+    else:
+      log_info( "Success" + lb1 )
+    log_info( "  (3/3) Building indices... " )
+    execute_cmd( "psql", [ "-v", "ON_ERROR_STOP=1", "-f",
+      find_config( sql_bulk_finalize_file ), "postgres" ] )
+    log_info( "Success" + lb1 )
+    return len( failures ) == 0
+  except:
+    log_info( "Failure" + lb1 )
+    if len( log_file ) > 0:
+      log_info( "  Check log: " + log_file + lb2 )
+    return False
+
 def build_balltree_index( install_dir="", log_file="" ):
   if not build_standard_index( install_dir, log_file ):
     return False
@@ -224,17 +292,76 @@ def build_balltree_index( install_dir="", log_file="" ):
       log_info( "Failure" + lb1 + "  Check log: " + log_file + lb2 )
     return False
 
-def build_standard_index( install_dir="", log_file="" ):
+def is_initialized():
+  return os.path.exists( sql_dir )
+
+def itq_model_file():
+  """Rotation matrix written by ITQ training, read by hash code computation"""
+  with open( find_config( smqtk_hcode_config ) ) as f:
+    config = json.load( f )
+  functor = config[ "plugins" ][ "lsh_functor" ][ "ItqFunctor" ]
+  return functor[ "rotation_cache" ][ "DataFileElement" ][ "filepath" ]
+
+def run_video_sql( video_names, statements ):
+  """Run statements with the given video names loaded in table videos"""
+  fd, sql_file = tempfile.mkstemp( suffix=".sql" )
+  try:
+    with os.fdopen( fd, "w" ) as f:
+      f.write( "CREATE TEMP TABLE videos ( video_name TEXT );" + lb1 )
+      for name in video_names:
+        f.write( "INSERT INTO videos VALUES ( '" + name.replace( "'", "''" ) + "' );" + lb1 )
+      f.write( lb1.join( statements ) + lb1 )
+    execute_cmd( "psql", [ "-v", "ON_ERROR_STOP=1", "-f", sql_file, "postgres" ] )
+  finally:
+    remove_file( sql_file )
+
+def remove_videos( video_names, log_file="" ):
+  """Delete all rows of the given videos, before they are processed again"""
+  global status_log_file
+  status_log_file = log_file
+
+  uids = "SELECT uid FROM track_descriptor WHERE video_name IN ( SELECT video_name FROM videos )"
+  try:
+    log_info( "Removing " + str( len( video_names ) ) + " changed videos from database... " )
+    run_video_sql( video_names, [ "BEGIN;",
+      "DELETE FROM track_descriptor_history WHERE uid IN ( " + uids + " );",
+      "DELETE FROM track_descriptor_track WHERE uid IN ( " + uids + " );",
+      "DELETE FROM descriptor_index WHERE uid IN ( " + uids + " );",
+      "DELETE FROM track_descriptor WHERE video_name IN ( SELECT video_name FROM videos );",
+      "DELETE FROM object_track WHERE video_name IN ( SELECT video_name FROM videos );",
+      "COMMIT;" ] )
+    log_info( "Success" + lb1 )
+    return True
+  except:
+    log_info( "Failure" + lb1 )
+    return False
+
+def build_standard_index( install_dir="", log_file="", video_names=None ):
+  """Train the ITQ model and hash all descriptors, or when video names are
+  given and a model exists, only hash the descriptors of these videos into
+  the existing hash codes"""
   try:
     global status_log_file
     status_log_file = log_file
-    log_info( "  (1/2) Training ITQ Model... " )
-    execute_pycmd( install_dir, "train_itq",
-      [ "-vc", find_config( smqtk_itq_train_config ) ] )
+    uid_file = ""
+    if video_names is not None and os.path.exists( itq_model_file() ):
+      fd, uid_file = tempfile.mkstemp( suffix=".txt" )
+      os.close( fd )
+      log_info( "  (1/2) Listing New Descriptors... " )
+      run_video_sql( video_names, [ "\\copy ( SELECT uid FROM track_descriptor "
+        "WHERE video_name IN ( SELECT video_name FROM videos ) ) TO '" +
+        os.path.abspath( uid_file ).replace( "'", "''" ) + "'" ] )
+    else:
+      log_info( "  (1/2) Training ITQ Model... " )
+      execute_pycmd( install_dir, "train_itq",
+        [ "-vc", find_config( smqtk_itq_train_config ) ] )
     log_info( "Success" + lb1 + "  (2/2) Computing Hash Codes... " )
-    execute_pycmd( install_dir, "compute_hash_codes",
-      [ "-vc", find_config( smqtk_hcode_config ) ] )
+    hash_args = [ "-vc", find_config( smqtk_hcode_config ) ]
+    if uid_file:
+      hash_args += [ "--uuids-list", uid_file ]
+    execute_pycmd( install_dir, "compute_hash_codes", hash_args )
     log_info( "Success" + lb1 )
+    remove_file( uid_file )
     return True
   except:
     if len( log_file ) > 0:
@@ -242,13 +369,13 @@ def build_standard_index( install_dir="", log_file="" ):
     return False
 
 def output_usage():
-  print( "Usage: database_tool.py [initialize | status | start | stop | index]" )
+  print( "Usage: database_tool.py [initialize | status | start | stop | index | ingest [streams]]" )
   sys.exit( 0 )
   
 # Main Function
 if __name__ == "__main__" :
 
-  if len( sys.argv ) != 2:
+  if len( sys.argv ) != 2 and not ( len( sys.argv ) == 3 and sys.argv[1] == "ingest" ):
     output_usage()
 
   if sys.argv[1] == "init" or sys.argv[1] == "initialize":
@@ -263,5 +390,7 @@ if __name__ == "__main__" :
     build_standard_index()
   elif sys.argv[1] == "build_balltree":
     build_balltree_index()
+  elif sys.argv[1] == "ingest":
+    bulk_ingest( int( sys.argv[2] ) if len( sys.argv ) == 3 else 4 )
   else:
     output_usage()
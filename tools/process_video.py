@@ -8,10 +8,13 @@ import numpy as np
 import argparse
 import contextlib
 import itertools
+import json
 import signal
+import socket
 import subprocess
 import tempfile
 import threading
+import time
 
 try:
   import queue # Python 3
@@ -45,6 +48,13 @@ default_pipeline = pipeline_dir + div + "index_default" + default_pipe_ext
 no_pipeline = "none"
 auto_pipeline = "auto"
 
+# Assumed encoded frame size for videos with no readable frame count
+default_bytes_per_frame = 50000
+
+# Inputs completed by earlier runs, kept in the output directory
+summary_state_file = "summary_state.json"
+summary_state_version = 1
+
 # Global flag to see if any video has successfully completed processing
 any_video_complete = False
 
@@ -195,6 +205,79 @@ def execute_command( cmd, stdout=None, stderr=None, gpu=None ):
     env[ CUDA_VISIBLE_DEVICES ] = get_real_gpu_index( gpu )
   return subprocess.call( cmd, stdout=stdout, stderr=stderr, env=env )
 
+def get_server_cmd():
+  return [ 'viame_pipeline_server' ]
+
+class pipeline_worker( object ):
+  """Warm pipeline process kept for all the jobs of one thread. Jobs are sent
+  as run requests to a viame_pipeline_server on a local socket, so plugins
+  and the GPU context are only loaded once. The server is restarted if a job
+  brings it down.
+
+  """
+  def __init__( self, socket_path, log_file, gpu=None ):
+    self.socket_path = socket_path
+    self.log_file = log_file
+    self.gpu = gpu
+    self.server = None
+    self.connection = None
+
+  def start( self ):
+    env = None
+    if self.gpu is not None:
+      env = dict( os.environ )
+      env[ CUDA_VISIBLE_DEVICES ] = get_real_gpu_index( self.gpu )
+    if os.path.exists( self.socket_path ):
+      os.unlink( self.socket_path )
+    with open( self.log_file, 'a' ) as fo:
+      self.server = subprocess.Popen( get_server_cmd() +
+        [ '--socket', self.socket_path ], stdout=fo, stderr=fo, env=env )
+    while self.server.poll() is None:
+      if os.path.exists( self.socket_path ):
+        try:
+          self.connection = socket.socket( socket.AF_UNIX, socket.SOCK_STREAM )
+          self.connection.connect( self.socket_path )
+          return
+        except socket.error:
+          self.connection.close()
+          self.connection = None
+      time.sleep( 0.1 )
+    exit_with_error( 'Unable to start pipeline worker, check ' + self.log_file )
+
+  def run( self, command, log_file='' ):
+    """Run a kwiver runner command line in the worker, returning its exit code"""
+    if self.server is None or self.server.poll() is not None:
+      self.start()
+    args = command[ len( get_pipeline_cmd() ): ]
+    settings = [ args[i+1] for i in range( 1, len( args ) - 1 ) if args[i] == '-s' ]
+    request = '\t'.join( [ 'run', os.path.abspath( args[0] ), log_file ] + settings )
+    reply = b''
+    try:
+      self.connection.sendall( request.encode() + b'\n' )
+      while not reply.endswith( b'\n' ):
+        data = self.connection.recv( 4096 )
+        if not data:
+          break
+        reply += data
+    except socket.error:
+      pass
+    if reply.startswith( b'OK' ):
+      return 0
+    if reply.startswith( b'ERROR' ):
+      return 1
+    # The server went down with the job, as a crashed kwiver runner would
+    self.close()
+    return self.server.returncode if self.server.returncode else -11
+
+  def close( self ):
+    if self.connection is not None:
+      self.connection.close()
+      self.connection = None
+    if self.server is not None and self.server.poll() is None:
+      self.server.terminate()
+    if self.server is not None:
+      self.server.wait()
+
 def get_script_path():
   return os.path.dirname( os.path.realpath( sys.argv[0] ) )
 
@@ -366,6 +449,74 @@ def split_image_list( image_list_file, n, dir ):
       f.close()
   return new_file_names
 
+def estimate_frame_count( input_path, image_exts ):
+  """Return a rough frame count for one input, only used to order jobs.
+  Videos use the stream frame count when it can be read, else their size.
+
+  """
+  if os.path.isdir( input_path ):
+    ext_list = image_exts.split( ";" )
+    return sum( 1 for _, _, files in os.walk( input_path )
+                for f in files if has_valid_ext( f, ext_list ) )
+  if not os.path.isfile( input_path ):
+    return 0
+  if input_path.endswith( default_list_ext ):
+    with open( input_path, 'r' ) as f:
+      return sum( 1 for _ in f )
+  try:
+    output = subprocess.check_output( [ 'ffprobe', '-v', 'error',
+      '-select_streams', 'v:0', '-show_entries', 'stream=nb_frames',
+      '-of', 'default=noprint_wrappers=1:nokey=1', input_path ],
+      stderr=subprocess.STDOUT )
+    return int( output.decode().strip() )
+  except Exception:
+    pass
+  try:
+    import cv2
+    count = int( cv2.VideoCapture( input_path ).get( cv2.CAP_PROP_FRAME_COUNT ) )
+    if count > 0:
+      return count
+  except Exception:
+    pass
+  return os.path.getsize( input_path ) // default_bytes_per_frame
+
+def input_signature( input_path, image_exts ):
+  """Sizes and modification times of a video, or of all images below a
+  folder, which change whenever frames or segments are added to the input.
+
+  """
+  if not os.path.isdir( input_path ):
+    st = os.stat( input_path )
+    return [ 1, st.st_size, int( st.st_mtime ) ]
+  ext_list = image_exts.split( ";" )
+  count, size, latest = 0, 0, 0
+  for root, _, files in os.walk( input_path ):
+    for f in files:
+      if has_valid_ext( f, ext_list ):
+        st = os.stat( os.path.join( root, f ) )
+        count += 1
+        size += st.st_size
+        latest = max( latest, int( st.st_mtime ) )
+  return [ count, size, latest ]
+
+def load_summary_state( output_dir ):
+  state_file = os.path.join( output_dir, summary_state_file )
+  if os.path.exists( state_file ):
+    with open( state_file, 'r' ) as f:
+      state = json.load( f )
+    if state.get( "version" ) == summary_state_version:
+      return state
+    log_info( "Ignoring summary state with unknown version: " + state_file + lb1 )
+  return { "version": summary_state_version, "inputs": {} }
+
+def save_summary_state( output_dir, state ):
+  """Rewrite the state file whole, so an interrupted run leaves the last
+  complete copy in place"""
+  state_file = os.path.join( output_dir, summary_state_file )
+  with open( state_file + ".tmp", 'w' ) as f:
+    json.dump( state, f, indent=1, sort_keys=True )
+  os.replace( state_file + ".tmp", state_file )
+
 def fset( setting_str ):
   return ['-s', setting_str]
 
@@ -433,6 +584,17 @@ def search_output_settings_list( output_dir, basename ):
     fset( 'kwa_writer:stream_id=' + basename ),
   ))
 
+def bulk_ingest_settings_list( basename ):
+  basename = basename.replace( div, "_" )
+  return list( itertools.chain(
+    fset( 'track_writer_db:writer:type=pg_copy' ),
+    fset( 'track_writer_db:writer:pg_copy:video_name=' + basename ),
+    fset( 'track_writer_db:file_name=' +
+          database_tool.spool_file( basename, 'object_track' ) ),
+    fset( 'smqtk_indexer:spool_file=' +
+          database_tool.spool_file( basename, 'descriptor_index' ) ),
+  ))
+
 def plot_settings_list( output_dir, basename ):
   return list( itertools.chain(
     fset( 'detector_writer:file_name=' + output_dir + div + basename + detection_ext ),
@@ -564,7 +726,7 @@ def add_final_list_csv( args, data_list ):
 # Process a single data item (image list, folder, or video)
 def process_using_kwiver( input_path, options, is_image_list=False,
                           base_name_override='', cpu=0, gpu=None,
-                          run_pipeline=True ):
+                          run_pipeline=True, worker=None ):
 
   # Generic settings shared across function
   multi_threaded = ( options.gpu_count * options.pipes > 1 )
@@ -722,6 +884,8 @@ def process_using_kwiver( input_path, options, is_image_list=False,
 
   command += homography_output_settings_list( output_dir, input_id_no_ext )
   command += search_output_settings_list( output_dir, input_id_no_ext )
+  if options.bulk_ingest:
+    command += bulk_ingest_settings_list( input_id_no_ext )
 
   command += archive_dimension_settings_list( options )
   command += object_detector_settings_list( options )
@@ -776,8 +940,13 @@ def process_using_kwiver( input_path, options, is_image_list=False,
       log_base = output_dir + div + options.log_directory + div + input_id_no_ext
       if os.path.sep in input_id_no_ext and not os.path.exists( os.path.dirname( log_base ) ):
         os.makedirs( os.path.dirname( log_base ) )
-      with get_log_output_files( log_base ) as kwargs:
-        return_id = execute_command( command, gpu=gpu, **kwargs )
+      if worker is not None:
+        return_id = worker.run( command, log_base + '.txt' )
+      else:
+        with get_log_output_files( log_base ) as kwargs:
+          return_id = execute_command( command, gpu=gpu, **kwargs )
+    elif worker is not None:
+      return_id = worker.run( command )
     else:
       return_id = execute_command( command, gpu=gpu )
   else:
@@ -832,6 +1001,7 @@ def process_using_kwiver( input_path, options, is_image_list=False,
     else:
       log_info( 'Success' + lb1 )
     any_video_complete = True
+    return input_id_no_ext
   else:
     if multi_threaded:
       log_info( 'Failure: {} on GPU {} Failed'.format( input_id, gpu ) + lb1 )
@@ -949,6 +1119,9 @@ if __name__ == "__main__" :
   parser.add_argument( "-pipes-per-gpu", "--pipes", default=1, type=int, metavar='N',
     help="Parallelize the ingest by using the first N GPUs in parallel" )
 
+  parser.add_argument( "--reuse-workers", dest="reuse_workers", action="store_true",
+    help="Keep one warm pipeline process per thread for all jobs, instead of a new runner per job" )
+
   parser.add_argument( "-pattern", dest="pattern", default="frame%06d.png",
     help="Pattern to use for output names for pipes outputting frames" )
 
@@ -994,12 +1167,20 @@ if __name__ == "__main__" :
   parser.add_argument( "--init-db", dest="init_db", action="store_true",
     help="Re-initialize database" )
 
+  parser.add_argument( "--bulk-ingest", dest="bulk_ingest", action="store_true",
+    help="Spool database rows to files and load them with parallel COPY at the end" )
+
   parser.add_argument( "--build-index", dest="build_index", action="store_true",
     help="Build searchable index on completion" )
 
   parser.add_argument( "--ball-tree", dest="ball_tree", action="store_true",
     help="Use a ball tree for the searchable index" )
 
+  parser.add_argument( "--incremental", dest="incremental", action="store_true",
+    help="Only process inputs which are new or changed since the last run "
+         "into the same output directory, keeping the existing database, "
+         "outputs and search index, which is updated with the new inputs." )
+
   parser.add_argument( "--no-reset-prompt", dest="no_reset_prompt", action="store_true",
     help="Don't prompt if the output folder should be reset" )
 
@@ -1051,6 +1232,17 @@ if __name__ == "__main__" :
     detection_ext = "_detections" + ext
     track_ext = "_tracks" + ext
 
+  # Incremental runs keep the database of earlier runs when there is one
+  summary_state = None
+  if args.incremental:
+    summary_state = load_summary_state( args.output_directory )
+    if args.init_db and database_tool.is_initialized():
+      log_info( lb1 + "Using existing database for incremental processing" + lb1 )
+      database_tool.start( quiet=True )
+      args.init_db = False
+    elif args.init_db:
+      summary_state[ "inputs" ] = {}
+
   # Initialize database
   if args.init_db:
     if len( args.log_directory ) > 0:
@@ -1075,8 +1267,9 @@ if __name__ == "__main__" :
 
     # Handle output directory creation if necessary
     if len( args.output_directory ) > 0:
-      recreate_dir = ( not args.init_db and not args.no_reset_prompt and call_pipeline )
-      prompt_user = ( not args.no_reset_prompt and call_pipeline )
+      recreate_dir = ( not args.init_db and not args.no_reset_prompt and call_pipeline and
+                       not args.incremental )
+      prompt_user = ( not args.no_reset_prompt and call_pipeline and not args.incremental )
       create_dir( args.output_directory, logging=False, recreate=recreate_dir, prompt=prompt_user )
 
     if len( args.log_directory ) > 0:
@@ -1097,10 +1290,12 @@ if __name__ == "__main__" :
       else:
         args.input_dir = args.input
 
+    worker_count = args.gpu_count * args.pipes
+
     if len( args.input_list ) > 0:
-      if args.gpu_count > 1:
+      if worker_count > 1:
         data_list = split_image_list( args.input_list, \
-          args.gpu_count, args.output_directory )
+          worker_count, args.output_directory )
       else:
         data_list = [ args.input_list ]
       is_image_list = True
@@ -1137,9 +1332,61 @@ if __name__ == "__main__" :
         else:
           exit_with_error( "Use of this script requires training a detector first" )
 
-    # Process videos in parallel, one per GPU
+    # Drop inputs completed by earlier runs, remembering what to record
+    # for the others once they complete
+    input_records = {}
+    removed_videos = []
+
+    if args.incremental and is_image_list:
+      log_info( "Incremental processing needs a folder or video input, "
+                "processing all images" + lb1 )
+    elif args.incremental:
+      completed = summary_state[ "inputs" ]
+      new_list = []
+      for entry in data_list:
+        if not os.path.exists( entry ):
+          new_list.append( entry )
+          continue
+        key = os.path.abspath( entry )
+        record = { "signature": input_signature( entry, args.image_exts ),
+                   "pipeline": args.pipeline }
+        previous = completed.get( key )
+        if previous is not None and previous[ "signature" ] == record[ "signature" ] and \
+           previous[ "pipeline" ] == record[ "pipeline" ]:
+          continue
+        if previous is not None:
+          removed_videos.append( previous[ "video_name" ] )
+          del completed[ key ]
+        input_records[ entry ] = record
+        new_list.append( entry )
+
+      log_info( "Skipping " + str( len( data_list ) - len( new_list ) ) +
+                " inputs processed by earlier runs, " + str( len( removed_videos ) ) +
+                " changed inputs will be reprocessed" + lb2 )
+      data_list = new_list
+
+      if removed_videos and call_pipeline and database_tool.is_initialized():
+        if len( args.log_directory ) > 0 and args.log_directory != "PIPE":
+          remove_log_file = args.output_directory + div + args.log_directory + div + "database_log.txt"
+        else:
+          remove_log_file = ""
+        if not database_tool.remove_videos( removed_videos, log_file=remove_log_file ):
+          exit_with_error( "Unable to remove changed inputs from database" )
+
+    new_videos = []
+    state_lock = threading.Lock()
+
+    # Process videos in parallel, each thread taking the next job when done.
+    # Longest jobs are queued first, so one long video is not left running
+    # on its own at the end of the batch.
+    queue_list = data_list
+    if worker_count > 1 and len( data_list ) > 1:
+      frame_counts = dict( ( f, estimate_frame_count( f, args.image_exts ) )
+                           for f in data_list )
+      queue_list = sorted( data_list, key=lambda f: frame_counts[f], reverse=True )
+
     data_queue = queue.Queue()
-    for video_name in data_list:
+    for video_name in queue_list:
       if os.path.isfile( video_name ) or os.path.isdir( video_name ):
         data_queue.put( video_name )
       else:
@@ -1151,15 +1398,44 @@ if __name__ == "__main__" :
     if auto_select_pipe and not args.mosaic:
       exit_with_error( "Auto-pipeline selection only valid for mosaicing" )
 
+    # Warm workers need the local socket server, not built on Windows
+    reuse_workers = args.reuse_workers and call_pipeline and not args.debug
+    if reuse_workers and os.name == 'nt':
+      log_info( "Worker reuse is not supported on Windows, ignoring" + lb1 )
+      reuse_workers = False
+    worker_dir = tempfile.mkdtemp() if reuse_workers else ""
+
     def process_on_thread( gpu, cpu ):
-      while True:
-        try:
-          entry_name = data_queue.get_nowait()
-        except queue.Empty:
-          break
-        if auto_select_pipe:
-          args.pipeline = auto_select_registration_pipe( entry_name )
-        process_using_kwiver( entry_name, args, is_image_list, cpu=cpu, gpu=gpu, run_pipeline=call_pipeline )
+      worker = None
+      if reuse_workers:
+        worker_name = "worker_" + str( gpu ) + "_" + str( cpu )
+        if len( args.log_directory ) > 0 and args.log_directory != "PIPE":
+          worker_log = args.output_directory + div + args.log_directory + div + worker_name + ".txt"
+        else:
+          worker_log = os.devnull
+        worker = pipeline_worker( os.path.join( worker_dir, worker_name + ".sock" ),
+                                  worker_log, gpu )
+      try:
+        while True:
+          try:
+            entry_name = data_queue.get_nowait()
+          except queue.Empty:
+            break
+          if auto_select_pipe:
+            args.pipeline = auto_select_registration_pipe( entry_name )
+          video_name = process_using_kwiver( entry_name, args, is_image_list, cpu=cpu,
+                                             gpu=gpu, run_pipeline=call_pipeline,
+                                             worker=worker )
+          if video_name is not None and entry_name in input_records:
+            with state_lock:
+              record = input_records[ entry_name ]
+              record[ "video_name" ] = video_name
+              summary_state[ "inputs" ][ os.path.abspath( entry_name ) ] = record
+              save_summary_state( args.output_directory, summary_state )
+              new_videos.append( video_name )
+      finally:
+        if worker is not None:
+          worker.close()
 
     gpu_thread_list = [ i for i in range( args.gpu_count ) for _ in range( args.pipes ) ]
     cpu_thread_list = list( range( args.pipes ) ) * args.gpu_count
@@ -1172,8 +1448,11 @@ if __name__ == "__main__" :
     for thread in threads:
       thread.join()
 
+    if worker_dir:
+      shutil.rmtree( worker_dir, ignore_errors=True )
+
     if is_image_list:
-      if args.gpu_count > 1: # Each thread outputs 1 list, add multiple
+      if len( data_list ) > 1: # Each thread outputs 1 list, add multiple
         add_final_list_csv( args, data_list )
         for image_list in data_list: # Clean up after split_image_list
           os.unlink( image_list )
@@ -1205,7 +1484,28 @@ if __name__ == "__main__" :
   if args.detection_plots or args.track_plots:
     log_info( lb1 )
 
-  # Build searchable index
+  # Load spooled database rows before any index is trained on them
+  if args.bulk_ingest and process_data and call_pipeline:
+    log_info( lb1 + "Loading database rows" + lb2 )
+
+    if len( args.log_directory ) > 0 and args.log_directory != "PIPE":
+      ingest_log_file = args.output_directory + div + args.log_directory + div + "database_ingest.txt"
+    else:
+      ingest_log_file = ""
+
+    if not database_tool.bulk_ingest( max( 4, args.gpu_count * args.pipes ),
+                                      log_file = ingest_log_file ):
+      exit_with_error( "Unable to load database rows" )
+
+  # Build searchable index, only hashing new inputs into an existing index
+  # unless indexed inputs were changed and removed from the database
+  index_videos = None
+  if args.incremental and process_data and call_pipeline and not is_image_list:
+    index_videos = new_videos if not removed_videos else None
+    if args.build_index and len( new_videos ) == 0 and not removed_videos:
+      log_info( lb1 + "No new inputs, leaving searchable index unchanged" + lb1 )
+      args.build_index = False
+
   if args.build_index:
     log_info( lb1 + "Building searchable index" + lb2 )
 
@@ -1218,7 +1518,8 @@ if __name__ == "__main__" :
       print( "Warning: building a ball tree is deprecated" )
 
     if not database_tool.build_standard_index( remove_quotes( args.install_dir ),
-                                               log_file = index_log_file ):
+                                               log_file = index_log_file,
+                                               video_names = index_videos ):
       exit_with_error( "Unable to build index" )
 
   # Output complete message
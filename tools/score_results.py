@@ -492,6 +492,114 @@ def generate_metrics_csv_kwcoco( input_file, output_file ):
 
   return [ output[-1][1], output[-1][2], output[-1][3] ]
 
+# ------------------- NATIVE C++ SCORING ENGINE ------------------------
+
+def get_native_scoring_cmd():
+  if os.name == 'nt':
+    return shutil.which( 'viame_score_results.exe' )
+  else:
+    return shutil.which( 'viame_score_results' )
+
+def use_native_scoring( args ):
+  return not args.python_scoring and args.input_format == "viame_csv" and \
+    get_native_scoring_cmd() is not None
+
+def get_native_scoring_base_cmd( args ):
+  cmd = [ get_native_scoring_cmd(), '--computed', args.computed ]
+  cmd = cmd + [ '--truth', args.truth, '--input-ext', args.input_ext ]
+  cmd = cmd + [ '--iou-thresh', str( args.iou_thresh ) ]
+  cmd = cmd + [ '--threshold', str( args.threshold ) ]
+  if args.labels:
+    cmd = cmd + [ '--labels', args.labels ]
+  if args.default_label:
+    cmd = cmd + [ '--default-label', args.default_label ]
+  if args.ignore_classes:
+    cmd = cmd + [ '--ignore-classes' ]
+  if args.aux_confidence:
+    cmd = cmd + [ '--aux-confidence' ]
+  return cmd
+
+def load_native_csv( filename ):
+  rows = []
+  with open( filename ) as f:
+    for line in f:
+      if len( line ) > 0 and line[0] != '#':
+        rows.append( line.rstrip().split( ',' ) )
+  return rows
+
+def plot_native_prc( output_dir ):
+  curves = dict()
+  for row in load_native_csv( os.path.join( output_dir, "pr_curves.csv" ) ):
+    if row[0] not in curves:
+      curves[ row[0] ] = ( [], [] )
+    curves[ row[0] ][0].append( float( row[3] ) )
+    curves[ row[0] ][1].append( float( row[2] ) )
+
+  fig = plt.figure()
+  for i, ( label, ( recall, precision ) ) in enumerate( curves.items() ):
+    stl = linestyles[ i % len( linestyles ) ]
+    cl = linecolors[ i ] if i < len( linecolors ) else np.random.rand( 3 )
+    plt.plot( recall, precision, linestyle=stl, color=cl, label=label )
+  plt.xlabel( 'Recall' )
+  plt.ylabel( 'Precision' )
+  plt.xlim( 0, 1 )
+  plt.ylim( 0, 1.05 )
+  if len( curves ) < 15:
+    plt.legend( loc="best" )
+  plt.savefig( os.path.join( output_dir, "pr_curves.png" ), bbox_inches='tight' )
+  plt.close( fig )
+
+def plot_native_confusion( output_dir ):
+  with open( os.path.join( output_dir, "confusion_matrix.csv" ) ) as f:
+    labels = f.readline().rstrip().split( ',' )[1:]
+  counts = np.array( [ [ int( x ) for x in row[1:] ] for row in
+    load_native_csv( os.path.join( output_dir, "confusion_matrix.csv" ) ) ] )
+
+  fig, ax = plt.subplots( figsize=( 2 + 0.5 * len( labels ), 2 + 0.5 * len( labels ) ) )
+  ax.imshow( counts, cmap='Blues' )
+  ax.set_xticks( range( len( labels ) ) )
+  ax.set_yticks( range( len( labels ) ) )
+  ax.set_xticklabels( labels, rotation=90 )
+  ax.set_yticklabels( labels )
+  ax.set_xlabel( 'Computed' )
+  ax.set_ylabel( 'Truth' )
+  for i in range( counts.shape[0] ):
+    for j in range( counts.shape[1] ):
+      if counts[i][j]:
+        ax.text( j, i, str( counts[i][j] ), ha='center', va='center', fontsize=6 )
+  plt.savefig( os.path.join( output_dir, "confusion_matrix.png" ), bbox_inches='tight' )
+  plt.close( fig )
+
+def generate_det_prc_conf_native( args ):
+  cmd = get_native_scoring_base_cmd( args )
+  cmd = cmd + [ '--det-prc-conf', args.det_prc_conf ]
+  if args.track_detections:
+    cmd = cmd + [ '--track-detections' ]
+  if subprocess.call( cmd ) != 0:
+    print_and_exit( "Native detection scoring failed" )
+  plot_native_prc( args.det_prc_conf )
+  plot_native_confusion( args.det_prc_conf )
+
+def generate_trk_mot_stats_native( args ):
+  cmd = get_native_scoring_base_cmd( args )
+  cmd = cmd + [ '--trk-mot-stats', args.trk_mot_stats ]
+  if args.per_class:
+    cmd = cmd + [ '--per-class' ]
+  if args.sweep_thresholds:
+    cmd = cmd + [ '--sweep-thresholds' ]
+    cmd = cmd + [ '--sweep-interval', str( args.sweep_interval ) ]
+  if subprocess.call( cmd ) != 0:
+    print_and_exit( "Native track scoring failed" )
+
+  # Filter file contains optimal thresholds per class in DIVE format
+  if args.per_class and args.sweep_thresholds and args.filter_estimator != "none":
+    net_score_file = os.path.join( args.trk_mot_stats, "class_metrics.csv" )
+    scores = { row[0] : [ float( x ) for x in row[1:] ]
+               for row in load_native_csv( net_score_file ) }
+    if scores:
+      filter_file = os.path.join( args.trk_mot_stats, "dive.config.json" )
+      create_mot_filter_json( filter_file, scores, args.filter_estimator )
+
 # ---------------- PRECISION-RECALL AND CONF MAT -----------------------
 
 def get_prc_conf_cmd():
@@ -627,6 +735,10 @@ def generate_det_prc_conf_single( args, target_class=None ):
 
 def generate_det_prc_conf( args, classes ):
 
+  if use_native_scoring( args ):
+    generate_det_prc_conf_native( args )
+    return
+
   if not classes:
     classes = [ None ]
 
@@ -1011,6 +1123,10 @@ def create_mot_filter_json( filename, scores, method ):
   return True
 
 def generate_trk_mot_stats( args, classes ):
+  if use_native_scoring( args ):
+    generate_trk_mot_stats_native( args )
+    return
+
   if classes:
     remake_dir( args.trk_mot_stats )
   else:
@@ -1135,6 +1251,8 @@ if __name__ == "__main__":
     help='Set to suppress plot legend' )
   parser.add_argument( '--use-cache', dest="use_cache", action='store_true',
     help='Do not recompute roc or conf intermediate files' )
+  parser.add_argument( '--python-scoring', dest="python_scoring", action='store_true',
+    help='Use kwcoco and motmetrics even when viame_score_results is available' )
 
   args = parser.parse_args()
 
@@ -0,0 +1,952 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <kwiversys/CommandLineArguments.hxx>
+
+#include <vital/config/config_block.h>
+#include <vital/algo/detected_object_set_input.h>
+#include <vital/algo/detected_object_set_output.h>
+#include <vital/algo/image_filter.h>
+#include <vital/types/detected_object_set.h>
+#include <vital/types/detected_object_type.h>
+#include <vital/types/image_container.h>
+#include <vital/types/object_track_set.h>
+#include <vital/types/timestamp.h>
+
+#include <plugins/core/plugin_manifest.h>
+
+#include <sprokit/processes/adapters/adapter_data_set.h>
+#include <sprokit/processes/adapters/embedded_pipeline.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if WIN32 || ( __cplusplus >= 201703L && __has_include(<filesystem>) )
+  #include <filesystem>
+  namespace filesystem = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+  #include <experimental/filesystem>
+  namespace filesystem = std::experimental::filesystem;
+#else
+  #error "No filesystem library available"
+#endif
+
+namespace kv = kwiver::vital;
+
+// =======================================================================================
+// Allocations of every thread, including the pipeline threads, counted by operator new
+static std::atomic< size_t > g_allocations{ 0 };
+static std::atomic< size_t > g_allocated_bytes{ 0 };
+
+void* operator new( std::size_t size )
+{
+  g_allocations.fetch_add( 1, std::memory_order_relaxed );
+  g_allocated_bytes.fetch_add( size, std::memory_order_relaxed );
+
+  if( void* ptr = std::malloc( size ? size : 1 ) )
+  {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete( void* ptr ) noexcept
+{
+  std::free( ptr );
+}
+
+void operator delete( void* ptr, std::size_t ) noexcept
+{
+  std::free( ptr );
+}
+
+// =======================================================================================
+// Class storing all input parameters for the tool
+class benchmark_vars
+{
+public:
+
+  // Collected command line args
+  kwiversys::CommandLineArguments m_args;
+
+  // Config options
+  bool opt_help = false;
+
+  std::string opt_iterations = "200";
+  std::string opt_warmup = "10";
+  std::string opt_detections = "50";
+  std::string opt_frames = "20";
+  std::string opt_width = "1920";
+  std::string opt_height = "1080";
+  std::string opt_cameras;
+  std::string opt_depths = "1,4,16";
+  std::string opt_resolutions = "640x480,1920x1080,5472x3648";
+  std::string opt_filter;
+  std::string opt_output;
+};
+
+static benchmark_vars g_params;
+
+// =======================================================================================
+// One measured operation, setup runs before every call and is not timed
+struct benchmark_case
+{
+  size_t items_per_call = 1;
+
+  std::function< void() > setup;
+  std::function< void() > call;
+};
+
+// Statistics of one case, or the reason it could not run
+struct benchmark_result
+{
+  std::string name;
+  std::string kind;
+  std::string skipped;
+  size_t items_per_call = 1;
+  size_t calls = 0;
+
+  double throughput = 0.0;
+  double mean_us = 0.0;
+  double p50_us = 0.0;
+  double p90_us = 0.0;
+  double p99_us = 0.0;
+  double max_us = 0.0;
+  double allocations = 0.0;
+  double allocated_bytes = 0.0;
+};
+
+// Synthetic input sizes shared by all cases
+struct benchmark_inputs
+{
+  size_t detections;
+  size_t frames;
+  size_t width;
+  size_t height;
+};
+
+// ---------------------------------------------------------------------------------------
+static double
+percentile( std::vector< double > const& sorted, double fraction )
+{
+  const size_t rank = static_cast< size_t >( fraction * ( sorted.size() - 1 ) + 0.5 );
+  return sorted[ std::min( rank, sorted.size() - 1 ) ];
+}
+
+// ---------------------------------------------------------------------------------------
+static benchmark_result
+run_case( benchmark_case const& bench, size_t warmup, size_t iterations )
+{
+  for( size_t i = 0; i < warmup; ++i )
+  {
+    if( bench.setup )
+    {
+      bench.setup();
+    }
+    bench.call();
+  }
+
+  std::vector< double > latencies;
+  latencies.reserve( iterations );
+
+  size_t allocations = 0, allocated_bytes = 0;
+
+  for( size_t i = 0; i < iterations; ++i )
+  {
+    if( bench.setup )
+    {
+      bench.setup();
+    }
+
+    const size_t allocations_before = g_allocations.load();
+    const size_t bytes_before = g_allocated_bytes.load();
+    const auto start = std::chrono::steady_clock::now();
+
+    bench.call();
+
+    const auto end = std::chrono::steady_clock::now();
+    allocations += g_allocations.load() - allocations_before;
+    allocated_bytes += g_allocated_bytes.load() - bytes_before;
+
+    latencies.push_back( std::chrono::duration< double, std::micro >( end - start ).count() );
+  }
+
+  benchmark_result result;
+  result.items_per_call = bench.items_per_call;
+  result.calls = iterations;
+
+  double total_us = 0.0;
+  for( double latency : latencies )
+  {
+    total_us += latency;
+  }
+
+  std::sort( latencies.begin(), latencies.end() );
+
+  result.throughput = ( total_us > 0.0 ? iterations * 1.0e6 / total_us : 0.0 );
+  result.mean_us = total_us / iterations;
+  result.p50_us = percentile( latencies, 0.50 );
+  result.p90_us = percentile( latencies, 0.90 );
+  result.p99_us = percentile( latencies, 0.99 );
+  result.max_us = latencies.back();
+  result.allocations = static_cast< double >( allocations ) / iterations;
+  result.allocated_bytes = static_cast< double >( allocated_bytes ) / iterations;
+
+  return result;
+}
+
+// ---------------------------------------------------------------------------------------
+static std::string
+json_string( std::string const& value )
+{
+  std::ostringstream out;
+  out << '"';
+
+  for( char c : value )
+  {
+    switch( c )
+    {
+      case '"':  out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\n': out << "\\n"; break;
+      case '\t': out << "\\t"; break;
+      default:
+        if( static_cast< unsigned char >( c ) < 0x20 )
+        {
+          out << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' )
+              << static_cast< int >( c ) << std::dec << std::setfill( ' ' );
+        }
+        else
+        {
+          out << c;
+        }
+    }
+  }
+
+  out << '"';
+  return out.str();
+}
+
+// ---------------------------------------------------------------------------------------
+static void
+write_json( std::ostream& out, benchmark_inputs const& inputs, size_t warmup,
+            size_t iterations, std::vector< benchmark_result > const& results )
+{
+  out << std::fixed << std::setprecision( 3 );
+  out << "{\n"
+      << "  \"iterations\": " << iterations << ",\n"
+      << "  \"warmup\": " << warmup << ",\n"
+      << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+      << "  \"detections\": " << inputs.detections << ",\n"
+      << "  \"frames\": " << inputs.frames << ",\n"
+      << "  \"image_width\": " << inputs.width << ",\n"
+      << "  \"image_height\": " << inputs.height << ",\n"
+      << "  \"results\": [";
+
+  for( size_t i = 0; i < results.size(); ++i )
+  {
+    auto const& r = results[i];
+
+    out << ( i ? "," : "" ) << "\n    {\n"
+        << "      \"name\": " << json_string( r.name ) << ",\n"
+        << "      \"kind\": " << json_string( r.kind ) << ",\n";
+
+    if( !r.skipped.empty() )
+    {
+      out << "      \"skipped\": " << json_string( r.skipped ) << "\n    }";
+      continue;
+    }
+
+    out << "      \"items_per_call\": " << r.items_per_call << ",\n"
+        << "      \"calls\": " << r.calls << ",\n"
+        << "      \"calls_per_second\": " << r.throughput << ",\n"
+        << "      \"items_per_second\": " << r.throughput * r.items_per_call << ",\n"
+        << "      \"latency_us\": { \"mean\": " << r.mean_us
+        << ", \"p50\": " << r.p50_us << ", \"p90\": " << r.p90_us
+        << ", \"p99\": " << r.p99_us << ", \"max\": " << r.max_us << " },\n"
+        << "      \"allocations_per_call\": " << r.allocations << ",\n"
+        << "      \"allocated_bytes_per_call\": " << r.allocated_bytes << "\n    }";
+  }
+
+  out << "\n  ]\n}" << std::endl;
+}
+
+// =======================================================================================
+// Synthetic inputs, generated from a fixed seed so that runs are comparable
+static std::mt19937 g_rng( 42 );
+
+static kv::detected_object_set_sptr
+make_detections( benchmark_inputs const& inputs, bool with_lengths )
+{
+  std::uniform_real_distribution< double > size_dist( 20.0, 200.0 );
+  std::uniform_real_distribution< double > x_dist( 0.0, inputs.width - 200.0 );
+  std::uniform_real_distribution< double > y_dist( 0.0, inputs.height - 200.0 );
+  std::uniform_real_distribution< double > score_dist( 0.1, 1.0 );
+
+  auto output = std::make_shared< kv::detected_object_set >();
+
+  for( size_t i = 0; i < inputs.detections; ++i )
+  {
+    const double x = x_dist( g_rng ), y = y_dist( g_rng );
+    const double w = size_dist( g_rng ), h = size_dist( g_rng );
+    const double score = score_dist( g_rng );
+
+    auto type = std::make_shared< kv::detected_object_type >( "fish", score );
+    auto det = std::make_shared< kv::detected_object >(
+      kv::bounding_box_d( x, y, x + w, y + h ), score, type );
+
+    if( with_lengths && i % 2 == 0 )
+    {
+      det->add_note( ":length=" + std::to_string( w * 0.5 ) );
+    }
+
+    output->add( det );
+  }
+
+  return output;
+}
+
+static kv::image_container_sptr
+make_image( benchmark_inputs const& inputs, size_t depth )
+{
+  std::uniform_int_distribution< int > value_dist( 0, 255 );
+
+  kv::image_of< uint8_t > image( inputs.width, inputs.height, depth );
+
+  for( size_t d = 0; d < depth; ++d )
+  {
+    for( size_t j = 0; j < inputs.height; ++j )
+    {
+      for( size_t i = 0; i < inputs.width; ++i )
+      {
+        image( i, j, d ) = static_cast< uint8_t >( value_dist( g_rng ) );
+      }
+    }
+  }
+
+  return std::make_shared< kv::simple_image_container >( image );
+}
+
+// New single state tracks around the given detections, as tracker outputs
+static kv::object_track_set_sptr
+make_tracks( kv::detected_object_set_sptr detections, kv::timestamp const& ts,
+             kv::track_id_t first_id )
+{
+  std::vector< kv::track_sptr > tracks;
+
+  for( auto det : *detections )
+  {
+    auto track = kv::track::create();
+    track->set_id( first_id++ );
+    track->append( std::make_shared< kv::object_track_state >( ts, det ) );
+    tracks.push_back( track );
+  }
+
+  return std::make_shared< kv::object_track_set >( tracks );
+}
+
+// =======================================================================================
+// Embedded pipeline around one process, stopped when the last reference is released
+typedef std::shared_ptr< kwiver::embedded_pipeline > pipeline_sptr;
+
+static pipeline_sptr
+start_pipeline_text( std::string const& text )
+{
+  std::unique_ptr< kwiver::embedded_pipeline > pipe( new kwiver::embedded_pipeline() );
+
+  std::istringstream stream( text );
+  pipe->build_pipeline( stream );
+  pipe->start();
+
+  return pipeline_sptr( pipe.release(),
+    []( kwiver::embedded_pipeline* p )
+    {
+      p->send_end_of_input();
+      p->wait();
+      delete p;
+    } );
+}
+
+static const char* const adapter_blocks =
+  "process in_adapt\n :: input_adapter\n\n"
+  "process out_adapt\n :: output_adapter\n\n";
+
+static pipeline_sptr
+start_pipeline( std::string const& process_block,
+                std::vector< std::string > const& inputs,
+                std::vector< std::string > const& outputs )
+{
+  std::ostringstream text;
+
+  text << adapter_blocks << process_block << "\n";
+
+  for( auto const& port : inputs )
+  {
+    text << "connect from in_adapt." << port << "\n"
+         << "        to   bench." << port << "\n";
+  }
+  for( auto const& port : outputs )
+  {
+    text << "connect from bench." << port << "\n"
+         << "        to   out_adapt." << port << "\n";
+  }
+
+  return start_pipeline_text( text.str() );
+}
+
+// Send one input set and wait for the matching output set
+static void
+run_pipeline_step( kwiver::embedded_pipeline& pipe,
+                   kwiver::adapter::adapter_data_set_t const& inputs )
+{
+  pipe.send( inputs );
+
+  if( pipe.receive()->is_end_of_data() )
+  {
+    throw std::runtime_error( "Pipeline terminated unexpectedly" );
+  }
+}
+
+// =======================================================================================
+// Benchmark cases, each throwing when its plugins or settings are unavailable
+static kv::algo::detected_object_set_output_sptr
+create_csv_writer()
+{
+  kv::config_block_sptr config = kv::config_block::empty_config();
+  config->set_value( "writer:type", "viame_csv" );
+
+  kv::algo::detected_object_set_output_sptr writer;
+  kv::algo::detected_object_set_output::set_nested_algo_configuration(
+    "writer", config, writer );
+
+  if( !writer )
+  {
+    throw std::runtime_error( "viame_csv writer is not available" );
+  }
+  return writer;
+}
+
+static void
+write_csv( kv::algo::detected_object_set_output_sptr writer,
+           std::vector< kv::detected_object_set_sptr > const& sets,
+           std::string const& filename )
+{
+  writer->open( filename );
+  for( size_t i = 0; i < sets.size(); ++i )
+  {
+    writer->write_set( sets[i], "frame" + std::to_string( i ) + ".png" );
+  }
+  writer->complete();
+  writer->close();
+}
+
+static std::vector< kv::detected_object_set_sptr >
+make_frame_sets( benchmark_inputs const& inputs )
+{
+  std::vector< kv::detected_object_set_sptr > sets;
+  for( size_t i = 0; i < inputs.frames; ++i )
+  {
+    sets.push_back( make_detections( inputs, false ) );
+  }
+  return sets;
+}
+
+static benchmark_case
+csv_writer_case( benchmark_inputs const& inputs, std::string const& filename )
+{
+  auto writer = create_csv_writer();
+  auto sets = make_frame_sets( inputs );
+
+  benchmark_case bench;
+  bench.items_per_call = inputs.frames;
+  bench.call = [writer, sets, filename]()
+  {
+    write_csv( writer, sets, filename );
+  };
+  return bench;
+}
+
+static benchmark_case
+csv_reader_case( benchmark_inputs const& inputs, std::string const& filename )
+{
+  kv::config_block_sptr config = kv::config_block::empty_config();
+  config->set_value( "reader:type", "viame_csv" );
+
+  kv::algo::detected_object_set_input_sptr reader;
+  kv::algo::detected_object_set_input::set_nested_algo_configuration(
+    "reader", config, reader );
+
+  if( !reader )
+  {
+    throw std::runtime_error( "viame_csv reader is not available" );
+  }
+
+  write_csv( create_csv_writer(), make_frame_sets( inputs ), filename );
+
+  // The reader parses the whole file on its first read, so every call reads it all
+  benchmark_case bench;
+  bench.items_per_call = inputs.frames;
+  bench.call = [reader, filename]()
+  {
+    kv::detected_object_set_sptr set;
+    std::string name;
+
+    reader->open( filename );
+    while( reader->read_set( set, name ) )
+    {
+      name.clear();
+    }
+    reader->close();
+  };
+  return bench;
+}
+
+static benchmark_case
+image_filter_case( benchmark_inputs const& inputs, std::string const& type,
+                   size_t depth )
+{
+  kv::config_block_sptr config = kv::config_block::empty_config();
+  config->set_value( "filter:type", type );
+
+  kv::algo::image_filter_sptr filter;
+  kv::algo::image_filter::set_nested_algo_configuration( "filter", config, filter );
+
+  if( !filter )
+  {
+    throw std::runtime_error( type + " filter is not available" );
+  }
+
+  const kv::image_container_sptr image = make_image( inputs, depth );
+
+  benchmark_case bench;
+  bench.call = [filter, image]()
+  {
+    filter->filter( image );
+  };
+  return bench;
+}
+
+static benchmark_case
+refine_measurements_case( benchmark_inputs const& inputs )
+{
+  auto pipe = start_pipeline(
+    "process bench\n :: refine_measurements\n  :history_length 10\n",
+    { "timestamp", "detected_object_set" }, { "detected_object_set" } );
+
+  // The process rewrites the detection notes, so each call gets new detections
+  auto next = std::make_shared< kwiver::adapter::adapter_data_set_t >();
+  auto frame = std::make_shared< kv::frame_id_t >( 0 );
+
+  benchmark_case bench;
+  bench.setup = [inputs, next, frame]()
+  {
+    *next = kwiver::adapter::adapter_data_set::create();
+    ( *next )->add_value( "timestamp", kv::timestamp( *frame, *frame ) );
+    ( *next )->add_value( "detected_object_set", make_detections( inputs, true ) );
+    ++( *frame );
+  };
+  bench.call = [pipe, next]()
+  {
+    run_pipeline_step( *pipe, *next );
+  };
+  return bench;
+}
+
+static benchmark_case
+track_conductor_case( benchmark_inputs const& inputs )
+{
+  // The short term tracker outputs come from the input adapter, as from a tracker
+  auto pipe = start_pipeline(
+    "process bench\n :: track_conductor\n",
+    { "timestamp", "initializations", "short_term_tracks", "short_term_timestamp" },
+    { "object_track_set" } );
+
+  auto next = std::make_shared< kwiver::adapter::adapter_data_set_t >();
+  auto frame = std::make_shared< kv::frame_id_t >( 0 );
+
+  benchmark_case bench;
+  bench.setup = [inputs, next, frame]()
+  {
+    const kv::timestamp ts( *frame, *frame );
+    const kv::track_id_t first_id = *frame * inputs.detections * 2;
+
+    *next = kwiver::adapter::adapter_data_set::create();
+    ( *next )->add_value( "timestamp", ts );
+    ( *next )->add_value( "initializations",
+      make_tracks( make_detections( inputs, false ), ts, first_id ) );
+    ( *next )->add_value( "short_term_tracks",
+      make_tracks( make_detections( inputs, false ), ts, first_id + inputs.detections ) );
+    ( *next )->add_value( "short_term_timestamp", ts );
+    ++( *frame );
+  };
+  bench.call = [pipe, next]()
+  {
+    run_pipeline_step( *pipe, *next );
+  };
+  return bench;
+}
+
+static benchmark_case
+stereo_pairing_case( benchmark_inputs const& inputs, std::string const& cameras )
+{
+  if( cameras.empty() )
+  {
+    throw std::runtime_error( "No --cameras calibration directory given" );
+  }
+
+  // The IOU method needs no depth map, only the calibration
+  auto pipe = start_pipeline(
+    "process bench\n :: detections_pairing_from_stereo\n"
+    "  :cameras_directory " + cameras + "\n"
+    "  :pairing_method PAIRING_IOU\n",
+    { "detected_object_set1", "detected_object_set2" },
+    { "detected_object_set_out1", "detected_object_set_out2" } );
+
+  auto next = std::make_shared< kwiver::adapter::adapter_data_set_t >();
+
+  benchmark_case bench;
+  bench.setup = [inputs, next]()
+  {
+    *next = kwiver::adapter::adapter_data_set::create();
+    ( *next )->add_value( "detected_object_set1", make_detections( inputs, false ) );
+    ( *next )->add_value( "detected_object_set2", make_detections( inputs, false ) );
+  };
+  bench.call = [pipe, next]()
+  {
+    run_pipeline_step( *pipe, *next );
+  };
+  return bench;
+}
+
+// ---------------------------------------------------------------------------------------
+// Framework overhead, with algorithms doing no work so that only sprokit costs remain
+static benchmark_case
+image_pipeline_case( std::string const& text, size_t width, size_t height )
+{
+  auto pipe = start_pipeline_text( text );
+
+  benchmark_inputs image_size = { 0, 0, width, height };
+  auto image = make_image( image_size, 3 );
+  auto next = std::make_shared< kwiver::adapter::adapter_data_set_t >();
+
+  benchmark_case bench;
+  bench.setup = [image, next]()
+  {
+    *next = kwiver::adapter::adapter_data_set::create();
+    ( *next )->add_value( "image", image );
+  };
+  bench.call = [pipe, next]()
+  {
+    run_pipeline_step( *pipe, *next );
+  };
+  return bench;
+}
+
+// Image passed along a chain of hello_world pass-through filters, one step per hop
+static benchmark_case
+filter_chain_case( size_t depth, size_t width, size_t height )
+{
+  std::ostringstream text;
+  std::string source = "in_adapt.image";
+
+  text << adapter_blocks;
+
+  for( size_t i = 0; i < depth; ++i )
+  {
+    const std::string stage = "filter" + std::to_string( i );
+
+    text << "process " << stage << "\n :: image_filter\n"
+         << "  :filter:type hello_world\n\n"
+         << "connect from " << source << "\n"
+         << "        to   " << stage << ".image\n\n";
+
+    source = stage + ".image";
+  }
+
+  text << "connect from " << source << "\n"
+       << "        to   out_adapt.image\n";
+
+  return image_pipeline_case( text.str(), width, height );
+}
+
+// One image shared by parallel empty detectors, each producing a new detection set
+static benchmark_case
+detector_fanout_case( size_t depth, size_t width, size_t height )
+{
+  std::ostringstream text;
+
+  text << adapter_blocks;
+
+  for( size_t i = 0; i < depth; ++i )
+  {
+    const std::string stage = "detector" + std::to_string( i );
+
+    text << "process " << stage << "\n :: image_object_detector\n"
+         << "  :detector:type empty\n\n"
+         << "connect from in_adapt.image\n"
+         << "        to   " << stage << ".image\n"
+         << "connect from " << stage << ".detected_object_set\n"
+         << "        to   out_adapt.detected_object_set" << i << "\n\n";
+  }
+
+  return image_pipeline_case( text.str(), width, height );
+}
+
+// ---------------------------------------------------------------------------------------
+static std::vector< std::string >
+split_list( std::string const& value )
+{
+  std::vector< std::string > output;
+  std::istringstream stream( value );
+  std::string item;
+
+  while( std::getline( stream, item, ',' ) )
+  {
+    if( !item.empty() )
+    {
+      output.push_back( item );
+    }
+  }
+  return output;
+}
+
+/*                   _
+ *   _ __ ___   __ _(_)_ __
+ *  | '_ ` _ \ / _` | | '_ \
+ *  | | | | | | (_| | | | | |
+ *  |_| |_| |_|\__,_|_|_| |_|
+ *
+ */
+int
+main( int argc, char* argv[] )
+{
+  // Parse options
+  g_params.m_args.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  g_params.m_args.AddArgument( "--help",       argT::NO_ARGUMENT,
+    &g_params.opt_help, "Display usage information" );
+  g_params.m_args.AddArgument( "--iterations", argT::SPACE_ARGUMENT,
+    &g_params.opt_iterations, "Timed calls of every case, 200 by default" );
+  g_params.m_args.AddArgument( "--warmup",     argT::SPACE_ARGUMENT,
+    &g_params.opt_warmup, "Untimed calls of every case before the timed ones" );
+  g_params.m_args.AddArgument( "--detections", argT::SPACE_ARGUMENT,
+    &g_params.opt_detections, "Synthetic detections per frame" );
+  g_params.m_args.AddArgument( "--frames",     argT::SPACE_ARGUMENT,
+    &g_params.opt_frames, "Frames written and read per call of the CSV cases" );
+  g_params.m_args.AddArgument( "--width",      argT::SPACE_ARGUMENT,
+    &g_params.opt_width, "Synthetic image width" );
+  g_params.m_args.AddArgument( "--height",     argT::SPACE_ARGUMENT,
+    &g_params.opt_height, "Synthetic image height" );
+  g_params.m_args.AddArgument( "--cameras",    argT::SPACE_ARGUMENT,
+    &g_params.opt_cameras, "Stereo calibration directory, with intrinsics.yml and "
+    "extrinsics.yml, required by the stereo pairing case" );
+  g_params.m_args.AddArgument( "--depths",     argT::SPACE_ARGUMENT,
+    &g_params.opt_depths, "Comma separated stage counts of the overhead pipelines" );
+  g_params.m_args.AddArgument( "--resolutions", argT::SPACE_ARGUMENT,
+    &g_params.opt_resolutions, "Comma separated WIDTHxHEIGHT image sizes of the "
+    "overhead pipelines" );
+  g_params.m_args.AddArgument( "--filter",     argT::SPACE_ARGUMENT,
+    &g_params.opt_filter, "Only run the cases whose name contains this string" );
+  g_params.m_args.AddArgument( "--output",     argT::SPACE_ARGUMENT,
+    &g_params.opt_output, "Output JSON file, printed to the console by default" );
+
+  // Parse args
+  if( !g_params.m_args.Parse() )
+  {
+    std::cerr << "Problem parsing arguments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Print help
+  if( g_params.opt_help )
+  {
+    std::cout << "Usage: " << argv[0] << " [options]\n"
+              << "\nMeasure core and OpenCV plugins on synthetic inputs, outside of "
+              << "a full pipeline.\n"
+              << g_params.m_args.GetHelp() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    benchmark_inputs inputs;
+    inputs.detections = std::stoul( g_params.opt_detections );
+    inputs.frames = std::max< size_t >( std::stoul( g_params.opt_frames ), 1 );
+    inputs.width = std::max< size_t >( std::stoul( g_params.opt_width ), 256 );
+    inputs.height = std::max< size_t >( std::stoul( g_params.opt_height ), 256 );
+
+    const size_t iterations =
+      std::max< size_t >( std::stoul( g_params.opt_iterations ), 1 );
+    const size_t warmup = std::stoul( g_params.opt_warmup );
+
+    viame::load_plugins_for( { "viame_csv", "ocv_enhancer", "ocv_debayer",
+                               "input_adapter", "output_adapter",
+                               "refine_measurements", "track_conductor",
+                               "detections_pairing_from_stereo",
+                               "image_filter", "hello_world",
+                               "image_object_detector", "empty" } );
+
+    const std::string csv_file =
+      ( filesystem::temp_directory_path() /
+        ( "viame_benchmark_" + std::to_string( std::random_device()() ) + ".csv" ) ).string();
+
+    // Cases are created lazily, so that filtered out ones never start a pipeline
+    struct case_entry
+    {
+      std::string name;
+      std::string kind;
+      std::function< benchmark_case() > create;
+    };
+
+    std::vector< case_entry > cases =
+    {
+      { "viame_csv write", "algorithm",
+        [&]{ return csv_writer_case( inputs, csv_file ); } },
+      { "viame_csv read", "algorithm",
+        [&]{ return csv_reader_case( inputs, csv_file ); } },
+      { "ocv_enhancer", "algorithm",
+        [&]{ return image_filter_case( inputs, "ocv_enhancer", 3 ); } },
+      { "ocv_debayer", "algorithm",
+        [&]{ return image_filter_case( inputs, "ocv_debayer", 1 ); } },
+      { "refine_measurements", "process",
+        [&]{ return refine_measurements_case( inputs ); } },
+      { "track_conductor", "process",
+        [&]{ return track_conductor_case( inputs ); } },
+      { "detections_pairing_from_stereo", "process",
+        [&]{ return stereo_pairing_case( inputs, g_params.opt_cameras ); } },
+    };
+
+    // Depth 0 only crosses the input and output adapters
+    for( auto const& resolution : split_list( g_params.opt_resolutions ) )
+    {
+      size_t width = 0, height = 0;
+      char separator = 0;
+      std::istringstream parser( resolution );
+
+      if( !( parser >> width >> separator >> height ) || separator != 'x' ||
+          width == 0 || height == 0 )
+      {
+        throw std::runtime_error( "Invalid resolution: " + resolution );
+      }
+
+      cases.push_back( { "overhead adapters " + resolution, "pipeline",
+        [=]{ return filter_chain_case( 0, width, height ); } } );
+
+      for( auto const& depth_str : split_list( g_params.opt_depths ) )
+      {
+        const size_t depth = std::stoul( depth_str );
+        const std::string suffix = " depth=" + depth_str + " " + resolution;
+
+        cases.push_back( { "overhead filter_chain" + suffix, "pipeline",
+          [=]{ return filter_chain_case( depth, width, height ); } } );
+        cases.push_back( { "overhead detector_fanout" + suffix, "pipeline",
+          [=]{ return detector_fanout_case( depth, width, height ); } } );
+      }
+    }
+
+    std::vector< benchmark_result > results;
+
+    for( auto const& entry : cases )
+    {
+      if( entry.name.find( g_params.opt_filter ) == std::string::npos )
+      {
+        continue;
+      }
+
+      benchmark_result result;
+
+      std::cerr << "Running " << entry.name << std::endl;
+
+      // Console text of algorithms, such as hello_world, is dropped from the report
+      std::streambuf* console = std::cout.rdbuf( nullptr );
+
+      try
+      {
+        result = run_case( entry.create(), warmup, iterations );
+      }
+      catch( const std::exception& e )
+      {
+        result.skipped = e.what();
+      }
+
+      std::cout.rdbuf( console );
+      std::cout.clear();
+
+      if( !result.skipped.empty() )
+      {
+        std::cerr << "Skipping " << entry.name << ": " << result.skipped << std::endl;
+      }
+
+      result.name = entry.name;
+      result.kind = entry.kind;
+      results.push_back( result );
+    }
+
+    std::error_code ec;
+    filesystem::remove( csv_file, ec );
+
+    if( g_params.opt_output.empty() )
+    {
+      write_json( std::cout, inputs, warmup, iterations, results );
+    }
+    else
+    {
+      std::ofstream fout( g_params.opt_output );
+
+      if( !fout )
+      {
+        throw std::runtime_error( "Unable to open " + g_params.opt_output );
+      }
+      write_json( fout, inputs, warmup, iterations, results );
+    }
+  }
+  catch( const std::exception& e )
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
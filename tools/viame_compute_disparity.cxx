@@ -0,0 +1,591 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <kwiversys/CommandLineArguments.hxx>
+
+#include <vital/plugin_loader/plugin_manager.h>
+#include <vital/config/config_block.h>
+#include <vital/config/config_block_io.h>
+#include <vital/algo/compute_stereo_depth_map.h>
+#include <vital/types/image_container.h>
+
+#include <arrows/ocv/image_container.h>
+
+#include <plugins/core/spsc_ring_buffer.h>
+#include <plugins/core/thread_pool.h>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/calib3d/calib3d.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if WIN32 || ( __cplusplus >= 201703L && __has_include(<filesystem>) )
+  #include <filesystem>
+  namespace filesystem = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+  #include <experimental/filesystem>
+  namespace filesystem = std::experimental::filesystem;
+#else
+  #error "No filesystem library available"
+#endif
+
+namespace kv = kwiver::vital;
+namespace ocv = kwiver::arrows::ocv;
+
+// =======================================================================================
+// Class storing all input parameters for the tool
+class disparity_vars
+{
+public:
+
+  // Collected command line args
+  kwiversys::CommandLineArguments m_args;
+
+  // Config options
+  bool opt_help = false;
+  bool opt_depth = false;
+
+  std::string opt_config;
+  std::string opt_algorithm = "ocv_rectified_stereo_disparity_map";
+  std::string opt_cameras;
+  std::string opt_left_list;
+  std::string opt_right_list;
+  std::string opt_input_list;
+  std::string opt_output = ".";
+  std::string opt_format = "png";
+  std::string opt_png_compression = "3";
+  std::string opt_threads = "0";
+  std::string opt_prefetch = "4";
+};
+
+static disparity_vars g_params;
+
+// ---------------------------------------------------------------------------------------
+// One stereo pair, decoded ahead of the workers by the prefetch thread
+struct stereo_job
+{
+  size_t index = 0;
+  std::string name;
+  cv::Mat left;
+  cv::Mat right;
+  bool last = false;
+};
+
+// ---------------------------------------------------------------------------------------
+static std::vector< std::string >
+read_list( std::string const& filename )
+{
+  std::vector< std::string > output;
+  std::ifstream fin( filename );
+  std::string line;
+
+  if( !fin )
+  {
+    throw std::runtime_error( "Unable to open " + filename );
+  }
+
+  while( std::getline( fin, line ) )
+  {
+    if( !line.empty() && line.back() == '\r' )
+    {
+      line.pop_back();
+    }
+    if( !line.empty() )
+    {
+      output.push_back( line );
+    }
+  }
+  return output;
+}
+
+// ---------------------------------------------------------------------------------------
+// Write a single channel float image in the NumPy format, readable with numpy.load
+static void
+write_npy( std::string const& filename, cv::Mat const& image )
+{
+  std::ostringstream header;
+  header << "{'descr': '<f4', 'fortran_order': False, 'shape': ("
+         << image.rows << ", " << image.cols << "), }";
+
+  std::string text = header.str();
+
+  // The header, including the magic, version and length fields, is padded
+  // with spaces to a multiple of 64 bytes and ends with a newline
+  const size_t total = 10 + text.size() + 1;
+  text.append( ( 64 - total % 64 ) % 64, ' ' );
+  text.push_back( '\n' );
+
+  std::ofstream fout( filename, std::ios::binary );
+  const std::uint16_t length = static_cast< std::uint16_t >( text.size() );
+
+  fout.write( "\x93NUMPY\x01\x00", 8 );
+  fout.put( static_cast< char >( length & 0xFF ) );
+  fout.put( static_cast< char >( length >> 8 ) );
+  fout.write( text.data(), text.size() );
+
+  for( int r = 0; r < image.rows; ++r )
+  {
+    fout.write( image.ptr< const char >( r ), image.cols * sizeof( float ) );
+  }
+
+  if( !fout )
+  {
+    throw std::runtime_error( "Unable to write " + filename );
+  }
+}
+
+// ---------------------------------------------------------------------------------------
+// Algorithm instances are not safe to share between threads, so each task borrows
+// one of these for its pair
+class algorithm_pool
+{
+public:
+  void add( kv::algo::compute_stereo_depth_map_sptr algo )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_idle.push_back( algo );
+  }
+
+  kv::algo::compute_stereo_depth_map_sptr acquire()
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    auto algo = m_idle.back();
+    m_idle.pop_back();
+    return algo;
+  }
+
+private:
+  std::mutex m_mutex;
+  std::vector< kv::algo::compute_stereo_depth_map_sptr > m_idle;
+};
+
+// ---------------------------------------------------------------------------------------
+// Compute one pair and write its outputs
+static void
+process_job( stereo_job const& job, algorithm_pool& algos, cv::Mat const& Q )
+{
+  auto algo = algos.acquire();
+
+  kv::image_container_sptr output;
+
+  try
+  {
+    output = algo->compute(
+      std::make_shared< ocv::image_container >( job.left, ocv::image_container::BGR_COLOR ),
+      std::make_shared< ocv::image_container >( job.right, ocv::image_container::BGR_COLOR ) );
+  }
+  catch( ... )
+  {
+    algos.add( algo );
+    throw;
+  }
+  algos.add( algo );
+
+  if( !output )
+  {
+    throw std::runtime_error( "No disparity computed for " + job.name );
+  }
+
+  cv::Mat raw = ocv::image_container::vital_to_ocv( output->get_image(),
+                                                    ocv::image_container::BGR_COLOR );
+
+  // Disparities in pixels, from either the float or the 4 fractional bit output
+  cv::Mat disparity;
+
+  if( raw.channels() > 1 )
+  {
+    throw std::runtime_error( "Disparity of " + job.name + " has several channels, "
+                              "disable set_disparity_as_alpha_chanel" );
+  }
+  else if( raw.depth() == CV_16S )
+  {
+    raw.convertTo( disparity, CV_32F, 1.0 / 16.0 );
+  }
+  else
+  {
+    raw.convertTo( disparity, CV_32F );
+  }
+
+  const std::string base =
+    ( filesystem::path( g_params.opt_output ) / job.name ).string();
+
+  if( g_params.opt_format == "png" )
+  {
+    // Same scale as the fixed-point disparities, invalid pixels are zero
+    cv::Mat fixed;
+    disparity.convertTo( fixed, CV_16U, 16.0 );
+    fixed.setTo( 0, disparity < 0 );
+
+    const std::vector< int > params = { cv::IMWRITE_PNG_COMPRESSION,
+                                        std::stoi( g_params.opt_png_compression ) };
+
+    if( !cv::imwrite( base + "_disparity.png", fixed, params ) )
+    {
+      throw std::runtime_error( "Unable to write " + base + "_disparity.png" );
+    }
+  }
+  else
+  {
+    write_npy( base + "_disparity.npy", disparity );
+  }
+
+  if( !Q.empty() )
+  {
+    cv::Mat points, depth;
+    cv::reprojectImageTo3D( disparity, points, Q, false, CV_32F );
+    cv::extractChannel( points, depth, 2 );
+    depth.setTo( std::numeric_limits< float >::quiet_NaN(), disparity <= 0 );
+
+    write_npy( base + "_depth.npy", depth );
+  }
+}
+
+/*                   _
+ *   _ __ ___   __ _(_)_ __
+ *  | '_ ` _ \ / _` | | '_ \
+ *  | | | | | | (_| | | | | |
+ *  |_| |_| |_|\__,_|_|_| |_|
+ *
+ */
+int
+main( int argc, char* argv[] )
+{
+  // Parse options
+  g_params.m_args.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  g_params.m_args.AddArgument( "--help",            argT::NO_ARGUMENT,
+    &g_params.opt_help, "Display usage information" );
+  g_params.m_args.AddArgument( "--config",          argT::SPACE_ARGUMENT,
+    &g_params.opt_config, "Optional configuration of the stereo algorithm, in a "
+    "block named stereo" );
+  g_params.m_args.AddArgument( "--algorithm",       argT::SPACE_ARGUMENT,
+    &g_params.opt_algorithm, "Stereo algorithm type when no config is given" );
+  g_params.m_args.AddArgument( "--cameras",         argT::SPACE_ARGUMENT,
+    &g_params.opt_cameras, "Directory of intrinsics.yml and extrinsics.yml, for "
+    "rectification and depth" );
+  g_params.m_args.AddArgument( "--left-list",       argT::SPACE_ARGUMENT,
+    &g_params.opt_left_list, "List of left images" );
+  g_params.m_args.AddArgument( "--right-list",      argT::SPACE_ARGUMENT,
+    &g_params.opt_right_list, "List of right images, paired with the left by line" );
+  g_params.m_args.AddArgument( "--input-list",      argT::SPACE_ARGUMENT,
+    &g_params.opt_input_list, "List of side-by-side stereo images, instead of "
+    "left and right lists" );
+  g_params.m_args.AddArgument( "--output",          argT::SPACE_ARGUMENT,
+    &g_params.opt_output, "Output directory" );
+  g_params.m_args.AddArgument( "--format",          argT::SPACE_ARGUMENT,
+    &g_params.opt_format, "Disparity output, png for 16-bit images in 1/16 pixel "
+    "units or npy for float pixel values" );
+  g_params.m_args.AddArgument( "--png-compression", argT::SPACE_ARGUMENT,
+    &g_params.opt_png_compression, "PNG compression level, 0 to 9" );
+  g_params.m_args.AddArgument( "--depth",           argT::NO_ARGUMENT,
+    &g_params.opt_depth, "Also write depth in npy files, using Q of the cameras" );
+  g_params.m_args.AddArgument( "--threads",         argT::SPACE_ARGUMENT,
+    &g_params.opt_threads, "Pairs computed at once, 0 for one per core" );
+  g_params.m_args.AddArgument( "--prefetch",        argT::SPACE_ARGUMENT,
+    &g_params.opt_prefetch, "Decoded pairs read ahead of the workers" );
+
+  // Parse args
+  if( !g_params.m_args.Parse() )
+  {
+    std::cerr << "Problem parsing arguments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Print help
+  if( argc == 1 || g_params.opt_help )
+  {
+    std::cout << "Usage: " << argv[0] << " [options]\n"
+              << "\nCompute disparities and depths for lists of stereo pairs.\n"
+              << g_params.m_args.GetHelp() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( g_params.opt_input_list.empty() ==
+      ( g_params.opt_left_list.empty() || g_params.opt_right_list.empty() ) )
+  {
+    std::cerr << "Give either --input-list or both --left-list and --right-list"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( g_params.opt_format != "png" && g_params.opt_format != "npy" )
+  {
+    std::cerr << "Invalid output format " << g_params.opt_format << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    std::vector< std::string > left, right;
+
+    if( g_params.opt_input_list.empty() )
+    {
+      left = read_list( g_params.opt_left_list );
+      right = read_list( g_params.opt_right_list );
+
+      if( left.size() != right.size() )
+      {
+        throw std::runtime_error( "Left and right lists differ in length" );
+      }
+    }
+    else
+    {
+      left = read_list( g_params.opt_input_list );
+    }
+
+    if( left.empty() )
+    {
+      throw std::runtime_error( "No stereo pairs given" );
+    }
+
+    filesystem::create_directories( g_params.opt_output );
+
+    // Load KWIVER plugins
+    kv::plugin_manager::instance().load_all_plugins();
+    kv::config_block_sptr config = kv::config_block::empty_config( "disparity_tool" );
+
+    if( !g_params.opt_config.empty() )
+    {
+      config->merge_config( kv::read_config_file( g_params.opt_config ) );
+    }
+    else
+    {
+      config->set_value( "stereo:type", g_params.opt_algorithm );
+    }
+
+    const std::string type = config->get_value< std::string >( "stereo:type" );
+    const std::string block = "stereo:" + type + ":";
+
+    if( !g_params.opt_cameras.empty() )
+    {
+      config->set_value( block + "cameras_directory", g_params.opt_cameras );
+    }
+
+    // All workers share one set of rectification maps, stored by the first pair
+    // and memory-mapped by the rest
+    if( type == "ocv_rectified_stereo_disparity_map" &&
+        config->get_value< std::string >( block + "rectification_cache_directory", "" ).empty() )
+    {
+      config->set_value( block + "rectification_cache_directory", g_params.opt_output );
+    }
+
+    cv::Mat Q;
+
+    if( g_params.opt_depth )
+    {
+      const std::string extrinsics = config->get_value< std::string >(
+        block + "cameras_directory", g_params.opt_cameras ) + "/extrinsics.yml";
+      cv::FileStorage fs( extrinsics, cv::FileStorage::READ );
+
+      if( !fs.isOpened() )
+      {
+        throw std::runtime_error( "Unable to read " + extrinsics );
+      }
+      fs[ "Q" ] >> Q;
+      Q.convertTo( Q, CV_64F );
+    }
+
+    viame::thread_pool workers( std::stoul( g_params.opt_threads ) );
+    algorithm_pool algos;
+
+    for( size_t i = 0; i < workers.size(); ++i )
+    {
+      kv::algo::compute_stereo_depth_map_sptr algo;
+      kv::algo::compute_stereo_depth_map::set_nested_algo_configuration(
+        "stereo", config, algo );
+
+      if( !algo )
+      {
+        throw std::runtime_error( "Unable to create stereo algorithm " + type );
+      }
+      algos.add( algo );
+    }
+
+    // Decode pairs on a background thread, bounded by the prefetch depth
+    viame::spsc_ring_buffer< stereo_job > prefetched(
+      std::max< size_t >( std::stoul( g_params.opt_prefetch ), 1 ) );
+
+    std::atomic< bool > cancel( false );
+    std::exception_ptr load_error;
+
+    std::thread loader( [&]
+    {
+      try
+      {
+        for( size_t i = 0; i < left.size() && !cancel; ++i )
+        {
+          stereo_job job;
+          job.index = i;
+          job.name = filesystem::path( left[i] ).stem().string();
+
+          cv::Mat image = cv::imread( left[i], cv::IMREAD_UNCHANGED );
+
+          if( image.empty() )
+          {
+            throw std::runtime_error( "Unable to read " + left[i] );
+          }
+
+          if( right.empty() )
+          {
+            job.left = image.colRange( 0, image.cols / 2 );
+            job.right = image.colRange( image.cols / 2, image.cols / 2 * 2 );
+          }
+          else
+          {
+            job.left = image;
+            job.right = cv::imread( right[i], cv::IMREAD_UNCHANGED );
+
+            if( job.right.empty() )
+            {
+              throw std::runtime_error( "Unable to read " + right[i] );
+            }
+          }
+          prefetched.wait_push( std::move( job ) );
+        }
+      }
+      catch( ... )
+      {
+        load_error = std::current_exception();
+      }
+
+      stereo_job end;
+      end.last = true;
+      prefetched.wait_push( std::move( end ) );
+    } );
+
+    std::deque< std::future< void > > pending;
+    const size_t max_pending = 2 * workers.size();
+    size_t done = 0;
+    bool loaded = false;
+
+    auto next_job = [&]
+    {
+      while( prefetched.empty() )
+      {
+        std::this_thread::yield();
+      }
+
+      stereo_job job = std::move( prefetched.front() );
+      prefetched.pop();
+      loaded = job.last;
+      return job;
+    };
+
+    try
+    {
+      while( true )
+      {
+        stereo_job job = next_job();
+
+        if( job.last )
+        {
+          break;
+        }
+
+        // The first pair computes the rectification alone, so the others find
+        // it in the cache instead of all computing their own
+        if( job.index == 0 )
+        {
+          process_job( job, algos, Q );
+          ++done;
+          continue;
+        }
+
+        pending.push_back( workers.enqueue( [ job = std::move( job ), &algos, &Q ]
+        {
+          process_job( job, algos, Q );
+        } ) );
+
+        while( pending.size() >= max_pending )
+        {
+          pending.front().get();
+          pending.pop_front();
+          ++done;
+        }
+      }
+
+      while( !pending.empty() )
+      {
+        pending.front().get();
+        pending.pop_front();
+        ++done;
+      }
+    }
+    catch( ... )
+    {
+      // Stop the loader and let running pairs finish before unwinding
+      cancel = true;
+
+      for( auto& p : pending )
+      {
+        p.wait();
+      }
+
+      while( !loaded )
+      {
+        next_job();
+      }
+      loader.join();
+      throw;
+    }
+
+    loader.join();
+
+    if( load_error )
+    {
+      std::rethrow_exception( load_error );
+    }
+
+    std::cout << "Computed " << done << " disparities" << std::endl;
+  }
+  catch( std::exception const& e )
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,272 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <kwiversys/CommandLineArguments.hxx>
+
+#include <vital/config/config_block.h>
+#include <vital/config/config_block_io.h>
+#include <vital/algo/detected_object_filter.h>
+#include <vital/algo/detected_object_set_input.h>
+#include <vital/algo/detected_object_set_output.h>
+#include <vital/types/detected_object_set.h>
+
+#include <plugins/core/plugin_manifest.h>
+
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace kv = kwiver::vital;
+
+// =======================================================================================
+// Class storing all input parameters for the tool
+class convert_vars
+{
+public:
+
+  // Collected command line args
+  kwiversys::CommandLineArguments m_args;
+
+  // Config options
+  bool opt_help = false;
+
+  std::string opt_config;
+  std::string opt_input;
+  std::string opt_output;
+  std::string opt_reader;
+  std::string opt_writer;
+  std::string opt_filter;
+  std::string opt_image_list;
+};
+
+static convert_vars g_params;
+
+// ---------------------------------------------------------------------------------------
+static std::vector< std::string >
+read_image_list( std::string const& filename )
+{
+  std::vector< std::string > output;
+  std::ifstream fin( filename );
+  std::string line;
+
+  if( !fin )
+  {
+    throw std::runtime_error( "Unable to open " + filename );
+  }
+
+  while( std::getline( fin, line ) )
+  {
+    if( !line.empty() && line.back() == '\r' )
+    {
+      line.pop_back();
+    }
+    if( !line.empty() )
+    {
+      output.push_back( line );
+    }
+  }
+  return output;
+}
+
+/*                   _
+ *   _ __ ___   __ _(_)_ __
+ *  | '_ ` _ \ / _` | | '_ \
+ *  | | | | | | (_| | | | | |
+ *  |_| |_| |_|\__,_|_|_| |_|
+ *
+ */
+int
+main( int argc, char* argv[] )
+{
+  // Parse options
+  g_params.m_args.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  g_params.m_args.AddArgument( "--help",       argT::NO_ARGUMENT,
+    &g_params.opt_help, "Display usage information" );
+  g_params.m_args.AddArgument( "--config",     argT::SPACE_ARGUMENT,
+    &g_params.opt_config, "Optional configuration with reader, writer and filter "
+    "algorithm blocks, such as the ones of the convert pipelines" );
+  g_params.m_args.AddArgument( "--input",      argT::SPACE_ARGUMENT,
+    &g_params.opt_input, "Input detection file" );
+  g_params.m_args.AddArgument( "--output",     argT::SPACE_ARGUMENT,
+    &g_params.opt_output, "Output detection file" );
+  g_params.m_args.AddArgument( "--reader",     argT::SPACE_ARGUMENT,
+    &g_params.opt_reader, "Reader type, such as viame_csv, kw18 or coco" );
+  g_params.m_args.AddArgument( "--writer",     argT::SPACE_ARGUMENT,
+    &g_params.opt_writer, "Writer type, such as viame_csv, kw18 or coco" );
+  g_params.m_args.AddArgument( "--filter",     argT::SPACE_ARGUMENT,
+    &g_params.opt_filter, "Optional detection filter type applied to every set" );
+  g_params.m_args.AddArgument( "--image-list", argT::SPACE_ARGUMENT,
+    &g_params.opt_image_list, "Optional list of image names to convert in order, "
+    "by default all sets of the input are converted in file order" );
+
+  // Parse args
+  if( !g_params.m_args.Parse() )
+  {
+    std::cerr << "Problem parsing arguments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Print help
+  if( argc == 1 || g_params.opt_help )
+  {
+    std::cout << "Usage: " << argv[0] << " [options]\n"
+              << "\nConvert detection files between formats without a pipeline.\n"
+              << g_params.m_args.GetHelp() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( g_params.opt_input.empty() || g_params.opt_output.empty() )
+  {
+    std::cerr << "Both --input and --output must be specified" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    kv::config_block_sptr config = kv::config_block::empty_config( "convert_tool" );
+
+    if( !g_params.opt_config.empty() )
+    {
+      config->merge_config( kv::read_config_file( g_params.opt_config ) );
+    }
+    if( !g_params.opt_reader.empty() )
+    {
+      config->set_value( "reader:type", g_params.opt_reader );
+    }
+    if( !g_params.opt_writer.empty() )
+    {
+      config->set_value( "writer:type", g_params.opt_writer );
+    }
+    if( !g_params.opt_filter.empty() )
+    {
+      config->set_value( "filter:type", g_params.opt_filter );
+    }
+
+    // Load only the plugins providing the configured types
+    std::vector< std::string > types;
+
+    for( auto const& key : config->available_values() )
+    {
+      if( key == "type" || ( key.size() > 5 && key.compare( key.size() - 5, 5, ":type" ) == 0 ) )
+      {
+        types.push_back( config->get_value< std::string >( key ) );
+      }
+    }
+    viame::load_plugins_for( types );
+
+    kv::algo::detected_object_set_input_sptr reader;
+    kv::algo::detected_object_set_output_sptr writer;
+    kv::algo::detected_object_filter_sptr filter;
+
+    kv::algo::detected_object_set_input::set_nested_algo_configuration(
+      "reader", config, reader );
+    kv::algo::detected_object_set_output::set_nested_algo_configuration(
+      "writer", config, writer );
+
+    if( config->has_value( "filter:type" ) )
+    {
+      kv::algo::detected_object_filter::set_nested_algo_configuration(
+        "filter", config, filter );
+    }
+
+    if( !reader || !writer )
+    {
+      throw std::runtime_error( "Unable to create the reader or writer, check "
+                                "their types" );
+    }
+
+    reader->open( g_params.opt_input );
+    writer->open( g_params.opt_output );
+
+    // Sets go straight from reader to writer, with no per-frame pipeline data
+    size_t sets = 0, detections = 0;
+
+    auto convert = [&]( kv::detected_object_set_sptr set, std::string const& name )
+    {
+      if( !set )
+      {
+        set = std::make_shared< kv::detected_object_set >();
+      }
+      if( filter )
+      {
+        set = filter->filter( set );
+      }
+
+      writer->write_set( set, name );
+
+      ++sets;
+      detections += set->size();
+    };
+
+    if( !g_params.opt_image_list.empty() )
+    {
+      for( auto name : read_image_list( g_params.opt_image_list ) )
+      {
+        kv::detected_object_set_sptr set;
+
+        if( !reader->read_set( set, name ) )
+        {
+          break;
+        }
+        convert( set, name );
+      }
+    }
+    else
+    {
+      kv::detected_object_set_sptr set;
+      std::string name;
+
+      while( reader->read_set( set, name ) )
+      {
+        convert( set, name );
+        name.clear();
+      }
+    }
+
+    writer->complete();
+    writer->close();
+    reader->close();
+
+    std::cout << "Converted " << detections << " detections in "
+              << sets << " sets" << std::endl;
+  }
+  catch( std::exception const& e )
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,712 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <kwiversys/CommandLineArguments.hxx>
+
+#include <plugins/core/homography_list_binary.h>
+#include <plugins/core/thread_pool.h>
+#include <plugins/core/tiled_tiff_writer.h>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// =======================================================================================
+// Class storing all input parameters for the tool
+class mosaic_vars
+{
+public:
+
+  // Collected command line args
+  kwiversys::CommandLineArguments m_args;
+
+  // Config options
+  bool opt_help = false;
+  bool opt_reverse = false;
+
+  std::string opt_output;
+  std::vector< std::string > opt_homographies;
+  std::vector< std::string > opt_images;
+  std::string opt_start = "0";
+  std::string opt_stop = "0";
+  std::string opt_step = "0";
+  std::string opt_frames = "0";
+  std::string opt_zoom = "1.0";
+  std::string opt_tile_size = "512";
+  std::string opt_levels = "0";
+  std::string opt_threads = "0";
+};
+
+static mosaic_vars g_params;
+
+// ---------------------------------------------------------------------------------------
+// One image to paste, with its mapping into mosaic pixel coordinates
+struct mosaic_frame
+{
+  std::string image;
+  std::string reference;
+  bool valid;
+  cv::Matx33d homography;
+
+  // Covered mosaic pixels, inclusive
+  double min_x, min_y, max_x, max_y;
+};
+
+// =======================================================================================
+// Read a list of write_homography_list_process, in its text or binary format
+static std::vector< mosaic_frame >
+read_homography_list( std::string const& filename )
+{
+  std::vector< mosaic_frame > output;
+  std::ifstream fin( filename, std::ios::binary );
+
+  if( !fin )
+  {
+    throw std::runtime_error( "Unable to open " + filename );
+  }
+
+  char magic[8] = { 0 };
+  fin.read( magic, sizeof( magic ) );
+
+  if( fin && std::string( magic, sizeof( magic ) ) == "VIAMEHOM" )
+  {
+    viame::homography_list_reader reader;
+    reader.open( filename );
+
+    for( size_t i = 0; i < reader.size(); ++i )
+    {
+      const viame::homography_list_record record = reader.record( i );
+
+      mosaic_frame frame;
+      frame.image = record.source;
+      frame.reference = record.dest;
+      frame.valid = record.valid;
+
+      for( int r = 0; r < 3; ++r )
+      {
+        for( int c = 0; c < 3; ++c )
+        {
+          frame.homography( r, c ) = record.homography( r, c );
+        }
+      }
+      output.push_back( frame );
+    }
+    return output;
+  }
+
+  fin.clear();
+  fin.seekg( 0 );
+
+  std::string line;
+
+  // Per-frame lines of a row-major matrix in Y, X order followed by the frame
+  // and reference numbers, as tools/create_mosaic.py reads
+  std::getline( fin, line );
+  {
+    std::stringstream tokens( line );
+    std::vector< double > numbers;
+    double value;
+
+    while( tokens >> value )
+    {
+      numbers.push_back( value );
+    }
+
+    if( numbers.size() == 11 && tokens.eof() )
+    {
+      const cv::Matx33d swap_xy( 0, 1, 0, 1, 0, 0, 0, 0, 1 );
+
+      do
+      {
+        std::stringstream row( line );
+        cv::Matx33d homography;
+        std::string from, to;
+
+        for( int i = 0; i < 9; ++i )
+        {
+          row >> homography( i / 3, i % 3 );
+        }
+
+        if( !( row >> from >> to ) )
+        {
+          continue;
+        }
+
+        mosaic_frame frame;
+        frame.image = from;
+        frame.reference = to;
+        frame.valid = true;
+        frame.homography = swap_xy * homography * swap_xy;
+        output.push_back( frame );
+      }
+      while( std::getline( fin, line ) );
+
+      return output;
+    }
+  }
+
+  // Text lists of write_homography_list_process hold blocks of source,
+  // destination and matrix rows or the no match string, separated by blank lines
+  fin.clear();
+  fin.seekg( 0 );
+
+  std::vector< std::string > block;
+
+  auto flush_block = [&]()
+  {
+    if( block.size() >= 2 )
+    {
+      mosaic_frame frame;
+      frame.image = block[0];
+      frame.reference = block[1];
+
+      std::stringstream values;
+      for( size_t i = 2; i < block.size(); ++i )
+      {
+        values << block[i] << ' ';
+      }
+
+      std::vector< double > numbers;
+      double value;
+      while( values >> value )
+      {
+        numbers.push_back( value );
+      }
+
+      frame.valid = ( numbers.size() == 9 );
+
+      for( int i = 0; i < 9; ++i )
+      {
+        frame.homography( i / 3, i % 3 ) =
+          frame.valid ? numbers[i] : ( i % 4 == 0 ? 1.0 : 0.0 );
+      }
+      output.push_back( frame );
+    }
+    block.clear();
+  };
+
+  while( std::getline( fin, line ) )
+  {
+    while( !line.empty() && ( line.back() == '\r' || line.back() == ' ' ) )
+    {
+      line.pop_back();
+    }
+
+    if( line.empty() )
+    {
+      flush_block();
+    }
+    else
+    {
+      block.push_back( line );
+    }
+  }
+  flush_block();
+
+  return output;
+}
+
+// ---------------------------------------------------------------------------------------
+static std::vector< std::string >
+read_image_list( std::string const& filename )
+{
+  std::vector< std::string > output;
+  std::ifstream fin( filename );
+  std::string line;
+
+  if( !fin )
+  {
+    throw std::runtime_error( "Unable to open " + filename );
+  }
+
+  while( std::getline( fin, line ) )
+  {
+    if( !line.empty() && line.back() == '\r' )
+    {
+      line.pop_back();
+    }
+    output.push_back( line );
+  }
+  return output;
+}
+
+// ---------------------------------------------------------------------------------------
+// Select frames as tools/create_mosaic.py does, interleaving cameras per frame
+static std::vector< mosaic_frame >
+select_frames( std::vector< std::vector< mosaic_frame > > cameras )
+{
+  const long long start = std::stoll( g_params.opt_start );
+  const long long stop = std::stoll( g_params.opt_stop );
+  const long long step = std::stoll( g_params.opt_step );
+  const long long frames = std::stoll( g_params.opt_frames );
+
+  if( ( frames > 0 ) == ( step > 0 ) )
+  {
+    throw std::runtime_error( "Exactly one of --frames and --step must be specified" );
+  }
+
+  size_t length = std::numeric_limits< size_t >::max();
+
+  for( auto& camera : cameras )
+  {
+    const size_t end = stop > 0 ? std::min< size_t >( stop, camera.size() ) : camera.size();
+    const size_t begin = std::min< size_t >( start, end );
+
+    camera = std::vector< mosaic_frame >( camera.begin() + begin, camera.begin() + end );
+    length = std::min( length, camera.size() );
+  }
+
+  if( length == 0 )
+  {
+    throw std::runtime_error( "No frames selected" );
+  }
+
+  std::vector< size_t > numbers;
+
+  if( frames > 0 )
+  {
+    for( long long i = 0; i < frames; ++i )
+    {
+      numbers.push_back( frames > 1 ? ( length - 1 ) * i / ( frames - 1 ) : 0 );
+    }
+  }
+  else
+  {
+    for( size_t i = 0; i < length; i += step )
+    {
+      numbers.push_back( i );
+    }
+  }
+
+  if( g_params.opt_reverse )
+  {
+    std::reverse( numbers.begin(), numbers.end() );
+    std::reverse( cameras.begin(), cameras.end() );
+  }
+
+  std::vector< mosaic_frame > output;
+
+  for( size_t n : numbers )
+  {
+    for( auto const& camera : cameras )
+    {
+      output.push_back( camera[n] );
+    }
+  }
+  return output;
+}
+
+// ---------------------------------------------------------------------------------------
+// Decoded images, loaded before the first tile row using them and released after
+// the last one, so only the frames overlapping one row of tiles are in memory
+class image_cache
+{
+public:
+  std::shared_ptr< const cv::Mat > get( size_t index ) const
+  {
+    return m_images.at( index );
+  }
+
+  void load( std::vector< mosaic_frame > const& frames,
+             std::vector< size_t > const& indices, viame::thread_pool& workers )
+  {
+    std::vector< std::pair< size_t, std::future< cv::Mat > > > loads;
+
+    for( size_t i : indices )
+    {
+      if( m_images.count( i ) == 0 )
+      {
+        loads.emplace_back( i, workers.enqueue( [&frames, i]
+        {
+          return cv::imread( frames[i].image, cv::IMREAD_COLOR );
+        } ) );
+      }
+    }
+
+    for( auto& load : loads )
+    {
+      cv::Mat image = load.second.get();
+
+      if( image.empty() )
+      {
+        throw std::runtime_error( "Unable to read " + frames[ load.first ].image );
+      }
+      m_images[ load.first ] = std::make_shared< const cv::Mat >( image );
+    }
+  }
+
+  void release_before( std::vector< mosaic_frame > const& frames, double y )
+  {
+    for( auto it = m_images.begin(); it != m_images.end(); )
+    {
+      it = ( frames[ it->first ].max_y < y ) ? m_images.erase( it ) : std::next( it );
+    }
+  }
+
+private:
+  std::map< size_t, std::shared_ptr< const cv::Mat > > m_images;
+};
+
+// ---------------------------------------------------------------------------------------
+static void
+render_tile( std::vector< mosaic_frame > const& frames, image_cache const& cache,
+             viame::tiled_tiff_writer& output, size_t tx, size_t ty )
+{
+  const int ts = static_cast< int >( output.tile_size() );
+  const double x0 = static_cast< double >( tx * ts );
+  const double y0 = static_cast< double >( ty * ts );
+
+  cv::Mat tile( ts, ts, CV_8UC3, cv::Scalar::all( 0 ) );
+
+  for( size_t i = 0; i < frames.size(); ++i )
+  {
+    mosaic_frame const& frame = frames[i];
+
+    if( frame.max_x < x0 || frame.min_x >= x0 + ts ||
+        frame.max_y < y0 || frame.min_y >= y0 + ts )
+    {
+      continue;
+    }
+
+    // Later frames are pasted over earlier ones where they have pixels
+    const cv::Matx33d to_tile( 1, 0, -x0, 0, 1, -y0, 0, 0, 1 );
+
+    cv::warpPerspective( *cache.get( i ), tile, cv::Mat( to_tile * frame.homography ),
+                         tile.size(), cv::INTER_LINEAR, cv::BORDER_TRANSPARENT );
+  }
+
+  cv::cvtColor( tile, tile, cv::COLOR_BGR2RGB );
+  output.write_tile( 0, tx, ty, tile.data );
+}
+
+// ---------------------------------------------------------------------------------------
+// Average 2x2 tiles of the previous level, read back from the output
+static void
+render_overview_tile( viame::tiled_tiff_writer& output, unsigned level,
+                      size_t tx, size_t ty )
+{
+  const int ts = static_cast< int >( output.tile_size() );
+
+  cv::Mat children( 2 * ts, 2 * ts, CV_8UC3, cv::Scalar::all( 0 ) );
+  cv::Mat child( ts, ts, CV_8UC3 );
+
+  for( size_t dy = 0; dy < 2; ++dy )
+  {
+    for( size_t dx = 0; dx < 2; ++dx )
+    {
+      const size_t cx = 2 * tx + dx, cy = 2 * ty + dy;
+
+      if( cx < output.tiles_x( level - 1 ) && cy < output.tiles_y( level - 1 ) )
+      {
+        output.read_tile( level - 1, cx, cy, child.data );
+        child.copyTo( children( cv::Rect( dx * ts, dy * ts, ts, ts ) ) );
+      }
+    }
+  }
+
+  cv::Mat tile;
+  cv::resize( children, tile, cv::Size( ts, ts ), 0, 0, cv::INTER_AREA );
+  output.write_tile( level, tx, ty, tile.data );
+}
+
+// ---------------------------------------------------------------------------------------
+static void
+wait_all( std::vector< std::future< void > >& futures )
+{
+  for( auto& future : futures )
+  {
+    future.wait();
+  }
+  for( auto& future : futures )
+  {
+    future.get();
+  }
+  futures.clear();
+}
+
+/*                   _
+ *   _ __ ___   __ _(_)_ __
+ *  | '_ ` _ \ / _` | | '_ \
+ *  | | | | | | (_| | | | | |
+ *  |_| |_| |_|\__,_|_|_| |_|
+ *
+ */
+int
+main( int argc, char* argv[] )
+{
+  // Parse options
+  g_params.m_args.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  g_params.m_args.AddArgument( "--help",         argT::NO_ARGUMENT,
+    &g_params.opt_help, "Display usage information" );
+  g_params.m_args.AddArgument( "--output",       argT::SPACE_ARGUMENT,
+    &g_params.opt_output, "Output tiled TIFF file" );
+  g_params.m_args.AddArgument( "--homographies", argT::SPACE_ARGUMENT,
+    &g_params.opt_homographies, "Homography list of one camera, may be repeated" );
+  g_params.m_args.AddArgument( "--images",       argT::SPACE_ARGUMENT,
+    &g_params.opt_images, "Optional image list for each homography list, one path "
+    "per line, instead of the source names stored in the list; needed for "
+    "the per-frame line format tools/create_mosaic.py reads" );
+  g_params.m_args.AddArgument( "--frames",       argT::SPACE_ARGUMENT,
+    &g_params.opt_frames, "Number of frames represented in output" );
+  g_params.m_args.AddArgument( "--start",        argT::SPACE_ARGUMENT,
+    &g_params.opt_start, "Ignore first N frames" );
+  g_params.m_args.AddArgument( "--stop",         argT::SPACE_ARGUMENT,
+    &g_params.opt_stop, "Ignore frames after the Nth" );
+  g_params.m_args.AddArgument( "--step",         argT::SPACE_ARGUMENT,
+    &g_params.opt_step, "Write every Nth frame" );
+  g_params.m_args.AddArgument( "--reverse",      argT::NO_ARGUMENT,
+    &g_params.opt_reverse, "Render images in reverse order" );
+  g_params.m_args.AddArgument( "--zoom",         argT::SPACE_ARGUMENT,
+    &g_params.opt_zoom, "Scale the output image by this factor" );
+  g_params.m_args.AddArgument( "--tile-size",    argT::SPACE_ARGUMENT,
+    &g_params.opt_tile_size, "Width and height of output tiles, a multiple of 16" );
+  g_params.m_args.AddArgument( "--levels",       argT::SPACE_ARGUMENT,
+    &g_params.opt_levels, "Pyramid levels including full resolution, 0 for all" );
+  g_params.m_args.AddArgument( "--threads",      argT::SPACE_ARGUMENT,
+    &g_params.opt_threads, "Worker threads, 0 for one per core" );
+
+  // Parse args
+  if( !g_params.m_args.Parse() )
+  {
+    std::cerr << "Problem parsing arguments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Print help
+  if( argc == 1 || g_params.opt_help )
+  {
+    std::cout << "Usage: " << argv[0] << " [options]\n"
+              << "\nPaste registered frames into a tiled, pyramidal TIFF mosaic.\n"
+              << g_params.m_args.GetHelp() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( g_params.opt_output.empty() || g_params.opt_homographies.empty() )
+  {
+    std::cerr << "Both --output and --homographies must be specified" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( !g_params.opt_images.empty() &&
+      g_params.opt_images.size() != g_params.opt_homographies.size() )
+  {
+    std::cerr << "Give either no --images or one per --homographies" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    std::vector< std::vector< mosaic_frame > > cameras;
+
+    for( size_t c = 0; c < g_params.opt_homographies.size(); ++c )
+    {
+      cameras.push_back( read_homography_list( g_params.opt_homographies[c] ) );
+
+      if( !g_params.opt_images.empty() )
+      {
+        const auto images = read_image_list( g_params.opt_images[c] );
+        cameras.back().resize( std::min( cameras.back().size(), images.size() ) );
+
+        for( size_t i = 0; i < cameras.back().size(); ++i )
+        {
+          cameras.back()[i].image = images[i];
+        }
+      }
+    }
+
+    std::vector< mosaic_frame > selected = select_frames( cameras );
+
+    // Homographies only share a coordinate frame while their reference is the same
+    const std::string reference = selected.front().reference;
+    std::vector< mosaic_frame > frames;
+
+    for( auto const& frame : selected )
+    {
+      if( !frame.valid )
+      {
+        std::cerr << "Skipping " << frame.image << ", it has no homography" << std::endl;
+      }
+      else if( frame.reference != reference )
+      {
+        std::cerr << "Skipping " << frame.image << ", its reference "
+                  << frame.reference << " is not " << reference << std::endl;
+      }
+      else
+      {
+        frames.push_back( frame );
+      }
+    }
+
+    if( frames.empty() )
+    {
+      throw std::runtime_error( "No frames with a homography selected" );
+    }
+
+    // Frames are assumed to share the size of the first one
+    const cv::Mat first = cv::imread( frames.front().image, cv::IMREAD_COLOR );
+
+    if( first.empty() )
+    {
+      throw std::runtime_error( "Unable to read " + frames.front().image );
+    }
+
+    const double zoom = std::stod( g_params.opt_zoom );
+    const cv::Matx33d scale( zoom, 0, 0, 0, zoom, 0, 0, 0, 1 );
+    const std::vector< cv::Point2d > corners = { { 0.0, 0.0 },
+      { first.cols - 1.0, 0.0 }, { 0.0, first.rows - 1.0 },
+      { first.cols - 1.0, first.rows - 1.0 } };
+
+    double min_x = 1.0e300, min_y = 1.0e300, max_x = -1.0e300, max_y = -1.0e300;
+
+    for( auto& frame : frames )
+    {
+      frame.homography = scale * frame.homography;
+      frame.min_x = frame.min_y = 1.0e300;
+      frame.max_x = frame.max_y = -1.0e300;
+
+      for( auto const& corner : corners )
+      {
+        const cv::Vec3d p = frame.homography * cv::Vec3d( corner.x, corner.y, 1.0 );
+
+        if( p[2] <= 0.0 )
+        {
+          throw std::runtime_error( "Homography of " + frame.image +
+                                    " maps the image across the horizon" );
+        }
+
+        frame.min_x = std::min( frame.min_x, p[0] / p[2] );
+        frame.min_y = std::min( frame.min_y, p[1] / p[2] );
+        frame.max_x = std::max( frame.max_x, p[0] / p[2] );
+        frame.max_y = std::max( frame.max_y, p[1] / p[2] );
+      }
+
+      min_x = std::min( min_x, frame.min_x );
+      min_y = std::min( min_y, frame.min_y );
+      max_x = std::max( max_x, frame.max_x );
+      max_y = std::max( max_y, frame.max_y );
+    }
+
+    // Shift the mosaic so that its upper left pixel is the origin
+    const double origin_x = std::floor( min_x ), origin_y = std::floor( min_y );
+    const cv::Matx33d shift( 1, 0, -origin_x, 0, 1, -origin_y, 0, 0, 1 );
+
+    for( auto& frame : frames )
+    {
+      frame.homography = shift * frame.homography;
+      frame.min_x -= origin_x;
+      frame.max_x -= origin_x;
+      frame.min_y -= origin_y;
+      frame.max_y -= origin_y;
+    }
+
+    const size_t width = static_cast< size_t >( std::ceil( max_x ) - origin_x ) + 1;
+    const size_t height = static_cast< size_t >( std::ceil( max_y ) - origin_y ) + 1;
+
+    viame::tiled_tiff_writer output( g_params.opt_output, width, height, 3,
+      std::stoul( g_params.opt_tile_size ), std::stoul( g_params.opt_levels ) );
+    viame::thread_pool workers( std::stoul( g_params.opt_threads ) );
+
+    std::cout << "Writing " << width << "x" << height << " mosaic of "
+              << frames.size() << " frames in " << output.levels()
+              << " levels" << std::endl;
+
+    // Full resolution, one row of tiles at a time
+    const double ts = static_cast< double >( output.tile_size() );
+    image_cache cache;
+    std::vector< std::future< void > > futures;
+
+    for( size_t ty = 0; ty < output.tiles_y( 0 ); ++ty )
+    {
+      std::vector< size_t > needed;
+
+      for( size_t i = 0; i < frames.size(); ++i )
+      {
+        if( frames[i].max_y >= ty * ts && frames[i].min_y < ( ty + 1 ) * ts )
+        {
+          needed.push_back( i );
+        }
+      }
+
+      cache.load( frames, needed, workers );
+
+      for( size_t tx = 0; tx < output.tiles_x( 0 ); ++tx )
+      {
+        futures.push_back( workers.enqueue( [&, tx, ty]
+        {
+          render_tile( frames, cache, output, tx, ty );
+        } ) );
+      }
+      wait_all( futures );
+
+      cache.release_before( frames, ( ty + 1 ) * ts );
+    }
+
+    // Each overview level only reads back the one before it
+    for( unsigned level = 1; level < output.levels(); ++level )
+    {
+      for( size_t ty = 0; ty < output.tiles_y( level ); ++ty )
+      {
+        for( size_t tx = 0; tx < output.tiles_x( level ); ++tx )
+        {
+          futures.push_back( workers.enqueue( [&, level, tx, ty]
+          {
+            render_overview_tile( output, level, tx, ty );
+          } ) );
+        }
+      }
+      wait_all( futures );
+    }
+
+    output.close();
+  }
+  catch( std::exception const& e )
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
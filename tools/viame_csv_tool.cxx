@@ -0,0 +1,853 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <kwiversys/CommandLineArguments.hxx>
+
+#include <plugins/core/csv_file_parser.h>
+#include <plugins/core/csv_row_buffer.h>
+#include <plugins/core/thread_pool.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if WIN32 || ( __cplusplus >= 201703L && __has_include(<filesystem>) )
+  #include <filesystem>
+  namespace filesystem = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+  #include <experimental/filesystem>
+  namespace filesystem = std::experimental::filesystem;
+#endif
+
+// =======================================================================================
+// Class storing all input parameters for the tool
+class csv_tool_vars
+{
+public:
+
+  // Collected command line args
+  kwiversys::CommandLineArguments m_args;
+
+  // Config options
+  bool opt_help = false;
+  bool opt_decrease_fid = false;
+  bool opt_increase_fid = false;
+  bool opt_assign_uid = false;
+  bool opt_filter_single = false;
+  bool opt_print_types = false;
+  bool opt_caps_only = false;
+  bool opt_track_count = false;
+  bool opt_counts_per_frame = false;
+  bool opt_average_box_size = false;
+  bool opt_print_filtered = false;
+  bool opt_print_single = false;
+  bool opt_print_fps = false;
+
+  std::string opt_input;
+  std::string opt_output;
+  std::string opt_merge;
+  std::string opt_replace_file;
+  std::string opt_conf_threshold = "-1.0";
+  std::string opt_type_threshold = "-1.0";
+  std::string opt_lower_fid = "0";
+  std::string opt_upper_fid = "0";
+  std::string opt_threads = "0";
+
+  // Parsed values
+  double conf_threshold = -1.0;
+  double type_threshold = -1.0;
+  long long lower_fid = 0;
+  long long upper_fid = 0;
+  bool write_output = false;
+  std::unordered_map< std::string, std::string > replacements;
+};
+
+static csv_tool_vars g_params;
+
+// =======================================================================================
+// Counts keyed by name which remember the order names were first seen in
+template< typename T >
+class ordered_counts
+{
+public:
+  T& operator[]( std::string_view name )
+  {
+    auto it = m_index.find( std::string( name ) );
+
+    if( it == m_index.end() )
+    {
+      it = m_index.emplace( std::string( name ), m_entries.size() ).first;
+      m_entries.emplace_back( it->first, T() );
+    }
+    return m_entries[ it->second ].second;
+  }
+
+  std::vector< std::pair< std::string, T > > const& entries() const { return m_entries; }
+
+private:
+  std::unordered_map< std::string, size_t > m_index;
+  std::vector< std::pair< std::string, T > > m_entries;
+};
+
+// ---------------------------------------------------------------------------------------
+// Everything one input file contributes, combined in input order afterwards
+struct file_result
+{
+  std::string log;
+  std::string output;
+  size_t assigned_id_count = 0;
+  size_t unique_id_count = 0;
+  size_t state_count = 0;
+  ordered_counts< size_t > type_counts;
+  ordered_counts< double > type_sizes;
+};
+
+// ---------------------------------------------------------------------------------------
+static double
+parse_fps( std::string_view line )
+{
+  const size_t pos = line.find( "fps" );
+
+  if( pos == std::string_view::npos )
+  {
+    return -1.0;
+  }
+
+  std::string value;
+  bool found_period = false;
+
+  for( size_t i = pos; i < line.size(); ++i )
+  {
+    if( std::isdigit( static_cast< unsigned char >( line[i] ) ) )
+    {
+      value += line[i];
+    }
+    else if( !value.empty() && line[i] == '.' && !found_period )
+    {
+      value += line[i];
+      found_period = true;
+    }
+    else if( !value.empty() )
+    {
+      break;
+    }
+  }
+
+  return value.empty() ? -1.0 : std::stod( value );
+}
+
+// ---------------------------------------------------------------------------------------
+static void
+load_replacements( std::string const& filename )
+{
+  std::ifstream fin( filename );
+
+  if( !fin )
+  {
+    throw std::runtime_error( "Replace file: " + filename + " does not exist" );
+  }
+
+  std::string line;
+  std::vector< std::string_view > fields;
+
+  while( std::getline( fin, line ) )
+  {
+    viame::csv_split_fields( line, ",", fields );
+
+    auto trim = []( std::string_view s )
+    {
+      while( !s.empty() && std::isspace( static_cast< unsigned char >( s.back() ) ) )
+      {
+        s.remove_suffix( 1 );
+      }
+      return std::string( s );
+    };
+
+    if( fields.size() > 1 )
+    {
+      g_params.replacements[ trim( fields[0] ) ] = trim( fields[1] );
+    }
+    else if( !trim( line ).empty() )
+    {
+      std::cerr << "Error parsing line: " << line << std::endl;
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------------------
+// Apply every filter and edit to one file in a single pass over its mapped contents.
+// Unique ids are numbered from first_uid, the output text is only kept if write is set.
+static file_result
+process_file( std::string const& input_file, long long first_uid, bool write,
+              bool keep_headers )
+{
+  file_result result;
+  std::ostringstream log;
+
+  if( !g_params.opt_print_single )
+  {
+    if( g_params.opt_counts_per_frame )
+    {
+      log << "# " << filesystem::path( input_file ).filename().string() << "\n";
+    }
+    else if( g_params.opt_print_fps )
+    {
+      log << input_file << ",";
+    }
+    else
+    {
+      log << "Processing " << input_file << "\n";
+    }
+  }
+
+  std::ifstream stream( input_file );
+
+  if( !stream )
+  {
+    throw std::runtime_error( "Unable to open " + input_file );
+  }
+
+  viame::csv_file_view file( input_file, stream );
+  std::string_view data = file.data();
+
+  // Kept lines, as field views into the file or into edited values, along with their
+  // original id or an empty view for header lines
+  std::vector< std::vector< std::string_view > > rows;
+  std::vector< std::string_view > row_ids;
+  std::deque< std::string > edited;
+
+  std::unordered_map< std::string_view, size_t > id_states;
+  std::unordered_map< std::string_view, long long > id_mappings;
+  std::unordered_set< std::string_view > unique_ids;
+  std::unordered_set< std::string_view > printed_ids;
+  ordered_counts< ordered_counts< size_t > > frame_counts;
+  bool contains_track = false;
+  bool has_non_single = false;
+  double video_fps = 0.0;
+  long long next_uid = first_uid;
+
+  std::vector< std::string_view > fields;
+
+  auto print_filtered = [&]( std::string_view id )
+  {
+    if( g_params.opt_print_filtered && printed_ids.insert( id ).second )
+    {
+      log << "Id: " << id << " filtered\n";
+    }
+  };
+
+  auto edit = [&]( std::string value ) -> std::string_view
+  {
+    edited.push_back( std::move( value ) );
+    return edited.back();
+  };
+
+  size_t position = 0;
+
+  while( position < data.size() )
+  {
+    size_t end = data.find( '\n', position );
+    end = ( end == std::string_view::npos ? data.size() : end );
+
+    std::string_view line = data.substr( position, end - position );
+    position = end + 1;
+
+    if( !line.empty() && ( line[0] == '#' || viame::csv_starts_with( line, "target_id" ) ) )
+    {
+      if( g_params.opt_print_fps && line.find( "fps" ) != std::string_view::npos )
+      {
+        video_fps = parse_fps( line );
+      }
+      while( !line.empty() && ( line.back() == '\r' ) )
+      {
+        line.remove_suffix( 1 );
+      }
+      if( write && keep_headers )
+      {
+        rows.push_back( { line } );
+        row_ids.emplace_back();
+      }
+      continue;
+    }
+
+    while( !line.empty() && std::isspace( static_cast< unsigned char >( line.back() ) ) )
+    {
+      line.remove_suffix( 1 );
+    }
+
+    viame::csv_split_fields( line, ",", fields );
+
+    if( fields.size() < 2 )
+    {
+      continue;
+    }
+
+    if( g_params.conf_threshold > 0 && fields.size() > 7 &&
+        viame::csv_to_double( fields[7] ) < g_params.conf_threshold )
+    {
+      print_filtered( fields[0] );
+      continue;
+    }
+
+    if( g_params.opt_track_count )
+    {
+      result.state_count++;
+
+      if( !unique_ids.insert( fields[0] ).second )
+      {
+        contains_track = true;
+      }
+    }
+
+    if( g_params.opt_decrease_fid || g_params.opt_increase_fid || g_params.lower_fid > 0 ||
+        g_params.upper_fid > 0 )
+    {
+      long long fid = viame::csv_to_int( fields[2] );
+
+      fid += ( g_params.opt_increase_fid ? 1 : 0 ) - ( g_params.opt_decrease_fid ? 1 : 0 );
+
+      if( g_params.lower_fid > 0 )
+      {
+        if( fid < g_params.lower_fid )
+        {
+          continue;
+        }
+        fid -= g_params.lower_fid;
+      }
+
+      if( g_params.upper_fid > 0 && fid > g_params.upper_fid - g_params.lower_fid )
+      {
+        continue;
+      }
+
+      fields[2] = edit( std::to_string( fid ) );
+    }
+
+    const std::string_view original_id = fields[0];
+
+    if( g_params.opt_filter_single && ++id_states[ original_id ] > 1 )
+    {
+      has_non_single = true;
+    }
+
+    if( fields.size() > 9 )
+    {
+      std::string_view top_category;
+      double top_score = -100.0;
+      size_t attr_start = 0;
+
+      for( size_t i = 9; i < fields.size(); i += 2 )
+      {
+        if( fields[i].empty() )
+        {
+          continue;
+        }
+        if( fields[i][0] == '(' )
+        {
+          attr_start = i;
+          break;
+        }
+
+        const double score = i + 1 < fields.size() ?
+          viame::csv_to_double( fields[i+1] ) : 0.0;
+
+        if( score > top_score )
+        {
+          top_category = fields[i];
+          top_score = score;
+        }
+      }
+
+      if( g_params.type_threshold > 0 && top_score < g_params.type_threshold )
+      {
+        print_filtered( fields[0] );
+        continue;
+      }
+
+      if( g_params.opt_print_types || g_params.opt_average_box_size )
+      {
+        result.type_counts[ top_category ]++;
+      }
+
+      if( g_params.opt_counts_per_frame )
+      {
+        frame_counts[ fields[1] ][ top_category ]++;
+      }
+
+      if( g_params.opt_average_box_size )
+      {
+        const double width =
+          viame::csv_to_double( fields[5] ) - viame::csv_to_double( fields[3] );
+        const double height =
+          viame::csv_to_double( fields[6] ) - viame::csv_to_double( fields[4] );
+
+        result.type_sizes[ top_category ] += width * height;
+      }
+
+      if( !g_params.opt_replace_file.empty() )
+      {
+        auto it = g_params.replacements.find( std::string( top_category ) );
+
+        std::vector< std::string_view > replaced( fields.begin(), fields.begin() + 9 );
+        replaced.push_back( it != g_params.replacements.end() ?
+          std::string_view( it->second ) : top_category );
+        replaced.push_back( "1.0" );
+
+        if( attr_start > 0 )
+        {
+          replaced.insert( replaced.end(), fields.begin() + attr_start, fields.end() );
+        }
+        fields.swap( replaced );
+      }
+    }
+
+    if( g_params.opt_assign_uid )
+    {
+      auto it = id_mappings.find( fields[0] );
+
+      if( it == id_mappings.end() )
+      {
+        id_mappings.emplace( original_id, next_uid );
+        fields[0] = edit( std::to_string( next_uid++ ) );
+      }
+      else
+      {
+        fields[0] = edit( std::to_string( it->second ) );
+        has_non_single = true;
+      }
+    }
+
+    if( write )
+    {
+      rows.push_back( fields );
+      row_ids.push_back( original_id );
+    }
+  }
+
+  result.assigned_id_count = id_mappings.size();
+  result.unique_id_count = unique_ids.size();
+
+  if( g_params.opt_print_fps )
+  {
+    if( video_fps > 0 )
+    {
+      log << video_fps << "\n";
+    }
+    else
+    {
+      log << "unlisted\n";
+    }
+  }
+
+  if( ( g_params.opt_assign_uid || g_params.opt_filter_single ) && !has_non_single )
+  {
+    log << "Sequence " << input_file << " has all single states\n";
+  }
+
+  if( g_params.opt_print_single && !contains_track )
+  {
+    log << "Sequence " << input_file << " contains "
+        << ( unique_ids.empty() ? "no detections" : "only detections" ) << "\n";
+  }
+
+  if( g_params.opt_counts_per_frame )
+  {
+    for( auto const& frame : frame_counts.entries() )
+    {
+      log << frame.first;
+
+      for( auto const& cls : frame.second.entries() )
+      {
+        log << ", " << cls.first << "=" << cls.second;
+      }
+      log << "\n";
+    }
+  }
+
+  if( write )
+  {
+    viame::csv_row_buffer buffer;
+    std::ostringstream output;
+
+    for( size_t r = 0; r < rows.size(); ++r )
+    {
+      auto const& row = rows[r];
+
+      // Single states are judged on the id column before any renumbering
+      if( g_params.opt_filter_single && !row_ids[r].empty() &&
+          id_states[ row_ids[r] ] <= 1 )
+      {
+        continue;
+      }
+
+      for( size_t i = 0; i < row.size(); ++i )
+      {
+        if( i > 0 )
+        {
+          buffer << ',';
+        }
+        buffer << row[i];
+      }
+      buffer.end_row( output );
+    }
+
+    buffer.flush( output );
+    result.output = output.str();
+  }
+
+  result.log = log.str();
+  return result;
+}
+
+// ---------------------------------------------------------------------------------------
+static std::vector< std::string >
+list_input_files( std::string const& input )
+{
+  std::vector< std::string > output;
+
+  if( filesystem::is_directory( input ) )
+  {
+    for( auto const& entry : filesystem::recursive_directory_iterator( input ) )
+    {
+      if( entry.is_regular_file() && entry.path().extension() == ".csv" )
+      {
+        output.push_back( entry.path().string() );
+      }
+    }
+    std::sort( output.begin(), output.end() );
+  }
+  else if( input.find( '*' ) != std::string::npos )
+  {
+    // Glob on the file name part of the pattern only
+    const filesystem::path pattern( input );
+    const filesystem::path folder =
+      pattern.has_parent_path() ? pattern.parent_path() : filesystem::path( "." );
+
+    std::string expr;
+
+    for( char c : pattern.filename().string() )
+    {
+      if( c == '*' )
+      {
+        expr += ".*";
+      }
+      else if( c == '?' )
+      {
+        expr += '.';
+      }
+      else if( std::string( "\\^$.|+()[]{}" ).find( c ) != std::string::npos )
+      {
+        expr += std::string( "\\" ) + c;
+      }
+      else
+      {
+        expr += c;
+      }
+    }
+
+    const std::regex matcher( expr );
+
+    for( auto const& entry : filesystem::directory_iterator( folder ) )
+    {
+      if( std::regex_match( entry.path().filename().string(), matcher ) )
+      {
+        output.push_back( entry.path().string() );
+      }
+    }
+    std::sort( output.begin(), output.end() );
+  }
+  else
+  {
+    output.push_back( input );
+  }
+
+  return output;
+}
+
+// ---------------------------------------------------------------------------------------
+static std::string
+output_path( std::string const& input_file )
+{
+  if( g_params.opt_output.empty() )
+  {
+    return input_file;
+  }
+  if( filesystem::is_directory( g_params.opt_output ) )
+  {
+    return ( filesystem::path( g_params.opt_output ) /
+             filesystem::path( input_file ).filename() ).string();
+  }
+  return g_params.opt_output;
+}
+
+/*                   _
+ *   _ __ ___   __ _(_)_ __
+ *  | '_ ` _ \ / _` | | '_ \
+ *  | | | | | | (_| | | | | |
+ *  |_| |_| |_|\__,_|_|_| |_|
+ *
+ */
+int
+main( int argc, char* argv[] )
+{
+  // Parse options
+  g_params.m_args.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  g_params.m_args.AddArgument( "--help",             argT::NO_ARGUMENT,
+    &g_params.opt_help, "Display usage information" );
+  g_params.m_args.AddArgument( "-i",                 argT::SPACE_ARGUMENT,
+    &g_params.opt_input, "Input file, folder or glob pattern to process" );
+  g_params.m_args.AddArgument( "-o",                 argT::SPACE_ARGUMENT,
+    &g_params.opt_output, "Output file or folder, instead of editing inputs in place" );
+  g_params.m_args.AddArgument( "--merge",            argT::SPACE_ARGUMENT,
+    &g_params.opt_merge, "Write all processed inputs into this single file" );
+  g_params.m_args.AddArgument( "--decrease-fid",     argT::NO_ARGUMENT,
+    &g_params.opt_decrease_fid, "Decrease frame IDs in files by 1" );
+  g_params.m_args.AddArgument( "--increase-fid",     argT::NO_ARGUMENT,
+    &g_params.opt_increase_fid, "Increase frame IDs in files by 1" );
+  g_params.m_args.AddArgument( "--assign-uid",       argT::NO_ARGUMENT,
+    &g_params.opt_assign_uid, "Assign unique detection ids to all entries in volume" );
+  g_params.m_args.AddArgument( "--filter-single",    argT::NO_ARGUMENT,
+    &g_params.opt_filter_single, "Filter single state tracks" );
+  g_params.m_args.AddArgument( "--print-types",      argT::NO_ARGUMENT,
+    &g_params.opt_print_types, "Print unique list of target types" );
+  g_params.m_args.AddArgument( "--caps-only",        argT::NO_ARGUMENT,
+    &g_params.opt_caps_only, "Only print types with capitalized letters in them" );
+  g_params.m_args.AddArgument( "--track-count",      argT::NO_ARGUMENT,
+    &g_params.opt_track_count, "Print total number of tracks" );
+  g_params.m_args.AddArgument( "--counts-per-frame", argT::NO_ARGUMENT,
+    &g_params.opt_counts_per_frame, "Print total number of detections per frame" );
+  g_params.m_args.AddArgument( "--average-box-size", argT::NO_ARGUMENT,
+    &g_params.opt_average_box_size, "Print average box size per type" );
+  g_params.m_args.AddArgument( "--conf-threshold",   argT::SPACE_ARGUMENT,
+    &g_params.opt_conf_threshold, "Detection confidence threshold" );
+  g_params.m_args.AddArgument( "--type-threshold",   argT::SPACE_ARGUMENT,
+    &g_params.opt_type_threshold, "Top type confidence threshold" );
+  g_params.m_args.AddArgument( "--print-filtered",   argT::NO_ARGUMENT,
+    &g_params.opt_print_filtered, "Print out tracks that were filtered out" );
+  g_params.m_args.AddArgument( "--print-single",     argT::NO_ARGUMENT,
+    &g_params.opt_print_single, "Print out video sequences only containing single states" );
+  g_params.m_args.AddArgument( "--lower-fid",        argT::SPACE_ARGUMENT,
+    &g_params.opt_lower_fid, "Lower FID if adjusting FIDs to be within some range" );
+  g_params.m_args.AddArgument( "--upper-fid",        argT::SPACE_ARGUMENT,
+    &g_params.opt_upper_fid, "Upper FID if adjusting FIDs to be within some range" );
+  g_params.m_args.AddArgument( "--replace-file",     argT::SPACE_ARGUMENT,
+    &g_params.opt_replace_file, "If set, replace all types in this file given their synonyms" );
+  g_params.m_args.AddArgument( "--print-fps",        argT::NO_ARGUMENT,
+    &g_params.opt_print_fps, "Print FPS in input files" );
+  g_params.m_args.AddArgument( "--threads",          argT::SPACE_ARGUMENT,
+    &g_params.opt_threads, "Files processed concurrently, 0 for one per core" );
+
+  // Parse args
+  if( !g_params.m_args.Parse() )
+  {
+    std::cerr << "Problem parsing arguments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Print help
+  if( argc == 1 || g_params.opt_help )
+  {
+    std::cout << "Usage: " << argv[0] << " [options]\n"
+              << "\nPerform filtering and conversion actions on viame_csv files.\n"
+              << g_params.m_args.GetHelp() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( g_params.opt_input.empty() )
+  {
+    std::cout << "No valid input files provided, exiting." << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  try
+  {
+    g_params.conf_threshold = std::stod( g_params.opt_conf_threshold );
+    g_params.type_threshold = std::stod( g_params.opt_type_threshold );
+    g_params.lower_fid = std::stoll( g_params.opt_lower_fid );
+    g_params.upper_fid = std::stoll( g_params.opt_upper_fid );
+
+    if( g_params.opt_caps_only )
+    {
+      g_params.opt_print_types = true;
+    }
+    if( g_params.opt_print_single )
+    {
+      g_params.opt_track_count = true;
+    }
+    if( !g_params.opt_replace_file.empty() )
+    {
+      load_replacements( g_params.opt_replace_file );
+    }
+
+    g_params.write_output = g_params.opt_filter_single || g_params.opt_increase_fid ||
+      g_params.opt_decrease_fid || g_params.opt_assign_uid ||
+      !g_params.opt_replace_file.empty() || g_params.lower_fid || g_params.upper_fid ||
+      !g_params.opt_output.empty() || !g_params.opt_merge.empty();
+
+    const std::vector< std::string > input_files = list_input_files( g_params.opt_input );
+    viame::thread_pool workers( std::stoul( g_params.opt_threads ) );
+
+    // Unique ids continue across files, so each file's first id needs the counts of the
+    // files before it, taken from a first pass which writes nothing
+    std::vector< long long > first_uids( input_files.size(), 1 );
+
+    if( g_params.opt_assign_uid && input_files.size() > 1 )
+    {
+      std::vector< std::future< size_t > > counts;
+
+      for( auto const& input_file : input_files )
+      {
+        counts.push_back( workers.enqueue( [&input_file]
+        {
+          return process_file( input_file, 1, false, false ).assigned_id_count;
+        } ) );
+      }
+      for( size_t i = 1; i < input_files.size(); ++i )
+      {
+        first_uids[i] = first_uids[i-1] + counts[i-1].get();
+      }
+    }
+
+    std::vector< std::future< file_result > > results;
+
+    for( size_t i = 0; i < input_files.size(); ++i )
+    {
+      results.push_back( workers.enqueue( [&input_files, &first_uids, i]
+      {
+        // Merged outputs keep the header lines of the first file only
+        return process_file( input_files[i], first_uids[i], g_params.write_output,
+                             g_params.opt_merge.empty() || i == 0 );
+      } ) );
+    }
+
+    std::ofstream merged;
+
+    if( !g_params.opt_merge.empty() )
+    {
+      merged.open( g_params.opt_merge );
+
+      if( !merged )
+      {
+        throw std::runtime_error( "Unable to open " + g_params.opt_merge );
+      }
+    }
+
+    size_t track_counter = 0;
+    size_t state_counter = 0;
+    ordered_counts< size_t > type_counts;
+    ordered_counts< double > type_sizes;
+
+    // Results are combined in input order, while later files are still processed
+    for( size_t i = 0; i < input_files.size(); ++i )
+    {
+      file_result result = results[i].get();
+
+      std::cout << result.log << std::flush;
+
+      if( merged.is_open() )
+      {
+        merged << result.output;
+      }
+      else if( g_params.write_output )
+      {
+        std::ofstream fout( output_path( input_files[i] ) );
+        fout << result.output;
+      }
+
+      if( g_params.opt_track_count )
+      {
+        track_counter += result.unique_id_count;
+      }
+      state_counter += result.state_count;
+
+      for( auto const& entry : result.type_counts.entries() )
+      {
+        type_counts[ entry.first ] += entry.second;
+      }
+      for( auto const& entry : result.type_sizes.entries() )
+      {
+        type_sizes[ entry.first ] += entry.second;
+      }
+    }
+
+    if( g_params.opt_track_count )
+    {
+      std::cout << "Track count: " << track_counter << " , states = "
+                << state_counter << std::endl;
+    }
+
+    if( g_params.opt_print_types )
+    {
+      std::cout << "\nTypes found in files:\n" << std::endl;
+
+      for( auto const& entry : type_counts.entries() )
+      {
+        if( !g_params.opt_caps_only ||
+            std::any_of( entry.first.begin(), entry.first.end(),
+              []( char c ){ return std::isupper( static_cast< unsigned char >( c ) ); } ) )
+        {
+          std::cout << entry.first << std::endl;
+        }
+      }
+    }
+
+    if( g_params.opt_average_box_size )
+    {
+      std::cout << "Type - Average Box Area - Total Count" << std::endl;
+
+      for( auto const& entry : type_sizes.entries() )
+      {
+        const size_t count = type_counts[ entry.first ];
+        std::cout << entry.first << " " << entry.second / count << " "
+                  << count << std::endl;
+      }
+    }
+  }
+  catch( std::exception const& e )
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,734 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Extract track state chips for tracker training into shards
+ *
+ * Track groundtruth is indexed by frame, so that every frame is decoded once
+ * and all of its track state chips are cut from it together, with frames
+ * processed in parallel. Chips are written grouped by track into the fixed
+ * layout, memory-mapped shards of track_chip_shards.h.
+ */
+
+#include <kwiversys/CommandLineArguments.hxx>
+
+#include <vital/algo/image_io.h>
+#include <vital/config/config_block.h>
+#include <vital/config/config_block_io.h>
+#include <vital/types/image_container.h>
+
+#include <plugins/core/csv_file_parser.h>
+#include <plugins/core/plugin_manifest.h>
+#include <plugins/core/thread_pool.h>
+#include <plugins/core/track_chip_shards.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if WIN32 || ( __cplusplus >= 201703L && __has_include(<filesystem>) )
+  #include <filesystem>
+  namespace filesystem = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+  #include <experimental/filesystem>
+  namespace filesystem = std::experimental::filesystem;
+#endif
+
+namespace kv = kwiver::vital;
+
+// =======================================================================================
+// Class storing all input parameters for the tool
+class track_chip_vars
+{
+public:
+
+  // Collected command line args
+  kwiversys::CommandLineArguments m_args;
+
+  // Config options
+  bool opt_help = false;
+
+  std::string opt_config;
+  std::string opt_input;
+  std::string opt_output;
+  std::string opt_groundtruth;
+  std::string opt_reader = "ocv";
+  std::string opt_chip_size = "255";
+  std::string opt_context = "0.5";
+  std::string opt_search_scale = "2.0";
+  std::string opt_shard_size = "1024";
+  std::string opt_threads = "0";
+
+  // Parsed values
+  unsigned chip_size = 255;
+  double context = 0.5;
+  double search_scale = 2.0;
+  std::uint64_t shard_bytes = 0;
+};
+
+static track_chip_vars g_params;
+
+// Chips are always written with three channels, gray frames being replicated
+static const unsigned chip_channels = 3;
+
+// ---------------------------------------------------------------------------------------
+// One track state of the groundtruth
+struct track_state
+{
+  std::int64_t track_id;
+  std::int64_t frame_id;
+  double box[4];
+  std::size_t frame;
+};
+
+// ---------------------------------------------------------------------------------------
+// Location of a chip, by shard and chip index within it
+struct chip_slot
+{
+  std::size_t shard;
+  std::size_t chip;
+};
+
+// ---------------------------------------------------------------------------------------
+// Image readers, one per concurrently decoded frame
+class reader_pool
+{
+public:
+  reader_pool( kv::config_block_sptr config, size_t count )
+  {
+    for( size_t i = 0; i < count; ++i )
+    {
+      kv::algo::image_io_sptr reader;
+      kv::algo::image_io::set_nested_algo_configuration( "image_reader", config, reader );
+
+      if( !reader )
+      {
+        throw std::runtime_error( "Unable to create image reader, check its type" );
+      }
+      m_free.push_back( reader );
+    }
+  }
+
+  kv::algo::image_io_sptr acquire()
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    kv::algo::image_io_sptr reader = m_free.back();
+    m_free.pop_back();
+    return reader;
+  }
+
+  void release( kv::algo::image_io_sptr reader )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_free.push_back( reader );
+  }
+
+private:
+  std::mutex m_mutex;
+  std::vector< kv::algo::image_io_sptr > m_free;
+};
+
+// ---------------------------------------------------------------------------------------
+static bool
+is_image_file( filesystem::path const& path )
+{
+  std::string ext = path.extension().string();
+
+  std::transform( ext.begin(), ext.end(), ext.begin(),
+    []( unsigned char c ){ return static_cast< char >( std::tolower( c ) ); } );
+
+  return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tif" ||
+         ext == ".tiff" || ext == ".bmp" || ext == ".sgi";
+}
+
+// ---------------------------------------------------------------------------------------
+// Name of a folder, also when given with a trailing separator
+static std::string
+folder_name( filesystem::path const& folder )
+{
+  return folder.has_filename() ? folder.filename().string() :
+                                 folder.parent_path().filename().string();
+}
+
+// ---------------------------------------------------------------------------------------
+// Groundtruth file of a sequence folder, if it has one
+static std::string
+find_groundtruth( filesystem::path const& folder )
+{
+  if( !g_params.opt_groundtruth.empty() )
+  {
+    const filesystem::path file = folder / g_params.opt_groundtruth;
+    return filesystem::exists( file ) ? file.string() : std::string();
+  }
+
+  std::vector< std::string > candidates;
+
+  for( auto const& entry : filesystem::directory_iterator( folder ) )
+  {
+    if( entry.is_regular_file() && entry.path().extension() == ".csv" )
+    {
+      candidates.push_back( entry.path().string() );
+    }
+  }
+
+  std::sort( candidates.begin(), candidates.end() );
+  return candidates.empty() ? std::string() : candidates.front();
+}
+
+// ---------------------------------------------------------------------------------------
+// Read the track states of a viame_csv file, with the frame index it refers to
+static std::vector< track_state >
+read_track_states( std::string const& csv_file, filesystem::path const& folder,
+                   std::vector< std::string >& frames )
+{
+  std::vector< std::string > folder_images;
+
+  for( auto const& entry : filesystem::directory_iterator( folder ) )
+  {
+    if( entry.is_regular_file() && is_image_file( entry.path() ) )
+    {
+      folder_images.push_back( entry.path().string() );
+    }
+  }
+  std::sort( folder_images.begin(), folder_images.end() );
+
+  std::ifstream fin( csv_file, std::ios::binary );
+
+  if( !fin )
+  {
+    throw std::runtime_error( "Unable to open " + csv_file );
+  }
+
+  viame::csv_file_view view( csv_file, fin );
+  viame::csv_line_parser parser( view.data() );
+
+  std::vector< track_state > states;
+  std::unordered_map< std::string, std::size_t > frame_ids;
+
+  while( parser.next() )
+  {
+    auto const& fields = parser.fields();
+
+    if( fields.size() < 7 ||
+        !std::isdigit( static_cast< unsigned char >( fields[0].empty() ? 'x' : fields[0][0] ) ) )
+    {
+      continue;
+    }
+
+    track_state state;
+    state.track_id = viame::csv_to_int( fields[0] );
+    state.frame_id = viame::csv_to_int( fields[2] );
+
+    for( unsigned i = 0; i < 4; ++i )
+    {
+      state.box[i] = viame::csv_to_double( fields[ 3 + i ] );
+    }
+
+    // Image names are tried against the sequence folder, then frame ids index
+    // the sorted images of the folder
+    const std::string name( fields[1] );
+    std::string image;
+
+    if( !name.empty() )
+    {
+      const filesystem::path path( name );
+
+      if( path.is_absolute() && filesystem::exists( path ) )
+      {
+        image = path.string();
+      }
+      else if( filesystem::exists( folder / path ) )
+      {
+        image = ( folder / path ).string();
+      }
+      else if( filesystem::exists( folder / path.filename() ) )
+      {
+        image = ( folder / path.filename() ).string();
+      }
+    }
+    if( image.empty() && state.frame_id >= 0 &&
+        state.frame_id < static_cast< std::int64_t >( folder_images.size() ) )
+    {
+      image = folder_images[ state.frame_id ];
+    }
+    if( image.empty() )
+    {
+      std::cerr << "Warning: no image found for frame " << state.frame_id
+                << " of " << csv_file << std::endl;
+      continue;
+    }
+
+    auto it = frame_ids.find( image );
+
+    if( it == frame_ids.end() )
+    {
+      it = frame_ids.emplace( image, frames.size() ).first;
+      frames.push_back( image );
+    }
+
+    state.frame = it->second;
+    states.push_back( state );
+  }
+
+  return states;
+}
+
+// ---------------------------------------------------------------------------------------
+// Square region around a track box, with context in the style of SiamFC crops
+static void
+chip_region( const double box[4], double region[4] )
+{
+  const double w = box[2] - box[0];
+  const double h = box[3] - box[1];
+  const double pad = g_params.context * ( w + h );
+  const double side = std::sqrt( ( w + pad ) * ( h + pad ) ) * g_params.search_scale;
+  const double cx = 0.5 * ( box[0] + box[2] );
+  const double cy = 0.5 * ( box[1] + box[3] );
+
+  region[0] = cx - 0.5 * side;
+  region[1] = cy - 0.5 * side;
+  region[2] = cx + 0.5 * side;
+  region[3] = cy + 0.5 * side;
+}
+
+// ---------------------------------------------------------------------------------------
+// Bilinear resampling of a frame region into a chip, filling pixels outside the
+// frame with the mean frame color
+static void
+resample_chip( kv::image const& image, const double mean[3], const double region[4],
+               unsigned char* chip )
+{
+  const unsigned size = g_params.chip_size;
+  const auto* base = static_cast< const unsigned char* >( image.first_pixel() );
+  const std::ptrdiff_t ws = image.w_step(), hs = image.h_step(), ds = image.d_step();
+  const std::ptrdiff_t width = image.width(), height = image.height();
+  const unsigned depth = std::min< unsigned >( image.depth(), chip_channels );
+  const double scale = ( region[2] - region[0] ) / size;
+
+  for( unsigned y = 0; y < size; ++y )
+  {
+    const double sy = region[1] + ( y + 0.5 ) * scale - 0.5;
+    const std::ptrdiff_t y0 = static_cast< std::ptrdiff_t >( std::floor( sy ) );
+    const double fy = sy - y0;
+
+    for( unsigned x = 0; x < size; ++x )
+    {
+      const double sx = region[0] + ( x + 0.5 ) * scale - 0.5;
+      const std::ptrdiff_t x0 = static_cast< std::ptrdiff_t >( std::floor( sx ) );
+      const double fx = sx - x0;
+
+      unsigned char* out = chip + ( static_cast< std::size_t >( y ) * size + x ) * chip_channels;
+
+      for( unsigned c = 0; c < chip_channels; ++c )
+      {
+        const unsigned src_c = ( depth == chip_channels ) ? c : 0;
+        double value = 0.0;
+
+        for( unsigned k = 0; k < 4; ++k )
+        {
+          const std::ptrdiff_t px = x0 + ( k & 1 ), py = y0 + ( k >> 1 );
+          const double weight = ( ( k & 1 ) ? fx : 1.0 - fx ) *
+                                ( ( k >> 1 ) ? fy : 1.0 - fy );
+
+          value += weight * ( ( px < 0 || py < 0 || px >= width || py >= height ) ?
+            mean[ src_c ] : base[ px * ws + py * hs + src_c * ds ] );
+        }
+
+        out[c] = static_cast< unsigned char >(
+          std::min( 255.0, std::max( 0.0, std::round( value ) ) ) );
+      }
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------------------
+// Decode one frame and cut all of its chips, returns false if it was unreadable
+static bool
+process_frame( reader_pool& readers, std::string const& image_file,
+               std::vector< track_state > const& states,
+               std::vector< std::size_t > const& frame_states,
+               std::vector< chip_slot > const& slots,
+               std::vector< std::unique_ptr< viame::track_chip_shard_writer > >& shards )
+{
+  kv::image_container_sptr container;
+  kv::algo::image_io_sptr reader = readers.acquire();
+
+  try
+  {
+    container = reader->load( image_file );
+  }
+  catch( std::exception const& e )
+  {
+    std::cerr << "Warning: unable to load " << image_file << ": " << e.what() << std::endl;
+  }
+  readers.release( reader );
+
+  if( !container ||
+      container->get_image().pixel_traits() != kv::image_pixel_traits_of< std::uint8_t >() )
+  {
+    return false;
+  }
+
+  kv::image const& image = container->get_image();
+  const auto* base = static_cast< const unsigned char* >( image.first_pixel() );
+  const unsigned depth = std::min< unsigned >( image.depth(), chip_channels );
+
+  double mean[3] = { 0.0, 0.0, 0.0 };
+
+  for( unsigned c = 0; c < depth; ++c )
+  {
+    double sum = 0.0;
+
+    for( std::size_t j = 0; j < image.height(); ++j )
+    {
+      for( std::size_t i = 0; i < image.width(); ++i )
+      {
+        sum += base[ i * image.w_step() + j * image.h_step() + c * image.d_step() ];
+      }
+    }
+    mean[c] = sum / std::max< std::size_t >( 1, image.width() * image.height() );
+  }
+
+  for( const std::size_t s : frame_states )
+  {
+    track_state const& state = states[s];
+    viame::track_chip_record record;
+    record.frame_id = state.frame_id;
+
+    chip_region( state.box, record.region );
+
+    const double scale = g_params.chip_size / ( record.region[2] - record.region[0] );
+
+    if( !std::isfinite( scale ) || scale <= 0.0 )
+    {
+      continue;
+    }
+
+    for( unsigned i = 0; i < 4; ++i )
+    {
+      record.box[i] = ( state.box[i] - record.region[ i % 2 ] ) * scale;
+    }
+
+    auto& shard = *shards[ slots[s].shard ];
+    resample_chip( image, mean, record.region, shard.pixels( slots[s].chip ) );
+
+    record.flags = viame::track_chip_record::has_pixels;
+    shard.set_record( slots[s].chip, record );
+  }
+
+  return true;
+}
+
+// ---------------------------------------------------------------------------------------
+// Extract all chips of one sequence, returns the number of chips written
+static std::size_t
+process_sequence( filesystem::path const& folder, std::string const& csv_file,
+                  filesystem::path const& output_folder, viame::thread_pool& workers,
+                  reader_pool& readers, std::size_t& failed_frames )
+{
+  std::vector< std::string > frames;
+  std::vector< track_state > states = read_track_states( csv_file, folder, frames );
+
+  if( states.empty() )
+  {
+    return 0;
+  }
+
+  // Chips are ordered by track then frame, and whole tracks assigned to shards
+  std::vector< std::size_t > order( states.size() );
+
+  for( std::size_t i = 0; i < order.size(); ++i )
+  {
+    order[i] = i;
+  }
+
+  std::sort( order.begin(), order.end(), [&states]( std::size_t a, std::size_t b )
+  {
+    return states[a].track_id != states[b].track_id ?
+      states[a].track_id < states[b].track_id : states[a].frame_id < states[b].frame_id;
+  } );
+
+  const std::uint64_t chip_bytes = static_cast< std::uint64_t >( g_params.chip_size ) *
+    g_params.chip_size * chip_channels;
+
+  std::vector< std::vector< viame::track_chip_range > > shard_tracks( 1 );
+  std::vector< chip_slot > slots( states.size() );
+  std::uint64_t shard_used = 0;
+
+  for( std::size_t i = 0; i < order.size(); )
+  {
+    std::size_t end = i;
+
+    while( end < order.size() && states[ order[end] ].track_id == states[ order[i] ].track_id )
+    {
+      ++end;
+    }
+
+    const std::uint64_t track_bytes = ( end - i ) * chip_bytes;
+
+    if( !shard_tracks.back().empty() && shard_used + track_bytes > g_params.shard_bytes )
+    {
+      shard_tracks.emplace_back();
+      shard_used = 0;
+    }
+
+    viame::track_chip_range range;
+    range.track_id = states[ order[i] ].track_id;
+    range.first_chip = shard_used / chip_bytes;
+    range.chip_count = end - i;
+
+    for( std::size_t k = i; k < end; ++k )
+    {
+      slots[ order[k] ] = { shard_tracks.size() - 1, range.first_chip + ( k - i ) };
+    }
+
+    shard_tracks.back().push_back( range );
+    shard_used += track_bytes;
+    i = end;
+  }
+
+  filesystem::create_directories( output_folder );
+
+  std::vector< std::unique_ptr< viame::track_chip_shard_writer > > shards;
+
+  for( std::size_t s = 0; s < shard_tracks.size(); ++s )
+  {
+    std::ostringstream name;
+    name << "track_chips_" << std::setw( 5 ) << std::setfill( '0' ) << s << ".chips";
+
+    shards.emplace_back( new viame::track_chip_shard_writer(
+      ( output_folder / name.str() ).string(), g_params.chip_size, g_params.chip_size,
+      chip_channels, shard_tracks[s] ) );
+  }
+
+  // The frame index, listing the states cut from every frame
+  std::vector< std::vector< std::size_t > > frame_states( frames.size() );
+
+  for( std::size_t s = 0; s < states.size(); ++s )
+  {
+    frame_states[ states[s].frame ].push_back( s );
+  }
+
+  std::vector< std::future< bool > > results;
+
+  for( std::size_t f = 0; f < frames.size(); ++f )
+  {
+    results.push_back( workers.enqueue( [&, f]
+    {
+      return process_frame( readers, frames[f], states, frame_states[f], slots, shards );
+    } ) );
+  }
+
+  for( auto& result : results )
+  {
+    if( !result.get() )
+    {
+      failed_frames++;
+    }
+  }
+
+  for( auto& shard : shards )
+  {
+    shard->close();
+  }
+
+  std::cout << folder_name( folder ) << ": " << states.size() << " chips of "
+            << shard_tracks.size() << " shards from " << frames.size() << " frames"
+            << std::endl;
+
+  return states.size();
+}
+
+/*                   _
+ *   _ __ ___   __ _(_)_ __
+ *  | '_ ` _ \ / _` | | '_ \
+ *  | | | | | | (_| | | | | |
+ *  |_| |_| |_|\__,_|_|_| |_|
+ *
+ */
+int
+main( int argc, char* argv[] )
+{
+  // Parse options
+  g_params.m_args.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  g_params.m_args.AddArgument( "--help",             argT::NO_ARGUMENT,
+    &g_params.opt_help, "Display usage information" );
+  g_params.m_args.AddArgument( "-i",                 argT::SPACE_ARGUMENT,
+    &g_params.opt_input, "Training data folder of sequence folders, or one sequence" );
+  g_params.m_args.AddArgument( "-o",                 argT::SPACE_ARGUMENT,
+    &g_params.opt_output, "Output folder, receiving one shard folder per sequence" );
+  g_params.m_args.AddArgument( "--config",           argT::SPACE_ARGUMENT,
+    &g_params.opt_config, "Optional configuration with an image_reader block" );
+  g_params.m_args.AddArgument( "--groundtruth",      argT::SPACE_ARGUMENT,
+    &g_params.opt_groundtruth, "Track file name in each sequence, else its first csv" );
+  g_params.m_args.AddArgument( "--reader",           argT::SPACE_ARGUMENT,
+    &g_params.opt_reader, "Image reader type, unless set by the configuration" );
+  g_params.m_args.AddArgument( "--chip-size",        argT::SPACE_ARGUMENT,
+    &g_params.opt_chip_size, "Width and height of the square chips in pixels" );
+  g_params.m_args.AddArgument( "--context",          argT::SPACE_ARGUMENT,
+    &g_params.opt_context, "Context added around boxes, as a fraction of width plus height" );
+  g_params.m_args.AddArgument( "--search-scale",     argT::SPACE_ARGUMENT,
+    &g_params.opt_search_scale, "Chip side as a multiple of the box side with context" );
+  g_params.m_args.AddArgument( "--shard-size",       argT::SPACE_ARGUMENT,
+    &g_params.opt_shard_size, "Maximum shard size in megabytes, unless a track is larger" );
+  g_params.m_args.AddArgument( "--threads",          argT::SPACE_ARGUMENT,
+    &g_params.opt_threads, "Frames decoded concurrently, 0 for one per core" );
+
+  // Parse args
+  if( !g_params.m_args.Parse() )
+  {
+    std::cerr << "Problem parsing arguments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Print help
+  if( argc == 1 || g_params.opt_help )
+  {
+    std::cout << "Usage: " << argv[0] << " [options]\n"
+              << "\nExtract track chips from groundtruth for tracker training.\n"
+              << g_params.m_args.GetHelp() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( g_params.opt_input.empty() || g_params.opt_output.empty() )
+  {
+    std::cerr << "Both an input (-i) and an output folder (-o) must be given" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    g_params.chip_size = std::stoul( g_params.opt_chip_size );
+    g_params.context = std::stod( g_params.opt_context );
+    g_params.search_scale = std::stod( g_params.opt_search_scale );
+    g_params.shard_bytes = std::stoull( g_params.opt_shard_size ) << 20;
+
+    if( g_params.chip_size == 0 || g_params.search_scale <= 0.0 )
+    {
+      throw std::runtime_error( "Chip size and search scale must be positive" );
+    }
+
+    kv::config_block_sptr config = kv::config_block::empty_config( "track_chip_tool" );
+
+    if( !g_params.opt_config.empty() )
+    {
+      config->merge_config( kv::read_config_file( g_params.opt_config ) );
+    }
+    if( !config->has_value( "image_reader:type" ) )
+    {
+      config->set_value( "image_reader:type", g_params.opt_reader );
+    }
+
+    viame::load_plugins_for( { config->get_value< std::string >( "image_reader:type" ) } );
+
+    // Sequences are the input folder itself when it has groundtruth, else its
+    // subfolders which do
+    const filesystem::path input( g_params.opt_input );
+    std::vector< std::pair< filesystem::path, std::string > > sequences;
+
+    if( !filesystem::is_directory( input ) )
+    {
+      throw std::runtime_error( "Input folder " + g_params.opt_input + " does not exist" );
+    }
+
+    std::string groundtruth = find_groundtruth( input );
+
+    if( !groundtruth.empty() )
+    {
+      sequences.emplace_back( input, groundtruth );
+    }
+    else
+    {
+      for( auto const& entry : filesystem::directory_iterator( input ) )
+      {
+        if( entry.is_directory() &&
+            !( groundtruth = find_groundtruth( entry.path() ) ).empty() )
+        {
+          sequences.emplace_back( entry.path(), groundtruth );
+        }
+      }
+      std::sort( sequences.begin(), sequences.end() );
+    }
+
+    if( sequences.empty() )
+    {
+      std::cout << "No sequences with groundtruth found, exiting." << std::endl;
+      return EXIT_SUCCESS;
+    }
+
+    viame::thread_pool workers( std::stoul( g_params.opt_threads ) );
+    reader_pool readers( config, workers.size() );
+
+    std::size_t chip_count = 0, failed_frames = 0;
+
+    for( auto const& sequence : sequences )
+    {
+      const filesystem::path output_folder =
+        filesystem::path( g_params.opt_output ) / folder_name( sequence.first );
+
+      chip_count += process_sequence( sequence.first, sequence.second, output_folder,
+                                      workers, readers, failed_frames );
+    }
+
+    std::cout << "Extracted " << chip_count << " chips from " << sequences.size()
+              << " sequences into " << g_params.opt_output << std::endl;
+
+    if( failed_frames )
+    {
+      std::cout << failed_frames << " frames could not be read, their chips are "
+                << "marked empty" << std::endl;
+    }
+  }
+  catch( std::exception const& e )
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,321 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ * \brief Build a metadata index over a whole HabCam image archive
+ *
+ * Every image is opened once, in parallel, and its navigation metadata and
+ * GSD are written to a sidecar index which read_habcam_metadata can use
+ * instead of reopening the images on every pipeline run.
+ */
+
+#include <kwiversys/CommandLineArguments.hxx>
+
+#include <plugins/core/habcam_metadata_index.h>
+#include <plugins/core/thread_pool.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if WIN32 || ( __cplusplus >= 201703L && __has_include(<filesystem>) )
+  #include <filesystem>
+  namespace filesystem = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+  #include <experimental/filesystem>
+  namespace filesystem = std::experimental::filesystem;
+#endif
+
+// =======================================================================================
+// Class storing all input parameters for the tool
+class habcam_index_vars
+{
+public:
+
+  // Collected command line args
+  kwiversys::CommandLineArguments m_args;
+
+  // Config options
+  bool opt_help = false;
+
+  std::string opt_input;
+  std::string opt_output;
+  std::string opt_scan_length = "1000";
+  std::string opt_focal_length = "0";
+  std::string opt_threads = "0";
+  std::string opt_max_errors = "20";
+};
+
+static habcam_index_vars g_params;
+
+// Images read by a single task, amortizing the scheduling cost over a few files
+static const size_t files_per_task = 64;
+
+// ---------------------------------------------------------------------------------------
+// Everything one block of images contributes, combined in input order afterwards
+struct block_result
+{
+  std::vector< std::pair< std::string, viame::habcam_metadata > > entries;
+  std::vector< std::string > errors;
+  size_t without_metadata = 0;
+};
+
+// ---------------------------------------------------------------------------------------
+static bool
+is_image_file( filesystem::path const& path )
+{
+  std::string ext = path.extension().string();
+
+  std::transform( ext.begin(), ext.end(), ext.begin(),
+    []( unsigned char c ){ return static_cast< char >( std::tolower( c ) ); } );
+
+  return ext == ".tif" || ext == ".tiff" || ext == ".jpg" || ext == ".jpeg";
+}
+
+// ---------------------------------------------------------------------------------------
+static std::vector< std::string >
+list_input_files( std::string const& input )
+{
+  std::vector< std::string > output;
+
+  if( filesystem::is_directory( input ) )
+  {
+    for( auto const& entry : filesystem::recursive_directory_iterator( input ) )
+    {
+      if( entry.is_regular_file() && is_image_file( entry.path() ) )
+      {
+        output.push_back( entry.path().string() );
+      }
+    }
+    std::sort( output.begin(), output.end() );
+  }
+  else if( is_image_file( input ) )
+  {
+    output.push_back( input );
+  }
+  else
+  {
+    // Image list, one file per line as used by the pipeline input lists
+    std::ifstream fin( input );
+
+    if( !fin )
+    {
+      throw std::runtime_error( "Unable to open input list: " + input );
+    }
+
+    std::string line;
+
+    while( std::getline( fin, line ) )
+    {
+      while( !line.empty() && std::isspace( static_cast< unsigned char >( line.back() ) ) )
+      {
+        line.pop_back();
+      }
+      if( !line.empty() && line[0] != '#' )
+      {
+        output.push_back( line );
+      }
+    }
+  }
+
+  return output;
+}
+
+// ---------------------------------------------------------------------------------------
+static block_result
+process_block( std::vector< std::string > const& files, size_t begin, size_t end,
+               size_t scan_length, double focal_length )
+{
+  block_result result;
+  result.entries.reserve( end - begin );
+
+  for( size_t i = begin; i < end; ++i )
+  {
+    viame::habcam_metadata metadata;
+
+    try
+    {
+      if( !viame::read_habcam_image_metadata( files[i], scan_length, metadata ) )
+      {
+        result.without_metadata++;
+        continue;
+      }
+    }
+    catch( std::exception const& e )
+    {
+      result.errors.push_back( e.what() );
+      continue;
+    }
+
+    viame::compute_habcam_gsd( metadata, focal_length );
+    result.entries.emplace_back( files[i], metadata );
+  }
+
+  return result;
+}
+
+/*                   _
+ *   _ __ ___   __ _(_)_ __
+ *  | '_ ` _ \ / _` | | '_ \
+ *  | | | | | | (_| | | | | |
+ *  |_| |_| |_|\__,_|_|_| |_|
+ *
+ */
+int
+main( int argc, char* argv[] )
+{
+  // Parse options
+  g_params.m_args.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  g_params.m_args.AddArgument( "--help",             argT::NO_ARGUMENT,
+    &g_params.opt_help, "Display usage information" );
+  g_params.m_args.AddArgument( "-i",                 argT::SPACE_ARGUMENT,
+    &g_params.opt_input, "Input image folder, searched recursively, or image list" );
+  g_params.m_args.AddArgument( "-o",                 argT::SPACE_ARGUMENT,
+    &g_params.opt_output, "Output metadata index file" );
+  g_params.m_args.AddArgument( "--scan-length",      argT::SPACE_ARGUMENT,
+    &g_params.opt_scan_length, "Number of bytes at the end of TIFF files to scan" );
+  g_params.m_args.AddArgument( "--focal-length",     argT::SPACE_ARGUMENT,
+    &g_params.opt_focal_length, "Focal length in pixels to compute GSD, 0 for none" );
+  g_params.m_args.AddArgument( "--threads",          argT::SPACE_ARGUMENT,
+    &g_params.opt_threads, "Images read concurrently, 0 for one per core" );
+  g_params.m_args.AddArgument( "--max-errors",       argT::SPACE_ARGUMENT,
+    &g_params.opt_max_errors, "Number of unreadable images to report individually" );
+
+  // Parse args
+  if( !g_params.m_args.Parse() )
+  {
+    std::cerr << "Problem parsing arguments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Print help
+  if( argc == 1 || g_params.opt_help )
+  {
+    std::cout << "Usage: " << argv[0] << " [options]\n"
+              << "\nIndex the metadata of a HabCam image archive for read_habcam_metadata.\n"
+              << g_params.m_args.GetHelp() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( g_params.opt_input.empty() || g_params.opt_output.empty() )
+  {
+    std::cerr << "Both an input (-i) and an output index (-o) must be given" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    const size_t scan_length = std::stoul( g_params.opt_scan_length );
+    const double focal_length = std::stod( g_params.opt_focal_length );
+    const size_t max_errors = std::stoul( g_params.opt_max_errors );
+
+    const std::vector< std::string > input_files = list_input_files( g_params.opt_input );
+
+    std::cout << "Indexing " << input_files.size() << " images" << std::endl;
+
+    viame::thread_pool workers( std::stoul( g_params.opt_threads ) );
+    std::vector< std::future< block_result > > results;
+
+    for( size_t begin = 0; begin < input_files.size(); begin += files_per_task )
+    {
+      const size_t end = std::min( begin + files_per_task, input_files.size() );
+
+      results.push_back( workers.enqueue(
+        [&input_files, begin, end, scan_length, focal_length]
+        {
+          return process_block( input_files, begin, end, scan_length, focal_length );
+        } ) );
+    }
+
+    std::vector< std::pair< std::string, viame::habcam_metadata > > entries;
+    entries.reserve( input_files.size() );
+
+    size_t error_count = 0;
+    size_t without_metadata = 0;
+
+    // Results are combined in input order, while later blocks are still read
+    for( auto& future : results )
+    {
+      block_result result = future.get();
+
+      for( auto const& error : result.errors )
+      {
+        if( error_count++ < max_errors )
+        {
+          std::cerr << "Warning: " << error << std::endl;
+        }
+      }
+
+      without_metadata += result.without_metadata;
+
+      std::move( result.entries.begin(), result.entries.end(),
+                 std::back_inserter( entries ) );
+    }
+
+    const size_t duplicates =
+      viame::write_habcam_metadata_index( g_params.opt_output, entries );
+
+    std::cout << "Indexed " << entries.size() - duplicates << " images into "
+              << g_params.opt_output << std::endl;
+
+    if( without_metadata )
+    {
+      std::cout << without_metadata << " images had no metadata" << std::endl;
+    }
+    if( error_count )
+    {
+      std::cout << error_count << " images could not be read" << std::endl;
+    }
+    if( duplicates )
+    {
+      std::cout << duplicates << " images shared a file name with an earlier "
+                << "image and were skipped" << std::endl;
+    }
+  }
+  catch( std::exception const& e )
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
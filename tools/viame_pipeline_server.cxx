@@ -0,0 +1,578 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <kwiversys/CommandLineArguments.hxx>
+
+#include <vital/types/detected_object_set.h>
+
+#include <plugins/core/embedded_pipeline_pool.h>
+#include <plugins/core/plugin_manifest.h>
+
+#include <sprokit/pipeline/datum.h>
+#include <sprokit/pipeline/pipeline.h>
+#include <sprokit/pipeline/scheduler.h>
+#include <sprokit/pipeline/scheduler_factory.h>
+#include <sprokit/pipeline_util/pipeline_builder.h>
+#include <sprokit/processes/adapters/adapter_data_set.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#if WIN32 || ( __cplusplus >= 201703L && __has_include(<filesystem>) )
+  #include <filesystem>
+  namespace filesystem = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+  #include <experimental/filesystem>
+  namespace filesystem = std::experimental::filesystem;
+#else
+  #error "No filesystem library available"
+#endif
+
+#ifndef MSG_NOSIGNAL
+  #define MSG_NOSIGNAL 0
+#endif
+
+namespace kv = kwiver::vital;
+
+// =======================================================================================
+// Class storing all input parameters for the tool
+class server_vars
+{
+public:
+
+  // Collected command line args
+  kwiversys::CommandLineArguments m_args;
+
+  // Config options
+  bool opt_help = false;
+
+  std::vector< std::string > opt_pipelines;
+  std::string opt_socket = "viame_pipeline.sock";
+  std::string opt_instances = "1";
+};
+
+static server_vars g_params;
+
+static std::atomic< bool > g_stop( false );
+
+static void
+handle_signal( int )
+{
+  g_stop = true;
+}
+
+typedef std::map< std::string, std::unique_ptr< viame::embedded_pipeline_pool > > pipeline_map_t;
+
+// ---------------------------------------------------------------------------------------
+// Reply lines of one output port. Detections use the columns of the VIAME CSV
+// format, other values supported by the adapters are written as text.
+static void
+write_output( std::ostream& out, std::string const& port,
+              sprokit::datum_t const& value, std::string const& image_name )
+{
+  try
+  {
+    auto set = value->get_datum< kv::detected_object_set_sptr >();
+    unsigned id = 0;
+
+    for( auto const& det : *set )
+    {
+      const kv::bounding_box_d bbox( det->bounding_box() );
+
+      out << port << ":" << id++ << "," << image_name << ",0,"
+          << bbox.min_x() << "," << bbox.min_y() << ","
+          << bbox.max_x() << "," << bbox.max_y() << ","
+          << det->confidence() << ",0";
+
+      if( det->type() )
+      {
+        for( auto const& name : det->type()->class_names() )
+        {
+          out << "," << name << "," << det->type()->score( name );
+        }
+      }
+      out << "\n";
+    }
+    return;
+  }
+  catch( sprokit::bad_datum_cast_exception const& )
+  {
+  }
+
+  try
+  {
+    out << port << "=" << value->get_datum< std::string >() << "\n";
+    return;
+  }
+  catch( sprokit::bad_datum_cast_exception const& )
+  {
+  }
+
+  try
+  {
+    out << port << "=" << ( value->get_datum< bool >() ? "true" : "false" ) << "\n";
+    return;
+  }
+  catch( sprokit::bad_datum_cast_exception const& )
+  {
+  }
+
+  out << port << "=(unsupported type)\n";
+}
+
+// ---------------------------------------------------------------------------------------
+// Run a full pipeline file to completion, as kwiver runner would, from the fields
+// run, pipeline file, log file and optional key=value settings. Plugins stay
+// loaded between runs, so only the pipeline itself is set up again per file.
+// Runs are serialized as the log redirects the output of the whole server.
+static std::string
+run_pipeline_file( std::vector< std::string > const& fields )
+{
+  static std::mutex run_mutex;
+  static std::set< std::string > loaded_types;
+
+  std::lock_guard< std::mutex > lock( run_mutex );
+
+  int saved_out = -1;
+  int saved_err = -1;
+
+  if( !fields[2].empty() )
+  {
+    const int log = ::open( fields[2].c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+
+    if( log < 0 )
+    {
+      return "ERROR unable to open log " + fields[2] + "\n";
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    saved_out = ::dup( STDOUT_FILENO );
+    saved_err = ::dup( STDERR_FILENO );
+    ::dup2( log, STDOUT_FILENO );
+    ::dup2( log, STDERR_FILENO );
+    ::close( log );
+  }
+
+  std::string reply = "OK 0\n";
+
+  try
+  {
+    std::vector< std::string > types;
+
+    for( auto const& name : viame::pipeline_plugin_names( fields[1] ) )
+    {
+      if( loaded_types.insert( name ).second )
+      {
+        types.push_back( name );
+      }
+    }
+    if( !types.empty() )
+    {
+      viame::load_plugins_for( types );
+    }
+
+    kwiver::pipeline_builder builder;
+    builder.load_pipeline( fields[1] );
+
+    for( size_t i = 3; i < fields.size(); ++i )
+    {
+      builder.add_setting( fields[i] );
+    }
+
+    sprokit::pipeline_t const pipe = builder.pipeline();
+    kv::config_block_sptr const config = builder.config();
+
+    if( !pipe )
+    {
+      throw std::runtime_error( "Unable to bake pipeline " + fields[1] );
+    }
+    pipe->setup_pipeline();
+
+    const std::string type = config->get_value< std::string >(
+      "_scheduler:type", sprokit::scheduler_factory::default_type );
+
+    sprokit::scheduler_t const scheduler = sprokit::create_scheduler(
+      type, pipe, config->subblock_view( "_scheduler:" + type ) );
+
+    if( !scheduler )
+    {
+      throw std::runtime_error( "Unable to create scheduler " + type );
+    }
+    scheduler->start();
+    scheduler->wait();
+  }
+  catch( std::exception const& e )
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+
+    std::string message = e.what();
+    std::replace( message.begin(), message.end(), '\n', ' ' );
+    reply = "ERROR " + message + "\n";
+  }
+
+  if( saved_out >= 0 )
+  {
+    std::cout.flush();
+    std::cerr.flush();
+    ::dup2( saved_out, STDOUT_FILENO );
+    ::dup2( saved_err, STDERR_FILENO );
+    ::close( saved_out );
+    ::close( saved_err );
+  }
+
+  return reply;
+}
+
+// ---------------------------------------------------------------------------------------
+// Run one request line, of the pipeline name, input file and optional output
+// file separated by tabs, and return the reply ending with an OK or ERROR line
+static std::string
+run_job( pipeline_map_t& pipelines, std::string const& request )
+{
+  std::ostringstream reply;
+  std::vector< std::string > fields;
+  std::stringstream ss( request );
+  std::string field;
+
+  while( std::getline( ss, field, '\t' ) )
+  {
+    fields.push_back( field );
+  }
+
+  if( fields.size() == 1 && fields[0] == "list" )
+  {
+    for( auto const& p : pipelines )
+    {
+      reply << p.first << "\n";
+    }
+    reply << "OK " << pipelines.size() << "\n";
+    return reply.str();
+  }
+
+  if( !fields.empty() && fields[0] == "run" )
+  {
+    if( fields.size() < 3 )
+    {
+      return "ERROR expected run<TAB>pipeline_file<TAB>log_file[<TAB>key=value...]\n";
+    }
+    return run_pipeline_file( fields );
+  }
+
+  if( fields.size() < 2 || fields.size() > 3 )
+  {
+    return "ERROR expected pipeline<TAB>input[<TAB>output]\n";
+  }
+
+  auto it = pipelines.find( fields[0] );
+
+  if( it == pipelines.end() )
+  {
+    return "ERROR unknown pipeline " + fields[0] + "\n";
+  }
+
+  try
+  {
+    auto inputs = kwiver::adapter::adapter_data_set::create();
+    inputs->add_value( "input_file_name", fields[1] );
+
+    if( fields.size() == 3 && it->second->has_input( "output_file_name" ) )
+    {
+      inputs->add_value( "output_file_name", fields[2] );
+    }
+
+    auto outputs = it->second->submit( inputs ).get();
+    size_t count = 0;
+
+    for( auto const& output : *outputs )
+    {
+      write_output( reply, output.first, output.second, fields[1] );
+      ++count;
+    }
+    reply << "OK " << count << "\n";
+  }
+  catch( std::exception const& e )
+  {
+    std::string message = e.what();
+    std::replace( message.begin(), message.end(), '\n', ' ' );
+    reply << "ERROR " << message << "\n";
+  }
+
+  return reply.str();
+}
+
+// ---------------------------------------------------------------------------------------
+static bool
+send_all( int fd, std::string const& data )
+{
+  size_t sent = 0;
+
+  while( sent < data.size() )
+  {
+    const ssize_t n = ::send( fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL );
+
+    if( n <= 0 )
+    {
+      return false;
+    }
+    sent += static_cast< size_t >( n );
+  }
+  return true;
+}
+
+// ---------------------------------------------------------------------------------------
+// Serve the requests of one client connection, one per line, until it closes
+static void
+serve_client( int fd, pipeline_map_t& pipelines )
+{
+  std::string pending;
+  char buffer[4096];
+
+  while( !g_stop )
+  {
+    const ssize_t n = ::recv( fd, buffer, sizeof( buffer ), 0 );
+
+    if( n <= 0 )
+    {
+      return;
+    }
+    pending.append( buffer, static_cast< size_t >( n ) );
+
+    size_t end;
+    while( ( end = pending.find( '\n' ) ) != std::string::npos )
+    {
+      std::string request = pending.substr( 0, end );
+      pending.erase( 0, end + 1 );
+
+      if( !request.empty() && request.back() == '\r' )
+      {
+        request.pop_back();
+      }
+
+      if( !request.empty() && !send_all( fd, run_job( pipelines, request ) ) )
+      {
+        return;
+      }
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------------------
+// Thread of one connection. The socket is closed by the owner after joining, so
+// that it can be shut down from the main thread without racing a reused fd.
+struct client_connection
+{
+  int fd;
+  std::thread thread;
+  std::shared_ptr< std::atomic< bool > > done;
+};
+
+/*                   _
+ *   _ __ ___   __ _(_)_ __
+ *  | '_ ` _ \ / _` | | '_ \
+ *  | | | | | | (_| | | | | |
+ *  |_| |_| |_|\__,_|_|_| |_|
+ *
+ */
+int
+main( int argc, char* argv[] )
+{
+  // Parse options
+  g_params.m_args.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  g_params.m_args.AddArgument( "--help",      argT::NO_ARGUMENT,
+    &g_params.opt_help, "Display usage information" );
+  g_params.m_args.AddArgument( "--pipeline",  argT::SPACE_ARGUMENT,
+    &g_params.opt_pipelines, "Embedded pipeline file to keep loaded, may be repeated; "
+    "requests name it by its file name without extension. Optional when only "
+    "run requests are sent" );
+  g_params.m_args.AddArgument( "--socket",    argT::SPACE_ARGUMENT,
+    &g_params.opt_socket, "Path of the local socket to listen on" );
+  g_params.m_args.AddArgument( "--instances", argT::SPACE_ARGUMENT,
+    &g_params.opt_instances, "Started copies of each pipeline, running jobs at once" );
+
+  // Parse args
+  if( !g_params.m_args.Parse() )
+  {
+    std::cerr << "Problem parsing arguments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Print help
+  if( argc == 1 || g_params.opt_help )
+  {
+    std::cout << "Usage: " << argv[0] << " [options]\n"
+              << "\nKeep pipelines loaded and run jobs sent over a local socket.\n"
+              << "Each request line holds a pipeline name, an input file and an\n"
+              << "optional output file separated by tabs. Replies list the output\n"
+              << "ports of the pipeline and end with an OK or ERROR line.\n"
+              << "A run request instead holds a pipeline file, a log file and\n"
+              << "key=value settings, and runs the file to completion.\n"
+              << g_params.m_args.GetHelp() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  sockaddr_un address;
+  std::memset( &address, 0, sizeof( address ) );
+  address.sun_family = AF_UNIX;
+
+  if( g_params.opt_socket.size() >= sizeof( address.sun_path ) )
+  {
+    std::cerr << "Socket path is too long: " << g_params.opt_socket << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::strcpy( address.sun_path, g_params.opt_socket.c_str() );
+
+  pipeline_map_t pipelines;
+
+  try
+  {
+    // Plugins and models are only loaded once, here
+    std::vector< std::string > types;
+
+    for( auto const& filename : g_params.opt_pipelines )
+    {
+      auto names = viame::pipeline_plugin_names( filename );
+      types.insert( types.end(), names.begin(), names.end() );
+    }
+    viame::load_plugins_for( types );
+
+    for( auto const& filename : g_params.opt_pipelines )
+    {
+      const std::string name = filesystem::path( filename ).stem().string();
+
+      std::cout << "Loading " << name << std::endl;
+      pipelines[ name ].reset(
+        new viame::embedded_pipeline_pool( filename, std::stoul( g_params.opt_instances ) ) );
+    }
+  }
+  catch( std::exception const& e )
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const int listener = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+  ::unlink( address.sun_path );
+
+  if( listener < 0 ||
+      ::bind( listener, reinterpret_cast< sockaddr* >( &address ), sizeof( address ) ) != 0 ||
+      ::listen( listener, 16 ) != 0 )
+  {
+    std::cerr << "Unable to listen on " << g_params.opt_socket << ": "
+              << std::strerror( errno ) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::signal( SIGINT, handle_signal );
+  std::signal( SIGTERM, handle_signal );
+  std::signal( SIGPIPE, SIG_IGN );
+
+  std::cout << "Listening on " << g_params.opt_socket << std::endl;
+
+  std::vector< client_connection > clients;
+
+  auto reap = [&]( bool all )
+  {
+    for( auto it = clients.begin(); it != clients.end(); )
+    {
+      if( all || *it->done )
+      {
+        it->thread.join();
+        ::close( it->fd );
+        it = clients.erase( it );
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  };
+
+  while( !g_stop )
+  {
+    pollfd request = { listener, POLLIN, 0 };
+    const int ready = ::poll( &request, 1, 500 );
+
+    reap( false );
+
+    if( ready <= 0 )
+    {
+      continue;
+    }
+
+    const int fd = ::accept( listener, nullptr, nullptr );
+
+    if( fd >= 0 )
+    {
+      auto done = std::make_shared< std::atomic< bool > >( false );
+
+      clients.push_back( { fd, std::thread( [fd, done, &pipelines]
+      {
+        serve_client( fd, pipelines );
+        *done = true;
+      } ), done } );
+    }
+  }
+
+  ::close( listener );
+  ::unlink( address.sun_path );
+
+  // Clients stop reading after their current request, then pipelines are ended
+  for( auto& client : clients )
+  {
+    ::shutdown( client.fd, SHUT_RD );
+  }
+  reap( true );
+
+  return EXIT_SUCCESS;
+}
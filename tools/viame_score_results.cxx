@@ -0,0 +1,542 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <kwiversys/CommandLineArguments.hxx>
+
+#include <vital/types/category_hierarchy.h>
+
+#include <plugins/core/scoring_data.h>
+#include <plugins/core/detection_scoring.h>
+#include <plugins/core/track_scoring.h>
+#include <plugins/core/thread_pool.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if WIN32 || ( __cplusplus >= 201703L && __has_include(<filesystem>) )
+  #include <filesystem>
+  namespace filesystem = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+  #include <experimental/filesystem>
+  namespace filesystem = std::experimental::filesystem;
+#endif
+
+// =======================================================================================
+// Class storing all input parameters for the tool
+class scoring_vars
+{
+public:
+
+  // Collected command line args
+  kwiversys::CommandLineArguments m_args;
+
+  // Config options
+  bool opt_help = false;
+  bool opt_ignore_classes = false;
+  bool opt_aux_confidence = false;
+  bool opt_per_class = false;
+  bool opt_sweep_thresholds = false;
+  bool opt_track_detections = false;
+
+  std::string opt_computed;
+  std::string opt_truth;
+  std::string opt_labels;
+  std::string opt_input_ext = ".csv";
+  std::string opt_default_label;
+  std::string opt_det_prc_conf;
+  std::string opt_trk_mot_stats;
+  std::string opt_iou_thresh = "0.5";
+  std::string opt_threshold = "0.0";
+  std::string opt_sweep_interval = "100";
+  std::string opt_threads = "0";
+};
+
+static scoring_vars g_params;
+
+// =======================================================================================
+static std::vector< std::string >
+list_files_with_ext( std::string const& folder, std::string const& ext )
+{
+  std::vector< std::string > output;
+
+  for( auto const& entry : filesystem::recursive_directory_iterator( folder ) )
+  {
+    const std::string path = entry.path().string();
+
+    if( entry.is_regular_file() && path.size() >= ext.size() &&
+        path.compare( path.size() - ext.size(), ext.size(), ext ) == 0 )
+    {
+      output.push_back( path );
+    }
+  }
+
+  std::sort( output.begin(), output.end() );
+  return output;
+}
+
+// ---------------------------------------------------------------------------------------
+// Pair each computed file with the truth file of the same base name, after removing the
+// postfix VIAME adds to its outputs. Files with skip_postfix are other outputs.
+static std::vector< std::pair< std::string, std::string > >
+align_files( std::string const& computed_dir, std::string const& truth_dir,
+             std::string const& ext, std::string const& remove_postfix,
+             std::string const& skip_postfix )
+{
+  std::vector< std::pair< std::string, std::string > > output;
+  std::map< std::string, std::string > truth_by_name;
+
+  for( auto const& truth : list_files_with_ext( truth_dir, ext ) )
+  {
+    truth_by_name.emplace( filesystem::path( truth ).filename().string(), truth );
+  }
+
+  for( auto const& computed : list_files_with_ext( computed_dir, ext ) )
+  {
+    if( computed.find( skip_postfix + ext ) != std::string::npos )
+    {
+      continue;
+    }
+
+    std::string name = filesystem::path( computed ).filename().string();
+    const size_t pos = name.find( remove_postfix + ext );
+
+    if( pos != std::string::npos )
+    {
+      name = name.substr( 0, pos ) + ext;
+    }
+
+    auto it = truth_by_name.find( name );
+
+    if( it == truth_by_name.end() )
+    {
+      throw std::runtime_error( "Could not find corresponding truth for: " + name );
+    }
+
+    output.emplace_back( computed, it->second );
+  }
+
+  return output;
+}
+
+// ---------------------------------------------------------------------------------------
+static std::string
+format_class_fn( std::string name )
+{
+  std::replace( name.begin(), name.end(), '/', '-' );
+  return name;
+}
+
+// =======================================================================================
+static void
+write_detection_metrics( viame::detection_metrics const& metrics,
+                         std::string const& output_dir )
+{
+  filesystem::create_directories( output_dir );
+
+  std::vector< viame::detection_class_metrics const* > rows;
+
+  for( auto const& cls : metrics.classes )
+  {
+    if( cls.truth_count > 0 )
+    {
+      rows.push_back( &cls );
+    }
+  }
+
+  std::stable_sort( rows.begin(), rows.end(),
+    []( viame::detection_class_metrics const* a, viame::detection_class_metrics const* b )
+    {
+      return a->average_precision > b->average_precision;
+    } );
+
+  rows.push_back( &metrics.overall );
+
+  std::ofstream summary( output_dir + "/metrics.csv" );
+  summary << "#category,ap,max_f1,max_f1_threshold,samples\n";
+
+  std::ofstream curves( output_dir + "/pr_curves.csv" );
+  curves << "#category,threshold,precision,recall,true_positives,false_positives\n";
+
+  for( auto row : rows )
+  {
+    summary << row->label << "," << row->average_precision << ","
+            << row->max_f1 << "," << row->max_f1_threshold << ","
+            << row->truth_count << "\n";
+
+    for( auto const& point : row->curve )
+    {
+      curves << row->label << "," << point.threshold << "," << point.precision << ","
+             << point.recall << "," << point.true_positives << ","
+             << point.false_positives << "\n";
+    }
+  }
+
+  viame::detection_confusion_matrix const& confusion = metrics.confusion;
+  const size_t count = confusion.labels.size();
+
+  std::ofstream matrix( output_dir + "/confusion_matrix.csv" );
+  matrix << "#truth\\computed";
+
+  for( auto const& label : confusion.labels )
+  {
+    matrix << "," << label;
+  }
+  matrix << ",background\n";
+
+  for( size_t t = 0; t <= count; ++t )
+  {
+    matrix << ( t < count ? confusion.labels[t] : "background" );
+
+    for( size_t c = 0; c <= count; ++c )
+    {
+      matrix << "," << confusion.at( t, c );
+    }
+    matrix << "\n";
+  }
+
+  std::cout << "Overall AP " << metrics.overall.average_precision
+            << ", wrote scores to " << output_dir << std::endl;
+}
+
+// ---------------------------------------------------------------------------------------
+static void
+write_track_summary( std::ostream& out, std::string const& name,
+                     viame::track_metrics const& m )
+{
+  out << std::left << std::setw( 24 ) << name << std::right << std::fixed
+      << std::setprecision( 3 )
+      << std::setw( 8 ) << m.idf1 << std::setw( 8 ) << m.idp
+      << std::setw( 8 ) << m.idr << std::setw( 8 ) << m.recall
+      << std::setw( 8 ) << m.precision << std::setw( 8 ) << m.num_unique_objects
+      << std::setw( 8 ) << m.mostly_tracked << std::setw( 8 ) << m.partially_tracked
+      << std::setw( 8 ) << m.mostly_lost << std::setw( 8 ) << m.num_false_positives
+      << std::setw( 8 ) << m.num_misses << std::setw( 8 ) << m.num_switches
+      << std::setw( 8 ) << m.num_fragmentations << std::setw( 8 ) << m.mota
+      << std::setw( 8 ) << m.motp << "\n";
+}
+
+// ---------------------------------------------------------------------------------------
+// Returns the best IDF1 and MOTA values and the thresholds they are reached at
+static std::vector< double >
+write_track_metrics( std::vector< viame::scoring_sequence > const& sequences,
+                     std::vector< double > const& thresholds,
+                     viame::track_scoring_options const& options,
+                     std::string const& output_file, unsigned num_threads )
+{
+  // Each (threshold, sequence) pair is independent
+  viame::thread_pool workers( num_threads );
+  std::vector< std::vector< std::future< viame::track_metrics > > > results;
+
+  for( double threshold : thresholds )
+  {
+    results.emplace_back();
+
+    for( auto const& sequence : sequences )
+    {
+      results.back().push_back( workers.enqueue( [&sequence, threshold, &options]
+      {
+        return viame::score_tracks( sequence, threshold, options );
+      } ) );
+    }
+  }
+
+  std::ofstream out( output_file );
+  std::vector< double > best = { -1.0e4, 0.0, -1.0e4, 0.0 };
+
+  for( size_t i = 0; i < thresholds.size(); ++i )
+  {
+    out << "\nRunning MOT Metrics at Threshold " << thresholds[i] << "\n\n"
+        << std::left << std::setw( 24 ) << "" << std::right
+        << "    IDF1     IDP     IDR    Rcll    Prcn      GT      MT      PT"
+        << "      ML      FP      FN     IDs      FM    MOTA    MOTP\n";
+
+    viame::track_metrics overall;
+
+    for( size_t s = 0; s < sequences.size(); ++s )
+    {
+      const viame::track_metrics m = results[i][s].get();
+      write_track_summary( out,
+        filesystem::path( sequences[s].name ).stem().string(), m );
+      overall.accumulate( m );
+    }
+
+    overall.finalize();
+    write_track_summary( out, "OVERALL", overall );
+
+    if( overall.idf1 > best[0] )
+    {
+      best[0] = overall.idf1;
+      best[1] = thresholds[i];
+    }
+    if( overall.mota > best[2] )
+    {
+      best[2] = overall.mota;
+      best[3] = thresholds[i];
+    }
+  }
+
+  if( thresholds.size() > 1 )
+  {
+    out << std::fixed << std::setprecision( 3 )
+        << "\nTop IDF1 value: " << best[0] << " at threshold " << best[1]
+        << "\nTop MOTA value: " << best[2] << " at threshold " << best[3] << "\n";
+  }
+
+  std::cout << "Wrote track scores to " << output_file << std::endl;
+  return best;
+}
+
+// ---------------------------------------------------------------------------------------
+static std::vector< viame::scoring_sequence >
+load_sequences( std::string const& remove_postfix, std::string const& skip_postfix,
+                viame::scoring_load_options const& options,
+                viame::scoring_labels& labels )
+{
+  std::vector< std::pair< std::string, std::string > > pairs;
+
+  if( filesystem::is_directory( g_params.opt_computed ) )
+  {
+    pairs = align_files( g_params.opt_computed, g_params.opt_truth,
+      g_params.opt_input_ext, remove_postfix, skip_postfix );
+  }
+  else
+  {
+    pairs.emplace_back( g_params.opt_computed, g_params.opt_truth );
+  }
+
+  std::vector< viame::scoring_sequence > output;
+
+  for( auto const& pair : pairs )
+  {
+    output.push_back(
+      viame::load_scoring_sequence( pair.second, pair.first, options, labels ) );
+  }
+
+  return output;
+}
+
+/*                   _
+ *   _ __ ___   __ _(_)_ __
+ *  | '_ ` _ \ / _` | | '_ \
+ *  | | | | | | (_| | | | | |
+ *  |_| |_| |_|\__,_|_|_| |_|
+ *
+ */
+int
+main( int argc, char* argv[] )
+{
+  // Parse options
+  g_params.m_args.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  g_params.m_args.AddArgument( "--help",             argT::NO_ARGUMENT,
+    &g_params.opt_help, "Display usage information" );
+  g_params.m_args.AddArgument( "--computed",         argT::SPACE_ARGUMENT,
+    &g_params.opt_computed, "Input viame_csv file or folder for computed results" );
+  g_params.m_args.AddArgument( "--truth",            argT::SPACE_ARGUMENT,
+    &g_params.opt_truth, "Input viame_csv file or folder for groundtruth" );
+  g_params.m_args.AddArgument( "--labels",           argT::SPACE_ARGUMENT,
+    &g_params.opt_labels, "Optional label synonym file to use during evaluation" );
+  g_params.m_args.AddArgument( "--input-ext",        argT::SPACE_ARGUMENT,
+    &g_params.opt_input_ext, "Input file extension, used if inputs are folders" );
+  g_params.m_args.AddArgument( "--det-prc-conf",     argT::SPACE_ARGUMENT,
+    &g_params.opt_det_prc_conf, "Output folder for PR curves and confusion matrix" );
+  g_params.m_args.AddArgument( "--trk-mot-stats",    argT::SPACE_ARGUMENT,
+    &g_params.opt_trk_mot_stats, "Output file or folder for MOT statistics" );
+  g_params.m_args.AddArgument( "--iou-thresh",       argT::SPACE_ARGUMENT,
+    &g_params.opt_iou_thresh, "IOU threshold for detection and track matching" );
+  g_params.m_args.AddArgument( "--threshold",        argT::SPACE_ARGUMENT,
+    &g_params.opt_threshold, "Detection confidence threshold for statistics" );
+  g_params.m_args.AddArgument( "--ignore-classes",   argT::NO_ARGUMENT,
+    &g_params.opt_ignore_classes, "Score all detection types as the same class" );
+  g_params.m_args.AddArgument( "--default-label",    argT::SPACE_ARGUMENT,
+    &g_params.opt_default_label, "Class name used with --ignore-classes" );
+  g_params.m_args.AddArgument( "--aux-confidence",   argT::NO_ARGUMENT,
+    &g_params.opt_aux_confidence, "Use the detection instead of the type confidence" );
+  g_params.m_args.AddArgument( "--per-class",        argT::NO_ARGUMENT,
+    &g_params.opt_per_class, "Compute track statistics for each class independently" );
+  g_params.m_args.AddArgument( "--sweep-thresholds", argT::NO_ARGUMENT,
+    &g_params.opt_sweep_thresholds, "Compute track statistics at several thresholds" );
+  g_params.m_args.AddArgument( "--sweep-interval",   argT::SPACE_ARGUMENT,
+    &g_params.opt_sweep_interval, "Number of thresholds used when sweeping" );
+  g_params.m_args.AddArgument( "--track-detections", argT::NO_ARGUMENT,
+    &g_params.opt_track_detections, "Score detections stored in track files" );
+  g_params.m_args.AddArgument( "--threads",          argT::SPACE_ARGUMENT,
+    &g_params.opt_threads, "Worker threads, 0 for one per core" );
+
+  // Parse args
+  if( !g_params.m_args.Parse() )
+  {
+    std::cerr << "Problem parsing arguments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Print help
+  if( argc == 1 || g_params.opt_help )
+  {
+    std::cout << "Usage: " << argv[0] << " [options]\n"
+              << "\nScore computed detections or tracks against groundtruth.\n"
+              << g_params.m_args.GetHelp() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( g_params.opt_computed.empty() || g_params.opt_truth.empty() )
+  {
+    std::cerr << "Both --computed and --truth must be specified" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( g_params.opt_det_prc_conf.empty() && g_params.opt_trk_mot_stats.empty() )
+  {
+    std::cerr << "One of --det-prc-conf or --trk-mot-stats must be specified" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( filesystem::is_directory( g_params.opt_computed ) !=
+      filesystem::is_directory( g_params.opt_truth ) )
+  {
+    std::cerr << "Inputs must be either both folders or both files" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    const unsigned num_threads = std::stoul( g_params.opt_threads );
+    const double iou_thresh = std::stod( g_params.opt_iou_thresh );
+    const double threshold = std::stod( g_params.opt_threshold );
+
+    viame::scoring_load_options load_options;
+    load_options.ignore_classes = g_params.opt_ignore_classes;
+    load_options.aux_confidence = g_params.opt_aux_confidence;
+    load_options.num_threads = num_threads;
+
+    if( !g_params.opt_labels.empty() )
+    {
+      load_options.hierarchy.reset(
+        new kwiver::vital::category_hierarchy( g_params.opt_labels ) );
+
+      if( load_options.hierarchy->all_class_names().size() == 1 )
+      {
+        load_options.default_label = load_options.hierarchy->all_class_names()[0];
+      }
+    }
+
+    if( !g_params.opt_default_label.empty() )
+    {
+      load_options.default_label = g_params.opt_default_label;
+    }
+
+    if( !g_params.opt_det_prc_conf.empty() )
+    {
+      viame::scoring_labels labels;
+
+      const auto sequences = g_params.opt_track_detections ?
+        load_sequences( "_tracks", "_detections", load_options, labels ) :
+        load_sequences( "_detections", "_tracks", load_options, labels );
+
+      viame::detection_scoring_options options;
+      options.iou_threshold = iou_thresh;
+      options.threshold = threshold;
+      options.num_threads = num_threads;
+
+      write_detection_metrics(
+        viame::score_detections( sequences, labels, options ),
+        g_params.opt_det_prc_conf );
+    }
+
+    if( !g_params.opt_trk_mot_stats.empty() )
+    {
+      viame::scoring_labels labels;
+
+      const auto sequences =
+        load_sequences( "_tracks", "_detections", load_options, labels );
+
+      std::vector< double > thresholds = { threshold };
+
+      if( g_params.opt_sweep_thresholds )
+      {
+        const int interval = std::max( std::stoi( g_params.opt_sweep_interval ), 1 );
+        thresholds.clear();
+
+        for( int i = 0; i < interval; ++i )
+        {
+          thresholds.push_back( static_cast< double >( i ) / interval );
+        }
+      }
+
+      viame::track_scoring_options options;
+      options.iou_threshold = iou_thresh;
+
+      if( !g_params.opt_per_class )
+      {
+        write_track_metrics( sequences, thresholds, options,
+          g_params.opt_trk_mot_stats, num_threads );
+      }
+      else
+      {
+        filesystem::create_directories( g_params.opt_trk_mot_stats );
+
+        std::ofstream net( g_params.opt_trk_mot_stats + "/class_metrics.csv" );
+        net << "# class,idf1,idf1_thresh,mota,mota_thresh\n" << std::fixed
+            << std::setprecision( 3 );
+
+        for( size_t l = 0; l < labels.size(); ++l )
+        {
+          options.target_label = static_cast< int >( l );
+
+          const std::vector< double > best = write_track_metrics(
+            sequences, thresholds, options,
+            g_params.opt_trk_mot_stats + "/" +
+              format_class_fn( labels.names()[l] ) + ".txt",
+            num_threads );
+
+          net << labels.names()[l] << "," << best[0] << "," << best[1] << ","
+              << best[2] << "," << best[3] << "\n";
+        }
+      }
+    }
+  }
+  catch( std::exception const& e )
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,514 @@
+/*ckwg +29
+ * Copyright 2026 by Kitware, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of Kitware, Inc. nor the names of any contributors may be used
+ *    to endorse or promote products derived from this software without specific
+ *    prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <kwiversys/CommandLineArguments.hxx>
+
+#include <vital/config/config_block.h>
+#include <vital/config/config_block_io.h>
+
+#include <plugins/core/spsc_ring_buffer.h>
+#include <plugins/core/thread_pool.h>
+#include <plugins/opencv/ocv_rectified_stereo_disparity_map.h>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if WIN32 || ( __cplusplus >= 201703L && __has_include(<filesystem>) )
+  #include <filesystem>
+  namespace filesystem = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+  #include <experimental/filesystem>
+  namespace filesystem = std::experimental::filesystem;
+#else
+  #error "No filesystem library available"
+#endif
+
+namespace kv = kwiver::vital;
+
+// =======================================================================================
+// Class storing all input parameters for the tool
+class rectify_vars
+{
+public:
+
+  // Collected command line args
+  kwiversys::CommandLineArguments m_args;
+
+  // Config options
+  bool opt_help = false;
+  bool opt_bayer = false;
+
+  std::string opt_config;
+  std::string opt_cameras;
+  std::string opt_cache;
+  std::string opt_left_list;
+  std::string opt_right_list;
+  std::string opt_input_list;
+  std::string opt_output = ".";
+  std::string opt_extension = "png";
+  std::string opt_interpolation = "cubic";
+  std::string opt_threads = "0";
+  std::string opt_writers = "2";
+  std::string opt_prefetch = "4";
+};
+
+static rectify_vars g_params;
+
+// ---------------------------------------------------------------------------------------
+// One stereo pair, decoded ahead of the workers by the prefetch thread
+struct stereo_job
+{
+  size_t index = 0;
+  std::string left_name;
+  std::string right_name;
+  cv::Mat left;
+  cv::Mat right;
+  bool last = false;
+};
+
+// ---------------------------------------------------------------------------------------
+// Rectification maps shared read-only by every worker
+struct rectification_maps
+{
+  cv::Mat map11, map12, map21, map22;
+  int interpolation = cv::INTER_CUBIC;
+};
+
+// ---------------------------------------------------------------------------------------
+static std::vector< std::string >
+read_list( std::string const& filename )
+{
+  std::vector< std::string > output;
+  std::ifstream fin( filename );
+  std::string line;
+
+  if( !fin )
+  {
+    throw std::runtime_error( "Unable to open " + filename );
+  }
+
+  while( std::getline( fin, line ) )
+  {
+    if( !line.empty() && line.back() == '\r' )
+    {
+      line.pop_back();
+    }
+    if( !line.empty() )
+    {
+      output.push_back( line );
+    }
+  }
+  return output;
+}
+
+// ---------------------------------------------------------------------------------------
+static void
+write_image( std::string const& filename, cv::Mat const& image )
+{
+  if( !cv::imwrite( filename, image ) )
+  {
+    throw std::runtime_error( "Unable to write " + filename );
+  }
+}
+
+// ---------------------------------------------------------------------------------------
+// Rectify one pair, then queue the encoding and writing of its outputs on the
+// writer pool so that remapping continues while the files are written
+static std::future< void >
+process_job( stereo_job const& job, rectification_maps const& maps,
+             viame::thread_pool& writers )
+{
+  if( job.left.size() != maps.map11.size() || job.right.size() != maps.map21.size() )
+  {
+    throw std::runtime_error( "Pair " + job.left_name + " differs in size from the "
+                              "first pair" );
+  }
+
+  cv::Mat left = job.left, right = job.right;
+
+  if( g_params.opt_bayer )
+  {
+    cv::Mat left_raw, right_raw;
+    cv::extractChannel( job.left, left_raw, 0 );
+    cv::extractChannel( job.right, right_raw, 0 );
+    cv::cvtColor( left_raw, left, cv::COLOR_BayerBG2BGR );
+    cv::cvtColor( right_raw, right, cv::COLOR_BayerBG2BGR );
+  }
+
+  cv::Mat left_rect, right_rect;
+  cv::remap( left, left_rect, maps.map11, maps.map12, maps.interpolation );
+  cv::remap( right, right_rect, maps.map21, maps.map22, maps.interpolation );
+
+  const filesystem::path output( g_params.opt_output );
+  const std::string extension = "." + g_params.opt_extension;
+
+  if( job.right_name.empty() )
+  {
+    // Side-by-side inputs give side-by-side outputs, as stereo_rectify.py
+    cv::Mat pair;
+    cv::hconcat( left_rect, right_rect, pair );
+
+    const std::string path = ( output / ( job.left_name + extension ) ).string();
+    return writers.enqueue( [ path, pair ]{ write_image( path, pair ); } );
+  }
+
+  const std::string left_path = ( output / "left" / ( job.left_name + extension ) ).string();
+  const std::string right_path = ( output / "right" / ( job.right_name + extension ) ).string();
+
+  return writers.enqueue( [ left_path, right_path, left_rect, right_rect ]
+  {
+    write_image( left_path, left_rect );
+    write_image( right_path, right_rect );
+  } );
+}
+
+/*                   _
+ *   _ __ ___   __ _(_)_ __
+ *  | '_ ` _ \ / _` | | '_ \
+ *  | | | | | | (_| | | | | |
+ *  |_| |_| |_|\__,_|_|_| |_|
+ *
+ */
+int
+main( int argc, char* argv[] )
+{
+  // Parse options
+  g_params.m_args.Initialize( argc, argv );
+  typedef kwiversys::CommandLineArguments argT;
+
+  g_params.m_args.AddArgument( "--help",            argT::NO_ARGUMENT,
+    &g_params.opt_help, "Display usage information" );
+  g_params.m_args.AddArgument( "--config",          argT::SPACE_ARGUMENT,
+    &g_params.opt_config, "Optional ocv_rectified_stereo_disparity_map configuration, "
+    "in a block named stereo:ocv_rectified_stereo_disparity_map" );
+  g_params.m_args.AddArgument( "--cameras",         argT::SPACE_ARGUMENT,
+    &g_params.opt_cameras, "Directory of intrinsics.yml and extrinsics.yml" );
+  g_params.m_args.AddArgument( "--cache",           argT::SPACE_ARGUMENT,
+    &g_params.opt_cache, "Rectification map cache directory, reused by later runs "
+    "with the same calibration and image size" );
+  g_params.m_args.AddArgument( "--left-list",       argT::SPACE_ARGUMENT,
+    &g_params.opt_left_list, "List of left images" );
+  g_params.m_args.AddArgument( "--right-list",      argT::SPACE_ARGUMENT,
+    &g_params.opt_right_list, "List of right images, paired with the left by line" );
+  g_params.m_args.AddArgument( "--input-list",      argT::SPACE_ARGUMENT,
+    &g_params.opt_input_list, "List of side-by-side stereo images, instead of "
+    "left and right lists" );
+  g_params.m_args.AddArgument( "--output",          argT::SPACE_ARGUMENT,
+    &g_params.opt_output, "Output directory, with left and right subdirectories "
+    "when left and right lists are given" );
+  g_params.m_args.AddArgument( "--extension",       argT::SPACE_ARGUMENT,
+    &g_params.opt_extension, "Output image file extension" );
+  g_params.m_args.AddArgument( "--interpolation",   argT::SPACE_ARGUMENT,
+    &g_params.opt_interpolation, "Remap interpolation, one of nearest, linear, cubic" );
+  g_params.m_args.AddArgument( "--bayer",           argT::NO_ARGUMENT,
+    &g_params.opt_bayer, "Input images are Bayer patterned" );
+  g_params.m_args.AddArgument( "--threads",         argT::SPACE_ARGUMENT,
+    &g_params.opt_threads, "Pairs rectified at once, 0 for one per core" );
+  g_params.m_args.AddArgument( "--writers",         argT::SPACE_ARGUMENT,
+    &g_params.opt_writers, "Threads encoding and writing the outputs" );
+  g_params.m_args.AddArgument( "--prefetch",        argT::SPACE_ARGUMENT,
+    &g_params.opt_prefetch, "Decoded pairs read ahead of the workers" );
+
+  // Parse args
+  if( !g_params.m_args.Parse() )
+  {
+    std::cerr << "Problem parsing arguments" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Print help
+  if( argc == 1 || g_params.opt_help )
+  {
+    std::cout << "Usage: " << argv[0] << " [options]\n"
+              << "\nRectify lists of stereo pairs.\n"
+              << g_params.m_args.GetHelp() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if( g_params.opt_input_list.empty() ==
+      ( g_params.opt_left_list.empty() || g_params.opt_right_list.empty() ) )
+  {
+    std::cerr << "Give either --input-list or both --left-list and --right-list"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  rectification_maps maps;
+
+  if( g_params.opt_interpolation == "nearest" )
+  {
+    maps.interpolation = cv::INTER_NEAREST;
+  }
+  else if( g_params.opt_interpolation == "linear" )
+  {
+    maps.interpolation = cv::INTER_LINEAR;
+  }
+  else if( g_params.opt_interpolation != "cubic" )
+  {
+    std::cerr << "Invalid interpolation " << g_params.opt_interpolation << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    std::vector< std::string > left, right;
+
+    if( g_params.opt_input_list.empty() )
+    {
+      left = read_list( g_params.opt_left_list );
+      right = read_list( g_params.opt_right_list );
+
+      if( left.size() != right.size() )
+      {
+        throw std::runtime_error( "Left and right lists differ in length" );
+      }
+    }
+    else
+    {
+      left = read_list( g_params.opt_input_list );
+    }
+
+    if( left.empty() )
+    {
+      throw std::runtime_error( "No stereo pairs given" );
+    }
+
+    filesystem::create_directories( g_params.opt_output );
+
+    if( !right.empty() )
+    {
+      filesystem::create_directories( filesystem::path( g_params.opt_output ) / "left" );
+      filesystem::create_directories( filesystem::path( g_params.opt_output ) / "right" );
+    }
+
+    // The calibration loading and map cache of the disparity algorithm are
+    // used as is, so that both tools rectify identically
+    viame::ocv_rectified_stereo_disparity_map rectifier;
+    kv::config_block_sptr config = rectifier.get_configuration();
+
+    if( !g_params.opt_config.empty() )
+    {
+      config->merge_config( kv::read_config_file( g_params.opt_config )->subblock(
+        "stereo:ocv_rectified_stereo_disparity_map" ) );
+    }
+    if( !g_params.opt_cameras.empty() )
+    {
+      config->set_value( "cameras_directory", g_params.opt_cameras );
+    }
+    if( !g_params.opt_cache.empty() )
+    {
+      config->set_value( "rectification_cache_directory", g_params.opt_cache );
+    }
+
+    rectifier.set_configuration( config );
+
+    viame::thread_pool workers( std::stoul( g_params.opt_threads ) );
+    viame::thread_pool writers( std::max< unsigned long >( std::stoul( g_params.opt_writers ), 1 ) );
+
+    // Decode pairs on a background thread, bounded by the prefetch depth
+    viame::spsc_ring_buffer< stereo_job > prefetched(
+      std::max< size_t >( std::stoul( g_params.opt_prefetch ), 1 ) );
+
+    std::atomic< bool > cancel( false );
+    std::exception_ptr load_error;
+
+    std::thread loader( [&]
+    {
+      try
+      {
+        for( size_t i = 0; i < left.size() && !cancel; ++i )
+        {
+          stereo_job job;
+          job.index = i;
+          job.left_name = filesystem::path( left[i] ).stem().string();
+
+          cv::Mat image = cv::imread( left[i], cv::IMREAD_UNCHANGED );
+
+          if( image.empty() )
+          {
+            throw std::runtime_error( "Unable to read " + left[i] );
+          }
+
+          if( right.empty() )
+          {
+            job.left = image.colRange( 0, image.cols / 2 );
+            job.right = image.colRange( image.cols / 2, image.cols / 2 * 2 );
+          }
+          else
+          {
+            job.right_name = filesystem::path( right[i] ).stem().string();
+            job.left = image;
+            job.right = cv::imread( right[i], cv::IMREAD_UNCHANGED );
+
+            if( job.right.empty() )
+            {
+              throw std::runtime_error( "Unable to read " + right[i] );
+            }
+          }
+          prefetched.wait_push( std::move( job ) );
+        }
+      }
+      catch( ... )
+      {
+        load_error = std::current_exception();
+      }
+
+      stereo_job end;
+      end.last = true;
+      prefetched.wait_push( std::move( end ) );
+    } );
+
+    // Rectified pairs in input order, then their queued writes
+    std::deque< std::future< std::future< void > > > pending;
+    std::deque< std::future< void > > writing;
+    const size_t max_pending = 2 * workers.size();
+    const size_t max_writing = 2 * writers.size();
+    size_t done = 0;
+    bool loaded = false;
+
+    auto next_job = [&]
+    {
+      while( prefetched.empty() )
+      {
+        std::this_thread::yield();
+      }
+
+      stereo_job job = std::move( prefetched.front() );
+      prefetched.pop();
+      loaded = job.last;
+      return job;
+    };
+
+    auto retire_pending = [&]
+    {
+      writing.push_back( pending.front().get() );
+      pending.pop_front();
+
+      while( writing.size() > max_writing )
+      {
+        writing.front().get();
+        writing.pop_front();
+        ++done;
+      }
+    };
+
+    try
+    {
+      while( true )
+      {
+        stereo_job job = next_job();
+
+        if( job.last )
+        {
+          break;
+        }
+
+        // The maps of the first pair size are loaded from the cache or computed
+        // once, every pair is then remapped with them concurrently
+        if( job.index == 0 )
+        {
+          rectifier.rectification_maps( job.left.size(), maps.map11, maps.map12,
+                                        maps.map21, maps.map22 );
+        }
+
+        pending.push_back( workers.enqueue( [ job = std::move( job ), &maps, &writers ]
+        {
+          return process_job( job, maps, writers );
+        } ) );
+
+        while( pending.size() >= max_pending )
+        {
+          retire_pending();
+        }
+      }
+
+      while( !pending.empty() )
+      {
+        retire_pending();
+      }
+
+      while( !writing.empty() )
+      {
+        writing.front().get();
+        writing.pop_front();
+        ++done;
+      }
+    }
+    catch( ... )
+    {
+      // Stop the loader and let running pairs and writes finish before unwinding
+      cancel = true;
+
+      for( auto& p : pending )
+      {
+        p.wait();
+      }
+      for( auto& w : writing )
+      {
+        w.wait();
+      }
+
+      while( !loaded )
+      {
+        next_job();
+      }
+      loader.join();
+      throw;
+    }
+
+    loader.join();
+
+    if( load_error )
+    {
+      std::rethrow_exception( load_error );
+    }
+
+    std::cout << "Rectified " << done << " stereo pairs" << std::endl;
+  }
+  catch( std::exception const& e )
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
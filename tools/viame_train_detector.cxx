@@ -50,6 +50,9 @@
 #include <sprokit/processes/adapters/embedded_pipeline.h>
 #include <sprokit/processes/adapters/adapter_types.h>
 
+#include <plugins/core/embedded_pipeline_pool.h>
+#include <plugins/core/image_tiling.h>
+
 #include <vector>
 #include <unordered_set>
 #include <string>
@@ -60,7 +63,18 @@
 #include <iterator>
 #include <memory>
 #include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <regex>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
 
 #if WIN32 || ( __cplusplus >= 201703L && __has_include(<filesystem>) )
   #include <filesystem>
@@ -99,12 +113,15 @@ public:
   std::string opt_detector;
   std::string opt_out_config;
   std::string opt_threshold;
-  std::string opt_settings;
+  std::vector< std::string > opt_settings;
   std::string opt_pipeline_file;
   std::string opt_frame_rate;
   std::string opt_max_frame_count;
   std::string opt_timeout;
   std::string opt_init_weights;
+  std::string opt_sweep;
+  std::string opt_gpus;
+  std::string opt_hosts;
 
   trainer_vars()
   {
@@ -127,7 +144,367 @@ public:
 static trainer_vars g_params;
 static kwiver::vital::logger_handle_t g_logger;
 
-typedef std::unique_ptr< kwiver::embedded_pipeline > pipeline_t;
+// =======================================================================================
+// Run a function on every index of [0, count) from the given number of threads, each
+// index being taken in order by the first idle thread. The first exception thrown is
+// rethrown once all threads are done.
+template< typename Function >
+void parallel_for( size_t count, unsigned thread_count, Function func )
+{
+  std::atomic< size_t > next( 0 );
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto work = [&]()
+  {
+    try
+    {
+      for( size_t i = next++; i < count; i = next++ )
+      {
+        func( i );
+      }
+    }
+    catch( ... )
+    {
+      std::lock_guard< std::mutex > lock( error_mutex );
+
+      if( !error )
+      {
+        error = std::current_exception();
+      }
+      next = count;
+    }
+  };
+
+  std::vector< std::thread > threads;
+
+  for( unsigned t = 1; t < thread_count && t < count; ++t )
+  {
+    threads.emplace_back( work );
+  }
+
+  work();
+
+  for( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  if( error )
+  {
+    std::rethrow_exception( error );
+  }
+}
+
+// =======================================================================================
+// Cache of folder listings, each one checked against the modification time of its
+// folder so that only changed folders are listed again. The cache can be saved to
+// and loaded from a dataset manifest file, with one line per folder followed by one
+// line per folder entry:
+//
+//   d <modification time> <folder>
+//   f <file name>   (regular file)
+//   s <folder name> (sub-folder)
+//   o <name>        (other entry)
+class directory_cache
+{
+public:
+
+  struct entry
+  {
+    std::string name;
+    char type;
+  };
+
+  // List the entries of a folder, returning false if it can not be read
+  bool list( const std::string& location, std::vector< entry >& entries )
+  {
+    entries.clear();
+
+    const std::string key = get_key( location );
+    std::error_code ec;
+    const auto mtime = filesystem::last_write_time( key, ec );
+
+    if( ec )
+    {
+      return false;
+    }
+
+    const long long stamp = static_cast< long long >( mtime.time_since_epoch().count() );
+
+    {
+      std::lock_guard< std::mutex > lock( m_mutex );
+      auto cached = m_listings.find( key );
+
+      if( cached != m_listings.end() && cached->second.mtime == stamp )
+      {
+        entries = cached->second.entries;
+        return true;
+      }
+    }
+
+    for( filesystem::directory_iterator dir_iter( key, ec );
+         !ec && dir_iter != filesystem::directory_iterator();
+         dir_iter.increment( ec ) )
+    {
+      entry e;
+      e.name = dir_iter->path().filename().string();
+
+      if( filesystem::is_regular_file( *dir_iter ) )
+      {
+        e.type = 'f';
+      }
+      else if( filesystem::is_directory( *dir_iter ) )
+      {
+        e.type = 's';
+      }
+      else
+      {
+        e.type = 'o';
+      }
+
+      entries.push_back( e );
+    }
+
+    if( ec )
+    {
+      entries.clear();
+      return false;
+    }
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_listings[ key ] = listing{ stamp, entries };
+    m_modified = true;
+    return true;
+  }
+
+  bool load( const std::string& file )
+  {
+    std::ifstream fin( file );
+
+    if( !fin )
+    {
+      return false;
+    }
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+    std::string line;
+    listing* current = nullptr;
+
+    while( std::getline( fin, line ) )
+    {
+      if( line.size() < 2 )
+      {
+        continue;
+      }
+
+      if( line[0] == 'd' )
+      {
+        std::istringstream iss( line.substr( 2 ) );
+        long long stamp;
+
+        if( !( iss >> stamp ) )
+        {
+          current = nullptr;
+          continue;
+        }
+
+        std::string folder;
+        std::getline( iss >> std::ws, folder );
+
+        current = &m_listings[ folder ];
+        current->mtime = stamp;
+        current->entries.clear();
+      }
+      else if( current )
+      {
+        current->entries.push_back( entry{ line.substr( 2 ), line[0] } );
+      }
+    }
+
+    m_modified = false;
+    return true;
+  }
+
+  // Save the cache, if anything was listed since it was loaded
+  bool save( const std::string& file )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    if( !m_modified )
+    {
+      return true;
+    }
+
+    std::ofstream fout( file );
+
+    if( !fout )
+    {
+      return false;
+    }
+
+    for( const auto& folder : m_listings )
+    {
+      fout << "d " << folder.second.mtime << " " << folder.first << "\n";
+
+      for( const auto& e : folder.second.entries )
+      {
+        fout << e.type << " " << e.name << "\n";
+      }
+    }
+
+    m_modified = false;
+    return static_cast< bool >( fout );
+  }
+
+private:
+
+  struct listing
+  {
+    long long mtime;
+    std::vector< entry > entries;
+  };
+
+  static std::string get_key( std::string location )
+  {
+    while( location.size() > 1 &&
+           ( location.back() == '/' || location.back() == '\\' ) )
+    {
+      location.pop_back();
+    }
+
+    return location;
+  }
+
+  std::mutex m_mutex;
+  std::map< std::string, listing > m_listings;
+  bool m_modified = false;
+};
+
+static directory_cache g_directory_cache;
+
+// =======================================================================================
+// Timing and throughput of each phase of training data preparation, written as a JSON
+// report. Phases run from several threads accumulate the time spent by every thread.
+class training_profile
+{
+public:
+
+  typedef std::chrono::steady_clock clock;
+
+  struct phase
+  {
+    double seconds = 0.0;
+    std::uint64_t items = 0;
+    std::uint64_t bytes_read = 0;
+    std::uint64_t bytes_written = 0;
+    std::uint64_t cache_hits = 0;
+    std::uint64_t cache_misses = 0;
+  };
+
+  training_profile()
+    : m_start( clock::now() )
+  {
+  }
+
+  static double seconds_since( const clock::time_point& start )
+  {
+    return std::chrono::duration< double >( clock::now() - start ).count();
+  }
+
+  // Update the statistics of a phase, created on first use
+  template< typename Function >
+  void update( const std::string& name, Function func )
+  {
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    auto existing = std::find_if( m_phases.begin(), m_phases.end(),
+      [&]( const std::pair< std::string, phase >& p ){ return p.first == name; } );
+
+    if( existing == m_phases.end() )
+    {
+      m_phases.emplace_back( name, phase() );
+      existing = m_phases.end() - 1;
+    }
+
+    func( existing->second );
+  }
+
+  void add_time( const std::string& name, const clock::time_point& start )
+  {
+    const double seconds = seconds_since( start );
+    update( name, [&]( phase& p ){ p.seconds += seconds; } );
+  }
+
+  bool write_json( const std::string& filename )
+  {
+    std::ofstream fout( filename );
+
+    if( !fout )
+    {
+      return false;
+    }
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    fout << std::fixed << std::setprecision( 3 )
+         << "{\n  \"total_seconds\": " << seconds_since( m_start )
+         << ",\n  \"phases\": {";
+
+    for( size_t i = 0; i < m_phases.size(); ++i )
+    {
+      const phase& p = m_phases[i].second;
+      const std::uint64_t lookups = p.cache_hits + p.cache_misses;
+
+      fout << ( i ? "," : "" ) << "\n    \"" << m_phases[i].first << "\": {"
+           << "\n      \"seconds\": " << p.seconds
+           << ",\n      \"items\": " << p.items
+           << ",\n      \"items_per_second\": "
+           << ( p.seconds > 0.0 ? p.items / p.seconds : 0.0 )
+           << ",\n      \"bytes_read\": " << p.bytes_read
+           << ",\n      \"bytes_written\": " << p.bytes_written
+           << ",\n      \"cache_hits\": " << p.cache_hits
+           << ",\n      \"cache_misses\": " << p.cache_misses
+           << ",\n      \"cache_hit_rate\": "
+           << ( lookups ? static_cast< double >( p.cache_hits ) / lookups : 0.0 )
+           << "\n    }";
+    }
+
+    fout << "\n  }\n}\n";
+    return static_cast< bool >( fout );
+  }
+
+private:
+
+  clock::time_point m_start;
+  std::mutex m_mutex;
+  std::vector< std::pair< std::string, phase > > m_phases;
+};
+
+static training_profile g_profile;
+
+// Video reader used for frame extraction, set once from the tool config
+static std::string g_video_reader = "vidl_ffmpeg";
+static bool g_video_seek_frames = false;
+
+std::uint64_t get_file_size( const std::string& location )
+{
+  std::error_code ec;
+  const auto size = filesystem::file_size( location, ec );
+  return ec ? 0 : static_cast< std::uint64_t >( size );
+}
+
+std::uint64_t get_total_file_size( const std::vector< std::string >& locations )
+{
+  std::uint64_t total = 0;
+
+  for( const auto& location : locations )
+  {
+    total += get_file_size( location );
+  }
+
+  return total;
+}
 
 // =======================================================================================
 // Assorted filesystem related helper functions
@@ -148,20 +525,20 @@ bool list_all_subfolders( const std::string& location,
 {
   subfolders.clear();
 
-  if( !does_folder_exist( location ) )
+  std::vector< directory_cache::entry > entries;
+
+  if( !g_directory_cache.list( location, entries ) )
   {
     return false;
   }
 
   filesystem::path dir( location );
 
-  for( filesystem::directory_iterator dir_iter( dir );
-       dir_iter != filesystem::directory_iterator();
-       ++dir_iter )
+  for( const auto& e : entries )
   {
-    if( filesystem::is_directory( *dir_iter ) )
+    if( e.type == 's' )
     {
-      subfolders.push_back( dir_iter->path().string() );
+      subfolders.push_back( ( dir / e.name ).string() );
     }
   }
 
@@ -174,7 +551,9 @@ bool list_files_in_folder( std::string location,
 {
   filepaths.clear();
 
-  if( !does_folder_exist( location ) )
+  std::vector< directory_cache::entry > entries;
+
+  if( !g_directory_cache.list( location, entries ) )
   {
     return false;
   }
@@ -193,32 +572,32 @@ bool list_files_in_folder( std::string location,
 
   filesystem::path dir( location );
 
-  for( filesystem::directory_iterator file_iter( dir );
-       file_iter != filesystem::directory_iterator();
-       ++file_iter )
+  for( const auto& e : entries )
   {
-    if( filesystem::is_regular_file( *file_iter ) )
+    const filesystem::path file_path = dir / e.name;
+
+    if( e.type == 'f' )
     {
       if( extensions.empty() )
       {
-        filepaths.push_back( file_iter->path().string() );
+        filepaths.push_back( file_path.string() );
       }
       else
       {
         for( unsigned i = 0; i < extensions.size(); i++ )
         {
-          if( file_iter->path().extension() == extensions[i] )
+          if( file_path.extension() == extensions[i] )
           {
-            filepaths.push_back( file_iter->path().string() );
+            filepaths.push_back( file_path.string() );
             break;
           }
         }
       }
     }
-    else if( filesystem::is_directory( *file_iter ) && search_subfolders )
+    else if( e.type == 's' && search_subfolders )
     {
       std::vector< std::string > subfiles;
-      list_files_in_folder( file_iter->path().string(),
+      list_files_in_folder( file_path.string(),
         subfiles, search_subfolders, extensions );
 
       filepaths.insert( filepaths.end(), subfiles.begin(), subfiles.end() );
@@ -419,64 +798,105 @@ void correct_manual_annotations( kwiver::vital::detected_object_set_sptr dos )
   }
 }
 
-kwiver::vital::detected_object_set_sptr
-adjust_to_full_frame( const kwiver::vital::detected_object_set_sptr dos,
-                      const unsigned width, const unsigned height )
+struct chip_settings
 {
-  if( !dos )
-  {
-    return dos;
-  }
+  unsigned width;
+  unsigned height;
+  unsigned overlap;
+  double min_overlap;     // Min fraction of a detection inside a chip to keep it
+  bool keep_empty;        // Keep chips without any detection
+  bool full_frame;        // Convert detections to full frame labels of each chip
+  bool overwrite;         // Write chips again even if they already exist
+};
 
-  bool adj_required = false;
+// Split an image into chips written to the output folder, each one along with the
+// detections it contains, appending both to the output lists
+bool write_annotated_chips( kwiver::vital::algo::image_io_sptr image_io,
+  const std::string& image_file,
+  const kwiver::vital::detected_object_set_sptr& dets,
+  const std::string& output_folder,
+  const chip_settings& settings,
+  std::vector< std::string >& output_files,
+  std::vector< kwiver::vital::detected_object_set_sptr >& output_dets )
+{
+  const auto start = training_profile::clock::now();
+  const size_t first_output = output_files.size();
+  std::uint64_t bytes_written = 0, chips_reused = 0, chips_written = 0;
+
+  kwiver::vital::image_container_sptr image;
 
-  for( auto det : *dos )
+  try
   {
-    if( det &&
-        ( det->bounding_box().min_x() != 0 ||
-          det->bounding_box().min_y() != 0 ||
-          det->bounding_box().width() != width ||
-          det->bounding_box().height() != height ) )
-    {
-      adj_required = true;
-    }
+    image = image_io->load( image_file );
   }
-
-  if( !adj_required )
+  catch( const std::exception& e )
   {
-    return dos;
+    std::cerr << "Unable to load image to chip: " << image_file
+              << " (" << e.what() << ")" << std::endl;
+    return false;
   }
 
-  kwiver::vital::detected_object_set_sptr output =
-    std::make_shared< kwiver::vital::detected_object_set>();
+  if( !image || image->width() == 0 || image->height() == 0 )
+  {
+    return false;
+  }
 
-  kwiver::vital::bounding_box_d ff_box( 0, 0, width, height );
+  const unsigned chip_ni = std::min< unsigned >( settings.width, image->width() );
+  const unsigned chip_nj = std::min< unsigned >( settings.height, image->height() );
 
-  std::map< std::string, int > obs_labels;
+  const std::string stem = filesystem::path( image_file ).stem().string();
+  const std::string ext = filesystem::path( image_file ).extension().string();
 
-  for( auto det : *dos )
+  for( unsigned j0 : viame::tile_origins( image->height(), chip_nj, settings.overlap ) )
   {
-    std::string label;
-    double score;
-
-    if( det->type() )
+    for( unsigned i0 : viame::tile_origins( image->width(), chip_ni, settings.overlap ) )
     {
-      det->type()->get_most_likely( label, score );
-    }
+      const kwiver::vital::bounding_box_d region( i0, j0, i0 + chip_ni, j0 + chip_nj );
 
-    obs_labels[ label ]++;
+      auto chip_dets = viame::crop_detections( dets, region, settings.min_overlap );
 
-    if( obs_labels[ label ] > 1 )
-    {
-      continue;
-    }
+      if( chip_dets->empty() && !settings.keep_empty )
+      {
+        continue;
+      }
+
+      if( settings.full_frame )
+      {
+        chip_dets = viame::adjust_to_full_frame( chip_dets, chip_ni, chip_nj );
+      }
+
+      const std::string chip_file = append_path( output_folder,
+        stem + "_" + std::to_string( i0 ) + "_" + std::to_string( j0 ) + ext );
+
+      if( settings.overwrite || !does_file_exist( chip_file ) )
+      {
+        image_io->save( chip_file, std::make_shared< kwiver::vital::simple_image_container >(
+          image->get_image().crop( i0, j0, chip_ni, chip_nj ) ) );
 
-    det->set_bounding_box( ff_box );
+        bytes_written += get_file_size( chip_file );
+        chips_written++;
+      }
+      else
+      {
+        chips_reused++;
+      }
 
-    output->add( det );
+      output_files.push_back( chip_file );
+      output_dets.push_back( chip_dets );
+    }
   }
 
-  return output;
+  g_profile.add_time( "chipping", start );
+  g_profile.update( "chipping", [&]( training_profile::phase& p )
+  {
+    p.items += output_files.size() - first_output;
+    p.bytes_read += get_file_size( image_file );
+    p.bytes_written += bytes_written;
+    p.cache_hits += chips_reused;
+    p.cache_misses += chips_written;
+  } );
+
+  return true;
 }
 
 bool folder_contains_less_than_n_files( const std::string& folder, unsigned n )
@@ -517,6 +937,13 @@ static kwiver::vital::config_block_sptr default_config()
     "If an augmentation cache already exists, should we regenerate it or use it as-is?" );
   config->set_value( "augmented_ext_override", ".png",
     "Optional image extension over-ride for augmented images." );
+  config->set_value( "incremental_cache", "false",
+    "Keep a manifest of the augmentation cache recording a hash of each source "
+    "image and of the augmentation pipeline, and only augment the images whose "
+    "entry is missing or stale, instead of applying regenerate_cache." );
+  config->set_value( "augmentation_threads", "1",
+    "Number of augmentation pipelines run concurrently when generating the "
+    "augmentation cache, each one on its own thread." );
   config->set_value( "default_percent_validation", "0.05",
     "Percent [0.0, 1.0] of validation samples to use if no manual files specified." );
   config->set_value( "validation_burst_frame_count", "500",
@@ -532,6 +959,21 @@ static kwiver::vital::config_block_sptr default_config()
     "this extension will not be included." );
   config->set_value( "video_extractor", "ffmpeg",
     "Method to use to extract frames from video, can either be ffmpeg or a pipe file" );
+  config->set_value( "video_extraction_in_process", "true",
+    "Run the video frame extraction pipeline inside this process, instead of "
+    "launching a kwiver runner for each video." );
+  config->set_value( "video_extraction_threads", "1",
+    "Number of videos listed directly in the training data whose frames are "
+    "extracted concurrently, ahead of their use. Only used in process." );
+  config->set_value( "video_frame_extension", ".png",
+    "Extension of the frames extracted from videos, which selects their format. "
+    "For instance .jpg is faster to write than .png." );
+  config->set_value( "video_reader", "vidl_ffmpeg",
+    "Video reader implementation used to extract frames, for instance one "
+    "backed by a hardware decoder." );
+  config->set_value( "video_seek_frames", "false",
+    "Wrap the video reader in a scheduled reader which seeks over the frames "
+    "dropped by the downsampler instead of decoding them." );
   config->set_value( "frame_rate", "5",
     "Default frame rate to use for videos when it is not manually specified inside of a "
     "groundtruth file." );
@@ -562,8 +1004,37 @@ static kwiver::vital::config_block_sptr default_config()
     "Over-ride and ignore data safety checks." );
   config->set_value( "convert_to_full_frame", "false",
     "Convert input detections to full frame labels even if they're not." );
+  config->set_value( "chip_width", "0",
+    "If non-zero along with chip_height, write training images to the augmentation "
+    "cache as chips of this maximum size, each one with the detections it contains, "
+    "instead of handing the full frames to the trainer." );
+  config->set_value( "chip_height", "0",
+    "Maximum height of training image chips, see chip_width." );
+  config->set_value( "chip_overlap", "50",
+    "Approximate overlap in pixels between neighboring training image chips." );
+  config->set_value( "chip_min_overlap", "0.5",
+    "Minimum fraction of a detection that must lie inside a chip for the chip to "
+    "contain it, clipped to the chip." );
+  config->set_value( "chip_keep_empty", "false",
+    "Also train on chips which do not contain any detection." );
   config->set_value( "data_warning_file", "",
     "Optional file for storing possible data errors and warning." );
+  config->set_value( "dataset_scan_threads", "1",
+    "Number of threads listing data folders and checking that training files "
+    "exist concurrently, ahead of their use." );
+  config->set_value( "dataset_manifest", "",
+    "Optional file caching the listing of every data folder along with its "
+    "modification time, so that unchanged folders are not listed again by "
+    "later runs." );
+  config->set_value( "training_manifest", "",
+    "Optional file to write a binary manifest of the prepared training and "
+    "validation data to, which trainers can memory-map." );
+  config->set_value( "profile_report", "",
+    "Optional JSON file to write the time spent in each phase of training to, "
+    "including throughput, bytes read and written, and cache hit rates." );
+  config->set_value( "groundtruth_reader_threads", "1",
+    "Number of threads parsing groundtruth files concurrently, each with its own "
+    "reader, when there is one groundtruth file per image." );
 
   kwiver::vital::algo::detected_object_set_input::get_nested_algo_configuration
     ( "groundtruth_reader", config, kwiver::vital::algo::detected_object_set_input_sptr() );
@@ -575,57 +1046,73 @@ static kwiver::vital::config_block_sptr default_config()
   return config;
 }
 
-pipeline_t load_embedded_pipeline( const std::string& pipeline_filename )
+// Embedded frame extraction pipeline, with settings applied over its file
+class frame_extraction_pipeline : public kwiver::embedded_pipeline
 {
-  std::unique_ptr< kwiver::embedded_pipeline > external_pipeline;
+public:
 
-  if( !pipeline_filename.empty() )
+  frame_extraction_pipeline( kwiver::vital::config_block_sptr settings )
+    : m_settings( settings )
   {
-    auto dir = filesystem::path( pipeline_filename ).parent_path();
+  }
 
-    std::unique_ptr< kwiver::embedded_pipeline > new_pipeline =
-      std::unique_ptr< kwiver::embedded_pipeline >( new kwiver::embedded_pipeline() );
+protected:
 
-    std::ifstream pipe_stream;
-    pipe_stream.open( pipeline_filename, std::ifstream::in );
+  virtual void update_config( kwiver::vital::config_block_sptr config )
+  {
+    config->merge_config( m_settings );
+  }
 
-    if( !pipe_stream )
-    {
-      throw sprokit::invalid_configuration_exception( "viame_train_detector",
-        "Unable to open pipeline file: " + pipeline_filename );
-    }
+private:
 
-    try
-    {
-      new_pipeline->build_pipeline( pipe_stream, dir.string() );
-      new_pipeline->start();
-    }
-    catch( const std::exception& e )
-    {
-      throw sprokit::invalid_configuration_exception( "viame_train_detector",
-                                                      e.what() );
-    }
+  kwiver::vital::config_block_sptr m_settings;
+};
+
+// Run a frame extraction pipeline to completion in this process
+bool run_frame_extraction( const std::string& pipeline_filename,
+                           kwiver::vital::config_block_sptr settings )
+{
+  std::ifstream pipe_stream( pipeline_filename, std::ifstream::in );
+
+  if( !pipe_stream )
+  {
+    std::cout << "Error: Unable to open pipeline file: " << pipeline_filename << std::endl;
+    return false;
+  }
+
+  try
+  {
+    frame_extraction_pipeline pipe( settings );
 
-    external_pipeline = std::move( new_pipeline );
-    pipe_stream.close();
+    pipe.build_pipeline( pipe_stream,
+      filesystem::path( pipeline_filename ).parent_path().string() );
+    pipe.start();
+    pipe.wait();
+  }
+  catch( const std::exception& e )
+  {
+    std::cout << "Error: Frame extraction failed: " << e.what() << std::endl;
+    return false;
   }
 
-  return external_pipeline;
+  return true;
 }
 
 std::vector< std::string > extract_video_frames( const std::string& video_filename,
   const std::string& pipeline_filename, const double& frame_rate,
   const std::string& output_directory, bool skip_extract_if_exists = false,
-  unsigned max_frame_count = 0 )
+  unsigned max_frame_count = 0, bool in_process = true,
+  const std::string& frame_ext = ".png" )
 {
   std::cout << "Extracting frames from " << video_filename
             << " at rate " << frame_rate << std::endl;
 
+  const auto start = training_profile::clock::now();
   std::vector< std::string > output;
 
   std::string video_no_path = get_filename_no_path( video_filename );
   std::string output_dir = append_path( output_directory, video_no_path );
-  std::string output_path = append_path( output_dir, "frame%06d.png" );
+  std::string output_path = append_path( output_dir, "frame%06d" + frame_ext );
   std::string frame_rate_str = std::to_string( frame_rate );
 
   if( !skip_extract_if_exists )
@@ -650,24 +1137,67 @@ std::vector< std::string > extract_video_frames( const std::string& video_filena
 
   cmd = cmd + " runner " + add_quotes( pipeline_filename ) + " ";
   cmd = cmd + "-s input:video_filename=" + add_quotes( video_filename ) + " ";
-  cmd = cmd + "-s input:video_reader:type=vidl_ffmpeg ";
   cmd = cmd + "-s downsampler:target_frame_rate=" + frame_rate_str + " ";
   cmd = cmd + "-s image_writer:file_name_template=" + add_quotes( output_path ) + " ";
 
-  if( max_frame_count > 0 )
+  auto settings = kwiver::vital::config_block::empty_config();
+
+  settings->set_value( "input:video_filename", video_filename );
+  settings->set_value( "downsampler:target_frame_rate", frame_rate_str );
+  settings->set_value( "image_writer:file_name_template", output_path );
+
+  // Optionally seek over the frames the downsampler would drop
+  std::string reader_key = "input:video_reader";
+
+  if( g_video_seek_frames )
+  {
+    settings->set_value( reader_key + ":type", "scheduled" );
+    settings->set_value( reader_key + ":scheduled:target_frame_rate", frame_rate_str );
+    reader_key = reader_key + ":scheduled:video_reader";
+  }
+
+  settings->set_value( reader_key + ":type", g_video_reader );
+
+  if( max_frame_count > 0 && g_video_reader == "vidl_ffmpeg" )
   {
-    cmd = cmd + "-s input:video_reader:vidl_ffmpeg:stop_after_frame="
-              + std::to_string( max_frame_count );
+    settings->set_value( reader_key + ":vidl_ffmpeg:stop_after_frame",
+                         std::to_string( max_frame_count ) );
   }
 
-  if( !skip_extract_if_exists ||
-      ( !does_folder_exist( output_dir ) && create_folder( output_dir ) ) ||
-      folder_contains_less_than_n_files( output_dir, 3 ) )
+  for( auto const& key : settings->available_values() )
+  {
+    if( key.find( "input:video_reader" ) == 0 )
+    {
+      cmd = cmd + "-s " + key + "=" + settings->get_value< std::string >( key ) + " ";
+    }
+  }
+
+  const bool extract = !skip_extract_if_exists ||
+    ( !does_folder_exist( output_dir ) && create_folder( output_dir ) ) ||
+    folder_contains_less_than_n_files( output_dir, 3 );
+
+  if( extract && in_process )
+  {
+    run_frame_extraction( pipeline_filename, settings );
+  }
+  else if( extract )
   {
     system( cmd.c_str() );
   }
 
   list_files_in_folder( output_dir, output );
+
+  const std::uint64_t output_size = ( extract ? get_total_file_size( output ) : 0 );
+
+  g_profile.add_time( "frame_extraction", start );
+  g_profile.update( "frame_extraction", [&]( training_profile::phase& p )
+  {
+    p.items += output.size();
+    p.bytes_read += ( extract ? get_file_size( video_filename ) : 0 );
+    p.bytes_written += output_size;
+    ( extract ? p.cache_misses : p.cache_hits )++;
+  } );
+
   return output;
 }
 
@@ -791,10 +1321,12 @@ bool load_file_list( const std::string& file, std::vector< std::string >& output
   return true;
 }
 
-bool run_pipeline_on_image( pipeline_t& pipe,
-                            std::string pipe_file,
-                            std::string input_name,
-                            std::string output_name )
+// Inputs of one augmentation pipeline request
+kwiver::adapter::adapter_data_set_t
+augmentation_request( const std::string& input_name,
+                      const std::string& output_name,
+                      bool has_output2,
+                      bool has_output3 )
 {
   kwiver::adapter::adapter_data_set_t ids =
     kwiver::adapter::adapter_data_set::create();
@@ -803,30 +1335,390 @@ bool run_pipeline_on_image( pipeline_t& pipe,
 
   ids->add_value( "output_file_name", output_name );
 
-  if( file_contains_string( pipe_file, "output_file_name2" ) )
+  if( has_output2 )
   {
     ids->add_value( "output_file_name2", add_aux_ext( output_name, 1 ) );
   }
 
-  if( file_contains_string( pipe_file, "output_file_name3" ) )
+  if( has_output3 )
   {
     ids->add_value( "output_file_name3", add_aux_ext( output_name, 2 ) );
   }
 
-  pipe->send( ids );
+  return ids;
+}
+
+// =======================================================================================
+// Pool of embedded augmentation pipelines, only loaded when images first need
+// to be augmented
+class augmentation_workers
+{
+public:
+
+  augmentation_workers( const std::string& pipe_file, unsigned count )
+    : m_pipe_file( pipe_file ),
+      m_count( std::max( count, 1u ) ),
+      m_has_output2( file_contains_string( pipe_file, "output_file_name2" ) ),
+      m_has_output3( file_contains_string( pipe_file, "output_file_name3" ) )
+  {
+  }
+
+  ~augmentation_workers()
+  {
+    finish();
+  }
+
+  unsigned size() const
+  {
+    return m_count;
+  }
+
+  // Augment each input image into the output file of the same index, images
+  // being taken in order by the first idle pipeline. Returns the success flag
+  // of every image.
+  std::vector< bool > run( const std::vector< std::string >& inputs,
+                           const std::vector< std::string >& outputs )
+  {
+    if( inputs.empty() )
+    {
+      return std::vector< bool >();
+    }
+
+    if( !m_pool )
+    {
+      try
+      {
+        m_pool.reset( new viame::embedded_pipeline_pool( m_pipe_file, m_count ) );
+      }
+      catch( const std::exception& e )
+      {
+        throw sprokit::invalid_configuration_exception( "viame_train_detector",
+                                                        e.what() );
+      }
+    }
+
+    std::vector< std::future< kwiver::adapter::adapter_data_set_t > > results;
+
+    for( size_t i = 0; i < inputs.size(); ++i )
+    {
+      results.push_back( m_pool->submit( augmentation_request(
+        inputs[i], outputs[i], m_has_output2, m_has_output3 ) ) );
+    }
+
+    // Every request is waited on before the first error is reported
+    std::vector< bool > success( inputs.size(), false );
+    std::exception_ptr error;
+
+    for( size_t i = 0; i < results.size(); ++i )
+    {
+      try
+      {
+        auto const& ods = results[i].get();
+        auto const& success_flag = ods->find( "success_flag" );
+
+        success[i] = success_flag->second->get_datum< bool >();
+      }
+      catch( ... )
+      {
+        if( !error )
+        {
+          error = std::current_exception();
+        }
+      }
+    }
+
+    if( error )
+    {
+      std::rethrow_exception( error );
+    }
+
+    return success;
+  }
+
+  // Flush and stop all pipelines
+  void finish()
+  {
+    m_pool.reset();
+  }
+
+private:
+
+  std::string m_pipe_file;
+  unsigned m_count;
+  std::unique_ptr< viame::embedded_pipeline_pool > m_pool;
+  bool m_has_output2;
+  bool m_has_output3;
+};
 
-  auto const& ods = pipe->receive();
+// =======================================================================================
+// Content hashing of augmentation cache entries
 
-  if( ods->is_end_of_data() )
+// 64-bit FNV-1a hash of a string, continuing from the given hash
+std::uint64_t hash_string( const std::string& str,
+                           std::uint64_t hash = 14695981039346656037ULL )
+{
+  for( unsigned char c : str )
   {
-    throw std::runtime_error( "Pipeline terminated unexpectingly" );
+    hash = ( hash ^ c ) * 1099511628211ULL;
   }
+  return hash;
+}
 
-  auto const& success_flag = ods->find( "success_flag" );
+// 64-bit FNV-1a hash of the content of a file, continuing from the given hash
+std::uint64_t hash_file( const std::string& file,
+                         std::uint64_t hash = 14695981039346656037ULL )
+{
+  std::ifstream fin( file, std::ios::binary );
+  std::vector< char > buffer( 1 << 16 );
 
-  return success_flag->second->get_datum< bool >();;
+  while( fin )
+  {
+    fin.read( buffer.data(), buffer.size() );
+    hash = hash_string( std::string( buffer.data(), fin.gcount() ), hash );
+  }
+  return hash;
 }
 
+// Hash of a pipeline file and of the files it includes, so that any change to the
+// pipeline or to its configuration changes the hash
+std::uint64_t hash_pipeline_file( const std::string& file,
+                                  std::uint64_t hash = 14695981039346656037ULL,
+                                  unsigned depth = 0 )
+{
+  hash = hash_file( file, hash );
+
+  std::ifstream fin( file );
+  std::string line;
+
+  while( depth < 8 && std::getline( fin, line ) )
+  {
+    boost::algorithm::trim( line );
+
+    if( boost::algorithm::starts_with( line, "include " ) )
+    {
+      std::string included = boost::algorithm::trim_copy( line.substr( 8 ) );
+
+      if( !filesystem::path( included ).is_absolute() )
+      {
+        included = ( filesystem::path( file ).parent_path() / included ).string();
+      }
+
+      hash = hash_pipeline_file( included, hash, depth + 1 );
+    }
+  }
+  return hash;
+}
+
+// Record of the augmented images of a cache, persisted as one line per image:
+// success flag, source hash, pipeline hash and augmented file name. Appended
+// entries replace earlier ones of the same file.
+class augmentation_manifest
+{
+public:
+
+  // Load the entries of a manifest, rewrite it without replaced entries and
+  // keep it open for new ones
+  void open( const std::string& filename )
+  {
+    std::ifstream fin( filename );
+    std::string line;
+
+    while( std::getline( fin, line ) )
+    {
+      std::istringstream values( line );
+      entry e;
+      std::string output;
+
+      if( values >> e.success >> std::hex >> e.source_hash >> e.pipeline_hash &&
+          std::getline( values >> std::ws, output ) && !output.empty() )
+      {
+        m_entries[ output ] = e;
+      }
+    }
+    fin.close();
+
+    m_out.open( filename, std::ofstream::out | std::ofstream::trunc );
+
+    for( const auto& e : m_entries )
+    {
+      write( e.first, e.second );
+    }
+    m_out.flush();
+  }
+
+  bool is_open() const
+  {
+    return m_out.is_open();
+  }
+
+  // True if the augmented file is up to date for the given hashes, in which
+  // case success receives its recorded flag. Successful entries must also still
+  // have their augmented file.
+  bool find( const std::string& output, std::uint64_t source_hash,
+             std::uint64_t pipeline_hash, bool& success ) const
+  {
+    auto itr = m_entries.find( output );
+
+    if( itr == m_entries.end() ||
+        itr->second.source_hash != source_hash ||
+        itr->second.pipeline_hash != pipeline_hash ||
+        ( itr->second.success && !filesystem::exists( output ) ) )
+    {
+      return false;
+    }
+
+    success = itr->second.success;
+    return true;
+  }
+
+  void record( const std::string& output, std::uint64_t source_hash,
+               std::uint64_t pipeline_hash, bool success )
+  {
+    entry& e = m_entries[ output ];
+    e.success = success;
+    e.source_hash = source_hash;
+    e.pipeline_hash = pipeline_hash;
+
+    if( m_out.is_open() )
+    {
+      write( output, e );
+    }
+  }
+
+  void flush()
+  {
+    m_out.flush();
+  }
+
+private:
+
+  struct entry
+  {
+    bool success;
+    std::uint64_t source_hash;
+    std::uint64_t pipeline_hash;
+  };
+
+  void write( const std::string& output, const entry& e )
+  {
+    m_out << e.success << " " << std::hex << e.source_hash << " "
+          << e.pipeline_hash << std::dec << " " << output << "\n";
+  }
+
+  std::map< std::string, entry > m_entries;
+  std::ofstream m_out;
+};
+
+// =======================================================================================
+// Readers of one_file_per_image groundtruth, each one configured a single time and
+// reused across files. Files are parsed concurrently, one reader per thread.
+class groundtruth_file_readers
+{
+public:
+
+  groundtruth_file_readers( kwiver::vital::config_block_sptr config, unsigned count )
+    : m_config( config ),
+      m_count( std::max( count, 1u ) )
+  {
+  }
+
+  // Read the groundtruth file of each image, returning the detections of every
+  // image in order. Returns false, after reporting it, if any file failed to load.
+  bool read( const std::vector< std::string >& gt_files,
+             const std::vector< std::string >& image_files,
+             std::vector< kwiver::vital::detected_object_set_sptr >& output )
+  {
+    const auto start = training_profile::clock::now();
+
+    output.assign( image_files.size(), kwiver::vital::detected_object_set_sptr() );
+
+    const size_t thread_count = std::min< size_t >( m_count, image_files.size() );
+
+    while( m_readers.size() < thread_count )
+    {
+      kwiver::vital::algo::detected_object_set_input_sptr reader;
+
+      kwiver::vital::algo::detected_object_set_input::set_nested_algo_configuration
+        ( "groundtruth_reader", m_config, reader );
+      kwiver::vital::algo::detected_object_set_input::get_nested_algo_configuration
+        ( "groundtruth_reader", m_config, reader );
+
+      m_readers.push_back( reader );
+    }
+
+    std::atomic< size_t > next( 0 );
+    std::string error;
+    std::mutex error_mutex;
+
+    auto work = [&]( kwiver::vital::algo::detected_object_set_input_sptr reader )
+    {
+      for( size_t i = next++; i < image_files.size(); i = next++ )
+      {
+        try
+        {
+          auto frame_dets = std::make_shared< kwiver::vital::detected_object_set >();
+          std::string read_fn = get_filename_no_path( image_files[i] );
+
+          reader->open( gt_files[i] );
+          reader->read_set( frame_dets, read_fn );
+          reader->close();
+
+          output[i] = frame_dets;
+        }
+        catch( const std::exception& e )
+        {
+          std::lock_guard< std::mutex > lock( error_mutex );
+
+          if( error.empty() )
+          {
+            error = "Received exception: " + std::string( e.what() ) +
+              "\nUnable to load groundtruth file: " + gt_files[i];
+          }
+          next = image_files.size();
+        }
+      }
+    };
+
+    std::vector< std::thread > threads;
+
+    for( size_t t = 1; t < thread_count; ++t )
+    {
+      threads.emplace_back( work, m_readers[t] );
+    }
+
+    if( thread_count > 0 )
+    {
+      work( m_readers[0] );
+    }
+
+    for( auto& thread : threads )
+    {
+      thread.join();
+    }
+
+    g_profile.add_time( "groundtruth_reading", start );
+    g_profile.update( "groundtruth_reading", [&]( training_profile::phase& p )
+    {
+      p.items += gt_files.size();
+      p.bytes_read += get_total_file_size( gt_files );
+    } );
+
+    if( !error.empty() )
+    {
+      std::cerr << error << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+private:
+
+  kwiver::vital::config_block_sptr m_config;
+  unsigned m_count;
+  std::vector< kwiver::vital::algo::detected_object_set_input_sptr > m_readers;
+};
+
 std::string get_augmented_filename( std::string name,
                                     std::string subdir,
                                     std::string output_dir = "",
@@ -960,109 +1852,556 @@ adjust_labels( std::vector< kwiver::vital::detected_object_set_sptr >& input,
     fg_mask.push_back( adjust_labels( set, cats_to_use, background ) );
   }
 
-  return fg_mask;
+  return fg_mask;
+}
+
+// Keep the images and detections for which keep( i ) is true, in order, in a single
+// in-place pass. The predicate is called once per index, in increasing order, and
+// may move entries out of images it does not keep.
+template< typename Predicate >
+void filter_in_place( std::vector< std::string >& input_files,
+                      std::vector< kwiver::vital::detected_object_set_sptr >& input_dets,
+                      Predicate keep )
+{
+  size_t output = 0;
+
+  for( size_t i = 0; i < input_files.size(); i++ )
+  {
+    if( keep( i ) )
+    {
+      if( output != i )
+      {
+        input_files[ output ] = std::move( input_files[i] );
+        input_dets[ output ] = std::move( input_dets[i] );
+      }
+      output++;
+    }
+  }
+
+  input_files.resize( output );
+  input_dets.resize( output );
+}
+
+// Downsampling of training images, optionally restricted to the images whose path
+// contains a substring, for use within a filter_in_place predicate
+class downsample_filter
+{
+public:
+
+  downsample_filter( double downsample_factor, const std::string& substr = "" )
+    : m_factor( downsample_factor ),
+      m_substr( substr ),
+      m_counter( 1.0 )
+  {
+    if( m_factor > 0.0 && m_factor < 1.0 )
+    {
+      m_factor = 1.0 / m_factor;
+    }
+  }
+
+  bool operator()( const std::string& file )
+  {
+    if( m_factor <= 0.0 || m_factor == 1.0 )
+    {
+      return true;
+    }
+
+    if( !m_substr.empty() && file.find( m_substr ) == std::string::npos )
+    {
+      return true;
+    }
+
+    m_counter = m_counter + 1.0;
+
+    if( m_counter >= m_factor )
+    {
+      m_counter -= m_factor;
+      return true;
+    }
+
+    return false;
+  }
+
+private:
+
+  double m_factor;
+  std::string m_substr;
+  double m_counter;
+};
+
+void
+adjust_labels( std::vector< std::string >& input_files,
+               std::vector< kwiver::vital::detected_object_set_sptr >& input_dets,
+               const std::vector< bool >& fg_mask,
+               unsigned background_ds_rate = 0,
+               unsigned background_skip_count = 0 )
+{
+  if( !background_ds_rate && !background_skip_count )
+  {
+    return;
+  }
+
+  unsigned since_last_fg = 0, bg_counter = 0;
+
+  filter_in_place( input_files, input_dets, [&]( size_t i )
+  {
+    bool keep = true;
+
+    if( fg_mask[i] )
+    {
+      since_last_fg = 0;
+    }
+    else if( !input_dets[i] || input_dets[i]->empty() )
+    {
+      keep = false;
+    }
+    else
+    {
+      if( ( background_ds_rate && bg_counter % background_ds_rate != 0 ) ||
+          ( background_skip_count && since_last_fg < background_skip_count ) )
+      {
+        keep = false;
+      }
+
+      bg_counter++;
+      since_last_fg++;
+    }
+
+    return keep;
+  } );
+}
+
+// =======================================================================================
+// Binary training manifest, holding the prepared training and validation data so that
+// trainers can memory-map it instead of serializing the data again. All values are
+// little-endian and every section starts on an 8-byte boundary:
+//
+//   header   : char[8] "VIAMETM1", uint32 version (1), uint32 reserved,
+//              uint64 image, box and class counts, uint64 string and mask sizes
+//   images   : per image { uint64 path offset, uint32 path length, uint32 flags
+//              (bit 0 set for validation images), uint64 first box, uint64 box count }
+//   boxes    : per box { float64 min x, min y, max x, max y, score, int32 class index
+//              (-1 if unlabeled), uint32 mask width, mask height, reserved,
+//              uint64 mask offset }
+//   classes  : per class { uint64 name offset, uint32 name length, uint32 reserved }
+//   strings  : UTF-8 paths and class names, not null terminated
+//   masks    : uint8 row-major masks relative to the top-left of their box, 0 or 1
+//
+// The arrows.pytorch.training_manifest python module reads this format.
+bool write_training_manifest( const std::string& filename,
+  kwiver::vital::category_hierarchy_sptr labels,
+  const std::vector< std::string >& train_files,
+  const std::vector< kwiver::vital::detected_object_set_sptr >& train_dets,
+  const std::vector< std::string >& validation_files,
+  const std::vector< kwiver::vital::detected_object_set_sptr >& validation_dets )
+{
+  struct image_record
+  {
+    std::uint64_t path_offset;
+    std::uint32_t path_length;
+    std::uint32_t flags;
+    std::uint64_t first_box;
+    std::uint64_t box_count;
+  };
+
+  struct box_record
+  {
+    double bbox[4];
+    double score;
+    std::int32_t class_index;
+    std::uint32_t mask_width;
+    std::uint32_t mask_height;
+    std::uint32_t reserved;
+    std::uint64_t mask_offset;
+  };
+
+  struct class_record
+  {
+    std::uint64_t name_offset;
+    std::uint32_t name_length;
+    std::uint32_t reserved;
+  };
+
+  static_assert( sizeof( image_record ) == 32, "Unexpected image record padding" );
+  static_assert( sizeof( box_record ) == 64, "Unexpected box record padding" );
+  static_assert( sizeof( class_record ) == 16, "Unexpected class record padding" );
+
+  std::vector< image_record > images;
+  std::vector< box_record > boxes;
+  std::vector< class_record > classes;
+  std::string strings;
+  std::vector< std::uint8_t > masks;
+
+  std::map< std::string, std::int32_t > class_indices;
+
+  if( labels )
+  {
+    for( const auto& name : labels->all_class_names() )
+    {
+      class_indices[ name ] = static_cast< std::int32_t >( classes.size() );
+      classes.push_back( class_record{ strings.size(),
+        static_cast< std::uint32_t >( name.size() ), 0 } );
+      strings += name;
+    }
+  }
+
+  auto add_images = [&]( const std::vector< std::string >& files,
+    const std::vector< kwiver::vital::detected_object_set_sptr >& dets,
+    std::uint32_t flags )
+  {
+    for( size_t i = 0; i < files.size(); ++i )
+    {
+      image_record image{ strings.size(),
+        static_cast< std::uint32_t >( files[i].size() ), flags, boxes.size(), 0 };
+      strings += files[i];
+
+      if( i < dets.size() && dets[i] )
+      {
+        for( const auto& det : *dets[i] )
+        {
+          const auto& bbox = det->bounding_box();
+          box_record box{ { bbox.min_x(), bbox.min_y(), bbox.max_x(), bbox.max_y() },
+            det->confidence(), -1, 0, 0, 0, 0 };
+
+          if( det->type() )
+          {
+            std::string name;
+            det->type()->get_most_likely( name, box.score );
+
+            auto index = class_indices.find( name );
+
+            if( index != class_indices.end() )
+            {
+              box.class_index = index->second;
+            }
+          }
+
+          const kwiver::vital::image mask =
+            det->mask() ? det->mask()->get_image() : kwiver::vital::image();
+
+          if( mask.size() > 0 && mask.depth() == 1 &&
+              mask.pixel_traits().num_bytes == 1 )
+          {
+            box.mask_width = static_cast< std::uint32_t >( mask.width() );
+            box.mask_height = static_cast< std::uint32_t >( mask.height() );
+            box.mask_offset = masks.size();
+
+            for( size_t y = 0; y < mask.height(); ++y )
+            {
+              for( size_t x = 0; x < mask.width(); ++x )
+              {
+                masks.push_back( mask.at< std::uint8_t >( x, y ) ? 1 : 0 );
+              }
+            }
+          }
+
+          boxes.push_back( box );
+          image.box_count++;
+        }
+      }
+
+      images.push_back( image );
+    }
+  };
+
+  add_images( train_files, train_dets, 0 );
+  add_images( validation_files, validation_dets, 1 );
+
+  std::ofstream fout( filename, std::ios::binary );
+
+  if( !fout )
+  {
+    return false;
+  }
+
+  auto write_padded = [&]( const void* data, size_t size )
+  {
+    static const char padding[8] = { 0 };
+
+    fout.write( static_cast< const char* >( data ), size );
+    fout.write( padding, ( 8 - size % 8 ) % 8 );
+  };
+
+  const std::uint32_t version = 1, reserved = 0;
+  const std::uint64_t counts[5] = { images.size(), boxes.size(), classes.size(),
+                                    strings.size(), masks.size() };
+
+  fout.write( "VIAMETM1", 8 );
+  fout.write( reinterpret_cast< const char* >( &version ), sizeof( version ) );
+  fout.write( reinterpret_cast< const char* >( &reserved ), sizeof( reserved ) );
+  fout.write( reinterpret_cast< const char* >( counts ), sizeof( counts ) );
+
+  write_padded( images.data(), images.size() * sizeof( image_record ) );
+  write_padded( boxes.data(), boxes.size() * sizeof( box_record ) );
+  write_padded( classes.data(), classes.size() * sizeof( class_record ) );
+  write_padded( strings.data(), strings.size() );
+  write_padded( masks.data(), masks.size() );
+
+  return static_cast< bool >( fout );
+}
+
+// =======================================================================================
+// Training sweeps, running several trainings of the same data each in a child process
+// of this tool pinned to a single GPU, on this machine and optionally on remote hosts.
+// Each job runs in its own folder so that the models and pipeline templates output by
+// its trainer are kept apart.
+
+// Number of GPUs usable by trainers, as reported by check_gpu_usability.py
+unsigned detect_usable_gpus()
+{
+  const char* install_dir = std::getenv( "VIAME_INSTALL" );
+
+  std::string script = "check_gpu_usability.py";
+
+  if( install_dir )
+  {
+    script = append_path( append_path( install_dir, "configs" ), script );
+  }
+
+  if( !does_file_exist( script ) )
+  {
+    return 0;
+  }
+
+#ifdef WIN32
+  FILE* output = _popen( ( "python.exe " + add_quotes( script ) ).c_str(), "r" );
+#else
+  FILE* output = popen( ( "python " + add_quotes( script ) + " 2>&1" ).c_str(), "r" );
+#endif
+
+  if( !output )
+  {
+    return 0;
+  }
+
+  unsigned count = 0;
+  char buffer[256];
+  const std::string key = "Usable devices: ";
+
+  while( std::fgets( buffer, sizeof( buffer ), output ) )
+  {
+    const std::string line( buffer );
+    const size_t pos = line.find( key );
+
+    if( pos != std::string::npos )
+    {
+      count = static_cast< unsigned >( std::atoi( line.c_str() + pos + key.size() ) );
+    }
+  }
+
+#ifdef WIN32
+  _pclose( output );
+#else
+  pclose( output );
+#endif
+
+  return count;
+}
+
+// Command line of this tool, without the sweep options, with paths made absolute
+std::vector< std::string > get_sweep_job_arguments( int argc, char* argv[] )
+{
+  const std::unordered_set< std::string > sweep_args =
+    { "--sweep", "-sw", "--gpus", "-g", "--hosts", "-hs" };
+
+  std::vector< std::string > output;
+
+  for( int i = 1; i < argc; ++i )
+  {
+    const std::string arg = argv[i];
+
+    if( sweep_args.count( arg ) )
+    {
+      ++i;
+      continue;
+    }
+
+    if( arg[0] != '-' && filesystem::exists( arg ) )
+    {
+      output.push_back( filesystem::absolute( arg ).string() );
+    }
+    else
+    {
+      output.push_back( arg );
+    }
+  }
+
+  return output;
 }
 
-template< typename T >
-void conditional_remove( std::vector< T >& input, std::vector< bool > remove )
+int run_training_sweep( int argc, char* argv[] )
 {
-  std::vector< T > output;
-  for( unsigned i = 0; i < input.size(); i++ )
+  // Each line of the sweep file holds the key=value settings of one training
+  std::vector< std::string > lines, jobs;
+
+  if( !file_to_vector( g_params.opt_sweep, lines ) )
+  {
+    std::cerr << "Unable to open sweep file " << g_params.opt_sweep << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for( auto line : lines )
   {
-    if( !remove[i] )
+    boost::algorithm::trim( line );
+
+    if( !line.empty() && line[0] != '#' )
     {
-      output.push_back( input[i] );
+      jobs.push_back( line );
     }
   }
-  input = output;
-}
 
-void
-adjust_labels( std::vector< std::string >& input_files,
-               std::vector< kwiver::vital::detected_object_set_sptr >& input_dets,
-               const std::vector< bool >& fg_mask,
-               unsigned background_ds_rate = 0,
-               unsigned background_skip_count = 0 )
-{
-  if( !background_ds_rate && !background_skip_count )
+  if( jobs.empty() )
   {
-    return;
+    std::cerr << "Sweep file " << g_params.opt_sweep << " lists no trainings" << std::endl;
+    return EXIT_FAILURE;
   }
 
-  std::vector< bool > to_remove( fg_mask.size(), false );
-  unsigned since_last_fg = 0, bg_counter = 0;
+  std::vector< std::string > gpus, hosts;
 
-  for( unsigned i = 0; i < input_files.size(); i++ )
+  if( !g_params.opt_gpus.empty() )
   {
-    if( fg_mask[i] )
-    {
-      since_last_fg = 0;
-    }
-    else if( !input_dets[i] || input_dets[i]->empty() )
+    boost::split( gpus, g_params.opt_gpus, boost::is_any_of( "," ),
+                  boost::token_compress_on );
+  }
+  else
+  {
+    for( unsigned i = 0; i < detect_usable_gpus(); ++i )
     {
-      to_remove[i] = true;
+      gpus.push_back( std::to_string( i ) );
     }
-    else
-    {
-      if( ( background_ds_rate && bg_counter % background_ds_rate != 0 ) ||
-          ( background_skip_count && since_last_fg < background_skip_count ) )
-      {
-        to_remove[i] = true;
-      }
+  }
 
-      bg_counter++;
-      since_last_fg++;
-    }
+  if( gpus.empty() )
+  {
+    std::cout << "No usable GPUs found, running sweep trainings one at a time" << std::endl;
+    gpus.push_back( "" );
   }
 
-  conditional_remove( input_files, to_remove );
-  conditional_remove( input_dets, to_remove );
-}
+  // Local trainings use an empty host
+  hosts.push_back( "" );
 
+  if( !g_params.opt_hosts.empty() )
+  {
+    std::vector< std::string > remote_hosts;
+    boost::split( remote_hosts, g_params.opt_hosts, boost::is_any_of( "," ),
+                  boost::token_compress_on );
+    hosts.insert( hosts.end(), remote_hosts.begin(), remote_hosts.end() );
+  }
 
-void
-adjust( std::vector< std::string >& input_files,
-        std::vector< kwiver::vital::detected_object_set_sptr >& input_dets,
-        double downsample_factor,
-        const std::string substr = "" )
-{
-  if( !downsample_factor || downsample_factor == 1.0 || input_files.empty() )
+  std::string executable = argv[0];
+
+  if( filesystem::exists( executable ) )
   {
-    return;
+    executable = filesystem::absolute( executable ).string();
   }
 
-  if( downsample_factor < 1.0 )
+  std::string base_cmd = add_quotes( executable );
+
+  for( const auto& arg : get_sweep_job_arguments( argc, argv ) )
   {
-    downsample_factor = 1.0 / downsample_factor;
+    base_cmd += " " + add_quotes( arg );
   }
 
-  double counter = 1.0;
+  const std::string sweep_dir = filesystem::absolute(
+    filesystem::path( g_params.opt_sweep ).stem().string() + "_jobs" ).string();
+
+  std::vector< std::string > job_dirs( jobs.size() );
+  std::vector< int > job_status( jobs.size(), -1 );
+  std::mutex slot_mutex, print_mutex;
+
+  // Each running job holds one of the free GPU slots, as many as there are threads
+  std::vector< size_t > free_slots;
+
+  for( size_t slot = gpus.size() * hosts.size(); slot > 0; --slot )
+  {
+    free_slots.push_back( slot - 1 );
+  }
 
-  std::vector< std::string > original_files = input_files;
-  std::vector< kwiver::vital::detected_object_set_sptr > original_dets = input_dets;
+  for( size_t j = 0; j < jobs.size(); ++j )
+  {
+    job_dirs[j] = append_path( sweep_dir, "job_" + std::to_string( j ) );
+    create_folder( job_dirs[j] );
+  }
 
-  input_files.clear();
-  input_dets.clear();
+  std::cout << "Running " << jobs.size() << " sweep trainings on "
+            << gpus.size() * hosts.size() << " GPU slots" << std::endl;
 
-  for( unsigned i = 0; i < original_files.size(); i++ )
+  // One thread per GPU of every host, each one taking the next pending job
+  parallel_for( jobs.size(), static_cast< unsigned >( free_slots.size() ),
+    [&]( size_t j )
   {
-    if( !substr.empty() && original_files[i].find( substr ) == std::string::npos )
+    size_t slot;
+
     {
-      input_files.push_back( original_files[i] );
-      input_dets.push_back( original_dets[i] );
-      continue;
+      std::lock_guard< std::mutex > lock( slot_mutex );
+      slot = free_slots.back();
+      free_slots.pop_back();
+    }
+
+    const std::string& host = hosts[ slot / gpus.size() ];
+    const std::string& gpu = gpus[ slot % gpus.size() ];
+
+    std::vector< std::string > settings;
+    boost::split( settings, jobs[j], boost::is_any_of( " \t" ),
+                  boost::token_compress_on );
+
+    std::string cmd = base_cmd;
+
+    for( const auto& setting : settings )
+    {
+      cmd += " -s " + add_quotes( setting );
+    }
+
+    cmd += " > " + add_quotes( append_path( job_dirs[j], "training.log" ) ) + " 2>&1";
+
+#ifdef WIN32
+    cmd = "cd /d " + add_quotes( job_dirs[j] ) + " && " +
+      ( gpu.empty() ? "" : "set CUDA_VISIBLE_DEVICES=" + gpu + "&& " ) + cmd;
+#else
+    cmd = "cd " + add_quotes( job_dirs[j] ) + " && " +
+      ( gpu.empty() ? "" : "CUDA_VISIBLE_DEVICES=" + gpu + " " ) + cmd;
+#endif
+
+    // Remote hosts are expected to share the filesystem of this one
+    if( !host.empty() )
+    {
+      cmd = "ssh " + host + " '" + cmd + "'";
+    }
+
+    {
+      std::lock_guard< std::mutex > lock( print_mutex );
+      std::cout << "Starting sweep training " << j << " on "
+                << ( host.empty() ? "localhost" : host )
+                << ( gpu.empty() ? "" : " GPU " + gpu ) << ": " << jobs[j] << std::endl;
     }
 
-    counter = counter + 1.0;
+    job_status[j] = system( cmd.c_str() );
 
-    if( counter >= downsample_factor )
     {
-      counter -= downsample_factor;
+      std::lock_guard< std::mutex > lock( slot_mutex );
+      free_slots.push_back( slot );
+    }
 
-      input_files.push_back( original_files[i] );
-      input_dets.push_back( original_dets[i] );
+    {
+      std::lock_guard< std::mutex > lock( print_mutex );
+      std::cout << "Sweep training " << j << ( job_status[j] == 0 ? " finished" : " failed" )
+                << ", outputs in " << job_dirs[j] << std::endl;
     }
+  } );
+
+  unsigned failures = 0;
+
+  std::cout << std::endl << "Sweep summary:" << std::endl;
+
+  for( size_t j = 0; j < jobs.size(); ++j )
+  {
+    std::cout << ( job_status[j] == 0 ? " - done   " : " - failed " )
+              << job_dirs[j] << " : " << jobs[j] << std::endl;
+
+    failures += ( job_status[j] != 0 );
   }
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 // =======================================================================================
@@ -1168,6 +2507,18 @@ main( int argc, char* argv[] )
     &g_params.opt_init_weights, "Optional input seed weights over-ride" );
   g_params.m_args.AddArgument( "-iw",             argT::SPACE_ARGUMENT,
     &g_params.opt_init_weights, "Optional input seed weights over-ride" );
+  g_params.m_args.AddArgument( "--sweep",         argT::SPACE_ARGUMENT,
+    &g_params.opt_sweep, "File listing the settings of several trainings to run" );
+  g_params.m_args.AddArgument( "-sw",            argT::SPACE_ARGUMENT,
+    &g_params.opt_sweep, "File listing the settings of several trainings to run" );
+  g_params.m_args.AddArgument( "--gpus",          argT::SPACE_ARGUMENT,
+    &g_params.opt_gpus, "Comma separated GPUs used by a sweep, default all" );
+  g_params.m_args.AddArgument( "-g",              argT::SPACE_ARGUMENT,
+    &g_params.opt_gpus, "Comma separated GPUs used by a sweep, default all" );
+  g_params.m_args.AddArgument( "--hosts",         argT::SPACE_ARGUMENT,
+    &g_params.opt_hosts, "Comma separated ssh hosts also running a sweep" );
+  g_params.m_args.AddArgument( "-hs",             argT::SPACE_ARGUMENT,
+    &g_params.opt_hosts, "Comma separated ssh hosts also running a sweep" );
 
   // Parse args
   if( !g_params.m_args.Parse() )
@@ -1238,6 +2589,12 @@ main( int argc, char* argv[] )
     return EXIT_FAILURE;
   }
 
+  // Run each training of a sweep in its own process instead
+  if( !g_params.opt_sweep.empty() )
+  {
+    return run_training_sweep( argc, argv );
+  }
+
   // Load KWIVER plugins
   kwiver::vital::plugin_manager::instance().load_all_plugins();
   kwiver::vital::config_block_sptr config = default_config();
@@ -1266,9 +2623,8 @@ main( int argc, char* argv[] )
     config->set_value( "detector_trainer:type", g_params.opt_detector );
   }
 
-  if( !g_params.opt_settings.empty() )
+  for( const std::string& setting : g_params.opt_settings )
   {
-    const std::string& setting = g_params.opt_settings;
     size_t const split_pos = setting.find( "=" );
 
     if( split_pos == std::string::npos )
@@ -1497,6 +2853,10 @@ main( int argc, char* argv[] )
     config->get_value< bool >( "regenerate_cache" );
   std::string augmented_ext_override =
     config->get_value< std::string >( "augmented_ext_override" );
+  unsigned augmentation_threads =
+    config->get_value< unsigned >( "augmentation_threads" );
+  bool incremental_cache =
+    config->get_value< bool >( "incremental_cache" );
   double percent_validation =
     config->get_value< double >( "default_percent_validation" );
   unsigned validation_burst_frame_count =
@@ -1507,6 +2867,26 @@ main( int argc, char* argv[] )
     config->get_value< std::string >( "video_extensions" );
   std::string video_extractor =
     config->get_value< std::string >( "video_extractor" );
+  bool video_extraction_in_process =
+    config->get_value< bool >( "video_extraction_in_process" );
+  unsigned video_extraction_threads =
+    config->get_value< unsigned >( "video_extraction_threads" );
+  unsigned dataset_scan_threads =
+    config->get_value< unsigned >( "dataset_scan_threads" );
+  std::string dataset_manifest =
+    config->get_value< std::string >( "dataset_manifest" );
+  std::string training_manifest =
+    config->get_value< std::string >( "training_manifest" );
+  unsigned groundtruth_reader_threads =
+    config->get_value< unsigned >( "groundtruth_reader_threads" );
+  std::string profile_report =
+    config->get_value< std::string >( "profile_report" );
+  std::string video_frame_extension =
+    config->get_value< std::string >( "video_frame_extension" );
+  g_video_reader =
+    config->get_value< std::string >( "video_reader" );
+  g_video_seek_frames =
+    config->get_value< bool >( "video_seek_frames" );
   double frame_rate =
     config->get_value< double >( "frame_rate" );
   unsigned max_frame_count =
@@ -1531,6 +2911,16 @@ main( int argc, char* argv[] )
     config->get_value< bool >( "check_override" );
   bool convert_to_full_frame =
     config->get_value< bool >( "convert_to_full_frame" );
+
+  chip_settings chipping;
+  chipping.width = config->get_value< unsigned >( "chip_width" );
+  chipping.height = config->get_value< unsigned >( "chip_height" );
+  chipping.overlap = config->get_value< unsigned >( "chip_overlap" );
+  chipping.min_overlap = config->get_value< double >( "chip_min_overlap" );
+  chipping.keep_empty = config->get_value< bool >( "chip_keep_empty" );
+  chipping.full_frame = convert_to_full_frame;
+
+  const bool chip_images = ( chipping.width > 0 && chipping.height > 0 );
   std::string data_warning_file =
     config->get_value< std::string >( "data_warning_file" );
 
@@ -1565,6 +2955,21 @@ main( int argc, char* argv[] )
     regenerate_cache = true;
   }
 
+  // Cache entries are identified by the content of their source image and of the
+  // augmentation pipeline, including its output extension
+  augmentation_manifest cache_manifest;
+  std::uint64_t pipeline_hash = 0;
+
+  if( incremental_cache && !augmented_cache.empty() && !pipeline_file.empty() )
+  {
+    pipeline_hash = hash_string( augmented_ext_override,
+                                 hash_pipeline_file( pipeline_file ) );
+    cache_manifest.open( append_path( augmented_cache, "augmentation_manifest.txt" ) );
+  }
+
+  const bool augment_cache = regenerate_cache || cache_manifest.is_open();
+  chipping.overwrite = augment_cache;
+
   std::unique_ptr< std::ofstream > data_warning_writer;
   std::vector< std::string > mentioned_warnings;
 
@@ -1659,7 +3064,7 @@ main( int argc, char* argv[] )
   }
 
   // Image reader and width/height only required for certain operations
-  if( convert_to_full_frame )
+  if( convert_to_full_frame || chip_images )
   {
     kwiver::vital::algo::image_io::set_nested_algo_configuration
       ( "image_reader", config, image_reader );
@@ -1676,6 +3081,13 @@ main( int argc, char* argv[] )
   int validation_pivot = -1;            // Validation index start, if manually set
   bool auto_detect_truth = false;       // Auto-detect truth if not manually specified
 
+  auto phase_start = training_profile::clock::now();
+
+  if( !dataset_manifest.empty() && g_directory_cache.load( dataset_manifest ) )
+  {
+    std::cout << "Loaded dataset manifest " << dataset_manifest << std::endl;
+  }
+
   // Option 1: a typical training data directory is input
   if( !g_params.opt_input_dir.empty() )
   {
@@ -1764,14 +3176,21 @@ main( int argc, char* argv[] )
         std::cout << "Using absolute paths in train.txt and validation.txt" << std::endl;
       }
 
-      for( unsigned i = 0; i < all_data.size(); i++ )
+      std::vector< char > file_exists( all_data.size(), 0 );
+
+      parallel_for( all_data.size(), dataset_scan_threads, [&]( size_t i )
       {
         if( !absolute_paths )
         {
           all_data[i] = append_path( g_params.opt_input_dir, all_data[i] );
         }
 
-        if( !does_file_exist( all_data[i] ) )
+        file_exists[i] = does_file_exist( all_data[i] );
+      } );
+
+      for( unsigned i = 0; i < all_data.size(); i++ )
+      {
+        if( !file_exists[i] )
         {
           std::cerr << "Could not find train file: " << all_data[i] << std::endl;
         }
@@ -1874,6 +3293,112 @@ main( int argc, char* argv[] )
   // Retain class counts for error checking
   std::map< std::string, int > label_counts;
 
+  // Extract the frames of the videos listed directly in the data concurrently,
+  // in data order, ahead of their use. A maximum frame count stops at the first
+  // video so nothing is extracted ahead then.
+  std::map< std::string, std::shared_future< std::vector< std::string > > > extracted_videos;
+  std::vector< std::thread > extraction_threads;
+
+  struct thread_joiner
+  {
+    std::vector< std::thread >& threads;
+
+    ~thread_joiner()
+    {
+      for( auto& thread : threads )
+      {
+        thread.join();
+      }
+    }
+  } extraction_joiner{ extraction_threads };
+
+  if( video_extraction_in_process && video_extraction_threads > 1 &&
+      max_frame_count == 0 && video_extractor.find( "_only" ) == std::string::npos )
+  {
+    using extraction_job =
+      std::pair< std::string, std::promise< std::vector< std::string > > >;
+
+    auto jobs = std::make_shared< std::vector< extraction_job > >();
+    std::vector< double > job_frame_rates;
+
+    for( unsigned i = 0; i < all_data.size(); i++ )
+    {
+      const std::string& data_item = all_data[i];
+
+      if( !ends_with_extension( data_item, video_exts ) ||
+          extracted_videos.count( data_item ) )
+      {
+        continue;
+      }
+
+      std::string video_truth;
+
+      if( !auto_detect_truth )
+      {
+        video_truth = ( i < all_truth.size() ? all_truth[i] : "" );
+      }
+      else if( does_file_exist( replace_ext_with( data_item, groundtruth_exts[0] ) ) )
+      {
+        video_truth = replace_ext_with( data_item, groundtruth_exts[0] );
+      }
+      else
+      {
+        video_truth = add_ext_unto( data_item, groundtruth_exts[0] );
+      }
+
+      const double file_frame_rate = get_file_frame_rate( video_truth );
+
+      jobs->emplace_back( data_item, std::promise< std::vector< std::string > >() );
+      job_frame_rates.push_back( file_frame_rate > 0 ? file_frame_rate : frame_rate );
+      extracted_videos[ data_item ] = jobs->back().second.get_future().share();
+    }
+
+    auto next_job = std::make_shared< std::atomic< size_t > >( 0 );
+
+    for( unsigned t = 0; t < video_extraction_threads && t < jobs->size(); t++ )
+    {
+      extraction_threads.emplace_back( [=]()
+      {
+        for( size_t j = ( *next_job )++; j < jobs->size(); j = ( *next_job )++ )
+        {
+          try
+          {
+            ( *jobs )[j].second.set_value( extract_video_frames( ( *jobs )[j].first,
+              video_extractor, job_frame_rates[j], augmented_cache, !regenerate_cache,
+              0, true, video_frame_extension ) );
+          }
+          catch( ... )
+          {
+            ( *jobs )[j].second.set_exception( std::current_exception() );
+          }
+        }
+      } );
+    }
+  }
+
+  // List all data folders concurrently ahead of their use, filling the folder cache
+  if( dataset_scan_threads > 1 || !dataset_manifest.empty() )
+  {
+    parallel_for( all_data.size(), dataset_scan_threads, [&]( size_t i )
+    {
+      std::vector< std::string > files;
+      list_files_in_folder( all_data[i], files, true );
+    } );
+  }
+
+  if( !dataset_manifest.empty() && !g_directory_cache.save( dataset_manifest ) )
+  {
+    std::cerr << "Unable to write dataset manifest " << dataset_manifest << std::endl;
+  }
+
+  g_profile.add_time( "discovery", phase_start );
+  g_profile.update( "discovery", [&]( training_profile::phase& p )
+  {
+    p.items += all_data.size();
+  } );
+
+  groundtruth_file_readers gt_file_readers( config, groundtruth_reader_threads );
+
   for( unsigned i = 0; i < all_data.size(); i++ )
   {
     // Get next data entry to process
@@ -1969,9 +3494,19 @@ main( int argc, char* argv[] )
         return EXIT_FAILURE;
       }
 
-      image_files = extract_video_frames( data_item, video_extractor,
-        ( file_frame_rate > 0 ? file_frame_rate : frame_rate ),
-        augmented_cache, !regenerate_cache, max_frame_count );
+      auto extracted = extracted_videos.find( data_item );
+
+      if( extracted != extracted_videos.end() )
+      {
+        image_files = extracted->second.get();
+      }
+      else
+      {
+        image_files = extract_video_frames( data_item, video_extractor,
+          ( file_frame_rate > 0 ? file_frame_rate : frame_rate ),
+          augmented_cache, !regenerate_cache, max_frame_count,
+          video_extraction_in_process, video_frame_extension );
+      }
 
       if( max_frame_count > 0 )
       {
@@ -1981,10 +3516,19 @@ main( int argc, char* argv[] )
 
     std::sort( image_files.begin(), image_files.end() );
 
-    // Load groundtruth file for this entry
+    // Load groundtruth file for this entry, or parse all of its groundtruth
+    // files ahead of the image loop when there is one per image
     kwiver::vital::algo::detected_object_set_input_sptr gt_reader;
+    std::vector< kwiver::vital::detected_object_set_sptr > image_dets;
 
-    if( !one_file_per_image )
+    if( one_file_per_image )
+    {
+      if( !gt_file_readers.read( gt_files, image_files, image_dets ) )
+      {
+        return EXIT_FAILURE;
+      }
+    }
+    else
     {
       if( gt_files.size() != 1 )
       {
@@ -2000,13 +3544,29 @@ main( int argc, char* argv[] )
 
       std::cout << "Opening groundtruth file " << gt_files[0] << std::endl;
 
+      const auto open_start = training_profile::clock::now();
+
       gt_reader->open( gt_files[0] );
+
+      g_profile.add_time( "groundtruth_reading", open_start );
+      g_profile.update( "groundtruth_reading", [&]( training_profile::phase& p )
+      {
+        p.items++;
+        p.bytes_read += get_file_size( gt_files[0] );
+      } );
     }
 
     // Perform any augmentation for this entry, if enabled
-    pipeline_t augmentation_pipe = load_embedded_pipeline( pipeline_file );
+    std::unique_ptr< augmentation_workers > augmentation_pipes;
+    std::vector< bool > augmented;
     std::string last_subdir;
 
+    if( !pipeline_file.empty() )
+    {
+      augmentation_pipes.reset( new augmentation_workers( pipeline_file,
+        augment_cache ? augmentation_threads : 1 ) );
+    }
+
     if( !augmented_cache.empty() && !pipeline_file.empty() )
     {
       std::vector< std::string > cache_path, split_folder;
@@ -2020,6 +3580,18 @@ main( int argc, char* argv[] )
       create_folder( kwiversys::SystemTools::JoinPath( cache_path ) );
     }
 
+    // Chips of this entry are written in their own cache folder
+    std::string chip_folder;
+
+    if( chip_images )
+    {
+      chip_folder = append_path( append_path(
+        augmented_cache.empty() ? "training_chips" : augmented_cache,
+        get_filename_no_path( data_item ) ), "chips" );
+
+      create_folder( chip_folder );
+    }
+
     // Read all images and detections in sequence
     if( image_files.size() == 0 )
     {
@@ -2033,18 +3605,82 @@ main( int argc, char* argv[] )
       bool use_image = true;
       std::string filtered_image_file;
 
-      if( augmentation_pipe )
+      if( augmentation_pipes )
       {
         filtered_image_file = get_augmented_filename( image_file, last_subdir,
           augmented_cache, augmented_ext_override );
 
-        if( regenerate_cache )
+        // Augment images ahead by batches, so that all the pipelines stay busy
+        // while not augmenting images past a maximum frame count
+        if( augment_cache && i >= augmented.size() )
         {
-          if( !run_pipeline_on_image( augmentation_pipe, pipeline_file,
-                image_file, filtered_image_file ) )
+          const size_t batch_end = std::min< size_t >( image_files.size(),
+            i + 32 * augmentation_pipes->size() );
+
+          const auto batch_start = training_profile::clock::now();
+
+          std::vector< bool > batch( batch_end - i, false );
+          std::vector< size_t > batch_indices;
+          std::vector< std::string > batch_inputs, batch_outputs;
+          std::vector< std::uint64_t > batch_hashes;
+
+          for( size_t j = i; j < batch_end; ++j )
+          {
+            const std::string output = get_augmented_filename( image_files[j],
+              last_subdir, augmented_cache, augmented_ext_override );
+
+            // Up to date entries of the manifest are reused as they are
+            std::uint64_t source_hash = 0;
+            bool success = false;
+
+            if( cache_manifest.is_open() )
+            {
+              source_hash = hash_file( image_files[j] );
+
+              if( cache_manifest.find( output, source_hash, pipeline_hash, success ) )
+              {
+                batch[ j - i ] = success;
+                continue;
+              }
+            }
+
+            batch_indices.push_back( j - i );
+            batch_inputs.push_back( image_files[j] );
+            batch_outputs.push_back( output );
+            batch_hashes.push_back( source_hash );
+          }
+
+          const std::vector< bool > results =
+            augmentation_pipes->run( batch_inputs, batch_outputs );
+
+          for( size_t k = 0; k < results.size(); ++k )
           {
-            use_image = false;
+            batch[ batch_indices[k] ] = results[k];
+
+            if( cache_manifest.is_open() )
+            {
+              cache_manifest.record( batch_outputs[k], batch_hashes[k],
+                                     pipeline_hash, results[k] );
+            }
           }
+
+          cache_manifest.flush();
+          augmented.insert( augmented.end(), batch.begin(), batch.end() );
+
+          g_profile.add_time( "augmentation", batch_start );
+          g_profile.update( "augmentation", [&]( training_profile::phase& p )
+          {
+            p.items += batch.size();
+            p.bytes_read += get_total_file_size( batch_inputs );
+            p.bytes_written += get_total_file_size( batch_outputs );
+            p.cache_hits += batch.size() - batch_inputs.size();
+            p.cache_misses += batch_inputs.size();
+          } );
+        }
+
+        if( augment_cache )
+        {
+          use_image = augmented[i];
         }
         else
         {
@@ -2062,27 +3698,17 @@ main( int argc, char* argv[] )
 
       if( one_file_per_image )
       {
-        gt_reader.reset();
-
-        kwiver::vital::algo::detected_object_set_input::set_nested_algo_configuration
-          ( "groundtruth_reader", config, gt_reader );
-        kwiver::vital::algo::detected_object_set_input::get_nested_algo_configuration
-          ( "groundtruth_reader", config, gt_reader );
-
-        gt_reader->open( gt_files[i] );
-
-        std::string read_fn = get_filename_no_path( image_file );
-
-        gt_reader->read_set( frame_dets, read_fn );
-        gt_reader->close();
+        frame_dets = image_dets[i];
       }
       else
       {
         std::string read_fn = get_filename_no_path( image_file );
+        const auto read_start = training_profile::clock::now();
 
         try
         {
           gt_reader->read_set( frame_dets, read_fn );
+          g_profile.add_time( "groundtruth_reading", read_start );
         }
         catch( const std::exception& e )
         {
@@ -2094,7 +3720,8 @@ main( int argc, char* argv[] )
 
       correct_manual_annotations( frame_dets );
 
-      if( convert_to_full_frame )
+      // With chips, detections are converted to full frame labels for each chip
+      if( convert_to_full_frame && !chip_images )
       {
         if( i < 4 || variable_resolution_sequences )
         {
@@ -2112,7 +3739,7 @@ main( int argc, char* argv[] )
           image_height = new_height;
         }
 
-        frame_dets = adjust_to_full_frame( frame_dets, image_width, image_height );
+        frame_dets = viame::adjust_to_full_frame( frame_dets, image_width, image_height );
       }
 
       // Apply threshold to frame detections
@@ -2177,8 +3804,19 @@ main( int argc, char* argv[] )
           }
         }
 
-        train_image_fn.push_back( filtered_image_file );
-        train_gt.push_back( filtered_dets );
+        if( chip_images )
+        {
+          if( !write_annotated_chips( image_reader, filtered_image_file,
+                filtered_dets, chip_folder, chipping, train_image_fn, train_gt ) )
+          {
+            std::cout << "Warning: unable to chip " << filtered_image_file << std::endl;
+          }
+        }
+        else
+        {
+          train_image_fn.push_back( filtered_image_file );
+          train_gt.push_back( filtered_dets );
+        }
       }
 
       if( max_frame_count > 0 && train_image_fn.size() > max_frame_count )
@@ -2187,10 +3825,9 @@ main( int argc, char* argv[] )
       }
     }
 
-    if( augmentation_pipe )
+    if( augmentation_pipes )
     {
-      augmentation_pipe->send_end_of_input();
-      augmentation_pipe->wait();
+      augmentation_pipes->finish();
     }
 
     if( !one_file_per_image )
@@ -2204,12 +3841,16 @@ main( int argc, char* argv[] )
     }
   }
 
+  phase_start = training_profile::clock::now();
+
   if( validation_pivot > 0 )
   {
     validation_image_fn.insert( validation_image_fn.begin(),
-      train_image_fn.begin() + validation_pivot, train_image_fn.end() );
+      std::make_move_iterator( train_image_fn.begin() + validation_pivot ),
+      std::make_move_iterator( train_image_fn.end() ) );
     validation_gt.insert( validation_gt.begin(),
-      train_gt.begin() + validation_pivot, train_gt.end() );
+      std::make_move_iterator( train_gt.begin() + validation_pivot ),
+      std::make_move_iterator( train_gt.end() ) );
 
     train_image_fn.erase(
       train_image_fn.begin() + validation_pivot, train_image_fn.end() );
@@ -2217,14 +3858,20 @@ main( int argc, char* argv[] )
       train_gt.begin() + validation_pivot, train_gt.end() );
   }
 
-  if( downsample > 0 )
+  // Downsample images and keep only GT frames if enabled, in one pass. Removing
+  // frames without truth does not change the label counts gathered below.
+  if( downsample > 0 || targetted_downsample > 0 || g_params.opt_gt_only )
   {
-    adjust( train_image_fn, train_gt, downsample );
-  }
+    downsample_filter downsampler( downsample );
+    downsample_filter targetted_downsampler( targetted_downsample,
+                                             targetted_downsample_string );
 
-  if( targetted_downsample > 0 )
-  {
-    adjust( train_image_fn, train_gt, targetted_downsample, targetted_downsample_string );
+    filter_in_place( train_image_fn, train_gt, [&]( size_t i )
+    {
+      return downsampler( train_image_fn[i] ) &&
+             targetted_downsampler( train_image_fn[i] ) &&
+             ( !g_params.opt_gt_only || !train_gt[i]->empty() );
+    } );
   }
 
   if( label_counts.empty() )
@@ -2336,25 +3983,6 @@ main( int argc, char* argv[] )
     }
   }
 
-  // Use GT frames only if enabled
-  if( g_params.opt_gt_only )
-  {
-    std::vector< std::string > adj_train_image_fn;
-    std::vector< kwiver::vital::detected_object_set_sptr > adj_train_gt;
-
-    for( unsigned i = 0; i < train_image_fn.size(); ++i )
-    {
-      if( !train_gt[i]->empty() )
-      {
-        adj_train_image_fn.push_back( train_image_fn[i] );
-        adj_train_gt.push_back( train_gt[i] );
-      }
-    }
-
-    train_image_fn = adj_train_image_fn;
-    train_gt = adj_train_gt;
-  }
-
   // Generate a validation set automatically if enabled
   bool invalid_train_set = false, invalid_validation_set = false, found_any = false;
 
@@ -2377,25 +4005,22 @@ main( int argc, char* argv[] )
     }
 
     bool found_first = false, found_second = false, initial_override = false;
-    std::vector< std::string > adj_train_image_fn;
-    std::vector< kwiver::vital::detected_object_set_sptr > adj_train_gt;
 
-    for( unsigned i = 0; i < train_image_fn.size(); ++i )
+    filter_in_place( train_image_fn, train_gt, [&]( size_t i )
     {
+      bool keep = false;
+
       // First 2 conditionals are hack to ensure at least 1 truth frame.
       if( !found_first && !train_gt[i]->empty() )
       {
-        validation_image_fn.push_back( train_image_fn[i] );
-        validation_gt.push_back( train_gt[i] );
         found_first = true;
         found_any = true;
       }
       else if( !found_second && !train_gt[i]->empty() )
       {
-        adj_train_image_fn.push_back( train_image_fn[i] );
-        adj_train_gt.push_back( train_gt[i] );
         found_second = true;
         initial_override = true;
+        keep = true;
       }
       else if( initial_override || i % total_segment < train_segment )
       {
@@ -2403,21 +4028,20 @@ main( int argc, char* argv[] )
         {
           initial_override = false;
         }
-        adj_train_image_fn.push_back( train_image_fn[i] );
-        adj_train_gt.push_back( train_gt[i] );
+        keep = true;
       }
-      else
+
+      if( !keep )
       {
-        validation_image_fn.push_back( train_image_fn[i] );
-        validation_gt.push_back( train_gt[i] );
+        validation_image_fn.push_back( std::move( train_image_fn[i] ) );
+        validation_gt.push_back( std::move( train_gt[i] ) );
       }
-    }
+
+      return keep;
+    } );
 
     invalid_validation_set = !found_first;
     invalid_train_set = !found_second;
-
-    train_image_fn = adj_train_image_fn;
-    train_gt = adj_train_gt;
   }
 
   // Backup case for small datasets
@@ -2486,9 +4110,29 @@ main( int argc, char* argv[] )
     adjust_labels( validation_gt, model_labels, secondary_frame_labels );
   }
 
+  g_profile.add_time( "label_adjustment", phase_start );
+  g_profile.update( "label_adjustment", [&]( training_profile::phase& p )
+  {
+    p.items += train_image_fn.size() + validation_image_fn.size();
+  } );
+
+  // Write the prepared data once for trainers which read it directly
+  if( !training_manifest.empty() )
+  {
+    std::cout << "Writing training manifest " << training_manifest << std::endl;
+
+    if( !write_training_manifest( training_manifest, model_labels,
+          train_image_fn, train_gt, validation_image_fn, validation_gt ) )
+    {
+      std::cerr << "Unable to write training manifest " << training_manifest << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   // Run training algorithm
   std::cout << "Beginning Training Process" << std::endl;
   std::string error;
+  phase_start = training_profile::clock::now();
 
   try
   {
@@ -2525,5 +4169,16 @@ main( int argc, char* argv[] )
     }
   }
 
+  g_profile.add_time( "training", phase_start );
+  g_profile.update( "training", [&]( training_profile::phase& p )
+  {
+    p.items += train_image_fn.size();
+  } );
+
+  if( !profile_report.empty() && !g_profile.write_json( profile_report ) )
+  {
+    std::cerr << "Unable to write profile report " << profile_report << std::endl;
+  }
+
   return EXIT_SUCCESS;
 }
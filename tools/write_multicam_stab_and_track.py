@@ -1,5 +1,5 @@
 from pathlib import Path
-from textwrap import dedent
+from textwrap import dedent, indent
 
 import os
 
@@ -60,56 +60,61 @@ def make_detector_creator(embedded):
 def adapt_suffix(i):
     return str(i) if i > 1 else ''
 
+# Feature and homography algorithms of a stabilizer, indented for a process
+stabilizer_algorithms = """\
+  feature_detector:type = filtered
+  block feature_detector:filtered
+    detector:type = ocv_SURF
+    block detector:ocv_SURF
+      extended           = false
+      hessian_threshold  = 400
+      n_octave_layers    = 3
+      n_octaves          = 4
+      upright            = false
+    endblock
+
+    filter:type = nonmax
+    block filter:nonmax
+      num_features_target = 5000
+      num_features_range = 500
+    endblock
+  endblock
+
+  descriptor_extractor:type = ocv_SURF
+  block descriptor_extractor:ocv_SURF
+    extended           = false
+    hessian_threshold  = 400 # 5000
+    n_octave_layers    = 3
+    n_octaves          = 4
+    upright            = false
+  endblock
+
+  feature_matcher:type = ocv_flann_based
+
+  homography_estimator:type = vxl
+"""
+
 def stabilize_images(image_ports):
     process = dedent(f"""\
         process stabilizer
           :: many_image_stabilizer
           n_input = {len(image_ports)}
 
-          feature_detector:type = filtered
-          block feature_detector:filtered
-            detector:type = ocv_SURF
-            block detector:ocv_SURF
-              extended           = false
-              hessian_threshold  = 400
-              n_octave_layers    = 3
-              n_octaves          = 4
-              upright            = false
-            endblock
-
-            filter:type = nonmax
-            block filter:nonmax
-              num_features_target = 5000
-              num_features_range = 500
-            endblock
-          endblock
-
-          descriptor_extractor:type = ocv_SURF
-          block descriptor_extractor:ocv_SURF
-            extended           = false
-            hessian_threshold  = 400 # 5000
-            n_octave_layers    = 3
-            n_octaves          = 4
-            upright            = false
-          endblock
-
-          feature_matcher:type = ocv_flann_based
-
-          homography_estimator:type = vxl
-
-          ref_homography_computer:type = core
-          block ref_homography_computer:core
-            backproject_threshold = 4
-            allow_ref_frame_regression = false
-            min_matches_threshold = 50
-            estimator:type = vxl
-            forget_track_threshold = 5
-            inlier_scale = 10
-            min_track_length = 1
-            use_backproject_error = false
-          endblock
-
-    """)
+    """) + stabilizer_algorithms + indent(dedent("""\
+
+        ref_homography_computer:type = core
+        block ref_homography_computer:core
+          backproject_threshold = 4
+          allow_ref_frame_regression = false
+          min_matches_threshold = 50
+          estimator:type = vxl
+          forget_track_threshold = 5
+          inlier_scale = 10
+          min_track_length = 1
+          use_backproject_error = false
+        endblock
+
+    """), '  ')
     conns = ''.join(dedent(f"""\
         connect from {ip}
                 to stabilizer.image{i}
@@ -144,6 +149,34 @@ def multitrack(homogs, objects, timestamp):
     """))
     return ''.join(result), [f'tracker.obj_tracks_{i}' for i in range1(ncam)]
 
+def stabilize_and_track(images, objects, timestamp):
+    """Stabilize and track all cameras in one native process"""
+    ncam, = {len(images), len(objects)}
+    result = []
+    result.append(dedent(f"""\
+        process tracker
+          :: multicam_stabilize_and_track
+          n_input = {ncam}
+          min_matches = 50
+          inlier_scale = 10
+
+    """) + stabilizer_algorithms + '\n')
+    for prefix, ports in [('image', images), ('det_objs_', objects)]:
+        for i, p in enum1(ports):
+            result.append(dedent(f"""\
+                connect from {p}
+                        to tracker.{prefix}{i}
+            """))
+        result.append('\n')
+    result.append(dedent(f"""\
+        connect from {timestamp}
+                to tracker.timestamp
+
+    """))
+    return ''.join(result), (
+        [f'tracker.homog{i}' for i in range1(ncam)],
+        [f'tracker.obj_tracks_{i}' for i in range1(ncam)])
+
 def suppressor(homogs, objects, images):
     ncams, = {len(homogs), len(objects), len(images)}
     result = []
@@ -251,10 +284,16 @@ def create_file(type_, ncams, *, embedded):
         create_input = make_input_creator()
         ports = (do(create_input(i)) for i in rncams)
         images, file_names, timestamps = zip(*ports)
-    homogs = do(stabilize_images(images))
+    if type_ != 'native_tracker':
+        homogs = do(stabilize_images(images))
     create_detector = make_detector_creator(embedded)
     objects = [do(create_detector(i, im)) for i, im in enum1(images)]
-    if type_ == 'tracker':
+    if type_ == 'native_tracker':
+        homogs, track_sets = do(stabilize_and_track(images, objects,
+                                                    timestamps[0]))
+        for i, ts, t, fn in zip(rncams, track_sets, timestamps, file_names):
+            do(write_tracks(i, ts, t, fn))
+    elif type_ == 'tracker':
         track_sets = do(multitrack(homogs, objects, timestamps[0]))
         for i, ts, t, fn in zip(rncams, track_sets, timestamps, file_names):
             do(write_tracks(i, ts, t, fn))
@@ -275,7 +314,7 @@ def create_file(type_, ncams, *, embedded):
     return ''.join(result).rstrip('\n') + '\n'
 
 def main():
-    for type_ in ['tracker', 'suppressor']:
+    for type_ in ['tracker', 'suppressor', 'native_tracker']:
         for embedded in [False, True]:
             for ncams in range(1, 4):
                 emb = 'embedded_dual_stream' if embedded else ''